@@ -0,0 +1,48 @@
+// Tests the $approxCountDistinct accumulator.
+(function() {
+    "use strict";
+
+    const coll = db.approx_count_distinct;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 50000; i++) {
+        bulk.insert({_id: i, day: i % 2, user: i % 20000, small: i % 7});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Small numbers of distinct values are counted exactly.
+    let result =
+        coll.aggregate([{$group: {_id: null, n: {$approxCountDistinct: "$small"}}}]).toArray();
+    assert.eq([{_id: null, n: NumberLong(7)}], result);
+
+    // Large numbers of distinct values are estimated closely.
+    result = coll.aggregate([
+                     {$group: {_id: "$day", users: {$approxCountDistinct: "$user"}}},
+                     {$sort: {_id: 1}}
+                 ])
+                 .toArray();
+    assert.eq(2, result.length);
+    for (let doc of result) {
+        assert.lt(Math.abs(doc.users - 10000), 300, tojson(doc));
+    }
+
+    // Numerically equal values are counted once.
+    result = coll.aggregate([
+                     {$match: {_id: 0}},
+                     {$project: {values: [1, NumberLong(1), 1.0, "a", null]}},
+                     {$unwind: "$values"},
+                     {$group: {_id: null, n: {$approxCountDistinct: "$values"}}}
+                 ])
+                 .toArray();
+    assert.eq([{_id: null, n: NumberLong(3)}], result);
+
+    // Values which are equal under the collation are counted once, and the documents missing the
+    // field are ignored.
+    assert.writeOK(coll.insert({_id: "upper", str: "A"}));
+    assert.writeOK(coll.insert({_id: "lower", str: "a"}));
+    result = coll.aggregate([{$group: {_id: null, n: {$approxCountDistinct: "$str"}}}],
+                            {collation: {locale: "en_US", strength: 2}})
+                 .toArray();
+    assert.eq([{_id: null, n: NumberLong(1)}], result);
+}());
@@ -0,0 +1,82 @@
+// Tests the $percentileApprox and $medianApprox accumulators, and $bucketAuto with 'approximate'.
+(function() {
+    "use strict";
+
+    load("jstests/aggregation/extras/utils.js");  // For assertErrorCode.
+
+    const coll = db.percentile_approx;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 10000; i++) {
+        bulk.insert({_id: i, group: i % 2, latency: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Small groups are interpolated between the exact values.
+    let result = coll.aggregate([
+                         {$match: {_id: {$lt: 4}}},
+                         {$group: {_id: null, median: {$medianApprox: "$latency"}}}
+                     ])
+                     .toArray();
+    assert.eq([{_id: null, median: 1.5}], result);
+
+    // Large groups are estimated closely, with a number or an array for each percentile.
+    result = coll.aggregate([
+                     {
+                       $group: {
+                           _id: "$group",
+                           p99: {$percentileApprox: {input: "$latency", p: 0.99}},
+                           tails: {$percentileApprox: {input: "$latency", p: [0, 0.5, 1]}},
+                           median: {$medianApprox: "$latency"}
+                       }
+                     },
+                     {$sort: {_id: 1}}
+                 ])
+                 .toArray();
+    assert.eq(2, result.length);
+    for (let doc of result) {
+        assert.lt(Math.abs(doc.p99 - 9900), 50, tojson(doc));
+        assert.eq(3, doc.tails.length, tojson(doc));
+        assert.eq(doc._id, doc.tails[0], tojson(doc));
+        assert.lt(Math.abs(doc.tails[1] - 5000), 100, tojson(doc));
+        assert.eq(9998 + doc._id, doc.tails[2], tojson(doc));
+        assert.eq(doc.tails[1], doc.median, tojson(doc));
+    }
+
+    // Groups without numeric values produce null.
+    result = coll.aggregate([
+                     {$match: {_id: 0}},
+                     {$group: {_id: null, median: {$medianApprox: "$missing"}}}
+                 ])
+                 .toArray();
+    assert.eq([{_id: null, median: null}], result);
+
+    // $medianApprox may also be used as an expression over an array.
+    result =
+        coll.aggregate([{$match: {_id: 0}}, {$project: {_id: 0, m: {$medianApprox: [[3, 1, 2]]}}}])
+            .toArray();
+    assert.eq([{m: 2}], result);
+
+    assertErrorCode(coll, [{$group: {_id: null, p: {$percentileApprox: "$latency"}}}], 50813);
+    assertErrorCode(
+        coll, [{$group: {_id: null, p: {$percentileApprox: {input: "$latency", p: 2}}}}], 50814);
+
+    // An approximate $bucketAuto splits the input into buckets of similar size without sorting it.
+    result = coll.aggregate([{$bucketAuto: {groupBy: "$latency", buckets: 4, approximate: true}}])
+                 .toArray();
+    assert.eq(4, result.length, tojson(result));
+    assert.eq(0, result[0]._id.min, tojson(result));
+    assert.eq(9999, result[3]._id.max, tojson(result));
+    for (let i = 0; i < result.length; i++) {
+        assert.lt(Math.abs(result[i].count - 2500), 50, tojson(result));
+        if (i > 0) {
+            assert.eq(result[i - 1]._id.max, result[i]._id.min, tojson(result));
+        }
+    }
+
+    assertErrorCode(
+        coll,
+        [{$bucketAuto: {groupBy: {$literal: "a"}, buckets: 2, approximate: true}}],
+        50816);
+}());
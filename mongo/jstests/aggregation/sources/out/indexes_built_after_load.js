@@ -0,0 +1,39 @@
+// Tests that $out preserves the indexes of the target collection, which are built on the temporary
+// collection after all of the output has been inserted, and that a unique index violated by the
+// output fails the $out while leaving the target collection untouched.
+(function() {
+    "use strict";
+
+    load("jstests/aggregation/extras/utils.js");  // For assertErrorCode.
+
+    const source = db.out_indexes_built_after_load_source;
+    const target = db.out_indexes_built_after_load_target;
+    source.drop();
+    target.drop();
+
+    const bulk = source.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, a: i, b: i % 10, c: [i, i + 1]});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.writeOK(target.insert({_id: "original", a: -1}));
+    assert.commandWorked(target.createIndex({a: 1}, {unique: true}));
+    assert.commandWorked(target.createIndex({b: 1, a: -1}));
+    assert.commandWorked(target.createIndex({c: 1}, {sparse: true}));
+    const originalIndexes = target.getIndexes();
+
+    source.aggregate([{$out: target.getName()}]);
+    assert.eq(1000, target.find().itcount());
+    assert.sameMembers(originalIndexes.map(index => index.name),
+                       target.getIndexes().map(index => index.name));
+    assert.eq(1, target.find({a: 500}).hint({a: 1}).itcount());
+    assert.eq(100, target.find({b: 3}).hint({b: 1, a: -1}).itcount());
+    assert.eq(2, target.find({c: 20}).hint({c: 1}).itcount());
+
+    // A duplicate value for the unique index is only detected when the indexes are built, which
+    // must fail the $out without replacing the target collection.
+    assertErrorCode(source, [{$project: {a: {$literal: 1}}}, {$out: target.getName()}], 16995);
+    assert.eq(1000, target.find().itcount());
+    assert.eq(4, target.getIndexes().length);
+}());
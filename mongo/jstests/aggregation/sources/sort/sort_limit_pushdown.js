@@ -0,0 +1,48 @@
+// Tests that a $sort with a coalesced $limit, whose order no index provides, is run by the query
+// system as a top-k SORT stage, unless allowDiskUse lets $sort spill, and that both return the same
+// documents.
+//
+// This test inspects the explain output of a single unsharded collection, and a pipeline wrapped in
+// a $facet is not pushed down.
+// @tags: [assumes_unsharded_collection, do_not_wrap_aggregations_in_facets]
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getAggPlanStage().
+
+    const coll = db.sort_limit_pushdown;
+    coll.drop();
+
+    const nDocs = 200;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < nDocs; i++) {
+        bulk.insert({_id: i, a: (i * 37) % nDocs, b: i % 3, padding: "x".repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+
+    const pipeline = [{$match: {b: {$ne: 1}}}, {$sort: {a: -1}}, {$limit: 5}];
+    const expected = coll.find({b: {$ne: 1}}).toArray()
+                         .sort(function(x, y) {
+                             return y.a - x.a;
+                         })
+                         .slice(0, 5);
+
+    // The $sort is absorbed into a SORT stage which keeps only the top 5 documents.
+    let explain = coll.explain().aggregate(pipeline);
+    const sortStage = getAggPlanStage(explain, "SORT");
+    assert.neq(null, sortStage, tojson(explain));
+    assert.eq(5, sortStage.limitAmount, tojson(explain));
+    assert.eq({a: -1}, sortStage.sortPattern, tojson(explain));
+    assert.eq(null, getAggPlanStage(explain, "$sort"), tojson(explain));
+    assert.eq(expected, coll.aggregate(pipeline).toArray());
+
+    // With allowDiskUse, $sort can spill where the SORT stage is bound by its memory limit.
+    explain = coll.explain().aggregate(pipeline, {allowDiskUse: true});
+    assert.eq(null, getAggPlanStage(explain, "SORT"), tojson(explain));
+    assert.neq(null, getAggPlanStage(explain, "$sort"), tojson(explain));
+    assert.eq(expected, coll.aggregate(pipeline, {allowDiskUse: true}).toArray());
+
+    // Ties on the sort key are still cut at the limit.
+    const tiedPipeline = [{$sort: {b: 1}}, {$limit: 10}, {$project: {_id: 0, b: 1}}];
+    assert.eq(Array(10).fill({b: 0}), coll.aggregate(tiedPipeline).toArray());
+})();
@@ -0,0 +1,52 @@
+/**
+ * Tests that a view over a collection of time-series buckets, built with $_internalUnpackBucket,
+ * returns the individual measurements and filters them by time and meta values.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/aggregation/extras/utils.js");  // For arrayEq.
+
+    const buckets = db.unpack_bucket_view_buckets;
+    buckets.drop();
+    assert.commandWorked(db.runCommand({drop: "unpack_bucket_view"}));
+
+    const minute = 60 * 1000;
+    const start = new Date(2018, 0, 1).getTime();
+
+    // One bucket per sensor per ten minutes, holding one measurement per minute.
+    const expected = [];
+    for (let sensor = 0; sensor < 3; ++sensor) {
+        for (let window = 0; window < 6; ++window) {
+            const data = [];
+            for (let i = 0; i < 10; ++i) {
+                const t = new Date(start + (window * 10 + i) * minute);
+                data.push({t: t, temp: sensor * 100 + window * 10 + i});
+                expected.push({t: t, temp: sensor * 100 + window * 10 + i, sensor: {id: sensor}});
+            }
+            assert.writeOK(buckets.insert({
+                meta: {id: sensor},
+                control: {min: {t: data[0].t}, max: {t: data[data.length - 1].t}},
+                data: data
+            }));
+        }
+    }
+    assert.commandWorked(buckets.createIndex({"meta.id": 1, "control.max.t": 1}));
+
+    const unpack = {$_internalUnpackBucket: {timeField: "t", metaField: "sensor"}};
+    assert.commandWorked(db.createView("unpack_bucket_view", buckets.getName(), [unpack]));
+    const view = db.unpack_bucket_view;
+
+    assert.eq(expected.length, view.find().itcount());
+    assert(arrayEq(expected, view.find().toArray()));
+
+    const from = new Date(start + 15 * minute);
+    const to = new Date(start + 42 * minute);
+    const inRange = (doc) => doc.t >= from && doc.t < to;
+    assert(arrayEq(expected.filter(inRange), view.find({t: {$gte: from, $lt: to}}).toArray()));
+    assert(arrayEq(expected.filter((doc) => inRange(doc) && doc.sensor.id === 1),
+                   view.find({t: {$gte: from, $lt: to}, "sensor.id": 1}).toArray()));
+    assert(arrayEq(expected.filter((doc) => doc.t.getTime() === from.getTime()),
+                   view.aggregate([{$match: {t: from}}]).toArray()));
+    assert.eq(0, view.find({"sensor.id": 7}).itcount());
+})();
@@ -37,7 +37,8 @@
 
     function assertQueryDoesNotCoverProjection(pipeline) {
         const explainOutput = coll.explain().aggregate(pipeline);
-        assert(aggPlanHasStage(explainOutput, "FETCH") || aggPlanHasStage("COLLSCAN"),
+        assert(aggPlanHasStage(explainOutput, "FETCH") ||
+                   aggPlanHasStage(explainOutput, "COLLSCAN"),
                "Expected pipeline " + tojsononeline(pipeline) +
                    " to include a FETCH or COLLSCAN stage in the explain output: " +
                    tojson(explainOutput));
@@ -62,6 +63,14 @@
     // Test that a pipeline requiring a field that is not in the index cannot use a covered plan.
     assertQueryDoesNotCoverProjection([{$match: {x: "string"}}, {$project: {notThere: 1}}]);
 
+    // Test that a pipeline with no predicate can still be covered by a whole index scan, so long as
+    // the index holds every field the pipeline needs.
+    assertQueryCoversProjection([{$group: {_id: "$x", total: {$sum: "$a"}}}]);
+    assertQueryCoversProjection([{$project: {_id: 0, x: 1, a: 1}}]);
+    assertQueryDoesNotCoverProjection([{$group: {_id: "$x", total: {$sum: "$y"}}}]);
+    assert.eq([{_id: "string", total: -4950}],
+              coll.aggregate([{$group: {_id: "$x", total: {$sum: "$a"}}}]).toArray());
+
     // Test that a covered plan is the only plan considered, even if another plan would be equally
     // selective. Add an equally selective index, then rely on assertQueryCoversProjection() to
     // assert that there is only one considered plan, and it is a covered plan.
@@ -1694,6 +1694,29 @@ var authCommandsLib = {
               }
           ]
         },
+        {
+          testname: "analyze",
+          command: {analyze: "x", key: "a"},
+          skipSharded: true,
+          setup: function(db) {
+              db.x.save({a: 1});
+          },
+          teardown: function(db) {
+              db.x.drop();
+          },
+          testcases: [
+              {
+                runOnDb: firstDbName,
+                roles: roles_read,
+                privileges: [{resource: {db: firstDbName, collection: "x"}, actions: ["find"]}]
+              },
+              {
+                runOnDb: secondDbName,
+                roles: roles_readAny,
+                privileges: [{resource: {db: secondDbName, collection: "x"}, actions: ["find"]}]
+              }
+          ]
+        },
         {
           testname: "appendOplogNote",
           command: {appendOplogNote: 1, data: {a: 1}},
@@ -1722,6 +1745,24 @@ var authCommandsLib = {
               {runOnDb: secondDbName, roles: {}}
           ]
         },
+        {
+          testname: "beginBackupCursor",
+          command: {beginBackupCursor: 1},
+          skipSharded: true,
+          teardown: function(db) {
+              db.getSisterDB(adminDbName).runCommand({endBackupCursor: 1});
+          },
+          testcases: [
+              {
+                runOnDb: adminDbName,
+                roles: roles_hostManager,
+                privileges: [{resource: {cluster: true}, actions: ["fsync"]}],
+                expectFail: true  // not every storage engine supports non-blocking backups
+              },
+              {runOnDb: firstDbName, roles: {}},
+              {runOnDb: secondDbName, roles: {}}
+          ]
+        },
         {
           testname: "buildInfo",
           command: {buildInfo: 1},
@@ -2856,6 +2897,21 @@ var authCommandsLib = {
               {runOnDb: secondDbName, roles: {}}
           ]
         },
+        {
+          testname: "endBackupCursor",
+          command: {endBackupCursor: 1},
+          skipSharded: true,
+          testcases: [
+              {
+                runOnDb: adminDbName,
+                roles: roles_hostManager,
+                privileges: [{resource: {cluster: true}, actions: ["fsync"]}],
+                expectFail: true
+              },
+              {runOnDb: firstDbName, roles: {}},
+              {runOnDb: secondDbName, roles: {}}
+          ]
+        },
         {
           testname: "lockInfo",
           command: {lockInfo: 1},
@@ -4300,6 +4356,30 @@ var authCommandsLib = {
               {runOnDb: secondDbName, roles: {}}
           ]
         },
+        {
+          testname: "planCollectionPartitions",
+          command: {planCollectionPartitions: "x", numPartitions: 2},
+          skipSharded: true,
+          setup: function(db) {
+              db.x.insert({_id: 5});
+              db.x.insert({_id: 6});
+          },
+          teardown: function(db) {
+              db.x.drop();
+          },
+          testcases: [
+              {
+                runOnDb: firstDbName,
+                roles: roles_read,
+                privileges: [{resource: {db: firstDbName, collection: "x"}, actions: ["find"]}]
+              },
+              {
+                runOnDb: secondDbName,
+                roles: roles_readAny,
+                privileges: [{resource: {db: secondDbName, collection: "x"}, actions: ["find"]}]
+              }
+          ]
+        },
         {
           testname: "planCacheIndexFilter",
           command: {planCacheClearFilters: "x"},
@@ -754,6 +754,16 @@
         planStage = getPlanStage(explainRes.executionStats.executionStages, "IDHACK");
         assert.eq(null, planStage);
 
+        // Find on _id should still use idhack stage when query collation does not match collection
+        // default, if the _id value cannot be affected by collation.
+        assert.writeOK(coll.insert({_id: 1}));
+        explainRes =
+            coll.explain("executionStats").find({_id: 1}).collation({locale: "fr_CA"}).finish();
+        assert.commandWorked(explainRes);
+        planStage = getPlanStage(explainRes.executionStats.executionStages, "IDHACK");
+        assert.neq(null, planStage);
+        assert.eq(1, explainRes.executionStats.nReturned);
+
         // Find with oplog replay should return correct results when "simple" collation specified
         // and collection has a default collation.
         coll.drop();
@@ -0,0 +1,35 @@
+/**
+ * Tests that count commands whose index bounds have several intervals are answered by count
+ * scans, and that counts over a multikey index do not double count documents.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    var coll = db.jstests_count_scan_multi_interval;
+    coll.drop();
+
+    for (var i = 0; i < 10; i++) {
+        assert.writeOK(coll.insert({a: i, b: i % 2}));
+    }
+    assert.commandWorked(coll.ensureIndex({a: 1, b: 1}));
+
+    function checkCountScan(query, expected) {
+        assert.eq(expected, coll.count(query), tojson(query));
+
+        var explain = coll.explain().count(query);
+        assert(planHasStage(explain.queryPlanner.winningPlan, "COUNT_SCAN"), tojson(explain));
+        assert(!planHasStage(explain.queryPlanner.winningPlan, "FETCH"), tojson(explain));
+    }
+
+    checkCountScan({a: {$in: [1, 3, 5]}}, 3);
+    checkCountScan({a: {$in: [1, 4]}, b: 0}, 1);
+    checkCountScan({a: {$in: [1, 4]}, b: {$in: [0, 1]}}, 2);
+    checkCountScan({a: {$in: [20, 30]}}, 0);
+
+    // Make the index multikey. A document matching several of the intervals must be counted once.
+    assert.writeOK(coll.insert({a: [1, 3, 5], b: 0}));
+    checkCountScan({a: {$in: [1, 3, 5]}}, 4);
+    checkCountScan({a: {$in: [3, 5]}, b: 0}, 1);
+})();
@@ -0,0 +1,37 @@
+// Tests the 'parallel' and 'orderIndependent' options of dbHash.
+(function() {
+    'use strict';
+
+    const testDB = db.getSiblingDB('dbhash_parallel');
+    assert.commandWorked(testDB.dropDatabase());
+
+    // Both collections hold the same documents, inserted in opposite orders.
+    for (let i = 0; i < 50; ++i) {
+        assert.writeOK(testDB.forward.insert({_id: i, x: 'a'.repeat(i)}));
+        assert.writeOK(testDB.backward.insert({_id: 49 - i, x: 'a'.repeat(49 - i)}));
+    }
+    for (let i = 0; i < 5; ++i) {
+        assert.commandWorked(testDB.createCollection('other' + i));
+        assert.writeOK(testDB['other' + i].insert({i: i}));
+    }
+
+    const serial = assert.commandWorked(testDB.runCommand({dbHash: 1}));
+    const parallel = assert.commandWorked(testDB.runCommand({dbHash: 1, parallel: 4}));
+    assert.eq(serial.collections, parallel.collections);
+    assert.eq(serial.md5, parallel.md5);
+
+    const unordered = assert.commandWorked(testDB.runCommand({dbHash: 1, orderIndependent: true}));
+    assert.eq(unordered.collections.forward, unordered.collections.backward);
+    assert.neq(unordered.collections.forward, unordered.collections.other0);
+    const unorderedParallel = assert.commandWorked(
+        testDB.runCommand({dbHash: 1, orderIndependent: true, parallel: 2}));
+    assert.eq(unordered.md5, unorderedParallel.md5);
+
+    // A different document changes the order independent hash.
+    assert.writeOK(testDB.backward.update({_id: 0}, {$set: {x: 'b'}}));
+    const changed = assert.commandWorked(testDB.runCommand({dbHash: 1, orderIndependent: true}));
+    assert.neq(changed.collections.forward, changed.collections.backward);
+
+    assert.commandFailed(testDB.runCommand({dbHash: 1, parallel: 0}));
+    assert.commandFailed(testDB.runCommand({dbHash: 1, orderIndependent: 1}));
+}());
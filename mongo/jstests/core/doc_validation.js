@@ -280,4 +280,31 @@
     assert.writeError(res);
     assert.eq(res.getWriteError().code, 16608);
     assert.writeOK(coll.insert({a: -1, b: -1}));
+
+    // Updates which do not change the layout of the document are applied in place. Validation
+    // must still be enforced and a rejected update must leave the document untouched.
+    coll.drop();
+    assert.commandWorked(db.createCollection(collName, {validator: {a: {$gte: 0}}}));
+    assert.writeOK(coll.insert({_id: 0, a: 5, padding: array}));
+    assert.writeOK(coll.update({_id: 0}, {$inc: {a: 1}}));
+    assertFailsValidation(coll.update({_id: 0}, {$inc: {a: -10}}));
+    assertFailsValidation(
+        coll.runCommand("findAndModify", {query: {_id: 0}, update: {$inc: {a: -10}}}));
+    assert.eq(6, coll.findOne({_id: 0}).a);
+
+    // With moderate validation, an in-place update must be checked against the document as it
+    // was before the update: invalid documents may stay invalid, but valid ones may not become so.
+    coll.drop();
+    assert.writeOK(coll.insert({_id: 0, a: 5, padding: array}));
+    assert.writeOK(coll.insert({_id: 1, a: -5, padding: array}));
+    assert.commandWorked(
+        db.runCommand({collMod: collName, validator: {a: {$gte: 0}}, validationLevel: "moderate"}));
+    assert.writeOK(coll.update({_id: 1}, {$inc: {a: 1}}));
+    assert.eq(-4, coll.findOne({_id: 1}).a);
+    assertFailsValidation(coll.update({_id: 0}, {$inc: {a: -10}}));
+    assertFailsValidation(
+        coll.runCommand("findAndModify", {query: {_id: 0}, update: {$inc: {a: -10}}}));
+    assert.eq(5, coll.findOne({_id: 0}).a);
+    assert.writeOK(coll.update({_id: 0}, {$inc: {a: 1}}));
+    assert.eq(6, coll.findOne({_id: 0}).a);
 })();
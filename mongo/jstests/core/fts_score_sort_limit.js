@@ -0,0 +1,66 @@
+// Tests that a $text query sorted on the text score with a limit returns the highest scoring
+// documents, and that only those documents are fetched.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const coll = db.fts_score_sort_limit;
+    coll.drop();
+
+    // Document i mentions "common" i % 10 + 1 times, so scores increase with i % 10.
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 200; ++i) {
+        bulk.insert({_id: i, a: Array(i % 10 + 1).fill("common").join(" ") + " filler words here"});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: "text"}));
+
+    function topScores(query, limit) {
+        let cursor = coll.find(query, {score: {$meta: "textScore"}}).sort({
+            score: {$meta: "textScore"}
+        });
+        if (limit) {
+            cursor = cursor.limit(limit);
+        }
+        return cursor.toArray().map(doc => doc.score);
+    }
+
+    const query = {$text: {$search: "common"}};
+    const allScores = topScores(query);
+    assert.eq(allScores.length, 200);
+    [1, 5, 20, 25, 199].forEach(limit => {
+        assert.eq(topScores(query, limit), allScores.slice(0, limit), "limit " + limit);
+    });
+
+    // Skipped documents still need to be considered.
+    const skipped = coll.find(query, {score: {$meta: "textScore"}})
+                        .sort({score: {$meta: "textScore"}})
+                        .skip(20)
+                        .limit(5)
+                        .toArray()
+                        .map(doc => doc.score);
+    assert.eq(skipped, allScores.slice(20, 25));
+
+    // Negated terms are checked against the fetched documents, so every match is returned.
+    assert.eq(topScores({$text: {$search: "common -missing"}}, 5), allScores.slice(0, 5));
+
+    const isMongos = db.runCommand({isMaster: 1}).msg === "isdbgrid";
+    if (!isMongos) {
+        const explain = coll.find(query, {score: {$meta: "textScore"}})
+                            .sort({score: {$meta: "textScore"}})
+                            .limit(5)
+                            .explain("executionStats");
+        const textOr = getPlanStage(explain.executionStats.executionStages, "TEXT_OR");
+        assert.neq(null, textOr, tojson(explain));
+        assert.eq(textOr.fetches, 5, tojson(explain));
+
+        // Without a limit, every match is fetched.
+        const unlimited = coll.find(query, {score: {$meta: "textScore"}})
+                              .sort({score: {$meta: "textScore"}})
+                              .explain("executionStats");
+        assert.eq(getPlanStage(unlimited.executionStats.executionStages, "TEXT_OR").fetches,
+                  200,
+                  tojson(unlimited));
+    }
+})();
@@ -0,0 +1,79 @@
+// Tests the read and write cost statistics reported by $indexStats.
+// @tags: [assumes_unsharded_collection, does_not_support_stepdowns, requires_non_retryable_writes]
+
+(function() {
+    "use strict";
+
+    var col = db.jstests_index_stats_costs;
+    col.drop();
+
+    var getIndexStats = function(indexName) {
+        var stats = col.aggregate([{$indexStats: {}}, {$match: {name: indexName}}]).toArray();
+        assert.eq(1, stats.length, tojson(stats));
+        return stats[0];
+    };
+
+    assert.commandWorked(col.createIndex({a: 1}, {name: "a_1"}));
+
+    var stats = getIndexStats("a_1");
+    assert.eq({keysExamined: 0, seeks: 0, docsReturned: 0}, stats.reads, tojson(stats));
+    assert.eq({ops: 0, keysInserted: 0, keysDeleted: 0, micros: 0}, stats.writes, tojson(stats));
+
+    //
+    // Inserts are charged to every index they add keys to.
+    //
+    for (var i = 0; i < 10; i++) {
+        assert.writeOK(col.insert({a: i}));
+    }
+    stats = getIndexStats("a_1");
+    assert.eq(10, stats.writes.ops, tojson(stats));
+    assert.eq(10, stats.writes.keysInserted, tojson(stats));
+    assert.eq(0, stats.writes.keysDeleted, tojson(stats));
+    assert.gte(stats.writes.micros, 0, tojson(stats));
+    assert.eq(10, getIndexStats("_id_").writes.keysInserted);
+
+    //
+    // Updates which change an indexed field replace its key. Others leave the index alone.
+    //
+    assert.writeOK(col.update({a: 9}, {$set: {a: 19}}));
+    stats = getIndexStats("a_1");
+    assert.eq(11, stats.writes.keysInserted, tojson(stats));
+    assert.eq(1, stats.writes.keysDeleted, tojson(stats));
+    assert.eq(10, getIndexStats("_id_").writes.keysInserted);
+
+    //
+    // Reads report the keys they examined against the documents they returned.
+    //
+    var readsBefore = getIndexStats("a_1").reads;
+    assert.eq(5, col.find({a: {$gte: 5}}).itcount());
+    stats = getIndexStats("a_1");
+    assert.eq(readsBefore.keysExamined + 5, stats.reads.keysExamined, tojson(stats));
+    assert.eq(readsBefore.seeks + 1, stats.reads.seeks, tojson(stats));
+    assert.eq(readsBefore.docsReturned + 5, stats.reads.docsReturned, tojson(stats));
+    assert.gt(stats.reads.keysExaminedPerDocReturned, 0, tojson(stats));
+
+
+    //
+    // Removes are charged to every index they remove keys from.
+    //
+    assert.writeOK(col.remove({a: 19}));
+    stats = getIndexStats("a_1");
+    assert.eq(2, stats.writes.keysDeleted, tojson(stats));
+    assert.eq(1, getIndexStats("_id_").writes.keysDeleted);
+
+    //
+    // Storage engines that can tell how much of the index is cached report it.
+    //
+    if (db.serverStatus().storageEngine.name === "wiredTiger") {
+        assert.gte(getIndexStats("a_1").cacheBytes, 0);
+    }
+
+    //
+    // Costs start again from zero when the index is recreated.
+    //
+    assert.commandWorked(col.dropIndex("a_1"));
+    assert.commandWorked(col.createIndex({a: 1}, {name: "a_1"}));
+    stats = getIndexStats("a_1");
+    assert.eq(0, stats.writes.keysInserted, tojson(stats));
+    assert.eq(0, stats.reads.keysExamined, tojson(stats));
+})();
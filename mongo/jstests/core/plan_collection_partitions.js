@@ -0,0 +1,57 @@
+// Tests that planCollectionPartitions returns contiguous _id ranges that together cover the
+// collection exactly once.
+// @tags: [assumes_against_mongod_not_mongos, assumes_unsharded_collection]
+(function() {
+    "use strict";
+
+    const coll = db.plan_collection_partitions;
+    coll.drop();
+
+    // Mix _id types: index bounds order across types, which a $gte/$lt filter would not.
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 500; ++i) {
+        bulk.insert({_id: i});
+        bulk.insert({_id: "s" + i});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandFailedWithCode(db.runCommand({planCollectionPartitions: coll.getName()}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(
+        db.runCommand({planCollectionPartitions: "does_not_exist", numPartitions: 2}),
+        ErrorCodes.NamespaceNotFound);
+
+    let res = assert.commandWorked(
+        db.runCommand({planCollectionPartitions: coll.getName(), numPartitions: 1}));
+    assert.eq([{}], res.partitions, tojson(res));
+
+    res = assert.commandWorked(
+        db.runCommand({planCollectionPartitions: coll.getName(), numPartitions: 8}));
+    const partitions = res.partitions;
+    assert.gte(partitions.length, 1, tojson(res));
+    assert.lte(partitions.length, 8, tojson(res));
+    assert(!partitions[0].hasOwnProperty("min"), tojson(res));
+    assert(!partitions[partitions.length - 1].hasOwnProperty("max"), tojson(res));
+
+    const seen = {};
+    let total = 0;
+    partitions.forEach(function(partition, i) {
+        if (i > 0) {
+            assert.eq(partitions[i - 1].max, partition.min, tojson(res));
+        }
+        let cursor = coll.find().hint({_id: 1});
+        if (partition.min) {
+            cursor = cursor.min(partition.min);
+        }
+        if (partition.max) {
+            cursor = cursor.max(partition.max);
+        }
+        cursor.forEach(function(doc) {
+            const key = tojson(doc._id);
+            assert(!seen.hasOwnProperty(key), "document read twice: " + key);
+            seen[key] = true;
+            ++total;
+        });
+    });
+    assert.eq(coll.count(), total);
+})();
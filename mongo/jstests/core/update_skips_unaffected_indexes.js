@@ -0,0 +1,38 @@
+// Tests that updates which only touch some indexed paths keep every index consistent with the
+// documents, including multikey and partial indexes.
+(function() {
+    "use strict";
+
+    const coll = db.update_skips_unaffected_indexes;
+    coll.drop();
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({"b.c": 1}));
+    assert.commandWorked(coll.createIndex({tags: 1}));
+    assert.commandWorked(coll.createIndex({d: 1}, {partialFilterExpression: {e: {$gt: 0}}}));
+
+    assert.writeOK(coll.insert({_id: 0, a: 1, b: {c: 1}, tags: [1, 2, 3], d: 1, e: 0}));
+
+    // Update an unindexed field, then each of the indexed ones.
+    assert.writeOK(coll.update({_id: 0}, {$set: {x: 1}}));
+    assert.writeOK(coll.update({_id: 0}, {$inc: {a: 1}}));
+    assert.writeOK(coll.update({_id: 0}, {$set: {"b.c": 2}}));
+    assert.writeOK(coll.update({_id: 0}, {$push: {tags: 4}}));
+    assert.writeOK(coll.update({_id: 0}, {$set: {e: 1}}));
+
+    assert.eq(1, coll.find({a: 2}).hint({a: 1}).itcount());
+    assert.eq(0, coll.find({a: 1}).hint({a: 1}).itcount());
+    assert.eq(1, coll.find({"b.c": 2}).hint({"b.c": 1}).itcount());
+    assert.eq(1, coll.find({tags: 4}).hint({tags: 1}).itcount());
+    assert.eq(1, coll.find({d: 1, e: {$gt: 0}}).hint({d: 1}).itcount());
+
+    // Replacing the document must update every index.
+    assert.writeOK(coll.update({_id: 0}, {a: 5, b: {c: 5}, tags: [5], d: 5, e: 5}));
+    assert.eq(1, coll.find({a: 5}).hint({a: 1}).itcount());
+    assert.eq(1, coll.find({"b.c": 5}).hint({"b.c": 1}).itcount());
+    assert.eq(1, coll.find({tags: 5}).hint({tags: 1}).itcount());
+    assert.eq(1, coll.find({d: 5, e: {$gt: 0}}).hint({d: 1}).itcount());
+
+    const res = assert.commandWorked(coll.validate(true));
+    assert(res.valid, tojson(res));
+})();
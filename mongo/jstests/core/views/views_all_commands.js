@@ -106,6 +106,7 @@
         balancerStart: {skip: isUnrelated},
         balancerStatus: {skip: isUnrelated},
         balancerStop: {skip: isUnrelated},
+        beginBackupCursor: {skip: isUnrelated},
         buildInfo: {skip: isUnrelated},
         captrunc: {
             command: {captrunc: "view", n: 2, inc: false},
@@ -208,6 +209,7 @@
             expectFailure: true,
         },
         enableSharding: {skip: "Tested as part of shardCollection"},
+        endBackupCursor: {skip: isUnrelated},
         endSessions: {skip: isUnrelated},
         eval: {skip: isUnrelated},
         explain: {command: {explain: {count: "view"}}},
@@ -370,6 +372,8 @@
         netstat: {skip: isAnInternalCommand},
         parallelCollectionScan: {command: {parallelCollectionScan: "view"}, expectFailure: true},
         ping: {command: {ping: 1}},
+        planCollectionPartitions:
+            {command: {planCollectionPartitions: "view", numPartitions: 2}, expectFailure: true},
         planCacheClear: {command: {planCacheClear: "view"}, expectFailure: true},
         planCacheClearFilters: {command: {planCacheClearFilters: "view"}, expectFailure: true},
         planCacheListFilters: {command: {planCacheListFilters: "view"}, expectFailure: true},
@@ -489,7 +493,9 @@
             expectFailure: true,
         },
         stageDebug: {skip: isAnInternalCommand},
+        startRecordingTraffic: {skip: isUnrelated},
         startSession: {skip: isAnInternalCommand},
+        stopRecordingTraffic: {skip: isUnrelated},
         top: {skip: "tested in views/views_stats.js"},
         touch: {
             command: {touch: "view", data: true},
@@ -0,0 +1,28 @@
+/**
+ * Tests that commands accept the generic 'admissionPriority' argument and reject unknown values.
+ */
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const testDB = conn.getDB('test');
+    const coll = testDB.admission_priority;
+
+    for (let priority of ['low', 'normal', 'high']) {
+        assert.commandWorked(testDB.runCommand(
+            {insert: coll.getName(), documents: [{priority: priority}], admissionPriority: priority}));
+        assert.commandWorked(testDB.runCommand(
+            {find: coll.getName(), filter: {priority: priority}, admissionPriority: priority}));
+        assert.commandWorked(
+            testDB.runCommand({count: coll.getName(), admissionPriority: priority}));
+    }
+
+    assert.commandFailedWithCode(
+        testDB.runCommand({find: coll.getName(), admissionPriority: 'urgent'}), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(testDB.runCommand({find: coll.getName(), admissionPriority: 1}),
+                                 ErrorCodes.BadValue);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,63 @@
+/**
+ * Tests that the files listed by beginBackupCursor can be copied while the server keeps taking
+ * writes, and that a mongod started on the copy sees the data written before the backup.
+ */
+(function() {
+    "use strict";
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    var storageEngine = jsTest.options().storageEngine || "wiredTiger";
+    if (storageEngine !== "wiredTiger") {
+        print('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    var conn = MongoRunner.runMongod({storageEngine: "wiredTiger"});
+    assert.neq(null, conn, "mongod was unable to start up");
+    var admin = conn.getDB("admin");
+    var coll = conn.getDB("test").backup_cursor;
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, x: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({x: 1}));
+    assert.commandWorked(admin.runCommand({fsync: 1}));
+
+    var res = assert.commandWorked(admin.runCommand({beginBackupCursor: 1}));
+    assert.eq(conn.dbpath, res.dbpath);
+    var filenames = res.files.map(function(file) {
+        return file.filename;
+    });
+    assert.contains("WiredTiger", filenames, tojson(res));
+    assert.contains("_mdb_catalog.wt", filenames, tojson(res));
+
+    // Only one backup can be open at a time, including the one taken by fsyncLock.
+    assert.commandFailedWithCode(admin.runCommand({beginBackupCursor: 1}),
+                                 ErrorCodes.IllegalOperation);
+    assert.commandFailed(admin.runCommand({fsync: 1, lock: 1}));
+
+    // Writes carry on while the backup is open.
+    assert.writeOK(coll.insert({_id: "afterBackup"}));
+
+    var copyPath = MongoRunner.dataPath + "backup_cursor_copy";
+    resetDbpath(copyPath);
+    mkdir(copyPath + "/journal");
+    filenames.forEach(function(filename) {
+        copyFile(res.dbpath + "/" + filename, copyPath + "/" + filename);
+    });
+
+    assert.commandWorked(admin.runCommand({endBackupCursor: 1}));
+    assert.commandFailedWithCode(admin.runCommand({endBackupCursor: 1}),
+                                 ErrorCodes.IllegalOperation);
+    MongoRunner.stopMongod(conn);
+
+    var copy = MongoRunner.runMongod(
+        {storageEngine: "wiredTiger", dbpath: copyPath, noCleanData: true});
+    assert.neq(null, copy, "mongod was unable to start up on the backup");
+    var copyColl = copy.getDB("test").backup_cursor;
+    assert.eq(1000, copyColl.find({x: {$gte: 0}}).hint({x: 1}).itcount());
+    assert.commandWorked(copyColl.validate(true));
+    MongoRunner.stopMongod(copy);
+})();
@@ -0,0 +1,43 @@
+// Tests benchRun's "changeStream" op, which opens a change stream and then repeatedly waits for
+// new events on it.
+(function() {
+    "use strict";
+
+    // For supportsMajorityReadConcern().
+    load("jstests/multiVersion/libs/causal_consistency_helpers.js");
+
+    if (!supportsMajorityReadConcern()) {
+        jsTestLog("Skipping test since storage engine doesn't support majority read concern.");
+        return;
+    }
+
+    const rst = new ReplSetTest({nodes: 1});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const coll = primary.getDB("test")[jsTestName()];
+    assert.commandWorked(coll.getDB().createCollection(coll.getName()));
+
+    const res = benchRun({
+        ops: [
+            {ns: coll.getFullName(), op: "changeStream", maxAwaitTimeMS: 100},
+            {
+              ns: coll.getFullName(),
+              op: "insert",
+              doc: {x: 1},
+              writeCmd: true,
+              writeConcern: {w: "majority"}
+            }
+        ],
+        parallel: 2,
+        seconds: 5,
+        host: primary.host
+    });
+
+    assert.gt(res.changeStream, 0, tojson(res));
+    assert.gt(res.changeStreamEvents, 0, tojson(res));
+    assert(res.latencyPercentilesMicros.changeStream, tojson(res));
+
+    rst.stopSet();
+})();
@@ -0,0 +1,76 @@
+/**
+ * Tests the summarized mode of $currentOp, which reports operations from the state their clients
+ * publish without locking, and that killOp finds operations by that state.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const adminDB = conn.getDB("admin");
+    const coll = testDB.currentop_summary;
+
+    coll.drop();
+    assert.writeOK(coll.insert({_id: 1}));
+
+    // Run a long operation to report on.
+    const awaitShell = startParallelShell(function() {
+        const res = db.getSiblingDB("test").runCommand({
+            find: "currentop_summary",
+            filter: {$where: "sleep(1000 * 60 * 60); return true;"}
+        });
+        assert.commandFailedWithCode(res, ErrorCodes.Interrupted);
+    }, conn.port);
+
+    function currentOp(spec, match) {
+        return adminDB.aggregate([{$currentOp: spec}, {$match: match}]).toArray();
+    }
+
+    let summary;
+    assert.soon(function() {
+        const ops = currentOp({summary: true}, {active: true, ns: coll.getFullName()});
+        if (ops.length !== 1) {
+            return false;
+        }
+        summary = ops[0];
+        return true;
+    }, () => tojson(currentOp({summary: true}, {})));
+
+    // The summary only has the fields published without locking the client.
+    assert(summary.hasOwnProperty("host"), tojson(summary));
+    assert(summary.hasOwnProperty("opid"), tojson(summary));
+    assert(summary.hasOwnProperty("desc"), tojson(summary));
+    assert(summary.hasOwnProperty("connectionId"), tojson(summary));
+    assert(summary.hasOwnProperty("client"), tojson(summary));
+    assert(summary.hasOwnProperty("secs_running"), tojson(summary));
+    assert(!summary.hasOwnProperty("command"), tojson(summary));
+    assert(!summary.hasOwnProperty("locks"), tojson(summary));
+
+    // Conditions on summary fields are checked before the full report is built, and give the
+    // same answer as the $match applied to the full reports.
+    let full = currentOp({}, {active: true, ns: coll.getFullName(), opid: summary.opid});
+    assert.eq(1, full.length, tojson(full));
+    assert.eq(summary.connectionId, full[0].connectionId, tojson(full));
+    assert(full[0].hasOwnProperty("command"), tojson(full));
+
+    full = currentOp({}, {active: true, ns: coll.getFullName(), opid: summary.opid + 1000000});
+    assert.eq(0, full.length, tojson(full));
+
+    // Filters on fields which are only in the full report still work.
+    full = currentOp({}, {ns: coll.getFullName(), "command.find": coll.getName()});
+    assert.eq(1, full.length, tojson(full));
+
+    // Idle connections are only summarized when asked for.
+    assert.eq(0, currentOp({summary: true}, {active: false}).length);
+    assert.lte(1, currentOp({summary: true, idleConnections: true}, {active: false}).length);
+
+    // killOp finds the operation by its published opid.
+    assert.commandWorked(adminDB.killOp(summary.opid));
+    assert.soon(function() {
+        return currentOp({summary: true}, {active: true, ns: coll.getFullName()}).length === 0;
+    });
+
+    awaitShell();
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,62 @@
+/**
+ * Tests that find cursors return the same results, in the same order, when the server prefetches
+ * their next batch in the background between getMores.
+ */
+(function() {
+    'use strict';
+
+    const options = {setParameter: 'internalQueryCursorPrefetchMaxBytes=' + 16 * 1024 * 1024};
+    const conn = MongoRunner.runMongod(options);
+    assert.neq(null, conn, 'mongod was unable to start up with options: ' + tojson(options));
+
+    const testDB = conn.getDB('test');
+    const coll = testDB.cursor_prefetch;
+    coll.drop();
+
+    const numDocs = 1000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < numDocs; ++i) {
+        bulk.insert({_id: i, a: i % 7, padding: 'x'.repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    function checkResults(cursor, expectedIds) {
+        const ids = cursor.toArray().map(doc => doc._id);
+        assert.eq(expectedIds, ids);
+    }
+
+    const allIds = Array.from({length: numDocs}, (_, i) => i);
+
+    // A collection scan, in several batch sizes. Prefetching honours the batch size of the
+    // previous getMore, as well as the 16MB limit when there is none.
+    checkResults(coll.find().sort({$natural: 1}).batchSize(10), allIds);
+    checkResults(coll.find().sort({$natural: 1}).batchSize(101), allIds);
+    checkResults(coll.find().sort({$natural: 1}).batchSize(1), allIds);
+
+    // An index scan with a sort.
+    const byA = allIds.slice().sort((x, y) => (x % 7) - (y % 7) || x - y);
+    checkResults(coll.find().sort({a: 1, _id: 1}).hint({a: 1}).batchSize(25), byA);
+
+    // A limit which ends in the middle of a prefetched batch.
+    checkResults(coll.find().sort({_id: 1}).limit(333).batchSize(50), allIds.slice(0, 333));
+
+    // Interleaved cursors on the same collection.
+    const cursors = [0, 1, 2].map(() => coll.find().sort({_id: 1}).batchSize(7));
+    const results = [[], [], []];
+    for (let i = 0; i < numDocs; ++i) {
+        cursors.forEach((cursor, j) => results[j].push(cursor.next()._id));
+    }
+    results.forEach(ids => assert.eq(allIds, ids));
+
+    // Killing a cursor with a prefetched batch.
+    const res = assert.commandWorked(testDB.runCommand({find: coll.getName(), batchSize: 2}));
+    const cursorId = res.cursor.id;
+    assert.commandWorked(
+        testDB.runCommand({getMore: cursorId, collection: coll.getName(), batchSize: 2}));
+    assert.commandWorked(testDB.runCommand({killCursors: coll.getName(), cursors: [cursorId]}));
+    assert.commandFailed(
+        testDB.runCommand({getMore: cursorId, collection: coll.getName(), batchSize: 2}));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,43 @@
+// Verify that the high frequency metrics are reported as fixed length arrays in the diagnostic data
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            diagnosticDataCollectionPeriodMillis: 1000,
+            diagnosticDataCollectionHighFrequencyPeriodMillis: 100
+        }
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+    const adminDb = conn.getDB("admin");
+
+    assert.commandFailed(
+        adminDb.runCommand({setParameter: 1, diagnosticDataCollectionHighFrequencyPeriodMillis: 5}));
+
+    const testDb = conn.getDB("test");
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(testDb.coll.insert({_id: i}));
+    }
+
+    let highFrequency;
+    assert.soon(function() {
+        const result = assert.commandWorked(adminDb.runCommand("getDiagnosticData"));
+        highFrequency = result.data.highFrequency;
+        return highFrequency !== undefined && highFrequency.samples > 0 &&
+            highFrequency.insert[highFrequency.insert.length - 1] >= 100;
+    }, "high frequency metrics were not reported", 60 * 1000);
+
+    assert.eq(100, highFrequency.periodMillis, tojson(highFrequency));
+    assert.eq(10, highFrequency.insert.length, tojson(highFrequency));
+    assert.eq(10, highFrequency.bytesIn.length, tojson(highFrequency));
+
+    // Disabling the sampling keeps the section but reports no samples.
+    assert.commandWorked(
+        adminDb.runCommand({setParameter: 1, diagnosticDataCollectionHighFrequencyPeriodMillis: 0}));
+    assert.soon(function() {
+        const result = assert.commandWorked(adminDb.runCommand("getDiagnosticData"));
+        return result.data.highFrequency.insert.length === 0;
+    }, "high frequency metrics were still reported", 60 * 1000);
+
+    MongoRunner.stopMongod(conn);
+})();
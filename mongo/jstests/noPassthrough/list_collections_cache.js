@@ -0,0 +1,49 @@
+/**
+ * Tests that listCollections returns up to date results when responses for a database are served
+ * from the cached collection listing, including for filters on a collection name prefix.
+ */
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({setParameter: {listCollectionsCacheMinCollections: 3}});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const testDB = conn.getDB('test');
+    assert.commandWorked(testDB.dropDatabase());
+
+    function listNames(filter) {
+        const res = assert.commandWorked(testDB.runCommand({listCollections: 1, filter: filter}));
+        return new DBCommandCursor(testDB, res).toArray().map(spec => spec.name).sort();
+    }
+
+    for (let name of ['a1', 'a2', 'b1', 'b2']) {
+        assert.commandWorked(testDB.createCollection(name));
+    }
+
+    // The first listing builds the cache entry and the second one is served from it.
+    assert.eq(['a1', 'a2', 'b1', 'b2'], listNames({}));
+    assert.eq(['a1', 'a2', 'b1', 'b2'], listNames({}));
+    assert.eq(['a1', 'a2'], listNames({name: /^a/}));
+    assert.eq(['b2'], listNames({$and: [{name: /^b/}, {name: /2$/}]}));
+    assert.eq([], listNames({name: /^c/}));
+
+    // Catalog changes must be visible to the next listing.
+    assert.commandWorked(testDB.createCollection('a3', {capped: true, size: 4096}));
+    assert.eq(['a1', 'a2', 'a3'], listNames({name: /^a/}));
+    assert.eq(['a3'], listNames({'options.capped': true}));
+
+    assert(testDB.a1.drop());
+    assert.eq(['a2', 'a3'], listNames({name: /^a/}));
+
+    assert.commandWorked(testDB.adminCommand({renameCollection: 'test.b1', to: 'test.a1'}));
+    assert.eq(['a1', 'a2', 'a3', 'b2'], listNames({}));
+
+    assert.commandWorked(testDB.a2.createIndex({x: 1}));
+    const res = assert.commandWorked(testDB.runCommand({listIndexes: 'a2'}));
+    assert.eq(2, new DBCommandCursor(testDB, res).toArray().length);
+
+    assert.commandWorked(testDB.dropDatabase());
+    assert.eq([], listNames({}));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,52 @@
+/**
+ * Verifies that with journalCommitWaitersThreshold set, the MMAPv1 durability thread starts group
+ * commits as soon as enough j:true writers are waiting, and that several outstanding journal
+ * write buffers can be configured.
+ */
+(function() {
+    "use strict";
+
+    if (jsTest.options().storageEngine !== "mmapv1") {
+        jsTestLog("Storage engine is not mmapv1, skipping test");
+        return;
+    }
+
+    // A long commit interval makes purely timer driven commits easy to tell apart.
+    const conn = MongoRunner.runMongod({
+        journal: "",
+        journalCommitInterval: 500,
+        setParameter: {journalAsyncWriteBuffers: 4, journalCommitWaitersThreshold: 1}
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.mmapv1_journal_group_commit;
+
+    assert.eq(4, assert.commandWorked(testDB.adminCommand({
+                     getParameter: 1,
+                     journalAsyncWriteBuffers: 1
+                 })).journalAsyncWriteBuffers);
+
+    // Keep j:true writers queued behind the group commit in progress until told to stop.
+    const awaitWriters = [0, 1].map(i => startParallelShell(
+        "while (db.mmapv1_journal_group_commit_stop.findOne() === null) {" +
+            "assert.writeOK(db.mmapv1_journal_group_commit.insert({w: " + i +
+            "}, {writeConcern: {j: true}}));" +
+            "}",
+        conn.port));
+
+    // The statistics are reported for the previous interval, so wait for it to roll over.
+    assert.soon(function() {
+        assert.writeOK(coll.insert({w: "main"}, {writeConcern: {j: true}}));
+        return testDB.serverStatus().dur.earlyCommits > 0;
+    }, "earlyCommits was never reported");
+
+    assert.writeOK(testDB.mmapv1_journal_group_commit_stop.insert({}));
+    awaitWriters.forEach(awaitShell => awaitShell());
+
+    // Turning the threshold off restores the timer driven commits.
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, journalCommitWaitersThreshold: 0}));
+    assert.writeOK(coll.insert({}, {writeConcern: {j: true}}));
+
+    MongoRunner.stopMongod(conn);
+})();
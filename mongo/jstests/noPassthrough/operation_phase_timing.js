@@ -0,0 +1,35 @@
+/**
+ * Tests that per-phase operation timings are only reported in the profiler when the
+ * 'operationPhaseTimingEnabled' server parameter is set.
+ */
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    const testDB = conn.getDB('test');
+    const coll = testDB.operation_phase_timing;
+    assert.writeOK(coll.insert({_id: 0, a: 0}));
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(testDB.setProfilingLevel(2));
+
+    function lastFindEntry(comment) {
+        assert.eq(1, coll.find({a: 0}).comment(comment).itcount());
+        const entry = testDB.system.profile.findOne({'command.comment': comment});
+        assert.neq(null, entry);
+        return entry;
+    }
+
+    assert(!lastFindEntry('disabled').hasOwnProperty('phaseMicros'));
+
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, operationPhaseTimingEnabled: true}));
+    const entry = lastFindEntry('enabled');
+    assert(entry.hasOwnProperty('phaseMicros'), tojson(entry));
+    for (let phase in entry.phaseMicros) {
+        assert(['parse', 'plan', 'yield', 'writeConcern', 'reply'].includes(phase), tojson(entry));
+        assert.gte(entry.phaseMicros[phase], 0, tojson(entry));
+    }
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,74 @@
+/**
+ * Tests that the plan cache warmup job saves the shapes of cached plans to local.planCacheShapes,
+ * and re-plans them into the plan cache once the node restarts. Shapes of collections which no
+ * longer exist are counted as failed.
+ */
+(function() {
+    'use strict';
+
+    const options = {
+        setParameter: {planCacheWarmupEnabled: true, planCacheWarmupSnapshotIntervalSecs: 1}
+    };
+
+    let conn = MongoRunner.runMongod(options);
+    assert.neq(null, conn, 'mongod was unable to start up');
+    let testDB = conn.getDB('test');
+
+    function setUpCollection(coll) {
+        assert.commandWorked(coll.createIndex({a: 1}));
+        assert.commandWorked(coll.createIndex({b: 1}));
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let i = 0; i < 100; i++) {
+            bulk.insert({a: i % 10, b: i % 7});
+        }
+        assert.writeOK(bulk.execute());
+    }
+    setUpCollection(testDB.coll);
+    setUpCollection(testDB.dropped);
+
+    // Both indexes can answer these queries, so the winning plans are cached.
+    const query = {a: 1, b: 1};
+    const sortedQuery = {a: {$gte: 5}, b: 3};
+    assert.eq(2, testDB.coll.find(query).itcount());
+    assert.eq(6, testDB.coll.find(sortedQuery).sort({a: 1}).itcount());
+    assert.eq(2, testDB.dropped.find(query).itcount());
+    assert.eq(2, testDB.coll.getPlanCache().listQueryShapes().length);
+
+    function savedShapes(ns) {
+        const doc = conn.getDB('local').planCacheShapes.findOne({_id: ns});
+        return doc ? doc.shapes : [];
+    }
+    assert.soon(function() {
+        return savedShapes('test.coll').length === 2 && savedShapes('test.dropped').length === 1;
+    }, 'plan cache shapes were not saved');
+
+    const savedShape = savedShapes('test.coll').find(function(shape) {
+        return bsonWoCompare(shape.sort, {a: 1}) === 0;
+    });
+    assert.eq(sortedQuery, savedShape.query, tojson(savedShapes('test.coll')));
+    assert.eq({}, savedShape.projection, tojson(savedShape));
+
+    // The saved shapes of a collection outlive it until the next restart.
+    assert(testDB.dropped.drop());
+
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod(Object.merge({restart: conn, cleanData: false}, options));
+    assert.neq(null, conn, 'mongod was unable to restart');
+    testDB = conn.getDB('test');
+
+    assert.soon(function() {
+        const warmup = testDB.serverStatus().metrics.query.planCacheWarmup;
+        return warmup.shapesReplanned + warmup.shapesFailed === 3;
+    }, 'plan cache warmup did not finish: ' + tojson(testDB.serverStatus().metrics.query));
+    const warmup = testDB.serverStatus().metrics.query.planCacheWarmup;
+    assert.eq(2, warmup.shapesReplanned, tojson(warmup));
+    assert.eq(1, warmup.shapesFailed, tojson(warmup));
+
+    // The shapes are in the plan cache before any client query runs them.
+    const shapes = testDB.coll.getPlanCache().listQueryShapes();
+    assert.eq(2, shapes.length, tojson(shapes));
+    assert.lt(0, testDB.coll.getPlanCache().getPlansByQuery(sortedQuery, {}, {a: 1}).plans.length);
+    assert.lt(0, testDB.coll.getPlanCache().getPlansByQuery(query).plans.length);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,57 @@
+/**
+ * Tests that the stages below the root of a plan report the time they spent working when the
+ * query is explained, through the explain command or a legacy $explain query, and when it is
+ * profiled.
+ */
+(function() {
+    'use strict';
+
+    load('jstests/libs/analyze_plan.js');  // For getPlanStage().
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    const testDB = conn.getDB('test');
+    const coll = testDB.plan_stage_timing;
+
+    for (let i = 0; i < 10; i++) {
+        assert.writeOK(coll.insert({_id: i, a: i}));
+    }
+
+    // Filtering each document takes 10ms, and the collection scan doing it is below a projection.
+    const filter = {
+        $where: function() {
+            sleep(10);
+            return true;
+        }
+    };
+    const projection = {_id: 0, a: 1};
+
+    function assertCollScanTimed(rootStage) {
+        assert.neq('COLLSCAN', rootStage.stage, tojson(rootStage));
+        const collScan = getPlanStage(rootStage, 'COLLSCAN');
+        assert.neq(null, collScan, tojson(rootStage));
+        assert.gt(collScan.executionTimeMillisEstimate, 0, tojson(rootStage));
+    }
+
+    // The explain command.
+    let explain = coll.find(filter, projection).explain('executionStats');
+    assert.eq(10, explain.executionStats.nReturned, tojson(explain));
+    assertCollScanTimed(explain.executionStats.executionStages);
+
+    // A legacy OP_QUERY with $explain.
+    testDB.getMongo().forceReadMode('legacy');
+    explain = coll.find({$query: filter, $explain: true}, projection).limit(-1).next();
+    assert.eq(10, explain.executionStats.nReturned, tojson(explain));
+    assertCollScanTimed(explain.executionStats.executionStages);
+    testDB.getMongo().forceReadMode('commands');
+
+    // A profiled query.
+    assert.commandWorked(testDB.setProfilingLevel(2));
+    assert.eq(10, coll.find(filter, projection).comment('plan_stage_timing').itcount());
+    assert.commandWorked(testDB.setProfilingLevel(0));
+    const profileEntry = testDB.system.profile.findOne({'command.comment': 'plan_stage_timing'});
+    assert.neq(null, profileEntry, tojson(testDB.system.profile.find().toArray()));
+    assertCollScanTimed(profileEntry.execStats);
+
+    MongoRunner.stopMongod(conn);
+}());
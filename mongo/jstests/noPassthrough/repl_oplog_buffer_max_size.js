@@ -0,0 +1,21 @@
+/**
+ * Tests that replOplogBufferMaxSizeBytes sets the size of a secondary's oplog buffer.
+ */
+(function() {
+    "use strict";
+
+    var bufferSize = 64 * 1024 * 1024;
+    var rst = new ReplSetTest(
+        {nodes: 2, nodeOptions: {setParameter: {replOplogBufferMaxSizeBytes: bufferSize}}});
+    rst.startSet();
+    rst.initiate();
+
+    var primary = rst.getPrimary();
+    assert.writeOK(primary.getDB("test").foo.insert({x: 1}, {writeConcern: {w: 2}}));
+
+    var secondary = rst.getSecondary();
+    var metrics = assert.commandWorked(secondary.adminCommand({serverStatus: 1})).metrics;
+    assert.eq(bufferSize, metrics.repl.buffer.maxSizeBytes, tojson(metrics.repl.buffer));
+
+    rst.stopSet();
+})();
@@ -0,0 +1,36 @@
+/**
+ * Tests that a secondary started with replPrefetchNextBatchThreadCount prefetches the documents
+ * touched by the batches it applies.
+ */
+(function() {
+    "use strict";
+
+    if (jsTest.options().storageEngine === "mmapv1") {
+        jsTest.log("Skipping test since MMAPv1 always prefetches each batch before applying it");
+        return;
+    }
+
+    var rst = new ReplSetTest(
+        {nodes: 2, nodeOptions: {setParameter: {replPrefetchNextBatchThreadCount: 4}}});
+    rst.startSet();
+    rst.initiate();
+
+    var primaryColl = rst.getPrimary().getDB("test").foo;
+    var bulk = primaryColl.initializeUnorderedBulkOp();
+    for (var i = 0; i < 100; i++) {
+        bulk.insert({_id: i, x: 0});
+    }
+    assert.writeOK(bulk.execute({w: 2}));
+    assert.writeOK(primaryColl.update({}, {$inc: {x: 1}}, {multi: true, writeConcern: {w: 2}}));
+
+    var secondary = rst.getSecondary();
+    secondary.setSlaveOk();
+    assert.eq(100, secondary.getDB("test").foo.find({x: 1}).itcount());
+
+    assert.soon(function() {
+        var metrics = assert.commandWorked(secondary.adminCommand({serverStatus: 1})).metrics;
+        return metrics.repl.preload.docs.num > 0;
+    }, "secondary never prefetched a document");
+
+    rst.stopSet();
+})();
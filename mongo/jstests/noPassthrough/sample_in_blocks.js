@@ -0,0 +1,51 @@
+/**
+ * Tests that a $sample too large for the random cursor on its own reads runs of neighbouring
+ * documents when block sampling is enabled, and still returns the requested number of distinct
+ * documents.
+ */
+(function() {
+    'use strict';
+
+    const options = {setParameter: 'internalDocumentSourceSampleBlockSize=16'};
+    const conn = MongoRunner.runMongod(options);
+    assert.neq(null, conn, 'mongod was unable to start up with options: ' + tojson(options));
+
+    const testDB = conn.getDB('test');
+    const coll = testDB.sample_in_blocks;
+    coll.drop();
+
+    const numDocs = 2000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < numDocs; ++i) {
+        bulk.insert({_id: i, padding: 'x'.repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Ten percent of the collection takes more than the random cursor is used for by default.
+    const sampleSize = numDocs / 10;
+    const pipeline = [{$sample: {size: sampleSize}}];
+
+    const isWiredTiger = testDB.serverStatus().storageEngine.name === 'wiredTiger';
+    if (isWiredTiger) {
+        const explain = coll.explain().aggregate(pipeline);
+        assert(explain.stages.some(stage => stage.hasOwnProperty('$sampleFromRandomCursor')),
+               tojson(explain));
+    }
+
+    for (let i = 0; i < 10; ++i) {
+        const ids = coll.aggregate(pipeline).toArray().map(doc => doc._id);
+        assert.eq(sampleSize, ids.length);
+        assert.eq(sampleSize, new Set(ids).size, 'duplicate documents in sample: ' + tojson(ids));
+        ids.forEach(id => assert.lt(id, numDocs));
+    }
+
+    // Above the block sampling ratio, $sample falls back to sorting the whole collection.
+    assert.commandWorked(testDB.adminCommand(
+        {setParameter: 1, internalDocumentSourceSampleBlockMaxSampleRatio: 0.05}));
+    const explain = coll.explain().aggregate(pipeline);
+    assert(!explain.stages.some(stage => stage.hasOwnProperty('$sampleFromRandomCursor')),
+           tojson(explain));
+    assert.eq(sampleSize, coll.aggregate(pipeline).itcount());
+
+    MongoRunner.stopMongod(conn);
+})();
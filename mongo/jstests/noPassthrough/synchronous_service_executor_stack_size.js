@@ -0,0 +1,45 @@
+/**
+ * Tests that the stack size of the synchronous service executor's threads is configurable and is
+ * accounted for in serverStatus, and that idle clients can be told not to keep spare lockers.
+ */
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({
+        serviceExecutor: 'synchronous',
+        setParameter: {synchronousServiceExecutorThreadStackSizeKB: 512}
+    });
+    assert.neq(null, conn, 'mongod failed to start up');
+    const db = conn.getDB('test');
+
+    // Debug builds halve the requested stack size
+    const stats = assert.commandWorked(db.serverStatus()).network.serviceExecutorTaskStats;
+    assert.eq('passthrough', stats.executor, tojson(stats));
+    assert.lte(stats.threadStackSizeBytes, 512 * 1024, tojson(stats));
+    assert.gte(stats.threadStackSizeBytes, 256 * 1024, tojson(stats));
+    assert.eq(stats.threadsRunning * stats.threadStackSizeBytes,
+              stats.threadStacksTotalBytes,
+              tojson(stats));
+
+    // Open a few more connections; each one gets a thread and its stack is accounted for
+    const conns = [];
+    for (let i = 0; i < 5; i++) {
+        conns.push(new Mongo(conn.host));
+        assert.commandWorked(conns[i].getDB('test').runCommand({ping: 1}));
+    }
+    const moreStats = assert.commandWorked(db.serverStatus()).network.serviceExecutorTaskStats;
+    assert.gte(moreStats.threadsRunning, stats.threadsRunning + 5, tojson(moreStats));
+    assert.eq(moreStats.threadsRunning * moreStats.threadStackSizeBytes,
+              moreStats.threadStacksTotalBytes,
+              tojson(moreStats));
+
+    // Once idle clients stop keeping their lockers, running operations does not add spare ones
+    assert.commandWorked(db.adminCommand({setParameter: 1, retainIdleClientLockers: false}));
+    const spareLockers = db.serverStatus().metrics.clients.spareLockers;
+    conns.forEach(function(c) {
+        assert.commandWorked(c.getDB('test').runCommand({ping: 1}));
+    });
+    assert.lte(db.serverStatus().metrics.clients.spareLockers, spareLockers);
+
+    MongoRunner.stopMongod(conn);
+}());
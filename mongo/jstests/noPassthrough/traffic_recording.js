@@ -0,0 +1,69 @@
+/**
+ * Tests that startRecordingTraffic and stopRecordingTraffic record client traffic to a file in the
+ * trafficRecordingDirectory.
+ */
+(function() {
+    'use strict';
+
+    // Recording is refused unless a directory is configured.
+    let conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    assert.commandFailedWithCode(
+        conn.adminCommand({startRecordingTraffic: 1, filename: 'recording'}),
+        ErrorCodes.IllegalOperation);
+    MongoRunner.stopMongod(conn);
+
+    const recordingDir = MongoRunner.toRealDir('$dataDir/traffic_recording/');
+    mkdir(recordingDir);
+
+    conn = MongoRunner.runMongod({setParameter: {trafficRecordingDirectory: recordingDir}});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    const adminDB = conn.getDB('admin');
+    const testDB = conn.getDB('test');
+
+    assert.commandFailedWithCode(
+        adminDB.runCommand({startRecordingTraffic: 1, filename: '../outside'}),
+        ErrorCodes.BadValue);
+    assert.commandFailedWithCode(adminDB.runCommand({stopRecordingTraffic: 1}),
+                                 ErrorCodes.BadValue);
+
+    assert.commandWorked(adminDB.runCommand({startRecordingTraffic: 1, filename: 'recording'}));
+    assert.commandFailedWithCode(
+        adminDB.runCommand({startRecordingTraffic: 1, filename: 'other'}), ErrorCodes.BadValue);
+
+    for (let i = 0; i < 10; ++i) {
+        assert.writeOK(testDB.traffic.insert({_id: i}));
+    }
+    assert.eq(10, testDB.traffic.find().batchSize(2).itcount());
+
+    const status = assert.commandWorked(adminDB.runCommand({serverStatus: 1, trafficRecording: 1}))
+                       .trafficRecording;
+    assert(status.enabled, tojson(status));
+    assert(status.running, tojson(status));
+
+    // Every request and reply so far, including the serverStatus request, is recorded.
+    const res = assert.commandWorked(adminDB.runCommand({stopRecordingTraffic: 1}));
+    assert(!res.running, tojson(res));
+    assert.gte(res.recordedMessages, 2 * 16, tojson(res));
+    assert.eq(0, res.droppedMessages, tojson(res));
+
+    const files = listFiles(recordingDir).filter(file => file.baseName === 'recording');
+    assert.eq(1, files.length, tojson(listFiles(recordingDir)));
+    assert.eq(res.writtenBytes, files[0].size, tojson(files));
+
+    // Recording stops by itself when the file reaches its size limit.
+    assert.commandWorked(adminDB.runCommand(
+        {startRecordingTraffic: 1, filename: 'limited', maxFileSize: 1024}));
+    for (let i = 0; i < 10; ++i) {
+        assert.commandWorked(testDB.runCommand({find: 'traffic'}));
+    }
+    assert.soon(() => {
+        const status =
+            assert.commandWorked(adminDB.runCommand({serverStatus: 1, trafficRecording: 1}))
+                .trafficRecording;
+        return !status.running && status.hasOwnProperty('error');
+    });
+    assert.commandWorked(adminDB.runCommand({stopRecordingTraffic: 1}));
+
+    MongoRunner.stopMongod(conn);
+}());
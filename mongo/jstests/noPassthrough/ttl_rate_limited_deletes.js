@@ -0,0 +1,33 @@
+// Test that the TTL monitor deletes expired documents in rate limited batches when
+// ttlMonitorMaxDeletesPerSecond is set.
+(function() {
+    "use strict";
+
+    const maxDeletesPerSecond = 100;
+    const runner = MongoRunner.runMongod({
+        setParameter: {ttlMonitorSleepSecs: 1, ttlMonitorMaxDeletesPerSecond: maxDeletesPerSecond}
+    });
+    const db = runner.getDB("test");
+    const coll = db.ttl_rate_limited_deletes;
+    coll.drop();
+
+    assert.commandWorked(coll.ensureIndex({x: 1}, {expireAfterSeconds: 0}));
+
+    const numDocs = 3 * maxDeletesPerSecond;
+    const bulk = coll.initializeUnorderedBulkOp();
+    const past = new Date(Date.now() - 60 * 1000);
+    for (let i = 0; i < numDocs; i++) {
+        bulk.insert({x: past});
+    }
+    assert.writeOK(bulk.execute());
+
+    // The documents expire in batches of 'maxDeletesPerSecond', so they cannot all be removed by
+    // the first batch.
+    const deletedBefore = db.serverStatus().metrics.ttl.deletedDocuments;
+    assert.soon(function() {
+        return coll.count() === 0;
+    }, "TTL monitor didn't delete the expired documents before timing out.");
+    assert.eq(numDocs, db.serverStatus().metrics.ttl.deletedDocuments - deletedBefore);
+
+    MongoRunner.stopMongod(runner);
+})();
@@ -0,0 +1,49 @@
+/**
+ * Tests that collMod can mark a collection and its indexes as resident in the WiredTiger cache,
+ * and that the option is validated and replicated like the other collMod options.
+ * @tags: [requires_wiredtiger, requires_replication]
+ */
+(function() {
+    'use strict';
+
+    const rst = new ReplSetTest({nodes: 2});
+    rst.startSet();
+    rst.initiate();
+
+    const primaryDB = rst.getPrimary().getDB('test');
+    const coll = primaryDB.wt_collmod_cache_resident;
+    assert.writeOK(coll.insert({_id: 0, a: 0}));
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    // Altering may briefly fail while another operation holds the table open.
+    function collMod(resident) {
+        assert.soon(function() {
+            const res = primaryDB.runCommand({collMod: coll.getName(), cacheResident: resident});
+            if (res.code === ErrorCodes.ConflictingOperationInProgress) {
+                return false;
+            }
+            assert.commandWorked(res);
+            return true;
+        });
+    }
+
+    collMod(true);
+    assert.eq(1, coll.find({a: 0}).itcount());
+    collMod(false);
+    assert.eq(1, coll.find({a: 0}).itcount());
+
+    assert.commandFailedWithCode(
+        primaryDB.runCommand({collMod: coll.getName(), cacheResident: 1}),
+        ErrorCodes.InvalidOptions);
+
+    // The option is not supported on views.
+    assert.commandWorked(primaryDB.createView('view', coll.getName(), []));
+    assert.commandFailedWithCode(primaryDB.runCommand({collMod: 'view', cacheResident: true}),
+                                 ErrorCodes.InvalidOptions);
+
+    // The secondary applies the collMod without stopping replication.
+    rst.awaitReplication();
+    assert.eq(1, rst.getSecondary().getDB('test').wt_collmod_cache_resident.find().itcount());
+
+    rst.stopSet();
+}());
@@ -0,0 +1,33 @@
+/**
+ * Tests that serverStatus reports the WiredTiger session cache with totals that add up the counters
+ * of its stripes. The shell only sees one of several fields with the same name, so that the
+ * section holds a single sessionCache field is checked by wiredtiger_server_status_test.cpp.
+ */
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    const testDB = conn.getDB('test');
+
+    if (!testDB.serverStatus().wiredTiger) {
+        jsTestLog('Skipping test because the storage engine is not WiredTiger');
+        MongoRunner.stopMongod(conn);
+        return;
+    }
+
+    for (let i = 0; i < 10; ++i) {
+        assert.writeOK(testDB.coll.insert({_id: i}));
+    }
+
+    const sessionCache = assert.commandWorked(testDB.serverStatus()).wiredTiger.sessionCache;
+    assert.gt(sessionCache.misses, 0, tojson(sessionCache));
+    ['cached', 'hits', 'misses', 'steals'].forEach(function(counter) {
+        const total = sessionCache.stripes.reduce(function(sum, stripe) {
+            return sum + stripe[counter];
+        }, 0);
+        assert.eq(total, sessionCache[counter], tojson(sessionCache));
+    });
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,43 @@
+/**
+ * Tests that collection scans with a range predicate on a field summarized by the WiredTiger zone
+ * maps skip records which cannot match, without missing documents whose values were changed.
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+    'use strict';
+
+    const options = {
+        storageEngine: 'wiredTiger',
+        setParameter: {wiredTigerZoneMapFields: 'ts', wiredTigerZoneMapRecordsPerZone: 100}
+    };
+    const conn = MongoRunner.runMongod(options);
+    assert.neq(null, conn, 'mongod was unable to start up with options: ' + tojson(options));
+
+    const testDB = conn.getDB('test');
+    const coll = testDB.wt_zone_map_collscan;
+    coll.drop();
+
+    const numDocs = 10000;
+    const bulk = coll.initializeOrderedBulkOp();
+    for (let i = 0; i < numDocs; ++i) {
+        bulk.insert({_id: i, ts: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    const query = {ts: {$gte: numDocs - 150}};
+    assert.eq(150, coll.find(query).itcount());
+    const stats = coll.find(query).explain('executionStats').executionStats;
+    assert.eq(150, stats.nReturned, tojson(stats));
+    assert.lt(stats.totalDocsExamined, numDocs / 10, tojson(stats));
+
+    // A document moved into the range must still be found, and its zone is no longer skipped.
+    assert.writeOK(coll.update({_id: 5}, {$set: {ts: numDocs}}));
+    assert.eq(151, coll.find(query).itcount());
+
+    // Predicates which may match documents without the field never skip anything.
+    assert.writeOK(coll.insert({_id: 'noTs'}));
+    assert.eq(1, coll.find({ts: null}).itcount());
+    assert.eq(numDocs - 151, coll.find({ts: {$lt: numDocs - 150}}).itcount());
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,53 @@
+// Tests that a $sort+$limit pushed down to the query system as a top-k sort succeeds on skewed
+// data whose largest documents are the ones kept, as long as they fit in the memory limit of
+// $sort, even though they exceed internalQueryExecMaxBlockingSortBytes.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const coll = db.agg_sort_limit_pushdown_skewed;
+    coll.drop();
+
+    // A few large documents sort first; the many small ones keep the average size low.
+    const bigStr = new Array(200 * 1024).join("x");
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, a: i});
+    }
+    for (let i = 0; i < 10; i++) {
+        bulk.insert({_id: 1000 + i, a: 1000 + i, s: bigStr});
+    }
+    assert.writeOK(bulk.execute());
+
+    const originalLimit = assert.commandWorked(
+        db.adminCommand({getParameter: 1, internalQueryExecMaxBlockingSortBytes: 1}));
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryExecMaxBlockingSortBytes: 1024 * 1024}));
+
+    try {
+        const pipeline = [{$sort: {a: -1}}, {$limit: 10}];
+
+        // The sort is still run by the query system.
+        const explain = coll.explain().aggregate(pipeline);
+        assert.neq(null, getAggPlanStage(explain, "SORT"), tojson(explain));
+
+        const results = coll.aggregate(pipeline).toArray();
+        assert.eq(10, results.length);
+        for (let i = 0; i < results.length; i++) {
+            assert.eq(1009 - i, results[i].a, tojson(results[i]));
+        }
+
+        // A plain find is still subject to internalQueryExecMaxBlockingSortBytes.
+        assert.commandFailedWithCode(
+            db.runCommand({find: coll.getName(), sort: {a: -1}, limit: 10}),
+            ErrorCodes.OperationFailed);
+    } finally {
+        assert.commandWorked(db.adminCommand({
+            setParameter: 1,
+            internalQueryExecMaxBlockingSortBytes:
+                originalLimit.internalQueryExecMaxBlockingSortBytes
+        }));
+    }
+    coll.drop();
+})();
@@ -0,0 +1,63 @@
+// Tests the analyze command, which samples a collection to build a histogram of one field.
+(function() {
+    "use strict";
+
+    const coll = db.analyze_cmd;
+    coll.drop();
+
+    assert.commandFailedWithCode(db.runCommand({analyze: coll.getName(), key: "x"}),
+                                 ErrorCodes.NamespaceNotFound);
+
+    let bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 100; ++i) {
+        bulk.insert(i < 90 ? {x: i % 10} : {y: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandFailedWithCode(db.runCommand({analyze: coll.getName()}), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(db.runCommand({analyze: coll.getName(), key: "x", buckets: 0}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(
+        db.runCommand({analyze: coll.getName(), key: "x", sampleSize: -1}), ErrorCodes.BadValue);
+
+    // A collection no larger than the sample size is scanned in full, so the statistics are exact.
+    let res = assert.commandWorked(db.runCommand({analyze: coll.getName(), key: "x", buckets: 5}));
+    assert.eq(res.numRecords, 100, tojson(res));
+    assert.eq(res.sampled, 100, tojson(res));
+    assert(res.fullScan, tojson(res));
+    assert.eq(res.missing, 10, tojson(res));
+    assert.eq(res.sampledDistinct, 10, tojson(res));
+    assert.eq(res.estimatedDistinct, 10, tojson(res));
+    assert.eq(res.histogram.length, 5, tojson(res));
+    for (let i = 0; i < 5; ++i) {
+        const bucket = res.histogram[i];
+        assert.eq(bucket.min, 2 * i, tojson(res));
+        assert.eq(bucket.max, 2 * i + 1, tojson(res));
+        assert.eq(bucket.sampled, 18, tojson(res));
+        assert.eq(bucket.distinct, 2, tojson(res));
+        assert.eq(bucket.estimatedCount, 18, tojson(res));
+    }
+
+    // Equal values never straddle buckets, so a single-valued field yields a single bucket.
+    coll.drop();
+    bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 2000; ++i) {
+        bulk.insert({x: 1, z: i});
+    }
+    assert.writeOK(bulk.execute());
+    res = assert.commandWorked(db.runCommand({analyze: coll.getName(), key: "x"}));
+    assert.eq(res.histogram.length, 1, tojson(res));
+    assert.eq(res.estimatedDistinct, 1, tojson(res));
+
+    // Larger collections are sampled.
+    res = db.runCommand({analyze: coll.getName(), key: "z", sampleSize: 500, buckets: 10});
+    if (res.code !== ErrorCodes.CommandNotSupported) {
+        assert.commandWorked(res);
+        assert.eq(res.sampled, 500, tojson(res));
+        assert(!res.fullScan, tojson(res));
+        assert.eq(res.missing, 0, tojson(res));
+        assert.eq(res.histogram.reduce((sum, bucket) => sum + bucket.sampled, 0), 500, tojson(res));
+        assert.lte(res.estimatedDistinct, 2000, tojson(res));
+        assert.gte(res.estimatedDistinct, res.sampledDistinct, tojson(res));
+    }
+})();
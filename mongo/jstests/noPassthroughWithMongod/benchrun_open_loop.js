@@ -0,0 +1,93 @@
+// Tests benchRun's open loop mode, latency percentiles, the "aggregate" op and OP_MSG document
+// sequence write batches.
+(function() {
+    "use strict";
+
+    var coll = db.benchrun_open_loop;
+    coll.drop();
+    assert.commandWorked(coll.getDB().createCollection(coll.getName()));
+
+    function executeBenchRun(benchOps, extraArgs) {
+        var benchArgs = {ops: benchOps, parallel: 2, seconds: 2, host: db.getMongo().host};
+        if (jsTest.options().auth) {
+            benchArgs['db'] = 'admin';
+            benchArgs['username'] = jsTest.options().authUser;
+            benchArgs['password'] = jsTest.options().authPassword;
+        }
+        return benchRun(Object.extend(benchArgs, extraArgs || {}));
+    }
+
+    function assertPercentiles(res, opName) {
+        var percentiles = res.latencyPercentilesMicros[opName];
+        assert(percentiles, tojson(res));
+        assert.lte(percentiles.p50, percentiles.p90, tojson(res));
+        assert.lte(percentiles.p90, percentiles.p99, tojson(res));
+        assert.lte(percentiles.p99, percentiles.p999, tojson(res));
+        assert.lte(percentiles.p999, percentiles.max, tojson(res));
+    }
+
+    // Closed loop runs report percentiles too.
+    var res = executeBenchRun([{ns: coll.getFullName(), op: "findOne", query: {}}]);
+    assert.gt(res.findOne, 0, tojson(res));
+    assertPercentiles(res, "findOne");
+    assert(!res.hasOwnProperty("targetOps/s"), tojson(res));
+
+    // An open loop run issues operations at roughly the target rate, however fast the server is.
+    [false, true].forEach(function(poissonArrivals) {
+        res = executeBenchRun([{ns: coll.getFullName(), op: "findOne", query: {}}],
+                              {rate: 100, poissonArrivals: poissonArrivals, seconds: 5});
+        assert.eq(100, res["targetOps/s"], tojson(res));
+        assert.gt(res.findOne, 50, tojson(res));
+        assert.lt(res.findOne, 150, tojson(res));
+        assert.gte(res.maxScheduleLagMicros, 0, tojson(res));
+        assertPercentiles(res, "findOne");
+    });
+
+    // Templated write batches, with and without OP_MSG document sequences.
+    [false, true].forEach(function(docSequence) {
+        coll.drop();
+        res = executeBenchRun([{
+            ns: coll.getFullName(),
+            op: "insert",
+            doc: {x: {"#RAND_INT": [0, 100]}},
+            batchSize: 10,
+            writeCmd: true,
+            docSequence: docSequence,
+            writeConcern: {w: 1}
+        }]);
+        assert.gt(res.insert, 0, tojson(res));
+        assert.eq(0, coll.count() % 10);
+        assertPercentiles(res, "insert");
+
+        res = executeBenchRun([{
+            ns: coll.getFullName(),
+            op: "update",
+            query: {x: {"#RAND_INT": [0, 100]}},
+            update: {$inc: {y: 1}},
+            writeCmd: true,
+            docSequence: docSequence
+        }]);
+        assert.gt(res.update, 0, tojson(res));
+        assert.gt(coll.count({y: {$exists: true}}), 0);
+    });
+
+    // A document sequence is only meaningful for write commands.
+    assert.throws(function() {
+        executeBenchRun([{ns: coll.getFullName(), op: "insert", doc: {}, docSequence: true}]);
+    });
+
+    // Aggregations are run to completion and counted, like queries.
+    coll.drop();
+    for (var i = 0; i < 100; i++) {
+        assert.writeOK(coll.insert({x: i}));
+    }
+    res = executeBenchRun([{
+        ns: coll.getFullName(),
+        op: "aggregate",
+        pipeline: [{$match: {x: {$gte: 50}}}, {$project: {_id: 0, x: 1}}],
+        batchSize: 20,
+        expected: 50
+    }]);
+    assert.gt(res.aggregate, 0, tojson(res));
+    assertPercentiles(res, "aggregate");
+})();
@@ -0,0 +1,50 @@
+/**
+ * Test that awaitData cursors still see every insert, and are woken promptly, when capped insert
+ * notifications are coalesced with 'cappedInsertNotifierCoalesceMicros'.
+ */
+(function() {
+    "use strict";
+
+    const coll = db.capped_insert_notifier_coalesce;
+    coll.drop();
+    assert.commandWorked(db.createCollection(coll.getName(), {capped: true, size: 1024 * 1024}));
+    assert.writeOK(coll.insert({_id: 0}));
+
+    const original = assert
+                         .commandWorked(db.adminCommand(
+                             {getParameter: 1, cappedInsertNotifierCoalesceMicros: 1}))
+                         .cappedInsertNotifierCoalesceMicros;
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, cappedInsertNotifierCoalesceMicros: 50 * 1000}));
+
+    try {
+        let res = assert.commandWorked(
+            db.runCommand({find: coll.getName(), batchSize: 10, tailable: true, awaitData: true}));
+        const cursorId = res.cursor.id;
+        assert.eq(1, res.cursor.firstBatch.length);
+
+        // Insert a burst of documents from another connection while the getMore below waits.
+        const awaitShell = startParallelShell(function() {
+            sleep(500);
+            for (let i = 1; i <= 20; i++) {
+                assert.writeOK(db.capped_insert_notifier_coalesce.insert({_id: i}));
+            }
+        });
+
+        let seen = 0;
+        const start = new Date();
+        for (let attempt = 0; seen < 20 && attempt < 20; attempt++) {
+            res = assert.commandWorked(db.runCommand(
+                {getMore: cursorId, collection: coll.getName(), batchSize: 10, maxTimeMS: 10000}));
+            seen += res.cursor.nextBatch.length;
+        }
+        assert.eq(20, seen);
+
+        // The waiters must have been woken by the inserts rather than by the await timeout.
+        assert.lt(new Date() - start, 10000);
+        awaitShell();
+    } finally {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, cappedInsertNotifierCoalesceMicros: original}));
+    }
+}());
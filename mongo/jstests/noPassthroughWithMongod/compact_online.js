@@ -0,0 +1,43 @@
+/**
+ * Tests the online mode of the compact command, which runs under intent locks.
+ */
+(function() {
+    "use strict";
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (db.serverStatus().storageEngine.name !== "wiredTiger") {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    var coll = db.compact_online;
+    coll.drop();
+    assert.commandWorked(coll.createIndex({x: 1}));
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 10000; i++) {
+        bulk.insert({_id: i, x: i, pad: "x".repeat(200)});
+    }
+    assert.writeOK(bulk.execute());
+    assert.writeOK(coll.remove({_id: {$lt: 9000}}));
+
+    // The throttling options are only valid for online compaction, and are range checked.
+    assert.commandFailed(coll.runCommand("compact", {sliceSecs: 1}));
+    assert.commandFailed(coll.runCommand("compact", {online: true, sliceSecs: 0}));
+    assert.commandFailed(coll.runCommand("compact", {online: true, pauseMillis: -1}));
+
+    // Reads and writes keep going while the compaction runs.
+    var awaitShell = startParallelShell(function() {
+        for (var i = 0; i < 100; i++) {
+            assert.writeOK(db.compact_online.insert({_id: "parallel" + i, x: -i}));
+            assert.eq(1, db.compact_online.find({x: -i}).itcount());
+        }
+    });
+
+    assert.commandWorked(coll.runCommand("compact", {online: true, pauseMillis: 10}));
+    awaitShell();
+
+    assert.eq(coll.getIndexes().length, 2);
+    assert.eq(1100, coll.find().itcount());
+    assert.eq(1100, coll.find().hint({x: 1}).itcount());
+}());
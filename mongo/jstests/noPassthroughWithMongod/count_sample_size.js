@@ -0,0 +1,38 @@
+// Tests count commands that estimate their result from a random sample of documents.
+(function() {
+    "use strict";
+
+    var coll = db.count_sample_size;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 5000; i++) {
+        bulk.insert({a: i % 4});
+    }
+    assert.writeOK(bulk.execute());
+
+    // A sample smaller than the collection gives an estimate with its confidence interval.
+    var res = assert.commandWorked(
+        db.runCommand({count: coll.getName(), query: {a: 0}, sampleSize: 500}));
+    assert.eq(true, res.approximate, tojson(res));
+    assert.eq(500, res.sampled, tojson(res));
+    assert.lte(res.confidenceInterval.lower, res.n, tojson(res));
+    assert.gte(res.confidenceInterval.upper, res.n, tojson(res));
+    assert.gt(res.n, 500, tojson(res));
+    assert.lt(res.n, 2000, tojson(res));
+
+    // The estimate honours limit.
+    res = assert.commandWorked(
+        db.runCommand({count: coll.getName(), query: {}, sampleSize: 100, limit: 10}));
+    assert.eq(10, res.n, tojson(res));
+
+    // A sample at least as large as the collection is answered exactly.
+    res = assert.commandWorked(
+        db.runCommand({count: coll.getName(), query: {a: 0}, sampleSize: 10000}));
+    assert.eq(false, res.approximate, tojson(res));
+    assert.eq(1250, res.n, tojson(res));
+
+    assert.commandFailedWithCode(
+        db.runCommand({count: coll.getName(), query: {a: 0}, sampleSize: -1}),
+        ErrorCodes.BadValue);
+})();
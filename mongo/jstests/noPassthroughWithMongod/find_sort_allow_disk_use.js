@@ -0,0 +1,56 @@
+// Tests that a blocking sort in find spills to disk when allowDiskUse is set, instead of failing
+// once it exceeds internalQueryExecMaxBlockingSortBytes.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    var coll = db.find_sort_allow_disk_use;
+    coll.drop();
+
+    var bigStr = new Array(1024).join("x");
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 500; i++) {
+        bulk.insert({a: (i * 7) % 500, s: bigStr});
+    }
+    assert.writeOK(bulk.execute());
+
+    var originalLimit = assert.commandWorked(
+        db.adminCommand({getParameter: 1, internalQueryExecMaxBlockingSortBytes: 1}));
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryExecMaxBlockingSortBytes: 100 * 1024}));
+
+    try {
+        assert.commandFailedWithCode(
+            db.runCommand({find: coll.getName(), sort: {a: 1}, batchSize: 1000}),
+            ErrorCodes.OperationFailed);
+
+        var res = assert.commandWorked(db.runCommand(
+            {find: coll.getName(), sort: {a: 1}, batchSize: 1000, allowDiskUse: true}));
+        var docs = res.cursor.firstBatch;
+        assert.eq(500, docs.length);
+        for (var j = 0; j < docs.length; j++) {
+            assert.eq(j, docs[j].a, tojson(docs[j]));
+        }
+
+        // The spilled sort honours limit and reports its disk use in explain.
+        res = assert.commandWorked(db.runCommand(
+            {find: coll.getName(), sort: {a: -1}, limit: 300, allowDiskUse: true}));
+        assert.eq(499, res.cursor.firstBatch[0].a);
+
+        var explain = assert.commandWorked(db.runCommand({
+            explain: {find: coll.getName(), sort: {a: 1}, allowDiskUse: true},
+            verbosity: "executionStats"
+        }));
+        var sortStage = getPlanStage(explain.executionStats.executionStages, "SORT");
+        assert.neq(null, sortStage, tojson(explain));
+        assert.eq(true, sortStage.usedDisk, tojson(sortStage));
+        assert.eq(500, explain.executionStats.nReturned);
+    } finally {
+        assert.commandWorked(db.adminCommand({
+            setParameter: 1,
+            internalQueryExecMaxBlockingSortBytes:
+                originalLimit.internalQueryExecMaxBlockingSortBytes
+        }));
+    }
+})();
@@ -0,0 +1,52 @@
+// Tests hashed indexes built with the MurmurHash3 hash function (hashVersion: 1).
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const coll = db.hashed_index_murmur3;
+    coll.drop();
+
+    assert.commandWorked(coll.createIndex({a: "hashed"}, {hashVersion: 1}));
+    for (let i = 0; i < 100; i++) {
+        assert.writeOK(coll.insert({_id: i, a: i % 10}));
+    }
+    assert.writeOK(coll.insert({_id: 100, a: "mongodb"}));
+
+    // Equality lookups are answered through the hashed index, using the index's own hash version.
+    assert.eq(10, coll.find({a: 3}).itcount());
+    assert.eq(10, coll.find({a: NumberLong(3)}).itcount());
+    assert.eq(1, coll.find({a: "mongodb"}).itcount());
+    assert.eq(0, coll.find({a: 11}).itcount());
+    const explain = coll.find({a: 3}).explain();
+    assert(isIxscan(explain.queryPlanner.winningPlan), tojson(explain));
+
+    // The two hash versions produce different index keys for the same value.
+    const md5 = assert.commandWorked(db.runCommand({_hashBSONElement: 42}));
+    const murmur3 = assert.commandWorked(db.runCommand({_hashBSONElement: 42, hashVersion: 1}));
+    assert.neq(md5.out, murmur3.out);
+
+    // Unsupported hash versions are rejected.
+    coll.drop();
+    assert.commandFailedWithCode(coll.createIndex({a: "hashed"}, {hashVersion: 2}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(coll.createIndex({a: "hashed"}, {hashVersion: "murmur3"}),
+                                 ErrorCodes.TypeMismatch);
+
+    // Binaries without MurmurHash3 support can't maintain a hashVersion 1 index, so creating one
+    // requires featureCompatibilityVersion 3.6, and downgrading is refused while one exists.
+    const adminDB = db.getSiblingDB("admin");
+    assert.commandWorked(adminDB.runCommand({setFeatureCompatibilityVersion: "3.4"}));
+    assert.commandFailedWithCode(coll.createIndex({a: "hashed"}, {hashVersion: 1}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandWorked(coll.createIndex({a: "hashed"}, {hashVersion: 0}));
+    assert.commandWorked(adminDB.runCommand({setFeatureCompatibilityVersion: "3.6"}));
+
+    assert.commandWorked(coll.createIndex({b: "hashed"}, {hashVersion: 1}));
+    assert.commandFailedWithCode(adminDB.runCommand({setFeatureCompatibilityVersion: "3.4"}),
+                                 ErrorCodes.IllegalOperation);
+    assert.commandWorked(coll.dropIndex({b: "hashed"}));
+    assert.commandWorked(adminDB.runCommand({setFeatureCompatibilityVersion: "3.4"}));
+    assert.commandWorked(adminDB.runCommand({setFeatureCompatibilityVersion: "3.6"}));
+    coll.drop();
+})();
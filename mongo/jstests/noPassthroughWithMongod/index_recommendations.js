@@ -0,0 +1,40 @@
+// Tests the per query shape execution statistics and the index recommendations derived from them.
+(function() {
+    "use strict";
+
+    const coll = db.index_recommendations;
+    coll.drop();
+
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(coll.insert({a: i, b: i % 10}));
+    }
+
+    for (let i = 0; i < 5; ++i) {
+        assert.eq(1, coll.find({a: i}).itcount());
+        assert.eq(10, coll.find({b: i}).sort({a: -1}).itcount());
+    }
+
+    let res = assert.commandWorked(db.runCommand({queryShapeStats: coll.getName()}));
+    assert.eq(2, res.shapes.length, tojson(res));
+    res.shapes.forEach(function(shape) {
+        assert.eq(5, shape.execCount, tojson(shape));
+        assert.eq(500, shape.totalDocsExamined, tojson(shape));
+        assert.eq(5, shape.collectionScans, tojson(shape));
+    });
+
+    res = assert.commandWorked(db.runCommand({indexRecommendations: coll.getName()}));
+    assert.eq(2, res.recommendations.length, tojson(res));
+    // Both shapes examine the same number of documents, but {a: i} returns fewer of them.
+    assert.eq({a: 1}, res.recommendations[0].keyPattern, tojson(res));
+    assert.eq({b: 1, a: -1}, res.recommendations[1].keyPattern, tojson(res));
+
+    // Once the recommended index exists, it is no longer recommended.
+    assert.commandWorked(coll.createIndex({a: 1}));
+    res = assert.commandWorked(db.runCommand({indexRecommendations: coll.getName()}));
+    assert.eq(1, res.recommendations.length, tojson(res));
+    assert.eq({b: 1, a: -1}, res.recommendations[0].keyPattern, tojson(res));
+
+    // A collection that does not exist has no shapes and no recommendations.
+    res = assert.commandWorked(db.runCommand({indexRecommendations: "does_not_exist"}));
+    assert.eq([], res.recommendations, tojson(res));
+})();
@@ -0,0 +1,50 @@
+// Tests that with internalQueryPlannerEnableIndexSkipScan, a compound index with few distinct
+// values in its leading field answers a query over its second field, and that the results match
+// a collection scan.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const coll = db.index_skip_scan;
+    coll.drop();
+
+    let bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 5000; ++i) {
+        bulk.insert({_id: i, a: Math.floor(i / 1250), b: i % 1000});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+
+    const query = {b: {$in: [7, 700]}};
+    const expected = coll.find(query).hint({$natural: 1}).sort({_id: 1}).toArray();
+    assert.eq(10, expected.length);
+
+    try {
+        // Without skip scans the index is not considered at all.
+        let explain = coll.find(query).explain();
+        assert(isCollscan(explain.queryPlanner.winningPlan), tojson(explain));
+
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryPlannerEnableIndexSkipScan: true}));
+
+        explain = coll.find(query).explain("executionStats");
+        const ixscan = getPlanStage(explain.queryPlanner.winningPlan, "IXSCAN");
+        assert.neq(null, ixscan, tojson(explain));
+        assert.eq({a: 1, b: 1}, ixscan.keyPattern, tojson(explain));
+        assert.eq(["[MinKey, MaxKey]"], ixscan.indexBounds.a, tojson(explain));
+
+        // Only the keys that match, plus one key per distinct value of 'a' to find the next one.
+        assert.eq(10, explain.executionStats.nReturned, tojson(explain));
+        assert.lte(explain.executionStats.totalKeysExamined, 40, tojson(explain));
+
+        assert.eq(expected, coll.find(query).sort({_id: 1}).toArray());
+
+        // With a predicate over the leading field as well, the index is used as usual.
+        assert.eq(coll.find({a: 3, b: 7}).hint({$natural: 1}).toArray(),
+                  coll.find({a: 3, b: 7}).toArray());
+    } finally {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryPlannerEnableIndexSkipScan: false}));
+    }
+}());
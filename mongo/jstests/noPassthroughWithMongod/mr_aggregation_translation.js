@@ -0,0 +1,97 @@
+// Tests that mapReduce commands which count documents by a field are evaluated as an aggregation
+// pipeline, and that they produce the same output as when evaluated through JavaScript.
+(function() {
+    "use strict";
+
+    const coll = db.mr_aggregation_translation;
+    coll.drop();
+
+    let bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 200; ++i) {
+        bulk.insert({_id: i, cat: i % 7, tag: (i % 3 === 0) ? NumberInt(i % 5) : "s" + (i % 4)});
+    }
+    bulk.insert({_id: 200});
+    bulk.insert({_id: 201, cat: null});
+    assert.writeOK(bulk.execute());
+
+    function count() {
+        emit(this.cat, 1);
+    }
+    function countTags() {
+        emit(this.tag, 2);
+    }
+    function sum(key, values) {
+        return Array.sum(values);
+    }
+
+    function runBothWays(cmd) {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalMapReduceUseAggregation: false}));
+        const jsResult = assert.commandWorked(db.runCommand(cmd));
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalMapReduceUseAggregation: true}));
+        const aggResult = assert.commandWorked(db.runCommand(Object.extend({verbose: true}, cmd)));
+
+        assert.eq("aggregation", aggResult.timing.mode, tojson(aggResult));
+        assert.eq(jsResult.results, aggResult.results, tojson(aggResult));
+        assert.eq(jsResult.counts.input, aggResult.counts.input, tojson(aggResult));
+        assert.eq(jsResult.counts.emit, aggResult.counts.emit, tojson(aggResult));
+        assert.eq(jsResult.counts.output, aggResult.counts.output, tojson(aggResult));
+    }
+
+    const inline = {inline: 1};
+    runBothWays({mapReduce: coll.getName(), map: count, reduce: sum, out: inline});
+    runBothWays({mapReduce: coll.getName(), map: countTags, reduce: sum, out: inline});
+    runBothWays(
+        {mapReduce: coll.getName(), map: count, reduce: sum, out: inline, query: {_id: {$gt: 50}}});
+    runBothWays({
+        mapReduce: coll.getName(),
+        map: count,
+        reduce: sum,
+        out: inline,
+        sort: {_id: -1},
+        limit: 30
+    });
+
+    // A reduce function other than a sum is still evaluated through JavaScript.
+    const jsResult = assert.commandWorked(db.runCommand({
+        mapReduce: coll.getName(),
+        map: count,
+        reduce: function(key, values) {
+            return values.length;
+        },
+        out: inline,
+        verbose: true
+    }));
+    assert.neq("aggregation", jsResult.timing.mode, tojson(jsResult));
+
+    // Queries using operators $match does not allow are still evaluated through JavaScript.
+    assert.commandWorked(coll.createIndex({loc: "2d"}));
+    bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 20; ++i) {
+        bulk.insert({_id: 300 + i, cat: i % 3, loc: [i, i]});
+    }
+    assert.writeOK(bulk.execute());
+
+    [{$where: "this.cat === 1"}, {loc: {$near: [0, 0]}}].forEach(function(query) {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalMapReduceUseAggregation: false}));
+        const expected = assert.commandWorked(db.runCommand(
+            {mapReduce: coll.getName(), map: count, reduce: sum, out: inline, query: query}));
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalMapReduceUseAggregation: true}));
+        const result = assert.commandWorked(db.runCommand({
+            mapReduce: coll.getName(),
+            map: count,
+            reduce: sum,
+            out: inline,
+            query: query,
+            verbose: true
+        }));
+
+        assert.neq("aggregation", result.timing.mode, tojson(result));
+        assert.gt(result.counts.input, 0, tojson(result));
+        assert.eq(expected.results, result.results, tojson(result));
+        assert.eq(expected.counts.input, result.counts.input, tojson(result));
+    });
+}());
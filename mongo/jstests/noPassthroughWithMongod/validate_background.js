@@ -0,0 +1,52 @@
+/**
+ * Tests background validation, which validates a snapshot under intent locks, and that validating
+ * several indexes at once reports the same results as validating them one by one.
+ */
+(function() {
+    "use strict";
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (db.serverStatus().storageEngine.name !== "wiredTiger") {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    var coll = db.validate_background;
+    coll.drop();
+    assert.commandWorked(coll.createIndexes([{a: 1}, {b: 1}, {a: 1, b: -1}, {c: 1}]));
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 5000; i++) {
+        bulk.insert({_id: i, a: i, b: i % 7, c: [i, i + 1]});
+    }
+    assert.writeOK(bulk.execute());
+
+    function checkValid(res) {
+        assert.commandWorked(res);
+        assert(res.valid, tojson(res));
+        assert.eq(5, res.nIndexes, tojson(res));
+    }
+
+    assert.commandFailed(coll.validate({full: true, background: true}));
+
+    // Foreground validation checks the indexes in parallel by default.
+    checkValid(coll.validate());
+    checkValid(coll.validate({full: true}));
+    assert.commandWorked(db.adminCommand({setParameter: 1, validateMaxParallelIndexes: 1}));
+    checkValid(coll.validate({full: true}));
+    assert.commandWorked(db.adminCommand({setParameter: 1, validateMaxParallelIndexes: 4}));
+
+    // Background validation stays consistent while writes continue.
+    var awaitShell = startParallelShell(function() {
+        for (var i = 0; i < 500; i++) {
+            assert.writeOK(db.validate_background.insert({_id: "parallel" + i, a: -i, c: [i]}));
+            assert.writeOK(db.validate_background.remove({_id: i}));
+        }
+    });
+    for (var j = 0; j < 5; j++) {
+        checkValid(coll.validate({background: true}));
+    }
+    awaitShell();
+    checkValid(coll.validate({background: true}));
+    checkValid(coll.validate());
+}());
@@ -0,0 +1,29 @@
+/**
+ * Tests that serverStatus reports the WiredTiger snapshots held open by operations.
+ */
+(function() {
+    "use strict";
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (db.serverStatus().storageEngine.name !== "wiredTiger") {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    var coll = db.wt_snapshot_stats;
+    coll.drop();
+    assert.writeOK(coll.insert({_id: 0}));
+
+    // Hold a snapshot open in a parallel shell with a collection scan that sleeps on its document.
+    var awaitShell = startParallelShell(function() {
+        db.wt_snapshot_stats.find({$where: "sleep(3000); return true;"}).itcount();
+    });
+
+    assert.soon(function() {
+        var snapshots = db.serverStatus().wiredTiger.snapshots;
+        assert(snapshots, tojson(db.serverStatus().wiredTiger));
+        return snapshots.open >= 1 && snapshots.oldestAgeMillis >= 1000;
+    }, "the sleeping scan's snapshot was never reported");
+
+    awaitShell();
+})();
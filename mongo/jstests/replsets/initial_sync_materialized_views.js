@@ -0,0 +1,47 @@
+/**
+ * Tests that initial sync clones the backing collection of a materialized view, so that the new
+ * member answers the view and applies the later writes the primary makes to it.
+ */
+(function() {
+    "use strict";
+
+    const testName = "initial_sync_materialized_views";
+    const replTest = new ReplSetTest({name: testName, nodes: 1});
+    replTest.startSet();
+    replTest.initiate();
+
+    const primaryDB = replTest.getPrimary().getDB(testName);
+    for (let i = 0; i < 10; ++i) {
+        assert.writeOK(primaryDB.coll.insert({_id: i, g: i % 2, v: i}));
+    }
+    assert.commandWorked(primaryDB.runCommand({
+        create: "totals",
+        viewOn: "coll",
+        pipeline: [{$group: {_id: "$g", total: {$sum: "$v"}}}],
+        materialized: true
+    }));
+
+    const expected = [{_id: 0, total: 20}, {_id: 1, total: 25}];
+    assert.eq(expected, primaryDB.totals.find().sort({_id: 1}).toArray());
+
+    // Add new member to the replica set and wait for initial sync to complete.
+    const secondary = replTest.add();
+    replTest.reInitiate();
+    replTest.awaitReplication();
+    replTest.awaitSecondaryNodes();
+
+    secondary.setSlaveOk();
+    const secondaryDB = secondary.getDB(testName);
+    assert.eq(1, secondaryDB.system.materialized.totals.find({_id: 0}).itcount());
+    assert.eq(expected, secondaryDB.totals.find().sort({_id: 1}).toArray());
+
+    // The secondary applies the primary's writes to the backing collection.
+    assert.writeOK(primaryDB.coll.insert({_id: 10, g: 0, v: 10}));
+    assert.writeOK(primaryDB.coll.remove({_id: 1}));
+    replTest.awaitReplication();
+    const updated = [{_id: 0, total: 30}, {_id: 1, total: 24}];
+    assert.eq(updated, primaryDB.totals.find().sort({_id: 1}).toArray());
+    assert.eq(updated, secondaryDB.totals.find().sort({_id: 1}).toArray());
+
+    replTest.stopSet();
+})();
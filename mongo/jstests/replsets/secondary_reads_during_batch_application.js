@@ -0,0 +1,52 @@
+/**
+ * Tests that reads with readConcern "local" on a secondary are served from the last oplog batch
+ * applied instead of waiting for the batch currently being applied to finish.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/check_log.js");
+
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== "wiredTiger") {
+        jsTest.log("Skipping test since storage engine doesn't support snapshot reads");
+        return;
+    }
+
+    var replTest = new ReplSetTest({
+        name: "secondary_reads_during_batch_application",
+        nodes: [{}, {rsConfig: {priority: 0}}],
+        nodeOptions: {setParameter: {readFromLastAppliedBatchOnSecondaries: true}}
+    });
+    replTest.startSet();
+    replTest.initiate();
+
+    var primary = replTest.getPrimary();
+    var secondary = replTest.getSecondary();
+    var primaryColl = primary.getDB("test").coll;
+    var secondaryColl = secondary.getDB("test").coll;
+    secondary.setSlaveOk();
+
+    assert.writeOK(primaryColl.insert({_id: 0}, {writeConcern: {w: 2}}));
+
+    // Hold the secondary in the middle of applying the next batch.
+    assert.commandWorked(secondary.adminCommand(
+        {configureFailPoint: "hangAfterApplyingBatchOps", mode: "alwaysOn"}));
+    assert.writeOK(primaryColl.insert({_id: 1}));
+    checkLog.contains(secondary, "hangAfterApplyingBatchOps fail point enabled");
+
+    // The read does not block on the batch, and sees none of its writes.
+    var res = secondaryColl.runCommand(
+        "find", {readConcern: {level: "local"}, maxTimeMS: 10 * 1000});
+    assert.commandWorked(res);
+    assert.eq([{_id: 0}], res.cursor.firstBatch);
+
+    assert.commandWorked(
+        secondary.adminCommand({configureFailPoint: "hangAfterApplyingBatchOps", mode: "off"}));
+    replTest.awaitReplication();
+
+    res = secondaryColl.runCommand("find", {readConcern: {level: "local"}, sort: {_id: 1}});
+    assert.commandWorked(res);
+    assert.eq([{_id: 0}, {_id: 1}], res.cursor.firstBatch);
+
+    replTest.stopSet();
+})();
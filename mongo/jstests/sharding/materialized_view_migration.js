@@ -0,0 +1,69 @@
+/**
+ * Tests that chunk migrations do not change a materialized view defined on a sharded collection,
+ * while regular writes, including those that remove the $max of a group, still maintain it.
+ */
+(function() {
+    'use strict';
+
+    const st = new ShardingTest({shards: 2, mongos: 1});
+    const dbName = 'test';
+    const mongosDB = st.s.getDB(dbName);
+    const coll = mongosDB.coll;
+
+    assert.commandWorked(st.s.adminCommand({enableSharding: dbName}));
+    st.ensurePrimaryShard(dbName, st.shard0.shardName);
+    assert.commandWorked(st.s.adminCommand({shardCollection: coll.getFullName(), key: {_id: 1}}));
+    assert.commandWorked(coll.createIndex({g: 1}));
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 20; i++) {
+        bulk.insert({_id: i, g: i % 2, v: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandWorked(mongosDB.runCommand({
+        create: 'totals',
+        viewOn: 'coll',
+        pipeline: [{$group: {_id: '$g', total: {$sum: '$v'}, high: {$max: '$v'}}}],
+        materialized: true
+    }));
+
+    // The view is maintained on the primary shard, which holds its backing collection
+    const viewOnPrimary = st.shard0.getDB(dbName).totals;
+    function assertView(expected) {
+        assert.eq(expected, viewOnPrimary.find().sort({_id: 1}).toArray());
+    }
+    const initial = [{_id: 0, total: 90, high: 18}, {_id: 1, total: 100, high: 19}];
+    assertView(initial);
+
+    // Moving a chunk away deletes its documents from the donor with fromMigrate, which must not
+    // remove them from the view
+    assert.commandWorked(st.s.adminCommand({split: coll.getFullName(), middle: {_id: 10}}));
+    assert.commandWorked(st.s.adminCommand({
+        moveChunk: coll.getFullName(),
+        find: {_id: 10},
+        to: st.shard1.shardName,
+        _waitForDelete: true
+    }));
+    assert.eq(10, st.shard0.getDB(dbName).coll.find().itcount());
+    assertView(initial);
+
+    // Moving it back inserts the documents on the primary shard with fromMigrate, which must not
+    // count them twice
+    assert.commandWorked(st.s.adminCommand({
+        moveChunk: coll.getFullName(),
+        find: {_id: 10},
+        to: st.shard0.shardName,
+        _waitForDelete: true
+    }));
+    assert.eq(20, st.shard0.getDB(dbName).coll.find().itcount());
+    assertView(initial);
+
+    // Regular deletes are still applied, and removing the $max recomputes the group
+    assert.writeOK(coll.remove({_id: 2}));
+    assertView([{_id: 0, total: 88, high: 18}, {_id: 1, total: 100, high: 19}]);
+    assert.writeOK(coll.remove({_id: 18}));
+    assertView([{_id: 0, total: 70, high: 16}, {_id: 1, total: 100, high: 19}]);
+
+    st.stop();
+})();
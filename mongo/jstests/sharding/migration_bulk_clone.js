@@ -0,0 +1,60 @@
+/**
+ * Tests that the documents of a migrated chunk are cloned in batches, for any value of
+ * migrateCloneInsertionBatchSize, and that the recipient's copy of the donor's secondary indexes
+ * covers all of them, on the recipient's secondaries as well.
+ */
+(function() {
+    'use strict';
+
+    const st = new ShardingTest({shards: 2, mongos: 1, rs: {nodes: 2}});
+    const dbName = 'test';
+    const coll = st.s.getDB(dbName).coll;
+    const nDocs = 300;
+
+    assert.commandWorked(st.s.adminCommand({enableSharding: dbName}));
+    st.ensurePrimaryShard(dbName, st.shard0.shardName);
+    assert.commandWorked(st.s.adminCommand({shardCollection: coll.getFullName(), key: {_id: 1}}));
+    assert.commandWorked(coll.createIndex({x: 1}));
+    assert.commandWorked(coll.createIndex({y: 1, x: -1}));
+
+    const padding = 'x'.repeat(1024);
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < nDocs; i++) {
+        bulk.insert({_id: i, x: i % 17, y: -i, padding: padding});
+    }
+    assert.writeOK(bulk.execute());
+
+    function assertShardHoldsEverything(rst) {
+        rst.awaitReplication();
+        rst.nodes.forEach(function(node) {
+            node.setSlaveOk();
+            const shardColl = node.getDB(dbName).coll;
+            assert.eq(nDocs, shardColl.find().itcount(), node.host);
+            assert.eq(nDocs, shardColl.find().hint({x: 1}).itcount(), node.host);
+            assert.eq(nDocs, shardColl.find().hint({y: 1, x: -1}).itcount(), node.host);
+        });
+    }
+
+    // The first migration to shard1 creates the collection and its indexes there, the later ones
+    // clone into an existing, empty collection.
+    let donor = st.rs0, recipient = st.rs1;
+    [0, 1, 7, 0].forEach(function(batchSize) {
+        assert.commandWorked(recipient.getPrimary().adminCommand(
+            {setParameter: 1, migrateCloneInsertionBatchSize: batchSize}));
+
+        assert.commandWorked(st.s.adminCommand({
+            moveChunk: coll.getFullName(),
+            find: {_id: 0},
+            to: recipient.name,
+            _waitForDelete: true
+        }));
+
+        assertShardHoldsEverything(recipient);
+        assert.eq(0, donor.getPrimary().getDB(dbName).coll.find().itcount());
+        assert.eq(nDocs, coll.find().itcount());
+
+        [donor, recipient] = [recipient, donor];
+    });
+
+    st.stop();
+})();
@@ -309,7 +309,9 @@
         splitChunk: {skip: "primary only"},
         splitVector: {skip: "primary only"},
         stageDebug: {skip: "primary only"},
+        startRecordingTraffic: {skip: "does not return user data"},
         startSession: {skip: "does not return user data"},
+        stopRecordingTraffic: {skip: "does not return user data"},
         top: {skip: "does not return user data"},
         touch: {skip: "does not return user data"},
         unsetSharding: {skip: "does not return user data"},
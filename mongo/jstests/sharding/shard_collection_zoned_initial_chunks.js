@@ -0,0 +1,69 @@
+/**
+ * Tests that sharding an empty collection with zones defined on it creates the initial chunks of
+ * each zone directly on the zone's shards, with the collection and its indexes already present
+ * there, rather than leaving them to be migrated by the balancer.
+ */
+(function() {
+    'use strict';
+
+    var st = new ShardingTest({shards: 3, mongos: 1, other: {enableBalancer: false}});
+
+    assert.commandWorked(st.s0.adminCommand({enableSharding: 'test'}));
+    st.ensurePrimaryShard('test', st.shard0.shardName);
+
+    var testDB = st.s0.getDB('test');
+    var configDB = st.s0.getDB('config');
+
+    assert.commandWorked(st.s0.adminCommand({addShardToZone: st.shard1.shardName, zone: 'A'}));
+    assert.commandWorked(st.s0.adminCommand({addShardToZone: st.shard2.shardName, zone: 'B'}));
+
+    // Zone ranges can only be assigned to sharded collections, but survive the collection being
+    // dropped.
+    assert.commandWorked(st.s0.adminCommand({shardCollection: 'test.foo', key: {x: 1}}));
+    assert.commandWorked(st.s0.adminCommand(
+        {updateZoneKeyRange: 'test.foo', min: {x: 0}, max: {x: 10}, zone: 'A'}));
+    assert.commandWorked(st.s0.adminCommand(
+        {updateZoneKeyRange: 'test.foo', min: {x: 10}, max: {x: 20}, zone: 'B'}));
+    assert(testDB.foo.drop());
+    assert.eq(2, configDB.tags.count({ns: 'test.foo'}));
+
+    assert.commandWorked(testDB.foo.createIndex({y: 1}));
+    assert.commandWorked(st.s0.adminCommand({shardCollection: 'test.foo', key: {x: 1}}));
+
+    function chunkShard(min) {
+        var chunk = configDB.chunks.findOne({ns: 'test.foo', min: min});
+        assert.neq(null, chunk, 'no chunk starting at ' + tojson(min));
+        return chunk.shard;
+    }
+
+    assert.eq(4, configDB.chunks.count({ns: 'test.foo'}));
+    assert.eq(st.shard1.shardName, chunkShard({x: 0}));
+    assert.eq(st.shard2.shardName, chunkShard({x: 10}));
+
+    // The collection must exist on the zones' shards with the same UUID and indexes as on the
+    // primary shard, so that it can be written to and migrated from right away.
+    var collUUID = configDB.collections.findOne({_id: 'test.foo'}).uuid;
+    [st.shard1, st.shard2].forEach(function(shard) {
+        var collInfos = shard.getDB('test').getCollectionInfos({name: 'foo'});
+        assert.eq(1, collInfos.length, tojson(collInfos));
+        assert.eq(collUUID, collInfos[0].info.uuid);
+
+        var indexKeys = shard.getDB('test').foo.getIndexes().map(function(index) {
+            return index.key;
+        });
+        assert.contains({x: 1}, indexKeys);
+        assert.contains({y: 1}, indexKeys);
+    });
+
+    assert.writeOK(testDB.foo.insert({x: 5}));
+    assert.writeOK(testDB.foo.insert({x: 15}));
+    assert.eq(1, st.shard1.getDB('test').foo.count({x: 5}));
+    assert.eq(1, st.shard2.getDB('test').foo.count({x: 15}));
+
+    // A chunk placed directly can be migrated like any other.
+    assert.commandWorked(st.s0.adminCommand(
+        {moveChunk: 'test.foo', find: {x: 5}, to: st.shard0.shardName, _waitForDelete: true}));
+    assert.eq(1, st.shard0.getDB('test').foo.count({x: 5}));
+
+    st.stop();
+})();
@@ -197,6 +197,50 @@ private:
     int _startPosition;
 };
 
+/**
+ * The stack of objects currently being validated. Real documents rarely nest more than a few
+ * levels deep, so the first kInlineFrames frames live inside the stack itself and only deeper
+ * documents pay for a heap allocation. This matters because every inbound document is validated
+ * when objcheck is on.
+ */
+class FrameStack {
+public:
+    void push_back(const ValidationObjectFrame& frame) {
+        if (_size < kInlineFrames) {
+            _inline[_size] = frame;
+        } else {
+            _overflow.push_back(frame);
+        }
+        ++_size;
+    }
+
+    void pop_back() {
+        --_size;
+        if (_size >= kInlineFrames) {
+            _overflow.pop_back();
+        }
+    }
+
+    ValidationObjectFrame& back() {
+        return _size > kInlineFrames ? _overflow.back() : _inline[_size - 1];
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+private:
+    static const size_t kInlineFrames = 32;
+
+    ValidationObjectFrame _inline[kInlineFrames];
+    std::vector<ValidationObjectFrame> _overflow;
+    size_t _size = 0;
+};
+
 /**
  * WARNING: only pass in a non-EOO idElem if it has been fully validated already!
  */
@@ -308,8 +352,7 @@ Status validateElementInfo(Buffer* buffer,
 }
 
 Status validateBSONIterative(Buffer* buffer) {
-    std::vector<ValidationObjectFrame> frames;
-    frames.reserve(16);
+    FrameStack frames;
     ValidationObjectFrame* curr = NULL;
     ValidationState::State state = ValidationState::BeginObj;
 
@@ -249,6 +249,24 @@ TEST(BSONValidateFast, NestedObject) {
     ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize() / 2, BSONVersion::kLatest));
 }
 
+TEST(BSONValidateFast, DeeplyNestedObject) {
+    // Deep enough that the validator's frame stack spills past its inline frames.
+    BSONObj x = BSON("leaf" << 1);
+    for (int i = 0; i < 100; ++i) {
+        x = BSON("a" << x << "b" << i);
+    }
+    ASSERT_OK(validateBSON(x.objdata(), x.objsize(), BSONVersion::kLatest));
+    ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize() / 2, BSONVersion::kLatest));
+
+    // Each level adds a 4 byte length, a type byte and the field name "a", so the object nested 40
+    // levels down starts at byte 7 * 40. Corrupt its length.
+    std::string copy(x.objdata(), x.objsize());
+    const size_t nestedStart = 7 * 40;
+    ASSERT_EQUALS(Object, copy[nestedStart - 3]);
+    copy[nestedStart] = copy[nestedStart] + 1;
+    ASSERT_NOT_OK(validateBSON(copy.data(), copy.size(), BSONVersion::kLatest));
+}
+
 TEST(BSONValidateFast, ErrorWithId) {
     BufBuilder bb;
     BSONObjBuilder ob(bb);
@@ -0,0 +1,107 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+// Builds a flat document of state.range(0) int fields.
+void BM_bsonObjBuilderAppendInts(benchmark::State& state) {
+    const auto numFields = state.range(0);
+    while (state.keepRunning()) {
+        BSONObjBuilder builder;
+        for (std::int64_t i = 0; i < numFields; ++i) {
+            builder.append("field", static_cast<int>(i));
+        }
+        benchmark::doNotOptimize(builder.done().objsize());
+    }
+    state.setItemsProcessed(state.iterations() * numFields);
+}
+BENCHMARK(BM_bsonObjBuilderAppendInts)->arg(1)->arg(10)->arg(100);
+
+// Builds a document with a mix of the field types found in typical user documents.
+void BM_bsonObjBuilderAppendMixed(benchmark::State& state) {
+    const Date_t now = Date_t::now();
+    const OID oid = OID::gen();
+    std::int64_t bytes = 0;
+    while (state.keepRunning()) {
+        BSONObjBuilder builder;
+        builder.append("_id", oid);
+        builder.append("name", "a moderately long string value");
+        builder.append("count", 42LL);
+        builder.append("ratio", 0.5);
+        builder.appendDate("createdAt", now);
+        builder.append("active", true);
+        {
+            BSONObjBuilder sub(builder.subobjStart("address"));
+            sub.append("street", "Main Street");
+            sub.append("number", 12);
+        }
+        {
+            BSONArrayBuilder arr(builder.subarrayStart("tags"));
+            arr.append("red");
+            arr.append("green");
+            arr.append("blue");
+        }
+        BSONObj obj = builder.obj();
+        bytes += obj.objsize();
+        benchmark::doNotOptimize(obj.objdata());
+    }
+    state.setBytesProcessed(bytes);
+}
+BENCHMARK(BM_bsonObjBuilderAppendMixed);
+
+// Iterates the fields of a document and looks up a field by name.
+void BM_bsonObjIterateAndFind(benchmark::State& state) {
+    const auto numFields = state.range(0);
+    BSONObjBuilder builder;
+    for (std::int64_t i = 0; i < numFields; ++i) {
+        builder.append("field" + std::to_string(i), static_cast<int>(i));
+    }
+    const BSONObj obj = builder.obj();
+    const std::string last = "field" + std::to_string(numFields - 1);
+
+    while (state.keepRunning()) {
+        long long sum = 0;
+        for (auto&& element : obj) {
+            sum += element.numberInt();
+        }
+        benchmark::doNotOptimize(sum);
+        benchmark::doNotOptimize(obj[last].numberInt());
+    }
+    state.setItemsProcessed(state.iterations() * numFields);
+}
+BENCHMARK(BM_bsonObjIterateAndFind)->arg(10)->arg(100);
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,105 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/field_offset_index.h"
+
+#include <algorithm>
+
+namespace mongo {
+
+namespace {
+thread_local ScopedFieldOffsetIndexes* currentFieldOffsetIndexes = nullptr;
+
+bool fieldNameLess(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.fieldNameStringData() < rhs.fieldNameStringData();
+}
+}  // namespace
+
+FieldOffsetIndex::FieldOffsetIndex(const BSONObj& obj) {
+    for (auto&& elem : obj) {
+        _elements.push_back(elem);
+    }
+    std::stable_sort(_elements.begin(), _elements.end(), fieldNameLess);
+}
+
+BSONElement FieldOffsetIndex::getField(StringData name) const {
+    auto it = std::lower_bound(
+        _elements.begin(), _elements.end(), name, [](const BSONElement& elem, StringData name) {
+            return elem.fieldNameStringData() < name;
+        });
+    if (it == _elements.end() || it->fieldNameStringData() != name) {
+        return BSONElement();
+    }
+    return *it;
+}
+
+BSONElement FieldOffsetIndex::getField(const BSONObj& obj, StringData name) {
+    if (auto index = ScopedFieldOffsetIndexes::find(obj)) {
+        return index->getField(name);
+    }
+    return obj.getField(name);
+}
+
+ScopedFieldOffsetIndexes::ScopedFieldOffsetIndexes(int minFields)
+    : _minFields(minFields), _enclosing(currentFieldOffsetIndexes) {
+    currentFieldOffsetIndexes = this;
+}
+
+ScopedFieldOffsetIndexes::~ScopedFieldOffsetIndexes() {
+    invariant(currentFieldOffsetIndexes == this);
+    currentFieldOffsetIndexes = _enclosing;
+}
+
+void ScopedFieldOffsetIndexes::add(const BSONObj& obj) {
+    if (_minFields <= 0 || obj.isEmpty() || _indexes.count(obj.objdata())) {
+        return;
+    }
+
+    // Count only as far as the threshold, so that small documents are not scanned to the end.
+    int numFields = 0;
+    for (BSONObjIterator it(obj); it.more() && numFields < _minFields; it.next()) {
+        ++numFields;
+    }
+    if (numFields < _minFields) {
+        return;
+    }
+    _indexes.emplace(obj.objdata(), FieldOffsetIndex(obj));
+}
+
+const FieldOffsetIndex* ScopedFieldOffsetIndexes::find(const BSONObj& obj) {
+    auto scope = currentFieldOffsetIndexes;
+    if (!scope || scope->_indexes.empty()) {
+        return nullptr;
+    }
+    auto it = scope->_indexes.find(obj.objdata());
+    return it == scope->_indexes.end() ? nullptr : &it->second;
+}
+
+}  // namespace mongo
@@ -0,0 +1,111 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/unordered_map.h"
+
+namespace mongo {
+
+/**
+ * A table of the top-level fields of one BSONObj, sorted by field name, so that looking a field
+ * up takes a binary search instead of a scan from the start of the object.
+ *
+ * Building the table costs one scan and a sort, so it only pays off for documents with many
+ * fields that are looked up many times, such as a wide document being inserted into a collection
+ * with many indexes. Code that does such lookups uses FieldOffsetIndex::getField(obj, name), which
+ * consults the index registered for 'obj' by an enclosing ScopedFieldOffsetIndexes on the current
+ * thread, and falls back to BSONObj::getField() otherwise.
+ *
+ * The index refers into the object's buffer, which must outlive it.
+ */
+class FieldOffsetIndex {
+public:
+    explicit FieldOffsetIndex(const BSONObj& obj);
+
+    /**
+     * Returns the first top-level field named 'name', or an EOO element if there is none. This
+     * matches BSONObj::getField().
+     */
+    BSONElement getField(StringData name) const;
+
+    size_t numFields() const {
+        return _elements.size();
+    }
+
+    /**
+     * Returns obj.getField(name), using the field offset index registered for 'obj' on this thread
+     * if there is one.
+     */
+    static BSONElement getField(const BSONObj& obj, StringData name);
+
+private:
+    // Sorted by field name. Elements with the same name keep their order in the object.
+    std::vector<BSONElement> _elements;
+};
+
+/**
+ * Registers field offset indexes for a set of documents on the current thread for the lifetime of
+ * this object. Scopes may nest; only the innermost one is consulted.
+ *
+ * The registered documents' buffers must outlive this object, and must not be modified while it
+ * exists.
+ */
+class ScopedFieldOffsetIndexes {
+    MONGO_DISALLOW_COPYING(ScopedFieldOffsetIndexes);
+
+public:
+    /**
+     * Only documents with at least 'minFields' top-level fields will be indexed.
+     */
+    explicit ScopedFieldOffsetIndexes(int minFields);
+    ~ScopedFieldOffsetIndexes();
+
+    /**
+     * Builds and registers an index for 'obj' if it has enough fields.
+     */
+    void add(const BSONObj& obj);
+
+    /**
+     * Returns the index registered for 'obj' in the innermost scope, or nullptr.
+     */
+    static const FieldOffsetIndex* find(const BSONObj& obj);
+
+private:
+    const int _minFields;
+    ScopedFieldOffsetIndexes* const _enclosing;
+    stdx::unordered_map<const char*, FieldOffsetIndex> _indexes;
+};
+
+}  // namespace mongo
@@ -0,0 +1,96 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/field_offset_index.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+BSONObj makeWideDocument(int numFields) {
+    BSONObjBuilder bob;
+    for (int i = numFields - 1; i >= 0; --i) {
+        bob.append(str::stream() << "f" << i, i);
+    }
+    return bob.obj();
+}
+
+TEST(FieldOffsetIndexTest, FindsEveryField) {
+    const auto doc = makeWideDocument(100);
+    FieldOffsetIndex index(doc);
+    ASSERT_EQ(index.numFields(), 100U);
+    for (auto&& elem : doc) {
+        ASSERT_EQ(index.getField(elem.fieldNameStringData()).rawdata(), elem.rawdata());
+    }
+    ASSERT(index.getField("missing").eoo());
+    ASSERT(index.getField("").eoo());
+}
+
+TEST(FieldOffsetIndexTest, ReturnsFirstOfDuplicateFields) {
+    const auto doc = BSON("b" << 1 << "a" << 2 << "b" << 3 << "a" << 4);
+    FieldOffsetIndex index(doc);
+    ASSERT_EQ(index.getField("a").numberInt(), 2);
+    ASSERT_EQ(index.getField("b").numberInt(), 1);
+}
+
+TEST(FieldOffsetIndexTest, LookupUsesRegisteredIndexOnlyWithinScope) {
+    const auto wide = makeWideDocument(10);
+    const auto narrow = makeWideDocument(2);
+    ASSERT(!ScopedFieldOffsetIndexes::find(wide));
+    {
+        ScopedFieldOffsetIndexes scope(5);
+        scope.add(wide);
+        scope.add(narrow);
+        ASSERT(ScopedFieldOffsetIndexes::find(wide));
+        ASSERT(!ScopedFieldOffsetIndexes::find(narrow));
+        ASSERT_EQ(FieldOffsetIndex::getField(wide, "f7").numberInt(), 7);
+        ASSERT_EQ(FieldOffsetIndex::getField(narrow, "f1").numberInt(), 1);
+        {
+            ScopedFieldOffsetIndexes inner(5);
+            ASSERT(!ScopedFieldOffsetIndexes::find(wide));
+            ASSERT_EQ(FieldOffsetIndex::getField(wide, "f7").numberInt(), 7);
+        }
+        ASSERT(ScopedFieldOffsetIndexes::find(wide));
+    }
+    ASSERT(!ScopedFieldOffsetIndexes::find(wide));
+}
+
+TEST(FieldOffsetIndexTest, ZeroMinFieldsDisablesIndexing) {
+    const auto doc = makeWideDocument(10);
+    ScopedFieldOffsetIndexes scope(0);
+    scope.add(doc);
+    ASSERT(!ScopedFieldOffsetIndexes::find(doc));
+}
+
+}  // namespace
+}  // namespace mongo
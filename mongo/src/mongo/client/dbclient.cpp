@@ -69,6 +69,7 @@
 #include "mongo/util/debug_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/message_port.h"
+#include "mongo/util/net/op_msg.h"
 #include "mongo/util/net/socket_exception.h"
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/net/ssl_options.h"
@@ -1369,11 +1370,25 @@ DBClientConnection::DBClientConnection(bool _autoReconnect,
     _numConnections.fetchAndAdd(1);
 }
 
+namespace {
+
+// Assigns a new id to an outgoing request. An OP_MSG checksum covers the header, so one the
+// caller appended is recomputed for the new id.
+void setNewRequestId(Message* toSend) {
+    toSend->header().setId(nextMessageId());
+    toSend->header().setResponseToMsgId(0);
+    if (toSend->operation() == dbMsg && OpMsg::isFlagSet(*toSend, OpMsg::kChecksumPresent)) {
+        OpMsg::removeChecksum(toSend);
+        OpMsg::appendChecksum(toSend);
+    }
+}
+
+}  // namespace
+
 void DBClientConnection::say(Message& toSend, bool isRetry, string* actualServer) {
     checkConnection();
     try {
-        toSend.header().setId(nextMessageId());
-        toSend.header().setResponseToMsgId(0);
+        setNewRequestId(&toSend);
         auto swm = _compressorManager.compressMessage(toSend);
         uassertStatusOK(swm.getStatus());
         port().say(swm.getValue());
@@ -1416,8 +1431,7 @@ bool DBClientConnection::call(Message& toSend,
     */
     checkConnection();
     try {
-        toSend.header().setId(nextMessageId());
-        toSend.header().setResponseToMsgId(0);
+        setNewRequestId(&toSend);
         auto swm = _compressorManager.compressMessage(toSend);
         uassertStatusOK(swm.getStatus());
 
@@ -28,7 +28,10 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/time_support.h"
 
@@ -38,9 +41,6 @@ class ConnectionString;
 class OperationContext;
 struct ReadPreferenceSetting;
 struct HostAndPort;
-template <typename T>
-class StatusWith;
-
 /**
  * Interface encapsulating the targeting logic for a given replica set or a standalone host.
  */
@@ -106,6 +106,32 @@ public:
      */
     virtual void markHostUnreachable(const HostAndPort& host, const Status& status) = 0;
 
+    /**
+     * Reports to the targeter that an operation run on 'host' took 'latency' to complete, so that
+     * later requests may prefer hosts which answer sooner. Targeters which have a single host
+     * ignore it.
+     */
+    virtual void updateHostWithOperationLatency(const HostAndPort& host, Milliseconds latency) {}
+
+    /**
+     * Returns how long an operation on 'host' may take before it counts as unusually slow, based on
+     * the latencies reported through updateHostWithOperationLatency, or boost::none if the
+     * targeter has no estimate for 'host'.
+     */
+    virtual boost::optional<Milliseconds> getOperationLatencyBound(const HostAndPort& host) {
+        return boost::none;
+    }
+
+    /**
+     * Finds a host other than 'excluded' matching readPref without performing any networking, for
+     * sending a second copy of a request which 'excluded' is slow to answer.
+     */
+    virtual StatusWith<HostAndPort> findAlternateHostNoWait(const ReadPreferenceSetting& readPref,
+                                                            const HostAndPort& excluded) {
+        return {ErrorCodes::FailedToSatisfyReadPreference,
+                "targeter does not support alternate hosts"};
+    }
+
 protected:
     RemoteCommandTargeter() = default;
 };
@@ -100,4 +100,25 @@ void RemoteCommandTargeterRS::markHostUnreachable(const HostAndPort& host, const
     _rsMonitor->failedHost(host, status);
 }
 
+void RemoteCommandTargeterRS::updateHostWithOperationLatency(const HostAndPort& host,
+                                                             Milliseconds latency) {
+    invariant(_rsMonitor);
+
+    _rsMonitor->updateHostOperationLatency(host, latency);
+}
+
+boost::optional<Milliseconds> RemoteCommandTargeterRS::getOperationLatencyBound(
+    const HostAndPort& host) {
+    invariant(_rsMonitor);
+
+    return _rsMonitor->getHostOperationLatencyBound(host);
+}
+
+StatusWith<HostAndPort> RemoteCommandTargeterRS::findAlternateHostNoWait(
+    const ReadPreferenceSetting& readPref, const HostAndPort& excluded) {
+    invariant(_rsMonitor);
+
+    return _rsMonitor->getAlternateHostNoRefresh(readPref, excluded);
+}
+
 }  // namespace mongo
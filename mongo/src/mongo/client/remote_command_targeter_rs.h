@@ -62,6 +62,13 @@ public:
 
     void markHostUnreachable(const HostAndPort& host, const Status& status) override;
 
+    void updateHostWithOperationLatency(const HostAndPort& host, Milliseconds latency) override;
+
+    boost::optional<Milliseconds> getOperationLatencyBound(const HostAndPort& host) override;
+
+    StatusWith<HostAndPort> findAlternateHostNoWait(const ReadPreferenceSetting& readPref,
+                                                    const HostAndPort& excluded) override;
+
 private:
     // Name of the replica set which this targeter maintains
     const std::string _rsName;
@@ -108,7 +108,7 @@ bool opTimeGreater(const Node* lhs, const Node* rhs) {
 
 bool compareLatencies(const Node* lhs, const Node* rhs) {
     // NOTE: this automatically compares Node::unknownLatency worse than all others.
-    return lhs->latencyMicros < rhs->latencyMicros;
+    return lhs->selectionLatencyMicros() < rhs->selectionLatencyMicros();
 }
 
 bool hostsEqual(const Node& lhs, const HostAndPort& rhs) {
@@ -329,6 +329,42 @@ void ReplicaSetMonitor::failedHost(const HostAndPort& host, const Status& status
     DEV _state->checkInvariants();
 }
 
+void ReplicaSetMonitor::updateHostOperationLatency(const HostAndPort& host,
+                                                   Milliseconds latency) {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    Node* node = _state->findNode(host);
+    if (node)
+        node->updateOperationLatency(durationCount<Microseconds>(latency));
+}
+
+boost::optional<Milliseconds> ReplicaSetMonitor::getHostOperationLatencyBound(
+    const HostAndPort& host) const {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    Node* node = _state->findNode(host);
+    if (!node || node->opLatencyMicros == unknownLatency)
+        return boost::none;
+
+    // As with TCP retransmission timeouts, the smoothed latency plus four times its mean deviation
+    // is exceeded only by the slowest few percent of operations.
+    return duration_cast<Milliseconds>(
+        Microseconds(node->opLatencyMicros + 4 * node->opLatencyDeviationMicros));
+}
+
+StatusWith<HostAndPort> ReplicaSetMonitor::getAlternateHostNoRefresh(
+    const ReadPreferenceSetting& criteria, const HostAndPort& excluded) const {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    HostAndPort out = _state->getMatchingHost(criteria, excluded);
+    if (out.empty()) {
+        return {ErrorCodes::FailedToSatisfyReadPreference,
+                str::stream() << "No host other than " << excluded
+                              << " matches read preference "
+                              << criteria.toString()
+                              << " for set "
+                              << getName()};
+    }
+    return {std::move(out)};
+}
+
 bool ReplicaSetMonitor::isPrimary(const HostAndPort& host) const {
     stdx::lock_guard<stdx::mutex> lk(_state->mutex);
     Node* node = _state->findNode(host);
@@ -439,6 +475,11 @@ void ReplicaSetMonitor::appendInfo(BSONObjBuilder& bsonObjBuilder) const {
         }
         builder.append("pingTimeMillis", pingTimeMillis);
 
+        if (node.opLatencyMicros != unknownLatency) {
+            builder.append("operationLatencyMillis",
+                           static_cast<long long>(node.opLatencyMicros / 1000));
+        }
+
         if (!node.tags.isEmpty()) {
             builder.append("tags", node.tags);
         }
@@ -926,7 +967,31 @@ void IsMasterReply::parse(const BSONObj& obj) {
     }
 }
 
-Node::Node(const HostAndPort& host) : host(host), latencyMicros(unknownLatency) {}
+void Node::updateOperationLatency(int64_t operationLatencyMicros) {
+    if (operationLatencyMicros < 0)
+        return;
+
+    if (opLatencyMicros == unknownLatency) {
+        opLatencyMicros = operationLatencyMicros;
+        opLatencyDeviationMicros = operationLatencyMicros / 2;
+        return;
+    }
+
+    // Smoothed average (1/8th the delta) and mean deviation (1/4th the delta), as TCP does for
+    // round trip times.
+    const int64_t delta = operationLatencyMicros - opLatencyMicros;
+    opLatencyDeviationMicros += (std::abs(delta) - opLatencyDeviationMicros) / 4;
+    opLatencyMicros += delta / 8;
+}
+
+int64_t Node::selectionLatencyMicros() const {
+    if (opLatencyMicros == unknownLatency)
+        return latencyMicros;
+    return std::max(latencyMicros, opLatencyMicros);
+}
+
+Node::Node(const HostAndPort& host)
+    : host(host), latencyMicros(unknownLatency), opLatencyMicros(unknownLatency) {}
 
 void Node::markFailed(const Status& status) {
     if (isUp) {
@@ -990,6 +1055,13 @@ void Node::update(const IsMasterReply& reply) {
             // update latency with smoothed moving average (1/4th the delta)
             latencyMicros += (reply.latencyMicros - latencyMicros) / 4;
         }
+
+        // Let the operation latency drift back towards the ping latency, so that a node which was
+        // slow once is eventually selected, and measured, again.
+        if (opLatencyMicros != unknownLatency) {
+            opLatencyMicros += (latencyMicros - opLatencyMicros) / 8;
+            opLatencyDeviationMicros -= opLatencyDeviationMicros / 8;
+        }
     }
 
     LOG(3) << "Updating " << host << " lastWriteDate to " << reply.lastWriteDate;
@@ -1031,33 +1103,38 @@ SetState::SetState(const MongoURI& uri)
     setUri = uri;
 }
 
-HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) const {
+HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria,
+                                      const HostAndPort& excluded) const {
     switch (criteria.pref) {
         // "Prefered" read preferences are defined in terms of other preferences
         case ReadPreference::PrimaryPreferred: {
-            HostAndPort out =
-                getMatchingHost(ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags));
+            HostAndPort out = getMatchingHost(
+                ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags), excluded);
             // NOTE: the spec says we should use the primary even if tags don't match
             if (!out.empty())
                 return out;
-            return getMatchingHost(ReadPreferenceSetting(
-                ReadPreference::SecondaryOnly, criteria.tags, criteria.maxStalenessSeconds));
+            return getMatchingHost(
+                ReadPreferenceSetting(
+                    ReadPreference::SecondaryOnly, criteria.tags, criteria.maxStalenessSeconds),
+                excluded);
         }
 
         case ReadPreference::SecondaryPreferred: {
-            HostAndPort out = getMatchingHost(ReadPreferenceSetting(
-                ReadPreference::SecondaryOnly, criteria.tags, criteria.maxStalenessSeconds));
+            HostAndPort out = getMatchingHost(
+                ReadPreferenceSetting(
+                    ReadPreference::SecondaryOnly, criteria.tags, criteria.maxStalenessSeconds),
+                excluded);
             if (!out.empty())
                 return out;
             // NOTE: the spec says we should use the primary even if tags don't match
             return getMatchingHost(
-                ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags));
+                ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags), excluded);
         }
 
         case ReadPreference::PrimaryOnly: {
             // NOTE: isMaster implies isUp
             Nodes::const_iterator it = std::find_if(nodes.begin(), nodes.end(), isMaster);
-            if (it == nodes.end())
+            if (it == nodes.end() || it->host == excluded)
                 return HostAndPort();
             return it->host;
         }
@@ -1112,8 +1189,8 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
 
                 std::vector<const Node*> matchingNodes;
                 for (size_t i = 0; i < nodes.size(); i++) {
-                    if (nodes[i].matches(criteria.pref) && nodes[i].matches(tag) &&
-                        matchNode(nodes[i])) {
+                    if (nodes[i].host != excluded && nodes[i].matches(criteria.pref) &&
+                        nodes[i].matches(tag) && matchNode(nodes[i])) {
                         matchingNodes.push_back(&nodes[i]);
                     }
                 }
@@ -1150,8 +1227,8 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
                 // and don't consider hosts further than a threshold from the closest.
                 std::sort(matchingNodes.begin(), matchingNodes.end(), compareLatencies);
                 for (size_t i = 1; i < matchingNodes.size(); i++) {
-                    int64_t distance =
-                        matchingNodes[i]->latencyMicros - matchingNodes[0]->latencyMicros;
+                    int64_t distance = matchingNodes[i]->selectionLatencyMicros() -
+                        matchingNodes[0]->selectionLatencyMicros();
                     if (distance >= latencyThresholdMicros) {
                         // this node and all remaining ones are too far away
                         matchingNodes.erase(matchingNodes.begin() + i, matchingNodes.end());
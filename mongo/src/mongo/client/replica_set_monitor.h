@@ -33,6 +33,8 @@
 #include <set>
 #include <string>
 
+#include <boost/optional.hpp>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
 #include "mongo/client/mongo_uri.h"
@@ -119,6 +121,27 @@ public:
      */
     void failedHost(const HostAndPort& host, const Status& status);
 
+    /**
+     * Reports that an operation run on 'host' took 'latency' from sending the request to receiving
+     * its response. Host selection prefers nodes on which operations complete sooner, not just
+     * those with the shortest isMaster round trip.
+     */
+    void updateHostOperationLatency(const HostAndPort& host, Milliseconds latency);
+
+    /**
+     * Returns a latency which operations on 'host' rarely exceed, derived from the smoothed
+     * average and mean deviation of the latencies reported with updateHostOperationLatency, or
+     * boost::none if no latency has been reported for 'host'.
+     */
+    boost::optional<Milliseconds> getHostOperationLatencyBound(const HostAndPort& host) const;
+
+    /**
+     * Returns a host other than 'excluded' which matches 'criteria', using only the current view
+     * of the set. Returns FailedToSatisfyReadPreference if there is none.
+     */
+    StatusWith<HostAndPort> getAlternateHostNoRefresh(const ReadPreferenceSetting& criteria,
+                                                      const HostAndPort& excluded) const;
+
     /**
      * Returns true if this node is the master based ONLY on local data. Be careful, return may
      * be stale.
@@ -122,10 +122,26 @@ public:
          */
         void update(const IsMasterReply& reply);
 
+        /**
+         * Folds the latency of an operation run on this node into opLatencyMicros.
+         */
+        void updateOperationLatency(int64_t operationLatencyMicros);
+
+        /**
+         * Returns the latency host selection orders nodes by: the isMaster round trip, or the
+         * smoothed operation latency if that is known and longer.
+         */
+        int64_t selectionLatencyMicros() const;
+
         HostAndPort host;
         bool isUp{false};
         bool isMaster{false};
         int64_t latencyMicros{};
+        // Smoothed latency of the operations run on this node and its mean deviation. Unknown until
+        // the first operation latency is reported, and decays towards latencyMicros with each
+        // isMaster reply so that a node which stopped receiving operations is tried again.
+        int64_t opLatencyMicros;
+        int64_t opLatencyDeviationMicros{0};
         BSONObj tags;  // owned
         int minWireVersion{};
         int maxWireVersion{};
@@ -151,7 +167,8 @@ public:
      *
      * Note: Uses only local data and does not go over the network.
      */
-    HostAndPort getMatchingHost(const ReadPreferenceSetting& criteria) const;
+    HostAndPort getMatchingHost(const ReadPreferenceSetting& criteria,
+                                const HostAndPort& excluded = HostAndPort()) const;
 
     /**
      * Returns the Node with the given host, or NULL if no Node has that host.
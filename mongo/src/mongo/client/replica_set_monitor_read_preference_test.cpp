@@ -50,7 +50,8 @@ HostAndPort selectNode(const vector<Node>& nodes,
                        ReadPreference pref,
                        const TagSet& tagSet,
                        int latencyThresholdMillis,
-                       bool* isPrimarySelected) {
+                       bool* isPrimarySelected,
+                       const HostAndPort& excluded = HostAndPort()) {
     invariant(!nodes.empty());
 
     set<HostAndPort> seeds;
@@ -61,7 +62,7 @@ HostAndPort selectNode(const vector<Node>& nodes,
     set.latencyThresholdMicros = latencyThresholdMillis * 1000;
 
     ReadPreferenceSetting criteria(pref, tagSet);
-    HostAndPort out = set.getMatchingHost(criteria);
+    HostAndPort out = set.getMatchingHost(criteria, excluded);
     if (isPrimarySelected && !out.empty()) {
         Node* node = set.findNode(out);
         ASSERT(node);
@@ -298,6 +299,93 @@ TEST(ReplSetMonitorReadPref, NearestOneLocal) {
     ASSERT(!isPrimarySelected);
 }
 
+TEST(ReplSetMonitorReadPref, NearestSlowOperationsOutweighPing) {
+    vector<Node> nodes = getThreeMemberWithTags();
+    TagSet tags(getDefaultTagSet());
+
+    nodes[0].latencyMicros = 10 * 1000;
+    nodes[1].latencyMicros = 20 * 1000;
+    nodes[2].latencyMicros = 30 * 1000;
+
+    // Operations on "a" take longer than the round trip to "c".
+    nodes[0].updateOperationLatency(100 * 1000);
+    nodes[1].updateOperationLatency(25 * 1000);
+
+    bool isPrimarySelected = false;
+    HostAndPort host =
+        selectNode(nodes, mongo::ReadPreference::Nearest, tags, 3, &isPrimarySelected);
+
+    ASSERT_EQUALS("b", host.host());
+    ASSERT(isPrimarySelected);
+}
+
+TEST(ReplSetMonitorReadPref, OperationLatencyIsSmoothed) {
+    Node node(HostAndPort("a"));
+    node.latencyMicros = 1000;
+
+    node.updateOperationLatency(8000);
+    ASSERT_EQUALS(8000, node.selectionLatencyMicros());
+
+    // A single fast operation only moves the average an eighth of the way.
+    node.updateOperationLatency(0);
+    ASSERT_EQUALS(7000, node.selectionLatencyMicros());
+
+    // The operation latency never makes a node look closer than its ping latency.
+    for (int i = 0; i < 100; i++) {
+        node.updateOperationLatency(0);
+    }
+    ASSERT_EQUALS(1000, node.selectionLatencyMicros());
+}
+
+TEST(ReplSetMonitorReadPref, SecOnlyExcludedHost) {
+    vector<Node> nodes = getThreeMemberWithTags();
+    TagSet tags(getDefaultTagSet());
+
+    nodes[0].latencyMicros = 10 * 1000;
+    nodes[1].latencyMicros = 20 * 1000;
+    nodes[2].latencyMicros = 30 * 1000;
+
+    bool isPrimarySelected = false;
+    HostAndPort host = selectNode(nodes,
+                                  mongo::ReadPreference::SecondaryOnly,
+                                  tags,
+                                  3,
+                                  &isPrimarySelected,
+                                  HostAndPort("a"));
+
+    ASSERT_EQUALS("c", host.host());
+    ASSERT(!isPrimarySelected);
+}
+
+TEST(ReplSetMonitorReadPref, PriOnlyExcludedPrimary) {
+    vector<Node> nodes = getThreeMemberWithTags();
+    TagSet tags(getDefaultTagSet());
+
+    bool isPrimarySelected = false;
+    HostAndPort host = selectNode(
+        nodes, mongo::ReadPreference::PrimaryOnly, tags, 3, &isPrimarySelected, HostAndPort("b"));
+
+    ASSERT(host.empty());
+}
+
+TEST(ReplSetMonitorReadPref, SecPrefExcludedSecondaryFallsBackToPrimary) {
+    vector<Node> nodes = getThreeMemberWithTags();
+    TagSet tags(getDefaultTagSet());
+
+    nodes[2].markFailed({ErrorCodes::InternalError, "down"});
+
+    bool isPrimarySelected = false;
+    HostAndPort host = selectNode(nodes,
+                                  mongo::ReadPreference::SecondaryPreferred,
+                                  tags,
+                                  3,
+                                  &isPrimarySelected,
+                                  HostAndPort("a"));
+
+    ASSERT_EQUALS("b", host.host());
+    ASSERT(isPrimarySelected);
+}
+
 TEST(ReplSetMonitorReadPref, PriOnlyWithTagsNoMatch) {
     vector<Node> nodes = getThreeMemberWithTags();
     TagSet tags(getP2TagSet());
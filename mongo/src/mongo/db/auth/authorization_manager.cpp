@@ -140,6 +140,14 @@ const int AuthorizationManager::schemaVersion26Upgrade;
 const int AuthorizationManager::schemaVersion26Final;
 const int AuthorizationManager::schemaVersion28SCRAM;
 
+namespace {
+
+// The fetch phase key under which the stored authorization schema version is read.  User names
+// always have a non-empty user and database, so this never collides with a user's fetch phase.
+const UserName kSchemaVersionFetchKey;
+
+}  // namespace
+
 /**
  * Guard object for synchronizing accesses to data cached in AuthorizationManager instances.
  * This guard allows one thread to access the cache at a time, and provides an exception-safe
@@ -150,17 +158,19 @@ const int AuthorizationManager::schemaVersion28SCRAM;
  * std::lock_guard, and perform reads or writes of the cache.
  *
  * Alternatively, one may instantiate the guard, examine the cache, and then enter into an
- * update mode by first wait()ing until otherUpdateInFetchPhase() is false, and then
- * calling beginFetchPhase().  At this point, other threads may acquire the guard in the simple
- * manner and do reads, but other threads may not enter into a fetch phase.  During the fetch
- * phase, the thread should perform required network or disk activity to determine what update
- * it will make to the cache.  Then, it should call endFetchPhase(), to reacquire the user cache
- * mutex.  At that point, the thread can make its modifications to the cache and let the guard
- * go out of scope.
+ * update mode for a particular user by first wait()ing until otherUpdateInFetchPhase() is false
+ * for that user, and then calling beginFetchPhase().  At this point, other threads may acquire
+ * the guard in the simple manner and do reads, and may enter into a fetch phase for other users,
+ * but not for the same user.  During the fetch phase, the thread should perform required network
+ * or disk activity to determine what update it will make to the cache.  Then, it should call
+ * endFetchPhase(), to reacquire the user cache mutex.  At that point, the thread can make its
+ * modifications to the cache and let the guard go out of scope.
  *
- * All updates by guards using a fetch-phase are totally ordered with respect to one another,
- * and all guards using no fetch phase are totally ordered with respect to one another, but
- * there is not a total ordering among all guard objects.
+ * All updates by guards using a fetch-phase for the same user are totally ordered with respect to
+ * one another, and all guards using no fetch phase are totally ordered with respect to one
+ * another, but there is not a total ordering among all guard objects.  Fetching the stored
+ * authorization schema version uses a fetch phase for kSchemaVersionFetchKey, which never names a
+ * real user.
  *
  * The cached data has an associated counter, called the cache generation.  If the cache
  * generation changes while a guard is in fetch phase, the fetched data should not be stored
@@ -174,20 +184,13 @@ class AuthorizationManager::CacheGuard {
     MONGO_DISALLOW_COPYING(CacheGuard);
 
 public:
-    enum FetchSynchronization { fetchSynchronizationAutomatic, fetchSynchronizationManual };
-
     /**
      * Constructs a cache guard, locking the mutex that synchronizes user cache accesses.
      */
-    CacheGuard(AuthorizationManager* authzManager,
-               const FetchSynchronization sync = fetchSynchronizationAutomatic)
+    explicit CacheGuard(AuthorizationManager* authzManager)
         : _isThisGuardInFetchPhase(false),
           _authzManager(authzManager),
-          _lock(authzManager->_cacheMutex) {
-        if (fetchSynchronizationAutomatic == sync) {
-            synchronizeWithFetchPhase();
-        }
-    }
+          _lock(authzManager->_cacheMutex) {}
 
     /**
      * Releases the mutex that synchronizes user cache access, if held, and notifies
@@ -198,17 +201,17 @@ public:
             _lock.lock();
         }
         if (_isThisGuardInFetchPhase) {
-            fassert(17190, _authzManager->_isFetchPhaseBusy);
-            _authzManager->_isFetchPhaseBusy = false;
+            fassert(17190, _authzManager->_usersInFetchPhase.erase(_fetchKey) == 1);
             _authzManager->_fetchPhaseIsReady.notify_all();
         }
     }
 
     /**
-     * Returns true of the authzManager reports that it is in fetch phase.
+     * Returns true if the authzManager reports that another update for 'fetchKey' is in fetch
+     * phase.
      */
-    bool otherUpdateInFetchPhase() {
-        return _authzManager->_isFetchPhaseBusy;
+    bool otherUpdateInFetchPhase(const UserName& fetchKey) {
+        return _authzManager->_usersInFetchPhase.count(fetchKey) > 0;
     }
 
     /**
@@ -220,13 +223,14 @@ public:
     }
 
     /**
-     * Enters fetch phase, releasing the _authzManager->_cacheMutex after recording the current
-     * cache generation.
+     * Enters fetch phase for 'fetchKey', releasing the _authzManager->_cacheMutex after recording
+     * the current cache generation.
      */
-    void beginFetchPhase() {
-        fassert(17191, !_authzManager->_isFetchPhaseBusy);
+    void beginFetchPhase(const UserName& fetchKey) {
+        fassert(17191, !_isThisGuardInFetchPhase);
+        fassert(17192, _authzManager->_usersInFetchPhase.insert(fetchKey).second);
         _isThisGuardInFetchPhase = true;
-        _authzManager->_isFetchPhaseBusy = true;
+        _fetchKey = fetchKey;
         _startGeneration = _authzManager->_cacheGeneration;
         _lock.unlock();
     }
@@ -236,10 +240,10 @@ public:
      */
     void endFetchPhase() {
         _lock.lock();
-        // We do not clear _authzManager->_isFetchPhaseBusy or notify waiters until
-        // ~CacheGuard(), for two reasons.  First, there's no value to notifying the waiters
-        // before you're ready to release the mutex, because they'll just go to sleep on the
-        // mutex.  Second, in order to meaningfully check the preconditions of
+        // We do not clear this guard's entry in _authzManager->_usersInFetchPhase or notify
+        // waiters until ~CacheGuard(), for two reasons.  First, there's no value to notifying the
+        // waiters before you're ready to release the mutex, because they'll just go to sleep on
+        // the mutex.  Second, in order to meaningfully check the preconditions of
         // isSameCacheGeneration(), we need a state that means "fetch phase was entered and now
         // has been exited."  That state is _isThisGuardInFetchPhase == true and
         // _lock.owns_lock() == true.
@@ -258,14 +262,7 @@ public:
     }
 
 private:
-    void synchronizeWithFetchPhase() {
-        while (otherUpdateInFetchPhase())
-            wait();
-        fassert(17192, !_authzManager->_isFetchPhaseBusy);
-        _isThisGuardInFetchPhase = true;
-        _authzManager->_isFetchPhaseBusy = true;
-    }
-
+    UserName _fetchKey;
     OID _startGeneration;
     bool _isThisGuardInFetchPhase;
     AuthorizationManager* _authzManager;
@@ -276,8 +273,7 @@ AuthorizationManager::AuthorizationManager(std::unique_ptr<AuthzManagerExternalS
     : _authEnabled(false),
       _privilegeDocsExist(false),
       _externalState(std::move(externalState)),
-      _version(schemaVersionInvalid),
-      _isFetchPhaseBusy(false) {
+      _version(schemaVersionInvalid) {
     _updateCacheGeneration_inlock();
 }
 
@@ -307,12 +303,12 @@ bool AuthorizationManager::shouldValidateAuthSchemaOnStartup() {
 }
 
 Status AuthorizationManager::getAuthorizationVersion(OperationContext* opCtx, int* version) {
-    CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
+    CacheGuard guard(this);
     int newVersion = _version;
     if (schemaVersionInvalid == newVersion) {
-        while (guard.otherUpdateInFetchPhase())
+        while (guard.otherUpdateInFetchPhase(kSchemaVersionFetchKey))
             guard.wait();
-        guard.beginFetchPhase();
+        guard.beginFetchPhase(kSchemaVersionFetchKey);
         Status status = _externalState->getStoredAuthorizationVersion(opCtx, &newVersion);
         guard.endFetchPhase();
         if (!status.isOK()) {
@@ -331,7 +327,7 @@ Status AuthorizationManager::getAuthorizationVersion(OperationContext* opCtx, in
 }
 
 OID AuthorizationManager::getCacheGeneration() {
-    CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
+    CacheGuard guard(this);
     return _cacheGeneration;
 }
 
@@ -504,9 +500,9 @@ Status AuthorizationManager::acquireUser(OperationContext* opCtx,
 
     unordered_map<UserName, User*>::iterator it;
 
-    CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
+    CacheGuard guard(this);
     while ((_userCache.end() == (it = _userCache.find(userName))) &&
-           guard.otherUpdateInFetchPhase()) {
+           guard.otherUpdateInFetchPhase(userName)) {
         guard.wait();
     }
 
@@ -521,8 +517,10 @@ Status AuthorizationManager::acquireUser(OperationContext* opCtx,
 
     std::unique_ptr<User> user;
 
+    // Fetches of distinct users proceed in parallel; only a concurrent fetch of this same user is
+    // waited for above, so that a user is never cached twice.
     int authzVersion = _version;
-    guard.beginFetchPhase();
+    guard.beginFetchPhase(userName);
 
     // Number of times to retry a user document that fetches due to transient
     // AuthSchemaIncompatible errors.  These errors should only ever occur during and shortly
@@ -614,7 +612,7 @@ void AuthorizationManager::releaseUser(User* user) {
         return;
     }
 
-    CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
+    CacheGuard guard(this);
     user->decrementRefCount();
     if (user->getRefCount() == 0) {
         // If it's been invalidated then it's not in the _userCache anymore.
@@ -627,7 +625,7 @@ void AuthorizationManager::releaseUser(User* user) {
 }
 
 void AuthorizationManager::invalidateUserByName(const UserName& userName) {
-    CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
+    CacheGuard guard(this);
     _updateCacheGeneration_inlock();
     unordered_map<UserName, User*>::iterator it = _userCache.find(userName);
     if (it == _userCache.end()) {
@@ -640,7 +638,7 @@ void AuthorizationManager::invalidateUserByName(const UserName& userName) {
 }
 
 void AuthorizationManager::invalidateUsersFromDB(const std::string& dbname) {
-    CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
+    CacheGuard guard(this);
     _updateCacheGeneration_inlock();
     unordered_map<UserName, User*>::iterator it = _userCache.begin();
     while (it != _userCache.end()) {
@@ -655,7 +653,7 @@ void AuthorizationManager::invalidateUsersFromDB(const std::string& dbname) {
 }
 
 void AuthorizationManager::invalidateUserCache() {
-    CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
+    CacheGuard guard(this);
     _invalidateUserCache_inlock();
 }
 
@@ -47,6 +47,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/server_options.h"
 #include "mongo/platform/unordered_map.h"
+#include "mongo/platform/unordered_set.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
@@ -422,21 +423,23 @@ private:
     OID _cacheGeneration;
 
     /**
-     * True if there is an update to the _userCache in progress, and that update is currently in
-     * the "fetch phase", during which it does not hold the _cacheMutex.
+     * Names of the users for which an update to the _userCache is in progress and currently in
+     * the "fetch phase", during which it does not hold the _cacheMutex.  Updates for distinct
+     * users may be in fetch phase concurrently.
      *
      * Manipulated via CacheGuard.
      */
-    bool _isFetchPhaseBusy;
+    unordered_set<UserName> _usersInFetchPhase;
 
     /**
-     * Protects _userCache, _cacheGeneration, _version and _isFetchPhaseBusy.  Manipulated
+     * Protects _userCache, _cacheGeneration, _version and _usersInFetchPhase.  Manipulated
      * via CacheGuard.
      */
     stdx::mutex _cacheMutex;
 
     /**
-     * Condition used to signal that it is OK for another CacheGuard to enter a fetch phase.
+     * Condition used to signal that a fetch phase has ended, so that a CacheGuard waiting on the
+     * same user may find it in the cache or enter a fetch phase itself.
      * Manipulated via CacheGuard.
      */
     stdx::condition_variable _fetchPhaseIsReady;
@@ -43,6 +43,7 @@
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/service_context_noop.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer_mock.h"
 #include "mongo/unittest/unittest.h"
@@ -246,6 +247,64 @@ TEST_F(AuthorizationManagerTest, testAcquireV2User) {
     authzManager->releaseUser(v2cluster);
 }
 
+TEST_F(AuthorizationManagerTest, ConcurrentAcquisitionsShareOneCachedUserPerName) {
+    OperationContextNoop opCtx;
+
+    const int kNumUsers = 4;
+    const int kNumThreadsPerUser = 8;
+    for (int i = 0; i < kNumUsers; ++i) {
+        const std::string userName = str::stream() << "user" << i;
+        ASSERT_OK(externalState->insertPrivilegeDocument(
+            &opCtx,
+            BSON("_id"
+                 << ("test." + userName)
+                 << "user"
+                 << userName
+                 << "db"
+                 << "test"
+                 << "credentials"
+                 << BSON("MONGODB-CR"
+                         << "password")
+                 << "roles"
+                 << BSON_ARRAY(BSON("role"
+                                    << "read"
+                                    << "db"
+                                    << "test"))),
+            BSONObj()));
+    }
+
+    std::vector<User*> acquired(kNumUsers * kNumThreadsPerUser, nullptr);
+    std::vector<Status> statuses(acquired.size(), Status::OK());
+    std::vector<stdx::thread> threads;
+    for (size_t i = 0; i < acquired.size(); ++i) {
+        threads.emplace_back([this, i, &acquired, &statuses] {
+            OperationContextNoop threadOpCtx;
+            const UserName userName(str::stream() << "user" << (i % kNumUsers), "test");
+            statuses[i] = authzManager->acquireUser(&threadOpCtx, userName, &acquired[i]);
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < acquired.size(); ++i) {
+        ASSERT_OK(statuses[i]);
+        ASSERT(acquired[i]);
+        ASSERT(acquired[i]->isValid());
+        ASSERT_EQUALS(acquired[i % kNumUsers], acquired[i]);
+        ASSERT_EQUALS(UserName(str::stream() << "user" << (i % kNumUsers), "test"),
+                      acquired[i]->getName());
+    }
+    for (int i = 0; i < kNumUsers; ++i) {
+        ASSERT_EQUALS(static_cast<uint32_t>(kNumThreadsPerUser), acquired[i]->getRefCount());
+    }
+
+    // Make sure the users' refCounts are 0 at the end of the test to avoid an assertion failure
+    for (auto&& user : acquired) {
+        authzManager->releaseUser(user);
+    }
+}
+
 TEST_F(AuthorizationManagerTest, testLocalX509Authorization) {
     ServiceContextNoop serviceContext;
     transport::TransportLayerMock transportLayer{};
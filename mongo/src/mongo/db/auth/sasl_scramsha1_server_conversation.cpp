@@ -39,7 +39,11 @@
 #include "mongo/crypto/mechanism_scram.h"
 #include "mongo/crypto/sha1_block.h"
 #include "mongo/db/auth/sasl_options.h"
+#include "mongo/db/auth/user.h"
+#include "mongo/db/auth/user_name_hash.h"
 #include "mongo/platform/random.h"
+#include "mongo/platform/unordered_map.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/base64.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -53,6 +57,57 @@ namespace mongo {
 using std::unique_ptr;
 using std::string;
 
+namespace {
+
+/**
+ * Caches the SCRAM credentials generated on the fly for users which only have MONGODB-CR
+ * credentials, keyed on the user name and its MONGODB-CR password hash.
+ *
+ * Generating the credentials runs the PBKDF2 key derivation and picks a fresh salt. Reusing them
+ * spares the server that work on every connection, and keeps the salt stable so that clients'
+ * own caches of derived SCRAM secrets can hit.
+ */
+class MixedModeCredentialsCache {
+public:
+    User::SCRAMCredentials getOrGenerate(const UserName& userName, const std::string& password) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            auto it = _cache.find(userName);
+            if (it != _cache.end() && it->second.first == password) {
+                return it->second.second;
+            }
+        }
+
+        // Use a default value of 5000 for the scramIterationCount when in mixed mode,
+        // overriding the default value (10000) used for SCRAM mode or the user-given value.
+        const int mixedModeScramIterationCount = 5000;
+        BSONObj scramCreds = scram::generateCredentials(password, mixedModeScramIterationCount);
+
+        User::SCRAMCredentials creds;
+        creds.iterationCount = scramCreds[scram::iterationCountFieldName].Int();
+        creds.salt = scramCreds[scram::saltFieldName].String();
+        creds.storedKey = scramCreds[scram::storedKeyFieldName].String();
+        creds.serverKey = scramCreds[scram::serverKeyFieldName].String();
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_cache.size() >= kMaxEntries) {
+            _cache.clear();
+        }
+        _cache[userName] = std::make_pair(password, creds);
+        return creds;
+    }
+
+private:
+    static const size_t kMaxEntries = 10000;
+
+    stdx::mutex _mutex;
+    unordered_map<UserName, std::pair<std::string, User::SCRAMCredentials>> _cache;
+};
+
+MixedModeCredentialsCache mixedModeCredentialsCache;
+
+}  // namespace
+
 SaslSCRAMSHA1ServerConversation::SaslSCRAMSHA1ServerConversation(
     SaslAuthenticationSession* saslAuthSession)
     : SaslServerConversation(saslAuthSession), _step(0), _authMessage(""), _nonce("") {}
@@ -194,15 +249,7 @@ StatusWith<bool> SaslSCRAMSHA1ServerConversation::_firstStep(std::vector<string>
 
     // Generate SCRAM credentials on the fly for mixed MONGODB-CR/SCRAM mode.
     if (_creds.scram.salt.empty() && !_creds.password.empty()) {
-        // Use a default value of 5000 for the scramIterationCount when in mixed mode,
-        // overriding the default value (10000) used for SCRAM mode or the user-given value.
-        const int mixedModeScramIterationCount = 5000;
-        BSONObj scramCreds =
-            scram::generateCredentials(_creds.password, mixedModeScramIterationCount);
-        _creds.scram.iterationCount = scramCreds[scram::iterationCountFieldName].Int();
-        _creds.scram.salt = scramCreds[scram::saltFieldName].String();
-        _creds.scram.storedKey = scramCreds[scram::storedKeyFieldName].String();
-        _creds.scram.serverKey = scramCreds[scram::serverKeyFieldName].String();
+        _creds.scram = mixedModeCredentialsCache.getOrGenerate(userName, _creds.password);
     }
 
     // Generate server-first-message
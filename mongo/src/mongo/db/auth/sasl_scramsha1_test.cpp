@@ -524,6 +524,46 @@ TEST_F(SCRAMSHA1Fixture, testMONGODBCR) {
     ASSERT_EQ(goalState, runSteps(saslServerSession.get(), saslClientSession.get()));
 }
 
+TEST_F(SCRAMSHA1Fixture, testMONGODBCRReusesGeneratedSCRAMCredentials) {
+    authzManagerExternalState
+        ->insertPrivilegeDocument(
+            opCtx.get(), generateMONGODBCRUserDocument("sajack", "sajack"), BSONObj())
+        .transitional_ignore();
+
+    // Returns the salt and iteration count from the server-first-message of a new conversation.
+    auto authenticate = [&] {
+        std::string saltAndIterations;
+        SCRAMMutators mutator;
+        mutator.setMutator(SaslTestState(SaslTestState::kServer, 1),
+                           [&saltAndIterations](std::string& serverMessage) {
+                               saltAndIterations = serverMessage.substr(serverMessage.find(",s="));
+                           });
+
+        NativeSaslAuthenticationSession serverSession(authzSession.get());
+        serverSession.setOpCtxt(opCtx.get());
+        ASSERT_OK(
+            serverSession.start("test", "SCRAM-SHA-1", "mongodb", "MockServer.test", 1, false));
+        NativeSaslClientSession clientSession;
+        clientSession.setParameter(NativeSaslClientSession::parameterMechanism, "SCRAM-SHA-1");
+        clientSession.setParameter(NativeSaslClientSession::parameterServiceName, "mongodb");
+        clientSession.setParameter(NativeSaslClientSession::parameterServiceHostname,
+                                   "MockServer.test");
+        clientSession.setParameter(NativeSaslClientSession::parameterServiceHostAndPort,
+                                   "MockServer.test:27017");
+        clientSession.setParameter(NativeSaslClientSession::parameterUser, "sajack");
+        clientSession.setParameter(NativeSaslClientSession::parameterPassword,
+                                   createPasswordDigest("sajack", "sajack"));
+        ASSERT_OK(clientSession.initialize());
+
+        ASSERT_EQ(goalState, runSteps(&serverSession, &clientSession, mutator));
+        return saltAndIterations;
+    };
+
+    const std::string first = authenticate();
+    ASSERT_FALSE(first.empty());
+    ASSERT_EQ(first, authenticate());
+}
+
 TEST(SCRAMSHA1Cache, testGetFromEmptyCache) {
     SCRAMSHA1ClientCache cache;
     std::string saltStr("saltsaltsaltsalt");
@@ -45,11 +45,13 @@
 #include "mongo/db/client.h"
 #include "mongo/db/commands/feature_compatibility_version_command_parser.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/recovery_unit.h"
 #include "mongo/db/views/view_catalog.h"
 #include "mongo/s/catalog/type_collection.h"
@@ -77,6 +79,7 @@ struct CollModRequest {
     std::string collValidationLevel = {};
     BSONElement usePowerOf2Sizes = {};
     BSONElement noPadding = {};
+    BSONElement cacheResident = {};
 };
 
 StatusWith<CollModRequest> parseCollModRequest(OperationContext* opCtx,
@@ -232,6 +235,11 @@ StatusWith<CollModRequest> parseCollModRequest(OperationContext* opCtx,
                 return Status(ErrorCodes::InvalidOptions, "'viewOn' option must be a string");
             }
             cmr.viewOn = e.str();
+        } else if (fieldName == "cacheResident" && !isView) {
+            if (e.type() != mongo::Bool) {
+                return Status(ErrorCodes::InvalidOptions, "'cacheResident' option must be a bool");
+            }
+            cmr.cacheResident = e;
         } else {
             if (isView) {
                 return Status(ErrorCodes::InvalidOptions,
@@ -256,6 +264,25 @@ StatusWith<CollModRequest> parseCollModRequest(OperationContext* opCtx,
     return {std::move(cmr)};
 }
 
+/**
+ * Asks the storage engine to keep the collection and all of its indexes resident in its cache, or
+ * to stop doing so. The setting is not persisted in the collection options.
+ */
+Status setCacheResident(OperationContext* opCtx, Collection* coll, bool resident) {
+    Status status = coll->getRecordStore()->setCacheResident(opCtx, resident);
+    if (!status.isOK())
+        return status;
+
+    IndexCatalog::IndexIterator it = coll->getIndexCatalog()->getIndexIterator(opCtx, true);
+    while (it.more()) {
+        IndexDescriptor* desc = it.next();
+        status = coll->getIndexCatalog()->getIndex(desc)->setCacheResident(opCtx, resident);
+        if (!status.isOK())
+            return status;
+    }
+    return Status::OK();
+}
+
 /**
  * Set a collection option flag for 'UsePowerOf2Sizes' or 'NoPadding'. Appends both the new and
  * old flag setting to the given 'result' builder.
@@ -426,6 +453,18 @@ Status _collModInternal(OperationContext* opCtx,
     if (!cmr.noPadding.eoo())
         setCollectionOptionFlag(opCtx, coll, cmr.noPadding, result);
 
+    // CacheResident
+    if (!cmr.cacheResident.eoo()) {
+        Status status = setCacheResident(opCtx, coll, cmr.cacheResident.boolean());
+        if (!status.isOK()) {
+            // A secondary must not stop applying the oplog because an index was busy; the setting
+            // is only a cache hint, so carry on without it.
+            if (opCtx->writesAreReplicated())
+                return status;
+            warning() << "Could not apply cacheResident to " << nss << ": " << redact(status);
+        }
+    }
+
     // Modify collection UUID if we are upgrading or downgrading. This is a no-op if we have
     // already upgraded or downgraded. As we don't assign UUIDs to system.indexes (SERVER-29926),
     // don't implicitly upgrade them on collMod either.
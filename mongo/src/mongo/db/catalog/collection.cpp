@@ -137,6 +137,11 @@ std::string CompactOptions::toString() const {
 
     ss << " validateDocuments: " << validateDocuments;
 
+    if (online) {
+        ss << " online: (sliceSecs: " << onlineSliceSecs << ", pauseMillis: " << onlinePauseMillis
+           << ")";
+    }
+
     return ss.str();
 }
 
@@ -144,24 +149,86 @@ std::string CompactOptions::toString() const {
 // CappedInsertNotifier
 //
 
+namespace {
+
+// Minimum interval between two wakeups of all the waiters on a capped insert notifier. Zero
+// wakes all waiters on every notification.
+MONGO_EXPORT_SERVER_PARAMETER(cappedInsertNotifierCoalesceMicros, int, 0);
+
+Microseconds coalesceInterval() {
+    return Microseconds(std::max(0, cappedInsertNotifierCoalesceMicros.load()));
+}
+
+}  // namespace
+
 CappedInsertNotifier::CappedInsertNotifier() : _version(0), _dead(false) {}
 
 void CappedInsertNotifier::notifyAll() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     ++_version;
+
+    const auto interval = coalesceInterval();
+    if (interval == Microseconds(0) ||
+        stdx::chrono::steady_clock::now() >= _lastBroadcast + interval.toSystemDuration()) {
+        _broadcast(lk);
+        return;
+    }
+
+    // A broadcast was made recently. Wake a single waiter to deliver one broadcast for this and
+    // any further inserts at the end of the interval, unless a waiter is already doing so.
+    if (!_broadcastScheduled) {
+        _broadcastPending = true;
+        _notifier.notify_one();
+    }
+}
+
+void CappedInsertNotifier::_broadcast(WithLock) const {
+    _lastBroadcast = stdx::chrono::steady_clock::now();
+    _broadcastPending = false;
     _notifier.notify_all();
 }
 
+void CappedInsertNotifier::_deliverPendingBroadcast(stdx::unique_lock<stdx::mutex>& lk) const {
+    if (!_broadcastPending) {
+        return;
+    }
+    _broadcastPending = false;
+    _broadcastScheduled = true;
+
+    const auto lastBroadcast = _lastBroadcast;
+    const auto deadline = lastBroadcast + coalesceInterval().toSystemDuration();
+    while (!_dead && _lastBroadcast == lastBroadcast &&
+           stdx::chrono::steady_clock::now() < deadline) {
+        _notifier.wait_until(lk, deadline);
+    }
+    _broadcastScheduled = false;
+
+    // Another caller may have broadcast while this thread was sleeping, in which case there is
+    // nothing left to deliver.
+    if (_lastBroadcast == lastBroadcast) {
+        _broadcast(lk);
+    }
+}
+
 void CappedInsertNotifier::_wait(stdx::unique_lock<stdx::mutex>& lk,
                                  uint64_t prevVersion,
                                  Microseconds timeout) const {
     while (!_dead && prevVersion == _version) {
+        if (_broadcastPending) {
+            // Nobody has taken charge of the pending group wakeup, so deliver it before sleeping.
+            _deliverPendingBroadcast(lk);
+            continue;
+        }
         if (timeout == Microseconds::max()) {
             _notifier.wait(lk);
         } else if (stdx::cv_status::timeout == _notifier.wait_for(lk, timeout.toSystemDuration())) {
-            return;
+            break;
         }
     }
+
+    // This waiter may have been woken, or have timed out, in place of the waiters a coalesced
+    // notification is owed to.
+    _deliverPendingBroadcast(lk);
 }
 
 void CappedInsertNotifier::wait(uint64_t prevVersion, Microseconds timeout) const {
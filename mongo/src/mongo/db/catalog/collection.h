@@ -53,9 +53,11 @@
 #include "mongo/db/storage/capped_callback.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/snapshot.h"
+#include "mongo/stdx/chrono.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
 
 namespace mongo {
 class CollectionCatalogEntry;
@@ -72,6 +74,7 @@ struct OplogUpdateEntryArgs;
 class RecordCursor;
 class RecordFetcher;
 class UpdateDriver;
+class UpdateIndexData;
 class UpdateRequest;
 
 struct CompactOptions {
@@ -85,6 +88,13 @@ struct CompactOptions {
     // other
     bool validateDocuments = true;
 
+    // Online compaction runs under intent locks and splits the storage engine's work into slices
+    // of at most onlineSliceSecs, sleeping onlinePauseMillis between them. Only storage engines
+    // that compact in place support it.
+    bool online = false;
+    int onlineSliceSecs = 1;
+    int onlinePauseMillis = 1000;
+
     std::string toString() const;
 
     unsigned computeRecordSize(unsigned recordSize) const {
@@ -101,13 +111,20 @@ struct CompactStats {
 /**
  * Queries with the awaitData option use this notifier object to wait for more data to be
  * inserted into the capped collection.
+ *
+ * When the 'cappedInsertNotifierCoalesceMicros' server parameter is positive, wakeups are
+ * coalesced: at most one broadcast to all waiters is made per interval. A notification which
+ * arrives within the interval of the previous broadcast only advances the version and wakes a
+ * single waiter, which then delivers one group wakeup for every insert made in the rest of the
+ * interval. This keeps a burst of inserts from waking thousands of tailing cursors per insert.
  */
 class CappedInsertNotifier {
 public:
     CappedInsertNotifier();
 
     /**
-     * Wakes up all threads waiting.
+     * Wakes up all threads waiting, possibly deferred to the end of the current coalescing
+     * interval.
      */
     void notifyAll();
 
@@ -152,6 +169,14 @@ private:
                uint64_t prevVersion,
                Microseconds timeout) const;
 
+    // Wakes all waiters and starts a new coalescing interval. Must be called with '_mutex' held.
+    void _broadcast(WithLock) const;
+
+    // Called by a waiter on its way out of _wait(). If a coalesced broadcast is pending and no
+    // other waiter has taken charge of it, waits for the end of the coalescing interval and then
+    // delivers the broadcast.
+    void _deliverPendingBroadcast(stdx::unique_lock<stdx::mutex>& lk) const;
+
     // Signalled when a successful insert is made into a capped collection.
     mutable stdx::condition_variable _notifier;
 
@@ -166,6 +191,17 @@ private:
 
     // True once the notifier is dead.
     bool _dead;
+
+    // The time of the last broadcast to all waiters. Protected by '_mutex'.
+    mutable stdx::chrono::steady_clock::time_point _lastBroadcast;
+
+    // True when the version has advanced since '_lastBroadcast' without waking all waiters, and
+    // no waiter has yet taken charge of delivering that wakeup. Protected by '_mutex'.
+    mutable bool _broadcastPending = false;
+
+    // True while a waiter is sleeping until the end of the coalescing interval in order to
+    // deliver a pending broadcast. Protected by '_mutex'.
+    mutable bool _broadcastScheduled = false;
 };
 
 /**
@@ -234,6 +270,9 @@ public:
         virtual std::vector<std::unique_ptr<RecordCursor>> getManyCursors(
             OperationContext* opCtx) const = 0;
 
+        virtual std::vector<std::unique_ptr<RecordCursor>> getPartitionedCursors(
+            OperationContext* opCtx, size_t numCursors) const = 0;
+
         virtual void deleteDocument(OperationContext* opCtx,
                                     StmtId stmtId,
                                     const RecordId& loc,
@@ -271,6 +310,7 @@ public:
                                         const BSONObj& newDoc,
                                         bool enforceQuota,
                                         bool indexesAffected,
+                                        const UpdateIndexData* modifiedIndexedPaths,
                                         OpDebug* opDebug,
                                         OplogUpdateEntryArgs* args) = 0;
 
@@ -459,6 +499,16 @@ public:
         return this->_impl().getManyCursors(opCtx);
     }
 
+    /**
+     * Returns at most 'numCursors' cursors that partition the Collection into disjoint sets of
+     * similar sizes, suitable for scanning the collection in parallel. Iterating all returned
+     * cursors is equivalent to iterating the full collection.
+     */
+    inline std::vector<std::unique_ptr<RecordCursor>> getPartitionedCursors(
+        OperationContext* const opCtx, const size_t numCursors) const {
+        return this->_impl().getPartitionedCursors(opCtx, numCursors);
+    }
+
     /**
      * Deletes the document with the given RecordId from the collection.
      *
@@ -542,6 +592,8 @@ public:
      * If the document fits in the old space, it is put there; if not, it is moved.
      * Sets 'args.updatedDoc' to the updated version of the document with damages applied, on
      * success.
+     * 'modifiedIndexedPaths' Optional argument. When not null and 'indexesAffected' is true, only
+     * the indexes over these paths have their keys regenerated.
      * 'opDebug' Optional argument. When not null, will be used to record operation statistics.
      * @return the post update location of the doc (may or may not be the same as oldLocation)
      */
@@ -551,10 +603,18 @@ public:
                                    const BSONObj& newDoc,
                                    const bool enforceQuota,
                                    const bool indexesAffected,
+                                   const UpdateIndexData* const modifiedIndexedPaths,
                                    OpDebug* const opDebug,
                                    OplogUpdateEntryArgs* const args) {
-        return this->_impl().updateDocument(
-            opCtx, oldLocation, oldDoc, newDoc, enforceQuota, indexesAffected, opDebug, args);
+        return this->_impl().updateDocument(opCtx,
+                                            oldLocation,
+                                            oldDoc,
+                                            newDoc,
+                                            enforceQuota,
+                                            indexesAffected,
+                                            modifiedIndexedPaths,
+                                            opDebug,
+                                            args);
     }
 
     inline bool updateWithDamagesSupported() const {
@@ -68,6 +68,18 @@ public:
 
     virtual BSONObj getIndexSpec(OperationContext* opCtx, StringData idxName) const = 0;
 
+    /**
+     * Appends the specs of all indexes, ready or not, to 'specs'. Storage engines that keep the
+     * index specs together should override this to read them all at once.
+     */
+    virtual void getAllIndexSpecs(OperationContext* opCtx, std::vector<BSONObj>* specs) const {
+        std::vector<std::string> names;
+        getAllIndexes(opCtx, &names);
+        for (auto&& name : names) {
+            specs->push_back(getIndexSpec(opCtx, name));
+        }
+    }
+
     /**
      * Returns true if the index identified by 'indexName' is multikey, and returns false otherwise.
      *
@@ -107,7 +107,8 @@ private:
 
 StatusWith<CompactStats> CollectionImpl::compact(OperationContext* opCtx,
                                                  const CompactOptions* compactOptions) {
-    dassert(opCtx->lockState()->isCollectionLockedForMode(ns().toString(), MODE_X));
+    dassert(opCtx->lockState()->isCollectionLockedForMode(
+        ns().toString(), compactOptions->online ? MODE_IX : MODE_X));
 
     DisableDocumentValidation validationDisabler(opCtx);
 
@@ -118,10 +119,20 @@ StatusWith<CompactStats> CollectionImpl::compact(OperationContext* opCtx,
                                             << _recordStore->name());
 
     if (_recordStore->compactsInPlace()) {
+        // Progress is reported per table: the collection first, then each of its indexes.
+        const char* curopMessage = compactOptions->online ? "Compact (online): tables compacted"
+                                                          : "Compact: tables compacted";
+        const auto numTables = 1 + _indexCatalog.numIndexesReady(opCtx);
+        stdx::unique_lock<Client> lk(*opCtx->getClient());
+        ProgressMeterHolder progress(
+            CurOp::get(opCtx)->setMessage_inlock(curopMessage, curopMessage, numTables));
+        lk.unlock();
+
         CompactStats stats;
         Status status = _recordStore->compact(opCtx, NULL, compactOptions, &stats);
         if (!status.isOK())
             return StatusWith<CompactStats>(status);
+        progress.hit();
 
         // Compact all indexes (not including unfinished indexes)
         IndexCatalog::IndexIterator ii(_indexCatalog.getIndexIterator(opCtx, false));
@@ -130,16 +141,24 @@ StatusWith<CompactStats> CollectionImpl::compact(OperationContext* opCtx,
             IndexAccessMethod* index = _indexCatalog.getIndex(descriptor);
 
             LOG(1) << "compacting index: " << descriptor->toString();
-            Status status = index->compact(opCtx);
+            Status status = index->compact(opCtx, compactOptions);
             if (!status.isOK()) {
                 error() << "failed to compact index: " << descriptor->toString();
                 return status;
             }
+            progress.hit();
         }
 
         return StatusWith<CompactStats>(stats);
     }
 
+    if (compactOptions->online) {
+        return StatusWith<CompactStats>(
+            ErrorCodes::CommandNotSupported,
+            str::stream() << "cannot compact collection online with record store: "
+                          << _recordStore->name());
+    }
+
     if (_indexCatalog.numIndexesInProgress(opCtx))
         return StatusWith<CompactStats>(ErrorCodes::BadValue,
                                         "cannot compact when indexes in progress");
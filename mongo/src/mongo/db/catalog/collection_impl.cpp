@@ -54,6 +54,7 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index_names.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/op_observer.h"
@@ -68,11 +69,14 @@
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/update/update_driver.h"
+#include "mongo/db/update_index_data.h"
 
 #include "mongo/db/auth/user_document_parser.h"  // XXX-ANDY
 #include "mongo/rpc/object_check.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -107,6 +111,10 @@ MONGO_INITIALIZER(InitializeParseValidationActionImpl)(InitializerContext* const
 // Used below to fail during inserts.
 MONGO_FP_DECLARE(failCollectionInserts);
 
+// The number of indexes a foreground validate checks at the same time. 1 checks them one by one
+// on the validating thread.
+MONGO_EXPORT_SERVER_PARAMETER(validateMaxParallelIndexes, int, 4);
+
 // Uses the collator factory to convert the BSON representation of a collator to a
 // CollatorInterface. Returns null if the BSONObj is empty. We expect the stored collation to be
 // valid, since it gets validated on collection create.
@@ -133,6 +141,25 @@ std::unique_ptr<CollatorInterface> parseCollation(OperationContext* opCtx,
 
     return std::move(collator.getValue());
 }
+
+// Returns false if none of the paths in 'modifiedIndexedPaths' can change the keys of the index
+// described by 'descriptor'. Text and partial indexes always return true, since their keys can
+// depend on paths other than those in the key pattern.
+bool indexMightBeAffected(const IndexDescriptor* descriptor,
+                          const IndexCatalogEntry* entry,
+                          const UpdateIndexData& modifiedIndexedPaths) {
+    if (descriptor->getAccessMethodName() == IndexNames::TEXT || entry->getFilterExpression()) {
+        return true;
+    }
+
+    BSONObjIterator it(descriptor->keyPattern());
+    while (it.more()) {
+        if (modifiedIndexedPaths.mightBeIndexed(it.next().fieldNameStringData())) {
+            return true;
+        }
+    }
+    return false;
+}
 }
 
 using std::unique_ptr;
@@ -230,6 +257,13 @@ vector<std::unique_ptr<RecordCursor>> CollectionImpl::getManyCursors(
     return _recordStore->getManyCursors(opCtx);
 }
 
+vector<std::unique_ptr<RecordCursor>> CollectionImpl::getPartitionedCursors(
+    OperationContext* opCtx, size_t numCursors) const {
+    dassert(opCtx->lockState()->isCollectionLockedForMode(ns().toString(), MODE_IS));
+
+    return _recordStore->getPartitionedCursors(opCtx, numCursors);
+}
+
 
 bool CollectionImpl::findDoc(OperationContext* opCtx,
                              const RecordId& loc,
@@ -322,7 +356,11 @@ Status CollectionImpl::insertDocumentsForOplog(OperationContext* opCtx,
     if (!status.isOK())
         return status;
 
-    opCtx->recoveryUnit()->onCommit([this]() { notifyCappedWaitersIfNeeded(); });
+    // When the storage engine publishes oplog visibility, one wakeup covers all of the concurrent
+    // writes it makes visible together, rather than one per committing writer.
+    if (!_recordStore->notifiesCappedWaitersOnVisibility()) {
+        opCtx->recoveryUnit()->onCommit([this]() { notifyCappedWaitersIfNeeded(); });
+    }
 
     return status;
 }
@@ -602,7 +640,8 @@ void CollectionImpl::deleteDocument(OperationContext* opCtx,
     Snapshotted<BSONObj> doc = docFor(opCtx, loc);
 
     auto deleteState =
-        getGlobalServiceContext()->getOpObserver()->aboutToDelete(opCtx, ns(), doc.value());
+        getGlobalServiceContext()->getOpObserver()->aboutToDelete(
+            opCtx, ns(), doc.value(), fromMigrate);
 
     boost::optional<BSONObj> deletedDoc;
     if (storeDeletedDoc == Collection::StoreDeletedDoc::On) {
@@ -633,23 +672,10 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
                                         const BSONObj& newDoc,
                                         bool enforceQuota,
                                         bool indexesAffected,
+                                        const UpdateIndexData* modifiedIndexedPaths,
                                         OpDebug* opDebug,
                                         OplogUpdateEntryArgs* args) {
-    {
-        auto status = checkValidation(opCtx, newDoc);
-        if (!status.isOK()) {
-            if (_validationLevel == ValidationLevel::STRICT_V) {
-                uassertStatusOK(status);
-            }
-            // moderate means we have to check the old doc
-            auto oldDocStatus = checkValidation(opCtx, oldDoc.value());
-            if (oldDocStatus.isOK()) {
-                // transitioning from good -> bad is not ok
-                uassertStatusOK(status);
-            }
-            // bad -> bad is ok in moderate mode
-        }
-    }
+    _validateUpdate(opCtx, oldDoc.value(), newDoc);
 
     dassert(opCtx->lockState()->isCollectionLockedForMode(ns().toString(), MODE_IX));
     invariant(oldDoc.snapshotId() == opCtx->recoveryUnit()->getSnapshotId());
@@ -684,9 +710,9 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
                                 << " != "
                                 << newDoc.objsize());
 
-    // At the end of this step, we will have a map of UpdateTickets, one per index, which
+    // At the end of this step, we will have a map of UpdateTickets, one per affected index, which
     // represent the index updates needed to be done, based on the changes between oldDoc and
-    // newDoc.
+    // newDoc. Indexes that none of the modified paths can touch are left out of the map.
     OwnedPointerMap<IndexDescriptor*, UpdateTicket> updateTickets;
     if (indexesAffected) {
         IndexCatalog::IndexIterator ii = _indexCatalog.getIndexIterator(opCtx, true);
@@ -695,6 +721,11 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
             IndexCatalogEntry* entry = ii.catalogEntry(descriptor);
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
+            if (modifiedIndexedPaths &&
+                !indexMightBeAffected(descriptor, entry, *modifiedIndexedPaths)) {
+                continue;
+            }
+
             InsertDeleteOptions options;
             IndexCatalog::prepareInsertDeleteOptions(opCtx, descriptor, &options);
             UpdateTicket* updateTicket = new UpdateTicket();
@@ -727,10 +758,20 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
             IndexDescriptor* descriptor = ii.next();
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
+            auto updateTicket = updateTickets.map().find(descriptor);
+            if (updateTicket == updateTickets.map().end()) {
+                continue;
+            }
+
             int64_t keysInserted;
             int64_t keysDeleted;
-            uassertStatusOK(iam->update(
-                opCtx, *updateTickets.mutableMap()[descriptor], &keysInserted, &keysDeleted));
+            Timer timer;
+            uassertStatusOK(
+                iam->update(opCtx, *updateTicket->second, &keysInserted, &keysDeleted));
+            _infoCache.notifyOfIndexWrite(descriptor->indexName(),
+                                          keysInserted,
+                                          keysDeleted,
+                                          Microseconds(timer.micros()));
             if (opDebug) {
                 opDebug->keysInserted += keysInserted;
                 opDebug->keysDeleted += keysDeleted;
@@ -809,10 +850,25 @@ Status CollectionImpl::recordStoreGoingToUpdateInPlace(OperationContext* opCtx,
 }
 
 
-bool CollectionImpl::updateWithDamagesSupported() const {
-    if (_validator)
-        return false;
+void CollectionImpl::_validateUpdate(OperationContext* opCtx,
+                                     const BSONObj& oldDoc,
+                                     const BSONObj& newDoc) const {
+    auto status = checkValidation(opCtx, newDoc);
+    if (!status.isOK()) {
+        if (_validationLevel == ValidationLevel::STRICT_V) {
+            uassertStatusOK(status);
+        }
+        // moderate means we have to check the old doc
+        auto oldDocStatus = checkValidation(opCtx, oldDoc);
+        if (oldDocStatus.isOK()) {
+            // transitioning from good -> bad is not ok
+            uassertStatusOK(status);
+        }
+        // bad -> bad is ok in moderate mode
+    }
+}
 
+bool CollectionImpl::updateWithDamagesSupported() const {
     return _recordStore->updateWithDamagesSupported();
 }
 
@@ -830,12 +886,23 @@ StatusWith<RecordData> CollectionImpl::updateDocumentWithDamages(
     // Broadcast the mutation so that query results stay correct.
     _cursorManager.invalidateDocument(opCtx, loc, INVALIDATION_MUTATION);
 
+    // Moderate validation compares against the old document, which some record stores (MMAPv1)
+    // overwrite in place when applying the damages, so it is copied first.
+    BSONObj oldDoc = oldRec.value().toBson();
+    if (_validator && _validationLevel == ValidationLevel::MODERATE) {
+        oldDoc = oldDoc.getOwned();
+    }
+
     auto newRecStatus =
         _recordStore->updateWithDamages(opCtx, loc, oldRec.value(), damageSource, damages);
 
     if (newRecStatus.isOK()) {
         args->updatedDoc = newRecStatus.getValue().toBson();
 
+        // The damages have already been written, but they are only visible to this unit of work,
+        // so a validation failure here rolls them back along with the rest of the update.
+        _validateUpdate(opCtx, oldDoc, args->updatedDoc);
+
         getGlobalServiceContext()->getOpObserver()->onUpdate(opCtx, *args);
     }
     return newRecStatus;
@@ -1140,51 +1207,132 @@ void _validateRecordStore(OperationContext* opCtx,
     }
 }
 
+// The per-index part of index validation, which only touches the index's own results and so can
+// run on any thread.
+struct IndexValidation {
+    const IndexDescriptor* descriptor;
+    IndexAccessMethod* iam;
+    ValidateResults* results;  // Entry in the ValidateResultsMap.
+    int64_t numTraversedKeys = 0;
+    std::string countMismatch;  // Set if the full validation and traversal counts disagree.
+};
+
+void _validateIndex(OperationContext* opCtx,
+                    RecordStoreValidateAdaptor* indexValidator,
+                    ValidateCmdLevel level,
+                    IndexValidation* validation) {
+    log(LogComponent::kIndex) << "validating index "
+                              << validation->descriptor->indexNamespace() << endl;
+    bool checkCounts = false;
+    int64_t numValidatedKeys;
+
+    if (level == kValidateFull) {
+        validation->iam->validate(opCtx, &numValidatedKeys, validation->results);
+        checkCounts = true;
+    }
+
+    if (validation->results->valid) {
+        indexValidator->traverseIndex(opCtx,
+                                      validation->iam,
+                                      validation->descriptor,
+                                      validation->results,
+                                      &validation->numTraversedKeys);
+
+        if (checkCounts && (numValidatedKeys != validation->numTraversedKeys)) {
+            validation->results->valid = false;
+            validation->countMismatch = str::stream()
+                << "number of traversed index entries (" << validation->numTraversedKeys
+                << ") does not match the number of expected index entries (" << numValidatedKeys
+                << ")";
+        }
+    }
+}
+
+// Validates the indexes on a thread pool, each with its own OperationContext and therefore its
+// own storage snapshot. Only used while the collection is locked exclusively, when every snapshot
+// sees the same data.
+void _validateIndexesInParallel(RecordStoreValidateAdaptor* indexValidator,
+                                ValidateCmdLevel level,
+                                std::vector<IndexValidation>* validations) {
+    ThreadPool::Options options;
+    options.poolName = "validate index pool";
+    options.threadNamePrefix = "validateIndex-";
+    options.minThreads = 0;
+    options.maxThreads = std::min(validations->size(),
+                                  static_cast<size_t>(validateMaxParallelIndexes.load()));
+    options.onCreateThread = [](const std::string& name) { Client::initThread(name); };
+    ThreadPool pool(options);
+    pool.startup();
+
+    std::vector<Status> statuses(validations->size(), Status::OK());
+    Status scheduleStatus = Status::OK();
+    for (size_t i = 0; i < validations->size() && scheduleStatus.isOK(); ++i) {
+        scheduleStatus = pool.schedule([indexValidator, level, validations, &statuses, i] {
+            try {
+                auto indexOpCtx = cc().makeOperationContext();
+                _validateIndex(indexOpCtx.get(), indexValidator, level, &(*validations)[i]);
+            } catch (const DBException& e) {
+                statuses[i] = e.toStatus();
+            }
+        });
+    }
+
+    // The tasks refer to this frame, so wait for them even if scheduling failed part way.
+    pool.waitForIdle();
+    pool.shutdown();
+    pool.join();
+
+    uassertStatusOK(scheduleStatus);
+    for (const auto& status : statuses) {
+        uassertStatusOK(status);
+    }
+}
+
 void _validateIndexes(OperationContext* opCtx,
                       IndexCatalog* indexCatalog,
                       BSONObjBuilder* keysPerIndex,
                       RecordStoreValidateAdaptor* indexValidator,
                       ValidateCmdLevel level,
+                      bool background,
                       ValidateResultsMap* indexNsResultsMap,
                       ValidateResults* results) {
 
+    std::vector<IndexValidation> validations;
     IndexCatalog::IndexIterator i = indexCatalog->getIndexIterator(opCtx, false);
+    while (i.more()) {
+        IndexValidation validation;
+        validation.descriptor = i.next();
+        validation.iam = indexCatalog->getIndex(validation.descriptor);
+        validation.results = &(*indexNsResultsMap)[validation.descriptor->indexNamespace()];
+        validations.push_back(std::move(validation));
+    }
+
+    // Background validation reads every index in the validating operation's snapshot, and
+    // storage engines without document-level locking need the collection lock on every thread
+    // that reads, so both check the indexes one at a time.
+    const bool parallel = !background && validations.size() > 1 &&
+        validateMaxParallelIndexes.load() > 1 &&
+        opCtx->getServiceContext()->getGlobalStorageEngine()->supportsDocLocking();
 
     // Validate Indexes.
-    while (i.more()) {
+    if (parallel) {
         opCtx->checkForInterrupt();
-        const IndexDescriptor* descriptor = i.next();
-        log(LogComponent::kIndex) << "validating index " << descriptor->indexNamespace() << endl;
-        IndexAccessMethod* iam = indexCatalog->getIndex(descriptor);
-        ValidateResults& curIndexResults = (*indexNsResultsMap)[descriptor->indexNamespace()];
-        bool checkCounts = false;
-        int64_t numTraversedKeys;
-        int64_t numValidatedKeys;
-
-        if (level == kValidateFull) {
-            iam->validate(opCtx, &numValidatedKeys, &curIndexResults);
-            checkCounts = true;
+        _validateIndexesInParallel(indexValidator, level, &validations);
+    } else {
+        for (auto& validation : validations) {
+            opCtx->checkForInterrupt();
+            _validateIndex(opCtx, indexValidator, level, &validation);
         }
+    }
 
-        if (curIndexResults.valid) {
-            indexValidator->traverseIndex(iam, descriptor, &curIndexResults, &numTraversedKeys);
-
-            if (checkCounts && (numValidatedKeys != numTraversedKeys)) {
-                curIndexResults.valid = false;
-                string msg = str::stream()
-                    << "number of traversed index entries (" << numTraversedKeys
-                    << ") does not match the number of expected index entries (" << numValidatedKeys
-                    << ")";
-                results->errors.push_back(msg);
-                results->valid = false;
-            }
+    for (const auto& validation : validations) {
+        if (!validation.countMismatch.empty()) {
+            results->errors.push_back(validation.countMismatch);
+        }
 
-            if (curIndexResults.valid) {
-                keysPerIndex->appendNumber(descriptor->indexNamespace(),
-                                           static_cast<long long>(numTraversedKeys));
-            } else {
-                results->valid = false;
-            }
+        if (validation.results->valid) {
+            keysPerIndex->appendNumber(validation.descriptor->indexNamespace(),
+                                       static_cast<long long>(validation.numTraversedKeys));
         } else {
             results->valid = false;
         }
@@ -1210,7 +1358,12 @@ void _validateIndexKeyCount(OperationContext* opCtx,
                             IndexCatalog* indexCatalog,
                             RecordStore* recordStore,
                             RecordStoreValidateAdaptor* indexValidator,
+                            bool background,
                             ValidateResultsMap* indexNsResultsMap) {
+    // Writes continue during background validation, so compare against the records in the
+    // snapshot rather than the record store's current count.
+    const int64_t numRecords =
+        background ? indexValidator->getNumRecordsTraversed() : recordStore->numRecords(opCtx);
 
     IndexCatalog::IndexIterator indexIterator = indexCatalog->getIndexIterator(opCtx, false);
     while (indexIterator.more()) {
@@ -1218,8 +1371,7 @@ void _validateIndexKeyCount(OperationContext* opCtx,
         ValidateResults& curIndexResults = (*indexNsResultsMap)[descriptor->indexNamespace()];
 
         if (curIndexResults.valid) {
-            indexValidator->validateIndexKeyCount(
-                descriptor, recordStore->numRecords(opCtx), curIndexResults);
+            indexValidator->validateIndexKeyCount(descriptor, numRecords, curIndexResults);
         }
     }
 }
@@ -1300,6 +1452,7 @@ Status CollectionImpl::validate(OperationContext* opCtx,
                              &keysPerIndex,
                              &indexValidator,
                              level,
+                             background,
                              &indexNsResultsMap,
                              results);
 
@@ -1310,8 +1463,12 @@ Status CollectionImpl::validate(OperationContext* opCtx,
 
         // Validate index key count.
         if (results->valid) {
-            _validateIndexKeyCount(
-                opCtx, &_indexCatalog, _recordStore, &indexValidator, &indexNsResultsMap);
+            _validateIndexKeyCount(opCtx,
+                                   &_indexCatalog,
+                                   _recordStore,
+                                   &indexValidator,
+                                   background,
+                                   &indexNsResultsMap);
         }
 
         // Report the validation results for the user to see
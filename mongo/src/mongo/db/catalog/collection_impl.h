@@ -136,6 +136,13 @@ public:
      */
     std::vector<std::unique_ptr<RecordCursor>> getManyCursors(OperationContext* opCtx) const final;
 
+    /**
+     * Returns at most 'numCursors' cursors that partition the Collection into disjoint sets of
+     * similar sizes. Iterating all returned cursors is equivalent to iterating the full collection.
+     */
+    std::vector<std::unique_ptr<RecordCursor>> getPartitionedCursors(
+        OperationContext* opCtx, size_t numCursors) const final;
+
     /**
      * Deletes the document with the given RecordId from the collection.
      *
@@ -221,6 +228,7 @@ public:
                             const BSONObj& newDoc,
                             bool enforceQuota,
                             bool indexesAffected,
+                            const UpdateIndexData* modifiedIndexedPaths,
                             OpDebug* opDebug,
                             OplogUpdateEntryArgs* args) final;
 
@@ -438,6 +446,14 @@ private:
 
     bool _enforceQuota(bool userEnforeQuota) const;
 
+    /**
+     * Throws if replacing 'oldDoc' with 'newDoc' is not permitted by the collection validator,
+     * taking the validation level into account.
+     */
+    void _validateUpdate(OperationContext* opCtx,
+                         const BSONObj& oldDoc,
+                         const BSONObj& newDoc) const;
+
     int _magic;
 
     const NamespaceString _ns;
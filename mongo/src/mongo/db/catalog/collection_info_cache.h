@@ -30,7 +30,9 @@
 
 #include "mongo/db/collection_index_usage_tracker.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/query/query_settings.h"
+#include "mongo/db/query/query_shape_stats.h"
 #include "mongo/db/update_index_data.h"
 #include "mongo/stdx/functional.h"
 
@@ -53,6 +55,8 @@ public:
 
         virtual QuerySettings* getQuerySettings() const = 0;
 
+        virtual QueryShapeStats* getQueryShapeStats() const = 0;
+
         virtual const UpdateIndexData& getIndexKeys(OperationContext* opCtx) const = 0;
 
         virtual CollectionIndexUsageMap getIndexUsageStats() const = 0;
@@ -66,7 +70,12 @@ public:
         virtual void clearQueryCache() = 0;
 
         virtual void notifyOfQuery(OperationContext* opCtx,
-                                   const std::set<std::string>& indexesUsed) = 0;
+                                   const PlanSummaryStats& summaryStats) = 0;
+
+        virtual void notifyOfIndexWrite(StringData indexName,
+                                        long long keysInserted,
+                                        long long keysDeleted,
+                                        Microseconds elapsed) = 0;
     };
 
 private:
@@ -103,6 +112,13 @@ public:
         return this->_impl().getQuerySettings();
     }
 
+    /**
+     * Get the per query shape execution statistics for this collection.
+     */
+    inline QueryShapeStats* getQueryShapeStats() const {
+        return this->_impl().getQueryShapeStats();
+    }
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -149,12 +165,22 @@ public:
     }
 
     /**
-     * Signal to the cache that a query operation has completed.  'indexesUsed' should list the
-     * set of indexes used by the winning plan, if any.
+     * Signal to the cache that a query operation has completed.  'summaryStats' should be the
+     * summary of the winning plan, whose 'indexesUsed' lists the indexes it used, if any.
+     */
+    inline void notifyOfQuery(OperationContext* const opCtx, const PlanSummaryStats& summaryStats) {
+        return this->_impl().notifyOfQuery(opCtx, summaryStats);
+    }
+
+    /**
+     * Signal to the cache that a write updated index 'indexName', inserting 'keysInserted' keys
+     * and removing 'keysDeleted' in 'elapsed'.
      */
-    inline void notifyOfQuery(OperationContext* const opCtx,
-                              const std::set<std::string>& indexesUsed) {
-        return this->_impl().notifyOfQuery(opCtx, indexesUsed);
+    inline void notifyOfIndexWrite(StringData indexName,
+                                   long long keysInserted,
+                                   long long keysDeleted,
+                                   Microseconds elapsed) {
+        return this->_impl().notifyOfIndexWrite(indexName, keysInserted, keysDeleted, elapsed);
     }
 
     std::unique_ptr<Impl> _pimpl;
@@ -65,6 +65,7 @@ CollectionInfoCacheImpl::CollectionInfoCacheImpl(Collection* collection, const N
       _keysComputed(false),
       _planCache(stdx::make_unique<PlanCache>(ns.ns())),
       _querySettings(stdx::make_unique<QuerySettings>()),
+      _queryShapeStats(stdx::make_unique<QueryShapeStats>()),
       _indexUsageTracker(getGlobalServiceContext()->getPreciseClockSource()) {}
 
 CollectionInfoCacheImpl::~CollectionInfoCacheImpl() {
@@ -152,17 +153,32 @@ void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
 }
 
 void CollectionInfoCacheImpl::notifyOfQuery(OperationContext* opCtx,
-                                            const std::set<std::string>& indexesUsed) {
+                                            const PlanSummaryStats& summaryStats) {
     // Record indexes used to fulfill query.
-    for (auto it = indexesUsed.begin(); it != indexesUsed.end(); ++it) {
+    for (auto it = summaryStats.indexesUsed.begin(); it != summaryStats.indexesUsed.end(); ++it) {
         // This index should still exist, since the PlanExecutor would have been killed if the
         // index was dropped (and we would not get here).
         dassert(NULL != _collection->getIndexCatalog()->findIndexByName(opCtx, *it));
 
         _indexUsageTracker.recordIndexAccess(*it);
+
+        auto scan = summaryStats.indexScans.find(*it);
+        if (scan != summaryStats.indexScans.end()) {
+            _indexUsageTracker.recordIndexRead(*it,
+                                               scan->second.keysExamined,
+                                               scan->second.seeks,
+                                               summaryStats.nReturned);
+        }
     }
 }
 
+void CollectionInfoCacheImpl::notifyOfIndexWrite(StringData indexName,
+                                                 long long keysInserted,
+                                                 long long keysDeleted,
+                                                 Microseconds elapsed) {
+    _indexUsageTracker.recordIndexWrite(indexName, keysInserted, keysDeleted, elapsed);
+}
+
 void CollectionInfoCacheImpl::clearQueryCache() {
     LOG(1) << _collection->ns().ns() << ": clearing plan cache - collection info cache reset";
     if (NULL != _planCache.get()) {
@@ -178,6 +194,10 @@ QuerySettings* CollectionInfoCacheImpl::getQuerySettings() const {
     return _querySettings.get();
 }
 
+QueryShapeStats* CollectionInfoCacheImpl::getQueryShapeStats() const {
+    return _queryShapeStats.get();
+}
+
 void CollectionInfoCacheImpl::updatePlanCacheIndexEntries(OperationContext* opCtx) {
     std::vector<IndexEntry> indexEntries;
 
@@ -33,6 +33,7 @@
 #include "mongo/db/collection_index_usage_tracker.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
+#include "mongo/db/query/query_shape_stats.h"
 #include "mongo/db/update_index_data.h"
 
 namespace mongo {
@@ -61,6 +62,11 @@ public:
      */
     QuerySettings* getQuerySettings() const;
 
+    /**
+     * Get the per query shape execution statistics for this collection.
+     */
+    QueryShapeStats* getQueryShapeStats() const;
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -102,10 +108,18 @@ public:
     void clearQueryCache();
 
     /**
-     * Signal to the cache that a query operation has completed.  'indexesUsed' should list the
-     * set of indexes used by the winning plan, if any.
+     * Signal to the cache that a query operation has completed.  'summaryStats' should be the
+     * summary of the winning plan, whose 'indexesUsed' lists the indexes it used, if any.
      */
-    void notifyOfQuery(OperationContext* opCtx, const std::set<std::string>& indexesUsed);
+    void notifyOfQuery(OperationContext* opCtx, const PlanSummaryStats& summaryStats);
+
+    /**
+     * Signal to the cache that a write updated index 'indexName'.
+     */
+    void notifyOfIndexWrite(StringData indexName,
+                            long long keysInserted,
+                            long long keysDeleted,
+                            Microseconds elapsed);
 
 private:
     void computeIndexKeys(OperationContext* opCtx);
@@ -131,6 +145,9 @@ private:
     // Includes index filters.
     std::unique_ptr<QuerySettings> _querySettings;
 
+    // Execution statistics per query shape, for index recommendations.
+    std::unique_ptr<QueryShapeStats> _queryShapeStats;
+
     // Tracks index usage statistics for this collection.
     CollectionIndexUsageTracker _indexUsageTracker;
 
@@ -128,6 +128,11 @@ public:
         std::abort();
     }
 
+    std::vector<std::unique_ptr<RecordCursor>> getPartitionedCursors(OperationContext* opCtx,
+                                                                     size_t numCursors) const {
+        std::abort();
+    }
+
     void deleteDocument(OperationContext* opCtx,
                         StmtId stmtId,
                         const RecordId& loc,
@@ -175,6 +180,7 @@ public:
                             const BSONObj& newDoc,
                             bool enforceQuota,
                             bool indexesAffected,
+                            const UpdateIndexData* modifiedIndexedPaths,
                             OpDebug* opDebug,
                             OplogUpdateEntryArgs* args) {
         std::abort();
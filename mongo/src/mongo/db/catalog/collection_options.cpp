@@ -241,6 +241,12 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
             }
 
             pipeline = e.Obj().getOwned();
+        } else if (fieldName == "materialized") {
+            if (e.type() != mongo::Bool) {
+                return Status(ErrorCodes::BadValue, "'materialized' has to be a boolean.");
+            }
+
+            materialized = e.Bool();
         } else if (!createdOn24OrEarlier && !Command::isGenericArgument(fieldName)) {
             return Status(ErrorCodes::InvalidOptions,
                           str::stream() << "The field '" << fieldName
@@ -253,6 +259,10 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
         return Status(ErrorCodes::BadValue, "'pipeline' cannot be specified without 'viewOn'");
     }
 
+    if (viewOn.empty() && materialized) {
+        return Status(ErrorCodes::BadValue, "'materialized' cannot be specified without 'viewOn'");
+    }
+
     return Status::OK();
 }
 
@@ -317,6 +327,10 @@ BSONObj CollectionOptions::toBSON() const {
         b.append("pipeline", pipeline);
     }
 
+    if (materialized) {
+        b.appendBool("materialized", true);
+    }
+
     return b.obj();
 }
 }
@@ -137,5 +137,8 @@ struct CollectionOptions {
     std::string viewOn;
     // The aggregation pipeline that defines this view.
     BSONObj pipeline;
+    // Whether the results of this view are stored in a backing collection and maintained as the
+    // collection it is defined on is written to.
+    bool materialized = false;
 };
 }
@@ -252,6 +252,19 @@ TEST(CollectionOptions, PipelineFieldRequiresViewOn) {
     ASSERT_NOT_OK(options.parse(fromjson("{pipeline: [{$match: {}}]}")));
 }
 
+TEST(CollectionOptions, MaterializedViewRoundTrips) {
+    CollectionOptions options;
+    ASSERT_OK(options.parse(fromjson("{viewOn: 'c', pipeline: [], materialized: true}")));
+    ASSERT_TRUE(options.materialized);
+    ASSERT_TRUE(options.toBSON()["materialized"].trueValue());
+    ASSERT_NOT_OK(options.parse(fromjson("{viewOn: 'c', materialized: 1}")));
+}
+
+TEST(CollectionOptions, MaterializedFieldRequiresViewOn) {
+    CollectionOptions options;
+    ASSERT_NOT_OK(options.parse(fromjson("{materialized: true}")));
+}
+
 TEST(CollectionOptions, UnknownTopLevelOptionFailsToParse) {
     CollectionOptions options;
     auto status = options.parse(fromjson("{invalidOption: 1}"));
@@ -44,6 +44,8 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/storage_engine.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 
@@ -94,28 +96,55 @@ StringData _todb(StringData ns) {
 
 }  // namespace
 
+DatabaseHolderImpl::~DatabaseHolderImpl() {
+    delete _dbs.load();
+}
 
 Database* DatabaseHolderImpl::get(OperationContext* opCtx, StringData ns) const {
     const StringData db = _todb(ns);
     invariant(opCtx->lockState()->isDbLockedForMode(db, MODE_IS));
 
-    stdx::lock_guard<SimpleMutex> lk(_m);
-    DBs::const_iterator it = _dbs.find(db);
-    if (it != _dbs.end()) {
+    // Keeps the map from being freed until this lookup is done, see _waitForReaders_inlock().
+    AtomicWord<int>& readers = _readersInEpoch[_readEpoch.load() & 1];
+    readers.fetchAndAdd(1);
+    ON_BLOCK_EXIT([&] { readers.fetchAndSubtract(1); });
+
+    const DBs* dbs = _dbs.load();
+    DBs::const_iterator it = dbs->find(db);
+    if (it != dbs->end()) {
         return it->second;
     }
 
     return NULL;
 }
 
+void DatabaseHolderImpl::_publish_inlock(std::unique_ptr<DBs> newDbs) {
+    std::unique_ptr<DBs> replaced(_dbs.swap(newDbs.release()));
+    _waitForReaders_inlock();
+}
+
+void DatabaseHolderImpl::_waitForReaders_inlock() const {
+    // A reader may have chosen its count just before the first flip, so both counts are drained.
+    for (int phase = 0; phase < 2; ++phase) {
+        const auto& readers = _readersInEpoch[_readEpoch.fetchAndAdd(1) & 1];
+        while (readers.load() != 0) {
+            stdx::this_thread::yield();
+        }
+    }
+}
+
 std::set<std::string> DatabaseHolderImpl::_getNamesWithConflictingCasing_inlock(StringData name) {
     std::set<std::string> duplicates;
 
-    for (const auto& nameAndPointer : _dbs) {
+    for (const auto& nameAndPointer : *_dbs.load()) {
         // A name that's equal with case-insensitive match must be identical, or it's a duplicate.
         if (name.equalCaseInsensitive(nameAndPointer.first) && name != nameAndPointer.first)
             duplicates.insert(nameAndPointer.first);
     }
+    for (const auto& beingOpened : _dbsBeingOpened) {
+        if (name.equalCaseInsensitive(beingOpened) && name != beingOpened)
+            duplicates.insert(beingOpened);
+    }
     return duplicates;
 }
 
@@ -133,16 +162,19 @@ Database* DatabaseHolderImpl::openDb(OperationContext* opCtx, StringData ns, boo
 
     stdx::unique_lock<SimpleMutex> lk(_m);
 
-    // The following will insert a nullptr for dbname, which will treated the same as a non-
-    // existant database by the get method, yet still counts in getNamesWithConflictingCasing.
-    if (auto db = _dbs[dbname])
-        return db;
+    const DBs& current = *_dbs.load();
+    auto existing = current.find(dbname);
+    if (existing != current.end() && existing->second)
+        return existing->second;
 
-    // We've inserted a nullptr entry for dbname: make sure to remove it on unsuccessful exit.
-    auto removeDbGuard = MakeGuard([this, &lk, dbname] {
+    // The name counts in getNamesWithConflictingCasing while the database is being opened, and
+    // only the finished Database is published to get().
+    const auto inserted = _dbsBeingOpened.insert(dbname.toString());
+    invariant(inserted.second);
+    auto removeDbGuard = MakeGuard([this, &lk, &inserted] {
         if (!lk.owns_lock())
             lk.lock();
-        _dbs.erase(dbname);
+        _dbsBeingOpened.erase(inserted.first);
     });
 
     // Check casing in lock to avoid transient duplicates.
@@ -172,15 +204,18 @@ Database* DatabaseHolderImpl::openDb(OperationContext* opCtx, StringData ns, boo
 
     auto newDb = stdx::make_unique<Database>(opCtx, dbname, entry);
 
-    // Finally replace our nullptr entry with the new Database pointer.
+    // Finally publish the new Database pointer.
     removeDbGuard.Dismiss();
     lk.lock();
-    auto it = _dbs.find(dbname);
-    invariant(it != _dbs.end() && it->second == nullptr);
-    it->second = newDb.release();
+    _dbsBeingOpened.erase(inserted.first);
+    auto withDb = stdx::make_unique<DBs>(*_dbs.load());
+    invariant(withDb->find(dbname) == withDb->end());
+    Database* db = newDb.release();
+    (*withDb)[dbname] = db;
+    _publish_inlock(std::move(withDb));
     invariant(_getNamesWithConflictingCasing_inlock(dbname.toString()).empty());
 
-    return it->second;
+    return db;
 }
 
 void DatabaseHolderImpl::close(OperationContext* opCtx, StringData ns, const std::string& reason) {
@@ -190,8 +225,9 @@ void DatabaseHolderImpl::close(OperationContext* opCtx, StringData ns, const std
 
     stdx::lock_guard<SimpleMutex> lk(_m);
 
-    DBs::const_iterator it = _dbs.find(dbName);
-    if (it == _dbs.end()) {
+    const DBs& current = *_dbs.load();
+    DBs::const_iterator it = current.find(dbName);
+    if (it == current.end()) {
         return;
     }
 
@@ -205,7 +241,9 @@ void DatabaseHolderImpl::close(OperationContext* opCtx, StringData ns, const std
     delete db;
     db = nullptr;
 
-    _dbs.erase(it);
+    auto withoutDb = stdx::make_unique<DBs>(current);
+    withoutDb->erase(dbName);
+    _publish_inlock(std::move(withoutDb));
 
     getGlobalServiceContext()
         ->getGlobalStorageEngine()
@@ -221,8 +259,9 @@ bool DatabaseHolderImpl::closeAll(OperationContext* opCtx,
 
     stdx::lock_guard<SimpleMutex> lk(_m);
 
+    auto remaining = stdx::make_unique<DBs>(*_dbs.load());
     set<string> dbs;
-    for (DBs::const_iterator i = _dbs.begin(); i != _dbs.end(); ++i) {
+    for (DBs::const_iterator i = remaining->begin(); i != remaining->end(); ++i) {
         dbs.insert(i->first);
     }
 
@@ -240,11 +279,11 @@ bool DatabaseHolderImpl::closeAll(OperationContext* opCtx,
             continue;
         }
 
-        Database* db = _dbs[name];
+        Database* db = (*remaining)[name];
         db->close(opCtx, reason);
         delete db;
 
-        _dbs.erase(name);
+        remaining->erase(name);
 
         getGlobalServiceContext()
             ->getGlobalStorageEngine()
@@ -254,6 +293,8 @@ bool DatabaseHolderImpl::closeAll(OperationContext* opCtx,
         bb.append(name);
     }
 
+    _publish_inlock(std::move(remaining));
+
     bb.done();
     if (nNotClosed) {
         result.append("nNotClosed", nNotClosed);
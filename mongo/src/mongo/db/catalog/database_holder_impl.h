@@ -30,11 +30,13 @@
 
 #include "mongo/db/catalog/database_holder.h"
 
+#include <memory>
 #include <set>
 #include <string>
 
 #include "mongo/base/string_data.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/string_map.h"
@@ -51,6 +53,8 @@ class DatabaseHolderImpl : public DatabaseHolder::Impl {
 public:
     DatabaseHolderImpl() = default;
 
+    ~DatabaseHolderImpl();
+
     /**
      * Retrieves an already opened database or returns NULL. Must be called with the database
      * locked in at least IS-mode.
@@ -89,11 +93,37 @@ public:
     std::set<std::string> getNamesWithConflictingCasing(StringData name) override;
 
 private:
+    typedef StringMap<Database*> DBs;
+
     std::set<std::string> _getNamesWithConflictingCasing_inlock(StringData name);
 
-    typedef StringMap<Database*> DBs;
+    /**
+     * Makes 'newDbs', a modified copy of the current map, the map seen by get(), and frees the
+     * map it replaces once no get() can still be reading it.
+     */
+    void _publish_inlock(std::unique_ptr<DBs> newDbs);
+
+    /**
+     * Waits until every get() that started before this call has returned. Each get() counts
+     * itself in one of two reader counts, chosen by the parity of _readEpoch. Flipping the epoch
+     * directs new readers to the other count, so draining both in turn only ever waits for the
+     * readers already running, which merely look up a name.
+     */
+    void _waitForReaders_inlock() const;
+
+    // Serializes changes to the map.
     mutable SimpleMutex _m;
-    DBs _dbs;
+
+    // The current map, which is never modified once published, so get() can read it without
+    // taking _m. Changes copy it and publish the copy.
+    AtomicWord<DBs*> _dbs{new DBs()};
+
+    // Names of the databases being opened, which are not in the map yet but count as taken when
+    // checking for conflicting casing. Guarded by _m.
+    std::set<std::string> _dbsBeingOpened;
+
+    mutable AtomicWord<unsigned> _readEpoch{0};
+    mutable AtomicWord<int> _readersInEpoch[2];
 };
 }  // namespace mongo
 
@@ -70,6 +70,7 @@
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/system_index.h"
+#include "mongo/db/views/materialized_view.h"
 #include "mongo/db/views/view_catalog.h"
 #include "mongo/platform/random.h"
 #include "mongo/stdx/memory.h"
@@ -437,8 +438,15 @@ void DatabaseImpl::getStats(OperationContext* opCtx, BSONObjBuilder* output, dou
 }
 
 Status DatabaseImpl::dropView(OperationContext* opCtx, StringData fullns) {
-    Status status = _views.dropView(opCtx, NamespaceString(fullns));
+    NamespaceString nss(fullns);
+    auto view = _views.lookup(opCtx, nss.ns());
+    Status status = _views.dropView(opCtx, nss);
     Top::get(opCtx->getServiceContext()).collectionDropped(fullns);
+
+    // The drop of the backing collection is replicated on its own.
+    if (status.isOK() && view && view->isMaterialized() && opCtx->writesAreReplicated()) {
+        status = dropCollectionEvenIfSystem(opCtx, view->backingNss(), {});
+    }
     return status;
 }
 
@@ -767,7 +775,18 @@ Status DatabaseImpl::createView(OperationContext* opCtx,
         return Status(ErrorCodes::InvalidNamespace,
                       str::stream() << "invalid namespace name for a view: " + nss.toString());
 
-    return _views.createView(opCtx, nss, viewOnNss, BSONArray(options.pipeline), options.collation);
+    Status status = _views.createView(opCtx,
+                                      nss,
+                                      viewOnNss,
+                                      BSONArray(options.pipeline),
+                                      options.collation,
+                                      options.materialized);
+
+    // The creation and initial contents of the backing collection are replicated on their own.
+    if (status.isOK() && options.materialized && opCtx->writesAreReplicated()) {
+        MaterializedView::create(opCtx, _this, *_views.lookup(opCtx, nss.ns()));
+    }
+    return status;
 }
 
 //insertBatchAndHandleErrors->makeCollection->mongo::userCreateNS->mongo::userCreateNSImpl->DatabaseImpl::createCollection
@@ -51,7 +51,9 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/service_context_d_test_fixture.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/scopeguard.h"
 
@@ -560,4 +562,55 @@ TEST_F(DatabaseTest, DBLockCanBePassedToAutoGetCollectionOrViewForReadCommand) {
     // The moved lock should go out of scope here, so the database should no longer be locked.
     ASSERT_FALSE(_opCtx.get()->lockState()->isDbLockedForMode(nss.db(), MODE_X));
 }
+
+TEST_F(DatabaseTest, OpenDatabasesCanBeLookedUpWhileOthersAreOpened) {
+    {
+        AutoGetOrCreateDb autoDb(_opCtx.get(), _nss.db(), MODE_X);
+        ASSERT_TRUE(autoDb.getDb());
+    }
+
+    // Readers look the database up without locking the holder, while its map is replaced by
+    // every database opened meanwhile.
+    AtomicWord<bool> done{false};
+    AtomicWord<long long> nLookups{0};
+    AtomicWord<long long> nMissed{0};
+    std::vector<stdx::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            Client::initThread("DatabaseHolderReader");
+            ON_BLOCK_EXIT([] { Client::destroy(); });
+            auto opCtx = cc().makeOperationContext();
+            while (!done.load()) {
+                AutoGetDb autoDb(opCtx.get(), _nss.db(), MODE_IS);
+                if (!autoDb.getDb()) {
+                    nMissed.fetchAndAdd(1);
+                }
+                nLookups.fetchAndAdd(1);
+            }
+        });
+    }
+
+    for (int i = 0; i < 50; ++i) {
+        const std::string name = str::stream() << "holderTest" << i;
+        AutoGetOrCreateDb autoDb(_opCtx.get(), name, MODE_X);
+        ASSERT_TRUE(autoDb.getDb());
+    }
+
+    done.store(true);
+    for (auto&& reader : readers) {
+        reader.join();
+    }
+    ASSERT_EQ(nMissed.load(), 0);
+    ASSERT_GT(nLookups.load(), 0);
+
+    // Every database opened is still found, and still reserves its name for any other casing.
+    for (int i = 0; i < 50; ++i) {
+        const std::string name = str::stream() << "holderTest" << i;
+        AutoGetDb autoDb(_opCtx.get(), name, MODE_IS);
+        ASSERT_TRUE(autoDb.getDb());
+    }
+    ASSERT_THROWS_CODE(AutoGetOrCreateDb(_opCtx.get(), "HOLDERTEST0", MODE_X),
+                       AssertionException,
+                       ErrorCodes::DatabaseDifferCase);
+}
 }  // namespace
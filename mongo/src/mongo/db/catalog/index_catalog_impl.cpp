@@ -36,6 +36,7 @@
 
 #include "mongo/base/init.h"
 #include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/bson/field_offset_index.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/audit.h"
 #include "mongo/db/background.h"
@@ -62,11 +63,14 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/represent_as.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -99,6 +103,10 @@ MONGO_INITIALIZER(InitializePrepareInsertDeleteOptionsImpl)(InitializerContext*
     return Status::OK();
 }
 
+// Documents with at least this many top-level fields get a field offset index while they are
+// inserted into the indexes of a collection with more than one index. 0 disables this.
+MONGO_EXPORT_SERVER_PARAMETER(indexRecordsFieldOffsetIndexMinFields, int, 64);
+
 }  // namespace
 
 using std::unique_ptr;
@@ -1380,6 +1388,34 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
 
+    if (bsonRecords.empty()) {
+        return Status::OK();
+    }
+
+    // Charge the time and keys spent maintaining this index to its usage statistics.
+    Timer timer;
+    int64_t totalInserted = 0;
+    ON_BLOCK_EXIT([&] {
+        _collection->infoCache()->notifyOfIndexWrite(
+            index->descriptor()->indexName(), totalInserted, 0, Microseconds(timer.micros()));
+    });
+
+    // Multi-document inserts are indexed as one sorted batch per index, rather than one btree
+    // descent per key in document order.
+    if (bsonRecords.size() > 1) {
+        int64_t inserted;
+        Status status =
+            index->accessMethod()->insertBatch(opCtx, bsonRecords, options, &inserted);
+        if (!status.isOK())
+            return status;
+
+        totalInserted += inserted;
+        if (keysInsertedOut) {
+            *keysInsertedOut += inserted;
+        }
+        return Status::OK();
+    }
+
     for (auto bsonRecord : bsonRecords) {
         int64_t inserted;
         invariant(bsonRecord.id != RecordId());
@@ -1389,6 +1425,7 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
         if (!status.isOK())
             return status;
 
+        totalInserted += inserted;
         if (keysInsertedOut) {
             *keysInsertedOut += inserted;
         }
@@ -1433,7 +1470,10 @@ Status IndexCatalogImpl::_unindexRecord(OperationContext* opCtx,
     options.dupsAllowed = options.dupsAllowed || !index->isReady(opCtx);
 
     int64_t removed;
+    Timer timer;
     Status status = index->accessMethod()->remove(opCtx, obj, loc, options, &removed);
+    _collection->infoCache()->notifyOfIndexWrite(
+        index->descriptor()->indexName(), 0, removed, Microseconds(timer.micros()));
 
     if (!status.isOK()) {
         log() << "Couldn't unindex record " << redact(obj) << " from collection "
@@ -1456,6 +1496,15 @@ Status IndexCatalogImpl::indexRecords(OperationContext* opCtx,
         *keysInsertedOut = 0;
     }
 
+    // Every index looks up its key fields in every document. For wide documents and several
+    // indexes, look each document's top-level fields up in a table rather than rescanning it.
+    ScopedFieldOffsetIndexes fieldOffsetIndexes(indexRecordsFieldOffsetIndexMinFields.load());
+    if (_entries.size() > 1) {
+        for (const auto& bsonRecord : bsonRecords) {
+            fieldOffsetIndexes.add(*bsonRecord.docPtr);
+        }
+    }
+
     for (IndexCatalogEntryContainer::const_iterator i = _entries.begin(); i != _entries.end();
          ++i) {
         Status s = _indexRecords(opCtx, i->get(), bsonRecords, keysInsertedOut);
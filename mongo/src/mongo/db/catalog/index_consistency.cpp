@@ -137,6 +137,31 @@ void IndexConsistency::removeIndexKey(const KeyString& ks, int indexNumber) {
     _removeIndexKey_inlock(ks, indexNumber);
 }
 
+uint32_t IndexConsistency::hashIndexKey(const KeyString& ks, int indexNumber) const {
+    // Entries are only added to `_indexesInfo` during construction and `indexNsHash` never
+    // changes afterwards, so reading it here without the mutex is safe.
+    return _hashKeyString(ks, indexNumber);
+}
+
+void IndexConsistency::addIndexKeyHashes(const std::vector<uint32_t>& hashes, int indexNumber) {
+
+    if (indexNumber < 0 || indexNumber >= static_cast<int>(_indexesInfo.size())) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(_classMutex);
+
+    // Ignore indexes that weren't ready before we started validation.
+    if (!_indexesInfo.at(indexNumber).isReady) {
+        return;
+    }
+
+    for (const uint32_t hash : hashes) {
+        _indexKeyCount[hash]--;
+    }
+    _indexesInfo.at(indexNumber).numKeys += hashes.size();
+}
+
 void IndexConsistency::addLongIndexKey(int indexNumber) {
 
     stdx::lock_guard<stdx::mutex> lock(_classMutex);
@@ -105,6 +105,18 @@ public:
      */
     void addLongIndexKey(int indexNumber);
 
+    /**
+     * Returns the hash that `addIndexKey` would count `ks` under. Does not take the class mutex,
+     * so concurrent index traversals can hash their entries independently and then count them
+     * with a single `addIndexKeyHashes` call per batch.
+     */
+    uint32_t hashIndexKey(const KeyString& ks, int indexNumber) const;
+
+    /**
+     * Equivalent to calling `addIndexKey` for each of the keys `hashes` were computed from.
+     */
+    void addIndexKeyHashes(const std::vector<uint32_t>& hashes, int indexNumber);
+
     /**
      * Returns the number of index entries for the given `indexNs`.
      */
@@ -82,6 +82,8 @@ public:
 
         virtual Status doneInserting(std::set<RecordId>* dupsOut = NULL) = 0;
 
+        virtual Status drainBackgroundWrites() = 0;
+
         virtual void commit() = 0;
 
         virtual void abortWithoutCleanup() = 0;
@@ -229,6 +231,20 @@ public:
         return this->_impl().doneInserting(dupsOut);
     }
 
+    /**
+     * Applies the writes that concurrent operations made to the collection while a hybrid
+     * background build was loading the indexes, after which writes go to the indexes directly
+     * again. Must be called after doneInserting() or insertAllDocumentsInCollection() return
+     * success and before commit(). Does nothing for other builds.
+     *
+     * Should not be called inside of a WriteUnitOfWork.
+     *
+     * Requires holding an exclusive database lock.
+     */
+    inline Status drainBackgroundWrites() {
+        return this->_impl().drainBackgroundWrites();
+    }
+
     /**
      * Marks the index ready for use. Should only be called as the last method after
      * doneInserting() or insertAllDocumentsInCollection() return success.
@@ -47,8 +47,13 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -56,6 +61,8 @@
 #include "mongo/util/progress_meter.h"
 #include "mongo/util/quick_exit.h"
 
+#include <deque>
+
 namespace mongo {
 
 namespace {
@@ -99,6 +106,151 @@ public:
 
 } exportedMaxIndexBuildMemoryUsageParameter;
 
+// Number of threads generating and sorting keys for foreground index builds. With 1 (or less) the
+// keys are generated on the thread scanning the collection.
+MONGO_EXPORT_SERVER_PARAMETER(indexBuildKeyGenerationThreads, int, 1);
+
+// Whether background builds bulk load their indexes while recording concurrent writes on the side
+// (a hybrid build), instead of inserting every key into the live index. Unique indexes are always
+// built the classic way, since a key that is transiently duplicated while the collection is being
+// scanned can't be told apart from a real duplicate without tracking it.
+MONGO_EXPORT_SERVER_PARAMETER(useHybridIndexBuilds, bool, true);
+
+// Hybrid builds drain the recorded writes under intent locks until at most this many documents
+// are left to apply under the exclusive lock, or they stop catching up.
+MONGO_EXPORT_SERVER_PARAMETER(maxIndexBuildSideWritesDrainedExclusively, int, 1000);
+const int kMaxIntentLockDrainPasses = 10;
+
+namespace {
+
+/**
+ * Generates index keys for a foreground index build on several threads. The collection scan stays
+ * on the building thread, which owns the locks and the storage snapshot, and hands batches of
+ * owned documents to the workers. Each worker feeds its own lane of BulkBuilders, so no sorter is
+ * shared between threads; the lanes are k-way merged when the bulk builds are committed.
+ *
+ * BulkBuilder::insert() only computes keys and adds them to its sorter, so it is safe to call
+ * from the workers while the building thread keeps scanning.
+ */
+class ParallelKeyGenerator {
+    MONGO_DISALLOW_COPYING(ParallelKeyGenerator);
+
+public:
+    using InsertFn = stdx::function<Status(size_t lane, const BSONObj& doc, const RecordId& loc)>;
+
+    ParallelKeyGenerator(size_t numLanes, InsertFn insert) : _insert(std::move(insert)) {
+        for (size_t lane = 0; lane < numLanes; ++lane) {
+            _workers.emplace_back([this, lane] { _run(lane); });
+        }
+    }
+
+    ~ParallelKeyGenerator() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _done = true;
+            _queue.clear();
+        }
+        _workAvailable.notify_all();
+        for (auto&& worker : _workers) {
+            worker.join();
+        }
+    }
+
+    /**
+     * Queues an owned document for key generation, blocking while the workers are behind. Returns
+     * the first error any worker hit, at which point the index build should be abandoned.
+     */
+    Status add(BSONObj doc, const RecordId& loc) {
+        invariant(doc.isOwned());
+        _pending.emplace_back(std::move(doc), loc);
+        if (_pending.size() < kBatchSize) {
+            return Status::OK();
+        }
+        return _flush();
+    }
+
+    /**
+     * Hands off any partial batch and waits for the workers to generate all remaining keys.
+     */
+    Status finish() {
+        _flush().transitional_ignore();  // Any error is returned below.
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _spaceAvailable.wait(lk, [&] { return !_status.isOK() || (_queue.empty() && !_busy); });
+        return _status;
+    }
+
+private:
+    using Batch = std::vector<std::pair<BSONObj, RecordId>>;
+
+    static constexpr size_t kBatchSize = 128;
+
+    Status _flush() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        if (!_pending.empty()) {
+            // Bound the documents held in memory to a couple of batches per worker.
+            _spaceAvailable.wait(
+                lk, [&] { return !_status.isOK() || _queue.size() < 2 * _workers.size(); });
+            _queue.push_back(std::move(_pending));
+            _pending = Batch();
+            _workAvailable.notify_one();
+        }
+        return _status;
+    }
+
+    void _run(size_t lane) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (true) {
+            _workAvailable.wait(lk, [&] { return _done || !_queue.empty(); });
+            if (_queue.empty()) {
+                return;
+            }
+
+            Batch batch = std::move(_queue.front());
+            _queue.pop_front();
+            ++_busy;
+            _spaceAvailable.notify_all();
+            lk.unlock();
+
+            Status status = Status::OK();
+            for (auto&& doc : batch) {
+                try {
+                    status = _insert(lane, doc.first, doc.second);
+                } catch (const DBException& ex) {
+                    status = ex.toStatus();
+                }
+                if (!status.isOK()) {
+                    break;
+                }
+            }
+
+            lk.lock();
+            --_busy;
+            if (!status.isOK() && _status.isOK()) {
+                _status = status;
+                _queue.clear();
+            }
+            _spaceAvailable.notify_all();
+        }
+    }
+
+    const InsertFn _insert;
+
+    // Only touched by the building thread.
+    Batch _pending;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _workAvailable;
+    stdx::condition_variable _spaceAvailable;
+    std::deque<Batch> _queue;
+    size_t _busy = 0;
+    bool _done = false;
+    Status _status = Status::OK();
+
+    std::vector<stdx::thread> _workers;
+};
+
+}  // namespace
+
 
 /**
  * On rollback sets MultiIndexBlockImpl::_needToCleanup to true.
@@ -140,6 +292,7 @@ MultiIndexBlockImpl::MultiIndexBlockImpl(OperationContext* opCtx, Collection* co
       _buildInBackground(false),
       _allowInterruption(false),
       _ignoreUnique(false),
+      _buildHybrid(false),
       _needToCleanup(true) {}
 
 MultiIndexBlockImpl::~MultiIndexBlockImpl() {
@@ -211,6 +364,7 @@ MultiIndexBlockImpl::init(const std::vector<BSONObj>& indexSpecs) {
     if (!status.isOK())
         return status;
 
+    bool anyUnique = false;
     for (size_t i = 0; i < indexSpecs.size(); i++) {
         BSONObj info = indexSpecs[i];
 
@@ -233,10 +387,19 @@ db.things.ensureIndex({name:1}, {background:true});
 		//Ƿ̨
         // Any foreground indexes make all indexes be built in the foreground.
         _buildInBackground = (_buildInBackground && info["background"].trueValue());
+        anyUnique = anyUnique || info["unique"].trueValue();
     }
 
+    // A hybrid build relies on a collection scan never returning a document twice, which only
+    // holds for storage engines that don't move documents on update.
+    _buildHybrid = _buildInBackground && !anyUnique && useHybridIndexBuilds.load() &&
+        _opCtx->getServiceContext()->getGlobalStorageEngine()->supportsDocLocking();
+
     std::vector<BSONObj> indexInfoObjs;
     indexInfoObjs.reserve(indexSpecs.size());
+    // Key generation lanes each get their own sorter per index, so they split the memory budget.
+    const std::size_t numLanes =
+        _buildInBackground ? 1 : std::max(1, indexBuildKeyGenerationThreads.load());
     std::size_t eachIndexBuildMaxMemoryUsageBytes = 0;
     if (!indexSpecs.empty()) {
         eachIndexBuildMaxMemoryUsageBytes =
@@ -265,10 +428,15 @@ db.things.ensureIndex({name:1}, {background:true});
         if (!status.isOK())
             return status;
 
-        if (!_buildInBackground) {
-            // Bulk build process requires foreground building as it assumes nothing is changing
-            // under it.
-            index.bulk = index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes);
+        if (!_buildInBackground || _buildHybrid) {
+            // Bulk build process assumes nothing is changing under it, so a hybrid build diverts
+            // the writes made to the index until the bulk load is done.
+            if (_buildHybrid)
+                index.real->beginIndexBuildInterception();
+            for (size_t lane = 0; lane < numLanes; ++lane) {
+                index.bulks.push_back(
+                    index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes / numLanes));
+            }
         }
 
         const IndexDescriptor* descriptor = index.block->getEntry()->descriptor();
@@ -281,9 +449,13 @@ db.things.ensureIndex({name:1}, {background:true});
 
 		//build index on: test.world properties: { v: 2, key: { geometry: "2dsphere" }, name: "geometry_2dsphere", ns: "test.world", 2dsphereIndexVersion: 3 }
         log() << "build index on: " << ns << " properties: " << descriptor->toString();
-        if (index.bulk)
+        if (!index.bulks.empty())
             log() << "\t building index using bulk method; build may temporarily use up to "
                   << eachIndexBuildMaxMemoryUsageBytes / 1024 / 1024 << " megabytes of RAM";
+        if (index.bulks.size() > 1)
+            log() << "\t generating keys on " << index.bulks.size() << " threads";
+        if (_buildHybrid)
+            log() << "\t recording concurrent writes to apply after the bulk load";
 
         index.filterExpression = index.block->getEntry()->getFilterExpression();
 
@@ -333,6 +505,16 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
     auto exec =
         InternalPlanner::collectionScan(_opCtx, _collection->ns().ns(), _collection, yieldPolicy);
 
+    // Foreground builds with several key generation lanes hand documents off to worker threads.
+    std::unique_ptr<ParallelKeyGenerator> keyGenerator;
+    if (!_indexes.empty() && _indexes.front().bulks.size() > 1) {
+        keyGenerator = stdx::make_unique<ParallelKeyGenerator>(
+            _indexes.front().bulks.size(),
+            [this](size_t lane, const BSONObj& doc, const RecordId& loc) {
+                return _insertIntoLane(lane, doc, loc);
+            });
+    }
+
     Snapshotted<BSONObj> objToIndex;
     RecordId loc;
     PlanExecutor::ExecState state;
@@ -364,7 +546,8 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
             progress->setTotalWhileRunning(_collection->numRecords(_opCtx));
 
             WriteUnitOfWork wunit(_opCtx);
-            Status ret = insert(objToIndex.value(), loc);
+            Status ret = keyGenerator ? keyGenerator->add(objToIndex.value().getOwned(), loc)
+                                      : insert(objToIndex.value(), loc);
             if (_buildInBackground)
                 exec->saveState();
             if (ret.isOK()) {
@@ -424,18 +607,45 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
         invariant(!"the hangAfterStartingIndexBuildUnlocked failpoint can't be turned off");
     }
 
+    if (keyGenerator) {
+        Status status = keyGenerator->finish();
+        if (!status.isOK())
+            return status;
+        keyGenerator.reset();
+    }
+
     progress->finished();
 
     Status ret = doneInserting(dupsOut);
     if (!ret.isOK())
         return ret;
 
+    // Catch up on the writes made while the indexes were loaded, so that few are left for the
+    // final drain under the exclusive lock. Each pass only has to apply the writes made during the
+    // previous one.
+    if (_buildHybrid) {
+        for (int pass = 0; pass < kMaxIntentLockDrainPasses &&
+             _numPendingSideWrites() >
+                 static_cast<size_t>(maxIndexBuildSideWritesDrainedExclusively.load());
+             ++pass) {
+            ret = _drainSideWrites();
+            if (!ret.isOK())
+                return ret;
+        }
+    }
+
     log() << "build index done.  scanned " << n << " total records. " << t.seconds() << " secs";
 
     return Status::OK();
 }
 
 Status MultiIndexBlockImpl::insert(const BSONObj& doc, const RecordId& loc) {
+    return _insertIntoLane(0, doc, loc);
+}
+
+Status MultiIndexBlockImpl::_insertIntoLane(size_t lane,
+                                            const BSONObj& doc,
+                                            const RecordId& loc) {
     for (size_t i = 0; i < _indexes.size(); i++) {
         if (_indexes[i].filterExpression && !_indexes[i].filterExpression->matchesBSON(doc)) {
             continue;
@@ -443,8 +653,9 @@ Status MultiIndexBlockImpl::insert(const BSONObj& doc, const RecordId& loc) {
 
         int64_t unused;
         Status idxStatus(ErrorCodes::InternalError, "");
-        if (_indexes[i].bulk) {
-            idxStatus = _indexes[i].bulk->insert(_opCtx, doc, loc, _indexes[i].options, &unused);
+        if (!_indexes[i].bulks.empty()) {
+            idxStatus =
+                _indexes[i].bulks[lane]->insert(_opCtx, doc, loc, _indexes[i].options, &unused);
         } else {
             idxStatus = _indexes[i].real->insert(_opCtx, doc, loc, _indexes[i].options, &unused);
         }
@@ -457,12 +668,12 @@ Status MultiIndexBlockImpl::insert(const BSONObj& doc, const RecordId& loc) {
 
 Status MultiIndexBlockImpl::doneInserting(std::set<RecordId>* dupsOut) {
     for (size_t i = 0; i < _indexes.size(); i++) {
-        if (_indexes[i].bulk == NULL)
+        if (_indexes[i].bulks.empty())
             continue;
         LOG(1) << "\t bulk commit starting for index: "
                << _indexes[i].block->getEntry()->descriptor()->indexName();
         Status status = _indexes[i].real->commitBulk(_opCtx,
-                                                     std::move(_indexes[i].bulk),
+                                                     std::move(_indexes[i].bulks),
                                                      _allowInterruption,
                                                      _indexes[i].options.dupsAllowed,
                                                      dupsOut);
@@ -474,12 +685,55 @@ Status MultiIndexBlockImpl::doneInserting(std::set<RecordId>* dupsOut) {
     return Status::OK();
 }
 
+Status MultiIndexBlockImpl::drainBackgroundWrites() {
+    if (!_buildHybrid)
+        return Status::OK();
+    invariant(_opCtx->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_X));
+
+    const size_t numPending = _numPendingSideWrites();
+    Status status = _drainSideWrites();
+    if (!status.isOK())
+        return status;
+
+    // Nothing else can write to the collection while the exclusive lock is held, so the indexes
+    // are now up to date and later writes can be applied to them directly.
+    for (auto&& index : _indexes) {
+        index.real->endIndexBuildInterception();
+    }
+    _buildHybrid = false;
+
+    log() << "index build: applied writes to " << numPending
+          << " documents under the exclusive lock";
+    return Status::OK();
+}
+
+Status MultiIndexBlockImpl::_drainSideWrites() {
+    for (auto&& index : _indexes) {
+        Status status = index.real->getIndexBuildInterceptor()->drainWritesIntoIndex(
+            _opCtx, _collection, index.real, index.options);
+        if (!status.isOK())
+            return status;
+    }
+    return Status::OK();
+}
+
+size_t MultiIndexBlockImpl::_numPendingSideWrites() const {
+    size_t numPending = 0;
+    for (auto&& index : _indexes) {
+        numPending += index.real->getIndexBuildInterceptor()->numPending();
+    }
+    return numPending;
+}
+
 void MultiIndexBlockImpl::abortWithoutCleanup() {
     _indexes.clear();
     _needToCleanup = false;
 }
 
 void MultiIndexBlockImpl::commit() {
+    // Hybrid builds must have applied all of the recorded writes first.
+    invariant(!_buildHybrid);
+
     for (size_t i = 0; i < _indexes.size(); i++) {
         _indexes[i].block->success();
     }
@@ -157,6 +157,18 @@ public:
      */
     Status doneInserting(std::set<RecordId>* dupsOut = nullptr) override;
 
+    /**
+     * Applies the writes that concurrent operations made to the collection while a hybrid
+     * background build was loading the indexes, after which writes go to the indexes directly
+     * again. Must be called after doneInserting() or insertAllDocumentsInCollection() return
+     * success and before commit(). Does nothing for other builds.
+     *
+     * Should not be called inside of a WriteUnitOfWork.
+     *
+     * Requires holding an exclusive database lock.
+     */
+    Status drainBackgroundWrites() override;
+
     /**
      * Marks the index ready for use. Should only be called as the last method after
      * doneInserting() or insertAllDocumentsInCollection() return success.
@@ -197,11 +209,26 @@ private:
 
         IndexAccessMethod* real = NULL;           // owned elsewhere
         const MatchExpression* filterExpression;  // might be NULL, owned elsewhere
-        std::unique_ptr<IndexAccessMethod::BulkBuilder> bulk;
+        // Empty for background builds that aren't hybrid. Holds one BulkBuilder per key
+        // generation thread; they are merged into the index by doneInserting().
+        std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>> bulks;
 
         InsertDeleteOptions options;
     };
 
+    /**
+     * Inserts 'doc' into every index using the BulkBuilders at position 'lane' of their 'bulks',
+     * or directly into the index for background builds (which only have lane 0).
+     */
+    Status _insertIntoLane(size_t lane, const BSONObj& doc, const RecordId& loc);
+
+    /**
+     * Applies the writes recorded by the IndexBuildInterceptors of a hybrid build so far.
+     */
+    Status _drainSideWrites();
+
+    size_t _numPendingSideWrites() const;
+
     std::vector<IndexToBuild> _indexes;
 
     std::unique_ptr<BackgroundOperation> _backgroundOperation;
@@ -214,6 +241,10 @@ private:
     bool _allowInterruption;
     bool _ignoreUnique;
 
+    // Background builds load the indexes with BulkBuilders and record concurrent writes in
+    // IndexBuildInterceptors, rather than inserting every key into the live indexes.
+    bool _buildHybrid;
+
     bool _needToCleanup;
 };
 
@@ -37,7 +37,9 @@
 
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
+#include "mongo/db/commands/feature_compatibility_version_command_parser.h"
 #include "mongo/db/field_ref.h"
+#include "mongo/db/hasher.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index_names.h"
 #include "mongo/db/jsobj.h"
@@ -76,6 +78,7 @@ static const std::set<StringData> allowedFieldNames = {
     IndexDescriptor::kDropDuplicatesFieldName,
     IndexDescriptor::kExpireAfterSecondsFieldName,
     IndexDescriptor::kGeoHaystackBucketSize,
+    IndexDescriptor::kHashVersionFieldName,
     IndexDescriptor::kIndexNameFieldName,
     IndexDescriptor::kIndexVersionFieldName,
     IndexDescriptor::kKeyPatternFieldName,
@@ -335,6 +338,42 @@ StatusWith<BSONObj> validateIndexSpec(
             }
 
             hasCollationField = true;
+        } else if (IndexDescriptor::kHashVersionFieldName == indexSpecElemFieldName) {
+            if (!indexSpecElem.isNumber()) {
+                return {ErrorCodes::TypeMismatch,
+                        str::stream() << "The field '" << IndexDescriptor::kHashVersionFieldName
+                                      << "' must be a number, but got "
+                                      << typeName(indexSpecElem.type())};
+            }
+
+            auto hashVersion = representAs<int>(indexSpecElem.number());
+            if (!hashVersion || !BSONElementHasher::isValidHashVersion(*hashVersion)) {
+                return {ErrorCodes::CannotCreateIndex,
+                        str::stream() << "Invalid hash version "
+                                      << indexSpecElem.toString(false, false)
+                                      << "; the supported hash versions are "
+                                      << BSONElementHasher::DEFAULT_HASH_VERSION
+                                      << " (MD5) and "
+                                      << BSONElementHasher::MURMUR3_HASH_VERSION
+                                      << " (MurmurHash3)"};
+            }
+
+            // 3.6 binaries without MurmurHash3 support fail to build the index keys for a
+            // hashVersion 1 index, so we only allow creating one once every node in the cluster
+            // is guaranteed to have been fully upgraded.
+            if (*hashVersion == BSONElementHasher::MURMUR3_HASH_VERSION &&
+                featureCompatibility.getVersion() !=
+                    ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo36) {
+                return {ErrorCodes::CannotCreateIndex,
+                        str::stream() << "The featureCompatibilityVersion must be 3.6 to create "
+                                         "a hashed index with "
+                                      << IndexDescriptor::kHashVersionFieldName
+                                      << " "
+                                      << BSONElementHasher::MURMUR3_HASH_VERSION
+                                      << ". See "
+                                      << feature_compatibility_version::kDochubLink
+                                      << "."};
+            }
         } else if (IndexDescriptor::kPartialFilterExprFieldName == indexSpecElemFieldName) {
             if (indexSpecElem.type() != BSONType::Object) {
                 return {ErrorCodes::TypeMismatch,
@@ -866,6 +866,91 @@ TEST(IndexSpecCollationValidateTest, FillsInCollationFieldWithCollectionDefaultI
                       sorted(result.getValue()));
 }
 
+TEST(IndexSpecValidateTest, AcceptsSupportedHashVersions) {
+    ServerGlobalParams::FeatureCompatibility featureCompatibility;
+    featureCompatibility.setVersion(
+        ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo36);
+
+    for (int hashVersion : {0, 1}) {
+        ASSERT_OK(validateIndexSpec(kDefaultOpCtx,
+                                    BSON("key" << BSON("field"
+                                                       << "hashed")
+                                               << "name"
+                                               << "indexName"
+                                               << "hashVersion"
+                                               << hashVersion),
+                                    kTestNamespace,
+                                    featureCompatibility));
+    }
+}
+
+TEST(IndexSpecValidateTest, ReturnsAnErrorIfMurmur3HashVersionIsRequestedBeforeUpgradeTo36) {
+    ServerGlobalParams::FeatureCompatibility featureCompatibility;
+    for (auto version : {ServerGlobalParams::FeatureCompatibility::Version::kFullyDowngradedTo34,
+                         ServerGlobalParams::FeatureCompatibility::Version::kUpgradingTo36,
+                         ServerGlobalParams::FeatureCompatibility::Version::kDowngradingTo34}) {
+        featureCompatibility.setVersion(version);
+
+        ASSERT_EQ(ErrorCodes::CannotCreateIndex,
+                  validateIndexSpec(kDefaultOpCtx,
+                                    BSON("key" << BSON("field"
+                                                       << "hashed")
+                                               << "name"
+                                               << "indexName"
+                                               << "hashVersion"
+                                               << 1),
+                                    kTestNamespace,
+                                    featureCompatibility));
+
+        // The default hash version is still allowed.
+        ASSERT_OK(validateIndexSpec(kDefaultOpCtx,
+                                    BSON("key" << BSON("field"
+                                                       << "hashed")
+                                               << "name"
+                                               << "indexName"
+                                               << "hashVersion"
+                                               << 0),
+                                    kTestNamespace,
+                                    featureCompatibility));
+    }
+}
+
+TEST(IndexSpecValidateTest, ReturnsAnErrorIfHashVersionIsNotANumber) {
+    ServerGlobalParams::FeatureCompatibility featureCompatibility;
+    featureCompatibility.setVersion(
+        ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo36);
+
+    ASSERT_EQ(ErrorCodes::TypeMismatch,
+              validateIndexSpec(kDefaultOpCtx,
+                                BSON("key" << BSON("field"
+                                                   << "hashed")
+                                           << "name"
+                                           << "indexName"
+                                           << "hashVersion"
+                                           << "murmur3"),
+                                kTestNamespace,
+                                featureCompatibility));
+}
+
+TEST(IndexSpecValidateTest, ReturnsAnErrorIfHashVersionIsUnsupported) {
+    ServerGlobalParams::FeatureCompatibility featureCompatibility;
+    featureCompatibility.setVersion(
+        ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo36);
+
+    for (auto hashVersion : {-1.0, 0.5, 2.0}) {
+        ASSERT_EQ(ErrorCodes::CannotCreateIndex,
+                  validateIndexSpec(kDefaultOpCtx,
+                                    BSON("key" << BSON("field"
+                                                       << "hashed")
+                                               << "name"
+                                               << "indexName"
+                                               << "hashVersion"
+                                               << hashVersion),
+                                    kTestNamespace,
+                                    featureCompatibility));
+    }
+}
+
 TEST(IndexSpecPartialFilterTest, FailsIfPartialFilterIsNotAnObject) {
     ServerGlobalParams::FeatureCompatibility featureCompatibility;
     featureCompatibility.setVersion(
@@ -117,7 +117,8 @@ Status RecordStoreValidateAdaptor::validate(const RecordId& recordId,
     return status;
 }
 
-void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
+void RecordStoreValidateAdaptor::traverseIndex(OperationContext* opCtx,
+                                               const IndexAccessMethod* iam,
                                                const IndexDescriptor* descriptor,
                                                ValidateResults* results,
                                                int64_t* numTraversedKeys) {
@@ -131,7 +132,13 @@ void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
     std::unique_ptr<KeyString> prevIndexKeyString = nullptr;
     bool isFirstEntry = true;
 
-    std::unique_ptr<SortedDataInterface::Cursor> cursor = iam->newCursor(_opCtx, true);
+    // Hash entries outside of IndexConsistency's mutex and count them in batches, so that
+    // indexes traversed concurrently do not contend on it for every key.
+    const size_t kHashBatchSize = 1024;
+    std::vector<uint32_t> hashes;
+    hashes.reserve(kHashBatchSize);
+
+    std::unique_ptr<SortedDataInterface::Cursor> cursor = iam->newCursor(opCtx, true);
     // Seeking to BSONObj() is equivalent to seeking to the first entry of an index.
     for (auto indexEntry = cursor->seek(BSONObj(), true); indexEntry; indexEntry = cursor->next()) {
 
@@ -148,12 +155,17 @@ void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
             results->valid = false;
         }
 
-        _indexConsistency->addIndexKey(*indexKeyString, indexNumber);
+        hashes.push_back(_indexConsistency->hashIndexKey(*indexKeyString, indexNumber));
+        if (hashes.size() == kHashBatchSize) {
+            _indexConsistency->addIndexKeyHashes(hashes, indexNumber);
+            hashes.clear();
+        }
 
         numKeys++;
         isFirstEntry = false;
         prevIndexKeyString.swap(indexKeyString);
     }
+    _indexConsistency->addIndexKeyHashes(hashes, indexNumber);
 
     *numTraversedKeys = numKeys;
 }
@@ -164,7 +176,6 @@ void RecordStoreValidateAdaptor::traverseRecordStore(RecordStore* recordStore,
                                                      BSONObjBuilder* output) {
 
     long long nrecords = 0;
-    long long dataSizeTotal = 0;
     long long nInvalid = 0;
 
     results->valid = true;
@@ -180,7 +191,6 @@ void RecordStoreValidateAdaptor::traverseRecordStore(RecordStore* recordStore,
         }
 
         auto dataSize = record->data.size();
-        dataSizeTotal += dataSize;
         size_t validatedSize;
         Status status = validate(record->id, record->data, &validatedSize);
 
@@ -204,9 +214,7 @@ void RecordStoreValidateAdaptor::traverseRecordStore(RecordStore* recordStore,
         prevRecordId = record->id;
     }
 
-    if (results->valid) {
-        recordStore->updateStatsAfterRepair(_opCtx, nrecords, dataSizeTotal);
-    }
+    _numRecordsTraversed = nrecords;
 
     output->append("nInvalidDocuments", nInvalid);
     output->appendNumber("nrecords", nrecords);
@@ -72,14 +72,17 @@ public:
      * Traverses the index getting index entriess to validate them and keep track of the index keys
      * for index consistency.
      */
-    void traverseIndex(const IndexAccessMethod* iam,
+    void traverseIndex(OperationContext* opCtx,
+                       const IndexAccessMethod* iam,
                        const IndexDescriptor* descriptor,
                        ValidateResults* results,
                        int64_t* numTraversedKeys);
 
     /**
      * Traverses the record store to retrieve every record and go through its document key
-     * set to keep track of the index consistency during a validation.
+     * set to keep track of the index consistency during a validation. Used by background
+     * validation, which reads a single snapshot while writes continue, so the record store's
+     * size and count are left alone.
      */
     void traverseRecordStore(RecordStore* recordStore,
                              ValidateCmdLevel level,
@@ -91,11 +94,19 @@ public:
      */
     void validateIndexKeyCount(IndexDescriptor* idx, int64_t numRecs, ValidateResults& results);
 
+    /**
+     * Returns the number of records seen by traverseRecordStore().
+     */
+    long long getNumRecordsTraversed() const {
+        return _numRecordsTraversed;
+    }
+
 private:
     OperationContext* _opCtx;             // Not owned.
     IndexConsistency* _indexConsistency;  // Not owned.
     ValidateCmdLevel _level;
     IndexCatalog* _indexCatalog;             // Not owned.
     ValidateResultsMap* _indexNsResultsMap;  // Not owned.
+    long long _numRecordsTraversed = 0;
 };
 }  // namespace
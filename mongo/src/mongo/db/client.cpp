@@ -42,11 +42,13 @@
 
 #include "mongo/base/status.h"
 #include "mongo/db/lasterror.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -143,11 +145,13 @@ void Client::setOperationContext(OperationContext* opCtx) {
     // We can only set the OperationContext once before resetting it.
     invariant(opCtx != NULL && _opCtx == NULL);
     _opCtx = opCtx;
+    _publishedOpState.publishOperation(opCtx->getOpID(), curTimeMicros64());
 }
 
 void Client::resetOperationContext() {
     invariant(_opCtx != NULL);
     _opCtx = NULL;
+    _publishedOpState.publishIdle();
 }
 
 std::string Client::clientAddress(bool includePort) const {
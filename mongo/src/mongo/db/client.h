@@ -41,6 +41,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/client.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/published_op_state.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/random.h"
 #include "mongo/platform/unordered_set.h"
@@ -214,6 +215,17 @@ public:
     ConnectionId getConnectionId() const {
         return _connectionId;
     }
+
+    /**
+     * Returns the summary of the current operation of this client, which may be read without
+     * holding the client lock.
+     */
+    PublishedOpState& getPublishedOpState() {
+        return _publishedOpState;
+    }
+    const PublishedOpState& getPublishedOpState() const {
+        return _publishedOpState;
+    }
     bool isFromUserConnection() const {
         return _connectionId > 0;
     }
@@ -243,6 +255,8 @@ private:
     // Protects the contents of the Client (such as changing the OperationContext, etc)
     SpinLock _lock;
 
+    PublishedOpState _publishedOpState;
+
     // Whether this client is running as DBDirectClient
     //ͻǷֱmongodʵ,mongosΪmongodĿͻҪ֤
     bool _inDirectClient = false;
@@ -49,6 +49,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/exit.h"
@@ -62,6 +63,7 @@ static Counter64 cursorStatsOpen;           // gauge
 static Counter64 cursorStatsOpenPinned;     // gauge
 static Counter64 cursorStatsOpenNoTimeout;  // gauge
 static Counter64 cursorStatsTimedOut;
+static AtomicInt64 cursorPrefetchedBytes;
 
 static ServerStatusMetricField<Counter64> dCursorStatsOpen("cursor.open.total", &cursorStatsOpen);
 static ServerStatusMetricField<Counter64> dCursorStatsOpenPinned("cursor.open.pinned",
@@ -75,6 +77,10 @@ long long ClientCursor::totalOpen() {
     return cursorStatsOpen.get();
 }
 
+long long ClientCursor::getTotalPrefetchedBytes() {
+    return cursorPrefetchedBytes.load();
+}
+
 ClientCursor::ClientCursor(ClientCursorParams params,
                            CursorManager* cursorManager,
                            CursorId cursorId,
@@ -111,6 +117,19 @@ ClientCursor::~ClientCursor() {
     if (isNoTimeout()) {
         cursorStatsOpenNoTimeout.decrement();
     }
+
+    releasePrefetchedBytes();
+}
+
+void ClientCursor::setPrefetchedBytes(size_t bytes) {
+    releasePrefetchedBytes();
+    _prefetchedBytes = bytes;
+    cursorPrefetchedBytes.addAndFetch(bytes);
+}
+
+void ClientCursor::releasePrefetchedBytes() {
+    cursorPrefetchedBytes.subtractAndFetch(_prefetchedBytes);
+    _prefetchedBytes = 0;
 }
 
 void ClientCursor::markAsKilled(const std::string& reason) {
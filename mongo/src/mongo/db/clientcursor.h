@@ -183,6 +183,34 @@ public:
         _pos = n;
     }
 
+    /**
+     * Returns the size in bytes of the last batch a getMore returned from this cursor, or zero if
+     * there has been no getMore yet. Used to size the reply buffer of the next getMore.
+     */
+    size_t getLastBatchBytes() const {
+        return _lastBatchBytes;
+    }
+
+    /**
+     * Returns the number of results in the last batch a getMore returned from this cursor.
+     */
+    long long getLastBatchNumResults() const {
+        return _lastBatchNumResults;
+    }
+
+    void setLastBatch(long long numResults, size_t bytes) {
+        _lastBatchNumResults = numResults;
+        _lastBatchBytes = bytes;
+    }
+
+    /**
+     * Records that a background prefetch stashed 'bytes' of results in this cursor's executor.
+     * They count towards getTotalPrefetchedBytes() until the next getMore claims them by calling
+     * releasePrefetchedBytes(), or the cursor is destroyed.
+     */
+    void setPrefetchedBytes(size_t bytes);
+    void releasePrefetchedBytes();
+
     //
     // Timing.
     //
@@ -230,6 +258,11 @@ public:
      */
     static long long totalOpen();
 
+    /**
+     * Returns the server-wide size of the results prefetched for cursors and not yet claimed.
+     */
+    static long long getTotalPrefetchedBytes();
+
     friend std::size_t partitionOf(const ClientCursor* cursor) {
         return cursor->cursorid();
     }
@@ -306,6 +339,13 @@ private:
     // Tracks the number of results returned by this cursor so far.
     long long _pos = 0;
 
+    // The size of the last batch returned by a getMore on this cursor.
+    long long _lastBatchNumResults = 0;
+    size_t _lastBatchBytes = 0;
+
+    // The size of the results a background prefetch stashed in '_exec' for the next getMore.
+    size_t _prefetchedBytes = 0;
+
     // Holds an owned copy of the command specification received from the client.
     const BSONObj _originatingCommand;
 
@@ -343,6 +383,11 @@ private:
     bool _isPinned = true;
 
     Date_t _lastUseDate;
+
+    // Links in the CursorManager's idle list for this cursor's partition. Only meaningful while
+    // the cursor is unpinned and eligible to time out.
+    ClientCursor* _idlePrev = nullptr;
+    ClientCursor* _idleNext = nullptr;
 };
 
 /**
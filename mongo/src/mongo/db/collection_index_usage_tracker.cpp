@@ -49,6 +49,39 @@ void CollectionIndexUsageTracker::recordIndexAccess(StringData indexName) {
     _indexUsageMap[indexName].accesses.fetchAndAdd(1);
 }
 
+void CollectionIndexUsageTracker::recordIndexRead(StringData indexName,
+                                                  long long keysExamined,
+                                                  long long seeks,
+                                                  long long docsReturned) {
+    invariant(!indexName.empty());
+    dassert(_indexUsageMap.find(indexName) != _indexUsageMap.end());
+
+    auto& stats = _indexUsageMap[indexName];
+    stats.keysExamined.fetchAndAdd(keysExamined);
+    stats.seeks.fetchAndAdd(seeks);
+    stats.docsReturned.fetchAndAdd(docsReturned);
+}
+
+void CollectionIndexUsageTracker::recordIndexWrite(StringData indexName,
+                                                   long long keysInserted,
+                                                   long long keysDeleted,
+                                                   Microseconds elapsed) {
+    invariant(!indexName.empty());
+
+    // Unlike reads, writes also reach indexes that are still being built, which are only
+    // registered once they are ready.
+    auto it = _indexUsageMap.find(indexName);
+    if (it == _indexUsageMap.end()) {
+        return;
+    }
+
+    auto& stats = it->second;
+    stats.writeOps.fetchAndAdd(1);
+    stats.keysInserted.fetchAndAdd(keysInserted);
+    stats.keysDeleted.fetchAndAdd(keysDeleted);
+    stats.writeMicros.fetchAndAdd(durationCount<Microseconds>(elapsed));
+}
+
 void CollectionIndexUsageTracker::registerIndex(StringData indexName, const BSONObj& indexKey) {
     invariant(!indexName.empty());
     dassert(_indexUsageMap.find(indexName) == _indexUsageMap.end());
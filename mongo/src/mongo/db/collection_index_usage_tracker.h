@@ -28,10 +28,13 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/util/duration.h"
 #include "mongo/util/string_map.h"
 #include "mongo/util/time_support.h"
 
@@ -44,6 +47,11 @@ class ClockSource;
  * considered "used" when it appears as part of a winning plan for an operation that uses the
  * query system.
  *
+ * Alongside the access count, the tracker accumulates what those reads cost (keys examined and
+ * seeks, against documents returned) and what maintaining the index costs writers (keys inserted
+ * and removed, and the time spent doing so), so that indexes which slow down writes without
+ * serving reads can be told apart from those that earn their keep.
+ *
  * Indexes must be registered and deregistered on creation/destruction.
  */
 class CollectionIndexUsageTracker {
@@ -55,26 +63,53 @@ public:
         explicit IndexUsageStats(Date_t now, const BSONObj& key)
             : trackerStartTime(now), indexKey(key.getOwned()) {}
 
-        IndexUsageStats(const IndexUsageStats& other)
-            : accesses(other.accesses.load()),
-              trackerStartTime(other.trackerStartTime),
-              indexKey(other.indexKey) {}
+        IndexUsageStats(const IndexUsageStats& other) {
+            *this = other;
+        }
 
         IndexUsageStats& operator=(const IndexUsageStats& other) {
             accesses.store(other.accesses.load());
+            keysExamined.store(other.keysExamined.load());
+            seeks.store(other.seeks.load());
+            docsReturned.store(other.docsReturned.load());
+            writeOps.store(other.writeOps.load());
+            keysInserted.store(other.keysInserted.load());
+            keysDeleted.store(other.keysDeleted.load());
+            writeMicros.store(other.writeMicros.load());
             trackerStartTime = other.trackerStartTime;
             indexKey = other.indexKey;
+            cacheBytes = other.cacheBytes;
             return *this;
         }
 
         // Number of operations that have used this index.
         AtomicInt64 accesses;
 
+        // Index keys examined, and seeks (distinct key ranges scanned), by those operations.
+        AtomicInt64 keysExamined;
+        AtomicInt64 seeks;
+
+        // Documents returned by those operations. An operation whose plan used several indexes is
+        // counted against each of them.
+        AtomicInt64 docsReturned;
+
+        // Number of times a write has updated this index, the keys it inserted and removed in
+        // doing so, and the time spent updating the index. Writes that later abort are counted,
+        // since their cost was paid all the same.
+        AtomicInt64 writeOps;
+        AtomicInt64 keysInserted;
+        AtomicInt64 keysDeleted;
+        AtomicInt64 writeMicros;
+
         // Date/Time that we started tracking index usage.
         Date_t trackerStartTime;
 
         // An owned copy of the associated IndexDescriptor's index key.
         BSONObj indexKey;
+
+        // Bytes of the index held in the storage engine's cache. Not tracked here; filled in at
+        // reporting time, and only if the storage engine can tell.
+        boost::optional<long long> cacheBytes;
     };
 
     /**
@@ -91,6 +126,25 @@ public:
      */
     void recordIndexAccess(StringData indexName);
 
+    /**
+     * Record the work done by an operation that read index 'indexName'. Safe to be called by
+     * multiple threads concurrently.
+     */
+    void recordIndexRead(StringData indexName,
+                         long long keysExamined,
+                         long long seeks,
+                         long long docsReturned);
+
+    /**
+     * Record that a write updated index 'indexName', inserting 'keysInserted' keys and removing
+     * 'keysDeleted' keys in 'elapsed'. Writes to indexes that are not registered, such as those
+     * still being built, are ignored. Safe to be called by multiple threads concurrently.
+     */
+    void recordIndexWrite(StringData indexName,
+                          long long keysInserted,
+                          long long keysDeleted,
+                          Microseconds elapsed);
+
     /**
      * Add map entry for 'indexName' stats collection. Must be called under exclusive collection
      * lock.
@@ -148,6 +148,52 @@ TEST_F(CollectionIndexUsageTrackerTest, DateTimeAfterDeregister) {
     ASSERT(statsMap.find("foo") != statsMap.end());
     ASSERT_EQUALS(statsMap["foo"].trackerStartTime, getClockSource()->now());
 }
+
+// Test that the work done by reads accumulates per index.
+TEST_F(CollectionIndexUsageTrackerTest, RecordIndexRead) {
+    getTracker()->registerIndex("foo", BSON("foo" << 1));
+    getTracker()->registerIndex("bar", BSON("bar" << 1));
+    getTracker()->recordIndexRead("foo", 10, 2, 5);
+    getTracker()->recordIndexRead("foo", 4, 1, 1);
+    CollectionIndexUsageMap statsMap = getTracker()->getUsageStats();
+    ASSERT_EQUALS(14, statsMap["foo"].keysExamined.loadRelaxed());
+    ASSERT_EQUALS(3, statsMap["foo"].seeks.loadRelaxed());
+    ASSERT_EQUALS(6, statsMap["foo"].docsReturned.loadRelaxed());
+    ASSERT_EQUALS(0, statsMap["bar"].keysExamined.loadRelaxed());
+}
+
+// Test that index maintenance done by writes accumulates per index.
+TEST_F(CollectionIndexUsageTrackerTest, RecordIndexWrite) {
+    getTracker()->registerIndex("foo", BSON("foo" << 1));
+    getTracker()->recordIndexWrite("foo", 3, 0, Microseconds(20));
+    getTracker()->recordIndexWrite("foo", 1, 2, Microseconds(5));
+    CollectionIndexUsageMap statsMap = getTracker()->getUsageStats();
+    ASSERT_EQUALS(2, statsMap["foo"].writeOps.loadRelaxed());
+    ASSERT_EQUALS(4, statsMap["foo"].keysInserted.loadRelaxed());
+    ASSERT_EQUALS(2, statsMap["foo"].keysDeleted.loadRelaxed());
+    ASSERT_EQUALS(25, statsMap["foo"].writeMicros.loadRelaxed());
+    ASSERT_EQUALS(0, statsMap["foo"].accesses.loadRelaxed());
+}
+
+// Test that writes to an index which is not registered, such as one being built, are ignored.
+TEST_F(CollectionIndexUsageTrackerTest, RecordIndexWriteUnregistered) {
+    getTracker()->recordIndexWrite("foo", 3, 0, Microseconds(20));
+    ASSERT(getTracker()->getUsageStats().empty());
+}
+
+// Test that unregistering an index resets its cost statistics.
+TEST_F(CollectionIndexUsageTrackerTest, CostsAfterDeregister) {
+    getTracker()->registerIndex("foo", BSON("foo" << 1));
+    getTracker()->recordIndexRead("foo", 10, 2, 5);
+    getTracker()->recordIndexWrite("foo", 3, 0, Microseconds(20));
+    getTracker()->unregisterIndex("foo");
+    getTracker()->registerIndex("foo", BSON("foo" << 1));
+
+    CollectionIndexUsageMap statsMap = getTracker()->getUsageStats();
+    ASSERT_EQUALS(0, statsMap["foo"].keysExamined.loadRelaxed());
+    ASSERT_EQUALS(0, statsMap["foo"].keysInserted.loadRelaxed());
+    ASSERT_FALSE(statsMap["foo"].cacheBytes);
+}
 }  // namespace
 }  // namespace mongo
 
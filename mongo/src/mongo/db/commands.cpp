@@ -431,6 +431,7 @@ bool Command::isHelpRequest(const BSONElement& helpElem) {
 }
 
 const char Command::kHelpFieldName[] = "help";
+const char Command::kAdmissionPriorityFieldName[] = "admissionPriority";
 
 void Command::generateHelpResponse(OperationContext* opCtx,
                                    rpc::ReplyBuilderInterface* replyBuilder,
@@ -191,6 +191,14 @@ public:
      */
     virtual bool maintenanceMode() const = 0;
 
+    /**
+     * Like maintenanceMode(), but for a specific invocation, so that commands can skip the
+     * "recovering" state for options that do not block reads.
+     */
+    virtual bool maintenanceModeFor(const BSONObj& cmdObj) const {
+        return maintenanceMode();
+    }
+
     /**
      * Return true if command should be permitted when a replica set secondary is in "recovering"
      * (unreadable) state.
@@ -717,6 +725,9 @@ public:
 
     static const char kHelpFieldName[];
 
+    // The name of the generic argument that sets an operation's ticket admission priority.
+    static const char kAdmissionPriorityFieldName[];
+
     /**
      * Generates a reply from the 'help' information associated with a command. The state of
      * the passed ReplyBuilder will be in kOutputDocs after calling this method.
@@ -779,6 +790,7 @@ public:
             arg == "writeConcern" ||                     //
             arg == "lsid" ||                             //
             arg == "txnNumber" ||                        //
+            arg == "admissionPriority" ||                //
             false;  // These comments tell clang-format to keep this line-oriented.
     }
 
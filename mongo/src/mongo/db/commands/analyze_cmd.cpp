@@ -0,0 +1,276 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace dps = ::mongo::dotted_path_support;
+
+namespace {
+
+const long long kDefaultSampleSize = 1000;
+const long long kMaxSampleSize = 100000;
+const long long kDefaultNumBuckets = 10;
+const long long kMaxNumBuckets = 1000;
+
+/**
+ * Estimates the number of distinct values in a collection of 'numRecords' documents from a sample
+ * of 'sampled' values containing 'distinct' distinct values, 'singletons' of which were seen
+ * exactly once. Uses the Duj1 estimator of Haas et al., which is exact for a full scan.
+ */
+double estimateDistinctValues(long long sampled,
+                              long long distinct,
+                              long long singletons,
+                              long long numRecords) {
+    if (sampled == 0 || sampled >= numRecords) {
+        return distinct;
+    }
+    double n = sampled;
+    double denominator = n - singletons + singletons * n / numRecords;
+    if (denominator <= 0) {
+        return numRecords;
+    }
+    return std::min(static_cast<double>(numRecords), n * distinct / denominator);
+}
+
+Status parsePositiveLong(const BSONObj& cmdObj,
+                         StringData fieldName,
+                         long long defaultValue,
+                         long long maxValue,
+                         long long* out) {
+    BSONElement elt = cmdObj[fieldName];
+    if (elt.eoo()) {
+        *out = defaultValue;
+        return Status::OK();
+    }
+    if (!elt.isNumber() || elt.numberLong() <= 0 || elt.numberLong() > maxValue) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "'" << fieldName << "' must be a number between 1 and "
+                              << maxValue};
+    }
+    *out = elt.numberLong();
+    return Status::OK();
+}
+
+/**
+ * Samples the documents of a collection and reports an equi-depth histogram and an estimate of
+ * the number of distinct values for one field.
+ *
+ * Format:
+ * {
+ *   analyze: <collection name>,
+ *   key: <field path>,
+ *   sampleSize: <number of documents to sample, default 1000>,
+ *   buckets: <number of histogram buckets, default 10>
+ * }
+ *
+ * Collections with no more than 'sampleSize' documents are scanned in full. Larger collections
+ * are sampled with replacement through the record store's random cursor. Documents missing the
+ * field are counted separately and are not part of the histogram. Each bucket reports the
+ * smallest and largest sampled value it covers, the number of sampled values and the estimated
+ * number of documents in the collection. Equal values never straddle two buckets, so a skewed
+ * field may produce fewer buckets than requested.
+ */
+class CmdAnalyze : public BasicCommand {
+public:
+    CmdAnalyze() : BasicCommand("analyze") {}
+
+    virtual bool slaveOk() const {
+        return true;
+    }
+
+    virtual bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    virtual void help(std::stringstream& help) const {
+        help << "sample a collection and report a histogram and distinct value estimate for a "
+                "field\n"
+                "{ analyze: <collection>, key: <field>, sampleSize: <n>, buckets: <n> }";
+    }
+
+    Status checkAuthForOperation(OperationContext* opCtx,
+                                 const std::string& dbname,
+                                 const BSONObj& cmdObj) override {
+        AuthorizationSession* authSession = AuthorizationSession::get(opCtx->getClient());
+        const NamespaceString nss(parseNsCollectionRequired(dbname, cmdObj));
+        if (!authSession->isAuthorizedForActionsOnNamespace(nss, ActionType::find)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+        return Status::OK();
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) {
+        const NamespaceString nss(parseNsCollectionRequired(dbname, cmdObj));
+
+        BSONElement keyElt = cmdObj["key"];
+        if (keyElt.type() != BSONType::String || keyElt.valueStringData().empty()) {
+            return appendCommandStatus(
+                result, {ErrorCodes::BadValue, "'key' must be a non-empty field path string"});
+        }
+        const std::string key = keyElt.str();
+
+        long long sampleSize;
+        Status status = parsePositiveLong(
+            cmdObj, "sampleSize", kDefaultSampleSize, kMaxSampleSize, &sampleSize);
+        if (!status.isOK()) {
+            return appendCommandStatus(result, status);
+        }
+        long long numBuckets;
+        status =
+            parsePositiveLong(cmdObj, "buckets", kDefaultNumBuckets, kMaxNumBuckets, &numBuckets);
+        if (!status.isOK()) {
+            return appendCommandStatus(result, status);
+        }
+
+        AutoGetCollectionForReadCommand ctx(opCtx, nss);
+        Collection* collection = ctx.getCollection();
+        if (!collection) {
+            return appendCommandStatus(
+                result,
+                {ErrorCodes::NamespaceNotFound, str::stream() << "ns not found: " << nss.ns()});
+        }
+
+        const long long numRecords = collection->numRecords(opCtx);
+        const bool fullScan = numRecords <= sampleSize;
+        std::unique_ptr<SeekableRecordCursor> fullCursor;
+        std::unique_ptr<RecordCursor> randomCursor;
+        if (fullScan) {
+            fullCursor = collection->getCursor(opCtx);
+        } else {
+            randomCursor = collection->getRecordStore()->getRandomCursor(opCtx);
+            if (!randomCursor) {
+                return appendCommandStatus(
+                    result,
+                    {ErrorCodes::CommandNotSupported,
+                     "the storage engine does not support random sampling of collections larger "
+                     "than 'sampleSize'"});
+            }
+        }
+
+        // Each sampled value is kept as a single-field object so that it owns its data.
+        std::vector<BSONObj> values;
+        long long sampled = 0;
+        long long missing = 0;
+        while (sampled < sampleSize) {
+            if (sampled % 128 == 0) {
+                opCtx->checkForInterrupt();
+            }
+            auto record = fullScan ? fullCursor->next() : randomCursor->next();
+            if (!record) {
+                break;
+            }
+            ++sampled;
+
+            BSONObj doc = record->data.toBson();
+            BSONElement value = dps::extractElementAtPath(doc, key);
+            if (value.eoo()) {
+                ++missing;
+                continue;
+            }
+            BSONObjBuilder bob;
+            bob.appendAs(value, "");
+            values.push_back(bob.obj());
+        }
+
+        const auto& comparator = SimpleBSONObjComparator::kInstance;
+        std::sort(values.begin(), values.end(), comparator.makeLessThan());
+
+        const double scale = sampled ? static_cast<double>(numRecords) / sampled : 0;
+        const size_t bucketDepth = (values.size() + numBuckets - 1) / numBuckets;
+        long long distinct = 0;
+        long long singletons = 0;
+
+        BSONArrayBuilder histogram(result.subarrayStart("histogram"));
+        size_t bucketStart = 0;
+        long long bucketDistinct = 0;
+        for (size_t i = 0; i < values.size();) {
+            // Advance over the run of values equal to values[i].
+            size_t runEnd = i + 1;
+            while (runEnd < values.size() && comparator.evaluate(values[runEnd] == values[i])) {
+                ++runEnd;
+            }
+            ++distinct;
+            ++bucketDistinct;
+            if (runEnd - i == 1) {
+                ++singletons;
+            }
+
+            if (runEnd - bucketStart >= bucketDepth || runEnd == values.size()) {
+                const long long count = runEnd - bucketStart;
+                BSONObjBuilder bucket(histogram.subobjStart());
+                bucket.appendAs(values[bucketStart].firstElement(), "min");
+                bucket.appendAs(values[runEnd - 1].firstElement(), "max");
+                bucket.append("sampled", count);
+                bucket.append("distinct", bucketDistinct);
+                bucket.append("estimatedCount", static_cast<long long>(count * scale));
+                bucket.doneFast();
+                bucketStart = runEnd;
+                bucketDistinct = 0;
+            }
+            i = runEnd;
+        }
+        histogram.doneFast();
+
+        result.append("ns", nss.ns());
+        result.append("key", key);
+        result.append("numRecords", numRecords);
+        result.append("sampled", sampled);
+        result.append("fullScan", fullScan);
+        result.append("missing", missing);
+        result.append("estimatedMissing", static_cast<long long>(missing * scale));
+        result.append("sampledDistinct", distinct);
+        result.append(
+            "estimatedDistinct",
+            static_cast<long long>(estimateDistinctValues(
+                static_cast<long long>(values.size()),
+                distinct,
+                singletons,
+                numRecords - static_cast<long long>(missing * scale))));
+        return true;
+    }
+} cmdAnalyze;
+
+}  // namespace
+}  // namespace mongo
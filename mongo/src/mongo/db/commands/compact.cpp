@@ -30,6 +30,7 @@
 
 #define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
 
+#include <boost/optional.hpp>
 #include <string>
 #include <vector>
 
@@ -67,6 +68,10 @@ public:
     virtual bool maintenanceMode() const {
         return true;
     }
+    bool maintenanceModeFor(const BSONObj& cmdObj) const override {
+        // Online compaction does not block reads, so the node can stay in rotation.
+        return !cmdObj["online"].trueValue();
+    }
     virtual void addRequiredPrivileges(const std::string& dbname,
                                        const BSONObj& cmdObj,
                                        std::vector<Privilege>* out) {
@@ -79,10 +84,14 @@ public:
                 "warning: this operation locks the database and is slow. you can cancel with "
                 "killOp()\n"
                 "{ compact : <collection_name>, [force:<bool>], [validate:<bool>],\n"
-                "  [paddingFactor:<num>], [paddingBytes:<num>] }\n"
+                "  [paddingFactor:<num>], [paddingBytes:<num>],\n"
+                "  [online:<bool>], [sliceSecs:<num>], [pauseMillis:<num>] }\n"
                 "  force - allows to run on a replica set primary\n"
                 "  validate - check records are noncorrupt before adding to newly compacting "
-                "extents. slower but safer (defaults to true in this version)\n";
+                "extents. slower but safer (defaults to true in this version)\n"
+                "  online - compact in place under intent locks, in slices of sliceSecs "
+                "(default 1) separated by pauseMillis (default 1000). needs a storage engine "
+                "that compacts in place\n";
     }
     CompactCmd() : ErrmsgCommandDeprecated("compact") {}
 
@@ -93,8 +102,12 @@ public:
                            BSONObjBuilder& result) {
         NamespaceString nss = parseNsCollectionRequired(db, cmdObj);
 
+        CompactOptions compactOptions;
+        compactOptions.online = cmdObj["online"].trueValue();
+
         repl::ReplicationCoordinator* replCoord = repl::getGlobalReplicationCoordinator();
-        if (replCoord->getMemberState().primary() && !cmdObj["force"].trueValue()) {
+        if (replCoord->getMemberState().primary() && !compactOptions.online &&
+            !cmdObj["force"].trueValue()) {
             errmsg =
                 "will not run compact on an active replica set primary as this is a slow blocking "
                 "operation. use force:true to force";
@@ -113,7 +126,27 @@ public:
             return false;
         }
 
-        CompactOptions compactOptions;
+        if (cmdObj.hasElement("sliceSecs") || cmdObj.hasElement("pauseMillis")) {
+            if (!compactOptions.online) {
+                errmsg = "sliceSecs and pauseMillis require online:true";
+                return false;
+            }
+            if (cmdObj.hasElement("sliceSecs")) {
+                compactOptions.onlineSliceSecs = cmdObj["sliceSecs"].numberInt();
+                if (compactOptions.onlineSliceSecs < 1 || compactOptions.onlineSliceSecs > 3600) {
+                    errmsg = "invalid sliceSecs";
+                    return false;
+                }
+            }
+            if (cmdObj.hasElement("pauseMillis")) {
+                compactOptions.onlinePauseMillis = cmdObj["pauseMillis"].numberInt();
+                if (compactOptions.onlinePauseMillis < 0 ||
+                    compactOptions.onlinePauseMillis > 60 * 60 * 1000) {
+                    errmsg = "invalid pauseMillis";
+                    return false;
+                }
+            }
+        }
 
         if (cmdObj["preservePadding"].trueValue()) {
             compactOptions.paddingMode = CompactOptions::PRESERVE;
@@ -143,8 +176,14 @@ public:
         if (cmdObj.hasElement("validate"))
             compactOptions.validateDocuments = cmdObj["validate"].trueValue();
 
-        AutoGetDb autoDb(opCtx, db, MODE_X);
+        // Online compaction only takes intent locks, so reads and writes to the collection carry
+        // on while it runs; drops and other exclusive operations still wait for it.
+        AutoGetDb autoDb(opCtx, db, compactOptions.online ? MODE_IX : MODE_X);
         Database* const collDB = autoDb.getDb();
+        boost::optional<Lock::CollectionLock> collLock;
+        if (compactOptions.online) {
+            collLock.emplace(opCtx->lockState(), nss.ns(), MODE_IX);
+        }
 
         Collection* collection = collDB ? collDB->getCollection(opCtx, nss) : nullptr;
         auto view =
@@ -30,6 +30,9 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
@@ -37,11 +40,17 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/count.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/view_response_formatter.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/db/views/resolved_view.h"
 #include "mongo/util/log.h"
 
@@ -52,6 +61,118 @@ using std::unique_ptr;
 using std::string;
 using std::stringstream;
 
+// The z-score of the two-sided 95% confidence interval reported for sampled counts.
+const double kConfidenceZ = 1.96;
+
+/**
+ * Applies the request's skip and limit to a count of matching documents.
+ */
+long long applySkipAndLimit(const CountRequest& request, long long count) {
+    count = std::max(0LL, count - request.getSkip());
+    if (request.getLimit() > 0) {
+        count = std::min(count, request.getLimit());
+    }
+    return count;
+}
+
+/**
+ * Estimates the count for 'request' by matching a random sample of documents from 'collection'
+ * and scaling the matched fraction by the number of records. Appends the estimate and a 95%
+ * (Wilson score) confidence interval to 'result'. Sampling stops early, with a correspondingly
+ * wider interval, once nine tenths of the request's maxTimeMS budget have been spent.
+ *
+ * Returns false without appending anything when the count should be computed exactly instead:
+ * the collection is no larger than the sample, the storage engine cannot sample randomly, or the
+ * query can only be answered through an index.
+ */
+StatusWith<bool> appendSampledCount(OperationContext* opCtx,
+                                    Collection* collection,
+                                    const CountRequest& request,
+                                    BSONObjBuilder* result) {
+    const long long sampleSize = *request.getSampleSize();
+    const long long numRecords = collection ? collection->numRecords(opCtx) : 0;
+    if (numRecords <= sampleSize) {
+        return false;
+    }
+
+    std::unique_ptr<CollatorInterface> collator;
+    const CollatorInterface* effectiveCollator = collection->getDefaultCollator();
+    if (!request.getCollation().isEmpty()) {
+        auto statusWithCollator = CollatorFactoryInterface::get(opCtx->getServiceContext())
+                                      ->makeFromBSON(request.getCollation());
+        if (!statusWithCollator.isOK()) {
+            return statusWithCollator.getStatus();
+        }
+        collator = std::move(statusWithCollator.getValue());
+        effectiveCollator = collator.get();
+    }
+
+    boost::intrusive_ptr<ExpressionContext> expCtx(
+        new ExpressionContext(opCtx, effectiveCollator));
+    auto statusWithMatcher =
+        MatchExpressionParser::parse(request.getQuery(),
+                                     expCtx,
+                                     ExtensionsCallbackReal(opCtx, &request.getNs()),
+                                     MatchExpressionParser::kAllowAllSpecialFeatures);
+    if (!statusWithMatcher.isOK()) {
+        return statusWithMatcher.getStatus();
+    }
+    const MatchExpression* matcher = statusWithMatcher.getValue().get();
+    if (QueryPlannerCommon::hasNode(matcher, MatchExpression::TEXT) ||
+        QueryPlannerCommon::hasNode(matcher, MatchExpression::GEO_NEAR)) {
+        return false;
+    }
+
+    auto cursor = collection->getRecordStore()->getRandomCursor(opCtx);
+    if (!cursor) {
+        return false;
+    }
+
+    // Keep a tenth of the time budget back so that an answer is returned before the deadline.
+    const Microseconds reserve(static_cast<long long>(request.getMaxTimeMS()) * 100);
+    long long sampled = 0;
+    long long matched = 0;
+    while (sampled < sampleSize) {
+        if (sampled % 128 == 0) {
+            if (sampled > 0 && opCtx->hasDeadline() &&
+                opCtx->getRemainingMaxTimeMicros() <= reserve) {
+                break;
+            }
+            opCtx->checkForInterrupt();
+        }
+        auto record = cursor->next();
+        if (!record) {
+            break;
+        }
+        ++sampled;
+        if (matcher->matchesBSON(record->data.toBson())) {
+            ++matched;
+        }
+    }
+    if (sampled == 0) {
+        return false;
+    }
+
+    const double n = sampled;
+    const double p = matched / n;
+    const double z2 = kConfidenceZ * kConfidenceZ;
+    const double center = (p + z2 / (2 * n)) / (1 + z2 / n);
+    const double halfWidth =
+        kConfidenceZ * std::sqrt(p * (1 - p) / n + z2 / (4 * n * n)) / (1 + z2 / n);
+    const auto scale = [&](double fraction) {
+        return applySkipAndLimit(request, std::llround(fraction * numRecords));
+    };
+
+    result->appendNumber("n", scale(p));
+    result->append("approximate", true);
+    result->appendNumber("sampled", sampled);
+    BSONObjBuilder interval(result->subobjStart("confidenceInterval"));
+    interval.appendNumber("lower", scale(std::max(0.0, center - halfWidth)));
+    interval.appendNumber("upper", scale(std::min(1.0, center + halfWidth)));
+    interval.doneFast();
+    return true;
+}
+
 /**
  * Implements the MongoD side of the count command.
  */ //countcommandͳ
@@ -213,6 +334,16 @@ public:
         auto rangePreserver =
             CollectionShardingState::get(opCtx, request.getValue().getNs())->getMetadata();
 
+        if (request.getValue().getSampleSize()) {
+            auto sampled = appendSampledCount(opCtx, collection, request.getValue(), &result);
+            if (!sampled.isOK()) {
+                return appendCommandStatus(result, sampled.getStatus());
+            }
+            if (sampled.getValue()) {
+                return true;
+            }
+        }
+
         auto statusWithPlanExecutor = getExecutorCount(opCtx,
                                                        collection,
                                                        request.getValue(),
@@ -239,7 +370,7 @@ public:
         PlanSummaryStats summaryStats;
         Explain::getSummaryStats(*exec, &summaryStats);
         if (collection) {
-            collection->infoCache()->notifyOfQuery(opCtx, summaryStats.indexesUsed);
+            collection->infoCache()->notifyOfQuery(opCtx, summaryStats);
         }
         curOp->debug().setPlanSummaryMetrics(summaryStats);
 
@@ -256,6 +387,9 @@ public:
             static_cast<const CountStats*>(countStage->getSpecificStats());
 
         result.appendNumber("n", countStats->nCounted);
+        if (request.getValue().getSampleSize()) {
+            result.append("approximate", false);
+        }
         return true;
     }
 
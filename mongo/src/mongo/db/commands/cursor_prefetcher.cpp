@@ -0,0 +1,198 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/commands/cursor_prefetcher.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/clientcursor.h"
+#include "mongo/db/cursor_manager.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/find_common.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+const auto getCursorPrefetcher = ServiceContext::declareDecoration<CursorPrefetcher>();
+
+ThreadPool::Options makeThreadPoolOptions() {
+    ThreadPool::Options options;
+    options.poolName = "CursorPrefetcher";
+    options.minThreads = 0;
+    options.maxThreads = 4;
+
+    // Ensure all threads have a client
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThread(threadName.c_str());
+    };
+    return options;
+}
+}  // namespace
+
+CursorPrefetcher* CursorPrefetcher::get(ServiceContext* serviceContext) {
+    return &getCursorPrefetcher(serviceContext);
+}
+
+CursorPrefetcher::CursorPrefetcher() : _threadPool(makeThreadPoolOptions()) {
+    _threadPool.startup();
+}
+
+CursorPrefetcher::~CursorPrefetcher() {
+    _threadPool.shutdown();
+    _threadPool.join();
+}
+
+bool CursorPrefetcher::shouldPrefetch(OperationContext* opCtx, const ClientCursor& cursor) {
+    const long long maxBytes = internalQueryCursorPrefetchMaxBytes.load();
+    return maxBytes > 0 && ClientCursor::getTotalPrefetchedBytes() < maxBytes &&
+        !cursor.isTailable() && !CursorManager::isGloballyManagedCursor(cursor.cursorid()) &&
+        !opCtx->getClient()->isInDirectClient();
+}
+
+void CursorPrefetcher::schedule(const NamespaceString& nss,
+                                CursorId cursorId,
+                                boost::optional<LogicalSessionId> lsid,
+                                boost::optional<long long> batchSize) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_inProgress.insert(cursorId).second) {
+            return;
+        }
+    }
+
+    auto status = _threadPool.schedule([this, nss, cursorId, lsid, batchSize]() noexcept {
+        _prefetch(nss, cursorId, lsid, batchSize);
+    });
+    if (!status.isOK()) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _inProgress.erase(cursorId);
+        _prefetchFinished.notify_all();
+    }
+}
+
+void CursorPrefetcher::waitForPrefetch(OperationContext* opCtx, CursorId cursorId) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    opCtx->waitForConditionOrInterrupt(
+        _prefetchFinished, lk, [&] { return !_inProgress.count(cursorId); });
+}
+
+void CursorPrefetcher::_prefetch(const NamespaceString& nss,
+                                 CursorId cursorId,
+                                 boost::optional<LogicalSessionId> lsid,
+                                 boost::optional<long long> batchSize) {
+    ON_BLOCK_EXIT([&] {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _inProgress.erase(cursorId);
+        _prefetchFinished.notify_all();
+    });
+
+    try {
+        auto opCtx = cc().makeOperationContext();
+        if (lsid) {
+            // Cursors opened in a session may only be pinned from that session.
+            opCtx->setLogicalSessionId(*lsid);
+        }
+
+        // As in getMore, the lock is acquired before the pin so that the pin is released under it.
+        AutoGetCollectionForRead readLock(opCtx.get(), nss);
+        Collection* collection = readLock.getCollection();
+        if (!collection) {
+            return;
+        }
+
+        auto ccPin = collection->getCursorManager()->pinCursor(opCtx.get(), cursorId);
+        if (!ccPin.isOK()) {
+            return;
+        }
+        ClientCursor* cursor = ccPin.getValue().getCursor();
+
+        if (cursor->isReadCommitted()) {
+            uassertStatusOK(opCtx->recoveryUnit()->setReadFromMajorityCommittedSnapshot());
+        }
+
+        PlanExecutor* exec = cursor->getExecutor();
+        exec->reattachToOperationContext(opCtx.get());
+        ON_BLOCK_EXIT([&] { exec->detachFromOperationContext(); });
+        if (!exec->restoreState().isOK()) {
+            // The cursor was killed, so releasing the pin disposes of it.
+            exec->saveState();
+            return;
+        }
+
+        // Produce the batch the next getMore would, with the same limits. This also takes back any
+        // result the last getMore stashed, so that the order of the stash is kept.
+        std::vector<BSONObj> results;
+        size_t bytes = 0;
+        boost::optional<BSONObj> failure;
+        try {
+            BSONObj obj;
+            PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
+            while (!FindCommon::enoughForGetMore(batchSize.value_or(0), results.size()) &&
+                   PlanExecutor::ADVANCED == (state = exec->getNext(&obj, NULL))) {
+                const bool haveSpace = FindCommon::haveSpaceForNext(obj, results.size(), bytes);
+                results.push_back(obj.getOwned());
+                bytes += obj.objsize();
+                if (!haveSpace) {
+                    break;
+                }
+            }
+            if (PlanExecutor::FAILURE == state) {
+                failure = obj.getOwned();
+            }
+        } catch (const DBException& ex) {
+            failure = WorkingSetCommon::buildMemberStatusObject(ex.toStatus());
+        }
+
+        // Results already taken from the plan must reach the client in order, followed by any
+        // error which stopped the prefetch, just as if the next getMore had produced them.
+        for (auto&& result : results) {
+            exec->enqueue(result);
+        }
+        if (failure) {
+            exec->enqueueFailure(*failure);
+        }
+
+        cursor->setPrefetchedBytes(bytes);
+        exec->saveState();
+    } catch (const DBException& ex) {
+        LOG(1) << "Failed to prefetch the next batch of cursor " << cursorId << " on " << nss
+               << ": " << redact(ex.toStatus());
+    }
+}
+
+}  // namespace mongo
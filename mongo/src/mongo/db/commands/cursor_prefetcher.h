@@ -0,0 +1,105 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/cursor_id.h"
+#include "mongo/db/logical_session_id.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_set.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+
+class ClientCursor;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Produces the next batch of a find cursor in the background once a getMore has returned, so that
+ * the following getMore only has to send results which are already waiting. Opt in by setting
+ * internalQueryCursorPrefetchMaxBytes, which bounds the results held for all cursors.
+ *
+ * A prefetch pins the cursor on a thread of its own, under its own OperationContext and collection
+ * lock, so it yields and can be killed like any other read. The results go into the cursor's
+ * PlanExecutor with PlanExecutor::enqueue(), which returns them ahead of anything it executes
+ * next. A getMore waits for a prefetch of its cursor which is still running before pinning it.
+ */
+class CursorPrefetcher {
+    MONGO_DISALLOW_COPYING(CursorPrefetcher);
+
+public:
+    static CursorPrefetcher* get(ServiceContext* serviceContext);
+
+    CursorPrefetcher();
+    ~CursorPrefetcher();
+
+    /**
+     * Returns whether the getMore on 'opCtx' should prefetch the next batch of 'cursor', which it
+     * is leaving open. Tailable, aggregation and DBDirectClient cursors are never prefetched.
+     */
+    static bool shouldPrefetch(OperationContext* opCtx, const ClientCursor& cursor);
+
+    /**
+     * Schedules a prefetch of up to 'batchSize' results (or a full batch if none) from the cursor
+     * 'cursorId' on 'nss'. The caller must have unpinned the cursor.
+     */
+    void schedule(const NamespaceString& nss,
+                  CursorId cursorId,
+                  boost::optional<LogicalSessionId> lsid,
+                  boost::optional<long long> batchSize);
+
+    /**
+     * Blocks until no prefetch of 'cursorId' is running. Called by getMore before it locks the
+     * collection and pins the cursor.
+     */
+    void waitForPrefetch(OperationContext* opCtx, CursorId cursorId);
+
+private:
+    void _prefetch(const NamespaceString& nss,
+                   CursorId cursorId,
+                   boost::optional<LogicalSessionId> lsid,
+                   boost::optional<long long> batchSize);
+
+    stdx::mutex _mutex;
+
+    // Signalled whenever a prefetch finishes.
+    stdx::condition_variable _prefetchFinished;
+
+    // The cursors with a prefetch scheduled or running.
+    stdx::unordered_set<CursorId> _inProgress;
+
+    ThreadPool _threadPool;
+};
+
+}  // namespace mongo
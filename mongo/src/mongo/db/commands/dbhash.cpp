@@ -32,6 +32,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <cstring>
 #include <map>
 #include <string>
 
@@ -39,12 +40,15 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_catalog_entry.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/net/sock.h"
@@ -54,6 +58,13 @@ namespace mongo {
 
 namespace {
 
+// The most collections a single dbHash command will hash at the same time.
+MONGO_EXPORT_SERVER_PARAMETER(dbHashMaxParallelism, int, 8);
+
+// How many documents are hashed between checks of whether the command was interrupted, when the
+// collection is hashed on a thread of its own.
+const long long kInterruptCheckInterval = 1024;
+
 class DBHashCmd : public ErrmsgCommandDeprecated {
 public:
     DBHashCmd() : ErrmsgCommandDeprecated("dbHash", "dbhash") {}
@@ -94,15 +105,42 @@ public:
             }
         }
 
+        // With 'orderIndependent', documents are read in their natural order and the hash of a
+        // collection only depends on which documents it holds, not on the order they are stored or
+        // indexed in. Such hashes can only be compared with other order independent hashes.
+        bool orderIndependent = false;
+        if (auto elem = cmdObj["orderIndependent"]) {
+            if (!elem.isBoolean()) {
+                errmsg = "orderIndependent has to be a boolean";
+                return false;
+            }
+            orderIndependent = elem.boolean();
+        }
+
+        // With a 'parallel' value greater than 1, that many collections are hashed at once, each
+        // under its own collection lock instead of all under one lock on the database. Each hash
+        // is then of a consistent state of its collection, but collections are not hashed at the
+        // same point in time, so this is only meant for when writes have been quiesced.
+        int parallel = 1;
+        if (auto elem = cmdObj["parallel"]) {
+            if (!elem.isNumber() || elem.numberInt() < 1) {
+                errmsg = "parallel has to be a positive number";
+                return false;
+            }
+            parallel = std::min(elem.numberInt(), std::max(dbHashMaxParallelism.load(), 1));
+        }
+
         const std::string ns = parseNs(dbname, cmdObj);
         uassert(ErrorCodes::InvalidNamespace,
                 str::stream() << "Invalid db name: " << ns,
                 NamespaceString::validDBName(ns, NamespaceString::DollarInDbNameBehavior::Allow));
 
         // We lock the entire database in S-mode in order to ensure that the contents will not
-        // change for the snapshot.
-        AutoGetDb autoDb(opCtx, ns, MODE_S);
-        Database* db = autoDb.getDb();
+        // change for the snapshot. Parallel hashing only needs the database lock while it lists
+        // the collections.
+        boost::optional<AutoGetDb> autoDb;
+        autoDb.emplace(opCtx, ns, parallel > 1 ? MODE_IS : MODE_S);
+        Database* db = autoDb->getDb();
         std::list<std::string> colls;
         if (db) {
             db->getDatabaseCatalogEntry()->getCollectionNamespaces(&colls);
@@ -124,7 +162,7 @@ public:
                                                                "system.views"};
 
 
-        BSONObjBuilder bb(result.subobjStart("collections"));
+        std::vector<NamespaceString> toHash;
         for (const auto& collectionName : colls) {
 
             NamespaceString collNss(collectionName);
@@ -136,7 +174,8 @@ public:
 
             // Only include 'system' collections that are replicated.
             bool isReplicatedSystemColl =
-                (replicatedSystemCollections.count(collNss.coll().toString()) > 0);
+                (replicatedSystemCollections.count(collNss.coll().toString()) > 0) ||
+                collNss.isSystemDotMaterialized();
             if (collNss.isSystem() && !isReplicatedSystemColl)
                 continue;
 
@@ -148,11 +187,24 @@ public:
             if (collNss.isDropPendingNamespace())
                 continue;
 
-            // Compute the hash for this collection.
-            std::string hash = _hashCollection(opCtx, db, collNss.toString());
+            toHash.push_back(std::move(collNss));
+        }
+
+        std::vector<std::string> hashes;
+        if (parallel > 1) {
+            autoDb.reset();
+            hashes = _hashCollectionsInParallel(opCtx, toHash, orderIndependent, parallel);
+        } else {
+            for (const auto& collNss : toHash) {
+                hashes.push_back(_hashCollection(
+                    opCtx, db->getCollection(opCtx, collNss), orderIndependent, nullptr));
+            }
+        }
 
-            bb.append(collNss.coll(), hash);
-            md5_append(&globalState, (const md5_byte_t*)hash.c_str(), hash.size());
+        BSONObjBuilder bb(result.subobjStart("collections"));
+        for (size_t i = 0; i < toHash.size(); ++i) {
+            bb.append(toHash[i].coll(), hashes[i]);
+            md5_append(&globalState, (const md5_byte_t*)hashes[i].c_str(), hashes[i].size());
         }
         bb.done();
 
@@ -167,20 +219,76 @@ public:
     }
 
 private:
-    std::string _hashCollection(OperationContext* opCtx,
-                                Database* db,
-                                const std::string& fullCollectionName) {
+    /**
+     * Hashes each collection of 'namespaces' on a thread of its own, running at most 'parallel' at
+     * a time, and returns the hashes in the same order. A collection which doesn't exist by the
+     * time it is hashed gets an empty hash, as it would have if hashed serially.
+     */
+    std::vector<std::string> _hashCollectionsInParallel(
+        OperationContext* opCtx,
+        const std::vector<NamespaceString>& namespaces,
+        bool orderIndependent,
+        int parallel) {
+        // Declared ahead of the pool, which joins any running workers when it is destroyed.
+        std::vector<std::string> hashes(namespaces.size());
+        std::vector<Status> statuses(namespaces.size(), Status::OK());
+
+        ThreadPool::Options options;
+        options.poolName = "dbHash";
+        options.minThreads = 0;
+        options.maxThreads = parallel;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+        };
+        ThreadPool threadPool(options);
+        threadPool.startup();
+
+        for (size_t i = 0; i < namespaces.size(); ++i) {
+            uassertStatusOK(threadPool.schedule([&, i]() noexcept {
+                try {
+                    auto workerOpCtx = cc().makeOperationContext();
+                    AutoGetCollection autoColl(workerOpCtx.get(), namespaces[i], MODE_IS, MODE_S);
+                    hashes[i] = _hashCollection(
+                        workerOpCtx.get(), autoColl.getCollection(), orderIndependent, opCtx);
+                } catch (const DBException& ex) {
+                    statuses[i] = ex.toStatus();
+                }
+            }));
+        }
+
+        // The workers give up soon after this operation is killed, so joining doesn't take long.
+        threadPool.shutdown();
+        threadPool.join();
 
-        NamespaceString ns(fullCollectionName);
+        opCtx->checkForInterrupt();
+        for (auto&& status : statuses) {
+            uassertStatusOK(status);
+        }
+        return hashes;
+    }
 
-        Collection* collection = db->getCollection(opCtx, ns);
+    /**
+     * Hashes the documents of 'collection', which the caller must have locked in MODE_S. Returns
+     * an empty hash if the collection doesn't exist.
+     *
+     * When hashing on behalf of another operation, 'parentOpCtx' is that operation, and hashing
+     * stops once it is killed.
+     */
+    std::string _hashCollection(OperationContext* opCtx,
+                                Collection* collection,
+                                bool orderIndependent,
+                                OperationContext* parentOpCtx) {
         if (!collection)
             return "";
 
+        const std::string& fullCollectionName = collection->ns().ns();
         IndexDescriptor* desc = collection->getIndexCatalog()->findIdIndex(opCtx);
 
         std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec;
-        if (desc) {
+        if (orderIndependent || (!desc && collection->isCapped())) {
+            exec = InternalPlanner::collectionScan(
+                opCtx, fullCollectionName, collection, PlanExecutor::NO_YIELD);
+        } else if (desc) {
             exec = InternalPlanner::indexScan(opCtx,
                                               collection,
                                               desc,
@@ -190,9 +298,6 @@ private:
                                               PlanExecutor::NO_YIELD,
                                               InternalPlanner::FORWARD,
                                               InternalPlanner::IXSCAN_FETCH);
-        } else if (collection->isCapped()) {
-            exec = InternalPlanner::collectionScan(
-                opCtx, fullCollectionName, collection, PlanExecutor::NO_YIELD);
         } else {
             log() << "can't find _id index for: " << fullCollectionName;
             return "no _id _index";
@@ -201,13 +306,32 @@ private:
         md5_state_t st;
         md5_init(&st);
 
+        // In order independent mode the digests of the documents are summed instead, as two 64-bit
+        // halves, and the sum is hashed along with the count of documents at the end.
+        uint64_t digestSum[2] = {0, 0};
+
         long long n = 0;
         PlanExecutor::ExecState state;
         BSONObj c;
         verify(NULL != exec.get());
         while (PlanExecutor::ADVANCED == (state = exec->getNext(&c, NULL))) {
-            md5_append(&st, (const md5_byte_t*)c.objdata(), c.objsize());
+            if (orderIndependent) {
+                md5digest docDigest;
+                md5(c.objdata(), c.objsize(), docDigest);
+                uint64_t halves[2];
+                std::memcpy(halves, docDigest, sizeof(halves));
+                digestSum[0] += halves[0];
+                digestSum[1] += halves[1];
+            } else {
+                md5_append(&st, (const md5_byte_t*)c.objdata(), c.objsize());
+            }
             n++;
+
+            if (parentOpCtx && n % kInterruptCheckInterval == 0) {
+                stdx::lock_guard<Client> lk(*parentOpCtx->getClient());
+                const auto killStatus = parentOpCtx->getKillStatus();
+                uassert(killStatus, "dbHash was interrupted", killStatus == ErrorCodes::OK);
+            }
         }
         if (PlanExecutor::IS_EOF != state) {
             warning() << "error while hashing, db dropped? ns=" << fullCollectionName;
@@ -215,6 +339,10 @@ private:
                       "Plan executor error while running dbHash command: " +
                           WorkingSetCommon::toStatusString(c));
         }
+        if (orderIndependent) {
+            md5_append(&st, (const md5_byte_t*)digestSum, sizeof(digestSum));
+            md5_append(&st, (const md5_byte_t*)&n, sizeof(n));
+        }
         md5digest d;
         md5_finish(&st, d);
         std::string hash = digestToString(d);
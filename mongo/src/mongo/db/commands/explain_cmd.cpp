@@ -29,6 +29,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/commands.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/util/mongoutils/str.h"
@@ -171,7 +172,9 @@ public:
             return false;
         }
 
-        // Actually call the nested command's explain(...) method.
+        // Actually call the nested command's explain(...) method. Have every stage of the plans it
+        // runs time its work, since the execution stats report the time of each stage.
+        CurOp::get(opCtx)->setIsExplain();
         Status explainStatus =
             commToExplain->explain(opCtx, dbname, explainObj, verbosity.getValue(), &result);
         if (!explainStatus.isOK()) {
@@ -37,6 +37,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/run_aggregate.h"
 #include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
@@ -296,16 +297,19 @@ at src/mongo/db/commands/find_cmd.cpp:311
         // Finish the parsing step by using the QueryRequest to create a CanonicalQuery.
         ExtensionsCallbackReal extensionsCallback(opCtx, &nss);
         const boost::intrusive_ptr<ExpressionContext> expCtx;
-        auto statusWithCQ =
+        auto statusWithCQ = [&] {
+            ScopedOpPhaseTimer parseTimer(opCtx, OpDebug::Phase::kParse);
 			// Queryм򵥵Ĵ(׼)һЩݽṹCanonicalQuery(׼Query)
 
 		    //qrлȡ_qr_isIsolated_projϢ洢CanonicalQuery
-            CanonicalQuery::canonicalize(opCtx,
-                                         std::move(qr),
-                                         expCtx,
-                                         extensionsCallback,
-                                         MatchExpressionParser::kAllowAllSpecialFeatures &
-                                             ~MatchExpressionParser::AllowedFeatures::kIsolated);
+            return CanonicalQuery::canonicalize(
+                opCtx,
+                std::move(qr),
+                expCtx,
+                extensionsCallback,
+                MatchExpressionParser::kAllowAllSpecialFeatures &
+                    ~MatchExpressionParser::AllowedFeatures::kIsolated);
+        }();
         if (!statusWithCQ.isOK()) {
             return appendCommandStatus(result, statusWithCQ.getStatus());
         }
@@ -30,6 +30,7 @@
 
 #include "mongo/db/commands/fsync.h"
 
+#include <boost/filesystem/operations.hpp>
 #include <string>
 #include <vector>
 
@@ -46,9 +47,11 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db.h"
+#include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/mmap_v1/dur.h"
 #include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/background.h"
@@ -329,6 +332,138 @@ private:
 
 } unlockFsyncCmd;
 
+// Whether a backup opened by beginBackupCursor is still open. Guarded by 'commandMutex'.
+bool backupCursorOpen = false;
+
+/**
+ * Opens a non-blocking backup of the storage engine's files and returns their names and sizes.
+ * The files stay consistent on disk, while writes continue, until endBackupCursor is run, so they
+ * can be copied to seed a new member. The copied oplog then brings the member forward from the
+ * backup point on startup recovery and regular replication.
+ */
+class BeginBackupCursorCommand : public BasicCommand {
+public:
+    BeginBackupCursorCommand() : BasicCommand("beginBackupCursor") {}
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    bool slaveOk() const override {
+        return true;
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    void help(stringstream& h) const override {
+        h << "{ beginBackupCursor: 1 } opens a non-blocking backup of the data files. The files "
+             "listed in the reply must not be modified until { endBackupCursor: 1 } is run.";
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) override {
+        ActionSet actions;
+        actions.addAction(ActionType::fsync);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        Lock::ExclusiveLock lk(opCtx->lockState(), commandMutex);
+        if (backupCursorOpen) {
+            return appendCommandStatus(
+                result,
+                {ErrorCodes::IllegalOperation,
+                 "A backup cursor is already open, run endBackupCursor to close it"});
+        }
+
+        // Take a global IS lock to ensure the storage engine is not shutdown
+        Lock::GlobalLock global(opCtx, MODE_IS, UINT_MAX);
+        StorageEngine* storageEngine = getGlobalServiceContext()->getGlobalStorageEngine();
+
+        // Read the last applied optime before opening the backup, so the backed up oplog is
+        // known to reach at least this far.
+        auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+        const auto lastApplied = replCoord->getMyLastAppliedOpTime();
+
+        auto swFiles = storageEngine->beginNonBlockingBackup(opCtx);
+        if (!swFiles.isOK()) {
+            return appendCommandStatus(result, swFiles.getStatus());
+        }
+        backupCursorOpen = true;
+
+        const boost::filesystem::path dbpath(storageGlobalParams.dbpath);
+        result.append("dbpath", storageGlobalParams.dbpath);
+        BSONArrayBuilder files(result.subarrayStart("files"));
+        for (auto&& filename : swFiles.getValue()) {
+            boost::system::error_code ec;
+            const auto fileSize = boost::filesystem::file_size(dbpath / filename, ec);
+            BSONObjBuilder file(files.subobjStart());
+            file.append("filename", filename);
+            file.appendNumber("fileSize", ec ? 0LL : static_cast<long long>(fileSize));
+        }
+        files.doneFast();
+        if (replCoord->getReplicationMode() == repl::ReplicationCoordinator::modeReplSet) {
+            lastApplied.append(&result, "lastAppliedOpTime");
+        }
+
+        log() << "opened a backup cursor over " << swFiles.getValue().size() << " files";
+        return true;
+    }
+} beginBackupCursorCmd;
+
+class EndBackupCursorCommand : public BasicCommand {
+public:
+    EndBackupCursorCommand() : BasicCommand("endBackupCursor") {}
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    bool slaveOk() const override {
+        return true;
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    void help(stringstream& h) const override {
+        h << "{ endBackupCursor: 1 } closes the backup opened by beginBackupCursor.";
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) override {
+        ActionSet actions;
+        actions.addAction(ActionType::fsync);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        Lock::ExclusiveLock lk(opCtx->lockState(), commandMutex);
+        if (!backupCursorOpen) {
+            return appendCommandStatus(
+                result, {ErrorCodes::IllegalOperation, "There is no open backup cursor"});
+        }
+
+        Lock::GlobalLock global(opCtx, MODE_IS, UINT_MAX);
+        getGlobalServiceContext()->getGlobalStorageEngine()->endNonBlockingBackup(opCtx);
+        backupCursorOpen = false;
+
+        log() << "closed the backup cursor";
+        return true;
+    }
+} endBackupCursorCmd;
+
 // Exposed publically via extern in fsync.h.
 SimpleMutex filesLockedFsync;
 
@@ -39,6 +39,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/cursor_prefetcher.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/cursor_manager.h"
 #include "mongo/db/db_raii.h"
@@ -119,10 +120,8 @@ public:
     }
 
     std::size_t reserveBytesForReply() const override {
-        // The extra 1K is an artifact of how we construct batches. We consider a batch to be full
-        // when it exceeds the goal batch size. In the case that we are just below the limit and
-        // then read a large document, the extra 1K helps prevent a final realloc+memcpy.
-        return FindCommon::kMaxBytesToReturnToClientAtOnce + 1024u;
+        // The reply is sized once the cursor is pinned; see getBatchBytesToReserve().
+        return FindCommon::kInitReplyBufferSize;
     }
 
     /**
@@ -201,6 +200,10 @@ public:
                     opCtx, *nssForCurOp, Top::LockType::NotLocked, dbProfilingLevel);
             }
         } else {
+            // A background prefetch of this cursor's next batch must finish before we pin it.
+            CursorPrefetcher::get(opCtx->getServiceContext())
+                ->waitForPrefetch(opCtx, request.cursorid);
+
             readLock.emplace(opCtx, request.nss);
             const int doNotChangeProfilingLevel = 0;
             statsTracker.emplace(opCtx,
@@ -225,6 +228,9 @@ public:
 
         ClientCursor* cursor = ccPin.getValue().getCursor();
 
+        // Any results prefetched for this getMore are about to be returned.
+        cursor->releasePrefetchedBytes();
+
         // If the fail point is enabled, busy wait until it is disabled.
         while (MONGO_FAIL_POINT(keepCursorPinnedDuringGetMore)) {
             if (readLock) {
@@ -320,6 +326,12 @@ public:
             }
         }
 
+        // Grow the reply to the expected batch size up front, rather than doubling it repeatedly
+        // as results are appended.
+        const int bytesToReserve = getBatchBytesToReserve(*cursor, request);
+        result.bb().reserveBytes(bytesToReserve);
+        result.bb().claimReservedBytes(bytesToReserve);
+
         CursorId respondWithId = 0;
         CursorResponseBuilder nextBatch(/*isInitialResponse*/ false, &result);
         BSONObj obj;
@@ -363,6 +375,8 @@ public:
         if (shouldSaveCursorGetMore(state, exec, cursor->isTailable())) {
             respondWithId = request.cursorid;
 
+            cursor->setLastBatch(numResults, nextBatch.bytesUsed());
+
             exec->saveState();
             exec->detachFromOperationContext();
 
@@ -386,6 +400,13 @@ public:
 
         if (respondWithId) {
             cursorFreer.Dismiss();
+
+            if (CursorPrefetcher::shouldPrefetch(opCtx, *cursor)) {
+                const auto lsid = cursor->getSessionId();
+                ccPin.getValue().release();
+                CursorPrefetcher::get(opCtx->getServiceContext())
+                    ->schedule(request.nss, request.cursorid, lsid, request.batchSize);
+            }
         }
 
         return true;
@@ -408,6 +429,32 @@ public:
         return runParsed(opCtx, request.nss, request, cmdObj, result);
     }
 
+    /**
+     * Returns the number of bytes to reserve for the batch this getMore returns from 'cursor'.
+     * Batches of a cursor tend to be alike, so the estimate comes from the cursor's previous
+     * getMore: its size, or its average result size times the requested batch size. Without a
+     * previous getMore, room for the largest possible batch is reserved.
+     */
+    static int getBatchBytesToReserve(const ClientCursor& cursor, const GetMoreRequest& request) {
+        // The extra 1K is an artifact of how we construct batches. We consider a batch to be full
+        // when it exceeds the goal batch size. In the case that we are just below the limit and
+        // then read a large document, the extra 1K helps prevent a final realloc+memcpy.
+        const long long maxBytes = FindCommon::kMaxBytesToReturnToClientAtOnce + 1024;
+        if (cursor.getLastBatchNumResults() == 0) {
+            return maxBytes;
+        }
+
+        long long expectedBytes = cursor.getLastBatchBytes();
+        if (request.batchSize) {
+            const long long avgResultBytes =
+                cursor.getLastBatchBytes() / cursor.getLastBatchNumResults() + 1;
+            expectedBytes = *request.batchSize < maxBytes / avgResultBytes
+                ? avgResultBytes * *request.batchSize
+                : maxBytes;
+        }
+        return std::min(maxBytes, expectedBytes + 1024);
+    }
+
     /**
      * Uses 'cursor' and 'request' to fill out 'nextBatch' with the batch of result documents to
      * be returned by this getMore.
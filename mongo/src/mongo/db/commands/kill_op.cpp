@@ -91,6 +91,13 @@ public:
 
         for (ServiceContext::LockedClientsCursor cursor(client->getServiceContext());
              Client* opClient = cursor.next();) {
+            // Only lock the client whose published operation is the one to kill. The summary
+            // may be stale, so the operation is checked again under the lock.
+            const auto summary = opClient->getPublishedOpState().read();
+            if (!summary.active || summary.opId != opId) {
+                continue;
+            }
+
             stdx::unique_lock<Client> lk(*opClient);
 
             OperationContext* opCtx = opClient->getOperationContext();
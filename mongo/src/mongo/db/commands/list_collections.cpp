@@ -28,6 +28,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <map>
+#include <memory>
 #include <vector>
 
 #include "mongo/base/checked_cast.h"
@@ -49,14 +51,21 @@
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_tree.h"
+#include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/cursor_request.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/find_common.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/views/view_catalog.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -68,6 +77,23 @@ using stdx::make_unique;
 
 namespace {
 
+// Databases with at least this many collections have their listCollections results cached until
+// the catalog next changes. 0 disables the cache.
+MONGO_EXPORT_SERVER_PARAMETER(listCollectionsCacheMinCollections, int, 1000);
+
+/**
+ * Collection name to listCollections result, including drop-pending collections.
+ */
+using CollectionListing = std::map<std::string, BSONObj>;
+
+struct CachedCollectionListing {
+    uint64_t catalogVersion;
+    std::shared_ptr<const CollectionListing> listing;
+};
+
+stdx::mutex collectionListingCacheMutex;
+StringMap<CachedCollectionListing> collectionListingCache;
+
 /**
  * Determines if 'matcher' is an exact match on the "name" field. If so, returns a vector of all the
  * collection names it is matching against. Returns {} if there is no obvious exact match on name.
@@ -106,6 +132,54 @@ boost::optional<vector<StringData>> _getExactNameMatches(const MatchExpression*
     return {};
 }
 
+/**
+ * Determines if 'matcher' requires the "name" field to match an anchored regular expression with a
+ * literal prefix, either by itself or as a child of a top-level $and. If so, returns the prefix.
+ * Returns {} otherwise.
+ */
+boost::optional<std::string> _getNamePrefix(const MatchExpression* matcher) {
+    if (!matcher) {
+        return {};
+    }
+
+    if (matcher->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < matcher->numChildren(); ++i) {
+            if (auto prefix = _getNamePrefix(matcher->getChild(i))) {
+                return prefix;
+            }
+        }
+        return {};
+    }
+
+    if (matcher->matchType() != MatchExpression::REGEX) {
+        return {};
+    }
+
+    auto regexMatch = checked_cast<const RegexMatchExpression*>(matcher);
+    if (regexMatch->path() != "name") {
+        return {};
+    }
+
+    // Collection names are compared using binary comparison, the same as an index with no collator.
+    const IndexEntry nameIndex(BSON("name" << 1),
+                               IndexNames::BTREE,
+                               false,
+                               MultikeyPaths{},
+                               false,
+                               false,
+                               "name",
+                               nullptr,
+                               BSONObj(),
+                               nullptr);
+    IndexBoundsBuilder::BoundsTightness tightness;
+    std::string prefix = IndexBoundsBuilder::simpleRegex(
+        regexMatch->getString().c_str(), regexMatch->getFlags().c_str(), nameIndex, &tightness);
+    if (prefix.empty()) {
+        return {};
+    }
+    return prefix;
+}
+
 /**
  * Uses 'matcher' to determine if the collection's information should be added to 'root'. If so,
  * allocates a WorkingSetMember containing information about 'collection', and adds it to 'root'.
@@ -141,6 +215,9 @@ BSONObj buildViewBson(const ViewDefinition& view) {
     if (view.defaultCollator()) {
         optionsBuilder.append("collation", view.defaultCollator()->getSpec().toBSON());
     }
+    if (view.isMaterialized()) {
+        optionsBuilder.append("materialized", true);
+    }
     optionsBuilder.doneFast();
 
     BSONObj info = BSON("readOnly" << true);
@@ -195,6 +272,67 @@ BSONObj buildCollectionBson(OperationContext* opCtx,
     return b.obj();
 }
 
+/**
+ * Returns the listCollections results for every collection in 'db', including drop-pending ones,
+ * keyed by collection name. The listing is served from a cache when the catalog has not changed
+ * since it was built. Returns nullptr if the listing should not be cached, in which case the caller
+ * is expected to walk the collections itself.
+ *
+ * The caller must hold the database lock in a mode which prevents the set of collections in 'db'
+ * from changing.
+ */
+std::shared_ptr<const CollectionListing> _getCollectionListing(OperationContext* opCtx,
+                                                               Database* db) {
+    const int minCollections = listCollectionsCacheMinCollections.load();
+    if (minCollections <= 0) {
+        return nullptr;
+    }
+
+    auto storageEngine = opCtx->getServiceContext()->getGlobalStorageEngine();
+    const auto catalogVersion = storageEngine->getCatalogVersion();
+    if (!catalogVersion) {
+        return nullptr;
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(collectionListingCacheMutex);
+        auto it = collectionListingCache.find(db->name());
+        if (it != collectionListingCache.end()) {
+            if (it->second.catalogVersion == *catalogVersion) {
+                return it->second.listing;
+            }
+            collectionListingCache.erase(it);
+        }
+    }
+
+    // Only large databases are worth keeping a copy of, so count before building anything.
+    size_t numCollections = 0;
+    for (auto&& collection : *db) {
+        if (collection) {
+            ++numCollections;
+        }
+    }
+    if (numCollections < static_cast<size_t>(minCollections)) {
+        return nullptr;
+    }
+
+    auto listing = std::make_shared<CollectionListing>();
+    for (auto&& collection : *db) {
+        BSONObj collBson = buildCollectionBson(opCtx, collection, true);
+        if (!collBson.isEmpty()) {
+            listing->emplace(collection->ns().coll().toString(), collBson.getOwned());
+        }
+    }
+
+    // A change made elsewhere while the listing was being built means it may not be the one the
+    // next reader would build, so use it for this command only.
+    if (storageEngine->getCatalogVersion() == catalogVersion) {
+        stdx::lock_guard<stdx::mutex> lk(collectionListingCacheMutex);
+        collectionListingCache[db->name()] = {*catalogVersion, listing};
+    }
+    return listing;
+}
+
 class CmdListCollections : public BasicCommand {
 public:
     virtual bool slaveOk() const {
@@ -278,7 +416,15 @@ public:
         auto ws = make_unique<WorkingSet>();
         auto root = make_unique<QueuedDataStage>(opCtx, ws.get());
 
+        if (!db) {
+            stdx::lock_guard<stdx::mutex> lk(collectionListingCacheMutex);
+            collectionListingCache.erase(dbname);
+        }
+
         if (db) {
+            const auto namePrefix = _getNamePrefix(matcher.get());
+            std::shared_ptr<const CollectionListing> listing;
+
             if (auto collNames = _getExactNameMatches(matcher.get())) {
                 for (auto&& collName : *collNames) {
                     auto nss = NamespaceString(db->name(), collName);
@@ -288,8 +434,24 @@ public:
                         _addWorkingSetMember(opCtx, collBson, matcher.get(), ws.get(), root.get());
                     }
                 }
+            } else if ((listing = _getCollectionListing(opCtx, db))) {
+                auto it = namePrefix ? listing->lower_bound(*namePrefix) : listing->begin();
+                for (; it != listing->end(); ++it) {
+                    if (namePrefix && !StringData(it->first).startsWith(*namePrefix)) {
+                        break;
+                    }
+                    if (!includePendingDrops &&
+                        NamespaceString(db->name(), it->first).isDropPendingNamespace()) {
+                        continue;
+                    }
+                    _addWorkingSetMember(opCtx, it->second, matcher.get(), ws.get(), root.get());
+                }
             } else {
                 for (auto&& collection : *db) {
+                    if (namePrefix && collection &&
+                        !collection->ns().coll().startsWith(*namePrefix)) {
+                        continue;
+                    }
                     BSONObj collBson = buildCollectionBson(opCtx, collection, includePendingDrops);
                     if (!collBson.isEmpty()) {
                         _addWorkingSetMember(opCtx, collBson, matcher.get(), ws.get(), root.get());
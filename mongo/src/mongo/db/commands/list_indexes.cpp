@@ -151,21 +151,18 @@ public:
         const CollectionCatalogEntry* cce = collection->getCatalogEntry();
         invariant(cce);
 
-        vector<string> indexNames;
-        writeConflictRetry(opCtx, "listIndexes", ns.ns(), [&indexNames, &cce, &opCtx] {
-            indexNames.clear();
-            cce->getAllIndexes(opCtx, &indexNames);
+        // Read all of the specs at once rather than looking up the catalog entry again for each
+        // index, which is quadratic in the number of indexes.
+        vector<BSONObj> indexSpecs;
+        writeConflictRetry(opCtx, "listIndexes", ns.ns(), [&indexSpecs, &cce, &opCtx] {
+            indexSpecs.clear();
+            cce->getAllIndexSpecs(opCtx, &indexSpecs);
         });
 
         auto ws = make_unique<WorkingSet>();
         auto root = make_unique<QueuedDataStage>(opCtx, ws.get());
 
-        for (size_t i = 0; i < indexNames.size(); i++) {
-            BSONObj indexSpec =
-                writeConflictRetry(opCtx, "listIndexes", ns.ns(), [&cce, &opCtx, &indexNames, i] {
-                    return cce->getIndexSpec(opCtx, indexNames[i]);
-                });
-
+        for (auto&& indexSpec : indexSpecs) {
             WorkingSetID id = ws->allocate();
             WorkingSetMember* member = ws->get(id);
             member->keyData.clear();
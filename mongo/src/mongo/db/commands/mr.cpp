@@ -32,6 +32,8 @@
 
 #include "mongo/db/commands/mr.h"
 
+#include <regex>
+
 #include "mongo/base/status_with.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/connpool.h"
@@ -55,6 +57,10 @@
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/ops/insert.h"
+#include "mongo/db/pipeline/aggregation_request.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/pipeline/pipeline_d.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
@@ -64,7 +70,9 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/client/parallel.h"
 #include "mongo/s/client/shard_connection.h"
@@ -77,6 +85,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -95,6 +104,10 @@ namespace mr {
 
 AtomicUInt32 Config::JOB_NUMBER;
 
+// Whether mapReduce commands whose functions follow simple patterns are translated into and run
+// as an aggregation pipeline instead of through the JavaScript engine.
+MONGO_EXPORT_SERVER_PARAMETER(internalMapReduceUseAggregation, bool, true);
+
 JSFunction::JSFunction(const std::string& type, const BSONElement& e) {
     _type = type;
     _code = e._asCode();
@@ -1344,6 +1357,165 @@ BSONObj _bailFromJS(const BSONObj& args, void* data) {
     return BSONObj();
 }
 
+namespace {
+
+// Map and reduce functions translatable to aggregation. The map function must emit a top-level
+// field of the document with an integer literal, and the reduce function must sum its values.
+// Integer literals are bounded so that summing them as doubles, as JavaScript does, is exact.
+const std::regex kSumMapFunctionRegex(
+    "^\\s*function\\s*\\(\\s*\\)\\s*\\{\\s*emit\\s*\\(\\s*this\\.([A-Za-z_][A-Za-z0-9_]*)\\s*,"
+    "\\s*(0|-?[1-9][0-9]{0,5})\\s*\\)\\s*;?\\s*\\}\\s*$");
+const std::regex kSumReduceFunctionRegex(
+    "^\\s*function\\s*\\(\\s*[A-Za-z_$][A-Za-z0-9_$]*\\s*,\\s*([A-Za-z_$][A-Za-z0-9_$]*)\\s*\\)"
+    "\\s*\\{\\s*return\\s+Array\\.sum\\s*\\(\\s*\\1\\s*\\)\\s*;?\\s*\\}\\s*$");
+
+/**
+ * Returns the source of the function 'elem', unless it is not plain code. Code with scope is
+ * rejected, since its scope may shadow the names the translation relies on.
+ */
+boost::optional<std::string> getFunctionSource(const BSONElement& elem) {
+    if (elem.type() != String && elem.type() != Code) {
+        return boost::none;
+    }
+    return elem.str();
+}
+
+/**
+ * Runs the translated 'pipeline' of an inline mapReduce and appends the same results and counts
+ * that the JavaScript implementation would. Returns false, having appended nothing, if the
+ * collection turns out to have properties the translation does not account for.
+ */
+bool runMapReduceAsAggregation(OperationContext* opCtx,
+                               const Config& config,
+                               const std::vector<BSONObj>& pipeline,
+                               const Timer& timer,
+                               BSONObjBuilder& result) {
+    AggregationRequest request(config.nss, pipeline);
+    request.setAllowDiskUse(true);
+    boost::intrusive_ptr<ExpressionContext> expCtx(
+        new ExpressionContext(opCtx, request, nullptr, {}));
+    expCtx->tempDir = storageGlobalParams.dbpath + "/_tmp";
+
+    auto parsedPipeline = uassertStatusOK(Pipeline::parse(pipeline, expCtx));
+    parsedPipeline->optimizePipeline();
+    {
+        AutoGetCollectionForReadCommand autoColl(opCtx, config.nss);
+        Collection* collection = autoColl.getCollection();
+
+        // mapReduce filters with the collection's default collation but groups keys by their
+        // binary representation, which a single aggregation collation cannot express.
+        if (!collection || collection->getDefaultCollator() ||
+            CollectionShardingState::get(opCtx, config.nss)->getMetadata()) {
+            return false;
+        }
+        PipelineD::prepareCursorSource(collection, config.nss, &request, parsedPipeline.get());
+    }
+    parsedPipeline->optimizePipeline();
+
+    long long numInputs = 0;
+    long long numReduces = 0;
+    long long numOutputs = 0;
+    BSONArrayBuilder resultsBuilder(result.subarrayStart("results"));
+    while (auto next = parsedPipeline->getNext()) {
+        const long long numEmits = next->getField("n").coerceToLong();
+        numInputs += numEmits;
+        numReduces += numEmits > 1 ? 1 : 0;
+        ++numOutputs;
+
+        BSONObjBuilder outputBuilder(resultsBuilder.subobjStart());
+        next->getField("_id").addToBsonObj(&outputBuilder, "_id");
+        next->getField("value").addToBsonObj(&outputBuilder, "value");
+        outputBuilder.doneFast();
+        uassert(13604,
+                "too much data for in memory map/reduce",
+                resultsBuilder.len() < BSONObjMaxUserSize);
+    }
+    resultsBuilder.doneFast();
+
+    result.appendNumber("timeMillis", timer.millis());
+    if (config.verbose) {
+        result.append("timing",
+                      BSON("mode"
+                           << "aggregation"
+                           << "total"
+                           << timer.millis()));
+    }
+    result.append("counts",
+                  BSON("input" << numInputs << "emit" << numInputs << "reduce" << numReduces
+                               << "output"
+                               << numOutputs));
+    return true;
+}
+
+/**
+ * Returns true if 'filter' may use a query operator, such as $where or $near, which the JavaScript
+ * implementation accepts but $match does not. A value which merely looks like one counts too,
+ * which only means the command is evaluated through JavaScript.
+ */
+bool usesOperatorsDisallowedInMatch(const BSONObj& filter) {
+    for (auto&& elem : filter) {
+        const StringData name = elem.fieldNameStringData();
+        if (name == "$where" || name == "$near" || name == "$nearSphere") {
+            return true;
+        }
+        if (elem.isABSONObj() && usesOperatorsDisallowedInMatch(elem.embeddedObject())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+boost::optional<std::vector<BSONObj>> translateToAggregationPipeline(const Config& config,
+                                                                     const BSONObj& cmdObj) {
+    if (config.outputOptions.outType != Config::INMEMORY || config.finalizer ||
+        !config.scopeSetup.isEmpty() || !config.mapParams.isEmpty() ||
+        !config.collation.isEmpty() || config.shardedFirstPass || config.splitInfo > 0 ||
+        config.limit < 0 || usesOperatorsDisallowedInMatch(config.filter)) {
+        return boost::none;
+    }
+
+    const auto mapSource = getFunctionSource(cmdObj["map"]);
+    const auto reduceSource = getFunctionSource(cmdObj["reduce"]);
+    std::smatch mapMatch;
+    if (!mapSource || !reduceSource ||
+        !std::regex_match(*mapSource, mapMatch, kSumMapFunctionRegex) ||
+        !std::regex_match(*reduceSource, kSumReduceFunctionRegex)) {
+        return boost::none;
+    }
+    const std::string keyPath = "$" + mapMatch[1].str();
+    const double emittedValue = std::stod(mapMatch[2].str());
+
+    std::vector<BSONObj> pipeline;
+    if (!config.filter.isEmpty()) {
+        pipeline.push_back(BSON("$match" << config.filter));
+    }
+    if (!config.sort.isEmpty()) {
+        pipeline.push_back(BSON("$sort" << config.sort));
+    }
+    if (config.limit > 0) {
+        pipeline.push_back(BSON("$limit" << config.limit));
+    }
+
+    // Keys and values make a round trip through JavaScript numbers, so an int key is emitted as a
+    // double. A missing key, emitted as undefined, is stored as null just as $group does.
+    const BSONObj groupKey =
+        BSON("$cond" << BSON("if" << BSON("$eq" << BSON_ARRAY(BSON("$type" << keyPath) << "int"))
+                                  << "then"
+                                  << BSON("$add" << BSON_ARRAY(keyPath << 0.0))
+                                  << "else"
+                                  << keyPath));
+    pipeline.push_back(BSON("$group" << BSON("_id" << groupKey << "value"
+                                                   << BSON("$sum" << emittedValue)
+                                                   << "n"
+                                                   << BSON("$sum" << 1))));
+
+    // Inline results are returned in key order.
+    pipeline.push_back(BSON("$sort" << BSON("_id" << 1)));
+    return pipeline;
+}
+
 /**
  * This class represents a map/reduce command executed on a single server
  */
@@ -1406,6 +1578,15 @@ public:
 
         LOG(1) << "mr ns: " << config.nss;
 
+        if (internalMapReduceUseAggregation.load()) {
+            if (auto pipeline = translateToAggregationPipeline(config, cmd)) {
+                LOG(1) << "mr evaluating as an aggregation pipeline";
+                if (runMapReduceAsAggregation(opCtx, config, *pipeline, t, result)) {
+                    return true;
+                }
+            }
+        }
+
         uassert(16149, "cannot run map reduce without the js engine", getGlobalScriptEngine());
 
         // Prevent sharding state from changing during the MR.
@@ -1597,7 +1778,7 @@ public:
 
                 Collection* coll = scopedAutoDb->getDb()->getCollection(opCtx, config.nss);
                 invariant(coll);  // 'exec' hasn't been killed, so collection must be alive.
-                coll->infoCache()->notifyOfQuery(opCtx, stats.indexesUsed);
+                coll->infoCache()->notifyOfQuery(opCtx, stats);
 
                 if (curOp->shouldDBProfile()) {
                     BSONObjBuilder execStatsBob;
@@ -413,6 +413,19 @@ protected:
 BSONObj fast_emit(const BSONObj& args, void* data);
 BSONObj _bailFromJS(const BSONObj& args, void* data);
 
+/**
+ * Returns an aggregation pipeline equivalent to the mapReduce command 'cmdObj', parsed as 'config',
+ * or boost::none if it cannot be evaluated without JavaScript. Only inline mapReduce with a map
+ * function of the form 'function() { emit(this.<field>, <integer>); }', a reduce function of the
+ * form 'function(key, values) { return Array.sum(values); }', no finalize function, no scope, no
+ * collation and a query $match accepts is translated.
+ *
+ * The pipeline ends with a $group, sorted by _id, whose documents hold the reduced 'value' along
+ * with the number of emits 'n' for each key, from which the mapReduce counts are derived.
+ */
+boost::optional<std::vector<BSONObj>> translateToAggregationPipeline(const Config& config,
+                                                                     const BSONObj& cmdObj);
+
 void addPrivilegesRequiredForMapReduce(Command* commandTemplate,
                                        const std::string& dbname,
                                        const BSONObj& cmdObj,
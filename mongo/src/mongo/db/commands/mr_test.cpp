@@ -255,4 +255,88 @@ TEST(ConfigTest, CollationNotAnObjectFailsToParse) {
     ASSERT_THROWS(mr::Config(dbname, cmdObj), AssertionException);
 }
 
+/**
+ * Tests for mr::translateToAggregationPipeline
+ */
+
+boost::optional<std::vector<BSONObj>> translate(const std::string& cmdObjStr) {
+    BSONObj cmdObj = fromjson(cmdObjStr);
+    mr::Config config("myDB", cmdObj);
+    return mr::translateToAggregationPipeline(config, cmdObj);
+}
+
+TEST(TranslateToAggregationPipelineTest, CountByFieldIsTranslated) {
+    auto pipeline = translate(
+        "{mapReduce: 'coll', map: 'function() { emit(this.cat, 1); }', "
+        "reduce: 'function(key, values) { return Array.sum(values); }', out: {inline: 1}, "
+        "query: {a: 1}, sort: {b: 1}, limit: 5}");
+    ASSERT(pipeline);
+    ASSERT_EQ(pipeline->size(), 5U);
+    ASSERT_BSONOBJ_EQ((*pipeline)[0], fromjson("{$match: {a: 1}}"));
+    ASSERT_BSONOBJ_EQ((*pipeline)[1], fromjson("{$sort: {b: 1}}"));
+    ASSERT_BSONOBJ_EQ((*pipeline)[2], BSON("$limit" << 5LL));
+    ASSERT_BSONOBJ_EQ((*pipeline)[3]["$group"]["value"].Obj(), BSON("$sum" << 1.0));
+    ASSERT_BSONOBJ_EQ((*pipeline)[3]["$group"]["n"].Obj(), BSON("$sum" << 1));
+    ASSERT_BSONOBJ_EQ((*pipeline)[4], fromjson("{$sort: {_id: 1}}"));
+}
+
+TEST(TranslateToAggregationPipelineTest, CodeTypedFunctionsAreTranslated) {
+    BSONObjBuilder bob;
+    bob.append("mapReduce", "coll");
+    bob.appendCode("map", "function(){emit(this.x,-3)}");
+    bob.appendCode("reduce", "function(k,v){return Array.sum(v)}");
+    bob.append("out", BSON("inline" << 1));
+    BSONObj cmdObj = bob.obj();
+    mr::Config config("myDB", cmdObj);
+    auto pipeline = mr::translateToAggregationPipeline(config, cmdObj);
+    ASSERT(pipeline);
+    ASSERT_EQ(pipeline->size(), 2U);
+    ASSERT_BSONOBJ_EQ((*pipeline)[0]["$group"]["value"].Obj(), BSON("$sum" << -3.0));
+}
+
+TEST(TranslateToAggregationPipelineTest, UnsupportedCommandsAreNotTranslated) {
+    const std::string map = "map: 'function() { emit(this.cat, 1); }'";
+    const std::string reduce = "reduce: 'function(key, values) { return Array.sum(values); }'";
+    const std::string sumCmd = "{mapReduce: 'coll', " + map + ", " + reduce;
+
+    // Output to a collection, finalize, scope and collation.
+    ASSERT_FALSE(translate(sumCmd + ", out: 'outColl'}"));
+    ASSERT_FALSE(
+        translate(sumCmd + ", out: {inline: 1}, finalize: 'function(k, v) { return v; }'}"));
+    ASSERT_FALSE(translate(sumCmd + ", out: {inline: 1}, scope: {x: 1}}"));
+    ASSERT_FALSE(translate(sumCmd + ", out: {inline: 1}, collation: {locale: 'en_US'}}"));
+
+    // Map functions emitting nested fields, non-literal values or more than once.
+    ASSERT_FALSE(translate("{mapReduce: 'coll', map: 'function() { emit(this.a.b, 1); }', " +
+                           reduce + ", out: {inline: 1}}"));
+    ASSERT_FALSE(translate("{mapReduce: 'coll', map: 'function() { emit(this.a, this.b); }', " +
+                           reduce + ", out: {inline: 1}}"));
+    ASSERT_FALSE(translate("{mapReduce: 'coll', map: 'function() { emit(this.a, 1.5); }', " +
+                           reduce + ", out: {inline: 1}}"));
+    ASSERT_FALSE(translate(
+        "{mapReduce: 'coll', map: 'function() { emit(this.a, 1); emit(this.b, 1); }', " + reduce +
+        ", out: {inline: 1}}"));
+
+    // Reduce functions other than a sum of the values.
+    ASSERT_FALSE(translate("{mapReduce: 'coll', " + map +
+                           ", reduce: 'function(k, v) { return v.length; }', out: {inline: 1}}"));
+    ASSERT_FALSE(translate("{mapReduce: 'coll', " + map +
+                           ", reduce: 'function(k, v) { return Array.sum(k); }', "
+                           "out: {inline: 1}}"));
+}
+
+TEST(TranslateToAggregationPipelineTest, QueriesMatchDoesNotAllowAreNotTranslated) {
+    const std::string sumCmd =
+        "{mapReduce: 'coll', map: 'function() { emit(this.cat, 1); }', "
+        "reduce: 'function(key, values) { return Array.sum(values); }', out: {inline: 1}, ";
+
+    ASSERT_FALSE(translate(sumCmd + "query: {$where: 'this.a > 1'}}"));
+    ASSERT_FALSE(translate(sumCmd + "query: {loc: {$near: [0, 0]}}}"));
+    ASSERT_FALSE(translate(sumCmd + "query: {loc: {$nearSphere: [0, 0]}, a: 1}}"));
+    ASSERT_FALSE(translate(sumCmd + "query: {$or: [{a: 1}, {$where: 'this.b > 1'}]}}"));
+
+    ASSERT(translate(sumCmd + "query: {$or: [{a: 1}, {b: {$gt: 1}}]}}"));
+    ASSERT(translate(sumCmd + "query: {loc: {$geoWithin: {$center: [[0, 0], 1]}}}}"));
+}
+
 }  // namespace
@@ -126,7 +126,7 @@ public:
             iterators.push_back(collection->getCursor(opCtx));
             numCursors = 1;
         } else {
-            iterators = collection->getManyCursors(opCtx);
+            iterators = collection->getPartitionedCursors(opCtx, numCursors);
             if (iterators.size() < numCursors) {
                 numCursors = iterators.size();
             }
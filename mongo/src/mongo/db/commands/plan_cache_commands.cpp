@@ -38,9 +38,11 @@
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands/plan_cache_commands.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/namespace_string.h"
@@ -92,6 +94,8 @@ MONGO_INITIALIZER_WITH_PREREQUISITES(SetupPlanCacheCommands, MONGO_NO_PREREQUISI
     new PlanCacheListQueryShapes();
     new PlanCacheClear();
     new PlanCacheListPlans();
+    new QueryShapeStatsList();
+    new QueryShapeStatsRecommendIndexes();
 
     return Status::OK();
 }
@@ -449,4 +453,110 @@ Status PlanCacheListPlans::list(OperationContext* opCtx,
     return Status::OK();
 }
 
+QueryShapeStatsList::QueryShapeStatsList()
+    : PlanCacheCommand("queryShapeStats",
+                       "Displays execution statistics for each query shape in a collection.",
+                       ActionType::planCacheRead) {}
+
+Status QueryShapeStatsList::runPlanCacheCommand(OperationContext* opCtx,
+                                                const string& ns,
+                                                const BSONObj& cmdObj,
+                                                BSONObjBuilder* bob) {
+    AutoGetCollectionForReadCommand ctx(opCtx, NamespaceString(ns));
+
+    Collection* collection = ctx.getCollection();
+    if (!collection) {
+        // No collection - return results with empty shapes array.
+        BSONArrayBuilder arrayBuilder(bob->subarrayStart("shapes"));
+        arrayBuilder.doneFast();
+        return Status::OK();
+    }
+    return list(*collection->infoCache()->getQueryShapeStats(), bob);
+}
+
+// static
+Status QueryShapeStatsList::list(const QueryShapeStats& shapeStats, BSONObjBuilder* bob) {
+    invariant(bob);
+
+    BSONArrayBuilder arrayBuilder(bob->subarrayStart("shapes"));
+    for (auto&& entry : shapeStats.getAllEntries()) {
+        BSONObjBuilder shapeBuilder(arrayBuilder.subobjStart());
+        entry.appendToBSON(&shapeBuilder);
+        shapeBuilder.doneFast();
+    }
+    arrayBuilder.doneFast();
+
+    return Status::OK();
+}
+
+QueryShapeStatsRecommendIndexes::QueryShapeStatsRecommendIndexes()
+    : PlanCacheCommand("indexRecommendations",
+                       "Proposes indexes that would reduce the documents examined by the query "
+                       "shapes in a collection.",
+                       ActionType::planCacheRead) {}
+
+Status QueryShapeStatsRecommendIndexes::runPlanCacheCommand(OperationContext* opCtx,
+                                                            const string& ns,
+                                                            const BSONObj& cmdObj,
+                                                            BSONObjBuilder* bob) {
+    AutoGetCollectionForReadCommand ctx(opCtx, NamespaceString(ns));
+
+    Collection* collection = ctx.getCollection();
+    if (!collection) {
+        // No collection - return results with empty recommendations array.
+        BSONArrayBuilder arrayBuilder(bob->subarrayStart("recommendations"));
+        arrayBuilder.doneFast();
+        return Status::OK();
+    }
+
+    // Indexes still being built are included so that they are not recommended again. Partial
+    // indexes are left out, as they may not serve every query on their key pattern.
+    vector<BSONObj> existingKeyPatterns;
+    IndexCatalog::IndexIterator ii = collection->getIndexCatalog()->getIndexIterator(opCtx, true);
+    while (ii.more()) {
+        const IndexDescriptor* desc = ii.next();
+        if (!desc->isPartial()) {
+            existingKeyPatterns.push_back(desc->keyPattern());
+        }
+    }
+
+    return recommend(*collection->infoCache()->getQueryShapeStats(), existingKeyPatterns, bob);
+}
+
+// static
+Status QueryShapeStatsRecommendIndexes::recommend(const QueryShapeStats& shapeStats,
+                                                  const vector<BSONObj>& existingKeyPatterns,
+                                                  BSONObjBuilder* bob) {
+    invariant(bob);
+
+    // Each recommendation lists only the shapes that examined the most documents, to keep the
+    // reply well under the maximum document size.
+    const size_t kMaxShapesPerRecommendation = 10;
+
+    BSONArrayBuilder arrayBuilder(bob->subarrayStart("recommendations"));
+    for (auto&& recommendation : shapeStats.recommendIndexes(existingKeyPatterns)) {
+        BSONObjBuilder recommendationBuilder(arrayBuilder.subobjStart());
+        recommendationBuilder.append("keyPattern", recommendation.keyPattern);
+        recommendationBuilder.appendNumber("execCount", recommendation.execCount);
+        recommendationBuilder.appendNumber("totalDocsExamined", recommendation.totalDocsExamined);
+        recommendationBuilder.appendNumber("totalReturned", recommendation.totalReturned);
+        recommendationBuilder.appendNumber("numShapes",
+                                           static_cast<long long>(recommendation.shapes.size()));
+
+        const size_t numShapesShown =
+            std::min(recommendation.shapes.size(), kMaxShapesPerRecommendation);
+        BSONArrayBuilder shapesBuilder(recommendationBuilder.subarrayStart("shapes"));
+        for (size_t i = 0; i < numShapesShown; ++i) {
+            BSONObjBuilder shapeBuilder(shapesBuilder.subobjStart());
+            recommendation.shapes[i].appendToBSON(&shapeBuilder);
+            shapeBuilder.doneFast();
+        }
+        shapesBuilder.doneFast();
+        recommendationBuilder.doneFast();
+    }
+    arrayBuilder.doneFast();
+
+    return Status::OK();
+}
+
 }  // namespace mongo
@@ -30,6 +30,7 @@
 
 #include "mongo/db/commands.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/query_shape_stats.h"
 
 namespace mongo {
 
@@ -182,4 +183,50 @@ public:
                        BSONObjBuilder* bob);
 };
 
+/**
+ * queryShapeStats
+ *
+ * { queryShapeStats: <collection> }
+ *
+ * Displays the execution statistics collected for each query shape run on a collection.
+ */
+class QueryShapeStatsList : public PlanCacheCommand {
+public:
+    QueryShapeStatsList();
+    virtual Status runPlanCacheCommand(OperationContext* opCtx,
+                                       const std::string& ns,
+                                       const BSONObj& cmdObj,
+                                       BSONObjBuilder* bob);
+
+    /**
+     * Inserts the statistics of every tracked shape into BSON builder.
+     */
+    static Status list(const QueryShapeStats& shapeStats, BSONObjBuilder* bob);
+};
+
+/**
+ * indexRecommendations
+ *
+ * { indexRecommendations: <collection> }
+ *
+ * Proposes indexes that would reduce the number of documents examined by the query shapes
+ * recorded for a collection.
+ */
+class QueryShapeStatsRecommendIndexes : public PlanCacheCommand {
+public:
+    QueryShapeStatsRecommendIndexes();
+    virtual Status runPlanCacheCommand(OperationContext* opCtx,
+                                       const std::string& ns,
+                                       const BSONObj& cmdObj,
+                                       BSONObjBuilder* bob);
+
+    /**
+     * Inserts the recommendations for 'shapeStats', given the key patterns of the collection's
+     * indexes, into BSON builder.
+     */
+    static Status recommend(const QueryShapeStats& shapeStats,
+                            const std::vector<BSONObj>& existingKeyPatterns,
+                            BSONObjBuilder* bob);
+};
+
 }  // namespace mongo
@@ -0,0 +1,220 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "mongo/bson/bsonobj_comparator.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/storage/record_store.h"
+
+namespace mongo {
+
+using std::string;
+
+namespace {
+
+const long long kMaxPartitions = 10000;
+const long long kDefaultSamplesPerPartition = 16;
+const long long kMaxSamplesPerPartition = 1000;
+
+/**
+ * Splits a collection into roughly equal _id ranges so that a client can read it with several
+ * cursors at once.
+ *
+ * Format:
+ * {
+ *   planCollectionPartitions: <collection name>,
+ *   numPartitions: <number of ranges wanted>,
+ *   samplesPerPartition: <optional, _id values sampled per range, default 16>
+ * }
+ *
+ * Return format:
+ * {
+ *   partitions: [ {max: {_id: b1}}, {min: {_id: b1}, max: {_id: b2}}, ..., {min: {_id: bk}} ],
+ *   sampled: <number of documents sampled>
+ * }
+ *
+ * Every partition is meant to be read with a find on the _id index using its 'min' (inclusive)
+ * and 'max' (exclusive) as index bounds, which unlike a $gte/$lt filter are not type bracketed.
+ * The ranges are contiguous and together cover the whole collection. Boundaries are chosen from
+ * documents sampled through the storage engine's random cursor, so planning costs a bounded
+ * number of random reads rather than a scan. Fewer partitions than requested are returned when
+ * the collection is small, has no _id index, or its storage engine cannot sample.
+ */
+class CmdPlanCollectionPartitions : public BasicCommand {
+public:
+    CmdPlanCollectionPartitions() : BasicCommand("planCollectionPartitions") {}
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    bool slaveOk() const override {
+        return true;
+    }
+
+    void help(std::stringstream& help) const override {
+        help << "splits a collection into _id ranges that can be read in parallel\n"
+                "{ planCollectionPartitions: <collection>, numPartitions: <n> }";
+    }
+
+    Status checkAuthForOperation(OperationContext* opCtx,
+                                 const std::string& dbname,
+                                 const BSONObj& cmdObj) override {
+        AuthorizationSession* authSession = AuthorizationSession::get(opCtx->getClient());
+
+        if (!authSession->isAuthorizedToParseNamespaceElement(cmdObj.firstElement())) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+
+        const NamespaceString ns(parseNsOrUUID(opCtx, dbname, cmdObj));
+        if (!authSession->isAuthorizedForActionsOnNamespace(ns, ActionType::find)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+
+        return Status::OK();
+    }
+
+    bool run(OperationContext* opCtx,
+             const string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const long long numPartitions = cmdObj["numPartitions"].numberLong();
+        if (numPartitions < 1 || numPartitions > kMaxPartitions) {
+            return appendCommandStatus(
+                result,
+                Status(ErrorCodes::BadValue,
+                       str::stream() << "numPartitions has to be between 1 and " << kMaxPartitions
+                                     << " was: "
+                                     << numPartitions));
+        }
+
+        long long samplesPerPartition = kDefaultSamplesPerPartition;
+        if (cmdObj.hasField("samplesPerPartition")) {
+            samplesPerPartition = cmdObj["samplesPerPartition"].numberLong();
+            if (samplesPerPartition < 1 || samplesPerPartition > kMaxSamplesPerPartition) {
+                return appendCommandStatus(
+                    result,
+                    Status(ErrorCodes::BadValue,
+                           str::stream() << "samplesPerPartition has to be between 1 and "
+                                         << kMaxSamplesPerPartition
+                                         << " was: "
+                                         << samplesPerPartition));
+            }
+        }
+
+        Lock::DBLock dbSLock(opCtx, dbname, MODE_IS);
+        const NamespaceString ns(parseNsOrUUID(opCtx, dbname, cmdObj));
+
+        AutoGetCollectionForReadCommand ctx(opCtx, ns, std::move(dbSLock));
+
+        Collection* collection = ctx.getCollection();
+        if (!collection)
+            return appendCommandStatus(result,
+                                       Status(ErrorCodes::NamespaceNotFound,
+                                              str::stream() << "ns does not exist: " << ns.ns()));
+
+        std::vector<BSONObj> boundaries;
+        long long sampled = 0;
+        if (numPartitions > 1 && collection->getIndexCatalog()->findIdIndex(opCtx)) {
+            const long long wanted =
+                std::min(numPartitions * samplesPerPartition,
+                         static_cast<long long>(collection->numRecords(opCtx)));
+            if (auto cursor = collection->getRecordStore()->getRandomCursor(opCtx)) {
+                std::vector<BSONObj> ids;
+                while (sampled < wanted) {
+                    auto record = cursor->next();
+                    if (!record) {
+                        break;
+                    }
+                    ++sampled;
+                    const BSONObj doc = record->data.releaseToBson();
+                    BSONElement id = doc["_id"];
+                    if (!id.eoo()) {
+                        ids.push_back(id.wrap());
+                    }
+                }
+                boundaries = _chooseBoundaries(
+                    std::move(ids), numPartitions, collection->getDefaultCollator());
+            }
+        }
+
+        BSONArrayBuilder partitions(result.subarrayStart("partitions"));
+        for (size_t i = 0; i <= boundaries.size(); ++i) {
+            BSONObjBuilder partition(partitions.subobjStart());
+            if (i > 0) {
+                partition.append("min", boundaries[i - 1]);
+            }
+            if (i < boundaries.size()) {
+                partition.append("max", boundaries[i]);
+            }
+        }
+        partitions.doneFast();
+        result.appendNumber("sampled", sampled);
+        return true;
+    }
+
+private:
+    /**
+     * Picks up to numPartitions - 1 distinct split points from the sampled {_id: value} objects,
+     * ordered as the _id index orders them.
+     */
+    static std::vector<BSONObj> _chooseBoundaries(std::vector<BSONObj> ids,
+                                                  long long numPartitions,
+                                                  const CollatorInterface* collator) {
+        BSONObjComparator comparator(
+            BSONObj(), BSONObjComparator::FieldNamesMode::kIgnore, collator);
+        std::sort(ids.begin(), ids.end(), comparator.makeLessThan());
+        ids.erase(std::unique(ids.begin(), ids.end(), comparator.makeEqualTo()), ids.end());
+
+        // Samples are distinct after the unique pass, so distinct indexes give strictly
+        // increasing boundaries.
+        std::vector<BSONObj> boundaries;
+        size_t lastIndex = 0;
+        for (long long i = 1; i < numPartitions; ++i) {
+            const size_t index = static_cast<size_t>(i * ids.size() / numPartitions);
+            if (index > lastIndex) {
+                boundaries.push_back(ids[index]);
+                lastIndex = index;
+            }
+        }
+        return boundaries;
+    }
+} cmdPlanCollectionPartitions;
+
+}  // namespace
+}  // namespace mongo
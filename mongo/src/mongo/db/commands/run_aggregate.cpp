@@ -342,6 +342,10 @@ Status runAggregate(OperationContext* opCtx,
                                  "readConcern levels"};
     }
 
+    if (request.getExplain()) {
+        CurOp::get(opCtx)->setIsExplain();
+    }
+
     // The collation to use for this aggregation. boost::optional to distinguish between the case
     // where the collation has not yet been resolved, and where it has been resolved to nullptr.
     boost::optional<std::unique_ptr<CollatorInterface>> collatorToUse;
@@ -32,12 +32,15 @@
 #include "mongo/db/catalog/coll_mod.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/feature_compatibility_version.h"
 #include "mongo/db/commands/feature_compatibility_version_command_parser.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/hasher.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/keys_collection_document.h"
 #include "mongo/db/logical_time_validator.h"
 #include "mongo/db/repl/repl_client_info.h"
@@ -45,6 +48,7 @@
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/catalog/sharding_catalog_client_impl.h"
 #include "mongo/s/catalog/sharding_catalog_manager.h"
@@ -59,6 +63,44 @@ namespace {
 
 MONGO_FP_DECLARE(featureCompatibilityDowngrade);
 MONGO_FP_DECLARE(featureCompatibilityUpgrade);
+
+/**
+ * Returns the namespace and name of a hashed index that uses MurmurHash3 (hashVersion 1), or
+ * boost::none if there isn't one. Binaries that don't support MurmurHash3 fail to build the keys
+ * for such an index, so they must all be dropped before downgrading.
+ */
+boost::optional<std::string> findMurmur3HashedIndex(OperationContext* opCtx) {
+    std::vector<std::string> dbNames;
+    StorageEngine* storageEngine = opCtx->getServiceContext()->getGlobalStorageEngine();
+    {
+        Lock::GlobalLock lk(opCtx, MODE_IS, UINT_MAX);
+        storageEngine->listDatabases(&dbNames);
+    }
+
+    for (auto&& dbName : dbNames) {
+        AutoGetDb autoDb(opCtx, dbName, MODE_IS);
+        Database* const db = autoDb.getDb();
+        if (!db) {
+            continue;
+        }
+
+        for (auto&& coll : *db) {
+            Lock::CollectionLock collLock(opCtx->lockState(), coll->ns().ns(), MODE_IS);
+            IndexCatalog::IndexIterator it =
+                coll->getIndexCatalog()->getIndexIterator(opCtx, true /* includeUnfinished */);
+            while (it.more()) {
+                const IndexDescriptor* desc = it.next();
+                auto hashVersionElem = desc->infoObj()[IndexDescriptor::kHashVersionFieldName];
+                if (hashVersionElem.isNumber() &&
+                    hashVersionElem.numberInt() == BSONElementHasher::MURMUR3_HASH_VERSION) {
+                    return std::string(str::stream() << "'" << desc->indexName() << "' on "
+                                                     << coll->ns().ns());
+                }
+            }
+        }
+    }
+    return boost::none;
+}
 /**
  * Sets the minimum allowed version for the cluster. If it is 3.4, then the node should not use 3.6
  * features.
@@ -206,6 +248,20 @@ public:
 
             FeatureCompatibilityVersion::setTargetDowngrade(opCtx);
 
+            // Now that the featureCompatibilityVersion is no longer 3.6, no new hashVersion 1
+            // indexes can be created, so it is safe to check for existing ones.
+            if (auto murmur3Index = findMurmur3HashedIndex(opCtx)) {
+                uasserted(ErrorCodes::IllegalOperation,
+                          str::stream() << "cannot downgrade featureCompatibilityVersion while "
+                                           "hashed indexes with "
+                                        << IndexDescriptor::kHashVersionFieldName
+                                        << " "
+                                        << BSONElementHasher::MURMUR3_HASH_VERSION
+                                        << " exist; drop the index "
+                                        << *murmur3Index
+                                        << " and rerun the downgrade");
+            }
+
             // Fail after updating the FCV document but before removing UUIDs.
             if (MONGO_FAIL_POINT(featureCompatibilityDowngrade)) {
                 exitCleanly(EXIT_CLEAN);
@@ -75,7 +75,9 @@ public:
              "Slow.\n"
              "Add full:true option to do a more thorough check\n"
              "Add scandata:false to skip the scan of the collection data without skipping scans "
-             "of any indexes";
+             "of any indexes\n"
+             "Add background:true to validate a snapshot under intent locks while reads and "
+             "writes continue (not with full:true)";
     }
 
     virtual bool supportsWriteConcern(const BSONObj& cmd) const override {
@@ -123,8 +125,19 @@ public:
             LOG(0) << "CMD: validate " << nss.ns();
         }
 
-        AutoGetDb ctx(opCtx, nss.db(), MODE_IX);
-        auto collLk = stdx::make_unique<Lock::CollectionLock>(opCtx->lockState(), nss.ns(), MODE_X);
+        const bool background = cmdObj["background"].trueValue();
+        if (full && background) {
+            appendCommandStatus(result,
+                                {ErrorCodes::CommandFailed,
+                                 "A full validate cannot run in the background, use full:false"});
+            return false;
+        }
+
+        // A background validation reads one storage snapshot of the collection and its indexes,
+        // so it only needs to keep the collection and its indexes from being dropped.
+        AutoGetDb ctx(opCtx, nss.db(), background ? MODE_IS : MODE_IX);
+        auto collLk = stdx::make_unique<Lock::CollectionLock>(
+            opCtx->lockState(), nss.ns(), background ? MODE_IS : MODE_X);
         Collection* collection = ctx.getDb() ? ctx.getDb()->getCollection(opCtx, nss) : NULL;
         if (!collection) {
             if (ctx.getDb() && ctx.getDb()->getViewCatalog()->lookup(opCtx, nss.ns())) {
@@ -136,19 +149,7 @@ public:
             return false;
         }
 
-        // Omit background validation logic until it is fully implemented and vetted.
-        const bool background = false;
-        /*
-        bool isInRecordIdOrder = collection->getRecordStore()->isInRecordIdOrder();
-        if (isInRecordIdOrder && !full) {
-            background = true;
-        }
-
-        if (cmdObj.hasElement("background")) {
-            background = cmdObj["background"].trueValue();
-        }
-
-        if (!isInRecordIdOrder && background) {
+        if (background && !collection->getRecordStore()->isInRecordIdOrder()) {
             appendCommandStatus(result,
                                 {ErrorCodes::CommandFailed,
                                  "This storage engine does not support the background option, use "
@@ -156,14 +157,6 @@ public:
             return false;
         }
 
-        if (full && background) {
-            appendCommandStatus(result,
-                                {ErrorCodes::CommandFailed,
-                                 "A full validate cannot run in the background, use full:false"});
-            return false;
-        }
-        */
-
         result.append("ns", nss.ns());
 
         // Only one validation per collection can be in progress, the rest wait in order.
@@ -141,6 +141,11 @@ private:
     // The lockheads need access to the partitions
     friend struct LockHead;
 
+    // Size of the padding placed after each bucket and partition in their arrays. Both are
+    // allocated contiguously and their mutexes are touched on every lock and unlock, so without
+    // padding unrelated lockers would invalidate each other's cache lines.
+    static const size_t kCacheLineSize = 64;
+
     // These types describe the locks hash table
     //LockManager._lockBuckets
     //ÿBucketResourceId->LockHeadĹϣùϣBucketеmutex
@@ -152,6 +157,9 @@ private:
         typedef unordered_map<ResourceId, LockHead*> Map;
         Map data; //data<ResourceId, LockHead*>
         LockHead* findOrInsert(ResourceId resId);
+
+        // Keeps the mutexes of neighbouring buckets off the same cache line.
+        char padding[kCacheLineSize];
     };
 
     // Each locker maps to a partition that is used for resources acquired in intent modes
@@ -166,6 +174,10 @@ private:
         SimpleMutex mutex;
         //LockManager::Partition::find  LockManager::Partition::findOrInsert
         Map data; //dataΪ<ResourceId, PartitionedLockHead>  
+
+        // Keeps the mutexes of neighbouring partitions off the same cache line, so that lockers
+        // taking intent locks in different partitions do not slow each other down.
+        char padding[kCacheLineSize];
     };
 
     /**
@@ -0,0 +1,87 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/lock_manager.h"
+#include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/db/concurrency/lock_state.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+const ResourceId kDatabaseId(RESOURCE_DATABASE, std::string("test"));
+const ResourceId kCollectionId(RESOURCE_COLLECTION, std::string("test.coll"));
+
+// Grants and releases a lock on a private LockManager, without any Locker bookkeeping.
+void BM_lockManagerLockUnlock(benchmark::State& state) {
+    LockManager lockManager;
+    DefaultLockerImpl locker;
+    TrackingLockGrantNotification notify;
+    LockRequest request;
+    request.initNew(&locker, &notify);
+
+    while (state.keepRunning()) {
+        invariant(lockManager.lock(kCollectionId, &request, MODE_IS) == LOCK_OK);
+        lockManager.unlock(&request);
+    }
+}
+BENCHMARK(BM_lockManagerLockUnlock);
+
+// Takes the global, database and collection intent locks a read operation acquires, from
+// several threads at once to measure contention on the shared lock heads.
+void BM_lockerReadIntentLocks(benchmark::State& state) {
+    DefaultLockerImpl locker;
+    while (state.keepRunning()) {
+        invariant(locker.lockGlobal(MODE_IS) == LOCK_OK);
+        invariant(locker.lock(kDatabaseId, MODE_IS) == LOCK_OK);
+        invariant(locker.lock(kCollectionId, MODE_IS) == LOCK_OK);
+        locker.unlock(kCollectionId);
+        locker.unlock(kDatabaseId);
+        locker.unlockGlobal();
+    }
+}
+BENCHMARK(BM_lockerReadIntentLocks)->threads(1)->threads(4)->threads(16);
+
+// As above with the write intent locks, which conflict with MODE_S and MODE_X but not each other.
+void BM_lockerWriteIntentLocks(benchmark::State& state) {
+    DefaultLockerImpl locker;
+    while (state.keepRunning()) {
+        invariant(locker.lockGlobal(MODE_IX) == LOCK_OK);
+        invariant(locker.lock(kDatabaseId, MODE_IX) == LOCK_OK);
+        invariant(locker.lock(kCollectionId, MODE_IX) == LOCK_OK);
+        locker.unlock(kCollectionId);
+        locker.unlock(kDatabaseId);
+        locker.unlockGlobal();
+    }
+}
+BENCHMARK(BM_lockerWriteIntentLocks)->threads(1)->threads(4)->threads(16);
+
+}  // namespace
+}  // namespace mongo
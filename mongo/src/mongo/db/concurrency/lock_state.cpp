@@ -43,6 +43,7 @@
 #include "mongo/util/debug_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -363,6 +364,23 @@ LockerImpl<IsForMMAPV1>::~LockerImpl() {
     _stats.reset();
 }
 
+template <bool IsForMMAPV1>
+bool LockerImpl<IsForMMAPV1>::resetForReuse() {
+    if (inAWriteUnitOfWork() || !_resourcesToUnlockAtEndOfUnitOfWork.empty() ||
+        !_requests.empty()) {
+        return false;
+    }
+    invariant(_modeForTicket == MODE_NONE);
+
+    _stats.reset();
+    _clientState.store(kInactive);
+    _ticketWaitTime = Microseconds(0);
+    // The next operation of the same client may run on a different thread.
+    _threadId = stdx::this_thread::get_id();
+    _resetOptions();
+    return true;
+}
+
 //ȡ Client ״̬ʱѾȡwiredtiger ticket  Reader/Writer ڵҲΪ Queued ״̬֮ǰˡ
 //http://www.mongoing.com/archives/4768
 template <bool IsForMMAPV1>
@@ -413,7 +431,7 @@ LockResult LockerImpl<IsForMMAPV1>::_lockGlobalBegin(LockMode mode, Milliseconds
     dassert(isLocked() == (_modeForTicket != MODE_NONE));
     if (_modeForTicket == MODE_NONE) {
         const bool reader = isSharedLockMode(mode);
-        auto holder = ticketHolders[mode]; //ģʽ
+        auto holder = shouldAcquireTicket() ? ticketHolders[mode] : nullptr; //ģʽ
         if (holder) { //modeΪMODE_X ticketHolders[MODE_X]ΪNULLsetGlobalThrottling
 		/*
     holderΪգClientȽȥkQueuedReaderkQueuedWriter״̬Ȼȡһticketȡת
@@ -426,11 +444,21 @@ LockResult LockerImpl<IsForMMAPV1>::_lockGlobalBegin(LockMode mode, Milliseconds
 		*/
             _clientState.store(reader ? kQueuedReader : kQueuedWriter); 
 		//ȴڼΪQueued״̬ȡΪActive״̬ȡʱΪinactive
-            if (timeout == Milliseconds::max()) {
-                holder->waitForTicket(); //ȴwiredtigerпticket Կʵź
-            } else if (!holder->waitForTicketUntil(Date_t::now() + timeout)) {
-                _clientState.store(kInactive); //ûȡҲźˣ״̬Ϊinactive
-                return LOCK_TIMEOUT;
+            if (holder->numQueued() == 0 && holder->tryAcquire()) {
+                // Don't pay for timing when a ticket is immediately available.
+            } else if (timeout == Milliseconds::max()) {
+                Timer waitTimer;
+                holder->waitForTicket(getAdmissionPriority()); //ȴwiredtigerпticket Կʵź
+                _ticketWaitTime += Microseconds(waitTimer.micros());
+            } else {
+                Timer waitTimer;
+                const bool acquired =
+                    holder->waitForTicketUntil(getAdmissionPriority(), Date_t::now() + timeout);
+                _ticketWaitTime += Microseconds(waitTimer.micros());
+                if (!acquired) {
+                    _clientState.store(kInactive); //ûȡҲźˣ״̬Ϊinactive
+                    return LOCK_TIMEOUT;
+                }
             }
         }
 
@@ -966,7 +994,7 @@ bool LockerImpl<IsForMMAPV1>::_unlockImpl(LockRequestsMap::Iterator* it) {
     if (globalLockManager.unlock(it->objAddr())) {
         if (it->key() == resourceIdGlobal) {
             invariant(_modeForTicket != MODE_NONE);
-            auto holder = ticketHolders[_modeForTicket];
+            auto holder = shouldAcquireTicket() ? ticketHolders[_modeForTicket] : nullptr;
             _modeForTicket = MODE_NONE;
             if (holder) {
                 holder->release();
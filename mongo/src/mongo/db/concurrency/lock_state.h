@@ -100,6 +100,12 @@ public:
 
     virtual ~LockerImpl();
 
+    bool resetForReuse() override;
+
+    Microseconds getTicketWaitTime() const override {
+        return _ticketWaitTime;
+    }
+
     virtual ClientState getClientState() const;
 
     virtual LockerId getId() const {
@@ -246,6 +252,9 @@ private:
     //ֵLockerImpl<IsForMMAPV1>::_lockGlobalBegin
     AtomicWord<ClientState> _clientState{kInactive};
 
+    // Time spent queued for tickets, only measured when a ticket was not immediately available.
+    Microseconds _ticketWaitTime{0};
+
     // Track the thread who owns the lock for debugging purposes
     stdx::thread::id _threadId;
 
@@ -253,6 +253,32 @@ TEST(LockerImpl, MMAPV1Locker) {
     ASSERT(locker.unlockGlobal());
 }
 
+TEST(LockerImpl, ResetForReuseOnlyWhenNoLocksHeld) {
+    const ResourceId resId(RESOURCE_DATABASE, "TestDB"_sd);
+
+    DefaultLockerImpl locker;
+    ASSERT_EQUALS(LOCK_OK, locker.lockGlobal(MODE_IX));
+    ASSERT_EQUALS(LOCK_OK, locker.lock(resId, MODE_X));
+    ASSERT_FALSE(locker.resetForReuse());
+    ASSERT(locker.isLockHeldForMode(resId, MODE_X));
+    ASSERT(locker.unlockGlobal());
+
+    locker.setShouldAcquireTicket(false);
+    locker.setShouldConflictWithSecondaryBatchApplication(false);
+    ASSERT(locker.resetForReuse());
+    ASSERT(locker.shouldAcquireTicket());
+    ASSERT(locker.shouldConflictWithSecondaryBatchApplication());
+
+    // The previous operation's locking statistics are not carried over.
+    Locker::LockerInfo info;
+    locker.getLockerInfo(&info);
+    ASSERT(info.locks.empty());
+    ASSERT_EQUALS(0, info.stats.get(resId, MODE_X).numAcquisitions);
+
+    ASSERT_EQUALS(LOCK_OK, locker.lockGlobal(MODE_IS));
+    ASSERT(locker.unlockGlobal());
+}
+
 TEST(LockerImpl, CanceledDeadlockUnblocks) {
     const ResourceId db1(RESOURCE_DATABASE, "db1"_sd);
     const ResourceId db2(RESOURCE_DATABASE, "db2"_sd);
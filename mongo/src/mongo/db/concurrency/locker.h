@@ -34,6 +34,7 @@
 #include "mongo/db/concurrency/lock_manager.h"
 #include "mongo/db/concurrency/lock_stats.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/ticketholder.h"
 
 namespace mongo {
 
@@ -345,7 +346,9 @@ public:
      * If set to false, this opts out of conflicting with replication's use of the
      * ParallelBatchWriterMode lock. Code that opts-out must be ok with seeing an inconsistent view
      * of data because within a batch, secondaries apply operations in a different order than on the
-     * primary. User operations should *never* opt out.
+     * primary. User operations must only opt out once their recovery unit reads from the snapshot
+     * of the last applied batch (see RecoveryUnit::setReadFromLocalSnapshot()), which does not see
+     * any write of the batch being applied.
      */
     void setShouldConflictWithSecondaryBatchApplication(bool newValue) {
         _shouldConflictWithSecondaryBatchApplication = newValue;
@@ -355,12 +358,67 @@ public:
         return _shouldConflictWithSecondaryBatchApplication;
     }
 
+    /**
+     * If set to false, the global lock is taken without first acquiring a storage engine ticket,
+     * so this locker is never queued behind user operations for admission. Only internal work
+     * that must keep making progress under overload, such as replication batch application,
+     * should opt out. May only be changed while no locks are held.
+     */
+    void setShouldAcquireTicket(bool newValue) {
+        invariant(!isLocked() || isNoop());
+        _shouldAcquireTicket = newValue;
+    }
+
+    bool shouldAcquireTicket() const {
+        return _shouldAcquireTicket;
+    }
+
+    /**
+     * Sets the priority with which this locker queues for a storage engine ticket when none is
+     * available. Takes effect the next time the global lock is acquired.
+     */
+    void setAdmissionPriority(TicketHolder::Priority priority) {
+        _admissionPriority = priority;
+    }
+
+    TicketHolder::Priority getAdmissionPriority() const {
+        return _admissionPriority;
+    }
+
+    /**
+     * Prepares this locker to serve another operation once its current one has finished, so that
+     * operations need not each construct a new one. Restores the options above to their defaults.
+     * Returns false, leaving the locker untouched, if it cannot be reused; a locker which still
+     * holds locks or is inside a write unit of work never can.
+     */
+    virtual bool resetForReuse() {
+        return false;
+    }
+
+    /**
+     * Returns the time this locker has spent queued for storage engine tickets since it was
+     * created or last reset for reuse.
+     */
+    virtual Microseconds getTicketWaitTime() const {
+        return Microseconds(0);
+    }
+
 protected:
     Locker() {}
 
+    void _resetOptions() {
+        _shouldConflictWithSecondaryBatchApplication = true;
+        _shouldAcquireTicket = true;
+        _admissionPriority = TicketHolder::Priority::kNormal;
+    }
+
 private:
     //ͬأοLock::ParallelBatchWriterMode::ParallelBatchWriterMode
     bool _shouldConflictWithSecondaryBatchApplication = true;
+
+    bool _shouldAcquireTicket = true;
+
+    TicketHolder::Priority _admissionPriority = TicketHolder::Priority::kNormal;
 };
 
 }  // namespace mongo
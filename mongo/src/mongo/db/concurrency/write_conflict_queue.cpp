@@ -0,0 +1,144 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/write_conflict_queue.h"
+
+#include <boost/functional/hash.hpp>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/concurrency/locker.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+
+// The longest a writer retrying a conflicting write waits for its turn on the document before
+// retrying regardless. Zero disables the queue, so retries only back off.
+MONGO_EXPORT_SERVER_PARAMETER(writeConflictQueueMaxWaitMS, int, 50);
+
+}  // namespace
+
+WriteConflictQueue& WriteConflictQueue::get() {
+    static WriteConflictQueue queue;
+    return queue;
+}
+
+WriteConflictQueue::Stripe& WriteConflictQueue::_stripeFor(StringData ns, const RecordId& id) {
+    size_t hash = RecordId::Hasher()(id);
+    boost::hash_combine(hash, boost::hash_range(ns.rawData(), ns.rawData() + ns.size()));
+    return _stripes[hash % kNumStripes];
+}
+
+WriteConflictQueue::Turn::Turn(OperationContext* opCtx, StringData ns, const RecordId& id) {
+    const int maxWaitMS = writeConflictQueueMaxWaitMS.load();
+
+    // A writer with uncommitted changes may be what the turn holder is conflicting with, so it
+    // must not wait behind it.
+    if (maxWaitMS <= 0 || opCtx->lockState()->inAWriteUnitOfWork()) {
+        return;
+    }
+
+    auto& queue = WriteConflictQueue::get();
+    Stripe& stripe = queue._stripeFor(ns, id);
+    Timer timer;
+    bool waited;
+    {
+        stdx::unique_lock<stdx::mutex> lk(stripe.mutex);
+        stripe.waiters.push_back(&_waiter);
+        _waiter.granted = stripe.waiters.front() == &_waiter;
+        waited = !_waiter.granted;
+
+        try {
+            opCtx->waitForConditionOrInterruptUntil(_waiter.cv,
+                                                    lk,
+                                                    Date_t::now() + Milliseconds(maxWaitMS),
+                                                    [&] { return _waiter.granted; });
+        } catch (...) {
+            _leave(&stripe, &_waiter);
+            throw;
+        }
+
+        if (_waiter.granted) {
+            _stripe = &stripe;
+        } else {
+            _leave(&stripe, &_waiter);
+        }
+    }
+
+    queue._recordRetry(ns, waited, !granted(), waited ? timer.micros() : 0);
+}
+
+WriteConflictQueue::Turn::~Turn() {
+    if (_stripe) {
+        stdx::lock_guard<stdx::mutex> lk(_stripe->mutex);
+        _leave(_stripe, &_waiter);
+    }
+}
+
+void WriteConflictQueue::_leave(Stripe* stripe, Waiter* waiter) {
+    const bool heldTurn = stripe->waiters.front() == waiter;
+    stripe->waiters.remove(waiter);
+    if (heldTurn && !stripe->waiters.empty()) {
+        Waiter* next = stripe->waiters.front();
+        next->granted = true;
+        next->cv.notify_one();
+    }
+}
+
+void WriteConflictQueue::_recordRetry(StringData ns,
+                                      bool waited,
+                                      bool timedOut,
+                                      long long waitMicros) {
+    stdx::lock_guard<stdx::mutex> lk(_statsMutex);
+    auto& stats = _stats[ns];
+    ++stats.retries;
+    if (waited) {
+        ++stats.waits;
+    }
+    if (timedOut) {
+        ++stats.timeouts;
+    }
+    stats.waitMicros += waitMicros;
+}
+
+void WriteConflictQueue::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_statsMutex);
+    for (auto&& entry : _stats) {
+        BSONObjBuilder nsBuilder(builder->subobjStart(entry.first));
+        nsBuilder.appendNumber("retries", entry.second.retries);
+        nsBuilder.appendNumber("waits", entry.second.waits);
+        nsBuilder.appendNumber("timeouts", entry.second.timeouts);
+        nsBuilder.appendNumber("waitMicros", entry.second.waitMicros);
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,133 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <list>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class OperationContext;
+
+/**
+ * Orders the retries of writers that hit a WriteConflictException on the same document.
+ *
+ * Without it, every writer that conflicts on a hot document backs off blindly and retries, and
+ * most retries conflict again. Instead, a writer retrying a document first takes a Turn for it,
+ * and writers retrying the same document are granted their turns one at a time, in the order they
+ * asked. A retrier that has waited longer than writeConflictQueueMaxWaitMS gives up its place and
+ * retries anyway, so the queue can only delay a write, never block it indefinitely. Writers that
+ * have not conflicted never wait.
+ *
+ * Documents are mapped onto a fixed number of stripes, so unrelated documents can occasionally
+ * share a queue.
+ */
+class WriteConflictQueue {
+    MONGO_DISALLOW_COPYING(WriteConflictQueue);
+
+    struct Waiter {
+        stdx::condition_variable cv;
+        bool granted = false;
+    };
+
+    // The writers queued for the documents that map onto a stripe. The front waiter holds the
+    // turn.
+    struct Stripe {
+        stdx::mutex mutex;
+        std::list<Waiter*> waiters;
+    };
+
+public:
+    /**
+     * RAII type for a turn to retry a write on a document. Blocks in the constructor until the
+     * turn is granted, the wait times out, or the operation is interrupted (which throws).
+     */
+    class Turn {
+        MONGO_DISALLOW_COPYING(Turn);
+
+    public:
+        Turn(OperationContext* opCtx, StringData ns, const RecordId& id);
+        ~Turn();
+
+        /**
+         * Returns true if this writer holds the document's turn, false if it gave up waiting or
+         * queueing is disabled.
+         */
+        bool granted() const {
+            return _stripe != nullptr;
+        }
+
+    private:
+        Stripe* _stripe = nullptr;
+        Waiter _waiter;
+    };
+
+    static WriteConflictQueue& get();
+
+    /**
+     * Appends per-namespace counters of the retries that went through the queue.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    struct NamespaceStats {
+        long long retries = 0;
+        long long waits = 0;
+        long long timeouts = 0;
+        long long waitMicros = 0;
+    };
+
+    static const size_t kNumStripes = 1024;
+
+    WriteConflictQueue() = default;
+
+    Stripe& _stripeFor(StringData ns, const RecordId& id);
+
+    /**
+     * Removes 'waiter' from 'stripe', handing the turn to the next waiter if 'waiter' held it.
+     * Must be called with the stripe's mutex held.
+     */
+    static void _leave(Stripe* stripe, Waiter* waiter);
+
+    void _recordRetry(StringData ns, bool waited, bool timedOut, long long waitMicros);
+
+    Stripe _stripes[kNumStripes];
+
+    mutable stdx::mutex _statsMutex;
+    StringMap<NamespaceStats> _stats;
+};
+
+}  // namespace mongo
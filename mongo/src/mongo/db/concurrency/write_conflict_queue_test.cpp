@@ -0,0 +1,143 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/write_conflict_queue.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+const StringData kNs = "test.writeConflictQueue"_sd;
+
+class WriteConflictQueueTest : public unittest::Test {
+public:
+    void setUp() override {
+        _maxWaitParameter =
+            ServerParameterSet::getGlobal()->getMap()["writeConflictQueueMaxWaitMS"];
+        ASSERT(_maxWaitParameter);
+        setMaxWaitMS(60 * 1000);
+    }
+
+    void tearDown() override {
+        setMaxWaitMS(50);
+    }
+
+    void setMaxWaitMS(int maxWaitMS) {
+        ASSERT_OK(_maxWaitParameter->setFromString(std::to_string(maxWaitMS)));
+    }
+
+    /**
+     * Takes a turn for 'id' on a new thread and returns the thread. 'granted' is set once the
+     * turn has been taken, to 1 if it was granted and to 2 if the wait timed out.
+     */
+    stdx::thread takeTurnInThread(const RecordId& id, AtomicWord<int>* granted) {
+        return stdx::thread([id, granted] {
+            auto client = getGlobalServiceContext()->makeClient("writeConflictQueueTest");
+            auto opCtx = client->makeOperationContext();
+            WriteConflictQueue::Turn turn(opCtx.get(), kNs, id);
+            granted->store(turn.granted() ? 1 : 2);
+        });
+    }
+
+    ServiceContext::UniqueOperationContext makeOpCtx() {
+        _clients.push_back(getGlobalServiceContext()->makeClient("writeConflictQueueTest"));
+        return _clients.back()->makeOperationContext();
+    }
+
+private:
+    ServerParameter* _maxWaitParameter = nullptr;
+    std::vector<ServiceContext::UniqueClient> _clients;
+};
+
+TEST_F(WriteConflictQueueTest, FirstRetrierIsGrantedImmediately) {
+    auto opCtx = makeOpCtx();
+    WriteConflictQueue::Turn turn(opCtx.get(), kNs, RecordId(1));
+    ASSERT(turn.granted());
+}
+
+TEST_F(WriteConflictQueueTest, SecondRetrierWaitsForFirstToFinish) {
+    auto opCtx = makeOpCtx();
+    AtomicWord<int> granted(0);
+    stdx::thread waiter;
+    {
+        WriteConflictQueue::Turn turn(opCtx.get(), kNs, RecordId(2));
+        ASSERT(turn.granted());
+
+        waiter = takeTurnInThread(RecordId(2), &granted);
+        sleepmillis(50);
+        ASSERT_EQ(0, granted.load());
+    }
+    waiter.join();
+    ASSERT_EQ(1, granted.load());
+}
+
+TEST_F(WriteConflictQueueTest, RetriersOfDifferentDocumentsDoNotWait) {
+    auto opCtx = makeOpCtx();
+    WriteConflictQueue::Turn turn(opCtx.get(), kNs, RecordId(3));
+
+    // RecordIds 3 and 4 are on different stripes, so the second turn is granted right away.
+    AtomicWord<int> granted(0);
+    takeTurnInThread(RecordId(4), &granted).join();
+    ASSERT_EQ(1, granted.load());
+}
+
+TEST_F(WriteConflictQueueTest, RetrierStopsWaitingAfterMaxWait) {
+    setMaxWaitMS(10);
+    auto opCtx = makeOpCtx();
+    WriteConflictQueue::Turn turn(opCtx.get(), kNs, RecordId(5));
+
+    AtomicWord<int> granted(0);
+    takeTurnInThread(RecordId(5), &granted).join();
+    ASSERT_EQ(2, granted.load());
+
+    BSONObjBuilder builder;
+    WriteConflictQueue::get().appendStats(&builder);
+    BSONObj stats = builder.obj()[kNs].Obj();
+    ASSERT_GTE(stats["timeouts"].numberLong(), 1);
+}
+
+TEST_F(WriteConflictQueueTest, DisabledQueueNeverGrantsTurns) {
+    setMaxWaitMS(0);
+    auto opCtx = makeOpCtx();
+    WriteConflictQueue::Turn turn(opCtx.get(), kNs, RecordId(6));
+    ASSERT(!turn.granted());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -42,6 +42,8 @@
 #include "mongo/db/json.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/util/log.h"
@@ -53,6 +55,10 @@ using std::string;
 
 namespace {
 
+// When set, ScopedOpPhaseTimer accumulates per-phase timings which are reported in the slow
+// operation log line and the profiler entry.
+MONGO_EXPORT_SERVER_PARAMETER(operationPhaseTimingEnabled, bool, false);
+
 // Lists the $-prefixed query options that can be passed alongside a wrapped query predicate for
 // OP_QUERY find. The $orderby field is omitted because "orderby" (no dollar sign) is also allowed,
 // and this requires special handling.
@@ -168,7 +174,8 @@ public:
         } else {
             _opCtx = opCtx;
         }
-        stdx::lock_guard<Client> lk(*_opCtx->getClient());
+        _client = opCtx->getClient();
+        stdx::lock_guard<Client> lk(*_client);
         push_nolock(curOp);
     }
 
@@ -199,14 +206,33 @@ public:
         CurOp* retval = _top;
         _top = _top->_parent;
         if (shouldLock) {
+            // The enclosing operation is the one the client reports again.
+            _top->_publishState_inlock();
             _opCtx->getClient()->unlock();
         }
         return retval;
     }
 
+    /**
+     * Returns the client of the operation owning this stack, or nullptr if it is not known yet.
+     */
+    Client* client() const {
+        return _client;
+    }
+
+    /**
+     * Records the client of the operation owning this stack. The stack is a decoration of the
+     * operation, so it only learns the operation when a CurOp is pushed or looked up.
+     */
+    void noteClient(Client* client) const {
+        _client = client;
+    }
+
 private:
     OperationContext* _opCtx = nullptr;
 
+    mutable Client* _client = nullptr;
+
     // Top of the stack of CurOps for a Client.
     CurOp* _top = nullptr;
 
@@ -223,7 +249,9 @@ CurOp* CurOp::get(const OperationContext* opCtx) {
 }
 
 CurOp* CurOp::get(const OperationContext& opCtx) {
-    return _curopStack(opCtx).top();
+    const auto& stack = _curopStack(opCtx);
+    stack.noteClient(opCtx.getClient());
+    return stack.top();
 }
 
 CurOp::CurOp(OperationContext* opCtx) : CurOp(opCtx, &_curopStack(opCtx)) {}
@@ -260,6 +288,15 @@ CurOp::~CurOp() {
 
 void CurOp::setNS_inlock(StringData ns) {
     _ns = ns.toString();
+    _publishState_inlock();
+}
+
+void CurOp::_publishState_inlock() {
+    Client* client = _stack->client();
+    if (!client || _stack->top() != this) {
+        return;
+    }
+    client->getPublishedOpState().publishDetails(_ns, _logicalOp, _start);
 }
 
 //execCommandDatabase   ServiceEntryPointMongod::handleRequest
@@ -272,6 +309,7 @@ void CurOp::ensureStarted() { //
 void CurOp::enter_inlock(const char* ns, boost::optional<int> dbProfileLevel) {
     ensureStarted();
     _ns = ns;
+    _publishState_inlock();
     if (dbProfileLevel) {
         raiseDbProfileLevel(*dbProfileLevel);
     }
@@ -530,6 +568,14 @@ string OpDebug::report(Client* client,
 
     s << " numYields:" << curop.numYields();
 
+    {
+        BSONObjBuilder phases;
+        appendPhaseTimes(&phases);
+        if (!phases.asTempObj().isEmpty()) {
+            s << " phaseMicros:" << phases.obj().toString();
+        }
+    }
+
     OPDEBUG_TOSTRING_HELP(nreturned);
     if (responseLength > 0) {
         s << " reslen:" << responseLength;
@@ -633,6 +679,14 @@ void OpDebug::append(const CurOp& curop,
     }
     b.appendIntOrLL("millis", executionTimeMicros / 1000);
 
+    {
+        BSONObjBuilder phases;
+        appendPhaseTimes(&phases);
+        if (!phases.asTempObj().isEmpty()) {
+            b.append("phaseMicros", phases.obj());
+        }
+    }
+
     if (!curop.getPlanSummary().empty()) {
         b.append("planSummary", curop.getPlanSummary());
     }
@@ -650,4 +704,56 @@ void OpDebug::setPlanSummaryMetrics(const PlanSummaryStats& planSummaryStats) {
     replanned = planSummaryStats.replanned;
 }
 
+bool OpDebug::isPhaseTimingEnabled() {
+    return operationPhaseTimingEnabled.loadRelaxed();
+}
+
+StringData OpDebug::phaseName(Phase phase) {
+    switch (phase) {
+        case Phase::kParse:
+            return "parse"_sd;
+        case Phase::kPlan:
+            return "plan"_sd;
+        case Phase::kYield:
+            return "yield"_sd;
+        case Phase::kWriteConcern:
+            return "writeConcern"_sd;
+        case Phase::kReply:
+            return "reply"_sd;
+        case Phase::kNumPhases:
+            break;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void OpDebug::appendPhaseTimes(BSONObjBuilder* builder) const {
+    for (size_t i = 0; i < phaseMicros.size(); ++i) {
+        if (phaseMicros[i] > Microseconds{0}) {
+            builder->appendNumber(phaseName(static_cast<Phase>(i)),
+                                  durationCount<Microseconds>(phaseMicros[i]));
+        }
+    }
+}
+
+ScopedOpPhaseTimer::ScopedOpPhaseTimer(OperationContext* opCtx, OpDebug::Phase phase)
+    : _phase(phase) {
+    if (!opCtx || !OpDebug::isPhaseTimingEnabled()) {
+        return;
+    }
+
+    _opDebug = &CurOp::get(opCtx)->debug();
+    _tickSource = opCtx->getServiceContext()->getTickSource();
+    _start = _tickSource->getTicks();
+}
+
+ScopedOpPhaseTimer::~ScopedOpPhaseTimer() {
+    if (!_opDebug) {
+        return;
+    }
+
+    const auto elapsedTicks = _tickSource->getTicks() - _start;
+    _opDebug->addPhaseTime(
+        _phase, Microseconds{elapsedTicks * 1000 * 1000 / _tickSource->getTicksPerSecond()});
+}
+
 }  // namespace mongo
@@ -31,6 +31,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/cursor_id.h"
@@ -39,6 +41,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/progress_meter.h"
+#include "mongo/util/tick_source.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -51,8 +54,32 @@ struct PlanSummaryStats;
 /* lifespan is different than CurOp because of recursives with DBDirectClient */
 class OpDebug {
 public:
+    /**
+     * Coarse phases of an operation whose wall-clock time is accumulated by ScopedOpPhaseTimer
+     * while the 'operationPhaseTimingEnabled' server parameter is set. Phases may nest, e.g. a
+     * yield taken during plan selection is counted towards both kYield and kPlan.
+     */
+    enum class Phase { kParse, kPlan, kYield, kWriteConcern, kReply, kNumPhases };
+
     OpDebug() = default;
 
+    /**
+     * Returns true if per-phase timings should be collected.
+     */
+    static bool isPhaseTimingEnabled();
+
+    static StringData phaseName(Phase phase);
+
+    void addPhaseTime(Phase phase, Microseconds elapsed) {
+        phaseMicros[static_cast<size_t>(phase)] += elapsed;
+    }
+
+    /**
+     * Appends a field for each phase with a non-zero accumulated time. Appends nothing if no
+     * phase was timed.
+     */
+    void appendPhaseTimes(BSONObjBuilder* builder) const;
+
     std::string report(Client* client,
                        const CurOp& curop,
                        const SingleThreadedLockStats& lockStats) const;
@@ -132,6 +159,9 @@ public:
     long long executionTimeMicros{0};
     long long nreturned{-1};
     int responseLength{-1};
+
+    // Accumulated time spent in each Phase, indexed by the Phase value.
+    std::array<Microseconds, static_cast<size_t>(Phase::kNumPhases)> phaseMicros{};
 };
 
 /**
@@ -204,6 +234,7 @@ public:
     void setLogicalOp_inlock(LogicalOp op) {
         _logicalOp = op;
         _debug.logicalOp = op;
+        _publishState_inlock();
     }
 
     /**
@@ -276,6 +307,23 @@ public:
         return _isCommand;
     }
 
+    /**
+     * Marks this operation as an explain, whose plan statistics are reported stage by stage. This
+     * is done by the explain command, legacy $explain queries and aggregations with explain set,
+     * before they build their plans.
+     */
+    void setIsExplain() {
+        _isExplain = true;
+    }
+
+    /**
+     * Returns true if the statistics of every plan stage run by this operation may be reported,
+     * as explain and the profiler do, rather than only the summary the slow query log uses.
+     */
+    bool shouldCollectDetailedExecStats() const {
+        return _isExplain || _dbprofile > 0;
+    }
+
     //
     // Methods for getting/setting elapsed time. Note that the observed elapsed time may be
     // negative, if the system time has been reset during the course of this operation.
@@ -462,6 +510,12 @@ private:
 
     CurOp(OperationContext*, CurOpStack*);
 
+    /**
+     * Publishes the namespace, type and start time of this operation to the PublishedOpState of
+     * its client, if this is the innermost CurOp of the client.
+     */
+    void _publishState_inlock();
+
     CurOpStack* _stack;
     CurOp* _parent{nullptr};
     Command* _command{nullptr};
@@ -488,6 +542,7 @@ private:
     LogicalOp _logicalOp{LogicalOp::opInvalid};  // only set this through setNetworkOp_inlock()
 
     bool _isCommand{false};
+    bool _isExplain{false};
     int _dbprofile{0};  // 0=off, 1=slow, 2=all
     std::string _ns; //
     //ֵcurOpCommandSetup->setOpDescription_inlock,  beginQueryOp->setOpDescription_inlockӦOpMsg.body
@@ -501,6 +556,24 @@ private:
     std::string _planSummary;
 };
 
+/**
+ * Adds the time between construction and destruction to the given phase of the current
+ * operation's OpDebug. Does nothing, and reads no clock, when phase timing is disabled.
+ */
+class ScopedOpPhaseTimer {
+    MONGO_DISALLOW_COPYING(ScopedOpPhaseTimer);
+
+public:
+    ScopedOpPhaseTimer(OperationContext* opCtx, OpDebug::Phase phase);
+    ~ScopedOpPhaseTimer();
+
+private:
+    OpDebug* _opDebug = nullptr;
+    TickSource* _tickSource = nullptr;
+    TickSource::Tick _start = 0;
+    const OpDebug::Phase _phase;
+};
+
 /**
  * Upconverts a legacy query object such that it matches the format of the find command.
  */
@@ -82,7 +82,7 @@ public:
      * Returns a unique 32-bit identifier to be used as the first 32 bits of all cursor ids for a
      * new CursorManager.
      */
-    uint32_t registerCursorManager(const NamespaceString& nss);
+    uint32_t registerCursorManager(const NamespaceString& nss, const AtomicInt64* numIdleCursors);
 
     /**
      * Must be called when a CursorManager is deleted. 'id' must be the identifier returned by
@@ -107,7 +107,14 @@ public:
 private:
     SimpleMutex _mutex;
 
-    typedef unordered_map<unsigned, NamespaceString> Map;
+    struct Entry {
+        NamespaceString nss;
+
+        // The number of cursors the manager could time out. Valid while the entry is registered.
+        const AtomicInt64* numIdleCursors;
+    };
+
+    typedef unordered_map<unsigned, Entry> Map;
     Map _idToNss;
     unsigned _nextId;
 
@@ -141,7 +148,8 @@ int64_t GlobalCursorIdCache::nextSeed() {
     return _secureRandom->nextInt64();
 }
 
-uint32_t GlobalCursorIdCache::registerCursorManager(const NamespaceString& nss) {
+uint32_t GlobalCursorIdCache::registerCursorManager(const NamespaceString& nss,
+                                                    const AtomicInt64* numIdleCursors) {
     static const uint32_t kMaxIds = 1000 * 1000 * 1000;
     static_assert((kMaxIds & (0b11 << 30)) == 0,
                   "the first two bits of a collection identifier must always be zeroes");
@@ -156,7 +164,7 @@ uint32_t GlobalCursorIdCache::registerCursorManager(const NamespaceString& nss)
             continue;
         if (_idToNss.count(id) > 0)
             continue;
-        _idToNss[id] = nss;
+        _idToNss[id] = {nss, numIdleCursors};
         return id;
     }
 
@@ -165,7 +173,7 @@ uint32_t GlobalCursorIdCache::registerCursorManager(const NamespaceString& nss)
 
 void GlobalCursorIdCache::deregisterCursorManager(uint32_t id, const NamespaceString& nss) {
     stdx::lock_guard<SimpleMutex> lk(_mutex);
-    invariant(nss == _idToNss[id]);
+    invariant(nss == _idToNss[id].nss);
     _idToNss.erase(id);
 }
 
@@ -190,7 +198,7 @@ bool GlobalCursorIdCache::eraseCursor(OperationContext* opCtx, CursorId id, bool
             // audit log here (even though we don't have a namespace).
             return false;
         }
-        nss = it->second;
+        nss = it->second.nss;
     }
     invariant(nss.isValid());
 
@@ -239,12 +247,16 @@ std::size_t GlobalCursorIdCache::timeoutCursors(OperationContext* opCtx, Date_t
     // Time out the cursors from the global cursor manager.
     totalTimedOut += globalCursorManager->timeoutCursors(opCtx, now);
 
-    // Compute the set of collection names that we have to time out cursors for.
+    // Compute the set of collection names that we have to time out cursors for. Collections whose
+    // cursors are all pinned or exempt from timeouts are skipped, so that the sweep doesn't take
+    // their collection locks.
     vector<NamespaceString> todo;
     {
         stdx::lock_guard<SimpleMutex> lk(_mutex);
         for (auto&& entry : _idToNss) {
-            todo.push_back(entry.second);
+            if (entry.second.numIdleCursors->load() > 0) {
+                todo.push_back(entry.second.nss);
+            }
         }
     }
 
@@ -277,7 +289,7 @@ void GlobalCursorIdCache::visitAllCursorManagers(OperationContext* opCtx, Visito
     {
         stdx::lock_guard<SimpleMutex> lk(_mutex);
         for (auto&& entry : _idToNss) {
-            namespaces.push_back(entry.second);
+            namespaces.push_back(entry.second.nss);
         }
     }
 
@@ -363,8 +375,9 @@ std::size_t CursorManager::PlanExecutorPartitioner::operator()(const PlanExecuto
 
 CursorManager::CursorManager(NamespaceString nss)
     : _nss(std::move(nss)),
-      _collectionCacheRuntimeId(_nss.isEmpty() ? 0
-                                               : globalCursorIdCache->registerCursorManager(_nss)),
+      _collectionCacheRuntimeId(
+          _nss.isEmpty() ? 0
+                         : globalCursorIdCache->registerCursorManager(_nss, &_numIdleCursors)),
       _random(stdx::make_unique<PseudoRandom>(globalCursorIdCache->nextSeed())),
       _registeredPlanExecutors(),
       _cursorMap(stdx::make_unique<Partitioned<unordered_map<CursorId, ClientCursor*>>>()) {}
@@ -410,11 +423,13 @@ void CursorManager::invalidateAll(OperationContext* opCtx,
                 continue;
             }
 
+            // Killed cursors which are kept around still time out, so they stay on the idle list.
             if (!collectionGoingAway) {
                 // We keep around unpinned cursors so that future attempts to use the cursor will
                 // result in a useful error message.
                 ++it;
             } else {
+                removeIdleCursor_inlock(cursor);
                 cursor->dispose(opCtx);
                 delete cursor;
                 it = partition.erase(it);
@@ -462,22 +477,63 @@ std::size_t CursorManager::timeoutCursors(OperationContext* opCtx, Date_t now) {
 
     for (size_t partitionId = 0; partitionId < kNumPartitions; ++partitionId) {
         auto lockedPartition = _cursorMap->lockOnePartitionById(partitionId);
-        for (auto it = lockedPartition->begin(); it != lockedPartition->end();) {
-            auto* cursor = it->second;
-            if (cursorShouldTimeout_inlock(cursor, now)) {
-                // Dispose of the cursor and remove it from the partition.
-                cursor->dispose(opCtx);
-                toDelete.push_back(std::unique_ptr<ClientCursor, ClientCursor::Deleter>{cursor});
-                it = lockedPartition->erase(it);
-            } else {
-                ++it;
-            }
+
+        // The idle list is ordered by time of last use, so we can stop at the first cursor which
+        // has not timed out yet.
+        auto& idleList = _idleLists[partitionId];
+        while (idleList.head && cursorShouldTimeout_inlock(idleList.head, now)) {
+            auto* cursor = idleList.head;
+
+            // Dispose of the cursor and remove it from the partition.
+            removeIdleCursor_inlock(cursor);
+            cursor->dispose(opCtx);
+            toDelete.push_back(std::unique_ptr<ClientCursor, ClientCursor::Deleter>{cursor});
+            lockedPartition->erase(cursor->cursorid());
         }
     }
 
     return toDelete.size();
 }
 
+void CursorManager::addIdleCursor_inlock(ClientCursor* cursor) {
+    if (cursor->isNoTimeout()) {
+        return;
+    }
+
+    auto& idleList = _idleLists[cursorMapPartitionOf(cursor->cursorid())];
+    cursor->_idlePrev = idleList.tail;
+    cursor->_idleNext = nullptr;
+    if (idleList.tail) {
+        idleList.tail->_idleNext = cursor;
+    } else {
+        idleList.head = cursor;
+    }
+    idleList.tail = cursor;
+    _numIdleCursors.fetchAndAdd(1);
+}
+
+void CursorManager::removeIdleCursor_inlock(ClientCursor* cursor) {
+    auto& idleList = _idleLists[cursorMapPartitionOf(cursor->cursorid())];
+    if (!cursor->_idlePrev && idleList.head != cursor) {
+        // Not on the idle list.
+        return;
+    }
+
+    if (cursor->_idlePrev) {
+        cursor->_idlePrev->_idleNext = cursor->_idleNext;
+    } else {
+        idleList.head = cursor->_idleNext;
+    }
+    if (cursor->_idleNext) {
+        cursor->_idleNext->_idlePrev = cursor->_idlePrev;
+    } else {
+        idleList.tail = cursor->_idlePrev;
+    }
+    cursor->_idlePrev = nullptr;
+    cursor->_idleNext = nullptr;
+    _numIdleCursors.fetchAndSubtract(1);
+}
+
 namespace {
 static AtomicUInt32 registeredPlanExecutorId;
 }  // namespace
@@ -510,6 +566,7 @@ StatusWith<ClientCursorPin> CursorManager::pinCursor(OperationContext* opCtx, Cu
         Status error{ErrorCodes::QueryPlanKilled,
                      str::stream() << "cursor killed because: "
                                    << cursor->getExecutor()->getKillReason()};
+        removeIdleCursor_inlock(cursor);
         lockedPartition->erase(cursor->cursorid());
         cursor->dispose(opCtx);
         delete cursor;
@@ -522,6 +579,7 @@ StatusWith<ClientCursorPin> CursorManager::pinCursor(OperationContext* opCtx, Cu
         return cursorPrivilegeStatus;
     }
 
+    removeIdleCursor_inlock(cursor);
     cursor->_isPinned = true;
 
     // We use pinning of a cursor as a proxy for active, user-initiated use of a cursor.  Therefor,
@@ -541,6 +599,7 @@ void CursorManager::unpin(OperationContext* opCtx, ClientCursor* cursor) {
     invariant(cursor->_isPinned);
     cursor->_isPinned = false;
     cursor->_lastUseDate = now;
+    addIdleCursor_inlock(cursor);
 }
 
 void CursorManager::getCursorIds(std::set<CursorId>* openCursors) const {
@@ -677,6 +736,7 @@ Status CursorManager::eraseCursor(OperationContext* opCtx, CursorId id, bool sho
         audit::logKillCursorsAuthzCheck(opCtx->getClient(), _nss, id, ErrorCodes::OK);
     }
 
+    removeIdleCursor_inlock(ownedCursor.get());
     lockedPartition->erase(ownedCursor->cursorid());
     ownedCursor->dispose(opCtx);
     return Status::OK();
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <array>
 #include <utility>
 
 #include "mongo/db/catalog/util/partitioned.h"
@@ -39,6 +40,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/session_killer.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/unordered_map.h"
 #include "mongo/platform/unordered_set.h"
 #include "mongo/stdx/unordered_set.h"
@@ -245,10 +247,26 @@ private:
 
     bool cursorShouldTimeout_inlock(const ClientCursor* cursor, Date_t now);
 
+    /**
+     * Maintain the idle list of the '_cursorMap' partition holding 'cursor'. The caller must hold
+     * that partition's mutex. Removing a cursor which is not on its idle list is a no-op.
+     */
+    void addIdleCursor_inlock(ClientCursor* cursor);
+    void removeIdleCursor_inlock(ClientCursor* cursor);
+
+    static std::size_t cursorMapPartitionOf(CursorId id) {
+        return Partitioner<CursorId>()(id, kNumPartitions);
+    }
+
     bool isGlobalManager() const {
         return _nss.isEmpty();
     }
 
+    // The number of cursors on the idle lists across all partitions. Lets the global timeout sweep
+    // skip cursor managers which have nothing to time out without taking their collection lock.
+    // Declared ahead of '_collectionCacheRuntimeId' since registering this manager publishes it.
+    AtomicInt64 _numIdleCursors;
+
     // No locks are needed to consult these data members.
     const NamespaceString _nss;
     const uint32_t _collectionCacheRuntimeId;
@@ -277,5 +295,16 @@ private:
     Partitioned<unordered_set<PlanExecutor*>, kNumPartitions, PlanExecutorPartitioner>
         _registeredPlanExecutors;
     std::unique_ptr<Partitioned<unordered_map<CursorId, ClientCursor*>, kNumPartitions>> _cursorMap;
+
+    // For each partition of '_cursorMap', an intrusive doubly-linked list of the unpinned cursors
+    // which are eligible to time out, in the order they were last unpinned. Since every cursor
+    // shares the same timeout, expired cursors are always found at the head of the list, and
+    // timeoutCursors() never needs to look at a cursor which is still live. Each list is protected
+    // by the mutex of its '_cursorMap' partition.
+    struct IdleList {
+        ClientCursor* head = nullptr;
+        ClientCursor* tail = nullptr;
+    };
+    std::array<IdleList, kNumPartitions> _idleLists;
 };
 }  // namespace mongo
@@ -92,6 +92,7 @@
 #include "mongo/db/mongod_options.h"
 #include "mongo/db/op_observer_impl.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/plan_cache_warmup.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repair_database.h"
 #include "mongo/db/repl/drop_pending_collection_reaper.h"
@@ -998,6 +999,7 @@ ExitCode _initAndListen(int listenPort) {
             log() << startupWarningsLog;
         } else {
             startTTLBackgroundJob();
+            startPlanCacheWarmupBackgroundJob();
         }
 
         if (replSettings.usingReplSets() || (!replSettings.isMaster() && replSettings.isSlave()) ||
@@ -1015,6 +1017,11 @@ ExitCode _initAndListen(int listenPort) {
     runner->startup().transitional_ignore();
     serviceContext->setPeriodicRunner(std::move(runner));
 
+    // Enforce operation deadlines from the periodic runner, at the fast clock's granularity, so
+    // that interrupt checks do not have to read the clock.
+    serviceContext->startOperationDeadlineMonitor(
+        serviceContext->getFastClockSource()->getPrecision());
+
     SessionKiller::set(serviceContext,
                        std::make_shared<SessionKiller>(serviceContext, killSessionsLocal));
 
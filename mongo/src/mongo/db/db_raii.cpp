@@ -36,8 +36,10 @@
 #include "mongo/db/catalog/uuid_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/curop.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/util/fail_point_service.h"
 
@@ -45,6 +47,51 @@ namespace mongo {
 
 namespace {
 MONGO_FP_DECLARE(setAutoGetCollectionWait);
+
+// When true, reads with readConcern "local" or "available" on a secondary read from the snapshot of
+// the last oplog batch applied rather than waiting for the batch being applied to finish. Off by
+// default, since such reads no longer see the data of a batch until the whole batch is applied.
+MONGO_EXPORT_SERVER_PARAMETER(readFromLastAppliedBatchOnSecondaries, bool, false);
+
+/**
+ * Switches a read on a secondary over to the snapshot of the last oplog batch applied, so that the
+ * locks it takes next no longer conflict with batch application. Leaves the operation untouched
+ * when it already holds locks, reads from the oplog's database, or needs another read concern.
+ */
+void readFromLocalSnapshotIfPossible(OperationContext* opCtx, StringData dbName) {
+    if (!readFromLastAppliedBatchOnSecondaries.load()) {
+        return;
+    }
+
+    auto locker = opCtx->lockState();
+    if (locker->isLocked() || !locker->shouldConflictWithSecondaryBatchApplication()) {
+        return;
+    }
+
+    if (!opCtx->getClient()->isFromUserConnection() || dbName == NamespaceString::kLocalDb) {
+        return;
+    }
+
+    const auto level = repl::ReadConcernArgs::get(opCtx).getLevel();
+    if (level != repl::ReadConcernLevel::kLocalReadConcern &&
+        level != repl::ReadConcernLevel::kAvailableReadConcern) {
+        return;
+    }
+
+    if (!repl::ReplicationCoordinator::get(opCtx)->getMemberState().secondary()) {
+        return;
+    }
+
+    if (!opCtx->recoveryUnit()->setReadFromLocalSnapshot().isOK()) {
+        return;
+    }
+    locker->setShouldConflictWithSecondaryBatchApplication(false);
+}
+
+Lock::DBLock lockDbForRead(OperationContext* opCtx, StringData dbName) {
+    readFromLocalSnapshotIfPossible(opCtx, dbName);
+    return Lock::DBLock(opCtx, dbName, MODE_IS);
+}
 }  // namespace
 
 AutoGetDb::AutoGetDb(OperationContext* opCtx, StringData ns, LockMode mode)
@@ -159,7 +206,7 @@ AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
                                                    const UUID& uuid) {
     // Lock the database since a UUID will always be in the same database even though its
     // collection name may change.
-    Lock::DBLock dbSLock(opCtx, dbName, MODE_IS);
+    Lock::DBLock dbSLock = lockDbForRead(opCtx, dbName);
 
     auto nss = UUIDCatalog::get(opCtx).lookupNSSByUUID(uuid);
 
@@ -176,7 +223,7 @@ AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
 AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
                                                    const NamespaceString& nss,
                                                    AutoGetCollection::ViewMode viewMode) {
-    _autoColl.emplace(opCtx, nss, MODE_IS, MODE_IS, viewMode);
+    _autoColl.emplace(opCtx, nss, MODE_IS, viewMode, lockDbForRead(opCtx, nss.db()));
 
     // Note: this can yield.
     _ensureMajorityCommittedSnapshotIsValid(nss, opCtx);
@@ -248,8 +295,7 @@ AutoGetCollectionForReadCommand::AutoGetCollectionForReadCommand(
 
 AutoGetCollectionForReadCommand::AutoGetCollectionForReadCommand(
     OperationContext* opCtx, const NamespaceString& nss, AutoGetCollection::ViewMode viewMode)
-    : AutoGetCollectionForReadCommand(
-          opCtx, nss, viewMode, Lock::DBLock(opCtx, nss.db(), MODE_IS)) {}
+    : AutoGetCollectionForReadCommand(opCtx, nss, viewMode, lockDbForRead(opCtx, nss.db())) {}
 
 //FindCmd::runйʹ
 AutoGetCollectionOrViewForReadCommand::AutoGetCollectionOrViewForReadCommand(
@@ -30,6 +30,8 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/base/static_assert.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/client/constants.h"
@@ -451,6 +453,14 @@ Message makeGetMoreMessage(StringData ns, long long cursorId, int nToReturn, int
 struct DbResponse {
     Message response;       // If empty, nothing will be returned to the client.
     std::string exhaustNS;  // Namespace of cursor if exhaust mode, else "".
+
+    // For OP_MSG requests sent with OpMsg::kExhaustSupported, whether the cursor is still open and
+    // the server should run another getMore and stream its reply without waiting on the client.
+    bool shouldRunAgainForExhaust = false;
+
+    // The command to run for the next batch when shouldRunAgainForExhaust is set: the getMore
+    // following an initial find or aggregate, or an owned copy of a getMore request.
+    boost::optional<BSONObj> nextInvocation;
 };
 
 /**
@@ -38,11 +38,14 @@
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/optime.h"
+#include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 #include "mongo/db/client.h"  // XXX-ERH
 
@@ -52,6 +55,62 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+/**
+ * Returns the comparisons on top-level fields which every record matching 'filter' satisfies.
+ */
+std::vector<ZoneMapPredicate> extractSkipPredicates(const MatchExpression* filter) {
+    std::vector<ZoneMapPredicate> predicates;
+    if (!filter) {
+        return predicates;
+    }
+
+    std::vector<const MatchExpression*> conjuncts;
+    if (MatchExpression::AND == filter->matchType()) {
+        for (size_t i = 0; i < filter->numChildren(); ++i) {
+            conjuncts.push_back(filter->getChild(i));
+        }
+    } else {
+        conjuncts.push_back(filter);
+    }
+
+    for (auto&& expr : conjuncts) {
+        ZoneMapPredicate::Op op;
+        switch (expr->matchType()) {
+            case MatchExpression::LT:
+                op = ZoneMapPredicate::Op::kLT;
+                break;
+            case MatchExpression::LTE:
+                op = ZoneMapPredicate::Op::kLTE;
+                break;
+            case MatchExpression::EQ:
+                op = ZoneMapPredicate::Op::kEQ;
+                break;
+            case MatchExpression::GTE:
+                op = ZoneMapPredicate::Op::kGTE;
+                break;
+            case MatchExpression::GT:
+                op = ZoneMapPredicate::Op::kGT;
+                break;
+            default:
+                continue;
+        }
+
+        // Zone maps only summarize top-level fields, and compare values without a collator.
+        auto comparison = static_cast<const ComparisonMatchExpression*>(expr);
+        if (comparison->getCollator() || comparison->path().empty() ||
+            comparison->path().find('.') != std::string::npos) {
+            continue;
+        }
+        predicates.push_back(
+            {comparison->path().toString(), op, comparison->getData().wrap("")});
+    }
+    return predicates;
+}
+
+}  // namespace
+
 /*
 2021-01-22T10:59:08.080+0800 D QUERY    [conn-1] Winning solution:
 FETCH  -------------PlanStageӦFetchStage   Ӧ־еdocsExamined:1
@@ -98,18 +157,32 @@ CollectionScan::CollectionScan(OperationContext* opCtx,
       _filter(filter),
       _params(params),
       _isDead(false),
-      _wsidForFetch(_workingSet->allocate()) {
+      _wsidForFetch(_workingSet->allocate()),
+      _batchSize(
+          static_cast<size_t>(std::max(0, internalQueryExecCollectionScanBatchSize.load()))) {
     // Explain reports the direction of the collection scan.
     _specificStats.direction = params.direction;
     _specificStats.maxTs = params.maxTs;
     invariant(!_params.shouldTrackLatestOplogTimestamp || _params.collection->ns().isOplog());
 
+    if (internalQueryExecEnableTopLevelComparisonMatcher.load()) {
+        _topLevelComparisonMatcher = TopLevelComparisonMatcher::make(_filter);
+    }
+
     if (params.maxTs) {
         _endConditionBSON = BSON("$gte" << *(params.maxTs));
         _endCondition = stdx::make_unique<GTEMatchExpression>();
         invariantOK(_endCondition->init(repl::OpTime::kTimestampFieldName,
                                         _endConditionBSON.firstElement()));
     }
+
+    // Only plain forward scans may skip records: the other kinds look at records which fail the
+    // filter, or count them.
+    if (params.direction == CollectionScanParams::FORWARD && !_endCondition &&
+        !params.tailable && !params.shouldTrackLatestOplogTimestamp &&
+        !params.stopApplyingFilterAfterFirstMatch && 0 == params.maxScan) {
+        _skipPredicates = extractSkipPredicates(_filter);
+    }
 }
 
 /*
@@ -154,6 +227,14 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {//PlanStage::wo
         return PlanStage::IS_EOF;
     }
 
+    // The first record is always read from our own cursor, which positions the scan.
+    if (_params.shareOplogReads && !_lastSeenId.isNull()) {
+        StageState state;
+        if (readFromSharedOplogBuffer(out, &state)) {
+            return state;
+        }
+    }
+
     boost::optional<Record> record;
     const bool needToMakeCursor = !_cursor;
     try {
@@ -178,6 +259,9 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {//PlanStage::wo
 
 			//ʼCollectionScanα_cursorԱ  CollectiongetCursorõα
             _cursor = _params.collection->getCursor(getOpCtx(), forward);
+            if (!_skipPredicates.empty()) {
+                _cursor->setSkipPredicates(_skipPredicates);
+            }
 
             if (!_lastSeenId.isNull()) {
                 invariant(_params.tailable);
@@ -244,7 +328,7 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {//PlanStage::wo
 
     _lastSeenId = record->id;
     if (_params.shouldTrackLatestOplogTimestamp) {
-        auto status = setLatestOplogEntryTimestamp(*record);
+        auto status = setLatestOplogEntryTimestamp(record->data.toBson());
         if (!status.isOK()) {
             *out = WorkingSetCommon::allocateStatusMember(_workingSet, status);
             return PlanStage::FAILURE;
@@ -253,6 +337,42 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {//PlanStage::wo
 
 	//WorkingSetҵһõλ¼,WorkingSetMemberlocֶΪ¼idֶ,
 	//objֶμ¼bsonĵ
+    // Documents which fail the filter are tested straight from the cursor, so the rest of the
+    // plan never sees them and they cost neither a working set member nor a round trip through
+    // work(). The planner only offers a COLLSCAN to the multi-planner when no indexed solution
+    // exists, so the smaller number of works reported for it does not skew plan ranking.
+    bool matchedInBatch = false;
+    if (canScanInBatches()) {
+        size_t numTested = 1;
+        while (!matchesFilter(record->data.toBson())) {
+            ++_specificStats.docsTested;
+            if (numTested++ >= _batchSize) {
+                return PlanStage::NEED_TIME;
+            }
+
+            try {
+                if (auto fetcher = _cursor->fetcherForNext()) {
+                    WorkingSetMember* member = _workingSet->get(_wsidForFetch);
+                    member->setFetcher(fetcher.release());
+                    *out = _wsidForFetch;
+                    return PlanStage::NEED_YIELD;
+                }
+
+                record = _cursor->next();
+            } catch (const WriteConflictException&) {
+                *out = WorkingSet::INVALID_ID;
+                return PlanStage::NEED_YIELD;
+            }
+
+            if (!record) {
+                _commonStats.isEOF = true;
+                return PlanStage::IS_EOF;
+            }
+            _lastSeenId = record->id;
+        }
+        matchedInBatch = true;
+    }
+
     WorkingSetID id = _workingSet->allocate();
     WorkingSetMember* member = _workingSet->get(id);
     member->recordId = record->id;
@@ -260,24 +380,161 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {//PlanStage::wo
     member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), record->data.releaseToBson()};
     _workingSet->transitionToRecordIdAndObj(id);
 
+    if (matchedInBatch) {
+        ++_specificStats.docsTested;
+        *out = id;
+        return PlanStage::ADVANCED;
+    }
+
 	//returnIfMatches,鿴ȫɨļ¼ǷǵCollectionScanPlanStagefilter.
 	//򷵻ظPlanExecutorgetNext,.
     return returnIfMatches(member, id, out); //CollectionScan::returnIfMatches
 }
 
-Status CollectionScan::setLatestOplogEntryTimestamp(const Record& record) {
-    auto tsElem = record.data.toBson()[repl::OpTime::kTimestampFieldName];
+bool CollectionScan::matchesFilter(const BSONObj& obj) const {
+    return _topLevelComparisonMatcher ? _topLevelComparisonMatcher->matches(obj)
+                                      : _filter->matchesBSON(obj);
+}
+
+bool CollectionScan::canScanInBatches() const {
+    return _batchSize > 1 && _filter && !_endCondition && !_params.tailable &&
+        !_params.shouldTrackLatestOplogTimestamp && !_params.stopApplyingFilterAfterFirstMatch &&
+        0 == _params.maxScan;
+}
+
+Status CollectionScan::setLatestOplogEntryTimestamp(const BSONObj& obj) {
+    auto tsElem = obj[repl::OpTime::kTimestampFieldName];
     if (tsElem.type() != BSONType::bsonTimestamp) {
         Status status(ErrorCodes::InternalError,
                       str::stream() << "CollectionScan was asked to track latest operation time, "
                                        "but found a result without a valid 'ts' field: "
-                                    << record.data.toBson().toString());
+                                    << obj.toString());
         return status;
     }
     _latestOplogEntryTimestamp = std::max(_latestOplogEntryTimestamp, tsElem.timestamp());
     return Status::OK();
 }
 
+SharedOplogBuffer::FillPoint CollectionScan::currentFillPoint() const {
+    return {_params.collection->getCappedInsertNotifier()->getVersion(),
+            repl::ReplicationCoordinator::get(getOpCtx())->getCurrentCommittedSnapshotOpTime()};
+}
+
+bool CollectionScan::readFromSharedOplogBuffer(WorkingSetID* out, StageState* state) {
+    const size_t maxBytes = std::max(0, internalQuerySharedOplogBufferMaxBytes.load());
+    if (maxBytes == 0) {
+        return false;
+    }
+
+    if (_sharedBatchPos == _sharedBatch.size()) {
+        _sharedBatch.clear();
+        _sharedBatchPos = 0;
+
+        const size_t batchSize = std::max(1, internalQuerySharedOplogBufferBatchSize.load());
+        auto buffer = SharedOplogBuffer::get(getOpCtx()->getServiceContext());
+        auto fillPoint = currentFillPoint();
+        switch (buffer->read(getOpCtx(), _lastSeenId, fillPoint, batchSize, &_sharedBatch)) {
+            case SharedOplogBuffer::ReadResult::kNotCovered:
+                return false;
+            case SharedOplogBuffer::ReadResult::kCaughtUp:
+                break;
+            case SharedOplogBuffer::ReadResult::kMustFill:
+                if (!fillSharedOplogBuffer(buffer, fillPoint, out, state)) {
+                    return true;
+                }
+                break;
+            case SharedOplogBuffer::ReadResult::kRead:
+                _specificStats.docsFromSharedOplogBuffer += _sharedBatch.size();
+                break;
+        }
+
+        // Our cursor is no longer positioned at '_lastSeenId', so if we need to read from it
+        // again it must seek back to the last record we returned.
+        _cursor.reset();
+
+        if (_sharedBatch.empty()) {
+            // Tailable EOF: pick up after '_lastSeenId' on the next call to work().
+            *state = PlanStage::IS_EOF;
+            return true;
+        }
+    }
+
+    const auto& entry = _sharedBatch[_sharedBatchPos++];
+    _lastSeenId = entry.id;
+    if (_params.shouldTrackLatestOplogTimestamp) {
+        auto status = setLatestOplogEntryTimestamp(entry.obj);
+        if (!status.isOK()) {
+            *out = WorkingSetCommon::allocateStatusMember(_workingSet, status);
+            *state = PlanStage::FAILURE;
+            return true;
+        }
+    }
+
+    WorkingSetID id = _workingSet->allocate();
+    WorkingSetMember* member = _workingSet->get(id);
+    member->recordId = entry.id;
+    member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), entry.obj};
+    _workingSet->transitionToRecordIdAndObj(id);
+    *state = returnIfMatches(member, id, out);
+    return true;
+}
+
+bool CollectionScan::fillSharedOplogBuffer(SharedOplogBuffer* buffer,
+                                           const SharedOplogBuffer::FillPoint& fillPoint,
+                                           WorkingSetID* out,
+                                           StageState* state) {
+    const size_t batchSize = std::max(1, internalQuerySharedOplogBufferBatchSize.load());
+    bool published = false;
+    ON_BLOCK_EXIT([&] {
+        if (!published) {
+            buffer->abandonFill();
+        }
+    });
+
+    bool reachedEnd = false;
+    try {
+        // Read from a snapshot opened after 'fillPoint' was taken, so that everything it describes
+        // is visible to us: the window is only caught up to what the read could see.
+        _cursor.reset();
+        getOpCtx()->recoveryUnit()->abandonSnapshot();
+        _cursor = _params.collection->getCursor(getOpCtx(), true);
+        if (!_cursor->seekExact(_lastSeenId)) {
+            _isDead = true;
+            Status status(ErrorCodes::CappedPositionLost,
+                          str::stream() << "CollectionScan died due to failure to restore "
+                                        << "tailable cursor position. "
+                                        << "Last seen record id: "
+                                        << _lastSeenId);
+            *out = WorkingSetCommon::allocateStatusMember(_workingSet, status);
+            *state = PlanStage::DEAD;
+            return false;
+        }
+
+        while (_sharedBatch.size() < batchSize) {
+            auto record = _cursor->next();
+            if (!record) {
+                reachedEnd = true;
+                break;
+            }
+            _sharedBatch.push_back({record->id, record->data.releaseToBson().getOwned()});
+        }
+    } catch (const WriteConflictException&) {
+        _cursor.reset();
+        _sharedBatch.clear();
+        *out = WorkingSet::INVALID_ID;
+        *state = PlanStage::NEED_YIELD;
+        return false;
+    }
+
+    buffer->publish(_lastSeenId,
+                    fillPoint,
+                    _sharedBatch,
+                    reachedEnd,
+                    std::max(0, internalQuerySharedOplogBufferMaxBytes.load()));
+    published = true;
+    return true;
+}
+
 //鿴ȫɨļ¼ǷǵCollectionScanPlanStagefilter.
 //򷵻ظPlanExecutorgetNext,.
 PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
@@ -285,9 +542,10 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
                                                       WorkingSetID* out) {
     ++_specificStats.docsTested;
 
-    if (Filter::passes(member, _filter)) {
+    if (!_filter || matchesFilter(member->obj.value())) {
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
+            _topLevelComparisonMatcher.reset();
         }
         *out = memberID;
         return PlanStage::ADVANCED;
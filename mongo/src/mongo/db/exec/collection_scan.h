@@ -32,8 +32,11 @@
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/shared_oplog_buffer.h"
 #include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/top_level_comparison_matcher.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/record_id_zone_map.h"
 
 namespace mongo {
 
@@ -86,11 +89,43 @@ private:
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
     /**
-     * Extracts the timestamp from the 'ts' field of 'record', and sets '_latestOplogEntryTimestamp'
+     * Returns whether 'obj' passes '_filter', using '_topLevelComparisonMatcher' when there is one.
+     * '_filter' must not be null.
+     */
+    bool matchesFilter(const BSONObj& obj) const;
+
+    /**
+     * Extracts the timestamp from the 'ts' field of 'obj', and sets '_latestOplogEntryTimestamp'
      * to that time if it isn't already greater.  Returns an error if the 'ts' field cannot be
      * extracted.
      */
-    Status setLatestOplogEntryTimestamp(const Record& record);
+    Status setLatestOplogEntryTimestamp(const BSONObj& obj);
+
+    /**
+     * Returns true and sets 'state' if the next record of a scan sharing its oplog reads could be
+     * taken from, or read into, the SharedOplogBuffer. Returns false if the scan must read the
+     * next record from its own cursor.
+     */
+    bool readFromSharedOplogBuffer(WorkingSetID* out, StageState* state);
+
+    /**
+     * Reads the batch of records following '_lastSeenId' from the oplog into '_sharedBatch' and
+     * publishes it to 'buffer'. Returns false and sets 'state' if the batch could not be read.
+     */
+    bool fillSharedOplogBuffer(SharedOplogBuffer* buffer,
+                               const SharedOplogBuffer::FillPoint& fillPoint,
+                               WorkingSetID* out,
+                               StageState* state);
+
+    SharedOplogBuffer::FillPoint currentFillPoint() const;
+
+    /**
+     * Returns true if records which fail '_filter' can be skipped in a tight loop over the cursor,
+     * without going through the working set or returning NEED_TIME for each of them. This is only
+     * the case for plain filtered scans: tailable, oplog-tracking, 'maxScan' and end-condition
+     * scans need to look at every record individually.
+     */
+    bool canScanInBatches() const;
     /*
     WorkingSetID id = _workingSet->allocate();
     WorkingSetMember* member = _workingSet->get(id);
@@ -102,6 +137,10 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // A faster evaluator for '_filter', if it only compares top-level fields. Null otherwise, and
+    // once '_filter' stops being applied.
+    std::unique_ptr<TopLevelComparisonMatcher> _topLevelComparisonMatcher;
+
     // If a document does not pass '_filter' but passes '_endCondition', stop scanning and return
     // IS_EOF.
     BSONObj _endConditionBSON;
@@ -115,15 +154,27 @@ private:
 
     RecordId _lastSeenId;  // Null if nothing has been returned from _cursor yet.
 
+    // Comparisons that every record passing '_filter' satisfies, handed to the cursor so that the
+    // storage engine can skip ranges of records. Empty if the scan must see every record.
+    std::vector<ZoneMapPredicate> _skipPredicates;
+
     // We allocate a working set member with this id on construction of the stage. It gets used for
     // all fetch requests. This should only be used for passing up the Fetcher for a NEED_YIELD, and
     // should remain in the INVALID state.
     const WorkingSetID _wsidForFetch;
 
+    // Maximum number of records tested per call to work() when canScanInBatches() is true. Read
+    // from internalQueryExecCollectionScanBatchSize at construction.
+    size_t _batchSize;
+
     // If _params.shouldTrackLatestOplogTimestamp is set and the collection is the oplog, the latest
     // timestamp seen in the collection.  Otherwise, this is a null timestamp.
     Timestamp _latestOplogEntryTimestamp;
 
+    // Records taken from the SharedOplogBuffer which have not been returned yet.
+    std::vector<SharedOplogBuffer::Entry> _sharedBatch;
+    size_t _sharedBatchPos = 0;
+
     // Stats   CollectionScanӦstageͳ
     CollectionScanStats _specificStats;
 };
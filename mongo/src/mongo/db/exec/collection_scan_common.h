@@ -69,6 +69,10 @@ struct CollectionScanParams {
     // This is useful for oplog queries where we know we will see records ordered by the ts field.
     bool stopApplyingFilterAfterFirstMatch = false;
 
+    // Should a tailable, forward scan of the replica set oplog read its records through the
+    // node-wide SharedOplogBuffer? Only valid when reading from the majority committed snapshot.
+    bool shareOplogReads = false;
+
     // If non-zero, how many documents will we look at?
     size_t maxScan = 0; //db.collection.find( { $query: { <query> }, $maxScan: <number> } 
 };
@@ -140,6 +140,8 @@ PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
     }
 
     WorkingSetID id = _workingSet->allocate();
+    // The RecordId lets a parent OR stage dedup across count scans over a multikey index.
+    _workingSet->get(id)->recordId = entry->loc;
     _workingSet->transitionToRecordIdAndObj(id);
     *out = id;
     return PlanStage::ADVANCED;
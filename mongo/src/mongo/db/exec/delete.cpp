@@ -92,6 +92,10 @@ bool DeleteStage::isEOF() {
     if (!_params.isMulti && _specificStats.docsDeleted > 0) {
         return true;
     }
+    if (_params.maxDocsToDelete > 0 &&
+        static_cast<long long>(_specificStats.docsDeleted) >= _params.maxDocsToDelete) {
+        return true;
+    }
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
         child()->isEOF();
 }
@@ -186,6 +190,7 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
     if (!docStillMatches) {
         // Either the document has already been deleted, or it has been updated such that it no
         // longer matches the predicate.
+        _conflictTurn.reset();
         if (shouldRestartDeleteIfNoLongerMatches(_params)) {
             throw WriteConflictException();
         }
@@ -229,6 +234,7 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
             return prepareToRetryWSM(id, out);
         }
     }
+    _conflictTurn.reset();
     ++_specificStats.docsDeleted;
 
     if (_params.returnDeleted) {
@@ -303,6 +309,13 @@ long long DeleteStage::getNumDeleted(const PlanExecutor& exec) {
 
 PlanStage::StageState DeleteStage::prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out) {
     _idRetrying = idToRetry;
+    if (!_conflictTurn || !_conflictTurn->granted()) {
+        // Wait behind the writers already retrying this document, so that the retry after the
+        // yield reads their committed changes instead of conflicting with them again.
+        _conflictTurn.reset();
+        _conflictTurn = stdx::make_unique<WriteConflictQueue::Turn>(
+            getOpCtx(), _collection->ns().ns(), _ws->get(idToRetry)->recordId);
+    }
     *out = WorkingSet::INVALID_ID;
     return NEED_YIELD;
 }
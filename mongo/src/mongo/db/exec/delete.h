@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include "mongo/db/concurrency/write_conflict_queue.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/logical_session_id.h"
@@ -52,6 +53,9 @@ struct DeleteStageParams {
     // (a "single delete")?
     bool isMulti;
 
+    // If positive, a multi delete reports EOF once it has deleted this many documents.
+    long long maxDocsToDelete = 0;
+
     // Is this delete part of a migrate operation that is essentially like a no-op
     // when the cluster is observed by an external client.
     bool fromMigrate;
@@ -138,6 +142,10 @@ private:
     // If not WorkingSet::INVALID_ID, we return this member to our caller.
     WorkingSetID _idReturning;
 
+    // Our place among the writers retrying the document in '_idRetrying' after a write conflict.
+    // Held from the conflict until the retried delete commits.
+    std::unique_ptr<WriteConflictQueue::Turn> _conflictTurn;
+
     // Stats
     DeleteStats _specificStats;
 };
@@ -35,7 +35,11 @@
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/storage/record_fetcher.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/mongoutils/str.h"
@@ -77,12 +81,19 @@ FetchStage::FetchStage(OperationContext* opCtx,
       _filter(filter),
       _idRetrying(WorkingSet::INVALID_ID) {
     _children.emplace_back(child);
+
+    // Batching only helps storage engines which read records through their own cache. MMAPv1
+    // relies on fetchers to take page faults outside the lock, one record at a time.
+    auto storageEngine = opCtx->getServiceContext()->getGlobalStorageEngine();
+    if (storageEngine && storageEngine->supportsDocLocking()) {
+        _batchSize = static_cast<size_t>(std::max(0, internalQueryExecFetchBatchSize.load()));
+    }
 }
 
 FetchStage::~FetchStage() {}
 
 bool FetchStage::isEOF() {
-    if (WorkingSet::INVALID_ID != _idRetrying) {
+    if (WorkingSet::INVALID_ID != _idRetrying || !_batch.empty()) {
         // We asked the parent for a page-in, but still haven't had a chance to return the
         // paged in document
         return false;
@@ -130,12 +141,30 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     StageState status;
-    if (_idRetrying == WorkingSet::INVALID_ID) {
-        status = child()->work(&id); //ʵǵIndexScan::doWork
-    } else {
+    bool prefetched = false;
+    if (_idRetrying != WorkingSet::INVALID_ID) {
         status = ADVANCED;
         id = _idRetrying;
         _idRetrying = WorkingSet::INVALID_ID;
+    } else if (_batchFetched) {
+        // Hand out a fetched batch in the order the child produced it, not in RecordId order.
+        status = ADVANCED;
+        id = _batch.front().id;
+        prefetched = _batch.front().prefetched;
+        _batch.pop_front();
+        _batchFetched = !_batch.empty();
+    } else if (!_batch.empty() && (_batch.size() >= _batchSize || child()->isEOF())) {
+        return fetchBatch(out);
+    } else {
+        status = child()->work(&id); //ʵǵIndexScan::doWork
+        if (PlanStage::ADVANCED == status && shouldBatch()) {
+            _batch.push_back({id, false});
+            return NEED_TIME;
+        }
+        if (PlanStage::IS_EOF == status && !_batch.empty()) {
+            // The rest of the batch still has to be fetched and returned.
+            return NEED_TIME;
+        }
     }
 
     if (PlanStage::ADVANCED == status) {
@@ -143,7 +172,9 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
 
         // If there's an obj there, there is no fetching to perform.
         if (member->hasObj()) {
-            ++_specificStats.alreadyHasObj;
+            if (!prefetched) {
+                ++_specificStats.alreadyHasObj;
+            }
         } else {
             // We need a valid RecordId to fetch from and this is the only state that has one.
             verify(WorkingSetMember::RID_AND_IDX == member->getState());
@@ -232,6 +263,77 @@ void FetchStage::doInvalidate(OperationContext* opCtx, const RecordId& dl, Inval
             WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, _collection);
         }
     }
+
+    for (auto&& buffered : _batch) {
+        WorkingSetMember* member = _ws->get(buffered.id);
+        if (member->hasRecordId() && (member->recordId == dl)) {
+            WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, _collection);
+        }
+    }
+}
+
+bool FetchStage::shouldBatch() const {
+    // Leave the first results unbatched, so that multi-planner trials and small limits are not
+    // delayed by buffering, and ranked exactly as before.
+    return _batchSize > 1 &&
+        _commonStats.advanced >= static_cast<size_t>(internalQueryPlanEvaluationMaxResults.load());
+}
+
+PlanStage::StageState FetchStage::fetchBatch(WorkingSetID* out) {
+    // Pairs of (RecordId, position in '_batch') for the members which still need a document.
+    // Suspicious members are left to the one-at-a-time path, which revalidates their index keys.
+    std::vector<std::pair<RecordId, size_t>> toFetch;
+    for (size_t i = 0; i < _batch.size(); ++i) {
+        WorkingSetMember* member = _ws->get(_batch[i].id);
+        if (!member->hasObj() && !member->isSuspicious) {
+            toFetch.emplace_back(member->recordId, i);
+        }
+    }
+    std::sort(toFetch.begin(), toFetch.end());
+
+    std::vector<RecordId> ids;
+    ids.reserve(toFetch.size());
+    for (auto&& entry : toFetch) {
+        ids.push_back(entry.first);
+    }
+
+    std::vector<Record> records;
+    try {
+        if (!_cursor)
+            _cursor = _collection->getCursor(getOpCtx());
+
+        _cursor->seekExactBatch(ids, &records);
+    } catch (const WriteConflictException&) {
+        // The batch is still intact, so it is simply fetched again after the yield.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    // Both 'toFetch' and 'records' are in RecordId order. Members whose record was not found keep
+    // their RecordId and are dropped by the one-at-a-time path when they are handed out.
+    const SnapshotId snapshotId = getOpCtx()->recoveryUnit()->getSnapshotId();
+    auto record = records.begin();
+    for (auto&& entry : toFetch) {
+        while (record != records.end() && record->id < entry.first) {
+            ++record;
+        }
+        if (record == records.end()) {
+            break;
+        }
+        if (record->id != entry.first) {
+            continue;
+        }
+
+        BufferedMember& buffered = _batch[entry.second];
+        WorkingSetMember* member = _ws->get(buffered.id);
+        member->obj = {snapshotId, record->data.toBson()};
+        member->keyData.clear();
+        _ws->transitionToRecordIdAndObj(buffered.id);
+        buffered.prefetched = true;
+    }
+
+    _batchFetched = true;
+    return NEED_TIME;
 }
 
 //FetchStage::doWork
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 
 #include "mongo/db/exec/plan_stage.h"
@@ -101,6 +102,19 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * Returns true if members produced by the child should be buffered for a batched fetch
+     * rather than fetched as soon as they arrive.
+     */
+    bool shouldBatch() const;
+
+    /**
+     * Looks up the documents of every buffered member which still needs one, in RecordId order,
+     * and then starts handing the batch out. Returns NEED_TIME, or NEED_YIELD on a write
+     * conflict, in which case the batch is fetched again after the yield.
+     */
+    StageState fetchBatch(WorkingSetID* out);
+
     // Collection which is used by this stage. Used to resolve record ids retrieved by child
     // stages. The lifetime of the collection must supersede that of the stage.
     const Collection* _collection;
@@ -118,6 +132,22 @@ private:
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
+    struct BufferedMember {
+        WorkingSetID id;
+
+        // Whether fetchBatch() has already attached the document to this member.
+        bool prefetched;
+    };
+
+    // Set from internalQueryExecFetchBatchSize at construction, or zero if batching is disabled.
+    size_t _batchSize = 0;
+
+    // Members buffered from the child for a batched fetch, in the order the child produced them.
+    std::deque<BufferedMember> _batch;
+
+    // True while '_batch' has been fetched and is being handed out.
+    bool _batchFetched = false;
+
     // Stats
     FetchStats _specificStats;
 };
@@ -38,6 +38,7 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/index/btree_access_method.h"
+#include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 
@@ -235,7 +236,13 @@ bool IDHackStage::supportsQuery(Collection* collection, const CanonicalQuery& qu
         //_idѯ
         CanonicalQuery::isSimpleIdQuery(query.getQueryRequest().getFilter()) &&
         !query.getQueryRequest().isTailable() &&
-        CollatorInterface::collatorsMatch(query.getCollator(), collection->getDefaultCollator());
+        (CollatorInterface::collatorsMatch(query.getCollator(), collection->getDefaultCollator()) ||
+         isCollationIndependent(query.getQueryRequest().getFilter()));
+}
+
+// static
+bool IDHackStage::isCollationIndependent(const BSONObj& query) {
+    return !CollationIndexKey::isCollatableType(query["_id"].type());
 }
 
 unique_ptr<PlanStageStats> IDHackStage::getStats() {
@@ -77,6 +77,13 @@ public:
      */
     static bool supportsQuery(Collection* collection, const CanonicalQuery& query);
 
+    /**
+     * Returns true if the _id equality in the simple _id query 'query' matches the same document
+     * under any collation, so the _id index can answer it even when its collation differs from
+     * the query's. This holds for _id values such as numbers and ObjectIds, which hold no strings.
+     */
+    static bool isCollationIndependent(const BSONObj& query);
+
     StageType stageType() const final {
         return STAGE_IDHACK;
     }
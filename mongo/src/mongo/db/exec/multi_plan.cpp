@@ -38,17 +38,26 @@
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/index_scan.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/record_fetcher.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/stdx/unordered_set.h"
+#include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -61,6 +70,157 @@ using stdx::make_unique;
 // static
 const char* MultiPlanStage::kStageType = "MULTI_PLAN";
 
+namespace {
+
+// Holds a trial period which registered itself for single-flight planning until disabled.
+MONGO_FP_DECLARE(hangAfterRegisteringSingleFlightTrial);
+
+/**
+ * The set of shapes whose trial period is currently being run by some MultiPlanStage. Entries are
+ * keyed by namespace as well as plan cache key, rather than kept in the collection's PlanCache,
+ * because the collection can be dropped while the owning trial is yielded.
+ */
+class SingleFlightTrials {
+public:
+    /**
+     * Returns true if the caller now owns the trial for 'key' and must call end() for it.
+     */
+    bool tryBegin(const std::string& key) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _inProgress.insert(key).second;
+    }
+
+    void end(const std::string& key) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _inProgress.erase(key);
+        }
+        _trialEnded.notify_all();
+    }
+
+    /**
+     * Returns false without blocking if no trial is running for 'key'.
+     */
+    bool waitFor(OperationContext* opCtx, const std::string& key, Milliseconds maxWait) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        if (!_inProgress.count(key)) {
+            return false;
+        }
+        opCtx->waitForConditionOrInterruptFor(
+            _trialEnded, lk, maxWait, [&] { return !_inProgress.count(key); });
+        return true;
+    }
+
+private:
+    stdx::mutex _mutex;
+    stdx::condition_variable _trialEnded;
+    stdx::unordered_set<std::string> _inProgress;
+};
+
+SingleFlightTrials singleFlightTrials;
+
+std::string makeSingleFlightKey(const Collection* collection, const CanonicalQuery& query) {
+    return collection->ns().ns() + '\0' +
+        collection->infoCache()->getPlanCache()->computeKey(query);
+}
+
+/**
+ * Estimated number of index keys or documents a candidate plan examines. When a count stopped at
+ * internalQueryPlanCardinalityEstimateMaxKeys, 'exact' is false and 'count' is a lower bound.
+ */
+struct CardinalityEstimate {
+    long long count = 0;
+    bool exact = true;
+};
+
+// Estimates for the index scans of the candidates, keyed on index name and bounds, so that a scan
+// shared by several candidates, such as the children of an intersection plan, is counted once.
+using IndexScanEstimates = stdx::unordered_map<std::string, boost::optional<CardinalityEstimate>>;
+
+/**
+ * Counts the keys within the bounds of 'ixn', examining at most 'maxKeys' keys. Returns
+ * boost::none if the count could not complete without yielding.
+ */
+boost::optional<CardinalityEstimate> estimateIndexScan(OperationContext* opCtx,
+                                                       const Collection* collection,
+                                                       const IndexScanNode* ixn,
+                                                       size_t maxKeys) {
+    IndexScanParams params;
+    params.descriptor = collection->getIndexCatalog()->findIndexByName(opCtx, ixn->index.name);
+    if (!params.descriptor) {
+        return boost::none;
+    }
+    params.bounds = ixn->bounds;
+    params.direction = ixn->direction;
+    params.doNotDedup = true;
+    params.maxScan = maxKeys;
+
+    WorkingSet ws;
+    IndexScan scan(opCtx, params, &ws, nullptr);
+    CardinalityEstimate estimate;
+    for (;;) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state = scan.work(&id);
+        if (PlanStage::ADVANCED == state) {
+            ++estimate.count;
+            ws.free(id);
+        } else if (PlanStage::IS_EOF == state) {
+            break;
+        } else if (PlanStage::NEED_TIME != state) {
+            return boost::none;
+        }
+    }
+
+    const IndexScanStats* stats = static_cast<const IndexScanStats*>(scan.getSpecificStats());
+    estimate.exact = stats->keysExamined < maxKeys;
+    return estimate;
+}
+
+/**
+ * Estimates how many keys and documents the plan rooted at 'node' examines, as the sum over its
+ * index and collection scans. Returns boost::none if the plan has a leaf that cannot be
+ * estimated, such as a text or geo-near stage.
+ */
+boost::optional<CardinalityEstimate> estimateSolution(OperationContext* opCtx,
+                                                      const Collection* collection,
+                                                      const QuerySolutionNode* node,
+                                                      size_t maxKeys,
+                                                      IndexScanEstimates* indexScanEstimates) {
+    if (STAGE_IXSCAN == node->getType()) {
+        const IndexScanNode* ixn = static_cast<const IndexScanNode*>(node);
+        std::string key = ixn->index.name + '\0' + ixn->bounds.toString();
+        auto it = indexScanEstimates->find(key);
+        if (it == indexScanEstimates->end()) {
+            it = indexScanEstimates
+                     ->emplace(std::move(key),
+                               estimateIndexScan(opCtx, collection, ixn, maxKeys))
+                     .first;
+        }
+        return it->second;
+    }
+    if (STAGE_COLLSCAN == node->getType()) {
+        CardinalityEstimate estimate;
+        estimate.count = collection->numRecords(opCtx);
+        return estimate;
+    }
+    if (node->children.empty()) {
+        return boost::none;
+    }
+
+    CardinalityEstimate total;
+    for (auto&& child : node->children) {
+        auto estimate = estimateSolution(opCtx, collection, child, maxKeys, indexScanEstimates);
+        if (!estimate) {
+            return boost::none;
+        }
+        total.count += estimate->count;
+        total.exact = total.exact && estimate->exact;
+    }
+    return total;
+}
+
+}  // namespace
+
 MultiPlanStage::MultiPlanStage(OperationContext* opCtx,
                                const Collection* collection,
                                CanonicalQuery* cq,
@@ -83,6 +243,58 @@ void MultiPlanStage::addPlan(QuerySolution* solution, PlanStage* root, WorkingSe
     _children.emplace_back(root); //PlanStage._children
 }
 
+void MultiPlanStage::pruneCandidatesByEstimatedCardinality() {
+    const int maxKeys = internalQueryPlanCardinalityEstimateMaxKeys.load();
+    if (maxKeys <= 0 || _candidates.size() < 2) {
+        return;
+    }
+
+    // A plan that examines many keys can still win when it provides the requested sort order.
+    if (!_query->getQueryRequest().getSort().isEmpty()) {
+        return;
+    }
+
+    IndexScanEstimates indexScanEstimates;
+    std::vector<boost::optional<CardinalityEstimate>> estimates;
+    boost::optional<long long> bestExactCount;
+    for (auto&& candidate : _candidates) {
+        estimates.push_back(estimateSolution(getOpCtx(),
+                                             _collection,
+                                             candidate.solution->root.get(),
+                                             static_cast<size_t>(maxKeys),
+                                             &indexScanEstimates));
+        const auto& estimate = estimates.back();
+        if (estimate && estimate->exact && (!bestExactCount || estimate->count < *bestExactCount)) {
+            bestExactCount = estimate->count;
+        }
+    }
+
+    // Without a complete count for at least one candidate, there is nothing to compare against.
+    if (!bestExactCount) {
+        return;
+    }
+
+    const double threshold = internalQueryPlanCardinalityPruneRatio.load() *
+        std::max(*bestExactCount, static_cast<long long>(1));
+    std::vector<CandidatePlan> keptCandidates;
+    Children keptChildren;
+    for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+        if (estimates[ix] && estimates[ix]->count > threshold) {
+            LOG(2) << "Pruning candidate plan " << ix << " before the trial period, estimated "
+                   << (estimates[ix]->exact ? "" : "at least ") << estimates[ix]->count
+                   << " keys examined versus " << *bestExactCount << " for the best candidate: "
+                   << redact(Explain::getPlanSummary(_candidates[ix].root));
+            continue;
+        }
+        keptCandidates.push_back(std::move(_candidates[ix]));
+        keptChildren.push_back(std::move(_children[ix]));
+    }
+    invariant(!keptCandidates.empty());
+
+    _candidates = std::move(keptCandidates);
+    _children = std::move(keptChildren);
+}
+
 bool MultiPlanStage::isEOF() {
     if (_failure) {
         return true;
@@ -223,6 +435,17 @@ size_t MultiPlanStage::getTrialPeriodNumToReturn(const CanonicalQuery& query) {
     return numResults;
 }
 
+bool MultiPlanStage::waitForConcurrentTrial(OperationContext* opCtx,
+                                            const Collection* collection,
+                                            const CanonicalQuery& query) {
+    if (!internalQueryPlanSingleFlightEnabled.load()) {
+        return false;
+    }
+
+    const Milliseconds maxWait(internalQueryPlanSingleFlightMaxWaitMillis.load());
+    return singleFlightTrials.waitFor(opCtx, makeSingleFlightKey(collection, query), maxWait);
+}
+
 //MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy)еPlanRanker::pickBestPlan(const vector<CandidatePlan>& candidates, PlanRankingDecision* why)
 /*
 lldbջ
@@ -249,11 +472,35 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // make sense.
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis); 
 
+    pruneCandidatesByEstimatedCardinality();
+
 	//ȡcollectionܼ¼*0.2910000Сɨ10000Σ10000ôɨcollection*0.29Ρ  
     size_t numWorks = getTrialPeriodWorks(getOpCtx(), _collection);
 	//ȡNToReturn  limit internalQueryPlanEvaluationMaxResultsСֵ
     size_t numResults = getTrialPeriodNumToReturn(*_query);
 
+    // Only the first of several concurrent trials of an uncached shape registers itself, so that
+    // queries which arrive while it runs can wait for its winner in waitForConcurrentTrial().
+    if (_cachingMode != CachingMode::NeverCache && internalQueryPlanSingleFlightEnabled.load() &&
+        PlanCache::shouldCacheQuery(*_query)) {
+        std::string key = makeSingleFlightKey(_collection, *_query);
+        if (singleFlightTrials.tryBegin(key)) {
+            _singleFlightKey = std::move(key);
+        }
+    }
+    ON_BLOCK_EXIT([&] {
+        if (!_singleFlightKey.empty()) {
+            singleFlightTrials.end(_singleFlightKey);
+            _singleFlightKey.clear();
+        }
+    });
+    if (!_singleFlightKey.empty()) {
+        MONGO_FAIL_POINT_PAUSE_WHILE_SET(hangAfterRegisteringSingleFlightTrial);
+    }
+
+    const int maxMillis = internalQueryPlanEvaluationMaxMillis.load();
+    const Date_t deadline = maxMillis > 0 ? getClock()->now() + Milliseconds(maxMillis) : Date_t();
+
     // Work the plans, stopping when a plan hits EOF or returns some
     // fixed number of results.
     for (size_t ix = 0; ix < numWorks; ++ix) {
@@ -263,6 +510,12 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
         if (!moreToDo) {
             break;
         }
+
+        if (maxMillis > 0 && getClock()->now() >= deadline) {
+            LOG(1) << "Ending trial period after " << maxMillis << "ms and " << ix + 1
+                   << " works: " << redact(_query->toStringShort());
+            break;
+        }
     }
 
     if (_failure) {
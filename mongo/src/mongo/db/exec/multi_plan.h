@@ -129,6 +129,19 @@ public:
      */
     static size_t getTrialPeriodNumToReturn(const CanonicalQuery& query);
 
+    /**
+     * If single-flight planning is enabled and another MultiPlanStage is currently running the
+     * trial period for the shape of 'query' on 'collection', blocks until that trial finishes or
+     * internalQueryPlanSingleFlightMaxWaitMillis elapses, so that the caller can use the winner
+     * it caches rather than run an identical trial of its own.
+     *
+     * Returns true if the caller waited, in which case it should look in the plan cache again.
+     * The caller must hold the collection lock.
+     */
+    static bool waitForConcurrentTrial(OperationContext* opCtx,
+                                       const Collection* collection,
+                                       const CanonicalQuery& query);
+
     /** Return true if a best plan has been chosen  */
     bool bestPlanChosen() const;
 
@@ -171,6 +184,14 @@ private:
      */
     bool workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * If internalQueryPlanCardinalityEstimateMaxKeys is positive, counts the keys within the bounds
+     * of each candidate's index scans, up to that limit, and drops the candidates that would
+     * examine more than internalQueryPlanCardinalityPruneRatio times as many keys as the
+     * candidate with the smallest complete count. Candidates that cannot be estimated are kept.
+     */
+    void pruneCandidatesByEstimatedCardinality();
+
     /**
      * Checks whether we need to perform either a timing-based yield or a yield for a document
      * fetch. If so, then uses 'yieldPolicy' to actually perform the yield.
@@ -235,6 +256,10 @@ private:
     // returned by ::work()
     WorkingSetID _statusMemberId;
 
+    // Namespace-qualified plan cache key of the shape whose single-flight trial this stage is
+    // running, or empty if it does not own one.
+    std::string _singleFlightKey;
+
     // When a stage requests a yield for document fetch, it gives us back a RecordFetcher*
     // to use to pull the record into memory. We take ownership of the RecordFetcher here,
     // deleting it after we've had a chance to do the fetch. For timing-based yields, we
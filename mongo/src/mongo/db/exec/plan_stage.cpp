@@ -32,8 +32,10 @@
 
 #include "mongo/db/exec/plan_stage.h"
 
+#include "mongo/db/curop.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context.h"
 
 #define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
@@ -102,7 +104,10 @@ FETCH
 //MultiPlanStage::workAllPlans(ѡ)  PlanExecutor::getNextImpl(ȡʵ)ִ
 PlanStage::StageState PlanStage::work(WorkingSetID* out) {   //ڸStageStateݹõ
     invariant(_opCtx);
-    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    boost::optional<ScopedTimer> timer;
+    if (_timingEnabled) {
+        timer.emplace(getClock(), &_commonStats.executionTimeMillis);
+    }
     ++_commonStats.works;
 
 	//StageType type = this->stageType();
@@ -122,6 +127,16 @@ PlanStage::StageState PlanStage::work(WorkingSetID* out) {   //
     return workResult;
 }
 
+PlanStage::PlanStage(const char* typeName, OperationContext* opCtx)
+    : _commonStats(typeName), _opCtx(opCtx), _timingEnabled(_shouldTime(opCtx)) {}
+
+bool PlanStage::_shouldTime(OperationContext* opCtx) {
+    if (!opCtx || internalQueryExecAlwaysTimeStages.load()) {
+        return true;
+    }
+    return CurOp::get(opCtx)->shouldCollectDetailedExecStats();
+}
+
 void PlanStage::saveState() {
     ++_commonStats.yields;
     for (auto&& child : _children) {
@@ -163,6 +178,8 @@ void PlanStage::detachFromOperationContext() {
 void PlanStage::reattachToOperationContext(OperationContext* opCtx) {
     invariant(_opCtx == nullptr);
     _opCtx = opCtx;
+    // A getMore may be explained or profiled where the operation which created the plan was not.
+    _timingEnabled = _timingForced || _shouldTime(opCtx);
 
     for (auto&& child : _children) {
         child->reattachToOperationContext(opCtx);
@@ -106,8 +106,7 @@ class RecordId;
 //PlanStageԲοprepareExecution->StageBuilder::build->buildStages
 class PlanStage { //ֵprepareExecution StageBuilder::build,ݲѯƻɼƻ׶PlanStage,ÿѯƻӦһƻ׶.
 public:
-    PlanStage(const char* typeName, OperationContext* opCtx)
-        : _commonStats(typeName), _opCtx(opCtx) {}
+    PlanStage(const char* typeName, OperationContext* opCtx);
 
     virtual ~PlanStage() {}
 
@@ -332,6 +331,15 @@ public:
         return &_commonStats;
     }
 
+    /**
+     * Makes work() time itself even when the operation does not report detailed statistics. The
+     * PlanExecutor does this for the root of its plan, whose time the summary statistics report.
+     */
+    void enableTiming() {
+        _timingForced = true;
+        _timingEnabled = true;
+    }
+
     /**
      * Get stats specific to this stage. Some stages may not have specific stats, in which
      * case they return NULL. The pointer is *not* owned by the caller.
@@ -399,7 +407,18 @@ protected:
     CommonStats _commonStats;
 
 private:
+    /**
+     * Returns true if stages run by 'opCtx' should time their work() calls. Reading the clock
+     * twice per call to work() is measurable on CPU-bound plans, so stages below the root only do
+     * when someone may look at their time.
+     */
+    static bool _shouldTime(OperationContext* opCtx);
+
     OperationContext* _opCtx;
+
+    // Whether work() adds its duration to _commonStats.executionTimeMillis.
+    bool _timingEnabled;
+    bool _timingForced = false;
 };
 
 }  // namespace mongo
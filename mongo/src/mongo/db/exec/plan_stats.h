@@ -301,6 +301,10 @@ struct CollectionScanStats : public SpecificStats {
     // sees a document that does not pass the filter and has a "ts" Timestamp field greater than
     // 'maxTs'.
     boost::optional<Timestamp> maxTs;
+
+    // How many of the documents tested were taken from the SharedOplogBuffer rather than read
+    // from the oplog by this scan?
+    size_t docsFromSharedOplogBuffer = 0;
 };
 
 struct CountStats : public SpecificStats {
@@ -614,7 +618,7 @@ struct ProjectionStats : public SpecificStats {
 };
 
 struct SortStats : public SpecificStats {
-    SortStats() : forcedFetches(0), memUsage(0), memLimit(0) {}
+    SortStats() : forcedFetches(0), memUsage(0), memLimit(0), usedDisk(false) {}
 
     SpecificStats* clone() const final {
         SortStats* specific = new SortStats(*this);
@@ -630,6 +634,9 @@ struct SortStats : public SpecificStats {
     // What's our memory limit?
     size_t memLimit;
 
+    // Did the sort outgrow the memory limit and continue in temporary files?
+    bool usedDisk;
+
     // The number of results to return from the sort.
     size_t limit;
 
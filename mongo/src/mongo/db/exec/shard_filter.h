@@ -28,8 +28,11 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/s/metadata_manager.h"
+#include "mongo/s/shard_key_pattern.h"
 
 namespace mongo {
 
@@ -98,6 +101,10 @@ private:
     // Note: it is important that this is the metadata from the time this stage is constructed.
     // See class comment for details.
     ScopedCollectionMetadata _metadata;
+
+    // Shard key pattern of '_metadata', parsed once rather than for every document. Unset if the
+    // collection is not sharded.
+    boost::optional<ShardKeyPattern> _shardKeyPattern;
 };
 
 }  // namespace mongo
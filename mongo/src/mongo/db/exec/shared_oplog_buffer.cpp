@@ -0,0 +1,139 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/shared_oplog_buffer.h"
+
+#include <algorithm>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getSharedOplogBuffer = ServiceContext::declareDecoration<SharedOplogBuffer>();
+
+}  // namespace
+
+SharedOplogBuffer* SharedOplogBuffer::get(ServiceContext* service) {
+    return &getSharedOplogBuffer(service);
+}
+
+SharedOplogBuffer::ReadResult SharedOplogBuffer::read(OperationContext* opCtx,
+                                                      const RecordId& after,
+                                                      const FillPoint& current,
+                                                      size_t maxEntries,
+                                                      std::vector<Entry>* out) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (true) {
+        if ((_coveredTo.isNull() || after > _coveredTo) && !_filling) {
+            // The window is empty, or every reader which used it has moved past it. Start it again
+            // from this reader's position.
+            _entries.clear();
+            _bytes = 0;
+            _coveredFrom = RecordId();
+            _coveredTo = RecordId();
+            _caughtUpAt = boost::none;
+            _filling = true;
+            return ReadResult::kMustFill;
+        }
+
+        if (_coveredTo.isNull() || after < _coveredFrom || after > _coveredTo) {
+            return ReadResult::kNotCovered;
+        }
+
+        if (after < _coveredTo) {
+            auto it = std::upper_bound(
+                _entries.begin(), _entries.end(), after, [](const RecordId& id, const Entry& e) {
+                    return id < e.id;
+                });
+            for (; it != _entries.end() && out->size() < maxEntries; ++it) {
+                out->push_back(*it);
+            }
+            return ReadResult::kRead;
+        }
+
+        // The reader is at the end of the window.
+        if (_filling) {
+            opCtx->waitForConditionOrInterrupt(_fillDone, lk);
+            continue;
+        }
+        if (_caughtUpAt && *_caughtUpAt == current) {
+            return ReadResult::kCaughtUp;
+        }
+        _filling = true;
+        return ReadResult::kMustFill;
+    }
+}
+
+void SharedOplogBuffer::publish(const RecordId& after,
+                                const FillPoint& fillPoint,
+                                const std::vector<Entry>& entries,
+                                bool reachedEnd,
+                                size_t maxBytes) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(_filling);
+    if (_coveredTo.isNull()) {
+        _coveredFrom = after;
+        _coveredTo = after;
+    }
+    invariant(after == _coveredTo);
+
+    for (auto&& entry : entries) {
+        invariant(entry.id > _coveredTo);
+        _entries.push_back(entry);
+        _bytes += entry.obj.objsize();
+        _coveredTo = entry.id;
+    }
+    while (_bytes > maxBytes && !_entries.empty()) {
+        _bytes -= _entries.front().obj.objsize();
+        _coveredFrom = _entries.front().id;
+        _entries.pop_front();
+    }
+
+    _caughtUpAt = reachedEnd ? boost::make_optional(fillPoint) : boost::none;
+    _filling = false;
+    _fillDone.notify_all();
+}
+
+void SharedOplogBuffer::abandonFill() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(_filling);
+    _filling = false;
+    _fillDone.notify_all();
+}
+
+size_t SharedOplogBuffer::getBytesBuffered() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _bytes;
+}
+
+}  // namespace mongo
@@ -0,0 +1,155 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * A node-wide window over the most recent entries of the replica set oplog, shared by the tailable
+ * collection scans of every change stream on the node.
+ *
+ * Without it, each change stream reads and copies every oplog entry out of the storage engine on
+ * its own. With it, the first scan to reach the end of the buffered window reads the next batch of
+ * entries from the oplog and publishes it, while the other scans which have caught up wait for it
+ * and then take their entries from the buffer. Each scan keeps its own position in the buffer and
+ * applies its own filter to the entries it takes.
+ *
+ * The buffer holds at most a fixed number of bytes. Scans which fall behind the start of the
+ * window, or which resume from a point before it, read from the oplog privately until they catch
+ * up, so a slow reader never holds back the others or grows the buffer.
+ *
+ * Only scans reading from the majority committed snapshot may share the buffer: their entries can
+ * never be rolled back, and have no holes behind them, so a batch read by one scan is valid for
+ * every other.
+ */
+class SharedOplogBuffer {
+    MONGO_DISALLOW_COPYING(SharedOplogBuffer);
+
+public:
+    struct Entry {
+        RecordId id;
+        BSONObj obj;  // Always owned.
+    };
+
+    /**
+     * What a reader of the oplog would be able to see: the version of the oplog's capped insert
+     * notifier and the optime of the committed snapshot. A read which reached the end of the oplog
+     * makes further reads redundant until one of these changes.
+     */
+    struct FillPoint {
+        uint64_t insertVersion;
+        repl::OpTime committedSnapshot;
+
+        bool operator==(const FillPoint& other) const {
+            return insertVersion == other.insertVersion &&
+                committedSnapshot == other.committedSnapshot;
+        }
+    };
+
+    enum class ReadResult {
+        // Entries were copied into the output.
+        kRead,
+
+        // There are no entries after the requested position which could be visible yet.
+        kCaughtUp,
+
+        // The caller is at the end of the window and must read the oplog itself, then publish()
+        // what it read or call abandonFill().
+        kMustFill,
+
+        // The window does not include the requested position; the caller should read the oplog
+        // privately.
+        kNotCovered,
+    };
+
+    SharedOplogBuffer() = default;
+
+    static SharedOplogBuffer* get(ServiceContext* service);
+
+    /**
+     * Copies up to 'maxEntries' of the entries which follow the entry with id 'after' into 'out'.
+     * If 'after' is the last entry in the window and another reader is reading the oplog, waits
+     * for that reader to publish its batch.
+     */
+    ReadResult read(OperationContext* opCtx,
+                    const RecordId& after,
+                    const FillPoint& current,
+                    size_t maxEntries,
+                    std::vector<Entry>* out);
+
+    /**
+     * Appends 'entries', read from the oplog immediately after the entry with id 'after' as of
+     * 'fillPoint', to the window and wakes any waiting readers. 'reachedEnd' is true if there were
+     * no more entries to read. Evicts the oldest entries until the window is at most 'maxBytes'.
+     */
+    void publish(const RecordId& after,
+                 const FillPoint& fillPoint,
+                 const std::vector<Entry>& entries,
+                 bool reachedEnd,
+                 size_t maxBytes);
+
+    /**
+     * Gives up a read of the oplog started by a kMustFill result, without publishing anything.
+     */
+    void abandonFill();
+
+    size_t getBytesBuffered() const;
+
+private:
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _fillDone;
+
+    // Every oplog entry with an id in the range (_coveredFrom, _coveredTo] is in '_entries', in id
+    // order. Both are null while the window is empty.
+    std::deque<Entry> _entries;
+    RecordId _coveredFrom;
+    RecordId _coveredTo;
+    size_t _bytes = 0;
+
+    // Whether a reader is currently reading the oplog to extend the window.
+    bool _filling = false;
+
+    // Set if the last read of the oplog reached its end, to what that read could see.
+    boost::optional<FillPoint> _caughtUpAt;
+};
+
+}  // namespace mongo
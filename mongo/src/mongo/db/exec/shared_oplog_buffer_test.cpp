@@ -0,0 +1,174 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/shared_oplog_buffer.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Entry = SharedOplogBuffer::Entry;
+using FillPoint = SharedOplogBuffer::FillPoint;
+using ReadResult = SharedOplogBuffer::ReadResult;
+
+const FillPoint kFillPoint{1, repl::OpTime(Timestamp(10, 1), 1)};
+const size_t kMaxBytes = 1024 * 1024;
+
+std::vector<Entry> makeEntries(long long first, long long last) {
+    std::vector<Entry> entries;
+    for (long long id = first; id <= last; ++id) {
+        entries.push_back({RecordId(id), BSON("ts" << Timestamp(10, id) << "x" << id)});
+    }
+    return entries;
+}
+
+std::vector<long long> ids(const std::vector<Entry>& entries) {
+    std::vector<long long> result;
+    for (auto&& entry : entries) {
+        result.push_back(entry.id.repr());
+    }
+    return result;
+}
+
+class SharedOplogBufferTest : public unittest::Test {
+protected:
+    ReadResult read(long long after, std::vector<Entry>* out, const FillPoint& fp = kFillPoint) {
+        return buffer.read(opCtx.get(), RecordId(after), fp, 100, out);
+    }
+
+    QueryTestServiceContext serviceContext;
+    ServiceContext::UniqueOperationContext opCtx = serviceContext.makeOperationContext();
+    SharedOplogBuffer buffer;
+};
+
+TEST_F(SharedOplogBufferTest, FirstReaderFillsEmptyBuffer) {
+    std::vector<Entry> out;
+    ASSERT(ReadResult::kMustFill == read(1, &out));
+    ASSERT(out.empty());
+
+    // While the first read is being filled, a reader elsewhere in the oplog reads on its own.
+    ASSERT(ReadResult::kNotCovered == read(5, &out));
+    buffer.abandonFill();
+}
+
+TEST_F(SharedOplogBufferTest, PublishedEntriesAreSharedWithOtherReaders) {
+    std::vector<Entry> out;
+    ASSERT(ReadResult::kMustFill == read(1, &out));
+    buffer.publish(RecordId(1), kFillPoint, makeEntries(2, 4), false, kMaxBytes);
+
+    ASSERT(ReadResult::kRead == read(1, &out));
+    ASSERT(ids(out) == std::vector<long long>({2, 3, 4}));
+
+    out.clear();
+    ASSERT(ReadResult::kRead == read(3, &out));
+    ASSERT(ids(out) == std::vector<long long>({4}));
+
+    out.clear();
+    ASSERT(ReadResult::kRead == buffer.read(opCtx.get(), RecordId(1), kFillPoint, 2, &out));
+    ASSERT(ids(out) == std::vector<long long>({2, 3}));
+
+    // The last reader to reach the end of the window extends it.
+    out.clear();
+    ASSERT(ReadResult::kMustFill == read(4, &out));
+    buffer.publish(RecordId(4), kFillPoint, makeEntries(5, 5), false, kMaxBytes);
+    ASSERT(ReadResult::kRead == read(4, &out));
+    ASSERT(ids(out) == std::vector<long long>({5}));
+}
+
+TEST_F(SharedOplogBufferTest, CaughtUpUntilFillPointChanges) {
+    std::vector<Entry> out;
+    ASSERT(ReadResult::kMustFill == read(1, &out));
+    buffer.publish(RecordId(1), kFillPoint, makeEntries(2, 3), true, kMaxBytes);
+
+    ASSERT(ReadResult::kCaughtUp == read(3, &out));
+
+    FillPoint afterInsert{kFillPoint.insertVersion + 1, kFillPoint.committedSnapshot};
+    ASSERT(ReadResult::kMustFill == read(3, &out, afterInsert));
+    buffer.abandonFill();
+
+    FillPoint afterCommit{kFillPoint.insertVersion, repl::OpTime(Timestamp(11, 1), 1)};
+    ASSERT(ReadResult::kMustFill == read(3, &out, afterCommit));
+    buffer.abandonFill();
+    ASSERT(out.empty());
+}
+
+TEST_F(SharedOplogBufferTest, EvictsOldestEntriesBeyondMaxBytes) {
+    auto entries = makeEntries(2, 5);
+    const size_t entrySize = entries.front().obj.objsize();
+
+    std::vector<Entry> out;
+    ASSERT(ReadResult::kMustFill == read(1, &out));
+    buffer.publish(RecordId(1), kFillPoint, entries, false, 2 * entrySize);
+    ASSERT_EQ(2 * entrySize, buffer.getBytesBuffered());
+
+    // Entries 2 and 3 were evicted, so only readers at 3 or later can use the window.
+    ASSERT(ReadResult::kNotCovered == read(2, &out));
+    ASSERT(ReadResult::kRead == read(3, &out));
+    ASSERT(ids(out) == std::vector<long long>({4, 5}));
+}
+
+TEST_F(SharedOplogBufferTest, ReaderAheadOfWindowRestartsIt) {
+    std::vector<Entry> out;
+    ASSERT(ReadResult::kMustFill == read(1, &out));
+    buffer.publish(RecordId(1), kFillPoint, makeEntries(2, 3), false, kMaxBytes);
+
+    ASSERT(ReadResult::kMustFill == read(10, &out));
+    buffer.publish(RecordId(10), kFillPoint, makeEntries(11, 11), false, kMaxBytes);
+    ASSERT(ReadResult::kNotCovered == read(1, &out));
+    ASSERT(ReadResult::kRead == read(10, &out));
+    ASSERT(ids(out) == std::vector<long long>({11}));
+}
+
+TEST_F(SharedOplogBufferTest, ReaderAtEndWaitsForFillInProgress) {
+    std::vector<Entry> out;
+    ASSERT(ReadResult::kMustFill == read(1, &out));
+    buffer.publish(RecordId(1), kFillPoint, makeEntries(2, 2), false, kMaxBytes);
+    ASSERT(ReadResult::kMustFill == read(2, &out));
+
+    ReadResult waiterResult = ReadResult::kNotCovered;
+    std::vector<Entry> waiterOut;
+    stdx::thread waiter([&] {
+        auto waiterClient = serviceContext.getServiceContext()->makeClient("waiter");
+        auto waiterOpCtx = waiterClient->makeOperationContext();
+        waiterResult = buffer.read(waiterOpCtx.get(), RecordId(2), kFillPoint, 100, &waiterOut);
+    });
+
+    buffer.publish(RecordId(2), kFillPoint, makeEntries(3, 4), false, kMaxBytes);
+    waiter.join();
+    ASSERT(ReadResult::kRead == waiterResult);
+    ASSERT(ids(waiterOut) == std::vector<long long>({3, 4}));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -41,6 +41,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
@@ -51,6 +52,23 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+Status makeMemoryLimitExceededStatus(size_t maxBytes) {
+    mongoutils::str::stream ss;
+    ss << "Sort operation used more than the maximum " << maxBytes
+       << " bytes of RAM. Add an index, or specify a smaller limit.";
+    return Status(ErrorCodes::OperationFailed, ss);
+}
+
+size_t getMaxBytes(size_t maxMemoryUsageBytes) {
+    return maxMemoryUsageBytes
+        ? maxMemoryUsageBytes
+        : static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
+}
+
+}  // namespace
+
 // static
 const char* SortStage::kStageType = "SORT";
 
@@ -78,7 +96,9 @@ SortStage::SortStage(OperationContext* opCtx,
       _limit(params.limit),
       _sorted(false),
       _resultIterator(_data.end()),
-      _memUsage(0) {
+      _memUsage(0),
+      _allowDiskUse(params.allowDiskUse),
+      _maxMemoryUsageBytes(params.maxMemoryUsageBytes) {
     _children.emplace_back(child);
 
     BSONObj sortComparator = FindCommon::transformSortSpec(_pattern);
@@ -97,18 +117,17 @@ SortStage::~SortStage() {}
 bool SortStage::isEOF() {
     // We're done when our child has no more results, we've sorted the child's results, and
     // we've returned all sorted results.
+    if (_spilledResults) {
+        return !_spilledResults->more();
+    }
     return child()->isEOF() && _sorted && (_data.end() == _resultIterator);
 }
 
 PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
-    const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
+    const size_t maxBytes = getMaxBytes(_maxMemoryUsageBytes);
 	//һѯĵڴ
-	if (_memUsage > maxBytes) {
-        mongoutils::str::stream ss;
-        ss << "Sort operation used more than the maximum " << maxBytes
-           << " bytes of RAM. Add an index, or specify a smaller limit.";
-        Status status(ErrorCodes::OperationFailed, ss);
-        *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+    if (_memUsage > maxBytes && !spillToSorter()) {
+        *out = WorkingSetCommon::allocateStatusMember(_ws, makeMemoryLimitExceededStatus(maxBytes));
         return PlanStage::FAILURE;
     }
 
@@ -131,6 +150,24 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
             // Planner must put a fetch before we get here.
             verify(member->hasObj());
 
+            // We extract the sort key from the WSM's computed data. This must have been generated
+            // by a SortKeyGeneratorStage descendent in the execution tree.
+            //ȡsortKey
+            auto sortKeyComputedData =
+                static_cast<const SortKeyComputedData*>(member->getComputed(WSM_SORT_KEY));
+
+            if (_spillSorter) {
+                if (!canSpill(member)) {
+                    *out = WorkingSetCommon::allocateStatusMember(
+                        _ws, makeMemoryLimitExceededStatus(maxBytes));
+                    return PlanStage::FAILURE;
+                }
+                _spillSorter->add(sortKeyComputedData->getSortKey(),
+                                  member->obj.value().getOwned());
+                _ws->free(id);
+                return PlanStage::NEED_TIME;
+            }
+
             // We might be sorting something that was invalidated at some point.
             if (member->hasRecordId()) {
                 _wsidByRecordId[member->recordId] = id;
@@ -138,12 +175,6 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
 
             SortableDataItem item;
             item.wsid = id;
-
-            // We extract the sort key from the WSM's computed data. This must have been generated
-            // by a SortKeyGeneratorStage descendent in the execution tree.
-            //ȡsortKey
-            auto sortKeyComputedData =
-                static_cast<const SortKeyComputedData*>(member->getComputed(WSM_SORT_KEY));
             item.sortKey = sortKeyComputedData->getSortKey();
 
             if (member->hasRecordId()) {
@@ -157,7 +188,12 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
         } else if (PlanStage::IS_EOF == code) {
             // TODO: We don't need the lock for this.  We could ask for a yield and do this work
             // unlocked.  Also, this is performing a lot of work for one call to work(...)
-            sortBuffer();
+            if (_spillSorter) {
+                _spilledResults.reset(_spillSorter->done());
+                _spillSorter.reset();
+            } else {
+                sortBuffer();
+            }
             _resultIterator = _data.begin();
             _sorted = true;
             return PlanStage::NEED_TIME;
@@ -181,6 +217,17 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     }
 
     // Returning results.
+    if (_spilledResults) {
+        // Unowned objects are only valid until the next call on the iterator.
+        SpillSorter::Data next = _spilledResults->next();
+        *out = _ws->allocate();
+        WorkingSetMember* member = _ws->get(*out);
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), next.second.getOwned());
+        member->addComputed(new SortKeyComputedData(next.first));
+        member->transitionToOwnedObj();
+        return PlanStage::ADVANCED;
+    }
+
     verify(_resultIterator != _data.end());
     verify(_sorted);
     *out = _resultIterator->wsid;
@@ -222,9 +269,9 @@ void SortStage::doInvalidate(OperationContext* opCtx, const RecordId& dl, Invali
 
 unique_ptr<PlanStageStats> SortStage::getStats() {
     _commonStats.isEOF = isEOF();
-    const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
+    const size_t maxBytes = getMaxBytes(_maxMemoryUsageBytes);
     _specificStats.memLimit = maxBytes;
-    _specificStats.memUsage = _memUsage;
+    _specificStats.memUsage = _spillSorter ? _spillSorter->memUsed() : _memUsage;
     _specificStats.limit = _limit;
     _specificStats.sortPattern = _pattern.getOwned();
 
@@ -327,6 +374,56 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
 }
 
 //SortStage::sortBuffer()_data
+// static
+bool SortStage::canSpill(const WorkingSetMember* member) {
+    for (int i = 0; i < WSM_COMPUTED_NUM_TYPES; ++i) {
+        const auto type = static_cast<WorkingSetComputedDataType>(i);
+        if (type != WSM_SORT_KEY && member->hasComputed(type)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SortStage::spillToSorter() {
+    if (!_allowDiskUse || _spillSorter) {
+        return false;
+    }
+
+    const vector<SortableDataItem> buffered = _dataSet
+        ? vector<SortableDataItem>(_dataSet->begin(), _dataSet->end())
+        : _data;
+    for (const auto& item : buffered) {
+        if (!canSpill(_ws->get(item.wsid))) {
+            return false;
+        }
+    }
+
+    SortOptions opts;
+    opts.limit = _limit;
+    opts.maxMemoryUsageBytes = getMaxBytes(_maxMemoryUsageBytes);
+    opts.extSortAllowed = true;
+    opts.tempDir = storageGlobalParams.dbpath + "/_tmp";
+    _spillSorter.reset(SpillSorter::make(opts, SpillComparator(_sortKeyComparator->pattern)));
+
+    // The buffered documents were made owned as they were added, so they outlive their members.
+    for (const auto& item : buffered) {
+        WorkingSetMember* member = _ws->get(item.wsid);
+        _spillSorter->add(item.sortKey, member->obj.value());
+        if (member->hasRecordId()) {
+            _wsidByRecordId.erase(member->recordId);
+        }
+        _ws->free(item.wsid);
+    }
+    _data.clear();
+    if (_dataSet) {
+        _dataSet->clear();
+    }
+    _memUsage = 0;
+    _specificStats.usedDisk = true;
+    return true;
+}
+
 void SortStage::sortBuffer() {
     if (_limit == 0) {
         const WorkingSetComparator& cmp = *_sortKeyComparator;
@@ -345,3 +442,6 @@ void SortStage::sortBuffer() {
 }
 
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
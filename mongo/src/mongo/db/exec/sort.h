@@ -37,6 +37,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/sorter/sorter.h"
 #include "mongo/platform/unordered_map.h"
 
 namespace mongo {
@@ -46,7 +47,7 @@ class BtreeKeyGenerator;
 // Parameters that must be provided to a SortStage
 class SortStageParams {
 public:
-    SortStageParams() : collection(NULL), limit(0) {}
+    SortStageParams() : collection(NULL), limit(0), allowDiskUse(false), maxMemoryUsageBytes(0) {}
 
     // Used for resolving RecordIds to BSON
     const Collection* collection;
@@ -56,6 +57,14 @@ public:
 
     // Equal to 0 for no limit.
     size_t limit;
+
+    // Whether to continue the sort in temporary files once the buffered data exceeds
+    // internalQueryExecMaxBlockingSortBytes, rather than failing.
+    bool allowDiskUse;
+
+    // The memory limit to apply instead of internalQueryExecMaxBlockingSortBytes, or 0 to apply
+    // that knob.
+    size_t maxMemoryUsageBytes;
 };
 
 /**
@@ -152,6 +161,32 @@ private:
      */
     void sortBuffer();
 
+    using SpillSorter = Sorter<BSONObj, BSONObj>;
+
+    struct SpillComparator {
+        explicit SpillComparator(BSONObj p) : pattern(p) {}
+
+        int operator()(const SpillSorter::Data& lhs, const SpillSorter::Data& rhs) const {
+            // False means ignore field names.
+            return lhs.first.woCompare(rhs.first, pattern, false);
+        }
+
+        BSONObj pattern;
+    };
+
+    /**
+     * Only the document and its sort key survive a trip through the spill sorter, so results
+     * carrying other computed data, such as text scores, can't be spilled.
+     */
+    static bool canSpill(const WorkingSetMember* member);
+
+    /**
+     * Moves the buffered data into a sorter which may write it to temporary files, after which
+     * all further input goes to that sorter rather than the buffer. Returns false, leaving the
+     * buffer untouched, if disk use is not allowed or the buffered data can't be spilled.
+     */
+    bool spillToSorter();
+
     // Comparator for data buffer
     // Initialization follows sort key generator
     std::unique_ptr<WorkingSetComparator> _sortKeyComparator;
@@ -178,6 +213,17 @@ private:
 
     // The usage in bytes of all buffered data that we're sorting.
     size_t _memUsage;
+
+    const bool _allowDiskUse;
+
+    // Zero when internalQueryExecMaxBlockingSortBytes applies.
+    const size_t _maxMemoryUsageBytes;
+
+    // Set once the buffered data outgrows the memory limit and has been handed over to a sorter,
+    // until all input has been read. The results are then returned from _spilledResults, as owned
+    // documents without RecordIds, and _data stays empty.
+    std::unique_ptr<SpillSorter> _spillSorter;
+    std::unique_ptr<SpillSorter::Iterator> _spilledResults;
 };
 
 }  // namespace mongo
@@ -120,8 +120,16 @@ unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* opCtx,
     std::unique_ptr<PlanStage> textMatchStage;
     if (wantTextScore) {
         // We use a TEXT_OR stage to get the union of the results from the index scans and then
-        // compute their text scores. This is a blocking operation.
-        auto textScorer = make_unique<TextOrStage>(opCtx, _params.spec, ws, filter, _params.index);
+        // compute their text scores. This is a blocking operation. When only the highest scoring
+        // documents are consumed, TEXT_OR can discard the rest before fetching them, unless the
+        // TEXT_MATCH stage may still reject documents, as it does for phrases, negated terms and
+        // case or diacritic sensitive searches.
+        const bool textMatchCanReject = !_params.query.getPositivePhr().empty() ||
+            !_params.query.getNegatedTerms().empty() || !_params.query.getNegatedPhr().empty() ||
+            _params.query.getCaseSensitive() || _params.query.getDiacriticSensitive();
+        const size_t topK = textMatchCanReject ? 0 : _params.textScoreTopK;
+        auto textScorer =
+            make_unique<TextOrStage>(opCtx, _params.spec, ws, filter, _params.index, topK);
 
         textScorer->addChildren(std::move(indexScanList));
 
@@ -67,6 +67,10 @@ struct TextStageParams {
     // True if we need the text score in the output, because the projection includes the 'textScore'
     // metadata field.
     bool wantTextScore = true;
+
+    // If non-zero, only the documents with the 'textScoreTopK' highest text scores are consumed,
+    // as for a sort on the text score with a limit.
+    size_t textScoreTopK = 0;
 };
 
 /**
@@ -28,6 +28,8 @@
 
 #include "mongo/db/exec/text_or.h"
 
+#include <algorithm>
+#include <functional>
 #include <map>
 #include <vector>
 
@@ -57,13 +59,14 @@ TextOrStage::TextOrStage(OperationContext* opCtx,
                          const FTSSpec& ftsSpec,
                          WorkingSet* ws,
                          const MatchExpression* filter,
-                         IndexDescriptor* index)
+                         IndexDescriptor* index,
+                         size_t topK)
     : PlanStage(kStageType, opCtx),
       _ftsSpec(ftsSpec),
       _ws(ws),
+      _topK(topK),
       _scoreIterator(_scores.end()),
       _filter(filter),
-      _idRetrying(WorkingSet::INVALID_ID),
       _index(index) {}
 
 TextOrStage::~TextOrStage() {}
@@ -187,14 +190,7 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
 
     // Either retry the last WSM we worked on or get a new one from our current child.
     WorkingSetID id;
-    StageState childState;
-    if (_idRetrying == WorkingSet::INVALID_ID) {
-        childState = _children[_currentChild]->work(&id);
-    } else {
-        childState = ADVANCED;
-        id = _idRetrying;
-        _idRetrying = WorkingSet::INVALID_ID;
-    }
+    StageState childState = _children[_currentChild]->work(&id);
 
     if (PlanStage::ADVANCED == childState) {
         return addTerm(id, out);
@@ -208,6 +204,7 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
         }
 
         // If we're here we are done reading results.  Move to the next state.
+        retainTopScores();
         _scoreIterator = _scores.begin();
         _internalState = State::kReturningResults;
 
@@ -232,6 +229,43 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
 }
 
+void TextOrStage::retainTopScores() {
+    if (_topK == 0 || _scores.size() <= _topK) {
+        return;
+    }
+
+    std::vector<double> scores;
+    for (auto&& entry : _scores) {
+        if (entry.second.score >= 0) {
+            scores.push_back(entry.second.score);
+        }
+    }
+    if (scores.size() <= _topK) {
+        return;
+    }
+
+    // Find the k-th highest score. Every record scoring above it is kept, along with just enough
+    // records scoring exactly the cutoff to make up k.
+    std::nth_element(scores.begin(), scores.begin() + (_topK - 1), scores.end(), std::greater<>());
+    const double cutoff = scores[_topK - 1];
+    size_t numAtCutoffToKeep =
+        _topK - std::count_if(scores.begin(), scores.end(), [&](double s) { return s > cutoff; });
+
+    for (auto&& entry : _scores) {
+        TextRecordData& textRecordData = entry.second;
+        if (textRecordData.score < 0 || textRecordData.score > cutoff) {
+            continue;
+        }
+        if (textRecordData.score == cutoff && numAtCutoffToKeep > 0) {
+            --numAtCutoffToKeep;
+            continue;
+        }
+        _ws->free(textRecordData.wsid);
+        textRecordData.wsid = WorkingSet::INVALID_ID;
+        textRecordData.score = -1;
+    }
+}
+
 PlanStage::StageState TextOrStage::returnResults(WorkingSetID* out) {
     if (_scoreIterator == _scores.end()) {
         _internalState = State::kDone;
@@ -240,14 +274,29 @@ PlanStage::StageState TextOrStage::returnResults(WorkingSetID* out) {
 
     // Retrieve the record that contains the text score.
     TextRecordData textRecordData = _scoreIterator->second;
-    ++_scoreIterator;
 
     // Ignore non-matched documents.
     if (textRecordData.score < 0) {
         invariant(textRecordData.wsid == WorkingSet::INVALID_ID);
+        ++_scoreIterator;
         return PlanStage::NEED_TIME;
     }
 
+    // Our parent expects RID_AND_OBJ members, so we fetch the document here. On a write conflict
+    // the iterator is left in place so that the fetch is retried after yielding.
+    try {
+        if (!WorkingSetCommon::fetch(getOpCtx(), _ws, textRecordData.wsid, _recordCursor)) {
+            _ws->free(textRecordData.wsid);
+            ++_scoreIterator;
+            return PlanStage::NEED_TIME;
+        }
+        ++_specificStats.fetches;
+    } catch (const WriteConflictException&) {
+        *out = WorkingSet::INVALID_ID;
+        return PlanStage::NEED_YIELD;
+    }
+    ++_scoreIterator;
+
     WorkingSetMember* wsm = _ws->get(textRecordData.wsid);
 
     // Populate the working set member with the text score and return it.
@@ -280,26 +329,11 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
             return NEED_TIME;
         }
 
-        // Our parent expects RID_AND_OBJ members, so we fetch the document here if we haven't
-        // already.
-        try {
-            if (!WorkingSetCommon::fetch(getOpCtx(), _ws, wsid, _recordCursor)) {
-                _ws->free(wsid);
-                textRecordData->score = -1;
-                return NEED_TIME;
-            }
-            ++_specificStats.fetches;
-        } catch (const WriteConflictException&) {
-            wsm->makeObjOwnedIfNeeded();
-            _idRetrying = wsid;
-            *out = WorkingSet::INVALID_ID;
-            return NEED_YIELD;
-        }
-
+        // The document is only fetched once it is about to be returned, so that matches which
+        // are dropped by retainTopScores() are never read from the collection. Own the key, as
+        // the member is kept across yields.
+        wsm->keyData.back().keyData = wsm->keyData.back().keyData.getOwned();
         textRecordData->wsid = wsid;
-
-        // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
-        wsm->makeObjOwnedIfNeeded();
     } else {
         // We already have a working set member for this RecordId. Free the new WSM and retrieve the
         // old one. Note that since we don't keep all index keys, we could get a score that doesn't
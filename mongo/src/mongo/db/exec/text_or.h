@@ -52,6 +52,10 @@ class OperationContext;
  * the positive terms in the search query, as well as their scores.
  *
  * The WorkingSetMembers returned are fetched and in the LOC_AND_OBJ state.
+ *
+ * If 'topK' is non-zero, only the 'topK' highest scoring documents are returned, and the others
+ * are never fetched. Callers may only request this when they consume nothing but the highest
+ * scoring 'topK' results, such as a sort on the text score with a limit.
  */
 class TextOrStage final : public PlanStage {
 public:
@@ -76,7 +80,8 @@ public:
                 const FTSSpec& ftsSpec,
                 WorkingSet* ws,
                 const MatchExpression* filter,
-                IndexDescriptor* index);
+                IndexDescriptor* index,
+                size_t topK = 0);
     ~TextOrStage();
 
     void addChild(unique_ptr<PlanStage> child);
@@ -123,7 +128,13 @@ private:
     StageState addTerm(WorkingSetID wsid, WorkingSetID* out);
 
     /**
-     * Worker for kReturningResults. Returns a wsm with RecordID and Score.
+     * Called once all terms have been read. If '_topK' is set, drops every scored record except
+     * the '_topK' highest scoring ones.
+     */
+    void retainTopScores();
+
+    /**
+     * Worker for kReturningResults. Fetches and returns a wsm with RecordID and Score.
      */
     StageState returnResults(WorkingSetID* out);
 
@@ -133,6 +144,9 @@ private:
     // Not owned by us.
     WorkingSet* _ws;
 
+    // If non-zero, the number of highest scoring documents to return.
+    const size_t _topK;
+
     // What state are we in?  See the State enum above.
     State _internalState = State::kInit;
 
@@ -158,7 +172,6 @@ private:
 
     // Members needed only for using the TextMatchableDocument.
     const MatchExpression* _filter;
-    WorkingSetID _idRetrying;
     std::unique_ptr<SeekableRecordCursor> _recordCursor;
     IndexDescriptor* _index;
 };
@@ -49,6 +49,7 @@
 #include "mongo/db/s/metadata_manager.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/update/storage_validation.h"
+#include "mongo/db/views/materialized_view.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
@@ -303,7 +304,10 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                     !request->isMulti() || args.criteria.hasField("_id"_sd));
             args.fromMigrate = request->isFromMigration();
             args.storeDocOption = getStoreDocMode(*request);
-            if (args.storeDocOption == OplogUpdateEntryArgs::StoreDocOption::PreImage) {
+            // Materialized views on the collection need the pre-image to undo the old document,
+            // which CollectionImpl::updateDocument() provides but in-place updates do not.
+            if (args.storeDocOption == OplogUpdateEntryArgs::StoreDocOption::PreImage ||
+                (inPlace && MaterializedView::hasViewsOn(getOpCtx(), args.nss))) {
                 args.preImageDoc = oldObj.value().getOwned();
             }
         }
@@ -338,6 +342,7 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                                                           newObj,
                                                           true,
                                                           driver->modsAffectIndices(),
+                                                          &driver->modifiedIndexedPaths(),
                                                           _params.opDebug,
                                                           &args);
             }
@@ -616,6 +621,7 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
         if (!docStillMatches) {
             // Either the document has been deleted, or it has been updated such that it no longer
             // matches the predicate.
+            _conflictTurn.reset();
             if (shouldRestartUpdateIfNoLongerMatches(_params)) {
                 throw WriteConflictException();
             }
@@ -648,6 +654,7 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
             memberFreer.Dismiss();  // Keep this member around so we can retry updating it.
             return prepareToRetryWSM(id, out);
         }
+        _conflictTurn.reset();
 
         // Set member's obj to be the doc we want to return.
         if (_params.request->shouldReturnAnyDocs()) {
@@ -782,6 +789,13 @@ UpdateResult UpdateStage::makeUpdateResult(const UpdateStats* updateStats) {
 
 PlanStage::StageState UpdateStage::prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out) {
     _idRetrying = idToRetry;
+    if (!_conflictTurn || !_conflictTurn->granted()) {
+        // Wait behind the writers already retrying this document, so that the retry after the
+        // yield reads their committed changes instead of conflicting with them again.
+        _conflictTurn.reset();
+        _conflictTurn = stdx::make_unique<WriteConflictQueue::Turn>(
+            getOpCtx(), _collection->ns().ns(), _ws->get(idToRetry)->recordId);
+    }
     *out = WorkingSet::INVALID_ID;
     return NEED_YIELD;
 }
@@ -30,6 +30,7 @@
 
 
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/concurrency/write_conflict_queue.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/ops/update_request.h"
@@ -189,6 +190,10 @@ private:
     // If not WorkingSet::INVALID_ID, we return this member to our caller.
     WorkingSetID _idReturning;
 
+    // Our place among the writers retrying the document in '_idRetrying' after a write conflict.
+    // Held from the conflict until the retried update commits.
+    std::unique_ptr<WriteConflictQueue::Turn> _conflictTurn;
+
     // Stats
     UpdateStats _specificStats;
 
@@ -28,6 +28,8 @@
 
 #include "mongo/db/exec/working_set.h"
 
+#include <algorithm>
+
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/service_context.h"
@@ -44,10 +46,32 @@ WorkingSet::MemberHolder::~MemberHolder() {}
 
 WorkingSet::WorkingSet() : _freeList(INVALID_ID) {}
 
-WorkingSet::~WorkingSet() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
+WorkingSet::~WorkingSet() {}
+
+namespace {
+
+// Bounds on the number of members in each allocation chunk. The first chunk is small enough
+// for a point query, and chunk sizes double up to the maximum as the working set grows.
+const size_t kInitialMemberChunkSize = 4;
+const size_t kMaxMemberChunkSize = 256;
+
+}  // namespace
+
+WorkingSetMember* WorkingSet::allocateMember() {
+    if (_lastChunkUsed == _lastChunkSize) {
+        _lastChunkSize = _memberChunks.empty()
+            ? kInitialMemberChunkSize
+            : std::min(_lastChunkSize * 2, kMaxMemberChunkSize);
+        _memberChunks.emplace_back(new WorkingSetMember[_lastChunkSize]);
+        _lastChunkUsed = 0;
     }
+    return &_memberChunks.back()[_lastChunkUsed++];
+}
+
+void WorkingSet::releaseMemberChunks() {
+    _memberChunks.clear();
+    _lastChunkSize = 0;
+    _lastChunkUsed = 0;
 }
 
 WorkingSetID WorkingSet::allocate() {
@@ -59,7 +83,7 @@ WorkingSetID WorkingSet::allocate() {
         WorkingSetID id = _data.size();
         _data.resize(_data.size() + 1);
         _data.back().nextFreeOrSelf = id;
-        _data.back().member = new WorkingSetMember();
+        _data.back().member = allocateMember();
         return id;
     }
 
@@ -97,10 +121,8 @@ bool WorkingSet::isFlagged(WorkingSetID id) const {
 }
 
 void WorkingSet::clear() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
-    }
     _data.clear();
+    releaseMemberChunks();
 
     // Since working set is now empty, the free list pointer should
     // point to nothing.
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
@@ -158,10 +159,21 @@ private:
         // Free list link if freed. Points to self if in use.
         WorkingSetID nextFreeOrSelf;
 
-        // Owning pointer
+        // Points into one of '_memberChunks', which owns the member.
         WorkingSetMember* member;
     };
 
+    /**
+     * Returns a default-constructed member carved out of '_memberChunks', allocating a new chunk
+     * when the current one is exhausted.
+     */
+    WorkingSetMember* allocateMember();
+
+    /**
+     * Frees every member chunk at once.
+     */
+    void releaseMemberChunks();
+
     // All WorkingSetIDs are indexes into this, except for INVALID_ID.
     // Elements are added to _freeList rather than removed when freed.
     /*
@@ -181,6 +193,16 @@ private:
 
     // Contains ids of WSMs that may need to be adjusted when we next yield.
     std::vector<WorkingSetID> _yieldSensitiveIds;
+
+    // Members are allocated in chunks of geometrically increasing size rather than one heap
+    // allocation each, so that a point query touches a single small allocation while scans keep
+    // their members contiguous. Members are never returned to a chunk individually: freed ids are
+    // recycled through '_freeList', and the chunks are released together with the WorkingSet.
+    std::vector<std::unique_ptr<WorkingSetMember[]>> _memberChunks;
+
+    // Capacity of the last chunk in '_memberChunks' and how many of its members are handed out.
+    size_t _lastChunkSize = 0;
+    size_t _lastChunkUsed = 0;
 };
 
 /**
@@ -154,4 +154,25 @@ TEST_F(WorkingSetFixture, getDottedFieldFromIndex) {
     ASSERT_FALSE(member->getFieldDotted("y", &elt));
 }
 
+TEST_F(WorkingSetFixture, membersStayValidAcrossChunks) {
+    // Allocate enough members to span several allocation chunks, and check that members handed
+    // out earlier are unaffected by later allocations.
+    std::vector<WorkingSetID> ids;
+    for (int i = 0; i < 1000; ++i) {
+        WorkingSetID newId = ws->allocate();
+        ws->get(newId)->recordId = RecordId(i + 1);
+        ids.push_back(newId);
+    }
+    ASSERT_EQUALS(member, ws->get(id));
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQUALS(RecordId(i + 1), ws->get(ids[i])->recordId);
+    }
+
+    // A freed member is cleared and recycled before new chunk space is used.
+    ws->free(ids[10]);
+    WorkingSetID reused = ws->allocate();
+    ASSERT_EQUALS(ids[10], reused);
+    ASSERT_EQUALS(WorkingSetMember::INVALID, ws->get(reused)->getState());
+}
+
 }  // namespace
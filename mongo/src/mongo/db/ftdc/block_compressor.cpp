@@ -36,9 +36,9 @@
 
 namespace mongo {
 
-StatusWith<ConstDataRange> BlockCompressor::compress(ConstDataRange source) {
+StatusWith<ConstDataRange> BlockCompressor::compress(ConstDataRange source, Level level) {
     z_stream stream;
-    int level = Z_DEFAULT_COMPRESSION;
+    int zlibLevel = (level == Level::kFastest) ? Z_BEST_SPEED : Z_DEFAULT_COMPRESSION;
 
     stream.next_in = reinterpret_cast<unsigned char*>(const_cast<char*>(source.data()));
     stream.avail_in = source.length();
@@ -56,7 +56,7 @@ StatusWith<ConstDataRange> BlockCompressor::compress(ConstDataRange source) {
     stream.zfree = nullptr;
     stream.opaque = nullptr;
 
-    int err = deflateInit(&stream, level);
+    int err = deflateInit(&stream, zlibLevel);
     if (err != Z_OK) {
         return {ErrorCodes::ZLibError, str::stream() << "deflateInit failed with " << err};
     }
@@ -46,13 +46,28 @@ class BlockCompressor {
 public:
     BlockCompressor() = default;
 
+    /**
+     * Trade off between the compression ratio and the time spent compressing.
+     */
+    enum class Level {
+        /**
+         * zlib's default level, for data which is written once and kept.
+         */
+        kDefault,
+
+        /**
+         * zlib's fastest level, for data which is rewritten often and soon discarded.
+         */
+        kFastest,
+    };
+
     /**
      * Compress a buffer of data.
      *
      * Returns a pointer to a buffer that BlockCompressor owns.
      * The returned buffer is valid until the next call to compress or uncompress.
      */
-    StatusWith<ConstDataRange> compress(ConstDataRange source);
+    StatusWith<ConstDataRange> compress(ConstDataRange source, Level level = Level::kDefault);
 
     /**
      * Uncompress a buffer of data.
@@ -111,7 +111,8 @@ FTDCCompressor::addSample(const BSONObj& sample, Date_t date) {
     return {boost::none};
 }
 
-StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamples() {
+StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamples(
+    BlockCompressor::Level level) {
     _uncompressedChunkBuffer.setlen(0);
 
     // Append reference document - BSON Object
@@ -194,7 +195,7 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
     }
 
     auto swDest = _compressor.compress(
-        ConstDataRange(_uncompressedChunkBuffer.buf(), _uncompressedChunkBuffer.len()));
+        ConstDataRange(_uncompressedChunkBuffer.buf(), _uncompressedChunkBuffer.len()), level);
 
     // The only way for compression to fail is if the buffer size calculations are wrong
     if (!swDest.isOK()) {
@@ -124,8 +124,12 @@ public:
      *
      * The returned buffer is valid until next call to addSample() or getCompressedSamples() with
      * CompressBuffer::kGenerateNewCompressedBuffer.
+     *
+     * level is passed to the block compressor. Snapshots of a chunk which is still being filled,
+     * such as the interim file, are replaced every few samples and can use the fastest level.
      */
-    StatusWith<std::tuple<ConstDataRange, Date_t>> getCompressedSamples();
+    StatusWith<std::tuple<ConstDataRange, Date_t>> getCompressedSamples(
+        BlockCompressor::Level level = BlockCompressor::Level::kDefault);
 
     /**
      * Reset the state of the compressor.
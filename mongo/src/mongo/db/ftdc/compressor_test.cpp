@@ -90,6 +90,32 @@ TEST(FTDCCompressor, TestBasic) {
     ASSERT_TRUE(std::get<0>(swBuf.getValue()).data() != nullptr);
 }
 
+// Test that chunks compressed at the fastest level, as interim snapshots are, decompress
+TEST(FTDCCompressor, TestFastestLevel) {
+    FTDCConfig config;
+    FTDCCompressor c(&config);
+    FTDCDecompressor d;
+
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 10; i++) {
+        docs.emplace_back(BSON("name"
+                               << "joe"
+                               << "key1"
+                               << i
+                               << "key2"
+                               << i * 7));
+        auto st = c.addSample(docs.back(), Date_t());
+        ASSERT_HAS_SPACE(st);
+    }
+
+    auto swBuf = c.getCompressedSamples(BlockCompressor::Level::kFastest);
+    ASSERT_TRUE(swBuf.isOK());
+
+    auto sw = d.uncompress(std::get<0>(swBuf.getValue()));
+    ASSERT_TRUE(sw.isOK());
+    ValidateDocumentList(sw.getValue(), docs);
+}
+
 // Test strings only
 TEST(FTDCCompressor, TestStrings) {
     FTDCConfig config;
@@ -45,6 +45,7 @@ struct FTDCConfig {
           maxDirectorySizeBytes(kMaxDirectorySizeBytesDefault),
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
+          highFrequencyPeriod(kHighFrequencyPeriodMillisDefault),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
           maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
 
@@ -72,6 +73,14 @@ struct FTDCConfig {
      */
     Milliseconds period;
 
+    /**
+     * Period at which the high frequency metrics are sampled, or zero if they are not sampled.
+     *
+     * Each periodic sample carries every high frequency sample taken since the previous one, so
+     * bursts shorter than the period remain visible without collecting serverStatus more often.
+     */
+    Milliseconds highFrequencyPeriod;
+
     /**
      * Maximum number of samples to collect in an archive metric chunk for long term storage.
      */
@@ -86,6 +95,7 @@ struct FTDCConfig {
     static const bool kEnabledDefault = true;
 
     static const std::int64_t kPeriodMillisDefault;
+    static const std::int64_t kHighFrequencyPeriodMillisDefault = 0;
     static const std::uint64_t kMaxDirectorySizeBytesDefault = 200 * 1024 * 1024;
     static const std::uint64_t kMaxFileSizeBytesDefault = 10 * 1024 * 1024;
 
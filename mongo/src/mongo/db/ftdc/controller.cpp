@@ -58,6 +58,7 @@ Status FTDCController::setEnabled(bool enabled) {
 
     _configTemp.enabled = enabled;
     _condvar.notify_one();
+    _highFrequencyCondvar.notify_one();
 
     return Status::OK();
 }
@@ -66,6 +67,13 @@ void FTDCController::setPeriod(Milliseconds millis) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
     _configTemp.period = millis;
     _condvar.notify_one();
+    _highFrequencyCondvar.notify_one();
+}
+
+void FTDCController::setHighFrequencyPeriod(Milliseconds millis) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.highFrequencyPeriod = millis;
+    _highFrequencyCondvar.notify_one();
 }
 
 void FTDCController::setMaxDirectorySizeBytes(std::uint64_t size) {
@@ -127,6 +135,16 @@ void FTDCController::addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface
     }
 }
 
+void FTDCController::addHighFrequencyMetric(std::string name,
+                                            FTDCHighFrequencyMetrics::Reader reader) {
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        invariant(_state == State::kNotStarted);
+
+        _highFrequencyMetrics.addMetric(std::move(name), std::move(reader));
+    }
+}
+
 BSONObj FTDCController::getMostRecentPeriodicDocument() {
     {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
@@ -138,6 +156,13 @@ void FTDCController::start() {
     log() << "Initializing full-time diagnostic data capture with directory '"
           << _path.generic_string() << "'";
 
+    // Start the high frequency sampling thread if anything registered a high frequency metric
+    if (!_highFrequencyMetrics.empty()) {
+        _periodicCollectors.add(_highFrequencyMetrics.makeCollector());
+        _highFrequencyThread =
+            stdx::thread(stdx::bind(&FTDCController::doHighFrequencyLoop, this));
+    }
+
     // Start the thread
     _thread = stdx::thread(stdx::bind(&FTDCController::doLoop, this));
 
@@ -169,10 +194,15 @@ void FTDCController::stop() {
 
         // Wake up the thread if sleeping so that it will check if we are done
         _condvar.notify_one();
+        _highFrequencyCondvar.notify_one();
     }
 
     _thread.join();
 
+    if (_highFrequencyThread.joinable()) {
+        _highFrequencyThread.join();
+    }
+
     _state = State::kDone;
 
     if (_mgr) {
@@ -262,4 +292,38 @@ void FTDCController::doLoop() {
     }
 }
 
+void FTDCController::doHighFrequencyLoop() {
+    auto clockSource = getGlobalServiceContext()->getPreciseClockSource();
+
+    while (true) {
+        {
+            stdx::unique_lock<stdx::mutex> lock(_mutex);
+            MONGO_IDLE_THREAD_BLOCK;
+
+            if (_state == State::kStopRequested) {
+                break;
+            }
+
+            // Read the pending settings since _config is owned by the collection thread
+            auto period = _configTemp.highFrequencyPeriod;
+            _highFrequencyMetrics.setPeriods(period, _configTemp.period);
+
+            if (!_configTemp.enabled || period <= Milliseconds(0)) {
+                _highFrequencyCondvar.wait(lock);
+                continue;
+            }
+
+            auto next_time = FTDCUtil::roundTime(clockSource->now(), period);
+
+            auto status = _highFrequencyCondvar.wait_until(lock, next_time.toSystemTimePoint());
+
+            if (status == stdx::cv_status::no_timeout || _state == State::kStopRequested) {
+                continue;
+            }
+        }
+
+        _highFrequencyMetrics.sample();
+    }
+}
+
 }  // namespace mongo
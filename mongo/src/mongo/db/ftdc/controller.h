@@ -36,6 +36,7 @@
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/file_manager.h"
+#include "mongo/db/ftdc/high_frequency_metrics.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -74,6 +75,11 @@ public:
      */
     void setPeriod(Milliseconds millis);
 
+    /**
+     * Set the period for sampling the high frequency metrics, or zero to stop sampling them.
+     */
+    void setHighFrequencyPeriod(Milliseconds millis);
+
     /**
      * Set the maximum directory size in bytes.
      */
@@ -117,6 +123,14 @@ public:
      */
     void addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface> collector);
 
+    /**
+     * Add a counter to sample every high frequency period. i.e., opcounters
+     *
+     * The reader must be cheap and must not block since it runs up to every few milliseconds.
+     * All samples taken during a period are reported by the "highFrequency" periodic collector.
+     */
+    void addHighFrequencyMetric(std::string name, FTDCHighFrequencyMetrics::Reader reader);
+
     /**
      * Start the controller.
      *
@@ -147,6 +161,12 @@ private:
      */
     void doLoop();
 
+    /**
+     * Sample the high frequency metrics on their own background thread, so that a slow periodic
+     * collection does not delay them.
+     */
+    void doHighFrequencyLoop();
+
 private:
     /**
     * Private enum to track state.
@@ -203,6 +223,12 @@ private:
     // Owned
     BSONObj _mostRecentPeriodicDocument;
 
+    // Counters sampled every high frequency period
+    FTDCHighFrequencyMetrics _highFrequencyMetrics;
+
+    // Signaled on configuration changes and shutdown for the high frequency thread
+    stdx::condition_variable _highFrequencyCondvar;
+
     // Set of file rotation collectors
     FTDCCollectorCollection _rotateCollectors;
 
@@ -211,6 +237,9 @@ private:
 
     // Background collection and writing thread
     stdx::thread _thread;
+
+    // Background high frequency sampling thread
+    stdx::thread _highFrequencyThread;
 };
 
 }  // namespace mongo
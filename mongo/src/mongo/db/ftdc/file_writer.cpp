@@ -165,7 +165,8 @@ Status FTDCFileWriter::writeSample(const BSONObj& sample, Date_t date) {
     if (_compressor.getSampleCount() != 0 &&
         (_compressor.getSampleCount() % _config->maxSamplesPerInterimMetricChunk) == 0) {
         // Check if we want to do a partial write to the interim buffer
-        auto swBuf = _compressor.getCompressedSamples();
+        // The interim buffer is rewritten every few samples, so favor speed over size
+        auto swBuf = _compressor.getCompressedSamples(BlockCompressor::Level::kFastest);
         if (!swBuf.isOK()) {
             return swBuf.getStatus();
         }
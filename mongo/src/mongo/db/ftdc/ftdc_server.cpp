@@ -26,6 +26,8 @@
  * then also delete it in the license file.
  */
 
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kFTDC
+
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/ftdc/ftdc_server.h"
@@ -41,10 +43,13 @@
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/controller.h"
 #include "mongo/db/ftdc/ftdc_system_stats.h"
+#include "mongo/db/ftdc/sampling_profiler.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/counters.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/log.h"
 
 namespace mongo {
 
@@ -241,6 +246,73 @@ public:
     }
 
 } exportedFTDCInterimChunkSizeParameter;
+
+AtomicInt32 localHighFrequencyPeriodMillis(FTDCConfig::kHighFrequencyPeriodMillisDefault);
+
+class ExportedFTDCHighFrequencyPeriodParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCHighFrequencyPeriodParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionHighFrequencyPeriodMillis",
+              &localHighFrequencyPeriodMillis) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue != 0 && potentialNewValue < 10) {
+            return Status(ErrorCodes::BadValue,
+                          "diagnosticDataCollectionHighFrequencyPeriodMillis must be 0 to disable "
+                          "high frequency sampling, or greater than or equal to 10ms");
+        }
+
+        auto controller = getGlobalFTDCController();
+        if (controller) {
+            controller->setHighFrequencyPeriod(Milliseconds(potentialNewValue));
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCHighFrequencyPeriodParameter;
+
+// Install the counters sampled every diagnosticDataCollectionHighFrequencyPeriodMillis. These are
+// plain atomic loads so that they can be read far more often than serverStatus can be built.
+void installHighFrequencyMetrics(FTDCController* controller) {
+    auto addOpCounter = [controller](std::string name, const AtomicUInt32* counter) {
+        controller->addHighFrequencyMetric(std::move(name),
+                                           [counter] { return counter->loadRelaxed(); });
+    };
+
+    addOpCounter("insert", globalOpCounters.getInsert());
+    addOpCounter("query", globalOpCounters.getQuery());
+    addOpCounter("update", globalOpCounters.getUpdate());
+    addOpCounter("delete", globalOpCounters.getDelete());
+    addOpCounter("getmore", globalOpCounters.getGetMore());
+    addOpCounter("command", globalOpCounters.getCommand());
+
+    controller->addHighFrequencyMetric("bytesIn",
+                                       [] { return networkCounter.getLogicalBytesIn(); });
+    controller->addHighFrequencyMetric("bytesOut",
+                                       [] { return networkCounter.getLogicalBytesOut(); });
+    controller->addHighFrequencyMetric("numRequests",
+                                       [] { return networkCounter.getNumRequests(); });
+}
+
+// When enabled, a SIGPROF-driven CPU sampling profiler reports its samples as the "cpuSamples"
+// section of the diagnostic data.
+bool localSamplingProfilerEnabled = false;
+int localSamplingProfilerFrequencyHz = 100;
+
+ExportedServerParameter<bool, ServerParameterType::kStartupOnly> samplingProfilerEnabledParameter(
+    ServerParameterSet::getGlobal(),
+    "diagnosticDataCollectionCpuSamplingEnabled",
+    &localSamplingProfilerEnabled);
+
+ExportedServerParameter<int, ServerParameterType::kStartupOnly>
+    samplingProfilerFrequencyParameter(ServerParameterSet::getGlobal(),
+                                       "diagnosticDataCollectionCpuSamplingFrequencyHz",
+                                       &localSamplingProfilerFrequencyHz);
+
 }  // namespace
 
 FTDCSimpleInternalCommandCollector::FTDCSimpleInternalCommandCollector(StringData command,
@@ -270,6 +342,7 @@ void startFTDC(boost::filesystem::path& path,
                RegisterCollectorsFunction registerCollectors) {
     FTDCConfig config;
     config.period = Milliseconds(localPeriodMillis.load());
+    config.highFrequencyPeriod = Milliseconds(localHighFrequencyPeriodMillis.load());
     // Only enable FTDC if our caller says to enable FTDC, MongoS may not have a valid path to write
     // files to so update the diagnosticDataCollectionEnabled set parameter to reflect that.
     localEnabledFlag.store(startupMode == FTDCStartMode::kStart && localEnabledFlag.load());
@@ -303,6 +376,19 @@ void startFTDC(boost::filesystem::path& path,
     // Install System Metric Collector as a periodic collector
     installSystemMetricsCollector(controller.get());
 
+    // Install the high frequency metrics, reported by the "highFrequency" periodic collector
+    installHighFrequencyMetrics(controller.get());
+
+    // Install the CPU sampling profiler's collector if sampling could be started
+    if (localSamplingProfilerEnabled) {
+        Status status = SamplingProfiler::start(localSamplingProfilerFrequencyHz);
+        if (status.isOK()) {
+            controller->addPeriodicCollector(makeSamplingProfilerCollector());
+        } else {
+            warning() << "Failed to start the CPU sampling profiler: " << status;
+        }
+    }
+
     // Install file rotation collectors
     // These are collected on each file rotation.
 
@@ -332,6 +418,8 @@ void stopFTDC() {
     if (controller) {
         controller->stop();
     }
+
+    SamplingProfiler::stop();
 }
 
 FTDCController* FTDCController::get(ServiceContext* serviceContext) {
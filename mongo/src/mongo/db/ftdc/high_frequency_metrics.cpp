@@ -0,0 +1,134 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/high_frequency_metrics.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+class FTDCHighFrequencyMetricsCollector final : public FTDCCollectorInterface {
+public:
+    explicit FTDCHighFrequencyMetricsCollector(FTDCHighFrequencyMetrics* metrics)
+        : _metrics(metrics) {}
+
+    std::string name() const final {
+        return "highFrequency";
+    }
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) final {
+        _metrics->append(builder);
+    }
+
+private:
+    FTDCHighFrequencyMetrics* const _metrics;
+};
+
+}  // namespace
+
+void FTDCHighFrequencyMetrics::addMetric(std::string name, Reader reader) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    invariant(_ringCount == 0 && _ringNext == 0);
+
+    _names.push_back(std::move(name));
+    _readers.push_back(std::move(reader));
+
+    _scratch.resize(_names.size());
+    _last.resize(_names.size());
+    _ring.resize(kMaxSamplesPerCollection * _names.size());
+}
+
+void FTDCHighFrequencyMetrics::setPeriods(Milliseconds highFrequencyPeriod, Milliseconds period) {
+    std::size_t samplesPerCollection = 0;
+    if (highFrequencyPeriod > Milliseconds(0)) {
+        // Round up so that a regular period which is not a multiple of the high frequency period
+        // still has room for all of its samples.
+        auto ratio = (durationCount<Milliseconds>(period) +
+                      durationCount<Milliseconds>(highFrequencyPeriod) - 1) /
+            durationCount<Milliseconds>(highFrequencyPeriod);
+        samplesPerCollection = std::min<std::size_t>(std::max<std::int64_t>(ratio, 1),
+                                                     kMaxSamplesPerCollection);
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _highFrequencyPeriod = highFrequencyPeriod;
+    _samplesPerCollection = samplesPerCollection;
+}
+
+void FTDCHighFrequencyMetrics::sample() {
+    for (std::size_t i = 0; i < _readers.size(); ++i) {
+        _scratch[i] = _readers[i]();
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    std::copy(_scratch.begin(), _scratch.end(), _ring.begin() + _ringNext * _names.size());
+    _ringNext = (_ringNext + 1) % kMaxSamplesPerCollection;
+    _ringCount = std::min(_ringCount + 1, kMaxSamplesPerCollection);
+    _last = _scratch;
+}
+
+void FTDCHighFrequencyMetrics::append(BSONObjBuilder& builder) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+
+    const std::size_t numMetrics = _names.size();
+    const std::size_t reported = std::min(_ringCount, _samplesPerCollection);
+    const std::size_t oldest =
+        (_ringNext + kMaxSamplesPerCollection - reported) % kMaxSamplesPerCollection;
+
+    builder.append("periodMillis", durationCount<Milliseconds>(_highFrequencyPeriod));
+    builder.append("samples", static_cast<long long>(reported));
+
+    for (std::size_t metric = 0; metric < numMetrics; ++metric) {
+        BSONArrayBuilder values(builder.subarrayStart(_names[metric]));
+
+        for (std::size_t i = 0; i < _samplesPerCollection; ++i) {
+            if (i < reported) {
+                auto row = (oldest + i) % kMaxSamplesPerCollection;
+                values.append(static_cast<long long>(_ring[row * numMetrics + metric]));
+            } else {
+                values.append(static_cast<long long>(_last[metric]));
+            }
+        }
+    }
+
+    _ringCount = 0;
+}
+
+std::unique_ptr<FTDCCollectorInterface> FTDCHighFrequencyMetrics::makeCollector() {
+    return stdx::make_unique<FTDCHighFrequencyMetricsCollector>(this);
+}
+
+}  // namespace mongo
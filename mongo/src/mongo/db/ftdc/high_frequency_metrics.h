@@ -0,0 +1,124 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/ftdc/collector.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A small, curated set of counters which FTDC samples more often than its regular period.
+ *
+ * Each metric is read by a caller supplied function, typically a relaxed load of an atomic
+ * counter, so taking a sample never builds BSON or runs a command. The samples taken between two
+ * periodic collections are reported by the collector from makeCollector() as one array per
+ * metric. The arrays always have the same length for a given pair of periods so the schema of the
+ * periodic document stays stable; missing samples repeat the last value and surplus samples keep
+ * only the most recent ones.
+ *
+ * sample() and the collector may run on different threads.
+ */
+class FTDCHighFrequencyMetrics {
+    MONGO_DISALLOW_COPYING(FTDCHighFrequencyMetrics);
+
+public:
+    using Reader = stdx::function<std::int64_t()>;
+
+    /**
+     * Upper bound on the number of samples reported per periodic collection.
+     */
+    static constexpr std::size_t kMaxSamplesPerCollection = 100;
+
+    FTDCHighFrequencyMetrics() = default;
+
+    /**
+     * Register a metric. Must be called before the first call to sample().
+     */
+    void addMetric(std::string name, Reader reader);
+
+    bool empty() const {
+        return _names.empty();
+    }
+
+    /**
+     * Configure how many samples each periodic collection reports, i.e. how many high frequency
+     * periods fit in one regular period.
+     */
+    void setPeriods(Milliseconds highFrequencyPeriod, Milliseconds period);
+
+    /**
+     * Read every registered metric once and buffer the values.
+     */
+    void sample();
+
+    /**
+     * Append the samples buffered since the previous call and forget them.
+     */
+    void append(BSONObjBuilder& builder);
+
+    /**
+     * Returns a collector named "highFrequency" which calls append(). This object must outlive
+     * the collector.
+     */
+    std::unique_ptr<FTDCCollectorInterface> makeCollector();
+
+private:
+    std::vector<std::string> _names;
+    std::vector<Reader> _readers;
+
+    // Only used by sample() to read the metrics without holding the mutex
+    std::vector<std::int64_t> _scratch;
+
+    // Protects the members below
+    stdx::mutex _mutex;
+
+    std::size_t _samplesPerCollection{1};
+    Milliseconds _highFrequencyPeriod{0};
+
+    // Ring of the most recent samples, kMaxSamplesPerCollection rows of _names.size() values
+    std::vector<std::int64_t> _ring;
+    std::size_t _ringNext{0};
+    std::size_t _ringCount{0};
+
+    // Values of the most recent sample, used to pad collections which saw too few samples
+    std::vector<std::int64_t> _last;
+};
+
+}  // namespace mongo
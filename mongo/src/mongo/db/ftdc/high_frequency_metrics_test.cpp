@@ -0,0 +1,110 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/high_frequency_metrics.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::vector<long long> toVector(const BSONElement& element) {
+    std::vector<long long> values;
+    for (auto&& value : element.Array()) {
+        values.push_back(value.numberLong());
+    }
+    return values;
+}
+
+BSONObj collect(FTDCCollectorInterface* collector) {
+    BSONObjBuilder builder;
+    collector->collect(nullptr, builder);
+    return builder.obj();
+}
+
+TEST(FTDCHighFrequencyMetricsTest, PadsMissingSamplesWithTheLastValue) {
+    FTDCHighFrequencyMetrics metrics;
+    long long counter = 0;
+    metrics.addMetric("counter", [&counter] { return counter; });
+    metrics.setPeriods(Milliseconds(100), Milliseconds(400));
+    auto collector = metrics.makeCollector();
+    ASSERT_EQ("highFrequency", collector->name());
+
+    counter = 5;
+    metrics.sample();
+    counter = 7;
+    metrics.sample();
+
+    BSONObj obj = collect(collector.get());
+    ASSERT_EQ(100, obj["periodMillis"].numberLong());
+    ASSERT_EQ(2, obj["samples"].numberLong());
+    ASSERT(toVector(obj["counter"]) == std::vector<long long>({5, 7, 7, 7}));
+
+    // A period without any sample keeps the same shape.
+    obj = collect(collector.get());
+    ASSERT_EQ(0, obj["samples"].numberLong());
+    ASSERT(toVector(obj["counter"]) == std::vector<long long>({7, 7, 7, 7}));
+}
+
+TEST(FTDCHighFrequencyMetricsTest, KeepsTheMostRecentSamples) {
+    FTDCHighFrequencyMetrics metrics;
+    long long counter = 0;
+    metrics.addMetric("a", [&counter] { return counter; });
+    metrics.addMetric("b", [&counter] { return counter * 10; });
+    metrics.setPeriods(Milliseconds(300), Milliseconds(1000));
+    auto collector = metrics.makeCollector();
+
+    for (counter = 1; counter <= 6; ++counter) {
+        metrics.sample();
+    }
+
+    BSONObj obj = collect(collector.get());
+    ASSERT_EQ(4, obj["samples"].numberLong());
+    ASSERT(toVector(obj["a"]) == std::vector<long long>({3, 4, 5, 6}));
+    ASSERT(toVector(obj["b"]) == std::vector<long long>({30, 40, 50, 60}));
+}
+
+TEST(FTDCHighFrequencyMetricsTest, ReportsNoSamplesWhenDisabled) {
+    FTDCHighFrequencyMetrics metrics;
+    metrics.addMetric("counter", [] { return 1; });
+    metrics.setPeriods(Milliseconds(0), Milliseconds(1000));
+    auto collector = metrics.makeCollector();
+
+    metrics.sample();
+
+    BSONObj obj = collect(collector.get());
+    ASSERT_EQ(0, obj["samples"].numberLong());
+    ASSERT_EQ(0U, obj["counter"].Array().size());
+}
+
+}  // namespace
+}  // namespace mongo
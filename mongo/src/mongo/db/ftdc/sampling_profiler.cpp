@@ -0,0 +1,308 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kFTDC
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/sampling_profiler.h"
+
+#include <atomic>
+#include <cstring>
+#include <map>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/config.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+#if defined(_POSIX_VERSION) && defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/time.h>
+#define MONGO_HAVE_SAMPLING_PROFILER
+// Read from the signal handler, so it must not need lazy allocation on first access.
+#define MONGO_SIGNAL_SAFE_TLS __attribute__((tls_model("initial-exec")))
+#else
+#define MONGO_SIGNAL_SAFE_TLS
+#endif
+
+namespace mongo {
+namespace {
+
+constexpr size_t kMaxTagLength = SamplingProfilerTag::kMaxTagLength;
+
+// The handler's own frame and the signal trampoline precede the interrupted frame.
+constexpr int kSkipFrames = 2;
+constexpr int kMaxFrames = 32;
+
+// Enough for 40 seconds at 100Hz, well above the default FTDC period.
+constexpr size_t kRingSize = 4096;
+
+// Bounds the size of the collector's output. Samples with stacks beyond this are only counted.
+constexpr size_t kMaxStacks = 1000;
+
+enum SlotState : int { kEmpty, kWriting, kReady };
+
+struct Sample {
+    std::atomic<int> state{kEmpty};  // NOLINT
+    int numFrames = 0;
+    void* frames[kMaxFrames];
+    char tag[kMaxTagLength];
+};
+
+Sample ring[kRingSize];
+std::atomic<unsigned> nextSlot{0};         // NOLINT
+std::atomic<long long> droppedSamples{0};  // NOLINT
+std::atomic<bool> running{false};          // NOLINT
+
+thread_local char currentTag[kMaxTagLength] MONGO_SIGNAL_SAFE_TLS;
+
+#ifdef MONGO_HAVE_SAMPLING_PROFILER
+
+struct sigaction previousAction;
+
+// Must only use async-signal-safe operations. backtrace() is safe once it has been called outside
+// of a signal handler, which SamplingProfiler::start() makes sure of.
+void onSigProf(int) {
+    const int savedErrno = errno;
+    Sample& sample = ring[nextSlot.fetch_add(1, std::memory_order_relaxed) % kRingSize];
+
+    int expected = kEmpty;
+    if (sample.state.compare_exchange_strong(expected, kWriting, std::memory_order_acquire)) {
+        sample.numFrames = backtrace(sample.frames, kMaxFrames);
+        std::memcpy(sample.tag, currentTag, kMaxTagLength);
+        sample.state.store(kReady, std::memory_order_release);
+    } else {
+        // The collector has fallen a full ring behind.
+        droppedSamples.fetch_add(1, std::memory_order_relaxed);
+    }
+    errno = savedErrno;
+}
+
+std::string symbolize(void* frame) {
+    Dl_info dli;
+    if (dladdr(frame, &dli) && dli.dli_sname) {
+        int status;
+        char* demangled = abi::__cxa_demangle(dli.dli_sname, 0, 0, &status);
+        if (demangled) {
+            std::string name(demangled);
+            free(demangled);
+            return name.substr(0, name.find('('));
+        }
+        return dli.dli_sname;
+    }
+    return str::stream() << frame;
+}
+
+#endif  // MONGO_HAVE_SAMPLING_PROFILER
+
+class SamplingProfilerCollector final : public FTDCCollectorInterface {
+public:
+    std::string name() const override {
+        return "cpuSamples";
+    }
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) override {
+        _drain();
+
+        builder.appendNumber("samples", _totalSamples);
+        builder.appendNumber("droppedSamples", droppedSamples.load());
+        builder.appendNumber("otherSamples", _otherSamples);
+
+        BSONObjBuilder stacksBuilder(builder.subobjStart("stacks"));
+        for (auto&& stackInfo : _stacksInOrder) {
+            BSONObjBuilder stackBuilder(stacksBuilder.subobjStart(stackInfo->name));
+            stackBuilder.append("tag", stackInfo->tag);
+            stackBuilder.appendNumber("samples", stackInfo->samples);
+            stackBuilder.append("stack", stackInfo->stack);
+        }
+    }
+
+private:
+    struct StackInfo {
+        std::string name;
+        std::string tag;
+        BSONArray stack;
+        long long samples = 0;
+    };
+
+    void _drain() {
+#ifdef MONGO_HAVE_SAMPLING_PROFILER
+        for (auto&& sample : ring) {
+            if (sample.state.load(std::memory_order_acquire) != kReady) {
+                continue;
+            }
+
+            const int numFrames = std::max(sample.numFrames - kSkipFrames, 0);
+            const StringData tag(sample.tag, strnlen(sample.tag, kMaxTagLength));
+
+            // The key is the tag followed by the raw frame addresses.
+            std::string key = tag.toString();
+            key.push_back('\0');
+            key.append(reinterpret_cast<const char*>(sample.frames + kSkipFrames),
+                       numFrames * sizeof(void*));
+
+            auto it = _stacks.find(key);
+            if (it == _stacks.end() && _stacks.size() < kMaxStacks) {
+                StackInfo info;
+                info.name = str::stream() << "stack" << _stacks.size();
+                info.tag = tag.empty() ? "-" : tag.toString();
+                BSONArrayBuilder frames;
+                for (int i = 0; i < numFrames; ++i) {
+                    frames.append(symbolize(sample.frames[kSkipFrames + i]));
+                }
+                info.stack = frames.arr();
+                LOG(1) << "cpu sampling " << info.name << " [" << info.tag << "]: " << info.stack;
+
+                it = _stacks.emplace(std::move(key), std::move(info)).first;
+                _stacksInOrder.push_back(&it->second);
+            }
+
+            sample.state.store(kEmpty, std::memory_order_release);
+
+            ++_totalSamples;
+            if (it != _stacks.end()) {
+                ++it->second.samples;
+            } else {
+                ++_otherSamples;
+            }
+        }
+#endif  // MONGO_HAVE_SAMPLING_PROFILER
+    }
+
+    // Only accessed from the FTDC thread.
+    std::map<std::string, StackInfo> _stacks;
+    std::vector<StackInfo*> _stacksInOrder;
+    long long _totalSamples = 0;
+    long long _otherSamples = 0;
+};
+
+}  // namespace
+
+Status SamplingProfiler::start(int frequencyHz) {
+#ifdef MONGO_HAVE_SAMPLING_PROFILER
+    if (frequencyHz <= 0 || frequencyHz > 1000) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Sampling frequency must be between 1 and 1000Hz, not "
+                              << frequencyHz};
+    }
+    if (running.load()) {
+        return {ErrorCodes::IllegalOperation, "The sampling profiler is already running"};
+    }
+
+    // The first call to backtrace() may load libgcc, which is not safe in a signal handler.
+    void* warmUp[1];
+    backtrace(warmUp, 1);
+
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = onSigProf;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, &previousAction) != 0) {
+        return {ErrorCodes::InternalError,
+                str::stream() << "Failed to install SIGPROF handler: " << errnoWithDescription()};
+    }
+
+    running.store(true);
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = 1000 * 1000 / frequencyHz;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        auto status = Status(ErrorCodes::InternalError,
+                             str::stream() << "Failed to start profiling timer: "
+                                           << errnoWithDescription());
+        stop();
+        return status;
+    }
+
+    log() << "Started CPU sampling profiler at " << frequencyHz << "Hz";
+    return Status::OK();
+#else
+    return {ErrorCodes::IllegalOperation,
+            "The sampling profiler is not supported on this platform"};
+#endif  // MONGO_HAVE_SAMPLING_PROFILER
+}
+
+void SamplingProfiler::stop() {
+#ifdef MONGO_HAVE_SAMPLING_PROFILER
+    if (!running.load()) {
+        return;
+    }
+
+    struct itimerval timer;
+    std::memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    sigaction(SIGPROF, &previousAction, nullptr);
+    running.store(false);
+#endif  // MONGO_HAVE_SAMPLING_PROFILER
+}
+
+bool SamplingProfiler::isRunning() {
+    return running.load();
+}
+
+SamplingProfilerTag::SamplingProfilerTag(StringData opType, StringData ns) {
+    if (!running.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    _active = true;
+    std::memcpy(_previous, currentTag, kMaxTagLength);
+
+    // A sample taken while the tag is being copied may see a mix of the old and new tag, which
+    // only affects how that one sample is labelled.
+    char tag[kMaxTagLength] = {};
+    size_t len = std::min(opType.size(), kMaxTagLength - 1);
+    std::memcpy(tag, opType.rawData(), len);
+    if (!ns.empty() && len + 1 < kMaxTagLength - 1) {
+        tag[len++] = ' ';
+        const size_t nsLen = std::min(ns.size(), kMaxTagLength - 1 - len);
+        std::memcpy(tag + len, ns.rawData(), nsLen);
+    }
+    std::memcpy(currentTag, tag, kMaxTagLength);
+}
+
+SamplingProfilerTag::~SamplingProfilerTag() {
+    if (_active) {
+        std::memcpy(currentTag, _previous, kMaxTagLength);
+    }
+}
+
+std::unique_ptr<FTDCCollectorInterface> makeSamplingProfilerCollector() {
+    return stdx::make_unique<SamplingProfilerCollector>();
+}
+
+}  // namespace mongo
@@ -0,0 +1,98 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/ftdc/collector.h"
+
+namespace mongo {
+
+/**
+ * A process-wide CPU sampling profiler. While running, an ITIMER_PROF timer delivers SIGPROF at
+ * the requested frequency and the signal handler records the interrupted thread's stack together
+ * with the thread's current tag (see SamplingProfilerTag) into a fixed-size ring buffer.
+ *
+ * The collector returned by makeSamplingProfilerCollector() drains that buffer on every FTDC
+ * period and reports one entry per distinct (tag, stack) pair with a cumulative sample count.
+ * Entries keep their name and symbolized stack once created, so between new stacks the
+ * collector's output only changes in its counters and compresses like any other FTDC metric.
+ *
+ * Only supported on POSIX platforms with backtrace().
+ */
+class SamplingProfiler {
+    MONGO_DISALLOW_COPYING(SamplingProfiler);
+
+public:
+    /**
+     * Installs the SIGPROF handler and starts sampling at 'frequencyHz'. Returns an error if the
+     * platform is not supported or the profiler is already running.
+     */
+    static Status start(int frequencyHz);
+
+    /**
+     * Stops sampling and restores the previous SIGPROF disposition. Samples already recorded are
+     * still reported by the collector.
+     */
+    static void stop();
+
+    static bool isRunning();
+
+private:
+    SamplingProfiler() = delete;
+};
+
+/**
+ * Labels the samples taken on the current thread for its lifetime, e.g. with the command name and
+ * database of the operation being run. Tags nest; the previous tag is restored on destruction.
+ * Does nothing while the profiler is not running.
+ */
+class SamplingProfilerTag {
+    MONGO_DISALLOW_COPYING(SamplingProfilerTag);
+
+public:
+    static constexpr size_t kMaxTagLength = 64;
+
+    SamplingProfilerTag(StringData opType, StringData ns);
+    ~SamplingProfilerTag();
+
+private:
+    bool _active = false;
+    char _previous[kMaxTagLength];
+};
+
+/**
+ * Returns the FTDC collector which reports the samples recorded by SamplingProfiler.
+ */
+std::unique_ptr<FTDCCollectorInterface> makeSamplingProfilerCollector();
+
+}  // namespace mongo
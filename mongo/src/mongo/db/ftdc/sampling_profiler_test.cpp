@@ -0,0 +1,106 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/sampling_profiler.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+// Burns CPU until the profiler has recorded at least one sample for the current tag.
+BSONObj spinUntilSampled(FTDCCollectorInterface* collector, StringData expectedTag) {
+    const auto deadline = Date_t::now() + Seconds(30);
+    volatile unsigned long long counter = 0;
+    while (Date_t::now() < deadline) {
+        for (int i = 0; i < 1000 * 1000; ++i) {
+            counter = counter + i;
+        }
+
+        BSONObjBuilder builder;
+        collector->collect(nullptr, builder);
+        BSONObj obj = builder.obj();
+        for (auto&& stack : obj["stacks"].Obj()) {
+            BSONObj stackObj = stack.Obj();
+            if (stackObj["tag"].str() == expectedTag && stackObj["samples"].numberLong() > 0) {
+                return obj;
+            }
+        }
+    }
+    return BSONObj();
+}
+
+TEST(SamplingProfilerTest, RecordsTaggedSamples) {
+    Status status = SamplingProfiler::start(1000);
+    if (status == ErrorCodes::IllegalOperation) {
+        return;  // Not supported on this platform.
+    }
+    ASSERT_OK(status);
+    ASSERT(SamplingProfiler::isRunning());
+    ASSERT_EQ(ErrorCodes::IllegalOperation, SamplingProfiler::start(1000));
+
+    auto collector = makeSamplingProfilerCollector();
+    BSONObj obj;
+    {
+        SamplingProfilerTag tag("testOp", "test");
+        obj = spinUntilSampled(collector.get(), "testOp test");
+    }
+    SamplingProfiler::stop();
+    ASSERT_FALSE(SamplingProfiler::isRunning());
+
+    ASSERT_FALSE(obj.isEmpty());
+    ASSERT_GT(obj["samples"].numberLong(), 0);
+    for (auto&& stack : obj["stacks"].Obj()) {
+        ASSERT_EQ(BSONType::Array, stack.Obj()["stack"].type());
+    }
+}
+
+TEST(SamplingProfilerTest, NoSamplesWhileStopped) {
+    ASSERT_FALSE(SamplingProfiler::isRunning());
+    SamplingProfilerTag tag("testOp", "test");
+
+    auto collector = makeSamplingProfilerCollector();
+    auto collect = [&] {
+        BSONObjBuilder builder;
+        collector->collect(nullptr, builder);
+        return builder.obj()["samples"].numberLong();
+    };
+
+    // The first collection may drain samples taken before an earlier test stopped the profiler.
+    const auto samples = collect();
+    sleepmillis(50);
+    ASSERT_EQ(samples, collect());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/startup_test.h"
+#include "third_party/murmurhash3/MurmurHash3.h"
 
 namespace mongo {
 
@@ -47,12 +48,15 @@ namespace {
 
 typedef unsigned char HashDigest[16];
 
-class Hasher {
-    MONGO_DISALLOW_COPYING(Hasher);
+/**
+ * Computes the MD5 digest of the seed followed by the data, for hash version 0.
+ */
+class MD5Hasher {
+    MONGO_DISALLOW_COPYING(MD5Hasher);
 
 public:
-    explicit Hasher(HashSeed seed);
-    ~Hasher(){};
+    explicit MD5Hasher(HashSeed seed);
+    ~MD5Hasher(){};
 
     // pointer to next part of input key, length in bytes to read
     void addData(const void* keyData, size_t numBytes);
@@ -66,19 +70,44 @@ private:
     HashSeed _seed;
 };
 
-Hasher::Hasher(HashSeed seed) : _seed(seed) {
+MD5Hasher::MD5Hasher(HashSeed seed) : _seed(seed) {
     md5_init(&_md5State);
     md5_append(&_md5State, reinterpret_cast<const md5_byte_t*>(&_seed), sizeof(_seed));
 }
 
-void Hasher::addData(const void* keyData, size_t numBytes) {
+void MD5Hasher::addData(const void* keyData, size_t numBytes) {
     md5_append(&_md5State, static_cast<const md5_byte_t*>(keyData), numBytes);
 }
 
-void Hasher::finish(HashDigest out) {
+void MD5Hasher::finish(HashDigest out) {
     md5_finish(&_md5State, out);
 }
 
+/**
+ * Computes the 128-bit MurmurHash3 of the data with the seed, for hash version 1. MurmurHash3 is
+ * not incremental, so the data is gathered in a buffer, which stays on the stack for all but
+ * large elements.
+ */
+class Murmur3Hasher {
+    MONGO_DISALLOW_COPYING(Murmur3Hasher);
+
+public:
+    explicit Murmur3Hasher(HashSeed seed) : _seed(seed) {}
+
+    void addData(const void* keyData, size_t numBytes) {
+        _buf.appendBuf(keyData, numBytes);
+    }
+
+    void finish(HashDigest out) {
+        MurmurHash3_x64_128(_buf.buf(), _buf.len(), static_cast<uint32_t>(_seed), out);
+    }
+
+private:
+    StackBufBuilder _buf;
+    HashSeed _seed;
+};
+
+template <typename Hasher>
 void recursiveHash(Hasher* h, const BSONElement& e, bool includeFieldName) {
     int canonicalType = endian::nativeToLittle(e.canonicalType());
     h->addData(&canonicalType, sizeof(canonicalType));
@@ -122,12 +151,14 @@ struct HasherUnitTest : public StartupTest {
         // Hard-coded check to ensure the hash function is consistent across platforms
         BSONObj o = BSON("check" << 42);
         verify(BSONElementHasher::hash64(o.firstElement(), 0) == -944302157085130861LL);
+        verify(BSONElementHasher::hash64(
+                   o.firstElement(), 0, BSONElementHasher::MURMUR3_HASH_VERSION) ==
+               8715208212397937794LL);
     }
 } hasherUnitTest;
 
-}  // namespace
-
-long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed) {
+template <typename Hasher>
+long long int hash64WithHasher(const BSONElement& e, HashSeed seed) {
     Hasher h(seed);
     recursiveHash(&h, e, false);
     HashDigest d;
@@ -137,4 +168,18 @@ long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed) {
     return digestView.read<LittleEndian<long long int>>();
 }
 
+}  // namespace
+
+long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed) {
+    return hash64WithHasher<MD5Hasher>(e, seed);
+}
+
+long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed, int hashVersion) {
+    invariant(isValidHashVersion(hashVersion));
+    if (hashVersion == MURMUR3_HASH_VERSION) {
+        return hash64WithHasher<Murmur3Hasher>(e, seed);
+    }
+    return hash64WithHasher<MD5Hasher>(e, seed);
+}
+
 }  // namespace mongo
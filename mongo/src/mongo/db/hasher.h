@@ -54,6 +54,20 @@ public:
      */
     static const int DEFAULT_HASH_SEED = 0;
 
+    /* The hash function is selected by a hash version, stored as "hashVersion" in the spec of
+     * hashed indexes. Version 0, the default, takes the first 8 bytes of an MD5 digest. Version 1
+     * takes the first 8 bytes of a 128-bit MurmurHash3 and is several times cheaper to compute.
+     *
+     * WARNING: do not change what an existing version computes. Hashed indexes and hash-based
+     * sharding clusters store and compare its values.
+     */
+    static const int DEFAULT_HASH_VERSION = 0;
+    static const int MURMUR3_HASH_VERSION = 1;
+
+    static bool isValidHashVersion(int hashVersion) {
+        return hashVersion == DEFAULT_HASH_VERSION || hashVersion == MURMUR3_HASH_VERSION;
+    }
+
     /* This computes a 64-bit hash of the value part of BSONElement "e",
      * preceded by the seed "seed".  Squashes element (and any sub-elements)
      * of the same canonical type, so hash({a:{b:4}}) will be the same
@@ -68,6 +82,10 @@ public:
      */
     static long long int hash64(const BSONElement& e, HashSeed seed);
 
+    /* Like hash64() above, using the hash function of 'hashVersion', which must be valid.
+     */
+    static long long int hash64(const BSONElement& e, HashSeed seed, int hashVersion);
+
 private:
     BSONElementHasher();
 };
@@ -359,5 +359,49 @@ TEST(BSONElementHasher, HashCodeWScope) {
     ASSERT_EQUALS(hashIt(o), 501342939894575968LL);
 }
 
+long long murmur3HashIt(const BSONObj& object, int seed = 0) {
+    return BSONElementHasher::hash64(
+        object.firstElement(), seed, BSONElementHasher::MURMUR3_HASH_VERSION);
+}
+
+TEST(BSONElementHasher, DefaultHashVersionIsMD5) {
+    BSONObj o = BSON("check" << 42);
+    ASSERT_EQUALS(
+        BSONElementHasher::hash64(o.firstElement(), 0, BSONElementHasher::DEFAULT_HASH_VERSION),
+        hashIt(o));
+}
+
+TEST(BSONElementHasher, Murmur3HashesAreStable) {
+    ASSERT_EQUALS(murmur3HashIt(BSON("check" << 42)), 8715208212397937794LL);
+    ASSERT_EQUALS(murmur3HashIt(BSON("check" << 42), 1), -9087602108468514688LL);
+    ASSERT_EQUALS(murmur3HashIt(BSON("check"
+                                     << "mongodb")),
+                  1347139127058840083LL);
+}
+
+TEST(BSONElementHasher, Murmur3SquashesNumericTypesAndIgnoresTopLevelFieldName) {
+    const long long intHash = murmur3HashIt(BSON("a" << 3));
+    ASSERT_EQUALS(intHash, murmur3HashIt(BSON("a" << 3LL)));
+    ASSERT_EQUALS(intHash, murmur3HashIt(BSON("a" << 3.1)));
+    ASSERT_EQUALS(intHash, murmur3HashIt(BSON("b" << 3)));
+    ASSERT_NOT_EQUALS(intHash, murmur3HashIt(BSON("a" << 4)));
+
+    const long long objHash = murmur3HashIt(BSON("a" << BSON("b" << 4)));
+    ASSERT_EQUALS(objHash, murmur3HashIt(BSON("a" << BSON("b" << 4.1))));
+    ASSERT_NOT_EQUALS(objHash, murmur3HashIt(BSON("a" << BSON("c" << 4))));
+}
+
+TEST(BSONElementHasher, Murmur3DiffersFromMD5) {
+    BSONObj o = BSON("check" << 42);
+    ASSERT_NOT_EQUALS(murmur3HashIt(o), hashIt(o));
+}
+
+TEST(BSONElementHasher, ValidHashVersions) {
+    ASSERT_TRUE(BSONElementHasher::isValidHashVersion(0));
+    ASSERT_TRUE(BSONElementHasher::isValidHashVersion(1));
+    ASSERT_FALSE(BSONElementHasher::isValidHashVersion(-1));
+    ASSERT_FALSE(BSONElementHasher::isValidHashVersion(2));
+}
+
 }  // namespace
 }  // namespace mongo
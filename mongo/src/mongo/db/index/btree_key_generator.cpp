@@ -31,6 +31,7 @@
 #include <boost/optional.hpp>
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/field_offset_index.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/query/collation/collation_index_key.h"
@@ -252,8 +253,10 @@ BSONElement BtreeKeyGeneratorV1::extractNextElement(const BSONObj& obj,
                                                     const PositionalPathInfo& positionalInfo,
                                                     const char** field,
                                                     bool* arrayNestedArray) const {
-    std::string firstField = mongoutils::str::before(*field, '.');
-    bool haveObjField = !obj.getField(firstField).eoo();
+    const char* const dot = strchr(*field, '.');
+    const StringData firstField = dot ? StringData(*field, dot - *field) : StringData(*field);
+    const BSONElement firstElt = FieldOffsetIndex::getField(obj, firstField);
+    bool haveObjField = !firstElt.eoo();
     BSONElement arrField = positionalInfo.positionallyIndexedElt;
 
     // An index component field name cannot exist in both a document
@@ -269,7 +272,15 @@ BSONElement BtreeKeyGeneratorV1::extractNextElement(const BSONObj& obj,
 
     *arrayNestedArray = false;
     if (haveObjField) {
-        return dps::extractElementAtPathOrArrayAlongPath(obj, *field);
+        // This is dps::extractElementAtPathOrArrayAlongPath(obj, *field), reusing the lookup of
+        // the first path component above.
+        *field = dot ? dot + 1 : *field + firstField.size();
+        if (firstElt.type() == Array || **field == '\0') {
+            return firstElt;
+        } else if (firstElt.type() == Object) {
+            return dps::extractElementAtPathOrArrayAlongPath(firstElt.embeddedObject(), *field);
+        }
+        return BSONElement();
     } else if (positionalInfo.hasPositionallyIndexedElt()) {
         if (arrField.type() == Array) {
             *arrayNestedArray = true;
@@ -35,6 +35,7 @@
 #include <algorithm>
 #include <iostream>
 
+#include "mongo/bson/field_offset_index.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/json.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
@@ -180,6 +181,21 @@ TEST(BtreeKeyGeneratorTest, GetKeysFromObjectDotted) {
     ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
 }
 
+TEST(BtreeKeyGeneratorTest, GetKeysFromObjectWithFieldOffsetIndex) {
+    BSONObj keyPattern = fromjson("{'a.b': 1, c: 1, d: 1, 'e.f': 1}");
+    BSONObj genKeysFrom = fromjson("{e: 1, d: 'x', c: [1, 2], a: {b: 4}, a: {b: 5}}");
+    ScopedFieldOffsetIndexes fieldOffsetIndexes(1);
+    fieldOffsetIndexes.add(genKeysFrom);
+    ASSERT(ScopedFieldOffsetIndexes::find(genKeysFrom));
+
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expectedKeys.insert(fromjson("{'': 4, '': 1, '': 'x', '': null}"));
+    expectedKeys.insert(fromjson("{'': 4, '': 2, '': 'x', '': null}"));
+    MultikeyPaths expectedMultikeyPaths{
+        std::set<size_t>{}, {0U}, std::set<size_t>{}, std::set<size_t>{}};
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
+}
+
 TEST(BtreeKeyGeneratorTest, GetKeysFromArraySimple) {
     BSONObj keyPattern = fromjson("{a: 1}");
     BSONObj genKeysFrom = fromjson("{a: [1, 2, 3]}");
@@ -32,6 +32,7 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -51,6 +52,7 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/progress_meter.h"
 
@@ -146,6 +148,19 @@ Status IndexAccessMethod::insert(OperationContext* opCtx,
                                  int64_t* numInserted) {
     invariant(numInserted);
     *numInserted = 0;
+    if (_indexBuildInterceptor) {
+        _indexBuildInterceptor->sideWrite(opCtx, loc, {});
+        return Status::OK();
+    }
+    return _insert(opCtx, obj, loc, options, numInserted);
+}
+
+Status IndexAccessMethod::_insert(OperationContext* opCtx,
+                                  const BSONObj& obj,
+                                  const RecordId& loc,
+                                  const InsertDeleteOptions& options,
+                                  int64_t* numInserted) {
+    *numInserted = 0;
     BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     MultikeyPaths multikeyPaths;
     // Delegate to the subclass.
@@ -201,6 +216,95 @@ Status IndexAccessMethod::insert(OperationContext* opCtx,
     return ret;
 }
 
+Status IndexAccessMethod::insertBatch(OperationContext* opCtx,
+                                      const std::vector<BsonRecord>& records,
+                                      const InsertDeleteOptions& options,
+                                      int64_t* numInserted) {
+    invariant(numInserted);
+    *numInserted = 0;
+    if (_indexBuildInterceptor) {
+        for (const auto& record : records) {
+            _indexBuildInterceptor->sideWrite(opCtx, record.id, {});
+        }
+        return Status::OK();
+    }
+
+    typedef BtreeExternalSortComparison::Data KeyAndLoc;
+    std::vector<KeyAndLoc> entries;
+    MultikeyPaths multikeyPaths;
+    bool isMultikey = false;
+    for (const auto& record : records) {
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths recordMultikeyPaths;
+        getKeys(*record.docPtr, options.getKeysMode, &keys, &recordMultikeyPaths);
+
+        // A document generating more than one key makes the index multikey, exactly as it would
+        // when inserted on its own. The paths of all such documents are merged so that the index
+        // metadata is only updated once for the batch.
+        if (keys.size() > 1 || isMultikeyFromPaths(recordMultikeyPaths)) {
+            isMultikey = true;
+            if (multikeyPaths.empty()) {
+                multikeyPaths = std::move(recordMultikeyPaths);
+            } else {
+                for (size_t i = 0; i < recordMultikeyPaths.size(); ++i) {
+                    multikeyPaths[i].insert(recordMultikeyPaths[i].begin(),
+                                            recordMultikeyPaths[i].end());
+                }
+            }
+        }
+
+        for (const auto& key : keys) {
+            entries.emplace_back(key, record.id);
+        }
+    }
+
+    // Equal keys are ordered by RecordId, so a unique index reports the same duplicate as it
+    // would have for one-at-a-time inserts in RecordId order.
+    const BtreeExternalSortComparison comparator(_descriptor->keyPattern(), _descriptor->version());
+    std::sort(entries.begin(), entries.end(), [&](const KeyAndLoc& l, const KeyAndLoc& r) {
+        return comparator(l, r) < 0;
+    });
+
+    const ValidationOperation operation = ValidationOperation::INSERT;
+
+    for (auto i = entries.begin(); i != entries.end(); ++i) {
+        Status status = _newInterface->insert(opCtx, i->first, i->second, options.dupsAllowed);
+
+        if (status.isOK()) {
+            ++*numInserted;
+            IndexKeyEntry indexEntry = IndexKeyEntry(i->first, i->second);
+            _descriptor->getCollection()->informIndexObserver(
+                opCtx, _descriptor, indexEntry, operation);
+            continue;
+        }
+
+        if (status.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(opCtx)) {
+            IndexKeyEntry indexEntry = IndexKeyEntry(i->first, i->second);
+            _descriptor->getCollection()->informIndexObserver(
+                opCtx, _descriptor, indexEntry, operation);
+            continue;
+        }
+
+        if (status.code() == ErrorCodes::DuplicateKeyValue && !_btreeState->isReady(opCtx)) {
+            LOG(3) << "key " << i->first << " already in index during background indexing (ok)";
+            continue;
+        }
+
+        for (auto j = entries.begin(); j != i; ++j) {
+            removeOneKey(opCtx, j->first, j->second, options.dupsAllowed);
+        }
+        *numInserted = 0;
+
+        return status;
+    }
+
+    if (isMultikey) {
+        _btreeState->setMultikey(opCtx, multikeyPaths);
+    }
+
+    return Status::OK();
+}
+
 void IndexAccessMethod::removeOneKey(OperationContext* opCtx,
                                      const BSONObj& key,
                                      const RecordId& loc,
@@ -246,6 +350,11 @@ Status IndexAccessMethod::remove(OperationContext* opCtx,
     MultikeyPaths* multikeyPaths = nullptr;
     getKeys(obj, options.getKeysMode, &keys, multikeyPaths);
 
+    if (_indexBuildInterceptor) {
+        _indexBuildInterceptor->sideWrite(opCtx, loc, {keys.begin(), keys.end()});
+        return Status::OK();
+    }
+
     for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
         removeOneKey(opCtx, *i, loc, options.dupsAllowed);
         ++*numDeleted;
@@ -278,6 +387,14 @@ Status IndexAccessMethod::touch(OperationContext* opCtx) const {
     return _newInterface->touch(opCtx);
 }
 
+Status IndexAccessMethod::setCacheResident(OperationContext* opCtx, bool resident) {
+    return _newInterface->setCacheResident(opCtx, resident);
+}
+
+StatusWith<long long> IndexAccessMethod::getCacheUsageBytes(OperationContext* opCtx) const {
+    return _newInterface->getCacheUsageBytes(opCtx);
+}
+
 RecordId IndexAccessMethod::findSingle(OperationContext* opCtx, const BSONObj& requestedKey) const {
     // Generate the key for this index.
     BSONObj actualKey;
@@ -404,6 +521,11 @@ Status IndexAccessMethod::update(OperationContext* opCtx,
         return Status(ErrorCodes::InternalError, "Invalid UpdateTicket in update");
     }
 
+    if (_indexBuildInterceptor) {
+        _indexBuildInterceptor->sideWrite(opCtx, ticket.loc, ticket.removed);
+        return Status::OK();
+    }
+
     if (ticket.oldKeys.size() + ticket.added.size() - ticket.removed.size() > 1 ||
         isMultikeyFromPaths(ticket.newMultikeyPaths)) {
         _btreeState->setMultikey(opCtx, ticket.newMultikeyPaths);
@@ -446,8 +568,49 @@ Status IndexAccessMethod::update(OperationContext* opCtx,
     return Status::OK();
 }
 
-Status IndexAccessMethod::compact(OperationContext* opCtx) {
-    return this->_newInterface->compact(opCtx);
+Status IndexAccessMethod::compact(OperationContext* opCtx, const CompactOptions* options) {
+    return this->_newInterface->compact(opCtx, options);
+}
+
+void IndexAccessMethod::beginIndexBuildInterception() {
+    invariant(!_indexBuildInterceptor);
+    _indexBuildInterceptor = stdx::make_unique<IndexBuildInterceptor>();
+}
+
+void IndexAccessMethod::endIndexBuildInterception() {
+    invariant(_indexBuildInterceptor);
+    invariant(_indexBuildInterceptor->numPending() == 0);
+    _indexBuildInterceptor.reset();
+}
+
+Status IndexAccessMethod::applySideWrite(OperationContext* opCtx,
+                                         const BSONObj* doc,
+                                         const RecordId& loc,
+                                         const std::vector<BSONObj>& staleKeys,
+                                         const InsertDeleteOptions& options) {
+    const MatchExpression* filter = _btreeState->getFilterExpression();
+    if (doc && filter && !filter->matchesBSON(*doc)) {
+        doc = nullptr;
+    }
+
+    BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    if (doc) {
+        getKeys(*doc, options.getKeysMode, &keys, nullptr);
+    }
+
+    // Removing an entry that isn't in the index is a no-op, and so is inserting one that is, so
+    // the outcome doesn't depend on which of the recorded writes the bulk load already reflects.
+    for (const auto& key : staleKeys) {
+        if (!keys.count(key)) {
+            removeOneKey(opCtx, key, loc, options.dupsAllowed);
+        }
+    }
+
+    if (!doc) {
+        return Status::OK();
+    }
+    int64_t unused;
+    return _insert(opCtx, *doc, loc, options, &unused);
 }
 
 std::unique_ptr<IndexAccessMethod::BulkBuilder> IndexAccessMethod::initiateBulk(
@@ -507,15 +670,53 @@ Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
                                      bool mayInterrupt,
                                      bool dupsAllowed,
                                      set<RecordId>* dupsToDrop) {
+    std::vector<std::unique_ptr<BulkBuilder>> bulks;
+    bulks.push_back(std::move(bulk));
+    return commitBulk(opCtx, std::move(bulks), mayInterrupt, dupsAllowed, dupsToDrop);
+}
+
+Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
+                                     std::vector<std::unique_ptr<BulkBuilder>> bulks,
+                                     bool mayInterrupt,
+                                     bool dupsAllowed,
+                                     set<RecordId>* dupsToDrop) {
+    invariant(!bulks.empty());
     Timer timer;
 
-    std::unique_ptr<BulkBuilder::Sorter::Iterator> i(bulk->_sorter->done());
+    int64_t keysInserted = 0;
+    bool everGeneratedMultipleKeys = false;
+    MultikeyPaths indexMultikeyPaths;
+    std::vector<std::shared_ptr<BulkBuilder::Sorter::Iterator>> sorted;
+    for (auto&& bulk : bulks) {
+        keysInserted += bulk->_keysInserted;
+        everGeneratedMultipleKeys = everGeneratedMultipleKeys || bulk->_everGeneratedMultipleKeys;
+        if (indexMultikeyPaths.empty()) {
+            indexMultikeyPaths = bulk->_indexMultikeyPaths;
+        } else if (!bulk->_indexMultikeyPaths.empty()) {
+            invariant(indexMultikeyPaths.size() == bulk->_indexMultikeyPaths.size());
+            for (size_t j = 0; j < indexMultikeyPaths.size(); ++j) {
+                indexMultikeyPaths[j].insert(bulk->_indexMultikeyPaths[j].begin(),
+                                             bulk->_indexMultikeyPaths[j].end());
+            }
+        }
+        sorted.emplace_back(bulk->_sorter->done());
+    }
+
+    std::shared_ptr<BulkBuilder::Sorter::Iterator> i;
+    if (sorted.size() == 1) {
+        i = std::move(sorted.front());
+    } else {
+        i.reset(BulkBuilder::Sorter::Iterator::merge(
+            sorted,
+            SortOptions(),
+            BtreeExternalSortComparison(_descriptor->keyPattern(), _descriptor->version())));
+    }
 
     stdx::unique_lock<Client> lk(*opCtx->getClient());
     ProgressMeterHolder pm(
         CurOp::get(opCtx)->setMessage_inlock("Index Bulk Build: (2/3) btree bottom up",
                                              "Index: (2/3) BTree Bottom Up Progress",
-                                             bulk->_keysInserted,
+                                             keysInserted,
                                              10));
     lk.unlock();
 
@@ -524,8 +725,8 @@ Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
     writeConflictRetry(opCtx, "setting index multikey flag", "", [&] {
         WriteUnitOfWork wunit(opCtx);
 
-        if (bulk->_everGeneratedMultipleKeys || isMultikeyFromPaths(bulk->_indexMultikeyPaths)) {
-            _btreeState->setMultikey(opCtx, bulk->_indexMultikeyPaths);
+        if (everGeneratedMultipleKeys || isMultikeyFromPaths(indexMultikeyPaths)) {
+            _btreeState->setMultikey(opCtx, indexMultikeyPaths);
         }
 
         builder.reset(_newInterface->getBulkBuilder(opCtx, dupsAllowed));
@@ -30,9 +30,11 @@
 
 #include <atomic>
 #include <memory>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/index/index_build_interceptor.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
@@ -47,6 +49,7 @@ extern AtomicBool failIndexKeyTooLong;
 class BSONObjBuilder;
 class MatchExpression;
 class UpdateTicket;
+struct BsonRecord;
 struct InsertDeleteOptions;
 
 /**
@@ -107,6 +110,18 @@ public:
                   const InsertDeleteOptions& options,
                   int64_t* numInserted);
 
+    /**
+     * Analogous to insert(), but for every document in 'records' at once. The keys of the whole
+     * batch are generated first and applied to the index in key order, so that consecutive
+     * inserts land on neighbouring pages of the underlying btree. 'numInserted' will be set to the
+     * total number of keys added for the batch. If any key fails to insert, the keys already added
+     * for the batch are removed again and the error is returned.
+     */
+    Status insertBatch(OperationContext* opCtx,
+                       const std::vector<BsonRecord>& records,
+                       const InsertDeleteOptions& options,
+                       int64_t* numInserted);
+
     /**
      * Analogous to above, but remove the records instead of inserting them.
      * 'numDeleted' will be set to the number of keys removed from the index for the document.
@@ -187,6 +202,17 @@ public:
      */
     Status touch(OperationContext* opCtx) const;
 
+    /**
+     * Keeps the index in the storage engine's cache, or stops doing so.
+     */
+    Status setCacheResident(OperationContext* opCtx, bool resident);
+
+    /**
+     * Returns the number of bytes of the index held in the storage engine's cache, or
+     * CommandNotSupported if the storage engine cannot tell.
+     */
+    StatusWith<long long> getCacheUsageBytes(OperationContext* opCtx) const;
+
     /**
      * Walk the entire index, checking the internal structure for consistency.
      * Set numKeys to the number of keys in the index.
@@ -214,7 +240,47 @@ public:
      * Attempt compaction to regain disk space if the indexed record store supports
      * compaction-in-place.
      */
-    Status compact(OperationContext* opCtx);
+    Status compact(OperationContext* opCtx, const CompactOptions* options);
+
+    //
+    // Hybrid index build support
+    //
+
+    /**
+     * Starts recording the writes made to this index in an IndexBuildInterceptor instead of
+     * applying them, so that a background build can bulk load the index while the collection is
+     * being written to. insert(), insertBatch(), remove() and update() only record which
+     * documents they wrote until endIndexBuildInterception() is called.
+     *
+     * Requires an exclusive lock on the collection.
+     */
+    void beginIndexBuildInterception();
+
+    /**
+     * Resumes applying writes to this index directly. Every recorded write must have been
+     * drained into the index first.
+     *
+     * Requires an exclusive lock on the collection.
+     */
+    void endIndexBuildInterception();
+
+    /**
+     * Returns the interceptor recording writes to this index, or null if there is none.
+     */
+    IndexBuildInterceptor* getIndexBuildInterceptor() const {
+        return _indexBuildInterceptor.get();
+    }
+
+    /**
+     * Makes the index entries for 'loc' match 'doc', bypassing any IndexBuildInterceptor: unindexes
+     * those of 'staleKeys' that 'doc' no longer generates and indexes the keys 'doc' does
+     * generate. 'doc' is null if the document no longer exists.
+     */
+    Status applySideWrite(OperationContext* opCtx,
+                          const BSONObj* doc,
+                          const RecordId& loc,
+                          const std::vector<BSONObj>& staleKeys,
+                          const InsertDeleteOptions& options);
 
     //
     // Bulk operations support
@@ -281,6 +347,17 @@ public:
                       bool dupsAllowed,
                       std::set<RecordId>* dups);
 
+    /**
+     * Like commitBulk() above, but for several BulkBuilders over disjoint sets of documents, e.g.
+     * ones filled concurrently by different threads. Their sorted outputs are k-way merged into
+     * a single bottom-up build.
+     */
+    Status commitBulk(OperationContext* opCtx,
+                      std::vector<std::unique_ptr<BulkBuilder>> bulks,
+                      bool mayInterrupt,
+                      bool dupsAllowed,
+                      std::set<RecordId>* dups);
+
     /**
      * Specifies whether getKeys should relax the index constraints or not.
      */
@@ -337,6 +414,15 @@ protected:
     const IndexDescriptor* _descriptor;
 
 private:
+    /**
+     * Implements insert() for indexes whose writes are not being intercepted.
+     */
+    Status _insert(OperationContext* opCtx,
+                   const BSONObj& obj,
+                   const RecordId& loc,
+                   const InsertDeleteOptions& options,
+                   int64_t* numInserted);
+
     void removeOneKey(OperationContext* opCtx,
                       const BSONObj& key,
                       const RecordId& loc,
@@ -345,6 +431,9 @@ private:
     //IndexAccessMethod::IndexAccessMethodгʼֵ
     //wiredtiger洢ӦWiredTigerIndexUnique
     const std::unique_ptr<SortedDataInterface> _newInterface;
+
+    // Set while a hybrid background build is bulk loading this index.
+    std::unique_ptr<IndexBuildInterceptor> _indexBuildInterceptor;
 };
 
 /**
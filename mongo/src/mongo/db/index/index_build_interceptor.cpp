@@ -0,0 +1,150 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kIndex
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index/index_build_interceptor.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+namespace {
+
+// Number of written documents applied to the index per unit of work while draining.
+const size_t kDrainBatchSize = 1000;
+
+}  // namespace
+
+/**
+ * Hands a write over to the IndexBuildInterceptor once the unit of work making it commits.
+ */
+class IndexBuildInterceptor::RecordOnCommit : public RecoveryUnit::Change {
+public:
+    RecordOnCommit(IndexBuildInterceptor* interceptor,
+                   const RecordId& loc,
+                   std::vector<BSONObj> removedKeys)
+        : _interceptor(interceptor), _loc(loc), _removedKeys(std::move(removedKeys)) {}
+
+    void commit() override {
+        _interceptor->_record(_loc, std::move(_removedKeys));
+    }
+
+    void rollback() override {}
+
+private:
+    IndexBuildInterceptor* const _interceptor;
+    const RecordId _loc;
+    std::vector<BSONObj> _removedKeys;
+};
+
+void IndexBuildInterceptor::sideWrite(OperationContext* opCtx,
+                                      const RecordId& loc,
+                                      std::vector<BSONObj> removedKeys) {
+    for (auto&& key : removedKeys) {
+        key = key.getOwned();
+    }
+    opCtx->recoveryUnit()->registerChange(new RecordOnCommit(this, loc, std::move(removedKeys)));
+}
+
+void IndexBuildInterceptor::_record(const RecordId& loc, std::vector<BSONObj> removedKeys) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto& keys = _pending[loc];
+    keys.insert(keys.end(),
+                std::make_move_iterator(removedKeys.begin()),
+                std::make_move_iterator(removedKeys.end()));
+}
+
+size_t IndexBuildInterceptor::numPending() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _pending.size();
+}
+
+Status IndexBuildInterceptor::drainWritesIntoIndex(OperationContext* opCtx,
+                                                   const Collection* collection,
+                                                   IndexAccessMethod* iam,
+                                                   const InsertDeleteOptions& options,
+                                                   size_t* numDrainedOut) {
+    invariant(!opCtx->lockState()->inAWriteUnitOfWork());
+
+    PendingWrites pending;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        pending.swap(_pending);
+    }
+    if (numDrainedOut) {
+        *numDrainedOut = pending.size();
+    }
+
+    // Writes are recorded after they commit, so a snapshot opened from here on sees all of them.
+    opCtx->recoveryUnit()->abandonSnapshot();
+
+    auto batchBegin = pending.begin();
+    while (batchBegin != pending.end()) {
+        opCtx->checkForInterrupt();
+
+        auto batchEnd = batchBegin;
+        for (size_t i = 0; i < kDrainBatchSize && batchEnd != pending.end(); ++i) {
+            ++batchEnd;
+        }
+
+        Status status = writeConflictRetry(
+            opCtx, "draining index build side writes", collection->ns().ns(), [&] {
+                WriteUnitOfWork wunit(opCtx);
+                for (auto it = batchBegin; it != batchEnd; ++it) {
+                    Snapshotted<BSONObj> doc;
+                    const bool exists = collection->findDoc(opCtx, it->first, &doc);
+                    Status status = iam->applySideWrite(
+                        opCtx, exists ? &doc.value() : nullptr, it->first, it->second, options);
+                    if (!status.isOK()) {
+                        return status;
+                    }
+                }
+                wunit.commit();
+                return Status::OK();
+            });
+        if (!status.isOK()) {
+            return status;
+        }
+
+        batchBegin = batchEnd;
+    }
+
+    LOG(1) << "applied writes to " << pending.size() << " documents of " << collection->ns()
+           << " made during a hybrid index build";
+    return Status::OK();
+}
+
+}  // namespace mongo
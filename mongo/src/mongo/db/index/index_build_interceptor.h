@@ -0,0 +1,103 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class Collection;
+class IndexAccessMethod;
+class OperationContext;
+struct InsertDeleteOptions;
+
+/**
+ * Records the writes that concurrent operations make to an index while a hybrid background build
+ * bulk loads it, so that the bulk load never races with writes to the same index.
+ *
+ * Only the RecordIds of the written documents are kept, together with the keys their writes
+ * removed. Draining looks every recorded document up again and makes its index entries match its
+ * current version, which makes the result independent of the order in which the writes were
+ * recorded. The recorded writes are held in memory; they are bounded by the number of documents
+ * written while the build scans the collection.
+ *
+ * Writes are only recorded when the unit of work making them commits, so rolled back writes
+ * leave no trace. This class is thread safe.
+ */
+class IndexBuildInterceptor {
+    MONGO_DISALLOW_COPYING(IndexBuildInterceptor);
+
+public:
+    IndexBuildInterceptor() = default;
+
+    /**
+     * Records a write to the document at 'loc' which took 'removedKeys' out of the index. Takes
+     * effect when the caller's unit of work commits. Must be called inside of a WriteUnitOfWork.
+     */
+    void sideWrite(OperationContext* opCtx, const RecordId& loc, std::vector<BSONObj> removedKeys);
+
+    /**
+     * Applies every write recorded so far to the index behind 'iam', reading the written
+     * documents from 'collection' on a new snapshot. Writes recorded while draining are left for
+     * the next call. 'numDrainedOut', if not null, is set to the number of documents applied.
+     *
+     * Must not be called inside of a WriteUnitOfWork.
+     */
+    Status drainWritesIntoIndex(OperationContext* opCtx,
+                                const Collection* collection,
+                                IndexAccessMethod* iam,
+                                const InsertDeleteOptions& options,
+                                size_t* numDrainedOut = nullptr);
+
+    /**
+     * Returns the number of written documents waiting to be drained.
+     */
+    size_t numPending() const;
+
+private:
+    class RecordOnCommit;
+
+    using PendingWrites = std::map<RecordId, std::vector<BSONObj>>;
+
+    void _record(const RecordId& loc, std::vector<BSONObj> removedKeys);
+
+    mutable stdx::mutex _mutex;
+
+    // The keys each written document removed, pending the next drain.
+    PendingWrites _pending;
+};
+
+}  // namespace mongo
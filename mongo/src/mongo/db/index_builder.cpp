@@ -177,6 +177,10 @@ Status IndexBuilder::_build(OperationContext* opCtx,
                     if (allowBackgroundBuilding) {
                         dbLock->relockWithMode(MODE_X);
                     }
+                    status = indexer.drainBackgroundWrites();
+                }
+
+                if (status.isOK()) {
                     WriteUnitOfWork wunit(opCtx);
                     indexer.commit();
                     wunit.commit();
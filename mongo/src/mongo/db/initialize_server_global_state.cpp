@@ -32,6 +32,7 @@
 
 #include "mongo/db/initialize_server_global_state.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
 #include <iostream>
 #include <memory>
@@ -53,6 +54,7 @@
 #include "mongo/db/auth/security_key.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/logger/async_appender.h"
 #include "mongo/logger/console_appender.h"
 #include "mongo/logger/logger.h"
 #include "mongo/logger/message_event.h"
@@ -215,6 +217,24 @@ void forkServerOrDie() {
         quickExit(EXIT_FAILURE);
 }
 
+namespace {
+
+// When enabled, the global log domain writes to its file or syslog from a background thread so
+// operations never wait on log I/O; messages are dropped (and counted) if the buffer overflows.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(asyncLogging, bool, false);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(asyncLogBufferSize, int, 8192);
+
+logger::MessageLogDomain::AppenderAutoPtr wrapGlobalAppender(
+    logger::MessageLogDomain::AppenderAutoPtr appender) {
+    if (!asyncLogging) {
+        return appender;
+    }
+    return logger::MessageLogDomain::AppenderAutoPtr(new logger::AsyncAppender(
+        std::move(appender), static_cast<size_t>(std::max(asyncLogBufferSize, 1))));
+}
+
+}  // namespace
+
 MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
                           ("GlobalLogManager", "EndStartupOptionHandling", "ForkServer"),
                           ("default"))
@@ -240,8 +260,9 @@ MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
         openlog(strdup(sb.str().c_str()), LOG_PID | LOG_CONS, serverGlobalParams.syslogFacility);
         LogManager* manager = logger::globalLogManager();
         manager->getGlobalDomain()->clearAppenders();
-        manager->getGlobalDomain()->attachAppender(MessageLogDomain::AppenderAutoPtr(
-            new SyslogAppender<MessageEventEphemeral>(new logger::MessageEventWithContextEncoder)));
+        manager->getGlobalDomain()->attachAppender(
+            wrapGlobalAppender(MessageLogDomain::AppenderAutoPtr(new SyslogAppender<
+                MessageEventEphemeral>(new logger::MessageEventWithContextEncoder))));
         manager->getNamedDomain("javascriptOutput")
             ->attachAppender(
                 MessageLogDomain::AppenderAutoPtr(new SyslogAppender<MessageEventEphemeral>(
@@ -304,9 +325,9 @@ MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
 
         LogManager* manager = logger::globalLogManager();
         manager->getGlobalDomain()->clearAppenders();
-        manager->getGlobalDomain()->attachAppender(
+        manager->getGlobalDomain()->attachAppender(wrapGlobalAppender(
             MessageLogDomain::AppenderAutoPtr(new RotatableFileAppender<MessageEventEphemeral>(
-                new MessageEventDetailsEncoder, writer.getValue())));
+                new MessageEventDetailsEncoder, writer.getValue()))));
         manager->getNamedDomain("javascriptOutput")
             ->attachAppender(
                 MessageLogDomain::AppenderAutoPtr(new RotatableFileAppender<MessageEventEphemeral>(
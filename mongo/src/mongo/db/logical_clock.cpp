@@ -92,21 +92,16 @@ void LogicalClock::set(ServiceContext* service, std::unique_ptr<LogicalClock> cl
 LogicalClock::LogicalClock(ServiceContext* service) : _service(service) {}
 
 LogicalTime LogicalClock::getClusterTime() {
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
-    return _clusterTime;
+    return LogicalTime(Timestamp(_clusterTime.load()));
 }
 
 Status LogicalClock::advanceClusterTime(const LogicalTime newTime) {
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
-
-    auto rateLimitStatus = _passesRateLimiter_inlock(newTime);
+    auto rateLimitStatus = _passesRateLimiter(newTime);
     if (!rateLimitStatus.isOK()) {
         return rateLimitStatus;
     }
 
-    if (newTime > _clusterTime) {
-        _clusterTime = newTime;
-    }
+    _advanceTo(newTime);
 
     return Status::OK();
 }
@@ -115,51 +110,56 @@ LogicalTime LogicalClock::reserveTicks(uint64_t nTicks) {
 
     invariant(nTicks > 0 && nTicks <= kMaxSignedInt);
 
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
-
-    LogicalTime clusterTime = _clusterTime;
-
     const unsigned wallClockSecs =
         durationCount<Seconds>(_service->getFastClockSource()->now().toDurationSinceEpoch());
-    unsigned clusterTimeSecs = clusterTime.asTimestamp().getSecs();
 
-    // Synchronize clusterTime with wall clock time, if clusterTime was behind in seconds.
-    if (clusterTimeSecs < wallClockSecs) {
-        clusterTime = LogicalTime(Timestamp(wallClockSecs, 0));
-    }
-    // If reserving 'nTicks' would force the cluster timestamp's increment field to exceed (2^31-1),
-    // overflow by moving to the next second. We use the signed integer maximum as an overflow point
-    // in order to preserve compatibility with potentially signed or unsigned integral Timestamp
-    // increment types. It is also unlikely to apply more than 2^31 oplog entries in the span of one
-    // second.
-    else if (clusterTime.asTimestamp().getInc() > (kMaxSignedInt - nTicks)) {
-
-        log() << "Exceeded maximum allowable increment value within one second. Moving clusterTime "
-                 "forward to the next second.";
-
-        // Move time forward to the next second
-        clusterTime = LogicalTime(Timestamp(clusterTime.asTimestamp().getSecs() + 1, 0));
-    }
+    uint64_t current = _clusterTime.load();
+    while (true) {
+        LogicalTime clusterTime{Timestamp(current)};
+        unsigned clusterTimeSecs = clusterTime.asTimestamp().getSecs();
 
-    uassert(40482,
-            "cluster time cannot be advanced beyond its maximum value",
-            lessThanOrEqualToMaxPossibleTime(clusterTime, nTicks));
+        // Synchronize clusterTime with wall clock time, if clusterTime was behind in seconds.
+        if (clusterTimeSecs < wallClockSecs) {
+            clusterTime = LogicalTime(Timestamp(wallClockSecs, 0));
+        }
+        // If reserving 'nTicks' would force the cluster timestamp's increment field to exceed
+        // (2^31-1), overflow by moving to the next second. We use the signed integer maximum as an
+        // overflow point in order to preserve compatibility with potentially signed or unsigned
+        // integral Timestamp increment types. It is also unlikely to apply more than 2^31 oplog
+        // entries in the span of one second.
+        else if (clusterTime.asTimestamp().getInc() > (kMaxSignedInt - nTicks)) {
+
+            log() << "Exceeded maximum allowable increment value within one second. Moving "
+                     "clusterTime forward to the next second.";
+
+            // Move time forward to the next second
+            clusterTime = LogicalTime(Timestamp(clusterTime.asTimestamp().getSecs() + 1, 0));
+        }
 
-    // Save the next cluster time.
-    clusterTime.addTicks(1);
-    _clusterTime = clusterTime;
+        uassert(40482,
+                "cluster time cannot be advanced beyond its maximum value",
+                lessThanOrEqualToMaxPossibleTime(clusterTime, nTicks));
 
-    // Add the rest of the requested ticks if needed.
-    if (nTicks > 1) {
-        _clusterTime.addTicks(nTicks - 1);
-    }
+        // The next cluster time is the first reserved tick; the rest of the requested ticks, if
+        // any, are reserved by moving the clock past them.
+        clusterTime.addTicks(1);
+        LogicalTime newClusterTime = clusterTime;
+        if (nTicks > 1) {
+            newClusterTime.addTicks(nTicks - 1);
+        }
 
-    return clusterTime;
+        const uint64_t witnessed =
+            _clusterTime.compareAndSwap(current, newClusterTime.asTimestamp().asULL());
+        if (witnessed == current) {
+            return clusterTime;
+        }
+
+        // Another thread moved the clock; retry from the value it left.
+        current = witnessed;
+    }
 }
 
 void LogicalClock::setClusterTimeFromTrustedSource(LogicalTime newTime) {
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
-
     // Rate limit checks are skipped here so a server with no activity for longer than
     // maxAcceptableLogicalClockDriftSecs seconds can still have its cluster time initialized.
 
@@ -167,12 +167,22 @@ void LogicalClock::setClusterTimeFromTrustedSource(LogicalTime newTime) {
             "cluster time cannot be advanced beyond its maximum value",
             lessThanOrEqualToMaxPossibleTime(newTime, 0));
 
-    if (newTime > _clusterTime) {
-        _clusterTime = newTime;
+    _advanceTo(newTime);
+}
+
+void LogicalClock::_advanceTo(LogicalTime newTime) {
+    const uint64_t newValue = newTime.asTimestamp().asULL();
+    uint64_t current = _clusterTime.load();
+    while (newValue > current) {
+        const uint64_t witnessed = _clusterTime.compareAndSwap(current, newValue);
+        if (witnessed == current) {
+            return;
+        }
+        current = witnessed;
     }
 }
 
-Status LogicalClock::_passesRateLimiter_inlock(LogicalTime newTime) {
+Status LogicalClock::_passesRateLimiter(LogicalTime newTime) {
     const unsigned wallClockSecs =
         durationCount<Seconds>(_service->getFastClockSource()->now().toDurationSinceEpoch());
     auto maxAcceptableDriftSecs = static_cast<const unsigned>(maxAcceptableLogicalClockDriftSecs);
@@ -28,8 +28,9 @@
 
 #pragma once
 
+#include "mongo/bson/timestamp.h"
 #include "mongo/db/logical_time.h"
-#include "mongo/stdx/mutex.h"
+#include "mongo/platform/atomic_word.h"
 
 namespace mongo {
 class ServiceContext;
@@ -87,13 +88,19 @@ private:
      * Rate limiter for advancing cluster time. Rejects newTime if its seconds value is more than
      * kMaxAcceptableLogicalClockDriftSecs seconds ahead of this node's wall clock.
      */
-    Status _passesRateLimiter_inlock(LogicalTime newTime);
+    Status _passesRateLimiter(LogicalTime newTime);
+
+    /**
+     * Moves _clusterTime forward to newTime, unless it is already at or past it.
+     */
+    void _advanceTo(LogicalTime newTime);
 
     ServiceContext* const _service;
 
-    // The mutex protects _clusterTime.
-    stdx::mutex _mutex;
-    LogicalTime _clusterTime;
+    // The cluster time as Timestamp::asULL(). Every writer on a primary reserves ticks from it, so
+    // it is updated with compare-and-swap rather than under a mutex. The packed value orders the
+    // same way as the Timestamp.
+    AtomicUInt64 _clusterTime{Timestamp().asULL()};
 };
 
 }  // namespace mongo
@@ -34,6 +34,7 @@
 
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/logical_session_id_helpers.h"
+#include "mongo/db/ops/write_ops.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
@@ -43,6 +44,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/periodic_runner.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -53,7 +55,12 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(
 
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(disableLogicalSessionCacheRefresh, bool, false);
 
+// When positive, the refresh job writes session records to the sessions collection in batches
+// spaced out so as to stay under this many records per second. Zero writes them all at once.
+MONGO_EXPORT_SERVER_PARAMETER(logicalSessionRefreshMaxRecordsPerSecond, int, 0);
+
 constexpr Minutes LogicalSessionCacheImpl::kLogicalSessionDefaultRefresh;
+constexpr size_t LogicalSessionCacheImpl::kNumActiveSessionsStripes;
 
 LogicalSessionCacheImpl::LogicalSessionCacheImpl(
     std::unique_ptr<ServiceLiason> service,
@@ -86,9 +93,10 @@ LogicalSessionCacheImpl::~LogicalSessionCacheImpl() {
 }
 
 Status LogicalSessionCacheImpl::promote(LogicalSessionId lsid) {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    auto it = _activeSessions.find(lsid);
-    if (it == _activeSessions.end()) {
+    auto& stripe = _getStripe(lsid);
+    stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+    auto it = stripe.sessions.find(lsid);
+    if (it == stripe.sessions.end()) {
         return {ErrorCodes::NoSuchSession, "no matching session record found in the cache"};
     }
 
@@ -155,8 +163,12 @@ Date_t LogicalSessionCacheImpl::now() {
 }
 
 size_t LogicalSessionCacheImpl::size() {
-    stdx::lock_guard<stdx::mutex> lock(_cacheMutex);
-    return _activeSessions.size();
+    size_t size = 0;
+    for (auto& stripe : _activeSessions) {
+        stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+        size += stripe.sessions.size();
+    }
+    return size;
 }
 
 void LogicalSessionCacheImpl::_periodicRefresh(Client* client) {
@@ -282,7 +294,7 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
     LogicalSessionIdMap<LogicalSessionRecord> activeSessions;
 
     // backSwapper creates a guard that in the case of a exception
-    // replaces the ending or active sessions that swapped out of of LogicalSessionCache,
+    // replaces the ending sessions that swapped out of of LogicalSessionCache,
     // and merges in any records that had been added since we swapped them
     // out.
     auto backSwapper = [this](auto& member, auto& temp) {
@@ -300,9 +312,10 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
         using std::swap;
         stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
         swap(explicitlyEndingSessions, _endingSessions);
-        swap(activeSessions, _activeSessions);
     }
-    auto activeSessionsBackSwapper = backSwapper(_activeSessions, activeSessions);
+    activeSessions = _takeActiveSessions();
+    auto activeSessionsBackSwapper =
+        MakeGuard([this, &activeSessions] { _restoreActiveSessions(activeSessions); });
     auto explicitlyEndingBackSwaper = backSwapper(_endingSessions, explicitlyEndingSessions);
 
     // remove all explicitlyEndingSessions from activeSessions
@@ -328,7 +341,7 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
     }
 
     // Refresh the active sessions in the sessions collection.
-    uassertStatusOK(_sessionsColl->refreshSessions(opCtx, activeSessionRecords));
+    _refreshRecords(opCtx, activeSessionRecords, &activeSessions);
     activeSessionsBackSwapper.Dismiss();
     {
         stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
@@ -380,34 +393,110 @@ void LogicalSessionCacheImpl::endSessions(const LogicalSessionIdSet& sessions) {
 }
 
 LogicalSessionCacheStats LogicalSessionCacheImpl::getStats() {
+    const auto activeSessionsCount = size();
     stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    _stats.setActiveSessionsCount(_activeSessions.size());
+    _stats.setActiveSessionsCount(activeSessionsCount);
     return _stats;
 }
 
 void LogicalSessionCacheImpl::_addToCache(LogicalSessionRecord record) {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    _activeSessions.insert(std::make_pair(record.getId(), record));
+    auto& stripe = _getStripe(record.getId());
+    stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+    stripe.sessions.insert(std::make_pair(record.getId(), record));
+}
+
+LogicalSessionCacheImpl::ActiveSessionsStripe& LogicalSessionCacheImpl::_getStripe(
+    const LogicalSessionId& lsid) const {
+    return _activeSessions[LogicalSessionIdHash{}(lsid) % kNumActiveSessionsStripes];
+}
+
+LogicalSessionIdMap<LogicalSessionRecord> LogicalSessionCacheImpl::_takeActiveSessions() {
+    LogicalSessionIdMap<LogicalSessionRecord> sessions;
+    for (auto& stripe : _activeSessions) {
+        LogicalSessionIdMap<LogicalSessionRecord> stripeSessions;
+        {
+            using std::swap;
+            stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+            swap(stripeSessions, stripe.sessions);
+        }
+        sessions.insert(stripeSessions.begin(), stripeSessions.end());
+    }
+    return sessions;
+}
+
+void LogicalSessionCacheImpl::_restoreActiveSessions(
+    const LogicalSessionIdMap<LogicalSessionRecord>& sessions) {
+    for (const auto& it : sessions) {
+        auto& stripe = _getStripe(it.first);
+        stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+        stripe.sessions.emplace(it);
+    }
+}
+
+void LogicalSessionCacheImpl::_refreshRecords(
+    OperationContext* opCtx,
+    const LogicalSessionRecordSet& records,
+    LogicalSessionIdMap<LogicalSessionRecord>* activeSessions) {
+    const auto maxRecordsPerSecond = logicalSessionRefreshMaxRecordsPerSecond.load();
+    if (maxRecordsPerSecond <= 0) {
+        uassertStatusOK(_sessionsColl->refreshSessions(opCtx, records));
+        return;
+    }
+
+    const size_t batchSize =
+        std::min(static_cast<size_t>(maxRecordsPerSecond), write_ops::kMaxWriteBatchSize);
+    Timer timer;
+    size_t numRefreshed = 0;
+    LogicalSessionRecordSet batch;
+    auto refreshBatch = [&] {
+        uassertStatusOK(_sessionsColl->refreshSessions(opCtx, batch));
+        for (const auto& record : batch) {
+            activeSessions->erase(record.getId());
+        }
+        numRefreshed += batch.size();
+        batch.clear();
+
+        // Wait until the records refreshed so far fit under the rate limit.
+        const Milliseconds target(static_cast<long long>(numRefreshed) * 1000 /
+                                  maxRecordsPerSecond);
+        const Milliseconds elapsed(timer.millis());
+        if (numRefreshed < records.size() && elapsed < target) {
+            opCtx->sleepFor(target - elapsed);
+        }
+    };
+
+    for (const auto& record : records) {
+        batch.insert(record);
+        if (batch.size() >= batchSize) {
+            refreshBatch();
+        }
+    }
+    if (!batch.empty()) {
+        refreshBatch();
+    }
 }
 
 std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds() const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
     std::vector<LogicalSessionId> ret;
-    ret.reserve(_activeSessions.size());
-    for (const auto& id : _activeSessions) {
-        ret.push_back(id.first);
+    for (auto& stripe : _activeSessions) {
+        stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+        for (const auto& id : stripe.sessions) {
+            ret.push_back(id.first);
+        }
     }
     return ret;
 }
 
 std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds(
     const std::vector<SHA256Block>& userDigests) const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
     std::vector<LogicalSessionId> ret;
-    for (const auto& it : _activeSessions) {
-        if (std::find(userDigests.cbegin(), userDigests.cend(), it.first.getUid()) !=
-            userDigests.cend()) {
-            ret.push_back(it.first);
+    for (auto& stripe : _activeSessions) {
+        stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+        for (const auto& it : stripe.sessions) {
+            if (std::find(userDigests.cbegin(), userDigests.cend(), it.first.getUid()) !=
+                userDigests.cend()) {
+                ret.push_back(it.first);
+            }
         }
     }
     return ret;
@@ -415,9 +504,10 @@ std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds(
 
 boost::optional<LogicalSessionRecord> LogicalSessionCacheImpl::peekCached(
     const LogicalSessionId& id) const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    const auto it = _activeSessions.find(id);
-    if (it == _activeSessions.end()) {
+    auto& stripe = _getStripe(id);
+    stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+    const auto it = stripe.sessions.find(id);
+    if (it == stripe.sessions.end()) {
         return boost::none;
     }
     return it->second;
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/db/logical_session_cache.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/refresh_sessions_gen.h"
@@ -46,6 +48,7 @@ class OperationContext;
 class ServiceContext;
 
 extern int logicalSessionRefreshMinutes;
+extern AtomicInt32 logicalSessionRefreshMaxRecordsPerSecond;
 
 /**
  * A thread-safe cache structure for logical session records.
@@ -148,6 +151,39 @@ private:
      */
     void _addToCache(LogicalSessionRecord record);
 
+    /**
+     * The active sessions are striped by lsid so that operations on different sessions don't
+     * contend on a single mutex. _cacheMutex must not be taken while holding a stripe's mutex.
+     */
+    struct ActiveSessionsStripe {
+        stdx::mutex mutex;
+        LogicalSessionIdMap<LogicalSessionRecord> sessions;
+    };
+
+    static constexpr size_t kNumActiveSessionsStripes = 16;
+
+    ActiveSessionsStripe& _getStripe(const LogicalSessionId& lsid) const;
+
+    /**
+     * Removes all records from the active sessions and returns them.
+     */
+    LogicalSessionIdMap<LogicalSessionRecord> _takeActiveSessions();
+
+    /**
+     * Puts back records taken by _takeActiveSessions() that could not be refreshed, unless the
+     * cache has gained a newer record for the same session in the meantime.
+     */
+    void _restoreActiveSessions(const LogicalSessionIdMap<LogicalSessionRecord>& sessions);
+
+    /**
+     * Refreshes 'records' in the sessions collection, in bounded batches spaced out so as not to
+     * exceed logicalSessionRefreshMaxRecordsPerSecond when that is set. Erases each batch from
+     * 'activeSessions' once it has been refreshed.
+     */
+    void _refreshRecords(OperationContext* opCtx,
+                         const LogicalSessionRecordSet& records,
+                         LogicalSessionIdMap<LogicalSessionRecord>* activeSessions);
+
     const Minutes _refreshInterval;
     const Minutes _sessionTimeout;
 
@@ -163,7 +199,7 @@ private:
 
     mutable stdx::mutex _cacheMutex;
 
-    LogicalSessionIdMap<LogicalSessionRecord> _activeSessions;
+    mutable std::array<ActiveSessionsStripe, kNumActiveSessionsStripes> _activeSessions;
 
     LogicalSessionIdSet _endingSessions;
 
@@ -47,6 +47,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/ensure_fcv.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -270,6 +271,39 @@ TEST_F(LogicalSessionCacheTest, ManySignedLsidsInCacheRefresh) {
     ASSERT(cache()->refreshNow(client()).isOK());
 }
 
+// Test that a rate limited refresh writes all records in bounded batches
+TEST_F(LogicalSessionCacheTest, RateLimitedRefreshWritesRecordsInBatches) {
+    const int count = 1500;
+    for (int i = 0; i < count; i++) {
+        auto record = makeLogicalSessionRecordForTest();
+        cache()->startSession(opCtx(), record);
+    }
+    ASSERT_EQ(cache()->size(), size_t(count));
+
+    const auto originalMaxRecordsPerSecond = logicalSessionRefreshMaxRecordsPerSecond.load();
+    logicalSessionRefreshMaxRecordsPerSecond.store(1000);
+    ON_BLOCK_EXIT(
+        [&] { logicalSessionRefreshMaxRecordsPerSecond.store(originalMaxRecordsPerSecond); });
+
+    LogicalSessionIdSet refreshed;
+    int numBatches = 0;
+    sessions()->setRefreshHook([&](const LogicalSessionRecordSet& sessions) {
+        ASSERT_LTE(sessions.size(), 1000U);
+        for (const auto& record : sessions) {
+            refreshed.insert(record.getId());
+        }
+        ++numBatches;
+        return Status::OK();
+    });
+
+    clearOpCtx();
+    service()->fastForward(kForceRefresh);
+    ASSERT(cache()->refreshNow(client()).isOK());
+    ASSERT_EQ(refreshed.size(), size_t(count));
+    ASSERT_EQ(numBatches, 2);
+    ASSERT_EQ(cache()->size(), 0U);
+}
+
 //
 TEST_F(LogicalSessionCacheTest, RefreshMatrixSessionState) {
     const std::vector<std::vector<std::string>> stateNames = {
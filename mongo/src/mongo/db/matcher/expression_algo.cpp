@@ -36,6 +36,7 @@
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/expression_tree.h"
+#include "mongo/db/matcher/expression_type.h"
 #include "mongo/db/matcher/schema/expression_internal_schema_xor.h"
 #include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/query/collation/collation_index_key.h"
@@ -170,11 +171,20 @@ bool _isSubsetOf(const MatchExpression* lhs, const ComparisonMatchExpression* rh
  * 'rhs', i.e. a document matched by 'lhs' must also be matched by 'rhs', and false otherwise.
  */
 bool _isSubsetOf(const MatchExpression* lhs, const ExistsMatchExpression* rhs) {
+    // The path compared by $not expressions is that of their subexpression.
+    const StringData lhsPath =
+        lhs->matchType() == MatchExpression::NOT ? lhs->getChild(0)->path() : lhs->path();
+
     // An expression can only match a subset of the documents matched by another if they are
-    // comparing the same field. Defer checking the path for $not expressions until the
-    // subexpression is examined.
-    if (lhs->matchType() != MatchExpression::NOT && lhs->path() != rhs->path()) {
-        return false;
+    // comparing the same field, or a field nested within it: a document with a value for 'a.b'
+    // necessarily has one for 'a'.
+    if (lhsPath != rhs->path()) {
+        if (!expression::isPathPrefixOf(rhs->path(), lhsPath)) {
+            return false;
+        }
+        ExistsMatchExpression lhsPathExists;
+        lhsPathExists.init(lhsPath).transitional_ignore();
+        return _isSubsetOf(lhs, &lhsPathExists);
     }
 
     if (ComparisonMatchExpression::isComparisonMatchExpression(lhs)) {
@@ -199,12 +209,6 @@ bool _isSubsetOf(const MatchExpression* lhs, const ExistsMatchExpression* rhs) {
             return !ime->hasNull();
         }
         case MatchExpression::NOT:
-            // An expression can only match a subset of the documents matched by another if they are
-            // comparing the same field.
-            if (lhs->getChild(0)->path() != rhs->path()) {
-                return false;
-            }
-
             switch (lhs->getChild(0)->matchType()) {
                 case MatchExpression::EQ: {
                     const ComparisonMatchExpression* cme =
@@ -224,6 +228,92 @@ bool _isSubsetOf(const MatchExpression* lhs, const ExistsMatchExpression* rhs) {
     }
 }
 
+/**
+ * Returns true if every value that compares equal to a value of type 'type', as comparisons
+ * bracket values by canonical type, has one of the types in 'typeSet'.
+ */
+bool containsCanonicalType(const MatcherTypeSet& typeSet, BSONType type) {
+    static const BSONType kAllTypes[] = {MinKey, NumberDouble, String, Object, Array, BinData,
+                                         Undefined, jstOID, Bool, Date, jstNULL, RegEx, DBRef,
+                                         Code, Symbol, CodeWScope, NumberInt, bsonTimestamp,
+                                         NumberLong, NumberDecimal, MaxKey};
+
+    const int canonicalType = canonicalizeBSONType(type);
+    for (BSONType other : kAllTypes) {
+        if (canonicalizeBSONType(other) == canonicalType && !typeSet.hasType(other)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns true if the documents matched by 'lhs' are a subset of the documents matched by
+ * 'rhs', i.e. a document matched by 'lhs' must also be matched by 'rhs', and false otherwise.
+ */
+bool _isSubsetOf(const MatchExpression* lhs, const TypeMatchExpression* rhs) {
+    // An expression can only match a subset of the documents matched by another if they are
+    // comparing the same field.
+    if (lhs->path() != rhs->path()) {
+        return false;
+    }
+
+    const MatcherTypeSet& rhsTypes = rhs->typeSet();
+
+    // Returns true if a comparison with 'data' only matches values of the types in 'rhs'. Like
+    // $type, comparisons match arrays by their elements. Comparisons with null also match missing
+    // fields, those with MinKey and MaxKey compare across types, and equality with an array also
+    // matches the array as a whole, so none of those qualify.
+    auto comparisonMatchesOnlyRhsTypes = [&](BSONElement data) {
+        switch (data.type()) {
+            case jstNULL:
+            case Undefined:
+            case MinKey:
+            case MaxKey:
+            case Array:
+            case RegEx:
+                return false;
+            default:
+                return containsCanonicalType(rhsTypes, data.type());
+        }
+    };
+
+    if (ComparisonMatchExpression::isComparisonMatchExpression(lhs)) {
+        return comparisonMatchesOnlyRhsTypes(
+            static_cast<const ComparisonMatchExpression*>(lhs)->getData());
+    }
+
+    switch (lhs->matchType()) {
+        case MatchExpression::MATCH_IN: {
+            const InMatchExpression* ime = static_cast<const InMatchExpression*>(lhs);
+            if (!ime->getRegexes().empty()) {
+                return false;
+            }
+            for (BSONElement elem : ime->getEqualities()) {
+                if (!comparisonMatchesOnlyRhsTypes(elem)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case MatchExpression::TYPE_OPERATOR: {
+            const MatcherTypeSet& lhsTypes =
+                static_cast<const TypeMatchExpression*>(lhs)->typeSet();
+            if (lhsTypes.allNumbers && !containsCanonicalType(rhsTypes, NumberDouble)) {
+                return false;
+            }
+            for (BSONType type : lhsTypes.bsonTypes) {
+                if (!rhsTypes.hasType(type)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
 /**
  * Returns whether the leaf at 'path' is independent of 'fields'.
  */
@@ -405,6 +495,10 @@ bool isSubsetOf(const MatchExpression* lhs, const MatchExpression* rhs) {
         return _isSubsetOf(lhs, static_cast<const ExistsMatchExpression*>(rhs));
     }
 
+    if (rhs->matchType() == MatchExpression::TYPE_OPERATOR) {
+        return _isSubsetOf(lhs, static_cast<const TypeMatchExpression*>(rhs));
+    }
+
     return false;
 }
 
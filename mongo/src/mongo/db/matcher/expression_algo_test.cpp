@@ -548,6 +548,74 @@ TEST(ExpressionAlgoIsSubsetOf, TypeAndExists) {
     ASSERT_FALSE(expression::isSubsetOf(bType2.get(), aExists.get()));
 }
 
+TEST(ExpressionAlgoIsSubsetOf, Compare_Type) {
+    ParsedMatchExpression aTypeNumber("{a: {$type: 'number'}}");
+    ParsedMatchExpression aTypeDouble("{a: {$type: 1}}");
+    ParsedMatchExpression aTypeString("{a: {$type: 2}}");
+    ParsedMatchExpression aTypeStringOrSymbol("{a: {$type: ['string', 'symbol']}}");
+    ParsedMatchExpression aTypeInt("{a: {$type: 16}}");
+
+    ParsedMatchExpression aEq5("{a: 5}");
+    ParsedMatchExpression aGt5("{a: {$gt: 5}}");
+    ParsedMatchExpression aEqString("{a: 'x'}");
+    ParsedMatchExpression bEq5("{b: 5}");
+
+    ASSERT_TRUE(expression::isSubsetOf(aEq5.get(), aTypeNumber.get()));
+    ASSERT_TRUE(expression::isSubsetOf(aGt5.get(), aTypeNumber.get()));
+    ASSERT_TRUE(expression::isSubsetOf(aEqString.get(), aTypeStringOrSymbol.get()));
+    ASSERT_FALSE(expression::isSubsetOf(bEq5.get(), aTypeNumber.get()));
+
+    // Comparisons match every type in the canonical type of their operand, so a single numeric
+    // type, or string without symbol, is not enough.
+    ASSERT_FALSE(expression::isSubsetOf(aEqString.get(), aTypeString.get()));
+    ASSERT_FALSE(expression::isSubsetOf(aEq5.get(), aTypeDouble.get()));
+    ASSERT_FALSE(expression::isSubsetOf(aEq5.get(), aTypeInt.get()));
+    ASSERT_FALSE(expression::isSubsetOf(aEqString.get(), aTypeNumber.get()));
+
+    ASSERT_FALSE(expression::isSubsetOf(aTypeNumber.get(), aEq5.get()));
+}
+
+TEST(ExpressionAlgoIsSubsetOf, CompareNullOrArray_Type) {
+    ParsedMatchExpression aTypeNull("{a: {$type: 'null'}}");
+    ParsedMatchExpression aTypeArray("{a: {$type: 'array'}}");
+    ParsedMatchExpression aEqNull("{a: null}");
+    ParsedMatchExpression aEqArray("{a: [1, 2]}");
+
+    // Equality with null also matches missing fields, and equality with an array also matches
+    // arrays containing it.
+    ASSERT_FALSE(expression::isSubsetOf(aEqNull.get(), aTypeNull.get()));
+    ASSERT_FALSE(expression::isSubsetOf(aEqArray.get(), aTypeArray.get()));
+}
+
+TEST(ExpressionAlgoIsSubsetOf, In_Type) {
+    ParsedMatchExpression aTypeNumber("{a: {$type: 'number'}}");
+    ParsedMatchExpression aInNumbers("{a: {$in: [1, 2.5, 3]}}");
+    ParsedMatchExpression aInMixed("{a: {$in: [1, 'x']}}");
+    ParsedMatchExpression aInWithNull("{a: {$in: [1, null]}}");
+    ParsedMatchExpression aInWithRegex("{a: {$in: [1, /x/]}}");
+
+    ASSERT_TRUE(expression::isSubsetOf(aInNumbers.get(), aTypeNumber.get()));
+    ASSERT_FALSE(expression::isSubsetOf(aInMixed.get(), aTypeNumber.get()));
+    ASSERT_FALSE(expression::isSubsetOf(aInWithNull.get(), aTypeNumber.get()));
+    ASSERT_FALSE(expression::isSubsetOf(aInWithRegex.get(), aTypeNumber.get()));
+}
+
+TEST(ExpressionAlgoIsSubsetOf, TypeSet) {
+    ParsedMatchExpression aTypeNumber("{a: {$type: 'number'}}");
+    ParsedMatchExpression aTypeDouble("{a: {$type: 1}}");
+    ParsedMatchExpression aTypeDoubleOrString("{a: {$type: [1, 2]}}");
+    ParsedMatchExpression aTypeNumberOrString("{a: {$type: ['number', 'string']}}");
+
+    ASSERT_TRUE(expression::isSubsetOf(aTypeDouble.get(), aTypeNumber.get()));
+    ASSERT_TRUE(expression::isSubsetOf(aTypeDouble.get(), aTypeDoubleOrString.get()));
+    ASSERT_TRUE(expression::isSubsetOf(aTypeDoubleOrString.get(), aTypeNumberOrString.get()));
+    ASSERT_TRUE(expression::isSubsetOf(aTypeNumber.get(), aTypeNumberOrString.get()));
+
+    ASSERT_FALSE(expression::isSubsetOf(aTypeNumber.get(), aTypeDouble.get()));
+    ASSERT_FALSE(expression::isSubsetOf(aTypeDoubleOrString.get(), aTypeNumber.get()));
+    ASSERT_FALSE(expression::isSubsetOf(aTypeNumberOrString.get(), aTypeDoubleOrString.get()));
+}
+
 TEST(ExpressionAlgoIsSubsetOf, AllAndExists) {
     ParsedMatchExpression aExists("{a: {$exists: true}}");
     ParsedMatchExpression aAll("{a: {$all: ['x', 'y', 'z']}}");
@@ -648,6 +716,23 @@ TEST(ExpressionAlgoIsSubsetOf, Compare_Exists_NE) {
     ASSERT_TRUE(expression::isSubsetOf(aNotEqualNull.get(), aExists.get()));
 }
 
+TEST(ExpressionAlgoIsSubsetOf, NestedPathAndExists) {
+    ParsedMatchExpression aExists("{a: {$exists: true}}");
+    ParsedMatchExpression abExists("{'a.b': {$exists: true}}");
+    ParsedMatchExpression abEq1("{'a.b': 1}");
+    ParsedMatchExpression abNotEqualNull("{'a.b': {$ne: null}}");
+    ParsedMatchExpression abEqNull("{'a.b': null}");
+    ParsedMatchExpression abcEq1("{abc: 1}");
+
+    ASSERT_TRUE(expression::isSubsetOf(abExists.get(), aExists.get()));
+    ASSERT_TRUE(expression::isSubsetOf(abEq1.get(), aExists.get()));
+    ASSERT_TRUE(expression::isSubsetOf(abNotEqualNull.get(), aExists.get()));
+
+    ASSERT_FALSE(expression::isSubsetOf(abEqNull.get(), aExists.get()));
+    ASSERT_FALSE(expression::isSubsetOf(abcEq1.get(), aExists.get()));
+    ASSERT_FALSE(expression::isSubsetOf(aExists.get(), abExists.get()));
+}
+
 TEST(ExpressionAlgoIsSubsetOf, CollationAwareStringComparison) {
     CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
     ParsedMatchExpression lhs("{a: {$gt: 'abc'}}", &collator);
@@ -0,0 +1,98 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/top_level_comparison_matcher.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+const char* const kFilters[] = {
+    "{a: 5}",
+    "{a: {$gt: 1, $lt: 10}, b: {$in: [1, 2, 3, 4, 5]}}",
+    "{$or: [{a: 1}, {'b.c': {$exists: true}}, {d: {$regex: '^abc'}}]}",
+    "{tags: {$elemMatch: {k: 'color', v: {$in: ['red', 'green']}}}}",
+};
+
+const BSONObj kDocument = fromjson(
+    "{a: 5, b: 3, c: {d: 1}, d: 'abcdef', tags: [{k: 'size', v: 'L'}, {k: 'color', v: 'green'}]}");
+
+// state.range(0) selects the filter from kFilters.
+void BM_matchExpressionParse(benchmark::State& state) {
+    const BSONObj filter = fromjson(kFilters[state.range(0)]);
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    while (state.keepRunning()) {
+        auto swExpr = MatchExpressionParser::parse(filter, expCtx);
+        invariant(swExpr.isOK());
+        benchmark::doNotOptimize(swExpr.getValue().get());
+    }
+}
+BENCHMARK(BM_matchExpressionParse)->arg(0)->arg(1)->arg(2)->arg(3);
+
+void BM_matchExpressionMatchesBSON(benchmark::State& state) {
+    const BSONObj filter = fromjson(kFilters[state.range(0)]);
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto swExpr = MatchExpressionParser::parse(filter, expCtx);
+    invariant(swExpr.isOK());
+    const auto expr = std::move(swExpr.getValue());
+
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(expr->matchesBSON(kDocument));
+    }
+}
+BENCHMARK(BM_matchExpressionMatchesBSON)->arg(0)->arg(1)->arg(2)->arg(3);
+
+const char* const kTopLevelComparisonFilters[] = {
+    "{a: 5}", "{a: {$gt: 1, $lt: 10}, b: {$gte: 3}}",
+};
+
+// state.range(0) selects the filter from kTopLevelComparisonFilters.
+void BM_topLevelComparisonMatcherMatches(benchmark::State& state) {
+    const BSONObj filter = fromjson(kTopLevelComparisonFilters[state.range(0)]);
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto swExpr = MatchExpressionParser::parse(filter, expCtx);
+    invariant(swExpr.isOK());
+    const auto expr = std::move(swExpr.getValue());
+    const auto matcher = TopLevelComparisonMatcher::make(expr.get());
+    invariant(matcher);
+
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(matcher->matches(kDocument));
+    }
+}
+BENCHMARK(BM_topLevelComparisonMatcherMatches)->arg(0)->arg(1);
+
+}  // namespace
+}  // namespace mongo
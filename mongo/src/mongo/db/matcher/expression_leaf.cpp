@@ -47,6 +47,8 @@
 
 namespace mongo {
 
+constexpr size_t InMatchExpression::kMinEqualitiesForHashedLookup;
+
 bool ComparisonMatchExpression::equivalent(const MatchExpression* other) const {
     if (other->matchType() != matchType())
         return false;
@@ -407,6 +409,7 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
     next->_hasEmptyArray = _hasEmptyArray;
     next->_equalitySet = _equalitySet;
     next->_originalEqualityVector = _originalEqualityVector;
+    next->updateEqualityHashSet();
     for (auto&& regex : _regexes) {
         std::unique_ptr<RegexMatchExpression> clonedRegex(
             static_cast<RegexMatchExpression*>(regex->shallowClone().release()));
@@ -419,7 +422,11 @@ bool InMatchExpression::matchesSingleElement(const BSONElement& e, MatchDetails*
     if (_hasNull && e.eoo()) {
         return true;
     }
-    if (_equalitySet.find(e) != _equalitySet.end()) {
+    if (!_equalityHashSet.empty()) {
+        if (_equalityHashSet.find(e) != _equalityHashSet.end()) {
+            return true;
+        }
+    } else if (_equalitySet.find(e) != _equalitySet.end()) {
         return true;
     }
     for (auto&& regex : _regexes) {
@@ -511,6 +518,16 @@ void InMatchExpression::_doSetCollator(const CollatorInterface* collator) {
 
     // We need to re-compute '_equalitySet', since our set comparator has changed.
     _equalitySet = _eltCmp.makeBSONEltFlatSet(_originalEqualityVector);
+    updateEqualityHashSet();
+}
+
+void InMatchExpression::updateEqualityHashSet() {
+    _equalityHashSet = _eltCmp.makeBSONEltUnorderedSet();
+    if (_equalitySet.size() < kMinEqualitiesForHashedLookup) {
+        return;
+    }
+    _equalityHashSet.reserve(_equalitySet.size());
+    _equalityHashSet.insert(_equalitySet.begin(), _equalitySet.end());
 }
 
 Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
@@ -531,6 +548,7 @@ Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
     _originalEqualityVector = std::move(equalities);
 
     _equalitySet = _eltCmp.makeBSONEltFlatSet(_originalEqualityVector);
+    updateEqualityHashSet();
 
     return Status::OK();
 }
@@ -350,7 +350,14 @@ public:
     InMatchExpression()
         : LeafMatchExpression(MATCH_IN),
           _eltCmp(BSONElementComparator::FieldNamesMode::kIgnore, _collator),
-          _equalitySet(_eltCmp.makeBSONEltFlatSet(_originalEqualityVector)) {}
+          _equalitySet(_eltCmp.makeBSONEltFlatSet(_originalEqualityVector)),
+          _equalityHashSet(_eltCmp.makeBSONEltUnorderedSet()) {}
+
+    /**
+     * $in lists with at least this many distinct equalities are additionally indexed by a hash
+     * set, so that matching a value does not require a binary search over the sorted equalities.
+     */
+    static constexpr size_t kMinEqualitiesForHashedLookup = 64;
 
     Status init(StringData path);
 
@@ -396,6 +403,12 @@ public:
 private:
     ExpressionOptimizerFunc getOptimizer() const final;
 
+    /**
+     * Rebuilds '_equalityHashSet' from '_equalitySet'. The hash set is left empty when there are
+     * fewer than 'kMinEqualitiesForHashedLookup' equalities.
+     */
+    void updateEqualityHashSet();
+
     // Whether or not '_equalities' has a jstNULL element in it.
     bool _hasNull = false;
 
@@ -416,6 +429,10 @@ private:
     // for this set.
     BSONEltFlatSet _equalitySet;
 
+    // Hashed copy of '_equalitySet' used for lookups when the $in list is large. Hashing and
+    // equality are given by '_eltCmp', so the set respects the collation.
+    BSONEltUnorderedSet _equalityHashSet;
+
     // Container of regex elements this object owns.
     std::vector<std::unique_ptr<RegexMatchExpression>> _regexes;
 };
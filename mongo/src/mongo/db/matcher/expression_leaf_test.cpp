@@ -1580,6 +1580,63 @@ TEST(InMatchExpression, ChangingCollationAfterAddingEqualitiesPreservesEqualitie
     ASSERT(in.getEqualities().count(obj2.firstElement()));
 }
 
+TEST(InMatchExpression, LargeInListMatchesNumericallyEquivalentValues) {
+    BSONArrayBuilder operandBuilder;
+    for (int i = 0; i < 1000; ++i) {
+        operandBuilder.append(i * 2);
+    }
+    BSONArray operand = operandBuilder.arr();
+    std::vector<BSONElement> equalities;
+    operand.elems(equalities);
+    InMatchExpression in;
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+    ASSERT_GTE(in.getEqualities().size(), InMatchExpression::kMinEqualitiesForHashedLookup);
+
+    ASSERT(in.matchesBSON(BSON("a" << 998)));
+    ASSERT(in.matchesBSON(BSON("a" << 998LL)));
+    ASSERT(in.matchesBSON(BSON("a" << 998.0)));
+    ASSERT(in.matchesBSON(BSON("a" << Decimal128("998"))));
+    ASSERT(in.matchesBSON(BSON("a" << BSON_ARRAY(1 << 3 << 1998))));
+    ASSERT(!in.matchesBSON(BSON("a" << 999)));
+    ASSERT(!in.matchesBSON(BSON("a" << 2000)));
+    ASSERT(!in.matchesBSON(BSON("a"
+                                << "998")));
+    ASSERT(!in.matchesBSON(BSONObj()));
+}
+
+TEST(InMatchExpression, LargeInListRespectsCollation) {
+    BSONArrayBuilder operandBuilder;
+    for (int i = 0; i < 1000; ++i) {
+        operandBuilder.append("STRING" + std::to_string(i));
+    }
+    BSONArray operand = operandBuilder.arr();
+    std::vector<BSONElement> equalities;
+    operand.elems(equalities);
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    InMatchExpression in;
+    in.setCollator(&collator);
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+
+    ASSERT(in.matchesBSON(BSON("a"
+                               << "string500")));
+    ASSERT(in.matchesBSON(BSON("a"
+                               << "String999")));
+    ASSERT(!in.matchesBSON(BSON("a"
+                                << "string1000")));
+
+    // The shallow clone must build its own hashed lookup.
+    auto clone = in.shallowClone();
+    ASSERT(clone->matchesBSON(BSON("a"
+                                   << "string500")));
+
+    // Resetting the collator must rebuild the hashed lookup with the new comparison semantics.
+    in.setCollator(nullptr);
+    ASSERT(!in.matchesBSON(BSON("a"
+                                << "string500")));
+    ASSERT(in.matchesBSON(BSON("a"
+                               << "STRING500")));
+}
+
 std::vector<uint32_t> bsonArrayToBitPositions(const BSONArray& ba) {
     std::vector<uint32_t> bitPositions;
 
@@ -0,0 +1,130 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/top_level_comparison_matcher.h"
+
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_leaf.h"
+
+namespace mongo {
+
+namespace {
+
+bool isTopLevelComparison(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            break;
+        default:
+            return false;
+    }
+    const StringData path = expr->path();
+    return !path.empty() && path.find('.') == std::string::npos;
+}
+
+}  // namespace
+
+constexpr size_t TopLevelComparisonMatcher::kMaxComparisons;
+
+std::unique_ptr<TopLevelComparisonMatcher> TopLevelComparisonMatcher::make(
+    const MatchExpression* filter) {
+    if (!filter) {
+        return nullptr;
+    }
+
+    std::vector<const ComparisonMatchExpression*> comparisons;
+    if (MatchExpression::AND == filter->matchType()) {
+        if (filter->numChildren() == 0 || filter->numChildren() > kMaxComparisons) {
+            return nullptr;
+        }
+        for (size_t i = 0; i < filter->numChildren(); ++i) {
+            const MatchExpression* child = filter->getChild(i);
+            if (!isTopLevelComparison(child)) {
+                return nullptr;
+            }
+            comparisons.push_back(static_cast<const ComparisonMatchExpression*>(child));
+        }
+    } else if (isTopLevelComparison(filter)) {
+        comparisons.push_back(static_cast<const ComparisonMatchExpression*>(filter));
+    } else {
+        return nullptr;
+    }
+
+    return std::unique_ptr<TopLevelComparisonMatcher>(
+        new TopLevelComparisonMatcher(filter, std::move(comparisons)));
+}
+
+TopLevelComparisonMatcher::TopLevelComparisonMatcher(
+    const MatchExpression* filter, std::vector<const ComparisonMatchExpression*> comparisons)
+    : _filter(filter),
+      _comparisons(std::move(comparisons)),
+      _allComparisonsMask(_comparisons.size() == kMaxComparisons
+                              ? ~std::uint64_t(0)
+                              : (std::uint64_t(1) << _comparisons.size()) - 1) {}
+
+bool TopLevelComparisonMatcher::matches(const BSONObj& doc) const {
+    std::uint64_t seen = 0;
+
+    BSONObjIterator it(doc);
+    while (it.more() && seen != _allComparisonsMask) {
+        const BSONElement elem = it.next();
+        const StringData fieldName = elem.fieldNameStringData();
+
+        for (size_t i = 0; i < _comparisons.size(); ++i) {
+            const std::uint64_t bit = std::uint64_t(1) << i;
+            // Only the first field with a given name is compared, as in the general matcher.
+            if ((seen & bit) || _comparisons[i]->path() != fieldName) {
+                continue;
+            }
+            seen |= bit;
+
+            if (elem.type() == BSONType::Array) {
+                return _filter->matchesBSON(doc);
+            }
+            if (!_comparisons[i]->matchesSingleElement(elem)) {
+                return false;
+            }
+        }
+    }
+
+    // A missing field is compared as an EOO element.
+    for (size_t i = 0; i < _comparisons.size(); ++i) {
+        if (!(seen & (std::uint64_t(1) << i)) &&
+            !_comparisons[i]->matchesSingleElement(BSONElement())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace mongo
@@ -0,0 +1,79 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+class ComparisonMatchExpression;
+class MatchExpression;
+
+/**
+ * Evaluates a filter which is a comparison ($eq, $lt, $lte, $gt or $gte) on a top-level field, or
+ * a conjunction of such comparisons, in a single pass over the fields of a BSON document. Unlike
+ * MatchExpression::matchesBSON(), this does not set up an element iterator per predicate, and it
+ * stops at the first comparison which fails.
+ *
+ * A compared field which holds an array needs the implicit array traversal of the general
+ * matcher, so matches() falls back to the original MatchExpression for such documents.
+ */
+class TopLevelComparisonMatcher {
+    MONGO_DISALLOW_COPYING(TopLevelComparisonMatcher);
+
+public:
+    /**
+     * Returns a matcher for 'filter', or nullptr if 'filter' does not have a supported shape. The
+     * returned matcher refers to 'filter', which must outlive it.
+     */
+    static std::unique_ptr<TopLevelComparisonMatcher> make(const MatchExpression* filter);
+
+    /**
+     * Returns the same result as 'filter->matchesBSON(doc)' for the filter this was made from.
+     */
+    bool matches(const BSONObj& doc) const;
+
+private:
+    TopLevelComparisonMatcher(const MatchExpression* filter,
+                              std::vector<const ComparisonMatchExpression*> comparisons);
+
+    // The predicates are tracked in a bit mask while scanning a document.
+    static constexpr size_t kMaxComparisons = 64;
+
+    const MatchExpression* const _filter;
+    const std::vector<const ComparisonMatchExpression*> _comparisons;
+    const std::uint64_t _allComparisonsMask;
+};
+
+}  // namespace mongo
@@ -0,0 +1,116 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/top_level_comparison_matcher.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<MatchExpression> parse(const char* filter) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto swExpr = MatchExpressionParser::parse(fromjson(filter), expCtx);
+    ASSERT_OK(swExpr.getStatus());
+    return std::move(swExpr.getValue());
+}
+
+/**
+ * Asserts that a matcher can be made for 'filter' and agrees with the MatchExpression for each of
+ * 'docs'.
+ */
+void assertAgreesWithMatchExpression(const char* filter, const std::vector<const char*>& docs) {
+    auto expr = parse(filter);
+    auto matcher = TopLevelComparisonMatcher::make(expr.get());
+    ASSERT(matcher) << filter;
+    for (auto&& doc : docs) {
+        const BSONObj obj = fromjson(doc);
+        ASSERT_EQ(expr->matchesBSON(obj), matcher->matches(obj)) << filter << " on " << doc;
+    }
+}
+
+TEST(TopLevelComparisonMatcher, MakeRejectsUnsupportedFilters) {
+    for (auto&& filter : {"{}",
+                          "{'a.b': 1}",
+                          "{a: {$in: [1, 2]}}",
+                          "{a: {$ne: 1}}",
+                          "{a: 1, b: {$exists: true}}",
+                          "{$or: [{a: 1}, {b: 1}]}",
+                          "{a: {$elemMatch: {$gt: 1}}}"}) {
+        auto expr = parse(filter);
+        ASSERT_FALSE(TopLevelComparisonMatcher::make(expr.get())) << filter;
+    }
+    ASSERT_FALSE(TopLevelComparisonMatcher::make(nullptr));
+}
+
+TEST(TopLevelComparisonMatcher, SingleComparison) {
+    assertAgreesWithMatchExpression(
+        "{a: 5}", {"{a: 5}", "{a: 6}", "{b: 5}", "{a: 5.0}", "{a: '5'}", "{a: [1, 5]}", "{}"});
+    assertAgreesWithMatchExpression("{a: {$lt: 5}}",
+                                    {"{a: 4}", "{a: 5}", "{a: 'x'}", "{a: [6, 4]}", "{a: [6]}"});
+}
+
+TEST(TopLevelComparisonMatcher, ConjunctionOfComparisons) {
+    assertAgreesWithMatchExpression("{a: {$gt: 1, $lte: 10}, b: 'x', c: {$gte: 0}}",
+                                    {"{a: 5, b: 'x', c: 0}",
+                                     "{c: 3, b: 'x', a: 10}",
+                                     "{a: 11, b: 'x', c: 0}",
+                                     "{a: 5, b: 'y', c: 0}",
+                                     "{a: 5, b: 'x'}",
+                                     "{a: 5, b: ['y', 'x'], c: 1}",
+                                     "{a: 5, b: 'x', c: -1, d: 1}"});
+}
+
+TEST(TopLevelComparisonMatcher, MissingAndNullFields) {
+    assertAgreesWithMatchExpression("{a: null}", {"{}", "{a: null}", "{a: 1}", "{a: undefined}"});
+    assertAgreesWithMatchExpression("{a: {$gte: null}}", {"{}", "{a: null}", "{a: 1}"});
+    assertAgreesWithMatchExpression("{a: {$lt: null}}", {"{}", "{a: null}", "{a: 1}"});
+}
+
+TEST(TopLevelComparisonMatcher, OnlyFirstOfDuplicateFieldsIsCompared) {
+    auto expr = parse("{a: 1}");
+    auto matcher = TopLevelComparisonMatcher::make(expr.get());
+    ASSERT(matcher);
+    ASSERT_TRUE(matcher->matches(BSON("a" << 1 << "a" << 2)));
+    ASSERT_FALSE(matcher->matches(BSON("a" << 2 << "a" << 1)));
+    ASSERT_EQ(expr->matchesBSON(BSON("a" << 2 << "a" << 1)),
+              matcher->matches(BSON("a" << 2 << "a" << 1)));
+}
+
+TEST(TopLevelComparisonMatcher, NaNAndMinMaxKey) {
+    assertAgreesWithMatchExpression("{a: {$gte: NaN}}", {"{a: NaN}", "{a: 1}", "{}"});
+    assertAgreesWithMatchExpression("{a: {$gt: {$minKey: 1}}}", {"{a: 1}", "{a: 'x'}", "{}"});
+}
+
+}  // namespace
+}  // namespace mongo
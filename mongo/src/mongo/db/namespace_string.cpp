@@ -82,6 +82,7 @@ constexpr StringData NamespaceString::kAdminDb;
 constexpr StringData NamespaceString::kLocalDb;
 constexpr StringData NamespaceString::kConfigDb;
 constexpr StringData NamespaceString::kSystemDotViewsCollectionName;
+constexpr StringData NamespaceString::kSystemDotMaterializedPrefix;
 constexpr StringData NamespaceString::kShardConfigCollectionsCollectionName;
 constexpr StringData NamespaceString::kSystemKeysCollectionName;
 
@@ -130,6 +131,11 @@ bool NamespaceString::isLegalClientSystemNS() const {
     if (coll() == kSystemDotViewsCollectionName)
         return true;
 
+    // Materialized views are maintained on the primary only, so their backing collections must be
+    // cloned like any other data.
+    if (isSystemDotMaterialized())
+        return true;
+
     return false;
 }
 
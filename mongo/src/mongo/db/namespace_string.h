@@ -63,6 +63,9 @@ public:
     // Name for the system views collection
     static constexpr StringData kSystemDotViewsCollectionName = "system.views"_sd;
 
+    // Prefix of the names of the collections holding the results of materialized views
+    static constexpr StringData kSystemDotMaterializedPrefix = "system.materialized."_sd;
+
     // Name for a shard's collections metadata collection, each document of which indicates the
     // state of a specific collection.
     static constexpr StringData kShardConfigCollectionsCollectionName = "config.cache.collections"_sd;
@@ -196,6 +199,10 @@ public:
     bool isSystemDotViews() const {
         return coll() == kSystemDotViewsCollectionName;
     }
+    bool isSystemDotMaterialized() const {
+        return coll().size() > kSystemDotMaterializedPrefix.size() &&
+            coll().startsWith(kSystemDotMaterializedPrefix);
+    }
     bool isAdminDotSystemDotVersion() const {
         return ((db() == "admin") && (coll() == "system.version"));
     }
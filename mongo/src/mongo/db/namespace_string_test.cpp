@@ -174,6 +174,15 @@ TEST(NamespaceStringTest, ListIndexesCursorNS) {
     ASSERT(!NamespaceString("test.$cmd.listCollections.foo").isListIndexesCursorNS());
 }
 
+TEST(NamespaceStringTest, MaterializedViewBackingCollectionsAreLegalClientSystemNamespaces) {
+    ASSERT(NamespaceString("test.system.materialized.totals").isSystemDotMaterialized());
+    ASSERT(NamespaceString("test.system.materialized.totals").isLegalClientSystemNS());
+    ASSERT(!NamespaceString("test.system.materialized.").isSystemDotMaterialized());
+    ASSERT(!NamespaceString("test.system.materialized").isSystemDotMaterialized());
+    ASSERT(!NamespaceString("test.materialized.totals").isSystemDotMaterialized());
+    ASSERT(!NamespaceString("test.system.profile").isLegalClientSystemNS());
+}
+
 TEST(NamespaceStringTest, IsGloballyManagedNamespace) {
     ASSERT_TRUE(NamespaceString{"test.$cmd.aggregate.foo"}.isGloballyManagedNamespace());
     ASSERT_TRUE(NamespaceString{"test.$cmd.listIndexes.foo"}.isGloballyManagedNamespace());
@@ -103,9 +103,14 @@ public:
                            std::vector<InsertStatement>::const_iterator end,
                            bool fromMigrate) = 0;
     virtual void onUpdate(OperationContext* opCtx, const OplogUpdateEntryArgs& args) = 0;
+    /**
+     * Called before 'doc' is deleted from 'nss'. "fromMigrate" has the same meaning as for
+     * onDelete.
+     */
     virtual CollectionShardingState::DeleteState aboutToDelete(OperationContext* opCtx,
                                                                const NamespaceString& nss,
-                                                               const BSONObj& doc) = 0;
+                                                               const BSONObj& doc,
+                                                               bool fromMigrate) = 0;
     /**
      * Handles logging before document is deleted.
      *
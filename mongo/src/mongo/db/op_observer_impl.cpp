@@ -49,6 +49,7 @@
 #include "mongo/db/server_options.h"
 #include "mongo/db/session_catalog.h"
 #include "mongo/db/views/durable_view_catalog.h"
+#include "mongo/db/views/materialized_view.h"
 #include "mongo/scripting/engine.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/fail_point_service.h"
@@ -334,6 +335,10 @@ void OpObserverImpl::onInserts(OperationContext* opCtx,
         }
     }
 
+    if (!fromMigrate) {
+        MaterializedView::onInserts(opCtx, nss, begin, end);
+    }
+
     const auto lastOpTime = opTimeList.empty() ? repl::OpTime() : opTimeList.back();
     if (nss.coll() == "system.js") {
         Scope::storedFuncMod(opCtx);
@@ -395,6 +400,10 @@ void OpObserverImpl::onUpdate(OperationContext* opCtx, const OplogUpdateEntryArg
         }
     }
 
+    if (!args.fromMigrate && args.preImageDoc) {
+        MaterializedView::onUpdate(opCtx, args.nss, *args.preImageDoc, args.updatedDoc);
+    }
+
     if (args.nss.coll() == "system.js") {
         Scope::storedFuncMod(opCtx);
     } else if (args.nss.coll() == DurableViewCatalog::viewsCollectionName()) {
@@ -416,7 +425,14 @@ void OpObserverImpl::onUpdate(OperationContext* opCtx, const OplogUpdateEntryArg
 
 auto OpObserverImpl::aboutToDelete(OperationContext* opCtx,
                                    NamespaceString const& nss,
-                                   BSONObj const& doc) -> CollectionShardingState::DeleteState {
+                                   BSONObj const& doc,
+                                   bool fromMigrate) -> CollectionShardingState::DeleteState {
+    // Chunk migrations move documents between shards without changing the collection, and their
+    // inserts on the recipient are not applied to views either
+    if (!fromMigrate) {
+        MaterializedView::aboutToDelete(opCtx, nss, doc);
+    }
+
     auto* css = CollectionShardingState::get(opCtx, nss.ns());
     return css->makeDeleteState(doc);
 }
@@ -654,6 +670,7 @@ repl::OpTime OpObserverImpl::onDropCollection(OperationContext* opCtx,
     } else if (collectionName == NamespaceString::kSessionTransactionsTableNamespace) {
         SessionCatalog::get(opCtx)->invalidateSessions(opCtx, boost::none);
     }
+    MaterializedView::onDropCollection(opCtx, collectionName);
 
     AuthorizationManager::get(opCtx->getServiceContext())
         ->logOp(opCtx, "c", cmdNss, cmdObj, nullptr);
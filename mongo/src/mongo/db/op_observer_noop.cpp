@@ -51,7 +51,8 @@ void OpObserverNoop::onUpdate(OperationContext*, const OplogUpdateEntryArgs&) {}
 
 CollectionShardingState::DeleteState OpObserverNoop::aboutToDelete(OperationContext*,
                                                                    const NamespaceString&,
-                                                                   const BSONObj&) {
+                                                                   const BSONObj&,
+                                                                   bool) {
     return {};
 }
 
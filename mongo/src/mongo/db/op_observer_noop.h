@@ -53,7 +53,8 @@ public:
     void onUpdate(OperationContext* opCtx, const OplogUpdateEntryArgs& args) override;
     CollectionShardingState::DeleteState aboutToDelete(OperationContext* opCtx,
                                                        const NamespaceString& nss,
-                                                       const BSONObj& doc) override;
+                                                       const BSONObj& doc,
+                                                       bool fromMigrate) override;
     void onDelete(OperationContext* opCtx,
                   const NamespaceString& nss,
                   OptionalCollectionUUID uuid,
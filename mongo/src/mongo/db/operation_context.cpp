@@ -85,7 +85,7 @@ OperationContext::OperationContext(Client* client, unsigned int opId)
 void OperationContext::setDeadlineAndMaxTime(Date_t when, Microseconds maxTime) {
     invariant(!getClient()->isInDirectClient());
     uassert(40120, "Illegal attempt to change operation deadline", !hasDeadline());
-    _deadline = when;
+    _deadline.store(when.toMillisSinceEpoch());
     _maxTime = maxTime;
 }
 
@@ -104,12 +104,12 @@ Microseconds OperationContext::computeMaxTimeFromDeadline(Date_t when) {
 
 OperationContext::DeadlineStash::DeadlineStash(OperationContext* opCtx)
     : _opCtx(opCtx), _originalDeadline(_opCtx->getDeadline()) {
-    _opCtx->_deadline = Date_t::max();
+    _opCtx->_deadline.store(Date_t::max().toMillisSinceEpoch());
     _opCtx->_maxTime = _opCtx->computeMaxTimeFromDeadline(Date_t::max());
 }
 
 OperationContext::DeadlineStash::~DeadlineStash() {
-    _opCtx->_deadline = _originalDeadline;
+    _opCtx->_deadline.store(_originalDeadline.toMillisSinceEpoch());
     _opCtx->_maxTime = _opCtx->computeMaxTimeFromDeadline(_originalDeadline);
 }
 
@@ -145,6 +145,12 @@ bool OperationContext::hasDeadlineExpired() const {
         return true;
     }
 
+    // The deadline monitor marks this operation killed once its deadline passes, and the kill
+    // status is checked separately.
+    if (_deadlineMonitored) {
+        return false;
+    }
+
     // TODO: Remove once all OperationContexts are properly connected to Clients and ServiceContexts
     // in tests.
     if (MONGO_unlikely(!getClient() || !getServiceContext())) {
@@ -233,6 +239,9 @@ Status OperationContext::checkForInterruptNoAssert() {
     //ErrorCodes::ExceededTimeLimitʶkillʱ
     //markKilledֵ
     const auto killStatus = getKillStatus();
+    if (killStatus == ErrorCodes::ExceededTimeLimit) {
+        return Status(killStatus, "operation exceeded time limit");
+    }
     if (killStatus != ErrorCodes::OK) {
         return Status(killStatus, "operation was interrupted");
     }
@@ -391,6 +400,14 @@ void OperationContext::markKilled(ErrorCodes::Error killCode) {
     }
 }
 
+void OperationContext::markKilledIfPastDeadline(Date_t now) {
+    if (!_deadlineMonitored || !hasDeadline() || now < getDeadline() || isKillPending() ||
+        MONGO_FAIL_POINT(maxTimeNeverTimeOut)) {
+        return;
+    }
+    markKilled(ErrorCodes::ExceededTimeLimit);
+}
+
 //initializeOperationSessionInfo
 void OperationContext::setLogicalSessionId(LogicalSessionId lsid) {
     invariant(!_lsid);
@@ -435,7 +435,7 @@ public:
      * Returns the deadline for this operation, or Date_t::max() if there is no deadline.
      */
     Date_t getDeadline() const {
-        return _deadline;
+        return Date_t::fromMillisSinceEpoch(_deadline.loadRelaxed());
     }
 
     /**
@@ -460,6 +460,12 @@ private:
      */
     bool hasDeadlineExpired() const;
 
+    /**
+     * Called by the ServiceContext's deadline monitor, with the Client locked, to kill this
+     * operation with ExceededTimeLimit if it is monitored and its deadline is before 'now'.
+     */
+    void markKilledIfPastDeadline(Date_t now);
+
     /**
      * Sets the deadline and maxTime as described. It is up to the caller to ensure that
      * these correctly correspond.
@@ -485,6 +491,7 @@ private:
     }
 
     friend class DeadlineStash;
+    friend class ServiceContext;
     friend class WriteUnitOfWork;
     friend class repl::UnreplicatedWritesBlock;
     Client* const _client;
@@ -530,8 +537,14 @@ private:
 
     WriteConcernOptions _writeConcern;
 
-    Date_t _deadline =
-        Date_t::max();  // The timepoint at which this operation exceeds its time limit.
+    // The timepoint at which this operation exceeds its time limit, in milliseconds since the
+    // epoch. Atomic since the deadline monitor reads it from another thread.
+    AtomicWord<long long> _deadline{Date_t::max().toMillisSinceEpoch()};
+
+    // Set when the operation is created if the ServiceContext's deadline monitor is running. The
+    // monitor then kills the operation once its deadline passes, so checkForInterrupt() need not
+    // read the clock.
+    bool _deadlineMonitored = false;
 
     // Max operation time requested by the user or by the cursor in the case of a getMore with no
     // user-specified maxTime. This is tracked with microsecond granularity for the purpose of
@@ -214,6 +214,53 @@ TEST_F(OperationDeadlineTests, OperationDeadlineExpiration) {
     ASSERT_EQ(ErrorCodes::ExceededTimeLimit, opCtx->checkForInterruptNoAssert());
 }
 
+// Keeps the jobs scheduled on it so that a test can decide when they run.
+class ManualPeriodicRunner : public PeriodicRunner {
+public:
+    void scheduleJob(PeriodicJob job) override {
+        _jobs.push_back(std::move(job));
+    }
+
+    Status startup() override {
+        return Status::OK();
+    }
+
+    void shutdown() override {}
+
+    void runJobs(Client* client) {
+        for (auto&& job : _jobs) {
+            job.job(client);
+        }
+    }
+
+private:
+    std::vector<PeriodicJob> _jobs;
+};
+
+TEST_F(OperationDeadlineTests, DeadlineMonitorKillsOperationsPastTheirDeadline) {
+    auto runner = stdx::make_unique<ManualPeriodicRunner>();
+    auto runnerPtr = runner.get();
+    service->setPeriodicRunner(std::move(runner));
+    service->startOperationDeadlineMonitor(Milliseconds{10});
+    auto otherClient = service->makeClient("OperationDeadlineTestNoDeadline");
+
+    auto opCtx = client->makeOperationContext();
+    auto opCtxWithoutDeadline = otherClient->makeOperationContext();
+    opCtx->setDeadlineAfterNowBy(Seconds{1});
+
+    mockClock->advance(Milliseconds{500});
+    runnerPtr->runJobs(client.get());
+    ASSERT_OK(opCtx->checkForInterruptNoAssert());
+
+    // Interrupt checks leave reading the clock to the monitor, so the expired deadline is only
+    // noticed once the monitor has run.
+    mockClock->advance(Seconds{1});
+    ASSERT_OK(opCtx->checkForInterruptNoAssert());
+    runnerPtr->runJobs(client.get());
+    ASSERT_EQ(ErrorCodes::ExceededTimeLimit, opCtx->checkForInterruptNoAssert());
+    ASSERT_OK(opCtxWithoutDeadline->checkForInterruptNoAssert());
+}
+
 template <typename D>
 void assertLargeRelativeDeadlineLikeInfinity(Client& client, D maxTime) {
     auto opCtx = client.makeOperationContext();
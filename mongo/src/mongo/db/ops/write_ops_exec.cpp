@@ -552,7 +552,9 @@ WriteResult performInserts(OperationContext* opCtx, const write_ops::Insert& who
 			//yang test performInserts... doc:{ _id: ObjectId('5badf00412ee982ae019e0c1'), name: "yangyazhou1", age: 22.0 }
 			//log() << "yang test performInserts... doc:" << redact(toInsert);
 			//ĵ뵽batch
-            batch.emplace_back(stmtId, toInsert);
+            // 'toInsert' either shares ownership of the request's message buffer or owns the
+            // fixed-up copy; move it so the batch does not take another reference.
+            batch.emplace_back(stmtId, std::move(toInsert));
             bytesInBatch += batch.back().doc.objsize();
 			//continueΪ˰ĵɵһbatchУһһԲ
 
@@ -699,7 +701,7 @@ static SingleWriteResult performSingleUpdateOp(OperationContext* opCtx,
     PlanSummaryStats summary;
     Explain::getSummaryStats(*exec, &summary);
     if (collection->getCollection()) {
-        collection->getCollection()->infoCache()->notifyOfQuery(opCtx, summary.indexesUsed);
+        collection->getCollection()->infoCache()->notifyOfQuery(opCtx, summary);
     }
 
     if (curOp.shouldDBProfile()) {
@@ -870,7 +872,7 @@ static SingleWriteResult performSingleDeleteOp(OperationContext* opCtx,
     PlanSummaryStats summary;
     Explain::getSummaryStats(*exec, &summary);
     if (collection.getCollection()) {
-        collection.getCollection()->infoCache()->notifyOfQuery(opCtx, summary.indexesUsed);
+        collection.getCollection()->infoCache()->notifyOfQuery(opCtx, summary);
     }
     curOp.debug().setPlanSummaryMetrics(summary);
 
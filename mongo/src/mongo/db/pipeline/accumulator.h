@@ -38,6 +38,8 @@
 #include "mongo/bson/bsontypes.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/hyper_log_log.h"
+#include "mongo/db/pipeline/t_digest.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
 #include "mongo/stdx/functional.h"
@@ -126,6 +128,37 @@ private:
 };
 
 
+/**
+ * Estimates the number of distinct values it processes with a HyperLogLog sketch, which takes at
+ * most a few kilobytes instead of holding every distinct value as $addToSet does. As in $addToSet,
+ * values that compare equal are counted once and missing values are ignored. Small numbers of
+ * distinct values are counted exactly.
+ */
+class AccumulatorApproxCountDistinct final : public Accumulator {
+public:
+    explicit AccumulatorApproxCountDistinct(const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) final;
+    const char* getOpName() const final;
+    void reset() final;
+
+    static boost::intrusive_ptr<Accumulator> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    bool isAssociative() const final {
+        return true;
+    }
+
+    bool isCommutative() const final {
+        return true;
+    }
+
+private:
+    HyperLogLog _sketch;
+};
+
+
 class AccumulatorFirst final : public Accumulator {
 public:
     explicit AccumulatorFirst(const boost::intrusive_ptr<ExpressionContext>& expCtx);
@@ -307,6 +340,61 @@ public:
         const boost::intrusive_ptr<ExpressionContext>& expCtx);
 };
 
+/**
+ * Estimates percentiles of the numeric values it processes with a t-digest, in memory independent
+ * of the number of values. Shards send their digests to be merged, so the estimates are the same
+ * whether or not the input is split across shards.
+ */
+class AccumulatorPercentile : public Accumulator {
+public:
+    AccumulatorPercentile(const boost::intrusive_ptr<ExpressionContext>& expCtx, bool isMedian);
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) final;
+    const char* getOpName() const final;
+    void reset() final;
+
+private:
+    /**
+     * Validates and records the requested percentiles, given as a number or an array of numbers
+     * in [0, 1].
+     */
+    void _setPercentiles(const Value& percentiles);
+
+    void _updateMemUsage();
+
+    const bool _isMedian;
+    TDigest _digest;
+
+    // The percentiles as specified, which determines the shape of the result. Missing until the
+    // first input of a $percentileApprox has been processed.
+    Value _percentilesSpec;
+    std::vector<double> _percentiles;
+};
+
+/**
+ * {$percentileApprox: {input: <expression>, p: <number or array of numbers>}} estimates the given
+ * percentile, or an array of them if 'p' is an array.
+ */
+class AccumulatorPercentileApprox final : public AccumulatorPercentile {
+public:
+    explicit AccumulatorPercentileApprox(const boost::intrusive_ptr<ExpressionContext>& expCtx)
+        : AccumulatorPercentile(expCtx, false) {}
+    static boost::intrusive_ptr<Accumulator> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx);
+};
+
+/**
+ * {$medianApprox: <expression>} estimates the median.
+ */
+class AccumulatorMedianApprox final : public AccumulatorPercentile {
+public:
+    explicit AccumulatorMedianApprox(const boost::intrusive_ptr<ExpressionContext>& expCtx)
+        : AccumulatorPercentile(expCtx, true) {}
+    static boost::intrusive_ptr<Accumulator> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx);
+};
+
 class AccumulatorMergeObjects : public Accumulator {
 public:
     AccumulatorMergeObjects(const boost::intrusive_ptr<ExpressionContext>& expCtx);
@@ -0,0 +1,118 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/accumulator.h"
+
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+REGISTER_ACCUMULATOR(approxCountDistinct, AccumulatorApproxCountDistinct::create);
+
+namespace {
+/**
+ * Value hashes are only meant for hash tables, so their bits are mixed with the MurmurHash3
+ * finalizer before the sketch relies on them being uniformly distributed.
+ */
+uint64_t mixHash(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+bool isExactlyRepresentableAsDouble(long long value) {
+    uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : value;
+    if (magnitude == 0) {
+        return true;
+    }
+    magnitude >>= countTrailingZeros64(magnitude);
+    return magnitude < (1ULL << 53);
+}
+
+/**
+ * Values that are equal under the collation hash identically, so they are counted once. Value
+ * hashes treat every number as a double, so NumberLongs that differ only in their low-order bits,
+ * such as large ids, would collide. No double or int is equal to a NumberLong that has no exact
+ * double representation, so such longs are hashed by their own bits instead.
+ */
+uint64_t hashForCounting(const ValueComparator& comparator, const Value& input) {
+    if (input.getType() == NumberLong && !isExactlyRepresentableAsDouble(input.getLong())) {
+        return mixHash(static_cast<uint64_t>(input.getLong()));
+    }
+    return mixHash(comparator.hash(input));
+}
+}  // namespace
+
+const char* AccumulatorApproxCountDistinct::getOpName() const {
+    return "$approxCountDistinct";
+}
+
+void AccumulatorApproxCountDistinct::processInternal(const Value& input, bool merging) {
+    if (merging) {
+        // 'input' is what getValue(true) produced below.
+        _sketch.merge(HyperLogLog::parse(input));
+    } else if (!input.missing()) {
+        _sketch.add(hashForCounting(getExpressionContext()->getValueComparator(), input));
+    }
+    _memUsageBytes = sizeof(*this) - sizeof(HyperLogLog) + _sketch.memUsageBytes();
+}
+
+Value AccumulatorApproxCountDistinct::getValue(bool toBeMerged) {
+    if (toBeMerged) {
+        return _sketch.serialize();
+    }
+    return Value(_sketch.estimate());
+}
+
+AccumulatorApproxCountDistinct::AccumulatorApproxCountDistinct(
+    const intrusive_ptr<ExpressionContext>& expCtx)
+    : Accumulator(expCtx) {
+    _memUsageBytes = sizeof(*this) - sizeof(HyperLogLog) + _sketch.memUsageBytes();
+}
+
+void AccumulatorApproxCountDistinct::reset() {
+    _sketch = HyperLogLog();
+    _memUsageBytes = sizeof(*this) - sizeof(HyperLogLog) + _sketch.memUsageBytes();
+}
+
+intrusive_ptr<Accumulator> AccumulatorApproxCountDistinct::create(
+    const intrusive_ptr<ExpressionContext>& expCtx) {
+    return new AccumulatorApproxCountDistinct(expCtx);
+}
+
+}  // namespace mongo
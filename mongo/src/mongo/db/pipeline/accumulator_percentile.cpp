@@ -0,0 +1,172 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/accumulator.h"
+
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+REGISTER_ACCUMULATOR(percentileApprox, AccumulatorPercentileApprox::create);
+REGISTER_ACCUMULATOR(medianApprox, AccumulatorMedianApprox::create);
+REGISTER_EXPRESSION(medianApprox, ExpressionFromAccumulator<AccumulatorMedianApprox>::parse);
+
+namespace {
+const char kInputField[] = "input";
+const char kPercentilesField[] = "p";
+const char kDigestField[] = "digest";
+}  // namespace
+
+const char* AccumulatorPercentile::getOpName() const {
+    return (_isMedian ? "$medianApprox" : "$percentileApprox");
+}
+
+void AccumulatorPercentile::processInternal(const Value& input, bool merging) {
+    if (merging) {
+        // 'input' is what getValue(true) produced below.
+        verify(input.getType() == Object);
+        Value percentiles = input[kPercentilesField];
+        if (_percentilesSpec.missing() && !percentiles.missing()) {
+            _setPercentiles(percentiles);
+        }
+        _digest.merge(TDigest::parse(input[kDigestField]));
+        _updateMemUsage();
+        return;
+    }
+
+    Value value = input;
+    if (!_isMedian) {
+        uassert(50813,
+                str::stream() << "$percentileApprox expects an object of the form {input: "
+                                 "<expression>, p: <number or array of numbers>}, but found "
+                              << typeName(input.getType()),
+                input.getType() == Object);
+
+        // 'p' is expected to be constant, so it is only validated once.
+        if (_percentilesSpec.missing()) {
+            _setPercentiles(input[kPercentilesField]);
+        }
+        value = input[kInputField];
+    }
+
+    // Non-numeric types have no impact on the percentiles.
+    if (value.numeric()) {
+        _digest.add(value.coerceToDouble());
+        _updateMemUsage();
+    }
+}
+
+void AccumulatorPercentile::_setPercentiles(const Value& percentiles) {
+    auto addPercentile = [this](const Value& percentile) {
+        uassert(50814,
+                str::stream() << "$percentileApprox 'p' must be a number or an array of numbers "
+                                 "between 0 and 1, but found "
+                              << percentile.toString(),
+                percentile.numeric() && percentile.coerceToDouble() >= 0 &&
+                    percentile.coerceToDouble() <= 1);
+        _percentiles.push_back(percentile.coerceToDouble());
+    };
+
+    _percentiles.clear();
+    if (percentiles.getType() == Array) {
+        uassert(50815,
+                "$percentileApprox 'p' must not be an empty array",
+                percentiles.getArrayLength() > 0);
+        for (auto&& percentile : percentiles.getArray()) {
+            addPercentile(percentile);
+        }
+    } else {
+        addPercentile(percentiles);
+    }
+    _percentilesSpec = percentiles;
+}
+
+void AccumulatorPercentile::_updateMemUsage() {
+    _memUsageBytes =
+        sizeof(*this) - sizeof(TDigest) + _digest.memUsageBytes() +
+        _percentiles.capacity() * sizeof(double) + _percentilesSpec.getApproximateSize();
+}
+
+Value AccumulatorPercentile::getValue(bool toBeMerged) {
+    if (toBeMerged) {
+        return Value(Document{{kDigestField, _digest.serialize()},
+                              {kPercentilesField, _percentilesSpec}});
+    }
+
+    if (_digest.empty()) {
+        return Value(BSONNULL);
+    }
+
+    if (_isMedian) {
+        return Value(_digest.quantile(0.5));
+    }
+
+    if (_percentilesSpec.getType() != Array) {
+        return Value(_digest.quantile(_percentiles.front()));
+    }
+
+    std::vector<Value> estimates;
+    estimates.reserve(_percentiles.size());
+    for (double percentile : _percentiles) {
+        estimates.push_back(Value(_digest.quantile(percentile)));
+    }
+    return Value(std::move(estimates));
+}
+
+AccumulatorPercentile::AccumulatorPercentile(const intrusive_ptr<ExpressionContext>& expCtx,
+                                             bool isMedian)
+    : Accumulator(expCtx), _isMedian(isMedian) {
+    _updateMemUsage();
+}
+
+void AccumulatorPercentile::reset() {
+    _digest = TDigest();
+    _percentilesSpec = Value();
+    _percentiles.clear();
+    _updateMemUsage();
+}
+
+intrusive_ptr<Accumulator> AccumulatorPercentileApprox::create(
+    const intrusive_ptr<ExpressionContext>& expCtx) {
+    return new AccumulatorPercentileApprox(expCtx);
+}
+
+intrusive_ptr<Accumulator> AccumulatorMedianApprox::create(
+    const intrusive_ptr<ExpressionContext>& expCtx) {
+    return new AccumulatorMedianApprox(expCtx);
+}
+}
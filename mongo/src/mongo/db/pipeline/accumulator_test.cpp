@@ -344,6 +344,135 @@ TEST(Accumulators, AddToSetRespectsCollation) {
                             Value(std::vector<Value>{Value("a"_sd)})}});
 }
 
+TEST(Accumulators, ApproxCountDistinct) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    assertExpectedResults(
+        "$approxCountDistinct",
+        expCtx,
+        {// No documents evaluated.
+         {{}, Value(0LL)},
+         // Small numbers of distinct values are counted exactly.
+         {{Value(1), Value(2), Value(1), Value(3)}, Value(3LL)},
+         // Numerically equal values of different types are the same value.
+         {{Value(1), Value(1LL), Value(1.0), Value(Decimal128(1))}, Value(1LL)},
+         // Large longs which only differ in their low-order bits are distinct.
+         {{Value((1LL << 60) + 1), Value((1LL << 60) + 2), Value(1LL << 60),
+           Value(static_cast<double>(1LL << 60))},
+          Value(3LL)},
+         // Null is counted, but missing values are ignored.
+         {{Value("a"_sd), Value(BSONNULL), Value(), Value(BSON_ARRAY(1 << 2))}, Value(3LL)}});
+}
+
+TEST(Accumulators, ApproxCountDistinctRespectsCollation) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    expCtx->setCollator(&collator);
+    assertExpectedResults("$approxCountDistinct",
+                          expCtx,
+                          {{{Value("a"_sd), Value("b"_sd), Value("c"_sd)}, Value(1LL)}});
+}
+
+TEST(Accumulators, ApproxCountDistinctEstimatesLargeCardinalitiesAcrossShards) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$approxCountDistinct");
+
+    // Every shard sees half of the values, and each shard's values overlap with the next.
+    auto merger = factory(expCtx);
+    for (int shard = 0; shard < 4; ++shard) {
+        auto accum = factory(expCtx);
+        for (int i = shard * 25000; i < shard * 25000 + 50000; ++i) {
+            accum->process(Value(i % 100000), false);
+        }
+        merger->process(accum->getValue(true), true);
+    }
+
+    Value result = merger->getValue(false);
+    ASSERT_EQ(result.getType(), BSONType::NumberLong);
+    ASSERT_APPROX_EQUAL(result.getLong(), 100000LL, 3000LL);
+    ASSERT_LT(merger->memUsageForSorter(), 32 * 1024);
+}
+
+TEST(Accumulators, MedianApprox) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    assertExpectedResults(
+        "$medianApprox",
+        expCtx,
+        {// No documents evaluated.
+         {{}, Value(BSONNULL)},
+         // A single value is its own median.
+         {{Value(3)}, Value(3.0)},
+         // Small inputs are interpolated between the exact values.
+         {{Value(3), Value(1LL), Value(2.0)}, Value(2.0)},
+         {{Value(4), Value(1), Value(3), Value(2)}, Value(2.5)},
+         // Non-numeric values are ignored.
+         {{Value("a"_sd), Value(5), Value(BSONNULL), Value()}, Value(5.0)}});
+}
+
+static Value percentileInput(Value input, Value p) {
+    return Value(Document{{"input", input}, {"p", p}});
+}
+
+TEST(Accumulators, PercentileApprox) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    const Value median(0.5);
+    const Value extremes(BSON_ARRAY(0 << 1));
+    assertExpectedResults(
+        "$percentileApprox",
+        expCtx,
+        {// No documents evaluated.
+         {{}, Value(BSONNULL)},
+         // No numeric values evaluated.
+         {{percentileInput(Value("a"_sd), median)}, Value(BSONNULL)},
+         // A single percentile is returned as a number.
+         {{percentileInput(Value(1), median),
+           percentileInput(Value(4), median),
+           percentileInput(Value(2), median),
+           percentileInput(Value(3), median)},
+          Value(2.5)},
+         // An array of percentiles is returned as an array.
+         {{percentileInput(Value(5), extremes),
+           percentileInput(Value(1), extremes),
+           percentileInput(Value(3), extremes)},
+          Value(BSON_ARRAY(1.0 << 5.0))}});
+}
+
+TEST(Accumulators, PercentileApproxEstimatesLargeInputsAcrossShards) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$percentileApprox");
+    const Value percentiles(BSON_ARRAY(0.5 << 0.99));
+
+    auto merger = factory(expCtx);
+    for (int shard = 0; shard < 4; ++shard) {
+        auto accum = factory(expCtx);
+        for (int i = shard; i < 100000; i += 4) {
+            accum->process(percentileInput(Value(i), percentiles), false);
+        }
+        merger->process(accum->getValue(true), true);
+    }
+
+    Value result = merger->getValue(false);
+    ASSERT_EQ(result.getType(), BSONType::Array);
+    ASSERT_APPROX_EQUAL(result[0].getDouble(), 50000.0, 500.0);
+    ASSERT_APPROX_EQUAL(result[1].getDouble(), 99000.0, 100.0);
+}
+
+TEST(Accumulators, PercentileApproxRejectsInvalidArguments) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$percentileApprox");
+
+    ASSERT_THROWS_CODE(factory(expCtx)->process(Value(1), false), AssertionException, 50813);
+    ASSERT_THROWS_CODE(factory(expCtx)->process(percentileInput(Value(1), Value(2)), false),
+                       AssertionException,
+                       50814);
+    ASSERT_THROWS_CODE(factory(expCtx)->process(percentileInput(Value(1), Value()), false),
+                       AssertionException,
+                       50814);
+    ASSERT_THROWS_CODE(
+        factory(expCtx)->process(percentileInput(Value(1), Value(BSONArray())), false),
+        AssertionException,
+        50815);
+}
+
 /* ------------------------- AccumulatorMergeObjects -------------------------- */
 
 namespace AccumulatorMergeObjects {
@@ -0,0 +1,149 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/change_stream_post_image_cache.h"
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/clock_source.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+const auto getChangeStreamPostImageCache =
+    ServiceContext::declareDecoration<ChangeStreamPostImageCache>();
+
+boost::optional<Document> toPostImage(const boost::optional<BSONObj>& cached) {
+    return cached ? boost::optional<Document>(Document(*cached)) : boost::none;
+}
+}  // namespace
+
+ChangeStreamPostImageCache* ChangeStreamPostImageCache::get(ServiceContext* serviceContext) {
+    return &getChangeStreamPostImageCache(serviceContext);
+}
+
+bool ChangeStreamPostImageCache::KeyLess::operator()(const Key& lhs, const Key& rhs) const {
+    if (lhs.clusterTime != rhs.clusterTime) {
+        return lhs.clusterTime < rhs.clusterTime;
+    }
+    if (!(lhs.uuid == rhs.uuid)) {
+        return lhs.uuid < rhs.uuid;
+    }
+    return SimpleBSONObjComparator::kInstance.evaluate(lhs.documentKey < rhs.documentKey);
+}
+
+boost::optional<Document> ChangeStreamPostImageCache::lookup(OperationContext* opCtx,
+                                                             const UUID& uuid,
+                                                             Timestamp clusterTime,
+                                                             const Document& documentKey,
+                                                             const LookupFn& lookupFn) {
+    const Milliseconds ttl(internalDocumentSourceLookupChangePostImageCacheTTLMillis.load());
+    if (ttl <= Milliseconds(0)) {
+        return lookupFn();
+    }
+
+    auto clock = opCtx->getServiceContext()->getFastClockSource();
+    const Key key{uuid, clusterTime, documentKey.toBson()};
+    auto entry = std::make_shared<Entry>();
+    {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (true) {
+            _evict_inlock(clock->now());
+
+            auto it = _entries.find(key);
+            if (it == _entries.end()) {
+                _entries.emplace(key, entry);
+                break;
+            }
+
+            auto existing = it->second;
+            if (existing->ready) {
+                return toPostImage(existing->postImage);
+            }
+
+            // Another change stream is already looking up this post-image. Wait for its result
+            // rather than issuing the same query, then re-check: if its lookup failed, the entry is
+            // gone and this operation runs the lookup itself.
+            opCtx->waitForConditionOrInterrupt(
+                _lookupFinished, lk, [&] { return existing->ready || existing->abandoned; });
+        }
+    }
+
+    // Make sure that operations waiting on this entry do not wait forever if the lookup throws.
+    auto abandonGuard = MakeGuard([&] {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        entry->abandoned = true;
+        _entries.erase(key);
+        _lookupFinished.notify_all();
+    });
+
+    auto postImage = lookupFn();
+
+    // Documents decode their fields lazily and so may not be shared between threads; cache the
+    // post-image as BSON and give each reader its own Document.
+    boost::optional<BSONObj> cached;
+    if (postImage) {
+        cached = postImage->toBson();
+    }
+
+    abandonGuard.Dismiss();
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    entry->ready = true;
+    entry->expiresAt = clock->now() + ttl;
+    entry->postImage = cached;
+    _bytesCached += cached ? cached->objsize() : 0;
+    _expiryQueue.emplace_back(key, entry);
+    _evict_inlock(clock->now());
+    _lookupFinished.notify_all();
+    return toPostImage(cached);
+}
+
+size_t ChangeStreamPostImageCache::size() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _expiryQueue.size();
+}
+
+void ChangeStreamPostImageCache::_evict_inlock(Date_t now) {
+    const size_t maxBytes = internalDocumentSourceLookupChangePostImageCacheSizeBytes.load();
+    while (!_expiryQueue.empty()) {
+        auto& oldest = _expiryQueue.front();
+        if (oldest.second->expiresAt > now && _bytesCached <= maxBytes) {
+            break;
+        }
+        _bytesCached -= oldest.second->postImage ? oldest.second->postImage->objsize() : 0;
+        _entries.erase(oldest.first);
+        _expiryQueue.pop_front();
+    }
+}
+
+}  // namespace mongo
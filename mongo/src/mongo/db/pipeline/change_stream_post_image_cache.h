@@ -0,0 +1,128 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <boost/optional/optional.hpp>
+#include <deque>
+#include <map>
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * A short-lived, process-wide cache of the post-images looked up by change streams opened with
+ * {fullDocument: "updateLookup"}. Every change stream on a collection sees the same update events,
+ * so without sharing, N listeners issue N identical lookups per update. Entries are keyed by
+ * (collection UUID, event clusterTime, documentKey): a post-image cached for an event was read
+ * after that event was visible, which is all "updateLookup" promises, so any stream reporting the
+ * same event may reuse it.
+ *
+ * Concurrent lookups of the same key are coalesced: the first caller runs the lookup while the
+ * others wait for its result. Entries expire after a short TTL, and the oldest entries are evicted
+ * once the cached post-images exceed a size limit. See the
+ * internalDocumentSourceLookupChangePostImageCache* knobs; a TTL of zero disables the cache.
+ */
+class ChangeStreamPostImageCache {
+    MONGO_DISALLOW_COPYING(ChangeStreamPostImageCache);
+
+public:
+    using LookupFn = stdx::function<boost::optional<Document>()>;
+
+    static ChangeStreamPostImageCache* get(ServiceContext* serviceContext);
+
+    ChangeStreamPostImageCache() = default;
+
+    /**
+     * Returns the post-image cached for the update to 'documentKey' in the collection 'uuid' at
+     * 'clusterTime', running 'lookupFn' to look it up if no unexpired entry exists. boost::none
+     * means the document no longer exists. If 'lookupFn' throws, nothing is cached and the
+     * exception propagates; any operations waiting on the same key then run their own lookups.
+     */
+    boost::optional<Document> lookup(OperationContext* opCtx,
+                                     const UUID& uuid,
+                                     Timestamp clusterTime,
+                                     const Document& documentKey,
+                                     const LookupFn& lookupFn);
+
+    /**
+     * Returns the number of post-images currently cached, including expired entries which have
+     * not yet been evicted.
+     */
+    size_t size() const;
+
+private:
+    struct Key {
+        UUID uuid;
+        Timestamp clusterTime;
+        BSONObj documentKey;
+    };
+
+    struct KeyLess {
+        bool operator()(const Key& lhs, const Key& rhs) const;
+    };
+
+    struct Entry {
+        // Set once the lookup which created this entry has finished. 'abandoned' means it failed.
+        bool ready = false;
+        bool abandoned = false;
+        Date_t expiresAt;
+        boost::optional<BSONObj> postImage;
+    };
+
+    // Removes entries which expired before 'now', then the oldest entries while the cache is over
+    // its size limit. Must be called with '_mutex' held.
+    void _evict_inlock(Date_t now);
+
+    mutable stdx::mutex _mutex;
+
+    // Signalled whenever an in-progress lookup finishes or is abandoned.
+    stdx::condition_variable _lookupFinished;
+
+    std::map<Key, std::shared_ptr<Entry>, KeyLess> _entries;
+
+    // The ready entries in the order they were cached, which is also the order they expire in.
+    std::deque<std::pair<Key, std::shared_ptr<Entry>>> _expiryQueue;
+
+    size_t _bytesCached = 0;
+};
+
+}  // namespace mongo
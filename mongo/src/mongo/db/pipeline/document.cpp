@@ -48,6 +48,30 @@ const DocumentStorage DocumentStorage::kEmptyDoc;
 const std::vector<StringData> Document::allMetadataFieldNames = {
     Document::metaFieldTextScore, Document::metaFieldRandVal, Document::metaFieldSortKey};
 
+namespace {
+
+/**
+ * Like Value(elem), but embedded objects, including those nested in arrays, become documents
+ * backed by their BSON, which lives in the owned object 'owner'.
+ */
+Value lazyValueFromBson(const BSONElement& elem, const BSONObj& owner) {
+    switch (elem.type()) {
+        case Object:
+            return Value(Document::fromBsonLazily(elem.embeddedObject().shareOwnershipWith(owner)));
+        case Array: {
+            std::vector<Value> values;
+            BSONForEach(sub, elem.embeddedObject()) {
+                values.push_back(lazyValueFromBson(sub, owner));
+            }
+            return Value(std::move(values));
+        }
+        default:
+            return Value(elem);
+    }
+}
+
+}  // namespace
+
 Position DocumentStorage::findField(StringData requested) const {
     int reqSize = requested.size();  // get size calculation out of the way if needed
 
@@ -65,18 +89,37 @@ Position DocumentStorage::findField(StringData requested) const {
             pos = elem.nextCollision;
         }
     } else {  // linear scan
-        for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+        for (DocumentStorageIterator it = iteratorDecoded(); !it.atEnd(); it.advance()) {
             if (it->nameLen == reqSize && memcmp(requested.rawData(), it->_name, reqSize) == 0) {
                 return it.position();
             }
         }
     }
 
+    // Not decoded yet, so keep decoding the backing BSON up to the requested field
+    while (_bsonIt.more()) {
+        const Position pos = loadNextField();
+        const ValueElement& elem = getField(pos);
+        if (elem.nameLen == reqSize && memcmp(requested.rawData(), elem._name, reqSize) == 0) {
+            return pos;
+        }
+    }
+
     // if we got here, there's no such field
     return Position();
 }
 
-Value& DocumentStorage::appendField(StringData name) {
+Position DocumentStorage::loadNextField() const {
+    // Decoding leaves the logical content of the document unchanged, hence is done on const access
+    auto* const self = const_cast<DocumentStorage*>(this);
+
+    const BSONElement elem = _bsonIt.next();
+    const Position pos = getNextPosition();
+    self->appendFieldWithoutLoading(elem.fieldNameStringData()) = lazyValueFromBson(elem, _bson);
+    return pos;
+}
+
+Value& DocumentStorage::appendFieldWithoutLoading(StringData name) {
     Position pos = getNextPosition();
     const int nameSize = name.size();
 
@@ -201,13 +244,16 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
     out->_usedBytes = _usedBytes;
     out->_numFields = _numFields;
     out->_hashTabMask = _hashTabMask;
+    out->_bson = _bson;
+    out->_bsonIt = _bsonIt;
+    out->_modified = _modified;
     out->_metaFields = _metaFields;
     out->_textScore = _textScore;
     out->_randVal = _randVal;
     out->_sortKey = _sortKey.getOwned();
 
     // Tell values that they have been memcpyed (updates ref counts)
-    for (DocumentStorageIterator it = out->iteratorAll(); !it.atEnd(); it.advance()) {
+    for (DocumentStorageIterator it = out->iteratorDecoded(); !it.atEnd(); it.advance()) {
         it->val.memcpyed();
     }
 
@@ -217,7 +263,7 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
 DocumentStorage::~DocumentStorage() {
     std::unique_ptr<char[]> deleteBufferAtScopeEnd(_buffer);
 
-    for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+    for (DocumentStorageIterator it = iteratorDecoded(); !it.atEnd(); it.advance()) {
         it->val.~Value();  // explicit destructor call
     }
 }
@@ -234,6 +280,16 @@ Document::Document(const BSONObj& bson) {
     *this = md.freeze();
 }
 
+Document Document::fromBsonLazily(const BSONObj& bson) {
+    if (bson.isEmpty()) {
+        return Document();
+    }
+
+    intrusive_ptr<DocumentStorage> storage(new DocumentStorage());
+    storage->initFromBson(bson.getOwned());
+    return Document(storage.get());
+}
+
 Document::Document(std::initializer_list<std::pair<StringData, ImplicitValue>> initializerList) {
     MutableDocument mutableDoc(initializerList.size());
 
@@ -258,6 +314,12 @@ void Document::toBson(BSONObjBuilder* builder, size_t recursionLevel) const {
                           << " levels of nesting",
             recursionLevel <= BSONDepth::getMaxAllowableDepth());
 
+    // A document left as it was decoded copies its original BSON rather than re-encode the fields
+    if (storage().hasUnmodifiedBson()) {
+        builder->appendElements(storage().getBson());
+        return;
+    }
+
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
         it->val.addToBsonObj(builder, it->nameSD(), recursionLevel);
     }
@@ -285,6 +347,19 @@ BSONObj Document::toBsonWithMetaData(bool includeSortKey) const {
     return bb.obj();
 }
 
+Document Document::fromBsonWithMetaDataLazily(const BSONObj& bson) {
+    BSONForEach(elem, bson) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName[0] == '$' &&
+            std::find(allMetadataFieldNames.begin(), allMetadataFieldNames.end(), fieldName) !=
+                allMetadataFieldNames.end()) {
+            return fromBsonWithMetaData(bson);
+        }
+    }
+
+    return fromBsonLazily(bson);
+}
+
 Document Document::fromBsonWithMetaData(const BSONObj& bson) {
     MutableDocument md;
 
@@ -383,7 +458,12 @@ size_t Document::getApproximateSize() const {
     size_t size = sizeof(DocumentStorage);
     size += storage().allocatedBytes();
 
-    for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
+    // Fields not decoded yet only take space in the backing BSON
+    if (!storage().getBson().isEmpty()) {
+        size += storage().getBson().objsize();
+    }
+
+    for (DocumentStorageIterator it = storage().iteratorDecoded(); !it.atEnd(); it.advance()) {
         size += it->val.getApproximateSize();
         size -= sizeof(Value);  // already accounted for above
     }
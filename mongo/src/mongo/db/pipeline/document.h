@@ -102,6 +102,16 @@ public:
     /// Create a new Document deep-converted from the given BSONObj.
     explicit Document(const BSONObj& bson);
 
+    /**
+     * Create a new Document backed by an owned copy of the given BSONObj. Fields, and the fields of
+     * embedded objects, are only converted to Values when first looked up or iterated, and an
+     * object whose fields are left unmodified is output by toBson() as a copy of its original BSON.
+     *
+     * Converting fields on const access makes such a Document unsafe to read from several threads
+     * at once.
+     */
+    static Document fromBsonLazily(const BSONObj& bson);
+
     /**
      * Create a new document from key, value pairs. Enables constructing a document using this
      * syntax:
@@ -217,6 +227,12 @@ public:
      */
     static Document fromBsonWithMetaData(const BSONObj& bson);
 
+    /**
+     * Like fromBsonWithMetaData(), but returns a lazily decoded document as fromBsonLazily() does
+     * when 'bson' has no metadata fields.
+     */
+    static Document fromBsonWithMetaDataLazily(const BSONObj& bson);
+
     /**
      * Given a BSON object that may have metadata fields added as part of toBsonWithMetadata(),
      * returns the same object without any of the metadata fields.
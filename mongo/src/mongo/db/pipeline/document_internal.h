@@ -187,6 +187,8 @@ public:
           _usedBytes(0),
           _numFields(0),
           _hashTabMask(0),
+          _bsonIt(BSONObj()),
+          _modified(false),
           _metaFields(),
           _textScore(0),
           _randVal(0) {}
@@ -219,6 +221,7 @@ public:
     }
 
     /// Returns the position of the named field (may be missing) or Position()
+    /// Decodes the fields of the backing BSON, if any, up to the named one.
     Position findField(StringData name) const;
 
     // Document uses these
@@ -236,6 +239,7 @@ public:
     // MutableDocument uses these
     ValueElement& getField(Position pos) {
         verify(pos.found());
+        _modified = true;
         return *(_firstElement->plusBytes(pos.index));
     }
     Value& getField(StringData name) {
@@ -246,7 +250,36 @@ public:
     }
 
     /// Adds a new field with missing Value at the end of the document
-    Value& appendField(StringData name);
+    Value& appendField(StringData name) {
+        loadAll();
+        _modified = true;
+        return appendFieldWithoutLoading(name);
+    }
+
+    /**
+     * Backs this empty storage with 'bson', which must be owned. Its fields are decoded into Values
+     * only as they are looked up or iterated, and for as long as none of them is modified, added or
+     * removed, the whole object is output as is by Document::toBson().
+     *
+     * Since decoding happens on const access, a document backed by BSON must not be read from
+     * several threads at once.
+     */
+    void initFromBson(BSONObj bson) {
+        invariant(!_buffer && _bson.isEmpty());
+        invariant(bson.isOwned());
+        _bson = std::move(bson);
+        _bsonIt = BSONObjIterator(_bson);
+    }
+
+    /// True if this storage is backed by BSON that still holds exactly its fields
+    bool hasUnmodifiedBson() const {
+        return !_modified && !_bson.isEmpty();
+    }
+
+    /// The BSON this storage is backed by, or an empty object if there is none
+    const BSONObj& getBson() const {
+        return _bson;
+    }
 
     /** Preallocates space for fields. Use this to attempt to prevent buffer growth.
      *  This is only valid to call before anything is added to the document.
@@ -255,11 +288,18 @@ public:
 
     /// This skips missing values
     DocumentStorageIterator iterator() const {
+        loadAll();
         return DocumentStorageIterator(_firstElement, end(), false);
     }
 
     /// This includes missing values
     DocumentStorageIterator iteratorAll() const {
+        loadAll();
+        return iteratorDecoded();
+    }
+
+    /// Like iteratorAll(), but only visits the fields decoded from the backing BSON so far
+    DocumentStorageIterator iteratorDecoded() const {
         return DocumentStorageIterator(_firstElement, end(), true);
     }
 
@@ -328,6 +368,19 @@ private:
     /// Allocates space in _buffer. Copies existing data if there is any.
     void alloc(unsigned newSize);
 
+    /// Same as appendField() but leaves the rest of the backing BSON undecoded
+    Value& appendFieldWithoutLoading(StringData name);
+
+    /// Decodes the next field of the backing BSON and returns its position
+    Position loadNextField() const;
+
+    /// Decodes all the remaining fields of the backing BSON
+    void loadAll() const {
+        while (_bsonIt.more()) {
+            loadNextField();
+        }
+    }
+
     /// Call after adding field to _buffer and increasing _numFields
     void addFieldToHashTable(Position pos);
 
@@ -363,7 +416,7 @@ private:
     /// Adds all fields to the hash table
     void rehash() {
         hashTabInit();
-        for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance())
+        for (DocumentStorageIterator it = iteratorDecoded(); !it.atEnd(); it.advance())
             addFieldToHashTable(it.position());
     }
 
@@ -397,6 +450,10 @@ private:
     unsigned _numFields;    // this includes removed fields
     unsigned _hashTabMask;  // equal to hashTabBuckets()-1 but used more often
 
+    BSONObj _bson;                    // backing BSON, empty unless set by initFromBson()
+    mutable BSONObjIterator _bsonIt;  // first field of _bson not decoded into _buffer yet
+    bool _modified;                   // set once a field is modified, added or removed
+
     std::bitset<MetaType::NUM_FIELDS> _metaFields;
     double _textScore;
     double _randVal;
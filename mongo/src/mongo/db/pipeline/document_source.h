@@ -59,6 +59,7 @@ namespace mongo {
 
 class AggregationRequest;
 class Document;
+class MatchExpression;
 
 /**
  * Registers a DocumentSource to have the name 'key'.
@@ -713,6 +714,7 @@ public:
         enum class CurrentOpConnectionsMode { kIncludeIdle, kExcludeIdle };
         enum class CurrentOpUserMode { kIncludeAll, kExcludeOthers };
         enum class CurrentOpTruncateMode { kNoTruncation, kTruncateOps };
+        enum class CurrentOpReportMode { kFullReports, kSummaries };
 
         struct MakePipelineOptions {
             MakePipelineOptions(){};
@@ -749,13 +751,31 @@ public:
         virtual bool isSharded(const NamespaceString& ns) = 0;
 
         /**
-         * Inserts 'objs' into 'ns' and returns the "detailed" last error object.
+         * Inserts 'objs' into 'ns' as one ordered batch. Returns the error of the first document
+         * which could not be inserted, if any.
          */
-        virtual BSONObj insert(const NamespaceString& ns, const std::vector<BSONObj>& objs) = 0;
+        virtual Status insert(const NamespaceString& ns, const std::vector<BSONObj>& objs) = 0;
 
         virtual CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
                                                       const NamespaceString& ns) = 0;
 
+        /**
+         * If 'localNs' is sharded on 'localField' alone, 'foreignNs' is sharded on 'foreignField'
+         * alone, and the chunks of both collections cover the same ranges on the same shards,
+         * returns the collection version of 'foreignNs'. Otherwise returns an empty object.
+         */
+        virtual BSONObj getColocatedCollectionVersion(const NamespaceString& localNs,
+                                                      StringData localField,
+                                                      const NamespaceString& foreignNs,
+                                                      StringData foreignField) = 0;
+
+        /**
+         * Returns the collection version of 'ns' recorded in this shard's sharding metadata, or an
+         * empty object if 'ns' is not sharded. Unlike getColocatedCollectionVersion(), this does
+         * not look at the chunks, so it is cheap enough to call once per document.
+         */
+        virtual BSONObj getShardedCollectionVersion(const NamespaceString& ns) = 0;
+
         /**
          * Appends operation latency statistics for collection "nss" to "builder"
          */
@@ -823,10 +843,16 @@ public:
          * operation or, optionally, an idle connection. If userMode is kIncludeAllUsers, report
          * operations for all authenticated users; otherwise, report only the current user's
          * operations.
+         *
+         * If reportMode is kSummaries, each operation is reported only by the fields its client
+         * publishes without locking, see PublishedOpState. Otherwise, operations whose summary
+         * does not match 'summaryFilter', if there is one, are skipped without being reported.
          */
         virtual std::vector<BSONObj> getCurrentOps(CurrentOpConnectionsMode connMode,
                                                    CurrentOpUserMode userMode,
-                                                   CurrentOpTruncateMode) const = 0;
+                                                   CurrentOpTruncateMode,
+                                                   CurrentOpReportMode reportMode,
+                                                   const MatchExpression* summaryFilter) const = 0;
 
         /**
          * Returns the name of the local shard if sharding is enabled, or an empty string.
@@ -30,6 +30,8 @@
 
 #include "mongo/db/pipeline/document_source_bucket_auto.h"
 
+#include <algorithm>
+
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 
@@ -52,13 +54,17 @@ DocumentSource::GetNextResult DocumentSourceBucketAuto::getNext() {
     pExpCtx->checkForInterrupt();
 
     if (!_populated) {
-        const auto populationResult = populateSorter();
+        const auto populationResult = _approximate ? populateUnsortedInput() : populateSorter();
         if (populationResult.isPaused()) {
             return populationResult;
         }
         invariant(populationResult.isEOF());
 
-        populateBuckets();
+        if (_approximate) {
+            populateBucketsApproximately();
+        } else {
+            populateBuckets();
+        }
 
         _populated = true;
         _bucketsIterator = _buckets.begin();
@@ -113,6 +119,31 @@ DocumentSource::GetNextResult DocumentSourceBucketAuto::populateSorter() {
     return next;
 }
 
+DocumentSource::GetNextResult DocumentSourceBucketAuto::populateUnsortedInput() {
+    auto next = pSource->getNext();
+    for (; next.isAdvanced(); next = pSource->getNext()) {
+        auto nextDoc = next.releaseDocument();
+        auto key = extractKey(nextDoc);
+        uassert(50816,
+                str::stream() << "$bucketAuto with 'approximate' can group by numeric values only, "
+                                 "but found a value with type: "
+                              << typeName(key.getType()),
+                key.numeric());
+
+        _unsortedInputBytes += key.getApproximateSize() + nextDoc.getApproximateSize();
+        uassert(50817,
+                str::stream() << "$bucketAuto with 'approximate' exceeded its memory limit of "
+                              << _maxMemoryUsageBytes
+                              << " bytes. Remove 'approximate' to allow sorting the input on disk.",
+                _unsortedInputBytes <= _maxMemoryUsageBytes);
+
+        _keyDigest.add(key.coerceToDouble());
+        _unsortedInput.emplace_back(std::move(key), std::move(nextDoc));
+        _nDocuments++;
+    }
+    return next;
+}
+
 Value DocumentSourceBucketAuto::extractKey(const Document& doc) {
     if (!_groupByExpression) {
         return Value(BSONNULL);
@@ -265,6 +296,57 @@ void DocumentSourceBucketAuto::populateBuckets() {
     }
 }
 
+void DocumentSourceBucketAuto::populateBucketsApproximately() {
+    const auto& valueCmp = pExpCtx->getValueComparator();
+
+    // The boundaries between buckets are the quantiles that split the input into '_nBuckets'
+    // equally sized parts. Boundaries that the digest estimates to be equal collapse into one, so
+    // that many duplicates of a value yield fewer buckets rather than empty ones. The digest
+    // ignores NaN, so it may be empty, in which case every document lands in one bucket.
+    std::vector<Value> boundaries;
+    for (int i = 1; i < _nBuckets && !_keyDigest.empty(); ++i) {
+        const double boundary = _keyDigest.quantile(static_cast<double>(i) / _nBuckets);
+        if (boundaries.empty() || boundary > boundaries.back().getDouble()) {
+            boundaries.push_back(Value(boundary));
+        }
+    }
+
+    const size_t numAccumulators = _accumulatedFields.size();
+    std::vector<boost::optional<Bucket>> buckets(boundaries.size() + 1);
+    for (auto&& entry : _unsortedInput) {
+        const size_t bucketIndex = std::upper_bound(boundaries.begin(),
+                                                    boundaries.end(),
+                                                    entry.first,
+                                                    [&](const Value& lhs, const Value& rhs) {
+                                                        return valueCmp.evaluate(lhs < rhs);
+                                                    }) -
+            boundaries.begin();
+
+        auto& bucket = buckets[bucketIndex];
+        if (!bucket) {
+            bucket.emplace(pExpCtx, entry.first, entry.first, _accumulatedFields);
+        } else if (valueCmp.evaluate(entry.first < bucket->_min)) {
+            bucket->_min = entry.first;
+        } else if (valueCmp.evaluate(entry.first > bucket->_max)) {
+            bucket->_max = entry.first;
+        }
+
+        for (size_t k = 0; k < numAccumulators; k++) {
+            bucket->_accums[k]->process(_accumulatedFields[k].expression->evaluate(entry.second),
+                                        false);
+        }
+    }
+    std::vector<std::pair<Value, Document>>().swap(_unsortedInput);
+
+    // As in the exact case, each bucket's minimum is the smallest value in it and each bucket's
+    // maximum is the next bucket's minimum, except for the last bucket's.
+    for (auto&& bucket : buckets) {
+        if (bucket) {
+            addBucket(*bucket);
+        }
+    }
+}
+
 DocumentSourceBucketAuto::Bucket::Bucket(
     const boost::intrusive_ptr<ExpressionContext>& expCtx,
     Value min,
@@ -328,6 +410,7 @@ Document DocumentSourceBucketAuto::makeDocument(const Bucket& bucket) {
 
 void DocumentSourceBucketAuto::doDispose() {
     _sortedInput.reset();
+    std::vector<std::pair<Value, Document>>().swap(_unsortedInput);
     _bucketsIterator = _buckets.end();
 }
 
@@ -342,6 +425,10 @@ Value DocumentSourceBucketAuto::serialize(
         insides["granularity"] = Value(_granularityRounder->getName());
     }
 
+    if (_approximate) {
+        insides["approximate"] = Value(true);
+    }
+
     MutableDocument outputSpec(_accumulatedFields.size());
     for (auto&& accumulatedField : _accumulatedFields) {
         intrusive_ptr<Accumulator> accum = accumulatedField.makeAccumulator(pExpCtx);
@@ -360,7 +447,8 @@ intrusive_ptr<DocumentSourceBucketAuto> DocumentSourceBucketAuto::create(
     int numBuckets,
     std::vector<AccumulationStatement> accumulationStatements,
     const boost::intrusive_ptr<GranularityRounder>& granularityRounder,
-    uint64_t maxMemoryUsageBytes) {
+    uint64_t maxMemoryUsageBytes,
+    bool approximate) {
     uassert(40243,
             str::stream() << "The $bucketAuto 'buckets' field must be greater than 0, but found: "
                           << numBuckets,
@@ -376,7 +464,8 @@ intrusive_ptr<DocumentSourceBucketAuto> DocumentSourceBucketAuto::create(
                                         numBuckets,
                                         accumulationStatements,
                                         granularityRounder,
-                                        maxMemoryUsageBytes);
+                                        maxMemoryUsageBytes,
+                                        approximate);
 }
 
 DocumentSourceBucketAuto::DocumentSourceBucketAuto(
@@ -385,12 +474,14 @@ DocumentSourceBucketAuto::DocumentSourceBucketAuto(
     int numBuckets,
     std::vector<AccumulationStatement> accumulationStatements,
     const boost::intrusive_ptr<GranularityRounder>& granularityRounder,
-    uint64_t maxMemoryUsageBytes)
+    uint64_t maxMemoryUsageBytes,
+    bool approximate)
     : DocumentSource(pExpCtx),
       _nBuckets(numBuckets),
       _maxMemoryUsageBytes(maxMemoryUsageBytes),
       _groupByExpression(groupByExpression),
-      _granularityRounder(granularityRounder) {
+      _granularityRounder(granularityRounder),
+      _approximate(approximate) {
 
     invariant(!accumulationStatements.empty());
     for (auto&& accumulationStatement : accumulationStatements) {
@@ -432,6 +523,7 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
     boost::intrusive_ptr<Expression> groupByExpression;
     boost::optional<int> numBuckets;
     boost::intrusive_ptr<GranularityRounder> granularityRounder;
+    bool approximate = false;
 
     for (auto&& argument : elem.Obj()) {
         const auto argName = argument.fieldNameStringData();
@@ -472,6 +564,13 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
                         << typeName(argument.type()),
                     argument.type() == BSONType::String);
             granularityRounder = GranularityRounder::getGranularityRounder(pExpCtx, argument.str());
+        } else if ("approximate" == argName) {
+            uassert(50818,
+                    str::stream()
+                        << "The $bucketAuto 'approximate' field must be a boolean, but found type: "
+                        << typeName(argument.type()),
+                    argument.type() == BSONType::Bool);
+            approximate = argument.Bool();
         } else {
             uasserted(40245, str::stream() << "Unrecognized option to $bucketAuto: " << argName);
         }
@@ -481,8 +580,17 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
             "$bucketAuto requires 'groupBy' and 'buckets' to be specified",
             groupByExpression && numBuckets);
 
-    return DocumentSourceBucketAuto::create(
-        pExpCtx, groupByExpression, numBuckets.get(), accumulationStatements, granularityRounder);
+    uassert(50819,
+            "$bucketAuto cannot specify both 'approximate' and 'granularity'",
+            !(approximate && granularityRounder));
+
+    return DocumentSourceBucketAuto::create(pExpCtx,
+                                            groupByExpression,
+                                            numBuckets.get(),
+                                            accumulationStatements,
+                                            granularityRounder,
+                                            kDefaultMaxMemoryUsageBytes,
+                                            approximate);
 }
 }  // namespace mongo
 
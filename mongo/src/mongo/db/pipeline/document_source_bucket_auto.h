@@ -33,6 +33,7 @@
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/granularity_rounder.h"
+#include "mongo/db/pipeline/t_digest.h"
 #include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
@@ -40,6 +41,11 @@ namespace mongo {
 /**
  * The $bucketAuto stage takes a user-specified number of buckets and automatically determines
  * boundaries such that the values are approximately equally distributed between those buckets.
+ *
+ * With 'approximate: true', the boundaries are estimated from a t-digest of the numeric 'groupBy'
+ * values built in the same pass that buffers the input, so the input is never sorted. The bucket
+ * sizes are then only approximately equal, accumulators see each bucket's documents in input order,
+ * and the input must fit within the memory limit.
  */
 class DocumentSourceBucketAuto final : public DocumentSource, public SplittableDocumentSource {
 public:
@@ -80,7 +86,8 @@ public:
         int numBuckets,
         std::vector<AccumulationStatement> accumulationStatements = {},
         const boost::intrusive_ptr<GranularityRounder>& granularityRounder = nullptr,
-        uint64_t maxMemoryUsageBytes = kDefaultMaxMemoryUsageBytes);
+        uint64_t maxMemoryUsageBytes = kDefaultMaxMemoryUsageBytes,
+        bool approximate = false);
 
     /**
      * Parses a $bucketAuto stage from the user-supplied BSON.
@@ -97,7 +104,8 @@ private:
                              int numBuckets,
                              std::vector<AccumulationStatement> accumulationStatements,
                              const boost::intrusive_ptr<GranularityRounder>& granularityRounder,
-                             uint64_t maxMemoryUsageBytes);
+                             uint64_t maxMemoryUsageBytes,
+                             bool approximate);
 
     // struct for holding information about a bucket.
     struct Bucket {
@@ -118,6 +126,12 @@ private:
      */
     GetNextResult populateSorter();
 
+    /**
+     * The equivalent of populateSorter() for an approximate $bucketAuto: buffers the input in
+     * '_unsortedInput' and adds each 'groupBy' value to '_keyDigest'.
+     */
+    GetNextResult populateUnsortedInput();
+
     /**
      * Computes the 'groupBy' expression value for 'doc'.
      */
@@ -128,6 +142,12 @@ private:
      */
     void populateBuckets();
 
+    /**
+     * The equivalent of populateBuckets() for an approximate $bucketAuto: places each buffered
+     * document into the bucket whose boundaries, estimated from '_keyDigest', surround its key.
+     */
+    void populateBucketsApproximately();
+
     /**
      * Adds the document in 'entry' to 'bucket' by updating the accumulators in 'bucket'.
      */
@@ -157,6 +177,12 @@ private:
     boost::intrusive_ptr<Expression> _groupByExpression;
     boost::intrusive_ptr<GranularityRounder> _granularityRounder;
     long long _nDocuments = 0;
+
+    // Only used when '_approximate' is true.
+    const bool _approximate;
+    TDigest _keyDigest;
+    std::vector<std::pair<Value, Document>> _unsortedInput;
+    uint64_t _unsortedInputBytes = 0;
 };
 
 }  // namespace mongo
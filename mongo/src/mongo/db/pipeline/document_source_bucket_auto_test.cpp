@@ -802,5 +802,86 @@ TEST_F(BucketAutoTests, ShouldFailOnNegativeNumbersWhenGranularitySpecified) {
         AssertionException,
         40260);
 }
+TEST_F(BucketAutoTests, ApproximateReturnsContiguousBucketsOfSimilarSize) {
+    auto bucketAutoSpec =
+        fromjson("{$bucketAuto : {groupBy : '$x', buckets : 4, approximate : true}}");
+    deque<Document> inputs;
+    for (int i = 999; i >= 0; --i) {
+        inputs.push_back(Document{{"x", i}});
+    }
+    auto results = getResults(bucketAutoSpec, inputs);
+
+    ASSERT_EQUALS(results.size(), 4UL);
+    ASSERT_VALUE_EQ(results.front()["_id"]["min"], Value(0));
+    ASSERT_VALUE_EQ(results.back()["_id"]["max"], Value(999));
+    for (size_t i = 0; i < results.size(); ++i) {
+        const int count = results[i]["count"].coerceToInt();
+        ASSERT_GTE(count, 240);
+        ASSERT_LTE(count, 260);
+        if (i > 0) {
+            ASSERT_VALUE_EQ(results[i - 1]["_id"]["max"], results[i]["_id"]["min"]);
+        }
+    }
+}
+
+TEST_F(BucketAutoTests, ApproximateReturnsFewerBucketsWhenValueHasManyDuplicates) {
+    auto bucketAutoSpec =
+        fromjson("{$bucketAuto : {groupBy : '$x', buckets : 3, approximate : true}}");
+    auto results = getResults(bucketAutoSpec,
+                              {Document{{"x", 1}},
+                               Document{{"x", 1}},
+                               Document{{"x", 2}},
+                               Document{{"x", 1}},
+                               Document{{"x", 1}},
+                               Document{{"x", 1}},
+                               Document{{"x", 1}}});
+
+    ASSERT_EQUALS(results.size(), 1UL);
+    ASSERT_DOCUMENT_EQ(results[0], Document(fromjson("{_id : {min : 1, max : 2}, count : 7}")));
+}
+
+TEST_F(BucketAutoTests, SerializesApproximateFieldIfSpecified) {
+    auto bucketAutoSpec =
+        fromjson("{$bucketAuto : {groupBy : '$x', buckets : 2, approximate : true}}");
+    auto expected = fromjson(
+        "{groupBy : '$x', buckets : 2, approximate : true, output : {count : {$sum : {$const : "
+        "1}}}}");
+    testSerialize(bucketAutoSpec, expected);
+}
+
+TEST_F(BucketAutoTests, ApproximateShouldFailOnNonNumericValues) {
+    auto bucketAutoSpec =
+        fromjson("{$bucketAuto : {groupBy : '$x', buckets : 2, approximate : true}}");
+    ASSERT_THROWS_CODE(getResults(bucketAutoSpec, {Document{{"x", 1}}, Document{{"x", "a"_sd}}}),
+                       AssertionException,
+                       50816);
+}
+
+TEST_F(BucketAutoTests, ApproximateShouldFailIfBufferingTooManyDocuments) {
+    auto expCtx = getExpCtx();
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$a", vps);
+    auto bucketAutoStage = DocumentSourceBucketAuto::create(
+        expCtx, groupByExpression, 2, {}, nullptr, maxMemoryUsageBytes, true);
+
+    string largeStr(maxMemoryUsageBytes, 'x');
+    auto mock = DocumentSourceMock::create(
+        {Document{{"a", 0}, {"largeStr", largeStr}}, Document{{"a", 1}, {"largeStr", largeStr}}});
+    bucketAutoStage->setSource(mock.get());
+
+    ASSERT_THROWS_CODE(bucketAutoStage->getNext(), AssertionException, 50817);
+}
+
+TEST_F(BucketAutoTests, FailsWithInvalidApproximateSpecification) {
+    BSONObj spec = fromjson("{$bucketAuto : {groupBy : '$x', buckets : 2, approximate : 1}}");
+    ASSERT_THROWS_CODE(createBucketAuto(spec), AssertionException, 50818);
+
+    spec = fromjson(
+        "{$bucketAuto : {groupBy : '$x', buckets : 2, approximate : true, granularity : 'R5'}}");
+    ASSERT_THROWS_CODE(createBucketAuto(spec), AssertionException, 50819);
+}
 }  // namespace
 }  // namespace mongo
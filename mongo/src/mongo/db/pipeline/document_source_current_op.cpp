@@ -30,6 +30,9 @@
 
 #include "mongo/db/pipeline/document_source_current_op.h"
 
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 
 namespace mongo {
@@ -38,11 +41,18 @@ namespace {
 const StringData kAllUsersFieldName = "allUsers"_sd;
 const StringData kIdleConnectionsFieldName = "idleConnections"_sd;
 const StringData kTruncateOpsFieldName = "truncateOps"_sd;
+const StringData kSummaryFieldName = "summary"_sd;
 
 const StringData kOpIdFieldName = "opid"_sd;
 const StringData kClientFieldName = "client"_sd;
 const StringData kMongosClientFieldName = "client_s"_sd;
 const StringData kShardFieldName = "shard"_sd;
+
+// The fields of the operation summary which have the same value in the summary as in the full
+// report of an operation. Elapsed times are left out since the summary measures them from a
+// slightly different start, and so is killPending since not every kill is published.
+const std::set<StringData> kExactSummaryFields = {
+    "host"_sd, "desc"_sd, "connectionId"_sd, "client"_sd, "active"_sd, "opid"_sd, "op"_sd, "ns"_sd};
 }  // namespace
 
 using boost::intrusive_ptr;
@@ -90,8 +100,20 @@ DocumentSource::GetNextResult DocumentSourceCurrentOp::getNext() {
     pExpCtx->checkForInterrupt();
 
     if (_ops.empty()) {
-        _ops = _mongoProcessInterface->getCurrentOps(
-            _includeIdleConnections, _includeOpsFromAllUsers, _truncateOps);
+        std::unique_ptr<MatchExpression> summaryFilter;
+        if (!_summaryFilter.isEmpty()) {
+            summaryFilter =
+                uassertStatusOK(MatchExpressionParser::parse(_summaryFilter,
+                                                             pExpCtx,
+                                                             ExtensionsCallbackNoop(),
+                                                             Pipeline::kAllowedMatcherFeatures));
+        }
+
+        _ops = _mongoProcessInterface->getCurrentOps(_includeIdleConnections,
+                                                     _includeOpsFromAllUsers,
+                                                     _truncateOps,
+                                                     _reportMode,
+                                                     summaryFilter.get());
 
         _opsIter = _ops.begin();
 
@@ -164,6 +186,7 @@ intrusive_ptr<DocumentSource> DocumentSourceCurrentOp::createFromBson(
     ConnMode includeIdleConnections = ConnMode::kExcludeIdle;
     UserMode includeOpsFromAllUsers = UserMode::kExcludeOthers;
     TruncationMode truncateOps = TruncationMode::kNoTruncation;
+    ReportMode reportMode = ReportMode::kFullReports;
 
     for (auto&& elem : spec.embeddedObject()) {
         const auto fieldName = elem.fieldNameStringData();
@@ -192,6 +215,13 @@ intrusive_ptr<DocumentSource> DocumentSourceCurrentOp::createFromBson(
                     elem.type() == BSONType::Bool);
             truncateOps =
                 (elem.Bool() ? TruncationMode::kTruncateOps : TruncationMode::kNoTruncation);
+        } else if (fieldName == kSummaryFieldName) {
+            uassert(ErrorCodes::FailedToParse,
+                    str::stream() << "The 'summary' parameter of the $currentOp stage must be a "
+                                     "boolean value, but found: "
+                                  << typeName(elem.type()),
+                    elem.type() == BSONType::Bool);
+            reportMode = (elem.Bool() ? ReportMode::kSummaries : ReportMode::kFullReports);
         } else {
             uasserted(ErrorCodes::FailedToParse,
                       str::stream() << "Unrecognized option '" << fieldName
@@ -200,23 +230,57 @@ intrusive_ptr<DocumentSource> DocumentSourceCurrentOp::createFromBson(
     }
 
     return intrusive_ptr<DocumentSourceCurrentOp>(new DocumentSourceCurrentOp(
-        pExpCtx, includeIdleConnections, includeOpsFromAllUsers, truncateOps));
+        pExpCtx, includeIdleConnections, includeOpsFromAllUsers, truncateOps, reportMode));
 }
 
 intrusive_ptr<DocumentSourceCurrentOp> DocumentSourceCurrentOp::create(
     const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
     ConnMode includeIdleConnections,
     UserMode includeOpsFromAllUsers,
-    TruncationMode truncateOps) {
+    TruncationMode truncateOps,
+    ReportMode reportMode) {
     return intrusive_ptr<DocumentSourceCurrentOp>(new DocumentSourceCurrentOp(
-        pExpCtx, includeIdleConnections, includeOpsFromAllUsers, truncateOps));
+        pExpCtx, includeIdleConnections, includeOpsFromAllUsers, truncateOps, reportMode));
+}
+
+Pipeline::SourceContainer::iterator DocumentSourceCurrentOp::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    _summaryFilter = BSONObj();
+
+    auto nextMatch = dynamic_cast<DocumentSourceMatch*>((*std::next(itr)).get());
+    if (!nextMatch) {
+        return std::next(itr);
+    }
+
+    // The top-level conditions of a $match are implicitly ANDed, so any subset of them is
+    // satisfied by every operation the $match lets through. When running on a shard for mongos,
+    // the opid and client fields are renamed or rewritten after the summary is evaluated.
+    BSONObjBuilder filterBuilder;
+    for (auto&& elem : nextMatch->getQuery()) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (!kExactSummaryFields.count(fieldName)) {
+            continue;
+        }
+        if (pExpCtx->fromMongos && (fieldName == kOpIdFieldName || fieldName == kClientFieldName)) {
+            continue;
+        }
+        filterBuilder.append(elem);
+    }
+    _summaryFilter = filterBuilder.obj();
+
+    return std::next(itr);
 }
 
 Value DocumentSourceCurrentOp::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
-    return Value(Document{
-        {getSourceName(),
-         Document{{kIdleConnectionsFieldName, (_includeIdleConnections == ConnMode::kIncludeIdle)},
-                  {kAllUsersFieldName, (_includeOpsFromAllUsers == UserMode::kIncludeAll)},
-                  {kTruncateOpsFieldName, (_truncateOps == TruncationMode::kTruncateOps)}}}});
+    MutableDocument spec(
+        Document{{kIdleConnectionsFieldName, (_includeIdleConnections == ConnMode::kIncludeIdle)},
+                 {kAllUsersFieldName, (_includeOpsFromAllUsers == UserMode::kIncludeAll)},
+                 {kTruncateOpsFieldName, (_truncateOps == TruncationMode::kTruncateOps)}});
+    if (_reportMode == ReportMode::kSummaries) {
+        spec[kSummaryFieldName] = Value(true);
+    }
+    return Value(Document{{getSourceName(), spec.freeze()}});
 }
 }  // namespace mongo
@@ -67,12 +67,14 @@ public:
     using TruncationMode = MongoProcessInterface::CurrentOpTruncateMode;
     using ConnMode = MongoProcessInterface::CurrentOpConnectionsMode;
     using UserMode = MongoProcessInterface::CurrentOpUserMode;
+    using ReportMode = MongoProcessInterface::CurrentOpReportMode;
 
     static boost::intrusive_ptr<DocumentSourceCurrentOp> create(
         const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
         ConnMode includeIdleConnections = ConnMode::kExcludeIdle,
         UserMode includeOpsFromAllUsers = UserMode::kExcludeOthers,
-        TruncationMode truncateOps = TruncationMode::kNoTruncation);
+        TruncationMode truncateOps = TruncationMode::kNoTruncation,
+        ReportMode reportMode = ReportMode::kFullReports);
 
     GetNextResult getNext() final;
 
@@ -95,19 +97,41 @@ public:
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
 
+    /**
+     * Returns the predicate on summary fields which is applied to each operation before it is
+     * reported, or an empty object if there is none.
+     */
+    const BSONObj& getSummaryFilter() const {
+        return _summaryFilter;
+    }
+
+protected:
+    /**
+     * Copies the conditions of an immediately following $match which only refer to fields of the
+     * published operation summary, so that operations which cannot match are skipped before
+     * their full report is built. The $match itself stays in the pipeline.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
 private:
     DocumentSourceCurrentOp(const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
                             ConnMode includeIdleConnections = ConnMode::kExcludeIdle,
                             UserMode includeOpsFromAllUsers = UserMode::kExcludeOthers,
-                            TruncationMode truncateOps = TruncationMode::kNoTruncation)
+                            TruncationMode truncateOps = TruncationMode::kNoTruncation,
+                            ReportMode reportMode = ReportMode::kFullReports)
         : DocumentSourceNeedsMongoProcessInterface(pExpCtx),
           _includeIdleConnections(includeIdleConnections),
           _includeOpsFromAllUsers(includeOpsFromAllUsers),
-          _truncateOps(truncateOps) {}
+          _truncateOps(truncateOps),
+          _reportMode(reportMode) {}
 
     ConnMode _includeIdleConnections = ConnMode::kExcludeIdle;
     UserMode _includeOpsFromAllUsers = UserMode::kExcludeOthers;
     TruncationMode _truncateOps = TruncationMode::kNoTruncation;
+    ReportMode _reportMode = ReportMode::kFullReports;
+
+    BSONObj _summaryFilter;
 
     std::string _shardName;
 
@@ -32,6 +32,7 @@
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source_current_op.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/stub_mongo_process_interface.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
@@ -67,7 +68,9 @@ public:
 
     std::vector<BSONObj> getCurrentOps(CurrentOpConnectionsMode connMode,
                                        CurrentOpUserMode userMode,
-                                       CurrentOpTruncateMode truncateMode) const {
+                                       CurrentOpTruncateMode truncateMode,
+                                       CurrentOpReportMode reportMode,
+                                       const MatchExpression* summaryFilter) const {
         return _ops;
     }
 
@@ -128,6 +131,13 @@ TEST_F(DocumentSourceCurrentOpTest, ShouldFailToParseTruncateOpsIfNotBoolean) {
                        ErrorCodes::FailedToParse);
 }
 
+TEST_F(DocumentSourceCurrentOpTest, ShouldFailToParseSummaryIfNotBoolean) {
+    const auto specObj = fromjson("{$currentOp:{summary:1}}");
+    ASSERT_THROWS_CODE(DocumentSourceCurrentOp::createFromBson(specObj.firstElement(), getExpCtx()),
+                       AssertionException,
+                       ErrorCodes::FailedToParse);
+}
+
 TEST_F(DocumentSourceCurrentOpTest, ShouldFailToParseIfUnrecognisedParameterSpecified) {
     const auto specObj = fromjson("{$currentOp:{foo:true}}");
     ASSERT_THROWS_CODE(DocumentSourceCurrentOp::createFromBson(specObj.firstElement(), getExpCtx()),
@@ -182,6 +192,54 @@ TEST_F(DocumentSourceCurrentOpTest, ShouldSerializeOmittedOptionalArgumentsAsDef
     ASSERT_DOCUMENT_EQ(currentOp->serialize().getDocument(), expectedOutput);
 }
 
+TEST_F(DocumentSourceCurrentOpTest, ShouldParseAndSerializeSummary) {
+    const auto specObj = fromjson("{$currentOp:{summary:true}}");
+
+    const auto parsed =
+        DocumentSourceCurrentOp::createFromBson(specObj.firstElement(), getExpCtx());
+
+    const auto currentOp = static_cast<DocumentSourceCurrentOp*>(parsed.get());
+
+    const auto expectedOutput = Document{{"$currentOp",
+                                          Document{{"idleConnections", false},
+                                                   {"allUsers", false},
+                                                   {"truncateOps", false},
+                                                   {"summary", true}}}};
+
+    ASSERT_DOCUMENT_EQ(currentOp->serialize().getDocument(), expectedOutput);
+}
+
+TEST_F(DocumentSourceCurrentOpTest, ShouldCopySummaryConditionsOfFollowingMatch) {
+    std::vector<BSONObj> rawPipeline{
+        fromjson("{$currentOp:{}}"),
+        fromjson("{$match:{active:true, ns:'test.coll', secs_running:{$gt:5}, "
+                 "$or:[{op:'query'}, {op:'getmore'}]}}")};
+
+    auto pipeline = uassertStatusOK(Pipeline::parse(rawPipeline, getExpCtx()));
+    pipeline->optimizePipeline();
+
+    ASSERT_EQ(pipeline->getSources().size(), 2U);
+    const auto currentOp =
+        dynamic_cast<DocumentSourceCurrentOp*>(pipeline->getSources().front().get());
+    ASSERT(currentOp);
+    ASSERT_BSONOBJ_EQ(currentOp->getSummaryFilter(), fromjson("{active:true, ns:'test.coll'}"));
+}
+
+TEST_F(DocumentSourceCurrentOpTest, ShouldNotCopyRewrittenFieldsInShardedContext) {
+    getExpCtx()->fromMongos = true;
+
+    std::vector<BSONObj> rawPipeline{fromjson("{$currentOp:{}}"),
+                                     fromjson("{$match:{opid:'shard:12', active:true}}")};
+
+    auto pipeline = uassertStatusOK(Pipeline::parse(rawPipeline, getExpCtx()));
+    pipeline->optimizePipeline();
+
+    const auto currentOp =
+        dynamic_cast<DocumentSourceCurrentOp*>(pipeline->getSources().front().get());
+    ASSERT(currentOp);
+    ASSERT_BSONOBJ_EQ(currentOp->getSummaryFilter(), fromjson("{active:true}"));
+}
+
 TEST_F(DocumentSourceCurrentOpTest, ShouldReturnEOFImmediatelyIfNoCurrentOps) {
     const auto currentOp = DocumentSourceCurrentOp::create(getExpCtx());
     const auto mongod = std::make_shared<MockMongoProcessInterfaceImplementation>();
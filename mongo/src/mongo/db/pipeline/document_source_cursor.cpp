@@ -89,7 +89,7 @@ void DocumentSourceCursor::loadBatch() {
                 } else if (_dependencies) {
                     _currentBatch.push_back(_dependencies->extractFields(resultObj));
                 } else {
-                    _currentBatch.push_back(Document::fromBsonWithMetaData(resultObj));
+                    _currentBatch.push_back(Document::fromBsonWithMetaDataLazily(resultObj));
                 }
 
                 if (_limit) {
@@ -270,7 +270,7 @@ DocumentSourceCursor::DocumentSourceCursor(
     recordPlanSummaryStats();
 
     if (collection) {
-        collection->infoCache()->notifyOfQuery(pExpCtx->opCtx, _planSummaryStats.indexesUsed);
+        collection->infoCache()->notifyOfQuery(pExpCtx->opCtx, _planSummaryStats);
     }
 }
 
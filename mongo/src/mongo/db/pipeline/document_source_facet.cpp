@@ -30,13 +30,16 @@
 
 #include "mongo/db/pipeline/document_source_facet.h"
 
+#include <algorithm>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/bsontypes.h"
+#include "mongo/db/client.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source_tee_consumer.h"
 #include "mongo/db/pipeline/expression_context.h"
@@ -44,9 +47,13 @@
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/tee_buffer.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -63,7 +70,7 @@ DocumentSourceFacet::DocumentSourceFacet(std::vector<FacetPipeline> facetPipelin
     for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
         auto& facet = _facets[facetId];
         facet.pipeline->addInitialSource(
-            DocumentSourceTeeConsumer::create(pExpCtx, facetId, _teeBuffer));
+            DocumentSourceTeeConsumer::create(facet.pipeline->getContext(), facetId, _teeBuffer));
     }
 }
 
@@ -169,16 +176,37 @@ DocumentSource::GetNextResult DocumentSourceFacet::getNext() {
     }
 
     vector<vector<Value>> results(_facets.size());
-    bool allPipelinesEOF = false;
-    while (!allPipelinesEOF) {
-        allPipelinesEOF = true;  // Set this to false if any pipeline isn't EOF.
-        for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
-            const auto& pipeline = _facets[facetId].pipeline;
-            auto next = pipeline->getSources().back()->getNext();
-            for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
-                results[facetId].emplace_back(next.releaseDocument());
+
+    // The size of the results is accounted for across all the sub-pipelines, since together they
+    // make up the single output document.
+    const long long maxOutputBytes = internalQueryFacetMaxOutputDocSizeBytes.load();
+    AtomicInt64 outputBytes;
+    auto drainFacet = [&](size_t facetId) {
+        const auto& pipeline = _facets[facetId].pipeline;
+        auto next = pipeline->getSources().back()->getNext();
+        for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
+            results[facetId].emplace_back(next.releaseDocument());
+            uassert(50809,
+                    str::stream() << "$facet exceeded the maximum output size of "
+                                  << maxOutputBytes
+                                  << " bytes",
+                    outputBytes.addAndFetch(results[facetId].back().getApproximateSize()) <=
+                        maxOutputBytes);
+        }
+        return next.isEOF();
+    };
+
+    const size_t nThreads =
+        std::min(_facets.size(), size_t(std::max(1, internalQueryFacetMaxParallelism.load())));
+    if (nThreads > 1 && _canRunFacetsInParallel()) {
+        _drainFacetsInParallel(nThreads, drainFacet);
+    } else {
+        bool allPipelinesEOF = false;
+        while (!allPipelinesEOF) {
+            allPipelinesEOF = true;  // Set this to false if any pipeline isn't EOF.
+            for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
+                allPipelinesEOF = drainFacet(facetId) && allPipelinesEOF;
             }
-            allPipelinesEOF = allPipelinesEOF && next.isEOF();
         }
     }
 
@@ -191,6 +219,69 @@ DocumentSource::GetNextResult DocumentSourceFacet::getNext() {
     return resultDoc.freeze();
 }
 
+bool DocumentSourceFacet::_canRunFacetsInParallel() const {
+    std::set<const ExpressionContext*> expCtxs{pExpCtx.get()};
+    for (auto&& facet : _facets) {
+        if (!expCtxs.insert(facet.pipeline->getContext().get()).second) {
+            return false;
+        }
+        for (auto&& stage : facet.pipeline->getSources()) {
+            if (dynamic_cast<DocumentSourceNeedsMongoProcessInterface*>(stage.get())) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void DocumentSourceFacet::_drainFacetsInParallel(size_t nThreads,
+                                                 const stdx::function<bool(size_t)>& drainFacet) {
+    _teeBuffer->enableConcurrentConsumers();
+
+    // Each facet is always run by the same worker, the zeroth of which is this thread.
+    vector<char> facetEOF(_facets.size(), false);
+    vector<std::exception_ptr> workerErrors(nThreads);
+    auto runWorker = [&](size_t workerId) {
+        try {
+            for (size_t facetId = workerId; facetId < _facets.size(); facetId += nThreads) {
+                if (!facetEOF[facetId]) {
+                    facetEOF[facetId] = drainFacet(facetId);
+                }
+            }
+        } catch (...) {
+            // Rethrown from this thread once every worker has been joined.
+            workerErrors[workerId] = std::current_exception();
+        }
+    };
+    auto serviceContext = pExpCtx->opCtx->getServiceContext();
+    auto runWorkerWithClient = [&](size_t workerId) {
+        Client::initThread("facetWorker", serviceContext, nullptr);
+        ON_BLOCK_EXIT([] { Client::destroy(); });
+        runWorker(workerId);
+    };
+
+    while (std::find(facetEOF.begin(), facetEOF.end(), false) != facetEOF.end()) {
+        // Every facet has paused at the end of the previous batch, or is exhausted, so the next
+        // batch can be loaded from this thread, which is the only one allowed to read the input.
+        _teeBuffer->loadNextBatch();
+
+        vector<stdx::thread> workers;
+        for (size_t workerId = 1; workerId < nThreads; ++workerId) {
+            workers.emplace_back(runWorkerWithClient, workerId);
+        }
+        runWorker(0);
+        for (auto&& worker : workers) {
+            worker.join();
+        }
+
+        for (auto&& error : workerErrors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+}
+
 Value DocumentSourceFacet::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
     MutableDocument serialized;
     for (auto&& facet : _facets) {
@@ -292,11 +383,20 @@ DocumentSource::GetDepsReturn DocumentSourceFacet::getDependencies(DepsTracker*
 intrusive_ptr<DocumentSource> DocumentSourceFacet::createFromBson(
     BSONElement elem, const intrusive_ptr<ExpressionContext>& expCtx) {
 
+    // Sub-pipelines which may run in parallel need their own ExpressionContext, since expression
+    // evaluation and interrupt checking update it. This is not possible when the sub-pipelines may
+    // refer to variables defined in an enclosing scope, which only 'expCtx' knows about.
+    const bool parseForParallelism = internalQueryFacetMaxParallelism.load() > 1 &&
+        !expCtx->variablesParseState.hasDefinedVariables();
+
     std::vector<FacetPipeline> facetPipelines;
     for (auto&& rawFacet : extractRawPipelines(elem)) {
         const auto facetName = rawFacet.first;
 
-        auto pipeline = uassertStatusOK(Pipeline::parseFacetPipeline(rawFacet.second, expCtx));
+        auto facetExpCtx =
+            parseForParallelism ? expCtx->copyWith(expCtx->ns, expCtx->uuid) : expCtx;
+        auto pipeline =
+            uassertStatusOK(Pipeline::parseFacetPipeline(rawFacet.second, facetExpCtx));
 
         facetPipelines.emplace_back(facetName, std::move(pipeline));
     }
@@ -37,6 +37,7 @@
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
 #include "mongo/db/pipeline/pipeline.h"
+#include "mongo/stdx/functional.h"
 
 namespace mongo {
 
@@ -150,6 +151,22 @@ private:
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
 
+    /**
+     * Returns true if the sub-pipelines may run concurrently on separate threads. This requires
+     * each sub-pipeline to have been parsed with its own ExpressionContext, so they share no
+     * mutable expression state, and that no stage needs to talk to the rest of the server (e.g.
+     * $lookup), since the OperationContext may only be used from the thread running the
+     * aggregation.
+     */
+    bool _canRunFacetsInParallel() const;
+
+    /**
+     * Runs 'drainFacet' on every sub-pipeline for each batch of input until all the sub-pipelines
+     * are exhausted, spreading them over up to 'nThreads' threads. 'drainFacet' must return true
+     * once its sub-pipeline is exhausted.
+     */
+    void _drainFacetsInParallel(size_t nThreads, const stdx::function<bool(size_t)>& drainFacet);
+
     boost::intrusive_ptr<TeeBuffer> _teeBuffer;
     std::vector<FacetPipeline> _facets;
 
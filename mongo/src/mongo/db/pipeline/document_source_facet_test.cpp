@@ -43,8 +43,10 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_skip.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 using std::deque;
@@ -678,5 +680,94 @@ TEST_F(DocumentSourceFacetTest, ShouldNotRequirePrimaryShardIfNoStagesRequiresPr
            DocumentSource::StageConstraints::HostTypeRequirement::kAnyShard);
 }
 
+Document runFacetSpecWithParallelism(const boost::intrusive_ptr<ExpressionContext>& ctx,
+                                     const BSONObj& spec,
+                                     int parallelism,
+                                     bool decodeLazily = false) {
+    const auto originalParallelism = internalQueryFacetMaxParallelism.load();
+    const auto originalBufferSize = internalQueryFacetBufferSizeBytes.load();
+    ON_BLOCK_EXIT([&] {
+        internalQueryFacetMaxParallelism.store(originalParallelism);
+        internalQueryFacetBufferSizeBytes.store(originalBufferSize);
+    });
+    internalQueryFacetMaxParallelism.store(parallelism);
+
+    // Use a tiny buffer so that the input is split into many batches.
+    internalQueryFacetBufferSizeBytes.store(100);
+
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 100; ++i) {
+        if (decodeLazily) {
+            // As DocumentSourceCursor produces them.
+            auto sub = BSON("a" << i << "b" << BSON_ARRAY(i));
+            inputs.emplace_back(
+                Document::fromBsonLazily(BSON("_id" << i << "x" << i % 7 << "sub" << sub)));
+        } else {
+            inputs.emplace_back(Document{{"_id", i}, {"x", i % 7}});
+        }
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+
+    auto facetStage = DocumentSourceFacet::createFromBson(spec.firstElement(), ctx);
+    facetStage->setSource(mock.get());
+
+    auto output = facetStage->getNext();
+    ASSERT(output.isAdvanced());
+    ASSERT(facetStage->getNext().isEOF());
+    return output.releaseDocument();
+}
+
+TEST_F(DocumentSourceFacetTest, ParallelSubPipelinesShouldProduceTheSameResultsAsSerialOnes) {
+    auto spec = fromjson(
+        "{$facet: {"
+        "  skipped: [{$skip: 95}],"
+        "  limited: [{$limit: 3}],"
+        "  grouped: [{$group: {_id: '$x', count: {$sum: 1}}}, {$sort: {_id: 1}}],"
+        "  matched: [{$match: {x: 3}}, {$project: {_id: 1}}],"
+        "  computed: [{$project: {y: {$let: {vars: {v: '$x'}, in: {$multiply: ['$$v', 2]}}}}},"
+        "             {$group: {_id: null, total: {$sum: '$y'}}}],"
+        "  counted: [{$count: 'n'}]"
+        "}}");
+
+    auto serial = runFacetSpecWithParallelism(getExpCtx(), spec, 1);
+    auto parallel = runFacetSpecWithParallelism(getExpCtx(), spec, 4);
+
+    ASSERT_DOCUMENT_EQ(serial, parallel);
+    ASSERT_VALUE_EQ(parallel["counted"], Value(vector<Value>{Value(Document{{"n", 100}})}));
+    ASSERT_EQ(parallel["limited"].getArray().size(), 3UL);
+    ASSERT_EQ(parallel["skipped"].getArray().size(), 5UL);
+}
+
+TEST_F(DocumentSourceFacetTest, ParallelSubPipelinesShouldReadLazilyDecodedDocuments) {
+    // Every facet reads the same embedded fields, which would otherwise be decoded concurrently.
+    auto spec = fromjson(
+        "{$facet: {"
+        "  first: [{$group: {_id: '$x', total: {$sum: '$sub.a'}}}, {$sort: {_id: 1}}],"
+        "  second: [{$match: {'sub.a': {$gte: 50}}}, {$project: {b: '$sub.b'}}],"
+        "  third: [{$project: {a: '$sub.a', x: 1}}, {$sort: {a: -1}}, {$limit: 5}],"
+        "  fourth: [{$replaceRoot: {newRoot: '$sub'}}, {$count: 'n'}]"
+        "}}");
+
+    auto serial = runFacetSpecWithParallelism(getExpCtx(), spec, 1, true);
+    auto parallel = runFacetSpecWithParallelism(getExpCtx(), spec, 4, true);
+
+    ASSERT_DOCUMENT_EQ(serial, parallel);
+    ASSERT_EQ(parallel["second"].getArray().size(), 50UL);
+    ASSERT_VALUE_EQ(parallel["fourth"], Value(vector<Value>{Value(Document{{"n", 100}})}));
+}
+
+TEST_F(DocumentSourceFacetTest, ShouldFailIfTheOutputExceedsTheMaximumSize) {
+    const auto originalMaxBytes = internalQueryFacetMaxOutputDocSizeBytes.load();
+    ON_BLOCK_EXIT([&] { internalQueryFacetMaxOutputDocSizeBytes.store(originalMaxBytes); });
+    internalQueryFacetMaxOutputDocSizeBytes.store(1000);
+
+    auto spec = fromjson("{$facet: {a: [{$skip: 0}], b: [{$skip: 0}]}}");
+    for (int parallelism : {1, 2}) {
+        ASSERT_THROWS_CODE(runFacetSpecWithParallelism(getExpCtx(), spec, parallelism),
+                           AssertionException,
+                           50809);
+    }
+}
+
 }  // namespace
 }  // namespace mongo
@@ -30,6 +30,9 @@
 
 #include "mongo/db/pipeline/document_source_graph_lookup.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "mongo/base/init.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/jsobj.h"
@@ -39,6 +42,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/stdx/memory.h"
 
@@ -104,11 +108,9 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNext() {
     performSearch();
 
     std::vector<Value> results;
-    while (!_visited.empty()) {
+    while (hasMoreVisited()) {
         // Remove elements one at a time to avoid consuming more memory.
-        auto it = _visited.begin();
-        results.push_back(Value(it->second));
-        _visited.erase(it);
+        results.push_back(Value(releaseNextVisited()));
     }
 
     MutableDocument output(*_input);
@@ -127,7 +129,7 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
     // If the unwind is not preserving empty arrays, we might have to process multiple inputs before
     // we get one that will produce an output.
     while (true) {
-        if (_visited.empty()) {
+        if (!hasMoreVisited()) {
             // No results are left for the current input, so we should move on to the next one and
             // perform a new search.
 
@@ -143,7 +145,7 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
         }
         MutableDocument unwound(*_input);
 
-        if (_visited.empty()) {
+        if (!hasMoreVisited()) {
             if ((*_unwind)->preserveNullAndEmptyArrays()) {
                 // Since "preserveNullAndEmptyArrays" was specified, output a document even though
                 // we had no result.
@@ -157,23 +159,40 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
                 continue;
             }
         } else {
-            auto it = _visited.begin();
-            unwound.setNestedField(_as, Value(it->second));
+            unwound.setNestedField(_as, Value(releaseNextVisited()));
             if (indexPath) {
                 unwound.setNestedField(*indexPath, Value(_outputIndex));
                 ++_outputIndex;
             }
-            _visited.erase(it);
         }
 
         return unwound.freeze();
     }
 }
 
+bool DocumentSourceGraphLookUp::hasMoreVisited() {
+    return (_spilledVisited && _spilledVisited->more()) || !_visited.empty();
+}
+
+Document DocumentSourceGraphLookUp::releaseNextVisited() {
+    if (_spilledVisited && _spilledVisited->more()) {
+        return _spilledVisited->next().second;
+    }
+    _spilledVisited.reset();
+
+    auto it = _visited.begin();
+    Document result = std::move(it->second);
+    _visited.erase(it);
+    return result;
+}
+
 void DocumentSourceGraphLookUp::doDispose() {
     _cache.clear();
     _frontier.clear();
     _visited.clear();
+    _visitedSpillWriter.reset();
+    _spilledIds.clear();
+    _spilledVisited.reset();
 }
 
 void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
@@ -184,7 +203,7 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
 
         // Check whether each key in the frontier exists in the cache or needs to be queried.
         auto cached = pExpCtx->getDocumentComparator().makeUnorderedDocumentSet();
-        auto matchStage = makeMatchStageFromFrontier(&cached);
+        auto matchStages = makeMatchStagesFromFrontier(&cached);
 
         ValueUnorderedSet queried = pExpCtx->getValueComparator().makeUnorderedValueSet();
         _frontier.swap(queried);
@@ -199,12 +218,12 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
             checkMemoryUsage();
         }
 
-        if (matchStage) {
+        for (auto&& matchStage : matchStages) {
             // Query for all keys that were in the frontier and not in the cache, populating
             // '_frontier' for the next iteration of search.
 
             // We've already allocated space for the trailing $match stage in '_fromPipeline'.
-            _fromPipeline.back() = *matchStage;
+            _fromPipeline.back() = std::move(matchStage);
             auto pipeline =
                 uassertStatusOK(_mongoProcessInterface->makePipeline(_fromPipeline, _fromExpCtx));
             while (auto next = pipeline->getNext()) {
@@ -233,7 +252,7 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
 bool DocumentSourceGraphLookUp::addToVisitedAndFrontier(Document result, long long depth) {
     auto id = result.getField("_id");
 
-    if (_visited.find(id) != _visited.end()) {
+    if (_visited.find(id) != _visited.end() || _spilledIds.find(id) != _spilledIds.end()) {
         // We've already seen this object, don't repeat any work.
         return false;
     }
@@ -280,7 +299,7 @@ void DocumentSourceGraphLookUp::addToCache(const Document& result,
         });
 }
 
-boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
+std::vector<BSONObj> DocumentSourceGraphLookUp::makeMatchStagesFromFrontier(
     DocumentUnorderedSet* cached) {
     // Add any cached values to 'cached' and remove them from '_frontier'.
     for (auto it = _frontier.begin(); it != _frontier.end();) {
@@ -298,35 +317,46 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
         }
     }
 
-    // Create a query of the form {$and: [_additionalFilter, {_connectToField: {$in: [...]}}]}.
-    //
-    // We wrap the query in a $match so that it can be parsed into a DocumentSourceMatch when
-    // constructing a pipeline to execute.
-    BSONObjBuilder match;
-    {
-        BSONObjBuilder query(match.subobjStart("$match"));
+    const int batchSize = internalDocumentSourceGraphLookupFrontierBatchSize.load();
+    const size_t maxValuesPerQuery =
+        batchSize > 0 ? static_cast<size_t>(batchSize) : std::numeric_limits<size_t>::max();
+
+    std::vector<BSONObj> matchStages;
+    auto it = _frontier.begin();
+    while (it != _frontier.end()) {
+        // Create a query of the form {$and: [_additionalFilter, {_connectToField: {$in: [...]}}]}.
+        //
+        // We wrap the query in a $match so that it can be parsed into a DocumentSourceMatch when
+        // constructing a pipeline to execute.
+        BSONObjBuilder match;
         {
-            BSONArrayBuilder andObj(query.subarrayStart("$and"));
-            if (_additionalFilter) {
-                andObj << *_additionalFilter;
-            }
-
+            BSONObjBuilder query(match.subobjStart("$match"));
             {
-                BSONObjBuilder connectToObj(andObj.subobjStart());
+                BSONArrayBuilder andObj(query.subarrayStart("$and"));
+                if (_additionalFilter) {
+                    andObj << *_additionalFilter;
+                }
+
                 {
-                    BSONObjBuilder subObj(connectToObj.subobjStart(_connectToField.fullPath()));
+                    BSONObjBuilder connectToObj(andObj.subobjStart());
                     {
-                        BSONArrayBuilder in(subObj.subarrayStart("$in"));
-                        for (auto&& value : _frontier) {
-                            in << value;
+                        BSONObjBuilder subObj(connectToObj.subobjStart(_connectToField.fullPath()));
+                        {
+                            BSONArrayBuilder in(subObj.subarrayStart("$in"));
+                            for (size_t numValues = 0;
+                                 it != _frontier.end() && numValues < maxValuesPerQuery;
+                                 ++it, ++numValues) {
+                                in << *it;
+                            }
                         }
                     }
                 }
             }
         }
+        matchStages.push_back(match.obj());
     }
 
-    return _frontier.empty() ? boost::none : boost::optional<BSONObj>(match.obj());
+    return matchStages;
 }
 
 void DocumentSourceGraphLookUp::performSearch() {
@@ -347,6 +377,13 @@ void DocumentSourceGraphLookUp::performSearch() {
     }
 
     doBreadthFirstSearch();
+
+    // The spilled documents are returned ahead of those still in memory.
+    if (_visitedSpillWriter) {
+        _spilledVisited.reset(_visitedSpillWriter->done());
+        _visitedSpillWriter.reset();
+        _spilledIds.clear();
+    }
 }
 
 DocumentSource::GetModPathsReturn DocumentSourceGraphLookUp::getModifiedPaths() const {
@@ -388,13 +425,34 @@ BSONObjSet DocumentSourceGraphLookUp::getOutputSorts() {
 }
 
 void DocumentSourceGraphLookUp::checkMemoryUsage() {
-    // TODO SERVER-23980: Implement spilling to disk if allowDiskUse is specified.
+    if ((_visitedUsageBytes + _frontierUsageBytes) >= _maxMemoryUsageBytes &&
+        pExpCtx->allowDiskUse && !pExpCtx->inMongos && !_visited.empty()) {
+        spillVisited();
+    }
+
     uassert(40099,
             "$graphLookup reached maximum memory consumption",
             (_visitedUsageBytes + _frontierUsageBytes) < _maxMemoryUsageBytes);
     _cache.evictDownTo(_maxMemoryUsageBytes - _frontierUsageBytes - _visitedUsageBytes);
 }
 
+void DocumentSourceGraphLookUp::spillVisited() {
+    if (!_visitedSpillWriter) {
+        _visitedSpillWriter = stdx::make_unique<SortedFileWriter<Value, Document>>(
+            SortOptions().TempDir(pExpCtx->tempDir));
+    }
+
+    for (auto&& entry : _visited) {
+        _visitedSpillWriter->addAlreadySorted(entry.first, entry.second);
+
+        // Only the '_id' remains in memory.
+        const size_t documentSize = entry.second.getApproximateSize();
+        _visitedUsageBytes -= std::min(documentSize, _visitedUsageBytes);
+        _spilledIds.insert(entry.first);
+    }
+    _visited.clear();
+}
+
 void DocumentSourceGraphLookUp::serializeToArray(
     std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
     // Serialize default options.
@@ -466,9 +524,14 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
       _maxDepth(maxDepth),
       _frontier(pExpCtx->getValueComparator().makeUnorderedValueSet()),
       _visited(ValueComparator::kInstance.makeUnorderedValueMap<Document>()),
+      _spilledIds(ValueComparator::kInstance.makeUnorderedValueSet()),
       _cache(pExpCtx->getValueComparator()),
       _unwind(unwindSrc) {
     const auto& resolvedNamespace = pExpCtx->getResolvedNamespace(_from);
+    // A traversal may reach any document of 'from', wherever its chunk lives.
+    uassert(28769,
+            str::stream() << _from.ns() << " cannot be sharded",
+            !resolvedNamespace.colocatedShardKeyFields);
     _fromExpCtx = pExpCtx->copyWith(resolvedNamespace.ns);
     _fromPipeline = resolvedNamespace.pipeline;
 
@@ -607,3 +670,6 @@ intrusive_ptr<DocumentSource> DocumentSourceGraphLookUp::createFromBson(
     return std::move(newSource);
 }
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
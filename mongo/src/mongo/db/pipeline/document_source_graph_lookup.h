@@ -33,6 +33,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
 
@@ -57,7 +58,7 @@ public:
         StageConstraints constraints(StreamType::kStreaming,
                                      PositionRequirement::kNone,
                                      HostTypeRequirement::kPrimaryShard,
-                                     DiskUseRequirement::kNoDiskUse,
+                                     DiskUseRequirement::kWritesTmpData,
                                      FacetRequirement::kAllowed);
 
         constraints.canSwapWithMatch = true;
@@ -92,6 +93,10 @@ public:
     static boost::intrusive_ptr<DocumentSource> createFromBson(
         BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
 
+    void setMaxMemoryUsageBytes_forTest(size_t maxMemoryUsageBytes) {
+        _maxMemoryUsageBytes = maxMemoryUsageBytes;
+    }
+
 protected:
     void doDispose() final;
 
@@ -120,15 +125,15 @@ private:
     }
 
     /**
-     * Prepares the query to execute on the 'from' collection wrapped in a $match by using the
-     * contents of '_frontier'.
+     * Prepares the queries to execute on the 'from' collection wrapped in a $match by using the
+     * contents of '_frontier'. Each query looks up at most
+     * internalDocumentSourceGraphLookupFrontierBatchSize values, or all of them if it is zero.
      *
      * Fills 'cached' with any values that were retrieved from the cache.
      *
-     * Returns boost::none if no query is necessary, i.e., all values were retrieved from the cache.
-     * Otherwise, returns a query object.
+     * Returns no queries if none is necessary, i.e., all values were retrieved from the cache.
      */
-    boost::optional<BSONObj> makeMatchStageFromFrontier(DocumentUnorderedSet* cached);
+    std::vector<BSONObj> makeMatchStagesFromFrontier(DocumentUnorderedSet* cached);
 
     /**
      * If we have internalized a $unwind, getNext() dispatches to this function.
@@ -160,6 +165,19 @@ private:
      */
     void checkMemoryUsage();
 
+    /**
+     * Writes the documents in '_visited' to '_visitedSpillWriter', keeping only their '_id' values
+     * in memory so that they are still de-duplicated.
+     */
+    void spillVisited();
+
+    /**
+     * Returns whether the search for the current input found a document not yet returned, and
+     * removes and returns one such document.
+     */
+    bool hasMoreVisited();
+    Document releaseNextVisited();
+
     /**
      * Process 'result', adding it to '_visited' with the given 'depth', and updating '_frontier'
      * with the object's 'connectTo' values.
@@ -199,6 +217,13 @@ private:
     // using the simple collation.
     ValueUnorderedMap<Document> _visited;
 
+    // When '_visited' outgrows the memory limit and disk use is allowed, its documents are spilled
+    // here and only their '_id' values are kept. Once the search completes, the spilled documents
+    // are read back through '_spilledVisited' before those still in '_visited'.
+    std::unique_ptr<SortedFileWriter<Value, Document>> _visitedSpillWriter;
+    ValueUnorderedSet _spilledIds;
+    std::unique_ptr<SortIteratorInterface<Value, Document>> _spilledVisited;
+
     // Caches query results to avoid repeating any work. This structure is maintained across calls
     // to getNext().
     LookupSetCache _cache;
@@ -37,9 +37,12 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/stub_mongo_process_interface.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -84,9 +87,12 @@ public:
     Status attachCursorSourceToPipeline(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                         Pipeline* pipeline) override {
         pipeline->addInitialSource(DocumentSourceMock::create(_results));
+        ++numQueries;
         return Status::OK();
     }
 
+    size_t numQueries = 0;
+
 private:
     std::deque<DocumentSource::GetNextResult> _results;
 };
@@ -624,5 +630,122 @@ TEST_F(DocumentSourceGraphLookUpTest, ShouldNotExpandArraysWithinArraysAtEndOfCo
     ASSERT(graphLookupStage->getNext().isEOF());
 }
 
+/**
+ * Returns the documents of a chain in which the document with '_id' i connects to the one with '_id'
+ * i + 1. Each document is padded so that a few of them exceed a small memory limit.
+ */
+std::deque<DocumentSource::GetNextResult> makePaddedChain(int length) {
+    std::deque<DocumentSource::GetNextResult> chain;
+    for (int i = 0; i < length; ++i) {
+        chain.push_back(
+            Document{{"_id", i}, {"to", i}, {"from", i + 1}, {"pad", std::string(1000, 'x')}});
+    }
+    return chain;
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldErrorWhenExceedingMemoryLimitWithoutDiskUse) {
+    auto expCtx = getExpCtx();
+    auto inputMock = DocumentSourceMock::create(Document{{"_id", 0}});
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "from",
+                                          "to",
+                                          ExpressionFieldPath::create(expCtx, "_id"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock.get());
+    graphLookupStage->setMaxMemoryUsageBytes_forTest(4000);
+    graphLookupStage->injectMongoProcessInterface(
+        std::make_shared<MockMongoProcessInterfaceImplementation>(makePaddedChain(10)));
+
+    ASSERT_THROWS_CODE(graphLookupStage->getNext(), AssertionException, 40099);
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldSpillVisitedDocumentsWhenExceedingMemoryLimit) {
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceGraphLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    auto inputMock = DocumentSourceMock::create(Document{{"_id", 0}});
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "from",
+                                          "to",
+                                          ExpressionFieldPath::create(expCtx, "_id"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock.get());
+    graphLookupStage->setMaxMemoryUsageBytes_forTest(4000);
+    graphLookupStage->injectMongoProcessInterface(
+        std::make_shared<MockMongoProcessInterfaceImplementation>(makePaddedChain(10)));
+
+    auto next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+
+    auto resultsArray = next.getDocument().getField("results").getArray();
+    ASSERT_EQ(10U, resultsArray.size());
+    for (auto&& expected : makePaddedChain(10)) {
+        ASSERT(arrayContains(expCtx, resultsArray, Value(expected.getDocument())));
+    }
+
+    ASSERT_TRUE(graphLookupStage->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldQueryFrontierInBatches) {
+    auto expCtx = getExpCtx();
+    internalDocumentSourceGraphLookupFrontierBatchSize.store(2);
+    ON_BLOCK_EXIT([] { internalDocumentSourceGraphLookupFrontierBatchSize.store(0); });
+
+    auto inputMock = DocumentSourceMock::create(
+        Document{{"_id", 0},
+                 {"start",
+                  std::vector<Value>{Value(1), Value(2), Value(3), Value(4), Value(5)}}});
+
+    std::deque<DocumentSource::GetNextResult> fromContents;
+    for (int i = 1; i <= 5; ++i) {
+        fromContents.push_back(Document{{"_id", i}, {"to", i}});
+    }
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "from",
+                                          "to",
+                                          ExpressionFieldPath::create(expCtx, "start"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock.get());
+    auto mongoProcessInterface =
+        std::make_shared<MockMongoProcessInterfaceImplementation>(std::move(fromContents));
+    graphLookupStage->injectMongoProcessInterface(mongoProcessInterface);
+
+    auto next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_EQ(5U, next.getDocument().getField("results").getArray().size());
+
+    // The five starting values are looked up in queries of at most two values each.
+    ASSERT_EQ(3U, mongoProcessInterface->numQueries);
+}
+
 }  // namespace
 }  // namespace mongo
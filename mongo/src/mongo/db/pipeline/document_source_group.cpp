@@ -28,17 +28,29 @@
 
 #include "mongo/platform/basic.h"
 
+#include <deque>
+#include <numeric>
+
+#include "third_party/murmurhash3/MurmurHash3.h"
+
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/assert_util.h"
 
 namespace mongo {
 
@@ -51,6 +63,327 @@ REGISTER_DOCUMENT_SOURCE(group,
                          LiteParsedDocumentSourceDefault::parse,
                          DocumentSourceGroup::createFromBson);
 
+namespace {
+// Every hash partition keeps a spill file open, so bound how many a single $group may create.
+const int kMaxHashSpillPartitions = 128;
+
+const int kMaxGroupParallelism = 64;
+
+// Spreads a group key hash over the workers independently of the bits used to pick a spill
+// partition or a bucket of the groups map.
+size_t workerForHash(size_t hash, size_t numWorkers) {
+    return ((static_cast<uint64_t>(hash) * 0xC2B2AE3D27D4EB4FULL) >> 32) % numWorkers;
+}
+}  // namespace
+
+class DocumentSourceGroup::PartialAggregationWorkers {
+    MONGO_DISALLOW_COPYING(PartialAggregationWorkers);
+
+public:
+    /**
+     * Starts 'numWorkers' threads, each owning its own queue. The caller picks the worker for every
+     * document, so that all documents of a group are routed to the same worker and accumulated in
+     * the order they arrived. Accumulators such as $first, $last and $push depend on that order.
+     */
+    PartialAggregationWorkers(const DocumentSourceGroup& group, size_t numWorkers)
+        : _pending(numWorkers), _queues(numWorkers) {
+        const BSONObj spec = group.serialize().getDocument().toBson();
+        for (size_t i = 0; i < numWorkers; ++i) {
+            // Evaluating expressions writes to the ExpressionContext's variables, so each worker
+            // parses its own copy of the stage against its own context.
+            auto expCtx = group.pExpCtx->copyWith(group.pExpCtx->ns);
+            _partials.push_back(boost::static_pointer_cast<DocumentSourceGroup>(
+                createFromBson(spec.firstElement(), expCtx)));
+        }
+        _memoryUsageBytes.resize(numWorkers, 0);
+        for (size_t i = 0; i < numWorkers; ++i) {
+            _workers.emplace_back([this, i] { _run(i); });
+        }
+    }
+
+    ~PartialAggregationWorkers() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _done = true;
+            for (auto&& queue : _queues) {
+                queue.clear();
+            }
+            _queuedBatches = 0;
+        }
+        _workAvailable.notify_all();
+        for (auto&& worker : _workers) {
+            worker.join();
+        }
+    }
+
+    /**
+     * Queues 'doc' for the worker that owns the groups whose _id hashes to 'idHash', blocking while
+     * the workers are behind. Throws the first error any worker hit.
+     */
+    void add(Document doc, size_t idHash) {
+        _add(workerForHash(idHash, _workers.size()), std::move(doc));
+    }
+
+    /**
+     * The combined memory used by the workers' groups as of the last batch handed off.
+     */
+    size_t memoryUsageBytes() const {
+        return _lastMemoryUsageBytes;
+    }
+
+    /**
+     * Waits until every queued document has been aggregated and returns the workers' partial
+     * stages. The workers are idle afterwards and never touch the returned stages again.
+     */
+    std::vector<intrusive_ptr<DocumentSourceGroup>> finish() {
+        for (size_t i = 0; i < _queues.size(); ++i) {
+            _flush(i);
+        }
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _spaceAvailable.wait(lk, [&] { return !_status.isOK() || (!_queuedBatches && !_busy); });
+        uassertStatusOK(_status);
+        return _partials;
+    }
+
+private:
+    using Batch = std::vector<Document>;
+
+    static constexpr size_t kBatchSize = 256;
+
+    void _add(size_t queue, Document doc) {
+        _pending[queue].push_back(std::move(doc));
+        if (_pending[queue].size() >= kBatchSize) {
+            _flush(queue);
+        }
+    }
+
+    void _flush(size_t queue) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        if (!_pending[queue].empty()) {
+            // Bound the documents held in memory to a couple of batches per worker.
+            _spaceAvailable.wait(
+                lk, [&] { return !_status.isOK() || _queuedBatches < 2 * _workers.size(); });
+            _queues[queue].push_back(std::move(_pending[queue]));
+            _pending[queue] = Batch();
+            ++_queuedBatches;
+            // Only the worker owning this queue may take the batch.
+            _workAvailable.notify_all();
+        }
+        _lastMemoryUsageBytes =
+            std::accumulate(_memoryUsageBytes.begin(), _memoryUsageBytes.end(), size_t(0));
+        uassertStatusOK(_status);
+    }
+
+    void _run(size_t worker) {
+        DocumentSourceGroup* const partial = _partials[worker].get();
+        std::deque<Batch>& queue = _queues[worker];
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (true) {
+            _workAvailable.wait(lk, [&] { return _done || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+
+            Batch batch = std::move(queue.front());
+            queue.pop_front();
+            --_queuedBatches;
+            ++_busy;
+            _spaceAvailable.notify_all();
+            lk.unlock();
+
+            Status status = Status::OK();
+            try {
+                for (auto&& doc : batch) {
+                    partial->processDocument(doc);
+                }
+            } catch (...) {
+                status = exceptionToStatus();
+            }
+            batch.clear();
+
+            lk.lock();
+            --_busy;
+            _memoryUsageBytes[worker] = partial->_memoryUsageBytes;
+            if (!status.isOK() && _status.isOK()) {
+                _status = status;
+            }
+            _spaceAvailable.notify_all();
+        }
+    }
+
+    std::vector<intrusive_ptr<DocumentSourceGroup>> _partials;
+    std::vector<stdx::thread> _workers;
+    std::vector<Batch> _pending;  // Only touched by the thread running the pipeline.
+    size_t _lastMemoryUsageBytes = 0;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _workAvailable;
+    stdx::condition_variable _spaceAvailable;
+    std::vector<std::deque<Batch>> _queues;  // One per worker.
+    size_t _queuedBatches = 0;
+    std::vector<size_t> _memoryUsageBytes;
+    size_t _busy = 0;
+    bool _done = false;
+    Status _status = Status::OK();
+};
+
+/**
+ * Sits in front of '_groups' when the _id is a single expression, remembering which entry each
+ * string, integer or ObjectId key landed in. Keys are hashed once with a cheap type-specific hash
+ * rather than through Value::hash_combine and the comparator, and are probed in a flat table of
+ * precomputed hashes. Any other key, and any key seen for the first time, goes through '_groups'
+ * itself, which stays the single owner of the groups so that spilling and merging are unchanged.
+ *
+ * Entries are pointers into '_groups', which are stable across rehashing, so the index only needs
+ * to be thrown away when '_groups' is cleared or replaced.
+ */
+class DocumentSourceGroup::ScalarGroupIndex {
+public:
+    // 'indexStrings' must be false when a collator is in use, since collation-equal strings need
+    // not have equal bytes.
+    explicit ScalarGroupIndex(bool indexStrings) : _indexStrings(indexStrings) {}
+
+    enum class Kind : uint8_t { kNone, kInt, kString, kOid };
+
+    struct Key {
+        Kind kind = Kind::kNone;
+        uint64_t hash = 0;
+        long long intKey = 0;
+    };
+
+    /**
+     * Fills out 'key' for 'id' and returns the group it was last seen in, or nullptr. If
+     * 'key->kind' is left as kNone, 'id' cannot be indexed.
+     */
+    GroupsMap::value_type* find(const Value& id, Key* key) const {
+        if (!makeKey(id, key) || _slots.empty()) {
+            return nullptr;
+        }
+        for (size_t i = key->hash & _mask;; i = (i + 1) & _mask) {
+            const Slot& slot = _slots[i];
+            if (!slot.entry) {
+                return nullptr;
+            }
+            if (slot.hash == key->hash && slot.kind == key->kind && matches(slot, *key, id)) {
+                return slot.entry;
+            }
+        }
+    }
+
+    /**
+     * Remembers that the key previously passed to find() belongs to 'entry'.
+     */
+    void insert(const Key& key, GroupsMap::value_type* entry) {
+        // The comparisons in matches() read the key stored in '_groups', so it must have the same
+        // type as the key being indexed. Integers are compared using the copy kept in the slot.
+        const BSONType storedType = entry->first.getType();
+        if ((key.kind == Kind::kString && storedType != String) ||
+            (key.kind == Kind::kOid && storedType != jstOID)) {
+            return;
+        }
+
+        if ((_size + 1) * 2 > _slots.size()) {
+            grow();
+        }
+        place(Slot{key.hash, entry, key.intKey, key.kind});
+        ++_size;
+    }
+
+private:
+    struct Slot {
+        uint64_t hash;
+        GroupsMap::value_type* entry;  // Null if the slot is empty.
+        long long intKey;
+        Kind kind;
+    };
+
+    static const size_t kInitialCapacity = 64;
+
+    bool makeKey(const Value& id, Key* key) const {
+        switch (id.getType()) {
+            case NumberInt:
+            case NumberLong:
+                // NumberInt and NumberLong keys with the same value belong to the same group.
+                key->kind = Kind::kInt;
+                key->intKey = id.coerceToLong();
+                key->hash = mixBits(static_cast<uint64_t>(key->intKey));
+                return true;
+            case String: {
+                if (!_indexStrings) {
+                    return false;
+                }
+                const StringData str = id.getStringData();
+                key->kind = Kind::kString;
+                key->hash = hashBytes(str.rawData(), str.size());
+                return true;
+            }
+            case jstOID: {
+                const OID oid = id.getOid();
+                key->kind = Kind::kOid;
+                key->hash = hashBytes(oid.view().view(), OID::kOIDSize);
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    static bool matches(const Slot& slot, const Key& key, const Value& id) {
+        switch (key.kind) {
+            case Kind::kInt:
+                return slot.intKey == key.intKey;
+            case Kind::kString:
+                return slot.entry->first.getStringData() == id.getStringData();
+            case Kind::kOid:
+                return slot.entry->first.getOid() == id.getOid();
+            case Kind::kNone:
+                break;
+        }
+        MONGO_UNREACHABLE;
+    }
+
+    static uint64_t mixBits(uint64_t bits) {
+        bits ^= bits >> 33;
+        bits *= 0xFF51AFD7ED558CCDULL;
+        bits ^= bits >> 33;
+        bits *= 0xC4CEB9FE1A85EC53ULL;
+        bits ^= bits >> 33;
+        return bits;
+    }
+
+    static uint64_t hashBytes(const char* data, size_t len) {
+        uint64_t out[2];
+        MurmurHash3_x64_128(data, static_cast<int>(len), 0, out);
+        return out[0];
+    }
+
+    void place(const Slot& slot) {
+        size_t i = slot.hash & _mask;
+        while (_slots[i].entry) {
+            i = (i + 1) & _mask;
+        }
+        _slots[i] = slot;
+    }
+
+    void grow() {
+        std::vector<Slot> old(std::max(kInitialCapacity, _slots.size() * 2), Slot{0, nullptr, 0});
+        old.swap(_slots);
+        _mask = _slots.size() - 1;
+        for (auto&& slot : old) {
+            if (slot.entry) {
+                place(slot);
+            }
+        }
+    }
+
+    const bool _indexStrings;
+    std::vector<Slot> _slots;  // Power-of-two sized, kept at most half full.
+    size_t _mask = 0;
+    size_t _size = 0;
+};
+
+DocumentSourceGroup::~DocumentSourceGroup() = default;
+
 const char* DocumentSourceGroup::getSourceName() const {
     return "$group";
 }
@@ -103,7 +436,9 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
         }
 
         if (!_sorterIterator->more()) {
-            dispose();
+            if (!loadNextPartition()) {
+                dispose();
+            }
             break;
         }
 
@@ -120,7 +455,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
 
     Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
 
-    if (++groupsIterator == _groups->end())
+    if (++groupsIterator == _groups->end() && !loadNextPartition())
         dispose();
 
     return std::move(out);
@@ -129,7 +464,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
 DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
     // Streaming optimization is active.
     if (!_firstDocOfNextGroup) {
-        auto nextInput = pSource->getNext();
+        auto nextInput = getNextInput();
         if (!nextInput.isAdvanced()) {
             return nextInput;
         }
@@ -145,7 +480,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
         }
 
         // Retrieve the next document.
-        auto nextInput = pSource->getNext();
+        auto nextInput = getNextInput();
         if (!nextInput.isAdvanced()) {
             return nextInput;
         }
@@ -167,7 +502,11 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
 void DocumentSourceGroup::doDispose() {
     // Free our resources.
     _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+    _scalarIndex.reset();
     _sorterIterator.reset();
+    _partitionWriters.clear();
+    _partialWorkers.reset();
+    _workerPartitions.clear();
 
     // Make us look done.
     groupsIterator = _groups->end();
@@ -227,7 +566,21 @@ Value DocumentSourceGroup::serialize(boost::optional<ExplainOptions::Verbosity>
     return Value(DOC(getSourceName() << insides.freeze()));
 }
 
+void DocumentSourceGroup::serializeToArray(
+    std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
+    // An absorbed $unwind is serialized in its original position, so that the pipeline re-parses
+    // to the same stages.
+    if (_unwind) {
+        _unwind->serializeToArray(array, explain);
+    }
+    DocumentSource::serializeToArray(array, explain);
+}
+
 DocumentSource::GetDepsReturn DocumentSourceGroup::getDependencies(DepsTracker* deps) const {
+    if (_unwind) {
+        _unwind->getDependencies(deps);
+    }
+
     // add the _id
     for (size_t i = 0; i < _idExpressions.size(); i++) {
         _idExpressions[i]->addDependencies(deps);
@@ -266,6 +619,9 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
       _initialized(false),
       _groups(pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>()),
       _spilled(false),
+      _numSpillPartitions(std::min(
+          std::max(internalDocumentSourceGroupHashSpillPartitions.load(), 0),
+          kMaxHashSpillPartitions)),
       _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos) {}
 
 void DocumentSourceGroup::addAccumulator(AccumulationStatement accumulationStatement) {
@@ -303,6 +659,24 @@ intrusive_ptr<Expression> parseIdExpression(const intrusive_ptr<ExpressionContex
 
 }  // namespace
 
+bool DocumentSourceGroup::absorbUnwind(const intrusive_ptr<DocumentSourceUnwind>& unwind) {
+    if (_unwind || _doingMerge) {
+        return false;
+    }
+
+    // The metadata of each input document is always kept, so any metadata may be depended upon.
+    DepsTracker deps(DepsTracker::MetadataAvailable::kTextScore);
+    unwind->getDependencies(&deps);
+    getDependencies(&deps);
+
+    _unwindNeedsWholeDocument = deps.needWholeDocument;
+    for (auto&& field : deps.fields) {
+        _unwindInputFields.insert(FieldPath::extractFirstFieldFromDottedPath(field).toString());
+    }
+    _unwind = unwind;
+    return true;
+}
+
 void DocumentSourceGroup::setIdExpression(const boost::intrusive_ptr<Expression> idExpression) {
 
     if (auto object = dynamic_cast<ExpressionObject*>(idExpression.get())) {
@@ -448,6 +822,40 @@ void getFieldPathListForSpilled(ExpressionObject* expressionObj,
 }
 }  // namespace
 
+DocumentSource::GetNextResult DocumentSourceGroup::getNextInput() {
+    if (!_unwind) {
+        return pSource->getNext();
+    }
+
+    auto nextOut = _unwind->getNextUnwound();
+    while (nextOut.isEOF()) {
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            return nextInput;
+        }
+
+        if (_unwindNeedsWholeDocument) {
+            _unwind->resetUnwound(nextInput.releaseDocument());
+        } else {
+            // Unwinding sets the array element in a copy of the document, so only the fields that
+            // will be read are carried over into that copy.
+            const Document input = nextInput.releaseDocument();
+            MutableDocument trimmed(_unwindInputFields.size());
+            for (auto&& fieldName : _unwindInputFields) {
+                Value value = input[fieldName];
+                if (!value.missing()) {
+                    trimmed.addField(fieldName, std::move(value));
+                }
+            }
+            trimmed.copyMetaDataFrom(input);
+            _unwind->resetUnwound(trimmed.freeze());
+        }
+        nextOut = _unwind->getNextUnwound();
+    }
+
+    return nextOut;
+}
+
 DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     const size_t numAccumulators = _accumulatedFields.size();
 
@@ -464,7 +872,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
         }
 
         // We only need to load the first document.
-        auto firstInput = pSource->getNext();
+        auto firstInput = getNextInput();
         if (!firstInput.isAdvanced()) {
             // Leave '_firstDocOfNextGroup' uninitialized and return.
             return firstInput;
@@ -478,54 +886,42 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     }
 
 
-    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
-    GetNextResult input = pSource->getNext();
-    for (; input.isAdvanced(); input = pSource->getNext()) {
-        if (_memoryUsageBytes > _maxMemoryUsageBytes) {
-            uassert(16945,
-                    "Exceeded memory limit for $group, but didn't allow external sort."
-                    " Pass allowDiskUse:true to opt in.",
-                    _allowDiskUse);
-            _sortedFiles.push_back(spill());
-            _memoryUsageBytes = 0;
-        }
-
-        // We release the result document here so that it does not outlive the end of this loop
-        // iteration. Not releasing could lead to an array copy when this group follows an unwind.
-        auto rootDocument = input.releaseDocument();
-        Value id = computeId(rootDocument);
-
-        // Look for the _id value in the map. If it's not there, add a new entry with a blank
-        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
-        // looking it up in '_groups' multiple times.
-        const size_t oldSize = _groups->size();
-        vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
-        const bool inserted = _groups->size() != oldSize;
+    if (!_parallelismChosen) {
+        _parallelismChosen = true;
 
-        if (inserted) {
-            _memoryUsageBytes += id.getApproximateSize();
+        // Variables bound by an enclosing $lookup are not visible from a copied ExpressionContext,
+        // so only top-level pipelines build partial groups in parallel. Each worker owns a disjoint
+        // set of _ids, so its groups see their documents in input order and are returned as they
+        // are rather than merged on this thread.
+        const int parallelism = std::min(pExpCtx->inMongos
+                                             ? internalDocumentSourceGroupMongosParallelism.load()
+                                             : internalDocumentSourceGroupParallelism.load(),
+                                         kMaxGroupParallelism);
+        if (parallelism > 1 && pExpCtx->subPipelineDepth == 0) {
+            _partialWorkers = stdx::make_unique<PartialAggregationWorkers>(*this, parallelism);
+        }
+    }
 
-            // Add the accumulators
-            group.reserve(numAccumulators);
-            for (auto&& accumulatedField : _accumulatedFields) {
-                group.push_back(accumulatedField.makeAccumulator(pExpCtx));
-            }
-        } else {
-            for (auto&& groupObj : group) {
-                // subtract old mem usage. New usage added back after processing.
-                _memoryUsageBytes -= groupObj->memUsageForSorter();
+    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
+    GetNextResult input = getNextInput();
+    for (; input.isAdvanced(); input = getNextInput()) {
+        if (_partialWorkers) {
+            Document doc = input.releaseDocument();
+            const size_t idHash = _groups->hash_function()(computeId(doc));
+            _partialWorkers->add(std::move(doc), idHash);
+            if (_partialWorkers->memoryUsageBytes() > _maxMemoryUsageBytes) {
+                // Only this thread may spill, so merge what the workers have built so far and
+                // aggregate the rest of the input here.
+                finishPartialAggregation();
             }
+            continue;
         }
 
-        /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
+        spillIfOverMemoryLimit();
 
-        for (size_t i = 0; i < numAccumulators; i++) {
-            group[i]->process(_accumulatedFields[i].expression->evaluate(rootDocument),
-                              _doingMerge);
-
-            _memoryUsageBytes += group[i]->memUsageForSorter();
-        }
+        // We release the result document here so that it does not outlive the end of this loop
+        // iteration. Not releasing could lead to an array copy when this group follows an unwind.
+        const bool inserted = processDocument(input.releaseDocument());
 
         if (kDebugBuild && !storageGlobalParams.readOnly) {
             // In debug mode, spill every time we have a duplicate id to stress merge logic.
@@ -547,8 +943,28 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
             return input;  // Propagate pause.
         }
         case DocumentSource::GetNextResult::ReturnStatus::kEOF: {
+            if (_partialWorkers) {
+                // The workers' groups are disjoint, so each is returned in turn without a merge.
+                _workerPartitions = _partialWorkers->finish();
+                _partialWorkers.reset();
+                loadNextPartition();
+            }
+
             // Do any final steps necessary to prepare to output results.
-            if (!_sortedFiles.empty()) {
+            if (_hashSpilled) {
+                if (!_groups->empty()) {
+                    spillToPartitions();
+                }
+
+                // prepare current to accumulate data
+                _currentAccumulators.reserve(numAccumulators);
+                for (auto&& accumulatedField : _accumulatedFields) {
+                    _currentAccumulators.push_back(accumulatedField.makeAccumulator(pExpCtx));
+                }
+
+                // We put data in, so at least one partition must be non-empty.
+                verify(loadNextPartition());
+            } else if (!_sortedFiles.empty()) {
                 _spilled = true;
                 if (!_groups->empty()) {
                     _sortedFiles.push_back(spill());
@@ -556,6 +972,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
 
                 // We won't be using groups again so free its memory.
                 _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+                _scalarIndex.reset();
 
                 _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
                     _sortedFiles, SortOptions(), SorterComparator(pExpCtx->getValueComparator())));
@@ -568,7 +985,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
 
                 verify(_sorterIterator->more());  // we put data in, we should get something out.
                 _firstPartOfNextGroup = _sorterIterator->next();
-            } else {
+            } else if (_workerPartitions.empty()) {
                 // start the group iterator
                 groupsIterator = _groups->begin();
             }
@@ -582,6 +999,125 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     MONGO_UNREACHABLE;
 }
 
+void DocumentSourceGroup::spillIfOverMemoryLimit() {
+    if (_memoryUsageBytes <= _maxMemoryUsageBytes) {
+        return;
+    }
+
+    uassert(16945,
+            "Exceeded memory limit for $group, but didn't allow external sort."
+            " Pass allowDiskUse:true to opt in.",
+            _allowDiskUse);
+    if (_numSpillPartitions > 0) {
+        spillToPartitions();
+    } else {
+        _sortedFiles.push_back(spill());
+    }
+    _memoryUsageBytes = 0;
+}
+
+bool DocumentSourceGroup::processDocument(const Document& rootDocument) {
+    const size_t numAccumulators = _accumulatedFields.size();
+    Value id = computeId(rootDocument);
+
+    if (!_scalarIndex && _idExpressions.size() == 1) {
+        _scalarIndex = stdx::make_unique<ScalarGroupIndex>(!pExpCtx->getCollator());
+    }
+
+    // Scalar keys which have been seen before are found without going through '_groups'.
+    ScalarGroupIndex::Key scalarKey;
+    GroupsMap::value_type* entry = _scalarIndex ? _scalarIndex->find(id, &scalarKey) : nullptr;
+    bool inserted = false;
+    if (!entry && scalarKey.kind != ScalarGroupIndex::Kind::kNone) {
+        // The index needs the entry itself rather than just its accumulators, so this can't use
+        // operator[] below.
+        auto it = _groups->find(id);
+        if (it == _groups->end()) {
+            it = _groups->emplace(id, Accumulators()).first;
+            inserted = true;
+        }
+        entry = &*it;
+        _scalarIndex->insert(scalarKey, entry);
+    }
+
+    Accumulators* groupPtr;
+    if (entry) {
+        groupPtr = &entry->second;
+    } else {
+        // Look for the _id value in the map. If it's not there, add a new entry with a blank
+        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
+        // looking it up in '_groups' multiple times.
+        const size_t oldSize = _groups->size();
+        groupPtr = &(*_groups)[id];
+        inserted = _groups->size() != oldSize;
+    }
+    vector<intrusive_ptr<Accumulator>>& group = *groupPtr;
+
+    if (inserted) {
+        _memoryUsageBytes += id.getApproximateSize();
+
+        // Add the accumulators
+        group.reserve(numAccumulators);
+        for (auto&& accumulatedField : _accumulatedFields) {
+            group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+        }
+    } else {
+        for (auto&& groupObj : group) {
+            // subtract old mem usage. New usage added back after processing.
+            _memoryUsageBytes -= groupObj->memUsageForSorter();
+        }
+    }
+
+    /* tickle all the accumulators for the group we found */
+    dassert(numAccumulators == group.size());
+
+    for (size_t i = 0; i < numAccumulators; i++) {
+        group[i]->process(_accumulatedFields[i].expression->evaluate(rootDocument),
+                          _doingMerge);
+
+        _memoryUsageBytes += group[i]->memUsageForSorter();
+    }
+
+    return inserted;
+}
+
+void DocumentSourceGroup::finishPartialAggregation() {
+    for (auto&& partial : _partialWorkers->finish()) {
+        mergePartialGroups(partial.get());
+    }
+    _partialWorkers.reset();
+}
+
+void DocumentSourceGroup::mergePartialGroups(DocumentSourceGroup* partial) {
+    const size_t numAccumulators = _accumulatedFields.size();
+    for (auto&& partialGroup : *partial->_groups) {
+        spillIfOverMemoryLimit();
+
+        const size_t oldSize = _groups->size();
+        Accumulators& group = (*_groups)[partialGroup.first];
+        if (_groups->size() != oldSize) {
+            _memoryUsageBytes += partialGroup.first.getApproximateSize();
+            group.reserve(numAccumulators);
+            for (auto&& accumulatedField : _accumulatedFields) {
+                group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+            }
+        } else {
+            for (auto&& groupObj : group) {
+                _memoryUsageBytes -= groupObj->memUsageForSorter();
+            }
+        }
+
+        for (size_t i = 0; i < numAccumulators; i++) {
+            group[i]->process(partialGroup.second[i]->getValue(/*toBeMerged=*/true), true);
+            _memoryUsageBytes += group[i]->memUsageForSorter();
+        }
+    }
+
+    partial->_groups->clear();
+    partial->_scalarIndex.reset();
+    partial->_memoryUsageBytes = 0;
+}
+
 shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
     vector<const GroupsMap::value_type*> ptrs;  // using pointers to speed sorting
     ptrs.reserve(_groups->size());
@@ -618,10 +1154,145 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
     }
 
     _groups->clear();
+    _scalarIndex.reset();
 
     return shared_ptr<Sorter<Value, Value>::Iterator>(writer.done());
 }
 
+void DocumentSourceGroup::spillToPartitions() {
+    if (_partitionWriters.empty()) {
+        _partitionWriters.resize(_numSpillPartitions);
+    }
+    _hashSpilled = true;
+
+    const auto hasher = _groups->hash_function();
+    for (auto&& group : *_groups) {
+        // Scramble the hash so that the partition is not correlated with the map's own buckets.
+        const uint64_t hash = static_cast<uint64_t>(hasher(group.first)) * 0x9E3779B97F4A7C15ULL;
+        auto& writer = _partitionWriters[(hash >> 32) % _numSpillPartitions];
+        if (!writer) {
+            writer = stdx::make_unique<SortedFileWriter<Value, Value>>(
+                SortOptions().TempDir(pExpCtx->tempDir));
+        }
+
+        const Accumulators& accums = group.second;
+        switch (accums.size()) {  // mirrors switch in spill()
+            case 0:
+                writer->addAlreadySorted(group.first, Value());
+                break;
+
+            case 1:
+                writer->addAlreadySorted(group.first, accums[0]->getValue(/*toBeMerged=*/true));
+                break;
+
+            default: {
+                vector<Value> states;
+                states.reserve(accums.size());
+                for (auto&& accum : accums) {
+                    states.push_back(accum->getValue(/*toBeMerged=*/true));
+                }
+                writer->addAlreadySorted(group.first, Value(std::move(states)));
+                break;
+            }
+        }
+    }
+
+    _groups->clear();
+    _scalarIndex.reset();
+}
+
+bool DocumentSourceGroup::loadNextPartition() {
+    // Release whatever the previous partition was using.
+    _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+    _scalarIndex.reset();
+    _sortedFiles.clear();
+    _sorterIterator.reset();
+    _spilled = false;
+    _memoryUsageBytes = 0;
+
+    while (_nextWorkerPartition < _workerPartitions.size()) {
+        // The worker's stage, and with it the comparator its groups map hashes with, stays alive
+        // until this stage is disposed.
+        DocumentSourceGroup* const partial = _workerPartitions[_nextWorkerPartition++].get();
+        if (!partial->_groups->empty()) {
+            std::swap(*_groups, *partial->_groups);
+            groupsIterator = _groups->begin();
+            return true;
+        }
+    }
+
+    while (_nextPartition < _partitionWriters.size() && !_partitionWriters[_nextPartition]) {
+        ++_nextPartition;
+    }
+    if (_nextPartition == _partitionWriters.size()) {
+        return false;
+    }
+
+    const std::unique_ptr<Sorter<Value, Value>::Iterator> partition(
+        _partitionWriters[_nextPartition]->done());
+    _partitionWriters[_nextPartition].reset();
+    ++_nextPartition;
+
+    const size_t numAccumulators = _accumulatedFields.size();
+    while (partition->more()) {
+        if (_memoryUsageBytes > _maxMemoryUsageBytes) {
+            // Too many distinct _ids hashed to this partition. Finish it with sorted runs instead.
+            _sortedFiles.push_back(spill());
+            _memoryUsageBytes = 0;
+        }
+
+        const auto entry = partition->next();
+        const size_t oldSize = _groups->size();
+        Accumulators& group = (*_groups)[entry.first];
+        if (_groups->size() != oldSize) {
+            _memoryUsageBytes += entry.first.getApproximateSize();
+            group.reserve(numAccumulators);
+            for (auto&& accumulatedField : _accumulatedFields) {
+                group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+            }
+        } else {
+            for (auto&& groupObj : group) {
+                _memoryUsageBytes -= groupObj->memUsageForSorter();
+            }
+        }
+
+        switch (numAccumulators) {  // mirrors switch in spill()
+            case 1:
+                group[0]->process(entry.second, true);
+            case 0:
+                break;
+            default: {
+                const vector<Value>& accumulatorStates = entry.second.getArray();
+                for (size_t i = 0; i < numAccumulators; i++) {
+                    group[i]->process(accumulatorStates[i], true);
+                }
+            }
+        }
+
+        for (auto&& groupObj : group) {
+            _memoryUsageBytes += groupObj->memUsageForSorter();
+        }
+    }
+
+    if (_sortedFiles.empty()) {
+        groupsIterator = _groups->begin();
+        return true;
+    }
+
+    _spilled = true;
+    if (!_groups->empty()) {
+        _sortedFiles.push_back(spill());
+    }
+    _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+    _scalarIndex.reset();
+
+    _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
+        _sortedFiles, SortOptions(), SorterComparator(pExpCtx->getValueComparator())));
+    verify(_sorterIterator->more());
+    _firstPartOfNextGroup = _sorterIterator->next();
+    return true;
+}
+
 boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
     if (true) {
         // Until streaming $group correctly handles nullish values, the streaming behavior is
@@ -629,9 +1300,9 @@ boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
         return boost::none;
     }
 
-    if (!pSource) {
+    if (!pSource || _unwind) {
         // Sometimes when performing an explain, or using $group as the merge point, 'pSource' will
-        // not be set.
+        // not be set. The sort order of an absorbed $unwind's input is not that of its output.
         return boost::none;
     }
 
@@ -29,6 +29,8 @@
 #pragma once
 
 #include <memory>
+#include <set>
+#include <string>
 #include <utility>
 
 #include "mongo/db/pipeline/accumulation_statement.h"
@@ -38,6 +40,8 @@
 
 namespace mongo {
 
+class DocumentSourceUnwind;
+
 class DocumentSourceGroup final : public DocumentSource, public SplittableDocumentSource {
 public:
     using Accumulators = std::vector<boost::intrusive_ptr<Accumulator>>;
@@ -45,10 +49,15 @@ public:
 
     static const size_t kDefaultMaxMemoryUsageBytes = 100 * 1024 * 1024;
 
+    ~DocumentSourceGroup();
+
     // Virtuals from DocumentSource.
     boost::intrusive_ptr<DocumentSource> optimize() final;
     GetDepsReturn getDependencies(DepsTracker* deps) const final;
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+    void serializeToArray(
+        std::vector<Value>& array,
+        boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
     GetNextResult getNext() final;
     const char* getSourceName() const final;
     BSONObjSet getOutputSorts() final;
@@ -98,6 +107,14 @@ public:
         return _streaming;
     }
 
+    /**
+     * Makes this stage unwind its own input with 'unwind', which must immediately precede it.
+     * Before being unwound, each input document is trimmed to the top-level fields this stage and
+     * 'unwind' read, so the array elements are not written into copies of fields nobody looks at.
+     * Returns false, leaving this stage unchanged, if it cannot absorb the $unwind.
+     */
+    bool absorbUnwind(const boost::intrusive_ptr<DocumentSourceUnwind>& unwind);
+
     // Virtuals for SplittableDocumentSource.
     boost::intrusive_ptr<DocumentSource> getShardSource() final;
     std::list<boost::intrusive_ptr<DocumentSource>> getMergeSources() final;
@@ -106,6 +123,18 @@ protected:
     void doDispose() final;
 
 private:
+    /**
+     * A pool of threads, each feeding the documents of its own share of the _ids into its own copy
+     * of this $group stage. Defined in document_source_group.cpp.
+     */
+    class PartialAggregationWorkers;
+
+    /**
+     * An open-addressing index from single-field string, integer and ObjectId _id values to their
+     * entries in '_groups'. Defined in document_source_group.cpp.
+     */
+    class ScalarGroupIndex;
+
     explicit DocumentSourceGroup(const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
                                  size_t maxMemoryUsageBytes = kDefaultMaxMemoryUsageBytes);
 
@@ -136,6 +165,11 @@ private:
      */
     GetNextResult initialize();
 
+    /**
+     * Returns the next input document, unwound by '_unwind' if this stage has absorbed a $unwind.
+     */
+    GetNextResult getNextInput();
+
     /**
      * Spill groups map to disk and returns an iterator to the file. Note: Since a sorted $group
      * does not exhaust the previous stage before returning, and thus does not maintain as large a
@@ -143,6 +177,45 @@ private:
      */
     std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
 
+    /**
+     * Spills the groups map to disk if it has grown beyond the memory limit, or throws if this
+     * stage may not use the disk.
+     */
+    void spillIfOverMemoryLimit();
+
+    /**
+     * Adds 'root' to the group its _id belongs to, creating the group if needed. Returns true if a
+     * new group was created.
+     */
+    bool processDocument(const Document& root);
+
+    /**
+     * Waits for the partial aggregation workers to drain their input, then merges each worker's
+     * groups into this stage's groups map and shuts the workers down.
+     */
+    void finishPartialAggregation();
+
+    /**
+     * Merges the accumulator states of every group in 'partial' into this stage's groups map,
+     * spilling as needed, and empties 'partial'.
+     */
+    void mergePartialGroups(DocumentSourceGroup* partial);
+
+    /**
+     * Appends every entry of the groups map to the spill file of the hash partition its _id falls
+     * into, then clears the map. Groups with equal _ids always land in the same partition, so each
+     * partition can later be aggregated on its own without a merge sort.
+     */
+    void spillToPartitions();
+
+    /**
+     * Reads the next non-empty hash partition back into the groups map and prepares to return its
+     * groups. A partition that is itself too large for memory falls back to the sort-based spill.
+     * The groups built by parallel workers are consumed first, one worker at a time. Returns
+     * false once every partition has been consumed.
+     */
+    bool loadNextPartition();
+
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
     /**
@@ -158,6 +231,12 @@ private:
 
     std::vector<AccumulationStatement> _accumulatedFields;
 
+    // Set when this stage has absorbed the $unwind preceding it. Unless the whole document is
+    // needed, input documents are trimmed to '_unwindInputFields' before being unwound.
+    boost::intrusive_ptr<DocumentSourceUnwind> _unwind;
+    std::set<std::string> _unwindInputFields;
+    bool _unwindNeedsWholeDocument = false;
+
     bool _doingMerge;
     size_t _memoryUsageBytes = 0;
     size_t _maxMemoryUsageBytes;
@@ -176,9 +255,30 @@ private:
     // definition of equality.
     boost::optional<GroupsMap> _groups;
 
+    // Created on first use when the _id is a single expression. Points into '_groups', so it must
+    // be reset whenever '_groups' is cleared or replaced.
+    std::unique_ptr<ScalarGroupIndex> _scalarIndex;
+
     std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> _sortedFiles;
     bool _spilled;
 
+    // Number of hash partitions to spill into, or zero to spill sorted runs instead. Writers are
+    // created on first use so that partitions which never receive a group do not create files.
+    const size_t _numSpillPartitions;
+    std::vector<std::unique_ptr<SortedFileWriter<Value, Value>>> _partitionWriters;
+    size_t _nextPartition = 0;
+    bool _hashSpilled = false;
+
+    // Set while an unsorted $group is building partial groups on several threads. The decision to
+    // do so is made once, the first time initialize() runs.
+    std::unique_ptr<PartialAggregationWorkers> _partialWorkers;
+    bool _parallelismChosen = false;
+
+    // The stages of parallel workers whose groups are returned without being merged here. Kept
+    // until dispose since the groups map swapped in from one of them uses its comparator.
+    std::vector<boost::intrusive_ptr<DocumentSourceGroup>> _workerPartitions;
+    size_t _nextWorkerPartition = 0;
+
     // Only used when '_spilled' is false.
     GroupsMap::iterator groupsIterator;
 
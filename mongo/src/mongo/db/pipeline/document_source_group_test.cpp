@@ -28,6 +28,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <boost/intrusive_ptr.hpp>
 #include <deque>
 #include <map>
@@ -43,16 +44,21 @@
 #include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -139,6 +145,372 @@ TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoadingWhileSpilled) {
     ASSERT_EQ(idSet.count(2), 1UL);
 }
 
+/**
+ * Groups 'numIds' distinct, large _ids that each appear three times, with the given number of hash
+ * spill partitions, and checks that every group is returned exactly once with the right count.
+ */
+void assertHashSpilledGroupsAreComplete(const intrusive_ptr<ExpressionContextForTest>& expCtx,
+                                        int numPartitions,
+                                        int numIds) {
+    const int oldPartitions = internalDocumentSourceGroupHashSpillPartitions.load();
+    internalDocumentSourceGroupHashSpillPartitions.store(numPartitions);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupHashSpillPartitions.store(oldPartitions); });
+
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement countStatement{"count",
+                                         ExpressionConstant::create(expCtx, Value(1)),
+                                         AccumulationStatement::getFactory("$sum")};
+    auto group = DocumentSourceGroup::create(expCtx,
+                                             ExpressionFieldPath::parse(expCtx, "$key", vps),
+                                             {countStatement},
+                                             maxMemoryUsageBytes);
+
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < numIds; ++i) {
+            inputs.emplace_back(Document{{"key", std::to_string(i) + string(100, 'x')}});
+        }
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    group->setSource(mock.get());
+
+    map<int, int> counts;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_EQ(counts.count(std::stoi(doc["_id"].getString())), 0UL);
+        counts[std::stoi(doc["_id"].getString())] = doc["count"].coerceToInt();
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+
+    ASSERT_EQ(counts.size(), static_cast<size_t>(numIds));
+    for (auto&& count : counts) {
+        ASSERT_EQ(count.second, 3);
+    }
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldReturnAllGroupsAfterHashPartitionedSpill) {
+    assertHashSpilledGroupsAreComplete(getExpCtx(), 4, 100);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldFallBackToSortedSpillWhenHashPartitionIsTooLarge) {
+    // With a single partition, reloading it exceeds the memory limit again.
+    assertHashSpilledGroupsAreComplete(getExpCtx(), 1, 100);
+}
+
+/**
+ * Sums and averages 'numDocs' documents over 'numIds' distinct _ids using the given number of
+ * partial aggregation threads and checks every group's results. If 'inMongos' is true, the groups
+ * are built the way mongos merges them.
+ */
+void assertParallelGroupsAreComplete(const intrusive_ptr<ExpressionContextForTest>& expCtx,
+                                     int parallelism,
+                                     int numIds,
+                                     int numDocs,
+                                     size_t maxMemoryUsageBytes,
+                                     bool inMongos = false) {
+    auto& parallelismKnob = inMongos ? internalDocumentSourceGroupMongosParallelism
+                                     : internalDocumentSourceGroupParallelism;
+    const int oldParallelism = parallelismKnob.load();
+    parallelismKnob.store(parallelism);
+    ON_BLOCK_EXIT([&] { parallelismKnob.store(oldParallelism); });
+    expCtx->inMongos = inMongos;
+
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement sumStatement{"sum",
+                                       ExpressionFieldPath::parse(expCtx, "$value", vps),
+                                       AccumulationStatement::getFactory("$sum")};
+    AccumulationStatement avgStatement{"avg",
+                                       ExpressionFieldPath::parse(expCtx, "$value", vps),
+                                       AccumulationStatement::getFactory("$avg")};
+    auto group = DocumentSourceGroup::create(expCtx,
+                                             ExpressionFieldPath::parse(expCtx, "$key", vps),
+                                             {sumStatement, avgStatement},
+                                             maxMemoryUsageBytes);
+
+    deque<DocumentSource::GetNextResult> inputs;
+    map<int, std::pair<long long, long long>> expected;  // _id -> (sum, count)
+    for (int i = 0; i < numDocs; ++i) {
+        inputs.emplace_back(Document{{"key", i % numIds}, {"value", i}});
+        expected[i % numIds].first += i;
+        expected[i % numIds].second += 1;
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    group->setSource(mock.get());
+
+    map<int, Document> results;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_TRUE(results.emplace(doc["_id"].coerceToInt(), doc).second);
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+
+    ASSERT_EQ(results.size(), expected.size());
+    for (auto&& entry : expected) {
+        const Document& doc = results[entry.first];
+        ASSERT_EQ(doc["sum"].coerceToLong(), entry.second.first);
+        ASSERT_EQ(doc["avg"].coerceToDouble(),
+                  static_cast<double>(entry.second.first) / entry.second.second);
+    }
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldMergePartialGroupsBuiltInParallel) {
+    assertParallelGroupsAreComplete(
+        getExpCtx(), 4, 50, 10000, DocumentSourceGroup::kDefaultMaxMemoryUsageBytes);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldFinishSeriallyWhenParallelGroupsExceedMemoryLimit) {
+    assertParallelGroupsAreComplete(getExpCtx(), 4, 5000, 10000, 10 * 1024);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldReturnGroupsPartitionedAcrossThreadsOnMongos) {
+    assertParallelGroupsAreComplete(
+        getExpCtx(), 4, 500, 10000, DocumentSourceGroup::kDefaultMaxMemoryUsageBytes, true);
+}
+
+/**
+ * Groups 'numDocs' documents over 'numIds' distinct _ids with $first, $last and $push using the
+ * given number of partial aggregation threads, and checks that every group saw its documents in
+ * input order.
+ */
+void assertParallelGroupsKeepInputOrder(const intrusive_ptr<ExpressionContextForTest>& expCtx,
+                                        int parallelism,
+                                        int numIds,
+                                        int numDocs,
+                                        size_t maxMemoryUsageBytes) {
+    const int oldParallelism = internalDocumentSourceGroupParallelism.load();
+    internalDocumentSourceGroupParallelism.store(parallelism);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupParallelism.store(oldParallelism); });
+
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    std::vector<AccumulationStatement> accumulators;
+    for (auto&& op : {"$first", "$last", "$push"}) {
+        accumulators.push_back({StringData(op).substr(1).toString(),
+                                ExpressionFieldPath::parse(expCtx, "$value", vps),
+                                AccumulationStatement::getFactory(op)});
+    }
+    auto group = DocumentSourceGroup::create(expCtx,
+                                             ExpressionFieldPath::parse(expCtx, "$key", vps),
+                                             accumulators,
+                                             maxMemoryUsageBytes);
+
+    // The values of a group increase with their position in the input.
+    deque<DocumentSource::GetNextResult> inputs;
+    map<int, vector<Value>> expected;
+    for (int i = 0; i < numDocs; ++i) {
+        inputs.emplace_back(Document{{"key", i % numIds}, {"value", i}});
+        expected[i % numIds].push_back(Value(i));
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    group->setSource(mock.get());
+
+    map<int, Document> results;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_TRUE(results.emplace(doc["_id"].coerceToInt(), doc).second);
+    }
+
+    ASSERT_EQ(results.size(), expected.size());
+    for (auto&& entry : expected) {
+        const Document& doc = results[entry.first];
+        ASSERT_VALUE_EQ(doc["first"], entry.second.front());
+        ASSERT_VALUE_EQ(doc["last"], entry.second.back());
+        ASSERT_VALUE_EQ(doc["push"], Value(entry.second));
+    }
+}
+
+TEST_F(DocumentSourceGroupTest, ParallelGroupsAccumulateFirstLastAndPushInInputOrder) {
+    assertParallelGroupsKeepInputOrder(
+        getExpCtx(), 4, 10, 10000, DocumentSourceGroup::kDefaultMaxMemoryUsageBytes);
+}
+
+TEST_F(DocumentSourceGroupTest, ParallelGroupsKeepInputOrderWhenFinishingSerially) {
+    // The workers' groups outgrow the limit partway through, and the rest is aggregated here.
+    assertParallelGroupsKeepInputOrder(getExpCtx(), 4, 100, 10000, 200 * 1024);
+}
+
+TEST_F(DocumentSourceGroupTest, ParallelGroupsKeepInputOrderWithMoreThreadsThanGroups) {
+    // As after the $sort in the $sort + $group $first idiom, each group's $first is its smallest
+    // value.
+    assertParallelGroupsKeepInputOrder(
+        getExpCtx(), 8, 3, 3000, DocumentSourceGroup::kDefaultMaxMemoryUsageBytes);
+}
+
+/**
+ * Parses 'rawPipeline', optimizes it, feeds it 'inputs' and returns every output document keyed by
+ * its integer _id.
+ */
+map<int, Document> runOptimizedPipeline(const intrusive_ptr<ExpressionContextForTest>& expCtx,
+                                        const vector<BSONObj>& rawPipeline,
+                                        deque<DocumentSource::GetNextResult> inputs,
+                                        vector<Value>* serialized = nullptr) {
+    auto pipeline = uassertStatusOK(Pipeline::parse(rawPipeline, expCtx));
+    pipeline->optimizePipeline();
+    if (serialized) {
+        *serialized = pipeline->serialize();
+    }
+
+    auto sources = pipeline->getSources();
+    ASSERT_EQ(sources.size(), 1U);
+    ASSERT(dynamic_cast<DocumentSourceGroup*>(sources.front().get()));
+
+    pipeline->addInitialSource(DocumentSourceMock::create(std::move(inputs)));
+    map<int, Document> results;
+    while (auto doc = pipeline->getNext()) {
+        ASSERT_TRUE(results.emplace((*doc)["_id"].coerceToInt(), *doc).second);
+    }
+    return results;
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldAbsorbPrecedingUnwindAndSerializeBothStages) {
+    vector<BSONObj> rawPipeline{fromjson("{$unwind: '$arr'}"),
+                                fromjson("{$group: {_id: '$key', total: {$sum: '$arr'}}}")};
+    vector<Value> serialized;
+    auto results =
+        runOptimizedPipeline(getExpCtx(),
+                             rawPipeline,
+                             {Document{{"key", 1}, {"arr", BSON_ARRAY(1 << 2 << 3)}, {"x", 7}},
+                              Document{{"key", 2}, {"arr", BSONArray()}},
+                              Document{{"key", 1}, {"arr", 4}},
+                              Document{{"key", 2}, {"arr", BSON_ARRAY(5)}}},
+                             &serialized);
+
+    ASSERT_EQ(serialized.size(), 2U);
+    ASSERT_VALUE_EQ(serialized[0], Value(fromjson("{$unwind: {path: '$arr'}}")));
+    ASSERT_FALSE(serialized[1].getDocument()["$group"].missing());
+
+    ASSERT_EQ(results.size(), 2U);
+    ASSERT_EQ(results[1]["total"].coerceToInt(), 10);
+    ASSERT_EQ(results[2]["total"].coerceToInt(), 5);
+}
+
+TEST_F(DocumentSourceGroupTest, AbsorbedUnwindShouldOnlyDropFieldsTheGroupDoesNotRead) {
+    vector<BSONObj> rawPipeline{
+        fromjson("{$unwind: {path: '$a.arr', includeArrayIndex: 'idx'}}"),
+        fromjson("{$group: {_id: '$key', items: {$push: {v: '$a.arr', i: '$idx', o: '$a.o'}}}}")};
+    auto results = runOptimizedPipeline(
+        getExpCtx(),
+        rawPipeline,
+        {Document{{"key", 1}, {"a", Document{{"arr", BSON_ARRAY(8 << 9)}, {"o", 3}}}, {"x", 7}}});
+
+    ASSERT_EQ(results.size(), 1U);
+    ASSERT_VALUE_EQ(results[1]["items"],
+                    Value(BSON_ARRAY(BSON("v" << 8 << "i" << 0 << "o" << 3)
+                                     << BSON("v" << 9 << "i" << 1 << "o" << 3))));
+}
+
+TEST_F(DocumentSourceGroupTest, AbsorbedUnwindShouldKeepWholeDocumentWhenGroupReadsRoot) {
+    vector<BSONObj> rawPipeline{fromjson("{$unwind: '$arr'}"),
+                                fromjson("{$group: {_id: '$key', docs: {$push: '$$ROOT'}}}")};
+    auto results = runOptimizedPipeline(
+        getExpCtx(), rawPipeline, {Document{{"key", 1}, {"arr", BSON_ARRAY(1 << 2)}, {"x", 7}}});
+
+    ASSERT_EQ(results.size(), 1U);
+    ASSERT_VALUE_EQ(results[1]["docs"],
+                    Value(BSON_ARRAY(BSON("key" << 1 << "arr" << 1 << "x" << 7)
+                                     << BSON("key" << 1 << "arr" << 2 << "x" << 7))));
+}
+
+/**
+ * Groups 'inputs' by their "key" field, counting each group, and returns the groups sorted by _id.
+ */
+vector<Document> countByKey(const intrusive_ptr<ExpressionContextForTest>& expCtx,
+                            const deque<DocumentSource::GetNextResult>& inputs) {
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement countStatement{"count",
+                                         ExpressionConstant::create(expCtx, Value(1)),
+                                         AccumulationStatement::getFactory("$sum")};
+    auto group = DocumentSourceGroup::create(
+        expCtx, ExpressionFieldPath::parse(expCtx, "$key", vps), {countStatement});
+    auto mock = DocumentSourceMock::create(inputs);
+    group->setSource(mock.get());
+
+    vector<Document> results;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        results.push_back(result.releaseDocument());
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+
+    std::sort(results.begin(), results.end(), [&](const Document& lhs, const Document& rhs) {
+        return expCtx->getValueComparator().evaluate(lhs["_id"] < rhs["_id"]);
+    });
+    return results;
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldGroupEqualNumericKeysOfDifferentTypesTogether) {
+    auto results = countByKey(getExpCtx(),
+                              {Document{{"key", 1}},
+                               Document{{"key", 1LL}},
+                               Document{{"key", 2.0}},
+                               Document{{"key", 1.0}},
+                               Document{{"key", 2LL}},
+                               Document{{"key", 1}},
+                               Document{{"key", 2}},
+                               Document{{"key", 3.5}}});
+    ASSERT_EQ(results.size(), 3UL);
+    ASSERT_VALUE_EQ(results[0]["_id"], Value(1));
+    ASSERT_VALUE_EQ(results[0]["count"], Value(4));
+    ASSERT_VALUE_EQ(results[1]["_id"], Value(2));
+    ASSERT_VALUE_EQ(results[1]["count"], Value(3));
+    ASSERT_VALUE_EQ(results[2]["_id"], Value(3.5));
+    ASSERT_VALUE_EQ(results[2]["count"], Value(1));
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldGroupManyDistinctStringAndObjectIdKeys) {
+    const int numKeys = 1000;
+    vector<OID> oids;
+    for (int i = 0; i < numKeys; ++i) {
+        oids.push_back(OID::gen());
+    }
+
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < numKeys; ++i) {
+            inputs.emplace_back(Document{{"key", std::to_string(i)}});
+            inputs.emplace_back(Document{{"key", oids[i]}});
+        }
+    }
+    // Neither a missing key nor a string differing only by an embedded NUL joins another group.
+    inputs.emplace_back(Document{});
+    inputs.emplace_back(Document{{"key", StringData("1\0", 2)}});
+
+    auto results = countByKey(getExpCtx(), inputs);
+    ASSERT_EQ(results.size(), static_cast<size_t>(2 * numKeys + 2));
+    for (auto&& result : results) {
+        const bool isExtraKey = result["_id"].nullish() ||
+            (result["_id"].getType() == String && result["_id"].getString().size() == 2 &&
+             result["_id"].getString()[1] == '\0');
+        ASSERT_VALUE_EQ(result["count"], Value(isExtraKey ? 1 : 2));
+    }
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldGroupStringKeysUsingTheCollation) {
+    auto expCtx = getExpCtx();
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    expCtx->setCollator(&collator);
+
+    auto results = countByKey(expCtx,
+                              {Document{{"key", "abc"_sd}},
+                               Document{{"key", "ABC"_sd}},
+                               Document{{"key", "xyz"_sd}},
+                               Document{{"key", "aBc"_sd}}});
+    ASSERT_EQ(results.size(), 2UL);
+    ASSERT_VALUE_EQ(results[0]["count"], Value(3));
+    ASSERT_VALUE_EQ(results[1]["count"], Value(1));
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
     const size_t maxMemoryUsageBytes = 1000;
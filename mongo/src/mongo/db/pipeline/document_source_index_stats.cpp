@@ -63,6 +63,25 @@ DocumentSource::GetNextResult DocumentSourceIndexStats::getNext() {
         doc["host"] = Value(_processName);
         doc["accesses"]["ops"] = Value(stats.accesses.loadRelaxed());
         doc["accesses"]["since"] = Value(stats.trackerStartTime);
+
+        const auto docsReturned = stats.docsReturned.loadRelaxed();
+        doc["reads"]["keysExamined"] = Value(stats.keysExamined.loadRelaxed());
+        doc["reads"]["seeks"] = Value(stats.seeks.loadRelaxed());
+        doc["reads"]["docsReturned"] = Value(docsReturned);
+        if (docsReturned > 0) {
+            // Read amplification: how many keys had to be looked at per document returned.
+            doc["reads"]["keysExaminedPerDocReturned"] =
+                Value(static_cast<double>(stats.keysExamined.loadRelaxed()) / docsReturned);
+        }
+
+        doc["writes"]["ops"] = Value(stats.writeOps.loadRelaxed());
+        doc["writes"]["keysInserted"] = Value(stats.keysInserted.loadRelaxed());
+        doc["writes"]["keysDeleted"] = Value(stats.keysDeleted.loadRelaxed());
+        doc["writes"]["micros"] = Value(stats.writeMicros.loadRelaxed());
+
+        if (stats.cacheBytes) {
+            doc["cacheBytes"] = Value(*stats.cacheBytes);
+        }
         ++_indexStatsIter;
         return doc.freeze();
     }
@@ -0,0 +1,248 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+REGISTER_DOCUMENT_SOURCE(_internalUnpackBucket,
+                         LiteParsedDocumentSourceDefault::parse,
+                         DocumentSourceInternalUnpackBucket::createFromBson);
+
+constexpr StringData DocumentSourceInternalUnpackBucket::kStageName;
+constexpr StringData DocumentSourceInternalUnpackBucket::kBucketMetaFieldName;
+constexpr StringData DocumentSourceInternalUnpackBucket::kBucketControlFieldName;
+constexpr StringData DocumentSourceInternalUnpackBucket::kBucketDataFieldName;
+
+DocumentSourceInternalUnpackBucket::DocumentSourceInternalUnpackBucket(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    std::string timeField,
+    boost::optional<std::string> metaField)
+    : DocumentSource(expCtx), _timeField(std::move(timeField)), _metaField(std::move(metaField)) {}
+
+boost::intrusive_ptr<DocumentSource> DocumentSourceInternalUnpackBucket::createFromBson(
+    BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    uassert(ErrorCodes::TypeMismatch,
+            str::stream() << kStageName << " must take a nested object but found: " << elem,
+            elem.type() == BSONType::Object);
+
+    std::string timeField;
+    boost::optional<std::string> metaField;
+    for (auto&& subElem : elem.embeddedObject()) {
+        const auto fieldName = subElem.fieldNameStringData();
+        if (fieldName == "timeField" || fieldName == "metaField") {
+            uassert(50791,
+                    str::stream() << kStageName << " requires '" << fieldName
+                                  << "' to be a non-empty top-level field name, got: "
+                                  << subElem,
+                    subElem.type() == BSONType::String && !subElem.valueStringData().empty() &&
+                        subElem.valueStringData().find('.') == std::string::npos &&
+                        subElem.valueStringData()[0] != '$');
+            if (fieldName == "timeField") {
+                timeField = subElem.str();
+            } else {
+                metaField = subElem.str();
+            }
+        } else {
+            uasserted(50792,
+                      str::stream() << "unrecognized option to " << kStageName << ": "
+                                    << fieldName);
+        }
+    }
+    uassert(50793, str::stream() << kStageName << " requires a 'timeField'", !timeField.empty());
+    uassert(50794,
+            str::stream() << kStageName << " requires 'timeField' and 'metaField' to differ",
+            !metaField || *metaField != timeField);
+
+    return new DocumentSourceInternalUnpackBucket(expCtx, std::move(timeField), metaField);
+}
+
+DocumentSource::GetNextResult DocumentSourceInternalUnpackBucket::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    while (_bucketData.missing() || _nextMeasurement >= _bucketData.getArrayLength()) {
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            return nextInput;
+        }
+
+        const Document bucket = nextInput.releaseDocument();
+        _bucketMeta = bucket[kBucketMetaFieldName];
+        _bucketData = bucket[kBucketDataFieldName];
+        _nextMeasurement = 0;
+        uassert(50795,
+                str::stream() << kStageName << " requires the '" << kBucketDataFieldName
+                              << "' field of a bucket to be an array, but found: "
+                              << _bucketData.toString(),
+                _bucketData.getType() == BSONType::Array);
+    }
+
+    const Value& measurement = _bucketData.getArray()[_nextMeasurement++];
+    uassert(50796,
+            str::stream() << kStageName << " requires measurements to be objects, but found: "
+                          << measurement.toString(),
+            measurement.getType() == BSONType::Object);
+
+    MutableDocument output(measurement.getDocument());
+    if (_metaField) {
+        // The meta field always comes from the bucket, so that predicates on it mean the same
+        // thing before and after unpacking.
+        if (_bucketMeta.missing()) {
+            output.remove(*_metaField);
+        } else {
+            output.setField(*_metaField, _bucketMeta);
+        }
+    }
+    return output.freeze();
+}
+
+DocumentSource::GetDepsReturn DocumentSourceInternalUnpackBucket::getDependencies(
+    DepsTracker* deps) const {
+    deps->fields.insert(kBucketDataFieldName.toString());
+    if (_metaField) {
+        deps->fields.insert(kBucketMetaFieldName.toString());
+    }
+    return EXHAUSTIVE_FIELDS;
+}
+
+void DocumentSourceInternalUnpackBucket::appendBucketPredicates(
+    const BSONElement& elem, BSONArrayBuilder* bucketPredicates) const {
+    const auto fieldName = elem.fieldNameStringData();
+
+    if (fieldName == "$and" && elem.type() == BSONType::Array) {
+        for (auto&& conjunct : elem.embeddedObject()) {
+            if (conjunct.type() == BSONType::Object) {
+                for (auto&& conjunctElem : conjunct.embeddedObject()) {
+                    appendBucketPredicates(conjunctElem, bucketPredicates);
+                }
+            }
+        }
+        return;
+    }
+
+    if (_metaField && (fieldName == *_metaField || fieldName.startsWith(*_metaField + "."))) {
+        const std::string bucketPath =
+            kBucketMetaFieldName.toString() + fieldName.substr(_metaField->size()).toString();
+        BSONObjBuilder predicate(bucketPredicates->subobjStart());
+        predicate.appendAs(elem, bucketPath);
+        return;
+    }
+
+    if (fieldName != _timeField) {
+        return;
+    }
+
+    const std::string minPath = str::stream() << kBucketControlFieldName << ".min." << _timeField;
+    const std::string maxPath = str::stream() << kBucketControlFieldName << ".max." << _timeField;
+    auto appendBound = [&](const std::string& path, StringData op, const BSONElement& date) {
+        BSONObjBuilder predicate(bucketPredicates->subobjStart());
+        BSONObjBuilder comparison(predicate.subobjStart(path));
+        comparison.appendAs(date, op);
+    };
+
+    // The control fields bound the times in the bucket, so a bucket can hold a measurement later
+    // than T only if its maximum is, and one earlier than T only if its minimum is.
+    if (elem.type() == BSONType::Date) {
+        appendBound(minPath, "$lte", elem);
+        appendBound(maxPath, "$gte", elem);
+        return;
+    }
+    if (elem.type() != BSONType::Object ||
+        elem.embeddedObject().firstElementFieldName()[0] != '$') {
+        return;
+    }
+    for (auto&& comparison : elem.embeddedObject()) {
+        if (comparison.type() != BSONType::Date) {
+            continue;
+        }
+        const auto op = comparison.fieldNameStringData();
+        if (op == "$gt" || op == "$gte") {
+            appendBound(maxPath, op, comparison);
+        } else if (op == "$lt" || op == "$lte") {
+            appendBound(minPath, op, comparison);
+        } else if (op == "$eq") {
+            appendBound(minPath, "$lte", comparison);
+            appendBound(maxPath, "$gte", comparison);
+        }
+    }
+}
+
+BSONObj DocumentSourceInternalUnpackBucket::makeBucketFilter(
+    const BSONObj& measurementFilter) const {
+    BSONArrayBuilder bucketPredicates;
+    for (auto&& elem : measurementFilter) {
+        appendBucketPredicates(elem, &bucketPredicates);
+    }
+    if (bucketPredicates.arrSize() == 0) {
+        return BSONObj();
+    }
+    return BSON("$and" << bucketPredicates.arr());
+}
+
+Pipeline::SourceContainer::iterator DocumentSourceInternalUnpackBucket::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    auto nextMatch = dynamic_cast<DocumentSourceMatch*>((*std::next(itr)).get());
+    if (_addedBucketFilter || !nextMatch || nextMatch->isTextQuery()) {
+        return std::next(itr);
+    }
+
+    _addedBucketFilter = true;
+    BSONObj bucketFilter = makeBucketFilter(nextMatch->getQuery());
+    if (bucketFilter.isEmpty()) {
+        return std::next(itr);
+    }
+
+    // Keep the original $match after this stage: the bucket filter is only implied by it.
+    container->insert(itr, DocumentSourceMatch::create(bucketFilter, pExpCtx));
+
+    // The stage before the new $match may be able to optimize further, if there is such a stage.
+    return std::prev(itr) == container->begin() ? std::prev(itr) : std::prev(std::prev(itr));
+}
+
+Value DocumentSourceInternalUnpackBucket::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    MutableDocument spec;
+    spec["timeField"] = Value(_timeField);
+    if (_metaField) {
+        spec["metaField"] = Value(*_metaField);
+    }
+    return Value(Document{{getSourceName(), spec.freeze()}});
+}
+
+}  // namespace mongo
@@ -0,0 +1,125 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <string>
+
+#include "mongo/db/pipeline/document_source.h"
+
+namespace mongo {
+
+/**
+ * Turns bucket documents, each holding a batch of time-series measurements, back into one
+ * document per measurement. A bucket has the form
+ *
+ *     {_id: ..., meta: <value>,
+ *      control: {min: {<timeField>: <date>}, max: {<timeField>: <date>}},
+ *      data: [<measurement>, ...]}
+ *
+ * where 'control' holds the earliest and latest time of the measurements in 'data'. If the stage
+ * has a 'metaField', each measurement is returned with the bucket's 'meta' value in that field.
+ *
+ * Storing many small measurements per document spreads the per-document and per-index-entry
+ * overhead over the whole bucket, and lets block compression work across measurements. A view
+ * whose pipeline starts with this stage presents such a collection as individual measurements.
+ * A $match which follows the stage is used to filter whole buckets before they are unpacked.
+ */
+class DocumentSourceInternalUnpackBucket final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalUnpackBucket"_sd;
+    static constexpr StringData kBucketMetaFieldName = "meta"_sd;
+    static constexpr StringData kBucketControlFieldName = "control"_sd;
+    static constexpr StringData kBucketDataFieldName = "data"_sd;
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    DocumentSourceInternalUnpackBucket(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                       std::string timeField,
+                                       boost::optional<std::string> metaField);
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        return {StreamType::kStreaming,
+                PositionRequirement::kNone,
+                HostTypeRequirement::kNone,
+                DiskUseRequirement::kNoDiskUse,
+                FacetRequirement::kAllowed};
+    }
+
+    GetNextResult getNext() final;
+
+    GetDepsReturn getDependencies(DepsTracker* deps) const final;
+
+    GetModPathsReturn getModifiedPaths() const final {
+        return {GetModPathsReturn::Type::kAllPaths, std::set<std::string>{}, {}};
+    }
+
+    /**
+     * Returns a filter on bucket documents which every bucket holding a measurement that matches
+     * 'measurementFilter' satisfies, or an empty object if no such filter can be derived.
+     * Comparisons of the time field with dates become comparisons with the bucket's control
+     * bounds, and predicates on the meta field become predicates on the bucket's 'meta' field.
+     */
+    BSONObj makeBucketFilter(const BSONObj& measurementFilter) const;
+
+protected:
+    /**
+     * If followed by a $match, puts a $match on the buckets in front of this stage.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
+private:
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    /**
+     * Appends to 'bucketPredicates' the bucket-level predicates implied by the measurement-level
+     * predicate 'elem'.
+     */
+    void appendBucketPredicates(const BSONElement& elem, BSONArrayBuilder* bucketPredicates) const;
+
+    const std::string _timeField;
+    const boost::optional<std::string> _metaField;
+
+    // Set once a bucket-level $match has been derived from the following $match, so that it is
+    // not added again when the optimizer revisits this stage.
+    bool _addedBucketFilter = false;
+
+    // The bucket being unpacked.
+    Value _bucketMeta;
+    Value _bucketData;
+    size_t _nextMeasurement = 0;
+};
+
+}  // namespace mongo
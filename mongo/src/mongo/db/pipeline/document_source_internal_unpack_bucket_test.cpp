@@ -0,0 +1,146 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/json.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+#include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using InternalUnpackBucketTest = AggregationContextFixture;
+
+boost::intrusive_ptr<DocumentSourceInternalUnpackBucket> createUnpack(
+    const BSONObj& spec, const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    auto stage = DocumentSourceInternalUnpackBucket::createFromBson(
+        BSON("$_internalUnpackBucket" << spec).firstElement(), expCtx);
+    return static_cast<DocumentSourceInternalUnpackBucket*>(stage.get());
+}
+
+TEST_F(InternalUnpackBucketTest, UnpacksMeasurementsAndAddsMetaField) {
+    auto unpack = createUnpack(fromjson("{timeField: 't', metaField: 'sensor'}"), getExpCtx());
+    auto mock = DocumentSourceMock::create(
+        {"{_id: 1, meta: {id: 'a'}, data: [{t: 1, v: 10}, {t: 2, v: 20, sensor: 'x'}]}",
+         "{_id: 2, meta: {id: 'b'}, data: []}",
+         "{_id: 3, data: [{t: 3, v: 30, sensor: 'y'}]}"});
+    unpack->setSource(mock.get());
+
+    auto next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       Document(fromjson("{t: 1, v: 10, sensor: {id: 'a'}}")));
+
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       Document(fromjson("{t: 2, v: 20, sensor: {id: 'a'}}")));
+
+    // Empty buckets produce nothing, and a bucket without a meta value clears the meta field.
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), Document(fromjson("{t: 3, v: 30}")));
+
+    ASSERT_TRUE(unpack->getNext().isEOF());
+    ASSERT_TRUE(unpack->getNext().isEOF());
+}
+
+TEST_F(InternalUnpackBucketTest, RejectsBucketsWithoutDataArray) {
+    auto unpack = createUnpack(fromjson("{timeField: 't'}"), getExpCtx());
+    auto mock = DocumentSourceMock::create({"{_id: 1, data: {t: 1}}"});
+    unpack->setSource(mock.get());
+    ASSERT_THROWS_CODE(unpack->getNext(), AssertionException, 50795);
+}
+
+TEST_F(InternalUnpackBucketTest, RejectsInvalidSpecifications) {
+    ASSERT_THROWS_CODE(
+        createUnpack(fromjson("{metaField: 'm'}"), getExpCtx()), AssertionException, 50793);
+    ASSERT_THROWS_CODE(
+        createUnpack(fromjson("{timeField: 'a.b'}"), getExpCtx()), AssertionException, 50791);
+    ASSERT_THROWS_CODE(createUnpack(fromjson("{timeField: 't', other: 1}"), getExpCtx()),
+                       AssertionException,
+                       50792);
+    ASSERT_THROWS_CODE(createUnpack(fromjson("{timeField: 't', metaField: 't'}"), getExpCtx()),
+                       AssertionException,
+                       50794);
+}
+
+TEST_F(InternalUnpackBucketTest, MapsTimeAndMetaPredicatesToBuckets) {
+    auto unpack = createUnpack(fromjson("{timeField: 't', metaField: 'm'}"), getExpCtx());
+    const Date_t lower = Date_t::fromMillisSinceEpoch(1000);
+    const Date_t upper = Date_t::fromMillisSinceEpoch(2000);
+
+    ASSERT_BSONOBJ_EQ(
+        unpack->makeBucketFilter(BSON("t" << BSON("$gte" << lower << "$lt" << upper) << "m.id"
+                                          << "a"
+                                          << "v"
+                                          << BSON("$gt" << 5))),
+        BSON("$and" << BSON_ARRAY(BSON("control.max.t" << BSON("$gte" << lower))
+                                  << BSON("control.min.t" << BSON("$lt" << upper))
+                                  << BSON("meta.id"
+                                          << "a"))));
+
+    ASSERT_BSONOBJ_EQ(
+        unpack->makeBucketFilter(BSON("$and" << BSON_ARRAY(BSON("t" << lower)))),
+        BSON("$and" << BSON_ARRAY(BSON("control.min.t" << BSON("$lte" << lower))
+                                  << BSON("control.max.t" << BSON("$gte" << lower)))));
+
+    // Only comparisons with dates can be checked against the control bounds.
+    ASSERT_BSONOBJ_EQ(unpack->makeBucketFilter(fromjson("{t: {$gt: 5}, v: 1}")), BSONObj());
+}
+
+TEST_F(InternalUnpackBucketTest, OptimizeAddsBucketFilterOnce) {
+    auto unpack = createUnpack(fromjson("{timeField: 't', metaField: 'm'}"), getExpCtx());
+    auto match = DocumentSourceMatch::create(fromjson("{m: 'a', v: 1}"), getExpCtx());
+
+    Pipeline::SourceContainer container;
+    container.push_back(unpack);
+    container.push_back(match);
+
+    unpack->optimizeAt(container.begin(), &container);
+    ASSERT_EQUALS(container.size(), 3U);
+    auto bucketMatch = dynamic_cast<DocumentSourceMatch*>(container.front().get());
+    ASSERT(bucketMatch);
+    ASSERT_BSONOBJ_EQ(bucketMatch->getQuery(), fromjson("{$and: [{meta: 'a'}]}"));
+    ASSERT_EQUALS(container.back().get(), match.get());
+
+    unpack->optimizeAt(std::next(container.begin(), 1), &container);
+    ASSERT_EQUALS(container.size(), 3U);
+}
+
+}  // namespace
+}  // namespace mongo
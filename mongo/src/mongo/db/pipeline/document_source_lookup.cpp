@@ -30,9 +30,13 @@
 
 #include "mongo/db/pipeline/document_source_lookup.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "mongo/base/init.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_algo.h"
+#include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/expression.h"
@@ -95,6 +99,17 @@ DocumentSourceLookUp::DocumentSourceLookUp(NamespaceString fromNs,
     : DocumentSourceLookUp(fromNs, as, pExpCtx) {
     _localField = std::move(localField);
     _foreignField = std::move(foreignField);
+
+    const auto& colocatedKeys = pExpCtx->getResolvedNamespace(_fromNs).colocatedShardKeyFields;
+    if (colocatedKeys) {
+        uassert(28769,
+                str::stream() << _fromNs.ns() << " cannot be sharded unless $lookup joins the "
+                              << "shard key of the aggregated collection to its shard key",
+                pExpCtx->subPipelineDepth == 0 &&
+                    _localField->fullPath() == colocatedKeys->first &&
+                    _foreignField->fullPath() == colocatedKeys->second);
+        _colocated = true;
+    }
     // We append an additional BSONObj to '_resolvedPipeline' as a placeholder for the $match stage
     // we'll eventually construct from the input document.
     _resolvedPipeline.reserve(_resolvedPipeline.size() + 1);
@@ -107,6 +122,10 @@ DocumentSourceLookUp::DocumentSourceLookUp(NamespaceString fromNs,
                                            BSONObj letVariables,
                                            const boost::intrusive_ptr<ExpressionContext>& pExpCtx)
     : DocumentSourceLookUp(fromNs, as, pExpCtx) {
+    uassert(28769,
+            str::stream() << _fromNs.ns() << " cannot be sharded",
+            !pExpCtx->getResolvedNamespace(_fromNs).colocatedShardKeyFields);
+
     // '_resolvedPipeline' will first be initialized by the constructor delegated to within this
     // constructor's initializer list. It will be populated with view pipeline prefix if 'fromNs'
     // represents a view. We append the user 'pipeline' to the end of '_resolvedPipeline' to ensure
@@ -210,7 +229,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
         return unwindResult();
     }
 
-    auto nextInput = pSource->getNext();
+    auto nextInput = getNextInput();
     if (!nextInput.isAdvanced()) {
         return nextInput;
     }
@@ -228,20 +247,33 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
         _resolvedPipeline.back() = matchStage;
     }
 
-    auto pipeline = buildPipeline(inputDoc);
-
     std::vector<Value> results;
     int objsize = 0;
-
-    while (auto result = pipeline->getNext()) {
-        objsize += result->getApproximateSize();
+    const auto addResult = [&](Document result) {
+        objsize += result.getApproximateSize();
         uassert(4568,
                 str::stream() << "Total size of documents in " << _fromNs.coll()
                               << " matching pipeline "
                               << getUserPipelineDefinition()
                               << " exceeds maximum document size",
                 objsize <= BSONObjMaxInternalSize);
-        results.emplace_back(std::move(*result));
+        results.emplace_back(std::move(result));
+    };
+
+    if (useHashJoin()) {
+        for (auto&& result : joinFromTable(*_hashTable, inputDoc)) {
+            addResult(std::move(result));
+        }
+    } else if (useBatchedProbes()) {
+        for (auto&& result : _probedMatches) {
+            addResult(std::move(result));
+        }
+        _probedMatches.clear();
+    } else {
+        auto pipeline = buildPipeline(inputDoc);
+        while (auto result = pipeline->getNext()) {
+            addResult(std::move(*result));
+        }
     }
 
     MutableDocument output(std::move(inputDoc));
@@ -251,6 +283,8 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
 
 std::unique_ptr<Pipeline, Pipeline::Deleter> DocumentSourceLookUp::buildPipeline(
     const Document& inputDoc) {
+    checkColocatedForeignCollection();
+
     // Copy all 'let' variables into the foreign pipeline's expression context.
     copyVariablesToExpCtx(_variables, _variablesParseState, _fromExpCtx.get());
 
@@ -298,6 +332,225 @@ std::unique_ptr<Pipeline, Pipeline::Deleter> DocumentSourceLookUp::buildPipeline
     return pipeline;
 }
 
+bool DocumentSourceLookUp::useHashJoin() {
+    if (_joinStrategyChosen) {
+        return static_cast<bool>(_hashTable);
+    }
+    _joinStrategyChosen = true;
+
+    const long long maxSizeBytes = internalDocumentSourceLookupHashJoinMaxBytes.load();
+
+    // A view's pipeline has to run over the foreign documents before they can be joined.
+    if (wasConstructedWithPipelineSyntax() || maxSizeBytes <= 0 ||
+        _resolvedPipeline.size() != 1) {
+        return false;
+    }
+
+    BSONObjBuilder storageStats;
+    if (!_mongoProcessInterface->appendStorageStats(_resolvedNs, BSONObj(), &storageStats)
+             .isOK()) {
+        return false;
+    }
+    const auto dataSize = storageStats.obj()["size"];
+    if (!dataSize.isNumber() || dataSize.safeNumberLong() > maxSizeBytes) {
+        return false;
+    }
+
+    _hashTable.emplace(_fromExpCtx->getValueComparator(), *_foreignField, maxSizeBytes);
+
+    // Any $match absorbed along with an $unwind applies to every input document alike, so it can
+    // already be applied while loading the table.
+    checkColocatedForeignCollection();
+    copyVariablesToExpCtx(_variables, _variablesParseState, _fromExpCtx.get());
+    auto pipeline = uassertStatusOK(_mongoProcessInterface->makePipeline(
+        {BSON("$match" << _additionalFilter.value_or(BSONObj()))}, _fromExpCtx));
+    while (auto foreignDoc = pipeline->getNext()) {
+        if (!_hashTable->add(foreignDoc->toBson())) {
+            // The storage stats underestimated the collection. Query per document instead.
+            _hashTable.reset();
+            break;
+        }
+    }
+    return static_cast<bool>(_hashTable);
+}
+
+void DocumentSourceLookUp::checkColocatedForeignCollection() {
+    // Only a request from mongos can have been found co-located there, and a view's pipeline may
+    // rewrite the joined field.
+    if (!pExpCtx->fromMongos || wasConstructedWithPipelineSyntax() ||
+        _resolvedPipeline.size() != 1 ||
+        (_colocationChecked && _colocatedForeignVersion.isEmpty())) {
+        return;
+    }
+
+    if (!_colocationChecked) {
+        // Read the local version first, so that a migration which races with the co-location
+        // check is caught by the comparison on the next call.
+        const BSONObj localVersion =
+            _mongoProcessInterface->getShardedCollectionVersion(pExpCtx->ns);
+        const BSONObj foreignVersion = _mongoProcessInterface->getColocatedCollectionVersion(
+            pExpCtx->ns, _localField->fullPath(), _resolvedNs, _foreignField->fullPath());
+        _colocationChecked = true;
+        if (!foreignVersion.isEmpty()) {
+            _colocatedLocalVersion = localVersion.getOwned();
+            _colocatedForeignVersion = foreignVersion.getOwned();
+        }
+        _fromExpCtx->allowShardedCollection = !foreignVersion.isEmpty();
+        return;
+    }
+
+    uassert(ErrorCodes::StaleShardVersion,
+            str::stream() << "chunks of " << pExpCtx->ns.ns()
+                          << " changed while $lookup was joining against "
+                          << _resolvedNs.ns(),
+            _mongoProcessInterface->getShardedCollectionVersion(pExpCtx->ns)
+                .binaryEqual(_colocatedLocalVersion));
+    uassert(ErrorCodes::StaleShardVersion,
+            str::stream() << "chunks of " << _resolvedNs.ns()
+                          << " changed while $lookup was joining against them",
+            _mongoProcessInterface->getShardedCollectionVersion(_resolvedNs)
+                .binaryEqual(_colocatedForeignVersion));
+}
+
+bool DocumentSourceLookUp::useBatchedProbes() {
+    if (_probeStrategyChosen) {
+        return _probeBatchSize > 0;
+    }
+    _probeStrategyChosen = true;
+
+    const int batchSize = internalDocumentSourceLookupProbeBatchSize.load();
+    if (batchSize <= 1 || wasConstructedWithPipelineSyntax() || _resolvedPipeline.size() != 1 ||
+        useHashJoin()) {
+        return false;
+    }
+
+    // Without an index on 'foreignField' each query is a collection scan, so combining them saves
+    // little and makes every scan's result set larger.
+    const auto indexes = _mongoProcessInterface->getIndexStats(pExpCtx->opCtx, _resolvedNs);
+    const bool hasForeignFieldIndex =
+        std::any_of(indexes.begin(), indexes.end(), [&](const auto& index) {
+            const BSONElement firstKey = index.second.indexKey.firstElement();
+            return firstKey.fieldNameStringData() == _foreignField->fullPath() &&
+                (firstKey.isNumber() || firstKey.valueStringData() == "hashed");
+        });
+    if (!hasForeignFieldIndex) {
+        return false;
+    }
+
+    _probeBatchSize = batchSize;
+    return true;
+}
+
+DocumentSource::GetNextResult DocumentSourceLookUp::getNextInput() {
+    if (!useBatchedProbes()) {
+        return pSource->getNext();
+    }
+
+    if (_probedInputs.empty()) {
+        if (!_pendingInputResult) {
+            probeNextBatch();
+        }
+        if (_probedInputs.empty()) {
+            auto result = std::move(*_pendingInputResult);
+            _pendingInputResult = boost::none;
+            return result;
+        }
+    }
+
+    Document input = std::move(_probedInputs.front().first);
+    _probedMatches = std::move(_probedInputs.front().second);
+    _probedInputs.pop_front();
+    return std::move(input);
+}
+
+void DocumentSourceLookUp::probeNextBatch() {
+    std::vector<Document> batch;
+    while (batch.size() < _probeBatchSize) {
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            _pendingInputResult = std::move(nextInput);
+            break;
+        }
+        batch.push_back(nextInput.releaseDocument());
+    }
+    if (batch.empty()) {
+        return;
+    }
+
+    // Gather the distinct local values of the whole batch. Missing values are joined as null.
+    auto seen = _fromExpCtx->getValueComparator().makeUnorderedValueSet();
+    std::vector<Value> localValues;
+    const auto addLocalValue = [&](const Value& value) {
+        if (seen.insert(value).second) {
+            localValues.push_back(value);
+        }
+    };
+    for (auto&& input : batch) {
+        bool found = false;
+        document_path_support::visitAllValuesAtPath(input, *_localField, [&](const Value& value) {
+            found = true;
+            addLocalValue(value);
+        });
+        if (!found) {
+            addLocalValue(Value(BSONNULL));
+        }
+    }
+
+    // makeMatchStageFromInput() expands the array at the end of the path into its elements, which
+    // turns the batch's values into a single $in (or $or, if there are regexes) query.
+    const Document probe{{"values", Value(std::move(localValues))}};
+    _resolvedPipeline.back() = makeMatchStageFromInput(probe,
+                                                       FieldPath("values"),
+                                                       _foreignField->fullPath(),
+                                                       _additionalFilter.value_or(BSONObj()));
+
+    LookupHashTable table(_fromExpCtx->getValueComparator(),
+                          *_foreignField,
+                          std::numeric_limits<size_t>::max());
+    auto pipeline = buildPipeline(batch.front());
+    while (auto foreignDoc = pipeline->getNext()) {
+        table.add(foreignDoc->toBson());
+    }
+
+    for (auto&& input : batch) {
+        auto matches = joinFromTable(table, input);
+        _probedInputs.emplace_back(std::move(input), std::move(matches));
+    }
+}
+
+std::deque<Document> DocumentSourceLookUp::joinFromTable(const LookupHashTable& table,
+                                                         const Document& input) {
+    const BSONObj matchStage = makeMatchStageFromInput(
+        input, *_localField, _foreignField->fullPath(), _additionalFilter.value_or(BSONObj()));
+    const auto matcher = uassertStatusOK(
+        MatchExpressionParser::parse(matchStage.firstElement().Obj(), _fromExpCtx));
+
+    std::vector<Value> localValues;
+    document_path_support::visitAllValuesAtPath(
+        input, *_localField, [&](const Value& value) { localValues.push_back(value); });
+
+    std::deque<Document> matches;
+    for (auto&& position : table.candidates(localValues)) {
+        const BSONObj& foreignDoc = table.document(position);
+        if (matcher->matchesBSON(foreignDoc)) {
+            matches.emplace_back(foreignDoc);
+        }
+    }
+    return matches;
+}
+
+boost::optional<Document> DocumentSourceLookUp::nextUnwindMatch() {
+    if (!_hashTable && !_probeBatchSize) {
+        return _pipeline->getNext();
+    }
+    if (_hashJoinMatches.empty()) {
+        return boost::none;
+    }
+    Document next = std::move(_hashJoinMatches.front());
+    _hashJoinMatches.pop_front();
+    return next;
+}
+
 DocumentSource::GetModPathsReturn DocumentSourceLookUp::getModifiedPaths() const {
     std::set<std::string> modifiedPaths{_as.fullPath()};
     if (_unwindSrc) {
@@ -436,6 +689,10 @@ void DocumentSourceLookUp::doDispose() {
         _pipeline->dispose(pExpCtx->opCtx);
         _pipeline.reset();
     }
+    _hashJoinMatches.clear();
+    _hashTable.reset();
+    _probedInputs.clear();
+    _probedMatches.clear();
 }
 
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
@@ -528,8 +785,8 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     // Loop until we get a document that has at least one match.
     // Note we may return early from this loop if our source stage is exhausted or if the unwind
     // source was asked to return empty arrays and we get a document without a match.
-    while (!_pipeline || !_nextValue) {
-        auto nextInput = pSource->getNext();
+    while (!_nextValue) {
+        auto nextInput = getNextInput();
         if (!nextInput.isAdvanced()) {
             return nextInput;
         }
@@ -544,19 +801,26 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
             _resolvedPipeline.back() = matchStage;
         }
 
-        if (_pipeline) {
-            _pipeline->dispose(pExpCtx->opCtx);
-        }
+        if (useHashJoin()) {
+            _hashJoinMatches = joinFromTable(*_hashTable, *_input);
+        } else if (useBatchedProbes()) {
+            _hashJoinMatches = std::move(_probedMatches);
+            _probedMatches.clear();
+        } else {
+            if (_pipeline) {
+                _pipeline->dispose(pExpCtx->opCtx);
+            }
 
-        _pipeline = buildPipeline(*_input);
+            _pipeline = buildPipeline(*_input);
 
-        // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
-        // potentially be used by multiple OperationContexts, and the $lookup stage is part of an
-        // outer Pipeline that will propagate dispose() calls before being destroyed.
-        _pipeline.get_deleter().dismissDisposal();
+            // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
+            // potentially be used by multiple OperationContexts, and the $lookup stage is part of
+            // an outer Pipeline that will propagate dispose() calls before being destroyed.
+            _pipeline.get_deleter().dismissDisposal();
+        }
 
         _cursorIndex = 0;
-        _nextValue = _pipeline->getNext();
+        _nextValue = nextUnwindMatch();
 
         if (_unwindSrc->preserveNullAndEmptyArrays() && !_nextValue) {
             // There were no results for this cursor, but the $unwind was asked to preserve empty
@@ -574,7 +838,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
 
     invariant(bool(_input) && bool(_nextValue));
     auto currentValue = *_nextValue;
-    _nextValue = _pipeline->getNext();
+    _nextValue = nextUnwindMatch();
 
     // Move input document into output if this is the last or only result, otherwise perform a copy.
     MutableDocument output(_nextValue ? *_input : std::move(*_input));
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_match.h"
@@ -36,6 +37,7 @@
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
+#include "mongo/db/pipeline/lookup_hash_table.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
 
@@ -108,7 +110,8 @@ public:
 
         StageConstraints constraints(StreamType::kStreaming,
                                      PositionRequirement::kNone,
-                                     HostTypeRequirement::kPrimaryShard,
+                                     _colocated ? HostTypeRequirement::kAnyShard
+                                                : HostTypeRequirement::kPrimaryShard,
                                      mayUseDisk ? DiskUseRequirement::kWritesTmpData
                                                 : DiskUseRequirement::kNoDiskUse,
                                      FacetRequirement::kAllowed);
@@ -124,10 +127,13 @@ public:
     }
 
     boost::intrusive_ptr<DocumentSource> getShardSource() final {
-        return nullptr;
+        return _colocated ? this : nullptr;
     }
 
     std::list<boost::intrusive_ptr<DocumentSource>> getMergeSources() final {
+        if (_colocated) {
+            return {};
+        }
         return {this};
     }
 
@@ -175,6 +181,14 @@ public:
         return !static_cast<bool>(_localField);
     }
 
+    /**
+     * Returns true if mongos found the sharded 'from' collection to be co-located with the
+     * aggregated collection on the joined fields, in which case this stage runs on every shard.
+     */
+    bool isColocated() const {
+        return _colocated;
+    }
+
     const Variables& getVariables_forTest() {
         return _variables;
     }
@@ -244,6 +258,45 @@ private:
 
     GetNextResult unwindResult();
 
+    /**
+     * Decides, the first time it is called, whether this $lookup joins through an in-memory hash
+     * table over the foreign collection and builds the table if so. The hash join is only used for
+     * localField/foreignField syntax against a collection whose data size, per its storage stats,
+     * is within internalDocumentSourceLookupHashJoinMaxBytes. Returns true if the table is in use.
+     */
+    bool useHashJoin();
+
+    /**
+     * Decides, the first time it is called, whether this $lookup probes the foreign collection
+     * for batches of input documents at once. This requires localField/foreignField syntax, a
+     * foreign collection that is not a view and has an index on 'foreignField', and a hash join
+     * not being in use. Returns true if input documents are batched.
+     */
+    bool useBatchedProbes();
+
+    /**
+     * Returns the next input document. With batched probes, the input is read a batch at a time
+     * and '_probedMatches' receives the foreign documents joined to the returned input.
+     */
+    GetNextResult getNextInput();
+
+    /**
+     * Reads up to '_probeBatchSize' input documents, fetches the foreign documents matching any
+     * of their local values with one query, and queues each input along with its matches.
+     */
+    void probeNextBatch();
+
+    /**
+     * Returns the documents in 'table' joined to 'input', filtering the table's candidates with
+     * the same query a per-document lookup would run.
+     */
+    std::deque<Document> joinFromTable(const LookupHashTable& table, const Document& input);
+
+    /**
+     * Returns the next foreign document joined to '_input' while unwinding.
+     */
+    boost::optional<Document> nextUnwindMatch();
+
     /**
      * Copies 'vars' and 'vps' to the Variables and VariablesParseState objects in 'expCtx'. These
      * copies provide access to 'let' defined variables in sub-pipeline execution.
@@ -269,6 +322,15 @@ private:
      */
     std::unique_ptr<Pipeline, Pipeline::Deleter> buildPipeline(const Document& inputDoc);
 
+    /**
+     * On a shard, checks once whether the foreign collection is sharded and co-located with the
+     * aggregated collection and, if so, allows the foreign pipeline to read this shard's chunks of
+     * it. Later calls only compare the two collection versions against those seen by the first
+     * check, and throw StaleShardVersion if either has changed, since the chunks may then no longer
+     * line up.
+     */
+    void checkColocatedForeignCollection();
+
     /**
      * The pipeline supplied via the $lookup 'pipeline' argument. This may differ from pipeline that
      * is executed in that it will not include optimizations or resolved views.
@@ -295,6 +357,14 @@ private:
     boost::optional<FieldPath> _localField;
     boost::optional<FieldPath> _foreignField;
 
+    // Set on mongos when 'from' is sharded and co-located with the aggregated collection.
+    bool _colocated = false;
+    // Set on a shard once the foreign collection has been checked for co-location. The versions
+    // are empty unless the foreign collection is sharded and co-located.
+    bool _colocationChecked = false;
+    BSONObj _colocatedLocalVersion;
+    BSONObj _colocatedForeignVersion;
+
     // Holds 'let' defined variables defined both in this stage and in parent pipelines. These are
     // copied to the '_fromExpCtx' ExpressionContext's 'variables' and 'variablesParseState' for use
     // in foreign pipeline execution.
@@ -307,6 +377,18 @@ private:
     // from a cursor source.
     boost::optional<SequentialDocumentCache> _cache;
 
+    // Holds the whole foreign collection when this $lookup runs as a hash join.
+    boost::optional<LookupHashTable> _hashTable;
+    bool _joinStrategyChosen = false;
+
+    // Non-zero when input documents are joined in batches with a single query per batch.
+    size_t _probeBatchSize = 0;
+    bool _probeStrategyChosen = false;
+    std::deque<std::pair<Document, std::deque<Document>>> _probedInputs;
+    std::deque<Document> _probedMatches;
+    // The non-advanced result that ended the last batch, returned once the batch is consumed.
+    boost::optional<GetNextResult> _pendingInputResult;
+
     // The ExpressionContext used when performing aggregation pipelines against the '_resolvedNs'
     // namespace.
     boost::intrusive_ptr<ExpressionContext> _fromExpCtx;
@@ -330,6 +412,7 @@ private:
     // not null.
     long long _cursorIndex = 0;
     std::unique_ptr<Pipeline, Pipeline::Deleter> _pipeline;
+    std::deque<Document> _hashJoinMatches;
     boost::optional<Document> _input;
     boost::optional<Document> _nextValue;
 };
@@ -31,6 +31,7 @@
 #include "mongo/db/pipeline/document_source_lookup_change_post_image.h"
 
 #include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/db/pipeline/change_stream_post_image_cache.h"
 
 namespace mongo {
 
@@ -112,8 +113,19 @@ Value DocumentSourceLookupChangePostImage::lookupPostImage(const Document& updat
                                         << resumeToken.getData().clusterTime))
         : boost::none;
     invariant(resumeToken.getData().uuid);
-    auto lookedUpDoc = _mongoProcessInterface->lookupSingleDocument(
-        nss, *resumeToken.getData().uuid, documentKey, readConcern);
+    const auto& uuid = *resumeToken.getData().uuid;
+
+    // Other change streams on this collection report the same event, so share the lookup with
+    // them rather than each querying for the same post-image.
+    auto lookedUpDoc = ChangeStreamPostImageCache::get(pExpCtx->opCtx->getServiceContext())
+                           ->lookup(pExpCtx->opCtx,
+                                    uuid,
+                                    resumeToken.getData().clusterTime,
+                                    documentKey,
+                                    [&] {
+                                        return _mongoProcessInterface->lookupSingleDocument(
+                                            nss, uuid, documentKey, readConcern);
+                                    });
 
     // Check whether the lookup returned any documents. Even if the lookup itself succeeded, it may
     // not have returned any results if the document was deleted in the time since the update op.
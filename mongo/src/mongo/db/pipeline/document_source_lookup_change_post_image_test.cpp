@@ -36,6 +36,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/change_stream_post_image_cache.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 #include "mongo/db/pipeline/document_source_lookup_change_post_image.h"
@@ -44,6 +45,10 @@
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/db/pipeline/stub_mongo_process_interface.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/clock_source_mock.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -63,8 +68,7 @@ public:
         return *uuid_gen;
     }
 
-    Document makeResumeToken(ImplicitValue id = Value()) {
-        const Timestamp ts(100, 1);
+    Document makeResumeToken(ImplicitValue id = Value(), Timestamp ts = Timestamp(100, 1)) {
         if (id.missing()) {
             ResumeTokenData tokenData;
             tokenData.clusterTime = ts;
@@ -333,5 +337,91 @@ TEST_F(DocumentSourceLookupChangePostImageTest, ShouldPropagatePauses) {
     ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
 }
 
+/**
+ * Returns the post-image a new $changeStream lookup stage reports for an update to {_id: 0} at
+ * 'ts', when the collection it would look the document up in contains 'foreignContents'.
+ */
+Value lookUpUpdateToDocZero(DocumentSourceLookupChangePostImageTest* fixture,
+                            deque<DocumentSource::GetNextResult> foreignContents,
+                            Timestamp ts) {
+    auto expCtx = fixture->getExpCtx();
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+    auto mockLocalSource = DocumentSourceMock::create(
+        Document{{"_id", fixture->makeResumeToken(0, ts)},
+                 {"documentKey", Document{{"_id", 0}}},
+                 {"operationType", "update"_sd},
+                 {"ns", Document{{"db", expCtx->ns.db()}, {"coll", expCtx->ns.coll()}}}});
+    lookupChangeStage->setSource(mockLocalSource.get());
+    lookupChangeStage->injectMongoProcessInterface(
+        std::make_shared<MockMongoProcessInterface>(std::move(foreignContents)));
+
+    auto next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    return next.releaseDocument()["fullDocument"];
+}
+
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldShareLookupOfSameEventBetweenStreams) {
+    const Timestamp ts(100, 1);
+    ASSERT_VALUE_EQ(lookUpUpdateToDocZero(this, {Document{{"_id", 0}, {"x", 1}}}, ts),
+                    Value(Document{{"_id", 0}, {"x", 1}}));
+
+    // A second stream reporting the same event reuses the first stream's lookup, even though its
+    // own lookup would now find a different version of the document.
+    ASSERT_VALUE_EQ(lookUpUpdateToDocZero(this, {Document{{"_id", 0}, {"x", 2}}}, ts),
+                    Value(Document{{"_id", 0}, {"x", 1}}));
+
+    // A later update to the same document is looked up again.
+    const Timestamp laterTs(101, 1);
+    ASSERT_VALUE_EQ(lookUpUpdateToDocZero(this, {Document{{"_id", 0}, {"x", 2}}}, laterTs),
+                    Value(Document{{"_id", 0}, {"x", 2}}));
+}
+
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldShareLookupOfDeletedDocument) {
+    const Timestamp ts(100, 1);
+    ASSERT_VALUE_EQ(lookUpUpdateToDocZero(this, {}, ts), Value(BSONNULL));
+    ASSERT_VALUE_EQ(lookUpUpdateToDocZero(this, {Document{{"_id", 0}}}, ts), Value(BSONNULL));
+}
+
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldNotShareLookupOnceItExpires) {
+    auto clock = new ClockSourceMock();
+    getExpCtx()->opCtx->getServiceContext()->setFastClockSource(
+        std::unique_ptr<ClockSource>(clock));
+
+    const Timestamp ts(100, 1);
+    ASSERT_VALUE_EQ(lookUpUpdateToDocZero(this, {Document{{"_id", 0}, {"x", 1}}}, ts),
+                    Value(Document{{"_id", 0}, {"x", 1}}));
+
+    clock->advance(
+        Milliseconds(internalDocumentSourceLookupChangePostImageCacheTTLMillis.load() + 1));
+    ASSERT_VALUE_EQ(lookUpUpdateToDocZero(this, {Document{{"_id", 0}, {"x", 2}}}, ts),
+                    Value(Document{{"_id", 0}, {"x", 2}}));
+}
+
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldNotShareLookupWhenCacheIsDisabled) {
+    const auto originalTTL = internalDocumentSourceLookupChangePostImageCacheTTLMillis.load();
+    internalDocumentSourceLookupChangePostImageCacheTTLMillis.store(0);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceLookupChangePostImageCacheTTLMillis.store(originalTTL); });
+
+    const Timestamp ts(100, 1);
+    ASSERT_VALUE_EQ(lookUpUpdateToDocZero(this, {Document{{"_id", 0}, {"x", 1}}}, ts),
+                    Value(Document{{"_id", 0}, {"x", 1}}));
+    ASSERT_VALUE_EQ(lookUpUpdateToDocZero(this, {Document{{"_id", 0}, {"x", 2}}}, ts),
+                    Value(Document{{"_id", 0}, {"x", 2}}));
+}
+
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldNotCacheFailedLookup) {
+    const Timestamp ts(100, 1);
+    ASSERT_THROWS_CODE(
+        lookUpUpdateToDocZero(this, {Document{{"_id", 0}}, Document{{"_id", 0}}}, ts),
+        AssertionException,
+        ErrorCodes::TooManyMatchingDocuments);
+    ASSERT_EQ(ChangeStreamPostImageCache::get(getExpCtx()->opCtx->getServiceContext())->size(),
+              0UL);
+
+    ASSERT_VALUE_EQ(lookUpUpdateToDocZero(this, {Document{{"_id", 0}, {"x", 1}}}, ts),
+                    Value(Document{{"_id", 0}, {"x", 1}}));
+}
+
 }  // namespace
 }  // namespace mongo
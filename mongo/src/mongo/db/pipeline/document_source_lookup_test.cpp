@@ -30,6 +30,7 @@
 
 #include <boost/intrusive_ptr.hpp>
 #include <deque>
+#include <map>
 #include <vector>
 
 #include "mongo/bson/bsonmisc.h"
@@ -47,6 +48,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_options.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -167,6 +169,59 @@ TEST_F(DocumentSourceLookUpTest, ShouldTruncateOutputSortOnSuffixOfAsField) {
     ASSERT_EQUALS(outputSort.size(), 1U);
 }
 
+TEST_F(DocumentSourceLookUpTest, RunsOnEveryShardWhenJoiningColocatedShardKeys) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "a");
+    ExpressionContext::ResolvedNamespace resolvedNs{fromNs, std::vector<BSONObj>{}};
+    resolvedNs.colocatedShardKeyFields.emplace("b", "c");
+    expCtx->setResolvedNamespace(fromNs, std::move(resolvedNs));
+
+    auto lookup = DocumentSourceLookUp::createFromBson(Document{{"$lookup",
+                                                                 Document{{"from", "a"_sd},
+                                                                          {"localField", "b"_sd},
+                                                                          {"foreignField", "c"_sd},
+                                                                          {"as", "d"_sd}}}}
+                                                           .toBson()
+                                                           .firstElement(),
+                                                       expCtx);
+
+    ASSERT(lookup->constraints(Pipeline::SplitState::kUnsplit).hostRequirement ==
+           DocumentSource::StageConstraints::HostTypeRequirement::kAnyShard);
+    ASSERT_EQ(dynamic_cast<SplittableDocumentSource*>(lookup.get())->getShardSource(), lookup);
+}
+
+TEST_F(DocumentSourceLookUpTest, RejectsColocatedShardedFromCollectionUnlessJoiningShardKeys) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "a");
+    ExpressionContext::ResolvedNamespace resolvedNs{fromNs, std::vector<BSONObj>{}};
+    resolvedNs.colocatedShardKeyFields.emplace("b", "c");
+    expCtx->setResolvedNamespace(fromNs, std::move(resolvedNs));
+
+    ASSERT_THROWS_CODE(DocumentSourceLookUp::createFromBson(
+                           Document{{"$lookup",
+                                     Document{{"from", "a"_sd},
+                                              {"localField", "b"_sd},
+                                              {"foreignField", "x"_sd},
+                                              {"as", "d"_sd}}}}
+                               .toBson()
+                               .firstElement(),
+                           expCtx),
+                       AssertionException,
+                       28769);
+    ASSERT_THROWS_CODE(
+        DocumentSourceLookUp::createFromBson(
+            BSON("$lookup" << BSON("from"
+                                   << "a"
+                                   << "pipeline"
+                                   << BSON_ARRAY(BSON("$match" << BSON("x" << 1)))
+                                   << "as"
+                                   << "d"))
+                .firstElement(),
+            expCtx),
+        AssertionException,
+        28769);
+}
+
 TEST_F(DocumentSourceLookUpTest, AcceptsPipelineSyntax) {
     auto expCtx = getExpCtx();
     NamespaceString fromNs("test", "coll");
@@ -519,10 +574,56 @@ public:
         return false;
     }
 
+    CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
+                                          const NamespaceString& ns) final {
+        return _indexStats;
+    }
+
+    void setIndexStats(CollectionIndexUsageMap indexStats) {
+        _indexStats = std::move(indexStats);
+    }
+
+    int numPipelinesMade() const {
+        return _numPipelinesMade;
+    }
+
+    BSONObj getColocatedCollectionVersion(const NamespaceString& localNs,
+                                          StringData localField,
+                                          const NamespaceString& foreignNs,
+                                          StringData foreignField) final {
+        ++_numColocationChecks;
+        return getShardedCollectionVersion(foreignNs);
+    }
+
+    BSONObj getShardedCollectionVersion(const NamespaceString& ns) final {
+        auto it = _collVersions.find(ns.ns());
+        return it == _collVersions.end() ? BSONObj() : it->second;
+    }
+
+    void setShardedCollectionVersion(const NamespaceString& ns, BSONObj version) {
+        _collVersions[ns.ns()] = std::move(version);
+    }
+
+    int numColocationChecks() const {
+        return _numColocationChecks;
+    }
+
+    Status appendStorageStats(const NamespaceString& nss,
+                              const BSONObj& param,
+                              BSONObjBuilder* builder) const final {
+        builder->append("size", _storageSize);
+        return Status::OK();
+    }
+
+    void setStorageSize(long long storageSize) {
+        _storageSize = storageSize;
+    }
+
     StatusWith<std::unique_ptr<Pipeline, Pipeline::Deleter>> makePipeline(
         const std::vector<BSONObj>& rawPipeline,
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         const MakePipelineOptions opts) final {
+        ++_numPipelinesMade;
         auto pipeline = Pipeline::parse(rawPipeline, expCtx);
         if (!pipeline.isOK()) {
             return pipeline.getStatus();
@@ -557,8 +658,245 @@ public:
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
     bool _removeLeadingQueryStages = false;
+    CollectionIndexUsageMap _indexStats;
+    int _numPipelinesMade = 0;
+    std::map<std::string, BSONObj> _collVersions;
+    int _numColocationChecks = 0;
+    long long _storageSize = 0;
 };
 
+TEST_F(DocumentSourceLookUpTest, ShouldProbeIndexedForeignCollectionInBatches) {
+    const int oldBatchSize = internalDocumentSourceLookupProbeBatchSize.load();
+    internalDocumentSourceLookupProbeBatchSize.store(10);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupProbeBatchSize.store(oldBatchSize); });
+
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "_id"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    // The pause ends the first batch early.
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"foreignId", 0}},
+                                    Document{{"foreignId", 1}},
+                                    DocumentSource::GetNextResult::makePauseExecution(),
+                                    Document{{"foreignId", 1}},
+                                    Document{{"foreignId", vector<Value>{Value(0), Value(2)}}}});
+    lookup->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{
+        Document{{"_id", 0}}, Document{{"_id", 1}}, Document{{"_id", 2}}};
+    auto processInterface =
+        std::make_shared<MockMongoProcessInterface>(std::move(mockForeignContents));
+    CollectionIndexUsageMap indexStats;
+    indexStats["_id_"] = CollectionIndexUsageTracker::IndexUsageStats(Date_t(), BSON("_id" << 1));
+    processInterface->setIndexStats(std::move(indexStats));
+    lookup->injectMongoProcessInterface(processInterface);
+
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", 0}, {"foreignDocs", vector<Value>{Value(Document{{"_id", 0}})}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", 1}, {"foreignDocs", vector<Value>{Value(Document{{"_id", 1}})}}}));
+    ASSERT_EQ(processInterface->numPipelinesMade(), 1);
+
+    ASSERT_TRUE(lookup->getNext().isPaused());
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", 1}, {"foreignDocs", vector<Value>{Value(Document{{"_id", 1}})}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", vector<Value>{Value(0), Value(2)}},
+                                 {"foreignDocs",
+                                  vector<Value>{Value(Document{{"_id", 0}}),
+                                                Value(Document{{"_id", 2}})}}}));
+    ASSERT_EQ(processInterface->numPipelinesMade(), 2);
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, ChecksColocationOnceAndThenComparesCollectionVersions) {
+    auto expCtx = getExpCtx();
+    expCtx->fromMongos = true;
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "_id"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    auto mockLocalSource = DocumentSourceMock::create({Document{{"foreignId", 0}},
+                                                       Document{{"foreignId", 1}},
+                                                       Document{{"foreignId", 0}},
+                                                       Document{{"foreignId", 1}}});
+    lookup->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 0}},
+                                                             Document{{"_id", 1}}};
+    auto processInterface =
+        std::make_shared<MockMongoProcessInterface>(std::move(mockForeignContents));
+    processInterface->setShardedCollectionVersion(expCtx->ns, BSON("version" << 1));
+    processInterface->setShardedCollectionVersion(fromNs, BSON("version" << 2));
+    lookup->injectMongoProcessInterface(processInterface);
+
+    for (int i = 0; i < 3; ++i) {
+        auto next = lookup->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_VALUE_EQ(next.releaseDocument()["foreignDocs"],
+                        Value(vector<Value>{Value(Document{{"_id", i % 2}})}));
+    }
+    ASSERT_EQ(processInterface->numPipelinesMade(), 3);
+    ASSERT_EQ(processInterface->numColocationChecks(), 1);
+
+    // A migration of the foreign collection's chunks is detected without re-checking them all.
+    processInterface->setShardedCollectionVersion(fromNs, BSON("version" << 3));
+    ASSERT_THROWS_CODE(lookup->getNext(), AssertionException, ErrorCodes::StaleShardVersion);
+    ASSERT_EQ(processInterface->numColocationChecks(), 1);
+    lookup->dispose();
+}
+
+/**
+ * Runs a $lookup joining 'localField' of 'localDocs' to 'foreignField' of 'foreignDocs', followed
+ * by an absorbed $unwind if 'unwind' is true, and returns its output. The foreign collection is
+ * loaded into a hash table if 'hashJoin' is true and queried once per input document otherwise.
+ */
+vector<Document> runLocalFieldForeignFieldLookup(
+    const boost::intrusive_ptr<ExpressionContextForTest>& expCtx,
+    bool hashJoin,
+    bool unwind,
+    const deque<DocumentSource::GetNextResult>& localDocs,
+    const deque<DocumentSource::GetNextResult>& foreignDocs) {
+    const int oldMaxBytes = internalDocumentSourceLookupHashJoinMaxBytes.load();
+    internalDocumentSourceLookupHashJoinMaxBytes.store(hashJoin ? 1024 * 1024 : 0);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupHashJoinMaxBytes.store(oldMaxBytes); });
+
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "a"_sd},
+                                         {"foreignField", "x"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+    if (unwind) {
+        lookup->setUnwindStage(
+            DocumentSourceUnwind::create(expCtx, "foreignDocs", false, boost::none));
+    }
+
+    auto mockLocalSource = DocumentSourceMock::create(localDocs);
+    lookup->setSource(mockLocalSource.get());
+
+    auto processInterface = std::make_shared<MockMongoProcessInterface>(foreignDocs);
+    processInterface->setStorageSize(1024);
+    lookup->injectMongoProcessInterface(processInterface);
+
+    vector<Document> results;
+    for (auto next = lookup->getNext(); next.isAdvanced(); next = lookup->getNext()) {
+        results.push_back(next.releaseDocument());
+    }
+    ASSERT_TRUE(lookup->getNext().isEOF());
+
+    // The hash join reads the foreign collection once, to load the table.
+    if (hashJoin) {
+        ASSERT_EQ(processInterface->numPipelinesMade(), 1);
+    } else {
+        ASSERT_EQ(processInterface->numPipelinesMade(), static_cast<int>(localDocs.size()));
+    }
+    lookup->dispose();
+    return results;
+}
+
+const deque<DocumentSource::GetNextResult> kHashJoinForeignDocs{
+    Document{{"_id", 0}, {"x", 1}},
+    Document{{"_id", 1}, {"x", vector<Value>{Value(1), Value(2)}}},
+    Document{{"_id", 2}, {"x", BSONNULL}},
+    Document{{"_id", 3}},
+    Document{{"_id", 4}, {"x", 2}},
+    Document{{"_id", 5}, {"x", "str"_sd}}};
+
+const deque<DocumentSource::GetNextResult> kHashJoinLocalDocs{
+    Document{{"_id", 0}, {"a", 1}},
+    Document{{"_id", 1}, {"a", vector<Value>{Value(1), Value(2)}}},
+    Document{{"_id", 2}, {"a", 5}},
+    Document{{"_id", 3}},
+    Document{{"_id", 4}, {"a", BSONNULL}},
+    Document{{"_id", 5}, {"a", vector<Value>{}}},
+    Document{{"_id", 6}, {"a", vector<Value>{Value(7), Value("str"_sd)}}},
+    Document{{"_id", 7}, {"a", 2.0}}};
+
+TEST_F(DocumentSourceLookUpTest, HashJoinProducesTheSameOutputAsNestedLoopJoin) {
+    auto hashJoinResults = runLocalFieldForeignFieldLookup(
+        getExpCtx(), true, false, kHashJoinLocalDocs, kHashJoinForeignDocs);
+    auto nestedLoopResults = runLocalFieldForeignFieldLookup(
+        getExpCtx(), false, false, kHashJoinLocalDocs, kHashJoinForeignDocs);
+
+    ASSERT_EQ(hashJoinResults.size(), kHashJoinLocalDocs.size());
+    ASSERT_EQ(hashJoinResults.size(), nestedLoopResults.size());
+    for (size_t i = 0; i < hashJoinResults.size(); ++i) {
+        ASSERT_DOCUMENT_EQ(hashJoinResults[i], nestedLoopResults[i]);
+    }
+
+    // Spot-check the matches: an array local field joins on each of its elements, an unmatched
+    // value joins nothing, and missing, null and empty local values join missing and null.
+    const auto matchedIds = [&](size_t i) {
+        vector<Value> ids;
+        for (auto&& match : hashJoinResults[i]["foreignDocs"].getArray()) {
+            ids.push_back(match["_id"]);
+        }
+        return Value(ids);
+    };
+    ASSERT_VALUE_EQ(matchedIds(0), Value(vector<Value>{Value(0), Value(1)}));
+    ASSERT_VALUE_EQ(matchedIds(1), Value(vector<Value>{Value(0), Value(1), Value(4)}));
+    ASSERT_VALUE_EQ(matchedIds(2), Value(vector<Value>{}));
+    ASSERT_VALUE_EQ(matchedIds(3), Value(vector<Value>{Value(2), Value(3)}));
+    ASSERT_VALUE_EQ(matchedIds(4), Value(vector<Value>{Value(2), Value(3)}));
+    ASSERT_VALUE_EQ(matchedIds(5), Value(vector<Value>{Value(2), Value(3)}));
+    ASSERT_VALUE_EQ(matchedIds(6), Value(vector<Value>{Value(5)}));
+    ASSERT_VALUE_EQ(matchedIds(7), Value(vector<Value>{Value(1), Value(4)}));
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinWithAbsorbedUnwindProducesTheSameOutputAsNestedLoopJoin) {
+    auto hashJoinResults = runLocalFieldForeignFieldLookup(
+        getExpCtx(), true, true, kHashJoinLocalDocs, kHashJoinForeignDocs);
+    auto nestedLoopResults = runLocalFieldForeignFieldLookup(
+        getExpCtx(), false, true, kHashJoinLocalDocs, kHashJoinForeignDocs);
+
+    // Every match is unwound into its own document, and unmatched input documents are dropped.
+    ASSERT_EQ(hashJoinResults.size(), 14U);
+    ASSERT_EQ(hashJoinResults.size(), nestedLoopResults.size());
+    for (size_t i = 0; i < hashJoinResults.size(); ++i) {
+        ASSERT_DOCUMENT_EQ(hashJoinResults[i], nestedLoopResults[i]);
+    }
+}
+
 TEST_F(DocumentSourceLookUpTest, ShouldPropagatePauses) {
     auto expCtx = getExpCtx();
     NamespaceString fromNs("test", "foreign");
@@ -122,33 +122,36 @@ void DocumentSourceOut::initialize() {
                 ok);
     }
 
-    // copy indexes to _tempNs
-    for (std::list<BSONObj>::const_iterator it = _originalIndexes.begin();
-         it != _originalIndexes.end();
-         ++it) {
-        MutableDocument index((Document(*it)));
+    _initialized = true;
+}
+
+void DocumentSourceOut::createIndexesOnTempCollection() {
+    BSONArrayBuilder indexes;
+    for (auto&& originalIndex : _originalIndexes) {
+        MutableDocument index((Document(originalIndex)));
         index.remove("_id");  // indexes shouldn't have _ids but some existing ones do
         index["ns"] = Value(_tempNs.ns());
-
-        BSONObj indexBson = index.freeze().toBson();
-        conn->insert(_tempNs.getSystemIndexesCollection(), indexBson);
-        BSONObj err = conn->getLastErrorDetailed();
-        uassert(16995,
-                str::stream() << "copying index for $out failed."
-                              << " index: "
-                              << indexBson
-                              << " error: "
-                              << err,
-                DBClientBase::getLastErrorString(err).empty());
+        indexes.append(index.freeze().toBson());
     }
-    _initialized = true;
+    if (indexes.arrSize() == 0) {
+        return;
+    }
+
+    // The _id index already exists on the temporary collection, and is skipped by createIndexes.
+    BSONObj cmd = BSON("createIndexes" << _tempNs.coll() << "indexes" << indexes.arr());
+    BSONObj info;
+    bool ok = _mongoProcessInterface->directClient()->runCommand(
+        _tempNs.db().toString(), cmd, info);
+    uassert(16995,
+            str::stream() << "copying indexes for $out failed. indexes: " << cmd["indexes"]
+                          << " error: "
+                          << info,
+            ok);
 }
 
 void DocumentSourceOut::spill(const vector<BSONObj>& toInsert) {
-    BSONObj err = _mongoProcessInterface->insert(_tempNs, toInsert);
-    uassert(16996,
-            str::stream() << "insert for $out failed: " << err,
-            DBClientBase::getLastErrorString(err).empty());
+    auto status = _mongoProcessInterface->insert(_tempNs, toInsert);
+    uassert(16996, str::stream() << "insert for $out failed: " << status.toString(), status.isOK());
 }
 
 DocumentSource::GetNextResult DocumentSourceOut::getNext() {
@@ -190,6 +193,7 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
             return nextInput;  // Propagate the pause.
         }
         case GetNextResult::ReturnStatus::kEOF: {
+            createIndexesOnTempCollection();
 
             auto renameCommandObj =
                 BSON("renameCollection" << _tempNs.ns() << "to" << _outputNs.ns() << "dropTarget"
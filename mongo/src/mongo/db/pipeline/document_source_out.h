@@ -86,12 +86,20 @@ private:
      * Sets '_tempNs' to a unique temporary namespace, makes sure the output collection isn't
      * sharded or capped, and saves the collection options and indexes of the target collection.
      * Then creates the temporary collection we will insert into by copying the collection options
-     * and indexes from the target collection.
+     * from the target collection. Only the _id index is created up front; the other indexes of the
+     * target are built by createIndexesOnTempCollection() once all of the output is loaded.
      *
      * Sets '_initialized' to true upon completion.
      */
     void initialize();
 
+    /**
+     * Builds the indexes of the target collection on the temporary collection. They are built
+     * together by a single index build, which scans the loaded collection once and feeds each
+     * index from an external sort, rather than maintaining every index on each insert.
+     */
+    void createIndexesOnTempCollection();
+
     /**
      * Inserts all of 'toInsert' into the temporary collection.
      */
@@ -38,6 +38,8 @@
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/thread.h"
 
 namespace mongo {
 
@@ -48,6 +50,8 @@ using std::string;
 using std::vector;
 
 namespace {
+const int kMaxSortParallelism = 64;
+
 Value missingToNull(Value maybeMissing) {
     return maybeMissing.missing() ? Value(BSONNULL) : maybeMissing;
 }
@@ -335,10 +339,56 @@ DocumentSource::GetNextResult DocumentSourceSort::populate() {
     }
 }
 
+void DocumentSourceSort::makeSorters() {
+    // Only mongos, which cannot spill, sorts on several threads: each thread sorts an equal share
+    // of the input in memory and the sorted runs are merged as they are returned.
+    const int parallelism = pExpCtx->inMongos
+        ? std::min(internalDocumentSourceSortMongosParallelism.load(), kMaxSortParallelism)
+        : 1;
+    if (parallelism <= 1) {
+        _sorter.reset(MySorter::make(makeSortOptions(), Comparator(*this)));
+        return;
+    }
+
+    SortOptions opts = makeSortOptions();
+    opts.maxMemoryUsageBytes /= parallelism;
+    for (int i = 0; i < parallelism; ++i) {
+        _partialSorters.emplace_back(MySorter::make(opts, Comparator(*this)));
+    }
+}
+
+DocumentSourceSort::MySorter::Iterator* DocumentSourceSort::sortPartialSorters() {
+    const size_t numSorters = _partialSorters.size();
+    std::vector<std::shared_ptr<MySorter::Iterator>> runs(numSorters);
+    std::vector<Status> statuses(numSorters, Status::OK());
+    auto sortRun = [&](size_t i) {
+        try {
+            runs[i].reset(_partialSorters[i]->done());
+        } catch (...) {
+            statuses[i] = exceptionToStatus();
+        }
+    };
+
+    std::vector<stdx::thread> threads;
+    for (size_t i = 1; i < numSorters; ++i) {
+        threads.emplace_back(sortRun, i);
+    }
+    sortRun(0);
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    _partialSorters.clear();
+
+    for (auto&& status : statuses) {
+        uassertStatusOK(status);
+    }
+    return MySorter::Iterator::merge(runs, makeSortOptions(), Comparator(*this));
+}
+
 void DocumentSourceSort::loadDocument(Document&& doc) {
     invariant(!_populated);
-    if (!_sorter) {
-        _sorter.reset(MySorter::make(makeSortOptions(), Comparator(*this)));
+    if (!_sorter && _partialSorters.empty()) {
+        makeSorters();
     }
 
     Value sortKey;
@@ -347,12 +397,21 @@ void DocumentSourceSort::loadDocument(Document&& doc) {
     // already computed the sort key we'd have split the pipeline there, would be merging presorted
     // documents, and wouldn't use this method.
     std::tie(sortKey, docForSorter) = extractSortKey(std::move(doc));
+    if (!_partialSorters.empty()) {
+        _partialSorters[_nextPartialSorter++ % _partialSorters.size()]->add(sortKey, docForSorter);
+        return;
+    }
     _sorter->add(sortKey, docForSorter);
 }
 
 void DocumentSourceSort::loadingDone() {
-    if (!_sorter) {
-        _sorter.reset(MySorter::make(makeSortOptions(), Comparator(*this)));
+    if (!_sorter && _partialSorters.empty()) {
+        makeSorters();
+    }
+    if (!_partialSorters.empty()) {
+        _output.reset(sortPartialSorters());
+        _populated = true;
+        return;
     }
     _output.reset(_sorter->done());
     _sorter.reset();
@@ -119,6 +119,10 @@ public:
      */
     long long getLimit() const;
 
+    uint64_t getMaxMemoryUsageBytes() const {
+        return _maxMemoryUsageBytes;
+    }
+
     /**
      * Loads a document to be sorted. This can be used to sort a stream of documents that are not
      * coming from another DocumentSource. Once all documents have been added, the caller must call
@@ -201,6 +205,17 @@ private:
 
     SortOptions makeSortOptions() const;
 
+    /**
+     * Creates either '_sorter' or, when sorting on several threads, '_partialSorters'.
+     */
+    void makeSorters();
+
+    /**
+     * Finishes every partial sorter on its own thread and returns an iterator merging their
+     * sorted runs.
+     */
+    MySorter::Iterator* sortPartialSorters();
+
     /**
      * Returns the sort key for 'doc', as well as the document that should be entered into the
      * sorter to eventually be returned. If we will need to later merge the sorted results with
@@ -260,6 +275,11 @@ private:
     bool _mergingPresorted;
     std::unique_ptr<MySorter> _sorter;
     std::unique_ptr<MySorter::Iterator> _output;
+
+    // Used instead of '_sorter' when mongos sorts on several threads. Input documents are dealt
+    // out to them in turn.
+    std::vector<std::unique_ptr<MySorter>> _partialSorters;
+    size_t _nextPartialSorter = 0;
 };
 
 }  // namespace mongo
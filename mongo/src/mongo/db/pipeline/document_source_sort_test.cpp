@@ -44,8 +44,10 @@
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -433,6 +435,55 @@ TEST_F(DocumentSourceSortExecutionTest, ShouldBeAbleToPauseLoadingWhileSpilled)
     ASSERT_VALUE_EQ(next.releaseDocument()["_id"], Value(0));
 }
 
+TEST_F(DocumentSourceSortExecutionTest, ShouldMergeRunsSortedInParallelOnMongos) {
+    const int oldParallelism = internalDocumentSourceSortMongosParallelism.load();
+    internalDocumentSourceSortMongosParallelism.store(4);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceSortMongosParallelism.store(oldParallelism); });
+
+    auto expCtx = getExpCtx();
+    expCtx->inMongos = true;
+    auto sort = DocumentSourceSort::create(expCtx, BSON("a" << 1));
+
+    const int numDocs = 1000;
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < numDocs; ++i) {
+        inputs.emplace_back(Document{{"a", (i * 7919) % numDocs}});
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    sort->setSource(mock.get());
+
+    for (int i = 0; i < numDocs; ++i) {
+        auto next = sort->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_VALUE_EQ(next.releaseDocument()["a"], Value(i));
+    }
+    ASSERT_TRUE(sort->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceSortExecutionTest, ShouldApplyLimitWhenMergingRunsSortedInParallel) {
+    const int oldParallelism = internalDocumentSourceSortMongosParallelism.load();
+    internalDocumentSourceSortMongosParallelism.store(4);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceSortMongosParallelism.store(oldParallelism); });
+
+    auto expCtx = getExpCtx();
+    expCtx->inMongos = true;
+    auto sort = DocumentSourceSort::create(expCtx, BSON("a" << -1), 10);
+
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 100; ++i) {
+        inputs.emplace_back(Document{{"a", i}});
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    sort->setSource(mock.get());
+
+    for (int i = 99; i >= 90; --i) {
+        auto next = sort->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_VALUE_EQ(next.releaseDocument()["a"], Value(i));
+    }
+    ASSERT_TRUE(sort->getNext().isEOF());
+}
+
 TEST_F(DocumentSourceSortExecutionTest,
        ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
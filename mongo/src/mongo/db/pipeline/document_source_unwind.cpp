@@ -32,6 +32,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
@@ -206,6 +207,29 @@ DocumentSource::GetNextResult DocumentSourceUnwind::getNext() {
     return nextOut;
 }
 
+void DocumentSourceUnwind::resetUnwound(const Document& document) {
+    _unwinder->resetDocument(document);
+}
+
+DocumentSource::GetNextResult DocumentSourceUnwind::getNextUnwound() {
+    return _unwinder->getNext();
+}
+
+Pipeline::SourceContainer::iterator DocumentSourceUnwind::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    auto nextGroup = dynamic_cast<DocumentSourceGroup*>((*std::next(itr)).get());
+    if (nextGroup && nextGroup->absorbUnwind(this)) {
+        // The $group now unwinds its input itself, so this stage is no longer needed. Its former
+        // predecessor may be able to optimize further with the $group as its neighbor.
+        auto groupItr = container->erase(itr);
+        return groupItr == container->begin() ? groupItr : std::prev(groupItr);
+    }
+
+    return std::next(itr);
+}
+
 BSONObjSet DocumentSourceUnwind::getOutputSorts() {
     BSONObjSet out = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     std::string unwoundPath = getUnwindPath();
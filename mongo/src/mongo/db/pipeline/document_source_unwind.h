@@ -83,6 +83,26 @@ public:
         return _indexPath;
     }
 
+    /**
+     * Starts unwinding 'document' without pulling from this stage's source. Used by a stage that
+     * has absorbed this $unwind and feeds it input itself.
+     */
+    void resetUnwound(const Document& document);
+
+    /**
+     * Returns the next document unwound from the document passed to resetUnwound(), or EOF once
+     * that document is exhausted.
+     */
+    GetNextResult getNextUnwound();
+
+protected:
+    /**
+     * If the next stage is a $group, the $group absorbs this stage and unwinds its own input, so
+     * that only the fields the $group reads are copied into each unwound document.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
 private:
     DocumentSourceUnwind(const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
                          const FieldPath& fieldPath,
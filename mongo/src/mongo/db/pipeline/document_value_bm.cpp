@@ -0,0 +1,102 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/field_path.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+BSONObj makeBSON(std::int64_t numFields) {
+    BSONObjBuilder builder;
+    for (std::int64_t i = 0; i < numFields; ++i) {
+        builder.append("field" + std::to_string(i), static_cast<int>(i));
+    }
+    builder.append("nested", BSON("a" << BSON("b" << 1)));
+    return builder.obj();
+}
+
+// Converts BSON to a Document and reads back its last field, as $match and $project do.
+void BM_documentFromBSON(benchmark::State& state) {
+    const BSONObj bson = makeBSON(state.range(0));
+    while (state.keepRunning()) {
+        Document doc(bson);
+        benchmark::doNotOptimize(doc["nested"].getType());
+    }
+    state.setBytesProcessed(state.iterations() * bson.objsize());
+}
+BENCHMARK(BM_documentFromBSON)->arg(10)->arg(100);
+
+void BM_documentToBSON(benchmark::State& state) {
+    const Document doc(makeBSON(state.range(0)));
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(doc.toBson().objsize());
+    }
+}
+BENCHMARK(BM_documentToBSON)->arg(10)->arg(100);
+
+void BM_documentGetNestedField(benchmark::State& state) {
+    const Document doc(makeBSON(10));
+    const FieldPath path("nested.a.b");
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(doc.getNestedField(path).getType());
+    }
+}
+BENCHMARK(BM_documentGetNestedField);
+
+// Builds a Document with MutableDocument, as $group and $addFields do for each result.
+void BM_mutableDocumentAddFields(benchmark::State& state) {
+    const auto numFields = state.range(0);
+    while (state.keepRunning()) {
+        MutableDocument md;
+        for (std::int64_t i = 0; i < numFields; ++i) {
+            md.addField("field", Value(static_cast<int>(i)));
+        }
+        benchmark::doNotOptimize(md.freeze().size());
+    }
+    state.setItemsProcessed(state.iterations() * numFields);
+}
+BENCHMARK(BM_mutableDocumentAddFields)->arg(10)->arg(100);
+
+void BM_valueCompare(benchmark::State& state) {
+    const Value left(BSON_ARRAY(1 << "two" << 3.0));
+    const Value right(BSON_ARRAY(1 << "two" << 4.0));
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(Value::compare(left, right, nullptr));
+    }
+}
+BENCHMARK(BM_valueCompare);
+
+}  // namespace
+}  // namespace mongo
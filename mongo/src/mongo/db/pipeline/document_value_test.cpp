@@ -147,6 +147,61 @@ TEST(DocumentSerialization, CannotSerializeDocumentThatExceedsDepthLimit) {
     throwaway.abandon();
 }
 
+TEST(DocumentConstruction, FromBsonLazily) {
+    const BSONObj original = BSON("a" << 1 << "b" << BSON("c" << BSON_ARRAY(BSON("d" << 2) << 3))
+                                      << "e"
+                                      << "q");
+    Document document = Document::fromBsonLazily(original);
+
+    ASSERT_EQUALS(2, document.getNestedField(FieldPath("b.c")).getArray()[0]["d"].getInt());
+    ASSERT_EQUALS("q", document["e"].getString());
+    ASSERT(document["missing"].missing());
+    ASSERT_EQUALS(3U, document.size());
+    ASSERT_DOCUMENT_EQ(fromBson(original), document);
+    ASSERT_BSONOBJ_EQ(original, toBson(document));
+}
+
+TEST(DocumentConstruction, LazilyDecodedFieldsAreFoundInOrder) {
+    Document document = Document::fromBsonLazily(
+        BSON("a" << 1 << "b" << 2 << "c" << 3 << "d" << 4 << "e" << 5 << "f" << 6));
+
+    // Decode the middle of the document first
+    ASSERT_EQUALS(4, document["d"].getInt());
+    ASSERT_EQUALS(1, document["a"].getInt());
+    ASSERT_EQUALS(6, document["f"].getInt());
+    ASSERT_EQUALS(6U, document.size());
+    ASSERT_EQUALS("c", getNthField(document, 2).first.toString());
+    ASSERT_EQUALS(5, getNthField(document, 4).second.getInt());
+}
+
+TEST(DocumentConstruction, ModifiedLazyDocumentIsReserialized) {
+    const BSONObj original = BSON("a" << 1 << "b" << BSON("c" << 2) << "d" << 3);
+    Document document = Document::fromBsonLazily(original);
+
+    MutableDocument md(document);
+    md.setNestedField(FieldPath("b.c"), Value(5));
+    md.addField("e", Value(4));
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << BSON("c" << 5) << "d" << 3 << "e" << 4),
+                      toBson(md.freeze()));
+
+    // The original document is unaffected
+    ASSERT_BSONOBJ_EQ(original, toBson(document));
+}
+
+TEST(DocumentConstruction, LazyDocumentOutlivesItsSource) {
+    Document document;
+    Value nested;
+    {
+        BSONObj original = BSON("a" << BSON("b" << "q"));
+        document = Document::fromBsonLazily(original);
+        nested = document["a"];
+    }
+
+    document = Document();
+    ASSERT_EQUALS("q", nested["b"].getString());
+    ASSERT_BSONOBJ_EQ(BSON("x" << BSON("b" << "q")), BSON("x" << nested));
+}
+
 /** Add Document fields. */
 class AddField {
 public:
@@ -44,9 +44,11 @@
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/variables.h"
 #include "mongo/db/query/datetime/date_time_support.h"
+#include "mongo/platform/decimal128.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/intrusive_counter.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/summation.h"
 
 namespace mongo {
 
@@ -645,6 +647,28 @@ public:
 
 class ExpressionAdd final : public ExpressionVariadic<ExpressionAdd> {
 public:
+    /**
+     * Adds up the operands of $add one at a time. The result has the narrowest type which avoids
+     * overflow, loss of precision due to intermediate rounding or implicit use of decimal types.
+     */
+    class Sum {
+    public:
+        /**
+         * Adds 'val' to the sum. Returns false if 'val' is nullish, in which case the result is
+         * null regardless of the other operands, and throws if 'val' cannot be added.
+         */
+        bool add(const Value& val);
+
+        Value getValue() const;
+
+    private:
+        // A compensated sum for non-decimal values and a separate decimal sum for decimal values
+        DoubleDoubleSummation _nonDecimalTotal;
+        Decimal128 _decimalTotal;
+        BSONType _totalType = NumberInt;
+        bool _haveDate = false;
+    };
+
     explicit ExpressionAdd(const boost::intrusive_ptr<ExpressionContext>& expCtx)
         : ExpressionVariadic<ExpressionAdd>(expCtx) {}
 
@@ -1025,6 +1049,11 @@ public:
     explicit ExpressionDivide(const boost::intrusive_ptr<ExpressionContext>& expCtx)
         : ExpressionFixedArity<ExpressionDivide, 2>(expCtx) {}
 
+    /**
+     * Returns the quotient of the already evaluated operands 'lhs' and 'rhs'.
+     */
+    static Value apply(const Value& lhs, const Value& rhs);
+
     Value evaluate(const Document& root) const final;
     const char* getOpName() const final;
 };
@@ -1366,6 +1395,28 @@ public:
 
 class ExpressionMultiply final : public ExpressionVariadic<ExpressionMultiply> {
 public:
+    /**
+     * Multiplies the operands of $multiply one at a time. The result has the narrowest possible
+     * type: the arithmetic for double and integral types is done in parallel, tracking the current
+     * narrowest type, without creating intermediate Values.
+     */
+    class Product {
+    public:
+        /**
+         * Multiplies the product by 'val'. Returns false if 'val' is nullish, in which case the
+         * result is null regardless of the other operands, and throws if 'val' is not numeric.
+         */
+        bool multiply(const Value& val);
+
+        Value getValue() const;
+
+    private:
+        double _doubleProduct = 1;
+        long long _longProduct = 1;
+        Decimal128 _decimalProduct;  // Initialized on encountering the first decimal.
+        BSONType _productType = NumberInt;
+    };
+
     explicit ExpressionMultiply(const boost::intrusive_ptr<ExpressionContext>& expCtx)
         : ExpressionVariadic<ExpressionMultiply>(expCtx) {}
 
@@ -1720,6 +1771,11 @@ public:
     explicit ExpressionSubtract(const boost::intrusive_ptr<ExpressionContext>& expCtx)
         : ExpressionFixedArity<ExpressionSubtract, 2>(expCtx) {}
 
+    /**
+     * Returns the difference of the already evaluated operands 'lhs' and 'rhs'.
+     */
+    static Value apply(const Value& lhs, const Value& rhs);
+
     Value evaluate(const Document& root) const final;
     const char* getOpName() const final;
 };
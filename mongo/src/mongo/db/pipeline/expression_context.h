@@ -32,6 +32,7 @@
 #include <boost/optional.hpp>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "mongo/bson/bsonobj.h"
@@ -59,6 +60,11 @@ public:
 
         NamespaceString ns;
         std::vector<BSONObj> pipeline;
+
+        // Set by mongos when 'ns' is sharded and its chunks are distributed exactly like those of
+        // the aggregated collection. Holds the shard key field of the aggregated collection and
+        // that of 'ns', in that order.
+        boost::optional<std::pair<std::string, std::string>> colocatedShardKeyFields;
     };
 
     /**
@@ -200,6 +206,11 @@ public:
     // Tracks the depth of nested aggregation sub-pipelines. Used to enforce depth limits.
     size_t subPipelineDepth = 0;
 
+    // Set on the ExpressionContext of a $lookup's foreign pipeline once the shard has confirmed
+    // that the sharded foreign collection is co-located with the aggregated collection, allowing
+    // the foreign pipeline to read this shard's chunks of it. Not propagated by copyWith().
+    bool allowShardedCollection = false;
+
 protected:
     static const int kInterruptCheckPeriod = 128;
 
@@ -0,0 +1,214 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/expression_program.h"
+
+#include <array>
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+constexpr size_t ExpressionArithmeticProgram::kMaxRegisters;
+constexpr size_t ExpressionArithmeticProgram::kMaxAccumulators;
+
+intrusive_ptr<Expression> ExpressionArithmeticProgram::compile(
+    const intrusive_ptr<ExpressionContext>& expCtx, const intrusive_ptr<Expression>& expr) {
+    const Expression* root = expr.get();
+    if (!dynamic_cast<const ExpressionAdd*>(root) &&
+        !dynamic_cast<const ExpressionMultiply*>(root) &&
+        !dynamic_cast<const ExpressionSubtract*>(root) &&
+        !dynamic_cast<const ExpressionDivide*>(root)) {
+        return expr;
+    }
+
+    intrusive_ptr<ExpressionArithmeticProgram> program(
+        new ExpressionArithmeticProgram(expCtx, expr));
+    auto arithmeticNodes = program->compileNode(root, 0, 0);
+
+    // A single arithmetic node saves nothing over evaluating the tree.
+    if (!arithmeticNodes || *arithmeticNodes < 2) {
+        return expr;
+    }
+    return program;
+}
+
+boost::optional<size_t> ExpressionArithmeticProgram::compileNode(const Expression* expr,
+                                                                 size_t dst,
+                                                                 size_t slot) {
+    if (dst >= kMaxRegisters) {
+        return boost::none;
+    }
+
+    if (auto add = dynamic_cast<const ExpressionAdd*>(expr)) {
+        return compileAccumulator(
+            add, OpCode::kSumBegin, OpCode::kSumAdd, OpCode::kSumEnd, dst, slot);
+    }
+    if (auto multiply = dynamic_cast<const ExpressionMultiply*>(expr)) {
+        return compileAccumulator(multiply,
+                                  OpCode::kProductBegin,
+                                  OpCode::kProductMultiply,
+                                  OpCode::kProductEnd,
+                                  dst,
+                                  slot);
+    }
+
+    const bool isSubtract = dynamic_cast<const ExpressionSubtract*>(expr);
+    if (isSubtract || dynamic_cast<const ExpressionDivide*>(expr)) {
+        // Both operands are always evaluated, left before right, before either is inspected.
+        const auto& operands = static_cast<const ExpressionNary*>(expr)->getOperandList();
+        auto lhsNodes = compileNode(operands[0].get(), dst, slot);
+        auto rhsNodes = lhsNodes ? compileNode(operands[1].get(), dst + 1, slot) : boost::none;
+        if (!rhsNodes) {
+            return boost::none;
+        }
+        Instruction instruction;
+        instruction.op = isSubtract ? OpCode::kSubtract : OpCode::kDivide;
+        instruction.dst = dst;
+        _program.push_back(std::move(instruction));
+        return 1 + *lhsNodes + *rhsNodes;
+    }
+
+    Instruction instruction;
+    instruction.dst = dst;
+    if (auto constant = dynamic_cast<const ExpressionConstant*>(expr)) {
+        instruction.op = OpCode::kConstant;
+        instruction.constant = constant->getValue();
+    } else {
+        instruction.op =
+            dynamic_cast<const ExpressionFieldPath*>(expr) ? OpCode::kFieldPath : OpCode::kEvaluate;
+        instruction.expr = expr;
+    }
+    _program.push_back(std::move(instruction));
+    return size_t(0);
+}
+
+boost::optional<size_t> ExpressionArithmeticProgram::compileAccumulator(const ExpressionNary* expr,
+                                                                        OpCode begin,
+                                                                        OpCode step,
+                                                                        OpCode end,
+                                                                        size_t dst,
+                                                                        size_t slot) {
+    if (slot >= kMaxAccumulators) {
+        return boost::none;
+    }
+
+    Instruction beginInstruction;
+    beginInstruction.op = begin;
+    beginInstruction.slot = slot;
+    _program.push_back(std::move(beginInstruction));
+
+    // Each operand is evaluated into 'dst' and folded into the accumulator before the next operand
+    // is evaluated. The steps are patched to jump past the end of the accumulation once the
+    // address of its last instruction is known.
+    size_t nodes = 1;
+    std::vector<size_t> steps;
+    for (auto&& operand : expr->getOperandList()) {
+        auto operandNodes = compileNode(operand.get(), dst, slot + 1);
+        if (!operandNodes) {
+            return boost::none;
+        }
+        nodes += *operandNodes;
+
+        Instruction stepInstruction;
+        stepInstruction.op = step;
+        stepInstruction.dst = dst;
+        stepInstruction.slot = slot;
+        steps.push_back(_program.size());
+        _program.push_back(std::move(stepInstruction));
+    }
+
+    Instruction endInstruction;
+    endInstruction.op = end;
+    endInstruction.dst = dst;
+    endInstruction.slot = slot;
+    _program.push_back(std::move(endInstruction));
+
+    for (auto&& stepIndex : steps) {
+        _program[stepIndex].jump = _program.size();
+    }
+    return nodes;
+}
+
+Value ExpressionArithmeticProgram::evaluate(const Document& root) const {
+    std::array<Value, kMaxRegisters> registers;
+    std::array<ExpressionAdd::Sum, kMaxAccumulators> sums;
+    std::array<ExpressionMultiply::Product, kMaxAccumulators> products;
+
+    size_t pc = 0;
+    while (pc < _program.size()) {
+        const Instruction& instruction = _program[pc++];
+        Value& dst = registers[instruction.dst];
+        switch (instruction.op) {
+            case OpCode::kConstant:
+                dst = instruction.constant;
+                break;
+            case OpCode::kFieldPath:
+                dst = static_cast<const ExpressionFieldPath*>(instruction.expr)->evaluate(root);
+                break;
+            case OpCode::kEvaluate:
+                dst = instruction.expr->evaluate(root);
+                break;
+            case OpCode::kSumBegin:
+                sums[instruction.slot] = ExpressionAdd::Sum();
+                break;
+            case OpCode::kSumAdd:
+                if (!sums[instruction.slot].add(dst)) {
+                    dst = Value(BSONNULL);
+                    pc = instruction.jump;
+                }
+                break;
+            case OpCode::kSumEnd:
+                dst = sums[instruction.slot].getValue();
+                break;
+            case OpCode::kProductBegin:
+                products[instruction.slot] = ExpressionMultiply::Product();
+                break;
+            case OpCode::kProductMultiply:
+                if (!products[instruction.slot].multiply(dst)) {
+                    dst = Value(BSONNULL);
+                    pc = instruction.jump;
+                }
+                break;
+            case OpCode::kProductEnd:
+                dst = products[instruction.slot].getValue();
+                break;
+            case OpCode::kSubtract:
+                dst = ExpressionSubtract::apply(dst, registers[instruction.dst + 1]);
+                break;
+            case OpCode::kDivide:
+                dst = ExpressionDivide::apply(dst, registers[instruction.dst + 1]);
+                break;
+        }
+    }
+    return std::move(registers[0]);
+}
+
+}  // namespace mongo
@@ -0,0 +1,134 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/pipeline/expression.h"
+
+namespace mongo {
+
+/**
+ * An arithmetic expression tree flattened into a linear program. Each node of the tree built from
+ * $add, $subtract, $multiply and $divide becomes one or more instructions which read and write a
+ * small, fixed set of registers, so that evaluating the expression does not recurse through a
+ * virtual evaluate() call and allocate a temporary Value for every node. Operands which are not
+ * arithmetic are evaluated by calling into the original subexpression.
+ *
+ * The program produces exactly the same results and errors as the tree it was compiled from,
+ * including returning null as soon as an operand of $add or $multiply is nullish without
+ * evaluating the remaining operands.
+ */
+class ExpressionArithmeticProgram final : public Expression {
+public:
+    /**
+     * Returns a program equivalent to 'expr' if 'expr' is an arithmetic expression with at least
+     * one arithmetic subexpression, and 'expr' itself otherwise. 'expr' should already have been
+     * optimized, so that any constant subexpressions have been folded.
+     */
+    static boost::intrusive_ptr<Expression> compile(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const boost::intrusive_ptr<Expression>& expr);
+
+    Value evaluate(const Document& root) const final;
+
+    Value serialize(bool explain) const final {
+        return _source->serialize(explain);
+    }
+
+    ComputedPaths getComputedPaths(const std::string& exprFieldPath,
+                                   Variables::Id renamingVar) const final {
+        return _source->getComputedPaths(exprFieldPath, renamingVar);
+    }
+
+    const boost::intrusive_ptr<Expression>& getSource() const {
+        return _source;
+    }
+
+    // The maximum number of registers, and the maximum nesting of $add and $multiply expressions,
+    // that a compiled program may use.
+    static constexpr size_t kMaxRegisters = 8;
+    static constexpr size_t kMaxAccumulators = 8;
+
+protected:
+    void _doAddDependencies(DepsTracker* deps) const final {
+        _source->addDependencies(deps);
+    }
+
+private:
+    enum class OpCode {
+        kConstant,   // dst = constant
+        kFieldPath,  // dst = field path 'expr' evaluated against the root document
+        kEvaluate,   // dst = 'expr' evaluated against the root document
+        kSumBegin,   // reset the sum in accumulator slot 'slot'
+        kSumAdd,     // add dst to the sum in 'slot', or set dst to null and jump if it is nullish
+        kSumEnd,     // dst = the sum in 'slot'
+        kProductBegin,
+        kProductMultiply,
+        kProductEnd,
+        kSubtract,  // dst = dst - (dst + 1)
+        kDivide,    // dst = dst / (dst + 1)
+    };
+
+    struct Instruction {
+        OpCode op;
+        size_t dst = 0;
+        size_t slot = 0;
+        size_t jump = 0;
+        Value constant;
+        const Expression* expr = nullptr;
+    };
+
+    ExpressionArithmeticProgram(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                boost::intrusive_ptr<Expression> source)
+        : Expression(expCtx), _source(std::move(source)) {}
+
+    /**
+     * Appends the instructions which evaluate 'expr' into register 'dst' to the program, using
+     * registers above 'dst' for temporaries and accumulator slots from 'slot' upwards. Returns the
+     * number of arithmetic nodes compiled, or boost::none if 'expr' needs more registers or slots
+     * than are available.
+     */
+    boost::optional<size_t> compileNode(const Expression* expr, size_t dst, size_t slot);
+
+    boost::optional<size_t> compileAccumulator(const ExpressionNary* expr,
+                                               OpCode begin,
+                                               OpCode step,
+                                               OpCode end,
+                                               size_t dst,
+                                               size_t slot);
+
+    // The optimized expression tree this program was compiled from. It owns every subexpression
+    // referenced by the program's instructions.
+    boost::intrusive_ptr<Expression> _source;
+
+    std::vector<Instruction> _program;
+};
+
+}  // namespace mongo
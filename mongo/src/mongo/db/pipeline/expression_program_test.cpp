@@ -0,0 +1,171 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/expression_program.h"
+
+#include <limits>
+
+#include "mongo/bson/json.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/pipeline/parsed_inclusion_projection.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using boost::intrusive_ptr;
+
+using ExpressionArithmeticProgramTest = AggregationContextFixture;
+
+intrusive_ptr<Expression> parseOptimized(const intrusive_ptr<ExpressionContext>& expCtx,
+                                         const std::string& json) {
+    BSONObj obj = fromjson("{expr: " + json + "}");
+    return Expression::parseOperand(expCtx, obj.firstElement(), expCtx->variablesParseState)
+        ->optimize();
+}
+
+bool isCompiled(const intrusive_ptr<Expression>& expr) {
+    return dynamic_cast<ExpressionArithmeticProgram*>(expr.get());
+}
+
+/**
+ * Asserts that the compiled form of 'json' evaluates to the same value, of the same type, as the
+ * expression tree it was compiled from for each of 'inputs'.
+ */
+void assertMatchesTree(const intrusive_ptr<ExpressionContext>& expCtx,
+                       const std::string& json,
+                       const std::vector<Document>& inputs) {
+    auto tree = parseOptimized(expCtx, json);
+    auto program = ExpressionArithmeticProgram::compile(expCtx, tree);
+    ASSERT_TRUE(isCompiled(program));
+
+    for (auto&& input : inputs) {
+        Value expected = tree->evaluate(input);
+        Value actual = program->evaluate(input);
+        ASSERT_VALUE_EQ(expected, actual);
+        ASSERT_EQ(expected.getType(), actual.getType());
+    }
+}
+
+TEST_F(ExpressionArithmeticProgramTest, MatchesTreeEvaluation) {
+    std::vector<Document> inputs{
+        Document{{"a", 3}, {"b", 4}, {"c", 10}},
+        Document{{"a", 3LL}, {"b", 4.5}, {"c", 10}},
+        Document{{"a", Decimal128("1.5")}, {"b", 4}, {"c", -2LL}},
+        Document{{"a", std::numeric_limits<long long>::max()}, {"b", 2}, {"c", 1}},
+        Document{{"a", 3}, {"c", 10}},
+        Document{{"a", 3}, {"b", BSONNULL}, {"c", 10}},
+    };
+    assertMatchesTree(
+        getExpCtx(),
+        "{$add: [{$multiply: ['$a', '$b']}, {$subtract: ['$c', {$divide: ['$a', 2]}]}]}",
+        inputs);
+    assertMatchesTree(getExpCtx(),
+                      "{$multiply: [{$add: ['$a', '$b', 1]}, '$c', {$add: ['$c', '$a']}]}",
+                      inputs);
+    assertMatchesTree(getExpCtx(),
+                      "{$subtract: [{$add: ['$a', {$abs: '$c'}]}, {$subtract: ['$b', 1]}]}",
+                      inputs);
+}
+
+TEST_F(ExpressionArithmeticProgramTest, NullishOperandSkipsRemainingOperands) {
+    auto program = ExpressionArithmeticProgram::compile(
+        getExpCtx(), parseOptimized(getExpCtx(), "{$add: ['$missing', {$multiply: ['$s', 2]}]}"));
+    ASSERT_TRUE(isCompiled(program));
+
+    // The $multiply would fail on a string, but is never evaluated.
+    ASSERT_VALUE_EQ(Value(BSONNULL), program->evaluate(Document{{"s", "str"_sd}}));
+    ASSERT_THROWS_CODE(program->evaluate(Document{{"missing", 1}, {"s", "str"_sd}}),
+                       AssertionException,
+                       16555);
+}
+
+TEST_F(ExpressionArithmeticProgramTest, NullishOperandOfNestedSumOnlyEndsThatSum) {
+    auto program = ExpressionArithmeticProgram::compile(
+        getExpCtx(),
+        parseOptimized(getExpCtx(), "{$subtract: [{$add: ['$a', '$missing']}, '$a']}"));
+    ASSERT_TRUE(isCompiled(program));
+    ASSERT_VALUE_EQ(Value(BSONNULL), program->evaluate(Document{{"a", 1}}));
+}
+
+TEST_F(ExpressionArithmeticProgramTest, ReportsSameErrorsAsTree) {
+    auto program = ExpressionArithmeticProgram::compile(
+        getExpCtx(), parseOptimized(getExpCtx(), "{$divide: [{$add: ['$a', 1]}, '$b']}"));
+    ASSERT_TRUE(isCompiled(program));
+    ASSERT_THROWS_CODE(program->evaluate(Document{{"a", 1}, {"b", 0}}), AssertionException, 16608);
+    ASSERT_THROWS_CODE(
+        program->evaluate(Document{{"a", "str"_sd}, {"b", 1}}), AssertionException, 16554);
+}
+
+TEST_F(ExpressionArithmeticProgramTest, SerializesAsSourceExpression) {
+    auto tree = parseOptimized(getExpCtx(), "{$subtract: [{$multiply: ['$a', 2]}, '$b']}");
+    auto program = ExpressionArithmeticProgram::compile(getExpCtx(), tree);
+    ASSERT_TRUE(isCompiled(program));
+    ASSERT_VALUE_EQ(tree->serialize(false), program->serialize(false));
+
+    DepsTracker deps;
+    program->addDependencies(&deps);
+    ASSERT_EQ(2U, deps.fields.size());
+    ASSERT_EQ(1U, deps.fields.count("a"));
+    ASSERT_EQ(1U, deps.fields.count("b"));
+}
+
+TEST_F(ExpressionArithmeticProgramTest, DoesNotCompileTrivialOrNonArithmeticExpressions) {
+    ASSERT_FALSE(isCompiled(ExpressionArithmeticProgram::compile(
+        getExpCtx(), parseOptimized(getExpCtx(), "{$add: ['$a', '$b']}"))));
+    ASSERT_FALSE(isCompiled(ExpressionArithmeticProgram::compile(
+        getExpCtx(),
+        parseOptimized(getExpCtx(), "{$abs: {$add: ['$a', {$multiply: ['$b', 2]}]}}"))));
+}
+
+TEST_F(ExpressionArithmeticProgramTest, DoesNotCompileExpressionsNeedingTooManyRegisters) {
+    std::string json = "'$a'";
+    for (size_t i = 0; i < ExpressionArithmeticProgram::kMaxRegisters; ++i) {
+        json = "{$subtract: [1, " + json + "]}";
+    }
+    ASSERT_FALSE(isCompiled(
+        ExpressionArithmeticProgram::compile(getExpCtx(), parseOptimized(getExpCtx(), json))));
+}
+
+TEST_F(ExpressionArithmeticProgramTest, ProjectionEvaluatesCompiledExpressions) {
+    parsed_aggregation_projection::ParsedInclusionProjection projection(getExpCtx());
+    projection.parse(fromjson(
+        "{a: {$add: [{$multiply: ['$b', 2]}, 1]}, c: {d: {$subtract: [{$add: ['$b', 1]}, 3]}}}"));
+    projection.optimize();
+
+    auto result = projection.applyTransformation(Document{{"b", 5}});
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{a: 11, c: {d: 3}}")), result);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,214 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/hyper_log_log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "mongo/base/data_view.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+const char kHashesField[] = "hashes";
+const char kRegistersField[] = "registers";
+
+// sigma() and tau() are the series used by Ertl's estimator to account for the registers that
+// are still zero and for those that have saturated, respectively.
+double sigma(double x) {
+    if (x == 1) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double y = 1;
+    double z = x;
+    double previous;
+    do {
+        x *= x;
+        previous = z;
+        z += x * y;
+        y += y;
+    } while (z != previous);
+    return z;
+}
+
+double tau(double x) {
+    if (x == 0 || x == 1) {
+        return 0;
+    }
+    double y = 1;
+    double z = 1 - x;
+    double previous;
+    do {
+        x = std::sqrt(x);
+        previous = z;
+        y *= 0.5;
+        z -= (1 - x) * (1 - x) * y;
+    } while (z != previous);
+    return z / 3;
+}
+}  // namespace
+
+constexpr int HyperLogLog::kDefaultPrecision;
+
+HyperLogLog::HyperLogLog(int precision) : _precision(precision) {
+    invariant(_precision >= 4 && _precision <= 18);
+}
+
+void HyperLogLog::add(uint64_t hash) {
+    if (!_registers.empty()) {
+        _addToRegisters(hash);
+        return;
+    }
+
+    auto it = std::lower_bound(_hashes.begin(), _hashes.end(), hash);
+    if (it != _hashes.end() && *it == hash) {
+        return;
+    }
+    _hashes.insert(it, hash);
+
+    // Each hash takes eight bytes and each register one, so switch once the hashes would take
+    // more than half the registers' memory.
+    if (_hashes.size() * sizeof(uint64_t) > _numRegisters() / 2) {
+        _convertToRegisters();
+    }
+}
+
+void HyperLogLog::_addToRegisters(uint64_t hash) {
+    // The top bits pick the register, and the rank is one more than the number of leading zeros
+    // in the remaining 64 - precision bits.
+    const size_t index = hash >> (64 - _precision);
+    const uint64_t remaining = hash << _precision;
+    const int rank = remaining == 0 ? 64 - _precision + 1 : countLeadingZeros64(remaining) + 1;
+    if (_registers[index] < rank) {
+        _registers[index] = static_cast<uint8_t>(rank);
+    }
+}
+
+void HyperLogLog::_convertToRegisters() {
+    _registers.assign(_numRegisters(), 0);
+    for (uint64_t hash : _hashes) {
+        _addToRegisters(hash);
+    }
+    std::vector<uint64_t>().swap(_hashes);
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+    invariant(_precision == other._precision);
+
+    if (other._registers.empty()) {
+        for (uint64_t hash : other._hashes) {
+            add(hash);
+        }
+        return;
+    }
+
+    if (_registers.empty()) {
+        _convertToRegisters();
+    }
+    for (size_t i = 0; i < _registers.size(); ++i) {
+        _registers[i] = std::max(_registers[i], other._registers[i]);
+    }
+}
+
+long long HyperLogLog::estimate() const {
+    if (_registers.empty()) {
+        return _hashes.size();
+    }
+
+    const int maxRank = 64 - _precision + 1;
+    std::vector<double> histogram(maxRank + 1, 0);
+    for (uint8_t rank : _registers) {
+        histogram[rank]++;
+    }
+
+    const double m = _numRegisters();
+    double z = m * tau(1 - histogram[maxRank] / m);
+    for (int rank = maxRank - 1; rank >= 1; --rank) {
+        z = 0.5 * (z + histogram[rank]);
+    }
+    z += m * sigma(histogram[0] / m);
+
+    const double alpha = 0.5 / std::log(2.0);
+    return std::llround(alpha * m * m / z);
+}
+
+Value HyperLogLog::serialize() const {
+    if (!_registers.empty()) {
+        return Value(Document{
+            {kRegistersField,
+             BSONBinData(_registers.data(), _registers.size(), BinDataType::BinDataGeneral)}});
+    }
+
+    std::vector<char> buffer(_hashes.size() * sizeof(uint64_t));
+    for (size_t i = 0; i < _hashes.size(); ++i) {
+        DataView(buffer.data()).write<LittleEndian<uint64_t>>(_hashes[i], i * sizeof(uint64_t));
+    }
+    return Value(Document{
+        {kHashesField, BSONBinData(buffer.data(), buffer.size(), BinDataType::BinDataGeneral)}});
+}
+
+HyperLogLog HyperLogLog::parse(const Value& serialized, int precision) {
+    uassert(50820,
+            str::stream() << "expected a serialized HyperLogLog object, but found type "
+                          << typeName(serialized.getType()),
+            serialized.getType() == BSONType::Object);
+
+    HyperLogLog sketch(precision);
+    const Value registers = serialized[kRegistersField];
+    if (!registers.missing()) {
+        uassert(50821,
+                str::stream() << "a serialized HyperLogLog must have " << sketch._numRegisters()
+                              << " bytes of registers",
+                registers.getType() == BSONType::BinData &&
+                    static_cast<size_t>(registers.getBinData().length) == sketch._numRegisters());
+        const auto* data = static_cast<const uint8_t*>(registers.getBinData().data);
+        sketch._registers.assign(data, data + sketch._numRegisters());
+        return sketch;
+    }
+
+    const Value hashes = serialized[kHashesField];
+    uassert(50822,
+            "a serialized HyperLogLog must have either 'registers' or 'hashes' binary data",
+            hashes.getType() == BSONType::BinData &&
+                hashes.getBinData().length % sizeof(uint64_t) == 0);
+    ConstDataView data(static_cast<const char*>(hashes.getBinData().data));
+    for (int offset = 0; offset < hashes.getBinData().length; offset += sizeof(uint64_t)) {
+        sketch.add(data.read<LittleEndian<uint64_t>>(offset));
+    }
+    return sketch;
+}
+
+}  // namespace mongo
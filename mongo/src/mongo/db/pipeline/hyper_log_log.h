@@ -0,0 +1,107 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+/**
+ * A mergeable sketch which estimates the number of distinct 64-bit hashes added to it, in memory
+ * bounded by 2^precision bytes. Up to a small number of distinct hashes it keeps the hashes
+ * themselves and counts them exactly; past that it switches to the HyperLogLog registers, whose
+ * count is estimated with Ertl's improved estimator, which needs no empirical bias correction.
+ * The standard error of the estimate is about 1.04 / sqrt(2^precision), under 1% by default.
+ *
+ * The hashes must be well distributed over all 64 bits.
+ */
+class HyperLogLog {
+public:
+    static constexpr int kDefaultPrecision = 14;
+
+    explicit HyperLogLog(int precision = kDefaultPrecision);
+
+    void add(uint64_t hash);
+
+    /**
+     * Adds every hash summarized by 'other', which must have the same precision, to this sketch.
+     */
+    void merge(const HyperLogLog& other);
+
+    /**
+     * Returns the estimated number of distinct hashes added.
+     */
+    long long estimate() const;
+
+    /**
+     * Returns an approximation of the memory used by this sketch.
+     */
+    size_t memUsageBytes() const {
+        return sizeof(*this) + _hashes.capacity() * sizeof(uint64_t) + _registers.capacity();
+    }
+
+    /**
+     * Serializes the sketch as either {hashes: <BinData>} or {registers: <BinData>}, which parse()
+     * turns back into an equivalent sketch.
+     */
+    Value serialize() const;
+
+    /**
+     * Parses a sketch produced by serialize(). Throws if 'serialized' is not of that form.
+     */
+    static HyperLogLog parse(const Value& serialized, int precision = kDefaultPrecision);
+
+private:
+    size_t _numRegisters() const {
+        return size_t(1) << _precision;
+    }
+
+    void _addToRegisters(uint64_t hash);
+
+    /**
+     * Moves the exactly counted hashes into the registers.
+     */
+    void _convertToRegisters();
+
+    int _precision;
+
+    // The distinct hashes added, in sorted order, while there are few enough that they take less
+    // memory than the registers. Empty once the registers are in use.
+    std::vector<uint64_t> _hashes;
+
+    // One register per 2^precision hash buckets, holding the largest number of leading zeros plus
+    // one seen in the remaining bits of the hashes in the bucket. Empty until first needed.
+    std::vector<uint8_t> _registers;
+};
+
+}  // namespace mongo
@@ -0,0 +1,126 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/hyper_log_log.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+// Spreads consecutive integers over all 64 bits, as the sketch expects of its input.
+uint64_t hashOf(uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+TEST(HyperLogLogTest, CountsFewDistinctHashesExactly) {
+    HyperLogLog sketch;
+    ASSERT_EQ(sketch.estimate(), 0);
+
+    for (int i = 0; i < 500; ++i) {
+        sketch.add(hashOf(i % 250));
+    }
+    ASSERT_EQ(sketch.estimate(), 250);
+}
+
+TEST(HyperLogLogTest, EstimatesManyDistinctHashesInBoundedMemory) {
+    for (long long numDistinct : {2000LL, 20000LL, 1000000LL}) {
+        HyperLogLog sketch;
+        for (long long i = 0; i < numDistinct * 2; ++i) {
+            sketch.add(hashOf(i % numDistinct));
+        }
+        ASSERT_APPROX_EQUAL(sketch.estimate(), numDistinct, numDistinct * 3 / 100);
+        ASSERT_LT(sketch.memUsageBytes(), 20UL * 1024);
+    }
+}
+
+TEST(HyperLogLogTest, MergedSketchesEstimateTheUnion) {
+    HyperLogLog small;
+    HyperLogLog large;
+    HyperLogLog other;
+    for (int i = 0; i < 100; ++i) {
+        small.add(hashOf(i));
+    }
+    for (int i = 0; i < 50000; ++i) {
+        large.add(hashOf(i));
+        other.add(hashOf(i + 25000));
+    }
+
+    HyperLogLog merged;
+    merged.merge(small);
+    ASSERT_EQ(merged.estimate(), 100);
+
+    merged.merge(large);
+    merged.merge(other);
+    ASSERT_APPROX_EQUAL(merged.estimate(), 75000LL, 2250LL);
+
+    // Merging a sketch which still counts exactly into one using registers adds its hashes.
+    HyperLogLog registers = large;
+    registers.merge(small);
+    ASSERT_EQ(registers.estimate(), large.estimate());
+}
+
+TEST(HyperLogLogTest, SerializedSketchParsesToEquivalentSketch) {
+    HyperLogLog exact;
+    HyperLogLog estimated;
+    for (int i = 0; i < 30000; ++i) {
+        if (i < 300) {
+            exact.add(hashOf(i));
+        }
+        estimated.add(hashOf(i));
+    }
+
+    ASSERT_EQ(HyperLogLog::parse(exact.serialize()).estimate(), 300);
+    ASSERT_EQ(HyperLogLog::parse(estimated.serialize()).estimate(), estimated.estimate());
+    ASSERT_EQ(HyperLogLog::parse(HyperLogLog().serialize()).estimate(), 0);
+}
+
+TEST(HyperLogLogTest, ParseRejectsMalformedSketches) {
+    ASSERT_THROWS_CODE(HyperLogLog::parse(Value(1)), AssertionException, 50820);
+
+    const char bytes[7] = {};
+    const BSONBinData tooShort(bytes, sizeof(bytes), BinDataGeneral);
+    ASSERT_THROWS_CODE(HyperLogLog::parse(Value(Document{{"registers", tooShort}})),
+                       AssertionException,
+                       50821);
+    ASSERT_THROWS_CODE(HyperLogLog::parse(Value(Document{{"hashes", tooShort}})),
+                       AssertionException,
+                       50822);
+    ASSERT_THROWS_CODE(
+        HyperLogLog::parse(Value(Document{{"other", 1}})), AssertionException, 50822);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/lookup_hash_table.h"
+
+#include <algorithm>
+
+namespace mongo {
+
+LookupHashTable::LookupHashTable(const ValueComparator& comparator,
+                                 FieldPath foreignField,
+                                 size_t maxSizeBytes)
+    : _foreignField(std::move(foreignField)),
+      _maxSizeBytes(maxSizeBytes),
+      _index(comparator.makeUnorderedValueMap<std::vector<size_t>>()) {}
+
+bool LookupHashTable::add(BSONObj foreignDoc) {
+    const size_t position = _documents.size();
+    _sizeBytes += foreignDoc.objsize();
+
+    bool nullish = false;
+    visitKeys(foreignDoc,
+              0,
+              [&](const Value& key) {
+                  if (key.nullish()) {
+                      nullish = true;
+                  }
+                  auto& positions = _index[key];
+                  if (positions.empty()) {
+                      _sizeBytes += key.getApproximateSize();
+                  }
+                  // A document may reach the same key more than once, e.g. {a: [1, 1]}.
+                  if (positions.empty() || positions.back() != position) {
+                      positions.push_back(position);
+                      _sizeBytes += sizeof(size_t);
+                  }
+              },
+              &nullish);
+    if (nullish) {
+        _nullish.push_back(position);
+        _sizeBytes += sizeof(size_t);
+    }
+
+    _documents.push_back(foreignDoc.getOwned());
+    return _sizeBytes <= _maxSizeBytes;
+}
+
+std::vector<size_t> LookupHashTable::candidates(const std::vector<Value>& localValues) const {
+    std::vector<size_t> positions;
+    const auto addPositions = [&](const std::vector<size_t>& more) {
+        positions.insert(positions.end(), more.begin(), more.end());
+    };
+
+    if (localValues.empty()) {
+        // A missing local value is joined as null.
+        addPositions(_nullish);
+    }
+    for (auto&& value : localValues) {
+        if (value.nullish()) {
+            addPositions(_nullish);
+            continue;
+        }
+        auto it = _index.find(value);
+        if (it != _index.end()) {
+            addPositions(it->second);
+        }
+    }
+
+    if (localValues.size() > 1) {
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+    }
+    return positions;
+}
+
+template <typename OnKey>
+void LookupHashTable::visitKeys(const BSONObj& obj,
+                                size_t pathIndex,
+                                const OnKey& onKey,
+                                bool* nullish) const {
+    BSONElement elem = obj[_foreignField.getFieldName(pathIndex)];
+    if (elem.eoo()) {
+        *nullish = true;
+        return;
+    }
+    visitElement(elem, pathIndex + 1, onKey, nullish);
+}
+
+template <typename OnKey>
+void LookupHashTable::visitElement(const BSONElement& elem,
+                                   size_t pathIndex,
+                                   const OnKey& onKey,
+                                   bool* nullish) const {
+    if (pathIndex == _foreignField.getPathLength()) {
+        // An equality predicate matches a leaf array either as a whole or by any of its elements.
+        onKey(Value(elem));
+        if (elem.type() == BSONType::Array) {
+            for (auto&& arrayElem : elem.Obj()) {
+                onKey(Value(arrayElem));
+            }
+        }
+        return;
+    }
+
+    switch (elem.type()) {
+        case BSONType::Object:
+            visitKeys(elem.Obj(), pathIndex, onKey, nullish);
+            return;
+        case BSONType::Array: {
+            // The query traverses arrays of subdocuments implicitly. A numeric path component can
+            // also select an array element by position, as in "a.0".
+            const BSONObj arr = elem.Obj();
+            if (arr.isEmpty()) {
+                *nullish = true;
+            }
+            for (auto&& arrayElem : arr) {
+                if (arrayElem.type() == BSONType::Object) {
+                    visitKeys(arrayElem.Obj(), pathIndex, onKey, nullish);
+                } else {
+                    *nullish = true;
+                }
+            }
+            BSONElement positional = arr[_foreignField.getFieldName(pathIndex)];
+            if (!positional.eoo()) {
+                visitElement(positional, pathIndex + 1, onKey, nullish);
+            }
+            return;
+        }
+        default:
+            *nullish = true;
+            return;
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/pipeline/field_path.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/pipeline/value_comparator.h"
+
+namespace mongo {
+
+/**
+ * An in-memory hash table over the documents of a $lookup's foreign collection, keyed on the
+ * values found at the 'foreignField' path. It is used to answer localField/foreignField $lookups
+ * without issuing a query per input document.
+ *
+ * Lookups return candidates: a superset of the documents that the equivalent $eq/$in query would
+ * match. Callers must filter the candidates with that query to get exact $lookup semantics.
+ */
+class LookupHashTable {
+public:
+    /**
+     * Creates an empty table which hashes and compares keys with 'comparator'. 'maxSizeBytes'
+     * bounds the table's approximate memory footprint.
+     */
+    LookupHashTable(const ValueComparator& comparator, FieldPath foreignField, size_t maxSizeBytes);
+
+    /**
+     * Indexes 'foreignDoc' under every value at the foreign path. Returns false, leaving the table
+     * unusable, if adding the document took the table over its size limit.
+     */
+    bool add(BSONObj foreignDoc);
+
+    /**
+     * Returns the positions of the documents that may match any of 'localValues', in the order
+     * the documents were added and without duplicates. A null or undefined local value matches
+     * every document in which the foreign path is missing or nullish somewhere.
+     */
+    std::vector<size_t> candidates(const std::vector<Value>& localValues) const;
+
+    const BSONObj& document(size_t position) const {
+        return _documents[position];
+    }
+
+    size_t sizeBytes() const {
+        return _sizeBytes;
+    }
+
+private:
+    /**
+     * Calls 'onKey' with each value reachable at the foreign path from 'obj', starting at path
+     * component 'pathIndex'. Sets '*nullish' if some branch of the path ends without a value.
+     */
+    template <typename OnKey>
+    void visitKeys(const BSONObj& obj, size_t pathIndex, const OnKey& onKey, bool* nullish) const;
+
+    template <typename OnKey>
+    void visitElement(const BSONElement& elem,
+                      size_t pathIndex,
+                      const OnKey& onKey,
+                      bool* nullish) const;
+
+    const FieldPath _foreignField;
+    const size_t _maxSizeBytes;
+    size_t _sizeBytes = 0;
+
+    std::vector<BSONObj> _documents;
+    ValueUnorderedMap<std::vector<size_t>> _index;
+
+    // Documents in which the foreign path is missing, null or undefined along some branch. These
+    // are the candidates for a null local value, since {$eq: null} also matches missing fields.
+    std::vector<size_t> _nullish;
+};
+
+}  // namespace mongo
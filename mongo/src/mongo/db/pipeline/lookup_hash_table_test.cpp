@@ -0,0 +1,124 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/db/pipeline/lookup_hash_table.h"
+#include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Positions = std::vector<size_t>;
+
+const ValueComparator defaultComparator{nullptr};
+const size_t kNoSizeLimit = 1024 * 1024;
+
+TEST(LookupHashTableTest, FindsDocumentsByScalarKey) {
+    LookupHashTable table(defaultComparator, FieldPath("a"), kNoSizeLimit);
+    ASSERT_TRUE(table.add(fromjson("{_id: 0, a: 1}")));
+    ASSERT_TRUE(table.add(fromjson("{_id: 1, a: 2}")));
+    ASSERT_TRUE(table.add(fromjson("{_id: 2, a: 1.0}")));
+
+    ASSERT(table.candidates({Value(1)}) == (Positions{0, 2}));
+    ASSERT(table.candidates({Value(2)}) == (Positions{1}));
+    ASSERT(table.candidates({Value(3)}).empty());
+    ASSERT_BSONOBJ_EQ(table.document(1), fromjson("{_id: 1, a: 2}"));
+}
+
+TEST(LookupHashTableTest, MultipleLocalValuesReturnEachDocumentOnceInInsertionOrder) {
+    LookupHashTable table(defaultComparator, FieldPath("a"), kNoSizeLimit);
+    ASSERT_TRUE(table.add(fromjson("{_id: 0, a: [1, 2]}")));
+    ASSERT_TRUE(table.add(fromjson("{_id: 1, a: 2}")));
+    ASSERT_TRUE(table.add(fromjson("{_id: 2, a: 1}")));
+
+    ASSERT(table.candidates({Value(2), Value(1)}) == (Positions{0, 1, 2}));
+}
+
+TEST(LookupHashTableTest, IndexesLeafArraysWholeAndByElement) {
+    LookupHashTable table(defaultComparator, FieldPath("a"), kNoSizeLimit);
+    ASSERT_TRUE(table.add(fromjson("{_id: 0, a: [1, [2, 3]]}")));
+
+    ASSERT(table.candidates({Value(1)}) == (Positions{0}));
+    ASSERT(table.candidates({Value(BSON_ARRAY(2 << 3))}) == (Positions{0}));
+    ASSERT(table.candidates({Value(2)}).empty());
+}
+
+TEST(LookupHashTableTest, TraversesArraysOfSubdocumentsAndPositionalPaths) {
+    LookupHashTable table(defaultComparator, FieldPath("a.b"), kNoSizeLimit);
+    ASSERT_TRUE(table.add(fromjson("{_id: 0, a: [{b: 1}, {b: 2}]}")));
+    ASSERT_TRUE(table.add(fromjson("{_id: 1, a: {b: 2}}")));
+
+    ASSERT(table.candidates({Value(2)}) == (Positions{0, 1}));
+
+    LookupHashTable positional(defaultComparator, FieldPath("a.0"), kNoSizeLimit);
+    ASSERT_TRUE(positional.add(fromjson("{_id: 0, a: [5, 6]}")));
+    ASSERT(positional.candidates({Value(5)}) == (Positions{0}));
+}
+
+TEST(LookupHashTableTest, NullLocalValueFindsMissingAndNullishForeignValues) {
+    LookupHashTable table(defaultComparator, FieldPath("a.b"), kNoSizeLimit);
+    ASSERT_TRUE(table.add(fromjson("{_id: 0, a: {b: 1}}")));
+    ASSERT_TRUE(table.add(fromjson("{_id: 1}")));
+    ASSERT_TRUE(table.add(fromjson("{_id: 2, a: {b: null}}")));
+    ASSERT_TRUE(table.add(fromjson("{_id: 3, a: [{b: 1}, {c: 1}]}")));
+    ASSERT_TRUE(table.add(fromjson("{_id: 4, a: 1}")));
+
+    ASSERT(table.candidates({Value(BSONNULL)}) == (Positions{1, 2, 3, 4}));
+    ASSERT(table.candidates(std::vector<Value>{}) == (Positions{1, 2, 3, 4}));
+}
+
+TEST(LookupHashTableTest, RespectsCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    const ValueComparator comparator(&collator);
+    LookupHashTable table(comparator, FieldPath("a"), kNoSizeLimit);
+    ASSERT_TRUE(table.add(fromjson("{_id: 0, a: 'foo'}")));
+
+    ASSERT(table.candidates({Value("bar"_sd)}) == (Positions{0}));
+}
+
+TEST(LookupHashTableTest, ReportsWhenSizeLimitIsExceeded) {
+    const BSONObj doc = fromjson("{_id: 0, a: 1}");
+    LookupHashTable unbounded(defaultComparator, FieldPath("a"), kNoSizeLimit);
+    ASSERT_TRUE(unbounded.add(doc));
+    ASSERT_TRUE(unbounded.add(doc));
+
+    LookupHashTable table(defaultComparator, FieldPath("a"), unbounded.sizeBytes());
+    ASSERT_TRUE(table.add(doc));
+    ASSERT_TRUE(table.add(doc));
+    ASSERT_FALSE(table.add(doc));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -32,6 +32,8 @@
 
 #include <algorithm>
 
+#include "mongo/db/pipeline/expression_program.h"
+
 namespace mongo {
 
 namespace parsed_aggregation_projection {
@@ -45,12 +47,13 @@ using std::unique_ptr;
 
 InclusionNode::InclusionNode(std::string pathToNode) : _pathToNode(std::move(pathToNode)) {}
 
-void InclusionNode::optimize() {
+void InclusionNode::optimize(const boost::intrusive_ptr<ExpressionContext>& expCtx) {
     for (auto&& expressionIt : _expressions) {
-        _expressions[expressionIt.first] = expressionIt.second->optimize();
+        _expressions[expressionIt.first] =
+            ExpressionArithmeticProgram::compile(expCtx, expressionIt.second->optimize());
     }
     for (auto&& childPair : _children) {
-        childPair.second->optimize();
+        childPair.second->optimize(expCtx);
     }
 }
 
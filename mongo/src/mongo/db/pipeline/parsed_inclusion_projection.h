@@ -55,9 +55,9 @@ public:
     InclusionNode(std::string pathToNode = "");
 
     /**
-     * Optimize any computed expressions.
+     * Optimize any computed expressions, compiling arithmetic expressions into flat programs.
      */
-    void optimize();
+    void optimize(const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
     /**
      * Serialize this projection.
@@ -212,7 +212,7 @@ public:
      * Optimize any computed expressions.
      */
     void optimize() final {
-        _root->optimize();
+        _root->optimize(_expCtx);
     }
 
     DocumentSource::GetDepsReturn addDependencies(DepsTracker* deps) const final {
@@ -388,6 +388,11 @@ void Pipeline::Optimizations::Sharded::findSplitPoint(Pipeline* shardPipe, Pipel
                 mergePipe->_sources.push_front(*it);
             }
 
+            // A stage which runs entirely on the shards does not end the shards' part.
+            if (shardSource == current && mergeSources.empty()) {
+                continue;
+            }
+
             break;
         }
     }
@@ -42,6 +42,7 @@
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/exec/fetch.h"
@@ -52,6 +53,7 @@
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/ops/write_ops_exec.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 #include "mongo/db/pipeline/document_source_cursor.h"
@@ -65,6 +67,7 @@
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
@@ -74,6 +77,7 @@
 #include "mongo/db/stats/fill_locker_info.h"
 #include "mongo/db/stats/storage_stats.h"
 #include "mongo/db/stats/top.h"
+#include "mongo/db/storage/block_sample_record_cursor.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/sorted_data_interface.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
@@ -118,13 +122,63 @@ public:
         return bool(css->getMetadata());
     }
 
-    BSONObj insert(const NamespaceString& ns, const std::vector<BSONObj>& objs) final {
+    Status insert(const NamespaceString& ns, const std::vector<BSONObj>& objs) final {
         boost::optional<DisableDocumentValidation> maybeDisableValidation;
         if (_ctx->bypassDocumentValidation)
             maybeDisableValidation.emplace(_ctx->opCtx);
 
-        _client.insert(ns.ns(), objs);
-        return _client.getLastErrorDetailed();
+        // Use the batched insert path of the insert command directly, rather than serializing the
+        // batch into a message for the DBDirectClient. The nested CurOp keeps the insert from
+        // being reported as the aggregation's own operation.
+        CurOp insertCurOp(_ctx->opCtx);
+        write_ops::Insert insertOp(ns);
+        insertOp.setDocuments(objs);
+        const auto result = performInserts(_ctx->opCtx, insertOp);
+
+        if (result.staleConfigException) {
+            return result.staleConfigException->toStatus();
+        }
+        for (auto&& singleResult : result.results) {
+            if (!singleResult.isOK()) {
+                return singleResult.getStatus();
+            }
+        }
+        return Status::OK();
+    }
+
+    BSONObj getColocatedCollectionVersion(const NamespaceString& localNs,
+                                          StringData localField,
+                                          const NamespaceString& foreignNs,
+                                          StringData foreignField) final {
+        auto getMetadata = [this](const NamespaceString& nss) {
+            AutoGetCollectionForReadCommand autoColl(_ctx->opCtx, nss);
+            return CollectionShardingState::get(_ctx->opCtx, nss)->getMetadata();
+        };
+        auto localMetadata = getMetadata(localNs);
+        auto foreignMetadata = getMetadata(foreignNs);
+        if (!localMetadata || !foreignMetadata) {
+            return BSONObj();
+        }
+
+        const auto& localKey = localMetadata->getKeyPattern();
+        const auto& foreignKey = foreignMetadata->getKeyPattern();
+        if (localKey.nFields() != 1 || foreignKey.nFields() != 1 ||
+            StringData(localKey.firstElementFieldName()) != localField ||
+            StringData(foreignKey.firstElementFieldName()) != foreignField) {
+            return BSONObj();
+        }
+
+        if (!localMetadata->getChunkManager()->isColocatedWith(
+                *foreignMetadata->getChunkManager())) {
+            return BSONObj();
+        }
+        return foreignMetadata->getCollVersion().toBSON();
+    }
+
+    BSONObj getShardedCollectionVersion(const NamespaceString& ns) final {
+        AutoGetCollection autoColl(_ctx->opCtx, ns, MODE_IS);
+        auto metadata = CollectionShardingState::get(_ctx->opCtx, ns)->getMetadata();
+        return metadata ? metadata->getCollVersion().toBSON() : BSONObj();
     }
 
     CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
@@ -137,7 +191,26 @@ public:
             return CollectionIndexUsageMap();
         }
 
-        return collection->infoCache()->getIndexUsageStats();
+        auto stats = collection->infoCache()->getIndexUsageStats();
+
+        // Cache usage is a property of the storage engine's current state rather than something
+        // the usage tracker accumulates, so it is read here.
+        IndexCatalog::IndexIterator ii =
+            collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+        while (ii.more()) {
+            const IndexDescriptor* descriptor = ii.next();
+            auto it = stats.find(descriptor->indexName());
+            if (it == stats.end()) {
+                continue;
+            }
+
+            auto cacheBytes = ii.accessMethod(descriptor)->getCacheUsageBytes(opCtx);
+            if (cacheBytes.isOK()) {
+                it->second.cacheBytes = cacheBytes.getValue();
+            }
+        }
+
+        return stats;
     }
 
     void appendLatencyStats(const NamespaceString& nss,
@@ -254,7 +327,7 @@ public:
         auto css = CollectionShardingState::get(_ctx->opCtx, expCtx->ns);
         uassert(4567,
                 str::stream() << "from collection (" << expCtx->ns.ns() << ") cannot be sharded",
-                !bool(css->getMetadata()));
+                expCtx->allowShardedCollection || !bool(css->getMetadata()));
 
         PipelineD::prepareCursorSource(autoColl->getCollection(), expCtx->ns, nullptr, pipeline);
         // Optimize again, since there may be additional optimizations that can be done after adding
@@ -266,11 +339,17 @@ public:
 
     std::vector<BSONObj> getCurrentOps(CurrentOpConnectionsMode connMode,
                                        CurrentOpUserMode userMode,
-                                       CurrentOpTruncateMode truncateMode) const {
+                                       CurrentOpTruncateMode truncateMode,
+                                       CurrentOpReportMode reportMode,
+                                       const MatchExpression* summaryFilter) const {
         AuthorizationSession* ctxAuth = AuthorizationSession::get(_ctx->opCtx->getClient());
 
         const std::string hostName = getHostNameCachedAndPort();
 
+        // If auth is disabled, ignore the allUsers parameter.
+        const bool onlyCoauthorized = ctxAuth->getAuthorizationManager().isAuthEnabled() &&
+            userMode == CurrentOpUserMode::kExcludeOthers;
+
         std::vector<BSONObj> ops;
 
         for (ServiceContext::LockedClientsCursor cursor(
@@ -278,12 +357,37 @@ public:
              Client* client = cursor.next();) {
             invariant(client);
 
+            // The published summary is read without the client lock, which is only taken for the
+            // operations which will be reported in full.
+            if (reportMode == CurrentOpReportMode::kSummaries || summaryFilter) {
+                const auto summary = client->getPublishedOpState().read();
+                if (!summary.active && connMode == CurrentOpConnectionsMode::kExcludeIdle) {
+                    continue;
+                }
+
+                BSONObj summaryObj = _reportSummary(hostName, client, summary);
+
+                // A truncated namespace is not compared, as the full report has the whole one.
+                if (summaryFilter && !summary.nsTruncated &&
+                    !summaryFilter->matchesBSON(summaryObj)) {
+                    continue;
+                }
+
+                if (reportMode == CurrentOpReportMode::kSummaries) {
+                    if (onlyCoauthorized) {
+                        stdx::lock_guard<Client> lk(*client);
+                        if (!ctxAuth->isCoauthorizedWithClient(client)) {
+                            continue;
+                        }
+                    }
+                    ops.emplace_back(std::move(summaryObj));
+                    continue;
+                }
+            }
+
             stdx::lock_guard<Client> lk(*client);
 
-            // If auth is disabled, ignore the allUsers parameter.
-            if (ctxAuth->getAuthorizationManager().isAuthEnabled() &&
-                userMode == CurrentOpUserMode::kExcludeOthers &&
-                !ctxAuth->isCoauthorizedWithClient(client)) {
+            if (onlyCoauthorized && !ctxAuth->isCoauthorizedWithClient(client)) {
                 continue;
             }
 
@@ -344,6 +448,42 @@ public:
         return ops;
     }
 
+    /**
+     * Builds the summary report of the operation of 'client' from its published state. Only reads
+     * the fields of the client which never change, so the client lock is not needed.
+     */
+    static BSONObj _reportSummary(const std::string& hostName,
+                                  const Client* client,
+                                  const PublishedOpState::Snapshot& summary) {
+        BSONObjBuilder builder;
+        builder.append("host", hostName);
+        builder.append("desc", client->desc());
+        if (client->getConnectionId()) {
+            builder.appendNumber("connectionId", client->getConnectionId());
+        }
+        if (client->hasRemote()) {
+            builder.append("client", client->getRemote().toString());
+        }
+        builder.appendBool("active", summary.active);
+
+        if (summary.active) {
+            builder.append("opid", summary.opId);
+            if (summary.killPending) {
+                builder.append("killPending", true);
+            }
+            if (summary.startMicros) {
+                const Microseconds elapsed{
+                    static_cast<long long>(curTimeMicros64()) - summary.startMicros};
+                builder.append("secs_running", durationCount<Seconds>(elapsed));
+                builder.append("microsecs_running", durationCount<Microseconds>(elapsed));
+            }
+            builder.append("op", logicalOpToString(summary.logicalOp));
+            builder.append("ns", summary.ns);
+        }
+
+        return builder.obj();
+    }
+
     std::string getShardName(OperationContext* opCtx) const {
         if (ShardingState::get(opCtx)->enabled()) {
             return ShardingState::get(opCtx)->getShardName();
@@ -449,19 +589,41 @@ private:
  * Returns a PlanExecutor which uses a random cursor to sample documents if successful. Returns {}
  * if the storage engine doesn't support random cursors, or if 'sampleSize' is a large enough
  * percentage of the collection.
+ *
+ * Larger samples of non-capped collections may be read in blocks of neighbouring documents, see
+ * 'internalDocumentSourceSampleBlockSize'.
  */
 StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> createRandomCursorExecutor(
     Collection* collection, OperationContext* opCtx, long long sampleSize, long long numRecords) {
     double kMaxSampleRatioForRandCursor = 0.05;
-    if (sampleSize > numRecords * kMaxSampleRatioForRandCursor || numRecords <= 100) {
+    if (numRecords <= 100) {
         return {nullptr};
     }
 
+    const int blockSize = internalDocumentSourceSampleBlockSize.load();
+    bool useBlockSampling = false;
+    if (sampleSize > numRecords * kMaxSampleRatioForRandCursor) {
+        useBlockSampling = blockSize > 0 && !collection->isCapped() &&
+            sampleSize <= numRecords * internalDocumentSourceSampleBlockMaxSampleRatio.load();
+        if (!useBlockSampling) {
+            return {nullptr};
+        }
+    }
+
     // Attempt to get a random cursor from the RecordStore. If the RecordStore does not support
     // random cursors, attempt to get one from the _id index.
     std::unique_ptr<RecordCursor> rsRandCursor =
         collection->getRecordStore()->getRandomCursor(opCtx);
 
+    if (useBlockSampling) {
+        if (!rsRandCursor) {
+            // Only the RecordStore's random cursor can be combined with a forward scan.
+            return {nullptr};
+        }
+        rsRandCursor = stdx::make_unique<BlockSampleRecordCursor>(
+            std::move(rsRandCursor), collection->getCursor(opCtx), blockSize);
+    }
+
     auto ws = stdx::make_unique<WorkingSet>();
     std::unique_ptr<PlanStage> stage;
 
@@ -528,13 +690,17 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> attemptToGetExe
     BSONObj projectionObj,
     BSONObj sortObj,
     const AggregationRequest* aggRequest,
-    const size_t plannerOpts) {
+    const size_t plannerOpts,
+    boost::optional<long long> limit = boost::none,
+    size_t maxBlockingSortBytes = 0) {
     auto qr = stdx::make_unique<QueryRequest>(nss);
     qr->setTailableMode(pExpCtx->tailableMode);
     qr->setOplogReplay(oplogReplay);
     qr->setFilter(queryObj);
     qr->setProj(projectionObj);
     qr->setSort(sortObj);
+    qr->setLimit(limit);
+    qr->setMaxBlockingSortBytes(maxBlockingSortBytes);
     if (aggRequest) {
         qr->setExplain(static_cast<bool>(aggRequest->getExplain()));
         qr->setHint(aggRequest->getHint());
@@ -742,9 +908,13 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
     // The only way to get a text score or the sort key is to let the query system handle the
     // projection. In all other cases, unless the query system can do an index-covered projection
     // and avoid going to the raw record at all, it is faster to have ParsedDeps filter the fields
-    // we need.
+    // we need. An index which holds every field we need can cover the projection even when there
+    // is no predicate to scan it with, so ask the planner to consider whole index scans too; the
+    // pipeline then never fetches a document, which is what most $group pipelines want.
+    const size_t coveredProjectionOpts =
+        QueryPlannerParams::NO_UNCOVERED_PROJECTIONS | QueryPlannerParams::GENERATE_COVERED_IXSCANS;
     if (!deps.getNeedTextScore() && !deps.getNeedSortKey()) {
-        plannerOpts |= QueryPlannerParams::NO_UNCOVERED_PROJECTIONS;
+        plannerOpts |= coveredProjectionOpts;
     }
 
     if (expCtx->needsMerge && expCtx->tailableMode == TailableMode::kTailableAndAwaitData) {
@@ -811,7 +981,44 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
                     << "Failed to determine whether query system can provide a non-blocking sort: "
                     << swExecutorSort.getStatus().toString()};
         }
-        // The query system can't provide a non-blocking sort.
+        // The query system can't provide a non-blocking sort. If a small $limit was coalesced
+        // into the $sort, the SORT stage of the query system still runs the top-k sort more
+        // cheaply than DocumentSourceSort: it extracts sort keys from the BSON of each document,
+        // so the documents it discards are never converted to Documents. The SORT stage is given
+        // the memory limit of the $sort rather than the lower
+        // internalQueryExecMaxBlockingSortBytes, so it only fails where the $sort would have. With
+        // allowDiskUse, DocumentSourceSort can spill where the SORT stage would fail, so the sort
+        // is left to it.
+        const long long limit = sortStage->getLimit();
+        if (collection && !expCtx->allowDiskUse && limit > 0 &&
+            limit <= internalDocumentSourceSortTopKPushdownMaxLimit.load()) {
+            auto swExecutorTopK =
+                attemptToGetExecutor(opCtx,
+                                     collection,
+                                     nss,
+                                     expCtx,
+                                     oplogReplay,
+                                     queryObj,
+                                     expCtx->needsMerge ? metaSortProjection : emptyProjection,
+                                     *sortObj,
+                                     aggRequest,
+                                     plannerOpts & ~QueryPlannerParams::NO_BLOCKING_SORT,
+                                     limit,
+                                     sortStage->getMaxMemoryUsageBytes());
+
+            if (swExecutorTopK.isOK()) {
+                *projectionObj = BSONObj();
+                pipeline->_sources.pop_front();
+                pipeline->_sources.push_front(sortStage->getLimitSrc());
+                return std::move(swExecutorTopK.getValue());
+            } else if (swExecutorTopK == ErrorCodes::QueryPlanKilled) {
+                return {ErrorCodes::OperationFailed,
+                        str::stream() << "Failed to determine whether query system can provide a "
+                                         "top-k sort: "
+                                      << swExecutorTopK.getStatus().toString()};
+            }
+        }
+
         *sortObj = BSONObj();
     }
 
@@ -824,7 +1031,7 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
         // before, but now we know the query system won't cover the sort, so we will be able to
         // compute the sort key ourselves during the $sort stage, and thus don't need a query
         // projection to do so.
-        plannerOpts |= QueryPlannerParams::NO_UNCOVERED_PROJECTIONS;
+        plannerOpts |= coveredProjectionOpts;
     }
 
     // See if the query system can cover the projection.
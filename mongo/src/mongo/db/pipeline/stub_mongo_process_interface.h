@@ -55,7 +55,7 @@ public:
         MONGO_UNREACHABLE;
     }
 
-    BSONObj insert(const NamespaceString& ns, const std::vector<BSONObj>& objs) override {
+    Status insert(const NamespaceString& ns, const std::vector<BSONObj>& objs) override {
         MONGO_UNREACHABLE;
     }
 
@@ -64,6 +64,17 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    BSONObj getColocatedCollectionVersion(const NamespaceString& localNs,
+                                          StringData localField,
+                                          const NamespaceString& foreignNs,
+                                          StringData foreignField) override {
+        MONGO_UNREACHABLE;
+    }
+
+    BSONObj getShardedCollectionVersion(const NamespaceString& ns) override {
+        MONGO_UNREACHABLE;
+    }
+
     void appendLatencyStats(const NamespaceString& nss,
                             bool includeHistograms,
                             BSONObjBuilder* builder) const override {
@@ -106,7 +117,9 @@ public:
 
     std::vector<BSONObj> getCurrentOps(CurrentOpConnectionsMode connMode,
                                        CurrentOpUserMode userMode,
-                                       CurrentOpTruncateMode truncateMode) const override {
+                                       CurrentOpTruncateMode truncateMode,
+                                       CurrentOpReportMode reportMode,
+                                       const MatchExpression* summaryFilter) const override {
         MONGO_UNREACHABLE;
     }
 
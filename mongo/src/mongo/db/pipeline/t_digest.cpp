@@ -0,0 +1,237 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/t_digest.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/pipeline/document.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+const char kMeansField[] = "means";
+const char kWeightsField[] = "weights";
+const char kMinField[] = "min";
+const char kMaxField[] = "max";
+
+const double kPi = 3.14159265358979323846;
+}  // namespace
+
+constexpr double TDigest::kDefaultCompression;
+
+TDigest::TDigest(double compression) : _compression(compression) {
+    invariant(_compression > 0);
+}
+
+void TDigest::add(double value) {
+    if (!std::isfinite(value)) {
+        return;
+    }
+
+    if (empty()) {
+        _min = _max = value;
+    } else {
+        _min = std::min(_min, value);
+        _max = std::max(_max, value);
+    }
+    _unmerged.push_back({value, 1});
+    _totalWeight += 1;
+
+    // Buffering values and compressing them in bulk amortizes the sort over many additions.
+    if (_unmerged.size() >= static_cast<size_t>(_compression * 5)) {
+        _compress();
+    }
+}
+
+void TDigest::merge(const TDigest& other) {
+    if (other.empty()) {
+        return;
+    }
+
+    if (empty()) {
+        _min = other._min;
+        _max = other._max;
+    } else {
+        _min = std::min(_min, other._min);
+        _max = std::max(_max, other._max);
+    }
+    _unmerged.insert(_unmerged.end(), other._centroids.begin(), other._centroids.end());
+    _unmerged.insert(_unmerged.end(), other._unmerged.begin(), other._unmerged.end());
+    _totalWeight += other._totalWeight;
+
+    if (_unmerged.size() >= static_cast<size_t>(_compression * 5)) {
+        _compress();
+    }
+}
+
+void TDigest::_compress() {
+    if (_unmerged.empty()) {
+        return;
+    }
+
+    std::vector<Centroid> sorted;
+    sorted.reserve(_centroids.size() + _unmerged.size());
+    sorted.insert(sorted.end(), _centroids.begin(), _centroids.end());
+    sorted.insert(sorted.end(), _unmerged.begin(), _unmerged.end());
+    _unmerged.clear();
+    std::sort(sorted.begin(), sorted.end(), [](const Centroid& lhs, const Centroid& rhs) {
+        return lhs.mean < rhs.mean;
+    });
+
+    // The scale function k(q) = compression / (2 * pi) * asin(2q - 1) maps quantiles onto a scale
+    // on which every centroid may span at most one unit. It is steep near q = 0 and q = 1, which
+    // keeps the centroids in the tails small.
+    const double normalizer = _compression / (2 * kPi);
+    auto quantileLimit = [&](double weightSoFar) {
+        const double k = normalizer * std::asin(2 * weightSoFar / _totalWeight - 1) + 1;
+        if (k >= _compression / 4) {
+            return 1.0;
+        }
+        return (std::sin(k / normalizer) + 1) / 2;
+    };
+
+    std::vector<Centroid> compressed;
+    double weightSoFar = 0;
+    double limit = quantileLimit(weightSoFar) * _totalWeight;
+    Centroid current = sorted.front();
+    for (size_t i = 1; i < sorted.size(); ++i) {
+        const Centroid& next = sorted[i];
+        if (weightSoFar + current.weight + next.weight <= limit) {
+            current.weight += next.weight;
+            current.mean += (next.mean - current.mean) * next.weight / current.weight;
+        } else {
+            weightSoFar += current.weight;
+            compressed.push_back(current);
+            limit = quantileLimit(weightSoFar) * _totalWeight;
+            current = next;
+        }
+    }
+    compressed.push_back(current);
+    _centroids.swap(compressed);
+}
+
+double TDigest::quantile(double q) {
+    invariant(!empty());
+    _compress();
+
+    if (q <= 0) {
+        return _min;
+    }
+    if (q >= 1) {
+        return _max;
+    }
+
+    // Each centroid is assumed to be centered on its mean, so the estimate is interpolated
+    // between the means of the two centroids whose centers surround the target rank. Below the
+    // first center and above the last one, it is interpolated towards the exact min and max.
+    const double rank = q * _totalWeight;
+    double estimate;
+    const Centroid& first = _centroids.front();
+    const Centroid& last = _centroids.back();
+    if (rank < first.weight / 2) {
+        estimate = _min + (first.mean - _min) * rank / (first.weight / 2);
+    } else if (rank >= _totalWeight - last.weight / 2) {
+        const double lastCenter = _totalWeight - last.weight / 2;
+        estimate = last.mean + (_max - last.mean) * (rank - lastCenter) / (last.weight / 2);
+    } else {
+        estimate = last.mean;
+        double weightSoFar = 0;
+        for (size_t i = 0; i + 1 < _centroids.size(); ++i) {
+            const Centroid& left = _centroids[i];
+            const Centroid& right = _centroids[i + 1];
+            const double leftCenter = weightSoFar + left.weight / 2;
+            const double rightCenter = weightSoFar + left.weight + right.weight / 2;
+            if (rank < rightCenter) {
+                estimate = left.mean +
+                    (right.mean - left.mean) * (rank - leftCenter) / (rightCenter - leftCenter);
+                break;
+            }
+            weightSoFar += left.weight;
+        }
+    }
+
+    return std::max(_min, std::min(_max, estimate));
+}
+
+Value TDigest::serialize() {
+    _compress();
+
+    std::vector<Value> means;
+    std::vector<Value> weights;
+    means.reserve(_centroids.size());
+    weights.reserve(_centroids.size());
+    for (auto&& centroid : _centroids) {
+        means.push_back(Value(centroid.mean));
+        weights.push_back(Value(centroid.weight));
+    }
+    return Value(Document{{kMeansField, Value(std::move(means))},
+                          {kWeightsField, Value(std::move(weights))},
+                          {kMinField, _min},
+                          {kMaxField, _max}});
+}
+
+TDigest TDigest::parse(const Value& serialized, double compression) {
+    uassert(50810,
+            str::stream() << "expected a serialized t-digest object, but found type "
+                          << typeName(serialized.getType()),
+            serialized.getType() == BSONType::Object);
+
+    const Value means = serialized[kMeansField];
+    const Value weights = serialized[kWeightsField];
+    const Value min = serialized[kMinField];
+    const Value max = serialized[kMaxField];
+    uassert(50811,
+            "a serialized t-digest must have 'means' and 'weights' arrays of equal length, and "
+            "numeric 'min' and 'max' fields",
+            means.getType() == BSONType::Array && weights.getType() == BSONType::Array &&
+                means.getArrayLength() == weights.getArrayLength() && min.numeric() &&
+                max.numeric());
+
+    TDigest digest(compression);
+    for (size_t i = 0; i < means.getArrayLength(); ++i) {
+        const Value mean = means[i];
+        const Value weight = weights[i];
+        uassert(50812,
+                "a serialized t-digest must have numeric means and positive numeric weights",
+                mean.numeric() && weight.numeric() && weight.coerceToDouble() > 0);
+        digest._unmerged.push_back({mean.coerceToDouble(), weight.coerceToDouble()});
+        digest._totalWeight += weight.coerceToDouble();
+    }
+    digest._min = min.coerceToDouble();
+    digest._max = max.coerceToDouble();
+    digest._compress();
+    return digest;
+}
+
+}  // namespace mongo
@@ -0,0 +1,126 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+/**
+ * A mergeable sketch of a distribution of doubles, from which quantiles can be estimated in a
+ * single pass over the data and in memory bounded by the compression parameter. This is the
+ * merging variant of Dunning's t-digest: values are clustered into weighted centroids, which are
+ * kept small near the tails of the distribution, so extreme quantiles are estimated far more
+ * accurately than the median.
+ *
+ * Digests built over disjoint inputs can be merged, and the quantiles of the merged digest
+ * estimate those of the combined input. A digest holding at most a few dozen values keeps each of
+ * them as its own centroid, so its quantiles are interpolated between the exact values.
+ */
+class TDigest {
+public:
+    static constexpr double kDefaultCompression = 100.0;
+
+    explicit TDigest(double compression = kDefaultCompression);
+
+    /**
+     * Adds 'value' to the distribution. NaN and infinite values are ignored.
+     */
+    void add(double value);
+
+    /**
+     * Adds every value summarized by 'other' to this distribution.
+     */
+    void merge(const TDigest& other);
+
+    /**
+     * Returns an estimate of the 'q' quantile of the distribution, where 'q' is in [0, 1]. The
+     * estimate is always between the smallest and the largest value added. Must not be called on
+     * an empty digest.
+     */
+    double quantile(double q);
+
+    /**
+     * Returns the number of values added to the distribution.
+     */
+    double count() const {
+        return _totalWeight;
+    }
+
+    bool empty() const {
+        return _totalWeight == 0;
+    }
+
+    /**
+     * Returns an approximation of the memory used by this digest.
+     */
+    size_t memUsageBytes() const {
+        return sizeof(*this) + (_centroids.capacity() + _unmerged.capacity()) * sizeof(Centroid);
+    }
+
+    /**
+     * Serializes the digest as a document of the form {means: [...], weights: [...], min: <min>,
+     * max: <max>}, which parse() turns back into an equivalent digest.
+     */
+    Value serialize();
+
+    /**
+     * Parses a digest produced by serialize(). Throws if 'serialized' is not of that form.
+     */
+    static TDigest parse(const Value& serialized, double compression = kDefaultCompression);
+
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    /**
+     * Folds the values added since the last compression into the centroids.
+     */
+    void _compress();
+
+    double _compression;
+
+    // Sorted by mean, and compressed so that no centroid covers more of the distribution than the
+    // scale function allows at its position.
+    std::vector<Centroid> _centroids;
+
+    // Values added or merged since the last compression.
+    std::vector<Centroid> _unmerged;
+
+    double _totalWeight = 0;
+    double _min = 0;
+    double _max = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,143 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/t_digest.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(TDigestTest, SmallInputsInterpolateBetweenExactValues) {
+    TDigest digest;
+    for (double value : {4.0, 1.0, 3.0, 2.0}) {
+        digest.add(value);
+    }
+
+    ASSERT_EQ(digest.count(), 4.0);
+    ASSERT_EQ(digest.quantile(0), 1.0);
+    ASSERT_EQ(digest.quantile(0.5), 2.5);
+    ASSERT_EQ(digest.quantile(1), 4.0);
+}
+
+TEST(TDigestTest, SingleValueIsEveryQuantile) {
+    TDigest digest;
+    digest.add(7);
+
+    ASSERT_EQ(digest.quantile(0), 7.0);
+    ASSERT_EQ(digest.quantile(0.3), 7.0);
+    ASSERT_EQ(digest.quantile(1), 7.0);
+}
+
+TEST(TDigestTest, IgnoresNaNAndInfiniteValues) {
+    TDigest digest;
+    digest.add(std::numeric_limits<double>::quiet_NaN());
+    digest.add(std::numeric_limits<double>::infinity());
+    ASSERT_TRUE(digest.empty());
+
+    digest.add(1);
+    digest.add(-std::numeric_limits<double>::infinity());
+    ASSERT_EQ(digest.count(), 1.0);
+    ASSERT_EQ(digest.quantile(0.5), 1.0);
+}
+
+TEST(TDigestTest, EstimatesQuantilesOfLargeInputsInBoundedMemory) {
+    TDigest digest;
+    const int numValues = 1000000;
+    for (int i = 0; i < numValues; ++i) {
+        // Visit the values in a scrambled order, so that they do not arrive sorted.
+        digest.add((static_cast<long long>(i) * 7919) % numValues);
+    }
+
+    ASSERT_APPROX_EQUAL(digest.quantile(0.5), 500000.0, 5000.0);
+    ASSERT_APPROX_EQUAL(digest.quantile(0.9), 900000.0, 3000.0);
+    ASSERT_APPROX_EQUAL(digest.quantile(0.999), 999000.0, 500.0);
+    ASSERT_APPROX_EQUAL(digest.quantile(0.001), 1000.0, 500.0);
+    ASSERT_LT(digest.memUsageBytes(), 64UL * 1024);
+}
+
+TEST(TDigestTest, MergedDigestsEstimateQuantilesOfCombinedInput) {
+    TDigest low;
+    TDigest high;
+    for (int i = 0; i < 10000; ++i) {
+        low.add(i);
+        high.add(10000 + i);
+    }
+
+    TDigest merged;
+    merged.merge(low);
+    merged.merge(high);
+    merged.merge(TDigest());
+
+    ASSERT_EQ(merged.count(), 20000.0);
+    ASSERT_EQ(merged.quantile(0), 0.0);
+    ASSERT_EQ(merged.quantile(1), 19999.0);
+    ASSERT_APPROX_EQUAL(merged.quantile(0.5), 10000.0, 100.0);
+    ASSERT_APPROX_EQUAL(merged.quantile(0.25), 5000.0, 100.0);
+}
+
+TEST(TDigestTest, SerializedDigestParsesToEquivalentDigest) {
+    TDigest digest;
+    for (int i = 0; i < 5000; ++i) {
+        digest.add(i % 97);
+    }
+
+    TDigest parsed = TDigest::parse(digest.serialize());
+    ASSERT_EQ(parsed.count(), digest.count());
+    for (double q : {0.0, 0.1, 0.5, 0.9, 1.0}) {
+        ASSERT_EQ(parsed.quantile(q), digest.quantile(q));
+    }
+
+    TDigest empty = TDigest::parse(TDigest().serialize());
+    ASSERT_TRUE(empty.empty());
+}
+
+TEST(TDigestTest, ParseRejectsMalformedDigests) {
+    ASSERT_THROWS_CODE(TDigest::parse(Value(1)), AssertionException, 50810);
+    ASSERT_THROWS_CODE(TDigest::parse(Value(Document{{"means", BSON_ARRAY(1)},
+                                                     {"weights", BSONArray()},
+                                                     {"min", 1},
+                                                     {"max", 1}})),
+                       AssertionException,
+                       50811);
+    ASSERT_THROWS_CODE(TDigest::parse(Value(Document{{"means", BSON_ARRAY(1)},
+                                                     {"weights", BSON_ARRAY(0)},
+                                                     {"min", 1},
+                                                     {"max", 1}})),
+                       AssertionException,
+                       50812);
+}
+
+}  // namespace
+}  // namespace mongo
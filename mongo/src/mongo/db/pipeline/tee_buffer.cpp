@@ -49,6 +49,18 @@ boost::intrusive_ptr<TeeBuffer> TeeBuffer::create(size_t nConsumers, int bufferS
 }
 
 DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
+    if (_concurrentConsumers) {
+        // Only this consumer's own state may be touched here, since the other consumers may be
+        // running concurrently. The batch itself is not modified until every consumer has paused.
+        if (_consumers[consumerId].nLeftToReturn == 0) {
+            return _buffer.empty() ? DocumentSource::GetNextResult::makeEOF()
+                                   : DocumentSource::GetNextResult::makePauseExecution();
+        }
+        const size_t bufferIndex = _buffer.size() - _consumers[consumerId].nLeftToReturn;
+        --_consumers[consumerId].nLeftToReturn;
+        return _buffer[bufferIndex];
+    }
+
     size_t nConsumersStillProcessingThisBatch =
         std::count_if(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
             return info.nLeftToReturn > 0;
@@ -81,6 +93,11 @@ void TeeBuffer::loadNextBatch() {
 
     auto input = _source->getNext();
     for (; input.isAdvanced(); input = _source->getNext()) {
+        if (_concurrentConsumers) {
+            // Documents read from a cursor are decoded lazily, on const access, so they must be
+            // fully converted before several consumers may read them at once.
+            input = Document::fromBsonWithMetaData(input.getDocument().toBsonWithMetaData());
+        }
         bytesInBuffer += input.getDocument().getApproximateSize();
         _buffer.push_back(std::move(input));
 
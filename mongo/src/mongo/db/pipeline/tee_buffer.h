@@ -44,6 +44,11 @@ namespace mongo {
  * do so, it will batch incoming documents and allow each consumer to consume one batch at a time.
  * As a consequence, consumers must be able to pause their execution to allow other consumers to
  * process the batch before moving to the next batch.
+ *
+ * By default, the consumer which asks for a document after every consumer has finished the current
+ * batch loads the next one. In concurrent mode, each consumer may instead call getNext() and
+ * dispose() from its own thread, and batches are only loaded by explicit calls to loadNextBatch()
+ * made while no consumer is running.
  */
 class TeeBuffer : public RefCountable {
 public:
@@ -58,6 +63,24 @@ public:
         _source = source;
     }
 
+    /**
+     * Switches this buffer to concurrent mode. Must be called before any consumer asks for input.
+     */
+    void enableConcurrentConsumers() {
+        _concurrentConsumers = true;
+    }
+
+    /**
+     * Clears '_buffer', then keeps requesting results from '_source' and pushing them all into
+     * '_buffer', until more than '_bufferSizeBytes' of documents have been returned, or until
+     * '_source' is exhausted.
+     *
+     * In concurrent mode, this must be called for each batch, while no consumer is running. Once
+     * it leaves '_buffer' empty, the input is exhausted. The documents are then fully decoded as
+     * they are buffered, so that the consumers can read them concurrently.
+     */
+    void loadNextBatch();
+
     /**
      * Removes 'consumerId' as a consumer of this buffer. This is required to be called if a
      * consumer will not consume all input.
@@ -65,6 +88,10 @@ public:
     void dispose(size_t consumerId) {
         _consumers[consumerId].stillInUse = false;
         _consumers[consumerId].nLeftToReturn = 0;
+        if (_concurrentConsumers) {
+            // Other consumers may still be reading '_buffer' from their own threads.
+            return;
+        }
         if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
                 return info.stillInUse;
             })) {
@@ -85,15 +112,10 @@ public:
 private:
     TeeBuffer(size_t nConsumers, size_t bufferSizeBytes);
 
-    /**
-     * Clears '_buffer', then keeps requesting results from '_source' and pushing them all into
-     * '_buffer', until more than '_bufferSizeBytes' of documents have been returned, or until
-     * '_source' is exhausted.
-     */
-    void loadNextBatch();
-
     DocumentSource* _source = nullptr;
 
+    bool _concurrentConsumers = false;
+
     const size_t _bufferSizeBytes;
     std::vector<DocumentSource::GetNextResult> _buffer;
 
@@ -338,6 +338,12 @@ public:
     /// Members to support parsing/deserialization from IDL generated code.
     void serializeForIDL(StringData fieldName, BSONObjBuilder* builder) const;
     void serializeForIDL(BSONArrayBuilder* builder) const;
+
+    /**
+     * Returns the contents of a String or Symbol without copying them. Does no type checking, and
+     * may contain embedded NUL bytes.
+     */
+    StringData getStringData() const;
     static Value deserializeForIDL(const BSONElement& element);
 
 private:
@@ -351,9 +357,6 @@ private:
 
     explicit Value(const ValueStorage& storage) : _storage(storage) {}
 
-    // does no type checking
-    StringData getStringData() const;  // May contain embedded NUL bytes
-
     ValueStorage _storage;
     friend class MutableValue;  // gets and sets _storage.genericRCPtr
 };
@@ -0,0 +1,282 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/plan_cache_warmup.h"
+
+#include "mongo/base/counter.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/client/dbclientcursor.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/query_request.h"
+#include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/util/background.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+namespace {
+
+const char kShapesNamespace[] = "local.planCacheShapes";
+const char kShapesFieldName[] = "shapes";
+
+Counter64 planCacheWarmupSnapshots;
+Counter64 planCacheWarmupShapesReplanned;
+Counter64 planCacheWarmupShapesFailed;
+
+ServerStatusMetricField<Counter64> planCacheWarmupSnapshotsDisplay(
+    "query.planCacheWarmup.snapshots", &planCacheWarmupSnapshots);
+ServerStatusMetricField<Counter64> planCacheWarmupShapesReplannedDisplay(
+    "query.planCacheWarmup.shapesReplanned", &planCacheWarmupShapesReplanned);
+ServerStatusMetricField<Counter64> planCacheWarmupShapesFailedDisplay(
+    "query.planCacheWarmup.shapesFailed", &planCacheWarmupShapesFailed);
+
+MONGO_EXPORT_SERVER_PARAMETER(planCacheWarmupEnabled, bool, false);
+MONGO_EXPORT_SERVER_PARAMETER(planCacheWarmupSnapshotIntervalSecs, int, 300);
+MONGO_EXPORT_SERVER_PARAMETER(planCacheWarmupMaxShapesPerCollection, int, 100);
+
+/**
+ * Periodically saves the shape of every cached plan, keyed by namespace, and re-plans the saved
+ * shapes once when the node first becomes readable after startup.
+ *
+ * Only the shapes are persisted, not the winning solutions: re-planning at warmup runs the normal
+ * multi-planner trial against the indexes which exist now, so a stale or dropped index can never
+ * be resurrected from disk.
+ */
+class PlanCacheWarmupMonitor : public BackgroundJob {
+public:
+    std::string name() const override {
+        return "PlanCacheWarmupMonitor";
+    }
+
+    void run() override {
+        Client::initThread(name().c_str());
+        AuthorizationSession::get(cc())->grantInternalAuthorization();
+
+        bool warmedUp = false;
+        while (!globalInShutdownDeprecated()) {
+            if (!planCacheWarmupEnabled.load()) {
+                MONGO_IDLE_THREAD_BLOCK;
+                sleepsecs(1);
+                continue;
+            }
+
+            try {
+                const ServiceContext::UniqueOperationContext opCtx = cc().makeOperationContext();
+                if (!isReadable()) {
+                    MONGO_IDLE_THREAD_BLOCK;
+                    sleepsecs(1);
+                    continue;
+                }
+
+                // The shapes saved before the restart must be replayed before the first snapshot,
+                // which would otherwise overwrite them with the still-empty plan caches.
+                if (!warmedUp) {
+                    doWarmup(opCtx.get());
+                    warmedUp = true;
+                } else {
+                    doSnapshot(opCtx.get());
+                }
+            } catch (const DBException& ex) {
+                warning() << "plan cache warmup pass failed: " << redact(ex);
+            }
+
+            MONGO_IDLE_THREAD_BLOCK;
+            sleepsecs(std::max(1, planCacheWarmupSnapshotIntervalSecs.load()));
+        }
+    }
+
+private:
+    static bool isReadable() {
+        auto replCoord = repl::getGlobalReplicationCoordinator();
+        return replCoord->getReplicationMode() != repl::ReplicationCoordinator::modeReplSet ||
+            replCoord->getMemberState().readable();
+    }
+
+    /**
+     * Builds one document per collection with a non-empty plan cache, then upserts them without
+     * holding any collection locks.
+     */
+    void doSnapshot(OperationContext* opCtx) {
+        const int maxShapes = std::max(0, planCacheWarmupMaxShapesPerCollection.load());
+        std::vector<BSONObj> docs;
+
+        std::vector<std::string> dbNames;
+        getGlobalServiceContext()->getGlobalStorageEngine()->listDatabases(&dbNames);
+        for (const std::string& dbName : dbNames) {
+            if (dbName == NamespaceString::kLocalDb) {
+                continue;
+            }
+
+            AutoGetDb autoDb(opCtx, dbName, MODE_IS);
+            Database* db = autoDb.getDb();
+            if (!db) {
+                continue;
+            }
+
+            for (Collection* collection : *db) {
+                // Each collection is locked separately, so a snapshot never holds more than one
+                // collection lock at a time.
+                const NamespaceString nss = collection->ns();
+                Lock::CollectionLock collLock(opCtx->lockState(), nss.ns(), MODE_IS);
+
+                PlanCache* planCache = collection->infoCache()->getPlanCache();
+                std::vector<std::unique_ptr<PlanCacheEntry>> entries;
+                for (PlanCacheEntry* entry : planCache->getAllEntries()) {
+                    entries.emplace_back(entry);
+                }
+                if (entries.empty()) {
+                    continue;
+                }
+
+                BSONObjBuilder docBuilder;
+                docBuilder.append("_id", nss.ns());
+                BSONArrayBuilder shapesBuilder(docBuilder.subarrayStart(kShapesFieldName));
+                int numShapes = 0;
+                for (auto&& entry : entries) {
+                    if (numShapes >= maxShapes || docBuilder.len() > BSONObjMaxUserSize / 2) {
+                        break;
+                    }
+                    shapesBuilder.append(BSON("query" << entry->query << "sort" << entry->sort
+                                                      << "projection"
+                                                      << entry->projection
+                                                      << "collation"
+                                                      << entry->collation));
+                    ++numShapes;
+                }
+                shapesBuilder.doneFast();
+                docs.push_back(docBuilder.obj());
+            }
+        }
+
+        DBDirectClient client(opCtx);
+        for (const BSONObj& doc : docs) {
+            client.update(kShapesNamespace, BSON("_id" << doc["_id"]), doc, true /* upsert */);
+        }
+
+        planCacheWarmupSnapshots.increment();
+        LOG(1) << "saved plan cache shapes for " << docs.size() << " collections";
+    }
+
+    void doWarmup(OperationContext* opCtx) {
+        std::vector<BSONObj> docs;
+        {
+            DBDirectClient client(opCtx);
+            auto cursor = client.query(kShapesNamespace, Query());
+            while (cursor && cursor->more()) {
+                docs.push_back(cursor->nextSafe().getOwned());
+            }
+        }
+
+        for (const BSONObj& doc : docs) {
+            const BSONElement idElt = doc["_id"];
+            if (idElt.type() != String) {
+                continue;
+            }
+            const NamespaceString nss(idElt.valueStringData());
+            for (const BSONElement& shapeElt : doc[kShapesFieldName].Array()) {
+                if (globalInShutdownDeprecated()) {
+                    return;
+                }
+
+                Status status = replanShape(opCtx, nss, shapeElt.Obj());
+                if (status.isOK()) {
+                    planCacheWarmupShapesReplanned.increment();
+                } else {
+                    planCacheWarmupShapesFailed.increment();
+                    LOG(1) << "could not re-plan cached shape for " << nss << ": " << status;
+                }
+            }
+        }
+
+        log() << "plan cache warmup re-planned " << planCacheWarmupShapesReplanned.get()
+              << " shapes";
+    }
+
+    /**
+     * Canonicalizes 'shape' and builds a find executor for it, which runs the multi-planner trial
+     * and caches the winner exactly as a client query of that shape would.
+     */
+    Status replanShape(OperationContext* opCtx, const NamespaceString& nss, const BSONObj& shape) {
+        auto qr = stdx::make_unique<QueryRequest>(nss);
+        qr->setFilter(shape["query"].Obj().getOwned());
+        qr->setSort(shape["sort"].Obj().getOwned());
+        qr->setProj(shape["projection"].Obj().getOwned());
+        qr->setCollation(shape["collation"].Obj().getOwned());
+
+        AutoGetCollectionForRead autoColl(opCtx, nss);
+        Collection* collection = autoColl.getCollection();
+        if (!collection) {
+            return {ErrorCodes::NamespaceNotFound, "collection no longer exists"};
+        }
+
+        const ExtensionsCallbackReal extensionsCallback(opCtx, &nss);
+        auto statusWithCQ =
+            CanonicalQuery::canonicalize(opCtx, std::move(qr), nullptr, extensionsCallback);
+        if (!statusWithCQ.isOK()) {
+            return statusWithCQ.getStatus();
+        }
+
+        return getExecutorFind(opCtx,
+                               collection,
+                               nss,
+                               std::move(statusWithCQ.getValue()),
+                               PlanExecutor::NO_YIELD)
+            .getStatus();
+    }
+};
+
+PlanCacheWarmupMonitor* planCacheWarmupMonitor = nullptr;
+
+}  // namespace
+
+void startPlanCacheWarmupBackgroundJob() {
+    planCacheWarmupMonitor = new PlanCacheWarmupMonitor();
+    planCacheWarmupMonitor->go();
+}
+
+}  // namespace mongo
@@ -44,6 +44,7 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/db/storage/mmap_v1/mmap.h"
 #include "mongo/util/log.h"
@@ -171,10 +172,12 @@ void prefetchPagesForReplicatedOp(OperationContext* opCtx, Database* db, const B
     BSONObj obj = op.getObjectField(opField);
     const char* ns = op.getStringField("ns");
 
-    // This will have to change for engines other than MMAP V1, because they might not have
-    // means for directly prefetching pages from the collection. For this purpose, acquire S
-    // lock on the database, instead of optimizing with IS.
-    Lock::CollectionLock collLock(opCtx->lockState(), ns, MODE_S);
+    // MMAP V1 prefetches while the batch applier holds the PBWM, so take an S lock to keep out
+    // writers. Engines with document level locking prefetch concurrently with batch application
+    // through their own snapshots and must not block the appliers' intent locks.
+    const bool supportsDocLocking =
+        opCtx->getServiceContext()->getGlobalStorageEngine()->supportsDocLocking();
+    Lock::CollectionLock collLock(opCtx->lockState(), ns, supportsDocLocking ? MODE_IS : MODE_S);
 
     Collection* collection = db->getCollection(opCtx, ns);
     if (!collection) {
@@ -0,0 +1,123 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/published_op_state.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+
+constexpr size_t PublishedOpState::kMaxNsLength;
+
+template <typename Update>
+void PublishedOpState::_write(Update update) {
+    uint32_t sequence = _sequence.load();
+    while (sequence % 2 != 0 || _sequence.compareAndSwap(sequence, sequence + 1) != sequence) {
+        // Another writer is updating the fields.
+        stdx::this_thread::yield();
+        sequence = _sequence.load();
+    }
+
+    update();
+
+    _sequence.store(sequence + 2);
+}
+
+void PublishedOpState::publishOperation(unsigned int opId, long long startMicros) {
+    _write([&] {
+        _active = true;
+        _opId = opId;
+        _startMicros = startMicros;
+        _logicalOp = LogicalOp::opInvalid;
+        _killPending = false;
+        _nsLength = 0;
+        _nsTruncated = false;
+    });
+}
+
+void PublishedOpState::publishIdle() {
+    _write([&] {
+        _active = false;
+        _killPending = false;
+    });
+}
+
+void PublishedOpState::publishDetails(StringData ns, LogicalOp logicalOp, long long startMicros) {
+    _write([&] {
+        _nsLength = std::min(ns.size(), kMaxNsLength);
+        _nsTruncated = _nsLength < ns.size();
+        std::memcpy(_ns, ns.rawData(), _nsLength);
+        _logicalOp = logicalOp;
+        if (startMicros) {
+            _startMicros = startMicros;
+        }
+    });
+}
+
+void PublishedOpState::publishKillPending() {
+    _write([&] { _killPending = true; });
+}
+
+PublishedOpState::Snapshot PublishedOpState::read() const {
+    Snapshot snapshot;
+    char ns[kMaxNsLength];
+
+    while (true) {
+        const uint32_t sequence = _sequence.load();
+        if (sequence % 2 != 0) {
+            stdx::this_thread::yield();
+            continue;
+        }
+
+        // The fields may be torn while a writer updates them, in which case the sequence number
+        // has changed by the time they are copied and the copy is discarded.
+        snapshot.active = _active;
+        snapshot.opId = _opId;
+        snapshot.startMicros = _startMicros;
+        snapshot.logicalOp = _logicalOp;
+        snapshot.killPending = _killPending;
+        snapshot.nsTruncated = _nsTruncated;
+        const size_t nsLength = std::min(_nsLength, kMaxNsLength);
+        std::memcpy(ns, _ns, nsLength);
+
+        // Keep the copies above from being reordered after the second read of the sequence.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_sequence.load() == sequence) {
+            snapshot.ns.assign(ns, nsLength);
+            return snapshot;
+        }
+    }
+}
+
+}  // namespace mongo
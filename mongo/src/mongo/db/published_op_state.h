@@ -0,0 +1,110 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/net/message.h"
+
+namespace mongo {
+
+/**
+ * A summary of the operation a Client is running, published so that $currentOp and killOp can read
+ * it without taking the Client lock or building the full report of the operation.
+ *
+ * The summary is protected by a sequence lock: writers make the sequence number odd while they
+ * update the fields, and readers retry until they copied the fields between two reads of the same
+ * even sequence number. Writers exclude each other by claiming the odd sequence number, so they
+ * need not hold the Client lock, although they usually do.
+ */
+class PublishedOpState {
+    MONGO_DISALLOW_COPYING(PublishedOpState);
+
+public:
+    // Namespaces longer than this are published truncated.
+    static constexpr size_t kMaxNsLength = 127;
+
+    struct Snapshot {
+        bool active = false;
+        unsigned int opId = 0;
+        // When the operation started, in microseconds since the epoch, or 0 if it has not.
+        long long startMicros = 0;
+        LogicalOp logicalOp = LogicalOp::opInvalid;
+        bool killPending = false;
+        std::string ns;
+        bool nsTruncated = false;
+    };
+
+    PublishedOpState() = default;
+
+    /**
+     * Publishes that the client started running the operation 'opId'.
+     */
+    void publishOperation(unsigned int opId, long long startMicros);
+
+    /**
+     * Publishes that the client is no longer running an operation.
+     */
+    void publishIdle();
+
+    /**
+     * Publishes the namespace, type and start time of the current operation.
+     */
+    void publishDetails(StringData ns, LogicalOp logicalOp, long long startMicros);
+
+    /**
+     * Publishes that the current operation has been killed.
+     */
+    void publishKillPending();
+
+    /**
+     * Returns a consistent copy of the published fields.
+     */
+    Snapshot read() const;
+
+private:
+    template <typename Update>
+    void _write(Update update);
+
+    AtomicUInt32 _sequence{0};
+
+    bool _active = false;
+    unsigned int _opId = 0;
+    long long _startMicros = 0;
+    LogicalOp _logicalOp = LogicalOp::opInvalid;
+    bool _killPending = false;
+    size_t _nsLength = 0;
+    bool _nsTruncated = false;
+    char _ns[kMaxNsLength];
+};
+
+}  // namespace mongo
@@ -0,0 +1,118 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/db/published_op_state.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(PublishedOpStateTest, StartsIdle) {
+    PublishedOpState state;
+    const auto snapshot = state.read();
+    ASSERT_FALSE(snapshot.active);
+    ASSERT_EQ(0U, snapshot.opId);
+    ASSERT_EQ("", snapshot.ns);
+}
+
+TEST(PublishedOpStateTest, PublishesOperationUntilIdle) {
+    PublishedOpState state;
+    state.publishOperation(42, 1000);
+    state.publishDetails("test.coll", LogicalOp::opQuery, 0);
+
+    auto snapshot = state.read();
+    ASSERT_TRUE(snapshot.active);
+    ASSERT_EQ(42U, snapshot.opId);
+    ASSERT_EQ(1000, snapshot.startMicros);
+    ASSERT(LogicalOp::opQuery == snapshot.logicalOp);
+    ASSERT_EQ("test.coll", snapshot.ns);
+    ASSERT_FALSE(snapshot.nsTruncated);
+    ASSERT_FALSE(snapshot.killPending);
+
+    // The start time of the CurOp replaces the one of the operation context once known.
+    state.publishDetails("test.coll", LogicalOp::opQuery, 2000);
+    state.publishKillPending();
+    snapshot = state.read();
+    ASSERT_EQ(2000, snapshot.startMicros);
+    ASSERT_TRUE(snapshot.killPending);
+
+    state.publishIdle();
+    snapshot = state.read();
+    ASSERT_FALSE(snapshot.active);
+    ASSERT_FALSE(snapshot.killPending);
+
+    // The details of the previous operation do not carry over to the next one.
+    state.publishOperation(43, 3000);
+    snapshot = state.read();
+    ASSERT_EQ(43U, snapshot.opId);
+    ASSERT_EQ("", snapshot.ns);
+}
+
+TEST(PublishedOpStateTest, TruncatesLongNamespaces) {
+    PublishedOpState state;
+    const std::string ns = "test." + std::string(PublishedOpState::kMaxNsLength, 'x');
+    state.publishOperation(1, 1000);
+    state.publishDetails(ns, LogicalOp::opUpdate, 0);
+
+    const auto snapshot = state.read();
+    ASSERT_TRUE(snapshot.nsTruncated);
+    ASSERT_EQ(ns.substr(0, PublishedOpState::kMaxNsLength), snapshot.ns);
+}
+
+TEST(PublishedOpStateTest, ReadersSeeConsistentSnapshots) {
+    PublishedOpState state;
+    const unsigned int kIterations = 100000;
+
+    stdx::thread writer([&] {
+        for (unsigned int opId = 1; opId <= kIterations; ++opId) {
+            state.publishOperation(opId, opId);
+            state.publishDetails(std::to_string(opId), LogicalOp::opQuery, opId);
+        }
+    });
+
+    unsigned int lastOpId = 0;
+    while (lastOpId < kIterations) {
+        const auto snapshot = state.read();
+        if (!snapshot.ns.empty()) {
+            ASSERT_EQ(std::to_string(snapshot.opId), snapshot.ns);
+        }
+        ASSERT_EQ(static_cast<long long>(snapshot.opId), snapshot.startMicros);
+        ASSERT_GTE(snapshot.opId, lastOpId);
+        lastOpId = snapshot.opId;
+    }
+
+    writer.join();
+}
+
+}  // namespace
+}  // namespace mongo
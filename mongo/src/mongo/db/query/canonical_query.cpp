@@ -38,6 +38,8 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/indexability.h"
+#include "mongo/db/query/parsed_filter_cache.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/util/log.h"
 
@@ -172,6 +174,15 @@ StatusWith<std::unique_ptr<CanonicalQuery>>
         invariant(CollatorInterface::collatorsMatch(collator.get(), expCtx->getCollator()));
     }
 
+    // A filter whose shape was canonicalized before is rebuilt from the cached normalized tree
+    // around its own constants, skipping the parser and normalization.
+    const bool useParsedFilterCache = internalQueryParsedFilterCacheSize.load() > 0;
+    std::unique_ptr<MatchExpression> me;
+    if (useParsedFilterCache) {
+        me = ParsedFilterCache::get().bind(qr->getFilter(), newExpCtx->getCollator());
+    }
+    const bool rootIsNormalized = static_cast<bool>(me);
+
 	/*
 	ͨMatchExpressionParser_parsefilterԱ,filter﷨Ͽγṹ,
 	սıʽγɱʽ,ÿڵǲͬıʽ.
@@ -179,15 +190,17 @@ StatusWith<std::unique_ptr<CanonicalQuery>>
 	MatchExpressionParserþǰBsonתΪһεMatchExpression
 	οhttps://blog.csdn.net/baijiwei/article/details/78127191
 	*/
-    StatusWithMatchExpression statusWithMatcher = MatchExpressionParser::parse(
-        qr->getFilter(), newExpCtx, extensionsCallback, allowedFeatures);
-    if (!statusWithMatcher.isOK()) {
-        return statusWithMatcher.getStatus();
-    }
+    if (!me) {
+        StatusWithMatchExpression statusWithMatcher = MatchExpressionParser::parse(
+            qr->getFilter(), newExpCtx, extensionsCallback, allowedFeatures);
+        if (!statusWithMatcher.isOK()) {
+            return statusWithMatcher.getStatus();
+        }
 
 	//͵expressionṹԭʼνṹеĽڵһĲѯ
 	//մCanonicalQuery._root
-    std::unique_ptr<MatchExpression> me = std::move(statusWithMatcher.getValue());
+        me = std::move(statusWithMatcher.getValue());
+    }
 
     // Make the CQ we'll hopefully return.
     //CanonicalQuery
@@ -200,11 +213,16 @@ StatusWith<std::unique_ptr<CanonicalQuery>>
                  std::move(qr),
                  parsingCanProduceNoopMatchNodes(extensionsCallback, allowedFeatures),
                  std::move(me),
-                 std::move(collator));
+                 std::move(collator),
+                 rootIsNormalized);
 
     if (!initStatus.isOK()) {
         return initStatus;
     }
+
+    if (useParsedFilterCache && !rootIsNormalized) {
+        ParsedFilterCache::get().add(cq->getQueryRequest().getFilter(), cq->root());
+    }
     return std::move(cq);
 }
 
@@ -255,7 +273,8 @@ Status CanonicalQuery::init(OperationContext* opCtx,
                             std::unique_ptr<QueryRequest> qr,
                             bool canHaveNoopMatchNodes,
                             std::unique_ptr<MatchExpression> root,
-                            std::unique_ptr<CollatorInterface> collator) {
+                            std::unique_ptr<CollatorInterface> collator,
+                            bool rootIsNormalized) {
     _qr = std::move(qr);
     _collator = std::move(collator);
 
@@ -273,9 +292,13 @@ Status CanonicalQuery::init(OperationContext* opCtx,
     // Normalize, sort and validate tree.
     //Ҳϰ汾еCanonicalQuery::normalizeTreeοhttps://blog.csdn.net/baijiwei/article/details/78170387
     //ҪиڵϲŻ
-    _root = MatchExpression::optimize(std::move(root));
+    if (rootIsNormalized) {
+        _root = std::move(root);
+    } else {
+        _root = MatchExpression::optimize(std::move(root));
 	//ڶtree,ҪǶMatchExpressionĸ򣬺ôĲֻҪһξɡ˳ 
-    sortTree(_root.get());
+        sortTree(_root.get());
+    }
 
 	//treeЧԼ
     Status validStatus = isValid(_root.get(), *_qr);
@@ -198,7 +198,8 @@ private:
                 std::unique_ptr<QueryRequest> qr,
                 bool canHaveNoopMatchNodes,
                 std::unique_ptr<MatchExpression> root,
-                std::unique_ptr<CollatorInterface> collator);
+                std::unique_ptr<CollatorInterface> collator,
+                bool rootIsNormalized = false);
 
     std::unique_ptr<QueryRequest> _qr; //ѯеϸϢȶ¼
 
@@ -32,8 +32,11 @@
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/parsed_filter_cache.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -421,5 +424,49 @@ TEST(CanonicalQueryTest, NorWithOneChildNormalizedAfterNormalizingChild) {
     ASSERT_EQ(MatchExpression::EQ, root->getChild(0)->matchType());
 }
 
+TEST(CanonicalQueryTest, ParsedFilterCacheRebindsConstantsOfCachedShape) {
+    const int oldCacheSize = internalQueryParsedFilterCacheSize.load();
+    ON_BLOCK_EXIT([oldCacheSize] {
+        internalQueryParsedFilterCacheSize.store(oldCacheSize);
+        ParsedFilterCache::get().clear();
+    });
+    internalQueryParsedFilterCacheSize.store(100);
+    ParsedFilterCache::get().clear();
+
+    // The first query of a shape is parsed normally and seeds the cache.
+    unique_ptr<CanonicalQuery> first(canonicalize("{b: {$gt: 5}, a: 1}"));
+    ASSERT_EQ(1U, ParsedFilterCache::get().size());
+
+    // A later query of the same shape is built from the cached tree around its own constants.
+    const char* queryStr = "{b: {$gt: 7}, a: 'x'}";
+    BSONObj filter = fromjson(queryStr);
+    unique_ptr<MatchExpression> bound = ParsedFilterCache::get().bind(filter, nullptr);
+    ASSERT(bound);
+    unique_ptr<CanonicalQuery> cached(canonicalize(queryStr));
+    ASSERT_EQ(1U, ParsedFilterCache::get().size());
+
+    internalQueryParsedFilterCacheSize.store(0);
+    unique_ptr<CanonicalQuery> uncached(canonicalize(queryStr));
+    assertEquivalent(queryStr, uncached->root(), bound.get());
+    assertEquivalent(queryStr, uncached->root(), cached->root());
+    ASSERT_EQ(uncached->root()->toString(), cached->root()->toString());
+}
+
+TEST(CanonicalQueryTest, ParsedFilterCacheIgnoresNonComparisonShapes) {
+    const int oldCacheSize = internalQueryParsedFilterCacheSize.load();
+    ON_BLOCK_EXIT([oldCacheSize] {
+        internalQueryParsedFilterCacheSize.store(oldCacheSize);
+        ParsedFilterCache::get().clear();
+    });
+    internalQueryParsedFilterCacheSize.store(100);
+    ParsedFilterCache::get().clear();
+
+    canonicalize("{a: {$in: [1, 2]}}");
+    canonicalize("{a: {$gt: 1, $lt: 5}}");
+    canonicalize("{a: [1, 2]}");
+    canonicalize("{$or: [{a: 1}, {b: 1}]}");
+    ASSERT_EQ(0U, ParsedFilterCache::get().size());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -30,14 +30,28 @@
 
 #include "mongo/db/query/collation/collator_interface_icu.h"
 
+#include <algorithm>
 #include <unicode/coll.h>
-#include <unicode/sortkey.h>
 
 #include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
 
+namespace {
+
+// Strings up to this many bytes are converted to UTF-16, and have their sort keys generated, using
+// stack buffers rather than heap allocations.
+const size_t kStackBufferSize = 256;
+
+bool isASCII(StringData stringData) {
+    return std::all_of(stringData.begin(), stringData.end(), [](char c) {
+        return static_cast<unsigned char>(c) < 0x80;
+    });
+}
+
+}  // namespace
+
 CollatorInterfaceICU::CollatorInterfaceICU(CollationSpec spec,
                                            std::unique_ptr<icu::Collator> collator)
     : CollatorInterface(std::move(spec)), _collator(std::move(collator)) {}
@@ -49,6 +63,12 @@ std::unique_ptr<CollatorInterface> CollatorInterfaceICU::clone() const {
 }
 
 int CollatorInterfaceICU::compare(StringData left, StringData right) const {
+    // Byte-identical strings, even invalid UTF-8, always collate as equal. Checking this first
+    // avoids handing ICU the common case of an equality match against an indexed or grouped value.
+    if (left == right) {
+        return 0;
+    }
+
     UErrorCode status = U_ZERO_ERROR;
     auto compareResult = _collator->compareUTF8(icu::StringPiece(left.rawData(), left.size()),
                                                 icu::StringPiece(right.rawData(), right.size()),
@@ -73,28 +93,47 @@ int CollatorInterfaceICU::compare(StringData left, StringData right) const {
 
 CollatorInterface::ComparisonKey CollatorInterfaceICU::getComparisonKey(
     StringData stringData) const {
-    // A StringPiece is ICU's StringData. They are logically the same abstraction.
-    const icu::StringPiece stringPiece(stringData.rawData(), stringData.size());
-
-    UErrorCode status = U_ZERO_ERROR;
-    icu::CollationKey icuKey;
-    _collator->getCollationKey(icu::UnicodeString::fromUTF8(stringPiece), icuKey, status);
+    // The UTF-16 input to ICU. A pure ASCII string (by far the common case for keys) is widened
+    // byte-by-byte, which is exactly its UTF-16 encoding, skipping UTF-8 decoding entirely.
+    UChar stackChars[kStackBufferSize];
+    const UChar* chars = stackChars;
+    int32_t charsLength = static_cast<int32_t>(stringData.size());
+    icu::UnicodeString unicodeString;
+    if (stringData.size() <= kStackBufferSize && isASCII(stringData)) {
+        std::copy(stringData.begin(), stringData.end(), stackChars);
+    } else {
+        // A StringPiece is ICU's StringData. They are logically the same abstraction.
+        unicodeString = icu::UnicodeString::fromUTF8(
+            icu::StringPiece(stringData.rawData(), stringData.size()));
+        chars = unicodeString.getBuffer();
+        charsLength = unicodeString.length();
+    }
 
     // Any sequence of bytes, even invalid UTF-8, has defined comparison behavior in ICU (invalid
-    // subsequences are weighted as the replacement character, U+FFFD). A non-ok error code is only
+    // subsequences are weighted as the replacement character, U+FFFD). A zero length is only
     // expected when a memory allocation fails inside ICU, which we consider fatal to the process.
-    fassert(34439, U_SUCCESS(status));
-
-    int32_t keyLength;
-    const uint8_t* keyBuffer = icuKey.getByteArray(keyLength);
-    invariant(keyLength > 0);
-    invariant(keyBuffer);
+    // The sort key is written directly into a stack buffer, retrying with a heap buffer of the
+    // reported size only if it does not fit.
+    uint8_t stackKey[kStackBufferSize];
+    const int32_t keyLength =
+        _collator->getSortKey(chars, charsLength, stackKey, sizeof(stackKey));
+    fassert(34439, keyLength > 0);
 
     // The last byte of the sort key should always be null. When we construct the comparison key, we
     // omit the trailing null byte.
-    invariant(keyBuffer[keyLength - 1u] == '\0');
-    const char* charBuffer = reinterpret_cast<const char*>(keyBuffer);
-    return makeComparisonKey(std::string(charBuffer, keyLength - 1u));
+    if (static_cast<size_t>(keyLength) <= sizeof(stackKey)) {
+        invariant(stackKey[keyLength - 1] == '\0');
+        return makeComparisonKey(
+            std::string(reinterpret_cast<const char*>(stackKey), keyLength - 1));
+    }
+
+    std::string heapKey(keyLength, '\0');
+    const int32_t heapKeyLength = _collator->getSortKey(
+        chars, charsLength, reinterpret_cast<uint8_t*>(&heapKey[0]), keyLength);
+    invariant(heapKeyLength == keyLength);
+    invariant(heapKey.back() == '\0');
+    heapKey.pop_back();
+    return makeComparisonKey(std::move(heapKey));
 }
 
 }  // namespace mongo
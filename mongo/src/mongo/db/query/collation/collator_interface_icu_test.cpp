@@ -33,6 +33,7 @@
 #include <iomanip>
 #include <iostream>
 #include <unicode/coll.h>
+#include <unicode/sortkey.h>
 
 #include "mongo/unittest/unittest.h"
 
@@ -416,6 +417,64 @@ TEST(CollatorInterfaceICUTest, FrenchCanadianCollatorComparesCorrectlyUsingCompa
     ASSERT_GT(circumflexAndAcute.getKeyData().compare(circumflex.getKeyData()), 0);
 }
 
+TEST(CollatorInterfaceICUTest, ComparisonKeysMatchICUCollationKeys) {
+    CollationSpec collationSpec;
+    collationSpec.localeID = "en_US";
+
+    UErrorCode status = U_ZERO_ERROR;
+    std::unique_ptr<icu::Collator> coll(
+        icu::Collator::createInstance(icu::Locale("en", "US"), status));
+    ASSERT(U_SUCCESS(status));
+    std::unique_ptr<icu::Collator> referenceColl(coll->clone());
+
+    CollatorInterfaceICU icuCollator(collationSpec, std::move(coll));
+
+    // Exercise both the ASCII and the UTF-8 decoding paths, as well as sort keys which do not fit
+    // in the stack buffer.
+    const std::string longASCII(1000, 'x');
+    const std::vector<std::string> inputs{"",
+                                          "a",
+                                          "abc",
+                                          "ABC",
+                                          "a-b c_d.9",
+                                          std::string("a\0b", 3),
+                                          u8"p\u00EAche",
+                                          u8"\u4F60\u597D",
+                                          "\xFF\xFE",
+                                          longASCII,
+                                          longASCII + u8"\u00E9"};
+    for (auto&& input : inputs) {
+        icu::CollationKey referenceKey;
+        referenceColl->getCollationKey(
+            icu::UnicodeString::fromUTF8(icu::StringPiece(input.data(), input.size())),
+            referenceKey,
+            status);
+        ASSERT(U_SUCCESS(status));
+        int32_t referenceLength;
+        const uint8_t* referenceBytes = referenceKey.getByteArray(referenceLength);
+        ASSERT_EQ(std::string(reinterpret_cast<const char*>(referenceBytes), referenceLength - 1),
+                  icuCollator.getComparisonKey(input).getKeyData());
+    }
+}
+
+TEST(CollatorInterfaceICUTest, IdenticalStringsCompareEqualWithoutRegardToStrength) {
+    CollationSpec collationSpec;
+    collationSpec.localeID = "en_US";
+    collationSpec.strength = CollationSpec::StrengthType::kIdentical;
+
+    UErrorCode status = U_ZERO_ERROR;
+    std::unique_ptr<icu::Collator> coll(
+        icu::Collator::createInstance(icu::Locale("en", "US"), status));
+    ASSERT(U_SUCCESS(status));
+    coll->setStrength(icu::Collator::IDENTICAL);
+
+    CollatorInterfaceICU icuCollator(collationSpec, std::move(coll));
+    ASSERT_EQ(icuCollator.compare("abc", "abc"), 0);
+    ASSERT_EQ(icuCollator.compare("\xFF\xFE", "\xFF\xFE"), 0);
+    ASSERT_LT(icuCollator.compare("abc", "abd"), 0);
+    ASSERT_GT(icuCollator.compare("abd", "abc"), 0);
+}
+
 TEST(CollatorInterfaceICUTest, InvalidOneByteSequencesCompareEqual) {
     // Both one-byte sequences are invalid.
     assertEqualEnUS("\xEF", "\xF2");
@@ -40,6 +40,7 @@ const char kCmdName[] = "count";
 const char kQueryField[] = "query";
 const char kLimitField[] = "limit";
 const char kSkipField[] = "skip";
+const char kSampleSizeField[] = "sampleSize";
 const char kHintField[] = "hint";
 const char kCollationField[] = "collation";
 const char kExplainField[] = "explain";
@@ -92,6 +93,18 @@ StatusWith<CountRequest> CountRequest::parseFromBSON(const NamespaceString& nss,
         return Status(ErrorCodes::BadValue, "skip value is not a valid number");
     }
 
+    // sampleSize
+    if (cmdObj[kSampleSizeField].isNumber()) {
+        long long sampleSize = cmdObj[kSampleSizeField].numberLong();
+        if (sampleSize <= 0) {
+            return Status(ErrorCodes::BadValue, "sampleSize value must be positive in count query");
+        }
+
+        request.setSampleSize(sampleSize);
+    } else if (cmdObj[kSampleSizeField].ok()) {
+        return Status(ErrorCodes::BadValue, "sampleSize value is not a valid number");
+    }
+
     // maxTimeMS
     if (cmdObj[kMaxTimeMSField].ok()) {
         auto maxTimeMS = QueryRequest::parseMaxTimeMS(cmdObj[kMaxTimeMSField]);
@@ -145,6 +158,11 @@ StatusWith<CountRequest> CountRequest::parseFromBSON(const NamespaceString& nss,
 }
 
 StatusWith<BSONObj> CountRequest::asAggregationCommand() const {
+    if (_sampleSize) {
+        return Status(ErrorCodes::OptionNotSupportedOnView,
+                      "sampleSize is not supported for counts on a view");
+    }
+
     BSONObjBuilder aggregationBuilder;
     aggregationBuilder.append("aggregate", _nss.coll());
 
@@ -74,6 +74,14 @@ public:
         _skip = skip;
     }
 
+    const boost::optional<long long>& getSampleSize() const {
+        return _sampleSize;
+    }
+
+    void setSampleSize(long long sampleSize) {
+        _sampleSize = sampleSize;
+    }
+
     BSONObj getHint() const {
         return _hint.value_or(BSONObj());
     }
@@ -153,6 +161,10 @@ private:
     // Optional. An integer indicating to not include the first n documents in the count.
     boost::optional<long long> _skip;
 
+    // Optional. When set, the count is estimated from a random sample of this many documents
+    // rather than computed exactly.
+    boost::optional<long long> _sampleSize;
+
     // Optional. Indicates to the query planner that it should generate a count plan using a
     // particular index.
     boost::optional<BSONObj> _hint;
@@ -67,6 +67,7 @@ TEST(CountRequest, ParseDefaults) {
     ASSERT(countRequest.getReadConcern().isEmpty());
     ASSERT(countRequest.getUnwrappedReadPref().isEmpty());
     ASSERT(countRequest.getComment().empty());
+    ASSERT(!countRequest.getSampleSize());
 }
 
 TEST(CountRequest, ParseComplete) {
@@ -185,6 +186,44 @@ TEST(CountRequest, FailParseBadSkipValue) {
     ASSERT_EQUALS(countRequestStatus.getStatus(), ErrorCodes::BadValue);
 }
 
+TEST(CountRequest, ParseSampleSize) {
+    const bool isExplain = false;
+    const auto countRequestStatus =
+        CountRequest::parseFromBSON(testns,
+                                    BSON("count"
+                                         << "TestColl"
+                                         << "query"
+                                         << BSON("a" << BSON("$gte" << 11))
+                                         << "sampleSize"
+                                         << 500),
+                                    isExplain);
+
+    ASSERT_OK(countRequestStatus.getStatus());
+    ASSERT_EQUALS(*countRequestStatus.getValue().getSampleSize(), 500);
+}
+
+TEST(CountRequest, FailParseBadSampleSizeValue) {
+    const bool isExplain = false;
+    const auto countRequestStatus =
+        CountRequest::parseFromBSON(testns,
+                                    BSON("count"
+                                         << "TestColl"
+                                         << "query"
+                                         << BSON("a" << BSON("$gte" << 11))
+                                         << "sampleSize"
+                                         << 0),
+                                    isExplain);
+
+    ASSERT_EQUALS(countRequestStatus.getStatus(), ErrorCodes::BadValue);
+}
+
+TEST(CountRequest, ConvertToAggregationFailsWithSampleSize) {
+    CountRequest countRequest(testns, BSONObj());
+    countRequest.setSampleSize(100);
+    ASSERT_EQUALS(countRequest.asAggregationCommand().getStatus(),
+                  ErrorCodes::OptionNotSupportedOnView);
+}
+
 TEST(CountRequest, FailParseBadCollationValue) {
     const bool isExplain = false;
     const auto countRequestStatus =
@@ -314,6 +314,9 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         }
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->docsTested);
+            if (spec->docsFromSharedOplogBuffer) {
+                bob->appendNumber("docsFromSharedOplogBuffer", spec->docsFromSharedOplogBuffer);
+            }
         }
     } else if (STAGE_COUNT == stats.stageType) {
         CountStats* spec = static_cast<CountStats*>(stats.specific.get());
@@ -488,6 +491,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            bob->appendBool("usedDisk", spec->usedDisk);
         }
 
         if (spec->limit > 0) {
@@ -874,32 +878,49 @@ void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsO
             const IndexScanStats* ixscanStats =
                 static_cast<const IndexScanStats*>(ixscan->getSpecificStats());
             statsOut->indexesUsed.insert(ixscanStats->indexName);
+            auto& scan = statsOut->indexScans[ixscanStats->indexName];
+            scan.keysExamined += ixscanStats->keysExamined;
+            scan.seeks += ixscanStats->seeks;
         } else if (STAGE_COUNT_SCAN == stages[i]->stageType()) {
             const CountScan* countScan = static_cast<const CountScan*>(stages[i]);
             const CountScanStats* countScanStats =
                 static_cast<const CountScanStats*>(countScan->getSpecificStats());
             statsOut->indexesUsed.insert(countScanStats->indexName);
+            auto& scan = statsOut->indexScans[countScanStats->indexName];
+            scan.keysExamined += countScanStats->keysExamined;
+            scan.seeks += 1;
         } else if (STAGE_IDHACK == stages[i]->stageType()) {
             const IDHackStage* idHackStage = static_cast<const IDHackStage*>(stages[i]);
             const IDHackStats* idHackStats =
                 static_cast<const IDHackStats*>(idHackStage->getSpecificStats());
             statsOut->indexesUsed.insert(idHackStats->indexName);
+            // Every key examined by an _id lookup is a point lookup of its own.
+            auto& scan = statsOut->indexScans[idHackStats->indexName];
+            scan.keysExamined += idHackStats->keysExamined;
+            scan.seeks += idHackStats->keysExamined;
         } else if (STAGE_DISTINCT_SCAN == stages[i]->stageType()) {
             const DistinctScan* distinctScan = static_cast<const DistinctScan*>(stages[i]);
             const DistinctScanStats* distinctScanStats =
                 static_cast<const DistinctScanStats*>(distinctScan->getSpecificStats());
             statsOut->indexesUsed.insert(distinctScanStats->indexName);
+            // A distinct scan seeks past the remaining keys for each value it examines.
+            auto& scan = statsOut->indexScans[distinctScanStats->indexName];
+            scan.keysExamined += distinctScanStats->keysExamined;
+            scan.seeks += distinctScanStats->keysExamined;
         } else if (STAGE_TEXT == stages[i]->stageType()) {
             const TextStage* textStage = static_cast<const TextStage*>(stages[i]);
             const TextStats* textStats =
                 static_cast<const TextStats*>(textStage->getSpecificStats());
             statsOut->indexesUsed.insert(textStats->indexName);
+            // The keys are counted by the index scans beneath the text stage.
+            statsOut->indexScans[textStats->indexName];
         } else if (STAGE_GEO_NEAR_2D == stages[i]->stageType() ||
                    STAGE_GEO_NEAR_2DSPHERE == stages[i]->stageType()) {
             const NearStage* nearStage = static_cast<const NearStage*>(stages[i]);
             const NearStats* nearStats =
                 static_cast<const NearStats*>(nearStage->getSpecificStats());
             statsOut->indexesUsed.insert(nearStats->indexName);
+            statsOut->indexScans[nearStats->indexName];
         } else if (STAGE_CACHED_PLAN == stages[i]->stageType()) {
             const CachedPlanStage* cachedPlan = static_cast<const CachedPlanStage*>(stages[i]);
             const CachedPlanStats* cachedStats =
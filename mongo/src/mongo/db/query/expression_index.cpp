@@ -28,6 +28,7 @@
 
 #include "mongo/db/query/expression_index.h"
 
+#include <algorithm>
 #include <iostream>
 #include <unordered_set>
 
@@ -36,7 +37,10 @@
 #include "mongo/db/hasher.h"
 #include "mongo/db/index/expression_params.h"
 #include "mongo/db/query/expression_index_knobs.h"
+#include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/lru_cache.h"
 #include "third_party/s2/s2cellid.h"
 #include "third_party/s2/s2region.h"
 #include "third_party/s2/s2regioncoverer.h"
@@ -51,6 +55,22 @@ BSONObj ExpressionMapping::hash(const BSONElement& value) {
     return bob.obj();
 }
 
+BSONObj ExpressionMapping::hash(const BSONElement& value, const BSONObj& indexInfoObj) {
+    // Read the seed and hash version as ExpressionParams::parseHashParams() does, without
+    // requiring the rest of the index spec.
+    const BSONElement seedElt = indexInfoObj["seed"];
+    const HashSeed seed =
+        seedElt.eoo() ? BSONElementHasher::DEFAULT_HASH_SEED : HashSeed(seedElt.numberInt());
+    const int hashVersion = indexInfoObj["hashVersion"].numberInt();
+    massert(50808,
+            "Only HashVersion 0 and 1 have been defined",
+            BSONElementHasher::isValidHashVersion(hashVersion));
+
+    BSONObjBuilder bob;
+    bob.append("", BSONElementHasher::hash64(value, seed, hashVersion));
+    return bob.obj();
+}
+
 // For debugging only
 static std::string toCoveringString(const GeoHashConverter& hashConverter,
                                     const set<GeoHash>& covering) {
@@ -126,10 +146,76 @@ std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& reg
     return cover;
 }
 
+namespace {
+
+/**
+ * A bounded, process-wide cache of 2dsphere coverings. The capacity follows
+ * internalQueryS2GeoCoveringCacheSize, and the cache is emptied whenever that knob changes.
+ */
+class S2CoveringCache {
+public:
+    boost::optional<std::vector<S2CellId>> get(const std::string& key, size_t capacity) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        resize_inlock(capacity);
+        auto it = _cache->promote(key);
+        if (it == _cache->end()) {
+            return boost::none;
+        }
+        return it->second;
+    }
+
+    void add(const std::string& key, std::vector<S2CellId> cover, size_t capacity) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        resize_inlock(capacity);
+        _cache->add(key, std::move(cover));
+    }
+
+private:
+    void resize_inlock(size_t capacity) {
+        if (!_cache || _capacity != capacity) {
+            _cache = stdx::make_unique<LRUCache<std::string, std::vector<S2CellId>>>(capacity);
+            _capacity = capacity;
+        }
+    }
+
+    stdx::mutex _mutex;
+    size_t _capacity = 0;
+    std::unique_ptr<LRUCache<std::string, std::vector<S2CellId>>> _cache;
+};
+
+S2CoveringCache s2CoveringCache;
+
+}  // namespace
+
+std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& region,
+                                                             const BSONObj& regionSpec) {
+    const int capacity = internalQueryS2GeoCoveringCacheSize.load();
+    if (capacity <= 0 || regionSpec.isEmpty()) {
+        return get2dsphereCovering(region);
+    }
+
+    // The covering depends on the level knobs as well as on the region.
+    BSONObjBuilder keyBuilder;
+    keyBuilder.append("region", regionSpec);
+    keyBuilder.append("coarsest", internalQueryS2GeoCoarsestLevel.load());
+    keyBuilder.append("finest", internalQueryS2GeoFinestLevel.load());
+    keyBuilder.append("maxCells", internalQueryS2GeoMaxCells.load());
+    BSONObj keyObj = keyBuilder.obj();
+    std::string key(keyObj.objdata(), keyObj.objsize());
+
+    if (auto cached = s2CoveringCache.get(key, capacity)) {
+        return std::move(*cached);
+    }
+    std::vector<S2CellId> cover = get2dsphereCovering(region);
+    s2CoveringCache.add(key, cover, capacity);
+    return cover;
+}
+
 void ExpressionMapping::cover2dsphere(const S2Region& region,
                                       const S2IndexingParams& indexingParams,
-                                      OrderedIntervalList* oilOut) {
-    std::vector<S2CellId> cover = get2dsphereCovering(region);
+                                      OrderedIntervalList* oilOut,
+                                      const BSONObj& regionSpec) {
+    std::vector<S2CellId> cover = get2dsphereCovering(region, regionSpec);
     S2CellIdsToIntervalsWithParents(cover, indexingParams, oilOut);
 }
 
@@ -138,29 +224,77 @@ bool compareIntervals(const Interval& a, const Interval& b) {
     return a.precedes(b);
 }
 
+/**
+ * Returns the leaf cell ranges spanned by 'cells', sorted, with ranges that overlap or abut
+ * within a face merged so that each merged range can be scanned with a single index seek. Merging
+ * can only add the ids of cells containing two of the original cells, which the index bounds
+ * look up as exact parents anyway.
+ */
+std::vector<std::pair<S2CellId, S2CellId>> coalesceCellRanges(std::vector<S2CellId> cells) {
+    std::sort(cells.begin(), cells.end());
+    std::vector<std::pair<S2CellId, S2CellId>> ranges;
+    for (const S2CellId& cell : cells) {
+        S2CellId min = cell.range_min();
+        S2CellId max = cell.range_max();
+        // Leaf cell ids are odd, so adjacent leaves differ by two. Ranges never cross faces, so
+        // that each range keeps the same sign once converted to a signed index key.
+        if (!ranges.empty() && ranges.back().first.face() == cell.face() &&
+            min.id() <= ranges.back().second.id() + 2) {
+            if (max > ranges.back().second) {
+                ranges.back().second = max;
+            }
+        } else {
+            ranges.emplace_back(min, max);
+        }
+    }
+    return ranges;
+}
+
+/**
+ * Returns whether 'cell' falls within one of 'ranges', which must be sorted and disjoint.
+ */
+bool rangesContain(const std::vector<std::pair<S2CellId, S2CellId>>& ranges,
+                   const S2CellId& cell) {
+    auto it = std::upper_bound(
+        ranges.begin(),
+        ranges.end(),
+        cell,
+        [](const S2CellId& id, const std::pair<S2CellId, S2CellId>& range) {
+            return id < range.first;
+        });
+    return it != ranges.begin() && cell <= std::prev(it)->second;
+}
+
+void appendCellRangeInterval(S2CellId min, S2CellId max, OrderedIntervalList* oilOut) {
+    BSONObjBuilder b;
+    long long start = static_cast<long long>(min.id());
+    long long end = static_cast<long long>(max.id());
+    b.append("start", start);
+    b.append("end", end);
+    invariant(start <= end);
+    oilOut->intervals.push_back(IndexBoundsBuilder::makeRangeInterval(
+        b.obj(), BoundInclusion::kIncludeBothStartAndEndKeys));
+}
+
 void S2CellIdsToIntervalsUnsorted(const std::vector<S2CellId>& intervalSet,
                                   const S2IndexVersion indexVersion,
                                   OrderedIntervalList* oilOut) {
+    if (indexVersion >= S2_INDEX_VERSION_3) {
+        for (const auto& range : coalesceCellRanges(intervalSet)) {
+            appendCellRangeInterval(range.first, range.second, oilOut);
+        }
+        return;
+    }
     for (const S2CellId& interval : intervalSet) {
+        // for backwards compatibility, use strings
         BSONObjBuilder b;
-        if (indexVersion >= S2_INDEX_VERSION_3) {
-            long long start = static_cast<long long>(interval.range_min().id());
-            long long end = static_cast<long long>(interval.range_max().id());
-            b.append("start", start);
-            b.append("end", end);
-            invariant(start <= end);
-            oilOut->intervals.push_back(IndexBoundsBuilder::makeRangeInterval(
-                b.obj(), BoundInclusion::kIncludeBothStartAndEndKeys));
-        } else {
-            // for backwards compatibility, use strings
-            std::string start = interval.toString();
-            std::string end = start;
-            end[start.size() - 1]++;
-            b.append("start", start);
-            b.append("end", end);
-            oilOut->intervals.push_back(IndexBoundsBuilder::makeRangeInterval(
-                b.obj(), BoundInclusion::kIncludeStartKeyOnly));
-        }
+        std::string start = interval.toString();
+        std::string end = start;
+        end[start.size() - 1]++;
+        b.append("start", start);
+        b.append("end", end);
+        oilOut->intervals.push_back(IndexBoundsBuilder::makeRangeInterval(
+            b.obj(), BoundInclusion::kIncludeStartKeyOnly));
     }
 }
 }  // namespace
@@ -213,12 +347,26 @@ void ExpressionMapping::S2CellIdsToIntervalsWithParents(const std::vector<S2Cell
         }
     }
 
-    for (const S2CellId& exact : exactSet) {
-        BSONObj exactBSON = S2CellIdToIndexKey(exact, indexParams.indexVersion);
-        oilOut->intervals.push_back(IndexBoundsBuilder::makePointInterval(exactBSON));
+    if (indexParams.indexVersion >= S2_INDEX_VERSION_3) {
+        // Parent cells which fall within a coalesced range are already scanned by that range.
+        auto ranges = coalesceCellRanges(intervalSet);
+        for (const S2CellId& exact : exactSet) {
+            if (!rangesContain(ranges, exact)) {
+                BSONObj exactBSON = S2CellIdToIndexKey(exact, indexParams.indexVersion);
+                oilOut->intervals.push_back(IndexBoundsBuilder::makePointInterval(exactBSON));
+            }
+        }
+        for (const auto& range : ranges) {
+            appendCellRangeInterval(range.first, range.second, oilOut);
+        }
+    } else {
+        for (const S2CellId& exact : exactSet) {
+            BSONObj exactBSON = S2CellIdToIndexKey(exact, indexParams.indexVersion);
+            oilOut->intervals.push_back(IndexBoundsBuilder::makePointInterval(exactBSON));
+        }
+        S2CellIdsToIntervalsUnsorted(intervalSet, indexParams.indexVersion, oilOut);
     }
 
-    S2CellIdsToIntervalsUnsorted(intervalSet, indexParams.indexVersion, oilOut);
     std::sort(oilOut->intervals.begin(), oilOut->intervals.end(), compareIntervals);
     // Make sure that our intervals don't overlap each other and are ordered correctly.
     // This perhaps should only be done in debug mode.
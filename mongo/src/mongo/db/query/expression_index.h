@@ -50,6 +50,11 @@ class ExpressionMapping {
 public:
     static BSONObj hash(const BSONElement& value);
 
+    /**
+     * Like hash() above, for a hashed index whose spec is 'indexInfoObj'.
+     */
+    static BSONObj hash(const BSONElement& value, const BSONObj& indexInfoObj);
+
     static std::vector<GeoHash> get2dCovering(const R2Region& region,
                                               const BSONObj& indexInfoObj,
                                               int maxCoveringCells);
@@ -64,6 +69,13 @@ public:
 
     static std::vector<S2CellId> get2dsphereCovering(const S2Region& region);
 
+    /**
+     * Like get2dsphereCovering(), but looks the covering up in a process-wide cache keyed on
+     * 'regionSpec', which must uniquely describe 'region', and the current covering knobs.
+     */
+    static std::vector<S2CellId> get2dsphereCovering(const S2Region& region,
+                                                     const BSONObj& regionSpec);
+
     static void S2CellIdsToIntervals(const std::vector<S2CellId>& intervalSet,
                                      const S2IndexVersion indexVersion,
                                      OrderedIntervalList* oilOut);
@@ -74,9 +86,12 @@ public:
                                                 const S2IndexingParams& indexParams,
                                                 OrderedIntervalList* out);
 
+    // Covers 'region'. If 'regionSpec' is not empty, it must uniquely describe 'region' and is used
+    // to cache the covering.
     static void cover2dsphere(const S2Region& region,
                               const S2IndexingParams& indexParams,
-                              OrderedIntervalList* oilOut);
+                              OrderedIntervalList* oilOut,
+                              const BSONObj& regionSpec = BSONObj());
 };
 
 }  // namespace mongo
@@ -59,4 +59,9 @@ extern AtomicInt32 internalQueryS2GeoCoarsestLevel;
 // What is the maximum cell count that we want? (advisory, not a hard threshold)
 extern AtomicInt32 internalQueryS2GeoMaxCells;
 
+// How many 2dsphere query coverings, keyed on the query geometry and the level knobs above, to
+// keep so that repeated $geoWithin and $geoIntersects shapes are not covered again. Zero disables
+// the cache.
+extern AtomicInt32 internalQueryS2GeoCoveringCacheSize;
+
 }  // namespace mongo
@@ -147,7 +147,16 @@ void endQueryOp(OperationContext* opCtx,
     curOp->debug().setPlanSummaryMetrics(summaryStats);
 
     if (collection) {
-        collection->infoCache()->notifyOfQuery(opCtx, summaryStats.indexesUsed);
+        CollectionInfoCache* infoCache = collection->infoCache();
+        infoCache->notifyOfQuery(opCtx, summaryStats);
+
+        if (const CanonicalQuery* cq = exec.getCanonicalQuery()) {
+            infoCache->getQueryShapeStats()->record(
+                infoCache->getPlanCache()->computeKey(*cq),
+                *cq,
+                summaryStats,
+                opCtx->getServiceContext()->getFastClockSource()->now());
+        }
     }
 
     if (curOp->shouldDBProfile()) {
@@ -548,6 +557,12 @@ std::string runQuery(OperationContext* opCtx,
     unique_ptr<CanonicalQuery> cq = std::move(statusWithCQ.getValue());
     invariant(cq.get());
 
+    // A legacy $explain reports the time of each stage of the plan, so have them all time their
+    // work before the plan is built.
+    if (cq->getQueryRequest().isExplain()) {
+        curOp.setIsExplain();
+    }
+
     LOG(5) << "Running query:\n" << redact(cq->toString());
     LOG(2) << "Running query: " << redact(cq->toStringShort());
 
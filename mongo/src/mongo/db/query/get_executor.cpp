@@ -40,6 +40,7 @@
 #include "mongo/base/parse_number.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/exec/cached_plan.h"
 #include "mongo/db/exec/count.h"
 #include "mongo/db/exec/delete.h"
@@ -119,7 +120,7 @@ void filterAllowedIndexEntries(const AllowedIndicesFilter& allowedIndicesFilter,
 
 namespace {
 // The body is below in the "count hack" section but getExecutor calls it.
-bool turnIxscanIntoCount(QuerySolution* soln);
+bool turnIxscanIntoCount(QuerySolution* soln, size_t maxCountScans);
 
 }  // namespace
 
@@ -206,6 +207,10 @@ void fillOutPlannerParams(OperationContext* opCtx,
         plannerParams->options |= QueryPlannerParams::GENERATE_COVERED_IXSCANS;
     }
 
+    if (internalQueryPlannerEnableIndexSkipScan.load()) {
+        plannerParams->options |= QueryPlannerParams::INDEX_SKIP_SCAN;
+    }
+
     plannerParams->options |= QueryPlannerParams::SPLIT_LIMITED_SORT;
 
     // Doc-level locking storage engines cannot answer predicates implicitly via exact index
@@ -293,6 +298,7 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
                                                     unique_ptr<CanonicalQuery> canonicalQuery,
                                                     size_t plannerOptions) {
     invariant(canonicalQuery);
+    ScopedOpPhaseTimer planTimer(opCtx, OpDebug::Phase::kPlan);
 
     unique_ptr<PlanStage> root;
     unique_ptr<QuerySolution> querySolution;
@@ -397,8 +403,17 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
     //plancacheԲοhttps://segmentfault.com/a/1190000015236644 
     CachedSolution* rawCS;
 	//plancacheлȡ
-    if (PlanCache::shouldCacheQuery(*canonicalQuery) &&
-        collection->infoCache()->getPlanCache()->get(*canonicalQuery, &rawCS).isOK()) {
+    const bool shouldCacheQuery = PlanCache::shouldCacheQuery(*canonicalQuery);
+    PlanCache* planCache = collection->infoCache()->getPlanCache();
+    bool haveCachedSolution = shouldCacheQuery && planCache->get(*canonicalQuery, &rawCS).isOK();
+
+    // On a miss, give a concurrent trial of the same shape a chance to cache its winner.
+    if (!haveCachedSolution && shouldCacheQuery &&
+        MultiPlanStage::waitForConcurrentTrial(opCtx, collection, *canonicalQuery)) {
+        haveCachedSolution = planCache->get(*canonicalQuery, &rawCS).isOK();
+    }
+
+    if (haveCachedSolution) {
         // We have a CachedSolution.  Have the planner turn it into a QuerySolution.
         unique_ptr<CachedSolution> cs(rawCS);
         QuerySolution* qs;
@@ -406,7 +421,8 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         Status status = QueryPlanner::planFromCache(*canonicalQuery, plannerParams, *cs, &qs);
 
         if (status.isOK()) {
-            if ((plannerParams.options & QueryPlannerParams::IS_COUNT) && turnIxscanIntoCount(qs)) {
+            if ((plannerParams.options & QueryPlannerParams::IS_COUNT) &&
+                turnIxscanIntoCount(qs, internalQueryMaxScansToExplode.load())) {
                 LOG(2) << "Using fast count: " << redact(canonicalQuery->toStringShort());
             }
 
@@ -468,9 +484,16 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
     }
 
     // See if one of our solutions is a fast count hack in disguise.
+    // Prefer one that counts a single interval over one that needs a count scan per interval.
     if (plannerParams.options & QueryPlannerParams::IS_COUNT) {
-        for (size_t i = 0; i < solutions.size(); ++i) {
-            if (turnIxscanIntoCount(solutions[i])) {
+        const std::vector<size_t> countScanLimits{1,
+                                                  size_t(internalQueryMaxScansToExplode.load())};
+        for (size_t maxCountScans : countScanLimits) {
+            for (size_t i = 0; i < solutions.size(); ++i) {
+                if (!turnIxscanIntoCount(solutions[i], maxCountScans)) {
+                    continue;
+                }
+
                 // Great, we can use solutions[i].  Clean up the other QuerySolution(s).
                 for (size_t j = 0; j < solutions.size(); ++j) {
                     if (j != i) {
@@ -742,6 +765,12 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getOplogStartHack(
     params.shouldTrackLatestOplogTimestamp =
         plannerOptions & QueryPlannerParams::TRACK_LATEST_OPLOG_TS;
 
+    // Change streams tail the oplog with awaitData cursors reading from the majority committed
+    // snapshot. Let all of them on this node share one read of each new oplog entry.
+    params.shareOplogReads = cq->getQueryRequest().isTailableAndAwaitData() &&
+        collection->ns() == NamespaceString::kRsOplogNamespace &&
+        opCtx->recoveryUnit()->isReadingFromMajorityCommittedSnapshot();
+
     // If the query is just a lower bound on "ts", we know that every document in the collection
     // after the first matching one must also match. To avoid wasting time running the match
     // expression on every document to be returned, we tell the CollectionScan stage to stop
@@ -907,7 +936,8 @@ getExecutorDelete(
             CollatorInterface::collatorsMatch(collator.get(), collection->getDefaultCollator());
 
         if (descriptor && CanonicalQuery::isSimpleIdQuery(unparsedQuery) &&
-            request->getProj().isEmpty() && hasCollectionDefaultCollation) {
+            request->getProj().isEmpty() &&
+            (hasCollectionDefaultCollation || IDHackStage::isCollationIndependent(unparsedQuery))) {
             LOG(2) << "Using idhack: " << redact(unparsedQuery);
 
             PlanStage* idHackStage = new IDHackStage(
@@ -1044,7 +1074,8 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>>
             parsedUpdate->getCollator(), collection->getDefaultCollator());
 
         if (descriptor && CanonicalQuery::isSimpleIdQuery(unparsedQuery) &&
-            request->getProj().isEmpty() && hasCollectionDefaultCollation) {
+            request->getProj().isEmpty() &&
+            (hasCollectionDefaultCollation || IDHackStage::isCollationIndependent(unparsedQuery))) {
             LOG(2) << "Using idhack: " << redact(unparsedQuery);
 
             // Working set 'ws' is discarded. InternalPlanner::updateWithIdHack() makes its own
@@ -1185,13 +1216,66 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorGroup(
 
 namespace {
 
+struct CountScanInterval {
+    BSONObj startKey;
+    bool startKeyInclusive;
+    BSONObj endKey;
+    bool endKeyInclusive;
+};
+
+/**
+ * Splits 'bounds' into disjoint single intervals, in index order, that together contain the same
+ * keys, and appends them to 'out'. An OIL with several intervals (e.g. from $in) is split into one
+ * set of bounds per interval, up to 'maxIntervals' in total.
+ *
+ * Returns false if 'bounds' cannot be split this way within 'maxIntervals'.
+ */
+bool explodeIntoSingleIntervals(const IndexBounds& bounds,
+                                size_t maxIntervals,
+                                std::vector<CountScanInterval>* out) {
+    CountScanInterval interval;
+    if (IndexBoundsBuilder::isSingleInterval(bounds,
+                                             &interval.startKey,
+                                             &interval.startKeyInclusive,
+                                             &interval.endKey,
+                                             &interval.endKeyInclusive)) {
+        if (out->size() >= maxIntervals) {
+            return false;
+        }
+        out->push_back(std::move(interval));
+        return true;
+    }
+
+    // Split on the first field with more than one interval. The pieces are disjoint because the
+    // intervals of an OIL are.
+    for (size_t fieldNo = 0; fieldNo < bounds.fields.size(); ++fieldNo) {
+        const OrderedIntervalList& oil = bounds.fields[fieldNo];
+        if (oil.intervals.size() <= 1) {
+            continue;
+        }
+
+        for (const auto& oilInterval : oil.intervals) {
+            IndexBounds piece = bounds;
+            piece.fields[fieldNo].intervals = {oilInterval};
+            if (!explodeIntoSingleIntervals(piece, maxIntervals, out)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
 /**
  * Returns 'true' if the provided solution 'soln' can be rewritten to use
  * a fast counting stage.  Mutates the tree in 'soln->root'.
  *
+ * Bounds made of several intervals are counted by up to 'maxCountScans' count scans, one per
+ * interval, beneath an OR which dedups if the index is multikey.
+ *
  * Otherwise, returns 'false'.
  */
-bool turnIxscanIntoCount(QuerySolution* soln) {
+bool turnIxscanIntoCount(QuerySolution* soln, size_t maxCountScans) {
     QuerySolutionNode* root = soln->root.get();
 
     // Root should be an ixscan or fetch w/o any filters.
@@ -1222,24 +1306,34 @@ bool turnIxscanIntoCount(QuerySolution* soln) {
     }
 
     // Make sure the bounds are OK.
-    BSONObj startKey;
-    bool startKeyInclusive;
-    BSONObj endKey;
-    bool endKeyInclusive;
-
-    if (!IndexBoundsBuilder::isSingleInterval(
-            isn->bounds, &startKey, &startKeyInclusive, &endKey, &endKeyInclusive)) {
+    std::vector<CountScanInterval> intervals;
+    if (!explodeIntoSingleIntervals(isn->bounds, maxCountScans, &intervals)) {
         return false;
     }
 
-    // Make the count node that we replace the fetch + ixscan with.
-    CountScanNode* csn = new CountScanNode(isn->index);
-    csn->startKey = startKey;
-    csn->startKeyInclusive = startKeyInclusive;
-    csn->endKey = endKey;
-    csn->endKeyInclusive = endKeyInclusive;
-    // Takes ownership of 'cn' and deletes the old root.
-    soln->root.reset(csn);
+    // Make the count node(s) that we replace the fetch + ixscan with.
+    std::vector<std::unique_ptr<CountScanNode>> countScans;
+    for (auto&& interval : intervals) {
+        auto csn = stdx::make_unique<CountScanNode>(isn->index);
+        csn->startKey = std::move(interval.startKey);
+        csn->startKeyInclusive = interval.startKeyInclusive;
+        csn->endKey = std::move(interval.endKey);
+        csn->endKeyInclusive = interval.endKeyInclusive;
+        countScans.push_back(std::move(csn));
+    }
+
+    if (countScans.size() == 1) {
+        // Takes ownership of 'csn' and deletes the old root.
+        soln->root = std::move(countScans.front());
+        return true;
+    }
+
+    auto orn = stdx::make_unique<OrNode>();
+    orn->dedup = isn->index.multikey;
+    for (auto&& csn : countScans) {
+        orn->children.push_back(csn.release());
+    }
+    soln->root = std::move(orn);
     return true;
 }
 
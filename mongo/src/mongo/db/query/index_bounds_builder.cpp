@@ -602,6 +602,7 @@ void IndexBoundsBuilder::translate(const MatchExpression* expr,
         // Create our various intervals.
 
         IndexBoundsBuilder::BoundsTightness tightness;
+        oilOut->intervals.reserve(oilOut->intervals.size() + ime->getEqualities().size());
         for (auto&& equality : ime->getEqualities()) {
             translateEquality(equality, index, isHashed, oilOut, &tightness);
             if (tightness != IndexBoundsBuilder::EXACT) {
@@ -640,7 +641,10 @@ void IndexBoundsBuilder::translate(const MatchExpression* expr,
             const S2Region& region = gme->getGeoExpression().getGeometry().getS2Region();
             S2IndexingParams indexParams;
             ExpressionParams::initialize2dsphereParams(index.infoObj, index.collator, &indexParams);
-            ExpressionMapping::cover2dsphere(region, indexParams, oilOut);
+            // The serialized predicate identifies the region, so its covering can be cached.
+            BSONObjBuilder regionSpec;
+            gme->serialize(&regionSpec);
+            ExpressionMapping::cover2dsphere(region, indexParams, oilOut, regionSpec.obj());
             *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
         } else if (mongoutils::str::equals("2d", elt.valuestrsafe())) {
             verify(gme->getGeoExpression().getGeometry().hasR2Region());
@@ -734,46 +738,48 @@ void IndexBoundsBuilder::unionize(OrderedIntervalList* oilOut) {
         return;
     }
 
-    // Step 1: sort.
-    std::sort(iv.begin(), iv.end(), IntervalComparison);
+    // Step 1: sort. Intervals generated from a sorted set of equalities, such as those of a large
+    // $in, are frequently already in order, in which case the sort is skipped.
+    if (!std::is_sorted(iv.begin(), iv.end(), IntervalComparison)) {
+        std::sort(iv.begin(), iv.end(), IntervalComparison);
+    }
 
-    // Step 2: Walk through and merge.
-    size_t i = 0;
-    while (i < iv.size() - 1) {
-        // Compare i with i + 1.
-        Interval::IntervalComparison cmp = iv[i].compare(iv[i + 1]);
+    // Step 2: Walk through and merge. Intervals are compacted in place so that the walk is linear
+    // in the number of intervals, rather than erasing from the middle of the vector.
+    size_t last = 0;
+    for (size_t next = 1; next < iv.size(); ++next) {
+        // Compare the last kept interval with the next one.
+        Interval::IntervalComparison cmp = iv[last].compare(iv[next]);
 
         // This means our sort didn't work.
         verify(Interval::INTERVAL_SUCCEEDS != cmp);
 
-        // Intervals are correctly ordered.
         if (Interval::INTERVAL_PRECEDES == cmp) {
-            // We can move to the next pair.
-            ++i;
+            // Intervals are correctly ordered, keep 'next'.
+            ++last;
+            if (last != next) {
+                iv[last] = std::move(iv[next]);
+            }
         } else if (Interval::INTERVAL_EQUALS == cmp || Interval::INTERVAL_WITHIN == cmp) {
-            // Interval 'i' is equal to i+1, or is contained within i+1.
-            // Remove interval i and don't move to the next value of 'i'.
-            iv.erase(iv.begin() + i);
+            // Interval 'last' is equal to 'next', or is contained within 'next'. Replace it.
+            iv[last] = std::move(iv[next]);
         } else if (Interval::INTERVAL_CONTAINS == cmp) {
-            // Interval 'i' contains i+1, remove i+1 and don't move to the next value of 'i'.
-            iv.erase(iv.begin() + i + 1);
+            // Interval 'last' contains 'next', drop 'next'.
         } else if (Interval::INTERVAL_OVERLAPS_BEFORE == cmp ||
                    Interval::INTERVAL_PRECEDES_COULD_UNION == cmp) {
-            // We want to merge intervals i and i+1.
-            // Interval 'i' starts before interval 'i+1'.
+            // We want to merge intervals 'last' and 'next'.
+            // Interval 'last' starts before interval 'next'.
             BSONObjBuilder bob;
-            bob.appendAs(iv[i].start, "");
-            bob.appendAs(iv[i + 1].end, "");
+            bob.appendAs(iv[last].start, "");
+            bob.appendAs(iv[next].end, "");
             BSONObj data = bob.obj();
-            bool startInclusive = iv[i].startInclusive;
-            bool endInclusive = iv[i + 1].endInclusive;
-            iv.erase(iv.begin() + i);
-            // iv[i] is now the former iv[i + 1]
-            iv[i] = makeRangeInterval(
+            bool startInclusive = iv[last].startInclusive;
+            bool endInclusive = iv[next].endInclusive;
+            iv[last] = makeRangeInterval(
                 data, IndexBounds::makeBoundInclusionFromBoundBools(startInclusive, endInclusive));
-            // Don't increment 'i'.
         }
     }
+    iv.erase(iv.begin() + last + 1, iv.end());
 }
 
 // static
@@ -869,7 +875,7 @@ void IndexBoundsBuilder::translateEquality(const BSONElement& data,
     if (Array != data.type()) {
         BSONObj dataObj = objFromElement(data, index.collator);
         if (isHashed) {
-            dataObj = ExpressionMapping::hash(dataObj.firstElement());
+            dataObj = ExpressionMapping::hash(dataObj.firstElement(), index.infoObj);
         }
 
         verify(dataObj.isOwned());
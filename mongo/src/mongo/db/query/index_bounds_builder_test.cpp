@@ -39,6 +39,7 @@
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/db/query/expression_index.h"
 #include "mongo/unittest/unittest.h"
+#include "third_party/s2/s2cellid.h"
 
 using namespace mongo;
 
@@ -1482,6 +1483,47 @@ TEST(IndexBoundsBuilderTest, UnionizeWithNE) {
     ASSERT_EQUALS(tightness, IndexBoundsBuilder::EXACT);
 }
 
+TEST(IndexBoundsBuilderTest, TranslateLargeInProducesSortedPointIntervals) {
+    IndexEntry testIndex = IndexEntry(BSONObj());
+    BSONArrayBuilder inBuilder;
+    for (int i = 999; i >= 0; --i) {
+        inBuilder.append(i);
+    }
+    BSONObj obj = BSON("a" << BSON("$in" << inBuilder.arr()));
+    unique_ptr<MatchExpression> expr(parseMatchExpression(obj));
+    BSONElement elt = obj.firstElement();
+    OrderedIntervalList oil;
+    IndexBoundsBuilder::BoundsTightness tightness;
+    IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &oil, &tightness);
+    ASSERT_EQUALS(oil.name, "a");
+    ASSERT_EQUALS(oil.intervals.size(), 1000U);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                      oil.intervals[i].compare(Interval(BSON("" << i << "" << i), true, true)));
+    }
+    ASSERT_EQUALS(tightness, IndexBoundsBuilder::EXACT);
+}
+
+TEST(IndexBoundsBuilderTest, UnionizeMergesRunsOfOverlappingIntervals) {
+    OrderedIntervalList oil;
+    oil.intervals.push_back(Interval(fromjson("{'': 10, '': 12}"), true, true));
+    oil.intervals.push_back(Interval(fromjson("{'': 1, '': 3}"), true, true));
+    oil.intervals.push_back(Interval(fromjson("{'': 2, '': 5}"), true, false));
+    oil.intervals.push_back(Interval(fromjson("{'': 5, '': 6}"), true, true));
+    oil.intervals.push_back(Interval(fromjson("{'': 4, '': 4}"), true, true));
+    oil.intervals.push_back(Interval(fromjson("{'': 11, '': 11}"), true, true));
+    oil.intervals.push_back(Interval(fromjson("{'': 8, '': 8}"), true, true));
+    oil.intervals.push_back(Interval(fromjson("{'': 8, '': 8}"), true, true));
+    IndexBoundsBuilder::unionize(&oil);
+    ASSERT_EQUALS(oil.intervals.size(), 3U);
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[0].compare(Interval(fromjson("{'': 1, '': 6}"), true, true)));
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[1].compare(Interval(fromjson("{'': 8, '': 8}"), true, true)));
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[2].compare(Interval(fromjson("{'': 10, '': 12}"), true, true)));
+}
+
 // Test $type bounds for Code BSON type.
 TEST(IndexBoundsBuilderTest, CodeTypeBounds) {
     IndexEntry testIndex = IndexEntry(BSONObj());
@@ -2302,4 +2344,81 @@ TEST(IndexBoundsBuilderTest, CanUseCoveredMatchingForExistsTrueWithSparseIndex)
     ASSERT_TRUE(IndexBoundsBuilder::canUseCoveredMatching(expr.get(), testIndex));
 }
 
+// Adjacent cells of a version 3 2dsphere covering are scanned as a single range.
+TEST(IndexBoundsBuilderTest, S2CoveringCoalescesAdjacentCells) {
+    S2CellId parent = S2CellId::FromFacePosLevel(1, 0, 10).parent(8);
+    std::vector<S2CellId> cells{parent.child(0), parent.child(1), parent.child(3)};
+
+    OrderedIntervalList oil;
+    ExpressionMapping::S2CellIdsToIntervals(cells, S2_INDEX_VERSION_3, &oil);
+    ASSERT_EQUALS(oil.intervals.size(), 2U);
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[0].compare(Interval(
+                      BSON("" << static_cast<long long>(parent.child(0).range_min().id()) << ""
+                              << static_cast<long long>(parent.child(1).range_max().id())),
+                      true,
+                      true)));
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[1].compare(Interval(
+                      BSON("" << static_cast<long long>(parent.child(3).range_min().id()) << ""
+                              << static_cast<long long>(parent.child(3).range_max().id())),
+                      true,
+                      true)));
+
+    // Earlier index versions use string keys, which cannot be coalesced.
+    OrderedIntervalList stringOil;
+    ExpressionMapping::S2CellIdsToIntervals(cells, S2_INDEX_VERSION_2, &stringOil);
+    ASSERT_EQUALS(stringOil.intervals.size(), 3U);
+}
+
+// A parent cell whose id falls within a coalesced range is not also looked up as a point.
+TEST(IndexBoundsBuilderTest, S2CoveringWithParentsDropsParentsWithinCoalescedRanges) {
+    S2CellId parent = S2CellId::FromFacePosLevel(1, 0, 10).parent(8);
+    std::vector<S2CellId> cells{parent.child(0), parent.child(1)};
+
+    S2IndexingParams params;
+    params.coarsestIndexedLevel = parent.level();
+    params.finestIndexedLevel = parent.level() + 1;
+    params.indexVersion = S2_INDEX_VERSION_3;
+
+    OrderedIntervalList oil;
+    ExpressionMapping::S2CellIdsToIntervalsWithParents(cells, params, &oil);
+    ASSERT_EQUALS(oil.intervals.size(), 1U);
+    ASSERT_TRUE(oil.isValidFor(1));
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[0].compare(Interval(
+                      BSON("" << static_cast<long long>(parent.child(0).range_min().id()) << ""
+                              << static_cast<long long>(parent.child(1).range_max().id())),
+                      true,
+                      true)));
+}
+
+TEST(IndexBoundsBuilderTest, TranslateGeoWithinUsesCachedCovering) {
+    IndexEntry testIndex = IndexEntry(BSON("loc"
+                                           << "2dsphere"));
+    testIndex.infoObj = BSON("key" << BSON("loc"
+                                           << "2dsphere")
+                                   << "2dsphereIndexVersion"
+                                   << 3);
+    BSONObj obj = fromjson(
+        "{loc: {$geoWithin: {$geometry: {type: 'Polygon', coordinates: "
+        "[[[0, 0], [0, 1], [1, 1], [1, 0], [0, 0]]]}}}}");
+    unique_ptr<MatchExpression> expr(parseMatchExpression(obj));
+    BSONElement elt = testIndex.keyPattern.firstElement();
+
+    OrderedIntervalList first;
+    IndexBoundsBuilder::BoundsTightness tightness;
+    IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &first, &tightness);
+    ASSERT_TRUE(first.isValidFor(1));
+    ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
+
+    // The second translation is served from the covering cache and must agree with the first.
+    OrderedIntervalList second;
+    IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &second, &tightness);
+    ASSERT_EQUALS(first.intervals.size(), second.intervals.size());
+    for (size_t i = 0; i < first.intervals.size(); ++i) {
+        ASSERT_EQUALS(Interval::INTERVAL_EQUALS, first.intervals[i].compare(second.intervals[i]));
+    }
+}
+
 }  // namespace
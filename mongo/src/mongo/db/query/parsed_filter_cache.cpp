@@ -0,0 +1,308 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/parsed_filter_cache.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_tree.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+
+namespace mongo {
+
+namespace {
+
+// Lookups only hold the lock of the partition their shape hashes to, so that concurrent finds
+// of different shapes do not serialize on a single mutex.
+const size_t kNumPartitions = 16;
+
+// Marks a predicate written as {field: <value>} in a shape key, as opposed to an explicit
+// {field: {$op: <value>}}. The two parse to the same tree but keep their constants at different
+// places in the filter.
+const char kImplicitEqualityMarker[] = "=";
+
+bool isCacheableOperand(const BSONElement& operand) {
+    switch (operand.type()) {
+        case NumberDouble:
+        case String:
+        case jstOID:
+        case Bool:
+        case Date:
+        case jstNULL:
+        case NumberInt:
+        case bsonTimestamp:
+        case NumberLong:
+        case NumberDecimal:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isCacheableOperator(StringData op) {
+    return op == "$eq" || op == "$lt" || op == "$lte" || op == "$gt" || op == "$gte";
+}
+
+/**
+ * Returns the element holding the constant of the top-level predicate 'elem', which is either
+ * 'elem' itself or the operand of its single operator.
+ */
+BSONElement operandOf(const BSONElement& elem) {
+    return elem.type() == Object ? elem.embeddedObject().firstElement() : elem;
+}
+
+/**
+ * Builds the shape key of 'filter' into 'shapeKey'. Returns false if 'filter' is not eligible
+ * for the parsed filter cache.
+ */
+bool makeShapeKey(const BSONObj& filter, std::string* shapeKey) {
+    if (filter.isEmpty()) {
+        return false;
+    }
+
+    for (auto&& elem : filter) {
+        StringData fieldName = elem.fieldNameStringData();
+        if (fieldName.empty() || fieldName[0] == '$') {
+            return false;
+        }
+
+        shapeKey->append(fieldName.rawData(), fieldName.size());
+        shapeKey->push_back('\0');
+
+        if (elem.type() == Object) {
+            BSONObj predicate = elem.embeddedObject();
+            if (predicate.nFields() != 1) {
+                return false;
+            }
+            BSONElement operand = predicate.firstElement();
+            StringData op = operand.fieldNameStringData();
+            if (!isCacheableOperator(op) || !isCacheableOperand(operand)) {
+                return false;
+            }
+            shapeKey->append(op.rawData(), op.size());
+        } else {
+            if (!isCacheableOperand(elem)) {
+                return false;
+            }
+            shapeKey->append(kImplicitEqualityMarker);
+        }
+        shapeKey->push_back('\0');
+    }
+    return true;
+}
+
+std::unique_ptr<ComparisonMatchExpression> makeComparison(MatchExpression::MatchType type) {
+    switch (type) {
+        case MatchExpression::EQ:
+            return stdx::make_unique<EqualityMatchExpression>();
+        case MatchExpression::LT:
+            return stdx::make_unique<LTMatchExpression>();
+        case MatchExpression::LTE:
+            return stdx::make_unique<LTEMatchExpression>();
+        case MatchExpression::GT:
+            return stdx::make_unique<GTMatchExpression>();
+        case MatchExpression::GTE:
+            return stdx::make_unique<GTEMatchExpression>();
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+}  // namespace
+
+/**
+ * The leaves of a normalized tree, in the order normalization left them, together with the
+ * position in the filter of the predicate each leaf was parsed from.
+ */
+struct ParsedFilterCache::Template {
+    struct Leaf {
+        MatchExpression::MatchType type;
+        std::string path;
+        size_t filterIndex;
+    };
+
+    // Whether the leaves sit under an AND, or the single leaf is the root of the tree.
+    bool hasAndRoot;
+    std::vector<Leaf> leaves;
+};
+
+struct ParsedFilterCache::Partition {
+    mutable stdx::mutex mutex;
+    stdx::unordered_map<std::string, std::shared_ptr<const Template>> templates;
+};
+
+ParsedFilterCache::ParsedFilterCache() : _partitions(new Partition[kNumPartitions]) {}
+
+ParsedFilterCache::~ParsedFilterCache() = default;
+
+ParsedFilterCache& ParsedFilterCache::get() {
+    static ParsedFilterCache cache;
+    return cache;
+}
+
+ParsedFilterCache::Partition& ParsedFilterCache::_partitionFor(const std::string& shapeKey) const {
+    return _partitions[std::hash<std::string>()(shapeKey) % kNumPartitions];
+}
+
+std::unique_ptr<MatchExpression> ParsedFilterCache::bind(const BSONObj& filter,
+                                                         const CollatorInterface* collator) const {
+    std::string shapeKey;
+    if (!makeShapeKey(filter, &shapeKey)) {
+        return nullptr;
+    }
+
+    std::shared_ptr<const Template> tmpl;
+    {
+        Partition& partition = _partitionFor(shapeKey);
+        stdx::lock_guard<stdx::mutex> lock(partition.mutex);
+        auto it = partition.templates.find(shapeKey);
+        if (it == partition.templates.end()) {
+            return nullptr;
+        }
+        tmpl = it->second;
+    }
+
+    std::vector<BSONElement> operands;
+    operands.reserve(tmpl->leaves.size());
+    for (auto&& elem : filter) {
+        operands.push_back(operandOf(elem));
+    }
+
+    std::unique_ptr<AndMatchExpression> andRoot;
+    if (tmpl->hasAndRoot) {
+        andRoot = stdx::make_unique<AndMatchExpression>();
+    }
+
+    std::unique_ptr<MatchExpression> leafRoot;
+    for (auto&& leaf : tmpl->leaves) {
+        invariant(leaf.filterIndex < operands.size());
+        auto expr = makeComparison(leaf.type);
+        if (!expr->init(leaf.path, operands[leaf.filterIndex]).isOK()) {
+            return nullptr;
+        }
+        expr->setCollator(collator);
+
+        if (andRoot) {
+            andRoot->add(expr.release());
+        } else {
+            leafRoot = std::move(expr);
+        }
+    }
+
+    if (andRoot) {
+        return std::move(andRoot);
+    }
+    return leafRoot;
+}
+
+void ParsedFilterCache::add(const BSONObj& filter, const MatchExpression* root) {
+    const int maxSize = internalQueryParsedFilterCacheSize.load();
+    if (maxSize <= 0) {
+        return;
+    }
+
+    std::string shapeKey;
+    if (!makeShapeKey(filter, &shapeKey)) {
+        return;
+    }
+
+    std::vector<const MatchExpression*> leaves;
+    auto tmpl = std::make_shared<Template>();
+    tmpl->hasAndRoot = (root->matchType() == MatchExpression::AND);
+    if (tmpl->hasAndRoot) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            leaves.push_back(root->getChild(i));
+        }
+    } else {
+        leaves.push_back(root);
+    }
+
+    std::vector<BSONElement> operands;
+    for (auto&& elem : filter) {
+        operands.push_back(operandOf(elem));
+    }
+    if (leaves.size() != operands.size()) {
+        return;
+    }
+
+    // Each leaf still points at the constant it was parsed from, which identifies the predicate
+    // of 'filter' it came from regardless of where normalization moved it.
+    for (const MatchExpression* leaf : leaves) {
+        if (!ComparisonMatchExpression::isComparisonMatchExpression(leaf) || leaf->getTag()) {
+            return;
+        }
+        const BSONElement& data = static_cast<const ComparisonMatchExpression*>(leaf)->getData();
+
+        size_t filterIndex = 0;
+        while (filterIndex < operands.size() &&
+               operands[filterIndex].rawdata() != data.rawdata()) {
+            ++filterIndex;
+        }
+        if (filterIndex == operands.size()) {
+            return;
+        }
+        tmpl->leaves.push_back({leaf->matchType(), leaf->path().toString(), filterIndex});
+    }
+
+    const size_t maxPartitionSize = std::max<size_t>(1, maxSize / kNumPartitions);
+    Partition& partition = _partitionFor(shapeKey);
+    stdx::lock_guard<stdx::mutex> lock(partition.mutex);
+    if (partition.templates.size() >= maxPartitionSize &&
+        partition.templates.find(shapeKey) == partition.templates.end()) {
+        // There is no usage tracking to pick a victim from, so start the partition over.
+        partition.templates.clear();
+    }
+    partition.templates[shapeKey] = std::move(tmpl);
+}
+
+void ParsedFilterCache::clear() {
+    for (size_t i = 0; i < kNumPartitions; ++i) {
+        stdx::lock_guard<stdx::mutex> lock(_partitions[i].mutex);
+        _partitions[i].templates.clear();
+    }
+}
+
+size_t ParsedFilterCache::size() const {
+    size_t total = 0;
+    for (size_t i = 0; i < kNumPartitions; ++i) {
+        stdx::lock_guard<stdx::mutex> lock(_partitions[i].mutex);
+        total += _partitions[i].templates.size();
+    }
+    return total;
+}
+
+}  // namespace mongo
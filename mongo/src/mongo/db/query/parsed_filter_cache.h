@@ -0,0 +1,94 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+
+class CollatorInterface;
+class MatchExpression;
+
+/**
+ * A process-wide cache of normalized match expression trees, keyed by the shape of the filter
+ * they were parsed from. Only flat filters whose top-level predicates are all comparisons
+ * against scalars are cached, e.g. {a: 1, b: {$gte: 5}}. For those, the tree produced by
+ * parsing, optimizing and sorting depends only on the field names and operators, so a later
+ * filter of the same shape can be served by rebuilding the cached tree around its own constants
+ * rather than going through MatchExpressionParser and normalization again.
+ *
+ * The cache is bounded by internalQueryParsedFilterCacheSize, and is disabled when that is zero.
+ */
+class ParsedFilterCache {
+    MONGO_DISALLOW_COPYING(ParsedFilterCache);
+
+public:
+    ParsedFilterCache();
+    ~ParsedFilterCache();
+
+    static ParsedFilterCache& get();
+
+    /**
+     * Returns the normalized tree for 'filter' if its shape is cached, with every leaf bound to
+     * the corresponding constant of 'filter' and to 'collator'. The returned tree points into
+     * 'filter', which must outlive it. Returns nullptr if the shape is not cached, in which case
+     * the caller must parse 'filter' itself.
+     */
+    std::unique_ptr<MatchExpression> bind(const BSONObj& filter,
+                                          const CollatorInterface* collator) const;
+
+    /**
+     * Remembers the shape of 'filter', given 'root', the normalized tree it parsed into.
+     * Filters that are not eligible for caching are ignored.
+     */
+    void add(const BSONObj& filter, const MatchExpression* root);
+
+    /**
+     * Drops every cached shape.
+     */
+    void clear();
+
+    /**
+     * Returns the number of cached shapes.
+     */
+    size_t size() const;
+
+private:
+    struct Partition;
+    struct Template;
+
+    Partition& _partitionFor(const std::string& shapeKey) const;
+
+    std::unique_ptr<Partition[]> _partitions;
+};
+
+}  // namespace mongo
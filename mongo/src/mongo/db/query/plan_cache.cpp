@@ -47,6 +47,7 @@
 #include "mongo/db/query/query_solution.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/transitional_tools_do_not_use/vector_spooling.h"
 
@@ -556,9 +557,15 @@ std::string SolutionCacheData::toString() const {
 // PlanCache
 //
 
-PlanCache::PlanCache() : _cache(internalQueryCacheSize.load()) {}
+PlanCache::PlanCache() : PlanCache(std::string()) {}
 
-PlanCache::PlanCache(const std::string& ns) : _cache(internalQueryCacheSize.load()), _ns(ns) {}
+PlanCache::PlanCache(const std::string& ns) : _ns(ns) {
+    const size_t maxSize = std::max(internalQueryCacheSize.load(), 0);
+    const size_t maxSizePerShard = std::max<size_t>(1, (maxSize + kNumShards - 1) / kNumShards);
+    for (size_t i = 0; i < kNumShards; ++i) {
+        _shards.push_back(stdx::make_unique<Shard>(maxSizePerShard));
+    }
+}
 
 PlanCache::~PlanCache() {}
 
@@ -738,8 +745,10 @@ Status PlanCache::add(const CanonicalQuery& query,
     }
     entry->projection = projBuilder.obj();
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(computeKey(query), entry);
+    const PlanCacheKey key = computeKey(query);
+    Shard& shard = _getShard(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
+    std::unique_ptr<PlanCacheEntry> evictedEntry = shard.cache.add(key, entry);
 
     if (NULL != evictedEntry.get()) {
         LOG(1) << _ns << ": plan cache maximum size exceeded - "
@@ -753,9 +762,10 @@ Status PlanCache::get(const CanonicalQuery& query, CachedSolution** crOut) const
     PlanCacheKey key = computeKey(query);
     verify(crOut);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Shard& shard = _getShard(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = shard.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -773,9 +783,10 @@ Status PlanCache::feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* fee
     std::unique_ptr<PlanCacheEntryFeedback> autoFeedback(feedback);
     PlanCacheKey ck = computeKey(cq);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Shard& shard = _getShard(ck);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(ck, &entry);
+    Status cacheStatus = shard.cache.get(ck, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -790,13 +801,21 @@ Status PlanCache::feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* fee
 }
 
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    const PlanCacheKey key = computeKey(canonicalQuery);
+    Shard& shard = _getShard(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
+    return shard.cache.remove(key);
 }
 
 void PlanCache::clear() {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    _cache.clear();
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> cacheLock(shard->mutex);
+        shard->cache.clear();
+    }
+}
+
+PlanCache::Shard& PlanCache::_getShard(const PlanCacheKey& key) const {
+    return *_shards[std::hash<PlanCacheKey>()(key) % kNumShards];
 }
 
 PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
@@ -811,9 +830,10 @@ Status PlanCache::getEntry(const CanonicalQuery& query, PlanCacheEntry** entryOu
     PlanCacheKey key = computeKey(query);
     verify(entryOut);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Shard& shard = _getShard(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = shard.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -825,25 +845,33 @@ Status PlanCache::getEntry(const CanonicalQuery& query, PlanCacheEntry** entryOu
 }
 
 std::vector<PlanCacheEntry*> PlanCache::getAllEntries() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
     std::vector<PlanCacheEntry*> entries;
     typedef std::list<std::pair<PlanCacheKey, PlanCacheEntry*>>::const_iterator ConstIterator;
-    for (ConstIterator i = _cache.begin(); i != _cache.end(); i++) {
-        PlanCacheEntry* entry = i->second;
-        entries.push_back(entry->clone());
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> cacheLock(shard->mutex);
+        for (ConstIterator i = shard->cache.begin(); i != shard->cache.end(); i++) {
+            PlanCacheEntry* entry = i->second;
+            entries.push_back(entry->clone());
+        }
     }
 
     return entries;
 }
 
 bool PlanCache::contains(const CanonicalQuery& cq) const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.hasKey(computeKey(cq));
+    const PlanCacheKey key = computeKey(cq);
+    Shard& shard = _getShard(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
+    return shard.cache.hasKey(key);
 }
 
 size_t PlanCache::size() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.size();
+    size_t size = 0;
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> cacheLock(shard->mutex);
+        size += shard->cache.size();
+    }
+    return size;
 }
 
 void PlanCache::notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries) {
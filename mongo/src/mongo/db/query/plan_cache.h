@@ -429,10 +429,25 @@ private:
     void encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuilder) const;
     void encodeKeyForProj(const BSONObj& projObj, StringBuilder* keyBuilder) const;
 
-    LRUKeyValue<PlanCacheKey, PlanCacheEntry> _cache;
+    /**
+     * The cache is split into independently locked shards, selected by a hash of the cache key,
+     * so that concurrent queries of different shapes on the same collection do not serialize on a
+     * single mutex. Each shard is an LRU holding 1/kNumShards of the configured cache size.
+     */
+    struct Shard {
+        explicit Shard(size_t maxSize) : cache(maxSize) {}
+
+        LRUKeyValue<PlanCacheKey, PlanCacheEntry> cache;
+
+        // Protects 'cache'.
+        stdx::mutex mutex;
+    };
+
+    static const size_t kNumShards = 8;
+
+    Shard& _getShard(const PlanCacheKey& key) const;
 
-    // Protects _cache.
-    mutable stdx::mutex _cacheMutex;
+    std::vector<std::unique_ptr<Shard>> _shards;
 
     // Full namespace of collection.
     std::string _ns;
@@ -0,0 +1,96 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString nss("test.collection");
+
+const char* const kQueries[] = {
+    "{a: 1}",
+    "{a: {$gt: 1}, b: {$in: [1, 2, 3]}, c: {$exists: true}}",
+    "{$or: [{a: 1, b: 2}, {c: {$lt: 5}}, {d: {$elemMatch: {e: 1, f: {$ne: 2}}}}]}",
+};
+
+std::unique_ptr<CanonicalQuery> canonicalize(OperationContext* opCtx, const BSONObj& filter) {
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(filter);
+    qr->setSort(BSON("a" << 1));
+    auto statusWithCQ = CanonicalQuery::canonicalize(opCtx, std::move(qr));
+    invariant(statusWithCQ.isOK());
+    return std::move(statusWithCQ.getValue());
+}
+
+// state.range(0) selects the query from kQueries.
+void BM_canonicalQueryCanonicalize(benchmark::State& state) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    const BSONObj filter = fromjson(kQueries[state.range(0)]);
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(canonicalize(opCtx.get(), filter).get());
+    }
+}
+BENCHMARK(BM_canonicalQueryCanonicalize)->arg(0)->arg(1)->arg(2);
+
+// Computes the query shape key, which every cached plan lookup does first.
+void BM_planCacheComputeKey(benchmark::State& state) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    const auto cq = canonicalize(opCtx.get(), fromjson(kQueries[state.range(0)]));
+    PlanCache planCache;
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(planCache.computeKey(*cq).size());
+    }
+}
+BENCHMARK(BM_planCacheComputeKey)->arg(0)->arg(1)->arg(2);
+
+// Looks up a query shape which is not cached, including the key computation and the cache lock.
+void BM_planCacheLookupMiss(benchmark::State& state) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    const auto cq = canonicalize(opCtx.get(), fromjson(kQueries[state.range(0)]));
+    PlanCache planCache;
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(planCache.contains(*cq));
+    }
+}
+BENCHMARK(BM_planCacheLookupMiss)->arg(0)->arg(1)->arg(2);
+
+}  // namespace
+}  // namespace mongo
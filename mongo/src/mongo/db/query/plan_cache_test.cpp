@@ -449,6 +449,52 @@ TEST(PlanCacheTest, AddValidSolution) {
     ASSERT_EQUALS(planCache.size(), 1U);
 }
 
+TEST(PlanCacheTest, ManyShapesAreAllReachableAcrossShards) {
+    PlanCache planCache;
+    QuerySolution qs;
+    qs.cacheData.reset(new SolutionCacheData());
+    qs.cacheData->tree.reset(new PlanCacheIndexTree());
+    std::vector<QuerySolution*> solns;
+    solns.push_back(&qs);
+    QueryTestServiceContext serviceContext;
+
+    // Each query below has a distinct shape, so the entries spread over the cache's shards.
+    const char* queries[] = {"{a: 1}",
+                             "{b: 1}",
+                             "{c: 1}",
+                             "{d: 1}",
+                             "{a: 1, b: 1}",
+                             "{a: {$gt: 1}}",
+                             "{b: {$lt: 1}}",
+                             "{a: {$in: [1, 2]}}",
+                             "{c: {$exists: true}}",
+                             "{$or: [{a: 1}, {b: 1}]}"};
+    std::vector<unique_ptr<CanonicalQuery>> cqs;
+    for (auto query : queries) {
+        cqs.push_back(canonicalize(query));
+        ASSERT_OK(planCache.add(*cqs.back(), solns, createDecision(1U), Date_t{}));
+    }
+
+    const size_t numShapes = sizeof(queries) / sizeof(queries[0]);
+    ASSERT_EQUALS(planCache.size(), numShapes);
+    for (auto&& cq : cqs) {
+        ASSERT_TRUE(planCache.contains(*cq));
+    }
+
+    std::vector<PlanCacheEntry*> entries = planCache.getAllEntries();
+    ASSERT_EQUALS(entries.size(), numShapes);
+    for (auto entry : entries) {
+        delete entry;
+    }
+
+    ASSERT_OK(planCache.remove(*cqs.front()));
+    ASSERT_FALSE(planCache.contains(*cqs.front()));
+    ASSERT_EQUALS(planCache.size(), numShapes - 1);
+
+    planCache.clear();
+    ASSERT_EQUALS(planCache.size(), 0U);
+}
+
 /**
  * Each test in the CachePlanSelectionTest suite goes through
  * the following flow:
@@ -34,6 +34,7 @@
 
 #include "mongo/db/query/index_tag.h"
 #include "mongo/db/query/indexability.h"
+#include "mongo/db/query/planner_ixselect.h"
 #include "mongo/util/log.h"
 #include "mongo/util/string_map.h"
 
@@ -257,6 +258,7 @@ PlanEnumerator::PlanEnumerator(const PlanEnumeratorParams& params)
     : _root(params.root),
       _indices(params.indices),
       _ixisect(params.intersect),
+      _skipScan(params.skipScan),
       _orLimit(params.maxSolutionsPerOr),
       _intersectLimit(params.maxIntersectPerAnd) {}
 
@@ -941,6 +943,38 @@ void PlanEnumerator::enumerateOneIndex(
             andAssignment->choices.push_back(std::move(state));
         }
     }
+
+    if (!_skipScan) {
+        return;
+    }
+
+    // Indices with predicates over some of their fields but not the leading one can be skip
+    // scanned: the leading fields get bounds over all values and the index scan seeks past each
+    // of their distinct values that has no keys within the bounds on the later fields. Whether
+    // that beats the alternatives depends on how many distinct leading values there are, which
+    // is left to plan ranking.
+    for (IndexToPredMap::const_iterator it = idxToNotFirst.begin(); it != idxToNotFirst.end();
+         ++it) {
+        const IndexEntry& thisIndex = (*_indices)[it->first];
+        if (idxToFirst.find(it->first) != idxToFirst.end() ||
+            !QueryPlannerIXSelect::canSkipScan(thisIndex)) {
+            continue;
+        }
+
+        OneIndexAssignment indexAssign;
+        indexAssign.index = it->first;
+        for (auto pred : it->second) {
+            assignPredicate(outsidePreds, pred, getPosition(thisIndex, pred), &indexAssign);
+        }
+
+        // Do not output this assignment if it consists only of outside predicates.
+        if (!indexAssign.preds.empty()) {
+            AndEnumerableState state;
+            state.assignments.push_back(std::move(indexAssign));
+            andAssignment->choices.push_back(std::move(state));
+            _hasSkipScanAssignments = true;
+        }
+    }
 }
 
 void PlanEnumerator::enumerateAndIntersect(const IndexToPredMap& idxToFirst,
@@ -44,6 +44,7 @@ namespace mongo {
 struct PlanEnumeratorParams {
     PlanEnumeratorParams()
         : intersect(false),
+          skipScan(false),
           maxSolutionsPerOr(internalQueryEnumerationMaxOrSolutions.load()),
           maxIntersectPerAnd(internalQueryEnumerationMaxIntersectPerAnd.load()) {}
 
@@ -51,6 +52,10 @@ struct PlanEnumeratorParams {
     // an indexed solution?
     bool intersect;
 
+    // Do we provide solutions that use a compound index without a predicate over its leading
+    // field?
+    bool skipScan;
+
     // Not owned here.
     MatchExpression* root;
 
@@ -100,6 +105,14 @@ public:
      */
     Status init();
 
+    /**
+     * Returns true if any of the plans that may be output skip scans an index. Only valid after
+     * init().
+     */
+    bool hasSkipScanAssignments() const {
+        return _hasSkipScanAssignments;
+    }
+
     /**
      * Outputs a possible plan. Leaves in the plan are tagged with an index to use.
      * Returns a MatchExpression representing a point in the query tree (which can be
@@ -513,6 +526,12 @@ private:
     // Do we output >1 index per AND (index intersection)?
     bool _ixisect;
 
+    // Do we output assignments to indices with no predicate over their leading field?
+    bool _skipScan;
+
+    // Did we output any such assignment?
+    bool _hasSkipScanAssignments = false;
+
     // How many enumerations are we willing to produce from each OR?
     size_t _orLimit;
 
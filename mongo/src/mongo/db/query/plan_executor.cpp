@@ -233,6 +233,9 @@ PlanExecutor::PlanExecutor(OperationContext* opCtx,
       _nss(std::move(nss)),
       // There's no point in yielding if the collection doesn't exist.
       _yieldPolicy(makeYieldPolicy(this, collection ? yieldPolicy : NO_YIELD)) {
+    // The summary statistics, which the slow query log reports, include the time of the root stage.
+    _root->enableTiming();
+
     // We may still need to initialize _nss from either collection or _cq.
     if (!_nss.isEmpty()) {
         return;  // We already have an _nss set, so there's nothing more to do.
@@ -252,6 +255,7 @@ PlanExecutor::PlanExecutor(OperationContext* opCtx,
 //PlanExecutor::makeе  pickBestPlanѡȡŵPlan.˺ܶ಻ͬ͵PlanStage
 Status PlanExecutor::pickBestPlan(const Collection* collection) {
     invariant(_currentState == kUsable);
+    ScopedOpPhaseTimer planTimer(_opCtx, OpDebug::Phase::kPlan);
 
 	//¼prepareExecutionǶӦ
 
@@ -582,6 +586,13 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
         return PlanExecutor::ADVANCED;
     }
 
+    if (_stashedFailure) {
+        if (NULL != objOut) {
+            *objOut = {SnapshotId(), *_stashedFailure};
+        }
+        return PlanExecutor::FAILURE;
+    }
+
     // When a stage requests a yield for document fetch, it gives us back a RecordFetcher*
     // to use to pull the record into memory. We take ownership of the RecordFetcher here,
     // deleting it after we've had a chance to do the fetch. For timing-based yields, we
@@ -711,7 +722,7 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
 
 bool PlanExecutor::isEOF() {
     invariant(_currentState == kUsable);
-    return isMarkedAsKilled() || (_stash.empty() && _root->isEOF());
+    return isMarkedAsKilled() || (_stash.empty() && !_stashedFailure && _root->isEOF());
 }
 
 void PlanExecutor::markAsKilled(string reason) {
@@ -766,6 +777,10 @@ void PlanExecutor::enqueue(const BSONObj& obj) {
     _stash.push(obj.getOwned());
 }
 
+void PlanExecutor::enqueueFailure(const BSONObj& statusObj) {
+    _stashedFailure = statusObj.getOwned();
+}
+
 PlanExecutor::ExecState PlanExecutor::swallowTimeoutIfAwaitData(
     Status yieldError, Snapshotted<BSONObj>* errorObj) const {
     if (yieldError == ErrorCodes::ExceededTimeLimit) {
@@ -426,6 +426,13 @@ public:
      */
     void enqueue(const BSONObj& obj);
 
+    /**
+     * Once the enqueued documents are exhausted, makes getNext() return FAILURE with 'statusObj'
+     * rather than generating further results. Used when results were produced ahead of the
+     * caller, so that an error surfaces after the results which preceded it.
+     */
+    void enqueueFailure(const BSONObj& statusObj);
+
     /**
      * Helper method which returns a set of BSONObj, where each represents a sort order of our
      * output.
@@ -580,6 +587,9 @@ private:
     // stages.
     std::queue<BSONObj> _stash;
 
+    // Set by enqueueFailure(), and returned as a FAILURE once '_stash' is empty.
+    boost::optional<BSONObj> _stashedFailure;
+
     enum { kUsable, kSaved, kDetached, kDisposed } _currentState = kUsable;
 
     // Set if this PlanExecutor is registered with the CursorManager.
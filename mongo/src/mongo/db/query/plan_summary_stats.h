@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <map>
+#include <set>
 #include <string>
 
 namespace mongo {
@@ -57,6 +59,17 @@ struct PlanSummaryStats { //
     // The names of each index used by the plan.
     std::set<std::string> indexesUsed;
 
+    // The work done by the plan in each of the indexes in 'indexesUsed', keyed by index name.
+    struct IndexScanSummary {
+        // The number of keys examined in the index.
+        size_t keysExamined = 0U;
+
+        // The number of times the plan positioned a cursor in the index, i.e. the number of
+        // separate key ranges it scanned.
+        size_t seeks = 0U;
+    };
+    std::map<std::string, IndexScanSummary> indexScans;
+
     // Was this plan a result of using the MultiPlanStage to select a winner among several
     // candidates?
     bool fromMultiPlanner = false;
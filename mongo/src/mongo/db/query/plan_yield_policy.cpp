@@ -113,6 +113,7 @@ Status PlanYieldPolicy::yield(stdx::function<void()> beforeYieldingFn,
     OperationContext* opCtx = _planYielding->getOpCtx();
     invariant(opCtx);
     invariant(!opCtx->lockState()->inAWriteUnitOfWork());
+    ScopedOpPhaseTimer yieldTimer(opCtx, OpDebug::Phase::kYield);
 
     // Can't use writeConflictRetry since we need to call saveState before reseting the transaction.
     for (int attempt = 1; true; attempt++) {
@@ -136,6 +136,42 @@ std::vector<bool> canProvideSortWithMergeSort(const std::vector<QuerySolutionNod
     return shouldReverseScan;
 }
 
+/**
+ * Returns true if 'expr' can be evaluated entirely against the keys of 'index', so that a scan
+ * over the whole index can apply it as an index scan filter without fetching any documents.
+ * Only conjunctions of leaf predicates over fields of a non-multikey btree index qualify.
+ */
+bool canEvaluateOnIndexKeys(const MatchExpression* expr, const IndexEntry& index) {
+    if (index.type != INDEX_BTREE || index.multikey) {
+        return false;
+    }
+
+    if (MatchExpression::AND == expr->matchType()) {
+        for (size_t i = 0; i < expr->numChildren(); ++i) {
+            if (!canEvaluateOnIndexKeys(expr->getChild(i), index)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Geo predicates need a geo index to build bounds, so they can never be checked against the
+    // keys of a btree index.
+    if (MatchExpression::MatchCategory::kLeaf != expr->getCategory() ||
+        !Indexability::nodeCanUseIndexOnOwnField(expr) ||
+        MatchExpression::GEO == expr->matchType() ||
+        MatchExpression::GEO_NEAR == expr->matchType()) {
+        return false;
+    }
+
+    BSONElement keyElt = index.keyPattern.getField(expr->path());
+    if (keyElt.eoo() || !keyElt.isNumber()) {
+        return false;
+    }
+
+    return IndexBoundsBuilder::canUseCoveredMatching(expr, index);
+}
+
 }  // namespace
 
 namespace mongo {
@@ -1317,6 +1353,12 @@ QuerySolutionNode* QueryPlannerAccess::scanWholeIndex(const IndexEntry& index,
     // If it's find({}) remove the no-op root.
     if (MatchExpression::AND == filter->matchType() && (0 == filter->numChildren())) {
         solnRoot = isn.release();
+    } else if ((params.options & QueryPlannerParams::NO_UNCOVERED_PROJECTIONS) &&
+               canEvaluateOnIndexKeys(filter.get(), index)) {
+        // The caller only wants this plan if it is covered, and every predicate can be checked
+        // against the index keys, so filter the keys directly rather than fetching documents.
+        isn->filter = std::move(filter);
+        solnRoot = isn.release();
     } else {
         // TODO: We may not need to do the fetch if the predicates in root are covered.  But
         // for now it's safe (though *maybe* slower).
@@ -674,31 +674,36 @@ QuerySolution* QueryPlannerAnalysis::analyzeDataAccess(
     // If we're answering a query on a sharded system, we need to drop documents that aren't
     // logically part of our shard.
     if (params.options & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
-        if (!solnRoot->fetched()) {
-            // See if we need to fetch information for our shard key.
-            // NOTE: Solution nodes only list ordinary, non-transformed index keys for now
-
-            bool fetch = false;
-            BSONObjIterator it(params.shardKey);
-            while (it.more()) {
-                BSONElement nextEl = it.next();
-                if (!solnRoot->hasField(nextEl.fieldName())) {
-                    fetch = true;
-                    break;
+        // NOTE: Solution nodes only list ordinary, non-transformed index keys for now
+        auto providesShardKey = [&params](const QuerySolutionNode* node) {
+            for (auto&& shardKeyElt : params.shardKey) {
+                if (!node->hasField(shardKeyElt.fieldName())) {
+                    return false;
                 }
             }
-
-            if (fetch) {
+            return true;
+        };
+
+        if (STAGE_FETCH == solnRoot->getType() && !solnRoot->children[0]->fetched() &&
+            providesShardKey(solnRoot->children[0])) {
+            // The index keys below the fetch already contain the shard key, so filter out orphans
+            // there and avoid fetching (and matching) documents this shard does not own.
+            ShardingFilterNode* sfn = new ShardingFilterNode();
+            sfn->children.push_back(solnRoot->children[0]);
+            solnRoot->children[0] = sfn;
+        } else {
+            if (!solnRoot->fetched() && !providesShardKey(solnRoot.get())) {
+                // See if we need to fetch information for our shard key.
                 FetchNode* fetch = new FetchNode();
                 fetch->children.push_back(solnRoot.release());
                 solnRoot.reset(fetch);
             }
-        }
 
-		//rootΪShardingFilterNodeԭsolnRootӵrootchildrenҲShardingFilterNodeΪroot
-        ShardingFilterNode* sfn = new ShardingFilterNode();
-        sfn->children.push_back(solnRoot.release());
-        solnRoot.reset(sfn);
+            //rootΪShardingFilterNodeԭsolnRootӵrootchildrenҲShardingFilterNodeΪroot
+            ShardingFilterNode* sfn = new ShardingFilterNode();
+            sfn->children.push_back(solnRoot.release());
+            solnRoot.reset(sfn);
+        }
     }
 
     bool hasSortStage = false;
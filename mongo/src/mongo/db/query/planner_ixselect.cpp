@@ -68,6 +68,20 @@ bool elemMatchValueCompatible(const BSONElement& elt,
     return true;
 }
 
+/**
+ * Returns true if the negation of 'child' can't match a document in which the field is missing, as
+ * for {$ne: null} and {$nin: [null, ...]}: a missing field compares equal to null.
+ */
+bool negationExcludesNull(const MatchExpression* child) {
+    if (child->matchType() == MatchExpression::EQ) {
+        return static_cast<const EqualityMatchExpression*>(child)->getData().isNull();
+    }
+    if (child->matchType() == MatchExpression::MATCH_IN) {
+        return static_cast<const InMatchExpression*>(child)->hasNull();
+    }
+    return false;
+}
+
 }  // namespace
 
 static double fieldWithDefault(const BSONObj& infoObj, const string& name, double def) {
@@ -197,17 +211,36 @@ db.test.find({"name":"yangyazhou", "age":1, "male":1})
 //ȡQueryPlanner::planִУԭƥһֶ
 void QueryPlannerIXSelect::findRelevantIndices(const unordered_set<string>& fields,
                                                const vector<IndexEntry>& allIndices,
-                                               vector<IndexEntry>* out) {
+                                               vector<IndexEntry>* out,
+                                               bool allowSkipScan) {
     for (size_t i = 0; i < allIndices.size(); ++i) {
         BSONObjIterator it(allIndices[i].keyPattern);
         verify(it.more());
         BSONElement elt = it.next();
         if (fields.end() != fields.find(elt.fieldName())) {
             out->push_back(allIndices[i]);
+            continue;
+        }
+
+        if (!allowSkipScan || !canSkipScan(allIndices[i])) {
+            continue;
+        }
+        while (it.more()) {
+            if (fields.end() != fields.find(it.next().fieldName())) {
+                out->push_back(allIndices[i]);
+                break;
+            }
         }
     }
 }
 
+// static
+bool QueryPlannerIXSelect::canSkipScan(const IndexEntry& index) {
+    // Multikey indexes restrict which predicates may be compounded based on the predicates over
+    // the leading field, so only consider indexes that are not multikey.
+    return INDEX_BTREE == index.type && !index.multikey && index.keyPattern.nFields() > 1;
+}
+
 //QueryPlannerIXSelect::rateIndicesе
 // static
 bool QueryPlannerIXSelect::compatible(const BSONElement& elt,
@@ -276,8 +309,9 @@ bool QueryPlannerIXSelect::compatible(const BSONElement& elt,
             }
 
             // Prevent negated preds from using sparse indices. Doing so would cause us to
-            // miss documents which do not contain the indexed fields.
-            if (index.sparse) {
+            // miss documents which do not contain the indexed fields. Negations which exclude
+            // null, such as {$ne: null}, can't match those documents, so they are allowed.
+            if (index.sparse && !negationExcludesNull(node->getChild(0))) {
                 return false;
             }
 
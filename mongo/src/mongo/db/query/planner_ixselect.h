@@ -56,10 +56,20 @@ public:
     /**
      * Find all indices prefixed by fields we have predicates over.  Only these indices are
      * useful in answering the query.
+     *
+     * If 'allowSkipScan' is true, non-multikey btree indices with a predicate over any of their
+     * fields are also relevant, since they can be skip scanned.
      */
     static void findRelevantIndices(const unordered_set<std::string>& fields,
                                     const std::vector<IndexEntry>& indices,
-                                    std::vector<IndexEntry>* out);
+                                    std::vector<IndexEntry>* out,
+                                    bool allowSkipScan = false);
+
+    /**
+     * Returns true if 'index' may be used without a predicate over its leading field, by skipping
+     * over each distinct leading value.
+     */
+    static bool canSkipScan(const IndexEntry& index);
 
     /**
      * Return true if the index key pattern field 'elt' (which belongs to 'index') can be used
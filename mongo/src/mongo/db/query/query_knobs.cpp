@@ -39,12 +39,26 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationCollFraction, double, 0
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxResults, int, 101);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxMillis, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanSingleFlightEnabled, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanSingleFlightMaxWaitMillis, int, 100);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanCardinalityEstimateMaxKeys, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanCardinalityPruneRatio, double, 10.0);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheSize, int, 5000);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheFeedbacksStored, int, 20);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheEvictionRatio, double, 10.0);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryShapeStatsSize, int, 1000);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryParsedFilterCacheSize, int, 0);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerMaxIndexedSolutions, int, 64);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryEnumerationMaxOrSolutions, int, 10);
@@ -67,8 +81,26 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecFetchBatchSize, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecCollectionScanBatchSize, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecEnableTopLevelComparisonMatcher, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQuerySharedOplogBufferMaxBytes, int, 16 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQuerySharedOplogBufferBatchSize, int, 128);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCursorPrefetchMaxBytes, int, 0);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryFacetBufferSizeBytes, int, 100 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryFacetMaxParallelism, int, 1);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryFacetMaxOutputDocSizeBytes,
+                              long long,
+                              100 * 1024 * 1024);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalInsertMaxBatchSize,
                               int,
                               internalQueryExecYieldIterations.load() / 2); //(128 / 2)
@@ -77,9 +109,41 @@ MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceCursorBatchSizeBytes, int, 4
 
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupCacheSizeBytes, int, 100 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupHashJoinMaxBytes, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupProbeBatchSize, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGraphLookupFrontierBatchSize, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupHashSpillPartitions, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupParallelism, int, 1);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupMongosParallelism, int, 1);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceSortMongosParallelism, int, 1);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceSortTopKPushdownMaxLimit, int, 1000);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupChangePostImageCacheTTLMillis, int, 1000);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupChangePostImageCacheSizeBytes,
+                              int,
+                              16 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceSampleBlockSize, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceSampleBlockMaxSampleRatio, double, 0.25);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerGenerateCoveredWholeIndexScans, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableIndexSkipScan, bool, false);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryIgnoreUnknownJSONSchemaKeywords, bool, false);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryProhibitBlockingMergeOnMongoS, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryAllowColocatedShardedLookup, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecAlwaysTimeStages, bool, false);
 }  // namespace mongo
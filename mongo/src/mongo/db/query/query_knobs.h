@@ -49,6 +49,27 @@ extern AtomicDouble internalQueryPlanEvaluationCollFraction;
 //Ĭ101
 extern AtomicInt32 internalQueryPlanEvaluationMaxResults;
 
+// Stop working plans once the trial period has run for this many milliseconds. Zero disables the
+// time-based cutoff, leaving only the works and results limits above.
+extern AtomicInt32 internalQueryPlanEvaluationMaxMillis;
+
+// Let only one multi-planner at a time run the trial period for a given shape on a collection.
+// Concurrent queries of that shape wait for its cached winner instead of repeating the trial.
+extern AtomicBool internalQueryPlanSingleFlightEnabled;
+
+// Upper bound on how long a query waits for a concurrent trial of its shape before planning on
+// its own. The waiter holds its collection lock, so this must stay small.
+extern AtomicInt32 internalQueryPlanSingleFlightMaxWaitMillis;
+
+// Before the trial period, count up to this many keys within the bounds of each candidate's index
+// scans and use the counts to drop candidates that would examine far more keys than the best one.
+// Zero disables the estimate.
+extern AtomicInt32 internalQueryPlanCardinalityEstimateMaxKeys;
+
+// A candidate is dropped before the trial period when its estimated number of keys examined
+// exceeds this multiple of the smallest complete estimate among the candidates.
+extern AtomicDouble internalQueryPlanCardinalityPruneRatio;
+
 // Do we give a big ranking bonus to intersection plans?
 extern AtomicBool internalQueryForceIntersectionPlans;
 
@@ -73,6 +94,18 @@ extern AtomicInt32 internalQueryCacheFeedbacksStored;
 // and replanning?
 extern AtomicDouble internalQueryCacheEvictionRatio;
 
+//
+// query shape statistics
+//
+
+// How many query shapes per collection do we track execution statistics for? Zero disables the
+// tracking.
+extern AtomicInt32 internalQueryShapeStatsSize;
+
+// Maximum number of filter shapes whose normalized match expression tree is kept for reuse by
+// later queries of the same shape. Zero disables the parsed filter cache.
+extern AtomicInt32 internalQueryParsedFilterCacheSize;
+
 //
 // Planning and enumeration.
 //
@@ -97,6 +130,10 @@ extern AtomicInt32 internalQueryMaxScansToExplode;
 // Allow the planner to generate covered whole index scans, rather than falling back to a COLLSCAN.
 extern AtomicBool internalQueryPlannerGenerateCoveredWholeIndexScans;
 
+// Allow the planner to use a compound index whose leading fields are unconstrained, skipping over
+// each distinct value of the leading fields ("skip scan").
+extern AtomicBool internalQueryPlannerEnableIndexSkipScan;
+
 // Ignore unknown JSON Schema keywords.
 extern AtomicBool internalQueryIgnoreUnknownJSONSchemaKeywords;
 
@@ -113,11 +150,43 @@ extern AtomicInt32 internalQueryExecYieldIterations;
 // Yield if it's been at least this many milliseconds since we last yielded.
 extern AtomicInt32 internalQueryExecYieldPeriodMS;
 
+// Number of RecordIds a FetchStage buffers from its child and looks up in RecordId order, rather
+// than one at a time in index order. Values below 2 disable batched fetching.
+extern AtomicInt32 internalQueryExecFetchBatchSize;
+
+// Number of records a filtered CollectionScan may test against its filter within a single call to
+// work(), skipping the working set for records which do not match. Values below 2 disable it.
+extern AtomicInt32 internalQueryExecCollectionScanBatchSize;
+
+// Whether a CollectionScan whose filter only compares top-level fields evaluates it with a
+// TopLevelComparisonMatcher rather than the general MatchExpression.
+extern AtomicBool internalQueryExecEnableTopLevelComparisonMatcher;
+
+// Maximum size in bytes of the window of recent oplog entries shared by the oplog scans of all
+// change streams on a node. Zero makes every change stream read the oplog on its own.
+extern AtomicInt32 internalQuerySharedOplogBufferMaxBytes;
+
+// Number of oplog entries a change stream's oplog scan reads into, or takes from, the shared
+// window at once.
+extern AtomicInt32 internalQuerySharedOplogBufferBatchSize;
+
+// Total size in bytes of the find cursor batches which may be produced in the background after a
+// getMore and held until the next getMore claims them. Zero disables cursor prefetching.
+extern AtomicInt32 internalQueryCursorPrefetchMaxBytes;
+
 // Limit the size that we write without yielding to 16MB / 64 (max expected number of indexes)
 const int64_t insertVectorMaxBytes = 256 * 1024;
 
 // The number of bytes to buffer at once during a $facet stage.
 extern AtomicInt32 internalQueryFacetBufferSizeBytes;
+
+// The maximum number of threads a $facet stage may use to run its sub-pipelines, including the
+// thread running the aggregation. One runs every sub-pipeline on the calling thread.
+extern AtomicInt32 internalQueryFacetMaxParallelism;
+
+// The maximum total size in bytes of the results, across all sub-pipelines, that a $facet stage
+// may accumulate into its output document.
+extern AtomicInt64 internalQueryFacetMaxOutputDocSizeBytes;
 //AtomicInt32ͱͨinternalInsertMaxBatchSize.load()
 extern AtomicInt32 internalInsertMaxBatchSize;
 
@@ -125,5 +194,65 @@ extern AtomicInt32 internalDocumentSourceCursorBatchSizeBytes;
 
 extern AtomicInt32 internalDocumentSourceLookupCacheSizeBytes;
 
+// A localField/foreignField $lookup loads the foreign collection into an in-memory hash table when
+// the collection's data size is at most this many bytes. Zero always queries per input document.
+extern AtomicInt32 internalDocumentSourceLookupHashJoinMaxBytes;
+
+// When the foreign collection of a localField/foreignField $lookup has an index on foreignField,
+// input documents are joined in batches of this size with a single $in query per batch. Zero or
+// one queries once per input document.
+extern AtomicInt32 internalDocumentSourceLookupProbeBatchSize;
+
+// The most frontier values a $graphLookup looks up in the 'from' collection with a single query.
+// Larger frontiers are split into several queries. Zero queries the whole frontier at once.
+extern AtomicInt32 internalDocumentSourceGraphLookupFrontierBatchSize;
+
+// The number of hash partitions a $group spills into when it exceeds its memory limit. Each
+// partition is then aggregated in memory on its own. Zero keeps the sort-and-merge spill.
+extern AtomicInt32 internalDocumentSourceGroupHashSpillPartitions;
+
+// The number of threads an unsorted $group on mongod uses to build its groups. Documents are routed
+// to a thread by the hash of their group key, so each group is accumulated in input order. One
+// disables parallel aggregation.
+extern AtomicInt32 internalDocumentSourceGroupParallelism;
+
+// The number of threads a $group merging shard results on mongos uses. Documents are routed to a
+// thread by the hash of their group key, so every thread returns its groups without a final merge.
+// One disables parallel merging.
+extern AtomicInt32 internalDocumentSourceGroupMongosParallelism;
+
+// The number of threads a blocking $sort on mongos uses to sort its input, whose sorted runs are
+// then merged. One disables parallel sorting.
+extern AtomicInt32 internalDocumentSourceSortMongosParallelism;
+
+// The largest $limit coalesced into a $sort for which the query system runs the top-k sort itself
+// when no index provides the order. Zero leaves such sorts to DocumentSourceSort.
+extern AtomicInt32 internalDocumentSourceSortTopKPushdownMaxLimit;
+
+// How long a post-image looked up for a change stream with {fullDocument: "updateLookup"} is kept
+// for other change streams reporting the same event. Zero disables sharing of post-image lookups.
+extern AtomicInt32 internalDocumentSourceLookupChangePostImageCacheTTLMillis;
+
+// The total size of the post-images shared between change streams, beyond which the oldest are
+// evicted before they expire.
+extern AtomicInt32 internalDocumentSourceLookupChangePostImageCacheSizeBytes;
+
+// When positive, a $sample which asks for too large a fraction of a collection to pick documents
+// one at a time from a random cursor instead reads runs of this many neighbouring documents from
+// random starting points, up to 'internalDocumentSourceSampleBlockMaxSampleRatio' of the
+// collection. Should stay well below 100, the number of consecutive duplicates $sample tolerates.
+extern AtomicInt32 internalDocumentSourceSampleBlockSize;
+
+extern AtomicDouble internalDocumentSourceSampleBlockMaxSampleRatio;
+
 extern AtomicBool internalQueryProhibitBlockingMergeOnMongoS;
+
+// Allows a localField/foreignField $lookup from a sharded collection into a sharded 'from'
+// collection when both are sharded on the joined fields and their chunks are co-located. Each shard
+// then joins its own documents against its own chunks of 'from'.
+extern AtomicBool internalQueryAllowColocatedShardedLookup;
+
+// Makes every plan stage time its work, rather than only the root of each plan unless the query is
+// explained or profiled.
+extern AtomicBool internalQueryExecAlwaysTimeStages;
 }  // namespace mongo
@@ -780,7 +780,11 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
 	2021-01-12T17:57:31.001+0800 D QUERY    [conn1] Relevant index 4 is kp: { name: 1.0, male: 1.0 } name: 'name_1_male_1' io: { v: 2, key: { name: 1.0, male: 1.0 }, name: "name_1_male_1", ns: "test.test", background: true }
 	*/
 		//ȡ洢relevantIndices  Ѻfieldsƥҳ,ĺѡ
-        QueryPlannerIXSelect::findRelevantIndices(fields, params.indices, &relevantIndices);
+        QueryPlannerIXSelect::findRelevantIndices(
+            fields,
+            params.indices,
+            &relevantIndices,
+            params.options & QueryPlannerParams::INDEX_SKIP_SCAN);
     } else {
         // Sigh.  If the hint is specified it might be using the index name.
         BSONElement firstHintElt = hintIndex.firstElement();
@@ -1015,18 +1019,23 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
         LOG(2) << "Rated tree after text processing:" << redact(query.root()->toString());
     }
 
+    // Set if any indexed plan may skip scan an index.
+    bool enumeratedSkipScans = false;
+
     // If we have any relevant indices, we try to create indexed plans.
     //QuerySolutionӵout
     if (0 < relevantIndices.size()) {
         // The enumerator spits out trees tagged with IndexTag(s).
         PlanEnumeratorParams enumParams;
         enumParams.intersect = params.options & QueryPlannerParams::INDEX_INTERSECTION;
+        enumParams.skipScan = params.options & QueryPlannerParams::INDEX_SKIP_SCAN;
         enumParams.root = query.root();
         enumParams.indices = &relevantIndices;
 
 		//PlanEnumerator MatchExpressionĸֿܵϣ indexScan & collectionScanȣ ɾMatchExpression
         PlanEnumerator isp(enumParams);
         isp.init().transitional_ignore();
+        enumeratedSkipScans = isp.hasSkipScanAssignments();
 	
         unique_ptr<MatchExpression> rawTree;
 		//CanonicalQueryҪrelevantIndicesQuerySolution
@@ -1236,7 +1245,7 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
     //projectionˣout solutionΪ0ĬѡifжϵbuildWholeIXSoln
     const auto projection = query.getProj();
     if (params.options & QueryPlannerParams::GENERATE_COVERED_IXSCANS && out->size() == 0 &&
-        query.getQueryObj().isEmpty() && projection && !projection->requiresDocument()) {
+        projection && !projection->requiresDocument()) {
 
         const auto* indicesToConsider = hintIndex.isEmpty() ? &params.indices : &relevantIndices;
         for (auto&& index : *indicesToConsider) {
@@ -1274,7 +1283,10 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
         !QueryPlannerCommon::hasNode(query.root(), MatchExpression::TEXT) && hintIndex.isEmpty();
 
     // The caller can explicitly ask for a collscan.
-    bool collscanRequested = (params.options & QueryPlannerParams::INCLUDE_COLLSCAN);
+    // A skip scan only beats a collection scan when the skipped fields have few distinct values,
+    // so a collection scan competes with it.
+    bool collscanRequested = (params.options & QueryPlannerParams::INCLUDE_COLLSCAN) ||
+        (enumeratedSkipScans && canTableScan);
 
     // No indexed plans?  We must provide a collscan if possible or else we can't run the query.
     //ûкʵȫɨ
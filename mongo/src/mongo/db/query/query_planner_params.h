@@ -111,6 +111,10 @@ struct QueryPlannerParams {
 
         // Set this to track the most recent timestamp seen by this cursor while scanning the oplog.
         TRACK_LATEST_OPLOG_TS = 1 << 12,
+
+        // Set this to consider compound btree indexes whose leading fields have no predicates,
+        // answering predicates on later fields by skipping over the leading fields' values.
+        INDEX_SKIP_SCAN = 1 << 13,
     };
 
     // See Options enum above.
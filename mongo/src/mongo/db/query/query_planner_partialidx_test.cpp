@@ -52,6 +52,46 @@ TEST_F(QueryPlannerTest, PartialIndexEq) {
     assertNumSolutions(0U);
 }
 
+TEST_F(QueryPlannerTest, PartialIndexType) {
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+    BSONObj filterObj(fromjson("{a: {$type: 'number'}}"));
+    std::unique_ptr<MatchExpression> filterExpr = parseMatchExpression(filterObj);
+    addIndex(fromjson("{a: 1}"), filterExpr.get());
+
+    runQuery(fromjson("{a: 1}"));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: "
+        "{filter: null, pattern: {a: 1}, "
+        "bounds: {a: [[1, 1, true, true]]}}}}}");
+
+    runQuery(fromjson("{a: {$in: [1, 2]}}"));
+    assertNumSolutions(1U);
+
+    runQuery(fromjson("{a: 'foo'}"));
+    assertNumSolutions(0U);
+
+    runQuery(fromjson("{a: null}"));
+    assertNumSolutions(0U);
+}
+
+TEST_F(QueryPlannerTest, PartialIndexExistsParentPath) {
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+    BSONObj filterObj(fromjson("{a: {$exists: true}}"));
+    std::unique_ptr<MatchExpression> filterExpr = parseMatchExpression(filterObj);
+    addIndex(fromjson("{'a.b': 1}"), filterExpr.get());
+
+    runQuery(fromjson("{'a.b': 1}"));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: "
+        "{filter: null, pattern: {'a.b': 1}, "
+        "bounds: {'a.b': [[1, 1, true, true]]}}}}}");
+
+    runQuery(fromjson("{'a.b': null}"));
+    assertNumSolutions(0U);
+}
+
 TEST_F(QueryPlannerTest, PartialIndexNot) {
     params.options = QueryPlannerParams::NO_TABLE_SCAN;
     BSONObj filterObj(fromjson("{a: {$gt: 0}}"));
@@ -2819,6 +2819,31 @@ TEST_F(QueryPlannerTest, NegationCantUseSparseIndex) {
     assertSolutionExists("{cscan: {dir: 1}}");
 }
 
+TEST_F(QueryPlannerTest, NegationOfNullCanUseSparseIndex) {
+    // false means not multikey, true means sparse
+    addIndex(BSON("i" << 1), false, true);
+    runQuery(fromjson("{i: {$ne: null}}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists("{fetch: {node: {ixscan: {pattern: {i: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, NinWithNullCanUseSparseIndex) {
+    // false means not multikey, true means sparse
+    addIndex(BSON("i" << 1), false, true);
+    runQuery(fromjson("{i: {$nin: [null, 4]}}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists("{fetch: {node: {ixscan: {pattern: {i: 1}}}}}");
+
+    runQuery(fromjson("{i: {$nin: [3, 4]}}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
 TEST_F(QueryPlannerTest, NegationCantUseSparseIndex2) {
     // false means not multikey, true means sparse
     addIndex(BSON("i" << 1 << "j" << 1), false, true);
@@ -3957,6 +3982,34 @@ TEST_F(QueryPlannerTest, ShardFilterNoIndexNotCovered) {
         "{ixscan: {pattern: {b: 1}}}}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, ShardFilterBeforeFetchWhenIndexProvidesShardKey) {
+    params.options = QueryPlannerParams::INCLUDE_SHARD_FILTER;
+    params.shardKey = BSON("a" << 1);
+    addIndex(BSON("a" << 1));
+
+    runQuery(fromjson("{a: {$gt: 1}, b: 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: {b: 1}, node: "
+        "{sharding_filter: {node: "
+        "{ixscan: {pattern: {a: 1}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, ShardFilterAfterFetchWhenIndexDoesNotProvideShardKey) {
+    params.options = QueryPlannerParams::INCLUDE_SHARD_FILTER;
+    params.shardKey = BSON("a" << 1 << "c" << 1);
+    addIndex(BSON("a" << 1));
+
+    runQuery(fromjson("{a: {$gt: 1}, b: 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{sharding_filter: {node: "
+        "{fetch: {filter: {b: 1}, node: "
+        "{ixscan: {pattern: {a: 1}}}}}}}");
+}
+
 TEST_F(QueryPlannerTest, CannotTrimIxisectParam) {
     params.options = QueryPlannerParams::CANNOT_TRIM_IXISECT;
     params.options |= QueryPlannerParams::INDEX_INTERSECTION;
@@ -5334,6 +5387,40 @@ TEST_F(QueryPlannerTest, EmptyQueryWithProjectionDoesNotUseCoveredIxscanOnCompou
         "{cscan: {dir: 1}}}}");
 }
 
+TEST_F(QueryPlannerTest, QueryWithCoveredPredicateAndProjectionUsesFilteredWholeIxscan) {
+    params.options = QueryPlannerParams::GENERATE_COVERED_IXSCANS;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQueryAsCommand(
+        fromjson("{find: 'testns', filter: {b: {$gt: 5}}, projection: {_id: 0, a: 1, b: 1}}"));
+    assertNumSolutions(1);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1, b: 1}, node: "
+        "{ixscan: {filter: {b: {$gt: 5}}, pattern: {a: 1, b: 1}, bounds:"
+        "{a: [['MinKey', 'MaxKey', true, true]], b: [['MinKey', 'MaxKey', true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, QueryWithUncoveredPredicateAndProjectionUsesCollscan) {
+    params.options = QueryPlannerParams::GENERATE_COVERED_IXSCANS;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQueryAsCommand(
+        fromjson("{find: 'testns', filter: {b: 5, c: 6}, projection: {_id: 0, a: 1, b: 1}}"));
+    assertNumSolutions(1);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1, b: 1}, node: "
+        "{cscan: {dir: 1, filter: {b: 5, c: 6}}}}}");
+}
+
+TEST_F(QueryPlannerTest, QueryWithPredicateAndProjectionUsesCollscanIfIndexIsMultikey) {
+    params.options = QueryPlannerParams::GENERATE_COVERED_IXSCANS;
+    constexpr bool isMultikey = true;
+    addIndex(BSON("a" << 1 << "b" << 1), isMultikey);
+    runQueryAsCommand(fromjson("{find: 'testns', filter: {b: 5}, projection: {_id: 0, a: 1}}"));
+    assertNumSolutions(1);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1}, node: "
+        "{cscan: {dir: 1, filter: {b: 5}}}}}");
+}
+
 TEST_F(QueryPlannerTest, EmptyQueryWithProjectionDoesNotConsiderNonHintedIndices) {
     params.options = QueryPlannerParams::GENERATE_COVERED_IXSCANS;
     addIndex(BSON("a" << 1));
@@ -5445,4 +5532,63 @@ TEST_F(QueryPlannerTest, EmptyQueryWithProjectionUsesCollscanIfIndexCollationDif
         "{proj: {spec: {_id: 0, a: 1}, node: "
         "{cscan: {dir: 1}}}}");
 }
+
+//
+// Skip scans
+//
+
+TEST_F(QueryPlannerTest, SkipScanUsesCompoundIndexWithoutLeadingPredicate) {
+    params.options = QueryPlannerParams::INDEX_SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{b: 5}"));
+
+    // The collection scan competes with the skip scan.
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, pattern: {a: 1, b: 1}, bounds: "
+        "{a: [['MinKey','MaxKey',true,true]], b: [[5,5,true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanSkipsSeveralLeadingFields) {
+    params.options = QueryPlannerParams::INDEX_SKIP_SCAN | QueryPlannerParams::NO_TABLE_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1 << "c" << 1));
+    runQuery(fromjson("{c: {$gt: 3}, d: 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: {d: 1}, node: {ixscan: {filter: null, pattern: {a: 1, b: 1, c: 1}, "
+        "bounds: {a: [['MinKey','MaxKey',true,true]], b: [['MinKey','MaxKey',true,true]], "
+        "c: [[3,Infinity,false,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedWhenDisabled) {
+    params.options = QueryPlannerParams::DEFAULT;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedForMultikeyIndex) {
+    params.options = QueryPlannerParams::INDEX_SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1), true);
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedWhenLeadingFieldHasPredicate) {
+    params.options = QueryPlannerParams::INDEX_SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{a: 1, b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, pattern: {a: 1, b: 1}, bounds: "
+        "{a: [[1,1,true,true]], b: [[5,5,true,true]]}}}}}");
+}
+
 }  // namespace
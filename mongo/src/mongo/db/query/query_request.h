@@ -234,6 +234,7 @@ db.runCommand(
       "noCursorTimeout": <bool>,
       "awaitData": <bool>,
       "allowPartialResults": <bool>,
+      "allowDiskUse": <bool>,
       "collation": <document>
    }
 )
@@ -591,6 +592,31 @@ public:
         _allowPartialResults = allowPartialResults;
     }
 
+    /**
+     * Whether a blocking sort that needs more memory than internalQueryExecMaxBlockingSortBytes
+     * may spill to temporary files instead of failing.
+     */
+    bool allowDiskUse() const {
+        return _allowDiskUse;
+    }
+
+    void setAllowDiskUse(bool allowDiskUse) {
+        _allowDiskUse = allowDiskUse;
+    }
+
+    /**
+     * The memory limit of a blocking sort in place of internalQueryExecMaxBlockingSortBytes, or 0
+     * for that knob's limit. This is only set internally, when an aggregation pushes its $sort
+     * down, and is not part of the find command.
+     */
+    size_t getMaxBlockingSortBytes() const {
+        return _maxBlockingSortBytes;
+    }
+
+    void setMaxBlockingSortBytes(size_t maxBlockingSortBytes) {
+        _maxBlockingSortBytes = maxBlockingSortBytes;
+    }
+
     boost::optional<long long> getReplicationTerm() const {
         return _replicationTerm;
     }
@@ -719,6 +745,8 @@ private:
     //οhttps://www.cnblogs.com/silentcross/archive/2011/07/04/2095424.html  ѯsnapshot
     bool _snapshot = false;
     bool _hasReadPref = false;
+    bool _allowDiskUse = false;
+    size_t _maxBlockingSortBytes = 0;
 
     // Options that can be specified in the OP_QUERY 'flags' header.
     TailableMode _tailableMode = TailableMode::kNormal;
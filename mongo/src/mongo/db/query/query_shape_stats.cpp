@@ -0,0 +1,288 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_shape_stats.h"
+
+#include <algorithm>
+#include <set>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/query/query_planner_common.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Returns true if an index with key pattern 'existing' can serve every query that an index with
+ * key pattern 'suggested' would, i.e. if 'suggested' names a prefix of the fields of 'existing'
+ * with directions that are either all the same or all reversed.
+ */
+bool isServedBy(const BSONObj& suggested, const BSONObj& existing) {
+    BSONObjIterator existingIt(existing);
+    boost::optional<bool> sameDirection;
+    for (auto&& suggestedElem : suggested) {
+        if (!existingIt.more()) {
+            return false;
+        }
+        BSONElement existingElem = existingIt.next();
+        if (!existingElem.isNumber() ||
+            existingElem.fieldNameStringData() != suggestedElem.fieldNameStringData()) {
+            return false;
+        }
+
+        const bool same = (existingElem.number() < 0) == (suggestedElem.number() < 0);
+        if (sameDirection && *sameDirection != same) {
+            return false;
+        }
+        sameDirection = same;
+    }
+    return true;
+}
+
+long long wastedDocsExamined(long long docsExamined, long long returned) {
+    return std::max(docsExamined - returned, 0LL);
+}
+
+}  // namespace
+
+void QueryShapeStatsEntry::appendToBSON(BSONObjBuilder* bob) const {
+    bob->append("query", query);
+    bob->append("sort", sort);
+    bob->append("projection", projection);
+    if (!collation.isEmpty()) {
+        bob->append("collation", collation);
+    }
+    if (!suggestedIndex.isEmpty()) {
+        bob->append("suggestedIndex", suggestedIndex);
+    }
+    bob->appendNumber("execCount", execCount);
+    bob->appendNumber("totalKeysExamined", totalKeysExamined);
+    bob->appendNumber("totalDocsExamined", totalDocsExamined);
+    bob->appendNumber("totalReturned", totalReturned);
+    bob->appendNumber("totalExecutionTimeMillis", totalExecutionTimeMillis);
+    bob->appendNumber("collectionScans", collectionScans);
+    bob->appendDate("firstSeen", firstSeen);
+    bob->appendDate("lastSeen", lastSeen);
+}
+
+QueryShapeStats::QueryShapeStats() {
+    const size_t maxSize = std::max(internalQueryShapeStatsSize.load(), 0);
+    const size_t maxSizePerShard = std::max<size_t>(1, (maxSize + kNumShards - 1) / kNumShards);
+    for (size_t i = 0; i < kNumShards; ++i) {
+        _shards.push_back(stdx::make_unique<Shard>(maxSizePerShard));
+    }
+    _disabled = (maxSize == 0);
+}
+
+QueryShapeStats::Shard& QueryShapeStats::_getShard(const PlanCacheKey& key) const {
+    return *_shards[std::hash<PlanCacheKey>()(key) % kNumShards];
+}
+
+void QueryShapeStats::record(const PlanCacheKey& key,
+                             const CanonicalQuery& cq,
+                             const PlanSummaryStats& stats,
+                             Date_t now) {
+    if (_disabled) {
+        return;
+    }
+
+    Shard& shard = _getShard(key);
+    stdx::lock_guard<stdx::mutex> lock(shard.mutex);
+
+    QueryShapeStatsEntry* entry;
+    if (!shard.entries.get(key, &entry).isOK()) {
+        const QueryRequest& qr = cq.getQueryRequest();
+        auto newEntry = stdx::make_unique<QueryShapeStatsEntry>();
+        newEntry->query = qr.getFilter().getOwned();
+        newEntry->sort = qr.getSort().getOwned();
+        newEntry->projection = qr.getProj().getOwned();
+        if (cq.getCollator()) {
+            newEntry->collation = cq.getCollator()->getSpec().toBSON();
+        }
+        newEntry->suggestedIndex = suggestIndex(cq);
+        newEntry->firstSeen = now;
+
+        entry = newEntry.get();
+        shard.entries.add(key, newEntry.release());
+    }
+
+    ++entry->execCount;
+    entry->totalKeysExamined += stats.totalKeysExamined;
+    entry->totalDocsExamined += stats.totalDocsExamined;
+    entry->totalReturned += stats.nReturned;
+    entry->totalExecutionTimeMillis += stats.executionTimeMillis;
+    if (stats.indexesUsed.empty()) {
+        ++entry->collectionScans;
+    }
+    entry->lastSeen = now;
+}
+
+std::vector<QueryShapeStatsEntry> QueryShapeStats::getAllEntries() const {
+    std::vector<QueryShapeStatsEntry> entries;
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lock(shard->mutex);
+        for (auto it = shard->entries.begin(); it != shard->entries.end(); ++it) {
+            entries.push_back(*it->second);
+        }
+    }
+    return entries;
+}
+
+std::vector<IndexRecommendation> QueryShapeStats::recommendIndexes(
+    const std::vector<BSONObj>& existingKeyPatterns) const {
+    auto byKeyPattern =
+        SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<IndexRecommendation>();
+
+    for (auto&& entry : getAllEntries()) {
+        if (entry.suggestedIndex.isEmpty() ||
+            wastedDocsExamined(entry.totalDocsExamined, entry.totalReturned) == 0) {
+            continue;
+        }
+
+        const bool alreadyIndexed = std::any_of(
+            existingKeyPatterns.begin(), existingKeyPatterns.end(), [&](const BSONObj& existing) {
+                return isServedBy(entry.suggestedIndex, existing);
+            });
+        if (alreadyIndexed) {
+            continue;
+        }
+
+        IndexRecommendation& recommendation = byKeyPattern[entry.suggestedIndex];
+        recommendation.keyPattern = entry.suggestedIndex;
+        recommendation.execCount += entry.execCount;
+        recommendation.totalDocsExamined += entry.totalDocsExamined;
+        recommendation.totalReturned += entry.totalReturned;
+        recommendation.shapes.push_back(std::move(entry));
+    }
+
+    std::vector<IndexRecommendation> recommendations;
+    for (auto&& keyPatternAndRecommendation : byKeyPattern) {
+        IndexRecommendation& recommendation = keyPatternAndRecommendation.second;
+        std::sort(recommendation.shapes.begin(),
+                  recommendation.shapes.end(),
+                  [](const QueryShapeStatsEntry& lhs, const QueryShapeStatsEntry& rhs) {
+                      return lhs.totalDocsExamined > rhs.totalDocsExamined;
+                  });
+        recommendations.push_back(std::move(recommendation));
+    }
+
+    std::sort(recommendations.begin(),
+              recommendations.end(),
+              [](const IndexRecommendation& lhs, const IndexRecommendation& rhs) {
+                  return wastedDocsExamined(lhs.totalDocsExamined, lhs.totalReturned) >
+                      wastedDocsExamined(rhs.totalDocsExamined, rhs.totalReturned);
+              });
+    return recommendations;
+}
+
+void QueryShapeStats::clear() {
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lock(shard->mutex);
+        shard->entries.clear();
+    }
+}
+
+size_t QueryShapeStats::size() const {
+    size_t size = 0;
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lock(shard->mutex);
+        size += shard->entries.size();
+    }
+    return size;
+}
+
+// static
+BSONObj QueryShapeStats::suggestIndex(const CanonicalQuery& cq) {
+    const MatchExpression* root = cq.root();
+    if (QueryPlannerCommon::hasNode(root, MatchExpression::TEXT) ||
+        QueryPlannerCommon::hasNode(root, MatchExpression::GEO) ||
+        QueryPlannerCommon::hasNode(root, MatchExpression::GEO_NEAR)) {
+        return BSONObj();
+    }
+
+    // Only top-level predicates are considered: those under $or or $not would need an index of
+    // their own, and those under $elemMatch one on the array's subfields.
+    std::vector<const MatchExpression*> predicates;
+    if (root->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            predicates.push_back(root->getChild(i));
+        }
+    } else {
+        predicates.push_back(root);
+    }
+
+    std::vector<StringData> equalityPaths;
+    std::vector<StringData> rangePaths;
+    for (const MatchExpression* predicate : predicates) {
+        switch (predicate->matchType()) {
+            case MatchExpression::EQ:
+            case MatchExpression::MATCH_IN:
+                equalityPaths.push_back(predicate->path());
+                break;
+            case MatchExpression::LT:
+            case MatchExpression::LTE:
+            case MatchExpression::GT:
+            case MatchExpression::GTE:
+                rangePaths.push_back(predicate->path());
+                break;
+            default:
+                break;
+        }
+    }
+
+    BSONObjBuilder keyPattern;
+    std::set<StringData> addedPaths;
+    auto addField = [&](StringData path, int direction) {
+        if (addedPaths.insert(path).second) {
+            keyPattern.append(path, direction);
+        }
+    };
+
+    for (StringData path : equalityPaths) {
+        addField(path, 1);
+    }
+    for (auto&& sortElem : cq.getQueryRequest().getSort()) {
+        if (!sortElem.isNumber() || sortElem.fieldNameStringData() == "$natural") {
+            break;
+        }
+        addField(sortElem.fieldNameStringData(), sortElem.number() < 0 ? -1 : 1);
+    }
+    for (StringData path : rangePaths) {
+        addField(path, 1);
+    }
+    return keyPattern.obj();
+}
+
+}  // namespace mongo
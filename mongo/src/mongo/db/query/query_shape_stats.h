@@ -0,0 +1,167 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class CanonicalQuery;
+
+/**
+ * Execution statistics aggregated over every run of a single query shape.
+ */
+struct QueryShapeStatsEntry {
+    // A representative instance of the shape, in the form reported by planCacheListQueryShapes.
+    BSONObj query;
+    BSONObj sort;
+    BSONObj projection;
+    BSONObj collation;
+
+    // The index suggested by the shape's predicates and sort, or an empty object if there is
+    // none. See QueryShapeStats::suggestIndex().
+    BSONObj suggestedIndex;
+
+    long long execCount = 0;
+    long long totalKeysExamined = 0;
+    long long totalDocsExamined = 0;
+    long long totalReturned = 0;
+    long long totalExecutionTimeMillis = 0;
+
+    // The number of executions whose winning plan used no index.
+    long long collectionScans = 0;
+
+    Date_t firstSeen;
+    Date_t lastSeen;
+
+    void appendToBSON(BSONObjBuilder* bob) const;
+};
+
+/**
+ * An index that would let some of the recorded query shapes examine fewer documents.
+ */
+struct IndexRecommendation {
+    BSONObj keyPattern;
+
+    // Totals over the shapes that the index would serve.
+    long long execCount = 0;
+    long long totalDocsExamined = 0;
+    long long totalReturned = 0;
+
+    // The shapes that the index would serve, most documents examined first.
+    std::vector<QueryShapeStatsEntry> shapes;
+};
+
+/**
+ * Collects execution statistics per query shape for one collection, so that the workload can be
+ * analyzed for missing indexes without trawling the slow query log. Shapes are keyed by their
+ * plan cache key and the number tracked is bounded by internalQueryShapeStatsSize, evicting the
+ * least recently run shape first.
+ *
+ * Owned by the collection's CollectionInfoCache. Thread safe.
+ */
+class QueryShapeStats {
+    MONGO_DISALLOW_COPYING(QueryShapeStats);
+
+public:
+    QueryShapeStats();
+
+    /**
+     * Records one execution of 'cq', whose plan cache key is 'key', summarized by 'stats'.
+     */
+    void record(const PlanCacheKey& key,
+                const CanonicalQuery& cq,
+                const PlanSummaryStats& stats,
+                Date_t now);
+
+    /**
+     * Returns a copy of every tracked shape's statistics.
+     */
+    std::vector<QueryShapeStatsEntry> getAllEntries() const;
+
+    /**
+     * Proposes indexes for the tracked shapes that examined more documents than they returned,
+     * skipping those whose suggested index is already a prefix of one of 'existingKeyPatterns'.
+     * Recommendations serving the most wasted document examinations come first.
+     */
+    std::vector<IndexRecommendation> recommendIndexes(
+        const std::vector<BSONObj>& existingKeyPatterns) const;
+
+    /**
+     * Forgets every tracked shape.
+     */
+    void clear();
+
+    /**
+     * Returns the number of tracked shapes.
+     */
+    size_t size() const;
+
+    /**
+     * Returns the key pattern of a btree index suited to 'cq', or an empty object if there is
+     * none. Following the usual equality, sort, range ordering, the pattern leads with the fields
+     * of top-level equality and $in predicates, continues with the sort fields and ends with the
+     * fields of top-level range predicates. Queries needing a text or geo index get no suggestion.
+     */
+    static BSONObj suggestIndex(const CanonicalQuery& cq);
+
+private:
+    /**
+     * Like the plan cache, the statistics are split into independently locked shards, selected
+     * by a hash of the plan cache key, so that concurrent queries do not serialize on one mutex.
+     */
+    struct Shard {
+        explicit Shard(size_t maxSize) : entries(maxSize) {}
+
+        LRUKeyValue<PlanCacheKey, QueryShapeStatsEntry> entries;
+
+        // Protects 'entries'.
+        stdx::mutex mutex;
+    };
+
+    static const size_t kNumShards = 8;
+
+    Shard& _getShard(const PlanCacheKey& key) const;
+
+    std::vector<std::unique_ptr<Shard>> _shards;
+
+    // Whether internalQueryShapeStatsSize was zero when this object was created.
+    bool _disabled;
+};
+
+}  // namespace mongo
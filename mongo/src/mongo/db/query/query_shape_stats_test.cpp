@@ -0,0 +1,182 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+/**
+ * This file contains tests for mongo/db/query/query_shape_stats.h
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_shape_stats.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using std::unique_ptr;
+
+static const NamespaceString nss("test.collection");
+
+unique_ptr<CanonicalQuery> canonicalize(const char* queryStr, const char* sortStr = "{}") {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(fromjson(queryStr));
+    qr->setSort(fromjson(sortStr));
+    const boost::intrusive_ptr<ExpressionContext> expCtx;
+    auto statusWithCQ =
+        CanonicalQuery::canonicalize(opCtx.get(),
+                                     std::move(qr),
+                                     expCtx,
+                                     ExtensionsCallbackNoop(),
+                                     MatchExpressionParser::kAllowAllSpecialFeatures);
+    ASSERT_OK(statusWithCQ.getStatus());
+    return std::move(statusWithCQ.getValue());
+}
+
+PlanSummaryStats makeStats(size_t docsExamined, size_t nReturned) {
+    PlanSummaryStats stats;
+    stats.totalDocsExamined = docsExamined;
+    stats.nReturned = nReturned;
+    return stats;
+}
+
+void assertSuggestion(const char* queryStr, const char* sortStr, const char* expected) {
+    auto cq = canonicalize(queryStr, sortStr);
+    ASSERT_BSONOBJ_EQ(QueryShapeStats::suggestIndex(*cq), fromjson(expected));
+}
+
+TEST(QueryShapeStatsTest, SuggestIndexOrdersEqualitySortRange) {
+    assertSuggestion("{a: 1}", "{}", "{a: 1}");
+    assertSuggestion("{b: {$gt: 5}, a: 1}", "{}", "{a: 1, b: 1}");
+    assertSuggestion(
+        "{a: 1, b: {$gt: 5}, c: {$in: [1, 2]}}", "{d: -1}", "{a: 1, c: 1, d: -1, b: 1}");
+    assertSuggestion("{}", "{a: 1, b: -1}", "{a: 1, b: -1}");
+}
+
+TEST(QueryShapeStatsTest, SuggestIndexListsEachFieldOnce) {
+    assertSuggestion("{a: 1}", "{a: -1}", "{a: 1}");
+    assertSuggestion("{a: {$gt: 1, $lt: 5}}", "{}", "{a: 1}");
+    assertSuggestion("{a: {$gt: 1}}", "{a: -1}", "{a: -1}");
+}
+
+TEST(QueryShapeStatsTest, SuggestIndexIgnoresNonTopLevelPredicates) {
+    assertSuggestion("{$or: [{a: 1}, {b: 1}]}", "{}", "{}");
+    assertSuggestion("{a: {$ne: 1}}", "{}", "{}");
+    assertSuggestion("{a: {$elemMatch: {b: 1}}, c: 1}", "{}", "{c: 1}");
+    assertSuggestion("{a: 1}", "{$natural: 1}", "{a: 1}");
+}
+
+TEST(QueryShapeStatsTest, SuggestIndexSkipsQueriesNeedingSpecialIndexes) {
+    assertSuggestion("{$text: {$search: 'x'}, a: 1}", "{}", "{}");
+    assertSuggestion("{a: {$near: [0, 0]}, b: 1}", "{}", "{}");
+    assertSuggestion("{a: {$geoWithin: {$center: [[0, 0], 1]}}, b: 1}", "{}", "{}");
+}
+
+TEST(QueryShapeStatsTest, RecordAggregatesExecutionsOfAShape) {
+    QueryShapeStats shapeStats;
+    auto cq = canonicalize("{a: 1}");
+
+    PlanSummaryStats stats = makeStats(100, 2);
+    stats.totalKeysExamined = 3;
+    stats.executionTimeMillis = 4;
+    shapeStats.record("a", *cq, stats, Date_t::fromMillisSinceEpoch(1));
+    stats.indexesUsed.insert("a_1");
+    shapeStats.record("a", *cq, stats, Date_t::fromMillisSinceEpoch(2));
+
+    auto entries = shapeStats.getAllEntries();
+    ASSERT_EQUALS(entries.size(), 1U);
+    const QueryShapeStatsEntry& entry = entries[0];
+    ASSERT_BSONOBJ_EQ(entry.query, fromjson("{a: 1}"));
+    ASSERT_BSONOBJ_EQ(entry.suggestedIndex, fromjson("{a: 1}"));
+    ASSERT_EQUALS(entry.execCount, 2);
+    ASSERT_EQUALS(entry.totalKeysExamined, 6);
+    ASSERT_EQUALS(entry.totalDocsExamined, 200);
+    ASSERT_EQUALS(entry.totalReturned, 4);
+    ASSERT_EQUALS(entry.totalExecutionTimeMillis, 8);
+    ASSERT_EQUALS(entry.collectionScans, 1);
+    ASSERT_EQUALS(entry.firstSeen, Date_t::fromMillisSinceEpoch(1));
+    ASSERT_EQUALS(entry.lastSeen, Date_t::fromMillisSinceEpoch(2));
+
+    shapeStats.record("b", *canonicalize("{b: 1}"), stats, Date_t::fromMillisSinceEpoch(3));
+    ASSERT_EQUALS(shapeStats.size(), 2U);
+
+    shapeStats.clear();
+    ASSERT_EQUALS(shapeStats.size(), 0U);
+}
+
+TEST(QueryShapeStatsTest, RecommendIndexesGroupsShapesByIndex) {
+    QueryShapeStats shapeStats;
+    shapeStats.record("a", *canonicalize("{a: 1}"), makeStats(100, 1), Date_t());
+    shapeStats.record("aIn", *canonicalize("{a: {$in: [1, 2]}}"), makeStats(50, 2), Date_t());
+    shapeStats.record("b", *canonicalize("{b: 1}"), makeStats(500, 1), Date_t());
+
+    auto recommendations = shapeStats.recommendIndexes({});
+    ASSERT_EQUALS(recommendations.size(), 2U);
+
+    ASSERT_BSONOBJ_EQ(recommendations[0].keyPattern, fromjson("{b: 1}"));
+    ASSERT_EQUALS(recommendations[0].shapes.size(), 1U);
+
+    ASSERT_BSONOBJ_EQ(recommendations[1].keyPattern, fromjson("{a: 1}"));
+    ASSERT_EQUALS(recommendations[1].execCount, 2);
+    ASSERT_EQUALS(recommendations[1].totalDocsExamined, 150);
+    ASSERT_EQUALS(recommendations[1].totalReturned, 3);
+    ASSERT_EQUALS(recommendations[1].shapes.size(), 2U);
+    ASSERT_BSONOBJ_EQ(recommendations[1].shapes[0].query, fromjson("{a: 1}"));
+}
+
+TEST(QueryShapeStatsTest, RecommendIndexesSkipsShapesThatExamineOnlyWhatTheyReturn) {
+    QueryShapeStats shapeStats;
+    shapeStats.record("a", *canonicalize("{a: 1}"), makeStats(10, 10), Date_t());
+    shapeStats.record("all", *canonicalize("{}"), makeStats(100, 1), Date_t());
+
+    ASSERT_TRUE(shapeStats.recommendIndexes({}).empty());
+}
+
+TEST(QueryShapeStatsTest, RecommendIndexesSkipsIndexedShapes) {
+    QueryShapeStats shapeStats;
+    shapeStats.record("ab", *canonicalize("{a: 1}", "{b: -1}"), makeStats(100, 1), Date_t());
+
+    ASSERT_TRUE(shapeStats.recommendIndexes({fromjson("{a: 1, b: -1}")}).empty());
+    ASSERT_TRUE(shapeStats.recommendIndexes({fromjson("{a: -1, b: 1, c: 1}")}).empty());
+
+    ASSERT_EQUALS(shapeStats.recommendIndexes({fromjson("{a: 1}")}).size(), 1U);
+    ASSERT_EQUALS(shapeStats.recommendIndexes({fromjson("{a: 1, b: 1}")}).size(), 1U);
+    ASSERT_EQUALS(shapeStats.recommendIndexes({fromjson("{b: -1, a: 1}")}).size(), 1U);
+    ASSERT_EQUALS(shapeStats.recommendIndexes({fromjson("{a: 'hashed', b: -1}")}).size(), 1U);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -65,6 +65,37 @@ namespace mongo {
 
 using std::unique_ptr;
 using stdx::make_unique;
+
+namespace {
+
+/**
+ * Returns the limit of a sort on the text score that consumes the output of 'textNode' with
+ * nothing in between that could drop or reorder documents, or 0 if there is no such sort.
+ */
+size_t textScoreTopK(const QuerySolution& qsol, const QuerySolutionNode* textNode) {
+    size_t limit = 0;
+    const QuerySolutionNode* node = qsol.root.get();
+    while (node != textNode) {
+        if (node->children.size() != 1) {
+            return 0;
+        }
+        if (STAGE_SORT == node->getType()) {
+            const SortNode* sn = static_cast<const SortNode*>(node);
+            if (limit || sn->limit == 0 || sn->pattern.nFields() != 1 ||
+                !QueryRequest::isTextScoreMeta(sn->pattern.firstElement())) {
+                return 0;
+            }
+            limit = sn->limit;
+        } else if (limit && STAGE_SORT_KEY_GENERATOR != node->getType()) {
+            // Only stages above the sort may do anything but compute the sort key.
+            return 0;
+        }
+        node = node->children[0];
+    }
+    return limit;
+}
+
+}  // namespace
 //prepareExecution->StageBuilder::build  prepareExecutionĶ
 //עbuildStagesеݹãͿ԰QuerySolutionchild QuerySolutionһ
 PlanStage* buildStages(OperationContext* opCtx,     //úڵݹ
@@ -125,6 +156,8 @@ PlanStage* buildStages(OperationContext* opCtx,     //
             params.collection = collection;
             params.pattern = sn->pattern;
             params.limit = sn->limit;
+            params.allowDiskUse = cq.getQueryRequest().allowDiskUse();
+            params.maxMemoryUsageBytes = cq.getQueryRequest().getMaxBlockingSortBytes();
             return new SortStage(opCtx, params, ws, childStage);
         }
         case STAGE_SORT_KEY_GENERATOR: {
@@ -293,6 +326,7 @@ PlanStage* buildStages(OperationContext* opCtx,     //
             // fail in this case (this improvement is being tracked by SERVER-21510).
             params.query = static_cast<FTSQueryImpl&>(*node->ftsQuery);
             params.wantTextScore = (cq.getProj() && cq.getProj()->wantTextScore());
+            params.textScoreTopK = textScoreTopK(qsol, root);
             return new TextStage(opCtx, params, ws, node->filter.get());
         }
         case STAGE_SHARDING_FILTER: {
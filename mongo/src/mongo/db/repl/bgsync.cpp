@@ -571,6 +571,14 @@ void BackgroundSync::waitForMore() {
     _oplogBuffer->waitForData(Seconds(1));
 }
 
+double BackgroundSync::getBufferFillRatio() const {
+    const auto maxSize = _oplogBuffer->getMaxSize();
+    if (maxSize == 0) {
+        return 0.0;
+    }
+    return std::min(1.0, static_cast<double>(_oplogBuffer->getSize()) / maxSize);
+}
+
 void BackgroundSync::consume(OperationContext* opCtx) {
     // this is just to get the op off the queue, it's been peeked at
     // and queued for application already
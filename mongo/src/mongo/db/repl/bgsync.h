@@ -120,6 +120,9 @@ public:
     void clearSyncTarget();
     void waitForMore();
 
+    // Returns the fraction of the oplog buffer's capacity currently in use, in [0, 1].
+    double getBufferFillRatio() const;
+
     // For monitoring
     BSONObj getCounters();
 
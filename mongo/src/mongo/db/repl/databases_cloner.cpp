@@ -61,6 +61,10 @@ using UniqueLock = stdx::unique_lock<stdx::mutex>;
 // The number of attempts for the listDatabases commands.
 MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncListDatabasesAttempts, int, 3);
 
+// The number of databases to clone at the same time. Each database takes its own database lock,
+// so cloners for different databases do not contend with each other.
+MONGO_EXPORT_SERVER_PARAMETER(maxNumInitialSyncDatabaseCloners, int, 1);
+
 }  // namespace
 
 
@@ -359,10 +363,6 @@ void DatabasesCloner::_onListDatabaseFinish(const CommandCallbackArgs& cbd) {
             if (_scheduleDbWorkFn) {
                 dbCloner->setScheduleDbWorkFn_forTest(_scheduleDbWorkFn);
             }
-            // Start first database cloner.
-            if (_databaseCloners.empty()) {
-                startStatus = dbCloner->startup();
-            }
         } catch (...) {
             startStatus = exceptionToStatus();
         }
@@ -384,7 +384,41 @@ void DatabasesCloner::_onListDatabaseFinish(const CommandCallbackArgs& cbd) {
         } else {
             _fail_inlock(&lk, _status);
         }
+        return;
+    }
+
+    auto startStatus = _startDatabaseCloners_inlock();
+    if (!startStatus.isOK()) {
+        std::string err = str::stream() << "could not start cloner for database: "
+                                        << _databaseCloners[_nextDatabaseClonerIndex]->getDBName()
+                                        << " due to: " << startStatus.toString();
+        error() << err;
+        _fail_inlock(&lk, {ErrorCodes::InitialSyncFailure, err});
+    }
+}
+
+Status DatabasesCloner::_startDatabaseCloners_inlock() {
+    const size_t maxActive = std::max(1, maxNumInitialSyncDatabaseCloners.load());
+    while (_nextDatabaseClonerIndex < _databaseCloners.size()) {
+        const size_t active = _nextDatabaseClonerIndex - _stats.databasesCloned;
+        if (active >= maxActive) {
+            break;
+        }
+        if (active > 0 && _stats.databasesCloned == 0 &&
+            StringData(_databaseCloners.front()->getDBName()).equalCaseInsensitive("admin")) {
+            break;
+        }
+
+        auto&& dbCloner = _databaseCloners[_nextDatabaseClonerIndex];
+        LOG(1) << "starting cloner for database '" << dbCloner->getDBName() << "' ("
+               << (_nextDatabaseClonerIndex + 1) << " of " << _databaseCloners.size() << ")";
+        auto status = dbCloner->startup();
+        if (!status.isOK()) {
+            return status;
+        }
+        ++_nextDatabaseClonerIndex;
     }
+    return Status::OK();
 }
 
 std::vector<std::shared_ptr<DatabaseCloner>> DatabasesCloner::_getDatabaseCloners() const {
@@ -399,9 +433,21 @@ RemoteCommandRetryScheduler* DatabasesCloner::_getListDatabasesScheduler() const
 
 void DatabasesCloner::_onEachDBCloneFinish(const Status& status, const std::string& name) {
     UniqueLock lk(_mutex);
+    // When several databases are cloned at once, the others may still finish after one of them
+    // has already failed the clone.
+    if (!_isActive_inlock()) {
+        return;
+    }
+
     if (!status.isOK()) {
         warning() << "database '" << name << "' (" << (_stats.databasesCloned + 1) << " of "
                   << _databaseCloners.size() << ") clone failed due to " << status.toString();
+        for (size_t i = 0; i < _nextDatabaseClonerIndex; ++i) {
+            auto&& dbCloner = _databaseCloners[i];
+            if (dbCloner->getDBName() != name && dbCloner->isActive()) {
+                dbCloner->shutdown();
+            }
+        }
         _fail_inlock(&lk, status);
         return;
     }
@@ -434,12 +480,12 @@ void DatabasesCloner::_onEachDBCloneFinish(const Status& status, const std::stri
         return;
     }
 
-    // Start next database cloner.
-    auto&& dbCloner = _databaseCloners[_stats.databasesCloned];
-    auto startStatus = dbCloner->startup();
+    // Start next database cloners.
+    auto startStatus = _startDatabaseCloners_inlock();
     if (!startStatus.isOK()) {
-        warning() << "failed to schedule database '" << name << "' ("
-                  << (_stats.databasesCloned + 1) << " of " << _databaseCloners.size()
+        warning() << "failed to schedule database '"
+                  << _databaseCloners[_nextDatabaseClonerIndex]->getDBName() << "' ("
+                  << (_nextDatabaseClonerIndex + 1) << " of " << _databaseCloners.size()
                   << ") due to " << startStatus.toString();
         _fail_inlock(&lk, startStatus);
         return;
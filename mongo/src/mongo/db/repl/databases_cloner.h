@@ -165,6 +165,13 @@ private:
      */
     StatusWith<std::vector<BSONElement>> _parseListDatabasesResponse(BSONObj dbResponse);
 
+    /**
+     * Starts database cloners, in listDatabases order, until 'maxNumInitialSyncDatabaseCloners'
+     * are running at once. The 'admin' database is always cloned on its own, before any other
+     * database, so it can be validated before the rest of the data arrives.
+     */
+    Status _startDatabaseCloners_inlock();
+
     //
     // All member variables are labeled with one of the following codes indicating the
     // synchronization rules for accessing them.
@@ -186,6 +193,7 @@ private:
 
     std::unique_ptr<RemoteCommandRetryScheduler> _listDBsScheduler;  // (M) scheduler for listDBs.
     std::vector<std::shared_ptr<DatabaseCloner>> _databaseCloners;   // (M) database cloners by name
+    size_t _nextDatabaseClonerIndex = 0;  // (M) index of the next database cloner to start.
     Stats _stats;                                                    // (M)
 
     // State transitions:
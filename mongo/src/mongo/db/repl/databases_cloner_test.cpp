@@ -38,6 +38,7 @@
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/storage_interface_mock.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/network_interface_mock.h"
 #include "mongo/executor/thread_pool_task_executor_test_fixture.h"
 #include "mongo/stdx/mutex.h"
@@ -812,6 +813,65 @@ TEST_F(DBsClonerTest, FailingToScheduleSecondDatabaseClonerShouldCancelTheCloner
     ASSERT_EQUALS(ErrorCodes::OperationFailed, result);
 }
 
+TEST_F(DBsClonerTest, DatabasesAreClonedConcurrentlyUpToMaxNumInitialSyncDatabaseCloners) {
+    auto maxClonersParameter =
+        ServerParameterSet::getGlobal()->getMap()["maxNumInitialSyncDatabaseCloners"];
+    ASSERT(maxClonersParameter);
+    ASSERT_OK(maxClonersParameter->setFromString("2"));
+    ON_BLOCK_EXIT([maxClonersParameter] { maxClonersParameter->setFromString("1"); });
+
+    Status result{ErrorCodes::NotYetInitialized, ""};
+    DatabasesCloner cloner{&getStorage(),
+                           &getExecutor(),
+                           &getDbWorkThreadPool(),
+                           HostAndPort{"local:1234"},
+                           [](const BSONObj&) { return true; },
+                           [&result](const Status& status) {
+                               log() << "setting result to " << status;
+                               result = status;
+                           }};
+
+    ASSERT_OK(cloner.startup());
+    ASSERT_TRUE(cloner.isActive());
+
+    auto net = getNet();
+    executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+    // listDatabases
+    scheduleNetworkResponse("listDatabases",
+                            fromjson("{ok:1, databases:[{name:'a'}, {name:'b'}, {name:'c'}]}"));
+    net->runReadyNetworkOperations();
+    ASSERT_TRUE(cloner.isActive());
+
+    // Databases "a" and "b" are listed at the same time, "c" waits for one of them to finish.
+    auto firstRequest = net->getNextReadyRequest();
+    auto secondRequest = net->getNextReadyRequest();
+    ASSERT_FALSE(net->hasReadyRequests());
+    ASSERT_EQUALS("listCollections",
+                  std::string(firstRequest->getRequest().cmdObj.firstElementFieldName()));
+    ASSERT_EQUALS("listCollections",
+                  std::string(secondRequest->getRequest().cmdObj.firstElementFieldName()));
+    ASSERT_NOT_EQUALS(firstRequest->getRequest().dbname, secondRequest->getRequest().dbname);
+
+    scheduleNetworkResponse(
+        secondRequest,
+        fromjson("{ok:1, cursor:{id:NumberLong(0), ns:'b.$cmd.listCollections', firstBatch: []}}"));
+    net->runReadyNetworkOperations();
+    ASSERT_TRUE(cloner.isActive());
+    processNetworkResponse(
+        "listCollections",
+        fromjson("{ok:1, cursor:{id:NumberLong(0), ns:'c.$cmd.listCollections', firstBatch: []}}"));
+    ASSERT_TRUE(cloner.isActive());
+
+    scheduleNetworkResponse(
+        firstRequest,
+        fromjson("{ok:1, cursor:{id:NumberLong(0), ns:'a.$cmd.listCollections', firstBatch: []}}"));
+    net->runReadyNetworkOperations();
+
+    cloner.join();
+    ASSERT_FALSE(cloner.isActive());
+    ASSERT_OK(result);
+}
+
 TEST_F(DBsClonerTest, DatabaseClonerChecksAdminDbUsingStorageInterfaceAfterCopyingAdminDb) {
     Status result = getDetectableErrorStatus();
 
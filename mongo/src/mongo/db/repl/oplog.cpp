@@ -86,6 +86,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/session_catalog.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/storage/oplog_slot_tracker.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/platform/random.h"
@@ -126,16 +127,16 @@ Collection* _localOplogCollection = nullptr;
 // of the server who understand the risks this poses.
 MONGO_EXPORT_SERVER_PARAMETER(allowUnsafeRenamesDuringInitialSync, bool, false);
 
-PseudoRandom hashGenerator(std::unique_ptr<SecureRandom>(SecureRandom::create())->nextInt64());
+// Writers generate oplog entry hashes concurrently, so each thread has its own generator.
+thread_local std::unique_ptr<PseudoRandom> hashGenerator;
 
-// Synchronizes the section where a new Timestamp is generated and when it is registered in the
-// storage engine.
-stdx::mutex newOpMutex;
-stdx::condition_variable newTimestampNotifier;
-// Remembers that last timestamp generated for creating new oplog entries or last timestamp of
-// oplog entry applied as a secondary. This should only be used for the snapshot thread. Must hold
-// the newOpMutex when accessing this variable.
-Timestamp lastSetTimestamp;
+int64_t nextOplogHash() {
+    if (!hashGenerator) {
+        hashGenerator = stdx::make_unique<PseudoRandom>(
+            std::unique_ptr<SecureRandom>(SecureRandom::create())->nextInt64());
+    }
+    return hashGenerator->nextInt64();
+}
 
 static std::string _oplogCollectionName;
 
@@ -151,29 +152,32 @@ void _getNextOpTimes(OperationContext* opCtx,
     auto replCoord = ReplicationCoordinator::get(opCtx);
     long long term = OpTime::kUninitializedTerm;
 
-    // Fetch term out of the newOpMutex.
+    // Fetch term outside the reservation.
     if (replCoord->getReplicationMode() == ReplicationCoordinator::modeReplSet &&
         replCoord->isV1ElectionProtocol()) {
         // Current term. If we're not a replset of pv=1, it remains kOldProtocolVersionTerm.
         term = replCoord->getTerm();
     }
 
-    // Allow the storage engine to start the transaction outside the critical section.
+    // Allow the storage engine to start the transaction outside the reservation.
     opCtx->recoveryUnit()->prepareSnapshot();
-    stdx::lock_guard<stdx::mutex> lk(newOpMutex);
 
-    auto ts = LogicalClock::get(opCtx)->reserveTicks(count).asTimestamp();
-    lastSetTimestamp = ts;
-    newTimestampNotifier.notify_all();
+    // Concurrent writers reserve ticks without a shared lock. Until the storage engine has been
+    // given the timestamp, the slot tracker keeps oplog visibility from passing it.
+    auto slotTracker = OplogSlotTracker::get(opCtx->getServiceContext());
+    const auto reservation = slotTracker->reserve(
+        [&] { return LogicalClock::get(opCtx)->reserveTicks(count).asTimestamp(); });
+    const auto ts = reservation.timestamp;
 
     fassert(28560, oplog->getRecordStore()->oplogDiskLocRegister(opCtx, ts));
+    slotTracker->release(reservation);
 
     // Set hash if we're in replset mode, otherwise it remains 0 in master/slave.
     const bool needHash = (replCoord->getReplicationMode() == ReplicationCoordinator::modeReplSet);
     for (std::size_t i = 0; i < count; i++) {
         slotsOut[i].opTime = {Timestamp(ts.asULL() + i), term};
         if (needHash) {
-            slotsOut[i].hash = hashGenerator.nextInt64();
+            slotsOut[i].hash = nextOplogHash();
         }
     }
 }
@@ -1616,10 +1620,7 @@ Status applyCommand_inlock(OperationContext* opCtx,
 }
 
 void setNewTimestamp(ServiceContext* service, const Timestamp& newTime) {
-    stdx::lock_guard<stdx::mutex> lk(newOpMutex);
     LogicalClock::get(service)->setClusterTimeFromTrustedSource(LogicalTime(newTime));
-    lastSetTimestamp = newTime;
-    newTimestampNotifier.notify_all();
 }
 
 void initTimestampFromOplog(OperationContext* opCtx, const std::string& oplogNS) {
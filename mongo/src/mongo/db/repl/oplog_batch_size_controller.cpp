@@ -0,0 +1,77 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_batch_size_controller.h"
+
+#include <algorithm>
+
+namespace mongo {
+namespace repl {
+
+constexpr size_t OplogBatchSizeController::kMinTargetOps;
+constexpr double OplogBatchSizeController::kGrowthFactor;
+constexpr double OplogBatchSizeController::kHighBufferFillRatio;
+
+OplogBatchSizeController::OplogBatchSizeController(size_t initialTargetOps)
+    : _targetOps(std::max(initialTargetOps, kMinTargetOps)) {}
+
+size_t OplogBatchSizeController::getTargetOps(size_t maxOps) const {
+    const auto target = static_cast<size_t>(_targetOps.load());
+    return std::max<size_t>(1, std::min(target, maxOps));
+}
+
+void OplogBatchSizeController::recordBatch(size_t numOps,
+                                           Milliseconds applyTime,
+                                           Milliseconds targetApplyTime,
+                                           double bufferFillRatio) {
+    if (numOps == 0 || targetApplyTime <= Milliseconds(0)) {
+        return;
+    }
+
+    const auto target = static_cast<size_t>(_targetOps.load());
+    auto newTarget = target;
+
+    if (applyTime > targetApplyTime) {
+        // Scale down to the number of operations that would have fit in the target time at the
+        // observed per-op cost.
+        newTarget = static_cast<size_t>(static_cast<double>(numOps) * targetApplyTime.count() /
+                                        applyTime.count());
+    } else if (numOps >= target &&
+               (applyTime * 2 <= targetApplyTime || bufferFillRatio >= kHighBufferFillRatio)) {
+        // Only a batch that was limited by the target tells us anything about whether a larger
+        // batch would help; a short batch just means the buffer ran dry.
+        newTarget = static_cast<size_t>(static_cast<double>(target) * kGrowthFactor) + 1;
+    }
+
+    _targetOps.store(static_cast<long long>(std::max(newTarget, kMinTargetOps)));
+}
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,89 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * Chooses the number of operations the oplog batcher should try to put in the next batch, based on
+ * how long recent batches took to apply and how full the oplog buffer is.
+ *
+ * The target shrinks proportionally whenever a batch takes longer than the target apply time, so
+ * that majority commit latency stays bounded. It grows multiplicatively when a full batch was
+ * applied well under the target, or when the buffer is filling up faster than batches drain it, so
+ * that fixed per-batch costs (journaling, minValid updates, thread pool round trips) are amortized
+ * over more operations.
+ *
+ * recordBatch() is called by the applier thread and getTargetOps() by the batcher thread.
+ */
+class OplogBatchSizeController {
+    MONGO_DISALLOW_COPYING(OplogBatchSizeController);
+
+public:
+    // The target never drops below this many operations.
+    static constexpr size_t kMinTargetOps = 100;
+
+    // Multiplicative increase applied when a batch wants to grow.
+    static constexpr double kGrowthFactor = 1.25;
+
+    // Buffer fill ratio above which batches grow even if not yet well under the target time.
+    static constexpr double kHighBufferFillRatio = 0.5;
+
+    explicit OplogBatchSizeController(size_t initialTargetOps);
+
+    /**
+     * Returns the current target, capped at 'maxOps'. The target itself never drops below
+     * kMinTargetOps, but 'maxOps' is the configured hard limit on operations per batch and always
+     * wins, so the result is only below kMinTargetOps when 'maxOps' is. It is never 0.
+     */
+    size_t getTargetOps(size_t maxOps) const;
+
+    /**
+     * Feeds back the outcome of applying one batch. 'numOps' is the size of the batch,
+     * 'applyTime' how long multiApply() took and 'bufferFillRatio' the fraction of the oplog
+     * buffer in use once the batch was applied.
+     */
+    void recordBatch(size_t numOps,
+                     Milliseconds applyTime,
+                     Milliseconds targetApplyTime,
+                     double bufferFillRatio);
+
+private:
+    AtomicWord<long long> _targetOps;
+};
+
+}  // namespace repl
+}  // namespace mongo
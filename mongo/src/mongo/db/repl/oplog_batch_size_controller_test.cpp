@@ -0,0 +1,92 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_batch_size_controller.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+const Milliseconds kTarget(100);
+
+TEST(OplogBatchSizeControllerTest, InitialTargetIsClampedToMaxOps) {
+    OplogBatchSizeController controller(5000);
+    ASSERT_EQUALS(5000U, controller.getTargetOps(10000));
+    ASSERT_EQUALS(1000U, controller.getTargetOps(1000));
+}
+
+TEST(OplogBatchSizeControllerTest, MaxOpsBelowMinimumWins) {
+    OplogBatchSizeController controller(1000);
+    ASSERT_EQUALS(10U, controller.getTargetOps(10));
+    ASSERT_EQUALS(1U, controller.getTargetOps(0));
+}
+
+TEST(OplogBatchSizeControllerTest, InitialTargetIsAtLeastMinimum) {
+    OplogBatchSizeController controller(1);
+    ASSERT_EQUALS(OplogBatchSizeController::kMinTargetOps, controller.getTargetOps(10000));
+}
+
+TEST(OplogBatchSizeControllerTest, SlowBatchShrinksTargetProportionally) {
+    OplogBatchSizeController controller(4000);
+    controller.recordBatch(4000, Milliseconds(400), kTarget, 0.0);
+    ASSERT_EQUALS(1000U, controller.getTargetOps(10000));
+}
+
+TEST(OplogBatchSizeControllerTest, ShrinkNeverGoesBelowMinimum) {
+    OplogBatchSizeController controller(4000);
+    controller.recordBatch(4000, Seconds(100), kTarget, 0.0);
+    ASSERT_EQUALS(OplogBatchSizeController::kMinTargetOps, controller.getTargetOps(10000));
+}
+
+TEST(OplogBatchSizeControllerTest, FastFullBatchGrowsTarget) {
+    OplogBatchSizeController controller(1000);
+    controller.recordBatch(1000, Milliseconds(10), kTarget, 0.0);
+    ASSERT_GREATER_THAN(controller.getTargetOps(10000), 1000U);
+}
+
+TEST(OplogBatchSizeControllerTest, ShortBatchDoesNotGrowTarget) {
+    OplogBatchSizeController controller(1000);
+    controller.recordBatch(10, Milliseconds(1), kTarget, 0.0);
+    ASSERT_EQUALS(1000U, controller.getTargetOps(10000));
+}
+
+TEST(OplogBatchSizeControllerTest, FullBufferGrowsTargetEvenNearTargetTime) {
+    OplogBatchSizeController controller(1000);
+    controller.recordBatch(1000, Milliseconds(90), kTarget, 0.0);
+    ASSERT_EQUALS(1000U, controller.getTargetOps(10000));
+
+    controller.recordBatch(1000, Milliseconds(90), kTarget, 0.9);
+    ASSERT_GREATER_THAN(controller.getTargetOps(10000), 1000U);
+}
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
@@ -30,13 +30,29 @@
 
 #include "mongo/db/repl/oplog_buffer_blocking_queue.h"
 
+#include <algorithm>
+
+#include "mongo/bson/util/builder.h"
+#include "mongo/db/server_parameters.h"
+
 namespace mongo {
 namespace repl {
 
 namespace {
 
-// Limit buffer to 256MB
-const size_t kOplogBufferSize = 256 * 1024 * 1024;
+// Limit buffer to 256MB by default. A larger buffer lets the oplog fetcher keep the network busy
+// through bursts of slow application, which matters most for sync sources far away.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replOplogBufferMaxSizeBytes, int, 256 * 1024 * 1024);
+
+// The buffer must be able to hold at least the largest batch a single response can carry.
+size_t getOplogBufferSize() {
+    return std::max(static_cast<size_t>(std::max(replOplogBufferMaxSizeBytes, 0)),
+                    static_cast<size_t>(BSONObjMaxInternalSize));
+}
+
+// Most bytes moved from the shared queue into the consumer cache at once. An entry larger than this
+// is still moved on its own.
+const size_t kConsumerCacheRefillSize = 16 * 1024 * 1024;
 
 size_t getDocumentSize(const BSONObj& o) {
     // SERVER-9808 Avoid Fortify complaint about implicit signed->unsigned conversion
@@ -45,7 +61,8 @@ size_t getDocumentSize(const BSONObj& o) {
 
 }  // namespace
 
-OplogBufferBlockingQueue::OplogBufferBlockingQueue() : _queue(kOplogBufferSize, &getDocumentSize) {}
+OplogBufferBlockingQueue::OplogBufferBlockingQueue()
+    : _queue(getOplogBufferSize(), &getDocumentSize) {}
 
 void OplogBufferBlockingQueue::startup(OperationContext*) {}
 
@@ -72,41 +89,77 @@ void OplogBufferBlockingQueue::waitForSpace(OperationContext*, std::size_t size)
 }
 
 bool OplogBufferBlockingQueue::isEmpty() const {
-    return _queue.empty();
+    stdx::lock_guard<stdx::mutex> lk(_consumerMutex);
+    return _consumerCache.empty() && _queue.empty();
 }
 
 std::size_t OplogBufferBlockingQueue::getMaxSize() const {
-    return kOplogBufferSize;
+    return _queue.maxSize();
 }
 
 std::size_t OplogBufferBlockingQueue::getSize() const {
-    return _queue.size();
+    stdx::lock_guard<stdx::mutex> lk(_consumerMutex);
+    return _consumerCacheSize + _queue.size();
 }
 
 std::size_t OplogBufferBlockingQueue::getCount() const {
-    return _queue.count();
+    stdx::lock_guard<stdx::mutex> lk(_consumerMutex);
+    return _consumerCache.size() + _queue.count();
 }
 
 void OplogBufferBlockingQueue::clear(OperationContext*) {
+    stdx::lock_guard<stdx::mutex> lk(_consumerMutex);
+    _consumerCache.clear();
+    _consumerCacheSize = 0;
     _queue.clear();
 }
 
 bool OplogBufferBlockingQueue::tryPop(OperationContext*, Value* value) {
-    return _queue.tryPop(*value);
+    stdx::lock_guard<stdx::mutex> lk(_consumerMutex);
+    if (!_refillConsumerCache_inlock()) {
+        return false;
+    }
+    *value = std::move(_consumerCache.front());
+    _consumerCache.pop_front();
+    _consumerCacheSize -= getDocumentSize(*value);
+    return true;
 }
 
 bool OplogBufferBlockingQueue::waitForData(Seconds waitDuration) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_consumerMutex);
+        if (!_consumerCache.empty()) {
+            return true;
+        }
+    }
     Value ignored;
     return _queue.blockingPeek(ignored, static_cast<int>(durationCount<Seconds>(waitDuration)));
 }
 
 bool OplogBufferBlockingQueue::peek(OperationContext*, Value* value) {
-    return _queue.peek(*value);
+    stdx::lock_guard<stdx::mutex> lk(_consumerMutex);
+    if (!_refillConsumerCache_inlock()) {
+        return false;
+    }
+    *value = _consumerCache.front();
+    return true;
 }
 
 boost::optional<OplogBuffer::Value> OplogBufferBlockingQueue::lastObjectPushed(
     OperationContext*) const {
-    return _queue.lastObjectPushed();
+    stdx::lock_guard<stdx::mutex> lk(_consumerMutex);
+    auto lastObjectPushed = _queue.lastObjectPushed();
+    if (!lastObjectPushed && !_consumerCache.empty()) {
+        return _consumerCache.back();
+    }
+    return lastObjectPushed;
+}
+
+bool OplogBufferBlockingQueue::_refillConsumerCache_inlock() {
+    if (_consumerCache.empty()) {
+        _consumerCacheSize = _queue.tryPopUpTo(kConsumerCacheRefillSize, &_consumerCache);
+    }
+    return !_consumerCache.empty();
 }
 
 }  // namespace repl
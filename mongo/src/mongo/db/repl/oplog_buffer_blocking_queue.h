@@ -28,7 +28,10 @@
 
 #pragma once
 
+#include <deque>
+
 #include "mongo/db/repl/oplog_buffer.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/queue.h"
 
 namespace mongo {
@@ -36,6 +39,10 @@ namespace repl {
 
 /**
  * Oplog buffer backed by in memory blocking queue of BSONObj.
+ *
+ * The consumer side (peek/tryPop) is served from a private cache that is refilled by taking many
+ * entries out of the blocking queue at once, so the mutex shared with the producer is acquired
+ * once per refill rather than once per peek and once per pop.
  */
 class OplogBufferBlockingQueue final : public OplogBuffer {
 public:
@@ -60,7 +67,20 @@ public:
     boost::optional<Value> lastObjectPushed(OperationContext* opCtx) const override;
 
 private:
+    /**
+     * Refills '_consumerCache' from '_queue' if the cache is empty. Returns false if there is still
+     * nothing to consume.
+     */
+    bool _refillConsumerCache_inlock();
+
     BlockingQueue<BSONObj> _queue;
+
+    // Guards '_consumerCache' and '_consumerCacheSize'. Only ever taken before '_queue's mutex.
+    mutable stdx::mutex _consumerMutex;
+
+    // Entries already removed from '_queue' but not yet popped, in oplog order.
+    std::deque<BSONObj> _consumerCache;
+    std::size_t _consumerCacheSize = 0;
 };
 
 }  // namespace repl
@@ -0,0 +1,143 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/repl/oplog_buffer_blocking_queue.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+BSONObj makeOplogEntry(int t) {
+    return BSON("ts" << Timestamp(t, t) << "h" << t << "ns"
+                     << "a.a"
+                     << "v"
+                     << 2
+                     << "op"
+                     << "i"
+                     << "o"
+                     << BSON("_id" << t));
+}
+
+TEST(OplogBufferBlockingQueueTest, PeekAndPopReturnEntriesInOrder) {
+    OplogBufferBlockingQueue buffer;
+    OplogBuffer::Batch entries = {makeOplogEntry(1), makeOplogEntry(2), makeOplogEntry(3)};
+    buffer.pushAllNonBlocking(nullptr, entries.cbegin(), entries.cend());
+    ASSERT_EQUALS(3U, buffer.getCount());
+
+    for (const auto& expected : entries) {
+        OplogBuffer::Value peeked;
+        ASSERT_TRUE(buffer.peek(nullptr, &peeked));
+        ASSERT_BSONOBJ_EQ(expected, peeked);
+
+        OplogBuffer::Value popped;
+        ASSERT_TRUE(buffer.tryPop(nullptr, &popped));
+        ASSERT_BSONOBJ_EQ(expected, popped);
+    }
+
+    OplogBuffer::Value value;
+    ASSERT_FALSE(buffer.peek(nullptr, &value));
+    ASSERT_FALSE(buffer.tryPop(nullptr, &value));
+    ASSERT_TRUE(buffer.isEmpty());
+}
+
+TEST(OplogBufferBlockingQueueTest, SizeAndCountIncludeEntriesAlreadyPeeked) {
+    OplogBufferBlockingQueue buffer;
+    auto entry1 = makeOplogEntry(1);
+    auto entry2 = makeOplogEntry(2);
+    buffer.push(nullptr, entry1);
+    buffer.push(nullptr, entry2);
+    const auto totalSize = std::size_t(entry1.objsize() + entry2.objsize());
+
+    // Peeking moves entries into the consumer cache; they must still be accounted for.
+    OplogBuffer::Value value;
+    ASSERT_TRUE(buffer.peek(nullptr, &value));
+    ASSERT_EQUALS(2U, buffer.getCount());
+    ASSERT_EQUALS(totalSize, buffer.getSize());
+    ASSERT_FALSE(buffer.isEmpty());
+
+    ASSERT_TRUE(buffer.tryPop(nullptr, &value));
+    ASSERT_EQUALS(1U, buffer.getCount());
+    ASSERT_EQUALS(std::size_t(entry2.objsize()), buffer.getSize());
+}
+
+TEST(OplogBufferBlockingQueueTest, PushAfterPeekIsConsumedAfterCachedEntries) {
+    OplogBufferBlockingQueue buffer;
+    buffer.push(nullptr, makeOplogEntry(1));
+
+    OplogBuffer::Value value;
+    ASSERT_TRUE(buffer.peek(nullptr, &value));
+    buffer.push(nullptr, makeOplogEntry(2));
+    ASSERT_BSONOBJ_EQ(makeOplogEntry(2), *buffer.lastObjectPushed(nullptr));
+
+    ASSERT_TRUE(buffer.tryPop(nullptr, &value));
+    ASSERT_BSONOBJ_EQ(makeOplogEntry(1), value);
+    ASSERT_TRUE(buffer.tryPop(nullptr, &value));
+    ASSERT_BSONOBJ_EQ(makeOplogEntry(2), value);
+}
+
+TEST(OplogBufferBlockingQueueTest, LastObjectPushedReturnsCachedEntry) {
+    OplogBufferBlockingQueue buffer;
+    ASSERT_FALSE(buffer.lastObjectPushed(nullptr));
+    buffer.push(nullptr, makeOplogEntry(1));
+
+    OplogBuffer::Value value;
+    ASSERT_TRUE(buffer.peek(nullptr, &value));
+    ASSERT_BSONOBJ_EQ(makeOplogEntry(1), *buffer.lastObjectPushed(nullptr));
+}
+
+TEST(OplogBufferBlockingQueueTest, ClearDiscardsCachedEntries) {
+    OplogBufferBlockingQueue buffer;
+    buffer.push(nullptr, makeOplogEntry(1));
+    buffer.push(nullptr, makeOplogEntry(2));
+
+    OplogBuffer::Value value;
+    ASSERT_TRUE(buffer.peek(nullptr, &value));
+    buffer.clear(nullptr);
+
+    ASSERT_TRUE(buffer.isEmpty());
+    ASSERT_EQUALS(0U, buffer.getCount());
+    ASSERT_EQUALS(0U, buffer.getSize());
+    ASSERT_FALSE(buffer.tryPop(nullptr, &value));
+}
+
+TEST(OplogBufferBlockingQueueTest, WaitForDataReturnsTrueWhenOnlyCachedEntriesRemain) {
+    OplogBufferBlockingQueue buffer;
+    buffer.push(nullptr, makeOplogEntry(1));
+
+    OplogBuffer::Value value;
+    ASSERT_TRUE(buffer.peek(nullptr, &value));
+    ASSERT_TRUE(buffer.waitForData(Seconds(0)));
+}
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
@@ -381,6 +381,14 @@ public:
      */
     virtual OpTime getMyLastDurableOpTime() const = 0;
 
+    /**
+     * Returns the timestamp of the earliest optime that a reader is waiting for this node to
+     * apply, or a null Timestamp if no reader is waiting. Oplog application ends a batch once it
+     * reaches this point so that the waiting read is released without waiting for a full batch.
+     * Does not take the replication coordinator mutex.
+     */
+    virtual Timestamp getEarliestReadWaiterTimestamp() const = 0;
+
     /**
      * Waits until the optime of the current node is at least the opTime specified in 'settings'.
      *
@@ -451,6 +451,12 @@ OpTime ReplicationCoordinatorExternalStateImpl::onTransitionToPrimary(OperationC
         _replicationProcess->getConsistencyMarkers()->getOplogTruncateAfterPoint(opCtx).isNull());
     _replicationProcess->getConsistencyMarkers()->setAppliedThrough(opCtx, {});
 
+    // We no longer apply oplog batches, so reads must stop using the snapshot of the last batch we
+    // applied and see our own writes instead.
+    if (auto manager = _service->getGlobalStorageEngine()->getSnapshotManager()) {
+        manager->setLocalSnapshot(boost::none);
+    }
+
     if (isV1ElectionProtocol) {
         writeConflictRetry(opCtx, "logging transition to primary to oplog", "local.oplog.rs", [&] {
             WriteUnitOfWork wuow(opCtx);
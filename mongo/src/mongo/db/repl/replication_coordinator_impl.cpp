@@ -34,6 +34,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <tuple>
 
 #include "mongo/base/status.h"
 #include "mongo/client/fetcher.h"
@@ -252,52 +253,120 @@ private:
     Waiter* _waiter;
 };
 
+void ReplicationCoordinatorImpl::HeartbeatLatencyStats::record(Microseconds mutexWait,
+                                                                Microseconds processing) {
+    auto raiseMax = [](AtomicInt64* max, long long value) {
+        auto current = max->load();
+        while (current < value) {
+            auto previous = max->compareAndSwap(current, value);
+            if (previous == current) {
+                break;
+            }
+            current = previous;
+        }
+    };
+
+    _count.fetchAndAdd(1);
+    _totalMutexWaitMicros.fetchAndAdd(durationCount<Microseconds>(mutexWait));
+    raiseMax(&_maxMutexWaitMicros, durationCount<Microseconds>(mutexWait));
+    _totalProcessingMicros.fetchAndAdd(durationCount<Microseconds>(processing));
+    raiseMax(&_maxProcessingMicros, durationCount<Microseconds>(processing));
+}
+
+void ReplicationCoordinatorImpl::HeartbeatLatencyStats::append(StringData fieldName,
+                                                               BSONObjBuilder* builder) const {
+    BSONObjBuilder subBuilder(builder->subobjStart(fieldName));
+    subBuilder.append("count", _count.load());
+    subBuilder.append("totalMutexWaitMicros", _totalMutexWaitMicros.load());
+    subBuilder.append("maxMutexWaitMicros", _maxMutexWaitMicros.load());
+    subBuilder.append("totalProcessingMicros", _totalProcessingMicros.load());
+    subBuilder.append("maxProcessingMicros", _maxProcessingMicros.load());
+}
+
+ReplicationCoordinatorImpl::WaiterList::Group::Group(const WriteConcernOptions* writeConcern) {
+    if (writeConcern) {
+        hasWriteConcern = true;
+        wMode = writeConcern->wMode;
+        wNumNodes = writeConcern->wNumNodes;
+        syncMode = writeConcern->syncMode;
+    }
+}
+
+bool ReplicationCoordinatorImpl::WaiterList::Group::operator<(const Group& other) const {
+    return std::tie(hasWriteConcern, wMode, wNumNodes, syncMode) <
+        std::tie(other.hasWriteConcern, other.wMode, other.wNumNodes, other.syncMode);
+}
+
 void ReplicationCoordinatorImpl::WaiterList::add_inlock(WaiterType waiter) {
-    _list.push_back(waiter);
+    _groups[Group(waiter->writeConcern)].emplace(waiter->opTime, waiter);
 }
 
-void ReplicationCoordinatorImpl::WaiterList::signalAndRemoveIf_inlock(
+void ReplicationCoordinatorImpl::WaiterList::signalAndRemoveReady_inlock(
     stdx::function<bool(WaiterType)> func) {
-    // Only advance iterator when the element doesn't match.
-    for (auto it = _list.begin(); it != _list.end();) {
-        if (!func(*it)) {
+    std::vector<WaiterType> ready;
+    for (auto groupIt = _groups.begin(); groupIt != _groups.end();) {
+        auto& waiters = groupIt->second;
+        auto it = waiters.begin();
+        while (it != waiters.end() && func(it->second)) {
+            ready.push_back(it->second);
             ++it;
-            continue;
         }
+        waiters.erase(waiters.begin(), it);
 
-        WaiterType waiter = std::move(*it);
-        if (it == std::prev(_list.end())) {
-            // Iterator will be invalid after erasing the last element, so set it to the
-            // next one (i.e. end()).
-            it = _list.erase(it);
+        if (waiters.empty()) {
+            groupIt = _groups.erase(groupIt);
         } else {
-            // Iterator is still valid after pop_back().
-            std::swap(*it, _list.back());
-            _list.pop_back();
+            ++groupIt;
         }
+    }
 
-        // It's important to call notify() after the waiter has been removed from the list
-        // since notify() might remove the waiter itself.
+    // It's important to call notify() after the waiters have been removed from the list
+    // since notify() might remove the waiter itself.
+    for (auto& waiter : ready) {
         waiter->notify_inlock();
     }
 }
 
 void ReplicationCoordinatorImpl::WaiterList::signalAndRemoveAll_inlock() {
-    std::vector<WaiterType> list = std::move(_list);
+    auto groups = std::move(_groups);
+    _groups.clear();
     // Call notify() after removing the waiters from the list.
-    for (auto& waiter : list) {
-        waiter->notify_inlock();
+    for (auto& group : groups) {
+        for (auto& waiter : group.second) {
+            waiter.second->notify_inlock();
+        }
+    }
+}
+
+OpTime ReplicationCoordinatorImpl::WaiterList::earliestOpTime_inlock() const {
+    OpTime earliest;
+    for (const auto& group : _groups) {
+        const OpTime& opTime = group.second.begin()->first;
+        if (earliest.isNull() || opTime < earliest) {
+            earliest = opTime;
+        }
     }
+    return earliest;
 }
 
 bool ReplicationCoordinatorImpl::WaiterList::remove_inlock(WaiterType waiter) {
-    auto it = std::find(_list.begin(), _list.end(), waiter);
-    if (it == _list.end()) {
+    auto groupIt = _groups.find(Group(waiter->writeConcern));
+    if (groupIt == _groups.end()) {
         return false;
     }
-    std::swap(*it, _list.back());
-    _list.pop_back();
-    return true;
+
+    auto& waiters = groupIt->second;
+    auto range = waiters.equal_range(waiter->opTime);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == waiter) {
+            waiters.erase(it);
+            if (waiters.empty()) {
+                _groups.erase(groupIt);
+            }
+            return true;
+        }
+    }
+    return false;
 }
 
 namespace {
@@ -805,6 +874,7 @@ void ReplicationCoordinatorImpl::shutdown(OperationContext* opCtx) {
         }
         _replicationWaiterList.signalAndRemoveAll_inlock();
         _opTimeWaiterList.signalAndRemoveAll_inlock();
+        _updateEarliestReadWaiterTimestamp_inlock();
         _currentCommittedSnapshotCond.notify_all();
         _initialSyncer.swap(initialSyncerCopy);
         _stepDownWaiters.notify_all();
@@ -1123,8 +1193,9 @@ void ReplicationCoordinatorImpl::_setMyLastAppliedOpTime_inlock(const OpTime& op
     }
 
     // Signal anyone waiting on optime changes.
-    _opTimeWaiterList.signalAndRemoveIf_inlock(
+    _opTimeWaiterList.signalAndRemoveReady_inlock(
         [opTime](Waiter* waiter) { return waiter->opTime <= opTime; });
+    _updateEarliestReadWaiterTimestamp_inlock();
 
 
     // Note that master-slave mode has no automatic fail over, and so rollbacks never occur.
@@ -1288,6 +1359,7 @@ Status ReplicationCoordinatorImpl::_waitUntilOpTime(OperationContext* opCtx,
         stdx::condition_variable condVar;
         ThreadWaiter waiter(targetOpTime, nullptr, &condVar);
         WaiterGuard guard(&_opTimeWaiterList, &waiter);
+        _updateEarliestReadWaiterTimestamp_inlock();
 
         LOG(3) << "waitUntilOpTime: OpID " << opCtx->getOpID() << " is waiting for OpTime "
                << waiter << " until " << opCtx->getDeadline();
@@ -1340,6 +1412,15 @@ Status ReplicationCoordinatorImpl::_waitUntilOpTimeForReadDeprecated(
     return _waitUntilOpTime(opCtx, isMajorityReadConcern, targetOpTime);
 }
 
+Timestamp ReplicationCoordinatorImpl::getEarliestReadWaiterTimestamp() const {
+    return Timestamp(_earliestReadWaiterTimestamp.load());
+}
+
+void ReplicationCoordinatorImpl::_updateEarliestReadWaiterTimestamp_inlock() {
+    const auto earliest = _opTimeWaiterList.earliestOpTime_inlock();
+    _earliestReadWaiterTimestamp.store(earliest.getTimestamp().asULL());
+}
+
 OpTime ReplicationCoordinatorImpl::_getMyLastAppliedOpTime_inlock() const {
     return _topCoord->getMyLastAppliedOpTime();
 }
@@ -2088,6 +2169,12 @@ Status ReplicationCoordinatorImpl::processReplSetGetStatus(
             initialSyncProgress},
         response,
         &result);
+
+    if (result.isOK()) {
+        BSONObjBuilder heartbeatStats(response->subobjStart("heartbeatStats"));
+        _heartbeatRequestStats.append("requests", &heartbeatStats);
+        _heartbeatResponseStats.append("responses", &heartbeatStats);
+    }
     return result;
 }
 
@@ -2590,6 +2677,7 @@ ReplicationCoordinatorImpl::_updateMemberStateFromTopologyCoordinator_inlock(
         _replicationWaiterList.signalAndRemoveAll_inlock();
         // Wake up the optime waiter that is waiting for primary catch-up to finish.
         _opTimeWaiterList.signalAndRemoveAll_inlock();
+        _updateEarliestReadWaiterTimestamp_inlock();
         // If there are any pending stepdown command requests wake them up.
         _stepDownWaiters.notify_all();
 
@@ -2975,7 +3063,7 @@ ReplicationCoordinatorImpl::_setCurrentRSConfig_inlock(OperationContext* opCtx,
 }
 
 void ReplicationCoordinatorImpl::_wakeReadyWaiters_inlock() {
-    _replicationWaiterList.signalAndRemoveIf_inlock([this](Waiter* waiter) {
+    _replicationWaiterList.signalAndRemoveReady_inlock([this](Waiter* waiter) {
         return _doneWaitingForReplication_inlock(
             waiter->opTime, Timestamp(), *waiter->writeConcern);
     });
@@ -3427,16 +3515,19 @@ bool ReplicationCoordinatorImpl::getWriteConcernMajorityShouldJournal_inlock() c
 
 Status ReplicationCoordinatorImpl::processHeartbeatV1(const ReplSetHeartbeatArgsV1& args,
                                                       ReplSetHeartbeatResponse* response) {
-    {
-        stdx::lock_guard<stdx::mutex> lock(_mutex);
-        if (_rsConfigState == kConfigPreStart || _rsConfigState == kConfigStartingUp) {
-            return Status(ErrorCodes::NotYetInitialized,
-                          "Received heartbeat while still initializing replication system");
-        }
+    Timer timer;
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    const Microseconds mutexWait(timer.micros());
+    ON_BLOCK_EXIT([&] {
+        _heartbeatRequestStats.record(mutexWait, Microseconds(timer.micros()) - mutexWait);
+    });
+
+    if (_rsConfigState == kConfigPreStart || _rsConfigState == kConfigStartingUp) {
+        return Status(ErrorCodes::NotYetInitialized,
+                      "Received heartbeat while still initializing replication system");
     }
 
     Status result(ErrorCodes::InternalError, "didn't set status in prepareHeartbeatResponse");
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
 
     auto senderHost(args.getSenderHost());
     const Date_t now = _replExecutor->now();
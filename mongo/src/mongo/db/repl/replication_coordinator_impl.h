@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -167,6 +168,8 @@ public:
     virtual OpTime getMyLastAppliedOpTime() const override;
     virtual OpTime getMyLastDurableOpTime() const override;
 
+    virtual Timestamp getEarliestReadWaiterTimestamp() const override;
+
     virtual Status waitUntilOpTimeForReadUntil(OperationContext* opCtx,
                                                const ReadConcernArgs& readConcern,
                                                boost::optional<Date_t> deadline) override;
@@ -514,6 +517,26 @@ private:
 
     class WaiterGuard;
 
+    // Latency of handling heartbeats, split into the time spent waiting for _mutex and the time
+    // spent processing once it is held. Updated and read without holding _mutex.
+    class HeartbeatLatencyStats {
+    public:
+        void record(Microseconds mutexWait, Microseconds processing);
+        void append(StringData fieldName, BSONObjBuilder* builder) const;
+
+    private:
+        AtomicInt64 _count;
+        AtomicInt64 _totalMutexWaitMicros;
+        AtomicInt64 _maxMutexWaitMicros;
+        AtomicInt64 _totalProcessingMicros;
+        AtomicInt64 _maxProcessingMicros;
+    };
+
+    // Waiters are grouped by the parts of their write concern that decide which members have to
+    // reach the opTime, and kept in opTime order within each group. Since a member that has
+    // reached some opTime has also reached every earlier one, whether a waiter is done is
+    // monotonic in its opTime within a group, so finding the waiters to wake only needs to look
+    // at the ones being woken plus the first one in each group that is not.
     class WaiterList {
     public:
         using WaiterType = Waiter*;
@@ -522,13 +545,29 @@ private:
         void add_inlock(WaiterType waiter);
         // Returns whether waiter is found and removed.
         bool remove_inlock(WaiterType waiter);
-        // Signals and removes all waiters that satisfy the condition.
-        void signalAndRemoveIf_inlock(stdx::function<bool(WaiterType)> fun);
+        // Signals and removes, in each group, the waiters in opTime order up to the first one
+        // that does not satisfy the condition. The condition must be monotonic: if it holds for
+        // a waiter it must hold for every earlier waiter in the same group.
+        void signalAndRemoveReady_inlock(stdx::function<bool(WaiterType)> fun);
         // Signals and removes all waiters from the list.
         void signalAndRemoveAll_inlock();
+        // Returns the earliest optime waited for, or a null OpTime if the list is empty.
+        OpTime earliestOpTime_inlock() const;
 
     private:
-        std::vector<WaiterType> _list;
+        // The parts of a write concern which determine whether it is satisfied at an opTime.
+        // Waiters without a write concern all share the default group.
+        struct Group {
+            explicit Group(const WriteConcernOptions* writeConcern);
+            bool operator<(const Group& other) const;
+
+            bool hasWriteConcern = false;
+            std::string wMode;
+            int wNumNodes = 0;
+            WriteConcernOptions::SyncMode syncMode = WriteConcernOptions::SyncMode::UNSET;
+        };
+
+        std::map<Group, std::multimap<OpTime, WaiterType>> _groups;
     };
 
     typedef std::vector<executor::TaskExecutor::CallbackHandle> HeartbeatHandles;
@@ -1202,6 +1241,16 @@ private:
     // Does *not* own the WaiterInfos.
     WaiterList _opTimeWaiterList;  // (M)
 
+    // The timestamp of the earliest optime in _opTimeWaiterList, or 0, for oplog application to
+    // read without taking _mutex. Brought up to date whenever a reader starts waiting and whenever
+    // waiters are signaled, so it may briefly name a waiter that has already timed out.
+    AtomicUInt64 _earliestReadWaiterTimestamp;  // (S)
+
+    /**
+     * Publishes the earliest optime in _opTimeWaiterList to _earliestReadWaiterTimestamp.
+     */
+    void _updateEarliestReadWaiterTimestamp_inlock();
+
     // Set to true when we are in the process of shutting down replication.
     bool _inShutdown;  // (M)
 
@@ -1362,6 +1411,10 @@ private:
     // This variable must be written immediately after _term, and thus its value can lag.
     // Reading this value does not require the replication coordinator mutex to be locked.
     AtomicInt64 _termShadow;  // (S)
+
+    // Latency of answering heartbeats from other members and of handling the responses to ours.
+    HeartbeatLatencyStats _heartbeatRequestStats;   // (S)
+    HeartbeatLatencyStats _heartbeatResponseStats;  // (S)
 };
 
 }  // namespace repl
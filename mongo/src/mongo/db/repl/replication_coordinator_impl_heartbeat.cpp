@@ -58,6 +58,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace repl {
@@ -138,30 +139,37 @@ void ReplicationCoordinatorImpl::_scheduleHeartbeatToTarget_inlock(const HostAnd
 
 void ReplicationCoordinatorImpl::_handleHeartbeatResponse(
     const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData, int targetIndex) {
+    // Parse the response before taking _mutex so that the time it is held for doesn't depend on
+    // the size of the response. At the end of this step, if responseStatus is OK then hbResponse
+    // is valid.
+    Status responseStatus = cbData.response.status;
+    const HostAndPort& target = cbData.request.target;
+    const bool receivedResponse = responseStatus.isOK();
+
+    ReplSetHeartbeatResponse hbResponse;
+    BSONObj resp;
+    StatusWith<rpc::ReplSetMetadata> replMetadata(ErrorCodes::NoSuchKey,
+                                                  "no heartbeat response received");
+    if (receivedResponse) {
+        resp = cbData.response.data;
+        responseStatus = hbResponse.initialize(resp, _termShadow.load());
+        replMetadata = rpc::ReplSetMetadata::readFromMetadata(cbData.response.metadata);
+    }
+
+    Timer timer;
     stdx::unique_lock<stdx::mutex> lk(_mutex);
+    const Microseconds mutexWait(timer.micros());
 
     // remove handle from queued heartbeats
     _untrackHeartbeatHandle_inlock(cbData.myHandle);
 
-    // Parse and validate the response.  At the end of this step, if responseStatus is OK then
-    // hbResponse is valid.
-    Status responseStatus = cbData.response.status;
-    const HostAndPort& target = cbData.request.target;
-
     if (responseStatus == ErrorCodes::CallbackCanceled) {
         LOG_FOR_HEARTBEATS(2) << "Received response to heartbeat (requestId: " << cbData.request.id
                               << ") from " << target << " but the heartbeat was cancelled.";
         return;
     }
 
-    ReplSetHeartbeatResponse hbResponse;
-    BSONObj resp;
-    if (responseStatus.isOK()) {
-        resp = cbData.response.data;
-        responseStatus = hbResponse.initialize(resp, _topCoord->getTerm());
-        StatusWith<rpc::ReplSetMetadata> replMetadata =
-            rpc::ReplSetMetadata::readFromMetadata(cbData.response.metadata);
-
+    if (receivedResponse) {
         LOG_FOR_HEARTBEATS(2) << "Received response to heartbeat (requestId: " << cbData.request.id
                               << ") from " << target << ", " << resp;
 
@@ -245,7 +253,9 @@ void ReplicationCoordinatorImpl::_handleHeartbeatResponse(
     _scheduleHeartbeatToTarget_inlock(
         target, targetIndex, std::max(now, action.getNextHeartbeatStartDate()));
 
-    _handleHeartbeatResponseAction_inlock(action, hbStatusResponse, std::move(lk));
+    lk = _handleHeartbeatResponseAction_inlock(action, hbStatusResponse, std::move(lk));
+
+    _heartbeatResponseStats.record(mutexWait, Microseconds(timer.micros()) - mutexWait);
 }
 
 stdx::unique_lock<stdx::mutex> ReplicationCoordinatorImpl::_handleHeartbeatResponseAction_inlock(
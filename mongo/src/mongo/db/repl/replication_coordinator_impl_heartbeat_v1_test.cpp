@@ -344,6 +344,54 @@ TEST_F(ReplCoordHBV1Test,
     assertMemberState(MemberState::RS_RECOVERING, "0");
 }
 
+TEST_F(ReplCoordHBV1Test, ReplSetGetStatusReportsHeartbeatLatencyStats) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version"
+                            << 1
+                            << "members"
+                            << BSON_ARRAY(BSON("_id" << 1 << "host"
+                                                     << "node1:12345")
+                                          << BSON("_id" << 2 << "host"
+                                                        << "node2:12345"))
+                            << "protocolVersion"
+                            << 1),
+                       HostAndPort("node1", 12345));
+    ASSERT_OK(getReplCoord()->setFollowerMode(MemberState::RS_SECONDARY));
+
+    // Answer a heartbeat from node2.
+    ReplSetHeartbeatArgsV1 hbArgs;
+    hbArgs.setConfigVersion(1);
+    hbArgs.setSetName("mySet");
+    hbArgs.setSenderHost(HostAndPort("node2", 12345));
+    hbArgs.setSenderId(2);
+    hbArgs.setTerm(0);
+    ReplSetHeartbeatResponse hbResp;
+    ASSERT_OK(getReplCoord()->processHeartbeatV1(hbArgs, &hbResp));
+
+    // Handle the response to our heartbeat to node2.
+    enterNetwork();
+    const NetworkInterfaceMock::NetworkOperationIterator noi = getNet()->getNextReadyRequest();
+    ASSERT_EQUALS(HostAndPort("node2", 12345), noi->getRequest().target);
+    getNet()->scheduleResponse(noi,
+                               getNet()->now(),
+                               makeResponseStatus(BSON("ok" << 0.0 << "errmsg"
+                                                            << "unauth'd"
+                                                            << "code"
+                                                            << ErrorCodes::Unauthorized)));
+    getNet()->runReadyNetworkOperations();
+    exitNetwork();
+
+    BSONObjBuilder statusBuilder;
+    ASSERT_OK(getReplCoord()->processReplSetGetStatus(
+        &statusBuilder, ReplicationCoordinator::ReplSetGetStatusResponseStyle::kBasic));
+    auto heartbeatStats = statusBuilder.obj()["heartbeatStats"].Obj();
+    ASSERT_EQUALS(1LL, heartbeatStats["requests"]["count"].numberLong());
+    ASSERT_EQUALS(1LL, heartbeatStats["responses"]["count"].numberLong());
+    ASSERT_GREATER_THAN_OR_EQUALS(heartbeatStats["responses"]["maxProcessingMicros"].numberLong(),
+                                  0LL);
+}
+
 TEST_F(ReplCoordHBV1Test, IgnoreTheContentsOfMetadataWhenItsReplicaSetIdDoesNotMatchOurs) {
     // Tests that a secondary node will not update its committed optime from the heartbeat metadata
     // if the replica set ID is inconsistent with the existing configuration.
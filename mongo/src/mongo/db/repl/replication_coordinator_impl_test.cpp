@@ -1137,6 +1137,81 @@ TEST_F(ReplCoordTest, NodeReturnsOkWhenAWriteConcernWithNoTimeoutHasBeenSatisfie
     awaiter.reset();
 }
 
+TEST_F(ReplCoordTest, NodeWakesOnlyTheWaitersWhoseWriteConcernHasBeenSatisfied) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version"
+                            << 2
+                            << "members"
+                            << BSON_ARRAY(BSON("host"
+                                               << "node1:12345"
+                                               << "_id"
+                                               << 0)
+                                          << BSON("host"
+                                                  << "node2:12345"
+                                                  << "_id"
+                                                  << 1)
+                                          << BSON("host"
+                                                  << "node3:12345"
+                                                  << "_id"
+                                                  << 2))),
+                       HostAndPort("node1", 12345));
+    ASSERT_OK(getReplCoord()->setFollowerMode(MemberState::RS_SECONDARY));
+    getReplCoord()->setMyLastAppliedOpTime(OpTimeWithTermOne(100, 0));
+    getReplCoord()->setMyLastDurableOpTime(OpTimeWithTermOne(100, 0));
+    simulateSuccessfulV1Election();
+
+    OpTimeWithTermOne time1(100, 1);
+    OpTimeWithTermOne time2(100, 2);
+    OpTimeWithTermOne time3(100, 3);
+    getReplCoord()->setMyLastAppliedOpTime(time3);
+    getReplCoord()->setMyLastDurableOpTime(time3);
+
+    WriteConcernOptions twoNodes;
+    twoNodes.wTimeout = WriteConcernOptions::kNoTimeout;
+    twoNodes.wNumNodes = 2;
+    WriteConcernOptions threeNodes = twoNodes;
+    threeNodes.wNumNodes = 3;
+
+    // Waiters registered out of opTime order, in two write concern groups.
+    ReplicationAwaiter twoNodesTime3(getReplCoord(), getServiceContext());
+    twoNodesTime3.setOpTime(time3);
+    twoNodesTime3.setWriteConcern(twoNodes);
+    twoNodesTime3.start();
+
+    ReplicationAwaiter twoNodesTime1(getReplCoord(), getServiceContext());
+    twoNodesTime1.setOpTime(time1);
+    twoNodesTime1.setWriteConcern(twoNodes);
+    twoNodesTime1.start();
+
+    ReplicationAwaiter twoNodesTime2(getReplCoord(), getServiceContext());
+    twoNodesTime2.setOpTime(time2);
+    twoNodesTime2.setWriteConcern(twoNodes);
+    twoNodesTime2.start();
+
+    ReplicationAwaiter threeNodesTime1(getReplCoord(), getServiceContext());
+    threeNodesTime1.setOpTime(time1);
+    threeNodesTime1.setWriteConcern(threeNodes);
+    threeNodesTime1.start();
+
+    // Only the two node waiters up to time2 are satisfied. A waiter which was woken too early
+    // would be dropped from the waiter list and never return.
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time2));
+    ASSERT_OK(twoNodesTime1.getResult().status);
+    ASSERT_OK(twoNodesTime2.getResult().status);
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time3));
+    ASSERT_OK(twoNodesTime3.getResult().status);
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 2, time1));
+    ASSERT_OK(threeNodesTime1.getResult().status);
+
+    twoNodesTime1.reset();
+    twoNodesTime2.reset();
+    twoNodesTime3.reset();
+    threeNodesTime1.reset();
+}
+
 TEST_F(ReplCoordTest, NodeReturnsWriteConcernFailedWhenAWriteConcernTimesOutBeforeBeingSatisified) {
     assertStartSuccess(BSON("_id"
                             << "mySet"
@@ -4315,6 +4390,40 @@ TEST_F(ReplCoordTest, ReadAfterCommittedDeferredEqualOpTime) {
     pseudoLogOp.get();
 }
 
+TEST_F(ReplCoordTest, ReadAfterOpTimePublishesEarliestReadWaiterTimestamp) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version"
+                            << 2
+                            << "members"
+                            << BSON_ARRAY(BSON("host"
+                                               << "node1:12345"
+                                               << "_id"
+                                               << 0))),
+                       HostAndPort("node1", 12345));
+    auto opCtx = makeOperationContext();
+    runSingleNodeElection(opCtx.get());
+    getReplCoord()->setMyLastAppliedOpTime(OpTime(Timestamp(10, 0), 1));
+    getReplCoord()->setMyLastDurableOpTime(OpTime(Timestamp(10, 0), 1));
+    ASSERT_EQUALS(Timestamp(), getReplCoord()->getEarliestReadWaiterTimestamp());
+
+    OpTime opTimeToWait(Timestamp(100, 0), 1);
+
+    auto pseudoLogOp = stdx::async(stdx::launch::async, [this, &opTimeToWait]() {
+        // Only apply the awaited optime once the waiter has been published.
+        while (getReplCoord()->getEarliestReadWaiterTimestamp() != opTimeToWait.getTimestamp()) {
+            sleepmillis(1);
+        }
+        getReplCoord()->setMyLastAppliedOpTime(opTimeToWait);
+        getReplCoord()->setMyLastDurableOpTime(opTimeToWait);
+    });
+
+    ASSERT_OK(getReplCoord()->waitUntilOpTimeForRead(
+        opCtx.get(), ReadConcernArgs(opTimeToWait, ReadConcernLevel::kLocalReadConcern)));
+    pseudoLogOp.get();
+    ASSERT_EQUALS(Timestamp(), getReplCoord()->getEarliestReadWaiterTimestamp());
+}
+
 TEST_F(ReplCoordTest, IgnoreTheContentsOfMetadataWhenItsConfigVersionDoesNotMatchOurs) {
     // Ensure that we do not process ReplSetMetadata when ConfigVersions do not match.
     assertStartSuccess(BSON("_id"
@@ -221,6 +221,10 @@ OpTime ReplicationCoordinatorMock::getMyLastAppliedOpTime() const {
     return _myLastAppliedOpTime;
 }
 
+Timestamp ReplicationCoordinatorMock::getEarliestReadWaiterTimestamp() const {
+    return Timestamp();
+}
+
 OpTime ReplicationCoordinatorMock::getMyLastDurableOpTime() const {
     return _myLastDurableOpTime;
 }
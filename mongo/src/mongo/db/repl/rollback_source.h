@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/db/jsobj.h"
@@ -88,6 +90,15 @@ public:
                                                               UUID uuid,
                                                               const BSONObj& filter) const = 0;
 
+    /**
+     * Fetch the documents with the given _id values from the sync source using the UUID, in as
+     * few round trips as possible. Returns one document per _id, in the same order as 'ids', with
+     * an empty document for each _id that does not exist on the sync source. Returns the
+     * namespace matching the UUID on the sync source as well.
+     */
+    virtual std::pair<std::vector<BSONObj>, NamespaceString> findByUUID(
+        const std::string& db, UUID uuid, const std::vector<BSONElement>& ids) const = 0;
+
     /**
      * Clones a single collection from the sync source.
      */
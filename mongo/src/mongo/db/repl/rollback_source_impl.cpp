@@ -30,6 +30,7 @@
 
 #include "mongo/db/repl/rollback_source_impl.h"
 
+#include "mongo/bson/bsonelement_comparator.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/cloner.h"
 #include "mongo/db/jsobj.h"
@@ -79,6 +80,66 @@ std::pair<BSONObj, NamespaceString> RollbackSourceImpl::findOneByUUID(const std:
     return _getConnection()->findOneByUUID(db, uuid, filter);
 }
 
+std::pair<std::vector<BSONObj>, NamespaceString> RollbackSourceImpl::findByUUID(
+    const std::string& db, UUID uuid, const std::vector<BSONElement>& ids) const {
+    BSONObjBuilder cmdBuilder;
+    uuid.appendToBuilder(&cmdBuilder, "find");
+    {
+        BSONObjBuilder filterBuilder(cmdBuilder.subobjStart("filter"));
+        BSONObjBuilder idBuilder(filterBuilder.subobjStart("_id"));
+        BSONArrayBuilder inBuilder(idBuilder.subarrayStart("$in"));
+        for (auto&& id : ids) {
+            inBuilder.append(id);
+        }
+    }
+    const BSONObj cmd = cmdBuilder.obj();
+
+    // The documents may not fit in a single batch, so follow the cursor until it is exhausted.
+    std::vector<BSONObj> found;
+    NamespaceString resNss;
+    BSONObj res;
+    uassert(50805,
+            str::stream() << "find command using UUID failed. Command: " << cmd << " Result: "
+                          << res,
+            _getConnection()->runCommand(db, cmd, res, QueryOption_SlaveOk));
+    BSONObj cursorObj = res.getObjectField("cursor");
+    resNss = NamespaceString(cursorObj["ns"].valueStringData());
+    for (auto&& doc : cursorObj.getObjectField("firstBatch")) {
+        found.push_back(doc.Obj().getOwned());
+    }
+    auto cursorId = cursorObj["id"].numberLong();
+    while (cursorId) {
+        const BSONObj getMoreCmd = BSON("getMore" << cursorId << "collection" << resNss.coll());
+        uassert(50806,
+                str::stream() << "getMore command using UUID failed. Command: " << getMoreCmd
+                              << " Result: "
+                              << res,
+                _getConnection()->runCommand(db, getMoreCmd, res, QueryOption_SlaveOk));
+        cursorObj = res.getObjectField("cursor");
+        for (auto&& doc : cursorObj.getObjectField("nextBatch")) {
+            found.push_back(doc.Obj().getOwned());
+        }
+        cursorId = cursorObj["id"].numberLong();
+    }
+
+    // Match the documents with the _id values that were asked for, the same way rollback
+    // compares document ids.
+    const StringData::ComparatorInterface* stringComparator = nullptr;
+    BSONElementComparator eltCmp(BSONElementComparator::FieldNamesMode::kIgnore, stringComparator);
+    auto foundById = eltCmp.makeBSONEltIndexedMap<BSONObj>();
+    for (auto&& doc : found) {
+        foundById.emplace(doc["_id"], doc);
+    }
+
+    std::vector<BSONObj> docs;
+    docs.reserve(ids.size());
+    for (auto&& id : ids) {
+        auto it = foundById.find(id);
+        docs.push_back(it == foundById.end() ? BSONObj() : it->second);
+    }
+    return {std::move(docs), resNss};
+}
+
 void RollbackSourceImpl::copyCollectionFromRemote(OperationContext* opCtx,
                                                   const NamespaceString& nss) const {
     std::string errmsg;
@@ -31,6 +31,7 @@
 #include "mongo/db/repl/rollback_test_fixture.h"
 
 #include <string>
+#include <tuple>
 
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/database_holder.h"
@@ -205,6 +206,19 @@ std::pair<BSONObj, NamespaceString> RollbackSourceMock::findOneByUUID(const std:
     return {BSONObj(), NamespaceString()};
 }
 
+std::pair<std::vector<BSONObj>, NamespaceString> RollbackSourceMock::findByUUID(
+    const std::string& db, UUID uuid, const std::vector<BSONElement>& ids) const {
+    // Fetch one document at a time so tests can intercept each fetch through findOneByUUID().
+    std::vector<BSONObj> docs;
+    NamespaceString nss;
+    for (auto&& id : ids) {
+        BSONObj doc;
+        std::tie(doc, nss) = findOneByUUID(db, uuid, id.wrap());
+        docs.push_back(doc);
+    }
+    return {std::move(docs), nss};
+}
+
 void RollbackSourceMock::copyCollectionFromRemote(OperationContext* opCtx,
                                                   const NamespaceString& nss) const {}
 
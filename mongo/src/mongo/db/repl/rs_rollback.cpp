@@ -68,6 +68,7 @@
 #include "mongo/db/repl/rollback_source.h"
 #include "mongo/db/repl/rslog.h"
 #include "mongo/db/s/shard_identity_rollback_notifier.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/session_catalog.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
@@ -88,6 +89,9 @@ namespace repl {
 
 using namespace rollback_internal;
 
+// The most documents of one collection refetched from the sync source in a single round trip.
+MONGO_EXPORT_SERVER_PARAMETER(rollbackRefetchBatchSize, int, 1000);
+
 bool DocID::operator<(const DocID& other) const {
     int comp = uuid.toString().compare(other.uuid.toString());
     if (comp < 0)
@@ -991,22 +995,32 @@ void rollback_internal::syncFixUp(OperationContext* opCtx,
 
     log() << "Starting refetching documents";
 
-    for (auto&& doc : fixUpInfo.docsToRefetch) {
-        invariant(!doc._id.eoo());  // This is checked when we insert to the set.
-
-        UUID uuid = doc.uuid;
+    // Documents to refetch are ordered by collection, so each batch is made of the next run of
+    // documents from a single collection.
+    const size_t batchSize = std::max(1, rollbackRefetchBatchSize.load());
+    for (auto docIt = fixUpInfo.docsToRefetch.begin(); docIt != fixUpInfo.docsToRefetch.end();) {
+        UUID uuid = docIt->uuid;
         NamespaceString nss = catalog.lookupNSSByUUID(uuid);
 
+        std::vector<const DocID*> batch;
+        std::vector<BSONElement> ids;
+        for (; docIt != fixUpInfo.docsToRefetch.end() && docIt->uuid == uuid &&
+             batch.size() < batchSize;
+             ++docIt) {
+            invariant(!docIt->_id.eoo());  // This is checked when we insert to the set.
+            batch.push_back(&*docIt);
+            ids.push_back(docIt->_id);
+        }
+
         try {
-            LOG(2) << "Refetching document, collection: " << nss << ", UUID: " << uuid << ", "
-                   << redact(doc._id);
-            // TODO : Slow. Lots of round trips.
-            numFetched++;
+            LOG(2) << "Refetching " << ids.size() << " documents, collection: " << nss
+                   << ", UUID: " << uuid << ", first _id: " << redact(ids.front());
+            numFetched += ids.size();
 
-            BSONObj good;
+            std::vector<BSONObj> goods;
             NamespaceString resNss;
-            std::tie(good, resNss) =
-                rollbackSource.findOneByUUID(nss.db().toString(), uuid, doc._id.wrap());
+            std::tie(goods, resNss) = rollbackSource.findByUUID(nss.db().toString(), uuid, ids);
+            invariant(goods.size() == batch.size());
 
             // To prevent inconsistencies in the transactions collection, rollback fails if the UUID
             // of the collection is different on the sync source than on the node rolling back,
@@ -1023,17 +1037,20 @@ void rollback_internal::syncFixUp(OperationContext* opCtx,
                        "resync is required.");
             }
 
-            totalSize += good.objsize();
+            for (size_t i = 0; i < batch.size(); ++i) {
+                const auto& good = goods[i];
+                totalSize += good.objsize();
 
-            // Checks that the total amount of data that needs to be refetched is at most
-            // 300 MB. We do not roll back more than 300 MB of documents in order to
-            // prevent out of memory errors from too much data being stored. See SERVER-23392.
-            if (totalSize >= 300 * 1024 * 1024) {
-                throw RSFatalException("replSet too much data to roll back.");
-            }
+                // Checks that the total amount of data that needs to be refetched is at most
+                // 300 MB. We do not roll back more than 300 MB of documents in order to
+                // prevent out of memory errors from too much data being stored. See SERVER-23392.
+                if (totalSize >= 300 * 1024 * 1024) {
+                    throw RSFatalException("replSet too much data to roll back.");
+                }
 
-            // Note good might be empty, indicating we should delete it.
-            goodVersions[uuid].insert(std::pair<DocID, BSONObj>(doc, good));
+                // Note good might be empty, indicating we should delete it.
+                goodVersions[uuid].insert(std::pair<DocID, BSONObj>(*batch[i], good));
+            }
 
         } catch (const DBException& ex) {
             // If the collection turned into a view, we might get an error trying to
@@ -1042,9 +1059,9 @@ void rollback_internal::syncFixUp(OperationContext* opCtx,
             if (ex.code() == ErrorCodes::CommandNotSupportedOnView)
                 continue;
 
-            log() << "Rollback couldn't re-fetch from uuid: " << uuid << " _id: " << redact(doc._id)
-                  << ' ' << numFetched << '/' << fixUpInfo.docsToRefetch.size() << ": "
-                  << redact(ex);
+            log() << "Rollback couldn't re-fetch from uuid: " << uuid
+                  << " _id: " << redact(ids.front()) << " and " << ids.size() - 1 << " more "
+                  << numFetched << '/' << fixUpInfo.docsToRefetch.size() << ": " << redact(ex);
             throw;
         }
     }
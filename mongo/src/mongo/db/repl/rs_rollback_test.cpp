@@ -2218,6 +2218,55 @@ TEST_F(RSRollbackTest, LocalEntryWithTxnNumberAddsTransactionTableDocToBeRefetch
     ASSERT_TRUE(fui.docsToRefetch.find(expectedTxnDoc) != fui.docsToRefetch.end());
 }
 
+TEST_F(RSRollbackTest, SyncFixUpRefetchesDocumentsOfEachCollectionInOneBatch) {
+    createOplog(_opCtx.get());
+
+    FixUpInfo fui;
+    UUID uuid1 = UUID::gen();
+    UUID uuid2 = UUID::gen();
+    for (int i = 0; i < 5; i++) {
+        auto entry = BSON("ts" << Timestamp(Seconds(2), i) << "t" << 1LL << "h" << 1LL << "op"
+                               << "i"
+                               << "ui"
+                               << (i < 3 ? uuid1 : uuid2)
+                               << "ns"
+                               << "test.t"
+                               << "o"
+                               << BSON("_id" << i << "a" << 1));
+        ASSERT_OK(updateFixUpInfoFromLocalOplogEntry(fui, entry, false));
+    }
+    ASSERT_EQ(fui.docsToRefetch.size(), 5U);
+
+    auto commonOperation =
+        std::make_pair(BSON("ts" << Timestamp(Seconds(1), 0) << "h" << 1LL), RecordId(1));
+    fui.commonPoint = OpTime(Timestamp(Seconds(1), 0), 1LL);
+    fui.commonPointOurDiskloc = RecordId(1);
+    fui.rbid = 1;
+
+    class RollbackSourceLocal : public RollbackSourceMock {
+    public:
+        RollbackSourceLocal(std::unique_ptr<OplogInterface> oplog)
+            : RollbackSourceMock(std::move(oplog)) {}
+        std::pair<std::vector<BSONObj>, NamespaceString> findByUUID(
+            const std::string& db, UUID uuid, const std::vector<BSONElement>& ids) const override {
+            batchSizes[uuid.toString()] = ids.size();
+            return {std::vector<BSONObj>(ids.size()), NamespaceString("test.t")};
+        }
+        int getRollbackId() const override {
+            return 1;
+        }
+        mutable std::map<std::string, size_t> batchSizes;
+    };
+
+    RollbackSourceLocal rollbackSource(
+        std::unique_ptr<OplogInterface>(new OplogInterfaceMock({commonOperation})));
+    syncFixUp(_opCtx.get(), fui, rollbackSource, _coordinator, _replicationProcess.get());
+
+    ASSERT_EQ(2U, rollbackSource.batchSizes.size());
+    ASSERT_EQ(3U, rollbackSource.batchSizes[uuid1.toString()]);
+    ASSERT_EQ(2U, rollbackSource.batchSizes[uuid2.toString()]);
+}
+
 TEST_F(RSRollbackTest, RollbackFailsIfTransactionDocumentRefetchReturnsDifferentNamespace) {
     createOplog(_opCtx.get());
 
@@ -73,13 +73,17 @@
 #include "mongo/db/session_txn_record_gen.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/db/storage/recovery_unit.h"
+#include "mongo/db/storage/snapshot_manager.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/socket_exception.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -140,6 +144,38 @@ public:
     }
 } exportedBatchLimitOperationsParam;
 
+/**
+ * When enabled, an operation whose conflict key (namespace, plus _id for doc-locking engines) has
+ * not been seen earlier in the batch is handed to the least loaded writer rather than to the writer
+ * selected by 'hash % numWriters'. Operations that share a conflict key always land on the same
+ * writer, so their relative order is preserved either way.
+ */
+MONGO_EXPORT_SERVER_PARAMETER(replWriterDependencyAwareAssignment, bool, true);
+
+/**
+ * When enabled, the number of operations per batch is chosen by an OplogBatchSizeController from
+ * the observed apply time of previous batches, bounded above by 'replBatchLimitOperations'.
+ */
+MONGO_EXPORT_SERVER_PARAMETER(replBatchAdaptiveSizing, bool, false);
+
+// Apply time per batch that the adaptive batch sizing tries to stay under.
+MONGO_EXPORT_SERVER_PARAMETER(replBatchTargetApplyMillis, int, 200);
+
+/**
+ * When enabled, a batch ends at the first operation at or after the earliest optime a reader is
+ * waiting for (e.g. a causally consistent read with afterClusterTime), so that the reader is
+ * released once that shorter batch is applied rather than after a full batch.
+ */
+MONGO_EXPORT_SERVER_PARAMETER(replBatchEndAtReadWaiterOpTime, bool, true);
+
+// Number of threads that prefetch the pages needed by the next batch while the current one is being
+// applied. Zero disables this. MMAPv1 always prefetches each batch before applying it instead.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replPrefetchNextBatchThreadCount, int, 0);
+
+// Hangs batch application after the ops of a batch are applied, while still holding the
+// ParallelBatchWriterMode lock.
+MONGO_FP_DECLARE(hangAfterApplyingBatchOps);
+
 // The oplog entries applied
 Counter64 opsAppliedStats;
 ServerStatusMetricField<Counter64> displayOpsApplied("repl.apply.ops", &opsAppliedStats);
@@ -153,6 +189,24 @@ ServerStatusMetricField<Counter64> displayAttemptsToBecomeSecondary(
 TimerStats applyBatchStats;
 ServerStatusMetricField<TimerStats> displayOpBatchesApplied("repl.apply.batches", &applyBatchStats);
 
+// Number of operations the batcher is currently aiming for in each batch. This is a gauge, which
+// is set rather than incremented, so it is displayed by its own metric instead of a Counter64.
+AtomicInt64 batchSizeTarget;
+
+class BatchSizeTargetMetric final : public ServerStatusMetric {
+public:
+    BatchSizeTargetMetric() : ServerStatusMetric("repl.apply.batchSizeTarget") {}
+
+    void appendAtLeaf(BSONObjBuilder& b) const final {
+        b.append(_leafName, batchSizeTarget.load());
+    }
+} displayBatchSizeTarget;
+
+// Number of batches ended early because a reader was waiting for an optime in them.
+Counter64 batchesEndedForReaders;
+ServerStatusMetricField<Counter64> displayBatchesEndedForReaders(
+    "repl.apply.batchesEndedForReaders", &batchesEndedForReaders);
+
 void initializePrefetchThread() {
     if (!Client::getCurrent()) {
         Client::initThreadIfNotAlready();
@@ -437,6 +491,10 @@ void prefetchOp(const BSONObj& op) {
             // for multiple prefetches if they are for the same database.
             const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
             OperationContext& opCtx = *opCtxPtr;
+
+            // Prefetching only warms the cache, so it needn't wait for batch application. It is
+            // either run by the applier itself or concurrently with a batch that holds the PBWM.
+            opCtx.lockState()->setShouldConflictWithSecondaryBatchApplication(false);
             AutoGetCollectionForReadCommand ctx(&opCtx, NamespaceString(ns));
             Database* db = ctx.getDb();
             if (db) {
@@ -500,6 +558,7 @@ void scheduleWritesToOplog(OperationContext* opCtx,
             const auto opCtxHolder = cc().makeOperationContext();
             const auto opCtx = opCtxHolder.get();
             opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
+            opCtx->lockState()->setShouldAcquireTicket(false);
             UnreplicatedWritesBlock uwb(opCtx);
 
             std::vector<InsertStatement> docs;
@@ -558,6 +617,7 @@ void scheduleTxnTableUpdates(OperationContext* opCtx,
             const auto opCtxHolder = cc().makeOperationContext();
             const auto opCtx = opCtxHolder.get();
             opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
+            opCtx->lockState()->setShouldAcquireTicket(false);
 
             Session::updateSessionRecordOnSecondary(opCtx, record);
         });
@@ -623,6 +683,41 @@ private:
     StringMap<CollectionProperties> _cache;
 };
 
+/**
+ * Tracks which writer owns each conflict key seen so far in a batch. The first operation with a
+ * given key goes to the writer with the fewest operations; every later operation with the same key
+ * follows it so that dependent operations are applied in oplog order by a single thread. Keys are
+ * the 32-bit hashes computed in fillWriterVectorsAndLatestSessionRecords(), so a hash collision can
+ * only add serialization, never remove it.
+ */
+class WriterAssignment {
+public:
+    explicit WriterAssignment(uint32_t numWriters) : _opsPerWriter(numWriters, 0) {}
+
+    uint32_t assign(uint32_t conflictKey) {
+        auto it = _owners.find(conflictKey);
+        if (it == _owners.end()) {
+            it = _owners.emplace(conflictKey, _leastLoadedWriter()).first;
+        }
+        ++_opsPerWriter[it->second];
+        return it->second;
+    }
+
+private:
+    uint32_t _leastLoadedWriter() const {
+        uint32_t best = 0;
+        for (uint32_t i = 1; i < _opsPerWriter.size(); ++i) {
+            if (_opsPerWriter[i] < _opsPerWriter[best]) {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    std::vector<size_t> _opsPerWriter;
+    stdx::unordered_map<uint32_t, uint32_t> _owners;
+};
+
 /**
  * ops - This only modifies the isForCappedCollection field on each op. It does not alter the ops
  *      vector in any other way.
@@ -641,8 +736,10 @@ void fillWriterVectorsAndLatestSessionRecords(
 
     const bool supportsDocLocking = storageEngine->supportsDocLocking();
     const uint32_t numWriters = writerVectors->size();
+    const bool dependencyAware = replWriterDependencyAwareAssignment.load() && numWriters > 1;
 
     CachedCollectionProperties collPropertiesCache;
+    WriterAssignment writerAssignment(numWriters);
 
     for (auto&& op : *ops) {
         StringMapTraits::HashedKey hashedNs(op.getNamespace().ns());
@@ -690,7 +787,8 @@ void fillWriterVectorsAndLatestSessionRecords(
             }
         }
 
-        auto& writer = (*writerVectors)[hash % numWriters];
+        auto& writer = (*writerVectors)[dependencyAware ? writerAssignment.assign(hash)
+                                                        : hash % numWriters];
         if (writer.empty()) {
             writer.reserve(8);  // Skip a few growth rounds
         }
@@ -772,7 +870,8 @@ class SyncTail::OpQueueBatcher {
     MONGO_DISALLOW_COPYING(OpQueueBatcher);
 
 public:
-    OpQueueBatcher(SyncTail* syncTail) : _syncTail(syncTail), _thread([this] { run(); }) {}
+    OpQueueBatcher(SyncTail* syncTail)
+        : _syncTail(syncTail), _prefetcherPool(_makePrefetcherPool()), _thread([this] { run(); }) {}
     ~OpQueueBatcher() {
         invariant(_isDead);
         _thread.join();
@@ -823,6 +922,32 @@ private:
         return fastClockSource->now() - slaveDelay;
     }
 
+    /**
+     * Returns the pool that prefetches each batch while the previous one is being applied, or
+     * nullptr if that is disabled.
+     */
+    static std::unique_ptr<OldThreadPool> _makePrefetcherPool() {
+        if (replPrefetchNextBatchThreadCount <= 0 ||
+            getGlobalServiceContext()->getGlobalStorageEngine()->isMmapV1()) {
+            return nullptr;
+        }
+        return stdx::make_unique<OldThreadPool>(replPrefetchNextBatchThreadCount,
+                                                "repl prefetch worker ");
+    }
+
+    /**
+     * Pages in the documents and index entries 'ops' will touch, without waiting for the batch
+     * currently being applied.
+     */
+    void _prefetchBatch(const OpQueue& ops) {
+        // Let the prefetches of the previous batch finish first so that we never fall further
+        // behind than one batch.
+        _prefetcherPool->join();
+        for (auto&& op : ops.getBatch()) {
+            _prefetcherPool->schedule(&prefetchOp, op.raw);
+        }
+    }
+
     void run() {
         Client::initThread("ReplBatcher");
 
@@ -834,6 +959,10 @@ private:
 
             // Check this once per batch since users can change it at runtime.
             batchLimits.ops = replBatchLimitOperations.load();
+            if (replBatchAdaptiveSizing.load()) {
+                batchLimits.ops = _syncTail->_batchSizeController.getTargetOps(batchLimits.ops);
+            }
+            batchSizeTarget.store(static_cast<long long>(batchLimits.ops));
 
             OpQueue ops;
             // tryPopAndWaitForMore adds to ops and returns true when we need to end a batch early.
@@ -847,6 +976,10 @@ private:
                 continue;  // Don't emit empty batches.
             }
 
+            if (_prefetcherPool && !ops.empty()) {
+                _prefetchBatch(ops);
+            }
+
             stdx::unique_lock<stdx::mutex> lk(_mutex);
             // Block until the previous batch has been taken.
             _cv.wait(lk, [&] { return _ops.empty(); });
@@ -861,6 +994,8 @@ private:
 
     SyncTail* const _syncTail;
 
+    const std::unique_ptr<OldThreadPool> _prefetcherPool;
+
     stdx::mutex _mutex;  // Guards _ops.
     stdx::condition_variable _cv;
     OpQueue _ops;
@@ -951,9 +1086,26 @@ void SyncTail::oplogApplication(ReplicationCoordinator* replCoord) {
 
         // Apply the operations in this batch. 'multiApply' returns the optime of the last op that
         // was applied, which should be the last optime in the batch.
+        const auto numOpsInBatch = ops.getCount();
+        Timer batchTimer;
         auto lastOpTimeAppliedInBatch = multiApply(&opCtx, ops.releaseBatch());
         invariant(lastOpTimeAppliedInBatch == lastOpTimeInBatch);
 
+        if (replBatchAdaptiveSizing.load()) {
+            _batchSizeController.recordBatch(numOpsInBatch,
+                                             Milliseconds(batchTimer.millis()),
+                                             Milliseconds(replBatchTargetApplyMillis.load()),
+                                             _networkQueue->getBufferFillRatio());
+        }
+
+        // The whole batch is now visible, so reads on this secondary which don't conflict with
+        // batch application may move up to it. This must happen before our last applied optime
+        // advances so that reads waiting for that optime observe its writes.
+        if (auto snapshotManager =
+                opCtx.getServiceContext()->getGlobalStorageEngine()->getSnapshotManager()) {
+            snapshotManager->setLocalSnapshot(lastOpTimeInBatch.getTimestamp());
+        }
+
         // In order to provide resilience in the event of a crash in the middle of batch
         // application, 'multiApply' will update 'minValid' so that it is at least as great as the
         // last optime that it applied in this batch. If 'minValid' was moved forward, we make sure
@@ -1069,6 +1221,14 @@ bool SyncTail::tryPopAndWaitForMore(OperationContext* opCtx,
     // We are going to apply this Op.
     _networkQueue->consume(opCtx);
 
+    if (replBatchEndAtReadWaiterOpTime.load()) {
+        const auto waitedFor = ReplicationCoordinator::get(opCtx)->getEarliestReadWaiterTimestamp();
+        if (!waitedFor.isNull() && entry.getTimestamp() >= waitedFor) {
+            batchesEndedForReaders.increment();
+            return true;
+        }
+    }
+
     // Go back for more ops, unless we've hit the limit.
     return ops->getCount() >= limits.ops;
 }
@@ -1238,6 +1398,7 @@ Status multiSyncApply_noAbort(OperationContext* opCtx,
 
     // Allow us to get through the magic barrier.
     opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
+    opCtx->lockState()->setShouldAcquireTicket(false);
 
     // Sort the oplog entries by namespace, so that entries from the same namespace will be next to
     // each other in the list.
@@ -1432,6 +1593,7 @@ Status multiInitialSyncApply_noAbort(OperationContext* opCtx,
 
     // allow us to get through the magic barrier
     opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
+    opCtx->lockState()->setShouldAcquireTicket(false);
 
     for (auto it = ops->begin(); it != ops->end(); ++it) {
         auto& entry = **it;
@@ -1560,6 +1722,14 @@ StatusWith<OpTime> multiApply(OperationContext* opCtx,
         applyOps(writerVectors, workerPool, applyOperation, &statusVector);
         workerPool->join();
 
+        if (MONGO_FAIL_POINT(hangAfterApplyingBatchOps)) {
+            log() << "batch application - hangAfterApplyingBatchOps fail point enabled. "
+                     "Blocking until fail point is disabled.";
+            while (MONGO_FAIL_POINT(hangAfterApplyingBatchOps)) {
+                mongo::sleepsecs(1);
+            }
+        }
+
         // Update the transaction table to point to the latest oplog entries for each session id.
         scheduleTxnTableUpdates(opCtx, workerPool, latestSessionRecords);
         workerPool->join();
@@ -35,6 +35,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/repl/multiapplier.h"
 #include "mongo/db/repl/oplog.h"
+#include "mongo/db/repl/oplog_batch_size_controller.h"
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/concurrency/old_thread_pool.h"
@@ -243,6 +244,10 @@ private:
 
     // persistent pool of worker threads for writing ops to the databases
     std::unique_ptr<OldThreadPool> _writerPool;
+
+    // Picks the operation count of each batch when 'replBatchAdaptiveSizing' is enabled.
+    OplogBatchSizeController _batchSizeController{
+        static_cast<size_t>(replBatchLimitOperations.load())};
 };
 
 /**
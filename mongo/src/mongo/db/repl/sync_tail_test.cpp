@@ -574,6 +574,53 @@ TEST_F(SyncTailTest, MultiApplyAssignsOperationsToWriterThreadsBasedOnNamespaceH
     ASSERT_BSONOBJ_EQ(op2.raw, operationsWrittenToOplog[1].doc);
 }
 
+TEST_F(SyncTailTest, MultiApplyKeepsConflictingOperationsOnOneWriterAndBalancesTheRest) {
+    NamespaceString nss1("test.t0");
+    NamespaceString nss2("test.t1");
+    NamespaceString nss3("test.t2");
+    OldThreadPool writerPool(2);
+
+    stdx::mutex mutex;
+    std::vector<MultiApplier::Operations> operationsApplied;
+    auto applyOperationFn = [&mutex, &operationsApplied](
+        MultiApplier::OperationPtrs* operationsForWriterThreadToApply) -> Status {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        operationsApplied.emplace_back();
+        for (auto&& opPtr : *operationsForWriterThreadToApply) {
+            operationsApplied.back().push_back(*opPtr);
+        }
+        return Status::OK();
+    };
+
+    // The storage engine used by this fixture does not support document locking, so every
+    // operation on a namespace conflicts with every other operation on that namespace.
+    auto op1 = makeInsertDocumentOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss1, BSON("x" << 1));
+    auto op2 = makeInsertDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL}, nss2, BSON("x" << 2));
+    auto op3 = makeInsertDocumentOplogEntry({Timestamp(Seconds(3), 0), 1LL}, nss1, BSON("x" << 3));
+    auto op4 = makeInsertDocumentOplogEntry({Timestamp(Seconds(4), 0), 1LL}, nss3, BSON("x" << 4));
+
+    _storageInterface->insertDocumentsFn =
+        [](OperationContext*, const NamespaceString&, const std::vector<InsertStatement>&) {
+            return Status::OK();
+        };
+
+    auto lastOpTime = unittest::assertGet(
+        multiApply(_opCtx.get(), &writerPool, {op1, op2, op3, op4}, applyOperationFn));
+    ASSERT_EQUALS(op4.getOpTime(), lastOpTime);
+
+    stdx::lock_guard<stdx::mutex> lock(mutex);
+    ASSERT_EQUALS(2U, operationsApplied.size());
+    for (auto&& operationsAppliedByThread : operationsApplied) {
+        ASSERT_EQUALS(2U, operationsAppliedByThread.size());
+        if (operationsAppliedByThread.front() == op1) {
+            ASSERT_TRUE(operationsAppliedByThread.back() == op3);
+        } else {
+            ASSERT_TRUE(operationsAppliedByThread.front() == op2);
+            ASSERT_TRUE(operationsAppliedByThread.back() == op4);
+        }
+    }
+}
+
 TEST_F(SyncTailTest, MultiApplyUpdatesTheTransactionTable) {
     // Set up the transactions collection, which can only be done by the primary.
     ASSERT_OK(ReplicationCoordinator::get(_opCtx.get())->setFollowerMode(MemberState::RS_PRIMARY));
@@ -35,35 +35,59 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/migration_session_id.h"
 #include "mongo/db/s/migration_source_manager.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
 
+MONGO_EXPORT_SERVER_PARAMETER(maxConcurrentMigrationsPerShard, int, 1);
+
+namespace {
+
+/**
+ * Returns the current value of maxConcurrentMigrationsPerShard, clamped to the supported range.
+ */
+int getMaxConcurrentMigrations() {
+    return std::max(1,
+                    std::min(maxConcurrentMigrationsPerShard.load(),
+                             ActiveMigrationsRegistry::kMaxConcurrentMigrations));
+}
+
+}  // namespace
+
+constexpr int ActiveMigrationsRegistry::kMaxConcurrentMigrations;
+
 ActiveMigrationsRegistry::ActiveMigrationsRegistry() = default;
 
 ActiveMigrationsRegistry::~ActiveMigrationsRegistry() {
-    invariant(!_activeMoveChunkState);
+    invariant(_activeMoveChunkStates.empty());
 }
 
 //ShardingState::registerDonateChunk
 StatusWith<ScopedRegisterDonateChunk> ActiveMigrationsRegistry::registerDonateChunk(
     const MoveChunkRequest& args) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    if (_activeReceiveChunkState) {
-        return _activeReceiveChunkState->constructErrorStatus();
+    if (!_activeReceiveChunkStates.empty()) {
+        return _activeReceiveChunkStates.begin()->second.constructErrorStatus();
     }
 
-    if (_activeMoveChunkState) {
-        if (_activeMoveChunkState->args == args) {
-            return {ScopedRegisterDonateChunk(nullptr, false, _activeMoveChunkState->notification)};
+    auto it = _activeMoveChunkStates.find(args.getNss());
+    if (it != _activeMoveChunkStates.end()) {
+        if (it->second.args == args) {
+            return {ScopedRegisterDonateChunk(
+                nullptr, false, it->second.notification, args.getNss())};
         }
 
-        return _activeMoveChunkState->constructErrorStatus();
+        return it->second.constructErrorStatus();
     }
 
-    _activeMoveChunkState.emplace(args);
+    if (_activeMoveChunkStates.size() >= static_cast<size_t>(getMaxConcurrentMigrations())) {
+        return _activeMoveChunkStates.begin()->second.constructErrorStatus();
+    }
 
-    return {ScopedRegisterDonateChunk(this, true, _activeMoveChunkState->notification)};
+    it = _activeMoveChunkStates.emplace(args.getNss(), ActiveMoveChunkState(args)).first;
+
+    return {ScopedRegisterDonateChunk(this, true, it->second.notification, args.getNss())};
 }
 
 //ShardingState::registerReceiveChunkã
@@ -71,50 +95,50 @@ StatusWith<ScopedRegisterDonateChunk> ActiveMigrationsRegistry::registerDonateCh
 StatusWith<ScopedRegisterReceiveChunk> ActiveMigrationsRegistry::registerReceiveChunk(
     const NamespaceString& nss, const ChunkRange& chunkRange, const ShardId& fromShardId) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    if (_activeReceiveChunkState) { //յµ_recvChunkStartʼǨchunkʱҪǷѾǨchunk
-        return _activeReceiveChunkState->constructErrorStatus();
+    if (!_activeMoveChunkStates.empty()) {
+        return _activeMoveChunkStates.begin()->second.constructErrorStatus();
+    }
+
+    const int maxConcurrentMigrations = getMaxConcurrentMigrations();
+    if (_activeReceiveChunkStates.size() >= static_cast<size_t>(maxConcurrentMigrations)) {
+        return _activeReceiveChunkStates.begin()->second.constructErrorStatus();
     }
 
-	//˵ǰǨ飬ӡʾ
-    if (_activeMoveChunkState) {
-        return _activeMoveChunkState->constructErrorStatus();
+    // Take the lowest free slot. Slots above the current limit may still be held by receive
+    // operations, which started before it was lowered.
+    int slot = 0;
+    while (_activeReceiveChunkStates.count(slot)) {
+        slot++;
     }
+    invariant(slot < kMaxConcurrentMigrations);
 
-	//¼ǰǨƵchunkϢ_activeReceiveChunkStateյµ_recvChunkStartʼǨchunkʱҪǷѾǨchunk
-    _activeReceiveChunkState.emplace(nss, chunkRange, fromShardId);
+    _activeReceiveChunkStates.emplace(slot, ActiveReceiveChunkState(nss, chunkRange, fromShardId));
 
-    return {ScopedRegisterReceiveChunk(this)};
+    return {ScopedRegisterReceiveChunk(this, slot)};
 }
 
-boost::optional<NamespaceString> ActiveMigrationsRegistry::getActiveDonateChunkNss() {
+std::vector<NamespaceString> ActiveMigrationsRegistry::getActiveDonateChunkNamespaces() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    if (_activeMoveChunkState) {
-        return _activeMoveChunkState->args.getNss();
+
+    std::vector<NamespaceString> namespaces;
+    for (const auto& activeMoveChunkState : _activeMoveChunkStates) {
+        namespaces.push_back(activeMoveChunkState.first);
     }
 
-    return boost::none;
+    return namespaces;
 }
 
 ////ShardingServerStatus::generateSection
 BSONObj ActiveMigrationsRegistry::getActiveMigrationStatusReport(OperationContext* opCtx) {
-    boost::optional<NamespaceString> nss;
-    {
-        stdx::lock_guard<stdx::mutex> lk(_mutex);
-
-        if (_activeMoveChunkState) {
-            nss = _activeMoveChunkState->args.getNss();
-        }
-    }
-
-    // The state of the MigrationSourceManager could change between taking and releasing the mutex
-    // above and then taking the collection lock here, but that's fine because it isn't important to
+    // The state of the MigrationSourceManagers could change between taking and releasing the mutex
+    // and then taking the collection lock here, but that's fine because it isn't important to
     // return information on a migration that just ended or started. This is just best effort and
     // desireable for reporting, and then diagnosing, migrations that are stuck.
-    if (nss) {
+    for (const auto& nss : getActiveDonateChunkNamespaces()) {
         // Lock the collection so nothing changes while we're getting the migration report.
-        AutoGetCollection autoColl(opCtx, nss.get(), MODE_IS);
+        AutoGetCollection autoColl(opCtx, nss, MODE_IS);
 
-        auto css = CollectionShardingState::get(opCtx, nss.get());
+        auto css = CollectionShardingState::get(opCtx, nss);
         if (css && css->getMigrationSourceManager()) {
             return css->getMigrationSourceManager()->getMigrationStatusReport();
         }
@@ -123,16 +147,14 @@ BSONObj ActiveMigrationsRegistry::getActiveMigrationStatusReport(OperationContex
     return BSONObj();
 }
 
-void ActiveMigrationsRegistry::_clearDonateChunk() {
+void ActiveMigrationsRegistry::_clearDonateChunk(const NamespaceString& nss) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    invariant(_activeMoveChunkState);
-    _activeMoveChunkState.reset();
+    invariant(_activeMoveChunkStates.erase(nss));
 }
 
-void ActiveMigrationsRegistry::_clearReceiveChunk() {
+void ActiveMigrationsRegistry::_clearReceiveChunk(int slot) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    invariant(_activeReceiveChunkState);
-    _activeReceiveChunkState.reset();
+    invariant(_activeReceiveChunkStates.erase(slot));
 }
 
 //ʾǰǨĳ
@@ -161,16 +183,18 @@ Status ActiveMigrationsRegistry::ActiveReceiveChunkState::constructErrorStatus()
 ScopedRegisterDonateChunk::ScopedRegisterDonateChunk(
     ActiveMigrationsRegistry* registry,
     bool forUnregister,
-    std::shared_ptr<Notification<Status>> completionNotification)
+    std::shared_ptr<Notification<Status>> completionNotification,
+    NamespaceString nss)
     : _registry(registry),
       _forUnregister(forUnregister),
-      _completionNotification(std::move(completionNotification)) {}
+      _completionNotification(std::move(completionNotification)),
+      _nss(std::move(nss)) {}
 
 ScopedRegisterDonateChunk::~ScopedRegisterDonateChunk() {
     if (_registry && _forUnregister) {
         // If this is a newly started migration the caller must always signal on completion
         invariant(*_completionNotification);
-        _registry->_clearDonateChunk();
+        _registry->_clearDonateChunk(_nss);
     }
 }
 
@@ -184,6 +208,7 @@ ScopedRegisterDonateChunk& ScopedRegisterDonateChunk::operator=(ScopedRegisterDo
         other._registry = nullptr;
         _forUnregister = other._forUnregister;
         _completionNotification = std::move(other._completionNotification);
+        _nss = std::move(other._nss);
     }
 
     return *this;
@@ -199,12 +224,13 @@ Status ScopedRegisterDonateChunk::waitForCompletion(OperationContext* opCtx) {
     return _completionNotification->get(opCtx);
 }
 
-ScopedRegisterReceiveChunk::ScopedRegisterReceiveChunk(ActiveMigrationsRegistry* registry)
-    : _registry(registry) {}
+ScopedRegisterReceiveChunk::ScopedRegisterReceiveChunk(ActiveMigrationsRegistry* registry,
+                                                       int slot)
+    : _registry(registry), _slot(slot) {}
 
 ScopedRegisterReceiveChunk::~ScopedRegisterReceiveChunk() {
     if (_registry) {
-        _registry->_clearReceiveChunk();
+        _registry->_clearReceiveChunk(_slot);
     }
 }
 
@@ -217,6 +243,7 @@ ScopedRegisterReceiveChunk& ScopedRegisterReceiveChunk::operator=(
     if (&other != this) {
         _registry = other._registry;
         other._registry = nullptr;
+        _slot = other._slot;
     }
 
     return *this;
@@ -29,9 +29,12 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <map>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/s/migration_session_id.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/move_chunk_request.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
@@ -45,21 +48,30 @@ class ScopedRegisterReceiveChunk;
 template <typename T>
 class StatusWith;
 
+// How many chunks a shard may donate or receive at the same time. A shard never donates and
+// receives at the same time and donates at most one chunk of any collection at a time.
+extern AtomicInt32 maxConcurrentMigrationsPerShard;
+
 /**
  * Thread-safe object, which keeps track of the active migrations running on a node and limits them
- * to only one per-shard. There is only one instance of this object per shard.
+ * to maxConcurrentMigrationsPerShard per-shard. There is only one instance of this object per
+ * shard.
  */ //ScopedRegisterReceiveChunk._registry  ScopedRegisterDonateChunk._registryΪ
 class ActiveMigrationsRegistry {
     MONGO_DISALLOW_COPYING(ActiveMigrationsRegistry);
 
 public:
+    // Upper bound of maxConcurrentMigrationsPerShard, which is the number of receive slots
+    static constexpr int kMaxConcurrentMigrations = 16;
+
     ActiveMigrationsRegistry();
     ~ActiveMigrationsRegistry();
 
     /**
-     * If there are no migrations running on this shard, registers an active migration with the
-     * specified arguments and returns a ScopedRegisterDonateChunk, which must be signaled by the
-     * caller before it goes out of scope.
+     * If this shard is not receiving any chunks, is not donating a chunk of the same collection and
+     * has fewer than maxConcurrentMigrationsPerShard donations running, registers an active
+     * migration with the specified arguments and returns a ScopedRegisterDonateChunk, which must be
+     * signaled by the caller before it goes out of scope.
      *
      * If there is an active migration already running on this shard and it has the exact same
      * arguments, returns a ScopedRegisterDonateChunk, which can be used to join the already running
@@ -70,9 +82,11 @@ public:
     StatusWith<ScopedRegisterDonateChunk> registerDonateChunk(const MoveChunkRequest& args);
 
     /**
-     * If there are no migrations running on this shard, registers an active receive operation with
-     * the specified session id and returns a ScopedRegisterReceiveChunk, which will unregister it
-     * when it goes out of scope.
+     * If this shard is not donating any chunks and has fewer than maxConcurrentMigrationsPerShard
+     * receive operations running, registers an active receive operation with the specified
+     * arguments and returns a ScopedRegisterReceiveChunk, which will unregister it when it goes out
+     * of scope. Each concurrent receive operation is given a distinct slot in the range
+     * [0, kMaxConcurrentMigrations).
      *
      * Otherwise returns a ConflictingOperationInProgress error.
      */
@@ -81,16 +95,16 @@ public:
                                                                 const ShardId& fromShardId);
 
     /**
-     * If a migration has been previously registered through a call to registerDonateChunk returns
-     * that namespace. Otherwise returns boost::none.
+     * Returns the namespaces of the migrations, which have been previously registered through a
+     * call to registerDonateChunk and are still active.
      */
-    boost::optional<NamespaceString> getActiveDonateChunkNss();
+    std::vector<NamespaceString> getActiveDonateChunkNamespaces();
 
     /**
-     * Returns a report on the active migration if there currently is one. Otherwise, returns an
+     * Returns a report on an active migration if there currently is one. Otherwise, returns an
      * empty BSONObj.
      *
-     * Takes an IS lock on the namespace of the active migration, if one is active.
+     * Takes an IS lock on the namespace of the reported migration, if one is active.
      */
     BSONObj getActiveMigrationStatusReport(OperationContext* opCtx);
 
@@ -139,29 +153,27 @@ private:
      * Unregisters a previously registered namespace with ongoing migration. Must only be called if
      * a previous call to registerDonateChunk has succeeded.
      */
-    void _clearDonateChunk();
+    void _clearDonateChunk(const NamespaceString& nss);
 
     /**
      * Unregisters a previously registered incoming migration. Must only be called if a previous
      * call to registerReceiveChunk has succeeded.
      */
-    void _clearReceiveChunk();
+    void _clearReceiveChunk(int slot);
 
     // Protects the state below
     stdx::mutex _mutex;
 
-    // If there is an active moveChunk operation going on, this field contains the request, which
-    // initiated it
+    // Contains the request of each active moveChunk operation, keyed by its namespace
     //
     //ԴƬյmongos͹moveChunkԴƬǨ״̬֤ԴƬͬһʱÿֻǨһchunk
     //οShardingState::registerDonateChunk
-    boost::optional<ActiveMoveChunkState> _activeMoveChunkState;
+    std::map<NamespaceString, ActiveMoveChunkState> _activeMoveChunkStates;
 
-    // If there is an active receive of a chunk going on, this field contains the session id, which
-    // initiated it
+    // Contains the state of each active receive of a chunk, keyed by the slot it was assigned
     //¼ǰǨƵchunkϢ_activeReceiveChunkStateյµ_recvChunkStartʼǨchunk
     //ʱҪǷѾǨchunk֤ͬһʱͬһֻǨһchunk飬ActiveMigrationsRegistry::registerReceiveChunk
-    boost::optional<ActiveReceiveChunkState> _activeReceiveChunkState;
+    std::map<int, ActiveReceiveChunkState> _activeReceiveChunkStates;
 };
 
 /**
@@ -175,7 +187,8 @@ class ScopedRegisterDonateChunk {
 public:
     ScopedRegisterDonateChunk(ActiveMigrationsRegistry* registry,
                               bool forUnregister,
-                              std::shared_ptr<Notification<Status>> completionNotification);
+                              std::shared_ptr<Notification<Status>> completionNotification,
+                              NamespaceString nss);
     ~ScopedRegisterDonateChunk();
 
     ScopedRegisterDonateChunk(ScopedRegisterDonateChunk&&);
@@ -212,6 +225,9 @@ private:
 
     // This is the future, which will be signaled at the end of a migration
     std::shared_ptr<Notification<Status>> _completionNotification;
+
+    // Namespace of the migration, under which it is registered
+    NamespaceString _nss;
 };
 
 /**
@@ -222,16 +238,26 @@ class ScopedRegisterReceiveChunk {
     MONGO_DISALLOW_COPYING(ScopedRegisterReceiveChunk);
 
 public:
-    ScopedRegisterReceiveChunk(ActiveMigrationsRegistry* registry);
+    ScopedRegisterReceiveChunk(ActiveMigrationsRegistry* registry, int slot);
     ~ScopedRegisterReceiveChunk();
 
     ScopedRegisterReceiveChunk(ScopedRegisterReceiveChunk&&);
     ScopedRegisterReceiveChunk& operator=(ScopedRegisterReceiveChunk&&);
 
+    /**
+     * Returns the slot, which the registry assigned to this receive operation.
+     */
+    int getSlot() const {
+        return _slot;
+    }
+
 private:
     // Registry from which to unregister the migration. Not owned.
     
     ActiveMigrationsRegistry* _registry;
+
+    // Slot of the receive operation within the registry
+    int _slot{0};
 };
 
 }  // namespace mongo
@@ -35,6 +35,7 @@
 #include "mongo/db/service_context_noop.h"
 #include "mongo/s/move_chunk_request.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -99,14 +100,16 @@ TEST_F(MoveChunkRegistration, ScopedRegisterDonateChunkMoveConstructorAndAssignm
 }
 
 TEST_F(MoveChunkRegistration, GetActiveMigrationNamespace) {
-    ASSERT(!_registry.getActiveDonateChunkNss());
+    ASSERT(_registry.getActiveDonateChunkNamespaces().empty());
 
     const NamespaceString nss("TestDB", "TestColl");
 
     auto originalScopedRegisterDonateChunk =
         assertGet(_registry.registerDonateChunk(createMoveChunkRequest(nss)));
 
-    ASSERT_EQ(nss.ns(), _registry.getActiveDonateChunkNss()->ns());
+    const auto namespaces = _registry.getActiveDonateChunkNamespaces();
+    ASSERT_EQ(1U, namespaces.size());
+    ASSERT_EQ(nss.ns(), namespaces[0].ns());
 
     // Need to signal the registered migration so the destructor doesn't invariant
     originalScopedRegisterDonateChunk.complete(Status::OK());
@@ -138,5 +141,51 @@ TEST_F(MoveChunkRegistration, SecondMigrationWithSameArgumentsJoinsFirst) {
               secondScopedRegisterDonateChunk.waitForCompletion(getTxn()));
 }
 
+TEST_F(MoveChunkRegistration, ConcurrentMigrationsOfDifferentCollectionsAreAllowedUpToLimit) {
+    maxConcurrentMigrationsPerShard.store(2);
+    ON_BLOCK_EXIT([] { maxConcurrentMigrationsPerShard.store(1); });
+
+    auto firstScopedRegisterDonateChunk = assertGet(_registry.registerDonateChunk(
+        createMoveChunkRequest(NamespaceString("TestDB", "TestColl1"))));
+    auto secondScopedRegisterDonateChunk = assertGet(_registry.registerDonateChunk(
+        createMoveChunkRequest(NamespaceString("TestDB", "TestColl2"))));
+    ASSERT(secondScopedRegisterDonateChunk.mustExecute());
+    ASSERT_EQ(2U, _registry.getActiveDonateChunkNamespaces().size());
+
+    ASSERT_EQ(ErrorCodes::ConflictingOperationInProgress,
+              _registry
+                  .registerDonateChunk(
+                      createMoveChunkRequest(NamespaceString("TestDB", "TestColl3")))
+                  .getStatus());
+
+    firstScopedRegisterDonateChunk.complete(Status::OK());
+    secondScopedRegisterDonateChunk.complete(Status::OK());
+}
+
+TEST_F(MoveChunkRegistration, ConcurrentReceivesAreAssignedDistinctSlots) {
+    maxConcurrentMigrationsPerShard.store(2);
+    ON_BLOCK_EXIT([] { maxConcurrentMigrationsPerShard.store(1); });
+
+    const NamespaceString nss("TestDB", "TestColl");
+
+    auto firstScopedRegisterReceiveChunk = assertGet(_registry.registerReceiveChunk(
+        nss, ChunkRange(BSON("Key" << -100), BSON("Key" << 0)), ShardId("shard0001")));
+    auto secondScopedRegisterReceiveChunk = assertGet(_registry.registerReceiveChunk(
+        nss, ChunkRange(BSON("Key" << 0), BSON("Key" << 100)), ShardId("shard0002")));
+    ASSERT_EQ(0, firstScopedRegisterReceiveChunk.getSlot());
+    ASSERT_EQ(1, secondScopedRegisterReceiveChunk.getSlot());
+
+    ASSERT_EQ(ErrorCodes::ConflictingOperationInProgress,
+              _registry
+                  .registerReceiveChunk(nss,
+                                        ChunkRange(BSON("Key" << 100), BSON("Key" << 200)),
+                                        ShardId("shard0003"))
+                  .getStatus());
+
+    // Donating is not allowed while receiving
+    ASSERT_EQ(ErrorCodes::ConflictingOperationInProgress,
+              _registry.registerDonateChunk(createMoveChunkRequest(nss)).getStatus());
+}
+
 }  // namespace
 }  // namespace mongo
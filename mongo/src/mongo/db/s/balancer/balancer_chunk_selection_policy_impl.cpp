@@ -37,6 +37,7 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj_comparator_interface.h"
+#include "mongo/s/balancer_configuration.h"
 #include "mongo/s/catalog/sharding_catalog_client.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/catalog/type_collection.h"
@@ -502,7 +503,12 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
         }
     }
 
-    return BalancerPolicy::balance(shardStats, distribution, aggressiveBalanceHint);
+    const auto balancerConfig = Grid::get(opCtx)->getBalancerConfiguration();
+
+    return BalancerPolicy::balance(shardStats,
+                                   distribution,
+                                   aggressiveBalanceHint,
+                                   balancerConfig->getMaxConcurrentMigrationsPerShard());
 }
 
 }  // namespace mongo
@@ -33,6 +33,7 @@
 #include "mongo/db/s/balancer/balancer_policy.h"
 
 #include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog/type_tags.h"
 #include "mongo/util/log.h"
@@ -46,6 +47,10 @@ using std::set;
 using std::string;
 using std::vector;
 
+MONGO_EXPORT_SERVER_PARAMETER(internalBalancerCostAwareBalancing, bool, false);
+MONGO_EXPORT_SERVER_PARAMETER(internalBalancerCostImbalanceRatio, double, 1.25);
+MONGO_EXPORT_SERVER_PARAMETER(internalBalancerMaxShardOpsPerSecondToMigrate, int, 0);
+
 namespace {
 
 // These values indicate the minimum deviation shard's number of chunks need to have from the
@@ -291,12 +296,13 @@ ShardId BalancerPolicy::_getMostOverloadedShard(const ShardStatisticsVector& sha
 
 vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardStats,
                                             const DistributionStatus& distribution,
-                                            bool shouldAggressivelyBalance) {
+                                            bool shouldAggressivelyBalance,
+                                            size_t maxMigrationsPerShard) {
     vector<MigrateInfo> migrations;
 
-    // Set of shards, which have already been used for migrations. Used so we don't return multiple
-    // migrations for the same shard.
-    set<ShardId> usedShards;
+    // Shards, which have already been used for migrations. Used so we don't return more migrations
+    // for the same shard than it can run at once.
+    UsedShards usedShards(maxMigrationsPerShard);
 
     // 1) Check for shards, which are in draining mode
     {
@@ -304,7 +310,7 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
             if (!stat.isDraining)
                 continue;
 
-            if (usedShards.count(stat.shardId))
+            if (usedShards.excludedDonors().count(stat.shardId))
                 continue;
 
             const vector<ChunkType>& chunks = distribution.getChunks(stat.shardId);
@@ -325,8 +331,8 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
 
                 const string tag = distribution.getTagForChunk(chunk);
 
-                const ShardId to =
-                    _getLeastLoadedReceiverShard(shardStats, distribution, tag, usedShards);
+                const ShardId to = _getLeastLoadedReceiverShard(
+                    shardStats, distribution, tag, usedShards.excludedReceivers());
                 if (!to.isValid()) {
                     if (migrations.empty()) {
                         warning() << "Chunk " << redact(chunk.toString())
@@ -337,8 +343,7 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
 
                 invariant(to != stat.shardId);
                 migrations.emplace_back(to, chunk);
-                invariant(usedShards.insert(stat.shardId).second);
-                invariant(usedShards.insert(to).second);
+                usedShards.add(stat.shardId, to);
                 break;
             }
 
@@ -352,7 +357,7 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
     // 2) Check for chunks, which are on the wrong shard and must be moved off of it
     if (!distribution.tags().empty()) {
         for (const auto& stat : shardStats) {
-            if (usedShards.count(stat.shardId))
+            if (usedShards.excludedDonors().count(stat.shardId))
                 continue;
 
             const vector<ChunkType>& chunks = distribution.getChunks(stat.shardId);
@@ -372,8 +377,8 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
                     continue;
                 }
 
-                const ShardId to =
-                    _getLeastLoadedReceiverShard(shardStats, distribution, tag, usedShards);
+                const ShardId to = _getLeastLoadedReceiverShard(
+                    shardStats, distribution, tag, usedShards.excludedReceivers());
                 if (!to.isValid()) {
                     if (migrations.empty()) {
                         warning() << "Chunk " << redact(chunk.toString()) << " violates zone "
@@ -384,8 +389,7 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
 
                 invariant(to != stat.shardId);
                 migrations.emplace_back(to, chunk);
-                invariant(usedShards.insert(stat.shardId).second);
-                invariant(usedShards.insert(to).second);
+                usedShards.add(stat.shardId, to);
                 break;
             }
         }
@@ -428,6 +432,17 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
             (totalNumberOfChunksWithTag / totalNumberOfShardsWithTag) +
             (totalNumberOfChunksWithTag % totalNumberOfShardsWithTag ? 1 : 0);
 
+        if (internalBalancerCostAwareBalancing.load()) {
+            while (_singleZoneCostBalance(shardStats,
+                                          distribution,
+                                          tag,
+                                          idealNumberOfChunksPerShardForTag,
+                                          &migrations,
+                                          &usedShards))
+                ;
+            continue;
+        }
+
         while (_singleZoneBalance(shardStats,
                                   distribution,
                                   tag,
@@ -462,8 +477,9 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
                                         size_t idealNumberOfChunksPerShardForTag,
                                         size_t imbalanceThreshold,
                                         vector<MigrateInfo>* migrations,
-                                        set<ShardId>* usedShards) {
-    const ShardId from = _getMostOverloadedShard(shardStats, distribution, tag, *usedShards);
+                                        UsedShards* usedShards) {
+    const ShardId from =
+        _getMostOverloadedShard(shardStats, distribution, tag, usedShards->excludedDonors());
     if (!from.isValid())
         return false;
 
@@ -473,7 +489,8 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     if (max <= idealNumberOfChunksPerShardForTag)
         return false;
 
-    const ShardId to = _getLeastLoadedReceiverShard(shardStats, distribution, tag, *usedShards);
+    const ShardId to = _getLeastLoadedReceiverShard(
+        shardStats, distribution, tag, usedShards->excludedReceivers());
     if (!to.isValid()) {
         if (migrations->empty()) {
             log() << "No available shards to take chunks for zone [" << tag << "]";
@@ -514,8 +531,7 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
         }
 
         migrations->emplace_back(to, chunk);
-        invariant(usedShards->insert(chunk.getShard()).second);
-        invariant(usedShards->insert(to).second);
+        usedShards->add(chunk.getShard(), to);
         return true;
     }
 
@@ -528,6 +544,126 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     return false;
 }
 
+bool BalancerPolicy::_singleZoneCostBalance(const ShardStatisticsVector& shardStats,
+                                            const DistributionStatus& distribution,
+                                            const string& tag,
+                                            size_t idealNumberOfChunksPerShardForTag,
+                                            vector<MigrateInfo>* migrations,
+                                            UsedShards* usedShards) {
+    vector<const ClusterStatistics::ShardStatistics*> zoneShards;
+    double totalSizeMB = 0;
+    double totalOpsPerSecond = 0;
+
+    for (const auto& stat : shardStats) {
+        if (!tag.empty() && !stat.shardTags.count(tag))
+            continue;
+
+        zoneShards.push_back(&stat);
+        totalSizeMB += stat.currSizeMB;
+        totalOpsPerSecond += stat.opsPerSecond;
+    }
+
+    if (zoneShards.size() < 2)
+        return false;
+
+    const double avgSizeMB = totalSizeMB / zoneShards.size();
+    const double avgOpsPerSecond = totalOpsPerSecond / zoneShards.size();
+
+    const auto costOf = [&](const ClusterStatistics::ShardStatistics& stat) {
+        return (avgSizeMB > 0 ? stat.currSizeMB / avgSizeMB : 0) +
+            (avgOpsPerSecond > 0 ? stat.opsPerSecond / avgOpsPerSecond : 0);
+    };
+
+    const ClusterStatistics::ShardStatistics* from = nullptr;
+    const ClusterStatistics::ShardStatistics* to = nullptr;
+    double maxCost = 0;
+    double minCost = numeric_limits<double>::max();
+
+    for (const auto* stat : zoneShards) {
+        const double cost = costOf(*stat);
+
+        if (cost > maxCost && !usedShards->excludedDonors().count(stat->shardId) &&
+            distribution.numberOfChunksInShardWithTag(stat->shardId, tag)) {
+            from = stat;
+            maxCost = cost;
+        }
+
+        if (cost < minCost && !usedShards->excludedReceivers().count(stat->shardId) &&
+            isShardSuitableReceiver(*stat, tag).isOK()) {
+            to = stat;
+            minCost = cost;
+        }
+    }
+
+    if (!from || !to || from == to)
+        return false;
+
+    LOG(1) << "collection : " << distribution.nss().ns();
+    LOG(1) << "zone       : " << tag;
+    LOG(1) << "donor      : " << from->shardId << " cost " << maxCost;
+    LOG(1) << "receiver   : " << to->shardId << " cost " << minCost;
+    LOG(1) << "ratio      : " << internalBalancerCostImbalanceRatio.load();
+
+    // Check whether it is necessary to balance within this zone
+    if (maxCost <= minCost * internalBalancerCostImbalanceRatio.load())
+        return false;
+
+    const int maxOpsPerSecond = internalBalancerMaxShardOpsPerSecondToMigrate.load();
+    if (maxOpsPerSecond > 0 &&
+        (from->opsPerSecond > maxOpsPerSecond || to->opsPerSecond > maxOpsPerSecond)) {
+        LOG(1) << "Deferring migration from " << from->shardId << " to " << to->shardId
+               << " for zone [" << tag << "] because one of them is serving more than "
+               << maxOpsPerSecond << " operations per second";
+        return false;
+    }
+
+    // Do not let a shard take on an unbounded number of chunks, even if they are small or idle
+    if (distribution.numberOfChunksInShardWithTag(to->shardId, tag) >=
+        2 * idealNumberOfChunksPerShardForTag)
+        return false;
+
+    const vector<ChunkType>& chunks = distribution.getChunks(from->shardId);
+
+    unsigned numJumboChunks = 0;
+
+    for (const auto& chunk : chunks) {
+        if (distribution.getTagForChunk(chunk) != tag)
+            continue;
+
+        if (chunk.getJumbo()) {
+            numJumboChunks++;
+            continue;
+        }
+
+        migrations->emplace_back(to->shardId, chunk);
+        usedShards->add(chunk.getShard(), to->shardId);
+        return true;
+    }
+
+    if (numJumboChunks) {
+        warning() << "Shard: " << from->shardId << ", collection: " << distribution.nss().ns()
+                  << " has only jumbo chunks for zone \'" << tag
+                  << "\' and cannot be balanced. Jumbo chunks count: " << numJumboChunks;
+    }
+
+    return false;
+}
+
+void BalancerPolicy::UsedShards::add(const ShardId& from, const ShardId& to) {
+    invariant(!_excludedDonors.count(from));
+    invariant(!_excludedReceivers.count(to));
+
+    // A donor takes part in no other migration of the collection
+    _excludedDonors.insert(from);
+    _excludedReceivers.insert(from);
+
+    // A receiver does not donate and takes chunks until it has as many as it can receive at once
+    _excludedDonors.insert(to);
+    if (++_numReceiving[to] >= _maxMigrationsPerShard) {
+        _excludedReceivers.insert(to);
+    }
+}
+
 ZoneRange::ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone)
     : min(a_min.getOwned()), max(a_max.getOwned()), zone(_zone) {}
 
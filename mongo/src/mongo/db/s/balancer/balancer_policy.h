@@ -32,11 +32,24 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/platform/atomic_proxy.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/client/shard.h"
 
 namespace mongo {
 
+// Balance each zone by the data size and operation rate of its shards rather than by their chunk
+// counts.
+extern AtomicBool internalBalancerCostAwareBalancing;
+
+// How many times the cost of the most loaded shard in a zone must exceed that of the least loaded
+// one for cost-aware balancing to move a chunk between them.
+extern AtomicDouble internalBalancerCostImbalanceRatio;
+
+// Cost-aware balancing defers migrations to or from shards serving more operations per second than
+// this, so that chunks are not moved during peak load. Zero disables the limit.
+extern AtomicInt32 internalBalancerMaxShardOpsPerSecondToMigrate;
+
 struct ZoneRange {
     ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone);
 
@@ -207,10 +220,17 @@ public:
      *
      * The shouldAggressivelyBalance parameter causes the threshold for chunk could disparity
      * between shards to be lowered.
+     *
+     * The maxMigrationsPerShard parameter is how many chunks a shard may receive concurrently. A
+     * shard never donates more than one chunk of the collection, nor donates while it receives.
+     *
+     * If internalBalancerCostAwareBalancing is enabled, the per-zone step instead weighs each
+     * shard's data size and operation rate, see _singleZoneCostBalance.
      */
     static std::vector<MigrateInfo> balance(const ShardStatisticsVector& shardStats,
                                             const DistributionStatus& distribution,
-                                            bool shouldAggressivelyBalance);
+                                            bool shouldAggressivelyBalance,
+                                            size_t maxMigrationsPerShard = 1);
 
     /**
      * Using the specified distribution information, returns a suggested better location for the
@@ -221,6 +241,40 @@ public:
                                                            const DistributionStatus& distribution);
 
 private:
+    /**
+     * Keeps track of the shards, which the migrations selected so far during a call to balance()
+     * use, and of which of them can still donate or receive chunks.
+     */
+    class UsedShards {
+    public:
+        explicit UsedShards(size_t maxMigrationsPerShard)
+            : _maxMigrationsPerShard(maxMigrationsPerShard) {}
+
+        /**
+         * Records a migration from shard 'from' to shard 'to'. Neither of them must be excluded in
+         * the respective role.
+         */
+        void add(const ShardId& from, const ShardId& to);
+
+        const std::set<ShardId>& excludedDonors() const {
+            return _excludedDonors;
+        }
+
+        const std::set<ShardId>& excludedReceivers() const {
+            return _excludedReceivers;
+        }
+
+    private:
+        const size_t _maxMigrationsPerShard;
+
+        // Shards, which must not be picked as the donor or as the receiver of any other migration
+        std::set<ShardId> _excludedDonors;
+        std::set<ShardId> _excludedReceivers;
+
+        // Number of chunks each shard has been picked to receive
+        std::map<ShardId, size_t> _numReceiving;
+    };
+
     /**
      * Return the shard with the specified tag, which has the least number of chunks. If the tag is
      * empty, considers all shards.
@@ -257,7 +311,27 @@ private:
                                    size_t idealNumberOfChunksPerShardForTag,
                                    size_t imbalanceThreshold,
                                    std::vector<MigrateInfo>* migrations,
-                                   std::set<ShardId>* usedShards);
+                                   UsedShards* usedShards);
+
+    /**
+     * Cost-aware counterpart of _singleZoneBalance. The cost of each shard in the zone is the sum
+     * of its data size and operation rate, each relative to the zone's average. Suggests moving a
+     * chunk from the costliest shard to the cheapest one if the former exceeds the latter by more
+     * than internalBalancerCostImbalanceRatio, unless either of them is currently serving more than
+     * internalBalancerMaxShardOpsPerSecondToMigrate operations per second.
+     *
+     * The 'idealNumberOfChunksPerShardForTag' is only used to stop a receiver from accumulating
+     * more than twice its share of chunks, which bounds the number of chunks a shard with small
+     * chunks can be given.
+     *
+     * Returns true if a migration was suggested, false otherwise.
+     */
+    static bool _singleZoneCostBalance(const ShardStatisticsVector& shardStats,
+                                       const DistributionStatus& distribution,
+                                       const std::string& tag,
+                                       size_t idealNumberOfChunksPerShardForTag,
+                                       std::vector<MigrateInfo>* migrations,
+                                       UsedShards* usedShards);
 };
 
 }  // namespace mongo
@@ -36,6 +36,7 @@
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -553,6 +554,98 @@ TEST(BalancerPolicy, BalancerHandlesNoShardsWithTag) {
     ASSERT(BalancerPolicy::balance(cluster.first, distribution, false).empty());
 }
 
+TEST(BalancerPolicy, NewShardReceivesFromSeveralDonorsConcurrently) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 5},
+         {ShardStatistics(kShardId1, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 5},
+         {ShardStatistics(kShardId2, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 5},
+         {ShardStatistics(kShardId3, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0}});
+
+    const auto migrations(BalancerPolicy::balance(
+        cluster.first, DistributionStatus(kNamespace, cluster.second), false, 2));
+    ASSERT_EQ(2U, migrations.size());
+    ASSERT_EQ(kShardId3, migrations[0].to);
+    ASSERT_EQ(kShardId3, migrations[1].to);
+    ASSERT_NOT_EQUALS(migrations[0].from, migrations[1].from);
+}
+
+TEST(BalancerPolicy, ShardDonatesOneChunkOfCollectionWhenReceivingConcurrently) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 6, false, emptyTagSet, emptyShardVersion), 6},
+         {ShardStatistics(kShardId1, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2},
+         {ShardStatistics(kShardId2, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0}});
+
+    const auto migrations(BalancerPolicy::balance(
+        cluster.first, DistributionStatus(kNamespace, cluster.second), false, 4));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId2, migrations[0].to);
+}
+
+TEST(BalancerPolicy, CostAwareMovesChunkOffLargestShardWithEqualChunkCounts) {
+    internalBalancerCostAwareBalancing.store(true);
+    ON_BLOCK_EXIT([] { internalBalancerCostAwareBalancing.store(false); });
+
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 300, false, emptyTagSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, kNoMaxSize, 100, false, emptyTagSet, emptyShardVersion), 3}});
+
+    const auto migrations(BalancerPolicy::balance(
+        cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][0].getMin(), migrations[0].minKey);
+}
+
+TEST(BalancerPolicy, CostAwareMovesChunkOffBusiestShard) {
+    internalBalancerCostAwareBalancing.store(true);
+    ON_BLOCK_EXIT([] { internalBalancerCostAwareBalancing.store(false); });
+
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 100, false, emptyTagSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, kNoMaxSize, 100, false, emptyTagSet, emptyShardVersion), 3}});
+    cluster.first[0].opsPerSecond = 100;
+    cluster.first[1].opsPerSecond = 1000;
+
+    const auto migrations(BalancerPolicy::balance(
+        cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId1, migrations[0].from);
+    ASSERT_EQ(kShardId0, migrations[0].to);
+}
+
+TEST(BalancerPolicy, CostAwareDoesNotBalanceSmallImbalance) {
+    internalBalancerCostAwareBalancing.store(true);
+    ON_BLOCK_EXIT([] { internalBalancerCostAwareBalancing.store(false); });
+
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 110, false, emptyTagSet, emptyShardVersion), 1},
+         {ShardStatistics(kShardId1, kNoMaxSize, 100, false, emptyTagSet, emptyShardVersion), 5}});
+
+    ASSERT(BalancerPolicy::balance(
+               cluster.first, DistributionStatus(kNamespace, cluster.second), false)
+               .empty());
+}
+
+TEST(BalancerPolicy, CostAwareDefersMigrationsOfShardsUnderPeakLoad) {
+    internalBalancerCostAwareBalancing.store(true);
+    internalBalancerMaxShardOpsPerSecondToMigrate.store(500);
+    ON_BLOCK_EXIT([] {
+        internalBalancerCostAwareBalancing.store(false);
+        internalBalancerMaxShardOpsPerSecondToMigrate.store(0);
+    });
+
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 300, false, emptyTagSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, kNoMaxSize, 100, false, emptyTagSet, emptyShardVersion), 3}});
+    cluster.first[0].opsPerSecond = 1000;
+
+    ASSERT(BalancerPolicy::balance(
+               cluster.first, DistributionStatus(kNamespace, cluster.second), false)
+               .empty());
+}
+
 TEST(DistributionStatus, AddTagRangeOverlap) {
     DistributionStatus d(kNamespace, ShardToChunksMap{});
 
@@ -94,6 +94,10 @@ public:
 
         // Version of mongod, which runs on this shard's primary
         std::string mongoVersion;
+
+        // The rate at which the shard's primary served operations since the previous snapshot.
+        // Zero if no earlier snapshot is available.
+        double opsPerSecond{0};
     };
 
     virtual ~ClusterStatistics();
@@ -35,6 +35,7 @@
 #include "mongo/base/status_with.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/read_preference.h"
+#include "mongo/db/s/balancer/balancer_policy.h"
 #include "mongo/s/catalog/sharding_catalog_client.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/client/shard_registry.h"
@@ -51,16 +52,15 @@ using std::vector;
 namespace {
 
 const char kVersionField[] = "version";
+const char kOpCountersField[] = "opcounters";
 
 /**
- * Executes the serverStatus command against the specified shard and obtains the version of the
- * running MongoD service.
+ * Executes the serverStatus command against the specified shard and returns its response.
  *
- * Returns the MongoD version in strig format or an error. Known error codes are:
+ * Known error codes are:
  *  ShardNotFound if shard by that id is not available on the registry
- *  NoSuchKey if the version could not be retrieved
  */
-StatusWith<string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId shardId) {
+StatusWith<BSONObj> retrieveShardServerStatus(OperationContext* opCtx, ShardId shardId) {
     auto shardRegistry = Grid::get(opCtx)->shardRegistry();
     auto shardStatus = shardRegistry->getShard(opCtx, shardId);
     if (!shardStatus.isOK()) {
@@ -81,15 +81,28 @@ StatusWith<string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId s
         return commandResponse.getValue().commandStatus;
     }
 
-    BSONObj serverStatus = std::move(commandResponse.getValue().response);
+    return std::move(commandResponse.getValue().response);
+}
 
-    string version;
-    Status status = bsonExtractStringField(serverStatus, kVersionField, &version);
+/**
+ * Returns the total number of operations the replied serverStatus counts in its 'opcounters'
+ * section, or NoSuchKey if it has none.
+ */
+StatusWith<long long> extractTotalOpCount(const BSONObj& serverStatus) {
+    BSONElement opCounters;
+    Status status = bsonExtractTypedField(serverStatus, kOpCountersField, Object, &opCounters);
     if (!status.isOK()) {
         return status;
     }
 
-    return version;
+    long long totalOps = 0;
+    for (const auto& counter : opCounters.Obj()) {
+        if (counter.isNumber()) {
+            totalOps += counter.safeNumberLong();
+        }
+    }
+
+    return totalOps;
 }
 
 }  // namespace
@@ -100,6 +113,30 @@ ClusterStatisticsImpl::ClusterStatisticsImpl() = default;
 
 ClusterStatisticsImpl::~ClusterStatisticsImpl() = default;
 
+double ClusterStatisticsImpl::_noteOpCounters(const ShardId& shardId,
+                                              long long totalOps,
+                                              Date_t now) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    const OpCountersSample sample{totalOps, now};
+    auto it = _opCountersSamples.find(shardId);
+    if (it == _opCountersSamples.end()) {
+        _opCountersSamples.emplace(shardId, sample);
+        return 0;
+    }
+
+    const OpCountersSample previous = it->second;
+    it->second = sample;
+
+    // The counters restart from zero if the primary restarts or fails over
+    const auto elapsed = now - previous.sampledAt;
+    if (totalOps < previous.totalOps || elapsed <= Milliseconds(0)) {
+        return 0;
+    }
+
+    return (totalOps - previous.totalOps) * 1000.0 / durationCount<Milliseconds>(elapsed);
+}
+
 //ȡƬϢ
 StatusWith<vector<ShardStatistics>> ClusterStatisticsImpl::getStats(OperationContext* opCtx) {
     // Get a list of all the shards that are participating in this balance round along with any
@@ -119,7 +156,8 @@ StatusWith<vector<ShardStatistics>> ClusterStatisticsImpl::getStats(OperationCon
 
     for (const auto& shard : shards) {
         const auto shardSizeStatus = [&]() -> StatusWith<long long> {
-            if (!shard.getMaxSizeMB()) {
+            // Cost-aware balancing weighs every shard's data size, not only that of capped shards
+            if (!shard.getMaxSizeMB() && !internalBalancerCostAwareBalancing.load()) {
                 return 0;
             }
 
@@ -137,15 +175,27 @@ StatusWith<vector<ShardStatistics>> ClusterStatisticsImpl::getStats(OperationCon
         }
 
         string mongoDVersion;
+        double opsPerSecond = 0;
 
-        auto mongoDVersionStatus = retrieveShardMongoDVersion(opCtx, shard.getName());
+        auto serverStatus = retrieveShardServerStatus(opCtx, shard.getName());
+        Status mongoDVersionStatus = serverStatus.getStatus();
         if (mongoDVersionStatus.isOK()) {
-            mongoDVersion = std::move(mongoDVersionStatus.getValue());
-        } else {
+            mongoDVersionStatus =
+                bsonExtractStringField(serverStatus.getValue(), kVersionField, &mongoDVersion);
+
+            auto totalOps = extractTotalOpCount(serverStatus.getValue());
+            if (totalOps.isOK()) {
+                opsPerSecond =
+                    _noteOpCounters(shard.getName(), totalOps.getValue(), Date_t::now());
+            }
+        }
+
+        if (!mongoDVersionStatus.isOK()) {
             // Since the mongod version is only used for reporting, there is no need to fail the
-            // entire round if it cannot be retrieved, so just leave it empty
+            // entire round if it cannot be retrieved, so just leave it empty. Without the server
+            // status the operation rate is unknown too, which leaves it at zero.
             log() << "Unable to obtain shard version for " << shard.getName()
-                  << causedBy(mongoDVersionStatus.getStatus());
+                  << causedBy(mongoDVersionStatus);
         }
 
         std::set<string> shardTags;
@@ -160,6 +210,7 @@ StatusWith<vector<ShardStatistics>> ClusterStatisticsImpl::getStats(OperationCon
                            shard.getDraining(),
                            std::move(shardTags),
                            std::move(mongoDVersion));
+        stats.back().opsPerSecond = opsPerSecond;
     }
 
     return stats;
@@ -28,14 +28,19 @@
 
 #pragma once
 
+#include <map>
+
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
 /**
  * Default implementation for the cluster statistics gathering utility. Uses a blocking method to
- * fetch the statistics and does not perform any caching. If any of the shards fails to report
- * statistics fails the entire refresh.
+ * fetch the statistics and does not cache them. The only state kept between calls is each shard's
+ * last operation counter sample, from which the operation rate is derived. If any of the shards
+ * fails to report statistics fails the entire refresh.
  */
 class ClusterStatisticsImpl final : public ClusterStatistics {
 public:
@@ -44,6 +49,24 @@ public:
 
     //vectorĴСǷƬÿShardStatisticsԱӦһƬ
     StatusWith<std::vector<ShardStatistics>> getStats(OperationContext* opCtx) override;
+
+private:
+    struct OpCountersSample {
+        long long totalOps;
+        Date_t sampledAt;
+    };
+
+    /**
+     * Records 'totalOps' as the latest operation count of 'shardId' and returns the rate of
+     * operations per second since its previous sample, or zero if there is none.
+     */
+    double _noteOpCounters(const ShardId& shardId, long long totalOps, Date_t now);
+
+    // Protects '_opCountersSamples'
+    stdx::mutex _mutex;
+
+    // The operation counters of each shard's primary as of the previous call to getStats()
+    std::map<ShardId, OpCountersSample> _opCountersSamples;
 };
 
 }  // namespace mongo
@@ -258,13 +258,15 @@ void ChunkSplitter::interruptChunkSplitter() {
 void ChunkSplitter::trySplitting(const NamespaceString& nss,
                                  const BSONObj& min,
                                  const BSONObj& max,
-                                 long dataWritten) {
+                                 long dataWritten,
+                                 boost::optional<BSONObj> loadSplitKey) {
     if (!_isPrimary) {
         return;
     }
-    uassertStatusOK(_threadPool.schedule([ this, nss, min, max, dataWritten ]() noexcept {
-        _runAutosplit(nss, min, max, dataWritten);
-    }));
+    uassertStatusOK(
+        _threadPool.schedule([ this, nss, min, max, dataWritten, loadSplitKey ]() noexcept {
+            _runAutosplit(nss, min, max, dataWritten, loadSplitKey);
+        }));
 }
 
 //split chunks һڲ롢¡ɾʱ mongos Ƭ splitVector ʱƬŻжǷҪ split
@@ -274,7 +276,8 @@ void ChunkSplitter::trySplitting(const NamespaceString& nss,
 void ChunkSplitter::_runAutosplit(const NamespaceString& nss,
                                   const BSONObj& min,
                                   const BSONObj& max,
-                                  long dataWritten) {
+                                  long dataWritten,
+                                  const boost::optional<BSONObj>& loadSplitKey) {
     if (!_isPrimary) {
         return;
     }
@@ -331,7 +334,12 @@ void ChunkSplitter::_runAutosplit(const NamespaceString& nss,
                                                        maxChunkSizeBytes));
 
 		/*ûзָζû㹻ݿɹָ;һָζһĿСĿСԻûбҪָ*/
-        if (splitPoints.size() <= 1) {
+        const bool splitForLoad = splitPoints.size() <= 1 && loadSplitKey;
+        if (splitForLoad) {
+            // The chunk is too small to be split by size, but takes too many of the writes, so
+            // split it where the sampled writes divide in two halves
+            splitPoints = {loadSplitKey->getOwned()};
+        } else if (splitPoints.size() <= 1) {
             // No split points means there isn't enough data to split on; 1 split point means we
             // have between half the chunk size to full chunk size so there is no need to split yet
             return;
@@ -347,7 +355,7 @@ void ChunkSplitter::_runAutosplit(const NamespaceString& nss,
         // Keeps track of the minKey of the top chunk after the split so we can migrate the chunk.
         BSONObj topChunkMinKey;
 
-        if (KeyPattern::isOrderedKeyPattern(cm->getShardKeyPattern().toBSON())) {
+        if (!splitForLoad && KeyPattern::isOrderedKeyPattern(cm->getShardKeyPattern().toBSON())) {
             if (0 ==
                 cm->getShardKeyPattern().getKeyPattern().globalMin().woCompare(chunk->getMin())) {
                 // MinKey is infinity (This is the first chunk on the collection)
@@ -383,7 +391,7 @@ void ChunkSplitter::_runAutosplit(const NamespaceString& nss,
 
         log() << "autosplitted " << nss << " chunk: " << redact(chunk->toString()) << " into "
               << (splitPoints.size() + 1) << " parts (maxChunkSizeBytes " << maxChunkSizeBytes
-              << ")"
+              << ")" << (splitForLoad ? " because of its write load" : "")
               << (topChunkMinKey.isEmpty() ? "" : " (top chunk migration suggested" +
                           (std::string)(shouldBalance ? ")" : ", but no migrations allowed)"));
 
@@ -28,6 +28,9 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
+#include "mongo/bson/bsonobj.h"
 #include "mongo/util/concurrency/thread_pool.h"
 
 namespace mongo {
@@ -66,11 +69,15 @@ public:
 
     /**
      * Schedules an autosplit task. This function throws on scheduling failure.
+     *
+     * If 'loadSplitKey' is set, the chunk receives a disproportionate share of the writes and is
+     * split at that key even if it is not large enough to be split by size.
      */
     void trySplitting(const NamespaceString& nss,
                       const BSONObj& min,
                       const BSONObj& max,
-                      long dataWritten);
+                      long dataWritten,
+                      boost::optional<BSONObj> loadSplitKey = boost::none);
 
 private:
     /**
@@ -84,7 +91,8 @@ private:
     void _runAutosplit(const NamespaceString& nss,
                        const BSONObj& min,
                        const BSONObj& max,
-                       long dataWritten);
+                       long dataWritten,
+                       const boost::optional<BSONObj>& loadSplitKey);
 
     // Protects the state below.
     stdx::mutex _mutex;
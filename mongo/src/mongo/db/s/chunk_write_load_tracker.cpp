@@ -0,0 +1,123 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/chunk_write_load_tracker.h"
+
+#include <algorithm>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+
+namespace mongo {
+
+constexpr size_t ChunkWriteLoadTracker::kMaxSampledKeys;
+constexpr size_t ChunkWriteLoadTracker::kMinSampledKeys;
+
+ChunkWriteLoadTracker::ChunkWriteLoadTracker()
+    : _chunks(SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ChunkWriteSample>()),
+      _random(static_cast<int64_t>(Date_t::now().toMillisSinceEpoch())) {}
+
+ChunkWriteLoadTracker::~ChunkWriteLoadTracker() = default;
+
+boost::optional<BSONObj> ChunkWriteLoadTracker::recordWrite(const BSONObj& min,
+                                                            const BSONObj& max,
+                                                            const BSONObj& shardKey,
+                                                            Date_t now,
+                                                            int maxWritesPerSecond,
+                                                            Seconds window) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _chunks.find(min);
+    if (it == _chunks.end()) {
+        it = _chunks.emplace(min.getOwned(), ChunkWriteSample()).first;
+    }
+
+    auto& sample = it->second;
+
+    // Start over if the chunk has been split or merged since, or if its window has ended
+    if (sample.numWrites == 0 || SimpleBSONObjComparator::kInstance.evaluate(sample.max != max) ||
+        now - sample.windowStart >= window) {
+        sample.max = max.getOwned();
+        sample.windowStart = now;
+        sample.numWrites = 0;
+        sample.sampledKeys.clear();
+    }
+
+    ++sample.numWrites;
+
+    if (sample.sampledKeys.size() < kMaxSampledKeys) {
+        sample.sampledKeys.push_back(shardKey.getOwned());
+    } else {
+        const long long slot = _random.nextInt64(sample.numWrites);
+        if (slot < static_cast<long long>(kMaxSampledKeys)) {
+            sample.sampledKeys[slot] = shardKey.getOwned();
+        }
+    }
+
+    if (sample.numWrites < maxWritesPerSecond * durationCount<Seconds>(window)) {
+        return boost::none;
+    }
+
+    auto splitKey = sample.sampledKeys.size() >= kMinSampledKeys
+        ? _chooseSplitKey(min, std::move(sample.sampledKeys))
+        : boost::none;
+
+    _chunks.erase(it);
+    return splitKey;
+}
+
+void ChunkWriteLoadTracker::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _chunks.clear();
+}
+
+boost::optional<BSONObj> ChunkWriteLoadTracker::_chooseSplitKey(const BSONObj& min,
+                                                                std::vector<BSONObj> sampledKeys) {
+    std::sort(sampledKeys.begin(),
+              sampledKeys.end(),
+              SimpleBSONObjComparator::kInstance.makeLessThan());
+
+    const auto& median = sampledKeys[sampledKeys.size() / 2];
+    if (SimpleBSONObjComparator::kInstance.evaluate(median > min)) {
+        return median;
+    }
+
+    // Most writes target the chunk's minimum key, so split right above it to isolate that key
+    auto it = std::upper_bound(sampledKeys.begin(),
+                               sampledKeys.end(),
+                               min,
+                               SimpleBSONObjComparator::kInstance.makeLessThan());
+    if (it == sampledKeys.end()) {
+        return boost::none;
+    }
+
+    return *it;
+}
+
+}  // namespace mongo
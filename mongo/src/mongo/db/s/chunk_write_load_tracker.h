@@ -0,0 +1,117 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobj_comparator_interface.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Samples the writes which a shard receives for the chunks of one collection in order to find the
+ * chunks which take a disproportionate share of them, so they can be split by load rather than only
+ * by size.
+ *
+ * For every chunk it counts the writes received during the current sampling window and keeps a
+ * uniform reservoir sample of their shard keys. Once a chunk exceeds the write rate threshold
+ * within a window, the median of the sampled keys is proposed as split point, so that each half
+ * of the chunk takes roughly half of the writes.
+ *
+ * This class is thread-safe.
+ */
+class ChunkWriteLoadTracker {
+    MONGO_DISALLOW_COPYING(ChunkWriteLoadTracker);
+
+public:
+    // Number of shard keys kept in the reservoir of each chunk
+    static constexpr size_t kMaxSampledKeys = 100;
+
+    // Minimum number of sampled keys needed to choose a split point
+    static constexpr size_t kMinSampledKeys = 10;
+
+    ChunkWriteLoadTracker();
+    ~ChunkWriteLoadTracker();
+
+    /**
+     * Records a write of a document with shard key 'shardKey' to the chunk [min, max).
+     *
+     * If this write makes the chunk exceed 'maxWritesPerSecond' over the current window of length
+     * 'window', returns the key at which the chunk should be split and starts a new window for it.
+     * Returns boost::none otherwise, including when the sampled writes all target the chunk's
+     * minimum key, which no split can separate.
+     */
+    boost::optional<BSONObj> recordWrite(const BSONObj& min,
+                                         const BSONObj& max,
+                                         const BSONObj& shardKey,
+                                         Date_t now,
+                                         int maxWritesPerSecond,
+                                         Seconds window);
+
+    /**
+     * Forgets all the samples. Must be called when the chunk boundaries change.
+     */
+    void clear();
+
+private:
+    struct ChunkWriteSample {
+        // Upper bound of the sampled chunk, used to detect that the chunk has changed
+        BSONObj max;
+
+        // Beginning of the current sampling window and number of writes received since
+        Date_t windowStart;
+        long long numWrites{0};
+
+        // Reservoir of the shard keys written during the current window
+        std::vector<BSONObj> sampledKeys;
+    };
+
+    /**
+     * Returns the median of the sampled keys if it is greater than 'min', else the smallest sampled
+     * key greater than 'min', or boost::none if there is no such key.
+     */
+    static boost::optional<BSONObj> _chooseSplitKey(const BSONObj& min,
+                                                    std::vector<BSONObj> sampledKeys);
+
+    // Protects the state below
+    stdx::mutex _mutex;
+
+    // Sampled chunks, indexed by their min key
+    BSONObjIndexedMap<ChunkWriteSample> _chunks;
+
+    // Source of randomness for the reservoir sampling
+    PseudoRandom _random;
+};
+
+}  // namespace mongo
@@ -0,0 +1,121 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/chunk_write_load_tracker.h"
+
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const BSONObj kMin = BSON("x" << MINKEY);
+const BSONObj kMax = BSON("x" << MAXKEY);
+const Seconds kWindow(10);
+
+TEST(ChunkWriteLoadTrackerTest, NoSplitBelowThreshold) {
+    ChunkWriteLoadTracker tracker;
+    const auto now = Date_t::now();
+
+    for (int i = 0; i < 99; i++) {
+        ASSERT(!tracker.recordWrite(kMin, kMax, BSON("x" << i), now, 10, kWindow));
+    }
+}
+
+TEST(ChunkWriteLoadTrackerTest, SplitsAtMedianOfSampledKeys) {
+    ChunkWriteLoadTracker tracker;
+    const auto now = Date_t::now();
+
+    boost::optional<BSONObj> splitKey;
+    for (int i = 0; i < 100; i++) {
+        ASSERT(!splitKey);
+        splitKey = tracker.recordWrite(kMin, kMax, BSON("x" << i), now, 10, kWindow);
+    }
+
+    ASSERT(splitKey);
+    ASSERT_BSONOBJ_EQ(BSON("x" << 50), *splitKey);
+}
+
+TEST(ChunkWriteLoadTrackerTest, WritesFromExpiredWindowAreNotCounted) {
+    ChunkWriteLoadTracker tracker;
+    const auto now = Date_t::now();
+
+    for (int i = 0; i < 60; i++) {
+        ASSERT(!tracker.recordWrite(kMin, kMax, BSON("x" << i), now, 10, kWindow));
+    }
+
+    for (int i = 0; i < 60; i++) {
+        ASSERT(!tracker.recordWrite(kMin, kMax, BSON("x" << i), now + kWindow, 10, kWindow));
+    }
+}
+
+TEST(ChunkWriteLoadTrackerTest, ChangedChunkBoundsRestartSampling) {
+    ChunkWriteLoadTracker tracker;
+    const auto now = Date_t::now();
+
+    for (int i = 0; i < 60; i++) {
+        ASSERT(!tracker.recordWrite(kMin, kMax, BSON("x" << i), now, 10, kWindow));
+    }
+
+    const BSONObj newMax = BSON("x" << 1000);
+    for (int i = 0; i < 60; i++) {
+        ASSERT(!tracker.recordWrite(kMin, newMax, BSON("x" << i), now, 10, kWindow));
+    }
+}
+
+TEST(ChunkWriteLoadTrackerTest, HotMinimumKeyIsSplitOff) {
+    ChunkWriteLoadTracker tracker;
+    const auto now = Date_t::now();
+    const BSONObj min = BSON("x" << 0);
+
+    boost::optional<BSONObj> splitKey;
+    for (int i = 0; i < 100; i++) {
+        ASSERT(!splitKey);
+        splitKey =
+            tracker.recordWrite(min, kMax, BSON("x" << (i % 10 ? 0 : i)), now, 10, kWindow);
+    }
+
+    ASSERT(splitKey);
+    ASSERT_BSONOBJ_EQ(BSON("x" << 10), *splitKey);
+}
+
+TEST(ChunkWriteLoadTrackerTest, NoSplitWhenAllWritesTargetMinimumKey) {
+    ChunkWriteLoadTracker tracker;
+    const auto now = Date_t::now();
+    const BSONObj min = BSON("x" << 0);
+
+    for (int i = 0; i < 200; i++) {
+        ASSERT(!tracker.recordWrite(min, kMax, min, now, 10, kWindow));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -32,14 +32,40 @@
 
 #include "mongo/db/s/collection_metadata.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/bson/util/builder.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
+namespace {
+
+// Shard keys are compared field by field in ascending order, regardless of the direction or type
+// of the shard key pattern's fields, so the range bounds are encoded with an all ascending ordering
+const Ordering kShardKeyOrdering = Ordering::make(BSONObj());
+
+/**
+ * Compares the encoded shard key 'key' with the encoded range bound 'bound' the same way as
+ * KeyString::compare.
+ */
+bool keyStringLessThanBound(const KeyString& key, const std::string& bound) {
+    const size_t minSize = std::min(key.getSize(), bound.size());
+    const int cmp = std::memcmp(key.getBuffer(), bound.data(), minSize);
+    return cmp < 0 || (cmp == 0 && key.getSize() < bound.size());
+}
+
+std::string encodeRangeBound(const BSONObj& bound) {
+    const KeyString keyString(KeyString::Version::V1, bound, kShardKeyOrdering);
+    return std::string(keyString.getBuffer(), keyString.getSize());
+}
+
+}  // namespace
 
 CollectionMetadata::CollectionMetadata(std::shared_ptr<ChunkManager> cm, const ShardId& thisShardId)
     : _cm(std::move(cm)),
@@ -103,18 +129,29 @@ void CollectionMetadata::_buildRangesMap() {
     invariant(!max.isEmpty());
 
     _rangesMap.emplace(min, max);
+
+    _rangeBoundKeyStrings.clear();
+    _rangeBoundKeyStrings.reserve(2 * _rangesMap.size());
+    for (const auto& entry : _rangesMap) {
+        _rangeBoundKeyStrings.push_back(encodeRangeBound(entry.first));
+        _rangeBoundKeyStrings.push_back(encodeRangeBound(entry.second));
+    }
 }
 
 bool CollectionMetadata::keyBelongsToMe(const BSONObj& key) const {
-    if (_rangesMap.empty()) {
+    if (_rangeBoundKeyStrings.empty()) {
         return false;
     }
 
-    auto it = _rangesMap.upper_bound(key);
-    if (it != _rangesMap.begin())
-        it--;
+    // The ranges are coalesced, so the bounds are strictly increasing and the key is owned exactly
+    // when the first bound greater than it is the (exclusive) max of a range
+    const KeyString lookupKey(KeyString::Version::V1, key, kShardKeyOrdering);
+    const auto it = std::upper_bound(_rangeBoundKeyStrings.begin(),
+                                     _rangeBoundKeyStrings.end(),
+                                     lookupKey,
+                                     keyStringLessThanBound);
 
-    return rangeContains(it->first, it->second, key);
+    return (it - _rangeBoundKeyStrings.begin()) % 2 == 1;
 }
 
 bool CollectionMetadata::getNextChunk(const BSONObj& lookupKey, ChunkType* chunk) const {
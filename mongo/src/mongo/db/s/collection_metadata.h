@@ -197,6 +197,11 @@ private:
     // respect to the contents of _chunkMap but we expect high chunk contiguity, especially in small
     // clusters.
     RangeMap _rangesMap;
+
+    // The bounds of the ranges in _rangesMap encoded as KeyStrings and flattened into a single
+    // sorted array of alternating min and max keys, so that keyBelongsToMe can binary search them
+    // with memcmp instead of BSON comparisons. Keys at even positions are inclusive range mins.
+    std::vector<std::string> _rangeBoundKeyStrings;
 };
 
 }  // namespace mongo
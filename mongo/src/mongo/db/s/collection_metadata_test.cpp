@@ -331,6 +331,21 @@ TEST_F(ThreeChunkWithRangeGapFixture, ShardDoesntOwnDoc) {
     ASSERT_FALSE(makeCollectionMetadata()->keyBelongsToMe(BSON("a" << MAXKEY)));
 }
 
+TEST_F(ThreeChunkWithRangeGapFixture, KeyBelongsToMeComparesValuesAcrossTypes) {
+    auto metadata(makeCollectionMetadata());
+
+    // Numeric types compare by value, as they do for the BSON chunk bounds
+    ASSERT(metadata->keyBelongsToMe(BSON("a" << 19.5)));
+    ASSERT(metadata->keyBelongsToMe(BSON("a" << 30LL)));
+    ASSERT_FALSE(metadata->keyBelongsToMe(BSON("a" << 20.0)));
+    ASSERT_FALSE(metadata->keyBelongsToMe(BSON("a" << 29.9)));
+
+    // All strings sort after all numbers, so they fall in the [30, max) range
+    ASSERT(metadata->keyBelongsToMe(BSON("a"
+                                         << "")));
+    ASSERT(metadata->keyBelongsToMe(BSON("a" << MINKEY)));
+}
+
 TEST_F(ThreeChunkWithRangeGapFixture, GetNextFromEmpty) {
     ChunkType nextChunk;
     ASSERT(
@@ -53,14 +53,20 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/metadata_manager.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/top.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchDelayMS, int, 0);
+
 namespace {
 
 using Deletion = CollectionRangeDeleter::Deletion;
@@ -70,6 +76,104 @@ const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 WriteConcernOptions::SyncMode::UNSET,
                                                 Seconds(60));
 
+// Upper bound for the pause between batches while backing off under pressure
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxThrottleDelayMS, int, 1000);
+
+// Back off while the majority commit point trails the last applied optime by more than this many
+// seconds. Zero disables the check.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxReplicationLagSecs, int, 0);
+
+// Back off while the average latency of the reads and writes served since the previous batch
+// exceeds this many microseconds. Zero disables the check.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxForegroundLatencyMicros, int, 0);
+
+const Milliseconds kMinThrottleDelay(10);
+
+/**
+ * Paces the deletion batches of all the collections on this shard. On top of
+ * rangeDeleterBatchDelayMS, the pause after a batch doubles for as long as the secondaries lag or
+ * the foreground operations slow down beyond the configured limits, and halves back once they
+ * recover.
+ */
+class RangeDeletionThrottle {
+public:
+    Milliseconds nextBatchDelay(OperationContext* opCtx) {
+        const Milliseconds baseDelay(std::max(rangeDeleterBatchDelayMS.load(), 0));
+        const Milliseconds maxDelay =
+            std::max(Milliseconds(rangeDeleterMaxThrottleDelayMS.load()), baseDelay);
+
+        const bool lagging = _isReplicationLagging(opCtx);
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        const bool slow = _isForegroundSlow(opCtx);
+
+        if (lagging || slow) {
+            _backoff = std::max(_backoff * 2, kMinThrottleDelay);
+            LOG(1) << "Throttling range deletion for another " << _backoff
+                   << (lagging ? " because of replication lag" : " because of foreground latency");
+        } else if (_backoff > Milliseconds(0)) {
+            _backoff = _backoff / 2 < kMinThrottleDelay ? Milliseconds(0) : _backoff / 2;
+        }
+
+        _backoff = std::min(_backoff, maxDelay);
+        return std::min(baseDelay + _backoff, maxDelay);
+    }
+
+private:
+    static bool _isReplicationLagging(OperationContext* opCtx) {
+        const int maxLagSecs = rangeDeleterMaxReplicationLagSecs.load();
+        if (maxLagSecs <= 0) {
+            return false;
+        }
+
+        auto* const replCoord = repl::getGlobalReplicationCoordinator();
+        if (replCoord->getReplicationMode() != repl::ReplicationCoordinator::modeReplSet) {
+            return false;
+        }
+
+        const auto lastApplied = replCoord->getMyLastAppliedOpTime().getTimestamp().getSecs();
+        const auto lastCommitted = replCoord->getLastCommittedOpTime().getTimestamp().getSecs();
+        return lastApplied > lastCommitted && lastApplied - lastCommitted > unsigned(maxLagSecs);
+    }
+
+    bool _isForegroundSlow(OperationContext* opCtx) {
+        const int maxLatencyMicros = rangeDeleterMaxForegroundLatencyMicros.load();
+        if (maxLatencyMicros <= 0) {
+            return false;
+        }
+
+        BSONObjBuilder latencyBuilder;
+        Top::get(opCtx->getServiceContext()).appendGlobalLatencyStats(false, &latencyBuilder);
+        const BSONObj latencyStats = latencyBuilder.obj();
+
+        long long totalOps = 0;
+        long long totalLatencyMicros = 0;
+        for (auto kind : {"reads", "writes"}) {
+            const BSONObj stats = latencyStats[kind].Obj();
+            totalOps += stats["ops"].safeNumberLong();
+            totalLatencyMicros += stats["latency"].safeNumberLong();
+        }
+
+        const long long ops = totalOps - _lastOps;
+        const long long latencyMicros = totalLatencyMicros - _lastLatencyMicros;
+        _lastOps = totalOps;
+        _lastLatencyMicros = totalLatencyMicros;
+
+        return ops > 0 && latencyMicros / ops > maxLatencyMicros;
+    }
+
+    stdx::mutex _mutex;
+
+    // Extra pause on top of rangeDeleterBatchDelayMS, grown while under pressure
+    Milliseconds _backoff{0};
+
+    // Global latency counters as of the previous batch
+    long long _lastOps{0};
+    long long _lastLatencyMicros{0};
+};
+
+RangeDeletionThrottle rangeDeletionThrottle;
+
 boost::optional<DeleteNotification> checkOverlap(std::list<Deletion> const& deletions,
                                                  ChunkRange const& range) {
     // Start search with newest entries by using reverse iterators
@@ -266,7 +370,9 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     }
 
     notification.abandon();
-    return Date_t{};
+
+    const auto delay = rangeDeletionThrottle.nextBatchDelay(opCtx);
+    return delay > Milliseconds(0) ? Date_t::now() + delay : Date_t{};
 }
 
 StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
@@ -32,12 +32,17 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/util/concurrency/notification.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
 
+// Pause between two consecutive range deletion batches while neither replication nor foreground
+// operations show any pressure
+extern AtomicInt32 rangeDeleterBatchDelayMS;
+
 class BSONObj;
 class Collection;
 class OperationContext;
@@ -158,7 +163,9 @@ public:
      * it must be called without locks.
      *
      * If it should be scheduled to run again because there might be more documents to delete,
-     * returns the time to begin, or boost::none otherwise.
+     * returns the time to begin, or boost::none otherwise. After a batch of deletions the next run
+     * is deferred according to rangeDeleterBatchDelayMS, and further while replication lag or
+     * foreground latency exceed their configured limits.
      *
      * Argument 'forTestOnly' is used in unit tests that exercise the CollectionRangeDeleter class,
      * so that they do not need to set up CollectionShardingState and MetadataManager objects.
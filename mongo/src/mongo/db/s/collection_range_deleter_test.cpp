@@ -48,6 +48,7 @@
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/sharding_mongod_test_fixture.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -191,6 +192,35 @@ TEST_F(CollectionRangeDeleterTest, OneDocumentInOneRangeToClean) {
     ASSERT_EQUALS(0ULL, dbclient.count(kAdminSysVer.ns(), BSON(kPattern << "startRangeDeletion")));
 }
 
+// Tests that a configured batch delay defers the next pass after a batch of deletions.
+TEST_F(CollectionRangeDeleterTest, BatchDelayDefersNextPass) {
+    const auto originalDelay = rangeDeleterBatchDelayMS.load();
+    rangeDeleterBatchDelayMS.store(1000);
+    ON_BLOCK_EXIT([&] { rangeDeleterBatchDelayMS.store(originalDelay); });
+
+    CollectionRangeDeleter rangeDeleter;
+    DBDirectClient dbclient(operationContext());
+    dbclient.insert(kNss.toString(), BSON(kPattern << 1));
+    dbclient.insert(kNss.toString(), BSON(kPattern << 2));
+
+    std::list<Deletion> ranges;
+    ranges.emplace_back(Deletion{ChunkRange{BSON(kPattern << 0), BSON(kPattern << 10)}, Date_t{}});
+    rangeDeleter.add(std::move(ranges));
+
+    const auto before = Date_t::now();
+    auto nextPass = next(rangeDeleter, 1);
+    ASSERT(nextPass);
+    ASSERT_GTE(*nextPass, before + Milliseconds(1000));
+    ASSERT_EQUALS(1ULL, dbclient.count(kNss.toString(), BSON(kPattern << LT << 10)));
+
+    // Finishing the range is not delayed
+    ASSERT_TRUE(next(rangeDeleter, 1));
+    nextPass = next(rangeDeleter, 1);
+    ASSERT(nextPass);
+    ASSERT_EQUALS(*nextPass, Date_t{});
+    ASSERT_TRUE(rangeDeleter.isEmpty());
+}
+
 // Tests the case that there are multiple documents within a range to clean.
 TEST_F(CollectionRangeDeleterTest, MultipleDocumentsInOneRangeToClean) {
     CollectionRangeDeleter rangeDeleter;
@@ -38,6 +38,7 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/s/chunk_splitter.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/migration_chunk_cloner_source.h"
 #include "mongo/db/s/migration_source_manager.h"
@@ -68,6 +69,13 @@ namespace {
 // How long to wait before starting cleanup of an emigrated chunk range
 MONGO_EXPORT_SERVER_PARAMETER(orphanCleanupDelaySecs, int, 900);  // 900s = 15m
 
+// Split a chunk as soon as it receives more than this many writes per second over the sampling
+// window, regardless of its size. Zero disables splitting by write load.
+MONGO_EXPORT_SERVER_PARAMETER(autoSplitWriteLoadThresholdPerSec, int, 0);
+
+// Length of the window over which the writes to each chunk are sampled
+MONGO_EXPORT_SERVER_PARAMETER(autoSplitWriteLoadWindowSecs, int, 10);
+
 /**
  * Used to perform shard identity initialization once it is certain that the document is committed.
  */
@@ -163,6 +171,7 @@ void CollectionShardingState::refreshMetadata(OperationContext* opCtx,
     invariant(opCtx->lockState()->isCollectionLockedForMode(_nss.ns(), MODE_X));
 	//MetadataManager::refreshActiveMetadata
     _metadataManager->refreshActiveMetadata(std::move(newMetadata));
+    _writeLoadTracker.clear();
 }
 
 void CollectionShardingState::markNotShardedAtStepdown() {
@@ -522,9 +531,9 @@ bool CollectionShardingState::_checkShardVersionOk(OperationContext* opCtx,
         return true;
     }
 
-    // Set this for error messaging purposes before potentially returning false.
-    auto metadata = getMetadata();
-    *actualShardVersion = metadata ? metadata->getShardVersion() : ChunkVersion::UNSHARDED();
+    // Set this for error messaging purposes before potentially returning false. Only the version
+    // is needed here, so read it without pinning the metadata.
+    *actualShardVersion = _metadataManager->getActiveShardVersion();
 
     if (_sourceMgr) {
         const bool isReader = !opCtx->lockState()->isWriteLocked();
@@ -617,6 +626,24 @@ uint64_t CollectionShardingState::_incrementChunkOnInsertOrUpdate(OperationConte
         // TODO: call ChunkSplitter here
         chunk->clearBytesWritten();
     }
+
+    const int maxWritesPerSecond = autoSplitWriteLoadThresholdPerSec.load();
+    if (maxWritesPerSecond > 0) {
+        const Seconds window(std::max(autoSplitWriteLoadWindowSecs.load(), 1));
+        auto splitKey = _writeLoadTracker.recordWrite(
+            chunk->getMin(), chunk->getMax(), shardKey, Date_t::now(), maxWritesPerSecond, window);
+        if (splitKey) {
+            try {
+                ShardingState::get(opCtx)->getChunkSplitter()->trySplitting(
+                    _nss, chunk->getMin(), chunk->getMax(), chunk->getBytesWritten(), splitKey);
+            } catch (const DBException& ex) {
+                LOG(1) << "Unable to schedule a write load split of chunk "
+                       << redact(chunk->toString()) << " in " << _nss
+                       << causedBy(redact(ex.toStatus()));
+            }
+        }
+    }
+
     return chunk->getBytesWritten();
 }
 
@@ -34,6 +34,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/s/chunk_write_load_tracker.h"
 #include "mongo/db/s/collection_range_deleter.h"
 #include "mongo/db/s/metadata_manager.h"
 #include "mongo/util/concurrency/notification.h"
@@ -305,6 +306,9 @@ private:
      * If the collection is sharded, finds the chunk that contains the specified document, and
      * increments the size tracked for that chunk by the specified amount of data written, in
      * bytes. Returns the number of total bytes on that chunk, after the data is written.
+     *
+     * When splitting by write load is enabled, also samples the write and asks the ChunkSplitter
+     * to split the chunk once it receives more writes than autoSplitWriteLoadThresholdPerSec.
      */
     uint64_t _incrementChunkOnInsertOrUpdate(OperationContext* opCtx,
                                              const BSONObj& document,
@@ -325,6 +329,9 @@ private:
     
     std::shared_ptr<MetadataManager> _metadataManager;
 
+    // Write load sampled per chunk, reset whenever the chunk metadata changes
+    ChunkWriteLoadTracker _writeLoadTracker;
+
     // If this collection is serving as a source shard for chunk migration, this value will be
     // non-null. To write this value there needs to be X-lock on the collection in order to
     // synchronize with other callers, which read it.
@@ -30,6 +30,9 @@
 
 #include "mongo/platform/basic.h"
 
+#include <map>
+#include <set>
+
 #include "mongo/bson/simple_bsonelement_comparator.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/connpool.h"
@@ -51,6 +54,7 @@
 #include "mongo/s/catalog/sharding_catalog_manager.h"
 #include "mongo/s/catalog/type_database.h"
 #include "mongo/s/catalog/type_shard.h"
+#include "mongo/s/catalog/type_tags.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/client/shard_registry.h"
@@ -324,7 +328,8 @@ void validateShardKeyAgainstExistingIndexes(OperationContext* opCtx,
     //         ii. is not a sparse index, partial index, or index with a non-simple collation
     //         iii. contains no null values
     //         iv. is not multikey (maybe lift this restriction later)
-    //         v. if a hashed index, has default seed (lift this restriction later)
+    //         v. if a hashed index, has default seed and hash version (lift this restriction
+    //            later)
     //
     // 3. If the proposed shard key is specified as unique, there must exist a useful,
     //    unique index exactly equal to the proposedKey (not just a prefix).
@@ -371,6 +376,16 @@ void validateShardKeyAgainstExistingIndexes(OperationContext* opCtx,
                                   << idx["seed"].numberInt(),
                     !shardKeyPattern.isHashedPattern() || idx["seed"].eoo() ||
                         idx["seed"].numberInt() == BSONElementHasher::DEFAULT_HASH_SEED);
+            // Likewise, mongos targets hashed shard keys with the default hash version only, so
+            // the index must use it too.
+            uassert(ErrorCodes::InvalidOptions,
+                    str::stream() << "can't shard collection " << nss.ns()
+                                  << " with hashed shard key "
+                                  << proposedKey
+                                  << " because the hashed index uses a non-default hash version of "
+                                  << idx["hashVersion"].numberInt(),
+                    !shardKeyPattern.isHashedPattern() ||
+                        idx["hashVersion"].numberInt() == BSONElementHasher::DEFAULT_HASH_VERSION);
             hasUsefulIndexForKey = true;
         }
     }
@@ -520,6 +535,209 @@ void determinePresplittingPoints(OperationContext* opCtx,
     }
 }
 
+/**
+ * For new, empty collections with zones defined on them, splits the initial chunks at the zone
+ * boundaries and assigns each chunk to a shard of the zone it falls in. Chunks outside of any zone
+ * are assigned round-robin between all shards, as are the chunks of a zone without shards. The
+ * chunks can then be created on their owning shards directly, instead of being migrated there
+ * one at a time by the balancer after the collection has been sharded.
+ *
+ * 'splitPoints' holds the split points determined so far (for hashed shard keys) and is replaced
+ * with the full, ordered set of split points. Returns the owning shard of each resulting chunk, or
+ * an empty vector if there are no zones which apply to the shard key and 'splitPoints' was left
+ * unchanged.
+ */
+std::vector<ShardId> determineZonedInitialChunks(OperationContext* opCtx,
+                                                 const NamespaceString& nss,
+                                                 const ShardKeyPattern& shardKeyPattern,
+                                                 std::vector<BSONObj>* splitPoints) {
+    const auto catalogClient = Grid::get(opCtx)->catalogClient();
+
+    std::vector<TagsType> tags;
+    uassertStatusOK(catalogClient->getTagsForCollection(opCtx, nss.ns(), &tags));
+
+    // Zone ranges may be assigned before the collection is sharded, so only the ones expressed in
+    // terms of this shard key can be honoured.
+    tags.erase(std::remove_if(tags.begin(),
+                              tags.end(),
+                              [&](const TagsType& tag) {
+                                  return !shardKeyPattern.isShardKey(tag.getMinKey()) ||
+                                      !shardKeyPattern.isShardKey(tag.getMaxKey());
+                              }),
+               tags.end());
+    if (tags.empty()) {
+        return {};
+    }
+
+    const auto shards = uassertStatusOK(catalogClient->getAllShards(
+                                            opCtx, repl::ReadConcernLevel::kMajorityReadConcern))
+                            .value;
+
+    std::vector<ShardId> allShardIds;
+    std::map<std::string, std::vector<ShardId>> zoneToShardIds;
+    for (const auto& shard : shards) {
+        if (shard.getDraining()) {
+            continue;
+        }
+
+        allShardIds.push_back(shard.getName());
+        for (const auto& zone : shard.getTags()) {
+            zoneToShardIds[zone].push_back(shard.getName());
+        }
+    }
+
+    if (allShardIds.empty()) {
+        return {};
+    }
+
+    const KeyPattern& keyPattern = shardKeyPattern.getKeyPattern();
+    const BSONObj globalMin = keyPattern.globalMin();
+    const BSONObj globalMax = keyPattern.globalMax();
+
+    auto orderedPoints = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    orderedPoints.insert(splitPoints->begin(), splitPoints->end());
+    for (const auto& tag : tags) {
+        for (const auto& bound : {tag.getMinKey(), tag.getMaxKey()}) {
+            if (bound.woCompare(globalMin) != 0 && bound.woCompare(globalMax) != 0) {
+                orderedPoints.insert(bound);
+            }
+        }
+    }
+
+    splitPoints->assign(orderedPoints.begin(), orderedPoints.end());
+
+    std::vector<ShardId> chunkShardIds;
+    std::map<std::string, size_t> zoneNextShard;
+    size_t nextShard = 0;
+
+    for (size_t i = 0; i <= splitPoints->size(); i++) {
+        const BSONObj& min = (i == 0) ? globalMin : (*splitPoints)[i - 1];
+        const BSONObj& max = (i < splitPoints->size()) ? (*splitPoints)[i] : globalMax;
+
+        // Every zone boundary is a split point, so a chunk is either fully inside one zone or
+        // outside all of them.
+        const auto tagIt = std::find_if(tags.begin(), tags.end(), [&](const TagsType& tag) {
+            return tag.getMinKey().woCompare(min) <= 0 && max.woCompare(tag.getMaxKey()) <= 0;
+        });
+
+        const auto zoneShardsIt = (tagIt == tags.end()) ? zoneToShardIds.end()
+                                                        : zoneToShardIds.find(tagIt->getTag());
+        if (zoneShardsIt == zoneToShardIds.end()) {
+            chunkShardIds.push_back(allShardIds[nextShard++ % allShardIds.size()]);
+        } else {
+            const auto& zoneShardIds = zoneShardsIt->second;
+            chunkShardIds.push_back(
+                zoneShardIds[zoneNextShard[zoneShardsIt->first]++ % zoneShardIds.size()]);
+        }
+    }
+
+    return chunkShardIds;
+}
+
+/**
+ * Creates the collection, with the same UUID, options and indexes it has on the primary shard, on
+ * each of the shards in 'shardIds' other than the primary shard. This is what the recipient of a
+ * chunk migration would do before receiving its first chunk.
+ *
+ * Returns false without doing anything further if the collection already exists on one of the
+ * shards, in which case the initial chunks should not be assigned to it directly.
+ */
+bool createCollectionOnShards(OperationContext* opCtx,
+                              const NamespaceString& nss,
+                              const boost::optional<UUID>& uuid,
+                              const ShardId& primaryShardId,
+                              ScopedDbConnection& conn,
+                              const std::vector<ShardId>& shardIds) {
+    std::set<ShardId> targetShardIds(shardIds.begin(), shardIds.end());
+    targetShardIds.erase(primaryShardId);
+    if (targetShardIds.empty()) {
+        return true;
+    }
+
+    const auto collInfos =
+        conn->getCollectionInfos(nss.db().toString(), BSON("name" << nss.coll()));
+    uassert(ErrorCodes::NamespaceNotFound,
+            str::stream() << "collection " << nss.ns() << " was dropped from the primary shard "
+                          << primaryShardId
+                          << " while being sharded",
+            collInfos.size() == 1);
+
+    BSONObjBuilder createCmdBuilder;
+    createCmdBuilder.append("create", nss.coll());
+    createCmdBuilder.appendElements(collInfos.front()["options"].Obj());
+    const BSONObj createCmd = createCmdBuilder.obj();
+
+    // The _id index is created along with the collection
+    std::vector<BSONObj> indexSpecs;
+    for (const auto& indexSpec : conn->getIndexSpecs(nss.ns())) {
+        if (indexSpec["name"].String() != "_id_") {
+            indexSpecs.push_back(indexSpec);
+        }
+    }
+
+    const auto shardRegistry = Grid::get(opCtx)->shardRegistry();
+
+    for (const auto& shardId : targetShardIds) {
+        const auto shard = uassertStatusOK(shardRegistry->getShard(opCtx, shardId));
+
+        // Collections of a sharded collection must have the same UUID on all shards, which only
+        // applyOps allows to specify.
+        BSONObj cmdObj;
+        std::string dbName;
+        if (uuid) {
+            BSONObjBuilder createOp;
+            createOp.append("op", "c");
+            createOp.append("ns", nss.getCommandNS().ns());
+            uuid->appendToBuilder(&createOp, "ui");
+            createOp.append("o", createCmd);
+
+            cmdObj = BSON("applyOps" << BSON_ARRAY(createOp.obj()) << "writeConcern"
+                                     << WriteConcernOptions::Majority);
+            dbName = "admin";
+        } else {
+            cmdObj = createCmd.addField(
+                BSON("writeConcern" << WriteConcernOptions::Majority).firstElement());
+            dbName = nss.db().toString();
+        }
+
+        auto createResponse = uassertStatusOK(shard->runCommandWithFixedRetryAttempts(
+            opCtx,
+            ReadPreferenceSetting(ReadPreference::PrimaryOnly),
+            dbName,
+            cmdObj,
+            Shard::RetryPolicy::kNoRetry));
+        if (createResponse.commandStatus == ErrorCodes::NamespaceExists) {
+            log() << "not assigning initial chunks of " << nss << " to shard " << shardId
+                  << " because the collection already exists on it";
+            return false;
+        }
+        uassertStatusOK(createResponse.commandStatus);
+        uassertStatusOK(createResponse.writeConcernStatus);
+
+        if (indexSpecs.empty()) {
+            continue;
+        }
+
+        BSONArrayBuilder indexesBuilder;
+        for (const auto& indexSpec : indexSpecs) {
+            indexesBuilder.append(indexSpec);
+        }
+
+        auto indexesResponse = uassertStatusOK(shard->runCommandWithFixedRetryAttempts(
+            opCtx,
+            ReadPreferenceSetting(ReadPreference::PrimaryOnly),
+            nss.db().toString(),
+            BSON("createIndexes" << nss.coll() << "indexes" << indexesBuilder.arr()
+                                 << "writeConcern"
+                                 << WriteConcernOptions::Majority),
+            Shard::RetryPolicy::kIdempotent));
+        uassertStatusOK(indexesResponse.commandStatus);
+        uassertStatusOK(indexesResponse.writeConcernStatus);
+    }
+
+    return true;
+}
+
 /**
  * Migrates the initial "big chunks" from the primary shard to spread them evenly across the shards.
  *
@@ -870,6 +1088,24 @@ public:
                                     &initSplits,
                                     &allSplits);
 
+        // On empty collections, the chunks of zones are created directly on the zones' shards.
+        // For hashed shard keys this takes all the split points at once, rather than splitting
+        // the "big chunks" after they have been migrated.
+        std::vector<ShardId> initChunkShardIds;
+        if (isEmpty && !request.getInitialSplitPoints()) {
+            std::vector<BSONObj> zonedSplits = allSplits;
+            initChunkShardIds =
+                determineZonedInitialChunks(opCtx, nss, shardKeyPattern, &zonedSplits);
+            if (!initChunkShardIds.empty() &&
+                createCollectionOnShards(
+                    opCtx, nss, uuid, primaryShardId, conn, initChunkShardIds)) {
+                initSplits = std::move(zonedSplits);
+                allSplits.clear();
+            } else {
+                initChunkShardIds.clear();
+            }
+        }
+
         LOG(0) << "CMD: shardcollection: " << cmdObj;
 
         audit::logShardCollection(Client::getCurrent(), nss.ns(), proposedKey, request.getUnique());
@@ -889,6 +1125,7 @@ public:
                                         request.getUnique(),
                                         initSplits,
                                         distributeInitialChunks,
+                                        initChunkShardIds,
                                         primaryShardId);
         result << "collectionsharded" << nss.ns();
         if (uuid) {
@@ -903,9 +1140,12 @@ public:
         dbDistLock.reset();
         backwardsCompatibleDbDistLock.reset();
 
-        // Step 7. Migrate initial chunks to distribute them across shards.
-        migrateAndFurtherSplitInitialChunks(
-            opCtx, nss, numShards, shardIds, isEmpty, shardKeyPattern, allSplits);
+        // Step 7. Migrate initial chunks to distribute them across shards, unless they were
+        // already created on their zones' shards.
+        if (initChunkShardIds.empty()) {
+            migrateAndFurtherSplitInitialChunks(
+                opCtx, nss, numShards, shardIds, isEmpty, shardKeyPattern, allSplits);
+        }
 
         return true;
     }
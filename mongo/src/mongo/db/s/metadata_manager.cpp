@@ -32,6 +32,8 @@
 
 #include "mongo/db/s/metadata_manager.h"
 
+#include <cstring>
+
 #include "mongo/base/string_data.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/bson/util/builder.h"
@@ -43,6 +45,7 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -193,6 +196,31 @@ ScopedCollectionMetadata MetadataManager::getActiveMetadata(std::shared_ptr<Meta
     return ScopedCollectionMetadata();
 }
 
+ChunkVersion MetadataManager::getActiveShardVersion() const {
+    while (true) {
+        const uint32_t sequence = _publishedSequence.load();
+        if (sequence & 1) {
+            // The version is being published right now
+            stdx::this_thread::yield();
+            continue;
+        }
+
+        const uint64_t combinedVersion = _publishedCombinedVersion.load();
+        const uint64_t epochPrefix = _publishedEpochPrefix.load();
+        const uint32_t epochSuffix = _publishedEpochSuffix.load();
+
+        if (_publishedSequence.load() != sequence) {
+            continue;
+        }
+
+        unsigned char epochBytes[OID::kOIDSize];
+        std::memcpy(epochBytes, &epochPrefix, sizeof(epochPrefix));
+        std::memcpy(epochBytes + sizeof(epochPrefix), &epochSuffix, sizeof(epochSuffix));
+
+        return ChunkVersion::fromDeprecatedLong(combinedVersion, OID(epochBytes));
+    }
+}
+
 size_t MetadataManager::numberOfMetadataSnapshots() const {
     stdx::lock_guard<stdx::mutex> lg(_managerLock);
     if (_metadata.empty())
@@ -222,6 +250,7 @@ void MetadataManager::refreshActiveMetadata(std::unique_ptr<CollectionMetadata>
         _receivingChunks.clear();
         _clearAllCleanups(lg);
         _metadata.clear();
+        _publishActiveShardVersion(lg);
         return;
     }
 
@@ -286,9 +315,31 @@ void MetadataManager::refreshActiveMetadata(std::unique_ptr<CollectionMetadata>
 
 void MetadataManager::_setActiveMetadata(WithLock wl, CollectionMetadata newMetadata) {
     _metadata.emplace_back(std::make_shared<CollectionMetadataTracker>(std::move(newMetadata)));
+    _publishActiveShardVersion(wl);
     _retireExpiredMetadata(wl);
 }
 
+void MetadataManager::_publishActiveShardVersion(WithLock) {
+    const ChunkVersion shardVersion = _metadata.empty()
+        ? ChunkVersion::UNSHARDED()
+        : _metadata.back()->metadata.getShardVersion();
+    const OID epoch = shardVersion.epoch();
+    MONGO_STATIC_ASSERT(OID::kOIDSize == sizeof(uint64_t) + sizeof(uint32_t));
+
+    uint64_t epochPrefix;
+    uint32_t epochSuffix;
+    std::memcpy(&epochPrefix, epoch.view().view(), sizeof(epochPrefix));
+    std::memcpy(&epochSuffix, epoch.view().view() + sizeof(epochPrefix), sizeof(epochSuffix));
+
+    // Writers are serialized by _managerLock, so the sequence only needs to be made odd for the
+    // duration of the update
+    _publishedSequence.fetchAndAdd(1);
+    _publishedCombinedVersion.store(shardVersion.toLong());
+    _publishedEpochPrefix.store(epochPrefix);
+    _publishedEpochSuffix.store(epochSuffix);
+    _publishedSequence.fetchAndAdd(1);
+}
+
 void MetadataManager::_retireExpiredMetadata(WithLock lock) {
     while (_metadata.size() > 1 && !_metadata.front()->usageCounter) {
         if (!_metadata.front()->orphans.empty()) {
@@ -38,6 +38,7 @@
 #include "mongo/db/s/collection_range_deleter.h"
 #include "mongo/db/service_context.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/concurrency/notification.h"
@@ -70,6 +71,15 @@ public:
      */
     ScopedCollectionMetadata getActiveMetadata(std::shared_ptr<MetadataManager> self);
 
+    /**
+     * Returns the shard version of the active metadata, or UNSHARDED if there is none.
+     *
+     * Unlike getActiveMetadata, this neither takes the manager lock nor pins the metadata, so it is
+     * suitable for checking the version of every operation. The version may be stale by the time
+     * it is used, just like that of a snapshot which has already been released.
+     */
+    ChunkVersion getActiveShardVersion() const;
+
     /**
      * Returns the number of CollectionMetadata objects being maintained on behalf of running
      * queries.  The actual number may vary after it returns, so this is really only useful for unit
@@ -190,6 +200,12 @@ private:
      */
     void _retireExpiredMetadata(WithLock);
 
+    /**
+     * Publishes the shard version of the active metadata for getActiveShardVersion. Must be called
+     * after every change to _metadata.back().
+     */
+    void _publishActiveShardVersion(WithLock);
+
     /**
      * Pushes current set of chunks, if any, to _metadataInUse, replaces it with newMetadata.
      */
@@ -247,6 +263,14 @@ private:
     // The background task that deletes documents from orphaned chunk ranges.
     executor::TaskExecutor* const _executor;
 
+    // Shard version of _metadata.back(), published under a sequence lock so that version checks do
+    // not contend on _managerLock. Written only under _managerLock, by _publishActiveShardVersion.
+    // The sequence is odd while an update is in progress.
+    AtomicUInt32 _publishedSequence{0};
+    AtomicUInt64 _publishedCombinedVersion{0};
+    AtomicUInt64 _publishedEpochPrefix{0};
+    AtomicUInt32 _publishedEpochSuffix{0};
+
     // Mutex to protect the state below
     mutable stdx::mutex _managerLock;
 
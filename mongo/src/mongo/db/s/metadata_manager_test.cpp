@@ -307,6 +307,30 @@ TEST_F(MetadataManagerTest, RefreshMetadataAfterDropAndRecreate) {
     ASSERT_BSONOBJ_EQ(BSON("key" << 30), chunkEntry->second);
 }
 
+TEST_F(MetadataManagerTest, ActiveShardVersionFollowsRefreshes) {
+    ASSERT_EQ(ChunkVersion::UNSHARDED(), _manager->getActiveShardVersion());
+
+    _manager->refreshActiveMetadata(makeEmptyMetadata());
+    ASSERT_EQ(_manager->getActiveMetadata(_manager)->getShardVersion(),
+              _manager->getActiveShardVersion());
+
+    _manager->refreshActiveMetadata(cloneMetadataPlusChunk(
+        *_manager->getActiveMetadata(_manager).getMetadata(), BSON("key" << 0), BSON("key" << 10)));
+    const auto shardVersion = _manager->getActiveShardVersion();
+    ASSERT_EQ(_manager->getActiveMetadata(_manager)->getShardVersion(), shardVersion);
+    ASSERT(shardVersion.isSet());
+
+    // Pretend that the collection was dropped and recreated, which changes the epoch
+    _manager->refreshActiveMetadata(cloneMetadataPlusChunk(
+        *makeEmptyMetadata(), BSON("key" << 20), BSON("key" << 30)));
+    ASSERT_EQ(_manager->getActiveMetadata(_manager)->getShardVersion(),
+              _manager->getActiveShardVersion());
+    ASSERT_NE(shardVersion.epoch(), _manager->getActiveShardVersion().epoch());
+
+    _manager->refreshActiveMetadata(nullptr);
+    ASSERT_EQ(ChunkVersion::UNSHARDED(), _manager->getActiveShardVersion());
+}
+
 // Tests membership functions for _rangesToClean
 TEST_F(MetadataManagerTest, RangesToCleanMembership) {
     _manager->refreshActiveMetadata(makeEmptyMetadata());
@@ -483,12 +483,19 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
                                                         BSONArrayBuilder* arrBuilder) {
     dassert(opCtx->lockState()->isCollectionLockedForMode(_args.getNss().ns(), MODE_IS));
 
+    // Only bound the batch by the time it holds the collection lock and by its size, rather than
+    // also by the number of documents, so that each round trip to the recipient carries as many
+    // documents as it can
     ElapsedTracker tracker(opCtx->getServiceContext()->getFastClockSource(),
-                           internalQueryExecYieldIterations.load(),
+                           std::numeric_limits<int32_t>::max(),
                            Milliseconds(internalQueryExecYieldPeriodMS.load()));
 
     stdx::lock_guard<stdx::mutex> sl(_mutex);
 
+    // The record ids are visited in record store order, so reuse a single cursor to fetch them
+    // rather than open a new one for every document
+    auto cursor = collection->getCursor(opCtx);
+
     std::set<RecordId>::iterator it;
 
     for (it = _cloneLocs.begin(); it != _cloneLocs.end(); ++it) {
@@ -498,16 +505,18 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
             break;
         }
 
-        Snapshotted<BSONObj> doc;
-        if (collection->findDoc(opCtx, *it, &doc)) {
+        auto record = cursor->seekExact(*it);
+        if (record) {
+            const BSONObj doc = record->data.toBson();
+
             // Use the builder size instead of accumulating the document sizes directly so that we
             // take into consideration the overhead of BSONArray indices.
             if (arrBuilder->arrSize() &&
-                (arrBuilder->len() + doc.value().objsize() + 1024) > BSONObjMaxUserSize) {
+                (arrBuilder->len() + doc.objsize() + 1024) > BSONObjMaxUserSize) {
                 break;
             }
 
-            arrBuilder->append(doc.value());
+            arrBuilder->append(doc);
         }
     }
 
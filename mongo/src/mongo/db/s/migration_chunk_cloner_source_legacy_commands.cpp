@@ -52,8 +52,8 @@ namespace {
 
 /**
  * Shortcut class to perform the appropriate checks and acquire the cloner associated with the
- * currently active migration. Uses the currently registered migration for this shard and ensures
- * the session ids match.
+ * currently active migration. Looks among the migrations currently registered for this shard for
+ * the one whose session id matches.
  */
 class AutoGetActiveCloner {
     MONGO_DISALLOW_COPYING(AutoGetActiveCloner);
@@ -62,32 +62,45 @@ public:
     AutoGetActiveCloner(OperationContext* opCtx, const MigrationSessionId& migrationSessionId) {
         ShardingState* const gss = ShardingState::get(opCtx);
 
-        const auto nss = gss->getActiveDonateChunkNss();
-        uassert(ErrorCodes::NotYetInitialized, "No active migrations were found", nss);
+        const auto namespaces = gss->getActiveDonateChunkNamespaces();
+        uassert(
+            ErrorCodes::NotYetInitialized, "No active migrations were found", !namespaces.empty());
 
-        // Once the collection is locked, the migration status cannot change
-        _autoColl.emplace(opCtx, *nss, MODE_IS);
+        std::string activeSessionId;
 
-        uassert(ErrorCodes::NamespaceNotFound,
-                str::stream() << "Collection " << nss->ns() << " does not exist",
-                _autoColl->getCollection());
+        for (const auto& nss : namespaces) {
+            // Once the collection is locked, the migration status cannot change
+            _autoColl.emplace(opCtx, nss, MODE_IS);
 
-        auto css = CollectionShardingState::get(opCtx, *nss);
-        uassert(ErrorCodes::IllegalOperation,
-                str::stream() << "No active migrations were found for collection " << nss->ns(),
-                css && css->getMigrationSourceManager());
+            uassert(ErrorCodes::NamespaceNotFound,
+                    str::stream() << "Collection " << nss.ns() << " does not exist",
+                    _autoColl->getCollection());
 
-        // It is now safe to access the cloner
-        _chunkCloner = dynamic_cast<MigrationChunkClonerSourceLegacy*>(
-            css->getMigrationSourceManager()->getCloner());
-        invariant(_chunkCloner);
+            auto css = CollectionShardingState::get(opCtx, nss);
+            uassert(ErrorCodes::IllegalOperation,
+                    str::stream() << "No active migrations were found for collection " << nss.ns(),
+                    css && css->getMigrationSourceManager());
+
+            // It is now safe to access the cloner
+            _chunkCloner = dynamic_cast<MigrationChunkClonerSourceLegacy*>(
+                css->getMigrationSourceManager()->getCloner());
+            invariant(_chunkCloner);
+
+            if (migrationSessionId.matches(_chunkCloner->getSessionId())) {
+                return;
+            }
+
+            activeSessionId = _chunkCloner->getSessionId().toString();
+            _chunkCloner = nullptr;
+            _autoColl.reset();
+        }
 
         // Ensure the session ids are correct
-        uassert(ErrorCodes::IllegalOperation,
-                str::stream() << "Requested migration session id " << migrationSessionId.toString()
-                              << " does not match active session id "
-                              << _chunkCloner->getSessionId().toString(),
-                migrationSessionId.matches(_chunkCloner->getSessionId()));
+        uasserted(ErrorCodes::IllegalOperation,
+                  str::stream() << "Requested migration session id "
+                                << migrationSessionId.toString()
+                                << " does not match active session id "
+                                << activeSessionId);
     }
 
     Database* getDb() const {
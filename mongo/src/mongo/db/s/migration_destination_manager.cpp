@@ -43,6 +43,7 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/catalog/index_create.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/namespace_string.h"
@@ -56,6 +57,7 @@
 #include "mongo/db/s/migration_util.h"
 #include "mongo/db/s/move_timing_helper.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/client/shard_registry.h"
@@ -219,6 +221,40 @@ MONGO_FP_DECLARE(migrateThreadHangAtStep6);
 MONGO_FP_DECLARE(failMigrationLeaveOrphans);
 MONGO_FP_DECLARE(failMigrationReceivedOutOfRangeOperation);
 
+// Number of cloned documents to insert per storage transaction. Zero inserts each batch received
+// from the donor at once.
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneInsertionBatchSize, int, 0);
+
+// Caps the rate at which all the migrations this shard concurrently receives together clone
+// documents from their donors. Zero disables the limit.
+MONGO_EXPORT_SERVER_PARAMETER(migrationReceiveBandwidthMBPerSec, int, 0);
+
+// Protects 'cloneBandwidthNextAvailable'
+stdx::mutex cloneBandwidthMutex;
+
+// Time at which the bandwidth reserved by the receiving migrations so far has been used up
+Date_t cloneBandwidthNextAvailable;
+
+/**
+ * Reserves the bandwidth to clone 'bytes' more bytes out of the budget, which all migrations this
+ * shard receives share, and returns how long the caller must wait before cloning more.
+ */
+Milliseconds reserveCloneBandwidth(long long bytes) {
+    const long long limitMBPerSec = migrationReceiveBandwidthMBPerSec.load();
+    if (limitMBPerSec <= 0) {
+        return Milliseconds(0);
+    }
+
+    const Milliseconds cost(bytes * 1000 / (limitMBPerSec * 1024 * 1024));
+
+    stdx::lock_guard<stdx::mutex> lk(cloneBandwidthMutex);
+    const Date_t now = Date_t::now();
+    const Date_t start = std::max(now, cloneBandwidthNextAvailable);
+    cloneBandwidthNextAvailable = start + cost;
+
+    return start - now;
+}
+
 }  // namespace
 
 MigrationDestinationManager::MigrationDestinationManager() = default;
@@ -269,6 +305,11 @@ bool MigrationDestinationManager::_isActive(WithLock) const {
     return _sessionId.is_initialized();
 }
 
+bool MigrationDestinationManager::isLastSession(const MigrationSessionId& sessionId) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _lastSessionId && _lastSessionId->matches(sessionId);
+}
+
 //I SHARDING [conn3236631] moveChunk data transfer progress: { waited: true, active: true, sessionId: "ocloud_WbUiXohI_shard_1_ocloud_WbUiXohI_shard_9_5ef1b996f5dee0bd14574259", ns: "ocloud_cold_data_db.ocloud_cold_data_t", from: "ocloud_WbUiXohI_shard_1/10.64.54.4:20001,10.64.54.5:20001,10.64.54.6:20001", min: { user_id: "287141771", module: "album", md5: "C7CB3C95FAEF5B4BC28CF8BDF390CDAF" }, max: { user_id: "287145627", module: "album", md5: "F24CCFC32D07001F742FFE0245F5064A" }, shardKeyPattern: { user_id: 1.0, module: 1.0, md5: 1.0 }, state: "clone", counts: { cloned: 0, clonedBytes: 0, catchup: 0, steady: 0 }, ok: 1.0, operationTime: Timestamp(1592899984, 55), $gleStats: { lastOpTime: Timestamp(0, 0), electionId: ObjectId('7fffffff0000000000000004') }, $configServerState: { opTime: { ts: Timestamp(1592899992, 1), t: 13 } }, $clusterTime: { clusterTime: Timestamp(1592899992, 2), signature: { hash: BinData(0, 0000000000000000000000000000000000000000), keyId: 0 } } } mem used: 0 documents remaining to clone: 51880
 //ÿǨһݾʹӡһ
 void MigrationDestinationManager::report(BSONObjBuilder& b) {
@@ -347,6 +388,7 @@ Status MigrationDestinationManager::start(const NamespaceString& nss,
     _numSteady = 0;
 
     _sessionId = sessionId;
+    _lastSessionId = sessionId;
     _scopedRegisterReceiveChunk = std::move(scopedRegisterReceiveChunk);
 
     // TODO: If we are here, the migrate thread must have completed, otherwise _active above
@@ -677,6 +719,9 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
                 return;
             }
 
+            // Create the indexes while the collection is empty, so that the cloned documents are
+            // indexed as they are inserted rather than by a foreground build under the database
+            // lock once the clone is done.
             auto indexInfoObjs = indexer.init(donorIndexSpecs);
             if (!indexInfoObjs.isOK()) {
                 setStateFailWarn(str::stream() << "failed to create index before migrating data. "
@@ -756,38 +801,73 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
                     return;
                 }
 
-                BSONObj docToClone = i.next().Obj();
+                const int batchMaxCloned = migrateCloneInsertionBatchSize.load();
+                int batchNumCloned = 0;
+                long long batchClonedBytes = 0;
                 {
                     OldClientWriteContext cx(opCtx, _nss.ns());
 
-                    BSONObj localDoc;
-                    if (willOverrideLocalId(opCtx,
-                                            _nss,
-                                            min,
-                                            max,
-                                            shardKeyPattern,
-                                            cx.db(),
-                                            docToClone,
-                                            &localDoc)) {
-                        string errMsg = str::stream() << "cannot migrate chunk, local document "
-                                                      << redact(localDoc)
-                                                      << " has same _id as cloned "
-                                                      << "remote document " << redact(docToClone);
-
-                        warning() << errMsg;
-
-                        // Exception will abort migration cleanly
-                        uasserted(16976, errMsg);
+                    std::vector<InsertStatement> toInsert;
+                    while (i.more() && (batchMaxCloned <= 0 || batchNumCloned < batchMaxCloned)) {
+                        BSONObj docToClone = i.next().Obj();
+
+                        BSONObj localDoc;
+                        if (willOverrideLocalId(opCtx,
+                                                _nss,
+                                                min,
+                                                max,
+                                                shardKeyPattern,
+                                                cx.db(),
+                                                docToClone,
+                                                &localDoc)) {
+                            string errMsg = str::stream()
+                                << "cannot migrate chunk, local document " << redact(localDoc)
+                                << " has same _id as cloned "
+                                << "remote document " << redact(docToClone);
+
+                            warning() << errMsg;
+
+                            // Exception will abort migration cleanly
+                            uasserted(16976, errMsg);
+                        }
+
+                        batchNumCloned++;
+                        batchClonedBytes += docToClone.objsize();
+
+                        // A copy of the document left inside the range cannot be inserted over
+                        if (!localDoc.isEmpty()) {
+                            Helpers::upsert(opCtx, _nss.ns(), docToClone, true);
+                            continue;
+                        }
+
+                        toInsert.emplace_back(docToClone);
                     }
 
-                    Helpers::upsert(opCtx, _nss.ns(), docToClone, true);
+                    if (!toInsert.empty()) {
+                        writeConflictRetry(opCtx, "migrateCloneBatch", _nss.ns(), [&] {
+                            Collection* const collection = cx.getCollection();
+                            uassert(ErrorCodes::NamespaceNotFound,
+                                    str::stream() << "Collection " << _nss.ns()
+                                                  << " was dropped while cloning",
+                                    collection);
+
+                            WriteUnitOfWork wuow(opCtx);
+                            uassertStatusOK(collection->insertDocuments(opCtx,
+                                                                        toInsert.begin(),
+                                                                        toInsert.end(),
+                                                                        nullptr,
+                                                                        false,
+                                                                        true /* fromMigrate */));
+                            wuow.commit();
+                        });
+                    }
                 }
-                thisTime++;
+                thisTime += batchNumCloned;
 
                 {
                     stdx::lock_guard<stdx::mutex> statsLock(_mutex);
-                    _numCloned++;
-                    _clonedBytes += docToClone.objsize();
+                    _numCloned += batchNumCloned;
+                    _clonedBytes += batchClonedBytes;
                 }
 
                 if (writeConcern.shouldWaitForOtherNodes()) {
@@ -807,6 +887,9 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
 
             if (thisTime == 0)
                 break;
+
+            // Leave the bandwidth to the other migrations if they have used up the shared budget
+            opCtx->sleepFor(reserveCloneBandwidth(arr.objsize()));
         }
 
         timing.done(3);
@@ -58,7 +58,8 @@ class OpTime;
 }
 
 /**
- * Drives the receiving side of the MongoD migration process. One instance exists per shard.
+ * Drives the receiving side of the MongoD migration process. One instance exists per receive slot
+ * of the shard's active migrations registry, so a shard can receive several chunks concurrently.
  */ 
 //MigrationSourceManagerMigrationDestinationManagerӦ
  //ݿǨ
@@ -89,6 +90,12 @@ public:
      */
     bool isActive() const;
 
+    /**
+     * Returns whether the specified session id is that of the migration this manager is running
+     * or, if it is idle, of the last one it ran.
+     */
+    bool isLastSession(const MigrationSessionId& sessionId) const;
+
     /**
      * Reports the state of the migration manager as a BSON document.
      */
@@ -195,6 +202,10 @@ private:
     boost::optional<MigrationSessionId> _sessionId;
     boost::optional<ScopedRegisterReceiveChunk> _scopedRegisterReceiveChunk;
 
+    // Session ID of the migration last started on this manager. Unlike '_sessionId' it is kept
+    // after the migration completes, so that the donor can still be sent its outcome.
+    boost::optional<MigrationSessionId> _lastSessionId;
+
     // A condition variable on which to wait for the prepare method to be called.
     stdx::condition_variable _isActiveCV;
 
@@ -143,7 +143,8 @@ public:
             uassertStatusOK(shardingState->registerReceiveChunk(nss, chunkRange, fromShard)));
 
 		//MigrationDestinationManager::start
-        uassertStatusOK(shardingState->migrationDestinationManager()->start(
+        const int slot = scopedRegisterReceiveChunk.getSlot();
+        uassertStatusOK(shardingState->migrationDestinationManager(slot)->start(
             nss,
             std::move(scopedRegisterReceiveChunk),
             migrationSessionId,
@@ -194,7 +195,15 @@ public:
              const string&,
              const BSONObj& cmdObj,
              BSONObjBuilder& result) {
-        ShardingState::get(opCtx)->migrationDestinationManager()->report(result);
+        auto const shardingState = ShardingState::get(opCtx);
+
+        // Requests without a session id come from donors, which do not migrate concurrently
+        auto migrationSessionIdStatus(MigrationSessionId::extractFromBSON(cmdObj));
+        auto const mdm = migrationSessionIdStatus.isOK()
+            ? shardingState->migrationDestinationManager(migrationSessionIdStatus.getValue())
+            : shardingState->migrationDestinationManager(0);
+
+        mdm->report(result);
         return true;
     }
 
@@ -234,7 +243,7 @@ public:
              const BSONObj& cmdObj,
              BSONObjBuilder& result) {
         auto const sessionId = uassertStatusOK(MigrationSessionId::extractFromBSON(cmdObj));
-        auto mdm = ShardingState::get(opCtx)->migrationDestinationManager();
+        auto mdm = ShardingState::get(opCtx)->migrationDestinationManager(sessionId);
         Status const status = mdm->startCommit(sessionId);
         mdm->report(result);
         if (!status.isOK()) {
@@ -279,11 +288,13 @@ public:
              const string&,
              const BSONObj& cmdObj,
              BSONObjBuilder& result) {
-        auto const mdm = ShardingState::get(opCtx)->migrationDestinationManager();
+        auto const shardingState = ShardingState::get(opCtx);
 
         auto migrationSessionIdStatus(MigrationSessionId::extractFromBSON(cmdObj));
 
         if (migrationSessionIdStatus.isOK()) {
+            auto const mdm =
+                shardingState->migrationDestinationManager(migrationSessionIdStatus.getValue());
             Status const status = mdm->abort(migrationSessionIdStatus.getValue());
             mdm->report(result);
             if (!status.isOK()) {
@@ -291,8 +302,10 @@ public:
                 return appendCommandStatus(result, status);
             }
         } else if (migrationSessionIdStatus == ErrorCodes::NoSuchKey) {
-            mdm->abortWithoutSessionIdCheck();
-            mdm->report(result);
+            for (auto& mdm : shardingState->migrationDestinationManagers()) {
+                mdm.abortWithoutSessionIdCheck();
+            }
+            shardingState->migrationDestinationManager(0)->report(result);
         }
         uassertStatusOK(migrationSessionIdStatus.getStatus());
         return true;
@@ -585,8 +585,19 @@ StatusWith<ScopedRegisterReceiveChunk> ShardingState::registerReceiveChunk(
 	return _activeMigrationsRegistry.registerReceiveChunk(nss, chunkRange, fromShardId);
 }
 
-boost::optional<NamespaceString> ShardingState::getActiveDonateChunkNss() {
-    return _activeMigrationsRegistry.getActiveDonateChunkNss();
+std::vector<NamespaceString> ShardingState::getActiveDonateChunkNamespaces() {
+    return _activeMigrationsRegistry.getActiveDonateChunkNamespaces();
+}
+
+MigrationDestinationManager* ShardingState::migrationDestinationManager(
+    const MigrationSessionId& sessionId) {
+    for (auto& mdm : _migrationDestManagers) {
+        if (mdm.isLastSession(sessionId)) {
+            return &mdm;
+        }
+    }
+
+    return &_migrationDestManagers[0];
 }
 
 BSONObj ShardingState::getActiveMigrationStatusReport(OperationContext* opCtx) {
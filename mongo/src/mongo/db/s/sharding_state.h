@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -185,8 +186,28 @@ public:
 
     std::string getShardName();
 
-    MigrationDestinationManager* migrationDestinationManager() {
-        return &_migrationDestManager;
+    /**
+     * Returns the migration destination manager, which drives the receive operation registered in
+     * the specified slot of the active migrations registry.
+     */
+    MigrationDestinationManager* migrationDestinationManager(int slot) {
+        invariant(slot >= 0 && slot < ActiveMigrationsRegistry::kMaxConcurrentMigrations);
+        return &_migrationDestManagers[slot];
+    }
+
+    /**
+     * Returns the migration destination manager, which is running or last ran the migration with
+     * the specified session id. If there is none, returns the manager of the first slot, so that
+     * callers report on and reject stale sessions the same way a single manager would.
+     */
+    MigrationDestinationManager* migrationDestinationManager(const MigrationSessionId& sessionId);
+
+    /**
+     * Returns the migration destination managers of all slots.
+     */
+    std::array<MigrationDestinationManager, ActiveMigrationsRegistry::kMaxConcurrentMigrations>&
+    migrationDestinationManagers() {
+        return _migrationDestManagers;
     }
 
     /**
@@ -280,9 +301,9 @@ public:
                                            const std::string& newConnectionString);
 
     /**
-     * If there are no migrations running on this shard, registers an active migration with the
-     * specified arguments and returns a ScopedRegisterDonateChunk, which must be signaled by the
-     * caller before it goes out of scope.
+     * If the active migrations registry admits another donation, registers an active migration
+     * with the specified arguments and returns a ScopedRegisterDonateChunk, which must be signaled
+     * by the caller before it goes out of scope.
      *
      * If there is an active migration already running on this shard and it has the exact same
      * arguments, returns a ScopedRegisterDonateChunk, which can be used to join the existing one.
@@ -292,9 +313,9 @@ public:
     StatusWith<ScopedRegisterDonateChunk> registerDonateChunk(const MoveChunkRequest& args);
 
     /**
-     * If there are no migrations running on this shard, registers an active receive operation with
-     * the specified session id and returns a ScopedRegisterReceiveChunk, which will unregister it
-     * when it goes out of scope.
+     * If the active migrations registry admits another receive operation, registers one with the
+     * specified arguments and returns a ScopedRegisterReceiveChunk, which will unregister it when
+     * it goes out of scope.
      *
      * Otherwise returns a ConflictingOperationInProgress error.
      */
@@ -303,13 +324,13 @@ public:
                                                                 const ShardId& fromShardId);
 
     /**
-     * If a migration has been previously registered through a call to registerDonateChunk returns
-     * that namespace. Otherwise returns boost::none.
+     * Returns the namespaces of the migrations, which have been previously registered through a
+     * call to registerDonateChunk and are still active.
      *
-     * This method can be called without any locks, but once the namespace is fetched it needs to be
+     * This method can be called without any locks, but once a namespace is fetched it needs to be
      * re-checked after acquiring some intent lock on that namespace.
      */
-    boost::optional<NamespaceString> getActiveDonateChunkNss();
+    std::vector<NamespaceString> getActiveDonateChunkNamespaces();
 
     /**
      * Get a migration status report from the migration registry. If no migration is active, this
@@ -389,8 +410,9 @@ private:
      */
     ChunkVersion _refreshMetadata(OperationContext* opCtx, const NamespaceString& nss);
 
-    // Manages the state of the migration recipient shard
-    MigrationDestinationManager _migrationDestManager;
+    // Manage the state of the migration recipient shard, one per receive slot
+    std::array<MigrationDestinationManager, ActiveMigrationsRegistry::kMaxConcurrentMigrations>
+        _migrationDestManagers;
 
     // Tracks the active move chunk operations running on this shard
     ActiveMigrationsRegistry _activeMigrationsRegistry;
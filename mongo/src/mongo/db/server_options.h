@@ -80,7 +80,7 @@ struct ServerGlobalParams {
     //net.transportLayer
     std::string transportLayer;   // --transportLayer (must be either "asio" or "legacy")
 
-    // --serviceExecutor ("adaptive", "synchronous")
+    // --serviceExecutor ("adaptive", "perCore", "synchronous")
     std::string serviceExecutor; //Ĭsynchronous
 
     size_t maxConns = DEFAULT_MAX_CONN;  // Maximum number of simultaneous open connections.
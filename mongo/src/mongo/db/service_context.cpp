@@ -185,6 +185,25 @@ PeriodicRunner* ServiceContext::getPeriodicRunner() const {
     return _runner.get();
 }
 
+void ServiceContext::startOperationDeadlineMonitor(Milliseconds period) {
+    invariant(_runner);
+    invariant(!_deadlineMonitorStarted.load());
+
+    PeriodicRunner::PeriodicJob job(
+        [this](Client*) {
+            const Date_t now = getFastClockSource()->now();
+            for (LockedClientsCursor cursor(this); Client* client = cursor.next();) {
+                stdx::lock_guard<Client> lk(*client);
+                if (auto opCtx = client->getOperationContext()) {
+                    opCtx->markKilledIfPastDeadline(now);
+                }
+            }
+        },
+        period);
+    _runner->scheduleJob(std::move(job));
+    _deadlineMonitorStarted.store(true);
+}
+
 transport::TransportLayer* ServiceContext::getTransportLayer() const {
     return _transportLayer.get();//ӦTransportLayerManager._tls  transportLayerASIO
 }
@@ -286,6 +305,7 @@ ServiceContext::UniqueOperationContext ServiceContext::makeOperationContext(Clie
     {
         stdx::lock_guard<Client> lk(*client);
         client->setOperationContext(opCtx.get());
+        opCtx->_deadlineMonitored = _deadlineMonitorStarted.load();
     }
     return UniqueOperationContext(opCtx.release());
 };
@@ -373,6 +393,7 @@ void ServiceContext::setKillAllOperations() {
 
 void ServiceContext::killOperation(OperationContext* opCtx, ErrorCodes::Error killCode) {
     opCtx->markKilled(killCode);
+    opCtx->getClient()->getPublishedOpState().publishKillPending();
 
     for (const auto listener : _killOpListeners) {
         try {
@@ -357,6 +357,14 @@ public:
      */  //ȡһserviceContextʵӵеȫPeriodicRunner
     PeriodicRunner* getPeriodicRunner() const;
 
+    /**
+     * Schedules a job on the periodic runner which, every 'period', kills each operation whose
+     * deadline has passed according to the fast clock. Operations created afterwards leave
+     * deadline enforcement to this job instead of reading the clock on every interrupt check, so
+     * their deadlines are enforced to within 'period'. Requires a periodic runner to be set.
+     */
+    void startOperationDeadlineMonitor(Milliseconds period);
+
     //
     // Transport.
     //
@@ -543,6 +551,9 @@ private:
     // Flag set to indicate that all operations are to be interrupted ASAP.
     AtomicWord<bool> _globalKill{false};
 
+    // Set once startOperationDeadlineMonitor() has scheduled its job.
+    AtomicWord<bool> _deadlineMonitorStarted{false};
+
     // protected by _mutex
     std::vector<KillOpListenerInterface*> _killOpListeners;
 
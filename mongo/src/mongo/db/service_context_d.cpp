@@ -34,8 +34,12 @@
 
 #include "mongo/base/init.h"
 #include "mongo/base/initializer.h"
+#include "mongo/base/counter.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/lock_state.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_entry_point_mongod.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/storage/storage_engine_lock_file.h"
@@ -51,6 +55,49 @@
 
 namespace mongo {
 namespace {
+
+// The locker of a client's last operation, kept to be reused by its next one. Constructing a
+// locker allocates and initializes its request queue and grant notification, which is a
+// noticeable part of the cost of a short operation.
+const auto getSpareLocker = Client::declareDecoration<std::unique_ptr<Locker>>();
+
+// Whether idle clients keep their last locker for reuse. With very many mostly idle connections
+// the spare lockers add up, so turning this off makes lockers exist only while operations run.
+MONGO_EXPORT_SERVER_PARAMETER(retainIdleClientLockers, bool, true);
+
+// The number of lockers currently kept by idle clients
+Counter64 spareLockerCount;
+ServerStatusMetricField<Counter64> displaySpareLockerCount("clients.spareLockers",
+                                                           &spareLockerCount);
+
+class LockerReuseObserver final : public ServiceContext::ClientObserver {
+public:
+    void onCreateClient(Client* client) final {}
+
+    void onDestroyClient(Client* client) final {
+        if (getSpareLocker(client)) {
+            spareLockerCount.decrement();
+        }
+    }
+
+    void onCreateOperationContext(OperationContext* opCtx) final {}
+
+    void onDestroyOperationContext(OperationContext* opCtx) final {
+        if (!retainIdleClientLockers.load()) {
+            return;
+        }
+        if (!opCtx->lockState() || !opCtx->lockState()->resetForReuse()) {
+            return;
+        }
+
+        auto& spareLocker = getSpareLocker(opCtx->getClient());
+        if (!spareLocker) {
+            spareLockerCount.increment();
+        }
+        spareLocker = opCtx->releaseLockState();
+    }
+};
+
 //class ServiceContextMongoD final : public ServiceContext {  һServiceContextMongoD
 auto makeMongoDServiceContext() {
     auto service = stdx::make_unique<ServiceContextMongoD>();
@@ -58,6 +105,7 @@ auto makeMongoDServiceContext() {
     service->setTickSource(stdx::make_unique<SystemTickSource>());
     service->setFastClockSource(stdx::make_unique<SystemClockSource>());
     service->setPreciseClockSource(stdx::make_unique<SystemClockSource>());
+    service->registerClientObserver(stdx::make_unique<LockerReuseObserver>());
     return service;
 }
 
@@ -283,7 +331,10 @@ std::unique_ptr<OperationContext> ServiceContextMongoD::_newOpCtx(Client* client
     invariant(&cc() == client);
     auto opCtx = stdx::make_unique<OperationContext>(client, opId);
 
-    if (isMMAPV1()) {
+    if (auto& spareLocker = getSpareLocker(client)) {
+        spareLockerCount.decrement();
+        opCtx->setLockState(std::move(spareLocker));
+    } else if (isMMAPV1()) {
         opCtx->setLockState(stdx::make_unique<MMAPV1LockerImpl>());
     } else {
         opCtx->setLockState(stdx::make_unique<DefaultLockerImpl>());
@@ -44,6 +44,7 @@
 #include "mongo/db/curop_metrics.h"
 #include "mongo/db/cursor_manager.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/ftdc/sampling_profiler.h"
 #include "mongo/db/initialize_operation_session_info.h"
 #include "mongo/db/introspect.h"
 #include "mongo/db/jsobj.h"
@@ -64,8 +65,10 @@
 #include "mongo/db/s/sharded_connection_info.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/session_catalog.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/tenant_stats.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/metadata.h"
@@ -78,6 +81,7 @@
 #include "mongo/rpc/reply_builder_interface.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/stale_exception.h"
+#include "mongo/transport/reply_buffer_pool.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/message.h"
@@ -92,6 +96,49 @@ MONGO_FP_DECLARE(respondWithNotPrimaryInCommandDispatch);
 namespace {
 using logger::LogComponent;
 
+// The CPU time per second that operations on any one database may use before further operations
+// on it are queued for storage engine tickets at low priority. Zero disables throttling.
+MONGO_EXPORT_SERVER_PARAMETER(tenantCpuQuotaMillisPerSec, int, 0);
+
+/**
+ * Lowers the admission priority of this operation if the database it runs on has exceeded its
+ * CPU quota, so a noisy tenant gets a small share of the tickets while they are contended.
+ */
+void throttleIfTenantOverQuota(OperationContext* opCtx, StringData dbName) {
+    const int quotaMillis = tenantCpuQuotaMillisPerSec.load();
+    if (quotaMillis <= 0 || dbName.empty() || opCtx->getClient()->isInDirectClient() ||
+        dbName == "admin" || dbName == "local" || dbName == "config") {
+        return;
+    }
+
+    // Never override a priority that was chosen deliberately for this operation.
+    Locker* locker = opCtx->lockState();
+    if (locker->getAdmissionPriority() == TicketHolder::Priority::kNormal &&
+        TenantStats::get(opCtx->getServiceContext())
+            .checkOverQuota(dbName, quotaMillis * 1000LL, Date_t::now())) {
+        locker->setAdmissionPriority(TicketHolder::Priority::kLow);
+    }
+}
+
+/**
+ * Charges the resources this operation used to the database it ran on.
+ */
+void recordTenantUsage(OperationContext* opCtx, const CurOp& curOp, long long startCpuMicros) {
+    const std::string ns = curOp.getNS();
+    if (ns.empty() || opCtx->getClient()->isInDirectClient()) {
+        return;
+    }
+
+    const OpDebug& debug = curOp.debug();
+    TenantStats::OperationUsage usage;
+    usage.cpuMicros = TenantStats::currentThreadCpuMicros() - startCpuMicros;
+    usage.ticketWaitMicros = durationCount<Microseconds>(opCtx->lockState()->getTicketWaitTime());
+    usage.keysExamined = std::max(debug.keysExamined, 0LL);
+    usage.docsExamined = std::max(debug.docsExamined, 0LL);
+    TenantStats::get(opCtx->getServiceContext())
+        .recordOperation(nsToDatabaseSubstring(ns), usage, Date_t::now());
+}
+
 // The command names for which to check out a session.
 //
 // Note: Eval should check out a session because it defaults to running under a global write lock,
@@ -324,6 +371,26 @@ void appendReplyMetadata(OperationContext* opCtx,
     }
 }
 
+/**
+ * Parses the generic 'admissionPriority' command argument, which selects the queue an operation
+ * waits in when no storage engine ticket is available.
+ */
+StatusWith<TicketHolder::Priority> _parseAdmissionPriority(const BSONElement& elem) {
+    if (elem.type() == String) {
+        const auto value = elem.valueStringData();
+        if (value == "low"_sd) {
+            return TicketHolder::Priority::kLow;
+        } else if (value == "normal"_sd) {
+            return TicketHolder::Priority::kNormal;
+        } else if (value == "high"_sd) {
+            return TicketHolder::Priority::kHigh;
+        }
+    }
+    return {ErrorCodes::BadValue,
+            str::stream() << "admissionPriority must be one of 'low', 'normal' or 'high', not "
+                          << elem};
+}
+
 /**
  * Given the specified command and whether it supports read concern, returns an effective read
  * concern which should be used.
@@ -361,8 +428,10 @@ void _waitForWriteConcernAndAddToCommandResponse(OperationContext* opCtx,
     }
 
     WriteConcernResult res;
-    auto waitForWCStatus =
-        waitForWriteConcern(opCtx, lastOpAfterRun, opCtx->getWriteConcern(), &res);
+    auto waitForWCStatus = [&] {
+        ScopedOpPhaseTimer writeConcernTimer(opCtx, OpDebug::Phase::kWriteConcern);
+        return waitForWriteConcern(opCtx, lastOpAfterRun, opCtx->getWriteConcern(), &res);
+    }();
     Command::appendCommandWCStatus(*commandResponseBuilder, waitForWCStatus, res);
 
     // SERVER-22421: This code is to ensure error response backwards compatibility with the
@@ -428,6 +497,7 @@ LogicalTime computeOperationTime(OperationContext* opCtx,
 bool runCommandImpl(OperationContext* opCtx,
                     Command* command,
                     const OpMsgRequest& request,
+                    const std::string& db,
                     rpc::ReplyBuilderInterface* replyBuilder,
                     LogicalTime startOperationTime) {
     auto bytesToReserve = command->reserveBytesForReply();
@@ -443,10 +513,6 @@ bool runCommandImpl(OperationContext* opCtx,
     // run expects non-const bsonobj
     BSONObj cmd = request.body;
 
-    // run expects const db std::string (can't bind to temporary)
-    //ȡеDBϢ
-    const std::string db = request.getDatabase().toString();
-
     BSONObjBuilder inPlaceReplyBob = replyBuilder->getInPlaceReplyBuilder(bytesToReserve);
 
 	//ReadConcern
@@ -576,6 +642,7 @@ MONGO_FP_DECLARE(skipCheckingForNotMasterInCommandDispatch);
 void execCommandDatabase(OperationContext* opCtx,
                          Command* command,
                          const OpMsgRequest& request,
+                         StringData db,
                          rpc::ReplyBuilderInterface* replyBuilder) {
 
 	//ʼoptime
@@ -600,13 +667,15 @@ void execCommandDatabase(OperationContext* opCtx,
             opCtx->getServiceContext()->getGlobalStorageEngine()->supportsDocLocking());
 
 		//ȡdbname
-        const auto dbname = request.getDatabase().toString();
+        const auto dbname = db.toString();
 		//dbname
         uassert(
             ErrorCodes::InvalidNamespace,
             str::stream() << "Invalid database name: '" << dbname << "'",
             NamespaceString::validDBName(dbname, NamespaceString::DollarInDbNameBehavior::Allow));
 
+        throttleIfTenantOverQuota(opCtx, dbname);
+
         std::unique_ptr<MaintenanceModeSetter> mmSetter;
 
         BSONElement cmdOptionMaxTimeMSField;
@@ -614,6 +683,7 @@ void execCommandDatabase(OperationContext* opCtx,
         BSONElement helpField;
         BSONElement shardVersionFieldIdx;
         BSONElement queryOptionMaxTimeMSField;
+        BSONElement admissionPriorityField;
 
         StringMap<int> topLevelFields;
 		//body elem
@@ -629,6 +699,8 @@ void execCommandDatabase(OperationContext* opCtx,
                 shardVersionFieldIdx = element;
             } else if (fieldName == QueryRequest::queryOptionMaxTimeMS) {
                 queryOptionMaxTimeMSField = element;
+            } else if (fieldName == Command::kAdmissionPriorityFieldName) {
+                admissionPriorityField = element;
             }
 
 			//eleme쳣
@@ -712,7 +784,7 @@ void execCommandDatabase(OperationContext* opCtx,
         }
 
 		//ʱû
-        if (command->maintenanceMode()) {
+        if (command->maintenanceModeFor(request.body)) {
             mmSetter.reset(new MaintenanceModeSetter(opCtx));
         }
 
@@ -738,6 +810,11 @@ void execCommandDatabase(OperationContext* opCtx,
             opCtx->setDeadlineAfterNowBy(Milliseconds{maxTimeMS});
         }
 
+        if (admissionPriorityField) {
+            opCtx->lockState()->setAdmissionPriority(
+                uassertStatusOK(_parseAdmissionPriority(admissionPriorityField)));
+        }
+
         auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
         readConcernArgs = uassertStatusOK(_extractReadConcern(
             request.body, command->supportsNonLocalReadConcern(dbname, request.body)));
@@ -782,7 +859,7 @@ void execCommandDatabase(OperationContext* opCtx,
         }
 
 		//ִ
-        retval = runCommandImpl(opCtx, command, request, replyBuilder, startOperationTime);
+        retval = runCommandImpl(opCtx, command, request, dbname, replyBuilder, startOperationTime);
 
 		//ʧܴͳ
         if (!retval) {
@@ -807,9 +884,8 @@ void execCommandDatabase(OperationContext* opCtx,
 
         // Note: the read concern may not have been successfully or yet placed on the opCtx, so
         // parsing it separately here.
-        const std::string db = request.getDatabase().toString();
         auto readConcernArgsStatus = _extractReadConcern(
-            request.body, command->supportsNonLocalReadConcern(db, request.body));
+            request.body, command->supportsNonLocalReadConcern(db.toString(), request.body));
         auto operationTime = readConcernArgsStatus.isOK()
             ? computeOperationTime(
                   opCtx, startOperationTime, readConcernArgsStatus.getValue().getLevel())
@@ -821,14 +897,14 @@ void execCommandDatabase(OperationContext* opCtx,
             (serverGlobalParams.featureCompatibility.getVersion() ==
              ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo36)) {
             LOG(1) << "assertion while executing command '" << request.getCommandName() << "' "
-                   << "on database '" << request.getDatabase() << "' "
+                   << "on database '" << db << "' "
                    << "with arguments '" << command->getRedactedCopyForLogging(request.body)
                    << "' and operationTime '" << operationTime.toString() << "': " << e.toString();
 
             _generateErrorResponse(opCtx, replyBuilder, e, metadataBob.obj(), operationTime);
         } else {
             LOG(1) << "assertion while executing command '" << request.getCommandName() << "' "
-                   << "on database '" << request.getDatabase() << "' "
+                   << "on database '" << db << "' "
                    << "with arguments '" << command->getRedactedCopyForLogging(request.body)
                    << "': " << e.toString();
 
@@ -840,29 +916,74 @@ void execCommandDatabase(OperationContext* opCtx,
 /**
  * Fills out CurOp / OpDebug with basic command info.
  */ //ֱͨCurOp::get(opCtx)ȡ
-void curOpCommandSetup(OperationContext* opCtx, const OpMsgRequest& request) {
+void curOpCommandSetup(OperationContext* opCtx, const OpMsgRequest& request, StringData dbname) {
     auto curop = CurOp::get(opCtx); //CurOp::get
     curop->debug().iscommand = true;
 
     // We construct a legacy $cmd namespace so we can fill in curOp using
     // the existing logic that existed for OP_QUERY commands
-    NamespaceString nss(request.getDatabase(), "$cmd");
+    NamespaceString nss(dbname, "$cmd");
 
     stdx::lock_guard<Client> lk(*opCtx->getClient());
     curop->setOpDescription_inlock(request.body);
     curop->markCommand_inlock();
     curop->setNS_inlock(nss.ns());
 }
+
+/**
+ * For an OP_MSG cursor command sent with OpMsg::kExhaustSupported, decides whether the server
+ * should keep streaming batches on its own. Streaming continues while the cursor is open and
+ * batches are non-empty, so tailable cursors fall back to client-driven getMores once they have
+ * caught up instead of spinning on empty batches.
+ */
+void setUpExhaustIfPossible(const OpMsgRequest& request,
+                            const Message& response,
+                            DbResponse* dbResponse) {
+    const auto commandName = request.getCommandName();
+    const bool isGetMore = commandName == "getMore";
+    if (!isGetMore && commandName != "find" && commandName != "aggregate")
+        return;
+
+    const auto reply = OpMsg::parse(response).body;
+    if (!reply["ok"].trueValue() || reply["cursor"].type() != Object)
+        return;
+
+    const auto cursor = reply["cursor"].Obj();
+    const auto cursorId = cursor["id"].safeNumberLong();
+    const auto batch = cursor[isGetMore ? "nextBatch" : "firstBatch"];
+    if (!cursorId || batch.type() != Array || batch.Obj().isEmpty())
+        return;
+
+    dbResponse->shouldRunAgainForExhaust = true;
+    if (isGetMore) {
+        // The same getMore is run again. It is re-serialized rather than replayed as-is, since
+        // the request message may carry a checksum that covers its header.
+        dbResponse->nextInvocation = request.body.getOwned();
+        return;
+    }
+
+    const auto batchSize = commandName == "find" ? request.body["batchSize"]
+                                                 : request.body["cursor"]["batchSize"];
+    BSONObjBuilder nextInvocation;
+    nextInvocation.append("getMore", cursorId);
+    nextInvocation.append("collection", NamespaceString(cursor["ns"].str()).coll());
+    if (batchSize.isNumber())
+        nextInvocation.append("batchSize", batchSize.safeNumberLong());
+    nextInvocation.append("$db", request.getDatabase());
+    dbResponse->nextInvocation = nextInvocation.obj();
+}
 //mongosServiceEntryPointMongos::handleRequest->Strategy::clientCommand->runCommand
 //mongod:ServiceEntryPointMongod::handleRequest->runCommands->execCommandDatabase
 
 //mongodb  ServiceEntryPointMongod::handleRequestִ
 DbResponse runCommands(OperationContext* opCtx, const Message& message) {
 	//ȡmessageӦReplyBuilder3.6Ĭ϶ӦOpMsgReplyBuilder
-    auto replyBuilder = rpc::makeReplyBuilder(rpc::protocolForMessage(message));
+    auto replyBuilder = rpc::makeReplyBuilder(rpc::protocolForMessage(message),
+                                              ReplyBufferPool::get(opCtx->getClient()).take());
+    OpMsgRequest request;
     [&] {
-        OpMsgRequest request;
         try {  // Parse.
+            ScopedOpPhaseTimer parseTimer(opCtx, OpDebug::Phase::kParse);
         	//Э messageȡӦOpMsgRequest
             request = rpc::opMsgRequestFromAnyProtocol(message);
         } catch (const DBException& ex) {
@@ -884,7 +1005,9 @@ DbResponse runCommands(OperationContext* opCtx, const Message& message) {
 
         try {  // Execute.
         	//opCtxʼ
-            curOpCommandSetup(opCtx, request);
+            // Finding $db means scanning the body, so it is only looked up once here.
+            const StringData dbname = request.getDatabase();
+            curOpCommandSetup(opCtx, request, dbname);
 
             Command* c = nullptr;
             // In the absence of a Command object, no redaction is possible. Therefore
@@ -903,7 +1026,7 @@ DbResponse runCommands(OperationContext* opCtx, const Message& message) {
             }
 
 			//ӡ
-            LOG(2) << "run command " << request.getDatabase() << ".$cmd" << ' '
+            LOG(2) << "run command " << dbname << ".$cmd" << ' '
                    << c->getRedactedCopyForLogging(request.body) << ' ' << 
                    request.getCommandName(); // find  insert
 
@@ -913,7 +1036,8 @@ DbResponse runCommands(OperationContext* opCtx, const Message& message) {
                 CurOp::get(opCtx)->setLogicalOp_inlock(c->getLogicalOp());
             }
 
-            execCommandDatabase(opCtx, c, request, replyBuilder.get());
+            SamplingProfilerTag profilerTag(request.getCommandName(), dbname);
+            execCommandDatabase(opCtx, c, request, dbname, replyBuilder.get());
         } catch (const DBException& ex) {
             BSONObjBuilder metadataBob;
             appendReplyMetadataOnError(opCtx, &metadataBob);
@@ -935,11 +1059,17 @@ DbResponse runCommands(OperationContext* opCtx, const Message& message) {
     }
 
 	//OpMsgReplyBuilder::doneݽл
-    auto response = replyBuilder->done();
+    auto response = [&] {
+        ScopedOpPhaseTimer replyTimer(opCtx, OpDebug::Phase::kReply);
+        return replyBuilder->done();
+    }();
     CurOp::get(opCtx)->debug().responseLength = response.header().dataLen();
 
-    // TODO exhaust
-    return DbResponse{std::move(response)};
+    DbResponse dbResponse{std::move(response)};
+    if (OpMsg::isFlagSet(message, OpMsg::kExhaustSupported) && !request.body.isEmpty()) {
+        setUpExhaustIfPossible(request, dbResponse.response, &dbResponse);
+    }
+    return dbResponse;
 }
 
 //ServiceEntryPointMongod::handleRequestִ 
@@ -1228,6 +1358,7 @@ DbResponse ServiceEntryPointMongod::handleRequest(OperationContext* opCtx, const
 	//ȡ.ϢעֻdbUpdate<opCode<dbDeleteopCodeͨdbmsgֱӻȡͱϢ
     const char* ns = dbmsg.messageShouldHaveNs() ? dbmsg.getns() : NULL;
     const NamespaceString nsString = ns ? NamespaceString(ns) : NamespaceString();
+    const long long startCpuMicros = TenantStats::currentThreadCpuMicros();
 
     if (op == dbQuery) {
 		//admin.$cmd
@@ -1258,6 +1389,9 @@ DbResponse ServiceEntryPointMongod::handleRequest(OperationContext* opCtx, const
     bool shouldLogOpDebug = shouldLog(logger::LogSeverity::Debug(1));
 
     DbResponse dbresponse;
+    if (!isCommand) {
+        throttleIfTenantOverQuota(opCtx, nsString.db());
+    }
     if (op == dbMsg || op == dbCommand || (op == dbQuery && isCommand)) {
         dbresponse = runCommands(opCtx, m);   //runCommands   °汾 ѯʵ
     } else if (op == dbQuery) {
@@ -1353,6 +1487,7 @@ DbResponse ServiceEntryPointMongod::handleRequest(OperationContext* opCtx, const
     }
 	//ͳϢ
     recordCurOpMetrics(opCtx);
+    recordTenantUsage(opCtx, currentOp, startCpuMicros);
     return dbresponse;
 }
 
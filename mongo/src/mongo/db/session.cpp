@@ -32,6 +32,7 @@
 
 #include "mongo/db/session.h"
 
+#include "mongo/bson/simple_bsonelement_comparator.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
@@ -131,6 +132,21 @@ ActiveTransactionHistory fetchActiveTransactionHistory(OperationContext* opCtx,
     return result;
 }
 
+/**
+ * Returns whether every top-level field of 'query' is present in 'doc' with an equal value. The
+ * queries built by Session::_makeUpdateRequest consist only of such equalities, so this spares
+ * each retryable write from parsing them into a MatchExpression.
+ */
+bool matchesEqualityQuery(const BSONObj& query, const BSONObj& doc) {
+    for (const auto& predicate : query) {
+        const auto value = doc[predicate.fieldNameStringData()];
+        if (value.eoo() || SimpleBSONElementComparator::kInstance.evaluate(value != predicate)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void updateSessionEntry(OperationContext* opCtx, const UpdateRequest& updateRequest) {
     // Current code only supports replacement update.
     dassert(UpdateDriver::isDocReplacement(updateRequest.getUpdates()));
@@ -181,11 +197,7 @@ void updateSessionEntry(OperationContext* opCtx, const UpdateRequest& updateRequ
     auto originalDoc = originalRecordData.toBson();
 
     invariant(collection->getDefaultCollator() == nullptr);
-    boost::intrusive_ptr<ExpressionContext> expCtx(new ExpressionContext(opCtx, nullptr));
-
-    auto matcher = fassertStatusOK(
-        40673, MatchExpressionParser::parse(updateRequest.getQuery(), std::move(expCtx)));
-    if (!matcher->matchesBSON(originalDoc)) {
+    if (!matchesEqualityQuery(updateRequest.getQuery(), originalDoc)) {
         // Document no longer match what we expect so throw WCE to make the caller re-examine.
         throw WriteConflictException();
     }
@@ -204,6 +216,7 @@ void updateSessionEntry(OperationContext* opCtx, const UpdateRequest& updateRequ
                                true,   // enforceQuota
                                false,  // indexesAffected = false because _id is the only index
                                nullptr,
+                               nullptr,
                                &args);
 
     wuow.commit();
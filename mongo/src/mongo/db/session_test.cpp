@@ -29,6 +29,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/client.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/operation_context.h"
@@ -216,6 +217,35 @@ TEST_F(SessionTest, StartingNewerTransactionUpdatesThePersistedSession) {
     ASSERT_EQ(secondOpTime, session.getLastWriteOpTime(200));
 }
 
+TEST_F(SessionTest, WriteOpCompletedOnPrimaryThrowsWriteConflictIfPersistedSessionChanged) {
+    const auto sessionId = makeLogicalSessionIdForTest();
+    Session session(sessionId);
+    session.refreshFromStorageIfNeeded(opCtx());
+
+    const auto writeTxnRecordFn = [&](TxnNumber txnNum, StmtId stmtId, repl::OpTime prevOpTime) {
+        session.beginTxn(opCtx(), txnNum);
+
+        AutoGetCollection autoColl(opCtx(), kNss, MODE_IX);
+        WriteUnitOfWork wuow(opCtx());
+        const auto opTime = logOp(opCtx(), kNss, sessionId, txnNum, stmtId, prevOpTime);
+        session.onWriteOpCompletedOnPrimary(opCtx(), txnNum, {stmtId}, opTime, Date_t::now());
+        wuow.commit();
+
+        return opTime;
+    };
+
+    const auto firstOpTime = writeTxnRecordFn(100, 0, {});
+
+    // Change the persisted record behind the session's back.
+    DBDirectClient client(opCtx());
+    client.update(NamespaceString::kSessionTransactionsTableNamespace.ns(),
+                  {BSON("_id" << sessionId.toBSON())},
+                  BSON("$set" << BSON(SessionTxnRecord::kTxnNumFieldName << 150LL)));
+    ASSERT(client.getLastError().empty());
+
+    ASSERT_THROWS(writeTxnRecordFn(200, 1, firstOpTime), WriteConflictException);
+}
+
 TEST_F(SessionTest, StartingOldTxnShouldAssert) {
     const auto sessionId = makeLogicalSessionIdForTest();
     Session session(sessionId);
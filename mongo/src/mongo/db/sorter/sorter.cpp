@@ -48,7 +48,9 @@
 #include "mongo/db/sorter/sorter.h"
 
 #include <boost/filesystem/operations.hpp>
+#include <deque>
 #include <snappy.h>
+#include <third_party/murmurhash3/MurmurHash3.h>
 #include <vector>
 
 #include "mongo/base/string_data.h"
@@ -59,6 +61,10 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/s/is_mongos.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/bufreader.h"
 #include "mongo/util/destructor_guard.h"
@@ -143,6 +149,50 @@ private:
     std::deque<Data> _data;
 };
 
+/**
+ * Runs read-ahead for FileIterators. A merge can have thousands of spill files open at once, so a
+ * small fixed set of threads serves all of them rather than one thread per file. The threads live
+ * for the rest of the process once the first external sort merges with read-ahead enabled.
+ */
+class ReadAheadPool {
+public:
+    static ReadAheadPool* get() {
+        static ReadAheadPool* pool = new ReadAheadPool();  // Intentionally leaked.
+        return pool;
+    }
+
+    void schedule(stdx::function<void()> task) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _tasks.push_back(std::move(task));
+        _taskAvailable.notify_one();
+    }
+
+private:
+    static constexpr size_t kThreads = 4;
+
+    ReadAheadPool() {
+        for (size_t i = 0; i < kThreads; ++i) {
+            stdx::thread([this] { _run(); }).detach();
+        }
+    }
+
+    void _run() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (true) {
+            _taskAvailable.wait(lk, [&] { return !_tasks.empty(); });
+            auto task = std::move(_tasks.front());
+            _tasks.pop_front();
+            lk.unlock();
+            task();
+            lk.lock();
+        }
+    }
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _taskAvailable;
+    std::deque<stdx::function<void()>> _tasks;
+};
+
 /** Returns results in order from a single file */
 template <typename Key, typename Value>
 class FileIterator : public SortIteratorInterface<Key, Value> {
@@ -154,8 +204,10 @@ public:
 
     FileIterator(const std::string& fileName,
                  const Settings& settings,
-                 std::shared_ptr<FileDeleter> fileDeleter)
+                 std::shared_ptr<FileDeleter> fileDeleter,
+                 bool readAhead)
         : _settings(settings),
+          _readAhead(readAhead),
           _done(false),
           _fileName(fileName),
           _fileDeleter(fileDeleter),
@@ -170,6 +222,19 @@ public:
                 boost::filesystem::file_size(_fileName) != 0);
     }
 
+    ~FileIterator() {
+        // A read-ahead that is still queued must not run once we are gone, and one that is
+        // running is using _file.
+        if (!_pending)
+            return;
+        stdx::unique_lock<stdx::mutex> lk(_pending->mutex);
+        if (_pending->state == PendingRead::kQueued) {
+            _pending->state = PendingRead::kCancelled;
+            return;
+        }
+        _pending->done.wait(lk, [&] { return _pending->state == PendingRead::kDone; });
+    }
+
     bool more() {
         if (!_done)
             fillIfNeeded();  // may change _done
@@ -187,6 +252,24 @@ public:
     }
 
 private:
+    /** One block of the file, ready to be deserialized. */
+    struct Block {
+        std::unique_ptr<char[]> buffer;
+        size_t size = 0;
+        bool eof = false;
+    };
+
+    /** A block being read ahead on the ReadAheadPool. */
+    struct PendingRead {
+        enum State { kQueued, kRunning, kDone, kCancelled };
+
+        stdx::mutex mutex;
+        stdx::condition_variable done;
+        State state = kQueued;
+        Block block;
+        Status status = Status::OK();
+    };
+
     void fillIfNeeded() {
         verify(!_done);
 
@@ -195,25 +278,94 @@ private:
     }
 
     void fill() {
-        int32_t rawSize;
-        read(&rawSize, sizeof(rawSize));
-        if (_done)
+        Block block = _pending ? takePendingBlock() : readBlock();
+        if (block.eof) {
+            _done = true;
             return;
+        }
+
+        _buffer = std::move(block.buffer);
+        _reader.reset(new BufReader(_buffer.get(), block.size));
+
+        if (_readAhead)
+            scheduleReadAhead();
+    }
+
+    void scheduleReadAhead() {
+        invariant(!_pending);
+        _pending = std::make_shared<PendingRead>();
+        ReadAheadPool::get()->schedule([ this, pending = _pending ] {
+            {
+                stdx::lock_guard<stdx::mutex> lk(pending->mutex);
+                if (pending->state != PendingRead::kQueued)
+                    return;  // Cancelled, or the consumer got to it first.
+                pending->state = PendingRead::kRunning;
+            }
+
+            Block block;
+            Status status = Status::OK();
+            try {
+                block = readBlock();
+            } catch (const DBException& ex) {
+                status = ex.toStatus();
+            }
+
+            stdx::lock_guard<stdx::mutex> lk(pending->mutex);
+            pending->block = std::move(block);
+            pending->status = std::move(status);
+            pending->state = PendingRead::kDone;
+            pending->done.notify_all();
+        });
+    }
+
+    Block takePendingBlock() {
+        auto pending = std::move(_pending);
+        stdx::unique_lock<stdx::mutex> lk(pending->mutex);
+        if (pending->state == PendingRead::kQueued) {
+            // All the read-ahead threads are busy; reading it here beats waiting for one.
+            pending->state = PendingRead::kCancelled;
+            lk.unlock();
+            return readBlock();
+        }
+
+        pending->done.wait(lk, [&] { return pending->state == PendingRead::kDone; });
+        uassertStatusOK(pending->status);
+        return std::move(pending->block);
+    }
+
+    /**
+     * Reads, verifies, decrypts and decompresses the next block of the file. Only one thread calls
+     * this at a time: either the consumer or a read-ahead task it is waiting for.
+     */
+    Block readBlock() {
+        Block block;
+
+        int32_t rawSize;
+        uint32_t checksum;
+        if (!read(&rawSize, sizeof(rawSize)) || !read(&checksum, sizeof(checksum))) {
+            block.eof = true;
+            return block;
+        }
 
         // negative size means compressed
         const bool compressed = rawSize < 0;
         int32_t blockSize = std::abs(rawSize);
 
-        _buffer.reset(new char[blockSize]);
-        read(_buffer.get(), blockSize);
-        massert(16816, "file too short?", !_done);
+        std::unique_ptr<char[]> buffer(new char[blockSize]);
+        massert(16816, "file too short?", read(buffer.get(), blockSize));
+
+        uint32_t actualChecksum;
+        MurmurHash3_x86_32(buffer.get(), blockSize, 0, &actualChecksum);
+        massert(50790,
+                str::stream() << "checksum mismatch in sort spill file \"" << _fileName << "\"",
+                actualChecksum == checksum);
 
         auto encryptionHooks = EncryptionHooks::get(getGlobalServiceContext());
         if (encryptionHooks->enabled()) {
             std::unique_ptr<char[]> out(new char[blockSize]);
             size_t outLen;
             Status status =
-                encryptionHooks->unprotectTmpData(reinterpret_cast<uint8_t*>(_buffer.get()),
+                encryptionHooks->unprotectTmpData(reinterpret_cast<uint8_t*>(buffer.get()),
                                                   blockSize,
                                                   reinterpret_cast<uint8_t*>(out.get()),
                                                   blockSize,
@@ -222,38 +374,36 @@ private:
                     str::stream() << "Failed to unprotect data: " << status.toString(),
                     status.isOK());
             blockSize = outLen;
-            _buffer.swap(out);
+            buffer.swap(out);
         }
 
         if (!compressed) {
-            _reader.reset(new BufReader(_buffer.get(), blockSize));
-            return;
+            block.buffer = std::move(buffer);
+            block.size = blockSize;
+            return block;
         }
 
-        dassert(snappy::IsValidCompressedBuffer(_buffer.get(), blockSize));
+        dassert(snappy::IsValidCompressedBuffer(buffer.get(), blockSize));
 
         size_t uncompressedSize;
         massert(17061,
                 "couldn't get uncompressed length",
-                snappy::GetUncompressedLength(_buffer.get(), blockSize, &uncompressedSize));
+                snappy::GetUncompressedLength(buffer.get(), blockSize, &uncompressedSize));
 
-        std::unique_ptr<char[]> decompressionBuffer(new char[uncompressedSize]);
+        block.buffer.reset(new char[uncompressedSize]);
         massert(17062,
                 "decompression failed",
-                snappy::RawUncompress(_buffer.get(), blockSize, decompressionBuffer.get()));
-
-        // hold on to decompressed data and throw out compressed data at block exit
-        _buffer.swap(decompressionBuffer);
-        _reader.reset(new BufReader(_buffer.get(), uncompressedSize));
+                snappy::RawUncompress(buffer.get(), blockSize, block.buffer.get()));
+        block.size = uncompressedSize;
+        return block;
     }
 
-    // sets _done to true on EOF - asserts on any other error
-    void read(void* out, size_t size) {
+    // returns false on EOF - asserts on any other error
+    bool read(void* out, size_t size) {
         _file.read(reinterpret_cast<char*>(out), size);
         if (!_file.good()) {
             if (_file.eof()) {
-                _done = true;
-                return;
+                return false;
             }
 
             msgasserted(16817,
@@ -261,12 +411,15 @@ private:
                                       << myErrnoWithDescription());
         }
         verify(_file.gcount() == static_cast<std::streamsize>(size));
+        return true;
     }
 
     const Settings _settings;
+    const bool _readAhead;
     bool _done;
     std::unique_ptr<char[]> _buffer;
     std::unique_ptr<BufReader> _reader;
+    std::shared_ptr<PendingRead> _pending;  // The next block, if it is being read ahead.
     std::string _fileName;
     std::shared_ptr<FileDeleter> _fileDeleter;  // Must outlive _file
     std::ifstream _file;
@@ -806,7 +959,12 @@ inline unsigned nextFileNumber() {
 
 template <typename Key, typename Value>
 SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts, const Settings& settings)
-    : _settings(settings) {
+    : _settings(settings),
+      _blockBytes(opts.spillBlockBytes.value_or(storageGlobalParams.sorterSpillBlockBytes.load())),
+      _compressor(opts.spillCompressor.value_or(storageGlobalParams.sorterSpillCompressor == "none"
+                                                    ? SortSpillCompressor::kNone
+                                                    : SortSpillCompressor::kSnappy)),
+      _readAhead(opts.spillReadAhead.value_or(storageGlobalParams.sorterSpillReadAhead.load())) {
     namespace str = mongoutils::str;
 
     // This should be checked by consumers, but if we get here don't allow writes.
@@ -842,7 +1000,7 @@ void SortedFileWriter<Key, Value>::addAlreadySorted(const Key& key, const Value&
     key.serializeForSorter(_buffer);
     val.serializeForSorter(_buffer);
 
-    if (_buffer.len() > 64 * 1024)
+    if (static_cast<size_t>(_buffer.len()) > _blockBytes)
         spill();
 }
 
@@ -857,10 +1015,13 @@ void SortedFileWriter<Key, Value>::spill() {
         return;
 
     std::string compressed;
-    snappy::Compress(outBuffer, size, &compressed);
-    verify(compressed.size() <= size_t(std::numeric_limits<int32_t>::max()));
+    bool shouldCompress = false;
+    if (_compressor == SortSpillCompressor::kSnappy) {
+        snappy::Compress(outBuffer, size, &compressed);
+        verify(compressed.size() <= size_t(std::numeric_limits<int32_t>::max()));
+        shouldCompress = compressed.size() < size_t(_buffer.len() / 10 * 9);
+    }
 
-    const bool shouldCompress = compressed.size() < size_t(_buffer.len() / 10 * 9);
     if (shouldCompress) {
         size = compressed.size();
         outBuffer = const_cast<char*>(compressed.data());
@@ -884,10 +1045,16 @@ void SortedFileWriter<Key, Value>::spill() {
         size = resultLen;
     }
 
+    // Checksum what actually goes to disk, so a corrupt block is caught before it is decrypted
+    // or decompressed.
+    uint32_t checksum;
+    MurmurHash3_x86_32(outBuffer, size, 0, &checksum);
+
     // negative size means compressed
     size = shouldCompress ? -size : size;
     try {
         _file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        _file.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
         _file.write(outBuffer, std::abs(size));
 
     } catch (const std::exception&) {
@@ -903,7 +1070,7 @@ template <typename Key, typename Value>
 SortIteratorInterface<Key, Value>* SortedFileWriter<Key, Value>::done() {
     spill();
     _file.close();
-    return new sorter::FileIterator<Key, Value>(_fileName, _settings, _fileDeleter);
+    return new sorter::FileIterator<Key, Value>(_fileName, _settings, _fileDeleter, _readAhead);
 }
 
 //
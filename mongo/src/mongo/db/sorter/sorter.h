@@ -35,6 +35,8 @@
 #include <utility>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/util/builder.h"
 
@@ -89,6 +91,9 @@ namespace sorter {
 class FileDeleter;
 }
 
+/// How blocks of spilled data are compressed on disk.
+enum class SortSpillCompressor { kNone, kSnappy };
+
 /**
  * Runtime options that control the Sorter's behavior
  */
@@ -99,6 +104,11 @@ struct SortOptions {
     std::string tempDir;         /// Directory to directly place files in.
                                  /// Must be explicitly set if extSortAllowed is true.
 
+    // The following default to the sorterSpill* server parameters when unset.
+    boost::optional<size_t> spillBlockBytes;  /// Uncompressed size of each spilled block.
+    boost::optional<SortSpillCompressor> spillCompressor;
+    boost::optional<bool> spillReadAhead;  /// Prefetch the next block of each file when merging.
+
     SortOptions() : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false) {}
 
     /// Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
@@ -122,6 +132,21 @@ struct SortOptions {
         tempDir = newTempDir;
         return *this;
     }
+
+    SortOptions& SpillBlockBytes(size_t newSpillBlockBytes) {
+        spillBlockBytes = newSpillBlockBytes;
+        return *this;
+    }
+
+    SortOptions& SpillCompressor(SortSpillCompressor newSpillCompressor) {
+        spillCompressor = newSpillCompressor;
+        return *this;
+    }
+
+    SortOptions& SpillReadAhead(bool newSpillReadAhead = true) {
+        spillReadAhead = newSpillReadAhead;
+        return *this;
+    }
 };
 
 /// This is the output from the sorting framework
@@ -200,6 +225,9 @@ private:
     void spill();
 
     const Settings _settings;
+    const size_t _blockBytes;
+    const SortSpillCompressor _compressor;
+    const bool _readAhead;
     std::string _fileName;
     std::shared_ptr<sorter::FileDeleter> _fileDeleter;  // Must outlive _file
     std::ofstream _file;
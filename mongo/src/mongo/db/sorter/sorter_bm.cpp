@@ -0,0 +1,157 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/sorter/sorter.h"
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/init.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/unittest/temp_dir.h"
+
+// Need access to internal classes
+#include "mongo/db/sorter/sorter.cpp"
+
+namespace mongo {
+namespace {
+
+// Stub to avoid including the server environment library.
+MONGO_INITIALIZER(SetGlobalEnvironment)(InitializerContext* context) {
+    setGlobalServiceContext(stdx::make_unique<ServiceContextNoop>());
+    return Status::OK();
+}
+
+class IntWrapper {
+public:
+    IntWrapper(int i = 0) : _i(i) {}
+    operator const int&() const {
+        return _i;
+    }
+
+    /// members for Sorter
+    struct SorterDeserializeSettings {};  // unused
+    void serializeForSorter(BufBuilder& buf) const {
+        buf.appendNum(_i);
+    }
+    static IntWrapper deserializeForSorter(BufReader& buf, const SorterDeserializeSettings&) {
+        return buf.read<LittleEndian<int>>().value;
+    }
+    int memUsageForSorter() const {
+        return sizeof(IntWrapper);
+    }
+    IntWrapper getOwned() const {
+        return *this;
+    }
+
+private:
+    int _i;
+};
+
+using IWPair = std::pair<IntWrapper, IntWrapper>;
+using IWSorter = Sorter<IntWrapper, IntWrapper>;
+
+class IWComparator {
+public:
+    int operator()(const IWPair& lhs, const IWPair& rhs) const {
+        if (lhs.first == rhs.first)
+            return 0;
+        return lhs.first < rhs.first ? -1 : 1;
+    }
+};
+
+std::vector<int> makeInput(std::int64_t count) {
+    PseudoRandom random(12345);
+    std::vector<int> input;
+    input.reserve(count);
+    for (std::int64_t i = 0; i < count; ++i) {
+        input.push_back(random.nextInt32());
+    }
+    return input;
+}
+
+void sortAndDrain(const std::vector<int>& input, const SortOptions& opts) {
+    std::unique_ptr<IWSorter> sorter(IWSorter::make(opts, IWComparator()));
+    for (int value : input) {
+        sorter->add(value, -value);
+    }
+
+    std::unique_ptr<IWSorter::Iterator> it(sorter->done());
+    long long sum = 0;
+    while (it->more()) {
+        sum += it->next().first;
+    }
+    benchmark::doNotOptimize(sum);
+}
+
+void BM_sorterInMemory(benchmark::State& state) {
+    const auto input = makeInput(state.range(0));
+    while (state.keepRunning()) {
+        sortAndDrain(input, SortOptions());
+    }
+    state.setItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_sorterInMemory)->arg(1000)->arg(100 * 1000);
+
+// A sort with a small limit keeps only the top documents, as a blocking sort with a limit does.
+void BM_sorterTopK(benchmark::State& state) {
+    const auto input = makeInput(state.range(0));
+    while (state.keepRunning()) {
+        sortAndDrain(input, SortOptions().Limit(100));
+    }
+    state.setItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_sorterTopK)->arg(1000)->arg(100 * 1000);
+
+// A memory limit far below the input size forces spilling to and merging from disk.
+void BM_sorterExternal(benchmark::State& state) {
+    const auto input = makeInput(state.range(0));
+    unittest::TempDir tempDir("sorter_bm");
+    const auto opts = SortOptions()
+                          .TempDir(tempDir.path())
+                          .ExtSortAllowed()
+                          .MaxMemoryUsageBytes(state.range(0) * sizeof(IntWrapper) * 2 / 10);
+    while (state.keepRunning()) {
+        sortAndDrain(input, opts);
+    }
+    state.setItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_sorterExternal)->arg(100 * 1000)->arg(1000 * 1000);
+
+}  // namespace
+
+MONGO_CREATE_SORTER(IntWrapper, IntWrapper, IWComparator);
+
+}  // namespace mongo
@@ -276,6 +276,63 @@ public:
     }
 };
 
+class SortedFileWriterSpillOptionsTests {
+public:
+    void run() {
+        unittest::TempDir tempDir("sortedFileWriterSpillOptionsTests");
+        for (size_t blockBytes : {size_t(4 * 1024), size_t(1024 * 1024)}) {
+            for (auto compressor : {SortSpillCompressor::kNone, SortSpillCompressor::kSnappy}) {
+                for (bool readAhead : {false, true}) {
+                    const SortOptions opts = SortOptions()
+                                                 .TempDir(tempDir.path())
+                                                 .SpillBlockBytes(blockBytes)
+                                                 .SpillCompressor(compressor)
+                                                 .SpillReadAhead(readAhead);
+                    SortedFileWriter<IntWrapper, IntWrapper> sorter(opts);
+                    for (int i = 0; i < 100 * 1000; i++)
+                        sorter.addAlreadySorted(i, -i);
+
+                    ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter.done()),
+                                                make_shared<IntIterator>(0, 100 * 1000));
+                }
+            }
+        }
+
+        ASSERT(boost::filesystem::is_empty(tempDir.path()));
+    }
+};
+
+class SortedFileWriterDetectsCorruption {
+public:
+    void run() {
+        unittest::TempDir tempDir("sortedFileWriterDetectsCorruption");
+        const SortOptions opts =
+            SortOptions().TempDir(tempDir.path()).SpillCompressor(SortSpillCompressor::kNone);
+        SortedFileWriter<IntWrapper, IntWrapper> sorter(opts);
+        for (int i = 0; i < 1000; i++)
+            sorter.addAlreadySorted(i, -i);
+        std::shared_ptr<IWIterator> iter(sorter.done());
+
+        // Flip a byte in the middle of the only block of the only spill file.
+        boost::filesystem::directory_iterator file(tempDir.path());
+        std::fstream stream(file->path().string(),
+                            std::ios::in | std::ios::out | std::ios::binary);
+        stream.seekg(100);
+        char byte = stream.get();
+        stream.seekp(100);
+        stream.put(~byte);
+        stream.close();
+
+        ASSERT_THROWS_CODE(
+            [&] {
+                while (iter->more())
+                    iter->next();
+            }(),
+            AssertionException,
+            50790);
+    }
+};
+
 
 class MergeIteratorTests {
 public:
@@ -550,6 +607,8 @@ public:
     void setupTests() {
         add<InMemIterTests>();
         add<SortedFileWriterAndFileIteratorTests>();
+        add<SortedFileWriterSpillOptionsTests>();
+        add<SortedFileWriterDetectsCorruption>();
         add<MergeIteratorTests>();
         add<SorterTests::Basic>();
         add<SorterTests::Limit>();
@@ -112,6 +112,17 @@ public:
 
     void append(BSONObjBuilder& b);
 
+    // Cumulative totals reported by append(), for callers which sample them without building BSON
+    long long getLogicalBytesIn() const {
+        return _together.logicalBytesIn.loadRelaxed();
+    }
+    long long getLogicalBytesOut() const {
+        return _logicalBytesOut.loadRelaxed();
+    }
+    long long getNumRequests() const {
+        return _together.requests.loadRelaxed();
+    }
+
 private:
     CacheAligned<AtomicInt64> _physicalBytesIn{0};
     CacheAligned<AtomicInt64> _physicalBytesOut{0};
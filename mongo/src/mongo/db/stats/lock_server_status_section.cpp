@@ -33,6 +33,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/concurrency/lock_stats.h"
+#include "mongo/db/concurrency/write_conflict_queue.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 
@@ -134,5 +135,23 @@ public:
 
 } lockStatsServerStatusSection;
 
+
+class WriteConflictQueueServerStatusSection : public ServerStatusSection {
+public:
+    WriteConflictQueueServerStatusSection() : ServerStatusSection("writeConflictQueue") {}
+
+    virtual bool includeByDefault() const {
+        return false;
+    }
+
+    virtual BSONObj generateSection(OperationContext* opCtx,
+                                    const BSONElement& configElement) const {
+        BSONObjBuilder ret;
+        WriteConflictQueue::get().appendStats(&ret);
+        return ret.obj();
+    }
+
+} writeConflictQueueServerStatusSection;
+
 }  // namespace
 }  // namespace mongo
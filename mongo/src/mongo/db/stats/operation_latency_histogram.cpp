@@ -31,66 +31,48 @@
 #include "mongo/db/stats/operation_latency_histogram.h"
 
 #include <algorithm>
+#include <cmath>
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
 
 namespace mongo {
 
 //ʱӰЩάȲΪͬ _getBucketжʱͳӦǸ
+namespace {
+// Below 8 microseconds the buckets are 2 microseconds wide. Each power of two from 8 microseconds
+// up to 2^24 microseconds (about 16 seconds) is then split into 4 equal buckets, which keeps the
+// relative error under 25% where service level objectives are usually set. Larger latencies get a
+// bucket per power of two, up to 2^40 microseconds.
+const int kNumLinearBuckets = 4;
+const int kFirstSplitLog2 = 3;
+const int kLastSplitLog2 = 23;
+const int kSubBucketsPerPowerOfTwo = 4;
+const int kFirstUnsplitBucket =
+    kNumLinearBuckets + (kLastSplitLog2 - kFirstSplitLog2 + 1) * kSubBucketsPerPowerOfTwo;
+
+std::array<uint64_t, OperationLatencyHistogram::kMaxBuckets> makeLowerBounds() {
+    std::array<uint64_t, OperationLatencyHistogram::kMaxBuckets> bounds;
+    int bucket = 0;
+    for (int i = 0; i < kNumLinearBuckets; ++i) {
+        bounds[bucket++] = 2 * i;
+    }
+    for (int log2 = kFirstSplitLog2; log2 <= kLastSplitLog2; ++log2) {
+        for (int sub = 0; sub < kSubBucketsPerPowerOfTwo; ++sub) {
+            bounds[bucket++] = (1ULL << log2) + sub * (1ULL << (log2 - 2));
+        }
+    }
+    for (int log2 = kLastSplitLog2 + 1; bucket < OperationLatencyHistogram::kMaxBuckets; ++log2) {
+        bounds[bucket++] = 1ULL << log2;
+    }
+    return bounds;
+}
+}  // namespace
+
 const std::array<uint64_t, OperationLatencyHistogram::kMaxBuckets>
-    OperationLatencyHistogram::kLowerBounds = {0,
-                                               2,
-                                               4,
-                                               8,
-                                               16,
-                                               32,
-                                               64,
-                                               128,
-                                               256,
-                                               512,
-                                               1024,
-                                               2048,
-                                               3072,
-                                               4096,
-                                               6144,
-                                               8192,
-                                               12288,
-                                               16384,
-                                               24576,
-                                               32768,
-                                               49152,
-                                               65536,
-                                               98304,
-                                               131072,
-                                               196608,
-                                               262144,
-                                               393216,
-                                               524288,
-                                               786432,
-                                               1048576,
-                                               1572864,
-                                               2097152,
-                                               4194304,
-                                               8388608,
-                                               16777216,
-                                               33554432,
-                                               67108864,
-                                               134217728,
-                                               268435456,
-                                               536870912,
-                                               1073741824,
-                                               2147483648,
-                                               4294967296,
-                                               8589934592,
-                                               17179869184,
-                                               34359738368,
-                                               68719476736,
-                                               137438953472,
-                                               274877906944,
-                                               549755813888,
-                                               1099511627776};
+    OperationLatencyHistogram::kLowerBounds = makeLowerBounds();
 
 
 /*
@@ -161,6 +143,9 @@ void OperationLatencyHistogram::_append(const HistogramData& data,
     }
     histogramBuilder.append("latency", static_cast<long long>(data.sum));
     histogramBuilder.append("ops", static_cast<long long>(data.entryCount));
+    histogramBuilder.append("p50", static_cast<long long>(_getPercentile(data, 0.5)));
+    histogramBuilder.append("p99", static_cast<long long>(_getPercentile(data, 0.99)));
+    histogramBuilder.append("p999", static_cast<long long>(_getPercentile(data, 0.999)));
     histogramBuilder.doneFast();
 }
 
@@ -195,31 +180,40 @@ This indicates that there were:
 //¼ͬʱ־ϸͳ
 //ȷlatencyʱӶӦ[0-2](2-4](4-8](8-16](16-32](32-64](64-128]...еǸ  
 //ֱӦbucketsͰ0Ͱ1Ͱ2Ͱ3ȴҲ[0-2]ӦͰ0(2-4]ӦͰ1(4-8]ӦͰ2(8-16]ӦͰ3
-// Computes the log base 2 of value, and checks for cases of split buckets.
+// Computes the log base 2 of value, and which of its sub-buckets value falls into.
 int OperationLatencyHistogram::_getBucket(uint64_t value) {
-    // Zero is a special case since log(0) is undefined.
-    if (value == 0) {
-        return 0;
+    if (value < 2 * kNumLinearBuckets) {
+        return value / 2;
     }
 
     int log2 = 63 - countLeadingZeros64(value);
-    // Half splits occur in range [2^11, 2^21) giving 10 extra buckets.
-    if (log2 < 11) {
-        return log2;
-    } else if (log2 < 21) {
-        int extra = log2 - 11;
-        // Split value boundary is at (2^n + 2^(n+1))/2 = 2^n + 2^(n-1).
-        // Which corresponds to (1ULL << log2) | (1ULL << (log2 - 1))
-        // Which is equivalent to the following:
-        uint64_t splitBoundary = 3ULL << (log2 - 1);
-        if (value >= splitBoundary) {
-            extra++;
+    if (log2 <= kLastSplitLog2) {
+        // The two bits below the leading one select the quarter of the power of two.
+        int sub = (value >> (log2 - 2)) & (kSubBucketsPerPowerOfTwo - 1);
+        return kNumLinearBuckets + (log2 - kFirstSplitLog2) * kSubBucketsPerPowerOfTwo + sub;
+    }
+    return std::min(kFirstUnsplitBucket + log2 - kLastSplitLog2 - 1, kMaxBuckets - 1);
+}
+
+uint64_t OperationLatencyHistogram::_getPercentile(const HistogramData& data, double quantile) {
+    if (data.entryCount == 0) {
+        return 0;
+    }
+
+    const uint64_t rank =
+        std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * data.entryCount)));
+    uint64_t seen = 0;
+    for (int i = 0; i < kMaxBuckets; i++) {
+        if (seen + data.buckets[i] < rank) {
+            seen += data.buckets[i];
+            continue;
         }
-        return log2 + extra;
-    } else {
-        // Add all of the extra 10 buckets.
-        return std::min(log2 + 10, kMaxBuckets - 1);
+        // Report the highest latency the bucket can hold when the rank is its last entry.
+        const uint64_t lower = kLowerBounds[i];
+        const uint64_t highest = (i + 1 < kMaxBuckets) ? kLowerBounds[i + 1] - 1 : lower;
+        return lower + (highest - lower) * (rank - seen) / data.buckets[i];
     }
+    MONGO_UNREACHABLE;
 }
 
 //OperationLatencyHistogram::incrementе
@@ -242,6 +236,20 @@ db.collection.latencyStats( { histograms:true}).pretty()(
 
 //ͬοgetReadWriteType
 //Top::_incrementHistogram   ʱӼ
+void OperationLatencyHistogram::_addData(const HistogramData& from, HistogramData* to) {
+    for (int i = 0; i < kMaxBuckets; ++i) {
+        to->buckets[i] += from.buckets[i];
+    }
+    to->entryCount += from.entryCount;
+    to->sum += from.sum;
+}
+
+void OperationLatencyHistogram::add(const OperationLatencyHistogram& other) {
+    _addData(other._reads, &_reads);
+    _addData(other._writes, &_writes);
+    _addData(other._commands, &_commands);
+}
+
 void OperationLatencyHistogram::increment(uint64_t latency, Command::ReadWriteType type) {
 	//ȷlatencyʱӶӦ[0-2](2-4](4-8](8-16](16-32](32-64](64-128]...еǸ??
 	int bucket = _getBucket(latency);
@@ -52,7 +52,7 @@ class BSONObjBuilder;
 class OperationLatencyHistogram {
 public:
     //ͰOperationLatencyHistogram::kLowerBoundsС
-    static const int kMaxBuckets = 51;
+    static const int kMaxBuckets = 105;
 
     // Inclusive lower bounds of the histogram buckets.
     static const std::array<uint64_t, kMaxBuckets> kLowerBounds;
@@ -63,10 +63,16 @@ public:
     void increment(uint64_t latency, Command::ReadWriteType type);
 
     /**
-     * Appends the three histograms with latency totals and operation counts.
+     * Appends the three histograms with latency totals, operation counts and estimated p50, p99
+     * and p99.9 latencies.
      */
     void append(bool includeHistograms, BSONObjBuilder* builder) const;
 
+    /**
+     * Adds the latencies and operation counts recorded in 'other' to this histogram.
+     */
+    void add(const OperationLatencyHistogram& other);
+
 private:
     struct HistogramData {
         std::array<uint64_t, kMaxBuckets> buckets{};
@@ -76,6 +82,12 @@ private:
 
     static int _getBucket(uint64_t latency);
 
+    /**
+     * Estimates the latency below which the fraction 'quantile' of the operations in 'data' fall,
+     * by interpolating within the bucket holding that rank.
+     */
+    static uint64_t _getPercentile(const HistogramData& data, double quantile);
+
     static uint64_t _getBucketMicros(int bucket);
 
     void _append(const HistogramData& data,
@@ -85,6 +97,8 @@ private:
 
     void _incrementData(uint64_t latency, int bucket, HistogramData* data);
 
+    static void _addData(const HistogramData& from, HistogramData* to);
+
     HistogramData _reads, _writes, _commands;
 };
 }  // namespace mongo
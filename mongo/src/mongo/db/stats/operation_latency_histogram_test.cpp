@@ -89,4 +89,83 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatency) {
         ASSERT_EQUALS(bucket["count"].Long(), (i < kMaxBuckets - 1) ? 3 : 2);
     }
 }
+
+TEST(OperationLatencyHistogram, BucketsSplitPowersOfTwo) {
+    // Sub-millisecond latencies that differ by less than a factor of two land in their own buckets.
+    OperationLatencyHistogram hist;
+    hist.increment(256, Command::ReadWriteType::kRead);
+    hist.increment(320, Command::ReadWriteType::kRead);
+    hist.increment(384, Command::ReadWriteType::kRead);
+    hist.increment(448, Command::ReadWriteType::kRead);
+
+    BSONObjBuilder outBuilder;
+    hist.append(true, &outBuilder);
+    BSONObj out = outBuilder.done();
+    std::vector<BSONElement> readBuckets = out["reads"]["histogram"].Array();
+    ASSERT_EQUALS(readBuckets.size(), 4U);
+    ASSERT_EQUALS(readBuckets[0].Obj()["micros"].Long(), 256);
+    ASSERT_EQUALS(readBuckets[1].Obj()["micros"].Long(), 320);
+    ASSERT_EQUALS(readBuckets[2].Obj()["micros"].Long(), 384);
+    ASSERT_EQUALS(readBuckets[3].Obj()["micros"].Long(), 448);
+}
+
+TEST(OperationLatencyHistogram, ReportsPercentiles) {
+    OperationLatencyHistogram hist;
+    BSONObjBuilder emptyBuilder;
+    hist.append(false, &emptyBuilder);
+    BSONObj empty = emptyBuilder.done();
+    ASSERT_EQUALS(empty["reads"]["p50"].Long(), 0);
+    ASSERT_EQUALS(empty["reads"]["p999"].Long(), 0);
+
+    // 990 fast reads and 10 slow ones.
+    for (int i = 0; i < 990; i++) {
+        hist.increment(100, Command::ReadWriteType::kRead);
+    }
+    for (int i = 0; i < 10; i++) {
+        hist.increment(50000, Command::ReadWriteType::kRead);
+    }
+
+    BSONObjBuilder outBuilder;
+    hist.append(false, &outBuilder);
+    BSONObj out = outBuilder.done();
+
+    // 100 falls into the [96, 112) bucket and 50000 into the [49152, 57344) bucket.
+    long long p50 = out["reads"]["p50"].Long();
+    ASSERT_GTE(p50, 96);
+    ASSERT_LT(p50, 112);
+    long long p99 = out["reads"]["p99"].Long();
+    ASSERT_GTE(p99, 96);
+    ASSERT_LT(p99, 112);
+    long long p999 = out["reads"]["p999"].Long();
+    ASSERT_GTE(p999, 49152);
+    ASSERT_LT(p999, 57344);
+    ASSERT_EQUALS(out["writes"]["p50"].Long(), 0);
+}
+
+TEST(OperationLatencyHistogram, AddCombinesCountsAndLatencies) {
+    OperationLatencyHistogram first;
+    first.increment(1, Command::ReadWriteType::kRead);
+    first.increment(100, Command::ReadWriteType::kWrite);
+
+    OperationLatencyHistogram second;
+    second.increment(1, Command::ReadWriteType::kRead);
+    second.increment(1000, Command::ReadWriteType::kCommand);
+
+    first.add(second);
+
+    BSONObjBuilder outBuilder;
+    first.append(true, &outBuilder);
+    BSONObj out = outBuilder.done();
+    ASSERT_EQUALS(out["reads"]["ops"].Long(), 2);
+    ASSERT_EQUALS(out["reads"]["latency"].Long(), 2);
+    ASSERT_EQUALS(out["writes"]["ops"].Long(), 1);
+    ASSERT_EQUALS(out["writes"]["latency"].Long(), 100);
+    ASSERT_EQUALS(out["commands"]["ops"].Long(), 1);
+    ASSERT_EQUALS(out["commands"]["latency"].Long(), 1000);
+
+    // Both reads fall into the same bucket.
+    std::vector<BSONElement> readBuckets = out["reads"]["histogram"].Array();
+    ASSERT_EQUALS(readBuckets.size(), 1U);
+    ASSERT_EQUALS(readBuckets[0].Obj()["count"].Long(), 2);
+}
 }  // namespace mongo
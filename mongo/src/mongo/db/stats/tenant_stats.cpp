@@ -0,0 +1,114 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/tenant_stats.h"
+
+#include <boost/functional/hash.hpp>
+#include <time.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+const auto getTenantStats = ServiceContext::declareDecoration<TenantStats>();
+}  // namespace
+
+TenantStats& TenantStats::get(ServiceContext* service) {
+    return getTenantStats(service);
+}
+
+TenantStats::Usage* TenantStats::_getOrCreate(StringData dbName) {
+    auto& shard = _shards[boost::hash_range(dbName.rawData(), dbName.rawData() + dbName.size()) %
+                          kNumShards];
+    stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+    auto& usage = shard.usage[dbName];
+    if (!usage) {
+        usage = std::make_shared<Usage>();
+    }
+    return usage.get();
+}
+
+void TenantStats::recordOperation(StringData dbName, const OperationUsage& usage, Date_t now) {
+    Usage* entry = _getOrCreate(dbName);
+    entry->numOps.fetchAndAdd(1);
+    entry->cpuMicros.fetchAndAdd(usage.cpuMicros);
+    entry->ticketWaitMicros.fetchAndAdd(usage.ticketWaitMicros);
+    entry->keysExamined.fetchAndAdd(usage.keysExamined);
+    entry->docsExamined.fetchAndAdd(usage.docsExamined);
+
+    // Whichever operation first sees a new second starts its window. An operation racing with it
+    // may have its CPU time counted in either window, which is fine for throttling.
+    const long long secs = durationCount<Seconds>(now.toDurationSinceEpoch());
+    const long long windowSecs = entry->windowSecs.load();
+    if (windowSecs < secs && entry->windowSecs.compareAndSwap(windowSecs, secs) == windowSecs) {
+        entry->windowCpuMicros.store(usage.cpuMicros);
+    } else {
+        entry->windowCpuMicros.fetchAndAdd(usage.cpuMicros);
+    }
+}
+
+bool TenantStats::checkOverQuota(StringData dbName, long long cpuMicrosPerSecond, Date_t now) {
+    Usage* entry = _getOrCreate(dbName);
+    if (entry->windowSecs.load() != durationCount<Seconds>(now.toDurationSinceEpoch()) ||
+        entry->windowCpuMicros.load() <= cpuMicrosPerSecond) {
+        return false;
+    }
+    entry->numThrottled.fetchAndAdd(1);
+    return true;
+}
+
+void TenantStats::report(BSONObjBuilder* builder) const {
+    for (const auto& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+        for (const auto& entry : shard.usage) {
+            const Usage& usage = *entry.second;
+            BSONObjBuilder dbBuilder(builder->subobjStart(entry.first));
+            dbBuilder.append("ops", usage.numOps.load());
+            dbBuilder.append("throttledOps", usage.numThrottled.load());
+            dbBuilder.append("cpuMicros", usage.cpuMicros.load());
+            dbBuilder.append("ticketWaitMicros", usage.ticketWaitMicros.load());
+            dbBuilder.append("keysExamined", usage.keysExamined.load());
+            dbBuilder.append("docsExamined", usage.docsExamined.load());
+        }
+    }
+}
+
+long long TenantStats::currentThreadCpuMicros() {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+        return static_cast<long long>(ts.tv_sec) * 1000 * 1000 + ts.tv_nsec / 1000;
+    }
+#endif
+    return 0;
+}
+
+}  // namespace mongo
@@ -0,0 +1,122 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class ServiceContext;
+
+/**
+ * Accounts the resources that operations use per database, so a single noisy tenant among many
+ * databases can be identified, and optionally throttled once it exceeds a CPU quota.
+ *
+ * Databases are spread over independently locked shards, and the counters of each database are
+ * atomic, so recording an operation only contends with operations on the same shard.
+ */
+class TenantStats {
+    MONGO_DISALLOW_COPYING(TenantStats);
+
+public:
+    /**
+     * The resources used by one operation.
+     */
+    struct OperationUsage {
+        long long cpuMicros = 0;
+        long long ticketWaitMicros = 0;
+        long long keysExamined = 0;
+        long long docsExamined = 0;
+    };
+
+    static TenantStats& get(ServiceContext* service);
+
+    TenantStats() = default;
+
+    /**
+     * Adds the resources used by an operation to the totals of 'dbName', and to the CPU time it
+     * has used in the current one second quota window.
+     */
+    void recordOperation(StringData dbName, const OperationUsage& usage, Date_t now);
+
+    /**
+     * Returns true if operations on 'dbName' have used more than 'cpuMicrosPerSecond' of CPU time
+     * in the current quota window. Also counts the caller as a throttled operation of 'dbName'
+     * when the quota is exceeded, since callers only ask in order to throttle.
+     */
+    bool checkOverQuota(StringData dbName, long long cpuMicrosPerSecond, Date_t now);
+
+    /**
+     * Appends one subdocument per database with the totals recorded for it.
+     */
+    void report(BSONObjBuilder* builder) const;
+
+    /**
+     * Returns the CPU time consumed by the calling thread, or 0 where it cannot be measured.
+     */
+    static long long currentThreadCpuMicros();
+
+private:
+    struct Usage {
+        AtomicInt64 numOps;
+        AtomicInt64 numThrottled;
+        AtomicInt64 cpuMicros;
+        AtomicInt64 ticketWaitMicros;
+        AtomicInt64 keysExamined;
+        AtomicInt64 docsExamined;
+
+        // The quota window: the second it covers, and the CPU time used in it.
+        AtomicInt64 windowSecs;
+        AtomicInt64 windowCpuMicros;
+    };
+
+    struct Shard {
+        mutable stdx::mutex mutex;
+
+        // Entries are never removed, so pointers to them stay valid without the mutex.
+        StringMap<std::shared_ptr<Usage>> usage;
+    };
+
+    static constexpr std::size_t kNumShards = 16;
+
+    Usage* _getOrCreate(StringData dbName);
+
+    std::array<Shard, kNumShards> _shards;
+};
+
+}  // namespace mongo
@@ -0,0 +1,87 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/stats/tenant_stats.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+
+const Date_t kNow = Date_t::fromMillisSinceEpoch(100 * 1000);
+
+TEST(TenantStatsTest, RecordOperationAccumulatesPerDatabase) {
+    TenantStats stats;
+    TenantStats::OperationUsage usage;
+    usage.cpuMicros = 10;
+    usage.ticketWaitMicros = 2;
+    usage.keysExamined = 3;
+    usage.docsExamined = 4;
+    stats.recordOperation("a", usage, kNow);
+    stats.recordOperation("a", usage, kNow);
+    stats.recordOperation("b", usage, kNow);
+
+    BSONObjBuilder builder;
+    stats.report(&builder);
+    BSONObj report = builder.obj();
+    ASSERT_BSONOBJ_EQ(BSON("ops" << 2LL << "throttledOps" << 0LL << "cpuMicros" << 20LL
+                                 << "ticketWaitMicros"
+                                 << 4LL
+                                 << "keysExamined"
+                                 << 6LL
+                                 << "docsExamined"
+                                 << 8LL),
+                      report["a"].Obj());
+    ASSERT_EQ(1LL, report["b"].Obj()["ops"].numberLong());
+}
+
+TEST(TenantStatsTest, QuotaAppliesWithinCurrentSecondOnly) {
+    TenantStats stats;
+    TenantStats::OperationUsage usage;
+    usage.cpuMicros = 600;
+    stats.recordOperation("a", usage, kNow);
+    ASSERT_FALSE(stats.checkOverQuota("a", 1000, kNow));
+
+    stats.recordOperation("a", usage, kNow + Milliseconds(500));
+    ASSERT_TRUE(stats.checkOverQuota("a", 1000, kNow + Milliseconds(500)));
+    ASSERT_FALSE(stats.checkOverQuota("b", 1000, kNow + Milliseconds(500)));
+
+    // A new second starts a new window, with no CPU time used in it yet.
+    ASSERT_FALSE(stats.checkOverQuota("a", 1000, kNow + Seconds(1)));
+    stats.recordOperation("a", usage, kNow + Seconds(1));
+    ASSERT_FALSE(stats.checkOverQuota("a", 1000, kNow + Seconds(1)));
+
+    BSONObjBuilder builder;
+    stats.report(&builder);
+    ASSERT_EQ(1LL, builder.obj()["a"].Obj()["throttledOps"].numberLong());
+}
+
+}  // namespace
@@ -35,6 +35,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -73,6 +74,21 @@ Top::CollectionData::CollectionData(const CollectionData& older, const Collectio
       remove(older.remove, newer.remove),
       commands(older.commands, newer.commands) {}
 
+void Top::CollectionData::add(const CollectionData& other) {
+    total.add(other.total);
+    readLock.add(other.readLock);
+    writeLock.add(other.writeLock);
+    queries.add(other.queries);
+    getmore.add(other.getmore);
+    insert.add(other.insert);
+    update.add(other.update);
+    remove.add(other.remove);
+    commands.add(other.commands);
+    opLatencyHistogram.add(other.opLatencyHistogram);
+}
+
+const size_t Top::kNumStripes;
+
 // static
 Top& Top::get(ServiceContext* service) {
     return getTop(service);
@@ -98,15 +114,16 @@ void Top::record(OperationContext* opCtx,
 
 	//ݱMapҵñڱжӦhashλ
     auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    Stripe& stripe = _stripeForCurrentThread();
+    stdx::lock_guard<SimpleMutex> lk(stripe.lock);
 
 	//nsѾɾıֱӷ
-    if ((command || logicalOp == LogicalOp::opQuery) && ns == _lastDropped) {
-        _lastDropped = "";
+    if ((command || logicalOp == LogicalOp::opQuery) && ns == stripe.lastDropped) {
+        stripe.lastDropped = "";
         return;
     }
 	//ҵıӦCollectionData
-    CollectionData& coll = _usage[hashedNs];
+    CollectionData& coll = stripe.usage[hashedNs];
 	//ʼͳ
     _record(opCtx, coll, logicalOp, lockType, micros, readWriteType);
 }
@@ -160,26 +177,47 @@ void Top::_record(OperationContext* opCtx,
     }
 }
 
+Top::Stripe& Top::_stripeForCurrentThread() {
+    // Threads are spread over the stripes round robin the first time they record an operation.
+    static AtomicUInt32 nextStripe;
+    static thread_local uint32_t threadStripe = nextStripe.fetchAndAdd(1);
+    return _stripes[threadStripe % kNumStripes];
+}
+
+Top::UsageMap Top::_aggregateUsage() const {
+    UsageMap aggregated;
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard<SimpleMutex> lk(stripe.lock);
+        for (auto&& entry : stripe.usage) {
+            aggregated[entry.first].add(entry.second);
+        }
+    }
+    return aggregated;
+}
+
 void Top::collectionDropped(StringData ns, bool databaseDropped) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _usage.erase(ns);
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard<SimpleMutex> lk(stripe.lock);
+        stripe.usage.erase(ns);
+    }
     if (!databaseDropped) {
         // If a collection drop occurred, there will be a subsequent call to record for this
         // collection namespace which must be ignored. This does not apply to a database drop.
-        _lastDropped = ns.toString();
+        // That call comes from the dropping thread, so it is enough to note it in its stripe.
+        Stripe& stripe = _stripeForCurrentThread();
+        stdx::lock_guard<SimpleMutex> lk(stripe.lock);
+        stripe.lastDropped = ns.toString();
     }
 }
 
 void Top::cloneMap(Top::UsageMap& out) const {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    out = _usage;
+    out = _aggregateUsage();
 }
 //
 //ServiceEntryPointMongod::handleRequest->Top::incrementGlobalLatencyStatsлȡдʱͳ(db.serverStatus().opLatencies)
 //TopCommand::run->Top::appendȡϸcountʱͳ(db.runCommand( { top: 1 } ))
 void Top::append(BSONObjBuilder& b) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _appendToUsageMap(b, _usage);
+    _appendToUsageMap(b, _aggregateUsage());
 }
 
 //Top::append
@@ -227,9 +265,16 @@ void Top::_appendStatsEntry(BSONObjBuilder& b, const char* statsName, const Usag
 //Ķ д commandʱͳ
 void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuilder* builder) {
     auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    OperationLatencyHistogram histogram;
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard<SimpleMutex> lk(stripe.lock);
+        auto it = stripe.usage.find(hashedNs);
+        if (it != stripe.usage.end()) {
+            histogram.add(it->second.opLatencyHistogram);
+        }
+    }
     BSONObjBuilder latencyStatsBuilder;
-    _usage[hashedNs].opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
+    histogram.append(includeHistograms, &latencyStatsBuilder);
     builder->append("ns", ns);
     builder->append("latencyStats", latencyStatsBuilder.obj());
 }
@@ -262,15 +307,19 @@ featdoc_1:PRIMARY>
 void Top::incrementGlobalLatencyStats(OperationContext* opCtx,
                                       uint64_t latency,
                                       Command::ReadWriteType readWriteType) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _incrementHistogram(opCtx, latency, &_globalHistogramStats, readWriteType);
+    Stripe& stripe = _stripeForCurrentThread();
+    stdx::lock_guard<SimpleMutex> guard(stripe.lock);
+    _incrementHistogram(opCtx, latency, &stripe.globalHistogramStats, readWriteType);
 }
 
 //GlobalHistogramServerStatusSectiongenerateSectionӿڵãdb.serverStatus().opLatenciesȡʱϢ
 void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-	//OperationLatencyHistogram::append
-    _globalHistogramStats.append(includeHistograms, builder);
+    OperationLatencyHistogram histogram;
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard<SimpleMutex> guard(stripe.lock);
+        histogram.add(stripe.globalHistogramStats);
+    }
+    histogram.append(includeHistograms, builder);
 }
 
 //Top::incrementGlobalLatencyStats  дʱ
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <array>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
 #include "mongo/db/commands.h"
@@ -65,6 +66,11 @@ public:
             count++;
             time += micros;
         }
+
+        void add(const UsageData& other) {
+            count += other.count;
+            time += other.time;
+        }
     };
 
     //db.runCommand( { top: 1 } )еͳϢopʱ
@@ -76,6 +82,12 @@ public:
          */
         CollectionData() {}
         CollectionData(const CollectionData& older, const CollectionData& newer);
+
+        /**
+         * Adds the usage recorded in 'other' to this.
+         */
+        void add(const CollectionData& other);
+
         //ܵģ[queries,commands]
         UsageData total;
         
@@ -148,6 +160,28 @@ public:
     void appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder);
 
 private:
+    /**
+     * Operations record their statistics into the stripe of the thread running them, each with its
+     * own lock, so that concurrent operations rarely contend. Readers add up all the stripes.
+     */
+    struct Stripe {
+        mutable SimpleMutex lock;  // Guards the members below.
+        OperationLatencyHistogram globalHistogramStats;
+        UsageMap usage;
+        // The namespace most recently dropped by a thread recording into this stripe. The drop
+        // command itself ends after the drop, and must not recreate the namespace's entry.
+        std::string lastDropped;
+    };
+
+    static const size_t kNumStripes = 8;
+
+    Stripe& _stripeForCurrentThread();
+
+    /**
+     * Returns the usage of every namespace, added up over all the stripes.
+     */
+    UsageMap _aggregateUsage() const;
+
     void _appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const;
 
     void _appendStatsEntry(BSONObjBuilder& b, const char* statsName, const UsageData& map) const;
@@ -164,19 +198,7 @@ private:
                              OperationLatencyHistogram* histogram,
                              Command::ReadWriteType readWriteType);
 
-    mutable SimpleMutex _lock;
-    //дdb.serverStatus().opLatenciesؼбͳ ---ȫγ
-    //db.collection.latencyStats( { histograms:true})  --- γ
-    //db.collection.latencyStats( { histograms:false}) --- γ
-
-
-    
-    //Top._globalHistogramStatsȫ(б)Ĳʱͳ-ȫγ
-    //CollectionData.opLatencyHistogramǱĶдcommandͳ-γ
-    OperationLatencyHistogram _globalHistogramStats;
-    //ÿϸqpsʱͳ   db.runCommand( { top: 1 } )ȡ
-    UsageMap _usage;  //mapÿռһοTop::record
-    std::string _lastDropped;
+    std::array<Stripe, kNumStripes> _stripes;
 };
 
 }  // namespace mongo
@@ -0,0 +1,96 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/block_sample_record_cursor.h"
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+BlockSampleRecordCursor::BlockSampleRecordCursor(
+    std::unique_ptr<RecordCursor> randomCursor,
+    std::unique_ptr<SeekableRecordCursor> forwardCursor,
+    size_t blockSize)
+    : _randomCursor(std::move(randomCursor)),
+      _forwardCursor(std::move(forwardCursor)),
+      _blockSize(blockSize) {
+    invariant(_randomCursor);
+    invariant(_forwardCursor);
+    invariant(_blockSize > 0);
+}
+
+boost::optional<Record> BlockSampleRecordCursor::next() {
+    if (_remainingInBlock > 0) {
+        if (auto record = _forwardCursor->next()) {
+            --_remainingInBlock;
+            return record;
+        }
+
+        // The block ran into the end of the store. Start the next one early.
+        _remainingInBlock = 0;
+    }
+
+    auto start = _randomCursor->next();
+    if (!start) {
+        return boost::none;
+    }
+
+    // Position the forward cursor on the first record of the block. If the record has gone away
+    // in the meantime, it can't be positioned, so the block is just this one record.
+    if (auto record = _forwardCursor->seekExact(start->id)) {
+        _remainingInBlock = _blockSize - 1;
+        return record;
+    }
+    return start;
+}
+
+void BlockSampleRecordCursor::save() {
+    _randomCursor->save();
+    _forwardCursor->save();
+}
+
+bool BlockSampleRecordCursor::restore() {
+    // Both cursors must be restored, so don't short-circuit.
+    const bool randomRestored = _randomCursor->restore();
+    const bool forwardRestored = _forwardCursor->restore();
+    return randomRestored && forwardRestored;
+}
+
+void BlockSampleRecordCursor::detachFromOperationContext() {
+    _randomCursor->detachFromOperationContext();
+    _forwardCursor->detachFromOperationContext();
+}
+
+void BlockSampleRecordCursor::reattachToOperationContext(OperationContext* opCtx) {
+    _randomCursor->reattachToOperationContext(opCtx);
+    _forwardCursor->reattachToOperationContext(opCtx);
+}
+
+}  // namespace mongo
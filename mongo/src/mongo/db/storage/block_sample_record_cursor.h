@@ -0,0 +1,71 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/db/storage/record_store.h"
+
+namespace mongo {
+
+/**
+ * A RecordCursor which samples a RecordStore in contiguous runs of records. It uses a random
+ * cursor to choose where each run starts, and a forward cursor to read the 'blockSize' records
+ * which follow. Sampling in blocks keeps most reads on pages which are already in cache, at the
+ * cost of returning clusters of neighbouring records rather than independent ones.
+ *
+ * Like the random cursor, this may return the same record more than once, so callers must be
+ * prepared to discard duplicates.
+ */
+class BlockSampleRecordCursor final : public RecordCursor {
+public:
+    BlockSampleRecordCursor(std::unique_ptr<RecordCursor> randomCursor,
+                            std::unique_ptr<SeekableRecordCursor> forwardCursor,
+                            size_t blockSize);
+
+    boost::optional<Record> next() final;
+
+    void save() final;
+
+    bool restore() final;
+
+    void detachFromOperationContext() final;
+
+    void reattachToOperationContext(OperationContext* opCtx) final;
+
+private:
+    const std::unique_ptr<RecordCursor> _randomCursor;
+    const std::unique_ptr<SeekableRecordCursor> _forwardCursor;
+    const size_t _blockSize;
+
+    // The number of records left to read from '_forwardCursor' before starting a new block.
+    size_t _remainingInBlock = 0;
+};
+
+}  // namespace mongo
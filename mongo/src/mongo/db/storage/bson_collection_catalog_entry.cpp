@@ -144,6 +144,15 @@ void BSONCollectionCatalogEntry::getAllIndexes(OperationContext* opCtx,
     }
 }
 
+void BSONCollectionCatalogEntry::getAllIndexSpecs(OperationContext* opCtx,
+                                                  std::vector<BSONObj>* specs) const {
+    MetaData md = _getMetaData(opCtx);
+
+    for (unsigned i = 0; i < md.indexes.size(); i++) {
+        specs->push_back(md.indexes[i].spec.getOwned());
+    }
+}
+
 bool BSONCollectionCatalogEntry::isIndexMultikey(OperationContext* opCtx,
                                                  StringData indexName,
                                                  MultikeyPaths* multikeyPaths) const {
@@ -59,6 +59,8 @@ public:
 
     virtual void getAllIndexes(OperationContext* opCtx, std::vector<std::string>* names) const;
 
+    void getAllIndexSpecs(OperationContext* opCtx, std::vector<BSONObj>* specs) const override;
+
     virtual bool isIndexMultikey(OperationContext* opCtx,
                                  StringData indexName,
                                  MultikeyPaths* multikeyPaths) const;
@@ -34,6 +34,7 @@
 
 #include "mongo/db/storage/key_string.h"
 
+#include <algorithm>
 #include <cmath>
 #include <type_traits>
 
@@ -229,10 +230,20 @@ const uint8_t kGreater = 254;
 
 // some utility functions
 namespace {
+// Copies 'bytes' bytes from 'src' to 'dst', inverting every bit. 'dst' and 'src' may be the same.
+// Works a word at a time, since descending index fields invert every byte they encode or decode.
 void memcpy_flipBits(void* dst, const void* src, size_t bytes) {
     const char* input = static_cast<const char*>(src);
     char* output = static_cast<char*>(dst);
     const char* const end = input + bytes;
+    while (end - input >= static_cast<std::ptrdiff_t>(sizeof(uint64_t))) {
+        uint64_t word;
+        memcpy(&word, input, sizeof(word));
+        word = ~word;
+        memcpy(output, &word, sizeof(word));
+        input += sizeof(word);
+        output += sizeof(word);
+    }
     while (input != end) {
         *output++ = ~(*input++);
     }
@@ -285,9 +296,7 @@ string readInvertedCString(BufReader* reader) {
     invariant(end);
     size_t actualBytes = end - start;
     string s(start, actualBytes);
-    for (size_t i = 0; i < s.size(); i++) {
-        s[i] = ~s[i];
-    }
+    memcpy_flipBits(&s[0], s.data(), s.size());
     reader->skip(1 + actualBytes);
     return s;
 }
@@ -314,10 +323,7 @@ string readInvertedCStringWithNuls(BufReader* reader) {
         reader->skip(1 + actualBytes);
     } while (reader->peek<unsigned char>() == 0x00);
 
-    for (size_t i = 0; i < out.size(); i++) {
-        out[i] = ~out[i];
-    }
-
+    memcpy_flipBits(&out[0], out.data(), out.size());
     return out;
 }
 }  // namespace
@@ -1691,7 +1697,11 @@ Decimal128 adjustDecimalExponent(TypeBits::Reader* typeBits, Decimal128 num) {
 }  // namespace
 
 BSONObj KeyString::toBson(const char* buffer, size_t len, Ordering ord, const TypeBits& typeBits) {
-    BSONObjBuilder builder;
+    // Index keys are usually far smaller than the builder's default buffer. These objects are often
+    // kept around, e.g. by covered plans and in-memory sorts, so size the buffer for the common
+    // case, where every field decodes to at most a few times its encoded size, plus some headroom.
+    const size_t kMaxInitialSize = 512;
+    BSONObjBuilder builder(static_cast<int>(std::min(len * 4 + 32, kMaxInitialSize)));
     BufReader reader(buffer, len);
     TypeBits::Reader typeBitsReader(typeBits);
     for (int i = 0; reader.remaining(); i++) {
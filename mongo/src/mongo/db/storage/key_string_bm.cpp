@@ -0,0 +1,94 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+const Ordering kOrdering = Ordering::make(BSON("a" << 1 << "b" << 1 << "c" << -1));
+
+// Keys in the shape produced by an index on {a: 1, b: 1, c: -1}, which have no field names.
+BSONObj makeKey(std::int64_t i) {
+    return BSON("" << static_cast<int>(i) << ""
+                   << "some string value"
+                   << ""
+                   << static_cast<double>(i) / 3);
+}
+
+void BM_keyStringEncode(benchmark::State& state) {
+    const BSONObj key = makeKey(12345);
+    KeyString ks(KeyString::kLatestVersion);
+    while (state.keepRunning()) {
+        ks.resetToKey(key, kOrdering, RecordId(42));
+        benchmark::doNotOptimize(ks.getBuffer());
+    }
+    state.setBytesProcessed(state.iterations() * key.objsize());
+}
+BENCHMARK(BM_keyStringEncode);
+
+void BM_keyStringDecode(benchmark::State& state) {
+    const BSONObj key = makeKey(12345);
+    const KeyString ks(KeyString::kLatestVersion, key, kOrdering);
+    while (state.keepRunning()) {
+        BSONObj decoded =
+            KeyString::toBson(ks.getBuffer(), ks.getSize(), kOrdering, ks.getTypeBits());
+        benchmark::doNotOptimize(decoded.objdata());
+    }
+    state.setBytesProcessed(state.iterations() * key.objsize());
+}
+BENCHMARK(BM_keyStringDecode);
+
+// Compares encoded keys, as the storage engine does for every step of an index search.
+void BM_keyStringCompare(benchmark::State& state) {
+    const KeyString left(KeyString::kLatestVersion, makeKey(1), kOrdering);
+    const KeyString right(KeyString::kLatestVersion, makeKey(2), kOrdering);
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(left.compare(right));
+    }
+}
+BENCHMARK(BM_keyStringCompare);
+
+// Compares the same keys as BSON, as a baseline for BM_keyStringCompare.
+void BM_bsonKeyCompare(benchmark::State& state) {
+    const BSONObj left = makeKey(1);
+    const BSONObj right = makeKey(2);
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(left.woCompare(right, kOrdering, 0));
+    }
+}
+BENCHMARK(BM_bsonKeyCompare);
+
+}  // namespace
+}  // namespace mongo
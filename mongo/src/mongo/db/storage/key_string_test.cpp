@@ -198,6 +198,24 @@ TEST_F(KeyStringTest, AllTypesSimple) {
     ROUNDTRIP(version, BSON("" << 1235123123123LL));
 }
 
+TEST_F(KeyStringTest, StringsOfManyLengths) {
+    // Descending fields invert their bytes a word at a time, so cover every length around a few
+    // word boundaries, with and without embedded NULs.
+    for (size_t length = 0; length <= 40; ++length) {
+        std::string str;
+        for (size_t i = 0; i < length; ++i) {
+            str += static_cast<char>('a' + i % 26);
+        }
+        ROUNDTRIP(version, BSON("" << str));
+        ROUNDTRIP(version, BSON("" << BSON("field" + str << str)));
+
+        if (length > 0) {
+            str[length / 2] = '\0';
+            ROUNDTRIP(version, BSON("" << str));
+        }
+    }
+}
+
 TEST_F(KeyStringTest, Array1) {
     BSONObj emptyArray = BSON("" << BSONArray());
 
@@ -111,6 +111,25 @@ public:
     const Entry _entry;
 };
 
+class KVCatalog::BumpVersionChange : public RecoveryUnit::Change {
+public:
+    explicit BumpVersionChange(KVCatalog* catalog) : _catalog(catalog) {}
+
+    virtual void commit() {
+        _catalog->_version.fetchAndAdd(1);
+    }
+    virtual void rollback() {
+        _catalog->_version.fetchAndAdd(1);
+    }
+
+    KVCatalog* const _catalog;
+};
+
+void KVCatalog::_noteCatalogChange(OperationContext* opCtx) {
+    _version.fetchAndAdd(1);
+    opCtx->recoveryUnit()->registerChange(new BumpVersionChange(this));
+}
+
 bool KVCatalog::FeatureTracker::isFeatureDocument(BSONObj obj) {
     BSONElement firstElem = obj.firstElement();
     if (firstElem.fieldNameStringData() == kIsFeatureDocumentFieldName) {
@@ -371,6 +390,7 @@ Status KVCatalog::newCollection(OperationContext* opCtx,
     }
 
     opCtx->recoveryUnit()->registerChange(new AddIdentChange(this, ns));
+    _noteCatalogChange(opCtx);
 
     BSONObj obj;
     {
@@ -508,6 +528,7 @@ void KVCatalog::putMetaData(OperationContext* opCtx,
     LOG(3) << "recording new metadata: " << obj;
     Status status = _rs->updateRecord(opCtx, loc, obj.objdata(), obj.objsize(), false, NULL);
     fassert(28521, status.isOK());
+    _noteCatalogChange(opCtx);
 }
 
 Status KVCatalog::renameCollection(OperationContext* opCtx,
@@ -541,6 +562,7 @@ Status KVCatalog::renameCollection(OperationContext* opCtx,
 
     opCtx->recoveryUnit()->registerChange(new RemoveIdentChange(this, fromNS, fromIt->second));
     opCtx->recoveryUnit()->registerChange(new AddIdentChange(this, toNS));
+    _noteCatalogChange(opCtx);
 
     _idents.erase(fromIt);
     _idents[toNS.toString()] = Entry(old["ident"].String(), loc);
@@ -557,6 +579,7 @@ Status KVCatalog::dropCollection(OperationContext* opCtx, StringData ns) {
     }
 
     opCtx->recoveryUnit()->registerChange(new RemoveIdentChange(this, ns, it->second));
+    _noteCatalogChange(opCtx);
 
     LOG(1) << "deleting metadata for " << ns << " @ " << it->second.storedLoc;
     _rs->deleteRecord(opCtx, it->second.storedLoc);
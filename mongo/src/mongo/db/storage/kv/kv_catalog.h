@@ -39,6 +39,7 @@
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/bson_collection_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 
 namespace mongo {
@@ -93,6 +94,16 @@ public:
 
     bool isUserDataIdent(StringData ident) const;
 
+    /**
+     * Returns a number that changes whenever a collection is created, dropped or renamed, or its
+     * metadata is written. It changes once when the change is made and again when the unit of
+     * work making it commits or rolls back, so a value read before and after some reads of the
+     * catalog only matches if no change was in progress in between.
+     */
+    uint64_t getVersion() const {
+        return _version.load();
+    }
+
     FeatureTracker* getFeatureTracker() const {
         invariant(_featureTracker);
         return _featureTracker.get();
@@ -101,6 +112,12 @@ public:
 private:
     class AddIdentChange;
     class RemoveIdentChange;
+    class BumpVersionChange;
+
+    /**
+     * Advances '_version' now and once more when the caller's unit of work completes.
+     */
+    void _noteCatalogChange(OperationContext* opCtx);
 
     BSONObj _findEntry(OperationContext* opCtx, StringData ns, RecordId* out = NULL) const;
 
@@ -134,6 +151,8 @@ private:
     NSToIdentMap _idents;
     mutable stdx::mutex _identsLock;
 
+    AtomicUInt64 _version;
+
     // Manages the feature document that may be present in the KVCatalog. '_featureTracker' is
     // guaranteed to be non-null after KVCatalog::init() is called.
     std::unique_ptr<FeatureTracker> _featureTracker;
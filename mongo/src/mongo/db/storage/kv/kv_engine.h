@@ -35,6 +35,7 @@
 #include <vector>
 
 #include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
 #include "mongo/base/string_data.h"
 #include "mongo/bson/timestamp.h"
 #include "mongo/db/catalog/collection_options.h"
@@ -184,6 +185,21 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    /**
+     * See StorageEngine::beginNonBlockingBackup for details
+     */
+    virtual StatusWith<std::vector<std::string>> beginNonBlockingBackup(OperationContext* opCtx) {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "The current storage engine doesn't support non-blocking backup");
+    }
+
+    /**
+     * See StorageEngine::endNonBlockingBackup for details
+     */
+    virtual void endNonBlockingBackup(OperationContext* opCtx) {
+        MONGO_UNREACHABLE;
+    }
+
     virtual bool isDurable() const = 0;
 
     /**
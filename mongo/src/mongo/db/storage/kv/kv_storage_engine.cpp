@@ -355,6 +355,24 @@ void KVStorageEngine::endBackup(OperationContext* opCtx) {
     _inBackupMode = false;
 }
 
+StatusWith<std::vector<std::string>> KVStorageEngine::beginNonBlockingBackup(
+    OperationContext* opCtx) {
+    // We should not proceed if we are already in backup mode
+    if (_inBackupMode)
+        return Status(ErrorCodes::BadValue, "Already in Backup Mode");
+    auto files = _engine->beginNonBlockingBackup(opCtx);
+    if (files.isOK())
+        _inBackupMode = true;
+    return files;
+}
+
+void KVStorageEngine::endNonBlockingBackup(OperationContext* opCtx) {
+    // We should never reach here if we aren't already in backup mode
+    invariant(_inBackupMode);
+    _engine->endNonBlockingBackup(opCtx);
+    _inBackupMode = false;
+}
+
 bool KVStorageEngine::isDurable() const {
     return _engine->isDurable();
 }
@@ -248,6 +248,10 @@ public:
         return _supportsDBLocking;
     }
 
+    boost::optional<uint64_t> getCatalogVersion() const override {
+        return _catalog->getVersion();
+    }
+
     virtual Status closeDatabase(OperationContext* opCtx, StringData db);
 
     virtual Status dropDatabase(OperationContext* opCtx, StringData db);
@@ -258,6 +262,10 @@ public:
 
     virtual void endBackup(OperationContext* opCtx);
 
+    virtual StatusWith<std::vector<std::string>> beginNonBlockingBackup(OperationContext* opCtx);
+
+    virtual void endNonBlockingBackup(OperationContext* opCtx);
+
     virtual bool isDurable() const;
 
     virtual bool isEphemeral() const;
@@ -83,6 +83,7 @@
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/mmap_v1/aligned_builder.h"
 #include "mongo/db/storage/mmap_v1/commit_notifier.h"
 #include "mongo/db/storage/mmap_v1/dur_commitjob.h"
@@ -137,12 +138,30 @@ enum {
     // How many commit cycles to do before considering doing a remap
     NumCommitsBeforeRemap = 10,
 
-    // How many outstanding journal flushes should be allowed before applying writer back
-    // pressure. Size of 1 allows two journal blocks to be in the process of being written -
-    // one on the journal writer's buffer and one blocked waiting to be picked up.
-    NumAsyncJournalWrites = 1,
+    // Upper bound for journalAsyncWriteBuffers. Each buffer starts at 4MB and grows with the
+    // largest group commit it has held.
+    MaxAsyncJournalWrites = 8,
 };
 
+// How many outstanding journal flushes should be allowed before applying writer back pressure.
+// A value of 1 allows two journal blocks to be in the process of being written - one on the
+// journal writer's buffer and one blocked waiting to be picked up. Larger values let the
+// durability thread prepare the next group commits while earlier ones are still being written.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(journalAsyncWriteBuffers, int, 1);
+
+// When at least this many threads are waiting for a j:true acknowledgement, the group commit
+// is started right away rather than at the next third of journalCommitIntervalMs. Zero keeps
+// the purely timer driven behaviour.
+MONGO_EXPORT_SERVER_PARAMETER(journalCommitWaitersThreshold, int, 0);
+
+/**
+ * Returns whether enough j:true waiters have accumulated to start a group commit early.
+ */
+bool shouldCommitEarly(unsigned nWaiting) {
+    const int threshold = journalCommitWaitersThreshold.load();
+    return threshold > 0 && nWaiting >= static_cast<unsigned>(threshold);
+}
+
 // Remap loop state
 unsigned remapFileToStartAt;
 
@@ -495,7 +514,8 @@ std::string Stats::S::_CSVHeader() const {
 std::string Stats::S::_asCSV() const {
     stringstream ss;
     ss << setprecision(2) << _commits << '\t' << _journaledBytes / 1000000.0 << '\t'
-       << _writeToDataFilesBytes / 1000000.0 << '\t' << _commitsInWriteLock << '\t' << 0 << '\t'
+       << _writeToDataFilesBytes / 1000000.0 << '\t' << _commitsInWriteLock << '\t'
+       << _earlyCommits << '\t'
        << (unsigned)(_prepLogBufferMicros / 1000) << '\t'
        << (unsigned)(_writeToJournalMicros / 1000) << '\t'
        << (unsigned)(_writeToDataFilesMicros / 1000) << '\t'
@@ -510,7 +530,7 @@ void Stats::S::_asObj(BSONObjBuilder* builder) const {
     b << "commits" << _commits << "journaledMB" << _journaledBytes / 1000000.0
       << "writeToDataFilesMB" << _writeToDataFilesBytes / 1000000.0 << "compression"
       << _journaledBytes / (_uncompressedBytes + 1.0) << "commitsInWriteLock" << _commitsInWriteLock
-      << "earlyCommits" << 0 << "timeMs"
+      << "earlyCommits" << _earlyCommits << "timeMs"
       << BSON("dt" << _durationMillis << "prepLogBuffer" << (unsigned)(_prepLogBufferMicros / 1000)
                    << "writeToJournal"
                    << (unsigned)(_writeToJournalMicros / 1000)
@@ -559,6 +579,11 @@ bool DurableImpl::commitNow(OperationContext* opCtx) {
 }
 
 bool DurableImpl::waitUntilDurable() {
+    // This thread is not yet counted as a waiter, hence the + 1
+    if (shouldCommitEarly(commitNotify.nWaiting() + 1)) {
+        flushRequested.notify_one();
+    }
+
     commitNotify.awaitBeyondNow();
     return true;
 }
@@ -702,7 +727,14 @@ static void durThread(ClockSource* cs, int64_t serverStartMs) {
     }
 
     // Spawn the journal writer thread
-    JournalWriter journalWriter(&commitNotify, &applyToDataFilesNotify, NumAsyncJournalWrites);
+    const int numAsyncJournalWrites =
+        std::max(1, std::min<int>(journalAsyncWriteBuffers, MaxAsyncJournalWrites));
+    if (numAsyncJournalWrites != journalAsyncWriteBuffers) {
+        warning() << "journalAsyncWriteBuffers must be between 1 and "
+                  << static_cast<int>(MaxAsyncJournalWrites) << ", using " << numAsyncJournalWrites;
+    }
+
+    JournalWriter journalWriter(&commitNotify, &applyToDataFilesNotify, numAsyncJournalWrites);
     journalWriter.start();
 
     // Used as an estimate of how much / how fast to remap
@@ -728,6 +760,13 @@ static void durThread(ClockSource* cs, int64_t serverStartMs) {
             stdx::unique_lock<stdx::mutex> lock(flushMutex);
 
             for (unsigned i = 0; i <= 2; i++) {
+                if (shouldCommitEarly(commitNotify.nWaiting())) {
+                    // Enough getLastError j:true waiters queued up while the previous commit
+                    // was in progress, so there is no point in waiting for more
+                    stats.curr()->_earlyCommits++;
+                    break;
+                }
+
                 if (stdx::cv_status::no_timeout ==
                     flushRequested.wait_for(lock, Milliseconds(oneThird).toSystemDuration())) {
                     // Someone forced a flush
@@ -60,6 +60,7 @@ struct Stats {
 
         unsigned _commits;
         unsigned _commitsInWriteLock;
+        unsigned _earlyCommits;
 
         uint64_t _journaledBytes;
         uint64_t _uncompressedBytes;
@@ -0,0 +1,111 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/oplog_slot_tracker.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+const auto getOplogSlotTracker = ServiceContext::declareDecoration<OplogSlotTracker>();
+}  // namespace
+
+OplogSlotTracker* OplogSlotTracker::get(ServiceContext* service) {
+    return &getOplogSlotTracker(service);
+}
+
+std::size_t OplogSlotTracker::_stripeForCurrentThread() {
+    return std::hash<stdx::thread::id>()(stdx::this_thread::get_id()) % kNumStripes;
+}
+
+OplogSlotTracker::Reservation OplogSlotTracker::reserve(
+    const stdx::function<Timestamp()>& reserveFn) {
+    const std::size_t stripeIndex = _stripeForCurrentThread();
+    auto& stripe = _stripes[stripeIndex];
+
+    // The clock is advanced with the stripe locked, so a capVisibility() call that visits this
+    // stripe after a newer reservation completed elsewhere is guaranteed to find this one.
+    stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+    const Timestamp ts = reserveFn();
+    stripe.inFlight.insert(ts);
+    stripe.newestReserved = std::max(stripe.newestReserved, ts);
+    ++stripe.numReserved;
+    return {ts, stripeIndex};
+}
+
+void OplogSlotTracker::release(const Reservation& reservation) {
+    auto& stripe = _stripes[reservation.stripe];
+    stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+    invariant(stripe.inFlight.erase(reservation.timestamp) == 1);
+}
+
+Timestamp OplogSlotTracker::capVisibility(const stdx::function<Timestamp()>& readVisibility) {
+    // 1. Every reservation at or below 'newestReserved' had advanced the clock, with its stripe
+    // locked, before this pass finished.
+    Timestamp newestReserved;
+    std::array<std::uint64_t, kNumStripes> numReserved;
+    for (std::size_t i = 0; i < kNumStripes; ++i) {
+        stdx::lock_guard<stdx::mutex> lk(_stripes[i].mutex);
+        newestReserved = std::max(newestReserved, _stripes[i].newestReserved);
+        numReserved[i] = _stripes[i].numReserved;
+    }
+
+    // 2. So this pass sees each of those that is still unregistered, along with any newer one that
+    // started before its stripe was visited.
+    Timestamp oldestInFlight = Timestamp::max();
+    for (auto& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+        if (!stripe.inFlight.empty()) {
+            oldestInFlight = std::min(oldestInFlight, *stripe.inFlight.begin());
+        }
+    }
+
+    Timestamp visible = readVisibility();
+    if (oldestInFlight != Timestamp::max()) {
+        visible = std::min(visible, Timestamp(oldestInFlight.asULL() - 1));
+    }
+
+    // 3. Reservations that started after their stripe was visited are newer than 'newestReserved',
+    // but may have been registered and committed in time to be part of 'visible'.
+    for (std::size_t i = 0; i < kNumStripes; ++i) {
+        stdx::lock_guard<stdx::mutex> lk(_stripes[i].mutex);
+        if (_stripes[i].numReserved != numReserved[i]) {
+            return std::min(visible, newestReserved);
+        }
+    }
+    return visible;
+}
+
+}  // namespace mongo
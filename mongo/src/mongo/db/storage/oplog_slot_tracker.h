@@ -0,0 +1,107 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <array>
+#include <set>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * Tracks the oplog timestamps that have been reserved from the logical clock but not yet given to
+ * the storage engine as a commit timestamp.
+ *
+ * A storage engine that derives oplog visibility from its timestamped transactions (WiredTiger's
+ * all_committed) cannot see such a reservation, so without this a later timestamp could become
+ * visible ahead of it. Writers used to close that window by reserving and registering under one
+ * global mutex; instead, reservations are spread over independently locked stripes, so concurrent
+ * writers contend only when they land on the same stripe, and the component that publishes oplog
+ * visibility caps it with capVisibility(), which visits every stripe.
+ */
+class OplogSlotTracker {
+    MONGO_DISALLOW_COPYING(OplogSlotTracker);
+
+public:
+    struct Reservation {
+        Timestamp timestamp;
+        std::size_t stripe;
+    };
+
+    static OplogSlotTracker* get(ServiceContext* service);
+
+    OplogSlotTracker() = default;
+
+    /**
+     * Calls 'reserveFn', which must reserve ticks from the logical clock and return the first one,
+     * and tracks the returned timestamp as in flight until release() is called for it. Nothing is
+     * tracked if 'reserveFn' throws.
+     */
+    Reservation reserve(const stdx::function<Timestamp()>& reserveFn);
+
+    /**
+     * Stops tracking a reservation once the storage engine has been given its timestamp.
+     */
+    void release(const Reservation& reservation);
+
+    /**
+     * Calls 'readVisibility', which must read the storage engine's oplog visibility point, and
+     * returns that point capped below every reservation that storage engine may not yet know
+     * about: the oldest reservation in flight, and any reservation that started while the point
+     * was being read.
+     */
+    Timestamp capVisibility(const stdx::function<Timestamp()>& readVisibility);
+
+private:
+    static constexpr std::size_t kNumStripes = 16;
+
+    struct Stripe {
+        stdx::mutex mutex;
+
+        // Reserved timestamps not yet released.
+        std::set<Timestamp> inFlight;
+
+        // The newest timestamp reserved on this stripe, and the number of reservations it has
+        // seen, so capVisibility() can tell which reservations started while it ran.
+        Timestamp newestReserved;
+        std::uint64_t numReserved = 0;
+    };
+
+    static std::size_t _stripeForCurrentThread();
+
+    std::array<Stripe, kNumStripes> _stripes;
+};
+
+}  // namespace mongo
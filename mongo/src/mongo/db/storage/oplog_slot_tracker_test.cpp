@@ -0,0 +1,91 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/oplog_slot_tracker.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(OplogSlotTrackerTest, VisibilityIsUncappedWithoutReservations) {
+    OplogSlotTracker tracker;
+    ASSERT_EQ(Timestamp(1, 5), tracker.capVisibility([] { return Timestamp(1, 5); }));
+}
+
+TEST(OplogSlotTrackerTest, InFlightReservationCapsVisibilityUntilReleased) {
+    OplogSlotTracker tracker;
+    auto reservation = tracker.reserve([] { return Timestamp(1, 3); });
+    ASSERT_EQ(Timestamp(1, 3), reservation.timestamp);
+
+    // A newer write may already be committed; it must stay hidden behind the reservation.
+    ASSERT_EQ(Timestamp(1, 2), tracker.capVisibility([] { return Timestamp(1, 5); }));
+    ASSERT_EQ(Timestamp(1, 1), tracker.capVisibility([] { return Timestamp(1, 1); }));
+
+    tracker.release(reservation);
+    ASSERT_EQ(Timestamp(1, 5), tracker.capVisibility([] { return Timestamp(1, 5); }));
+}
+
+TEST(OplogSlotTrackerTest, OldestInFlightReservationCapsVisibility) {
+    OplogSlotTracker tracker;
+    auto first = tracker.reserve([] { return Timestamp(1, 3); });
+    auto second = tracker.reserve([] { return Timestamp(1, 4); });
+
+    tracker.release(second);
+    ASSERT_EQ(Timestamp(1, 2), tracker.capVisibility([] { return Timestamp(1, 5); }));
+
+    tracker.release(first);
+    ASSERT_EQ(Timestamp(1, 5), tracker.capVisibility([] { return Timestamp(1, 5); }));
+}
+
+TEST(OplogSlotTrackerTest, ReservationDuringVisibilityReadCapsAtNewestEarlierReservation) {
+    OplogSlotTracker tracker;
+    tracker.release(tracker.reserve([] { return Timestamp(1, 3); }));
+
+    // A reservation that is made and registered while the visibility point is being read was not
+    // seen in flight, so visibility cannot pass the reservations that were known beforehand.
+    auto visible = tracker.capVisibility([&] {
+        tracker.release(tracker.reserve([] { return Timestamp(1, 4); }));
+        return Timestamp(1, 4);
+    });
+    ASSERT_EQ(Timestamp(1, 3), visible);
+
+    ASSERT_EQ(Timestamp(1, 4), tracker.capVisibility([] { return Timestamp(1, 4); }));
+}
+
+TEST(OplogSlotTrackerTest, FailedReservationIsNotTracked) {
+    OplogSlotTracker tracker;
+    ASSERT_THROWS(tracker.reserve([]() -> Timestamp { uasserted(ErrorCodes::BadValue, "fail"); }),
+                  AssertionException);
+    ASSERT_EQ(Timestamp(1, 5), tracker.capVisibility([] { return Timestamp(1, 5); }));
+}
+
+}  // namespace
+}  // namespace mongo
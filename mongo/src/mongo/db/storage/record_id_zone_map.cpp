@@ -0,0 +1,201 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/record_id_zone_map.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Returns true if 'operand' can only be matched by records which have a value for the field.
+ * Comparisons with null, undefined, MinKey or MaxKey can match records without the field, arrays
+ * can match arrays element-wise and NaN does not fit in the canonical order of numbers.
+ */
+bool canUseOperand(const BSONElement& operand) {
+    switch (operand.type()) {
+        case jstNULL:
+        case Undefined:
+        case MinKey:
+        case MaxKey:
+        case Array:
+        case EOO:
+            return false;
+        default:
+            return !operand.isNumber() || !std::isnan(operand.numberDouble());
+    }
+}
+
+}  // namespace
+
+RecordIdZoneMap::RecordIdZoneMap(std::vector<std::string> fields,
+                                 int64_t recordsPerZone,
+                                 const RecordId& firstSummarizedId)
+    : _fields(std::move(fields)),
+      _recordsPerZone(recordsPerZone),
+      _firstSummarizedId(firstSummarizedId.repr()) {
+    invariant(_recordsPerZone > 0);
+    invariant(firstSummarizedId.isNormal());
+}
+
+void RecordIdZoneMap::noteRecord(const RecordId& id, const BSONObj& obj) {
+    if (id.repr() < _firstSummarizedId) {
+        return;
+    }
+
+    std::vector<BSONElement> values;
+    values.reserve(_fields.size());
+    for (auto&& field : _fields) {
+        values.push_back(obj.getField(field));
+    }
+
+    const size_t zoneIndex = (id.repr() - _firstSummarizedId) / _recordsPerZone;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (zoneIndex >= _zones.size()) {
+        _zones.resize(zoneIndex + 1, Zone(_fields.size()));
+    }
+
+    Zone& zone = _zones[zoneIndex];
+    for (size_t i = 0; i < values.size(); ++i) {
+        const BSONElement& value = values[i];
+        FieldSummary& summary = zone[i];
+        if (value.eoo() || summary.hasArray) {
+            continue;
+        }
+
+        if (value.type() == Array) {
+            summary.hasArray = true;
+            summary.min = BSONObj();
+            summary.max = BSONObj();
+            continue;
+        }
+
+        if (summary.min.isEmpty() || value.woCompare(summary.min.firstElement(), false) < 0) {
+            summary.min = value.wrap("");
+        }
+        if (summary.max.isEmpty() || value.woCompare(summary.max.firstElement(), false) > 0) {
+            summary.max = value.wrap("");
+        }
+    }
+}
+
+void RecordIdZoneMap::nextCandidateRange(const RecordId& id,
+                                         const std::vector<ZoneMapPredicate>& predicates,
+                                         RecordId* start,
+                                         RecordId* end) const {
+    *start = id;
+    *end = RecordId::max();
+
+    if (id.repr() < _firstSummarizedId) {
+        *end = RecordId(_firstSummarizedId);
+        return;
+    }
+
+    const size_t firstZone = (id.repr() - _firstSummarizedId) / _recordsPerZone;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    size_t zoneIndex = firstZone;
+    while (zoneIndex < _zones.size() && _canSkip(_zones[zoneIndex], predicates)) {
+        ++zoneIndex;
+    }
+    if (zoneIndex > firstZone) {
+        *start = _zoneStart(zoneIndex);
+    }
+
+    // Zones past the end of '_zones' have not been written to yet, so they cannot be skipped.
+    while (zoneIndex < _zones.size() && !_canSkip(_zones[zoneIndex], predicates)) {
+        ++zoneIndex;
+    }
+    if (zoneIndex < _zones.size()) {
+        *end = _zoneStart(zoneIndex);
+    }
+}
+
+bool RecordIdZoneMap::_canSkip(const Zone& zone,
+                               const std::vector<ZoneMapPredicate>& predicates) const {
+    for (auto&& predicate : predicates) {
+        const BSONElement operand = predicate.value.firstElement();
+        if (!canUseOperand(operand)) {
+            continue;
+        }
+
+        auto fieldIt = std::find(_fields.begin(), _fields.end(), predicate.field);
+        if (fieldIt == _fields.end()) {
+            continue;
+        }
+
+        const FieldSummary& summary = zone[fieldIt - _fields.begin()];
+        if (summary.hasArray) {
+            continue;
+        }
+        if (summary.min.isEmpty()) {
+            // No record in the zone has the field, so none can match a comparison with a value.
+            return true;
+        }
+
+        const int minCmp = summary.min.firstElement().woCompare(operand, false);
+        const int maxCmp = summary.max.firstElement().woCompare(operand, false);
+        switch (predicate.op) {
+            case ZoneMapPredicate::Op::kLT:
+                if (minCmp >= 0)
+                    return true;
+                break;
+            case ZoneMapPredicate::Op::kLTE:
+                if (minCmp > 0)
+                    return true;
+                break;
+            case ZoneMapPredicate::Op::kEQ:
+                if (minCmp > 0 || maxCmp < 0)
+                    return true;
+                break;
+            case ZoneMapPredicate::Op::kGTE:
+                if (maxCmp < 0)
+                    return true;
+                break;
+            case ZoneMapPredicate::Op::kGT:
+                if (maxCmp <= 0)
+                    return true;
+                break;
+        }
+    }
+    return false;
+}
+
+RecordId RecordIdZoneMap::_zoneStart(size_t zoneIndex) const {
+    return RecordId(_firstSummarizedId + static_cast<int64_t>(zoneIndex) * _recordsPerZone);
+}
+
+}  // namespace mongo
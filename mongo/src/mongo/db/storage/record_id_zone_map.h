@@ -0,0 +1,123 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+/**
+ * A comparison "field <op> value" on a top-level field, which a RecordIdZoneMap can use to rule
+ * out ranges of records. The operand is the first element of 'value'.
+ */
+struct ZoneMapPredicate {
+    enum class Op { kLT, kLTE, kEQ, kGTE, kGT };
+
+    std::string field;
+    Op op;
+    BSONObj value;
+};
+
+/**
+ * Tracks the smallest and largest value of a few top-level fields for each zone of
+ * 'recordsPerZone' consecutive RecordIds, so that a scan with a range predicate on one of those
+ * fields can skip zones which cannot hold a match. This works well for fields which grow with
+ * insertion order, such as timestamps.
+ *
+ * Values are compared in BSON canonical order. That order is coarser than the type bracketing of
+ * the query language, so a zone is only skipped when no value in it could match. Zones are never
+ * narrowed: values which were deleted or overwritten stay accounted for. An array value makes its
+ * field unusable for the zone, since a predicate on an array matches any of its elements.
+ *
+ * Records with a RecordId below 'firstSummarizedId' were written before the map existed and are
+ * never skipped.
+ *
+ * This class is thread-safe.
+ */
+class RecordIdZoneMap {
+    MONGO_DISALLOW_COPYING(RecordIdZoneMap);
+
+public:
+    RecordIdZoneMap(std::vector<std::string> fields,
+                    int64_t recordsPerZone,
+                    const RecordId& firstSummarizedId);
+
+    /**
+     * Accounts for 'obj' being written at 'id'. Writers must call this before their write
+     * commits, so that a reader which can see the write also sees its effect on the map.
+     */
+    void noteRecord(const RecordId& id, const BSONObj& obj);
+
+    /**
+     * Finds the first range of RecordIds at or after 'id' which may hold a record matching all
+     * of 'predicates', and returns it as ['*start', '*end'). Predicates on fields which are not
+     * summarized are ignored. If the range is unbounded, '*end' is RecordId::max().
+     */
+    void nextCandidateRange(const RecordId& id,
+                            const std::vector<ZoneMapPredicate>& predicates,
+                            RecordId* start,
+                            RecordId* end) const;
+
+private:
+    struct FieldSummary {
+        // Empty until the field has been seen in the zone. Otherwise each holds one element.
+        BSONObj min;
+        BSONObj max;
+
+        // Set once an array has been seen for the field in the zone.
+        bool hasArray = false;
+    };
+
+    using Zone = std::vector<FieldSummary>;
+
+    /**
+     * Returns true if no record in 'zone' can match all of 'predicates'.
+     */
+    bool _canSkip(const Zone& zone, const std::vector<ZoneMapPredicate>& predicates) const;
+
+    RecordId _zoneStart(size_t zoneIndex) const;
+
+    const std::vector<std::string> _fields;
+    const int64_t _recordsPerZone;
+    const int64_t _firstSummarizedId;
+
+    mutable stdx::mutex _mutex;
+
+    // Zone i covers the RecordIds in [_zoneStart(i), _zoneStart(i + 1)).
+    std::deque<Zone> _zones;
+};
+
+}  // namespace mongo
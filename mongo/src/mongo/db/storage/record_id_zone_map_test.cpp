@@ -0,0 +1,126 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/record_id_zone_map.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+ZoneMapPredicate makePredicate(ZoneMapPredicate::Op op, const BSONObj& value) {
+    return {"ts", op, value};
+}
+
+/**
+ * Returns the start of the first range at or after 'id' which may match 'predicates'.
+ */
+RecordId candidateStart(const RecordIdZoneMap& map,
+                        int64_t id,
+                        const std::vector<ZoneMapPredicate>& predicates,
+                        RecordId* end = nullptr) {
+    RecordId start;
+    RecordId ignored;
+    map.nextCandidateRange(RecordId(id), predicates, &start, end ? end : &ignored);
+    return start;
+}
+
+TEST(RecordIdZoneMapTest, SkipsZonesOutsideOfRange) {
+    // Zones of 10 records, where record i has ts: i.
+    RecordIdZoneMap map({"ts"}, 10, RecordId(1));
+    for (int64_t i = 1; i <= 100; ++i) {
+        map.noteRecord(RecordId(i), BSON("_id" << i << "ts" << i));
+    }
+
+    RecordId end;
+    std::vector<ZoneMapPredicate> gte = {makePredicate(ZoneMapPredicate::Op::kGTE, BSON("" << 55))};
+    ASSERT_EQ(RecordId(51), candidateStart(map, 1, gte, &end));
+    ASSERT_EQ(RecordId::max(), end);
+
+    std::vector<ZoneMapPredicate> lt = {makePredicate(ZoneMapPredicate::Op::kLT, BSON("" << 25))};
+    ASSERT_EQ(RecordId(1), candidateStart(map, 1, lt, &end));
+    ASSERT_EQ(RecordId(31), end);
+    ASSERT_EQ(RecordId(101), candidateStart(map, 31, lt, &end));
+    ASSERT_EQ(RecordId::max(), end);
+
+    std::vector<ZoneMapPredicate> eq = {makePredicate(ZoneMapPredicate::Op::kEQ, BSON("" << 73))};
+    ASSERT_EQ(RecordId(71), candidateStart(map, 1, eq, &end));
+    ASSERT_EQ(RecordId(81), end);
+}
+
+TEST(RecordIdZoneMapTest, DoesNotSkipZonesWhichMayMatch) {
+    RecordIdZoneMap map({"ts"}, 10, RecordId(1));
+    for (int64_t i = 1; i <= 30; ++i) {
+        map.noteRecord(RecordId(i), BSON("ts" << i));
+    }
+    // An array in the second zone, and a value outside of the first zone's original range.
+    map.noteRecord(RecordId(15), BSON("ts" << BSON_ARRAY(1 << 2)));
+    map.noteRecord(RecordId(5), BSON("ts" << 1000));
+
+    std::vector<ZoneMapPredicate> gt = {makePredicate(ZoneMapPredicate::Op::kGT, BSON("" << 500))};
+    ASSERT_EQ(RecordId(1), candidateStart(map, 1, gt));
+    ASSERT_EQ(RecordId(11), candidateStart(map, 11, gt));
+    ASSERT_EQ(RecordId(31), candidateStart(map, 21, gt));
+}
+
+TEST(RecordIdZoneMapTest, IgnoresUnusablePredicatesAndOlderRecords) {
+    RecordIdZoneMap map({"ts"}, 10, RecordId(11));
+    for (int64_t i = 11; i <= 40; ++i) {
+        map.noteRecord(RecordId(i), BSON("ts" << i));
+    }
+
+    // Records below the first summarized id are never skipped.
+    std::vector<ZoneMapPredicate> gt = {makePredicate(ZoneMapPredicate::Op::kGT, BSON("" << 35))};
+    RecordId end;
+    ASSERT_EQ(RecordId(1), candidateStart(map, 1, gt, &end));
+    ASSERT_EQ(RecordId(11), end);
+    ASSERT_EQ(RecordId(31), candidateStart(map, 11, gt));
+
+    // Null may match missing fields, and other fields are not summarized.
+    std::vector<ZoneMapPredicate> lteNull = {
+        makePredicate(ZoneMapPredicate::Op::kLTE, BSON("" << BSONNULL))};
+    ASSERT_EQ(RecordId(11), candidateStart(map, 11, lteNull));
+    std::vector<ZoneMapPredicate> other = {{"other", ZoneMapPredicate::Op::kEQ, BSON("" << 1)}};
+    ASSERT_EQ(RecordId(11), candidateStart(map, 11, other));
+}
+
+TEST(RecordIdZoneMapTest, SkipsZonesWithoutTheField) {
+    RecordIdZoneMap map({"ts"}, 10, RecordId(1));
+    for (int64_t i = 1; i <= 20; ++i) {
+        map.noteRecord(RecordId(i), i <= 10 ? BSON("x" << i) : BSON("ts" << i));
+    }
+
+    std::vector<ZoneMapPredicate> gt = {makePredicate(ZoneMapPredicate::Op::kGT, BSON("" << 0))};
+    ASSERT_EQ(RecordId(11), candidateStart(map, 1, gt));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/record_data.h"
 #include "mongo/db/storage/record_fetcher.h"
+#include "mongo/db/storage/record_id_zone_map.h"
 
 namespace mongo {
 
@@ -230,6 +231,14 @@ public:
      */
     virtual void invalidate(OperationContext* opCtx, const RecordId& id) {}
 
+    /**
+     * Allows the cursor to skip ranges of records which the storage engine knows cannot satisfy
+     * every one of 'predicates'. Non-matching records may still be returned, so callers must keep
+     * applying their own filter. Must be called before the first call to next(). The default
+     * implementation ignores the predicates.
+     */
+    virtual void setSkipPredicates(const std::vector<ZoneMapPredicate>& predicates) {}
+
     //
     // RecordFetchers
     //
@@ -271,6 +280,22 @@ public:
      */
     virtual boost::optional<Record> seekExact(const RecordId& id) = 0;
 
+    /**
+     * Looks up each of 'ids' and appends an owned copy of every Record found to 'out', in the
+     * order looked up. Ids without a matching Record are skipped. Callers should pass 'ids' in
+     * ascending order so that consecutive seeks can take advantage of locality in the storage
+     * engine.
+     *
+     * The resulting position of the cursor is unspecified.
+     */
+    virtual void seekExactBatch(const std::vector<RecordId>& ids, std::vector<Record>* out) {
+        for (auto&& id : ids) {
+            if (auto record = seekExact(id)) {
+                out->push_back({id, record->data.getOwned()});
+            }
+        }
+    }
+
     /**
      * Prepares for state changes in underlying data without necessarily saving the current
      * state.
@@ -535,6 +560,18 @@ public:
         return out;
     }
 
+    /**
+     * Returns at most 'numCursors' RecordCursors that partition the RecordStore into disjoint sets
+     * of similar sizes, so that the store can be scanned by several threads in parallel. Iterating
+     * all returned RecordCursors is equivalent to iterating the full store.
+     *
+     * Defaults to getManyCursors(), whose partitioning is fixed by the storage layout.
+     */
+    virtual std::vector<std::unique_ptr<RecordCursor>> getPartitionedCursors(
+        OperationContext* opCtx, size_t numCursors) const {
+        return getManyCursors(opCtx);
+    }
+
     // higher level
 
 
@@ -628,6 +665,18 @@ public:
                       "this storage engine does not support touch");
     }
 
+    /**
+     * Asks the storage engine to keep this record store in its cache once read, rather than
+     * evicting it to make room for other data, or to stop doing so.
+     *
+     * If the underlying storage engine does not support the operation,
+     * returns ErrorCodes::CommandNotSupported
+     */
+    virtual Status setCacheResident(OperationContext* opCtx, bool resident) {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "this storage engine does not support cacheResident");
+    }
+
     /**
      * Return the RecordId of an oplog entry as close to startingPosition as possible without
      * being higher. If there are no entries <= startingPosition, return RecordId().
@@ -652,6 +701,16 @@ public:
         return Status::OK();
     }
 
+    /**
+     * Returns true if this is an oplog whose storage engine wakes capped waiters itself each time
+     * it makes new entries visible. Inserts into such an oplog do not need to wake them on commit:
+     * waiters would find nothing new until the next visibility update, which wakes them once for
+     * every write committed since the previous one.
+     */
+    virtual bool notifiesCappedWaitersOnVisibility() const {
+        return false;
+    }
+
     /**
      * Waits for all writes that completed before this call to be visible to forward scans.
      * See the comment on RecordCursor for more details about the visibility rules.
@@ -113,5 +113,50 @@ TEST(RecordStoreTestHarness, GetManyIteratorsNonEmpty) {
     }
 }
 
+// Partition a nonempty record store for a parallel scan.
+TEST(RecordStoreTestHarness, GetPartitionedIteratorsNonEmpty) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    const int nToInsert = 10 * 1000;
+    set<RecordId> remain;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < nToInsert; i++) {
+            stringstream ss;
+            ss << "record " << i;
+            string data = ss.str();
+
+            StatusWith<RecordId> res =
+                rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, Timestamp(), false);
+            ASSERT_OK(res.getStatus());
+            remain.insert(res.getValue());
+        }
+        uow.commit();
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        auto cursors = rs->getPartitionedCursors(opCtx.get(), 4);
+        ASSERT_GTE(cursors.size(), 1U);
+        ASSERT_LTE(cursors.size(), 4U);
+
+        // Interleave the cursors, as a parallel scan would.
+        while (!cursors.empty()) {
+            for (auto it = cursors.begin(); it != cursors.end();) {
+                if (auto record = (*it)->next()) {
+                    ASSERT_EQ(remain.erase(record->id), size_t(1));
+                    ++it;
+                } else {
+                    ASSERT(!(*it)->next());
+                    it = cursors.erase(it);
+                }
+            }
+        }
+        ASSERT(remain.empty());
+    }
+}
+
 }  // namespace
 }  // namespace mongo
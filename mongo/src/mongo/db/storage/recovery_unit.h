@@ -137,6 +137,29 @@ public:
         return {};
     }
 
+    /**
+     * Informs this RecoveryUnit that all future reads through it should be from the snapshot set
+     * by SnapshotManager::setLocalSnapshot(), i.e. from the last oplog batch a secondary applied
+     * in its entirety. This allows reads to proceed without conflicting with batch application.
+     * Newer local snapshots should be used whenever implementations would normally change
+     * snapshots.
+     *
+     * If there is currently no local snapshot, returns a status with error code
+     * NotYetInitialized. StorageEngines that don't support a SnapshotManager should use the
+     * default implementation.
+     */
+    virtual Status setReadFromLocalSnapshot() {
+        return {ErrorCodes::CommandNotSupported,
+                "Current storage engine does not support reading from the local snapshot"};
+    }
+
+    /**
+     * Returns true if setReadFromLocalSnapshot() has been called.
+     */
+    virtual bool isReadingFromLocalSnapshot() const {
+        return false;
+    }
+
     /**
      * Gets the local SnapshotId.
      *
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <limits>
 #include <string>
 
@@ -85,6 +86,18 @@ public:
      */
     virtual void dropAllSnapshots() = 0;
 
+    /**
+     * Sets the snapshot used for reads on a secondary that do not conflict with batch
+     * application, or clears it when passed boost::none. On a secondary this is the timestamp of
+     * the last oplog batch applied in its entirety, so reads at it never see a partial batch.
+     */
+    virtual void setLocalSnapshot(const boost::optional<Timestamp>& timestamp) = 0;
+
+    /**
+     * Returns the snapshot set by setLocalSnapshot(), or boost::none if there is none.
+     */
+    virtual boost::optional<Timestamp> getLocalSnapshot() = 0;
+
 protected:
     /**
      * SnapshotManagers are not intended to be deleted through pointers to base type.
@@ -41,6 +41,7 @@ namespace mongo {
 
 class BSONObjBuilder;
 class BucketDeletionNotification;
+struct CompactOptions;
 class SortedDataBuilderInterface;
 struct ValidateResults;
 
@@ -127,9 +128,9 @@ public:
 
     /**
      * Attempt to reduce the storage space used by this index via compaction. Only called if the
-     * indexed record store supports compaction-in-place.
+     * indexed record store supports compaction-in-place. 'options' may be NULL.
      */
-    virtual Status compact(OperationContext* opCtx) {
+    virtual Status compact(OperationContext* opCtx, const CompactOptions* options) {
         return Status::OK();
     }
 
@@ -176,6 +177,28 @@ public:
                       "this storage engine does not support touch");
     }
 
+    /**
+     * Asks the storage engine to keep this index in its cache once read, rather than evicting it
+     * to make room for other data, or to stop doing so.
+     *
+     * If the underlying storage engine does not support the operation,
+     * returns ErrorCodes::CommandNotSupported
+     */
+    virtual Status setCacheResident(OperationContext* opCtx, bool resident) {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "this storage engine does not support cacheResident");
+    }
+
+    /**
+     * Return the number of bytes of 'this' index currently held in the storage engine's cache.
+     *
+     * If the underlying storage engine cannot tell, returns ErrorCodes::CommandNotSupported
+     */
+    virtual StatusWith<long long> getCacheUsageBytes(OperationContext* opCtx) const {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "this storage engine does not report per-index cache usage");
+    }
+
     /**
      * Return the number of entries in 'this' index.
      *
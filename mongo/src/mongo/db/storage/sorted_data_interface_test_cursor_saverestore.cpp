@@ -586,5 +586,49 @@ TEST(SortedDataInterface, SaveUnpositionedAndRestore) {
     ASSERT_EQ(cursor->seek(key3, true), IndexKeyEntry(key3, loc1));
 }
 
+// Ensure that a cursor saved and restored several times without being advanced in between, as
+// happens to idle cursors across repeated yields, still resumes from its original position.
+void testSaveAndRestoreRepeatedlyWithoutAdvancing(bool forward, bool unique) {
+    const auto harnessHelper = newSortedDataInterfaceHarnessHelper();
+    auto opCtx = harnessHelper->newOperationContext();
+    auto sorted = harnessHelper->newSortedDataInterface(unique,
+                                                        {
+                                                            {key1, loc1}, {key4, loc1},
+                                                        });
+
+    auto cursor = sorted->newCursor(opCtx.get(), forward);
+    const auto seekPoint = forward ? key1 : key4;
+
+    ASSERT_EQ(cursor->seek(seekPoint, true), IndexKeyEntry(seekPoint, loc1));
+
+    cursor->save();
+    insertToIndex(opCtx, sorted, {{forward ? key3 : key2, loc1}});
+    cursor->restore();
+
+    cursor->save();
+    insertToIndex(opCtx, sorted, {{forward ? key2 : key3, loc1}});
+    cursor->restore();
+
+    ASSERT_EQ(cursor->next(), IndexKeyEntry(forward ? key2 : key3, loc1));
+    ASSERT_EQ(cursor->next(), IndexKeyEntry(forward ? key3 : key2, loc1));
+
+    // A seek after a restore replaces the saved position.
+    cursor->save();
+    cursor->restore();
+    ASSERT_EQ(cursor->seek(seekPoint, true), IndexKeyEntry(seekPoint, loc1));
+}
+TEST(SortedDataInterface, SaveAndRestoreRepeatedlyWithoutAdvancing_Forward_Unique) {
+    testSaveAndRestoreRepeatedlyWithoutAdvancing(true, true);
+}
+TEST(SortedDataInterface, SaveAndRestoreRepeatedlyWithoutAdvancing_Forward_Standard) {
+    testSaveAndRestoreRepeatedlyWithoutAdvancing(true, false);
+}
+TEST(SortedDataInterface, SaveAndRestoreRepeatedlyWithoutAdvancing_Reverse_Unique) {
+    testSaveAndRestoreRepeatedlyWithoutAdvancing(false, true);
+}
+TEST(SortedDataInterface, SaveAndRestoreRepeatedlyWithoutAdvancing_Reverse_Standard) {
+    testSaveAndRestoreRepeatedlyWithoutAdvancing(false, false);
+}
+
 }  // namespace
 }  // namespace mongo
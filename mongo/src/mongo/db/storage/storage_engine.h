@@ -30,10 +30,12 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <string>
 #include <vector>
 
 #include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/timestamp.h"
 #include "mongo/util/mongoutils/str.h"
@@ -211,6 +213,17 @@ public:
         return false;
     }
 
+    /**
+     * Returns a number that changes whenever collections are created, dropped or renamed or their
+     * options or indexes change, as well as when the units of work making such changes commit or
+     * roll back. Lets callers tell whether a view of the catalog they built is still current.
+     *
+     * Returns boost::none if the storage engine doesn't keep track of catalog changes.
+     */
+    virtual boost::optional<uint64_t> getCatalogVersion() const {
+        return boost::none;
+    }
+
     /**
      * Closes all file handles associated with a database.
      */
@@ -261,6 +274,27 @@ public:
         return;
     }
 
+    /**
+     * Opens a backup of the storage engine's on-disk files which, unlike beginBackup(), does not
+     * stop writes. The files named in the returned list, relative to the dbpath, hold a
+     * consistent copy of the data as of the most recent checkpoint and stay unchanged on disk
+     * until endNonBlockingBackup() is called, so they can be copied by a filesystem level tool
+     * while the server continues to accept writes.
+     *
+     * Only one backup, blocking or not, can be open at a time.
+     */
+    virtual StatusWith<std::vector<std::string>> beginNonBlockingBackup(OperationContext* opCtx) {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "The current storage engine doesn't support non-blocking backup");
+    }
+
+    /**
+     * Closes the backup opened by beginNonBlockingBackup().
+     */
+    virtual void endNonBlockingBackup(OperationContext* opCtx) {
+        return;
+    }
+
     /**
      * Recover as much data as possible from a potentially corrupt RecordStore.
      * This only recovers the record data, not indexes or anything else.
@@ -50,6 +50,8 @@ const char* StorageGlobalParams::kDefaultConfigDbPath = "/data/configdb";
 
 const int StorageGlobalParams::kMaxJournalCommitIntervalMs = 500;
 const double StorageGlobalParams::kMaxSyncdelaySecs = 9.0 * 1000.0 * 1000.0;
+const int StorageGlobalParams::kMinSorterSpillBlockBytes = 4 * 1024;
+const int StorageGlobalParams::kMaxSorterSpillBlockBytes = 16 * 1024 * 1024;
 
 /**
  * Specify whether all queries must use indexes.
@@ -111,4 +113,66 @@ public:
         return Status::OK();
     }
 } journalCommitIntervalSetting;
+
+/**
+ * Uncompressed size of the blocks external sorts write to their spill files. Larger blocks mean
+ * fewer, larger reads during the merge phase at the cost of more buffered memory per file.
+ */
+class SorterSpillBlockBytesSetting
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    SorterSpillBlockBytesSetting()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "sorterSpillBlockBytes",
+              &storageGlobalParams.sorterSpillBlockBytes) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < StorageGlobalParams::kMinSorterSpillBlockBytes ||
+            potentialNewValue > StorageGlobalParams::kMaxSorterSpillBlockBytes) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "sorterSpillBlockBytes must be between "
+                                        << StorageGlobalParams::kMinSorterSpillBlockBytes
+                                        << " and "
+                                        << StorageGlobalParams::kMaxSorterSpillBlockBytes
+                                        << ", but attempted to set to: "
+                                        << potentialNewValue);
+        }
+
+        return Status::OK();
+    }
+} sorterSpillBlockBytesSetting;
+
+/**
+ * Compressor applied to the blocks external sorts spill to disk: "snappy" or "none".
+ */
+class SorterSpillCompressorSetting
+    : public ExportedServerParameter<std::string, ServerParameterType::kStartupOnly> {
+public:
+    SorterSpillCompressorSetting()
+        : ExportedServerParameter<std::string, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(),
+              "sorterSpillCompressor",
+              &storageGlobalParams.sorterSpillCompressor) {}
+
+    virtual Status validate(const std::string& potentialNewValue) {
+        if (potentialNewValue != "snappy" && potentialNewValue != "none") {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "sorterSpillCompressor must be 'snappy' or 'none', "
+                                        << "but attempted to set to: "
+                                        << potentialNewValue);
+        }
+
+        return Status::OK();
+    }
+} sorterSpillCompressorSetting;
+
+/**
+ * Whether the merge phase of external sorts reads the next block of every spill file in the
+ * background while the current one is being consumed.
+ */
+ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime> SorterSpillReadAheadSetting(
+    ServerParameterSet::getGlobal(),
+    "sorterSpillReadAhead",
+    &storageGlobalParams.sorterSpillReadAhead);
 }  // namespace mongo
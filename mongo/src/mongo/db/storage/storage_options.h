@@ -121,6 +121,14 @@ struct StorageGlobalParams {
     // an existing underlying MongoDB database level resource if possible. This can improve
     // workloads that rely heavily on creating many collections within a database.
     bool groupCollections = false;
+
+    // External sorts: uncompressed size of the blocks spilled to disk, the compressor applied to
+    // them ("snappy" or "none"), and whether merges read the next block of each file ahead.
+    static const int kMinSorterSpillBlockBytes;
+    static const int kMaxSorterSpillBlockBytes;
+    AtomicInt32 sorterSpillBlockBytes{64 * 1024};
+    std::string sorterSpillCompressor = "snappy";
+    AtomicBool sorterSpillReadAhead{true};
 };
 
 extern StorageGlobalParams storageGlobalParams;
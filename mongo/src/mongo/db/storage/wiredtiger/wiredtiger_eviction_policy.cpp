@@ -0,0 +1,122 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_eviction_policy.h"
+
+#include <algorithm>
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+// The most eviction threads WiredTiger runs.
+const int kMaxEvictionThreads = 20;
+
+}  // namespace
+
+WiredTigerEvictionSettings WiredTigerEvictionSettings::fromOpenConfig(StringData config) {
+    WiredTigerEvictionSettings settings;
+    WiredTigerConfigParser parser(config);
+    auto getInt = [&parser](const char* key, int* value) {
+        WT_CONFIG_ITEM item;
+        if (parser.get(key, &item) == 0 && item.type == WT_CONFIG_ITEM::WT_CONFIG_ITEM_NUM) {
+            *value = static_cast<int>(item.val);
+        }
+    };
+    getInt("eviction.threads_min", &settings.threadsMin);
+    getInt("eviction.threads_max", &settings.threadsMax);
+    getInt("eviction_dirty_target", &settings.dirtyTarget);
+    getInt("eviction_dirty_trigger", &settings.dirtyTrigger);
+    return settings;
+}
+
+std::string WiredTigerEvictionSettings::toReconfigureString() const {
+    return str::stream() << "eviction=(threads_min=" << threadsMin << ",threads_max=" << threadsMax
+                         << "),eviction_dirty_target=" << dirtyTarget
+                         << ",eviction_dirty_trigger=" << dirtyTrigger;
+}
+
+WiredTigerEvictionSettings WiredTigerEvictionPolicy::next(const WiredTigerEvictionSettings& current,
+                                                          const Options& options,
+                                                          const Observation& observation) {
+    if (!options.enabled) {
+        _pressureTarget = _openSettings.dirtyTarget;
+        return _openSettings;
+    }
+
+    const int minThreads = _openSettings.threadsMax;
+    const int maxThreads = std::max(minThreads, std::min(kMaxEvictionThreads, options.maxThreads));
+    const bool stalled = observation.appEvictMicrosPerSec > options.appStallMicrosPerSec ||
+        observation.dirtyPercent > _openSettings.dirtyTrigger * 0.8;
+
+    int threads = std::max(minThreads, std::min(maxThreads, current.threadsMax));
+    if (stalled) {
+        threads = std::min(maxThreads, threads + 2);
+        _pressureTarget = std::max(1, _pressureTarget - 1);
+    } else if (observation.dirtyPercent < _pressureTarget) {
+        threads = std::max(minThreads, threads - 1);
+        _pressureTarget = std::min(_openSettings.dirtyTarget, _pressureTarget + 1);
+    }
+
+    WiredTigerEvictionSettings target = _openSettings;
+    if (threads > _openSettings.threadsMax) {
+        // Keep all of the added threads running while eviction is behind.
+        target.threadsMin = threads;
+        target.threadsMax = threads;
+    }
+    target.dirtyTarget =
+        std::min(_pressureTarget, checkpointDirtyTarget(options, observation.sinceLastCheckpoint));
+    return target;
+}
+
+int WiredTigerEvictionPolicy::checkpointDirtyTarget(const Options& options,
+                                                    Milliseconds sinceLastCheckpoint) const {
+    const int baseTarget = _openSettings.dirtyTarget;
+    const long long intervalMillis = durationCount<Milliseconds>(options.checkpointInterval);
+    const long long spreadMillis =
+        intervalMillis * std::min(options.checkpointSpreadPercent, 100) / 100;
+    if (spreadMillis <= 0) {
+        return baseTarget;
+    }
+
+    const long long untilCheckpoint =
+        intervalMillis - durationCount<Milliseconds>(sinceLastCheckpoint);
+    if (untilCheckpoint >= spreadMillis) {
+        return baseTarget;
+    }
+
+    const int floor = std::max(1, std::min(baseTarget, options.checkpointDirtyTargetPercent));
+    const long long remaining = std::max(0LL, untilCheckpoint);
+    return floor + (baseTarget - floor) * remaining / spreadMillis;
+}
+
+}  // namespace mongo
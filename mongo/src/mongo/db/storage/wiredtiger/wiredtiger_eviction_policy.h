@@ -0,0 +1,127 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <string>
+
+#include "mongo/base/string_data.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * The cache eviction settings of a WiredTiger connection that the eviction tuner adjusts.
+ */
+struct WiredTigerEvictionSettings {
+    /**
+     * Returns the settings a wiredtiger_open configuration string results in: the last value it
+     * gives each of them, or the WiredTiger default for those it does not set.
+     */
+    static WiredTigerEvictionSettings fromOpenConfig(StringData config);
+
+    /**
+     * Returns the WT_CONNECTION::reconfigure string that applies these settings.
+     */
+    std::string toReconfigureString() const;
+
+    bool operator==(const WiredTigerEvictionSettings& other) const {
+        return threadsMin == other.threadsMin && threadsMax == other.threadsMax &&
+            dirtyTarget == other.dirtyTarget && dirtyTrigger == other.dirtyTrigger;
+    }
+
+    bool operator!=(const WiredTigerEvictionSettings& other) const {
+        return !(*this == other);
+    }
+
+    int threadsMin = 1;
+    int threadsMax = 8;
+    int dirtyTarget = 5;
+    int dirtyTrigger = 20;
+};
+
+/**
+ * Chooses the eviction settings of each interval of the eviction tuner, starting from those the
+ * connection was opened with. When application threads had to evict pages themselves, or dirty
+ * data is close to the trigger at which they are made to, two eviction threads are added and the
+ * dirty target is lowered so that background eviction starts earlier; once eviction keeps up,
+ * threads are removed one at a time and the target goes back up. Checkpoints write out all dirty
+ * data at once, so the dirty target is also lowered gradually in the run-up to each checkpoint,
+ * making eviction write that data over a longer period instead.
+ *
+ * The open-time settings bound the tuning: the thread count never goes below their maximum, and
+ * the dirty target and trigger never above theirs.
+ */
+class WiredTigerEvictionPolicy {
+public:
+    struct Options {
+        bool enabled = false;
+        int maxThreads = 8;
+        int appStallMicrosPerSec = 1000;
+        // Zero or less does not spread checkpoint writes.
+        int checkpointSpreadPercent = 0;
+        int checkpointDirtyTargetPercent = 1;
+        Milliseconds checkpointInterval{0};
+    };
+
+    struct Observation {
+        double appEvictMicrosPerSec = 0;
+        double dirtyPercent = 0;
+        Milliseconds sinceLastCheckpoint{0};
+    };
+
+    explicit WiredTigerEvictionPolicy(const WiredTigerEvictionSettings& openSettings)
+        : _openSettings(openSettings), _pressureTarget(openSettings.dirtyTarget) {}
+
+    const WiredTigerEvictionSettings& openSettings() const {
+        return _openSettings;
+    }
+
+    /**
+     * Returns the settings to apply after an interval that ran with 'current' and ended with
+     * 'observation'. Returns the open-time settings when the tuner is disabled.
+     */
+    WiredTigerEvictionSettings next(const WiredTigerEvictionSettings& current,
+                                    const Options& options,
+                                    const Observation& observation);
+
+    /**
+     * Returns the dirty target to use for spreading the writes of the next checkpoint: the
+     * open-time target until the run-up to the checkpoint, then lower in proportion to how close
+     * it is.
+     */
+    int checkpointDirtyTarget(const Options& options, Milliseconds sinceLastCheckpoint) const;
+
+private:
+    const WiredTigerEvictionSettings _openSettings;
+
+    // Dirty target chosen from cache pressure alone.
+    int _pressureTarget;
+};
+
+}  // namespace mongo
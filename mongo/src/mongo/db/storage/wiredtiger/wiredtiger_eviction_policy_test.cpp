@@ -0,0 +1,217 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_eviction_policy.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+WiredTigerEvictionSettings makeSettings(int threadsMin,
+                                        int threadsMax,
+                                        int dirtyTarget,
+                                        int dirtyTrigger) {
+    WiredTigerEvictionSettings settings;
+    settings.threadsMin = threadsMin;
+    settings.threadsMax = threadsMax;
+    settings.dirtyTarget = dirtyTarget;
+    settings.dirtyTrigger = dirtyTrigger;
+    return settings;
+}
+
+WiredTigerEvictionPolicy::Options enabledOptions() {
+    WiredTigerEvictionPolicy::Options options;
+    options.enabled = true;
+    options.maxThreads = 8;
+    options.appStallMicrosPerSec = 1000;
+    return options;
+}
+
+WiredTigerEvictionPolicy::Observation stalled() {
+    WiredTigerEvictionPolicy::Observation observation;
+    observation.appEvictMicrosPerSec = 5000;
+    return observation;
+}
+
+WiredTigerEvictionPolicy::Observation idle() {
+    return WiredTigerEvictionPolicy::Observation();
+}
+
+TEST(WiredTigerEvictionSettingsTest, FromOpenConfigUsesTheLastValueOfEachSetting) {
+    auto settings = WiredTigerEvictionSettings::fromOpenConfig(
+        "create,cache_size=1024M,eviction=(threads_min=4,threads_max=4),statistics=(fast),"
+        "eviction_dirty_target=10,eviction=(threads_max=6),eviction_dirty_target=12");
+    ASSERT_EQ(4, settings.threadsMin);
+    ASSERT_EQ(6, settings.threadsMax);
+    ASSERT_EQ(12, settings.dirtyTarget);
+    ASSERT_EQ(20, settings.dirtyTrigger);
+}
+
+TEST(WiredTigerEvictionSettingsTest, FromOpenConfigDefaultsToTheWiredTigerDefaults) {
+    ASSERT(WiredTigerEvictionSettings() == WiredTigerEvictionSettings::fromOpenConfig("create"));
+}
+
+TEST(WiredTigerEvictionSettingsTest, ReconfigureStringAppliesEverySetting) {
+    auto settings = makeSettings(2, 7, 9, 33);
+    ASSERT_EQ("eviction=(threads_min=2,threads_max=7),eviction_dirty_target=9,"
+              "eviction_dirty_trigger=33",
+              settings.toReconfigureString());
+    ASSERT(settings ==
+           WiredTigerEvictionSettings::fromOpenConfig(settings.toReconfigureString()));
+}
+
+TEST(WiredTigerEvictionPolicyTest, DisablingRestoresTheOpenSettings) {
+    const auto open = makeSettings(2, 4, 10, 30);
+    WiredTigerEvictionPolicy policy(open);
+    auto options = enabledOptions();
+
+    auto current = open;
+    for (int i = 0; i < 3; ++i) {
+        current = policy.next(current, options, stalled());
+    }
+    ASSERT(current != open);
+
+    options.enabled = false;
+    ASSERT(open == policy.next(current, options, stalled()));
+
+    // The pressure target starts over from the open-time dirty target once re-enabled.
+    options.enabled = true;
+    ASSERT_EQ(open.dirtyTarget, policy.next(open, options, idle()).dirtyTarget);
+}
+
+TEST(WiredTigerEvictionPolicyTest, StallsAddThreadsAndLowerTheDirtyTarget) {
+    const auto open = makeSettings(2, 4, 5, 20);
+    WiredTigerEvictionPolicy policy(open);
+    const auto options = enabledOptions();
+
+    auto current = policy.next(open, options, stalled());
+    ASSERT(makeSettings(6, 6, 4, 20) == current);
+    current = policy.next(current, options, stalled());
+    ASSERT(makeSettings(8, 8, 3, 20) == current);
+    current = policy.next(current, options, stalled());
+    ASSERT(makeSettings(8, 8, 2, 20) == current);
+    current = policy.next(current, options, stalled());
+    current = policy.next(current, options, stalled());
+    ASSERT(makeSettings(8, 8, 1, 20) == current);
+}
+
+TEST(WiredTigerEvictionPolicyTest, DirtyDataNearTheOpenTriggerCountsAsAStall) {
+    auto observation = idle();
+    observation.dirtyPercent = 20;
+
+    WiredTigerEvictionPolicy lowTrigger(makeSettings(4, 4, 5, 20));
+    ASSERT_EQ(6,
+              lowTrigger.next(lowTrigger.openSettings(), enabledOptions(), observation).threadsMax);
+
+    WiredTigerEvictionPolicy highTrigger(makeSettings(4, 4, 5, 30));
+    ASSERT(highTrigger.openSettings() ==
+           highTrigger.next(highTrigger.openSettings(), enabledOptions(), observation));
+}
+
+TEST(WiredTigerEvictionPolicyTest, RecoveryRemovesThreadsOneAtATimeUntilTheOpenSettings) {
+    const auto open = makeSettings(2, 4, 5, 20);
+    WiredTigerEvictionPolicy policy(open);
+    const auto options = enabledOptions();
+
+    auto current = open;
+    for (int i = 0; i < 3; ++i) {
+        current = policy.next(current, options, stalled());
+    }
+    ASSERT(makeSettings(8, 8, 2, 20) == current);
+
+    current = policy.next(current, options, idle());
+    ASSERT(makeSettings(7, 7, 3, 20) == current);
+    current = policy.next(current, options, idle());
+    ASSERT(makeSettings(6, 6, 4, 20) == current);
+    current = policy.next(current, options, idle());
+    ASSERT(makeSettings(5, 5, 5, 20) == current);
+    current = policy.next(current, options, idle());
+    ASSERT(open == current);
+    ASSERT(open == policy.next(current, options, idle()));
+}
+
+TEST(WiredTigerEvictionPolicyTest, ThreadsStayBetweenTheOpenMaximumAndTheWiredTigerLimit) {
+    auto options = enabledOptions();
+
+    // A maximum below the open-time one leaves the threads alone.
+    WiredTigerEvictionPolicy manyThreads(makeSettings(10, 10, 5, 20));
+    options.maxThreads = 8;
+    ASSERT_EQ(10, manyThreads.next(manyThreads.openSettings(), options, stalled()).threadsMax);
+
+    WiredTigerEvictionPolicy policy(makeSettings(4, 4, 5, 20));
+    options.maxThreads = 50;
+    auto current = policy.openSettings();
+    for (int i = 0; i < 20; ++i) {
+        current = policy.next(current, options, stalled());
+    }
+    ASSERT_EQ(20, current.threadsMin);
+    ASSERT_EQ(20, current.threadsMax);
+}
+
+TEST(WiredTigerEvictionPolicyTest, CheckpointDirtyTargetDropsInTheRunUpToACheckpoint) {
+    WiredTigerEvictionPolicy policy(makeSettings(4, 4, 5, 20));
+    auto options = enabledOptions();
+    options.checkpointInterval = Seconds(60);
+    options.checkpointSpreadPercent = 50;
+    options.checkpointDirtyTargetPercent = 1;
+
+    ASSERT_EQ(5, policy.checkpointDirtyTarget(options, Seconds(0)));
+    ASSERT_EQ(5, policy.checkpointDirtyTarget(options, Seconds(30)));
+    ASSERT_EQ(3, policy.checkpointDirtyTarget(options, Seconds(45)));
+    ASSERT_EQ(1, policy.checkpointDirtyTarget(options, Seconds(60)));
+    ASSERT_EQ(1, policy.checkpointDirtyTarget(options, Seconds(90)));
+
+    // The floor cannot exceed the open-time dirty target.
+    options.checkpointDirtyTargetPercent = 10;
+    ASSERT_EQ(5, policy.checkpointDirtyTarget(options, Seconds(60)));
+
+    options.checkpointSpreadPercent = 0;
+    ASSERT_EQ(5, policy.checkpointDirtyTarget(options, Seconds(60)));
+}
+
+TEST(WiredTigerEvictionPolicyTest, NextUsesTheLowerOfThePressureAndCheckpointTargets) {
+    const auto open = makeSettings(4, 4, 5, 20);
+    WiredTigerEvictionPolicy policy(open);
+    auto options = enabledOptions();
+    options.checkpointInterval = Seconds(60);
+    options.checkpointSpreadPercent = 50;
+    options.checkpointDirtyTargetPercent = 1;
+
+    auto observation = idle();
+    observation.sinceLastCheckpoint = Seconds(45);
+    ASSERT(makeSettings(4, 4, 3, 20) == policy.next(open, options, observation));
+
+    observation.sinceLastCheckpoint = Seconds(10);
+    ASSERT(open == policy.next(open, options, observation));
+}
+
+}  // namespace
+}  // namespace mongo
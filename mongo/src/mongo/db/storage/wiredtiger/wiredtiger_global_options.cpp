@@ -109,7 +109,25 @@ Status WiredTigerGlobalOptions::add(moe::OptionSection* options) {
                            "WiredTiger custom index configuration settings")
         .hidden();
 
-    return options->addSection(wiredTigerOptions);
+    // InMemory storage engine options
+    moe::OptionSection inMemoryOptions("InMemory options");
+    inMemoryOptions.addOptionChaining("storage.inMemory.engineConfig.inMemorySizeGB",
+                                      "inMemorySizeGB",
+                                      moe::Double,
+                                      "maximum amount of memory to allocate for in-memory storage "
+                                      "engine data; defaults to 1/2 of physical RAM");
+    inMemoryOptions
+        .addOptionChaining("storage.inMemory.engineConfig.configString",
+                           "inMemoryEngineConfigString",
+                           moe::String,
+                           "InMemory storage engine custom configuration settings")
+        .hidden();
+
+    Status ret = options->addSection(wiredTigerOptions);
+    if (!ret.isOK()) {
+        return ret;
+    }
+    return options->addSection(inMemoryOptions);
 }
 
 /*
@@ -123,6 +141,9 @@ storage:
          blockCompressor: <string>
       indexConfig:
          prefixCompression: <boolean>
+   inMemory:
+      engineConfig:
+         inMemorySizeGB: <number>
 */
 //mongo.confļеwiredTiger:صϢ
 Status WiredTigerGlobalOptions::store(const moe::Environment& params,
@@ -176,6 +197,17 @@ Status WiredTigerGlobalOptions::store(const moe::Environment& params,
         log() << "Index custom option: " << wiredTigerGlobalOptions.indexConfig;
     }
 
+    // InMemory storage engine options
+    if (params.count("storage.inMemory.engineConfig.inMemorySizeGB")) {
+        wiredTigerGlobalOptions.inMemorySizeGB =
+            params["storage.inMemory.engineConfig.inMemorySizeGB"].as<double>();
+    }
+    if (params.count("storage.inMemory.engineConfig.configString")) {
+        wiredTigerGlobalOptions.inMemoryEngineConfig =
+            params["storage.inMemory.engineConfig.configString"].as<std::string>();
+        log() << "InMemory engine custom option: " << wiredTigerGlobalOptions.inMemoryEngineConfig;
+    }
+
     return Status::OK();
 }
 
@@ -41,6 +41,7 @@ class WiredTigerGlobalOptions {
 public:
     WiredTigerGlobalOptions()
         : cacheSizeGB(0),
+          inMemorySizeGB(0),
           checkpointDelaySecs(0),
           statisticsLogDelaySecs(0),
           directoryForIndexes(false),
@@ -63,6 +64,10 @@ public:
     bool useIndexPrefixCompression;
     std::string collectionConfig;
     std::string indexConfig;
+
+    // Options of the inMemory storage engine, which replace 'cacheSizeGB' and 'engineConfig'.
+    double inMemorySizeGB;
+    std::string inMemoryEngineConfig;
 };
 
 extern WiredTigerGlobalOptions wiredTigerGlobalOptions;
@@ -457,6 +457,21 @@ Status WiredTigerIndex::touch(OperationContext* opCtx) const {
     return Status(ErrorCodes::CommandNotSupported, "this storage engine does not support touch");
 }
 
+Status WiredTigerIndex::setCacheResident(OperationContext* opCtx, bool resident) {
+    if (WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->isEphemeral()) {
+        // Everything is already in memory.
+        return Status::OK();
+    }
+    return WiredTigerUtil::setCacheResident(opCtx, _uri, resident);
+}
+
+StatusWith<long long> WiredTigerIndex::getCacheUsageBytes(OperationContext* opCtx) const {
+    WiredTigerSession* session = WiredTigerRecoveryUnit::get(opCtx)->getSession();
+    return WiredTigerUtil::getStatisticsValueAs<long long>(session->getSession(),
+                                                           "statistics:" + uri(),
+                                                           "statistics=(fast)",
+                                                           WT_STAT_DSRC_CACHE_BYTES_INUSE);
+}
 
 long long WiredTigerIndex::getSpaceUsedBytes(OperationContext* opCtx) const {
     auto ru = WiredTigerRecoveryUnit::get(opCtx);
@@ -532,15 +547,8 @@ Status WiredTigerIndex::initAsEmpty(OperationContext* opCtx) {
     return Status::OK();
 }
 
-Status WiredTigerIndex::compact(OperationContext* opCtx) {
-    WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
-    if (!cache->isEphemeral()) {
-        WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
-        opCtx->recoveryUnit()->abandonSnapshot();
-        int ret = s->compact(s, uri().c_str(), "timeout=0");
-        invariantWTOK(ret);
-    }
-    return Status::OK();
+Status WiredTigerIndex::compact(OperationContext* opCtx, const CompactOptions* options) {
+    return WiredTigerUtil::compact(opCtx, uri(), options);
 }
 
 /**
@@ -770,6 +778,9 @@ public:
         if (_eof)
             return {};
 
+        if (_seekPendingAfterRestore)
+            seekToSavedPosition();
+
         if (!_lastMoveWasRestore)
             advanceWTCursor();
         updatePosition(true);
@@ -805,6 +816,7 @@ public:
         // By using a discriminator other than kInclusive, there is no need to distinguish
         // unique vs non-unique key formats since both start with the key.
         _query.resetToKey(finalKey, _idx.ordering(), discriminator);
+        _seekPendingAfterRestore = false;
         seekWTCursor(_query); //ݲѯkeyȡcursorλ
         updatePosition(); //ȡжӦkey-value
         return curr(parts); //key-valueתΪIndexKeyEntryṹ
@@ -819,6 +831,7 @@ public:
         const auto discriminator =
             _forward ? KeyString::kExclusiveBefore : KeyString::kExclusiveAfter;
         _query.resetToKey(key, _idx.ordering(), discriminator);
+        _seekPendingAfterRestore = false;
         seekWTCursor(_query);
         updatePosition();
         return curr(parts);
@@ -850,18 +863,11 @@ public:
         // Ensure an active session exists, so any restored cursors will bind to it
         invariant(WiredTigerRecoveryUnit::get(_opCtx)->getSession() == _cursor->getSession());
 
-        if (!_eof) {
-            // Unique indices *don't* include the record id in their KeyStrings. If we seek to the
-            // same key with a new record id, seeking will successfully find the key and will return
-            // true. This will cause us to skip the key with the new record id, since we set
-            // _lastMoveWasRestore to false.
-            //
-            // Standard (non-unique) indices *do* include the record id in their KeyStrings. This
-            // means that restoring to the same key with a new record id will return false, and we
-            // will *not* skip the key with the new record id.
-            _lastMoveWasRestore = !seekWTCursor(_key);
-            TRACE_CURSOR << "restore _lastMoveWasRestore:" << _lastMoveWasRestore;
-        }
+        // Repositioning is deferred until the cursor is next advanced. A yield saves and restores
+        // every cursor in the plan, but many of them (the losing side of a merge sort, or scans
+        // that are about to be re-seeked) are not advanced again before the next yield, so
+        // seeking them eagerly is wasted work.
+        _seekPendingAfterRestore = !_eof;
     }
 
     void detachFromOperationContext() final {
@@ -1068,6 +1074,23 @@ protected:
         updateIdAndTypeBits();
     }
 
+    /**
+     * Repositions the WT cursor at the saved key after a restore().
+     */
+    void seekToSavedPosition() {
+        // Unique indices *don't* include the record id in their KeyStrings. If we seek to the
+        // same key with a new record id, seeking will successfully find the key and will return
+        // true. This will cause us to skip the key with the new record id, since we set
+        // _lastMoveWasRestore to false.
+        //
+        // Standard (non-unique) indices *do* include the record id in their KeyStrings. This
+        // means that restoring to the same key with a new record id will return false, and we
+        // will *not* skip the key with the new record id.
+        _lastMoveWasRestore = !seekWTCursor(_key);
+        _seekPendingAfterRestore = false;
+        TRACE_CURSOR << "restore _lastMoveWasRestore:" << _lastMoveWasRestore;
+    }
+
     OperationContext* _opCtx;
 	//ʼֵӦuriļcursorWiredTigerIndexCursorBase캯
 	//WiredTigerIndexCursorBase::seek->WiredTigerIndexCursorBase::seekWTCursorпָҪkeycursorλ
@@ -1091,6 +1114,9 @@ protected:
     // false by any operation that moves the cursor, other than subsequent save/restore pairs.
     bool _lastMoveWasRestore = false;
 
+    // Set by restore() when the cursor must be repositioned at _key before it is next advanced.
+    bool _seekPendingAfterRestore = false;
+
     KeyString _query;
     KVPrefix _prefix;
 
@@ -1150,6 +1176,7 @@ public:
 
     boost::optional<IndexKeyEntry> seekExact(const BSONObj& key, RequestedInfo parts) override {
         _query.resetToKey(stripFieldNames(key), _idx.ordering());
+        _seekPendingAfterRestore = false;
         const WiredTigerItem keyItem(_query.getBuffer(), _query.getSize());
 
         WT_CURSOR* c = _cursor->get();
@@ -106,11 +106,15 @@ public:
 
     virtual Status touch(OperationContext* opCtx) const;
 
+    virtual Status setCacheResident(OperationContext* opCtx, bool resident);
+
+    virtual StatusWith<long long> getCacheUsageBytes(OperationContext* opCtx) const;
+
     virtual long long getSpaceUsedBytes(OperationContext* opCtx) const;
 
     virtual Status initAsEmpty(OperationContext* opCtx);
 
-    virtual Status compact(OperationContext* opCtx);
+    virtual Status compact(OperationContext* opCtx, const CompactOptions* options);
 
     const std::string& uri() const {
         return _uri;
@@ -59,12 +59,19 @@ namespace mongo {
 namespace {
 class WiredTigerFactory : public StorageEngine::Factory {
 public:
+    /**
+     * An 'ephemeral' factory creates an engine that keeps all data in the WiredTiger cache and
+     * never writes it to disk, for caching tiers that can rebuild their data after a restart.
+     */
+    WiredTigerFactory(StringData canonicalName, bool ephemeral)
+        : _canonicalName(canonicalName.toString()), _ephemeral(ephemeral) {}
+
     virtual ~WiredTigerFactory() {}
 	//ServiceContextMongoD::initializeGlobalStorageEngine()еִУִиWiredTigerFactory::create
 	//paramsKVStorageEngine  
     virtual StorageEngine* create(const StorageGlobalParams& params,
                                   const StorageEngineLockFile* lockFile) const {
-        if (lockFile && lockFile->createdByUncleanShutdown()) {
+        if (!_ephemeral && lockFile && lockFile->createdByUncleanShutdown()) {
             warning() << "Recovering data from the last clean checkpoint.";
         }
 
@@ -72,7 +79,7 @@ public:
 // This is from <linux/magic.h> but that isn't available on all systems.
 // Note that the magic number for ext4 is the same as ext2 and ext3.
 #define EXT4_SUPER_MAGIC 0xEF53
-        {
+        if (!_ephemeral) {
             struct statfs fs_stats;
 			//statfsӲʹ
             int ret = statfs(params.dbpath.c_str(), &fs_stats);
@@ -90,16 +97,19 @@ public:
         }
 #endif
 		//wiredTigerGlobalOptions.cacheSizeGB GBתΪMB
-        size_t cacheMB = WiredTigerUtil::getCacheSizeMB(wiredTigerGlobalOptions.cacheSizeGB);
-        const bool ephemeral = false;
+        // An in-memory engine's cache holds all of its data, so it is sized separately.
+        const double cacheSizeGB = _ephemeral ? wiredTigerGlobalOptions.inMemorySizeGB
+                                              : wiredTigerGlobalOptions.cacheSizeGB;
+        size_t cacheMB = WiredTigerUtil::getCacheSizeMB(cacheSizeGB);
         WiredTigerKVEngine* kv =
             new WiredTigerKVEngine(getCanonicalName().toString(),
                                    params.dbpath,
                                    getGlobalServiceContext()->getFastClockSource(),
-                                   wiredTigerGlobalOptions.engineConfig,
+                                   _ephemeral ? wiredTigerGlobalOptions.inMemoryEngineConfig
+                                              : wiredTigerGlobalOptions.engineConfig,
                                    cacheMB,
-                                   params.dur,
-                                   ephemeral,
+                                   params.dur && !_ephemeral,
+                                   _ephemeral,
                                    params.repair,
                                    params.readOnly);
         kv->setRecordStoreExtraOptions(wiredTigerGlobalOptions.collectionConfig);
@@ -118,7 +128,7 @@ public:
     }
 
     virtual StringData getCanonicalName() const {
-        return kWiredTigerEngineName;
+        return _canonicalName;
     }
 
 	//wiredtiger洢ò飬wiredtiger_config_validate   ͨcollectionsļӦwiredtiger
@@ -174,15 +184,22 @@ public:
     }
 
     bool supportsReadOnly() const final {
-        return true;
+        // There is nothing on disk for an in-memory engine to read.
+        return !_ephemeral;
     }
+
+private:
+    const std::string _canonicalName;
+    const bool _ephemeral;
 };
 }  // namespace
 
 MONGO_INITIALIZER_WITH_PREREQUISITES(WiredTigerEngineInit, ("SetGlobalEnvironment"))
 (InitializerContext* context) {
-    getGlobalServiceContext()->registerStorageEngine(kWiredTigerEngineName,
-                                                     new WiredTigerFactory());
+    getGlobalServiceContext()->registerStorageEngine(
+        kWiredTigerEngineName, new WiredTigerFactory(kWiredTigerEngineName, false));
+    getGlobalServiceContext()->registerStorageEngine(
+        kInMemoryEngineName, new WiredTigerFactory(kInMemoryEngineName, true));
 
     return Status::OK();
 }
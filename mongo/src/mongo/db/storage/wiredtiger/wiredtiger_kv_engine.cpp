@@ -63,6 +63,7 @@
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_eviction_policy.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_extensions.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
@@ -93,12 +94,19 @@ using std::string;
 
 namespace dps = ::mongo::dotted_path_support;
 
+// When enabled, the journal flusher writes changed collection sizes and counts to the size storer
+// table before each flush, so that after an unclean shutdown they are off by at most one journal
+// commit interval of writes rather than by everything since the last periodic sync.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerSizeStorerSyncWithJournal, bool, true);
+
 //WiredTigerKVEngine::WiredTigerKVEngineгʼ
 //WiredTigerKVEngine._journalFlusherԱΪ
 class WiredTigerKVEngine::WiredTigerJournalFlusher : public BackgroundJob {
 public:
-    explicit WiredTigerJournalFlusher(WiredTigerSessionCache* sessionCache)
-        : BackgroundJob(false /* deleteSelf */), _sessionCache(sessionCache) {}
+    WiredTigerJournalFlusher(WiredTigerSessionCache* sessionCache, WiredTigerSizeStorer* sizeStorer)
+        : BackgroundJob(false /* deleteSelf */),
+          _sessionCache(sessionCache),
+          _sizeStorer(sizeStorer) {}
 
     virtual string name() const {
         return "WTJournalFlusher";
@@ -110,6 +118,14 @@ public:
         LOG(1) << "starting " << name() << " thread";
 
         while (!_shuttingDown.load()) {
+            if (_sizeStorer && wiredTigerSizeStorerSyncWithJournal.load()) {
+                try {
+                    _sizeStorer->syncCache(false);
+                } catch (const WriteConflictException&) {
+                    // ignore, we'll try again on the next flush.
+                }
+            }
+
             try {
                 const bool forceCheckpoint = false;
                 const bool stableCheckpoint = false;
@@ -136,6 +152,7 @@ public:
 
 private:
     WiredTigerSessionCache* _sessionCache;
+    WiredTigerSizeStorer* _sizeStorer;  // not owned, can be NULL
     AtomicBool _shuttingDown{false};
 };
 
@@ -143,11 +160,14 @@ private:
 //WiredTigerKVEngine._checkpointThreadԱΪ
 class WiredTigerKVEngine::WiredTigerCheckpointThread : public BackgroundJob {
 public:
-    explicit WiredTigerCheckpointThread(WiredTigerSessionCache* sessionCache)
+    WiredTigerCheckpointThread(WiredTigerSessionCache* sessionCache,
+                               WiredTigerSizeStorer* sizeStorer)
         : BackgroundJob(false /* deleteSelf */),
           _sessionCache(sessionCache),
+          _sizeStorer(sizeStorer),
           _stableTimestamp(0),
-          _initialDataTimestamp(0) {}
+          _initialDataTimestamp(0),
+          _lastCheckpointMillis(Date_t::now().toMillisSinceEpoch()) {}
 
     virtual string name() const {
         return "WTCheckpointThread";
@@ -170,6 +190,17 @@ public:
             const Timestamp stableTimestamp(_stableTimestamp.load());
             const Timestamp initialDataTimestamp(_initialDataTimestamp.load());
             const bool keepOldBehavior = true;
+            _lastCheckpointMillis.store(Date_t::now().toMillisSinceEpoch());
+
+            // Write the current sizes first so that the checkpoint, which is what recovery starts
+            // from, carries counts that match its data.
+            if (_sizeStorer) {
+                try {
+                    _sizeStorer->syncCache(false);
+                } catch (const WriteConflictException&) {
+                    // ignore, the journal flusher or the next checkpoint will try again.
+                }
+            }
 
             try {
                 if (keepOldBehavior) {
@@ -249,6 +280,14 @@ public:
         _initialDataTimestamp.store(initialDataTimestamp.asULL());
     }
 
+    /**
+     * Returns when the most recent checkpoint was started, or when the thread was created if none
+     * has been yet.
+     */
+    Date_t lastCheckpointTime() const {
+        return Date_t::fromMillisSinceEpoch(_lastCheckpointMillis.load());
+    }
+
     void shutdown() {
         _shuttingDown.store(true);
         _condvar.notify_one();
@@ -257,6 +296,7 @@ public:
 
 private:
     WiredTigerSessionCache* _sessionCache;
+    WiredTigerSizeStorer* _sizeStorer;  // not owned, can be NULL
 
     // _mutex/_condvar used to notify when _shuttingDown is flipped.
     stdx::mutex _mutex;
@@ -266,6 +306,7 @@ private:
     AtomicWord<std::uint64_t> _stableTimestamp; 
 	//ǰsetInitialDataTimestamp
     AtomicWord<std::uint64_t> _initialDataTimestamp;
+    AtomicWord<long long> _lastCheckpointMillis;
 };
 
 namespace {
@@ -277,10 +318,12 @@ public:
     TicketServerParameter(TicketHolder* holder, const std::string& name)
 		//db.adminCommand( { setParameter : 1, "wiredTigerEngineRuntimeConfig" : "cache_size=2GB" })
 		//db.adminCommand( { getParameter : "1", wiredTigerEngineRuntimeConfig : 1  } )
-        : ServerParameter(ServerParameterSet::getGlobal(), name, true, true), _holder(holder) {}
+        : ServerParameter(ServerParameterSet::getGlobal(), name, true, true),
+          _holder(holder),
+          _configured(holder->outof()) {}
 
     virtual void append(OperationContext* opCtx, BSONObjBuilder& b, const std::string& name) {
-        b.append(name, _holder->outof());
+        b.append(name, configured());
     }
 
     virtual Status set(const BSONElement& newValueElement) {
@@ -303,11 +346,24 @@ public:
             return Status(ErrorCodes::BadValue, str::stream() << name() << " has to be > 0");
         }
 
-        return _holder->resize(newNum); //TicketHolder::resize
+        Status status = _holder->resize(newNum); //TicketHolder::resize
+        if (status.isOK()) {
+            _configured.store(newNum);
+        }
+        return status;
+    }
+
+    /**
+     * The ticket count set by the user. While adaptive concurrency is enabled the holder may have
+     * fewer tickets than this, but never more.
+     */
+    int configured() const {
+        return _configured.load();
     }
 
 private:
     TicketHolder* _holder; 
+    AtomicInt32 _configured;
 };
 
 //ЧWiredTigerKVEngine::WiredTigerKVEngine->Locker::setGlobalThrottling
@@ -321,11 +377,460 @@ TicketHolder openReadTransaction(128);
 TicketServerParameter openReadTransactionParam(&openReadTransaction,
                                                "wiredTigerConcurrentReadTransactions");
 
+// When enabled, the ticket tuner adjusts the number of read and write tickets between
+// wiredTigerAdaptiveConcurrencyMinTickets and the configured wiredTigerConcurrent*Transactions.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrencyEnabled, bool, false);
+// Values below 10ms and 5 tickets (the smallest pool TicketHolder allows) are raised to those.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrencyIntervalMillis, int, 1000);
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrencyMinTickets, int, 8);
+// Cache usage, as a percentage of the configured cache size, above which the tuner cuts tickets
+// regardless of throughput so that eviction can catch up.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrencyCachePressurePercent, int, 95);
+
+// When enabled, the eviction tuner adjusts the number of eviction threads and the dirty target of
+// the cache from observed cache pressure and application thread eviction, and brings the dirty
+// target down ahead of each checkpoint so that the checkpoint has less to write.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveEvictionEnabled, bool, false);
+// Values below 100ms are raised to that.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveEvictionIntervalMillis, int, 1000);
+// Upper bound on eviction threads, raised to the open-time maximum and capped at the WiredTiger
+// limit of 20.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveEvictionMaxThreads, int, 8);
+// Microseconds per second that application threads may spend evicting pages before the tuner adds
+// eviction threads and lowers the dirty target.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveEvictionAppStallMicrosPerSec, int, 1000);
+// Fraction of the checkpoint interval, in percent, before each checkpoint during which the dirty
+// target is lowered step by step to wiredTigerAdaptiveEvictionCheckpointDirtyTargetPercent. Zero
+// disables spreading checkpoint writes.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveEvictionCheckpointSpreadPercent, int, 50);
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveEvictionCheckpointDirtyTargetPercent, int, 1);
+
+// Tables whose file is at least this large are dropped without removing the file, which is then
+// shrunk in steps by the file reaper before being unlinked. Zero or less removes every file as
+// part of the drop.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerIncrementalDropThresholdMB, int, 1024);
+// Rate at which the file reaper releases the space of dropped tables. Values below 1 are raised.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerIncrementalDropMBPerSecond, int, 256);
+
+// Suffix given to the file of a table dropped incrementally until the file is gone, so that files
+// left behind by a shutdown are found again on startup.
+const char kDroppedFileSuffix[] = ".dropped";
+
+Counter64 incrementalDropsQueued;
+Counter64 incrementalDropsCompleted;
+Counter64 incrementalDropBytesReleased;
+ServerStatusMetricField<Counter64> displayIncrementalDropsQueued(
+    "storage.wiredTiger.incrementalDrop.filesQueued", &incrementalDropsQueued);
+ServerStatusMetricField<Counter64> displayIncrementalDropsCompleted(
+    "storage.wiredTiger.incrementalDrop.filesRemoved", &incrementalDropsCompleted);
+ServerStatusMetricField<Counter64> displayIncrementalDropBytesReleased(
+    "storage.wiredTiger.incrementalDrop.bytesReleased", &incrementalDropBytesReleased);
+
 stdx::function<bool(StringData)> initRsOplogBackgroundThreadCallback = [](StringData) -> bool {
     fassertFailed(40358);
 };
 }  // namespace
 
+/**
+ * Periodically resizes the read and write ticket pools with an additive-increase,
+ * multiplicative-decrease policy. While every ticket of a pool is in use, the pool grows by a
+ * few tickets as long as the rate of completed operations keeps up; when the rate drops after a
+ * resize or the cache is under pressure, the pool shrinks by a quarter. Pools that are not
+ * saturated are left alone.
+ */
+class WiredTigerKVEngine::WiredTigerTicketTuner : public BackgroundJob {
+public:
+    explicit WiredTigerTicketTuner(WiredTigerSessionCache* sessionCache)
+        : BackgroundJob(false /* deleteSelf */), _sessionCache(sessionCache) {}
+
+    virtual string name() const {
+        return "WTTicketTuner";
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+
+        LOG(1) << "starting " << name() << " thread";
+
+        Date_t lastRun = Date_t::now();
+        while (!_shuttingDown.load()) {
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait_for(lock,
+                                  Milliseconds(std::max(
+                                      10, wiredTigerAdaptiveConcurrencyIntervalMillis.load()))
+                                      .toSystemDuration());
+            }
+            if (_shuttingDown.load()) {
+                break;
+            }
+
+            const Date_t now = Date_t::now();
+            const double elapsedSecs =
+                std::max<long long>(1, durationCount<Milliseconds>(now - lastRun)) / 1000.0;
+            lastRun = now;
+
+            try {
+                const bool cachePressure = _isCacheUnderPressure();
+                _tune(&_write, &openWriteTransaction, openWriteTransactionParam, cachePressure,
+                      elapsedSecs);
+                _tune(&_read, &openReadTransaction, openReadTransactionParam, cachePressure,
+                      elapsedSecs);
+            } catch (const DBException& ex) {
+                warning() << "Failed to tune storage engine tickets: " << ex.toStatus();
+            }
+        }
+
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        _condvar.notify_one();
+        wait();
+    }
+
+private:
+    struct PoolState {
+        long long lastReleased = 0;
+        double lastThroughput = 0;
+    };
+
+    bool _isCacheUnderPressure() {
+        const int pressurePercent = wiredTigerAdaptiveConcurrencyCachePressurePercent.load();
+        if (pressurePercent <= 0 || pressurePercent >= 100) {
+            return false;
+        }
+
+        WiredTigerSession session(_sessionCache->conn());
+        WT_SESSION* s = session.getSession();
+        auto inUse = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+            s, "statistics:", "statistics=(fast)", WT_STAT_CONN_CACHE_BYTES_INUSE);
+        auto maxBytes = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+            s, "statistics:", "statistics=(fast)", WT_STAT_CONN_CACHE_BYTES_MAX);
+        if (!inUse.isOK() || !maxBytes.isOK() || maxBytes.getValue() <= 0) {
+            return false;
+        }
+        return inUse.getValue() * 100 > maxBytes.getValue() * pressurePercent;
+    }
+
+    static void _tune(PoolState* state,
+                      TicketHolder* holder,
+                      const TicketServerParameter& param,
+                      bool cachePressure,
+                      double elapsedSecs) {
+        const long long released = holder->numReleased();
+        const double throughput = (released - state->lastReleased) / elapsedSecs;
+        state->lastReleased = released;
+
+        const int ceiling = param.configured();
+        const int current = holder->outof();
+        int target = current;
+        if (!wiredTigerAdaptiveConcurrencyEnabled.load()) {
+            target = ceiling;
+        } else if (cachePressure) {
+            target = current - current / 4;
+        } else if (holder->available() == 0) {
+            if (throughput < state->lastThroughput * 0.9) {
+                target = current - current / 4;
+            } else {
+                target = current + std::max(1, current / 16);
+            }
+        }
+        state->lastThroughput = throughput;
+
+        const int floor =
+            std::min(ceiling, std::max(5, wiredTigerAdaptiveConcurrencyMinTickets.load()));
+        target = std::max(floor, std::min(ceiling, target));
+        if (target == current) {
+            return;
+        }
+
+        // Shrinking waits for in-flight operations to hand back the tickets being removed.
+        Status status = holder->resize(target);
+        if (!status.isOK()) {
+            LOG(1) << "Could not resize " << param.name() << " from " << current << " to "
+                   << target << ": " << status;
+            return;
+        }
+        LOG(2) << "Resized " << param.name() << " from " << current << " to " << target
+               << " (throughput " << throughput << "/s, cache pressure " << cachePressure << ")";
+    }
+
+    WiredTigerSessionCache* _sessionCache;
+
+    PoolState _read;
+    PoolState _write;
+
+    // _mutex/_condvar used to notify when _shuttingDown is flipped.
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    AtomicBool _shuttingDown{false};
+};
+
+/**
+ * Periodically reconfigures cache eviction with the settings WiredTigerEvictionPolicy chooses from
+ * the cache statistics of the last interval. Disabling the tuner restores the settings the engine
+ * was opened with, including those given through wiredTigerEngineConfigString.
+ */
+class WiredTigerKVEngine::WiredTigerEvictionTuner : public BackgroundJob {
+public:
+    WiredTigerEvictionTuner(WiredTigerSessionCache* sessionCache,
+                            const WiredTigerCheckpointThread* checkpointThread,
+                            const WiredTigerEvictionSettings& openSettings)
+        : BackgroundJob(false /* deleteSelf */),
+          _sessionCache(sessionCache),
+          _checkpointThread(checkpointThread),
+          _policy(openSettings),
+          _current(openSettings) {}
+
+    virtual string name() const {
+        return "WTEvictionTuner";
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+
+        LOG(1) << "starting " << name() << " thread";
+
+        Date_t lastRun = Date_t::now();
+        while (!_shuttingDown.load()) {
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait_for(
+                    lock,
+                    Milliseconds(std::max(100, wiredTigerAdaptiveEvictionIntervalMillis.load()))
+                        .toSystemDuration());
+            }
+            if (_shuttingDown.load()) {
+                break;
+            }
+
+            const Date_t now = Date_t::now();
+            const double elapsedSecs =
+                std::max<long long>(1, durationCount<Milliseconds>(now - lastRun)) / 1000.0;
+            lastRun = now;
+
+            try {
+                _tune(now, elapsedSecs);
+            } catch (const DBException& ex) {
+                warning() << "Failed to tune storage engine eviction: " << ex.toStatus();
+            }
+        }
+
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        _condvar.notify_one();
+        wait();
+    }
+
+private:
+    void _tune(Date_t now, double elapsedSecs) {
+        WiredTigerSession session(_sessionCache->conn());
+        WT_SESSION* s = session.getSession();
+        auto getStat = [s](int key) {
+            return WiredTigerUtil::getStatisticsValueAs<int64_t>(
+                s, "statistics:", "statistics=(fast)", key);
+        };
+        auto appEvictMicros = getStat(WT_STAT_CONN_APPLICATION_EVICT_TIME);
+        auto dirtyBytes = getStat(WT_STAT_CONN_CACHE_BYTES_DIRTY);
+        auto maxBytes = getStat(WT_STAT_CONN_CACHE_BYTES_MAX);
+        if (!appEvictMicros.isOK() || !dirtyBytes.isOK() || !maxBytes.isOK() ||
+            maxBytes.getValue() <= 0) {
+            return;
+        }
+        const double stallMicrosPerSec =
+            (appEvictMicros.getValue() - _lastAppEvictMicros) / elapsedSecs;
+        _lastAppEvictMicros = appEvictMicros.getValue();
+
+        WiredTigerEvictionPolicy::Options options;
+        options.enabled = wiredTigerAdaptiveEvictionEnabled.load();
+        options.maxThreads = wiredTigerAdaptiveEvictionMaxThreads.load();
+        options.appStallMicrosPerSec = wiredTigerAdaptiveEvictionAppStallMicrosPerSec.load();
+        if (_checkpointThread) {
+            options.checkpointSpreadPercent =
+                wiredTigerAdaptiveEvictionCheckpointSpreadPercent.load();
+            options.checkpointDirtyTargetPercent =
+                wiredTigerAdaptiveEvictionCheckpointDirtyTargetPercent.load();
+            options.checkpointInterval =
+                Seconds(static_cast<long long>(wiredTigerGlobalOptions.checkpointDelaySecs));
+        }
+
+        WiredTigerEvictionPolicy::Observation observation;
+        observation.appEvictMicrosPerSec = stallMicrosPerSec;
+        observation.dirtyPercent = dirtyBytes.getValue() * 100.0 / maxBytes.getValue();
+        if (_checkpointThread) {
+            observation.sinceLastCheckpoint = now - _checkpointThread->lastCheckpointTime();
+        }
+
+        const WiredTigerEvictionSettings target = _policy.next(_current, options, observation);
+        if (target == _current) {
+            return;
+        }
+
+        const std::string config = target.toReconfigureString();
+        WT_CONNECTION* conn = _sessionCache->conn();
+        int ret = conn->reconfigure(conn, config.c_str());
+        if (ret != 0) {
+            LOG(1) << "Could not reconfigure eviction with " << config << ": "
+                   << wtRCToStatus(ret);
+            return;
+        }
+        LOG(2) << "Reconfigured eviction with " << config << " (application eviction "
+               << stallMicrosPerSec << "us/s)";
+        _current = target;
+    }
+
+    WiredTigerSessionCache* _sessionCache;
+    const WiredTigerCheckpointThread* _checkpointThread;  // not owned, can be NULL
+
+    WiredTigerEvictionPolicy _policy;
+    WiredTigerEvictionSettings _current;
+    int64_t _lastAppEvictMicros = 0;
+
+    // _mutex/_condvar used to notify when _shuttingDown is flipped.
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    AtomicBool _shuttingDown{false};
+};
+
+/**
+ * Releases the disk space of large dropped tables. Unlinking a file of hundreds of gigabytes frees
+ * all of its extents in one filesystem transaction, which stalls other I/O on the volume for as
+ * long as that takes. Instead, the file is truncated from the end in chunks at a bounded rate and
+ * only unlinked once it is small.
+ */
+class WiredTigerKVEngine::WiredTigerFileReaper : public BackgroundJob {
+public:
+    WiredTigerFileReaper() : BackgroundJob(false /* deleteSelf */) {}
+
+    virtual string name() const {
+        return "WTFileReaper";
+    }
+
+    /**
+     * Queues the file at 'path', which WiredTiger no longer references, for removal.
+     */
+    void queue(const boost::filesystem::path& path) {
+        incrementalDropsQueued.increment();
+        {
+            stdx::lock_guard<stdx::mutex> lock(_mutex);
+            _files.push_back(path);
+        }
+        _condvar.notify_one();
+    }
+
+    /**
+     * Queues the files under 'dbpath' that a previous process was removing when it shut down.
+     */
+    void queueLeftoverFiles(const boost::filesystem::path& dbpath) {
+        boost::system::error_code ec;
+        for (boost::filesystem::recursive_directory_iterator it(dbpath, ec), end;
+             !ec && it != end;
+             it.increment(ec)) {
+            if (boost::filesystem::is_regular_file(it->status()) &&
+                StringData(it->path().filename().string()).endsWith(kDroppedFileSuffix)) {
+                log() << "resuming removal of dropped table file " << it->path().string();
+                queue(it->path());
+            }
+        }
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+
+        LOG(1) << "starting " << name() << " thread";
+
+        while (true) {
+            boost::filesystem::path path;
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait(lock, [&] { return _shuttingDown || !_files.empty(); });
+                if (_shuttingDown) {
+                    break;
+                }
+                path = std::move(_files.front());
+                _files.pop_front();
+            }
+            _remove(path);
+        }
+
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        {
+            stdx::lock_guard<stdx::mutex> lock(_mutex);
+            _shuttingDown = true;
+        }
+        _condvar.notify_one();
+        wait();
+    }
+
+private:
+    static const std::uintmax_t kChunkBytes = 64 * 1024 * 1024;
+
+    void _remove(const boost::filesystem::path& path) {
+        const Date_t start = Date_t::now();
+        boost::system::error_code ec;
+        std::uintmax_t size = boost::filesystem::file_size(path, ec);
+        if (ec) {
+            size = 0;
+        }
+        const std::uintmax_t originalSize = size;
+
+        while (!ec && size > kChunkBytes) {
+            const Date_t chunkStart = Date_t::now();
+            boost::filesystem::resize_file(path, size - kChunkBytes, ec);
+            if (ec) {
+                warning() << "failed to truncate dropped table file " << path.string() << ": "
+                          << ec.message() << "; removing it at once";
+                break;
+            }
+            size -= kChunkBytes;
+            incrementalDropBytesReleased.increment(kChunkBytes);
+
+            // Pace the chunks so that space is released no faster than the configured rate.
+            const Milliseconds chunkBudget(
+                static_cast<long long>(kChunkBytes / (1024 * 1024)) * 1000 /
+                std::max(1, wiredTigerIncrementalDropMBPerSecond.load()));
+            const Date_t nextChunk = chunkStart + chunkBudget;
+            stdx::unique_lock<stdx::mutex> lock(_mutex);
+            MONGO_IDLE_THREAD_BLOCK;
+            while (!_shuttingDown && Date_t::now() < nextChunk) {
+                _condvar.wait_for(lock, (nextChunk - Date_t::now()).toSystemDuration());
+            }
+            if (_shuttingDown) {
+                // The file keeps its suffix, so the next startup finishes removing it.
+                return;
+            }
+        }
+
+        boost::filesystem::remove(path, ec);
+        if (ec) {
+            warning() << "failed to remove dropped table file " << path.string() << ": "
+                      << ec.message();
+            return;
+        }
+        incrementalDropsCompleted.increment();
+        incrementalDropBytesReleased.increment(size);
+        LOG(1) << "removed dropped table file " << path.string() << " of " << originalSize
+               << " bytes in " << (Date_t::now() - start);
+    }
+
+    // _mutex/_condvar used to hand over files and to notify when _shuttingDown is flipped.
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    std::list<boost::filesystem::path> _files;
+    bool _shuttingDown = false;
+};
+
 /*
 wiredtiger:
 error_check(wiredtiger_open(home, NULL, CONN_CONFIG, &conn));
@@ -408,6 +913,11 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
               ->getTableCreateConfig("system");
     ss << WiredTigerExtensions::get(getGlobalServiceContext())->getOpenExtensionsConfig();
     ss << extraOpenOptions;
+    if (_ephemeral) {
+        // Keep every table in the cache and never write them to disk. The cache size then bounds
+        // the data size: writes that would exceed it fail with WT_CACHE_FULL.
+        ss << "in_memory=true,";
+    }
     if (_readOnly) {
         invariant(!_durable);
         ss << "readonly=true,";
@@ -415,8 +925,8 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     if (!_durable && !_readOnly) {
         // If we started without the journal, but previously used the journal then open with the
         // WT log enabled to perform any unclean shutdown recovery and then close and reopen in
-        // the normal path without the journal.
-        if (boost::filesystem::exists(journalPath)) {
+        // the normal path without the journal. An in-memory engine has nothing to recover.
+        if (!_ephemeral && boost::filesystem::exists(journalPath)) {
             string config = ss.str();
             log() << "Detected WT journal files.  Running recovery from last checkpoint.";
             log() << "journal to nojournal transition config: " << config;
@@ -462,16 +972,6 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
 	//_sessionCacheָµnew
     _sessionCache.reset(new WiredTigerSessionCache(this)); //_sessionCacheָ븳ֵ
 
-    if (_durable && !_ephemeral) {
-        _journalFlusher = stdx::make_unique<WiredTigerJournalFlusher>(_sessionCache.get());
-        _journalFlusher->go();
-    }
-
-    if (!_readOnly && !_ephemeral) {
-        _checkpointThread = stdx::make_unique<WiredTigerCheckpointThread>(_sessionCache.get());
-        _checkpointThread->go();
-    }
-
     _sizeStorerUri = "table:sizeStorer";
     WiredTigerSession session(_conn);
     if (!_readOnly && repair && _hasUri(session.getSession(), _sizeStorerUri)) {
@@ -484,6 +984,36 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
         new WiredTigerSizeStorer(_conn, _sizeStorerUri, sizeStorerLoggingEnabled, _readOnly));
     _sizeStorer->fillCache();
 
+    // The background threads below write the size storer, so it must exist before they start.
+    WiredTigerSizeStorer* const writableSizeStorer = _readOnly ? nullptr : _sizeStorer.get();
+
+    if (_durable && !_ephemeral) {
+        _journalFlusher =
+            stdx::make_unique<WiredTigerJournalFlusher>(_sessionCache.get(), writableSizeStorer);
+        _journalFlusher->go();
+    }
+
+    if (!_readOnly && !_ephemeral) {
+        _checkpointThread =
+            stdx::make_unique<WiredTigerCheckpointThread>(_sessionCache.get(), writableSizeStorer);
+        _checkpointThread->go();
+
+        _fileReaper = stdx::make_unique<WiredTigerFileReaper>();
+        _fileReaper->queueLeftoverFiles(_path);
+        _fileReaper->go();
+    }
+
+    _ticketTuner = stdx::make_unique<WiredTigerTicketTuner>(_sessionCache.get());
+    _ticketTuner->go();
+
+    if (!_readOnly && !_ephemeral) {
+        _evictionTuner = stdx::make_unique<WiredTigerEvictionTuner>(
+            _sessionCache.get(),
+            _checkpointThread.get(),
+            WiredTigerEvictionSettings::fromOpenConfig(_wtOpenConfig));
+        _evictionTuner->go();
+    }
+
 	//WiredTigerKVEngine::WiredTigerKVEngine->Locker::setGlobalThrottling
     Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
 }
@@ -543,6 +1073,12 @@ void WiredTigerKVEngine::cleanShutdown() {
             _journalFlusher->shutdown();
         if (_checkpointThread)
             _checkpointThread->shutdown();
+        if (_ticketTuner)
+            _ticketTuner->shutdown();
+        if (_evictionTuner)
+            _evictionTuner->shutdown();
+        if (_fileReaper)
+            _fileReaper->shutdown();
         _sizeStorer.reset();
         _sessionCache->shuttingDown();
 
@@ -724,6 +1260,51 @@ void WiredTigerKVEngine::endBackup(OperationContext* opCtx) {
     _backupSession.reset();
 }
 
+StatusWith<std::vector<std::string>> WiredTigerKVEngine::beginNonBlockingBackup(
+    OperationContext* opCtx) {
+    invariant(!_backupSession);
+
+    // The inMemory Storage Engine has no files to copy.
+    if (_ephemeral) {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "The in-memory storage engine doesn't support non-blocking backup");
+    }
+
+    // The backup cursor pins the files of the last checkpoint until it is closed, which happens
+    // when the uncached backupSession is closed in endNonBlockingBackup(). Checkpoints and writes
+    // carry on as usual in the meantime.
+    auto session = stdx::make_unique<WiredTigerSession>(_conn);
+    WT_CURSOR* c = NULL;
+    WT_SESSION* s = session->getSession();
+    int ret = WT_OP_CHECK(s->open_cursor(s, "backup:", NULL, NULL, &c));
+    if (ret != 0) {
+        return wtRCToStatus(ret);
+    }
+
+    std::vector<std::string> files;
+    while ((ret = c->next(c)) == 0) {
+        const char* filename;
+        ret = c->get_key(c, &filename);
+        if (ret != 0) {
+            return wtRCToStatus(ret);
+        }
+        // Log files live in the journal directory but are named relative to it.
+        const StringData name(filename);
+        files.emplace_back(name.startsWith("WiredTigerLog.") ? "journal/" + name.toString()
+                                                             : name.toString());
+    }
+    if (ret != WT_NOTFOUND) {
+        return wtRCToStatus(ret);
+    }
+
+    _backupSession = std::move(session);
+    return files;
+}
+
+void WiredTigerKVEngine::endNonBlockingBackup(OperationContext* opCtx) {
+    _backupSession.reset();
+}
+
 //οhttp://www.mongoing.com/archives/5476  ͬڴеsize
 //WiredTigerKVEngine::haveDropsQueued  WiredTigerKVEngine::flushAllFilesе
 void WiredTigerKVEngine::syncSizeInfo(bool sync) const {
@@ -1028,8 +1609,7 @@ Status WiredTigerKVEngine::dropIdent(OperationContext* opCtx, StringData ident)
 
     WiredTigerSession session(_conn);
 
-    int ret = session.getSession()->drop(
-        session.getSession(), uri.c_str(), "force,checkpoint_wait=false");
+    int ret = _dropTable(session.getSession(), uri);
     LOG(1) << "WT drop of  " << uri << " res " << ret;
 
     if (ret == 0) {
@@ -1122,8 +1702,7 @@ void WiredTigerKVEngine::dropSomeQueuedIdents() {
             uri = _identToDrop.front();
             _identToDrop.pop_front();
         }
-        int ret = session.getSession()->drop(
-            session.getSession(), uri.c_str(), "force,checkpoint_wait=false");
+        int ret = _dropTable(session.getSession(), uri);
         LOG(1) << "WT queued drop of  " << uri << " res " << ret;
 
         if (ret == EBUSY) {
@@ -1135,6 +1714,44 @@ void WiredTigerKVEngine::dropSomeQueuedIdents() {
     }
 }
 
+int WiredTigerKVEngine::_dropTable(WT_SESSION* session, const std::string& uri) {
+    const long long thresholdMB = wiredTigerIncrementalDropThresholdMB.load();
+    const StringData tablePrefix = "table:";
+    if (!_fileReaper || thresholdMB <= 0 || !StringData(uri).startsWith(tablePrefix)) {
+        return session->drop(session, uri.c_str(), "force,checkpoint_wait=false");
+    }
+
+    // Ident names may contain directories, which are relative to the dbpath like the files are.
+    const boost::filesystem::path file =
+        boost::filesystem::path(_path) / (uri.substr(tablePrefix.size()) + ".wt");
+    boost::system::error_code ec;
+    const std::uintmax_t size = boost::filesystem::file_size(file, ec);
+    if (ec || size < static_cast<std::uintmax_t>(thresholdMB) * 1024 * 1024) {
+        return session->drop(session, uri.c_str(), "force,checkpoint_wait=false");
+    }
+
+    // The drop is durable once it returns, so the file can be removed at leisure afterwards.
+    int ret = session->drop(session, uri.c_str(), "force,checkpoint_wait=false,remove_files=false");
+    if (ret != 0) {
+        return ret;
+    }
+
+    boost::filesystem::path dropped = file;
+    dropped += kDroppedFileSuffix;
+    boost::filesystem::rename(file, dropped, ec);
+    if (ec) {
+        warning() << "failed to rename the file of dropped table " << uri << ": " << ec.message()
+                  << "; removing it at once";
+        boost::filesystem::remove(file, ec);
+        return 0;
+    }
+
+    log() << "dropped " << uri << "; releasing its " << size / (1024 * 1024)
+          << "MB file in the background";
+    _fileReaper->queue(dropped);
+    return 0;
+}
+
 bool WiredTigerKVEngine::supportsDocLocking() const {
     return true;
 }
@@ -149,6 +149,10 @@ public:
 
     virtual void endBackup(OperationContext* opCtx);
 
+    virtual StatusWith<std::vector<std::string>> beginNonBlockingBackup(OperationContext* opCtx);
+
+    virtual void endNonBlockingBackup(OperationContext* opCtx);
+
     virtual int64_t getIdentSize(OperationContext* opCtx, StringData ident);
 
     virtual Status repairIdent(OperationContext* opCtx, StringData ident);
@@ -260,12 +264,21 @@ public:
 private:
     class WiredTigerJournalFlusher;
     class WiredTigerCheckpointThread;
+    class WiredTigerTicketTuner;
+    class WiredTigerEvictionTuner;
+    class WiredTigerFileReaper;
 
     Status _salvageIfNeeded(const char* uri);
     void _checkIdentPath(StringData ident);
 
     bool _hasUri(WT_SESSION* session, const std::string& uri) const;
 
+    /**
+     * Drops the table 'uri' and returns the WiredTiger error code. The files of large tables are
+     * kept by the drop and handed to the file reaper, which releases their space gradually.
+     */
+    int _dropTable(WT_SESSION* session, const std::string& uri);
+
     std::string _uri(StringData ident) const;
 
     Timestamp _previousSetOldestTimestamp;
@@ -304,6 +317,9 @@ private:
     
     std::unique_ptr<WiredTigerJournalFlusher> _journalFlusher;  // Depends on _sizeStorer
     std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;
+    std::unique_ptr<WiredTigerTicketTuner> _ticketTuner;
+    std::unique_ptr<WiredTigerEvictionTuner> _evictionTuner;
+    std::unique_ptr<WiredTigerFileReaper> _fileReaper;
 
     std::string _rsOptions;
     std::string _indexOptions;
@@ -33,12 +33,17 @@
 
 #include "mongo/db/storage/kv/kv_engine_test_harness.h"
 
+#include <boost/filesystem/operations.hpp>
+#include <fstream>
+
 #include "mongo/base/init.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -80,5 +85,23 @@ MONGO_INITIALIZER(RegisterKVHarnessFactory)(InitializerContext*) {
     return Status::OK();
 }
 
+TEST(WiredTigerKVEngineTest, RemovesLeftoverDroppedTableFilesOnStartup) {
+    unittest::TempDir dbpath("wt-kv-dropped-files");
+    const boost::filesystem::path leftover =
+        boost::filesystem::path(dbpath.path()) / "collection-0-1.wt.dropped";
+    {
+        std::ofstream out(leftover.string());
+        out << std::string(1024 * 1024, 'x');
+    }
+
+    ClockSourceMock cs;
+    WiredTigerKVEngine engine(
+        kWiredTigerEngineName, dbpath.path(), &cs, "", 1, false, false, false, false);
+    for (int i = 0; i < 100 && boost::filesystem::exists(leftover); ++i) {
+        sleepmillis(100);
+    }
+    ASSERT_FALSE(boost::filesystem::exists(leftover));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -33,6 +33,8 @@
 
 #include <cstring>
 
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/oplog_slot_tracker.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
@@ -151,6 +153,30 @@ void WiredTigerOplogManager::waitForAllEarlierOplogWritesToBeVisible(
 //WiredTigerKVEngine::replicationBatchIsCompleteеִ
 void WiredTigerOplogManager::triggerJournalFlush() {
     stdx::lock_guard<stdx::mutex> lk(_oplogVisibilityStateMutex);
+    _triggerJournalFlush(lk);
+}
+
+void WiredTigerOplogManager::beginTimestampedTransaction(Timestamp commitTimestamp) {
+    stdx::lock_guard<stdx::mutex> lk(_oplogVisibilityStateMutex);
+    _inFlightCommitTimestamps.insert(commitTimestamp);
+}
+
+void WiredTigerOplogManager::finishTimestampedTransaction(Timestamp commitTimestamp) {
+    stdx::lock_guard<stdx::mutex> lk(_oplogVisibilityStateMutex);
+    auto it = _inFlightCommitTimestamps.lower_bound(commitTimestamp);
+    invariant(it != _inFlightCommitTimestamps.end() && *it == commitTimestamp);
+
+    const bool wasOldestHole = (it == _inFlightCommitTimestamps.begin());
+    _inFlightCommitTimestamps.erase(it);
+    if (wasOldestHole) {
+        _triggerJournalFlush(lk);
+    } else {
+        LOG(3) << "not refreshing oplog visibility for " << commitTimestamp
+               << ", an older transaction is still in flight";
+    }
+}
+
+void WiredTigerOplogManager::_triggerJournalFlush(WithLock) {
     if (!_opsWaitingForJournal) {
         _opsWaitingForJournal = true;
         _opsWaitingForJournalCV.notify_one();
@@ -186,7 +212,25 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(WiredTigerSessionCache* ses
         _opsWaitingForJournal = false;
         lk.unlock();
 
-        const uint64_t newTimestamp = _fetchAllCommittedValue(sessionCache->conn());
+        // WiredTiger only knows about oplog holes once their transactions have a commit timestamp,
+        // so the slot tracker caps all_committed below timestamps that are reserved but not yet
+        // registered. Whatever it holds back is checked again on the next pass.
+        uint64_t allCommitted = 0;
+        const uint64_t newTimestamp =
+            OplogSlotTracker::get(getGlobalServiceContext())
+                ->capVisibility([&] {
+                    allCommitted = _fetchAllCommittedValue(sessionCache->conn());
+                    return Timestamp(allCommitted);
+                })
+                .asULL();
+        if (newTimestamp < allCommitted) {
+            lk.lock();
+            _triggerJournalFlush(lk);
+            lk.unlock();
+            if (newTimestamp <= _oplogReadTimestamp.load()) {
+                continue;
+            }
+        }
 
         if (newTimestamp == _oplogReadTimestamp.load()) {
             LOG(2) << "no new oplog entries were made visible: " << newTimestamp;
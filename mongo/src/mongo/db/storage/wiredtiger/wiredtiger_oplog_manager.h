@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <set>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
@@ -76,6 +78,19 @@ public:
     // Triggers the oplogJournal thread to update its oplog read timestamp, by flushing the journal.
     void triggerJournalFlush();
 
+    // Called when a transaction is first given a commit timestamp, and when that transaction
+    // commits or rolls back. In-flight timestamped transactions are the holes in the oplog, and
+    // the oplog read timestamp can only advance once the oldest of them finishes, so only that
+    // triggers the oplogJournal thread; finishing any other one cannot make new entries visible.
+    void beginTimestampedTransaction(Timestamp commitTimestamp);
+    void finishTimestampedTransaction(Timestamp commitTimestamp);
+
+    // Whether the oplogJournal thread has been triggered and has not yet picked the trigger up.
+    bool isJournalFlushPending_forTest() const {
+        stdx::lock_guard<stdx::mutex> lk(_oplogVisibilityStateMutex);
+        return _opsWaitingForJournal;
+    }
+
     // Waits until all committed writes at this point to become visible (that is, no holes exist in
     // the oplog.)
     void waitForAllEarlierOplogWritesToBeVisible(const WiredTigerRecordStore* oplogRecordStore,
@@ -88,6 +103,8 @@ private:
 
     void _setOplogReadTimestamp(WithLock, uint64_t newTimestamp);
 
+    void _triggerJournalFlush(WithLock);
+
     uint64_t _fetchAllCommittedValue(WT_CONNECTION* conn);
 
     stdx::thread _oplogJournalThread;
@@ -105,6 +122,10 @@ private:
     RecordId _oplogMaxAtStartup = RecordId(0);  // Guarded by oplogVisibilityStateMutex.
     bool _opsWaitingForJournal = false;         // Guarded by oplogVisibilityStateMutex.
 
+    // The first commit timestamps of the timestamped transactions which have not yet committed or
+    // rolled back. Guarded by oplogVisibilityStateMutex.
+    std::multiset<Timestamp> _inFlightCommitTimestamps;
+
     //οhttp://www.mongoing.com/archives/25302  ʱ߼ʱ
     AtomicUInt64 _oplogReadTimestamp;
 };
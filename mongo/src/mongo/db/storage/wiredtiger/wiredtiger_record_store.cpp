@@ -37,6 +37,7 @@
 
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/static_assert.h"
+#include "mongo/bson/timestamp.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -44,6 +45,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
@@ -62,6 +64,7 @@
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -82,12 +85,61 @@ void checkOplogFormatVersion(OperationContext* opCtx, const std::string& uri) {
 
     fassertNoTrace(39998, appMetadata.getValue().getIntField("oplogKeyExtractionVersion") == 1);
 }
+
+// Top-level fields to keep per-zone minimum and maximum values for in non-capped user collections,
+// so that collection scans with range predicates on them can skip zones. Empty disables the zone
+// maps.
+std::vector<std::string> wiredTigerZoneMapFields;
+ExportedServerParameter<std::vector<std::string>, ServerParameterType::kStartupOnly>
+    wiredTigerZoneMapFieldsSetting(ServerParameterSet::getGlobal(),
+                                   "wiredTigerZoneMapFields",
+                                   &wiredTigerZoneMapFields);
+
+// The number of consecutive RecordIds summarized by each zone of a zone map.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerZoneMapRecordsPerZone, int, 4096);
+
+// When true, record stores whose size and count are kept by the size storer are not opened until
+// the first insert needs a new RecordId, instead of each being read at startup.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerLazyRecordStoreInit, bool, false);
+
+// When non-zero, the oplog keeps entries for this many hours and reclaims anything older, rather
+// than keeping it to its configured size.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerOplogRetentionHours, int, 0);
+
+// The maximum number of oplog stones removed by a single truncate when reclaiming the oplog.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerOplogReclaimStonesPerTruncate, int, 1);
+
+// When non-zero, a pass of the oplog reclaim thread stops after this many milliseconds and
+// releases its locks, even if more stones still need to be reclaimed.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerOplogReclaimSliceMillis, int, 0);
+
+// When non-zero, the oplog reclaim thread truncates a single stone at a time and ends its pass
+// while dirty data is more than this percentage of the WiredTiger cache, as each truncate adds to
+// the dirty data that eviction must write out.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerOplogReclaimMaxDirtyCachePercent, int, 0);
+
+bool isCacheDirtyAboveReclaimThreshold(WT_SESSION* session) {
+    const int maxDirtyPercent = wiredTigerOplogReclaimMaxDirtyCachePercent.load();
+    if (maxDirtyPercent <= 0) {
+        return false;
+    }
+
+    auto dirtyBytes = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+        session, "statistics:", "statistics=(fast)", WT_STAT_CONN_CACHE_BYTES_DIRTY);
+    auto maxBytes = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+        session, "statistics:", "statistics=(fast)", WT_STAT_CONN_CACHE_BYTES_MAX);
+    if (!dirtyBytes.isOK() || !maxBytes.isOK() || maxBytes.getValue() <= 0) {
+        return false;
+    }
+    return dirtyBytes.getValue() * 100 > maxBytes.getValue() * maxDirtyPercent;
+}
 }  // namespace
 
 MONGO_FP_DECLARE(WTWriteConflictException);
 MONGO_FP_DECLARE(WTWriteConflictExceptionForReads);
 
 const std::string kWiredTigerEngineName = "wiredTiger";
+const std::string kInMemoryEngineName = "inMemory";
 
 class WiredTigerRecordStore::OplogStones::InsertChange final : public RecoveryUnit::Change {
 public:
@@ -153,6 +205,7 @@ WiredTigerRecordStore::OplogStones::OplogStones(OperationContext* opCtx, WiredTi
     size_t numStonesToKeep = std::min(kMaxStonesToKeep, std::max(kMinStonesToKeep, numStones));
     _minBytesPerStone = maxSize / numStonesToKeep;
     invariant(_minBytesPerStone > 0);
+    _retentionSecs.store(wiredTigerOplogRetentionHours * 3600LL);
 
     _calculateStones(opCtx, numStonesToKeep);
     _pokeReclaimThreadIfNeeded();  // Reclaim stones if over the limit.
@@ -182,7 +235,12 @@ void WiredTigerRecordStore::OplogStones::awaitHasExcessStonesOrDead() {
                 break;
             }
         }
-        _oplogReclaimCv.wait(lock);
+        if (_retentionSecs.load() > 0) {
+            // Stones become excess as time passes rather than as records are inserted.
+            _oplogReclaimCv.wait_for(lock, Seconds(1).toSystemDuration());
+        } else {
+            _oplogReclaimCv.wait(lock);
+        }
     }
 }
 
@@ -197,11 +255,66 @@ WiredTigerRecordStore::OplogStones::peekOldestStoneIfNeeded() const {
     return _stones.front();
 }
 
+boost::optional<WiredTigerRecordStore::OplogStones::Stone>
+WiredTigerRecordStore::OplogStones::peekOldestStonesIfNeeded(size_t maxStones,
+                                                             size_t* numStones) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    *numStones = _numExcessStones_inlock(maxStones);
+    if (*numStones == 0) {
+        return {};
+    }
+
+    OplogStones::Stone merged = {0, 0, _stones[*numStones - 1].lastRecord};
+    for (size_t i = 0; i < *numStones; ++i) {
+        merged.records += _stones[i].records;
+        merged.bytes += _stones[i].bytes;
+    }
+    return merged;
+}
+
 void WiredTigerRecordStore::OplogStones::popOldestStone() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     _stones.pop_front();
 }
 
+void WiredTigerRecordStore::OplogStones::popOldestStones(size_t numStones) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(numStones <= _stones.size());
+    _stones.erase(_stones.begin(), _stones.begin() + numStones);
+}
+
+size_t WiredTigerRecordStore::OplogStones::_numExcessStones_inlock(size_t maxStones) const {
+    size_t numStones = 0;
+
+    const int64_t retentionSecs = _retentionSecs.load();
+    if (retentionSecs > 0) {
+        // Oplog RecordIds are the optimes of their entries, so the seconds of a stone's last
+        // record is the wall clock time of the newest entry in it.
+        const long long oldestSecsToKeep = Date_t::now().toMillisSinceEpoch() / 1000 -
+            retentionSecs;
+        while (numStones < maxStones && numStones < _stones.size()) {
+            Timestamp newest(static_cast<unsigned long long>(_stones[numStones].lastRecord.repr()));
+            if (newest.getSecs() >= oldestSecsToKeep) {
+                break;
+            }
+            ++numStones;
+        }
+        return numStones;
+    }
+
+    int64_t totalBytes = 0;
+    for (auto&& stone : _stones) {
+        totalBytes += stone.bytes;
+    }
+    while (numStones < maxStones && numStones < _stones.size() &&
+           totalBytes > _rs->cappedMaxSize()) {
+        totalBytes -= _stones[numStones].bytes;
+        ++numStones;
+    }
+    return numStones;
+}
+
 void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(RecordId lastRecord) {
     stdx::unique_lock<stdx::mutex> lk(_mutex, stdx::try_to_lock);
     if (!lk) {
@@ -281,6 +394,11 @@ void WiredTigerRecordStore::OplogStones::setMinBytesPerStone(int64_t size) {
     _minBytesPerStone = size;
 }
 
+void WiredTigerRecordStore::OplogStones::setRetentionSeconds(int64_t secs) {
+    invariant(secs >= 0);
+    _retentionSecs.store(secs);
+}
+
 void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* opCtx,
                                                           size_t numStonesToKeep) {
     long long numRecords = _rs->numRecords(opCtx);
@@ -627,7 +745,6 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
       _shuttingDown(false),
       _cappedDeleteCheckCount(0),
       _sizeStorer(params.sizeStorer),
-      _sizeStorerCounter(0),
       _kvEngine(kvEngine) {
     Status versionStatus = WiredTigerUtil::checkApplicationMetadataFormatVersion(
                                ctx, _uri, kMinimumRecordStoreVersion, kMaximumRecordStoreVersion)
@@ -684,12 +801,26 @@ WiredTigerRecordStore::~WiredTigerRecordStore() {
 }
 
 void WiredTigerRecordStore::postConstructorInit(OperationContext* opCtx) {
+    const bool zoneMapped = !wiredTigerZoneMapFields.empty() &&
+        wiredTigerZoneMapRecordsPerZone > 0 && !_isCapped &&
+        !NamespaceString(ns()).isOnInternalDb();
+
+    // Opening every table at startup to find its largest RecordId costs a WiredTiger data handle
+    // per collection. Unless something below needs it now, take the size and count from the size
+    // storer and leave finding the largest RecordId to the first insert.
+    if (wiredTigerLazyRecordStoreInit && _sizeStorer && !_isCapped && !zoneMapped) {
+        long long numRecords;
+        long long dataSize;
+        _sizeStorer->loadFromCache(_uri, &numRecords, &dataSize);
+        _numRecords.store(numRecords);
+        _dataSize.store(dataSize);
+        _sizeStorer->onCreate(this, numRecords, dataSize);
+        return;
+    }
+
     // Find the largest RecordId currently in use and estimate the number of records.
     std::unique_ptr<SeekableRecordCursor> cursor = getCursor(opCtx, /*forward=*/false);
-    if (auto record = cursor->next()) {
-        int64_t max = record->id.repr();
-        _nextIdNum.store(1 + max);
-
+    if (auto record = _initNextIdNum(cursor.get())) {
         if (_sizeStorer) {
             long long numRecords;
             long long dataSize;
@@ -711,8 +842,6 @@ void WiredTigerRecordStore::postConstructorInit(OperationContext* opCtx) {
     } else {
         _dataSize.store(0);
         _numRecords.store(0);
-        // Need to start at 1 so we are always higher than RecordId::min()
-        _nextIdNum.store(1);
         if (_sizeStorer)
             _sizeStorer->onCreate(this, 0, 0);
     }
@@ -721,6 +850,12 @@ void WiredTigerRecordStore::postConstructorInit(OperationContext* opCtx) {
         _oplogStones = std::make_shared<OplogStones>(opCtx, this);
     }
 
+    // Records which already exist are not summarized, so the zone map starts with the next id.
+    if (zoneMapped) {
+        _zoneMap = stdx::make_unique<RecordIdZoneMap>(
+            wiredTigerZoneMapFields, wiredTigerZoneMapRecordsPerZone, RecordId(_nextIdNum.load()));
+    }
+
     if (_isOplog) {
         invariant(_kvEngine);
         _kvEngine->startOplogManager(opCtx, _uri, this);
@@ -1059,15 +1194,26 @@ bool WiredTigerRecordStore::yieldAndAwaitOplogDeletionRequest(OperationContext*
 }
 
 void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx) {
-    while (auto stone = _oplogStones->peekOldestStoneIfNeeded()) {
+    Timer timer;
+    while (true) {
+        WiredTigerRecoveryUnit* ru = WiredTigerRecoveryUnit::get(opCtx);
+        WT_SESSION* session = ru->getSession()->getSession();
+
+        const bool cacheDirty = isCacheDirtyAboveReclaimThreshold(session);
+        const size_t maxStones =
+            cacheDirty ? 1 : std::max(1, wiredTigerOplogReclaimStonesPerTruncate.load());
+
+        size_t numStones = 0;
+        auto stone = _oplogStones->peekOldestStonesIfNeeded(maxStones, &numStones);
+        if (!stone) {
+            break;
+        }
         invariant(stone->lastRecord.isNormal());
 
         LOG(1) << "Truncating the oplog between " << _oplogStones->firstRecord << " and "
                << stone->lastRecord << " to remove approximately " << stone->records
-               << " records totaling to " << stone->bytes << " bytes";
-
-        WiredTigerRecoveryUnit* ru = WiredTigerRecoveryUnit::get(opCtx);
-        WT_SESSION* session = ru->getSession()->getSession();
+               << " records totaling to " << stone->bytes << " bytes in " << numStones
+               << " stone(s)";
 
         try {
             WriteUnitOfWork wuow(opCtx);
@@ -1086,14 +1232,23 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx) {
 
             wuow.commit();
 
-            // Remove the stone after a successful truncation.
-            _oplogStones->popOldestStone();
+            // Remove the stones after a successful truncation.
+            _oplogStones->popOldestStones(numStones);
 
             // Stash the truncate point for next time to cleanly skip over tombstones, etc.
             _oplogStones->firstRecord = stone->lastRecord;
         } catch (const WriteConflictException&) {
             LOG(1) << "Caught WriteConflictException while truncating oplog entries, retrying";
         }
+
+        // Give up the locks between slices so that a long reclaim does not hold off other
+        // operations on the oplog; the reclaim thread comes back for the remaining stones.
+        const int sliceMillis = wiredTigerOplogReclaimSliceMillis.load();
+        if (cacheDirty || (sliceMillis > 0 && timer.millis() >= sliceMillis)) {
+            LOG(1) << "Pausing oplog reclaim after " << timer.millis() << "ms"
+                   << (cacheDirty ? " as the cache is dirty" : "");
+            break;
+        }
     }
 
     LOG(1) << "Finished truncating the oplog, it now contains approximately " << _numRecords.load()
@@ -1192,6 +1347,10 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
 	//ñһд뵽洢idкż¼ģ´ݽ
     RecordId highestId = RecordId();
     dassert(nRecords != 0);
+
+    // Non-oplog records are keyed by a counter; reserve the ids for the whole batch with a single
+    // atomic increment so that concurrent batches each occupy a contiguous key range.
+    const RecordId firstId = _isOplog ? RecordId() : _nextId(opCtx, nRecords);
 	//Ϊһ洢KVеid keyǸ
     for (size_t i = 0; i < nRecords; i++) { //ֻй̶ϲŻһԶĵοinsertBatchAndHandleErrors
         auto& record = records[i];
@@ -1202,10 +1361,10 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
                 return status.getStatus();
             record.id = status.getValue();
         } else if (_isCapped) { //̶
-            record.id = _nextId();
+            record.id = RecordId(firstId.repr() + i);
         } else {
         	//RecordId дʱõCollectionImpl::_insertDocuments
-            record.id = _nextId();
+            record.id = RecordId(firstId.repr() + i);
         }
         dassert(record.id > highestId);
         highestId = record.id;
@@ -1241,6 +1400,10 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
         int ret = WT_OP_CHECK(c->insert(c));
         if (ret)
             return wtRCToStatus(ret, "WiredTigerRecordStore::insertRecord");
+
+        if (_zoneMap) {
+            _zoneMap->noteRecord(record.id, record.data.toBson());
+        }
     }
 
 	//¼ñеݴС
@@ -1355,6 +1518,10 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* opCtx,
     ret = WT_OP_CHECK(c->insert(c));
     invariantWTOK(ret);
 
+    if (_zoneMap) {
+        _zoneMap->noteRecord(id, BSONObj(data));
+    }
+
     _increaseDataSize(opCtx, len - old_length);
     if (!_oplogStones) {
         cappedDeleteAsNeeded(opCtx, id);
@@ -1400,6 +1567,10 @@ StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
     WT_ITEM value;
     invariantWTOK(c->get_value(c, &value));
 
+    if (_zoneMap) {
+        _zoneMap->noteRecord(id, BSONObj(static_cast<const char*>(value.data)));
+    }
+
     return RecordData(static_cast<const char*>(value.data), value.size).getOwned();
 }
 
@@ -1416,6 +1587,66 @@ std::vector<std::unique_ptr<RecordCursor>> WiredTigerRecordStore::getManyCursors
     return cursors;
 }
 
+std::vector<std::unique_ptr<RecordCursor>> WiredTigerRecordStore::getPartitionedCursors(
+    OperationContext* opCtx, size_t numCursors) const {
+    // Oversample so that the ranges come out roughly even, but bound the number of random probes
+    // taken for very large requests.
+    const size_t kRandomSamplesPerCursor = 10;
+    const size_t kMaxRandomSamples = 10 * 1000;
+    const long long kMinRecordsPerCursor = 1000;
+
+    if (_isCapped || numCursors < 2) {
+        return getManyCursors(opCtx);
+    }
+
+    numCursors = std::min<size_t>(numCursors,
+                                  std::max(0LL, numRecords(opCtx)) / kMinRecordsPerCursor);
+    const size_t numSamples = std::min(numCursors * kRandomSamplesPerCursor, kMaxRandomSamples);
+    numCursors = std::min(numCursors, numSamples / kRandomSamplesPerCursor);
+    if (numCursors < 2) {
+        return getManyCursors(opCtx);
+    }
+
+    // Inform the random cursor of the number of samples we intend to take. This allows it to
+    // account for skew in the tree shape.
+    const std::string extraConfig = str::stream() << "next_random_sample_size=" << numSamples;
+    auto randomCursor = getRandomCursorWithOptions(opCtx, extraConfig);
+    if (!randomCursor) {
+        return getManyCursors(opCtx);
+    }
+
+    std::vector<RecordId> samples;
+    samples.reserve(numSamples);
+    for (size_t i = 0; i < numSamples; ++i) {
+        auto record = randomCursor->next();
+        if (!record) {
+            break;
+        }
+        samples.push_back(record->id);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    // Use every (kRandomSamplesPerCursor)th sample as the first record of the next range. Random
+    // cursors may return the same record more than once, so skip repeated boundaries.
+    std::vector<RecordId> boundaries;
+    for (size_t i = kRandomSamplesPerCursor; i < samples.size(); i += kRandomSamplesPerCursor) {
+        if (boundaries.empty() || boundaries.back() < samples[i]) {
+            boundaries.push_back(samples[i]);
+        }
+    }
+
+    std::vector<std::unique_ptr<RecordCursor>> cursors;
+    RecordId start;
+    for (size_t i = 0; i <= boundaries.size(); ++i) {
+        const RecordId end = i < boundaries.size() ? boundaries[i] : RecordId();
+        auto cursor = getCursor(opCtx, /*forward=*/true);
+        checked_cast<WiredTigerRecordStoreCursorBase*>(cursor.get())->restrictToRange(start, end);
+        cursors.push_back(std::move(cursor));
+        start = end;
+    }
+    return cursors;
+}
+
 Status WiredTigerRecordStore::truncate(OperationContext* opCtx) {
     WiredTigerCursor startWrap(_uri, _tableId, true, opCtx);
     WT_CURSOR* start = startWrap.get();
@@ -1442,14 +1673,7 @@ Status WiredTigerRecordStore::compact(OperationContext* opCtx,
                                       RecordStoreCompactAdaptor* adaptor,
                                       const CompactOptions* options,
                                       CompactStats* stats) {
-    WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
-    if (!cache->isEphemeral()) {
-        WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
-        opCtx->recoveryUnit()->abandonSnapshot();
-        int ret = s->compact(s, getURI().c_str(), "timeout=0");
-        invariantWTOK(ret);
-    }
-    return Status::OK();
+    return WiredTigerUtil::compact(opCtx, getURI(), options);
 }
 
 Status WiredTigerRecordStore::validate(OperationContext* opCtx,
@@ -1573,6 +1797,14 @@ Status WiredTigerRecordStore::touch(OperationContext* opCtx, BSONObjBuilder* out
     return Status(ErrorCodes::CommandNotSupported, "this storage engine does not support touch");
 }
 
+Status WiredTigerRecordStore::setCacheResident(OperationContext* opCtx, bool resident) {
+    if (_isEphemeral) {
+        // Everything is already in memory.
+        return Status::OK();
+    }
+    return WiredTigerUtil::setCacheResident(opCtx, _uri, resident);
+}
+
 void WiredTigerRecordStore::waitForAllEarlierOplogWritesToBeVisible(OperationContext* opCtx) const {
     // Make sure that callers do not hold an active snapshot so it will be able to see the oplog
     // entries it waited for afterwards.
@@ -1620,9 +1852,26 @@ void WiredTigerRecordStore::updateStatsAfterRepair(OperationContext* opCtx,
     }
 }
 
-RecordId WiredTigerRecordStore::_nextId() {
+boost::optional<Record> WiredTigerRecordStore::_initNextIdNum(
+    SeekableRecordCursor* reverseCursor) {
+    auto record = reverseCursor->next();
+
+    // Need to start at 1 so we are always higher than RecordId::min()
+    _nextIdNum.store(record ? 1 + record->id.repr() : 1);
+    return record;
+}
+
+RecordId WiredTigerRecordStore::_nextId(OperationContext* opCtx, size_t count) {
     invariant(!_isOplog);
-    RecordId out = RecordId(_nextIdNum.fetchAndAdd(1));
+    invariant(count > 0);
+    if (MONGO_unlikely(_nextIdNum.load() == 0)) {
+        // The record store was opened lazily; no RecordIds can have been handed out yet.
+        stdx::lock_guard<stdx::mutex> lk(_nextIdInitMutex);
+        if (_nextIdNum.load() == 0) {
+            _initNextIdNum(getCursor(opCtx, /*forward=*/false).get());
+        }
+    }
+    RecordId out = RecordId(_nextIdNum.fetchAndAdd(count));
     invariant(out.isNormal());
     return out;
 }
@@ -1671,10 +1920,6 @@ void WiredTigerRecordStore::_increaseDataSize(OperationContext* opCtx, int64_t a
 
     if (_dataSize.fetchAndAdd(amount) < 0)
         _dataSize.store(std::max(amount, int64_t(0)));
-
-    if (_sizeStorer && _sizeStorerCounter++ % 1000 == 0) {
-        _sizeStorer->storeToCache(_uri, _numRecords.load(), _dataSize.load());
-    }
 }
 
 void WiredTigerRecordStore::cappedTruncateAfter(OperationContext* opCtx,
@@ -1767,32 +2012,42 @@ WiredTigerRecordStoreCursorBase::WiredTigerRecordStoreCursorBase(OperationContex
 }
 
 boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
-    if (_eof)
-        return {};
-
-    WT_CURSOR* c = _cursor->get();
-
     RecordId id;
-    if (!_skipNextAdvance) {
-        // Nothing after the next line can throw WCEs.
-        // Note that an unpositioned (or eof) WT_CURSOR returns the first/last entry in the
-        // table when you call next/prev.
-        int advanceRet = WT_READ_CHECK(_forward ? c->next(c) : c->prev(c));
-        if (advanceRet == WT_NOTFOUND) {
-            _eof = true;
+    do {
+        if (_eof)
             return {};
+
+        WT_CURSOR* c = _cursor->get();
+
+        id = RecordId();
+        if (!_skipNextAdvance) {
+            // Nothing after the next line can throw WCEs.
+            // Note that an unpositioned (or eof) WT_CURSOR returns the first/last entry in the
+            // table when you call next/prev.
+            int advanceRet = WT_READ_CHECK(_forward ? c->next(c) : c->prev(c));
+            if (advanceRet == WT_NOTFOUND) {
+                _eof = true;
+                return {};
+            }
+            invariantWTOK(advanceRet);
+            if (hasWrongPrefix(c, &id)) {
+                _eof = true;
+                return {};
+            }
         }
-        invariantWTOK(advanceRet);
-        if (hasWrongPrefix(c, &id)) {
+
+        _skipNextAdvance = false;
+        if (!id.isNormal()) {
+            id = getKey(c);
+        }
+
+        if (!_rangeEnd.isNull() && id >= _rangeEnd) {
             _eof = true;
             return {};
         }
-    }
+    } while (!_skipPredicates.empty() && id >= _zoneMapRecheckId && skipToCandidateZone(id));
 
-    _skipNextAdvance = false;
-    if (!id.isNormal()) {
-        id = getKey(c);
-    }
+    WT_CURSOR* c = _cursor->get();
 
     if (_forward && _lastReturnedId >= id) {
         log() << "WTCursor::next -- c->next_key ( " << id
@@ -1832,6 +2087,35 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
+void WiredTigerRecordStoreCursorBase::seekExactBatch(const std::vector<RecordId>& ids,
+                                                     std::vector<Record>* out) {
+    _skipNextAdvance = false;
+    WT_CURSOR* c = _cursor->get();
+    out->reserve(out->size() + ids.size());
+
+    // The cursor is deliberately not reset between searches: WiredTiger first looks for the key
+    // in the leaf page the cursor already has pinned, so ascending ids which land on the same
+    // page skip the descent from the root.
+    for (auto&& id : ids) {
+        setKey(c, id);
+        int seekRet = WT_READ_CHECK(c->search(c));
+        if (seekRet == WT_NOTFOUND) {
+            continue;
+        }
+        invariantWTOK(seekRet);
+
+        WT_ITEM value;
+        invariantWTOK(c->get_value(c, &value));
+        out->push_back(
+            {id,
+             RecordData(static_cast<const char*>(value.data), static_cast<int>(value.size))
+                 .getOwned()});
+        _lastReturnedId = id;
+    }
+
+    _eof = true;
+}
+
 
 void WiredTigerRecordStoreCursorBase::save() {
     try {
@@ -1917,6 +2201,46 @@ void WiredTigerRecordStoreCursorBase::reattachToOperationContext(OperationContex
     // _cursor recreated in restore() to avoid risk of WT_ROLLBACK issues.
 }
 
+void WiredTigerRecordStoreCursorBase::setSkipPredicates(
+    const std::vector<ZoneMapPredicate>& predicates) {
+    invariant(_lastReturnedId.isNull());
+    if (_forward && _rs._zoneMap) {
+        _skipPredicates = predicates;
+    }
+}
+
+bool WiredTigerRecordStoreCursorBase::skipToCandidateZone(const RecordId& id) {
+    // The map is consulted only once the cursor has read a record, so that every write which is
+    // visible in the cursor's snapshot has already been noted in the map.
+    RecordId start;
+    _rs._zoneMap->nextCandidateRange(id, _skipPredicates, &start, &_zoneMapRecheckId);
+    if (start <= id) {
+        return false;
+    }
+
+    // Reposition as if the record preceding 'start' had just been returned, like
+    // restrictToRange() does.
+    _lastReturnedId = RecordId(start.repr() - 1);
+    restore();
+    return true;
+}
+
+void WiredTigerRecordStoreCursorBase::restrictToRange(const RecordId& start, const RecordId& end) {
+    invariant(_forward);
+    invariant(!_rs._isCapped);
+    invariant(_lastReturnedId.isNull());
+
+    _rangeEnd = end;
+    if (start.isNull()) {
+        return;
+    }
+
+    // Position the cursor as if it had just returned the record preceding 'start', so that both
+    // the next call to next() and any restore() after a yield resume from 'start'.
+    _lastReturnedId = RecordId(start.repr() - 1);
+    restore();
+}
+
 // Standard Implementations:
 
 
@@ -38,6 +38,7 @@
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/storage/capped_callback.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
+#include "mongo/db/storage/record_id_zone_map.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -67,6 +68,7 @@ class WiredTigerSessionCache;
 class WiredTigerSizeStorer;
 
 extern const std::string kWiredTigerEngineName;
+extern const std::string kInMemoryEngineName;
 
 //WiredTigerSizeStorer.Entry *rsΪ 
 //WiredTigerSizeStorer._entries[].rs mapм¼еļͳϢ
@@ -187,6 +189,14 @@ public:
 
     std::vector<std::unique_ptr<RecordCursor>> getManyCursors(OperationContext* opCtx) const final;
 
+    /**
+     * Splits the RecordId space into at most 'numCursors' ranges holding roughly the same number of
+     * records, by sorting a random sample of RecordIds. Returns a single cursor when the store is
+     * capped, too small to be worth splitting, or cannot be sampled.
+     */
+    std::vector<std::unique_ptr<RecordCursor>> getPartitionedCursors(
+        OperationContext* opCtx, size_t numCursors) const final;
+
     virtual Status truncate(OperationContext* opCtx);
 
     virtual bool compactSupported() const {
@@ -217,6 +227,8 @@ public:
 
     virtual Status touch(OperationContext* opCtx, BSONObjBuilder* output) const;
 
+    virtual Status setCacheResident(OperationContext* opCtx, bool resident);
+
     virtual void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive);
 
     virtual boost::optional<RecordId> oplogStartHack(OperationContext* opCtx,
@@ -224,6 +236,11 @@ public:
 
     virtual Status oplogDiskLocRegister(OperationContext* opCtx, const Timestamp& opTime);
 
+    // The WiredTigerOplogManager notifies waiters whenever it advances the oplog read timestamp.
+    bool notifiesCappedWaitersOnVisibility() const final {
+        return _isOplog;
+    }
+
     virtual void updateStatsAfterRepair(OperationContext* opCtx,
                                         long long numRecords,
                                         long long dataSize);
@@ -296,7 +313,16 @@ private:
                           const Timestamp* timestamps,
                           size_t nRecords);
 
-    RecordId _nextId();
+    /**
+     * Reserves 'count' consecutive RecordIds and returns the first of them.
+     */
+    RecordId _nextId(OperationContext* opCtx, size_t count = 1);
+
+    /**
+     * Finds the largest RecordId in use to start the counter for new RecordIds after it. Returns
+     * the first record read from the end of the table, if any.
+     */
+    boost::optional<Record> _initNextIdNum(SeekableRecordCursor* reverseCursor);
     void _setId(RecordId id);
     bool cappedAndNeedDelete() const;
     void _changeNumRecords(OperationContext* opCtx, int64_t diff);
@@ -329,18 +355,24 @@ private:
     int _cappedDeleteCheckCount;
     mutable stdx::timed_mutex _cappedDeleterMutex;
 
+    // Zero until the record store has been opened to find its largest RecordId, which may be
+    // deferred until the first insert when wiredTigerLazyRecordStoreInit is set.
     AtomicInt64 _nextIdNum;
+    stdx::mutex _nextIdInitMutex;
     AtomicInt64 _dataSize;
     AtomicInt64 _numRecords;
 
     //
     WiredTigerSizeStorer* _sizeStorer;  // not owned, can be NULL
-    int _sizeStorerCounter;
 
     WiredTigerKVEngine* _kvEngine;  // not owned.
 
     // Non-null if this record store is underlying the active oplog.
     std::shared_ptr<OplogStones> _oplogStones;
+
+    // Non-null if the fields named by 'wiredTigerZoneMapFields' are summarized for this record
+    // store, so that forward cursors can skip ranges of records. Set by postConstructorInit().
+    std::unique_ptr<RecordIdZoneMap> _zoneMap;
 };
 
 class StandardWiredTigerRecordStore final : public WiredTigerRecordStore {
@@ -397,6 +429,8 @@ public:
 
     boost::optional<Record> seekExact(const RecordId& id);
 
+    void seekExactBatch(const std::vector<RecordId>& ids, std::vector<Record>* out);
+
     void save();
 
     void saveUnpositioned();
@@ -407,6 +441,14 @@ public:
 
     void reattachToOperationContext(OperationContext* opCtx);
 
+    /**
+     * Limits a forward cursor which has not returned anything yet to the records in ['start',
+     * 'end'). A null 'start' or 'end' leaves that side of the range unbounded.
+     */
+    void restrictToRange(const RecordId& start, const RecordId& end);
+
+    void setSkipPredicates(const std::vector<ZoneMapPredicate>& predicates) final;
+
 protected:
     virtual RecordId getKey(WT_CURSOR* cursor) const = 0;
 
@@ -433,9 +475,23 @@ protected:
     boost::optional<WiredTigerCursor> _cursor;
     bool _eof = false;
     RecordId _lastReturnedId;  // If null, need to seek to first/last record.
+    RecordId _rangeEnd;        // If not null, the cursor reaches EOF at this record.
 
 private:
     bool isVisible(const RecordId& id);
+
+    /**
+     * Consults the record store's zone map about the record at 'id', which the cursor has just
+     * moved to. Returns true if no record from 'id' up to some later RecordId can satisfy the skip
+     * predicates; the cursor is then repositioned past them and the caller must advance again.
+     */
+    bool skipToCandidateZone(const RecordId& id);
+
+    // Set by setSkipPredicates() if the record store has a zone map.
+    std::vector<ZoneMapPredicate> _skipPredicates;
+
+    // The zone map does not need to be consulted again until the cursor reaches this record.
+    RecordId _zoneMapRecheckId;
 };
 
 class WiredTigerRecordStoreStandardCursor final : public WiredTigerRecordStoreCursorBase {
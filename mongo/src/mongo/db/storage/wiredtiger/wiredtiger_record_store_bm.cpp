@@ -0,0 +1,152 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/db/storage/kv/kv_prefix.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/clock_source_mock.h"
+
+namespace mongo {
+namespace {
+
+const auto kNs = "test.coll"_sd;
+const auto kIdent = "collection-bm"_sd;
+
+/**
+ * A WiredTiger engine in a temporary directory with a single record store, which lives for the
+ * duration of one benchmark run.
+ */
+class WiredTigerRecordStoreFixture {
+public:
+    WiredTigerRecordStoreFixture()
+        : _dbpath("wt_record_store_bm"),
+          _engine(kWiredTigerEngineName, _dbpath.path(), &_cs, "", 1, false, false, false, false) {
+        auto opCtx = newOperationContext();
+        const CollectionOptions options;
+        invariantOK(_engine.createGroupedRecordStore(
+            opCtx.get(), kNs, kIdent, options, KVPrefix::kNotPrefixed));
+        _rs = _engine.getGroupedRecordStore(
+            opCtx.get(), kNs, kIdent, options, KVPrefix::kNotPrefixed);
+    }
+
+    std::unique_ptr<OperationContext> newOperationContext() {
+        return stdx::make_unique<OperationContextNoop>(_engine.newRecoveryUnit());
+    }
+
+    RecordStore* recordStore() {
+        return _rs.get();
+    }
+
+    RecordId insert(OperationContext* opCtx, const std::string& data) {
+        WriteUnitOfWork wuow(opCtx);
+        auto swRecordId =
+            _rs->insertRecord(opCtx, data.c_str(), data.size() + 1, Timestamp(), false);
+        invariantOK(swRecordId.getStatus());
+        wuow.commit();
+        return swRecordId.getValue();
+    }
+
+    std::vector<RecordId> populate(std::int64_t count, std::size_t recordSize) {
+        auto opCtx = newOperationContext();
+        const std::string data(recordSize, 'x');
+        std::vector<RecordId> ids;
+        for (std::int64_t i = 0; i < count; ++i) {
+            ids.push_back(insert(opCtx.get(), data));
+        }
+        return ids;
+    }
+
+private:
+    unittest::TempDir _dbpath;
+    ClockSourceMock _cs;
+    WiredTigerKVEngine _engine;
+    std::unique_ptr<RecordStore> _rs;
+};
+
+// Inserts one record of state.range(0) bytes per write unit of work.
+void BM_wiredTigerRecordStoreInsert(benchmark::State& state) {
+    WiredTigerRecordStoreFixture fixture;
+    auto opCtx = fixture.newOperationContext();
+    const std::string data(state.range(0), 'x');
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(fixture.insert(opCtx.get(), data).repr());
+    }
+    state.setBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_wiredTigerRecordStoreInsert)->arg(100)->arg(10 * 1024);
+
+// Finds a random record by RecordId among state.range(0) records.
+void BM_wiredTigerRecordStoreSeekExact(benchmark::State& state) {
+    WiredTigerRecordStoreFixture fixture;
+    const auto ids = fixture.populate(state.range(0), 100);
+    auto opCtx = fixture.newOperationContext();
+    auto cursor = fixture.recordStore()->getCursor(opCtx.get());
+    PseudoRandom random(12345);
+    while (state.keepRunning()) {
+        const auto& id = ids[random.nextInt64(ids.size())];
+        auto record = cursor->seekExact(id);
+        invariant(record);
+        benchmark::doNotOptimize(record->data.data());
+    }
+}
+BENCHMARK(BM_wiredTigerRecordStoreSeekExact)->arg(1000)->arg(100 * 1000);
+
+// Scans all of state.range(0) records, as a collection scan does.
+void BM_wiredTigerRecordStoreScan(benchmark::State& state) {
+    WiredTigerRecordStoreFixture fixture;
+    fixture.populate(state.range(0), 100);
+    auto opCtx = fixture.newOperationContext();
+    while (state.keepRunning()) {
+        auto cursor = fixture.recordStore()->getCursor(opCtx.get());
+        std::int64_t count = 0;
+        while (auto record = cursor->next()) {
+            benchmark::doNotOptimize(record->data.data());
+            ++count;
+        }
+        invariant(count == state.range(0));
+        opCtx->recoveryUnit()->abandonSnapshot();
+    }
+    state.setItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_wiredTigerRecordStoreScan)->arg(1000)->arg(100 * 1000);
+
+}  // namespace
+}  // namespace mongo
@@ -58,21 +58,22 @@ public:
     void kill();
 
     bool hasExcessStones_inlock() const {
-        int64_t total_bytes = 0;
-        for (std::deque<OplogStones::Stone>::const_iterator it = _stones.begin();
-             it != _stones.end();
-             ++it) {
-            total_bytes += it->bytes;
-        }
-        return total_bytes > _rs->cappedMaxSize();
+        return _numExcessStones_inlock(1) > 0;
     }
 
     void awaitHasExcessStonesOrDead();
 
     boost::optional<OplogStones::Stone> peekOldestStoneIfNeeded() const;
 
+    // Returns up to 'maxStones' of the oldest stones which need to be reclaimed, merged into a
+    // single stone spanning all of their records. Sets 'numStones' to the number merged.
+    boost::optional<OplogStones::Stone> peekOldestStonesIfNeeded(size_t maxStones,
+                                                                 size_t* numStones) const;
+
     void popOldestStone();
 
+    void popOldestStones(size_t numStones);
+
     void createNewStoneIfNeeded(RecordId lastRecord);
 
     void updateCurrentStoneAfterInsertOnCommit(OperationContext* opCtx,
@@ -113,6 +114,10 @@ public:
 
     void setMinBytesPerStone(int64_t size);
 
+    // Reclaim stones once all of their records are older than 'secs' seconds, regardless of the
+    // size of the oplog. Zero reclaims stones once the oplog exceeds its maximum size.
+    void setRetentionSeconds(int64_t secs);
+
 private:
     class InsertChange;
     class TruncateChange;
@@ -125,6 +130,8 @@ private:
 
     void _pokeReclaimThreadIfNeeded();
 
+    size_t _numExcessStones_inlock(size_t maxStones) const;
+
     static const uint64_t kRandomSamplesPerStone = 10;
 
     WiredTigerRecordStore* _rs;
@@ -140,6 +147,9 @@ private:
     // deque of oplog stones.
     int64_t _minBytesPerStone;
 
+    // When non-zero, stones are reclaimed by age rather than by the size of the oplog.
+    AtomicInt64 _retentionSecs;
+
     AtomicInt64 _currentRecords;  // Number of records in the stone being filled.
     AtomicInt64 _currentBytes;    // Number of bytes in the stone being filled.
 
@@ -32,6 +32,7 @@
 #include <sstream>
 #include <string>
 #include <time.h>
+#include <vector>
 
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/init.h"
@@ -40,6 +41,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context_noop.h"
+#include "mongo/db/storage/capped_callback.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/record_store_test_harness.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
@@ -47,7 +49,10 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/fail_point.h"
@@ -351,6 +356,96 @@ TEST(WiredTigerRecordStoreTest, OplogDurableVisibilityOutOfOrder) {
     ASSERT(!wtrs->isOpHidden_forTest(id2));
 }
 
+// Counts the notifications given to capped waiters, and lets threads wait for them.
+class CountingCappedCallback final : public CappedCallback {
+public:
+    Status aboutToDeleteCapped(OperationContext* opCtx,
+                               const RecordId& loc,
+                               RecordData data) override {
+        return Status::OK();
+    }
+
+    void notifyCappedWaitersIfNeeded() override {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        ++_notifications;
+        _notified.notify_all();
+    }
+
+    int getNotifications() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _notifications;
+    }
+
+    // Returns the number of notifications once there is at least one, or 0 on timeout.
+    int waitForNotification() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _notified.wait_for(lk, Seconds(30).toSystemDuration(), [this] {
+            return _notifications > 0;
+        });
+        return _notifications;
+    }
+
+private:
+    stdx::mutex _mutex;
+    stdx::condition_variable _notified;
+    int _notifications = 0;
+};
+
+// Test that committing oplog inserts leaves waking the capped waiters to the oplog visibility
+// update, which wakes all of them at once for every write it makes visible.
+TEST(WiredTigerRecordStoreTest, OplogVisibilityUpdateWakesAllCappedWaiters) {
+    ON_BLOCK_EXIT([] { WTPausePrimaryOplogDurabilityLoop.setMode(FailPoint::off); });
+    WTPausePrimaryOplogDurabilityLoop.setMode(FailPoint::alwaysOn);
+
+    CountingCappedCallback cappedCallback;
+    unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("local.oplog.rs", 100000, -1));
+    ASSERT_TRUE(rs->notifiesCappedWaitersOnVisibility());
+    ASSERT_FALSE(
+        harnessHelper->newNonCappedRecordStore("a.c")->notifiesCappedWaitersOnVisibility());
+
+    auto wtrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+    wtrs->setCappedCallback(&cappedCallback);
+    ON_BLOCK_EXIT([&] { wtrs->setCappedCallback(nullptr); });
+
+    const size_t nWaiters = 3;
+    std::vector<int> notificationsSeen(nWaiters, 0);
+    std::vector<stdx::thread> waiters;
+    for (size_t i = 0; i < nWaiters; i++) {
+        waiters.emplace_back(
+            [&, i] { notificationsSeen[i] = cappedCallback.waitForNotification(); });
+    }
+
+    // Writers on several clients commit while their entries are still hidden, waking no one.
+    std::vector<RecordId> ids;
+    for (int inc = 1; inc <= 3; inc++) {
+        auto client = harnessHelper->serviceContext()->makeClient("writer");
+        ServiceContext::UniqueOperationContext opCtx(
+            harnessHelper->newOperationContext(client.get()));
+        WriteUnitOfWork uow(opCtx.get());
+        ids.push_back(_oplogOrderInsertOplog(opCtx.get(), rs, inc));
+        uow.commit();
+    }
+    const int notificationsBeforeVisible = cappedCallback.getNotifications();
+
+    WTPausePrimaryOplogDurabilityLoop.setMode(FailPoint::off);
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        rs->waitForAllEarlierOplogWritesToBeVisible(opCtx.get());
+    }
+    for (auto&& waiter : waiters) {
+        waiter.join();
+    }
+
+    ASSERT_EQUALS(0, notificationsBeforeVisible);
+    for (size_t i = 0; i < nWaiters; i++) {
+        ASSERT_GT(notificationsSeen[i], 0);
+    }
+    for (auto&& id : ids) {
+        ASSERT(!wtrs->isOpHidden_forTest(id));
+    }
+}
+
 TEST(WiredTigerRecordStoreTest, AppendCustomStatsMetadata) {
     std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
     unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore("a.b"));
@@ -806,6 +901,48 @@ TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStones) {
     }
 }
 
+// Verify that oplog stones are reclaimed by age when a retention period is set, regardless of
+// cappedMaxSize.
+TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStonesByAge) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(
+        harnessHelper->newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    oplogStones->setMinBytesPerStone(100);
+    oplogStones->setRetentionSeconds(3600);
+
+    const unsigned nowSecs = Date_t::now().toMillisSinceEpoch() / 1000;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 1), 100), RecordId(1, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 2), 110), RecordId(1, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(nowSecs, 1), 120),
+                  RecordId(nowSecs, 1));
+
+        ASSERT_EQ(3, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(330, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(3U, oplogStones->numStones());
+    }
+
+    // Only the stones older than the retention period are truncated, although the oplog is well
+    // below cappedMaxSize.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get());
+
+        ASSERT_EQ(1, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(120, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(1U, oplogStones->numStones());
+    }
+}
+
 // Verify that an oplog stone isn't created if it would cause the logical representation of the
 // records to not be in increasing order.
 TEST(WiredTigerRecordStoreTest, OplogStones_AscendingOrder) {
@@ -34,11 +34,14 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/hex.h"
 #include "mongo/util/log.h"
 
@@ -50,6 +53,11 @@ namespace {
 AtomicUInt64 nextSnapshotId{1};
 
 logger::LogSeverity kSlowTransactionSeverity = logger::LogSeverity::Debug(1);
+
+// Every live recovery unit, so that serverStatus can report how long open snapshots have been
+// pinned.
+stdx::mutex registeredRecoveryUnitsMutex;
+std::list<const WiredTigerRecoveryUnit*> registeredRecoveryUnits;
 }  // namespace
 
 //WiredTigerRecoveryUnitWiredTigerKVEngine._sessionCacheͨWiredTigerKVEngine::newRecoveryUnit()
@@ -63,7 +71,10 @@ WiredTigerRecoveryUnit::WiredTigerRecoveryUnit(WiredTigerSessionCache* sc,
       _oplogManager(oplogManager),
       _inUnitOfWork(false),
       _active(false),
-      _mySnapshotId(nextSnapshotId.fetchAndAdd(1)) {}
+      _mySnapshotId(nextSnapshotId.fetchAndAdd(1)) {
+    stdx::lock_guard<stdx::mutex> lk(registeredRecoveryUnitsMutex);
+    _registration = registeredRecoveryUnits.insert(registeredRecoveryUnits.end(), this);
+}
 
 /*
 (gdb) bt
@@ -78,6 +89,42 @@ WiredTigerRecoveryUnit::WiredTigerRecoveryUnit(WiredTigerSessionCache* sc,
 WiredTigerRecoveryUnit::~WiredTigerRecoveryUnit() {
     invariant(!_inUnitOfWork);
     _abort();
+
+    stdx::lock_guard<stdx::mutex> lk(registeredRecoveryUnitsMutex);
+    registeredRecoveryUnits.erase(_registration);
+}
+
+void WiredTigerRecoveryUnit::reportState(BSONObjBuilder* b) const {
+    const long long openedAt = _txnOpenedAtMillis.load();
+    if (openedAt) {
+        const long long now = curTimeMillis64();
+        b->append("snapshotAgeMillis", std::max(0LL, now - openedAt));
+    }
+}
+
+void WiredTigerRecoveryUnit::appendGlobalStats(BSONObjBuilder& b) {
+    const long long now = curTimeMillis64();
+    long long open = 0;
+    long long openLongerThanSlowMS = 0;
+    long long oldestAgeMillis = 0;
+    {
+        stdx::lock_guard<stdx::mutex> lk(registeredRecoveryUnitsMutex);
+        for (auto ru : registeredRecoveryUnits) {
+            const long long openedAt = ru->_txnOpenedAtMillis.load();
+            if (!openedAt) {
+                continue;
+            }
+            const long long age = std::max(0LL, now - openedAt);
+            ++open;
+            if (age >= serverGlobalParams.slowMS) {
+                ++openLongerThanSlowMS;
+            }
+            oldestAgeMillis = std::max(oldestAgeMillis, age);
+        }
+    }
+    b.append("open", open);
+    b.append("openLongerThanSlowMS", openLongerThanSlowMS);
+    b.append("oldestAgeMillis", oldestAgeMillis);
 }
 
 void WiredTigerRecoveryUnit::prepareForCreateSnapshot(OperationContext* opCtx) {
@@ -261,12 +308,13 @@ void WiredTigerRecoveryUnit::_txnClose(bool commit) {
     }
 
     if (_isTimestamped) {
-        _oplogManager->triggerJournalFlush();
+        _oplogManager->finishTimestampedTransaction(_firstCommitTimestamp);
         _isTimestamped = false;
     }
     invariantWTOK(wtRet);
 
     _active = false;
+    _txnOpenedAtMillis.store(0);
     _mySnapshotId = nextSnapshotId.fetchAndAdd(1);
     _isOplogReader = false;
 }
@@ -294,6 +342,15 @@ boost::optional<Timestamp> WiredTigerRecoveryUnit::getMajorityCommittedSnapshot(
     return _majorityCommittedSnapshot;
 }
 
+Status WiredTigerRecoveryUnit::setReadFromLocalSnapshot() {
+    if (!_sessionCache->snapshotManager().getLocalSnapshot()) {
+        return {ErrorCodes::NotYetInitialized, "No local snapshot is currently available."};
+    }
+
+    _readFromLocalSnapshot = true;
+    return Status::OK();
+}
+
 //WiredTigerRecoveryUnit::getSessionִ,ȡһsession,begin_transaction
 /*
 RecoveryUnitװwiredTigerRecoveryUnit::_txnOpen ӦWTbeginTransaction  
@@ -320,12 +377,15 @@ void WiredTigerRecoveryUnit::_txnOpen() { //begin_transaction
     } else if (_isOplogReader) {
         _sessionCache->snapshotManager().beginTransactionOnOplog(
             _sessionCache->getKVEngine()->getOplogManager(), session);
+    } else if (_readFromLocalSnapshot) {
+        _sessionCache->snapshotManager().beginTransactionOnLocalSnapshot(session);
     } else {
         invariantWTOK(session->begin_transaction(session, NULL));  //begin_transaction
     }
 
     LOG(3) << "WiredTigerRecoveryUnit::_txnOpen WT begin_transaction for snapshot id " << _mySnapshotId;
     _active = true;
+    _txnOpenedAtMillis.store(static_cast<long long>(curTimeMillis64()));
 }
 
 //WiredTigerRecordStore::_insertRecords  oplogDiskLocRegisterеִ
@@ -340,8 +400,11 @@ Status WiredTigerRecoveryUnit::setTimestamp(Timestamp timestamp) {
 
     const std::string conf = "commit_timestamp=" + integerToHex(timestamp.asULL());
     auto rc = session->timestamp_transaction(session, conf.c_str());
-    if (rc == 0) {
+    if (rc == 0 && !_isTimestamped) {
+        // WiredTiger orders the transaction by the first commit timestamp it was given.
         _isTimestamped = true;
+        _firstCommitTimestamp = timestamp;
+        _oplogManager->beginTimestampedTransaction(timestamp);
     }
     return wtRCToStatus(rc, "timestamp_transaction");
 }
@@ -32,6 +32,7 @@
 
 #include <boost/optional.hpp>
 #include <cstdint>
+#include <list>
 #include <memory>
 #include <vector>
 
@@ -41,6 +42,7 @@
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -69,6 +71,8 @@ public:
 
     void registerChange(Change* change) override;
 
+    void reportState(BSONObjBuilder* b) const override;
+
     void abandonSnapshot() override;
     void prepareSnapshot() override;
 
@@ -79,6 +83,11 @@ public:
 
     boost::optional<Timestamp> getMajorityCommittedSnapshot() const override;
 
+    Status setReadFromLocalSnapshot() override;
+    bool isReadingFromLocalSnapshot() const override {
+        return _readFromLocalSnapshot;
+    }
+
     SnapshotId getSnapshotId() const override;
 
     Status setTimestamp(Timestamp timestamp) override;
@@ -119,6 +128,11 @@ public:
         return checked_cast<WiredTigerRecoveryUnit*>(opCtx->recoveryUnit());
     }
 
+    /**
+     * Appends the number of open WT snapshots and how long the oldest of them has been open. A
+     * long-lived snapshot pins the history of every document changed since it was opened in the
+     * WT cache.
+     */
     static void appendGlobalStats(BSONObjBuilder& b);
 
     /**
@@ -150,11 +164,19 @@ private:
     //WiredTigerRecoveryUnit::_txnOpenֵtrue RecoveryUnit::_txnCloseֵfalse
     bool _active;
     bool _isTimestamped = false;
+    // The commit timestamp this transaction was registered with the oplog manager under.
+    Timestamp _firstCommitTimestamp;
     uint64_t _mySnapshotId;
     bool _readFromMajorityCommittedSnapshot = false;
     Timestamp _majorityCommittedSnapshot;
+    bool _readFromLocalSnapshot = false;
     Timestamp _readAtTimestamp;
     std::unique_ptr<Timer> _timer;
+    // When the current WT transaction was opened, in milliseconds since the epoch, or 0 when there
+    // is none. Read by other threads through appendGlobalStats().
+    AtomicInt64 _txnOpenedAtMillis{0};
+    // This recovery unit's entry in the list of live recovery units.
+    std::list<const WiredTigerRecoveryUnit*>::iterator _registration;
     bool _isOplogReader = false;
     typedef std::vector<std::unique_ptr<Change>> Changes;
     //ύ عWiredTigerRecoveryUnit::_commit WiredTigerRecoveryUnit::_abort
@@ -79,6 +79,22 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
 
     WiredTigerKVEngine::appendGlobalStats(bob);
 
+    {
+        BSONObjBuilder snapshotsBuilder(bob.subobjStart("snapshots"));
+        WiredTigerRecoveryUnit::appendGlobalStats(snapshotsBuilder);
+    }
+
+    {
+        BSONObjBuilder sessionCacheBuilder(bob.subobjStart("sessionCache"));
+        WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->appendStats(&sessionCacheBuilder);
+    }
+
+    {
+        BSONObjBuilder groupCommitBuilder(bob.subobjStart("journalGroupCommit"));
+        WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->appendGroupCommitStats(
+            &groupCommitBuilder);
+    }
+
     return bob.obj();
 }
 
@@ -0,0 +1,71 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include <set>
+#include <string>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_server_status.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
+
+namespace mongo {
+namespace {
+
+TEST(WiredTigerServerStatusSectionTest, ReportsEveryFieldOnce) {
+    unittest::TempDir dbpath("wt-server-status");
+    ClockSourceMock cs;
+    WiredTigerKVEngine engine(
+        kWiredTigerEngineName, dbpath.path(), &cs, "", 1, false, false, false, false);
+    OperationContextNoop opCtx(engine.newRecoveryUnit());
+
+    WiredTigerServerStatusSection section(&engine);
+    const BSONObj status = section.generateSection(&opCtx, BSONElement());
+
+    // A JavaScript or BSONObj lookup only ever sees one of several fields with the same name, so
+    // count them while iterating over the raw object.
+    std::multiset<std::string> fieldNames;
+    for (auto&& elem : status) {
+        fieldNames.insert(elem.fieldName());
+    }
+    ASSERT_EQUALS(1U, fieldNames.count("sessionCache"));
+    ASSERT_EQUALS(1U, fieldNames.count("journalGroupCommit"));
+    ASSERT_EQUALS(1U, fieldNames.count("snapshots"));
+    for (auto&& name : fieldNames) {
+        ASSERT_EQUALS(1U, fieldNames.count(name)) << name;
+    }
+}
+
+}  // namespace
+}  // namespace mongo
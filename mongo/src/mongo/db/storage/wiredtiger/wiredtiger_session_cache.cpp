@@ -36,8 +36,10 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/mongod_options.h"
 #include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -45,6 +47,8 @@
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 /*
@@ -235,6 +239,11 @@ void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
 
 namespace {
 AtomicUInt64 nextTableId(1);
+
+// The longest a journal flush waits for more j:true writers to join it. Flushes only wait while
+// the previous flush covered more than one writer, and then for at most a quarter of the average
+// flush time, so a lone writer never waits. Zero disables the wait.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerJournalGroupCommitMaxDelayMicros, int, 0);
 }
 // static   WiredTigerIndex::WiredTigerIndex
 uint64_t WiredTigerSession::genTableId() {
@@ -242,6 +251,8 @@ uint64_t WiredTigerSession::genTableId() {
 }
 
 // -----------------------
+const size_t WiredTigerSessionCache::kNumSessionStripes;
+
 //WiredTigerKVEngine::WiredTigerKVEngineеù
 WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
     : _engine(engine), _conn(engine->getConnection()), _snapshotManager(_conn), _shuttingDown(0) {}
@@ -338,6 +349,9 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         return;
     }
 
+    _groupCommitWaiters.fetchAndAdd(1);
+    _groupCommitPendingWaiters.fetchAndAdd(1);
+
     uint32_t start = _lastSyncTime.load();
     // Do the remainder in a critical section that ensures only a single thread at a time
     // will attempt to synchronize.
@@ -347,7 +361,23 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         // Someone else synced already since we read lastSyncTime, so we're done!
         return;
     }
+
+    // When the last flush was shared, other writers are likely to arrive shortly, so give them a
+    // chance to join this flush rather than start another one right after it. Writers arriving
+    // now still read the current sync time and so are covered once it is bumped below.
+    const long long maxDelayMicros = wiredTigerJournalGroupCommitMaxDelayMicros.load();
+    if (maxDelayMicros > 0 && _groupCommitLastBatchSize.load() > 1) {
+        const long long delayMicros = std::min(
+            maxDelayMicros, static_cast<long long>(_groupCommitAverageFlushMicros.load() / 4));
+        if (delayMicros > 0) {
+            _groupCommitDelayedFlushes.fetchAndAdd(1);
+            sleepmicros(delayMicros);
+        }
+    }
     _lastSyncTime.store(current + 1);
+    _groupCommitLastBatchSize.store(_groupCommitPendingWaiters.swap(0));
+    _groupCommitFlushes.fetchAndAdd(1);
+    Timer flushTimer;
 
     // Nobody has synched yet, so we have to sync ourselves.
 
@@ -371,14 +401,22 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         LOG(4) << "created checkpoint";
     }
 
+    // Only the thread holding _lastSyncMutex updates the average, so a plain store is enough.
+    const uint64_t averageMicros = _groupCommitAverageFlushMicros.load();
+    const uint64_t flushMicros = static_cast<uint64_t>(flushTimer.micros());
+    _groupCommitAverageFlushMicros.store(
+        averageMicros == 0 ? flushMicros : (averageMicros * 7 + flushMicros) / 8);
+
 	//ReplicationCoordinatorExternalStateImpl::onDurable
     _journalListener->onDurable(token);
 }
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri); //WiredTigerSession::closeAllCursors
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> lock(stripe.lock);
+        for (SessionCache::iterator i = stripe.sessions.begin(); i != stripe.sessions.end(); i++) {
+            (*i)->closeAllCursors(uri); //WiredTigerSession::closeAllCursors
+        }
     }
 }
 
@@ -387,9 +425,11 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine); //WiredTigerSession::closeCursorsForQueuedDrops
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> lock(stripe.lock);
+        for (SessionCache::iterator i = stripe.sessions.begin(); i != stripe.sessions.end(); i++) {
+            (*i)->closeCursorsForQueuedDrops(_engine); //WiredTigerSession::closeCursorsForQueuedDrops
+        }
     }
 }
 
@@ -399,9 +439,19 @@ void WiredTigerSessionCache::closeAll() {
     SessionCache swap;
 
     {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        // Hold every stripe lock while moving to the new epoch, so that no session of the old
+        // epoch can be handed out or cached once closeAll() has started.
+        std::vector<stdx::unique_lock<stdx::mutex>> locks;
+        locks.reserve(kNumSessionStripes);
+        for (auto&& stripe : _stripes) {
+            locks.emplace_back(stripe.lock);
+        }
+
         _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
+        for (auto&& stripe : _stripes) {
+            swap.insert(swap.end(), stripe.sessions.begin(), stripe.sessions.end());
+            stripe.sessions.clear();
+        }
     }
 
     for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
@@ -435,17 +485,36 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
+    SessionStripe& ownStripe = _stripeForCurrentThread();
     {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) { //WiredTigerSession _sessionsΪգֱȡһ
+        stdx::lock_guard<stdx::mutex> lock(ownStripe.lock);
+        if (!ownStripe.sessions.empty()) { //WiredTigerSession _sessionsΪգֱȡһ
             // Get the most recently used session so that if we discard sessions, we're
             // discarding older ones  
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back(); //WiredTigerSessionCache._sessions
+            WiredTigerSession* cachedSession = ownStripe.sessions.back();
+            ownStripe.sessions.pop_back(); //WiredTigerSessionCache._sessions
+            ownStripe.hits.fetchAndAdd(1);
             return UniqueWiredTigerSession(cachedSession); 
         }
     }
 
+    // Our own stripe is empty, so take an idle session from another stripe before paying for a
+    // new one.
+    for (auto&& stripe : _stripes) {
+        if (&stripe == &ownStripe) {
+            continue;
+        }
+        stdx::lock_guard<stdx::mutex> lock(stripe.lock);
+        if (!stripe.sessions.empty()) {
+            WiredTigerSession* cachedSession = stripe.sessions.back();
+            stripe.sessions.pop_back();
+            ownStripe.steals.fetchAndAdd(1);
+            return UniqueWiredTigerSession(cachedSession);
+        }
+    }
+
+    ownStripe.misses.fetchAndAdd(1);
+
     // Outside of the cache partition lock, but on release will be put back on the cache
     return UniqueWiredTigerSession( //wiredtiger conn->open_sessionȡµsession
         new WiredTigerSession(_conn, this, _epoch.load(), _cursorEpoch.load()));
@@ -539,10 +608,11 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
 
 	//Ѹsessioncacheûֱdrop
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        SessionStripe& stripe = _stripeForCurrentThread();
+        stdx::lock_guard<stdx::mutex> lock(stripe.lock);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true; //
-            _sessions.push_back(session);
+            stripe.sessions.push_back(session);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -556,6 +626,61 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
 }
 
 //WiredTigerKVEngine::setJournalListenerе
+WiredTigerSessionCache::SessionStripe& WiredTigerSessionCache::_stripeForCurrentThread() {
+    // Threads are spread over the stripes round robin the first time they use a session cache.
+    // Hashing the thread id instead would cluster, since pthread ids are aligned addresses.
+    static AtomicUInt32 nextStripe;
+    static thread_local uint32_t threadStripe = nextStripe.fetchAndAdd(1);
+    return _stripes[threadStripe % kNumSessionStripes];
+}
+
+void WiredTigerSessionCache::appendStats(BSONObjBuilder* builder) const {
+    long long cached = 0;
+    long long hits = 0;
+    long long misses = 0;
+    long long steals = 0;
+
+    BSONArrayBuilder stripesBuilder;
+    for (auto&& stripe : _stripes) {
+        long long stripeCached;
+        {
+            stdx::lock_guard<stdx::mutex> lock(stripe.lock);
+            stripeCached = static_cast<long long>(stripe.sessions.size());
+        }
+        const auto stripeHits = static_cast<long long>(stripe.hits.load());
+        const auto stripeMisses = static_cast<long long>(stripe.misses.load());
+        const auto stripeSteals = static_cast<long long>(stripe.steals.load());
+
+        stripesBuilder.append(BSON("cached" << stripeCached << "hits" << stripeHits << "misses"
+                                            << stripeMisses
+                                            << "steals"
+                                            << stripeSteals));
+        cached += stripeCached;
+        hits += stripeHits;
+        misses += stripeMisses;
+        steals += stripeSteals;
+    }
+
+    builder->append("cached", cached);
+    builder->append("hits", hits);
+    builder->append("misses", misses);
+    builder->append("steals", steals);
+    builder->append("stripes", stripesBuilder.arr());
+}
+
+void WiredTigerSessionCache::appendGroupCommitStats(BSONObjBuilder* builder) const {
+    const long long flushes = static_cast<long long>(_groupCommitFlushes.load());
+    const long long waiters = static_cast<long long>(_groupCommitWaiters.load());
+
+    builder->append("flushes", flushes);
+    builder->append("waiters", waiters);
+    builder->append("averageBatchSize", flushes ? static_cast<double>(waiters) / flushes : 0.0);
+    builder->append("lastBatchSize", static_cast<long long>(_groupCommitLastBatchSize.load()));
+    builder->append("delayedFlushes", static_cast<long long>(_groupCommitDelayedFlushes.load()));
+    builder->append("averageFlushMicros",
+                    static_cast<long long>(_groupCommitAverageFlushMicros.load()));
+}
+
 void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     stdx::unique_lock<stdx::mutex> lk(_journalListenerMutex);
     _journalListener = jl;
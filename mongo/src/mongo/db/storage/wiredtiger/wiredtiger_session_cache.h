@@ -31,6 +31,7 @@
 
 #pragma once
 
+#include <array>
 #include <list>
 #include <string>
 
@@ -44,6 +45,7 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
@@ -221,7 +223,46 @@ public:
         return _engine;
     }
 
+    /**
+     * Appends the number of cached sessions and the hit, miss and steal counters of each stripe of
+     * the session pool to 'builder'.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+    /**
+     * Appends how many journal flushes waitUntilDurable() performed and how many callers they
+     * covered to 'builder'.
+     */
+    void appendGroupCommitStats(BSONObjBuilder* builder) const;
+
+    static const size_t kNumSessionStripes = 16;
+
 private:
+    typedef std::vector<WiredTigerSession*> SessionCache;
+
+    /**
+     * The pool of idle sessions is split into stripes, each with its own lock, so that concurrent
+     * getSession() and releaseSession() calls from different threads rarely contend. A thread
+     * releases into and takes from its own stripe, and only visits the other stripes when its own
+     * stripe is empty.
+     */
+    struct SessionStripe {
+        mutable stdx::mutex lock;  // Guards 'sessions'.
+        SessionCache sessions;
+
+        // getSession() calls served from this stripe's own sessions.
+        AtomicUInt64 hits;
+        // getSession() calls that found no cached session in any stripe and opened a new one.
+        AtomicUInt64 misses;
+        // getSession() calls that had to take a session from another stripe.
+        AtomicUInt64 steals;
+    };
+
+    /**
+     * Returns the stripe the calling thread releases into and takes from first.
+     */
+    SessionStripe& _stripeForCurrentThread();
+
     WiredTigerKVEngine* _engine;  // not owned, might be NULL  ֵWiredTigerSessionCache::WiredTigerSessionCache
     WT_CONNECTION* _conn;         // not owned  ԴWiredTigerKVEngine._conn
     WiredTigerSnapshotManager _snapshotManager;  //wiredtigerչ
@@ -232,13 +273,7 @@ private:
     AtomicUInt32 _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
-
-    //WiredTigerSessionCache::releaseSessionиֵ 
-    //WiredTigerRecoveryUnit::_ensureSession()ֵWiredTigerRecoveryUnit._session
-    typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions; 
-    
+    std::array<SessionStripe, kNumSessionStripes> _stripes;
 
     // Bumped when all open sessions need to be closed
     //WiredTigerSessionCache::closeAll
@@ -251,6 +286,16 @@ private:
     AtomicUInt32 _lastSyncTime;
     stdx::mutex _lastSyncMutex;
 
+    // Group commit statistics: calls to waitUntilDurable which did not force a checkpoint,
+    AtomicUInt64 _groupCommitWaiters;
+    // Such callers since the last flush started, which the next flush covers.
+    AtomicUInt32 _groupCommitPendingWaiters;
+    AtomicUInt64 _groupCommitFlushes;
+    AtomicUInt64 _groupCommitLastBatchSize;
+    AtomicUInt64 _groupCommitDelayedFlushes;
+    // Moving average of the time taken by a journal flush. Written under _lastSyncMutex.
+    AtomicUInt64 _groupCommitAverageFlushMicros;
+
     // Protects _journalListener.
     stdx::mutex _journalListenerMutex;
     // Notified when we commit to the journal.
@@ -0,0 +1,222 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/journal_listener.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+class WiredTigerSessionCacheTest : public unittest::Test {
+public:
+    WiredTigerSessionCacheTest() : _dbpath("wt_session_cache_test") {
+        ASSERT_OK(wtRCToStatus(wiredtiger_open(_dbpath.path().c_str(), NULL, "create,", &_conn)));
+        _sessionCache = stdx::make_unique<WiredTigerSessionCache>(_conn);
+    }
+
+    ~WiredTigerSessionCacheTest() {
+        _sessionCache.reset();
+        _conn->close(_conn, NULL);
+    }
+
+protected:
+    WiredTigerSessionCache* sessionCache() {
+        return _sessionCache.get();
+    }
+
+    BSONObj stats() {
+        BSONObjBuilder builder;
+        _sessionCache->appendStats(&builder);
+        return builder.obj();
+    }
+
+    BSONObj groupCommitStats() {
+        BSONObjBuilder builder;
+        _sessionCache->appendGroupCommitStats(&builder);
+        return builder.obj();
+    }
+
+private:
+    unittest::TempDir _dbpath;
+    WT_CONNECTION* _conn = nullptr;
+    std::unique_ptr<WiredTigerSessionCache> _sessionCache;
+};
+
+TEST_F(WiredTigerSessionCacheTest, ReleasedSessionIsReusedByTheSameThread) {
+    WiredTigerSession* first;
+    {
+        auto session = sessionCache()->getSession();
+        first = session.get();
+    }
+    ASSERT_EQUALS(1, stats()["misses"].numberLong());
+    ASSERT_EQUALS(1, stats()["cached"].numberLong());
+
+    auto session = sessionCache()->getSession();
+    ASSERT_EQUALS(first, session.get());
+    ASSERT_EQUALS(1, stats()["hits"].numberLong());
+    ASSERT_EQUALS(0, stats()["cached"].numberLong());
+}
+
+TEST_F(WiredTigerSessionCacheTest, SessionReleasedByAnotherThreadIsReusedInsteadOfOpeningOne) {
+    WiredTigerSession* released = nullptr;
+    stdx::thread releasingThread([&] {
+        auto session = sessionCache()->getSession();
+        released = session.get();
+    });
+    releasingThread.join();
+    ASSERT_EQUALS(1, stats()["misses"].numberLong());
+
+    auto session = sessionCache()->getSession();
+    ASSERT_EQUALS(released, session.get());
+    ASSERT_EQUALS(1, stats()["misses"].numberLong());
+    ASSERT_EQUALS(1, stats()["hits"].numberLong() + stats()["steals"].numberLong());
+}
+
+TEST_F(WiredTigerSessionCacheTest, StatsReportEveryStripe) {
+    auto stripes = stats()["stripes"].Array();
+    ASSERT_EQUALS(WiredTigerSessionCache::kNumSessionStripes, stripes.size());
+}
+
+TEST_F(WiredTigerSessionCacheTest, CloseAllDiscardsCachedSessions) {
+    { auto session = sessionCache()->getSession(); }
+    ASSERT_EQUALS(1, stats()["cached"].numberLong());
+
+    sessionCache()->closeAll();
+    ASSERT_EQUALS(0, stats()["cached"].numberLong());
+
+    auto session = sessionCache()->getSession();
+    ASSERT_EQUALS(2, stats()["misses"].numberLong());
+}
+
+/**
+ * Holds up the first flush until 'nWaiters' callers in all have asked to wait for durability, so
+ * that the ones arriving meanwhile share the next flush.
+ */
+class BlockingJournalListener : public JournalListener {
+public:
+    BlockingJournalListener(stdx::function<long long()> getNumWaiters, long long nWaiters)
+        : _getNumWaiters(std::move(getNumWaiters)), _nWaiters(nWaiters) {}
+
+    Token getToken() override {
+        if (!_blocked) {
+            _blocked = true;
+            while (_getNumWaiters() < _nWaiters) {
+                sleepmillis(1);
+            }
+            // Let the last waiters reach the flush they are queued for.
+            sleepmillis(50);
+        }
+        return Token();
+    }
+
+    void onDurable(const Token& token) override {}
+
+private:
+    const stdx::function<long long()> _getNumWaiters;
+    const long long _nWaiters;
+    bool _blocked = false;
+};
+
+void setMaxGroupCommitDelayMicros(StringData micros) {
+    auto parameter =
+        ServerParameterSet::getGlobal()->getMap()["wiredTigerJournalGroupCommitMaxDelayMicros"];
+    ASSERT(parameter);
+    ASSERT_OK(parameter->setFromString(micros.toString()));
+}
+
+TEST_F(WiredTigerSessionCacheTest, LoneWriterNeverDelaysAFlush) {
+    setMaxGroupCommitDelayMicros("1000000");
+    ON_BLOCK_EXIT([] { setMaxGroupCommitDelayMicros("0"); });
+
+    for (int i = 0; i < 3; ++i) {
+        sessionCache()->waitUntilDurable(false, false);
+    }
+
+    auto groupCommit = groupCommitStats();
+    ASSERT_EQUALS(3, groupCommit["flushes"].numberLong());
+    ASSERT_EQUALS(1, groupCommit["lastBatchSize"].numberLong());
+    ASSERT_EQUALS(0, groupCommit["delayedFlushes"].numberLong());
+}
+
+TEST_F(WiredTigerSessionCacheTest, FlushFollowingASharedOneWaitsForMoreWriters) {
+    setMaxGroupCommitDelayMicros("1000000");
+    ON_BLOCK_EXIT([] { setMaxGroupCommitDelayMicros("0"); });
+
+    BlockingJournalListener listener([this] { return groupCommitStats()["waiters"].numberLong(); },
+                                     3);
+    sessionCache()->setJournalListener(&listener);
+    ON_BLOCK_EXIT([this] { sessionCache()->setJournalListener(&NoOpJournalListener::instance); });
+
+    // Two writers arrive while the first flush is under way, and share the next flush.
+    std::vector<stdx::thread> writers;
+    writers.emplace_back([this] { sessionCache()->waitUntilDurable(false, false); });
+    while (groupCommitStats()["flushes"].numberLong() < 1) {
+        sleepmillis(1);
+    }
+    for (int i = 0; i < 2; ++i) {
+        writers.emplace_back([this] { sessionCache()->waitUntilDurable(false, false); });
+    }
+    for (auto&& writer : writers) {
+        writer.join();
+    }
+
+    auto groupCommit = groupCommitStats();
+    ASSERT_EQUALS(3, groupCommit["waiters"].numberLong());
+    ASSERT_EQUALS(2, groupCommit["flushes"].numberLong());
+    ASSERT_EQUALS(2, groupCommit["lastBatchSize"].numberLong());
+    ASSERT_EQUALS(0, groupCommit["delayedFlushes"].numberLong());
+    ASSERT_GT(groupCommit["averageFlushMicros"].numberLong(), 0);
+
+    // Since the last flush was shared, the next one waits for other writers to join it.
+    sessionCache()->waitUntilDurable(false, false);
+    groupCommit = groupCommitStats();
+    ASSERT_EQUALS(3, groupCommit["flushes"].numberLong());
+    ASSERT_EQUALS(1, groupCommit["delayedFlushes"].numberLong());
+    ASSERT_EQUALS(1, groupCommit["lastBatchSize"].numberLong());
+
+    // That flush covered a single writer, so the one after it starts right away.
+    sessionCache()->waitUntilDurable(false, false);
+    ASSERT_EQUALS(4, groupCommitStats()["flushes"].numberLong());
+    ASSERT_EQUALS(1, groupCommitStats()["delayedFlushes"].numberLong());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -33,6 +33,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <boost/functional/hash.hpp>
 #include <wiredtiger.h>
 
 #include "mongo/bson/bsonobj.h"
@@ -145,12 +146,17 @@ void WiredTigerSizeStorer::_checkMagic() const {
     invariant(_magic == MAGIC);
 }
 
+size_t WiredTigerSizeStorer::_shardIndex(StringData uri) {
+    return boost::hash_range(uri.rawData(), uri.rawData() + uri.size()) % kNumShards;
+}
+
 void WiredTigerSizeStorer::onCreate(WiredTigerRecordStore* rs,
                                     long long numRecords,
                                     long long dataSize) {
     _checkMagic();
-    stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-    Entry& entry = _entries[rs->getURI()];
+    Shard& shard = _shards[_shardIndex(rs->getURI())];
+    stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+    Entry& entry = shard.entries[rs->getURI()];
     entry.rs = rs;
     entry.numRecords = numRecords;
     entry.dataSize = dataSize;
@@ -159,8 +165,9 @@ void WiredTigerSizeStorer::onCreate(WiredTigerRecordStore* rs,
 
 void WiredTigerSizeStorer::onDestroy(WiredTigerRecordStore* rs) {
     _checkMagic();
-    stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-    Entry& entry = _entries[rs->getURI()];
+    Shard& shard = _shards[_shardIndex(rs->getURI())];
+    stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+    Entry& entry = shard.entries[rs->getURI()];
     entry.numRecords = rs->numRecords(NULL);
     entry.dataSize = rs->dataSize(NULL);
     entry.dirty = true;
@@ -172,8 +179,9 @@ void WiredTigerSizeStorer::onDestroy(WiredTigerRecordStore* rs) {
 //WiredTigerSizeStorer::storeToCacheWiredTigerSizeStorer::loadFromCacheӦ
 void WiredTigerSizeStorer::storeToCache(StringData uri, long long numRecords, long long dataSize) {
     _checkMagic();
-    stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-    Entry& entry = _entries[uri.toString()];
+    Shard& shard = _shards[_shardIndex(uri)];
+    stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+    Entry& entry = shard.entries[uri.toString()];
     entry.numRecords = numRecords;
     entry.dataSize = dataSize;
     entry.dirty = true;
@@ -186,9 +194,10 @@ void WiredTigerSizeStorer::loadFromCache(StringData uri,
                                          long long* numRecords,
                                          long long* dataSize) const {
     _checkMagic();
-    stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-    Map::const_iterator it = _entries.find(uri.toString());
-    if (it == _entries.end()) {
+    const Shard& shard = _shards[_shardIndex(uri)];
+    stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+    Map::const_iterator it = shard.entries.find(uri.toString());
+    if (it == shard.entries.end()) {
         *numRecords = 0;
         *dataSize = 0;
         return;
@@ -201,7 +210,7 @@ void WiredTigerSizeStorer::fillCache() {
     stdx::lock_guard<stdx::mutex> cursorLock(_cursorMutex);
     _checkMagic();
 
-    Map m;
+    std::array<Map, kNumShards> maps;
     {
         // Seek to beginning if needed.
         invariantWTOK(_cursor->reset(_cursor));
@@ -222,7 +231,7 @@ void WiredTigerSizeStorer::fillCache() {
 
             LOG(2) << "WiredTigerSizeStorer::loadFrom " << uriKey << " -> " << redact(data);
 
-            Entry& e = m[uriKey];
+            Entry& e = maps[_shardIndex(uriKey)][uriKey];
             e.numRecords = data["numRecords"].safeNumberLong();
             e.dataSize = data["dataSize"].safeNumberLong();
             e.dirty = false;
@@ -230,8 +239,10 @@ void WiredTigerSizeStorer::fillCache() {
         }
     }
 
-    stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-    _entries.swap(m);
+    for (size_t i = 0; i < kNumShards; ++i) {
+        stdx::lock_guard<stdx::mutex> lk(_shards[i].mutex);
+        _shards[i].entries.swap(maps[i]);
+    }
 }
 
 //ͬwiredtiger  οhttp://www.mongoing.com/archives/5476
@@ -242,9 +253,9 @@ void WiredTigerSizeStorer::syncCache(bool syncToDisk) {
     _checkMagic();
 
     Map myMap;
-    {
-        stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-        for (Map::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+    for (Shard& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+        for (Map::iterator it = shard.entries.begin(); it != shard.entries.end(); ++it) {
             std::string uriKey = it->first;
             Entry& entry = it->second;
             if (entry.rs) {
@@ -298,10 +309,16 @@ void WiredTigerSizeStorer::syncCache(bool syncToDisk) {
     rollbacker.Dismiss();
     invariantWTOK(session->commit_transaction(session, NULL));
 
-    {
-        stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-        for (Map::iterator it = _entries.begin(); it != _entries.end(); ++it) {
-            it->second.dirty = false;
+    // Only clear the entries that were written; one that changed again since it was copied is
+    // picked up by the next sync through its record store or storeToCache().
+    for (Map::iterator it = myMap.begin(); it != myMap.end(); ++it) {
+        Shard& shard = _shards[_shardIndex(it->first)];
+        stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+        Map::iterator current = shard.entries.find(it->first);
+        if (current != shard.entries.end() &&
+            current->second.numRecords == it->second.numRecords &&
+            current->second.dataSize == it->second.dataSize) {
+            current->second.dirty = false;
         }
     }
 }
@@ -31,6 +31,7 @@
 
 #pragma once
 
+#include <array>
 #include <map>
 #include <string>
 #include <wiredtiger.h>
@@ -74,13 +75,16 @@ public:
     void fillCache();
 
     /**
-     * Writes all changes to the underlying table.
+     * Writes all changes to the underlying table. Record stores registered through onCreate() are
+     * read directly, so their inserts and deletes never need to call storeToCache().
      */
     void syncCache(bool syncToDisk);
 
 private:
     void _checkMagic() const;
 
+    static size_t _shardIndex(StringData uri);
+
     struct Entry { //Map _entries;õýṹ
         Entry() : numRecords(0), dataSize(0), dirty(false), rs(NULL) {}
         long long numRecords;
@@ -91,7 +95,7 @@ private:
 
     int _magic;
 
-    // Guards _cursor. Acquire *before* _entriesMutex.
+    // Guards _cursor. Acquire *before* any Shard::mutex.
     mutable stdx::mutex _cursorMutex;
     const WiredTigerSession _session;
     WT_CURSOR* _cursor;  // pointer is const after constructor
@@ -99,7 +103,13 @@ private:
     typedef std::map<std::string, Entry> Map; 
     //_entries mapеڴWiredTigerSizeStorer::syncCacheͬwiredtiger
     //ÿ60ͬһΡdirty entryµwt,ʱʵּ_sizeStorerSyncTracker
-    Map _entries; //WiredTigerSizeStorer._entries[].rs mapм¼еļͳϢ
-    mutable stdx::mutex _entriesMutex;
+    // The entries are spread over shards by uri so that creating, dropping and looking up
+    // collections does not serialize on a single mutex.
+    struct Shard {
+        mutable stdx::mutex mutex;
+        Map entries;
+    };
+    static const size_t kNumShards = 16;
+    std::array<Shard, kNumShards> _shards;
 };
 }
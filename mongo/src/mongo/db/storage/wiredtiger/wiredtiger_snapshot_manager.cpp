@@ -64,6 +64,16 @@ void WiredTigerSnapshotManager::dropAllSnapshots() {
     _committedSnapshot = boost::none;
 }
 
+void WiredTigerSnapshotManager::setLocalSnapshot(const boost::optional<Timestamp>& timestamp) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _localSnapshot = timestamp;
+}
+
+boost::optional<Timestamp> WiredTigerSnapshotManager::getLocalSnapshot() {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    return _localSnapshot;
+}
+
 //WiredTigerSessionCache::shuttingDownе
 void WiredTigerSnapshotManager::shutdown() {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
@@ -107,6 +117,28 @@ Timestamp WiredTigerSnapshotManager::beginTransactionOnCommittedSnapshot(
     return *_committedSnapshot;
 }
 
+boost::optional<Timestamp> WiredTigerSnapshotManager::beginTransactionOnLocalSnapshot(
+    WT_SESSION* session) const {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+
+    // The local snapshot is only cleared once the node stops applying oplog batches, at which point
+    // an untimestamped transaction can no longer observe a partially applied batch.
+    if (!_localSnapshot) {
+        invariantWTOK(session->begin_transaction(session, NULL));
+        return boost::none;
+    }
+
+    auto status = beginTransactionAtTimestamp(*_localSnapshot, session);
+
+    // As with oplog reads, an EINVAL here means the oldest_timestamp raced ahead of the snapshot.
+    // Throw a WriteConflictException so that the read is retried on a newer snapshot.
+    if (status.code() == ErrorCodes::BadValue) {
+        throw WriteConflictException();
+    }
+    fassertStatusOK(50807, status);
+    return *_localSnapshot;
+}
+
 void WiredTigerSnapshotManager::beginTransactionOnOplog(WiredTigerOplogManager* oplogManager,
                                                         WT_SESSION* session) const {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
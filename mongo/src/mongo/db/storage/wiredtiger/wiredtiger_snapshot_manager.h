@@ -60,6 +60,8 @@ public:
     void setCommittedSnapshot(const Timestamp& timestamp) final;
     void cleanupUnneededSnapshots() final;
     void dropAllSnapshots() final;
+    void setLocalSnapshot(const boost::optional<Timestamp>& timestamp) final;
+    boost::optional<Timestamp> getLocalSnapshot() final;
 
     //
     // WT-specific methods
@@ -94,9 +96,16 @@ public:
      */
     boost::optional<Timestamp> getMinSnapshotForNextCommittedRead() const;
 
+    /**
+     * Starts a transaction on the local snapshot and returns the Timestamp used, or starts an
+     * untimestamped transaction and returns boost::none if there is currently no local snapshot.
+     */
+    boost::optional<Timestamp> beginTransactionOnLocalSnapshot(WT_SESSION* session) const;
+
 private:
     mutable stdx::mutex _mutex;  // Guards all members.
     boost::optional<Timestamp> _committedSnapshot;
+    boost::optional<Timestamp> _localSnapshot;
     WT_SESSION* _session;
     WT_CONNECTION* _conn;
 };
@@ -29,6 +29,7 @@
 #include "mongo/platform/basic.h"
 
 #include <memory>
+#include <set>
 #include <sstream>
 #include <string>
 #include <time.h>
@@ -40,6 +41,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context_noop.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/kv/kv_engine_test_harness.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/record_store_test_harness.h"
@@ -51,6 +53,8 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/barrier.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
@@ -296,6 +300,159 @@ TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     rs.reset(NULL);  // this has to be deleted before ss
 }
 
+void setLazyRecordStoreInit(StringData enabled) {
+    auto parameter = ServerParameterSet::getGlobal()->getMap()["wiredTigerLazyRecordStoreInit"];
+    ASSERT(parameter);
+    ASSERT_OK(parameter->setFromString(enabled.toString()));
+}
+
+// A record store opened lazily takes its count from the size storer, and finds the largest RecordId
+// in use on its first insert, once however many inserts race to be first.
+TEST(WiredTigerRecordStoreTest, LazyInitFindsNextRecordIdOnFirstInsert) {
+    setLazyRecordStoreInit("true");
+    ON_BLOCK_EXIT([] { setLazyRecordStoreInit("false"); });
+
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+    string uri = checked_cast<WiredTigerRecordStore*>(rs.get())->getURI();
+
+    WiredTigerSizeStorer ss(harnessHelper->conn(), "table:myindex", false);
+    checked_cast<WiredTigerRecordStore*>(rs.get())->setSizeStorer(&ss);
+
+    const int N = 12;
+    RecordId highestId;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < N; i++) {
+            StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "a", 2, Timestamp(), false);
+            ASSERT_OK(res.getStatus());
+            highestId = std::max(highestId, res.getValue());
+        }
+        uow.commit();
+    }
+
+    // Reopens the record store, as startup does after a restart.
+    auto reopen = [&] {
+        rs.reset(NULL);
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WiredTigerRecordStore::Params params;
+        params.ns = "a.b"_sd;
+        params.uri = uri;
+        params.engineName = kWiredTigerEngineName;
+        params.isCapped = false;
+        params.isEphemeral = false;
+        params.cappedMaxSize = -1;
+        params.cappedMaxDocs = -1;
+        params.cappedCallback = nullptr;
+        params.sizeStorer = &ss;
+
+        auto ret = new StandardWiredTigerRecordStore(nullptr, opCtx.get(), params);
+        ret->postConstructorInit(opCtx.get());
+        rs.reset(ret);
+    };
+
+    reopen();
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(N, rs->numRecords(opCtx.get()));
+
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "a", 2, Timestamp(), false);
+        ASSERT_OK(res.getStatus());
+        ASSERT_EQUALS(RecordId(highestId.repr() + 1), res.getValue());
+        highestId = res.getValue();
+        uow.commit();
+    }
+
+    reopen();
+    const size_t nInserters = 8;
+    unittest::Barrier barrier(nInserters);
+    std::vector<RecordId> insertedIds(nInserters);
+    std::vector<Status> statuses(nInserters, Status::OK());
+    std::vector<stdx::thread> inserters;
+    for (size_t i = 0; i < nInserters; i++) {
+        inserters.emplace_back([&, i] {
+            auto client = harnessHelper->serviceContext()->makeClient("inserter");
+            ServiceContext::UniqueOperationContext opCtx(
+                harnessHelper->newOperationContext(client.get()));
+            WriteUnitOfWork uow(opCtx.get());
+            barrier.countDownAndWait();
+            StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "a", 2, Timestamp(), false);
+            statuses[i] = res.getStatus();
+            if (res.isOK()) {
+                insertedIds[i] = res.getValue();
+                uow.commit();
+            }
+        });
+    }
+    for (auto&& inserter : inserters) {
+        inserter.join();
+    }
+
+    std::set<RecordId> distinctIds;
+    for (size_t i = 0; i < nInserters; i++) {
+        ASSERT_OK(statuses[i]);
+        ASSERT_GT(insertedIds[i], highestId);
+        distinctIds.insert(insertedIds[i]);
+    }
+    ASSERT_EQUALS(nInserters, distinctIds.size());
+    ASSERT_EQUALS(RecordId(highestId.repr() + static_cast<long long>(nInserters)),
+                  *distinctIds.rbegin());
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(N + 1 + static_cast<long long>(nInserters), rs->numRecords(opCtx.get()));
+    }
+
+    rs.reset(NULL);  // this has to be deleted before ss
+}
+
+// Inserts into a registered record store never touch the size storer; syncCache() reads the record
+// store's counters and persists them.
+TEST(WiredTigerRecordStoreTest, SizeStorerSyncReadsRegisteredRecordStores) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+    WiredTigerRecordStore* wtrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+    string uri = wtrs->getURI();
+
+    string sizeStorerUri = "table:sizeStorer";
+    const bool enableWtLogging = false;
+    WiredTigerSizeStorer ss(harnessHelper->conn(), sizeStorerUri, enableWtLogging);
+    wtrs->setSizeStorer(&ss);
+    ss.onCreate(wtrs, 0, 0);
+
+    int N = 1500;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < N; i++) {
+            ASSERT_OK(rs->insertRecord(opCtx.get(), "a", 2, Timestamp(), false).getStatus());
+        }
+        uow.commit();
+    }
+
+    {
+        long long numRecords;
+        long long dataSize;
+        ss.loadFromCache(uri, &numRecords, &dataSize);
+        ASSERT_EQUALS(0, numRecords);
+    }
+
+    ss.syncCache(true);
+
+    {
+        WiredTigerSizeStorer ss2(harnessHelper->conn(), sizeStorerUri, enableWtLogging);
+        ss2.fillCache();
+        long long numRecords;
+        long long dataSize;
+        ss2.loadFromCache(uri, &numRecords, &dataSize);
+        ASSERT_EQUALS(N, numRecords);
+        ASSERT_EQUALS(N * 2, dataSize);
+    }
+
+    rs.reset(NULL);  // this has to be deleted before ss
+}
+
 class GoodValidateAdaptor : public ValidateAdaptor {
 public:
     virtual Status validate(const RecordId& recordId, const RecordData& record, size_t* dataSize) {
@@ -39,6 +39,7 @@
 
 #include "mongo/base/simple_string_data_comparator.h"
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/catalog/collection.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
@@ -443,6 +444,46 @@ int WiredTigerUtil::verifyTable(OperationContext* opCtx,
     return (session->verify)(session, uri.c_str(), NULL);
 }
 
+Status WiredTigerUtil::compact(OperationContext* opCtx,
+                               const std::string& uri,
+                               const CompactOptions* options) {
+    WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
+    if (cache->isEphemeral()) {
+        return Status::OK();
+    }
+
+    WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+    opCtx->recoveryUnit()->abandonSnapshot();
+
+    if (!options || !options->online) {
+        invariantWTOK(s->compact(s, uri.c_str(), "timeout=0"));
+        return Status::OK();
+    }
+
+    const std::string config = str::stream() << "timeout=" << options->onlineSliceSecs;
+    long long slices = 0;
+    while (true) {
+        ++slices;
+        int ret = s->compact(s, uri.c_str(), config.c_str());
+        if (ret == 0) {
+            LOG(1) << "online compaction of " << uri << " finished after " << slices
+                   << " slice(s)";
+            return Status::OK();
+        }
+        // ETIMEDOUT means the slice ran out of time; EBUSY that a checkpoint got in the way.
+        // Either way the blocks moved so far stay moved, so just pick up again after the pause.
+        if (ret != ETIMEDOUT && ret != EBUSY) {
+            return wtRCToStatus(ret);
+        }
+
+        opCtx->sleepFor(Milliseconds(options->onlinePauseMillis));
+        Status interrupted = opCtx->checkForInterruptNoAssert();
+        if (!interrupted.isOK()) {
+            return interrupted;
+        }
+    }
+}
+
 bool WiredTigerUtil::useTableLogging(NamespaceString ns, bool replEnabled) {
     if (!replEnabled) {
         // All tables on standalones are logged.
@@ -497,6 +538,29 @@ Status WiredTigerUtil::setTableLogging(WT_SESSION* session, const std::string& u
     return Status::OK();
 }
 
+Status WiredTigerUtil::setCacheResident(OperationContext* opCtx,
+                                        const std::string& uri,
+                                        bool resident) {
+    // Altering an object requires exclusive access to it, so close as much as possible first.
+    WiredTigerRecoveryUnit::get(opCtx)->getSession()->closeAllCursors(uri);
+    WiredTigerSessionCache* sessionCache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
+    sessionCache->closeAllCursors(uri);
+
+    // Use a new session so as not to interfere with the operation's transaction.
+    WiredTigerSession session(sessionCache->conn());
+    WT_SESSION* s = session.getSession();
+    const std::string config = str::stream() << "cache_resident=" << (resident ? "true" : "false");
+
+    LOG(1) << "Altering " << uri << " to " << config;
+    int ret = s->alter(s, uri.c_str(), config.c_str());
+    if (ret == EBUSY) {
+        return Status(ErrorCodes::ConflictingOperationInProgress,
+                      str::stream() << "Could not set " << config << " on " << uri
+                                    << " as it is in use by other operations; try again later.");
+    }
+    return wtRCToStatus(ret);
+}
+
 Status WiredTigerUtil::exportTableToBSON(WT_SESSION* session,
                                          const std::string& uri,
                                          const std::string& config,
@@ -43,6 +43,7 @@
 namespace mongo {
 
 class BSONObjBuilder;
+struct CompactOptions;
 class OperationContext;
 class WiredTigerConfigParser;
 
@@ -219,12 +220,30 @@ public:
                            const std::string& uri,
                            std::vector<std::string>* errors = NULL);
 
+    /**
+     * Runs WT_SESSION::compact() on 'uri'. For online compaction ('options' non-NULL with 'online'
+     * set) the work is done in calls bounded by options->onlineSliceSecs, sleeping
+     * options->onlinePauseMillis between them and checking for interrupt, so that compacting a
+     * large table does not monopolize the disk. Each call keeps the space the previous ones
+     * reclaimed.
+     */
+    static Status compact(OperationContext* opCtx,
+                          const std::string& uri,
+                          const CompactOptions* options);
+
     static bool useTableLogging(NamespaceString ns, bool replEnabled);
 
     static Status setTableLogging(OperationContext* opCtx, const std::string& uri, bool on);
 
     static Status setTableLogging(WT_SESSION* session, const std::string& uri, bool on);
 
+    /**
+     * Sets the 'cache_resident' configuration of the table or file at 'uri', which stops its
+     * pages from being evicted once read. Closes cached cursors on 'uri' first, but
+     * returns ErrorCodes::ConflictingOperationInProgress if the object is still in use elsewhere.
+     */
+    static Status setCacheResident(OperationContext* opCtx, const std::string& uri, bool resident);
+
 private:
     /**
      * Casts unsigned 64-bit statistics value to T.
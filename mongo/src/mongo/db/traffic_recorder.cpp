@@ -0,0 +1,366 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/traffic_recorder.h"
+
+#include <boost/filesystem/path.hpp>
+#include <deque>
+#include <fstream>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/log.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+namespace {
+
+// Directory recordings are written to. Recording is disabled unless it is set.
+std::string trafficRecordingDirectory;
+ExportedServerParameter<std::string, ServerParameterType::kStartupOnly>
+    trafficRecordingDirectorySetting(ServerParameterSet::getGlobal(),
+                                     "trafficRecordingDirectory",
+                                     &trafficRecordingDirectory);
+
+const auto getTrafficRecorder = ServiceContext::declareDecoration<TrafficRecorder>();
+
+// Version of the mongoreplay playback file format written.
+const int kPlaybackFileVersion = 1;
+
+// mongoreplay stores times as seconds since January 1 of year 1, which is this many seconds before
+// the Unix epoch.
+const long long kUnixToInternalSecs = (1969LL * 365 + 1969 / 4 - 1969 / 100 + 1969 / 400) * 86400;
+
+}  // namespace
+
+class TrafficRecorder::Recording {
+public:
+    Recording(const Options& options, std::string path, AtomicBool* shouldRecord)
+        : _options(options), _path(std::move(path)), _shouldRecord(shouldRecord) {}
+
+    /**
+     * Creates the file, writes the playback file header and starts the writer thread.
+     */
+    Status open() {
+        _out.open(_path, std::ios::binary | std::ios::trunc);
+        if (!_out) {
+            return {ErrorCodes::FileOpenFailed,
+                    str::stream() << "Could not create traffic recording file " << _path};
+        }
+
+        // The field names are those mongoreplay's BSON library derives from its struct members.
+        BSONObj metadata =
+            BSON("playbackfileversion" << kPlaybackFileVersion << "driveropsfiltered" << false);
+        _out.write(metadata.objdata(), metadata.objsize());
+        _written = metadata.objsize();
+
+        _thread = stdx::thread([this] { _run(); });
+        return Status::OK();
+    }
+
+    /**
+     * Queues 'op' for writing, unless the buffer is full or the recording has stopped.
+     */
+    void push(BSONObj op) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_done || _queuedBytes + op.objsize() > _options.bufferSize) {
+            ++_dropped;
+            return;
+        }
+        _queuedBytes += op.objsize();
+        _queue.push_back(std::move(op));
+        _queueNotEmpty.notify_one();
+    }
+
+    /**
+     * Writes out whatever is queued and waits for the writer thread to exit. Returns false if the
+     * recording was already finished by an earlier call.
+     */
+    bool finish() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_finishing) {
+                return false;
+            }
+            _finishing = true;
+            _queueNotEmpty.notify_one();
+        }
+        _thread.join();
+        return true;
+    }
+
+    long long nextOrder() {
+        return _order.fetchAndAdd(1);
+    }
+
+    void report(BSONObjBuilder* builder) const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        builder->append("file", _path);
+        builder->append("running", !_done);
+        builder->appendNumber("bufferedBytes", _queuedBytes);
+        builder->appendNumber("writtenBytes", _written);
+        builder->appendNumber("recordedMessages", _recorded);
+        builder->appendNumber("droppedMessages", _dropped);
+        if (!_error.empty()) {
+            builder->append("error", _error);
+        }
+    }
+
+private:
+    void _run() {
+        std::deque<BSONObj> batch;
+        while (true) {
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                _queueNotEmpty.wait(lk, [&] { return !_queue.empty() || _finishing; });
+                if (_queue.empty()) {
+                    _done = true;
+                    break;
+                }
+                batch.swap(_queue);
+                _queuedBytes = 0;
+            }
+
+            std::string error;
+            size_t numWritten = 0;
+            for (auto&& op : batch) {
+                if (_written + op.objsize() > _options.maxFileSize) {
+                    error = "the file reached its size limit";
+                    break;
+                }
+                _out.write(op.objdata(), op.objsize());
+                _written += op.objsize();
+                ++numWritten;
+            }
+            _out.flush();
+            if (error.empty() && !_out) {
+                error = "writing to the file failed";
+            }
+            batch.clear();
+
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _recorded += numWritten;
+            if (!error.empty()) {
+                log() << "Stopped recording traffic to " << _path << " because " << error;
+                _error = std::move(error);
+                _dropped += _queue.size();
+                _queue.clear();
+                _queuedBytes = 0;
+                _done = true;
+                _shouldRecord->store(false);
+                break;
+            }
+        }
+        _out.close();
+    }
+
+    const Options _options;
+    const std::string _path;
+    AtomicBool* const _shouldRecord;
+
+    AtomicWord<long long> _order{0};
+
+    // Only used by the writer thread, once it is started.
+    std::ofstream _out;
+
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _queueNotEmpty;
+    std::deque<BSONObj> _queue;
+    long long _queuedBytes = 0;
+    long long _written = 0;
+    long long _recorded = 0;
+    long long _dropped = 0;
+    bool _finishing = false;
+    bool _done = false;
+    std::string _error;
+
+    stdx::thread _thread;
+};
+
+TrafficRecorder& TrafficRecorder::get(ServiceContext* serviceContext) {
+    return getTrafficRecorder(serviceContext);
+}
+
+TrafficRecorder::TrafficRecorder() = default;
+
+TrafficRecorder::~TrafficRecorder() {
+    if (_recording) {
+        _recording->finish();
+    }
+}
+
+Status TrafficRecorder::start(const Options& options) {
+    if (trafficRecordingDirectory.empty()) {
+        return {ErrorCodes::IllegalOperation,
+                "Traffic recording is disabled, set trafficRecordingDirectory to enable it"};
+    }
+    if (options.filename.empty() || options.filename == "." || options.filename == ".." ||
+        options.filename.find_first_of("/\\") != std::string::npos) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Invalid traffic recording file name: " << options.filename};
+    }
+    if (options.bufferSize <= 0 || options.maxFileSize <= 0) {
+        return {ErrorCodes::BadValue, "bufferSize and maxFileSize have to be positive"};
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_shouldRecord.load()) {
+        return {ErrorCodes::BadValue, "Traffic is already being recorded"};
+    }
+    if (_recording) {
+        // A recording which stopped by itself still has to be cleaned up.
+        _recording->finish();
+    }
+
+    const auto path = boost::filesystem::path(trafficRecordingDirectory) / options.filename;
+    auto recording = std::make_shared<Recording>(options, path.string(), &_shouldRecord);
+    Status status = recording->open();
+    if (!status.isOK()) {
+        return status;
+    }
+
+    log() << "Started recording traffic to " << path.string();
+    _recording = std::move(recording);
+    _shouldRecord.store(true);
+    return Status::OK();
+}
+
+Status TrafficRecorder::stop() {
+    std::shared_ptr<Recording> recording;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _shouldRecord.store(false);
+        recording = _recording;
+    }
+
+    // Threads recording a message keep their own reference, so finishing only has to wait for the
+    // writer. A recording which stopped by itself is finished here too.
+    if (!recording || !recording->finish()) {
+        return {ErrorCodes::BadValue, "Traffic is not being recorded"};
+    }
+    log() << "Stopped recording traffic";
+    return Status::OK();
+}
+
+void TrafficRecorder::observe(const transport::SessionHandle& session,
+                              const Message& message,
+                              bool isReply) {
+    if (!_shouldRecord.load()) {
+        return;
+    }
+    _record(session, &message, isReply);
+}
+
+void TrafficRecorder::observeEnd(const transport::SessionHandle& session) {
+    if (!_shouldRecord.load()) {
+        return;
+    }
+    _record(session, nullptr, false);
+}
+
+void TrafficRecorder::report(BSONObjBuilder* builder) const {
+    std::shared_ptr<Recording> recording;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        recording = _recording;
+    }
+    builder->append("enabled", !trafficRecordingDirectory.empty());
+    if (recording) {
+        recording->report(builder);
+    }
+}
+
+void TrafficRecorder::_record(const transport::SessionHandle& session,
+                              const Message* message,
+                              bool isReply) {
+    std::shared_ptr<Recording> recording;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        recording = _recording;
+    }
+    if (!recording) {
+        return;
+    }
+
+    const unsigned long long nowMicros = curTimeMicros64();
+    const std::string client = session->remote().toString();
+    const std::string server = session->local().toString();
+
+    // Lays out a RecordedOp of mongoreplay, whose body is the complete message.
+    BSONObjBuilder builder;
+    {
+        BSONObjBuilder rawOp(builder.subobjStart("rawop"));
+        BSONObjBuilder header(rawOp.subobjStart("header"));
+        if (message) {
+            header.append("messagelength", message->header().getLen());
+            header.append("requestid", message->header().getId());
+            header.append("responseto", message->header().getResponseToMsgId());
+            header.append("opcode", static_cast<int>(message->header().getNetworkOp()));
+        } else {
+            header.append("messagelength", 0);
+            header.append("requestid", 0);
+            header.append("responseto", 0);
+            header.append("opcode", 0);
+        }
+        header.doneFast();
+        if (message) {
+            rawOp.appendBinData("body", message->size(), BinDataGeneral, message->buf());
+        } else {
+            rawOp.appendBinData("body", 0, BinDataGeneral, "");
+        }
+        rawOp.doneFast();
+    }
+    {
+        BSONObjBuilder seen(builder.subobjStart("seen"));
+        seen.append("sec", static_cast<long long>(nowMicros / 1000000) + kUnixToInternalSecs);
+        seen.append("nsec", static_cast<int>(nowMicros % 1000000) * 1000);
+        seen.doneFast();
+    }
+    if (!message) {
+        builder.append("eof", true);
+    }
+    builder.append("srcendpoint", isReply ? server : client);
+    builder.append("dstendpoint", isReply ? client : server);
+    builder.append("seenconnectionnum", static_cast<long long>(session->id()));
+    builder.append("playedconnectionnum", 0LL);
+    builder.append("generation", 0);
+    builder.append("order", recording->nextOrder());
+
+    recording->push(builder.obj());
+}
+
+}  // namespace mongo
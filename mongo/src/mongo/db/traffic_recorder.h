@@ -0,0 +1,118 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/transport/session.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class Message;
+class ServiceContext;
+
+/**
+ * Records the messages exchanged with clients, and when they were seen, so that a production
+ * workload can be replayed against another deployment. Recordings are written in the playback
+ * file format of mongoreplay, so "mongoreplay play" replays them directly: it keeps the recorded
+ * spacing between operations and the concurrency of the recorded connections, and pairs each reply
+ * with its request to map the cursor ids of the recording to the ones of the replay.
+ *
+ * Messages are handed to a background thread through a buffer bounded in bytes, so recording
+ * never blocks a client. Messages which don't fit are dropped and counted. Recording stops by
+ * itself once the file reaches its size limit.
+ */
+class TrafficRecorder {
+    MONGO_DISALLOW_COPYING(TrafficRecorder);
+
+public:
+    struct Options {
+        // Name of the file to create in the trafficRecordingDirectory.
+        std::string filename;
+
+        // Bytes of messages which may wait to be written before further messages are dropped.
+        long long bufferSize = 128 * 1024 * 1024;
+
+        // Size of the file after which recording stops.
+        long long maxFileSize = 10LL * 1024 * 1024 * 1024;
+    };
+
+    static TrafficRecorder& get(ServiceContext* serviceContext);
+
+    TrafficRecorder();
+    ~TrafficRecorder();
+
+    /**
+     * Starts recording to a new file. Fails if a recording is running, recording isn't enabled by
+     * the trafficRecordingDirectory server parameter, or the file can't be created.
+     */
+    Status start(const Options& options);
+
+    /**
+     * Stops the running recording once everything buffered is written. Fails if none is running.
+     */
+    Status stop();
+
+    /**
+     * Records 'message', which was received from or is being sent to the client of 'session'.
+     * Requests must be observed after any decompression, and replies once their header is final.
+     */
+    void observe(const transport::SessionHandle& session, const Message& message, bool isReply);
+
+    /**
+     * Records that the client of 'session' disconnected, so that replay closes its connection.
+     */
+    void observeEnd(const transport::SessionHandle& session);
+
+    /**
+     * Appends the state of the current or most recent recording.
+     */
+    void report(BSONObjBuilder* builder) const;
+
+private:
+    class Recording;
+
+    void _record(const transport::SessionHandle& session,
+                 const Message* message,
+                 bool isReply);
+
+    // Whether messages should be recorded, checked without a lock for every message.
+    AtomicBool _shouldRecord{false};
+
+    mutable stdx::mutex _mutex;
+    std::shared_ptr<Recording> _recording;
+};
+
+}  // namespace mongo
@@ -59,6 +59,7 @@
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -72,6 +73,11 @@ ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocume
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorEnabled, bool, true);
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorSleepSecs, int, 60);  // used for testing
 
+// When positive, each TTL index is processed in batches of at most this many deletes, with the
+// locks released and a pause between batches so that no more than this many documents are deleted
+// per second. Zero deletes all expired documents of an index in a single pass.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorMaxDeletesPerSecond, int, 0);
+
 class TTLMonitor : public BackgroundJob {
 public:
     TTLMonitor() {}
@@ -169,22 +175,46 @@ private:
      * Remove documents from the collection using the specified TTL index after a sufficient amount
      * of time has passed according to its expiry specification.
      */
-    void doTTLForIndex(OperationContext* opCtx, BSONObj idx) {
+    void doTTLForIndex(OperationContext* opCtx, const BSONObj& idx) {
+        const long long maxDeletesPerSecond = ttlMonitorMaxDeletesPerSecond.load();
+        if (maxDeletesPerSecond <= 0) {
+            deleteExpiredDocuments(opCtx, idx, 0);
+            return;
+        }
+
+        while (true) {
+            Timer timer;
+            if (deleteExpiredDocuments(opCtx, idx, maxDeletesPerSecond) < maxDeletesPerSecond) {
+                return;
+            }
+
+            const Milliseconds elapsed(timer.millis());
+            if (elapsed < Seconds(1)) {
+                opCtx->sleepFor(Seconds(1) - elapsed);
+            }
+        }
+    }
+
+    /**
+     * Deletes the documents that have expired according to the TTL index 'idx', stopping after
+     * 'maxToDelete' documents when it is positive. Returns the number of documents deleted.
+     */
+    long long deleteExpiredDocuments(OperationContext* opCtx, BSONObj idx, long long maxToDelete) {
         const NamespaceString collectionNSS(idx["ns"].String());
         if (collectionNSS.isDropPendingNamespace()) {
-            return;
+            return 0;
         }
         if (!userAllowedWriteNS(collectionNSS).isOK()) {
             error() << "namespace '" << collectionNSS
                     << "' doesn't allow deletes, skipping ttl job for: " << idx;
-            return;
+            return 0;
         }
 
         const BSONObj key = idx["key"].Obj();
         const StringData name = idx["name"].valueStringData();
         if (key.nFields() != 1) {
             error() << "key for ttl index can only have 1 field, skipping ttl job for: " << idx;
-            return;
+            return 0;
         }
 
         LOG(1) << "ns: " << collectionNSS << " key: " << key << " name: " << name;
@@ -193,18 +223,18 @@ private:
         Collection* collection = autoGetCollection.getCollection();
         if (!collection) {
             // Collection was dropped.
-            return;
+            return 0;
         }
 
         if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(opCtx, collectionNSS)) {
-            return;
+            return 0;
         }
 
         IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(opCtx, name);
         if (!desc) {
             LOG(1) << "index not found (index build in progress? index dropped?), skipping "
                    << "ttl job for: " << idx;
-            return;
+            return 0;
         }
 
         // Re-read 'idx' from the descriptor, in case the collection or index definition changed
@@ -213,7 +243,7 @@ private:
 
         if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
             error() << "special index can't be used as a ttl index, skipping ttl job for: " << idx;
-            return;
+            return 0;
         }
 
         BSONElement secondsExpireElt = idx[secondsExpireField];
@@ -221,7 +251,7 @@ private:
             error() << "ttl indexes require the " << secondsExpireField << " field to be "
                     << "numeric but received a type of " << typeName(secondsExpireElt.type())
                     << ", skipping ttl job for: " << idx;
-            return;
+            return 0;
         }
 
         const Date_t kDawnOfTime =
@@ -248,6 +278,7 @@ private:
 
         DeleteStageParams params;
         params.isMulti = true;
+        params.maxDocsToDelete = maxToDelete;
         params.canonicalQuery = canonicalQuery.getValue().get();
 
         auto exec =
@@ -265,12 +296,13 @@ private:
         if (!result.isOK()) {
             error() << "ttl query execution for index " << idx
                     << " failed with status: " << redact(result);
-            return;
+            return 0;
         }
 
         const long long numDeleted = DeleteStage::getNumDeleted(*exec);
         ttlDeletedDocuments.increment(numDeleted);
         LOG(1) << "deleted: " << numDeleted;
+        return numDeleted;
     }
 };
 
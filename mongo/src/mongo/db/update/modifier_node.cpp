@@ -30,9 +30,14 @@
 
 #include "mongo/db/update/modifier_node.h"
 
+#include <utility>
+#include <vector>
+
 #include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/update/log_builder.h"
 #include "mongo/db/update/path_support.h"
 #include "mongo/db/update/storage_validation.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -143,6 +148,45 @@ void checkImmutablePathsNotModified(mutablebson::Element element,
     }
 }
 
+/**
+ * Logs an update that turned 'originalArray' into 'updatedArray' as $set entries on the individual
+ * indexes that differ, which keeps the oplog entry small when a large array barely changes. Returns
+ * false without logging anything when the array shrank or when most of its entries changed, in
+ * which case the caller should log the whole array instead. Elements that no longer have their
+ * original serialized value are conservatively treated as changed.
+ */
+bool logArrayDiff(LogBuilder* logBuilder,
+                  StringData pathTaken,
+                  mutablebson::Element updatedArray,
+                  const BSONObj& originalArray) {
+    if (updatedArray.getType() != BSONType::Array) {
+        return false;
+    }
+
+    std::vector<std::pair<size_t, mutablebson::Element>> changed;
+    BSONObjIterator originalIt(originalArray);
+    size_t index = 0;
+    for (auto child = updatedArray.leftChild(); child.ok(); child = child.rightSibling(), ++index) {
+        BSONElement original = originalIt.more() ? originalIt.next() : BSONElement();
+        if (!original.eoo() && child.hasValue() && child.getValue().binaryEqualValues(original)) {
+            continue;
+        }
+        changed.emplace_back(index, child);
+    }
+
+    // There is no $set that removes trailing array entries, and a diff touching half or more of the
+    // array saves little over logging it whole.
+    if (originalIt.more() || changed.empty() || changed.size() * 2 >= index) {
+        return false;
+    }
+
+    for (auto&& entry : changed) {
+        std::string pathToArrayElement(str::stream() << pathTaken << "." << entry.first);
+        uassertStatusOK(logBuilder->addToSetsWithNewFieldName(pathToArrayElement, entry.second));
+    }
+    return true;
+}
+
 }  // namespace
 
 UpdateNode::ApplyResult ModifierNode::applyToExistingElement(ApplyParams applyParams) const {
@@ -165,6 +209,13 @@ UpdateNode::ApplyResult ModifierNode::applyToExistingElement(ApplyParams applyPa
         }
     }
 
+    // Keep a copy of an array we are about to modify, so that the update can be logged as a diff.
+    BSONObj originalArray;
+    if (applyParams.logBuilder && canLogArrayDiff() &&
+        applyParams.element.getType() == BSONType::Array && applyParams.element.hasValue()) {
+        originalArray = applyParams.element.getValue().embeddedObject().getOwned();
+    }
+
     // We have two different ways of checking for changes to immutable paths, depending on the style
     // of update. See the comments above checkImmutablePathsNotModifiedFromOriginal() and
     // checkImmutablePathsNotModified().
@@ -192,6 +243,8 @@ UpdateNode::ApplyResult ModifierNode::applyToExistingElement(ApplyParams applyPa
     if (!applyParams.indexData ||
         !applyParams.indexData->mightBeIndexed(applyParams.pathTaken->dottedField())) {
         applyResult.indexesAffected = false;
+    } else if (applyParams.modifiedIndexedPaths) {
+        applyParams.modifiedIndexedPaths->addPath(applyParams.pathTaken->dottedField());
     }
 
     if (applyParams.validateForStorage) {
@@ -201,10 +254,18 @@ UpdateNode::ApplyResult ModifierNode::applyToExistingElement(ApplyParams applyPa
     }
 
     if (applyParams.logBuilder) {
-        logUpdate(applyParams.logBuilder,
-                  applyParams.pathTaken->dottedField(),
-                  applyParams.element,
-                  updateResult);
+        const bool loggedDiff = updateResult == ModifyResult::kNormalUpdate &&
+            !originalArray.isEmpty() &&
+            logArrayDiff(applyParams.logBuilder,
+                         applyParams.pathTaken->dottedField(),
+                         applyParams.element,
+                         originalArray);
+        if (!loggedDiff) {
+            logUpdate(applyParams.logBuilder,
+                      applyParams.pathTaken->dottedField(),
+                      applyParams.element,
+                      updateResult);
+        }
     }
 
     return applyResult;
@@ -286,11 +347,13 @@ UpdateNode::ApplyResult ModifierNode::applyToNonexistentElement(ApplyParams appl
         // an index {"a.b": 1}, and we set "a.1.c" and implicitly create an array element in "a",
         // then we may need to add a null key to the index, even though "a.1.c" does not appear to
         // affect the index.
-        if (!applyParams.indexData ||
-            !applyParams.indexData->mightBeIndexed(applyParams.element.getType() != BSONType::Array
-                                                       ? fullPath
-                                                       : applyParams.pathTaken->dottedField())) {
+        const auto pathForIndexCheck = applyParams.element.getType() != BSONType::Array
+            ? StringData(fullPath)
+            : applyParams.pathTaken->dottedField();
+        if (!applyParams.indexData || !applyParams.indexData->mightBeIndexed(pathForIndexCheck)) {
             applyResult.indexesAffected = false;
+        } else if (applyParams.modifiedIndexedPaths) {
+            applyParams.modifiedIndexedPaths->addPath(pathForIndexCheck);
         }
 
         if (applyParams.logBuilder) {
@@ -167,6 +167,17 @@ protected:
         return false;
     }
 
+    /**
+     * When updateExistingElement() returns ModifyResult::kNormalUpdate for an element that was and
+     * still is an array, ModifierNode::apply() may log $set entries for just the array indexes that
+     * changed rather than calling logUpdate() with the entire array. Child classes whose
+     * logUpdate() writes the updated element with a $set for kNormalUpdate results can override
+     * this method to return true to opt in.
+     */
+    virtual bool canLogArrayDiff() const {
+        return false;
+    }
+
 private:
     ApplyResult applyToNonexistentElement(ApplyParams applyParams) const;
     ApplyResult applyToExistingElement(ApplyParams applyParams) const;
@@ -151,6 +151,11 @@ UpdateNode::ApplyResult ObjectReplaceNode::apply(ApplyParams applyParams) const
         }
     }
 
+    // A replacement can change any indexed path.
+    if (applyParams.modifiedIndexedPaths) {
+        applyParams.modifiedIndexedPaths->allPathsIndexed();
+    }
+
     return ApplyResult();
 }
 
@@ -69,6 +69,10 @@ protected:
         return true;
     }
 
+    bool canLogArrayDiff() const final {
+        return true;
+    }
+
 
 private:
     // A helper for performPush().
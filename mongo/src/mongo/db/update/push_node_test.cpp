@@ -984,5 +984,50 @@ TEST_F(PushNodeTest, ApplyMultipleElementsPushWithNegativePosition) {
     ASSERT_EQUALS(fromjson("{$set: {a: [0, 1, 2, 5, 6, 7, 3, 4]}}"), getLogDoc());
 }
 
+TEST_F(PushNodeTest, ApplyWithSortLogsOnlyChangedArrayEntries) {
+    auto update = fromjson("{$push: {a: {$each: [10], $sort: 1}}}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    PushNode node;
+    ASSERT_OK(node.init(update["$push"]["a"], expCtx));
+
+    mutablebson::Document doc(fromjson("{a: [0, 1, 2, 3, 4, 5, 6, 7]}"));
+    setPathTaken("a");
+    auto result = node.apply(getApplyParams(doc.root()["a"]));
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{a: [0, 1, 2, 3, 4, 5, 6, 7, 10]}"), doc);
+    ASSERT_FALSE(doc.isInPlaceModeEnabled());
+    ASSERT_EQUALS(fromjson("{$set: {'a.8': 10}}"), getLogDoc());
+}
+
+TEST_F(PushNodeTest, ApplyWithPositionNearEndLogsOnlyChangedArrayEntries) {
+    auto update = fromjson("{$push: {a: {$each: [8], $position: 7}}}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    PushNode node;
+    ASSERT_OK(node.init(update["$push"]["a"], expCtx));
+
+    mutablebson::Document doc(fromjson("{a: [0, 1, 2, 3, 4, 5, 6, 7]}"));
+    setPathTaken("a");
+    auto result = node.apply(getApplyParams(doc.root()["a"]));
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{a: [0, 1, 2, 3, 4, 5, 6, 8, 7]}"), doc);
+    ASSERT_FALSE(doc.isInPlaceModeEnabled());
+    ASSERT_EQUALS(fromjson("{$set: {'a.7': 8, 'a.8': 7}}"), getLogDoc());
+}
+
+TEST_F(PushNodeTest, ApplyWithSliceThatShrinksArrayLogsWholeArray) {
+    auto update = fromjson("{$push: {a: {$each: [9], $slice: -8}}}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    PushNode node;
+    ASSERT_OK(node.init(update["$push"]["a"], expCtx));
+
+    mutablebson::Document doc(fromjson("{a: [0, 1, 2, 3, 4, 5, 6, 7, 8]}"));
+    setPathTaken("a");
+    auto result = node.apply(getApplyParams(doc.root()["a"]));
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{a: [2, 3, 4, 5, 6, 7, 8, 9]}"), doc);
+    ASSERT_FALSE(doc.isInPlaceModeEnabled());
+    ASSERT_EQUALS(fromjson("{$set: {a: [2, 3, 4, 5, 6, 7, 8, 9]}}"), getLogDoc());
+}
+
 }  // namespace
 }  // namespace mongo
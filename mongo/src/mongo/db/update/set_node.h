@@ -57,6 +57,10 @@ protected:
         return true;
     }
 
+    bool canLogArrayDiff() const final {
+        return true;
+    }
+
     bool canSetObjectValue() const final {
         return true;
     }
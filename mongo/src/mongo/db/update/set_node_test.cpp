@@ -1368,6 +1368,68 @@ TEST_F(SetNodeTest, ApplySetOnInsertIsAppliedWhenInsertIsTrue) {
     ASSERT_FALSE(doc.isInPlaceModeEnabled());
 }
 
+TEST_F(SetNodeTest, ApplyRecordsModifiedIndexedPath) {
+    auto update = fromjson("{$set: {'a.c': 1}}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    SetNode node;
+    ASSERT_OK(node.init(update["$set"]["a.c"], expCtx));
+
+    mutablebson::Document doc(fromjson("{a: {c: 0}, b: 0}"));
+    setPathTaken("a.c");
+    addIndexedPath("a");
+    addIndexedPath("b");
+    auto result = node.apply(getApplyParams(doc.root()["a"]["c"]));
+    ASSERT_FALSE(result.noop);
+    ASSERT_TRUE(result.indexesAffected);
+    ASSERT_TRUE(getModifiedIndexedPaths().mightBeIndexed("a"));
+    ASSERT_TRUE(getModifiedIndexedPaths().mightBeIndexed("a.c.d"));
+    ASSERT_FALSE(getModifiedIndexedPaths().mightBeIndexed("b"));
+}
+
+TEST_F(SetNodeTest, ApplyDoesNotRecordUnindexedPath) {
+    auto update = fromjson("{$set: {c: 1}}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    SetNode node;
+    ASSERT_OK(node.init(update["$set"]["c"], expCtx));
+
+    mutablebson::Document doc(fromjson("{a: 0, c: 0}"));
+    setPathTaken("c");
+    addIndexedPath("a");
+    auto result = node.apply(getApplyParams(doc.root()["c"]));
+    ASSERT_FALSE(result.noop);
+    ASSERT_FALSE(result.indexesAffected);
+    ASSERT_FALSE(getModifiedIndexedPaths().mightBeIndexed("a"));
+    ASSERT_FALSE(getModifiedIndexedPaths().mightBeIndexed("c"));
+}
+
+TEST_F(SetNodeTest, ApplyArrayLogsOnlyChangedEntries) {
+    auto update = fromjson("{$set: {a: [0, 1, 5, 3, 4]}}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    SetNode node;
+    ASSERT_OK(node.init(update["$set"]["a"], expCtx));
+
+    mutablebson::Document doc(fromjson("{a: [0, 1, 2, 3]}"));
+    setPathTaken("a");
+    auto result = node.apply(getApplyParams(doc.root()["a"]));
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{a: [0, 1, 5, 3, 4]}"), doc);
+    ASSERT_EQUALS(fromjson("{$set: {'a.2': 5, 'a.4': 4}}"), getLogDoc());
+}
+
+TEST_F(SetNodeTest, ApplyArrayWithMostEntriesChangedLogsWholeArray) {
+    auto update = fromjson("{$set: {a: [3, 2, 1, 0]}}");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    SetNode node;
+    ASSERT_OK(node.init(update["$set"]["a"], expCtx));
+
+    mutablebson::Document doc(fromjson("{a: [0, 1, 2, 3]}"));
+    setPathTaken("a");
+    auto result = node.apply(getApplyParams(doc.root()["a"]));
+    ASSERT_FALSE(result.noop);
+    ASSERT_EQUALS(fromjson("{a: [3, 2, 1, 0]}"), doc);
+    ASSERT_EQUALS(fromjson("{$set: {a: [3, 2, 1, 0]}}"), getLogDoc());
+}
+
 TEST_F(SetNodeTest, ApplySetOnInsertExistingPath) {
     auto update = fromjson("{$setOnInsert: {a: 2}}");
     boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
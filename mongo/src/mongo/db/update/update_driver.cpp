@@ -339,6 +339,10 @@ Status UpdateDriver::update(StringData matchedField,
     // TODO: assert that update() is called at most once in a !_multi case.
 
     _affectIndices = (isDocReplacement() && (_indexedFields != NULL));
+    _modifiedIndexedPaths.clear();
+    if (_affectIndices) {
+        _modifiedIndexedPaths.allPathsIndexed();
+    }
 
     _logDoc.reset();
     LogBuilder logBuilder(_logDoc.root());
@@ -352,6 +356,7 @@ Status UpdateDriver::update(StringData matchedField,
         applyParams.fromOplogApplication = _modOptions.fromOplogApplication;
         applyParams.validateForStorage = validateForStorage;
         applyParams.indexData = _indexedFields;
+        applyParams.modifiedIndexedPaths = &_modifiedIndexedPaths;
         if (_logOp && logOpRec) {
             applyParams.logBuilder = &logBuilder;
         }
@@ -428,6 +433,10 @@ Status UpdateDriver::update(StringData matchedField,
                             execInfo.fieldRef[i]->dottedSubstring(0, pathLengthForIndexCheck))) {
                         _affectIndices = true;
                         doc->disableInPlaceUpdates();
+
+                        // The old modifiers do not track which paths they touch, so every index
+                        // must be maintained.
+                        _modifiedIndexedPaths.allPathsIndexed();
                     }
                 }
             }
@@ -549,6 +558,10 @@ bool UpdateDriver::modsAffectIndices() const {
     return _affectIndices;
 }
 
+const UpdateIndexData& UpdateDriver::modifiedIndexedPaths() const {
+    return _modifiedIndexedPaths;
+}
+
 void UpdateDriver::refreshIndexKeys(const UpdateIndexData* indexedFields) {
     _indexedFields = indexedFields;
 }
@@ -129,6 +129,13 @@ public:
     static bool isDocReplacement(const BSONObj& updateExpr);
 
     bool modsAffectIndices() const;
+
+    /**
+     * Returns the indexed paths modified by the last call to update(). Only meaningful when
+     * modsAffectIndices() is true.
+     */
+    const UpdateIndexData& modifiedIndexedPaths() const;
+
     void refreshIndexKeys(const UpdateIndexData* indexedFields);
 
     bool logOp() const;
@@ -202,6 +209,9 @@ private:
     // at each call to update.
     bool _affectIndices;
 
+    // The paths that caused '_affectIndices' to be set. Is reset at each call to update().
+    UpdateIndexData _modifiedIndexedPaths;
+
     // Do any of the mods require positional match details when calling 'prepare'?
     bool _positional;
 
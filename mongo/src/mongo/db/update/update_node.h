@@ -119,6 +119,10 @@ public:
         // Used to determine whether indexes are affected.
         const UpdateIndexData* indexData = nullptr;
 
+        // If provided, UpdateNode::apply records here each modified path that affects indexes, so
+        // that index maintenance can be limited to the indexes over those paths.
+        UpdateIndexData* modifiedIndexedPaths = nullptr;
+
         // If provided, UpdateNode::apply will log the update here.
         LogBuilder* logBuilder = nullptr;
     };
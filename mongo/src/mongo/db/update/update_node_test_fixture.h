@@ -59,6 +59,7 @@ protected:
         _fromOplogApplication = false;
         _validateForStorage = true;
         _indexData.reset();
+        _modifiedIndexedPaths.clear();
         _logDoc.reset();
         _logBuilder = stdx::make_unique<LogBuilder>(_logDoc.root());
     }
@@ -72,6 +73,7 @@ protected:
         applyParams.fromOplogApplication = _fromOplogApplication;
         applyParams.validateForStorage = _validateForStorage;
         applyParams.indexData = _indexData.get();
+        applyParams.modifiedIndexedPaths = &_modifiedIndexedPaths;
         applyParams.logBuilder = _logBuilder.get();
         return applyParams;
     }
@@ -115,6 +117,10 @@ protected:
         _indexData->addPath(path);
     }
 
+    const UpdateIndexData& getModifiedIndexedPaths() const {
+        return _modifiedIndexedPaths;
+    }
+
     void setLogBuilderToNull() {
         _logBuilder.reset();
     }
@@ -133,6 +139,7 @@ private:
     bool _fromOplogApplication;
     bool _validateForStorage;
     std::unique_ptr<UpdateIndexData> _indexData;
+    UpdateIndexData _modifiedIndexedPaths;
     mutablebson::Document _logDoc;
     std::unique_ptr<LogBuilder> _logBuilder;
 };
@@ -0,0 +1,355 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/views/materialized_view.h"
+
+#include <utility>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/logical_session_id.h"
+#include "mongo/db/op_observer.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/query_request.h"
+#include "mongo/db/views/materialized_view_pipeline.h"
+#include "mongo/db/views/view.h"
+#include "mongo/db/views/view_catalog.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+std::vector<std::shared_ptr<ViewDefinition>> getViewsOn(OperationContext* opCtx,
+                                                        const NamespaceString& nss,
+                                                        Database** db) {
+    // Materialized views cannot be defined on system collections, which include their own backing
+    // collections.
+    if (!opCtx->writesAreReplicated() || nss.isSystem()) {
+        return {};
+    }
+
+    *db = dbHolder().get(opCtx, nss.db());
+    if (!*db) {
+        return {};
+    }
+    return (*db)->getViewCatalog()->getMaterializedViewsOn(opCtx, nss);
+}
+
+/**
+ * Applies the changes to the source collection of a materialized view to its backing collection.
+ */
+class BackingCollectionWriter {
+public:
+    BackingCollectionWriter(OperationContext* opCtx, Database* db, const ViewDefinition& view)
+        : _opCtx(opCtx),
+          _backingLock(opCtx->lockState(), view.backingNss().ns(), MODE_IX),
+          _pipeline(uassertStatusOK(MaterializedViewPipeline::parse(opCtx, view))),
+          _source(db->getCollection(opCtx, view.viewOn())),
+          _backing(db->getCollection(opCtx, view.backingNss())),
+          _collation(view.defaultCollator() ? view.defaultCollator()->getSpec().toBSON()
+                                            : BSONObj()) {
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "Missing backing collection " << view.backingNss().ns()
+                              << " of materialized view "
+                              << view.name().ns(),
+                _backing);
+    }
+
+    /**
+     * Fills the empty backing collection from the source collection.
+     */
+    void build() {
+        if (!_pipeline->hasGroup()) {
+            scanSource(BSONElement(), [this](const Document& doc) {
+                uassertStatusOK(_backing->insertDocument(
+                    _opCtx, InsertStatement(doc.toBson()), nullptr, false));
+            });
+            return;
+        }
+
+        using Group = std::pair<MaterializedViewPipeline::Accumulators, long long>;
+        auto groups = _pipeline->getValueComparator().makeUnorderedValueMap<Group>();
+        scanSource(BSONElement(), [this, &groups](const Document& doc) {
+            auto key = _pipeline->groupKey(doc);
+            auto it = groups.find(key);
+            if (it == groups.end()) {
+                it = groups.emplace(key, Group(_pipeline->makeAccumulators(), 0)).first;
+            }
+            _pipeline->accumulate(it->second.first, doc);
+            ++it->second.second;
+        });
+
+        for (auto&& group : groups) {
+            auto doc =
+                _pipeline->makeGroupDocument(group.first, group.second.first, group.second.second);
+            uassertStatusOK(
+                _backing->insertDocument(_opCtx, InsertStatement(doc.toBson()), nullptr, false));
+        }
+    }
+
+    /**
+     * Applies the replacement of the source document 'removed' by 'added'; either may be null.
+     * 'removedId' is the _id of 'removed' if it is still in the source collection.
+     */
+    void apply(const BSONObj* removed, const BSONObj* added, BSONElement removedId) {
+        auto removedDoc = removed ? _pipeline->transform(*removed) : boost::none;
+        auto addedDoc = added ? _pipeline->transform(*added) : boost::none;
+
+        if (!_pipeline->hasGroup()) {
+            if (addedDoc) {
+                write(addedDoc->getField("_id"), addedDoc->toBson());
+            } else if (removedDoc) {
+                write(removedDoc->getField("_id"), boost::none);
+            }
+            return;
+        }
+
+        boost::optional<Value> removedKey, addedKey;
+        if (removedDoc) {
+            removedKey = _pipeline->groupKey(*removedDoc);
+        }
+        if (addedDoc) {
+            addedKey = _pipeline->groupKey(*addedDoc);
+        }
+
+        if (removedKey && addedKey &&
+            _pipeline->getValueComparator().evaluate(*removedKey == *addedKey)) {
+            updateGroup(*removedKey, removedDoc.get_ptr(), addedDoc.get_ptr(), removedId);
+            return;
+        }
+        if (removedKey) {
+            updateGroup(*removedKey, removedDoc.get_ptr(), nullptr, removedId);
+        }
+        if (addedKey) {
+            updateGroup(*addedKey, nullptr, addedDoc.get_ptr(), removedId);
+        }
+    }
+
+private:
+    /**
+     * Calls 'callback' on the transformed form of every source document except the one whose _id
+     * is 'skipId', if set. If 'query' is not empty, only the documents matching it are read, using
+     * an index if there is a suitable one.
+     */
+    template <typename Callback>
+    void scanSource(BSONElement skipId,
+                    const Callback& callback,
+                    const BSONObj& query = BSONObj()) {
+        if (!_source) {
+            return;
+        }
+
+        std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec;
+        if (query.isEmpty()) {
+            exec = InternalPlanner::collectionScan(
+                _opCtx, _source->ns().ns(), _source, PlanExecutor::NO_YIELD);
+        } else {
+            auto qr = stdx::make_unique<QueryRequest>(_source->ns());
+            qr->setFilter(query);
+            qr->setCollation(_collation);
+            auto cq = uassertStatusOK(CanonicalQuery::canonicalize(_opCtx, std::move(qr)));
+            exec = uassertStatusOK(
+                getExecutor(_opCtx, _source, std::move(cq), PlanExecutor::NO_YIELD));
+        }
+
+        BSONObj obj;
+        PlanExecutor::ExecState state;
+        while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr))) {
+            if (!skipId.eoo() && obj["_id"].binaryEqualValues(skipId)) {
+                continue;
+            }
+            if (auto doc = _pipeline->transform(obj)) {
+                callback(*doc);
+            }
+        }
+
+        if (PlanExecutor::FAILURE == state || PlanExecutor::DEAD == state) {
+            uassertStatusOK(WorkingSetCommon::getMemberObjectStatus(obj).withContext(
+                "Failed to scan the source collection of a materialized view"));
+        }
+    }
+
+    void updateGroup(const Value& key,
+                     const Document* removed,
+                     const Document* added,
+                     BSONElement removedId) {
+        auto rid = findById(key);
+        boost::optional<Document> existing;
+        if (!rid.isNull()) {
+            existing = Document(_backing->docFor(_opCtx, rid).value().getOwned());
+        }
+
+        auto update = _pipeline->updateGroup(key, existing, removed, added);
+        if (!update.needsRecompute) {
+            write(key, update.doc ? boost::make_optional(update.doc->toBson()) : boost::none);
+            return;
+        }
+
+        // Only read the documents of the group, rather than the whole source collection
+        auto accumulators = _pipeline->makeAccumulators();
+        long long count = 0;
+        scanSource(removedId,
+                   [&](const Document& doc) {
+                       if (_pipeline->getValueComparator().evaluate(_pipeline->groupKey(doc) ==
+                                                                    key)) {
+                           _pipeline->accumulate(accumulators, doc);
+                           ++count;
+                       }
+                   },
+                   _pipeline->makeGroupSourceQuery(key));
+        write(key,
+              count ? boost::make_optional(
+                          _pipeline->makeGroupDocument(key, accumulators, count).toBson())
+                    : boost::none);
+    }
+
+    RecordId findById(const Value& id) {
+        BSONObjBuilder query;
+        id.addToBsonObj(&query, "_id");
+        return Helpers::findById(_opCtx, _backing, query.obj());
+    }
+
+    /**
+     * Sets the backing document with _id 'id' to 'newDoc', or deletes it if 'newDoc' is unset.
+     */
+    void write(const Value& id, const boost::optional<BSONObj>& newDoc) {
+        auto rid = findById(id);
+        if (rid.isNull()) {
+            if (newDoc) {
+                uassertStatusOK(
+                    _backing->insertDocument(_opCtx, InsertStatement(*newDoc), nullptr, false));
+            }
+            return;
+        }
+
+        if (!newDoc) {
+            _backing->deleteDocument(_opCtx, kUninitializedStmtId, rid, nullptr);
+            return;
+        }
+
+        OplogUpdateEntryArgs args;
+        args.nss = _backing->ns();
+        args.uuid = _backing->uuid();
+        args.update = *newDoc;
+        args.criteria = BSON("_id" << newDoc->getField("_id"));
+        _backing->updateDocument(_opCtx,
+                                 rid,
+                                 _backing->docFor(_opCtx, rid),
+                                 *newDoc,
+                                 false,
+                                 true,
+                                 nullptr,
+                                 nullptr,
+                                 &args);
+    }
+
+    OperationContext* _opCtx;
+    Lock::CollectionLock _backingLock;
+    std::unique_ptr<MaterializedViewPipeline> _pipeline;
+    Collection* _source;
+    Collection* _backing;
+    const BSONObj _collation;
+};
+}  // namespace
+
+void MaterializedView::create(OperationContext* opCtx, Database* db, const ViewDefinition& view) {
+    invariant(opCtx->lockState()->isDbLockedForMode(db->name(), MODE_X));
+
+    CollectionOptions options;
+    if (view.defaultCollator()) {
+        options.collation = view.defaultCollator()->getSpec().toBSON();
+    }
+    db->createCollection(opCtx, view.backingNss().ns(), options);
+    BackingCollectionWriter(opCtx, db, view).build();
+}
+
+bool MaterializedView::hasViewsOn(OperationContext* opCtx, const NamespaceString& nss) {
+    Database* db = nullptr;
+    return !getViewsOn(opCtx, nss, &db).empty();
+}
+
+void MaterializedView::onInserts(OperationContext* opCtx,
+                                 const NamespaceString& nss,
+                                 std::vector<InsertStatement>::const_iterator begin,
+                                 std::vector<InsertStatement>::const_iterator end) {
+    Database* db = nullptr;
+    for (auto&& view : getViewsOn(opCtx, nss, &db)) {
+        BackingCollectionWriter writer(opCtx, db, *view);
+        for (auto it = begin; it != end; ++it) {
+            writer.apply(nullptr, &it->doc, BSONElement());
+        }
+    }
+}
+
+void MaterializedView::onUpdate(OperationContext* opCtx,
+                                const NamespaceString& nss,
+                                const BSONObj& preImage,
+                                const BSONObj& postImage) {
+    Database* db = nullptr;
+    for (auto&& view : getViewsOn(opCtx, nss, &db)) {
+        BackingCollectionWriter(opCtx, db, *view).apply(&preImage, &postImage, BSONElement());
+    }
+}
+
+void MaterializedView::aboutToDelete(OperationContext* opCtx,
+                                     const NamespaceString& nss,
+                                     const BSONObj& doc) {
+    Database* db = nullptr;
+    for (auto&& view : getViewsOn(opCtx, nss, &db)) {
+        BackingCollectionWriter(opCtx, db, *view).apply(&doc, nullptr, doc["_id"]);
+    }
+}
+
+void MaterializedView::onDropCollection(OperationContext* opCtx, const NamespaceString& nss) {
+    if (nss.isSystem()) {
+        return;
+    }
+
+    Database* db = dbHolder().get(opCtx, nss.db());
+    if (!db) {
+        return;
+    }
+
+    for (auto&& view : db->getViewCatalog()->getMaterializedViewsOn(opCtx, nss)) {
+        if (auto backing = db->getCollection(opCtx, view->backingNss())) {
+            uassertStatusOK(backing->truncate(opCtx));
+        }
+    }
+}
+}  // namespace mongo
@@ -0,0 +1,89 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/repl/oplog.h"
+
+namespace mongo {
+class Database;
+class OperationContext;
+class ViewDefinition;
+
+/**
+ * Maintains the backing collections of materialized views from the writes to the collections they
+ * are defined on. The maintenance happens synchronously in the unit of work of the write, so a
+ * materialized view is always consistent with its source collection.
+ *
+ * Writes to the backing collections are replicated like any other write, so the write hooks do
+ * nothing while applying oplog entries.
+ */
+class MaterializedView {
+public:
+    /**
+     * Creates the backing collection of the materialized view 'view' and fills it from the
+     * collection the view is defined on. The database must be locked in MODE_X.
+     */
+    static void create(OperationContext* opCtx, Database* db, const ViewDefinition& view);
+
+    /**
+     * Returns true if writes to 'nss' need to maintain materialized views, and so need to provide
+     * the pre-image of updated documents.
+     */
+    static bool hasViewsOn(OperationContext* opCtx, const NamespaceString& nss);
+
+    static void onInserts(OperationContext* opCtx,
+                          const NamespaceString& nss,
+                          std::vector<InsertStatement>::const_iterator begin,
+                          std::vector<InsertStatement>::const_iterator end);
+
+    static void onUpdate(OperationContext* opCtx,
+                         const NamespaceString& nss,
+                         const BSONObj& preImage,
+                         const BSONObj& postImage);
+
+    /**
+     * Called before 'doc' is deleted from 'nss', so that the extreme values of $min and $max can
+     * be recomputed from the remaining documents.
+     */
+    static void aboutToDelete(OperationContext* opCtx,
+                              const NamespaceString& nss,
+                              const BSONObj& doc);
+
+    /**
+     * Empties the backing collections of the views defined on the dropped collection 'nss'. Unlike
+     * the other hooks, this also runs while applying oplog entries, since the drop of the source
+     * collection is the only record of it.
+     */
+    static void onDropCollection(OperationContext* opCtx, const NamespaceString& nss);
+};
+}  // namespace mongo
@@ -0,0 +1,328 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/views/materialized_view_pipeline.h"
+
+#include <limits>
+
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/views/view.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+using parsed_aggregation_projection::ParsedAggregationProjection;
+
+constexpr StringData MaterializedViewPipeline::kGroupCountField;
+
+namespace {
+/**
+ * Returns the value which, added by $sum, takes 'value' back out of the total. Non-numeric values
+ * are ignored by $sum and are returned unchanged.
+ */
+Value negate(const Value& value) {
+    switch (value.getType()) {
+        case NumberInt:
+            return Value::createIntOrLong(-value.coerceToLong());
+        case NumberLong: {
+            long long number = value.getLong();
+            if (number == std::numeric_limits<long long>::min()) {
+                return Value(-static_cast<double>(number));
+            }
+            return Value(-number);
+        }
+        case NumberDouble:
+            return Value(-value.getDouble());
+        case NumberDecimal:
+            return Value(value.getDecimal().negate());
+        default:
+            return value;
+    }
+}
+}  // namespace
+
+MaterializedViewPipeline::MaterializedViewPipeline(OperationContext* opCtx,
+                                                   const ViewDefinition& view)
+    : _collator(CollatorInterface::cloneCollator(view.defaultCollator())),
+      _expCtx(new ExpressionContext(opCtx, _collator.get())) {
+    for (auto&& stage : view.pipeline()) {
+        uassert(ErrorCodes::OptionNotSupportedOnView,
+                "A materialized view cannot have stages after its $group",
+                !_groupId);
+        uassert(ErrorCodes::OptionNotSupportedOnView,
+                str::stream() << "Invalid stage in the pipeline of a materialized view: " << stage,
+                stage.nFields() == 1 && stage.firstElement().type() == Object);
+
+        const auto stageName = StringData(stage.firstElementFieldName());
+        const auto spec = stage.firstElement().Obj();
+        if (stageName == "$match") {
+            Stage match;
+            match.match = uassertStatusOK(MatchExpressionParser::parse(spec, _expCtx));
+            _stages.push_back(std::move(match));
+            _matchSpecs.push_back(spec.getOwned());
+        } else if (stageName == "$project") {
+            auto idSpec = spec["_id"];
+            uassert(ErrorCodes::OptionNotSupportedOnView,
+                    "A $project in a materialized view without a $group must keep the _id field",
+                    idSpec.eoo() ||
+                        ((idSpec.isBoolean() || idSpec.isNumber()) && idSpec.trueValue()));
+            Stage projection;
+            projection.projection = ParsedAggregationProjection::create(_expCtx, spec);
+            projection.projection->optimize();
+            _stages.push_back(std::move(projection));
+        } else if (stageName == "$group") {
+            parseGroup(spec);
+        } else {
+            uasserted(ErrorCodes::OptionNotSupportedOnView,
+                      str::stream() << "Materialized views only support $match, $project and "
+                                       "$group stages, not "
+                                    << stageName);
+        }
+    }
+}
+
+void MaterializedViewPipeline::parseGroup(const BSONObj& spec) {
+    const auto& vps = _expCtx->variablesParseState;
+    for (auto&& elem : spec) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == "_id") {
+            _groupId = Expression::parseOperand(_expCtx, elem, vps)->optimize();
+            continue;
+        }
+
+        uassert(ErrorCodes::OptionNotSupportedOnView,
+                str::stream() << "The field name " << kGroupCountField
+                              << " is reserved in materialized views",
+                fieldName != kGroupCountField);
+        uassert(ErrorCodes::FailedToParse,
+                str::stream() << "The field '" << fieldName << "' must be an accumulator object",
+                elem.type() == Object && elem.Obj().nFields() == 1);
+
+        auto accumulatorElem = elem.Obj().firstElement();
+        const auto accumulatorName = accumulatorElem.fieldNameStringData();
+        AccumulatedField field;
+        field.fieldName = fieldName.toString();
+        if (accumulatorName == "$sum") {
+            field.kind = AccumulatorKind::kSum;
+        } else if (accumulatorName == "$min") {
+            field.kind = AccumulatorKind::kMin;
+        } else if (accumulatorName == "$max") {
+            field.kind = AccumulatorKind::kMax;
+        } else {
+            uasserted(ErrorCodes::OptionNotSupportedOnView,
+                      str::stream() << "Materialized views only support the $sum, $min and $max "
+                                       "accumulators, not "
+                                    << accumulatorName);
+        }
+        field.factory = AccumulationStatement::getFactory(accumulatorName);
+        field.expression = Expression::parseOperand(_expCtx, accumulatorElem, vps)->optimize();
+        _fields.push_back(std::move(field));
+    }
+
+    uassert(ErrorCodes::FailedToParse, "a group specification must include an _id", _groupId);
+
+    for (auto&& field : _fields) {
+        if (field.kind != AccumulatorKind::kSum) {
+            parseGroupKeySourcePaths();
+            break;
+        }
+    }
+}
+
+void MaterializedViewPipeline::parseGroupKeySourcePaths() {
+    const auto notSupported = [] {
+        uasserted(ErrorCodes::OptionNotSupportedOnView,
+                  "A materialized view with $min or $max must group by field paths of the source "
+                  "documents, without a $project before its $group");
+    };
+    for (auto&& stage : _stages) {
+        if (stage.projection) {
+            notSupported();
+        }
+    }
+
+    // Returns the source path of a field path expression on the current document, or fails.
+    const auto sourcePath = [&](const boost::intrusive_ptr<Expression>& expression) {
+        auto fieldPath = dynamic_cast<ExpressionFieldPath*>(expression.get());
+        if (!fieldPath || !fieldPath->isRootFieldPath() ||
+            fieldPath->getFieldPath().getPathLength() < 2) {
+            notSupported();
+        }
+        return fieldPath->getFieldPath().tail().fullPath();
+    };
+
+    if (auto object = dynamic_cast<ExpressionObject*>(_groupId.get())) {
+        for (auto&& child : object->getChildExpressions()) {
+            _groupKeySourcePaths.emplace_back(child.first, sourcePath(child.second));
+        }
+        if (_groupKeySourcePaths.empty()) {
+            notSupported();
+        }
+    } else {
+        _groupKeySourcePaths.emplace_back("", sourcePath(_groupId));
+    }
+}
+
+StatusWith<std::unique_ptr<MaterializedViewPipeline>> MaterializedViewPipeline::parse(
+    OperationContext* opCtx, const ViewDefinition& view) {
+    try {
+        return std::unique_ptr<MaterializedViewPipeline>(
+            new MaterializedViewPipeline(opCtx, view));
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+}
+
+std::vector<BSONObj> MaterializedViewPipeline::makeReadPipeline(const ViewDefinition& view) {
+    const auto& pipeline = view.pipeline();
+    if (!pipeline.empty() && pipeline.back().hasField("$group")) {
+        return {BSON("$project" << BSON(kGroupCountField << 0))};
+    }
+    return {};
+}
+
+boost::optional<Document> MaterializedViewPipeline::transform(const BSONObj& input) const {
+    Document doc(input);
+    bool projected = false;
+    for (auto&& stage : _stages) {
+        if (stage.match) {
+            if (!stage.match->matchesBSON(projected ? doc.toBson() : input)) {
+                return boost::none;
+            }
+        } else {
+            doc = stage.projection->applyTransformation(doc);
+            projected = true;
+        }
+    }
+    return doc;
+}
+
+Value MaterializedViewPipeline::groupKey(const Document& doc) const {
+    invariant(hasGroup());
+    // As in $group, a missing _id groups the document with those whose _id is null.
+    Value key = _groupId->evaluate(doc);
+    return key.missing() ? Value(BSONNULL) : key;
+}
+
+MaterializedViewPipeline::Accumulators MaterializedViewPipeline::makeAccumulators() const {
+    Accumulators accumulators;
+    for (auto&& field : _fields) {
+        accumulators.push_back(field.factory(_expCtx));
+    }
+    return accumulators;
+}
+
+void MaterializedViewPipeline::accumulate(const Accumulators& accumulators,
+                                          const Document& doc) const {
+    for (size_t i = 0; i < _fields.size(); ++i) {
+        accumulators[i]->process(_fields[i].expression->evaluate(doc), false);
+    }
+}
+
+Document MaterializedViewPipeline::makeGroupDocument(const Value& key,
+                                                     const Accumulators& accumulators,
+                                                     long long count) const {
+    MutableDocument out;
+    out.addField("_id", key);
+    for (size_t i = 0; i < _fields.size(); ++i) {
+        out.addField(_fields[i].fieldName, accumulators[i]->getValue(false));
+    }
+    out.addField(kGroupCountField, Value(count));
+    return out.freeze();
+}
+
+MaterializedViewPipeline::GroupUpdate MaterializedViewPipeline::updateGroup(
+    const Value& key,
+    const boost::optional<Document>& existing,
+    const Document* removed,
+    const Document* added) const {
+    GroupUpdate update;
+
+    long long count = existing ? existing->getField(kGroupCountField).coerceToLong() : 0;
+    count += (added ? 1 : 0) - (removed ? 1 : 0);
+    if (count <= 0) {
+        return update;
+    }
+
+    auto accumulators = makeAccumulators();
+    for (size_t i = 0; i < _fields.size(); ++i) {
+        const auto& field = _fields[i];
+        Value current = existing ? existing->getField(field.fieldName) : Value();
+        if (!current.missing()) {
+            accumulators[i]->process(current, true);
+        }
+
+        if (removed) {
+            Value value = field.expression->evaluate(*removed);
+            if (field.kind == AccumulatorKind::kSum) {
+                accumulators[i]->process(negate(value), false);
+            } else if (!value.nullish() &&
+                       getValueComparator().evaluate(value == current)) {
+                // The extreme value of the group is going away, and the next one is unknown.
+                update.needsRecompute = true;
+                return update;
+            }
+        }
+
+        if (added) {
+            accumulators[i]->process(field.expression->evaluate(*added), false);
+        }
+    }
+
+    update.doc = makeGroupDocument(key, accumulators, count);
+    return update;
+}
+
+BSONObj MaterializedViewPipeline::makeGroupSourceQuery(const Value& key) const {
+    invariant(!_groupKeySourcePaths.empty());
+
+    // A missing field and null both group under null, which {$eq: null} matches. Arrays match by
+    // element as well as whole, so the query may match documents of other groups, which the
+    // caller filters out by their group key.
+    BSONArrayBuilder clauses;
+    for (auto&& spec : _matchSpecs) {
+        clauses.append(spec);
+    }
+    for (auto&& part : _groupKeySourcePaths) {
+        Value value = part.first.empty() ? key : key.getDocument().getField(part.first);
+        if (value.missing()) {
+            value = Value(BSONNULL);
+        }
+
+        BSONObjBuilder clause(clauses.subobjStart());
+        BSONObjBuilder eq(clause.subobjStart(part.second));
+        value.addToBsonObj(&eq, "$eq");
+    }
+
+    return BSON("$and" << clauses.arr());
+}
+}  // namespace mongo
@@ -0,0 +1,192 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <boost/intrusive_ptr.hpp>
+#include <boost/optional.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/parsed_aggregation_projection.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/collation/collator_interface.h"
+
+namespace mongo {
+class OperationContext;
+class ViewDefinition;
+
+/**
+ * The parsed pipeline of a materialized view, which computes the changes to the view's backing
+ * collection caused by a write to the collection the view is defined on. Only pipelines made of
+ * $match and $project stages, optionally followed by one $group whose accumulators are all $sum,
+ * $min or $max, can be maintained this way.
+ *
+ * Without a $group, the backing collection holds the transformed copy of every source document
+ * that passes the $match stages, under the _id of the source document. With a $group, it holds one
+ * document per group, along with the number of source documents in the group under
+ * 'kGroupCountField'.
+ *
+ * A $group with $min or $max must be recomputed when its extreme value is removed. To keep that
+ * from scanning the whole source collection, such a $group must not follow a $project, and its _id
+ * must be a field path or an object of field paths, so that the documents of a group can be
+ * queried for (and found with an index on those fields).
+ */
+class MaterializedViewPipeline {
+public:
+    static constexpr StringData kGroupCountField = "__materializedViewCount"_sd;
+
+    using Accumulators = std::vector<boost::intrusive_ptr<Accumulator>>;
+
+    /**
+     * The backing document of a group after a change to it. An unset 'doc' means that the group no
+     * longer exists, unless 'needsRecompute' is set: removing the current $min or $max of a group
+     * requires recomputing the group from the source collection.
+     */
+    struct GroupUpdate {
+        bool needsRecompute = false;
+        boost::optional<Document> doc;
+    };
+
+    /**
+     * Parses the pipeline of 'view', returning ErrorCodes::OptionNotSupportedOnView if it cannot be
+     * maintained incrementally.
+     */
+    static StatusWith<std::unique_ptr<MaterializedViewPipeline>> parse(
+        OperationContext* opCtx, const ViewDefinition& view);
+
+    /**
+     * Returns the stages to run against the backing collection when reading from 'view', which
+     * hide the bookkeeping fields of the backing documents.
+     */
+    static std::vector<BSONObj> makeReadPipeline(const ViewDefinition& view);
+
+    /**
+     * Runs the $match and $project stages on 'input', returning boost::none if it is filtered out.
+     */
+    boost::optional<Document> transform(const BSONObj& input) const;
+
+    bool hasGroup() const {
+        return bool(_groupId);
+    }
+
+    /**
+     * Returns the _id of the group the transformed document 'doc' belongs to. Must only be called
+     * if hasGroup() is true.
+     */
+    Value groupKey(const Document& doc) const;
+
+    /**
+     * Returns fresh accumulators for the fields of the $group, to be fed with accumulate().
+     */
+    Accumulators makeAccumulators() const;
+
+    /**
+     * Adds the transformed document 'doc' to 'accumulators'.
+     */
+    void accumulate(const Accumulators& accumulators, const Document& doc) const;
+
+    /**
+     * Returns the backing document of the group 'key' holding 'count' source documents.
+     */
+    Document makeGroupDocument(const Value& key,
+                               const Accumulators& accumulators,
+                               long long count) const;
+
+    /**
+     * Returns the backing document of the group 'key' after the transformed document 'removed' is
+     * taken out of it and 'added' is put into it. Either may be null. 'existing' is the current
+     * backing document of the group, if there is one.
+     */
+    GroupUpdate updateGroup(const Value& key,
+                            const boost::optional<Document>& existing,
+                            const Document* removed,
+                            const Document* added) const;
+
+    /**
+     * Returns a query on the source collection which matches at least the documents of the group
+     * 'key', for recomputing it. Must only be called if updateGroup() can ask for a recompute.
+     */
+    BSONObj makeGroupSourceQuery(const Value& key) const;
+
+    const ValueComparator& getValueComparator() const {
+        return _expCtx->getValueComparator();
+    }
+
+private:
+    enum class AccumulatorKind { kSum, kMin, kMax };
+
+    struct Stage {
+        std::unique_ptr<MatchExpression> match;
+        std::unique_ptr<parsed_aggregation_projection::ParsedAggregationProjection> projection;
+    };
+
+    struct AccumulatedField {
+        std::string fieldName;
+        AccumulatorKind kind;
+        Accumulator::Factory factory;
+        boost::intrusive_ptr<Expression> expression;
+    };
+
+    MaterializedViewPipeline(OperationContext* opCtx, const ViewDefinition& view);
+
+    void parseGroup(const BSONObj& spec);
+
+    /**
+     * Fills _groupKeySourcePaths, failing if the $group _id cannot be turned into a query on the
+     * source collection.
+     */
+    void parseGroupKeySourcePaths();
+
+    std::unique_ptr<CollatorInterface> _collator;
+    boost::intrusive_ptr<ExpressionContext> _expCtx;
+    std::vector<Stage> _stages;
+
+    // Set only if the pipeline ends with a $group.
+    boost::intrusive_ptr<Expression> _groupId;
+    std::vector<AccumulatedField> _fields;
+
+    // The $match specifications of the pipeline, all of which apply to source documents when
+    // _groupKeySourcePaths is set.
+    std::vector<BSONObj> _matchSpecs;
+
+    // The source field path of each part of the $group _id, keyed by its field name in the _id, or
+    // by the empty string if the _id is a single field path. Only set if the $group has a $min or
+    // $max.
+    std::vector<std::pair<std::string, std::string>> _groupKeySourcePaths;
+};
+}  // namespace mongo
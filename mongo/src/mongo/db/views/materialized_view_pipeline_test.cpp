@@ -0,0 +1,172 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/db/views/materialized_view_pipeline.h"
+#include "mongo/db/views/view.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+ViewDefinition makeView(const std::string& pipeline) {
+    auto spec = fromjson("{pipeline: " + pipeline + "}");
+    return ViewDefinition("db", "view", "coll", spec["pipeline"].Obj(), nullptr, true);
+}
+
+class MaterializedViewPipelineTest : public unittest::Test {
+protected:
+    std::unique_ptr<MaterializedViewPipeline> parse(const std::string& pipeline) {
+        auto parsed = MaterializedViewPipeline::parse(_opCtx.get(), makeView(pipeline));
+        ASSERT_OK(parsed.getStatus());
+        return std::move(parsed.getValue());
+    }
+
+    Status parseStatus(const std::string& pipeline) {
+        return MaterializedViewPipeline::parse(_opCtx.get(), makeView(pipeline)).getStatus();
+    }
+
+private:
+    QueryTestServiceContext _serviceContext;
+    ServiceContext::UniqueOperationContext _opCtx = _serviceContext.makeOperationContext();
+};
+
+TEST_F(MaterializedViewPipelineTest, RejectsUnsupportedPipelines) {
+    ASSERT_EQ(parseStatus("[{$sort: {a: 1}}]"), ErrorCodes::OptionNotSupportedOnView);
+    ASSERT_EQ(parseStatus("[{$group: {_id: '$a'}}, {$match: {_id: 1}}]"),
+              ErrorCodes::OptionNotSupportedOnView);
+    ASSERT_EQ(parseStatus("[{$group: {_id: '$a', s: {$push: '$b'}}}]"),
+              ErrorCodes::OptionNotSupportedOnView);
+    ASSERT_EQ(parseStatus("[{$group: {_id: '$a', __materializedViewCount: {$sum: 1}}}]"),
+              ErrorCodes::OptionNotSupportedOnView);
+    ASSERT_EQ(parseStatus("[{$project: {_id: '$a'}}]"), ErrorCodes::OptionNotSupportedOnView);
+    ASSERT_OK(parseStatus("[{$match: {a: 1}}, {$project: {b: 1}}, {$group: {_id: '$b'}}]"));
+}
+
+TEST_F(MaterializedViewPipelineTest, TransformRunsMatchAndProjectStages) {
+    auto pipeline = parse("[{$match: {a: {$gt: 1}}}, {$project: {b: 1}}, {$match: {b: 'x'}}]");
+
+    ASSERT_FALSE(pipeline->transform(fromjson("{_id: 1, a: 1, b: 'x'}")));
+    ASSERT_FALSE(pipeline->transform(fromjson("{_id: 2, a: 2, b: 'y'}")));
+
+    auto doc = pipeline->transform(fromjson("{_id: 3, a: 2, b: 'x'}"));
+    ASSERT(doc);
+    ASSERT_DOCUMENT_EQ(*doc, Document(fromjson("{_id: 3, b: 'x'}")));
+}
+
+TEST_F(MaterializedViewPipelineTest, UpdateGroupAddsAndRemovesDocuments) {
+    auto pipeline = parse(
+        "[{$group: {_id: '$a', total: {$sum: '$b'}, low: {$min: '$b'}, high: {$max: '$b'}}}]");
+
+    Document first(fromjson("{a: 1, b: 5}"));
+    Document second(fromjson("{a: 1, b: 3}"));
+    Document third(fromjson("{a: 1, b: 4}"));
+    Value key = pipeline->groupKey(first);
+    ASSERT_VALUE_EQ(key, Value(1));
+
+    auto update = pipeline->updateGroup(key, boost::none, nullptr, &first);
+    ASSERT_FALSE(update.needsRecompute);
+    update = pipeline->updateGroup(key, update.doc, nullptr, &second);
+    update = pipeline->updateGroup(key, update.doc, nullptr, &third);
+    ASSERT(update.doc);
+    ASSERT_DOCUMENT_EQ(
+        *update.doc,
+        Document(fromjson("{_id: 1, total: 12, low: 3, high: 5, __materializedViewCount: 3}")));
+
+    // Removing a document that is neither the $min nor the $max is done incrementally.
+    update = pipeline->updateGroup(key, update.doc, &third, nullptr);
+    ASSERT_FALSE(update.needsRecompute);
+    ASSERT_DOCUMENT_EQ(
+        *update.doc,
+        Document(fromjson("{_id: 1, total: 8, low: 3, high: 5, __materializedViewCount: 2}")));
+
+    // Removing the $min requires recomputing the group.
+    ASSERT_TRUE(pipeline->updateGroup(key, update.doc, &second, nullptr).needsRecompute);
+
+    // Replacing the $max within the group requires recomputing it as well.
+    ASSERT_TRUE(pipeline->updateGroup(key, update.doc, &first, &third).needsRecompute);
+}
+
+TEST_F(MaterializedViewPipelineTest, UpdateGroupDeletesEmptyGroup) {
+    auto pipeline = parse("[{$group: {_id: '$a', count: {$sum: 1}}}]");
+
+    Document doc(fromjson("{a: 'x'}"));
+    Value key = pipeline->groupKey(doc);
+    auto update = pipeline->updateGroup(key, boost::none, nullptr, &doc);
+    ASSERT(update.doc);
+    ASSERT_DOCUMENT_EQ(*update.doc,
+                       Document(fromjson("{_id: 'x', count: 1, __materializedViewCount: 1}")));
+
+    update = pipeline->updateGroup(key, update.doc, &doc, nullptr);
+    ASSERT_FALSE(update.needsRecompute);
+    ASSERT_FALSE(update.doc);
+}
+
+TEST_F(MaterializedViewPipelineTest, MinAndMaxRequireGroupingBySourceFields) {
+    ASSERT_EQ(parseStatus("[{$project: {a: 1, b: 1}}, {$group: {_id: '$a', m: {$min: '$b'}}}]"),
+              ErrorCodes::OptionNotSupportedOnView);
+    ASSERT_EQ(parseStatus("[{$group: {_id: {$add: ['$a', 1]}, m: {$max: '$b'}}}]"),
+              ErrorCodes::OptionNotSupportedOnView);
+    ASSERT_EQ(parseStatus("[{$group: {_id: null, m: {$max: '$b'}}}]"),
+              ErrorCodes::OptionNotSupportedOnView);
+    ASSERT_OK(parseStatus("[{$project: {a: 1, b: 1}}, {$group: {_id: '$a', s: {$sum: '$b'}}}]"));
+    ASSERT_OK(parseStatus("[{$match: {c: 1}}, {$group: {_id: '$a.x', m: {$min: '$b'}}}]"));
+    ASSERT_OK(parseStatus("[{$group: {_id: {x: '$a', y: '$c'}, m: {$max: '$b'}}}]"));
+}
+
+TEST_F(MaterializedViewPipelineTest, GroupSourceQueryMatchesTheGroupsDocuments) {
+    auto pipeline = parse("[{$match: {c: 1}}, {$group: {_id: '$a.x', m: {$min: '$b'}}}]");
+    ASSERT_BSONOBJ_EQ(pipeline->makeGroupSourceQuery(Value(5)),
+                      fromjson("{$and: [{c: 1}, {'a.x': {$eq: 5}}]}"));
+
+    pipeline = parse("[{$group: {_id: {x: '$a', y: '$c'}, m: {$max: '$b'}}}]");
+    ASSERT_BSONOBJ_EQ(pipeline->makeGroupSourceQuery(Value(Document(fromjson("{x: 'q'}")))),
+                      fromjson("{$and: [{a: {$eq: 'q'}}, {c: {$eq: null}}]}"));
+}
+
+TEST_F(MaterializedViewPipelineTest, MissingGroupKeyIsNull) {
+    auto pipeline = parse("[{$group: {_id: '$a'}}]");
+    ASSERT_VALUE_EQ(pipeline->groupKey(Document(fromjson("{b: 1}"))), Value(BSONNULL));
+}
+
+TEST_F(MaterializedViewPipelineTest, ReadPipelineHidesGroupCount) {
+    auto readPipeline =
+        MaterializedViewPipeline::makeReadPipeline(makeView("[{$group: {_id: '$a'}}]"));
+    ASSERT_EQ(readPipeline.size(), 1UL);
+    ASSERT_BSONOBJ_EQ(readPipeline[0], fromjson("{$project: {__materializedViewCount: 0}}"));
+
+    ASSERT(MaterializedViewPipeline::makeReadPipeline(makeView("[{$match: {a: 1}}]")).empty());
+}
+
+}  // namespace
+}  // namespace mongo
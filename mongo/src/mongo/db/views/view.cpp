@@ -40,8 +40,13 @@ ViewDefinition::ViewDefinition(StringData dbName,
                                StringData viewName,
                                StringData viewOnName,
                                const BSONObj& pipeline,
-                               std::unique_ptr<CollatorInterface> collator)
-    : _viewNss(dbName, viewName), _viewOnNss(dbName, viewOnName), _collator(std::move(collator)) {
+                               std::unique_ptr<CollatorInterface> collator,
+                               bool materialized)
+    : _viewNss(dbName, viewName),
+      _viewOnNss(dbName, viewOnName),
+      _collator(std::move(collator)),
+      _materialized(materialized),
+      _backingNss(dbName, NamespaceString::kSystemDotMaterializedPrefix.toString() + viewName) {
     for (BSONElement e : pipeline) {
         _pipeline.push_back(e.Obj().getOwned());
     }
@@ -51,13 +56,17 @@ ViewDefinition::ViewDefinition(const ViewDefinition& other)
     : _viewNss(other._viewNss),
       _viewOnNss(other._viewOnNss),
       _collator(CollatorInterface::cloneCollator(other._collator.get())),
-      _pipeline(other._pipeline) {}
+      _pipeline(other._pipeline),
+      _materialized(other._materialized),
+      _backingNss(other._backingNss) {}
 
 ViewDefinition& ViewDefinition::operator=(const ViewDefinition& other) {
     _viewNss = other._viewNss;
     _viewOnNss = other._viewOnNss;
     _collator = CollatorInterface::cloneCollator(other._collator.get());
     _pipeline = other._pipeline;
+    _materialized = other._materialized;
+    _backingNss = other._backingNss;
 
     return *this;
 }
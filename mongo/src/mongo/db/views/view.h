@@ -46,12 +46,15 @@ public:
     /**
      * In the database 'dbName', create a new view 'viewName' on the view or collection
      * 'viewOnName'. Neither 'viewName' nor 'viewOnName' should include the name of the database.
+     * A 'materialized' view is answered from a backing collection that is kept up to date as
+     * 'viewOnName' is written to.
      */
     ViewDefinition(StringData dbName,
                    StringData viewName,
                    StringData viewOnName,
                    const BSONObj& pipeline,
-                   std::unique_ptr<CollatorInterface> collation);
+                   std::unique_ptr<CollatorInterface> collation,
+                   bool materialized = false);
 
     /**
      * Copying a view 'other' clones its collator and does a simple copy of all other fields.
@@ -89,6 +92,18 @@ public:
         return _collator.get();
     }
 
+    bool isMaterialized() const {
+        return _materialized;
+    }
+
+    /**
+     * @return The fully-qualified namespace of the collection holding the results of this view.
+     * Only meaningful for materialized views.
+     */
+    const NamespaceString& backingNss() const {
+        return _backingNss;
+    }
+
     void setViewOn(const NamespaceString& viewOnNss);
 
     /**
@@ -101,5 +116,7 @@ private:
     NamespaceString _viewOnNss;
     std::unique_ptr<CollatorInterface> _collator;
     std::vector<BSONObj> _pipeline;
+    bool _materialized;
+    NamespaceString _backingNss;
 };
 }  // namespace mongo
@@ -32,6 +32,7 @@
 
 #include "mongo/db/views/view_catalog.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -52,6 +53,7 @@
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/recovery_unit.h"
+#include "mongo/db/views/materialized_view_pipeline.h"
 #include "mongo/db/views/resolved_view.h"
 #include "mongo/db/views/view.h"
 #include "mongo/db/views/view_graph.h"
@@ -142,6 +144,7 @@ Status ViewCatalog::_reloadIfNeeded_inlock(OperationContext* opCtx) {
 
     // Need to reload, first clear our cache.
     _viewMap.clear();
+    bool hasMaterializedViews = false;
 
     Status status = _durable->iterate(opCtx, [&](const BSONObj& view) -> Status {
         BSONObj collationSpec = view.hasField("collation") ? view["collation"].Obj() : BSONObj();
@@ -163,13 +166,17 @@ Status ViewCatalog::_reloadIfNeeded_inlock(OperationContext* opCtx) {
             }
         }
 
+        const bool materialized = view["materialized"].trueValue();
+        hasMaterializedViews |= materialized;
         _viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(viewName.db(),
                                                                    viewName.coll(),
                                                                    view["viewOn"].str(),
                                                                    pipeline,
-                                                                   std::move(collator.getValue()));
+                                                                   std::move(collator.getValue()),
+                                                                   materialized);
         return Status::OK();
     });
+    _hasMaterializedViews.store(hasMaterializedViews);
     _valid.store(status.isOK());
 
     if (!status.isOK()) {
@@ -192,7 +199,8 @@ Status ViewCatalog::_createOrUpdateView_inlock(OperationContext* opCtx,
                                                const NamespaceString& viewName,
                                                const NamespaceString& viewOn,
                                                const BSONArray& pipeline,
-                                               std::unique_ptr<CollatorInterface> collator) {
+                                               std::unique_ptr<CollatorInterface> collator,
+                                               bool materialized) {
     _requireValidCatalog_inlock(opCtx);
 
     // Build the BSON definition for this view to be saved in the durable view catalog. If the
@@ -204,10 +212,24 @@ Status ViewCatalog::_createOrUpdateView_inlock(OperationContext* opCtx,
     if (collator) {
         viewDefBuilder.append("collation", collator->getSpec().toBSON());
     }
+    if (materialized) {
+        viewDefBuilder.append("materialized", true);
+    }
 
     BSONObj ownedPipeline = pipeline.getOwned();
-    auto view = std::make_shared<ViewDefinition>(
-        viewName.db(), viewName.coll(), viewOn.coll(), ownedPipeline, std::move(collator));
+    auto view = std::make_shared<ViewDefinition>(viewName.db(),
+                                                 viewName.coll(),
+                                                 viewOn.coll(),
+                                                 ownedPipeline,
+                                                 std::move(collator),
+                                                 materialized);
+
+    if (materialized) {
+        Status pipelineStatus = MaterializedViewPipeline::parse(opCtx, *view).getStatus();
+        if (!pipelineStatus.isOK()) {
+            return pipelineStatus;
+        }
+    }
 
     // Check that the resulting dependency graph is acyclic and within the maximum depth.
     Status graphStatus = _upsertIntoGraph(opCtx, *(view.get()));
@@ -217,6 +239,9 @@ Status ViewCatalog::_createOrUpdateView_inlock(OperationContext* opCtx,
 
     _durable->upsert(opCtx, viewName, viewDefBuilder.obj());
     _viewMap[viewName.ns()] = view;
+    if (materialized) {
+        _hasMaterializedViews.store(true);
+    }
     opCtx->recoveryUnit()->onRollback([this, viewName]() {
         this->_viewMap.erase(viewName.ns());
         this->_viewGraphNeedsRefresh = true;
@@ -349,7 +374,8 @@ Status ViewCatalog::createView(OperationContext* opCtx,
                                const NamespaceString& viewName,
                                const NamespaceString& viewOn,
                                const BSONArray& pipeline,
-                               const BSONObj& collation) {
+                               const BSONObj& collation,
+                               bool materialized) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
     if (viewName.db() != viewOn.db())
@@ -368,12 +394,22 @@ Status ViewCatalog::createView(OperationContext* opCtx,
             ErrorCodes::InvalidNamespace,
             "View name cannot start with 'system.', which is reserved for system namespaces");
 
+    if (materialized) {
+        if (viewOn.isSystem())
+            return Status(ErrorCodes::InvalidNamespace,
+                          "A materialized view cannot be defined on a system collection");
+
+        if (_lookup_inlock(opCtx, viewOn.ns()))
+            return Status(ErrorCodes::OptionNotSupportedOnView,
+                          "A materialized view must be defined on a collection, not a view");
+    }
+
     auto collator = parseCollator(opCtx, collation);
     if (!collator.isOK())
         return collator.getStatus();
 
     return _createOrUpdateView_inlock(
-        opCtx, viewName, viewOn, pipeline, std::move(collator.getValue()));
+        opCtx, viewName, viewOn, pipeline, std::move(collator.getValue()), materialized);
 }
 
 Status ViewCatalog::modifyView(OperationContext* opCtx,
@@ -391,6 +427,11 @@ Status ViewCatalog::modifyView(OperationContext* opCtx,
         return Status(ErrorCodes::NamespaceNotFound,
                       str::stream() << "cannot modify missing view " << viewName.ns());
 
+    if (viewPtr->isMaterialized())
+        return Status(ErrorCodes::OptionNotSupportedOnView,
+                      str::stream() << "cannot modify materialized view " << viewName.ns()
+                                    << "; drop and recreate it instead");
+
     if (!NamespaceString::validCollectionName(viewOn.coll()))
         return Status(ErrorCodes::InvalidNamespace,
                       str::stream() << "invalid name for 'viewOn': " << viewOn.coll());
@@ -405,7 +446,8 @@ Status ViewCatalog::modifyView(OperationContext* opCtx,
         viewName,
         viewOn,
         pipeline,
-        CollatorInterface::cloneCollator(savedDefinition.defaultCollator()));
+        CollatorInterface::cloneCollator(savedDefinition.defaultCollator()),
+        false);
 }
 
 Status ViewCatalog::dropView(OperationContext* opCtx, const NamespaceString& viewName) {
@@ -425,9 +467,19 @@ Status ViewCatalog::dropView(OperationContext* opCtx, const NamespaceString& vie
     _durable->remove(opCtx, viewName);
     _viewGraph.remove(savedDefinition.name());
     _viewMap.erase(viewName.ns());
+    if (savedDefinition.isMaterialized()) {
+        // Writes only look for materialized views to maintain while the database has some.
+        _hasMaterializedViews.store(
+            std::any_of(_viewMap.begin(), _viewMap.end(), [](const ViewMap::value_type& entry) {
+                return entry.second->isMaterialized();
+            }));
+    }
     opCtx->recoveryUnit()->onRollback([this, opCtx, viewName, savedDefinition]() {
         this->_viewGraphNeedsRefresh = true;
         this->_viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(savedDefinition);
+        if (savedDefinition.isMaterialized()) {
+            this->_hasMaterializedViews.store(true);
+        }
     });
 
     // We may get invalidated, but we're exclusively locked, so the change must be ours.
@@ -488,10 +540,21 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
                 {*resolvedNss, std::move(resolvedPipeline), std::move(collation)});
         }
 
-        resolvedNss = &(view->viewOn());
         collation = view->defaultCollator() ? view->defaultCollator()->getSpec().toBSON()
                                             : CollationSpec::kSimpleSpec;
 
+        // A materialized view is read from its backing collection, which already holds the
+        // results of the view's pipeline.
+        if (view->isMaterialized()) {
+            auto readPipeline = MaterializedViewPipeline::makeReadPipeline(*view);
+            resolvedPipeline.insert(
+                resolvedPipeline.begin(), readPipeline.begin(), readPipeline.end());
+            return StatusWith<ResolvedView>(
+                {view->backingNss(), std::move(resolvedPipeline), std::move(collation)});
+        }
+
+        resolvedNss = &(view->viewOn());
+
         // Prepend the underlying view's pipeline to the current working pipeline.
         const std::vector<BSONObj>& toPrepend = view->pipeline();
         resolvedPipeline.insert(resolvedPipeline.begin(), toPrepend.begin(), toPrepend.end());
@@ -507,4 +570,25 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
             str::stream() << "View depth too deep or view cycle detected; maximum depth is "
                           << ViewGraph::kMaxViewDepth};
 }
+
+std::vector<std::shared_ptr<ViewDefinition>> ViewCatalog::getMaterializedViewsOn(
+    OperationContext* opCtx, const NamespaceString& nss) {
+    if (_valid.load() && !_hasMaterializedViews.load()) {
+        return {};
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    // An invalid catalog has already been logged, and must not fail writes to the database.
+    if (!_reloadIfNeeded_inlock(opCtx).isOK()) {
+        return {};
+    }
+
+    std::vector<std::shared_ptr<ViewDefinition>> views;
+    for (auto&& view : _viewMap) {
+        if (view.second->isMaterialized() && view.second->viewOn() == nss) {
+            views.push_back(view.second);
+        }
+    }
+    return views;
+}
 }  // namespace mongo
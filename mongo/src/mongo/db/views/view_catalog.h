@@ -79,13 +79,17 @@ public:
      * database's catalog, so the check for an existing collection with the same name must be done
      * before calling createView.
      *
+     * A 'materialized' view must be defined on a collection by a pipeline that
+     * MaterializedViewPipeline can maintain. Creating its backing collection is left to the caller.
+     *
      * Must be in WriteUnitOfWork. View creation rolls back if the unit of work aborts.
      */
     Status createView(OperationContext* opCtx,
                       const NamespaceString& viewName,
                       const NamespaceString& viewOn,
                       const BSONArray& pipeline,
-                      const BSONObj& collation);
+                      const BSONObj& collation,
+                      bool materialized = false);
 
     /**
      * Drop the view named 'viewName'.
@@ -95,7 +99,8 @@ public:
     Status dropView(OperationContext* opCtx, const NamespaceString& viewName);
 
     /**
-     * Modify the view named 'viewName' to have the new 'viewOn' and 'pipeline'.
+     * Modify the view named 'viewName' to have the new 'viewOn' and 'pipeline'. Materialized views
+     * cannot be modified.
      *
      * Must be in WriteUnitOfWork. The modification rolls back if the unit of work aborts.
      */
@@ -117,6 +122,21 @@ public:
      */
     StatusWith<ResolvedView> resolveView(OperationContext* opCtx, const NamespaceString& nss);
 
+    /**
+     * Returns the materialized views defined on the collection 'nss'. This is called on every
+     * write, so it returns without taking the mutex when the database has no materialized views.
+     */
+    std::vector<std::shared_ptr<ViewDefinition>> getMaterializedViewsOn(OperationContext* opCtx,
+                                                                        const NamespaceString& nss);
+
+    /**
+     * Returns true if the database may have materialized views. False means writes to it have no
+     * materialized views to maintain.
+     */
+    bool hasMaterializedViews() const {
+        return _hasMaterializedViews.load();
+    }
+
     /**
      * Reload the views catalog if marked invalid. No-op if already valid. Does only minimal
      * validation, namely that the view definitions are valid BSON and have no unknown fields.
@@ -140,7 +160,8 @@ private:
                                       const NamespaceString& viewName,
                                       const NamespaceString& viewOn,
                                       const BSONArray& pipeline,
-                                      std::unique_ptr<CollatorInterface> collator);
+                                      std::unique_ptr<CollatorInterface> collator,
+                                      bool materialized);
     /**
      * Parses the view definition pipeline, attempts to upsert into the view graph, and refreshes
      * the graph if necessary. Returns an error status if the resulting graph would be invalid.
@@ -176,5 +197,8 @@ private:
     AtomicBool _valid;
     ViewGraph _viewGraph;
     bool _viewGraphNeedsRefresh = true;  // Defers initializing the graph until the first insert.
+    // Whether any view may be materialized. Reset on reload and when the last materialized view is
+    // dropped, so it may be stale in the conservative direction.
+    AtomicBool _hasMaterializedViews;
 };
 }  // namespace mongo
@@ -642,6 +642,118 @@ TEST_F(ViewCatalogFixture, ResolveViewCorrectlyExtractsDefaultCollation) {
                       expectedCollation.getValue()->getSpec().toBSON());
 }
 
+TEST_F(ViewCatalogFixture, ResolveMaterializedViewReadsBackingCollection) {
+    const NamespaceString view1("db.view1");
+    const NamespaceString view2("db.view2");
+    const NamespaceString viewOn("db.coll");
+
+    auto group = BSON("$group" << BSON("_id"
+                                       << "$a"
+                                       << "total"
+                                       << BSON("$sum"
+                                               << "$b")));
+    ASSERT_OK(viewCatalog.createView(
+        opCtx.get(), view1, viewOn, BSON_ARRAY(group), emptyCollation, true));
+    ASSERT_OK(viewCatalog.createView(opCtx.get(),
+                                     view2,
+                                     view1,
+                                     BSON_ARRAY(BSON("$match" << BSON("total" << 2))),
+                                     emptyCollation));
+
+    auto resolvedView = viewCatalog.resolveView(opCtx.get(), view2);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_EQ(resolvedView.getValue().getNamespace(),
+              NamespaceString("db.system.materialized.view1"));
+
+    std::vector<BSONObj> expected = {BSON("$project" << BSON("__materializedViewCount" << 0)),
+                                     BSON("$match" << BSON("total" << 2))};
+    std::vector<BSONObj> result = resolvedView.getValue().getPipeline();
+    ASSERT_EQ(expected.size(), result.size());
+    for (uint32_t i = 0; i < expected.size(); i++) {
+        ASSERT_BSONOBJ_EQ(expected[i], result[i]);
+    }
+
+    ASSERT_EQ(viewCatalog.getMaterializedViewsOn(opCtx.get(), viewOn).size(), 1UL);
+    ASSERT(viewCatalog.getMaterializedViewsOn(opCtx.get(), view1).empty());
+}
+
+TEST_F(ViewCatalogFixture, DroppingTheLastMaterializedViewClearsHasMaterializedViews) {
+    const NamespaceString view1("db.view1");
+    const NamespaceString view2("db.view2");
+    const NamespaceString view3("db.view3");
+    const NamespaceString viewOn("db.coll");
+    auto match = BSON_ARRAY(BSON("$match" << BSON("a" << 1)));
+
+    ASSERT_FALSE(viewCatalog.hasMaterializedViews());
+    ASSERT_OK(viewCatalog.createView(opCtx.get(), view1, viewOn, match, emptyCollation, true));
+    ASSERT_OK(viewCatalog.createView(opCtx.get(), view2, viewOn, match, emptyCollation, true));
+    ASSERT_OK(viewCatalog.createView(opCtx.get(), view3, viewOn, match, emptyCollation));
+    ASSERT_TRUE(viewCatalog.hasMaterializedViews());
+
+    ASSERT_OK(viewCatalog.dropView(opCtx.get(), view1));
+    ASSERT_TRUE(viewCatalog.hasMaterializedViews());
+    ASSERT_OK(viewCatalog.dropView(opCtx.get(), view2));
+    ASSERT_FALSE(viewCatalog.hasMaterializedViews());
+    ASSERT(viewCatalog.getMaterializedViewsOn(opCtx.get(), viewOn).empty());
+}
+
+TEST_F(ViewCatalogFixture, CannotCreateMaterializedViewWithUnsupportedPipeline) {
+    const NamespaceString viewOn("db.coll");
+
+    ASSERT_EQ(viewCatalog.createView(opCtx.get(),
+                                     NamespaceString("db.view1"),
+                                     viewOn,
+                                     BSON_ARRAY(BSON("$limit" << 1)),
+                                     emptyCollation,
+                                     true),
+              ErrorCodes::OptionNotSupportedOnView);
+
+    auto avg = BSON("$group" << BSON("_id"
+                                     << "$a"
+                                     << "avg"
+                                     << BSON("$avg"
+                                             << "$b")));
+    ASSERT_EQ(viewCatalog.createView(opCtx.get(),
+                                     NamespaceString("db.view2"),
+                                     viewOn,
+                                     BSON_ARRAY(avg),
+                                     emptyCollation,
+                                     true),
+              ErrorCodes::OptionNotSupportedOnView);
+
+    ASSERT_EQ(viewCatalog.createView(opCtx.get(),
+                                     NamespaceString("db.view3"),
+                                     viewOn,
+                                     BSON_ARRAY(BSON("$project" << BSON("_id" << 0))),
+                                     emptyCollation,
+                                     true),
+              ErrorCodes::OptionNotSupportedOnView);
+}
+
+TEST_F(ViewCatalogFixture, CannotCreateMaterializedViewOnView) {
+    const NamespaceString view1("db.view1");
+    const NamespaceString viewOn("db.coll");
+
+    ASSERT_OK(viewCatalog.createView(opCtx.get(), view1, viewOn, emptyPipeline, emptyCollation));
+    ASSERT_EQ(viewCatalog.createView(opCtx.get(),
+                                     NamespaceString("db.view2"),
+                                     view1,
+                                     emptyPipeline,
+                                     emptyCollation,
+                                     true),
+              ErrorCodes::OptionNotSupportedOnView);
+}
+
+TEST_F(ViewCatalogFixture, CannotModifyMaterializedView) {
+    const NamespaceString viewName("db.view");
+    const NamespaceString viewOn("db.coll");
+
+    ASSERT_OK(
+        viewCatalog.createView(opCtx.get(), viewName, viewOn, emptyPipeline, emptyCollation, true));
+    ASSERT_EQ(viewCatalog.modifyView(opCtx.get(), viewName, viewOn, emptyPipeline),
+              ErrorCodes::OptionNotSupportedOnView);
+}
+
 TEST_F(ViewCatalogFixture, InvalidateThenReload) {
     const NamespaceString viewName("db.view");
     const NamespaceString viewOn("db.coll");
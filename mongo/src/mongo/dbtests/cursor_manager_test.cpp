@@ -428,6 +428,40 @@ TEST_F(CursorManagerTest, CursorShouldNotTimeOutUntilIdleForLongEnoughAfterBeing
     ASSERT_EQ(0UL, cursorManager->numCursors());
 }
 
+/**
+ * Test that cursors time out in the order they were last used, including after other idle cursors
+ * have been killed or reused.
+ */
+TEST_F(CursorManagerTest, IdleCursorsShouldTimeOutInOrderOfLastUse) {
+    CursorManager* cursorManager = useCursorManager();
+    auto clock = useClock();
+
+    std::vector<CursorId> cursorIds;
+    for (int i = 0; i < 100; ++i) {
+        auto cursorPin = cursorManager->registerCursor(
+            _opCtx.get(), {makeFakePlanExecutor(), kTestNss, {}, false, BSONObj()});
+        cursorIds.push_back(cursorPin.getCursor()->cursorid());
+        clock->advance(Milliseconds(1));
+    }
+
+    // Kill one idle cursor and reuse another, moving it to the back of the line.
+    ASSERT_OK(cursorManager->eraseCursor(_opCtx.get(), cursorIds[10], false));
+    ASSERT_OK(cursorManager->pinCursor(_opCtx.get(), cursorIds[20]).getStatus());
+    ASSERT_EQ(99UL, cursorManager->numCursors());
+
+    // The first 50 cursors, less the killed and reused ones, have now been idle long enough.
+    clock->advance(getDefaultCursorTimeoutMillis() - Milliseconds(50));
+    ASSERT_EQ(48UL, cursorManager->timeoutCursors(_opCtx.get(), clock->now()));
+    ASSERT_EQ(51UL, cursorManager->numCursors());
+    ASSERT_OK(cursorManager->pinCursor(_opCtx.get(), cursorIds[20]).getStatus());
+    ASSERT_EQ(ErrorCodes::CursorNotFound,
+              cursorManager->pinCursor(_opCtx.get(), cursorIds[49]).getStatus());
+
+    clock->advance(getDefaultCursorTimeoutMillis());
+    ASSERT_EQ(51UL, cursorManager->timeoutCursors(_opCtx.get(), clock->now()));
+    ASSERT_EQ(0UL, cursorManager->numCursors());
+}
+
 /**
  * Test that cursors inherit the logical session id from their operation context
  */
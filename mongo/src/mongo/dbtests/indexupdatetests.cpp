@@ -38,10 +38,14 @@
 #include "mongo/db/client.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_d.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/util/scopeguard.h"
 
 namespace IndexUpdateTests {
 
@@ -307,6 +311,140 @@ public:
     }
 };
 
+/** A foreground build generating keys on several threads still produces a complete index. */
+class InsertBuildParallelKeyGeneration : public IndexBuildBase {
+public:
+    void run() {
+        auto param = ServerParameterSet::getGlobal()->getMap().find(
+            "indexBuildKeyGenerationThreads")->second;
+        ASSERT_OK(param->setFromString("4"));
+        ON_BLOCK_EXIT([&] { ASSERT_OK(param->setFromString("1")); });
+
+        Database* db = _ctx.db();
+        Collection* coll;
+        const int32_t nDocs = 2000;
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            db->dropCollection(&_opCtx, _ns).transitional_ignore();
+            coll = db->createCollection(&_opCtx, _ns);
+            OpDebug* const nullOpDebug = nullptr;
+            // Insert in descending order so that every lane sees keys out of order.
+            for (int32_t i = nDocs - 1; i >= 0; --i) {
+                ASSERT_OK(coll->insertDocument(
+                    &_opCtx,
+                    InsertStatement(BSON("_id" << i << "a" << i << "b" << BSON_ARRAY(i << -i))),
+                    nullOpDebug,
+                    true));
+            }
+            wunit.commit();
+        }
+
+        MultiIndexBlock indexer(&_opCtx, coll);
+        const BSONObj spec = BSON("name"
+                                  << "a_1_b_1"
+                                  << "ns"
+                                  << coll->ns().ns()
+                                  << "key"
+                                  << BSON("a" << 1 << "b" << 1)
+                                  << "v"
+                                  << static_cast<int>(kIndexVersion));
+        ASSERT_OK(indexer.init(spec).getStatus());
+        ASSERT_OK(indexer.insertAllDocumentsInCollection());
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            indexer.commit();
+            wunit.commit();
+        }
+
+        auto desc = coll->getIndexCatalog()->findIndexByName(&_opCtx, "a_1_b_1");
+        ASSERT(desc);
+        ASSERT(desc->isMultikey(&_opCtx));
+
+        // Every document is reachable through the index, in key order.
+        auto cursor = _client.query(_ns, Query().hint(BSON("a" << 1 << "b" << 1)));
+        int32_t expected = 0;
+        while (cursor->more()) {
+            ASSERT_EQ(cursor->next()["a"].numberInt(), expected++);
+        }
+        ASSERT_EQ(expected, nDocs);
+    }
+};
+
+/** A hybrid background build applies the writes made while it loads the index. */
+class InsertBuildHybridAppliesConcurrentWrites : public IndexBuildBase {
+public:
+    void run() {
+        Database* db = _ctx.db();
+        Collection* coll;
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            db->dropCollection(&_opCtx, _ns).transitional_ignore();
+            coll = db->createCollection(&_opCtx, _ns);
+            OpDebug* const nullOpDebug = nullptr;
+            for (int32_t i = 0; i < 1000; ++i) {
+                ASSERT_OK(coll->insertDocument(
+                    &_opCtx, InsertStatement(BSON("_id" << i << "a" << i)), nullOpDebug, true));
+            }
+            wunit.commit();
+        }
+
+        MultiIndexBlock indexer(&_opCtx, coll);
+        indexer.allowBackgroundBuilding();
+        indexer.allowInterruption();
+        const BSONObj spec = BSON("name"
+                                  << "a_1"
+                                  << "ns"
+                                  << coll->ns().ns()
+                                  << "key"
+                                  << BSON("a" << 1)
+                                  << "v"
+                                  << static_cast<int>(kIndexVersion)
+                                  << "background"
+                                  << true);
+        ASSERT_OK(indexer.init(spec).getStatus());
+
+        auto desc = coll->getIndexCatalog()->findIndexByName(&_opCtx, "a_1", true);
+        ASSERT(desc);
+        IndexAccessMethod* iam = coll->getIndexCatalog()->getIndex(desc);
+        if (getGlobalServiceContext()->getGlobalStorageEngine()->supportsDocLocking()) {
+            ASSERT(iam->getIndexBuildInterceptor());
+        }
+
+        // Writes made before and after the collection scan, including ones that make the index
+        // multikey and ones that remove documents the scan already indexed.
+        _client.remove(_ns, BSON("_id" << BSON("$lt" << 100)));
+        _client.update(_ns, BSON("_id" << 100), BSON("$set" << BSON("a" << -1)));
+        _client.insert(_ns, BSON("_id" << 1000 << "a" << BSON_ARRAY(1000 << 1001)));
+        ASSERT_OK(indexer.insertAllDocumentsInCollection());
+        _client.update(_ns, BSON("_id" << 101), BSON("$set" << BSON("a" << -2)));
+        _client.remove(_ns, BSON("_id" << 102));
+        _client.insert(_ns, BSON("_id" << 1001 << "a" << 2000));
+
+        ASSERT_OK(indexer.drainBackgroundWrites());
+        ASSERT(!iam->getIndexBuildInterceptor());
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            indexer.commit();
+            wunit.commit();
+        }
+        ASSERT(desc->isMultikey(&_opCtx));
+
+        // One key per document, plus the second key of the array.
+        size_t numEntries = 0;
+        auto cursor = iam->newCursor(&_opCtx);
+        for (auto kv = cursor->seek(kMinBSONKey, true); kv; kv = cursor->next()) {
+            ++numEntries;
+        }
+        ASSERT_EQ(numEntries, 900U - 1U + 2U + 1U);
+
+        auto lowKeys = _client.query(
+            _ns, Query(BSON("a" << BSON("$lt" << 103))).sort(BSON("a" << 1)).hint(BSON("a" << 1)));
+        ASSERT_EQ(lowKeys->next()["_id"].numberInt(), 101);
+        ASSERT_EQ(lowKeys->next()["_id"].numberInt(), 100);
+        ASSERT(!lowKeys->more());
+    }
+};
+
 /** Index creation is not killed if mayInterrupt is false. */
 class InsertBuildIndexInterruptDisallowed : public IndexBuildBase {
 public:
@@ -816,6 +954,8 @@ public:
         add<InsertBuildFillDups<false>>();
         add<InsertBuildIndexInterrupt>();
         add<InsertBuildIndexInterruptDisallowed>();
+        add<InsertBuildParallelKeyGeneration>();
+        add<InsertBuildHybridAppliesConcurrentWrites>();
         add<InsertBuildIdIndexInterrupt>();
         add<InsertBuildIdIndexInterruptDisallowed>();
         add<SameSpecDifferentOption>();
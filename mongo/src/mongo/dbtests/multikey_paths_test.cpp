@@ -30,6 +30,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "mongo/db/catalog/index_create.h"
 #include "mongo/db/client.h"
@@ -251,6 +252,40 @@ TEST_F(MultikeyPathsTest, PathsUpdatedOnDocumentInsert) {
     assertMultikeyPaths(collection, keyPattern, {{0U}, {0U}});
 }
 
+TEST_F(MultikeyPathsTest, PathsUpdatedOnBatchedDocumentInsert) {
+    AutoGetCollection autoColl(_opCtx.get(), _nss, MODE_X);
+    Collection* collection = autoColl.getCollection();
+    invariant(collection);
+
+    BSONObj keyPattern = BSON("a" << 1 << "b" << 1);
+    createIndex(collection,
+                BSON("name"
+                     << "a_1_b_1"
+                     << "ns"
+                     << _nss.ns()
+                     << "key"
+                     << keyPattern
+                     << "v"
+                     << static_cast<int>(kIndexVersion)))
+        .transitional_ignore();
+
+    {
+        std::vector<InsertStatement> inserts;
+        inserts.emplace_back(BSON("_id" << 0 << "a" << 5 << "b" << 1));
+        inserts.emplace_back(BSON("_id" << 1 << "a" << 5 << "b" << BSON_ARRAY(1 << 2 << 3)));
+        inserts.emplace_back(BSON("_id" << 2 << "a" << BSON_ARRAY(1 << 2 << 3) << "b" << 5));
+
+        WriteUnitOfWork wuow(_opCtx.get());
+        OpDebug* const nullOpDebug = nullptr;
+        const bool enforceQuota = true;
+        ASSERT_OK(collection->insertDocuments(
+            _opCtx.get(), inserts.begin(), inserts.end(), nullOpDebug, enforceQuota));
+        wuow.commit();
+    }
+
+    assertMultikeyPaths(collection, keyPattern, {{0U}, {0U}});
+}
+
 TEST_F(MultikeyPathsTest, PathsUpdatedOnDocumentUpdate) {
     AutoGetCollection autoColl(_opCtx.get(), _nss, MODE_X);
     Collection* collection = autoColl.getCollection();
@@ -300,6 +335,7 @@ TEST_F(MultikeyPathsTest, PathsUpdatedOnDocumentUpdate) {
                 BSON("_id" << 0 << "a" << 5 << "b" << BSON_ARRAY(1 << 2 << 3)),
                 enforceQuota,
                 indexesAffected,
+                nullptr,
                 opDebug,
                 &args);
             wuow.commit();
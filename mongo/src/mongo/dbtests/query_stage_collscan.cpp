@@ -44,10 +44,12 @@
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/fail_point_service.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageCollectionScan {
 
@@ -200,6 +202,31 @@ public:
     }
 };
 
+//
+// Skip runs of non-matching docs in batches, including a batch which ends the scan and a filter
+// that matches nothing.
+//
+
+class QueryStageCollscanBatchedSparseMatch : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        const int oldBatchSize = internalQueryExecCollectionScanBatchSize.load();
+        internalQueryExecCollectionScanBatchSize.store(8);
+        ON_BLOCK_EXIT(
+            [oldBatchSize] { internalQueryExecCollectionScanBatchSize.store(oldBatchSize); });
+
+        BSONObj obj = BSON("foo" << BSON("$in" << BSON_ARRAY(0 << 17 << 18 << 40)));
+        ASSERT_EQUALS(4, countResults(CollectionScanParams::FORWARD, obj));
+        ASSERT_EQUALS(4, countResults(CollectionScanParams::BACKWARD, obj));
+
+        obj = BSON("foo" << BSON("$lt" << 25));
+        ASSERT_EQUALS(25, countResults(CollectionScanParams::FORWARD, obj));
+
+        obj = BSON("bar" << BSON("$exists" << true));
+        ASSERT_EQUALS(0, countResults(CollectionScanParams::FORWARD, obj));
+    }
+};
+
 //
 // Get objects in the order we inserted them.
 //
@@ -410,6 +437,7 @@ public:
         add<QueryStageCollscanBasicBackward>();
         add<QueryStageCollscanBasicForwardWithMatch>();
         add<QueryStageCollscanBasicBackwardWithMatch>();
+        add<QueryStageCollscanBatchedSparseMatch>();
         add<QueryStageCollscanObjectsInOrderForward>();
         add<QueryStageCollscanObjectsInOrderBackward>();
         add<QueryStageCollscanInvalidateUpcomingObject>();
@@ -43,8 +43,10 @@
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageFetch {
 
@@ -219,6 +221,73 @@ public:
     }
 };
 
+//
+// Test that batched fetching returns members in the order the child produced them, not in the
+// RecordId order used for the lookups, and drops members whose document has gone away.
+//
+class FetchStageBatchedPreservesChildOrder : public QueryStageFetchBase {
+public:
+    void run() {
+        const int oldBatchSize = internalQueryExecFetchBatchSize.load();
+        internalQueryExecFetchBatchSize.store(8);
+        ON_BLOCK_EXIT([oldBatchSize] { internalQueryExecFetchBatchSize.store(oldBatchSize); });
+
+        OldClientWriteContext ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = db->getCollection(&_opCtx, ns());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        WorkingSet ws;
+
+        // Enough documents to get past the unbatched results at the start of the scan.
+        const int numDocs = internalQueryPlanEvaluationMaxResults.load() + 50;
+        for (int i = 0; i < numDocs; ++i) {
+            insert(BSON("foo" << i));
+        }
+        set<RecordId> recordIds;
+        getRecordIds(&recordIds, coll);
+        ASSERT_EQUALS(static_cast<size_t>(numDocs), recordIds.size());
+
+        // This document's RecordId is still handed to the fetch, but there is nothing to fetch.
+        const int removedFoo = numDocs - 10;
+        remove(BSON("foo" << removedFoo));
+
+        // Hand out the RecordIds in descending order, as a backwards index scan would.
+        auto mockStage = make_unique<QueuedDataStage>(&_opCtx, &ws);
+        for (auto it = recordIds.rbegin(); it != recordIds.rend(); ++it) {
+            WorkingSetID id = ws.allocate();
+            WorkingSetMember* mockMember = ws.get(id);
+            mockMember->recordId = *it;
+            ws.transitionToRecordIdAndIdx(id);
+            mockStage->pushBack(id);
+        }
+
+        unique_ptr<FetchStage> fetchStage(
+            new FetchStage(&_opCtx, &ws, mockStage.release(), NULL, coll));
+
+        int expectedFoo = numDocs - 1;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state;
+        while ((state = fetchStage->work(&id)) != PlanStage::IS_EOF) {
+            if (state != PlanStage::ADVANCED) {
+                ASSERT_EQUALS(PlanStage::NEED_TIME, state);
+                continue;
+            }
+            if (expectedFoo == removedFoo) {
+                --expectedFoo;
+            }
+            ASSERT_EQUALS(expectedFoo, ws.get(id)->obj.value()["foo"].numberInt());
+            ws.free(id);
+            --expectedFoo;
+        }
+        ASSERT_EQUALS(-1, expectedFoo);
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_fetch") {}
@@ -226,6 +295,7 @@ public:
     void setupTests() {
         add<FetchStageAlreadyFetched>();
         add<FetchStageFilter>();
+        add<FetchStageBatchedPreservesChildOrder>();
     }
 };
 
@@ -52,8 +52,12 @@
 #include "mongo/db/query/query_planner_test_lib.h"
 #include "mongo/db/query/stage_builder.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/fail_point_service.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -551,5 +555,169 @@ TEST_F(QueryStageMultiPlanTest, ShouldReportErrorIfKilledDuringPlanning) {
               multiPlanStage.pickBestPlan(&alwaysPlanKilledYieldPolicy));
 }
 
+// With single-flight planning enabled, a trial must still cache its winner and must release its
+// registration once it finishes, so that later queries of the shape never wait on it.
+TEST_F(QueryStageMultiPlanTest, SingleFlightTrialCachesWinnerAndReleasesShape) {
+    const int N = 5000;
+    for (int i = 0; i < N; ++i) {
+        insert(BSON("foo" << (i % 10)));
+    }
+
+    // Add two indices to give more plans.
+    addIndex(BSON("foo" << 1));
+    addIndex(BSON("foo" << -1 << "bar" << 1));
+
+    const bool singleFlightOldValue = internalQueryPlanSingleFlightEnabled.load();
+    ON_BLOCK_EXIT([&] { internalQueryPlanSingleFlightEnabled.store(singleFlightOldValue); });
+    internalQueryPlanSingleFlightEnabled.store(true);
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    Collection* coll = ctx.getCollection();
+
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(BSON("foo" << 7));
+    auto cq = uassertStatusOK(CanonicalQuery::canonicalize(opCtx(), std::move(qr)));
+    const CanonicalQuery& query = *cq;
+    ASSERT_FALSE(MultiPlanStage::waitForConcurrentTrial(opCtx(), coll, query));
+
+    auto exec =
+        uassertStatusOK(getExecutor(opCtx(), coll, std::move(cq), PlanExecutor::NO_YIELD, 0));
+    ASSERT_EQ(exec->getRootStage()->stageType(), STAGE_MULTI_PLAN);
+    ASSERT_TRUE(coll->infoCache()->getPlanCache()->contains(query));
+    ASSERT_FALSE(MultiPlanStage::waitForConcurrentTrial(opCtx(), coll, query));
+}
+
+// A query of a shape whose trial another thread is running waits for that trial, and finds its
+// winner in the plan cache once it wakes up.
+TEST_F(QueryStageMultiPlanTest, SingleFlightWaiterFindsTheWinnerOfTheConcurrentTrial) {
+    const int N = 5000;
+    for (int i = 0; i < N; ++i) {
+        insert(BSON("foo" << (i % 10)));
+    }
+    addIndex(BSON("foo" << 1));
+    addIndex(BSON("foo" << -1 << "bar" << 1));
+
+    const bool singleFlightOldValue = internalQueryPlanSingleFlightEnabled.load();
+    const int maxWaitOldValue = internalQueryPlanSingleFlightMaxWaitMillis.load();
+    ON_BLOCK_EXIT([&] {
+        internalQueryPlanSingleFlightEnabled.store(singleFlightOldValue);
+        internalQueryPlanSingleFlightMaxWaitMillis.store(maxWaitOldValue);
+    });
+    internalQueryPlanSingleFlightEnabled.store(true);
+
+    FailPoint* hangTrial =
+        getGlobalFailPointRegistry()->getFailPoint("hangAfterRegisteringSingleFlightTrial");
+    hangTrial->setMode(FailPoint::alwaysOn);
+    ON_BLOCK_EXIT([&] { hangTrial->setMode(FailPoint::off); });
+
+    auto makeQuery = [](OperationContext* opCtx) {
+        auto qr = stdx::make_unique<QueryRequest>(nss);
+        qr->setFilter(BSON("foo" << 7));
+        return uassertStatusOK(CanonicalQuery::canonicalize(opCtx, std::move(qr)));
+    };
+
+    // The trial registers its shape, then hangs until the fail point is turned off.
+    StageType trialRootType = STAGE_EOF;
+    stdx::thread trialThread([&] {
+        Client::initThread("singleFlightTrial");
+        ON_BLOCK_EXIT([] { Client::destroy(); });
+        auto opCtx = cc().makeOperationContext();
+        AutoGetCollectionForReadCommand ctx(opCtx.get(), nss);
+        auto exec = uassertStatusOK(getExecutor(
+            opCtx.get(), ctx.getCollection(), makeQuery(opCtx.get()), PlanExecutor::NO_YIELD, 0));
+        trialRootType = exec->getRootStage()->stageType();
+    });
+
+    // Nothing may throw while the threads run, since they must be joined.
+    bool cachedDuringTrial = true;
+    {
+        AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+        auto cq = makeQuery(_opCtx.get());
+        internalQueryPlanSingleFlightMaxWaitMillis.store(1);
+        while (!MultiPlanStage::waitForConcurrentTrial(_opCtx.get(), ctx.getCollection(), *cq)) {
+            sleepmillis(10);
+        }
+        cachedDuringTrial = ctx.getCollection()->infoCache()->getPlanCache()->contains(*cq);
+    }
+
+    internalQueryPlanSingleFlightMaxWaitMillis.store(60 * 1000);
+    AtomicBool waiterDone(false);
+    bool waited = false;
+    bool cachedOnWakeUp = false;
+    stdx::thread waiterThread([&] {
+        Client::initThread("singleFlightWaiter");
+        ON_BLOCK_EXIT([] { Client::destroy(); });
+        auto opCtx = cc().makeOperationContext();
+        AutoGetCollectionForReadCommand ctx(opCtx.get(), nss);
+        auto cq = makeQuery(opCtx.get());
+        waited = MultiPlanStage::waitForConcurrentTrial(opCtx.get(), ctx.getCollection(), *cq);
+        cachedOnWakeUp = ctx.getCollection()->infoCache()->getPlanCache()->contains(*cq);
+        waiterDone.store(true);
+    });
+
+    // The waiter stays blocked for as long as the trial is held.
+    sleepmillis(500);
+    const bool waiterDoneDuringTrial = waiterDone.load();
+
+    hangTrial->setMode(FailPoint::off);
+    trialThread.join();
+    waiterThread.join();
+
+    ASSERT_FALSE(cachedDuringTrial);
+    ASSERT_FALSE(waiterDoneDuringTrial);
+    ASSERT_EQ(STAGE_MULTI_PLAN, trialRootType);
+    ASSERT_TRUE(waited);
+    ASSERT_TRUE(cachedOnWakeUp);
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    auto cq = makeQuery(opCtx());
+    ASSERT_FALSE(MultiPlanStage::waitForConcurrentTrial(opCtx(), ctx.getCollection(), *cq));
+}
+
+// With cardinality estimates enabled, candidates whose index scans cover far more keys than the
+// most selective candidate are dropped before the trial period.
+TEST_F(QueryStageMultiPlanTest, CardinalityEstimatePrunesUnselectiveCandidates) {
+    const int N = 1000;
+    for (int i = 0; i < N; ++i) {
+        insert(BSON("a" << i << "b" << (i % 2)));
+    }
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("b" << 1));
+
+    const int maxKeysOldValue = internalQueryPlanCardinalityEstimateMaxKeys.load();
+    internalQueryPlanCardinalityEstimateMaxKeys.store(N);
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    Collection* collection = ctx.getCollection();
+
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(BSON("a" << 7 << "b" << 1));
+    auto cq = uassertStatusOK(CanonicalQuery::canonicalize(opCtx(), std::move(qr)));
+
+    QueryPlannerParams plannerParams;
+    fillOutPlannerParams(_opCtx.get(), collection, cq.get(), &plannerParams);
+    vector<QuerySolution*> solutions;
+    ASSERT_OK(QueryPlanner::plan(*cq, plannerParams, &solutions));
+    ASSERT_GTE(solutions.size(), 2U);
+
+    auto mps = stdx::make_unique<MultiPlanStage>(_opCtx.get(), collection, cq.get());
+    auto ws = stdx::make_unique<WorkingSet>();
+    for (size_t i = 0; i < solutions.size(); ++i) {
+        PlanStage* root;
+        ASSERT(StageBuilder::build(_opCtx.get(), collection, *cq, *solutions[i], ws.get(), &root));
+        mps->addPlan(solutions[i], root, ws.get());
+    }
+
+    PlanYieldPolicy yieldPolicy(PlanExecutor::NO_YIELD, _clock);
+    ASSERT_OK(mps->pickBestPlan(&yieldPolicy));
+    internalQueryPlanCardinalityEstimateMaxKeys.store(maxKeysOldValue);
+
+    // Only the plan scanning the single key {a: 7} survives to the trial period.
+    ASSERT_EQUALS(mps->getStats()->children.size(), 1U);
+    ASSERT(QueryPlannerTestLib::solutionMatches(
+        "{fetch: {filter: {b: 1}, node: {ixscan: {filter: null, pattern: {a: 1}}}}}",
+        mps->bestSolution()->root.get()));
+}
+
 }  // namespace
 }  // namespace mongo
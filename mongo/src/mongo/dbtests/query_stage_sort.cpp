@@ -362,7 +362,8 @@ public:
         args.nss = coll->ns();
         {
             WriteUnitOfWork wuow(&_opCtx);
-            coll->updateDocument(&_opCtx, *it, oldDoc, newDoc(oldDoc), false, false, NULL, &args);
+            coll->updateDocument(
+                &_opCtx, *it, oldDoc, newDoc(oldDoc), false, false, NULL, NULL, &args);
             wuow.commit();
         }
         ASSERT_OK(exec->restoreState());
@@ -381,7 +382,7 @@ public:
             {
                 WriteUnitOfWork wuow(&_opCtx);
                 coll->updateDocument(
-                    &_opCtx, *it++, oldDoc, newDoc(oldDoc), false, false, NULL, &args);
+                    &_opCtx, *it++, oldDoc, newDoc(oldDoc), false, false, NULL, NULL, &args);
                 wuow.commit();
             }
         }
@@ -36,6 +36,7 @@
 #include "mongo/config.h"
 #include "mongo/executor/async_stream_common.h"
 #include "mongo/util/log.h"
+#include "mongo/util/net/hostandport.h"
 #include "mongo/util/net/ssl_manager.h"
 
 #ifdef MONGO_CONFIG_SSL
@@ -88,6 +89,9 @@ void AsyncSecureStream::read(asio::mutable_buffer buffer, StreamHandler&& stream
 }
 
 void AsyncSecureStream::_handleConnect(asio::ip::tcp::resolver::iterator iter) {
+    _remoteHost = HostAndPort(iter->host_name(), iter->endpoint().port()).toString();
+    getSSLManager()->offerResumableSession(_stream.native_handle(), _remoteHost);
+
     _stream.async_handshake(decltype(_stream)::client,
                             _strand->wrap([this, iter](std::error_code ec) {
                                 if (ec) {
@@ -103,6 +107,8 @@ void AsyncSecureStream::_handleHandshake(std::error_code ec, const std::string&
     if (!certStatus.isOK()) {
         warning() << "Failed to validate peer certificate during SSL handshake: "
                   << certStatus.getStatus();
+    } else {
+        getSSLManager()->saveResumableSession(_stream.native_handle(), _remoteHost);
     }
     _userHandler(make_error_code(certStatus.getStatus().code()));
 }
@@ -34,6 +34,7 @@
 
 #include <asio.hpp>
 #include <asio/ssl.hpp>
+#include <string>
 
 #include "mongo/executor/async_stream_interface.h"
 
@@ -65,6 +66,8 @@ private:
     asio::io_service::strand* const _strand;
     asio::ssl::stream<asio::ip::tcp::socket> _stream;
     ConnectHandler _userHandler;
+    // Key under which this connection's TLS session is cached for resumption.
+    std::string _remoteHost;
     bool _connected = false;
 };
 
@@ -153,6 +153,17 @@ public:
     size_t openConnections(const stdx::unique_lock<stdx::mutex>& lk);
 
 private:
+    /**
+     * Records the current demand on the pool, for the purposes of adaptiveMinConnections.
+     */
+    void recordDemand(const stdx::unique_lock<stdx::mutex>& lk);
+
+    /**
+     * Returns the number of connections the pool keeps open even without demand: minConnections,
+     * or the recent peak demand if adaptiveMinConnections is set and that is larger.
+     */
+    size_t minConnections(const stdx::unique_lock<stdx::mutex>& lk);
+
     using OwnedConnection = std::unique_ptr<ConnectionInterface>;
     using OwnershipPool = stdx::unordered_map<ConnectionInterface*, OwnedConnection>;
     using LRUOwnershipPool = LRUCache<OwnershipPool::key_type, OwnershipPool::mapped_type>;
@@ -229,6 +240,12 @@ droppedProcessingPool
 
     size_t _created;
 
+    // The peak demand seen since _demandWindowStart, and over the refreshRequirement period before
+    // it. Only maintained if adaptiveMinConnections is set.
+    size_t _demandPeak;
+    size_t _priorDemandPeak;
+    Date_t _demandWindowStart;
+
     /**
      * The current state of the pool
      *
@@ -360,6 +377,9 @@ ConnectionPool::SpecificPool::SpecificPool(ConnectionPool* parent, const HostAnd
       _inFulfillRequests(false),
       _inSpawnConnections(false),
       _created(0),
+      _demandPeak(0),
+      _priorDemandPeak(0),
+      _demandWindowStart(parent->_factory->now()),
       _state(State::kRunning) {}
 
 ConnectionPool::SpecificPool::~SpecificPool() {
@@ -387,6 +407,34 @@ size_t ConnectionPool::SpecificPool::createdConnections(const stdx::unique_lock<
 size_t ConnectionPool::SpecificPool::openConnections(const stdx::unique_lock<stdx::mutex>& lk) {
     return _checkedOutPool.size() + _readyPool.size() + _processingPool.size();
 }
+
+void ConnectionPool::SpecificPool::recordDemand(const stdx::unique_lock<stdx::mutex>& lk) {
+    if (!_parent->_options.adaptiveMinConnections)
+        return;
+
+    // Force the demand window forward before folding in the current demand.
+    minConnections(lk);
+    _demandPeak = std::max(_demandPeak, _requests.size() + _checkedOutPool.size());
+}
+
+size_t ConnectionPool::SpecificPool::minConnections(const stdx::unique_lock<stdx::mutex>& lk) {
+    const auto& options = _parent->_options;
+    if (!options.adaptiveMinConnections)
+        return options.minConnections;
+
+    const auto now = _parent->_factory->now();
+    const auto window = options.refreshRequirement;
+    if (now - _demandWindowStart >= window) {
+        // If a whole window has passed since the previous one ended, its peak is too old to count.
+        _priorDemandPeak = (now - _demandWindowStart >= window * 2) ? 0 : _demandPeak;
+        _demandPeak = 0;
+        _demandWindowStart = now;
+    }
+
+    const auto recentDemand = std::min(std::max(_demandPeak, _priorDemandPeak),
+                                       options.maxConnections);
+    return std::max(options.minConnections, recentDemand);
+}
 //mongosͺmongod:mongosͺmongodӴNetworkInterfaceASIO::_connectmongosתݵmongodNetworkInterfaceASIO::_beginCommunication
 //mongosͿͻ˽:ServiceEntryPointMongos::handleRequest
 
@@ -403,6 +451,7 @@ void ConnectionPool::SpecificPool::getConnection(const HostAndPort& hostAndPort,
 
     _requests.push(make_pair(expiration, std::move(cb)));
 
+    recordDemand(lk);
     updateStateInLock();
 
     spawnConnections(lk);  //潨 
@@ -438,7 +487,7 @@ void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr
         // If we need to refresh this connection
 
         if (_readyPool.size() + _processingPool.size() + _checkedOutPool.size() >=
-            _parent->_options.minConnections) {
+            minConnections(lk)) {
             // If we already have minConnections, just let the connection lapse
             log() << "Ending idle connection to host " << _hostAndPort
                   << " because the pool meets constraints; " << openConnections(lk)
@@ -659,9 +708,10 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
     auto guard = MakeGuard([&] { _inSpawnConnections = false; });
 
     // We want minConnections <= outstanding requests <= maxConnections
+    const auto minConns = minConnections(lk);
     auto target = [&] {
         return std::max(
-            _parent->_options.minConnections,
+            minConns,
             std::min(_requests.size() + _checkedOutPool.size(), _parent->_options.maxConnections));
     };
 
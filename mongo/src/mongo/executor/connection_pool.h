@@ -116,6 +116,16 @@ public:
          */
         size_t maxConnecting = kDefaultMaxConnecting;
 
+        /**
+         * If true, the pool treats the peak demand for a host (pending requests plus checked out
+         * connections) seen over the last one to two refreshRequirement periods as a floor on
+         * its size, in addition to minConnections and bounded by maxConnections.  Connections to
+         * the host are kept alive and re-established up to that floor, so a host that recently
+         * served a burst stays warm and the next burst does not open all of its connections at
+         * once.
+         */
+        bool adaptiveMinConnections = false;
+
         /**
          * Amount of time to wait before timing out a refresh attempt
          */
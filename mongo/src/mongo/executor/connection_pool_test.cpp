@@ -268,6 +268,53 @@ TEST_F(ConnectionPoolTest, ConnectionsNotUsedRecentlyArePurged) {
     ASSERT_EQ(pool.getNumConnectionsPerHost(HostAndPort()), kSize / 4);
 }
 
+/**
+ * Verify that with adaptiveMinConnections, idle connections are refreshed rather than purged while
+ * the demand that opened them is recent, and are purged once it is not.
+ */
+TEST_F(ConnectionPoolTest, AdaptiveMinConnectionsKeepsRecentDemandWarm) {
+    ConnectionPool::Options options;
+    options.minConnections = 0;
+    options.refreshRequirement = Milliseconds(1000);
+    options.refreshTimeout = Milliseconds(500);
+    options.hostTimeout = Minutes(1);
+    options.adaptiveMinConnections = true;
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    // Check out kSize connections at once, then return them all.
+    constexpr size_t kSize = 10;
+    std::vector<ConnectionPool::ConnectionHandle> connections;
+    for (size_t i = 0; i != kSize; ++i) {
+        ConnectionImpl::pushSetup(Status::OK());
+        pool.get(HostAndPort(),
+                 Milliseconds(5000),
+                 [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                     ASSERT(swConn.isOK());
+                     connections.push_back(std::move(swConn.getValue()));
+                 });
+    }
+    ASSERT_EQ(pool.getNumConnectionsPerHost(HostAndPort()), kSize);
+    while (!connections.empty()) {
+        doneWith(connections.back());
+        connections.pop_back();
+    }
+
+    // Once the connections need refreshing, the burst is still recent, so they are refreshed.
+    for (size_t i = 0; i != kSize; ++i) {
+        ConnectionImpl::pushRefresh(Status::OK());
+    }
+    PoolImpl::setNow(now + Milliseconds(1000));
+    ASSERT_EQ(pool.getNumConnectionsPerHost(HostAndPort()), kSize);
+    ASSERT_EQ(ConnectionImpl::refreshQueueDepth(), 0U);
+
+    // A refresh requirement period later the burst has aged out, so they lapse.
+    PoolImpl::setNow(now + Milliseconds(2000));
+    ASSERT_EQ(pool.getNumConnectionsPerHost(HostAndPort()), 0U);
+}
+
 /**
  * Verify that a failed connection isn't returned to the pool
  */
@@ -116,6 +116,8 @@ func (dump *MongoDump) ValidateOptions() error {
 		return fmt.Errorf("compression can't be used when dumping a single collection to standard output")
 	case dump.OutputOptions.NumParallelCollections <= 0:
 		return fmt.Errorf("numParallelCollections must be positive")
+	case dump.OutputOptions.NumPartitionsPerCollection <= 0:
+		return fmt.Errorf("numPartitionsPerCollection must be positive")
 	}
 	return nil
 }
@@ -534,6 +536,7 @@ func (dump *MongoDump) DumpIntent(intent *intents.Intent, buffer resettableOutpu
 	session.SetPrefetch(1.0)
 
 	var findQuery *mgo.Query
+	var partitions []partitionBounds
 	switch {
 	case len(dump.query) > 0:
 		findQuery = session.DB(intent.DB).C(intent.C).Find(dump.query)
@@ -545,6 +548,10 @@ func (dump *MongoDump) DumpIntent(intent *intents.Intent, buffer resettableOutpu
 		findQuery = session.DB(intent.DB).C(intent.C).Find(nil)
 	default:
 		findQuery = session.DB(intent.DB).C(intent.C).Find(nil).Snapshot()
+		// like a snapshot query, each partition walks the _id index
+		if !dump.OutputOptions.Repair {
+			partitions = dump.planPartitions(session, intent)
+		}
 	}
 
 	var dumpCount int64
@@ -568,7 +575,12 @@ func (dump *MongoDump) DumpIntent(intent *intents.Intent, buffer resettableOutpu
 		}
 	}
 
-	if !dump.OutputOptions.Repair {
+	if len(partitions) > 0 {
+		log.Logvf(log.Always, "writing %v to %v in %v partitions", intent.Namespace(), intent.Location, len(partitions))
+		if dumpCount, err = dump.dumpPartitionsToIntent(session, findQuery, partitions, intent, buffer); err != nil {
+			return err
+		}
+	} else if !dump.OutputOptions.Repair {
 		log.Logvf(log.Always, "writing %v to %v", intent.Namespace(), intent.Location)
 		if dumpCount, err = dump.dumpQueryToIntent(findQuery, intent, buffer); err != nil {
 			return err
@@ -606,12 +618,50 @@ func (dump *MongoDump) dumpQueryToIntent(
 	return dump.dumpFilteredQueryToIntent(query, intent, buffer, copyDocumentFilter)
 }
 
+// dumpPartitionsToIntent reads each of the given _id ranges of the intent's collection
+// with its own connection and writes the raw bson results to the intent. The query is only
+// used to count the collection. Returns a final count of documents dumped, and any errors
+// that occured.
+func (dump *MongoDump) dumpPartitionsToIntent(session *mgo.Session, query *mgo.Query,
+	partitions []partitionBounds, intent *intents.Intent, buffer resettableOutputBuffer) (int64, error) {
+	return dump.dumpItersToIntent(query, intent, buffer, copyDocumentFilter, func() ([]*mgo.Iter, func(), error) {
+		sessions := make([]*mgo.Session, 0, len(partitions))
+		closeAll := func() {
+			for _, s := range sessions {
+				s.Close()
+			}
+		}
+		iters := make([]*mgo.Iter, 0, len(partitions))
+		for _, partition := range partitions {
+			partitionSession := session.Copy()
+			sessions = append(sessions, partitionSession)
+			iter, err := partitionIter(partitionSession, intent, partition)
+			if err != nil {
+				closeAll()
+				return nil, nil, err
+			}
+			iters = append(iters, iter)
+		}
+		return iters, closeAll, nil
+	})
+}
+
 // dumpFilterQueryToIntent takes an mgo Query, its intent, a writer, and a document filter, performs the query,
 // passes the results through the filter
 // and writes the raw bson results to the writer. Returns a final count of documents
 // dumped, and any errors that occured.
 func (dump *MongoDump) dumpFilteredQueryToIntent(
 	query *mgo.Query, intent *intents.Intent, buffer resettableOutputBuffer, filter documentFilter) (dumpCount int64, err error) {
+	return dump.dumpItersToIntent(query, intent, buffer, filter, func() ([]*mgo.Iter, func(), error) {
+		return []*mgo.Iter{query.Iter()}, func() {}, nil
+	})
+}
+
+// dumpItersToIntent counts the documents matched by query, then writes the filtered results
+// of the iterators returned by openIters to the intent. The cleanup function returned by
+// openIters is called once the iterators are exhausted.
+func (dump *MongoDump) dumpItersToIntent(query *mgo.Query, intent *intents.Intent, buffer resettableOutputBuffer,
+	filter documentFilter, openIters func() ([]*mgo.Iter, func(), error)) (dumpCount int64, err error) {
 
 	// restore of views from archives require an empty collection as the trigger to create the view
 	// so, we open here before the early return if IsView so that we write an empty collection to the archive
@@ -659,7 +709,12 @@ func (dump *MongoDump) dumpFilteredQueryToIntent(
 		}()
 	}
 
-	err = dump.dumpFilteredIterToWriter(query.Iter(), f, dumpProgressor, filter)
+	iters, cleanup, err := openIters()
+	if err != nil {
+		return 0, err
+	}
+	defer cleanup()
+	err = dump.dumpFilteredItersToWriter(iters, f, dumpProgressor, filter)
 	dumpCount, _ = dumpProgressor.Progress()
 	if err != nil {
 		err = fmt.Errorf("error writing data for collection `%v` to disk: %v", intent.Namespace(), err)
@@ -678,56 +733,87 @@ func (dump *MongoDump) dumpIterToWriter(
 // a counter, and fiters and dumps the iterator's contents to the writer.
 func (dump *MongoDump) dumpFilteredIterToWriter(
 	iter *mgo.Iter, writer io.Writer, progressCount progress.Updateable, filter documentFilter) error {
-	var termErr error
+	return dump.dumpFilteredItersToWriter([]*mgo.Iter{iter}, writer, progressCount, filter)
+}
 
-	// We run the result iteration in its own goroutine,
+// dumpFilteredItersToWriter takes several mgo iterators, a writer, and a pointer to a
+// counter, and filters and dumps the contents of all the iterators to the writer. Documents
+// from different iterators are interleaved in the order they arrive.
+func (dump *MongoDump) dumpFilteredItersToWriter(
+	iters []*mgo.Iter, writer io.Writer, progressCount progress.Updateable, filter documentFilter) error {
+	// We run each iteration in its own goroutine,
 	// this allows disk i/o to not block reads from the db,
-	// which gives a slight speedup on benchmarks
+	// which gives a slight speedup on benchmarks,
+	// and lets several cursors be read at once
 	buffChan := make(chan []byte)
+	stop := make(chan struct{})
+	errChan := make(chan error, len(iters))
+	var wg sync.WaitGroup
+	for _, iter := range iters {
+		wg.Add(1)
+		go func(iter *mgo.Iter) {
+			defer wg.Done()
+			errChan <- dump.readFilteredIter(iter, buffChan, stop, filter)
+		}(iter)
+	}
 	go func() {
-		for {
-			select {
-			case <-dump.shutdownIntentsNotifier.notified:
-				log.Logvf(log.DebugHigh, "terminating writes")
-				termErr = util.ErrTerminated
-				close(buffChan)
-				return
-			default:
-				raw := &bson.Raw{}
-				next := iter.Next(raw)
-				if !next {
-					// we check the iterator for errors below
-					close(buffChan)
-					return
-				}
-				out, err := filter(raw.Data)
-				if err != nil {
-					termErr = err
-					close(buffChan)
-					return
-				}
-				buffChan <- out
-			}
-		}
+		wg.Wait()
+		close(buffChan)
 	}()
 
 	// while there are still results in the database,
-	// grab results from the goroutine and write them to filesystem
+	// grab results from the goroutines and write them to filesystem
+	var writeErr error
+	for buff := range buffChan {
+		if writeErr != nil {
+			continue // drain until the readers notice they should stop
+		}
+		if _, err := writer.Write(buff); err != nil {
+			writeErr = fmt.Errorf("error writing to file: %v", err)
+			close(stop)
+			continue
+		}
+		progressCount.Inc(1)
+	}
+	if writeErr != nil {
+		return writeErr
+	}
+	for range iters {
+		if err := <-errChan; err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
+// readFilteredIter sends the filtered contents of iter to out until the iterator is
+// exhausted, the stop channel is closed, or the dump is interrupted.
+func (dump *MongoDump) readFilteredIter(
+	iter *mgo.Iter, out chan<- []byte, stop <-chan struct{}, filter documentFilter) error {
 	for {
-		buff, alive := <-buffChan
-		if !alive {
+		select {
+		case <-dump.shutdownIntentsNotifier.notified:
+			log.Logvf(log.DebugHigh, "terminating writes")
+			return util.ErrTerminated
+		default:
+		}
+		raw := &bson.Raw{}
+		if !iter.Next(raw) {
 			if iter.Err() != nil {
 				return fmt.Errorf("error reading collection: %v", iter.Err())
 			}
-			break
+			return nil
 		}
-		_, err := writer.Write(buff)
+		buff, err := filter(raw.Data)
 		if err != nil {
-			return fmt.Errorf("error writing to file: %v", err)
+			return err
+		}
+		select {
+		case out <- buff:
+		case <-stop:
+			return nil
 		}
-		progressCount.Inc(1)
 	}
-	return termErr
 }
 
 // DumpUsersAndRolesForDB queries and dumps the users and roles tied to the given
@@ -72,7 +72,8 @@ func simpleMongoDumpInstance() *MongoDump {
 	toolOptions.Namespace = &options.Namespace{DB: testDB}
 
 	outputOptions := &OutputOptions{
-		NumParallelCollections: 1,
+		NumParallelCollections:     1,
+		NumPartitionsPerCollection: 1,
 	}
 	inputOptions := &InputOptions{}
 
@@ -390,7 +391,8 @@ func TestMongoDumpKerberos(t *testing.T) {
 			ToolOptions:  opts,
 			InputOptions: &InputOptions{},
 			OutputOptions: &OutputOptions{
-				NumParallelCollections: 1,
+				NumParallelCollections:     1,
+				NumPartitionsPerCollection: 1,
 			},
 		}
 
@@ -532,6 +534,26 @@ func TestMongoDumpBSON(t *testing.T) {
 
 				})
 
+				Convey("it dumps every document once when reading the collection in partitions", func() {
+					md.OutputOptions.Out = "-"
+					md.OutputOptions.NumPartitionsPerCollection = 4
+					stdoutBuf := &bytes.Buffer{}
+					md.OutputWriter = stdoutBuf
+					err = md.Dump()
+					So(err, ShouldBeNil)
+					bsonSource := db.NewDecodedBSONSource(db.NewBSONSource(ioutil.NopCloser(stdoutBuf)))
+					defer bsonSource.Close()
+
+					seen := map[interface{}]bool{}
+					var result bson.M
+					for bsonSource.Next(&result) {
+						So(seen[result["_id"]], ShouldBeFalse)
+						seen[result["_id"]] = true
+					}
+					So(bsonSource.Err(), ShouldBeNil)
+					So(len(seen), ShouldEqual, 10) //The 0th collection has 10 documents
+				})
+
 			})
 
 			Convey("for an entire database", func() {
@@ -0,0 +1,77 @@
+// Copyright (C) MongoDB, Inc. 2014-present.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may
+// not use this file except in compliance with the License. You may obtain
+// a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+package mongodump
+
+import (
+	"fmt"
+
+	"github.com/mongodb/mongo-tools/common/intents"
+	"github.com/mongodb/mongo-tools/common/log"
+	"gopkg.in/mgo.v2"
+	"gopkg.in/mgo.v2/bson"
+)
+
+// partitionBounds is one _id range returned by the planCollectionPartitions command.
+// Min is inclusive and Max exclusive; a missing bound means the range is open on that side.
+type partitionBounds struct {
+	Min bson.D `bson:"min,omitempty"`
+	Max bson.D `bson:"max,omitempty"`
+}
+
+// planPartitions asks the server to split the intent's collection into _id ranges that
+// can be read concurrently. It returns nil when the collection should be read with a
+// single cursor, including when the server does not support partition planning.
+func (dump *MongoDump) planPartitions(session *mgo.Session, intent *intents.Intent) []partitionBounds {
+	numPartitions := dump.OutputOptions.NumPartitionsPerCollection
+	if numPartitions <= 1 || intent.IsView() || intent.IsOplog() {
+		return nil
+	}
+
+	var result struct {
+		Partitions []partitionBounds `bson:"partitions"`
+	}
+	command := bson.D{
+		{"planCollectionPartitions", intent.C},
+		{"numPartitions", numPartitions},
+	}
+	if err := session.DB(intent.DB).Run(command, &result); err != nil {
+		log.Logvf(log.Info, "not partitioning %v: %v", intent.Namespace(), err)
+		return nil
+	}
+	if len(result.Partitions) <= 1 {
+		return nil
+	}
+	log.Logvf(log.DebugLow, "reading %v with %v cursors", intent.Namespace(), len(result.Partitions))
+	return result.Partitions
+}
+
+// partitionIter opens a cursor over one _id range of the intent's collection. The range
+// is expressed as index bounds on _id rather than a filter so that it is not type bracketed.
+func partitionIter(session *mgo.Session, intent *intents.Intent, partition partitionBounds) (*mgo.Iter, error) {
+	command := bson.D{
+		{"find", intent.C},
+		{"hint", bson.D{{"_id", 1}}},
+	}
+	if len(partition.Min) > 0 {
+		command = append(command, bson.DocElem{"min", partition.Min})
+	}
+	if len(partition.Max) > 0 {
+		command = append(command, bson.DocElem{"max", partition.Max})
+	}
+
+	var result struct {
+		Cursor struct {
+			FirstBatch []bson.Raw `bson:"firstBatch"`
+			Id         int64
+		}
+	}
+	if err := session.DB(intent.DB).Run(command, &result); err != nil {
+		return nil, fmt.Errorf("error reading range of %v: %v", intent.Namespace(), err)
+	}
+	coll := session.DB(intent.DB).C(intent.C)
+	return coll.NewIter(session, result.Cursor.FirstBatch, result.Cursor.Id, nil), nil
+}
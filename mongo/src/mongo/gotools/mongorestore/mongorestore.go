@@ -66,6 +66,10 @@ type MongoRestore struct {
 	// indexes belonging to dbs and collections
 	dbCollectionIndexes map[string]collectionIndexes
 
+	// index builds postponed by --deferIndexBuilds until all data is restored
+	deferredIndexes      []deferredIndexBuild
+	deferredIndexesMutex sync.Mutex
+
 	archive *archive.Reader
 
 	// channel on which to notify if/when a termination signal is received
@@ -22,8 +22,24 @@ import (
 
 const insertBufferFactor = 16
 
+// deferredIndexBuild is the set of indexes to create on one collection once every
+// collection's data has been restored.
+type deferredIndexBuild struct {
+	intent  *intents.Intent
+	indexes []IndexDocument
+}
+
 // RestoreIntents iterates through all of the intents stored in the IntentManager, and restores them.
 func (restore *MongoRestore) RestoreIntents() error {
+	if err := restore.restoreIntentData(); err != nil {
+		return err
+	}
+	return restore.buildDeferredIndexes()
+}
+
+// restoreIntentData restores every intent in the IntentManager, building each collection's
+// indexes after its data unless index builds are deferred.
+func (restore *MongoRestore) restoreIntentData() error {
 	log.Logvf(log.DebugLow, "restoring up to %v collections in parallel", restore.OutputOptions.NumParallelCollections)
 
 	if restore.OutputOptions.NumParallelCollections > 0 {
@@ -208,7 +224,12 @@ func (restore *MongoRestore) RestoreIntent(intent *intents.Intent) error {
 	}
 
 	// finally, add indexes
-	if len(indexes) > 0 && !restore.OutputOptions.NoIndexRestore {
+	if len(indexes) > 0 && !restore.OutputOptions.NoIndexRestore && restore.OutputOptions.DeferIndexBuilds {
+		log.Logvf(log.Info, "deferring index builds for collection %v", intent.Namespace())
+		restore.deferredIndexesMutex.Lock()
+		restore.deferredIndexes = append(restore.deferredIndexes, deferredIndexBuild{intent, indexes})
+		restore.deferredIndexesMutex.Unlock()
+	} else if len(indexes) > 0 && !restore.OutputOptions.NoIndexRestore {
 		log.Logvf(log.Always, "restoring indexes for collection %v from metadata", intent.Namespace())
 		err = restore.CreateIndexes(intent, indexes)
 		if err != nil {
@@ -223,6 +244,55 @@ func (restore *MongoRestore) RestoreIntent(intent *intents.Intent) error {
 	return nil
 }
 
+// buildDeferredIndexes creates the indexes postponed by --deferIndexBuilds, running up to
+// numParallelCollections createIndexes commands at once. Foreground index builds lock their
+// database, so deferring them keeps them from stalling inserts into sibling collections.
+func (restore *MongoRestore) buildDeferredIndexes() error {
+	builds := restore.deferredIndexes
+	restore.deferredIndexes = nil
+	if len(builds) == 0 {
+		return nil
+	}
+
+	jobs := restore.OutputOptions.NumParallelCollections
+	if jobs < 1 {
+		jobs = 1
+	}
+	if jobs > len(builds) {
+		jobs = len(builds)
+	}
+	log.Logvf(log.Always, "building indexes for %v %v, up to %v at a time",
+		len(builds), util.Pluralize(len(builds), "collection", "collections"), jobs)
+
+	buildChan := make(chan deferredIndexBuild, len(builds))
+	for _, build := range builds {
+		buildChan <- build
+	}
+	close(buildChan)
+
+	resultChan := make(chan error, jobs)
+	for i := 0; i < jobs; i++ {
+		go func() {
+			for build := range buildChan {
+				log.Logvf(log.Always, "restoring indexes for collection %v from metadata", build.intent.Namespace())
+				if err := restore.CreateIndexes(build.intent, build.indexes); err != nil {
+					resultChan <- fmt.Errorf("error creating indexes for %v: %v", build.intent.Namespace(), err)
+					return
+				}
+			}
+			resultChan <- nil
+		}()
+	}
+
+	var firstErr error
+	for i := 0; i < jobs; i++ {
+		if err := <-resultChan; err != nil && firstErr == nil {
+			firstErr = err
+		}
+	}
+	return firstErr
+}
+
 // RestoreCollectionToDB pipes the given BSON data into the database.
 // Returns the number of documents restored and any errors that occured.
 func (restore *MongoRestore) RestoreCollectionToDB(dbName, colName string,
@@ -0,0 +1,249 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logger/async_appender.h"
+
+#include <algorithm>
+#include <set>
+
+#include "mongo/logger/log_severity.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace logger {
+
+namespace {
+
+// Slot strings that grew past this size while buffering a large message are released once the
+// message is written, so a burst of huge log lines does not pin memory in every slot.
+const size_t kMaxRetainedSlotBytes = 64 * 1024;
+
+// How long the writer sleeps when it finds the ring empty before checking again.  Wakeups are
+// normally signaled, this only bounds the latency of the rare missed signal.
+const Milliseconds kWriterIdleInterval{100};
+
+// The registry is intentionally leaked: it must outlive appenders destroyed during static
+// destruction.
+stdx::mutex* const registryMutex = new stdx::mutex;
+std::set<AsyncAppender*>* const registry = new std::set<AsyncAppender*>;
+
+size_t roundUpToPowerOfTwo(size_t n) {
+    size_t result = 1;
+    while (result < n) {
+        result <<= 1;
+    }
+    return result;
+}
+
+}  // namespace
+
+AsyncAppender::AsyncAppender(std::unique_ptr<Appender<MessageEventEphemeral>> target,
+                             size_t capacity)
+    : _target(std::move(target)),
+      _mask(roundUpToPowerOfTwo(std::max<size_t>(capacity, 2)) - 1),
+      _slots(_mask + 1) {
+    invariant(_target);
+    for (size_t i = 0; i < _slots.size(); ++i) {
+        _slots[i].sequence.store(i);
+    }
+    _writer = stdx::thread([this] { _run(); });
+
+    stdx::lock_guard<stdx::mutex> lk(*registryMutex);
+    registry->insert(this);
+}
+
+AsyncAppender::~AsyncAppender() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(*registryMutex);
+        registry->erase(this);
+    }
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _shutdown = true;
+        _wakeWriter.notify_one();
+    }
+    _writer.join();
+}
+
+Status AsyncAppender::append(const MessageEventEphemeral& event) {
+    if (event.getSeverity() >= LogSeverity::Severe()) {
+        // Keep ordering with what is already buffered, then write from this thread so the event
+        // is on its way to disk before the caller goes on to abort.
+        flush(Milliseconds::max());
+        return _target->append(event);
+    }
+
+    if (!_tryPush(event)) {
+        _dropped.fetchAndAdd(1);
+        return Status::OK();
+    }
+
+    if (_writerWaiting.load()) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _wakeWriter.notify_one();
+    }
+    return Status::OK();
+}
+
+bool AsyncAppender::flush(Milliseconds timeout) {
+    const uint64_t target = _enqueuePos.load();
+    const auto done = [&] { return _dequeuePos.load() >= target; };
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (done()) {
+        return true;
+    }
+    _wakeWriter.notify_one();
+    if (timeout == Milliseconds::max()) {
+        _drained.wait(lk, done);
+        return true;
+    }
+    return _drained.wait_for(lk, timeout.toSystemDuration(), done);
+}
+
+AsyncAppender::Stats AsyncAppender::getStats() const {
+    Stats stats;
+    stats.written = _dequeuePos.load();
+    stats.queued = _enqueuePos.load() - stats.written;
+    stats.dropped = _dropped.load();
+    return stats;
+}
+
+bool AsyncAppender::_tryPush(const MessageEventEphemeral& event) {
+    // Bounded multi-producer queue: each slot's sequence number says whose turn it is.  A slot is
+    // free for the producer claiming position "pos" once its sequence equals "pos", and holds a
+    // completed event for the writer once its sequence equals "pos + 1".
+    uint64_t pos = _enqueuePos.load();
+    Slot* slot;
+    while (true) {
+        slot = &_slots[pos & _mask];
+        const uint64_t seq = slot->sequence.load();
+        const int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            const uint64_t observed = _enqueuePos.compareAndSwap(pos, pos + 1);
+            if (observed == pos) {
+                break;
+            }
+            pos = observed;
+        } else if (diff < 0) {
+            return false;  // The writer has not released this slot yet: the ring is full.
+        } else {
+            pos = _enqueuePos.load();
+        }
+    }
+
+    slot->date = event.getDate();
+    slot->severity = event.getSeverity().toInt();
+    slot->component = event.getComponent();
+    slot->isTruncatable = event.isTruncatable();
+    slot->contextName.assign(event.getContextName().rawData(), event.getContextName().size());
+    slot->message.assign(event.getMessage().rawData(), event.getMessage().size());
+    slot->sequence.store(pos + 1);
+    return true;
+}
+
+bool AsyncAppender::_isEmpty() const {
+    const uint64_t pos = _dequeuePos.load();
+    return _slots[pos & _mask].sequence.load() != pos + 1;
+}
+
+bool AsyncAppender::_writeOne() {
+    const uint64_t pos = _dequeuePos.load();
+    Slot& slot = _slots[pos & _mask];
+    if (slot.sequence.load() != pos + 1) {
+        return false;
+    }
+
+    MessageEventEphemeral event(slot.date,
+                                LogSeverity::cast(slot.severity),
+                                slot.component,
+                                slot.contextName,
+                                slot.message);
+    event.setIsTruncatable(slot.isTruncatable);
+    // There is no caller left to report a failure to; like the domain, keep going.
+    _target->append(event).transitional_ignore();
+
+    if (slot.message.capacity() > kMaxRetainedSlotBytes) {
+        std::string().swap(slot.message);
+    }
+    slot.sequence.store(pos + _mask + 1);
+    _dequeuePos.store(pos + 1);
+    return true;
+}
+
+void AsyncAppender::_reportDrops() {
+    const uint64_t dropped = _dropped.load();
+    if (dropped == _droppedReported) {
+        return;
+    }
+    const std::string message = str::stream()
+        << "dropped " << (dropped - _droppedReported)
+        << " log messages because the asynchronous log buffer was full";
+    _droppedReported = dropped;
+    _target->append(MessageEventEphemeral(
+                        Date_t::now(), LogSeverity::Warning(), "AsyncLogWriter", message))
+        .transitional_ignore();
+}
+
+void AsyncAppender::_run() {
+    setThreadName("AsyncLogWriter");
+
+    while (true) {
+        while (_writeOne()) {
+        }
+        _reportDrops();
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _drained.notify_all();
+        if (_shutdown && _isEmpty()) {
+            return;
+        }
+
+        // Producers check _writerWaiting after publishing an event, and we check the ring after
+        // publishing _writerWaiting, so at least one side sees the other.
+        _writerWaiting.store(true);
+        if (_isEmpty() && !_shutdown) {
+            _wakeWriter.wait_for(lk, kWriterIdleInterval.toSystemDuration());
+        }
+        _writerWaiting.store(false);
+    }
+}
+
+void flushAsyncAppenders(Milliseconds timeout) {
+    stdx::lock_guard<stdx::mutex> lk(*registryMutex);
+    for (auto appender : *registry) {
+        appender->flush(timeout);
+    }
+}
+
+}  // namespace logger
+}  // namespace mongo
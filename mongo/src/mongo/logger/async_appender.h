@@ -0,0 +1,135 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/logger/appender.h"
+#include "mongo/logger/message_event.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace logger {
+
+/**
+ * Appender that takes log writes off the logging thread.
+ *
+ * append() copies the event into a fixed-size ring of slots without taking any lock and returns;
+ * a background thread drains the ring into the wrapped appender.  When the ring is full the event
+ * is dropped and counted instead of blocking the caller, and the writer thread reports the number
+ * of dropped events through the wrapped appender once it catches up.
+ *
+ * Events of severity Severe or higher are never dropped: they wait for the ring to drain and are
+ * then written synchronously, so that messages logged just before a crash reach the log.
+ */
+class AsyncAppender : public Appender<MessageEventEphemeral> {
+    MONGO_DISALLOW_COPYING(AsyncAppender);
+
+public:
+    struct Stats {
+        uint64_t queued;
+        uint64_t written;
+        uint64_t dropped;
+    };
+
+    /**
+     * Constructs an appender that owns "target" and forwards events to it from a background
+     * thread.  "capacity" is the number of buffered events and is rounded up to a power of two.
+     */
+    AsyncAppender(std::unique_ptr<Appender<MessageEventEphemeral>> target, size_t capacity);
+
+    /**
+     * Drains all buffered events into the wrapped appender and stops the writer thread.
+     */
+    ~AsyncAppender();
+
+    Status append(const MessageEventEphemeral& event) final;
+
+    /**
+     * Waits until every event buffered before the call has been handed to the wrapped appender,
+     * or until "timeout" elapses.  Returns true if the buffer was drained.
+     */
+    bool flush(Milliseconds timeout);
+
+    Stats getStats() const;
+
+private:
+    struct Slot {
+        AtomicWord<uint64_t> sequence;
+        Date_t date;
+        int severity;
+        LogComponent::Value component;
+        bool isTruncatable;
+        std::string contextName;
+        std::string message;
+    };
+
+    bool _tryPush(const MessageEventEphemeral& event);
+    bool _isEmpty() const;
+
+    // Writes the oldest buffered event to the target.  Returns false if the ring is empty.
+    bool _writeOne();
+    void _reportDrops();
+    void _run();
+
+    const std::unique_ptr<Appender<MessageEventEphemeral>> _target;
+    const uint64_t _mask;
+    std::vector<Slot> _slots;
+
+    AtomicWord<uint64_t> _enqueuePos{0};
+    AtomicWord<uint64_t> _dequeuePos{0};
+    AtomicWord<uint64_t> _dropped{0};
+    uint64_t _droppedReported = 0;  // Only accessed by the writer thread.
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _wakeWriter;  // Signaled when events arrive or on shutdown.
+    stdx::condition_variable _drained;     // Signaled when the writer finds the ring empty.
+    AtomicWord<bool> _writerWaiting{false};
+    bool _shutdown = false;
+
+    stdx::thread _writer;
+};
+
+/**
+ * Flushes every live AsyncAppender, waiting at most "timeout" for each.  Used on process exit,
+ * which does not run destructors.
+ */
+void flushAsyncAppenders(Milliseconds timeout);
+
+}  // namespace logger
+}  // namespace mongo
@@ -0,0 +1,155 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/logger/async_appender.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace {
+using namespace mongo;
+using namespace mongo::logger;
+
+/**
+ * Records the messages it receives.  While blocked, append() waits until unblock() is called.
+ */
+class RecordingAppender : public Appender<MessageEventEphemeral> {
+public:
+    struct State {
+        stdx::mutex mutex;
+        stdx::condition_variable cv;
+        bool blocked = false;
+        bool inAppend = false;
+        std::vector<std::string> messages;
+
+        void waitUntilInAppend() {
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            cv.wait(lk, [&] { return inAppend; });
+        }
+
+        void unblock() {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            blocked = false;
+            cv.notify_all();
+        }
+
+        std::vector<std::string> getMessages() {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            return messages;
+        }
+    };
+
+    explicit RecordingAppender(State* state) : _state(state) {}
+
+    Status append(const MessageEventEphemeral& event) override {
+        stdx::unique_lock<stdx::mutex> lk(_state->mutex);
+        _state->inAppend = true;
+        _state->cv.notify_all();
+        _state->cv.wait(lk, [&] { return !_state->blocked; });
+        _state->messages.push_back(event.getMessage().toString());
+        return Status::OK();
+    }
+
+private:
+    State* const _state;
+};
+
+Status appendMessage(AsyncAppender* appender, LogSeverity severity, StringData message) {
+    return appender->append(MessageEventEphemeral(Date_t::now(), severity, "test", message));
+}
+
+TEST(AsyncAppenderTest, DeliversEventsInOrderAfterFlush) {
+    RecordingAppender::State state;
+    AsyncAppender appender(stdx::make_unique<RecordingAppender>(&state), 16);
+
+    std::vector<std::string> expected;
+    for (int i = 0; i < 100; ++i) {
+        expected.push_back(str::stream() << "message " << i);
+        ASSERT_OK(appendMessage(&appender, LogSeverity::Log(), expected.back()));
+        if (i % 10 == 9) {
+            ASSERT_TRUE(appender.flush(Milliseconds::max()));
+        }
+    }
+
+    ASSERT_TRUE(appender.flush(Milliseconds::max()));
+    ASSERT_TRUE(expected == state.getMessages());
+    ASSERT_EQ(100U, appender.getStats().written);
+    ASSERT_EQ(0U, appender.getStats().dropped);
+}
+
+TEST(AsyncAppenderTest, DropsAndReportsEventsWhenFull) {
+    RecordingAppender::State state;
+    state.blocked = true;
+    {
+        AsyncAppender appender(stdx::make_unique<RecordingAppender>(&state), 4);
+
+        // The writer takes the first event and blocks in the target while still holding its slot,
+        // so only three more events fit.
+        ASSERT_OK(appendMessage(&appender, LogSeverity::Log(), "first"));
+        state.waitUntilInAppend();
+
+        for (int i = 0; i < 10; ++i) {
+            ASSERT_OK(appendMessage(&appender, LogSeverity::Log(), "filler"));
+        }
+        ASSERT_FALSE(appender.flush(Milliseconds(10)));
+
+        auto stats = appender.getStats();
+        ASSERT_EQ(4U, stats.queued);
+        ASSERT_EQ(0U, stats.written);
+        ASSERT_EQ(7U, stats.dropped);
+
+        state.unblock();
+        // Destroying the appender drains it, including the drop report.
+    }
+
+    auto messages = state.getMessages();
+    ASSERT_EQ(5U, messages.size());
+    ASSERT_EQ("first", messages[0]);
+    ASSERT_EQ("filler", messages[3]);
+    ASSERT_STRING_CONTAINS(messages[4], "dropped 7 log messages");
+}
+
+TEST(AsyncAppenderTest, SevereEventsAreWrittenBeforeAppendReturns) {
+    RecordingAppender::State state;
+    AsyncAppender appender(stdx::make_unique<RecordingAppender>(&state), 16);
+
+    ASSERT_OK(appendMessage(&appender, LogSeverity::Log(), "buffered"));
+    ASSERT_OK(appendMessage(&appender, LogSeverity::Severe(), "severe"));
+
+    auto messages = state.getMessages();
+    ASSERT_EQ(2U, messages.size());
+    ASSERT_EQ("buffered", messages[0]);
+    ASSERT_EQ("severe", messages[1]);
+}
+
+}  // namespace
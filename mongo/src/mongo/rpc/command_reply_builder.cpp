@@ -46,6 +46,12 @@ CommandReplyBuilder::CommandReplyBuilder(Message&& message) : _message{std::move
     _builder.skip(mongo::MsgData::MsgDataHeaderSize);
 }
 
+CommandReplyBuilder::CommandReplyBuilder(SharedBuffer buffer) : _builder(0) {
+    invariant(buffer);
+    _builder.useSharedBuffer(std::move(buffer));
+    _builder.skip(mongo::MsgData::MsgDataHeaderSize);
+}
+
 CommandReplyBuilder& CommandReplyBuilder::setRawCommandReply(const BSONObj& commandReply) {
     invariant(_state == State::kCommandReply);
     commandReply.appendSelfToBufBuilder(_builder);
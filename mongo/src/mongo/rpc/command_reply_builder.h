@@ -55,6 +55,12 @@ public:
      */
     CommandReplyBuilder(Message&& message);
 
+    /**
+     * Constructs an OP_COMMANDREPLY in 'buffer', which must not be shared, instead of allocating
+     * a new one.
+     */
+    explicit CommandReplyBuilder(SharedBuffer buffer);
+
 
     CommandReplyBuilder& setRawCommandReply(const BSONObj& commandReply) final;
     BSONObjBuilder getInPlaceReplyBuilder(std::size_t) final;
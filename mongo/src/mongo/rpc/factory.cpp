@@ -95,13 +95,22 @@ OpMsgRequest opMsgRequestFromAnyProtocol(const Message& unownedMessage) {
 }
 
 //Strategy::clientCommandеãȡӦReplyBuilder
-std::unique_ptr<ReplyBuilderInterface> makeReplyBuilder(Protocol protocol) {
+std::unique_ptr<ReplyBuilderInterface> makeReplyBuilder(Protocol protocol, SharedBuffer buffer) {
     switch (protocol) {
-        case Protocol::kOpMsg:  
+        case Protocol::kOpMsg:
+            if (buffer) {
+                return stdx::make_unique<OpMsgReplyBuilder>(std::move(buffer));
+            }
             return stdx::make_unique<OpMsgReplyBuilder>();
         case Protocol::kOpQuery:
+            if (buffer) {
+                return stdx::make_unique<LegacyReplyBuilder>(std::move(buffer));
+            }
             return stdx::make_unique<LegacyReplyBuilder>();
         case Protocol::kOpCommandV1:
+            if (buffer) {
+                return stdx::make_unique<CommandReplyBuilder>(std::move(buffer));
+            }
             return stdx::make_unique<CommandReplyBuilder>();
         default:
             MONGO_UNREACHABLE;
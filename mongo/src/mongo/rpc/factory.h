@@ -66,9 +66,11 @@ inline Message messageFromOpMsgRequest(ProtocolSet clientProtos,
 OpMsgRequest opMsgRequestFromAnyProtocol(const Message& unownedMessage);
 
 /**
- * Returns the appropriate concrete ReplyBuilder.
+ * Returns the appropriate concrete ReplyBuilder. The reply is built in 'buffer' when one is given,
+ * which saves allocating a new reply buffer.
  */
-std::unique_ptr<ReplyBuilderInterface> makeReplyBuilder(Protocol protocol);
+std::unique_ptr<ReplyBuilderInterface> makeReplyBuilder(Protocol protocol,
+                                                        SharedBuffer buffer = {});
 
 }  // namespace rpc
 }  // namespace mongo
@@ -49,6 +49,12 @@ LegacyReplyBuilder::LegacyReplyBuilder(Message&& message) : _message{std::move(m
     _builder.skip(sizeof(QueryResult::Value));
 }
 
+LegacyReplyBuilder::LegacyReplyBuilder(SharedBuffer buffer) : _builder(0) {
+    invariant(buffer);
+    _builder.useSharedBuffer(std::move(buffer));
+    _builder.skip(sizeof(QueryResult::Value));
+}
+
 LegacyReplyBuilder::~LegacyReplyBuilder() {}
 
 LegacyReplyBuilder& LegacyReplyBuilder::setCommandReply(Status nonOKStatus,
@@ -46,6 +46,11 @@ public:
 
     LegacyReplyBuilder();
     LegacyReplyBuilder(Message&&);
+
+    /**
+     * Builds the reply in 'buffer', which must not be shared, instead of allocating a new one.
+     */
+    explicit LegacyReplyBuilder(SharedBuffer buffer);
     ~LegacyReplyBuilder() final;
 
     // Override of setCommandReply specifically used to handle StaleConfigException.
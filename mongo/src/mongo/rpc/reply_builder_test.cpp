@@ -195,4 +195,29 @@ void testRoundTrip(rpc::ReplyBuilderInterface& replyBuilder, bool unifiedBodyAnd
     }
 }
 
+template <typename Builder, typename Reply>
+void testBuildInRecycledBuffer() {
+    auto buffer = SharedBuffer::allocate(4096);
+    const char* const data = buffer.get();
+
+    Builder builder(std::move(buffer));
+    rpc::ReplyBuilderInterface& replyBuilder = builder;
+    replyBuilder.setCommandReply(buildEmptyCommand());
+    replyBuilder.setMetadata(buildMetadata());
+    auto msg = replyBuilder.done();
+
+    // The reply fits in the buffer it was given, so it must not have been reallocated.
+    ASSERT_EQ(msg.buf(), data);
+    Reply parsed(&msg);
+    ASSERT_BSONOBJ_EQ(parsed.getCommandReply()["cursor"].Obj(), BSON("firstBatch" << BSONArray()));
+}
+
+TEST(LegacyReplyBuilder, BuildsInRecycledBuffer) {
+    testBuildInRecycledBuffer<rpc::LegacyReplyBuilder, rpc::LegacyReply>();
+}
+
+TEST(CommandReplyBuilder, BuildsInRecycledBuffer) {
+    testBuildInRecycledBuffer<rpc::CommandReplyBuilder, rpc::CommandReply>();
+}
+
 }  // namespace
@@ -33,6 +33,7 @@
 #include "mongo/s/async_requests_sender.h"
 
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/client/shard_registry.h"
@@ -48,6 +49,19 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// Report the latency of each response to the targeter of its shard, so that reads which may go to
+// secondaries prefer the hosts which currently answer soonest.
+MONGO_EXPORT_SERVER_PARAMETER(operationLatencyAwareReads, bool, false);
+
+// Send reads which may go to secondaries to a second host of the shard when the first has not
+// answered within the latency it usually answers in. Latencies are recorded as with
+// operationLatencyAwareReads, since the hedging delay is derived from them.
+MONGO_EXPORT_SERVER_PARAMETER(hedgedReadsEnabled, bool, false);
+
+// The shortest time to wait for the first host before sending a hedged request, so that hosts
+// which answer in a millisecond or two do not get every read twice.
+MONGO_EXPORT_SERVER_PARAMETER(hedgedReadsMinDelayMillis, int, 5);
+
 }  // namespace
 
 //BatchWriteExec::executeBatchе
@@ -117,6 +131,26 @@ AsyncRequestsSender::Response AsyncRequestsSender::next() {
     return *readyResponse;
 }
 
+void AsyncRequestsSender::addRequest(const Request& request) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    _remotes.emplace_back(request.shardId, request.cmdObj);
+    auto& remote = _remotes.back();
+
+    Status scheduleStatus = _interruptStatus;
+    if (scheduleStatus.isOK()) {
+        scheduleStatus = _scheduleRequest(lk, _remotes.size() - 1);
+    }
+
+    if (!scheduleStatus.isOK()) {
+        remote.swResponse = std::move(scheduleStatus);
+        // No callback will run for this remote, so signal the notification ourselves.
+        if (!*_notification) {
+            _notification->set();
+        }
+    }
+}
+
 void AsyncRequestsSender::stopRetrying() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     _stopRetrying = true;
@@ -137,6 +171,12 @@ void AsyncRequestsSender::_cancelPendingRequests() {
         if (remote.cbHandle.isValid()) {
             _executor->cancel(remote.cbHandle);
         }
+        if (remote.hedgeTimerHandle.isValid()) {
+            _executor->cancel(remote.hedgeTimerHandle);
+        }
+        if (remote.hedgeCbHandle.isValid()) {
+            _executor->cancel(remote.hedgeCbHandle);
+        }
     }
 }
 
@@ -153,7 +193,7 @@ boost::optional<AsyncRequestsSender::Response> AsyncRequestsSender::_ready() {
     // Check if any remote is ready.
     invariant(!_remotes.empty());
     for (auto& remote : _remotes) {
-        if (remote.swResponse && !remote.done) {
+        if (remote.swResponse && !remote.done && !remote.hasPendingCallbacks()) {
             remote.done = true;
             if (remote.swResponse->isOK()) {
                 invariant(remote.shardHostAndPort);
@@ -185,7 +225,7 @@ void AsyncRequestsSender::_scheduleRequests(WithLock lk) {
 
         // First check if the remote had a retriable error, and if so, clear its response field so
         // it will be retried.
-        if (remote.swResponse && !remote.done) {
+        if (remote.swResponse && !remote.done && !remote.hasPendingCallbacks()) {
             // We check both the response status and command status for a retriable error.
             Status status = remote.swResponse->getStatus();
             if (status.isOK()) {
@@ -217,7 +257,7 @@ void AsyncRequestsSender::_scheduleRequests(WithLock lk) {
         }
 
         // If the remote does not have a response or pending request, schedule remote work for it.
-        if (!remote.swResponse && !remote.cbHandle.isValid()) {
+        if (!remote.swResponse && !remote.hasPendingCallbacks()) {
 			//AsyncRequestsSender::_scheduleRequest
             auto scheduleStatus = _scheduleRequest(lk, i); //
             if (!scheduleStatus.isOK()) {
@@ -234,12 +274,14 @@ void AsyncRequestsSender::_scheduleRequests(WithLock lk) {
 }
 
 //AsyncRequestsSender::_scheduleRequestsе
-Status AsyncRequestsSender::_scheduleRequest(WithLock, size_t remoteIndex) {
+Status AsyncRequestsSender::_scheduleRequest(WithLock lk, size_t remoteIndex) {
     auto& remote = _remotes[remoteIndex];
 
-    invariant(!remote.cbHandle.isValid());
+    invariant(!remote.hasPendingCallbacks());
     invariant(!remote.swResponse);
 
+    remote.hedgeHostAndPort.reset();
+
 	//ȡshardHostAndPort
     Status resolveStatus = remote.resolveShardIdToHostAndPort(_readPreference);
     if (!resolveStatus.isOK()) {
@@ -252,32 +294,76 @@ Status AsyncRequestsSender::_scheduleRequest(WithLock, size_t remoteIndex) {
 	//ThreadPoolTaskExecutor::scheduleRemoteCommand
     auto callbackStatus = _executor->scheduleRemoteCommand(
         request,
-        stdx::bind(
-            &AsyncRequestsSender::_handleResponse, this, stdx::placeholders::_1, remoteIndex));
+        stdx::bind(&AsyncRequestsSender::_handleResponse,
+                   this,
+                   stdx::placeholders::_1,
+                   remoteIndex,
+                   false));
     if (!callbackStatus.isOK()) {
         return callbackStatus.getStatus();
     }
 
     remote.cbHandle = callbackStatus.getValue();
+
+    _scheduleHedgeTimer(lk, remoteIndex);
     return Status::OK();
 }
 
 void AsyncRequestsSender::_handleResponse(
-    const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData, size_t remoteIndex) {
+    const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData,
+    size_t remoteIndex,
+    bool isHedged) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
     auto& remote = _remotes[remoteIndex];
-    invariant(!remote.swResponse);
-
-    // Clear the callback handle. This indicates that we are no longer waiting on a response from
-    // 'remote'.
-    remote.cbHandle = executor::TaskExecutor::CallbackHandle();
 
-    // Store the response or error.
-    if (cbData.response.status.isOK()) {
-        remote.swResponse = std::move(cbData.response);
+    // Clear the callback handle. This indicates that we are no longer waiting on this response
+    // from 'remote'.
+    if (isHedged) {
+        remote.hedgeCbHandle = executor::TaskExecutor::CallbackHandle();
     } else {
-        remote.swResponse = std::move(cbData.response.status);
+        remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    }
+
+    if (cbData.response.status.isOK() && cbData.response.elapsedMillis &&
+        (operationLatencyAwareReads.load() || hedgedReadsEnabled.load())) {
+        if (auto shard = remote.getShard()) {
+            shard->getTargeter()->updateHostWithOperationLatency(cbData.request.target,
+                                                                 *cbData.response.elapsedMillis);
+        }
+    }
+
+    // The first of the original and the hedged request to return provides the response, and the
+    // other one is canceled.
+    if (!remote.swResponse) {
+        if (cbData.response.status.isOK()) {
+            remote.swResponse = std::move(cbData.response);
+        } else {
+            remote.swResponse = std::move(cbData.response.status);
+        }
+
+        if (isHedged) {
+            LOG(1) << "Hedged request to remote " << remote.shardId << " at host "
+                   << *remote.hedgeHostAndPort << " returned before the request to host "
+                   << *remote.shardHostAndPort;
+            remote.shardHostAndPort = remote.hedgeHostAndPort;
+        }
+
+        if (remote.cbHandle.isValid()) {
+            _executor->cancel(remote.cbHandle);
+        }
+        if (remote.hedgeTimerHandle.isValid()) {
+            _executor->cancel(remote.hedgeTimerHandle);
+        }
+        if (remote.hedgeCbHandle.isValid()) {
+            _executor->cancel(remote.hedgeCbHandle);
+        }
+    }
+
+    // The remote is not ready until the callbacks of the canceled request and timer have run, since
+    // they refer to this ARS.
+    if (remote.hasPendingCallbacks()) {
+        return;
     }
 
     // Signal the notification indicating that a remote received a response.
@@ -286,6 +372,93 @@ void AsyncRequestsSender::_handleResponse(
     }
 }
 
+bool AsyncRequestsSender::_shouldHedge(const RemoteData& remote) const {
+    if (!hedgedReadsEnabled.load() || _readPreference.pref == ReadPreference::PrimaryOnly) {
+        return false;
+    }
+
+    const StringData cmdName = remote.cmdObj.firstElementFieldName();
+    if (cmdName == "count"_sd || cmdName == "distinct"_sd) {
+        return true;
+    }
+
+    // A single batch find closes its cursor on the shard before replying, whereas the cursor of a
+    // canceled find or aggregate would stay open on the shard until it times out.
+    return cmdName == "find"_sd && remote.cmdObj["singleBatch"].trueValue();
+}
+
+void AsyncRequestsSender::_scheduleHedgeTimer(WithLock, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    if (!_shouldHedge(remote)) {
+        return;
+    }
+
+    const auto shard = remote.getShard();
+    if (!shard) {
+        return;
+    }
+
+    // Without any latency observed from the host there is no telling when it is late, so only
+    // reads to hosts which have answered before are hedged.
+    const auto latencyBound =
+        shard->getTargeter()->getOperationLatencyBound(*remote.shardHostAndPort);
+    if (!latencyBound) {
+        return;
+    }
+
+    const auto delay = std::max(*latencyBound, Milliseconds(hedgedReadsMinDelayMillis.load()));
+    auto swTimerHandle = _executor->scheduleWorkAt(
+        _executor->now() + delay,
+        stdx::bind(
+            &AsyncRequestsSender::_sendHedgedRequest, this, stdx::placeholders::_1, remoteIndex));
+    if (swTimerHandle.isOK()) {
+        remote.hedgeTimerHandle = swTimerHandle.getValue();
+    }
+}
+
+void AsyncRequestsSender::_sendHedgedRequest(const executor::TaskExecutor::CallbackArgs& cbData,
+                                             size_t remoteIndex) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto& remote = _remotes[remoteIndex];
+    remote.hedgeTimerHandle = executor::TaskExecutor::CallbackHandle();
+
+    // Hedge only if the timer was not canceled and the first host still has not answered.
+    if (cbData.status.isOK() && !_stopRetrying && !remote.swResponse &&
+        remote.cbHandle.isValid()) {
+        const auto shard = remote.getShard();
+        auto swHost = shard
+            ? shard->getTargeter()->findAlternateHostNoWait(_readPreference,
+                                                            *remote.shardHostAndPort)
+            : StatusWith<HostAndPort>(ErrorCodes::ShardNotFound, "shard was removed");
+        if (swHost.isOK()) {
+            executor::RemoteCommandRequest request(
+                swHost.getValue(), _db, remote.cmdObj, _metadataObj, _opCtx);
+
+            auto callbackStatus = _executor->scheduleRemoteCommand(
+                request,
+                stdx::bind(&AsyncRequestsSender::_handleResponse,
+                           this,
+                           stdx::placeholders::_1,
+                           remoteIndex,
+                           true));
+            if (callbackStatus.isOK()) {
+                LOG(1) << "Sending hedged request to remote " << remote.shardId << " at host "
+                       << swHost.getValue() << " since host " << *remote.shardHostAndPort
+                       << " has not answered yet";
+                remote.hedgeCbHandle = callbackStatus.getValue();
+                remote.hedgeHostAndPort = std::move(swHost.getValue());
+            }
+        }
+    }
+
+    // If the response arrived while this timer was being canceled, the remote is ready now.
+    if (remote.swResponse && !remote.hasPendingCallbacks() && !*_notification) {
+        _notification->set();
+    }
+}
+
 AsyncRequestsSender::Request::Request(ShardId shardId, BSONObj cmdObj)
     : shardId(shardId), cmdObj(cmdObj) {}
 
@@ -323,6 +496,10 @@ Status AsyncRequestsSender::RemoteData::resolveShardIdToHostAndPort(
     return Status::OK();
 }
 
+bool AsyncRequestsSender::RemoteData::hasPendingCallbacks() const {
+    return cbHandle.isValid() || hedgeTimerHandle.isValid() || hedgeCbHandle.isValid();
+}
+
 std::shared_ptr<Shard> AsyncRequestsSender::RemoteData::getShard() {
     // TODO: Pass down an OperationContext* to use here.
     return grid.shardRegistry()->getShardNoReload(shardId);
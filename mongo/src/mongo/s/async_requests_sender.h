@@ -78,6 +78,11 @@ namespace mongo {
  *     }
  * }
  *
+ * When hedged reads are enabled and the read preference allows reading from secondaries, a read
+ * whose host has not answered within the latency usually seen from it is also sent to another
+ * eligible host of the same shard; the first response is returned and the other request is
+ * canceled.
+ *
  * Does not throw exceptions.
  */
 class AsyncRequestsSender {
@@ -153,6 +158,15 @@ public:
      */
     Response next();
 
+    /**
+     * Sends an additional request, whose response is then returned by next() like those of the
+     * requests the ARS was constructed with. If the operation has already been interrupted, the
+     * request is not sent and its response is the interruption error.
+     *
+     * Note: Must only be called from the thread calling next().
+     */
+    void addRequest(const Request& request);
+
     /**
      * Stops the ARS from retrying requests.
      *
@@ -181,6 +195,12 @@ private:
          */
         std::shared_ptr<Shard> getShard();
 
+        /**
+         * Returns true while a request to, or the hedging timer for, this remote has not run its
+         * callback yet.
+         */
+        bool hasPendingCallbacks() const;
+
         // ShardId of the shard to which the command will be sent.
         ShardId shardId;
 
@@ -201,6 +221,14 @@ private:
         // The callback handle to an outstanding request for this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
+        // The callback handle to the timer which sends the hedged request, if one is scheduled.
+        executor::TaskExecutor::CallbackHandle hedgeTimerHandle;
+
+        // The callback handle to an outstanding hedged request for this remote, and the host it was
+        // sent to.
+        executor::TaskExecutor::CallbackHandle hedgeCbHandle;
+        boost::optional<HostAndPort> hedgeHostAndPort;
+
         // Whether this remote's result has been returned.
         bool done = false;
     };
@@ -250,7 +278,28 @@ private:
      * Stores the response or error in the remote and signals the notification.
      */
     void _handleResponse(const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData,
-                         size_t remoteIndex);
+                         size_t remoteIndex,
+                         bool isHedged);
+
+    /**
+     * Returns true if the command of the remote may be sent to a second host. Only reads which
+     * leave no state behind on the host they run on are hedged, since the losing request is
+     * canceled without waiting for the host to notice.
+     */
+    bool _shouldHedge(const RemoteData& remote) const;
+
+    /**
+     * Schedules the timer which sends a hedged request for the remote at 'remoteIndex' if its
+     * host has not answered within the latency the targeter usually observes from it.
+     */
+    void _scheduleHedgeTimer(WithLock, size_t remoteIndex);
+
+    /**
+     * The callback for the hedging timer: sends the request of the remote at 'remoteIndex' to a
+     * second host if the first one still has not answered.
+     */
+    void _sendHedgedRequest(const executor::TaskExecutor::CallbackArgs& cbData,
+                            size_t remoteIndex);
 
     OperationContext* _opCtx;
 
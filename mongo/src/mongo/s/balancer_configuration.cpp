@@ -52,6 +52,7 @@ const char kStopped[] = "stopped";
 const char kMode[] = "mode";
 const char kActiveWindow[] = "activeWindow";
 const char kWaitForDelete[] = "_waitForDelete";
+const char kMaxConcurrentMigrationsPerShard[] = "maxConcurrentMigrationsPerShard";
 
 const NamespaceString kSettingsNamespace("config", "settings");
 
@@ -138,6 +139,11 @@ bool BalancerConfiguration::waitForDelete() const {
     return _balancerSettings.waitForDelete();
 }
 
+int BalancerConfiguration::getMaxConcurrentMigrationsPerShard() const {
+    stdx::lock_guard<stdx::mutex> lk(_balancerSettingsMutex);
+    return _balancerSettings.getMaxConcurrentMigrationsPerShard();
+}
+
 //ˢϢ
 Status BalancerConfiguration::refreshAndCheck(OperationContext* opCtx) {
     // Balancer configuration
@@ -336,6 +342,22 @@ StatusWith<BalancerSettingsType> BalancerSettingsType::fromBSON(const BSONObj& o
         settings._waitForDelete = waitForDelete;
     }
 
+    {
+        long long maxConcurrentMigrationsPerShard;
+        Status status = bsonExtractIntegerFieldWithDefault(
+            obj, kMaxConcurrentMigrationsPerShard, 1, &maxConcurrentMigrationsPerShard);
+        if (!status.isOK())
+            return status;
+
+        if (maxConcurrentMigrationsPerShard < 1) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << kMaxConcurrentMigrationsPerShard
+                                        << " must be at least 1");
+        }
+
+        settings._maxConcurrentMigrationsPerShard = maxConcurrentMigrationsPerShard;
+    }
+
     return settings;
 }
 
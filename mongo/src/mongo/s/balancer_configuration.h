@@ -112,6 +112,14 @@ public:
         return _waitForDelete;
     }
 
+    /**
+     * Returns how many migrations the balancer may schedule at the same time for any one shard.
+     * The shards themselves admit at most their maxConcurrentMigrationsPerShard parameter worth.
+     */
+    int getMaxConcurrentMigrationsPerShard() const {
+        return _maxConcurrentMigrationsPerShard;
+    }
+
 private:
     BalancerSettingsType();
 
@@ -127,6 +135,9 @@ private:
     //db.settings.update({ "_id" : "balancer" },{ $set : { "_waitForDelete" : true } },{ upsert : true })
     //moveChunkʱݸþǷҪͬɾ
     bool _waitForDelete{false};
+
+    // db.settings.update({_id: "balancer"}, {$set: {maxConcurrentMigrationsPerShard: 4}})
+    int _maxConcurrentMigrationsPerShard{1};
 };
 
 /**
@@ -244,6 +255,11 @@ public:
      */
     bool waitForDelete() const;
 
+    /**
+     * Returns how many migrations the balancer may schedule at the same time for any one shard.
+     */
+    int getMaxConcurrentMigrationsPerShard() const;
+
     /**
      * Returns the max chunk size after which a chunk would be considered jumbo.
      */
@@ -207,6 +207,17 @@ TEST(BalancerSettingsType, Defaults) {
     ASSERT_EQ(MigrationSecondaryThrottleOptions::kDefault,
               settings.getSecondaryThrottle().getSecondaryThrottle());
     ASSERT(!settings.getSecondaryThrottle().isWriteConcernSpecified());
+    ASSERT_EQ(1, settings.getMaxConcurrentMigrationsPerShard());
+}
+
+TEST(BalancerSettingsType, MaxConcurrentMigrationsPerShard) {
+    BalancerSettingsType settings = assertGet(
+        BalancerSettingsType::fromBSON(BSON("maxConcurrentMigrationsPerShard" << 4)));
+    ASSERT_EQ(4, settings.getMaxConcurrentMigrationsPerShard());
+    ASSERT_EQ(ErrorCodes::BadValue,
+              BalancerSettingsType::fromBSON(BSON("maxConcurrentMigrationsPerShard" << 0))
+                  .getStatus()
+                  .code());
 }
 
 TEST(BalancerSettingsType, BalancerDisabledThroughStoppedOption) {
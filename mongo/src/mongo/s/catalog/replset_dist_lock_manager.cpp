@@ -48,6 +48,7 @@
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
 #include "mongo/util/timer.h"
 
@@ -102,6 +103,7 @@ void ReplSetDistLockManager::shutDown(OperationContext* opCtx) {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
         _isShutDown = true;
         _shutDownCV.notify_all();
+        _lockReleasedCV.notify_all();
     }
 
     // Don't grab _mutex, otherwise will deadlock trying to join. Safe to read
@@ -222,6 +224,7 @@ Database: { acquireCount: { w: 2 } }, Collection: { acquireCount: { w: 1 } }, op
                 } else {
                     LOG(0) << "distributed lock with " << LocksType::lockID() << ": "
                            << toUnlock.first << nameMessage << " unlocked.";
+                    notifyLockReleased(toUnlock.second);
                 }
 
                 if (isShutDown()) {
@@ -388,6 +391,19 @@ StatusWith<DistLockHandle> ReplSetDistLockManager::lockWithSessionID(OperationCo
 	//ȡconfigShardϢ
     auto configShard = Grid::get(opCtx)->shardRegistry()->getConfigShard();
 
+    // Threads of this process which release the lock wake up its waiters right away, so that the
+    // lock doesn't sit idle for the remainder of the retry interval.
+    const std::string lockName = name.toString();
+    const bool shouldWait = waitFor != Milliseconds::zero();
+    if (shouldWait) {
+        addLockWaiter(lockName);
+    }
+    ON_BLOCK_EXIT([&] {
+        if (shouldWait) {
+            removeLockWaiter(lockName);
+        }
+    });
+
     // Distributed lock acquisition works by tring to update the state of the lock to 'taken'. If
     // the lock is currently taken, we will back off and try the acquisition again, repeating this
     // until the lockTryInterval has been reached. If a network error occurs at each lock
@@ -396,6 +412,10 @@ StatusWith<DistLockHandle> ReplSetDistLockManager::lockWithSessionID(OperationCo
     while (waitFor <= Milliseconds::zero() || Milliseconds(timer.millis()) < waitFor) {
         const string who = str::stream() << _processID << ":" << getThreadName();
 
+        // Taken before the attempt, so that a release which happens while the attempt is in
+        // progress is not missed
+        const uint64_t releaseCount = shouldWait ? getLockReleaseCount(lockName) : 0;
+
 		//ȡʵѾܾûкcfgͨlockpingsˣʵʧҪڼ飬һֱlockʱ
         auto lockExpiration = _lockExpiration;
         MONGO_FAIL_POINT_BLOCK(setDistLockTimeout, customTimeout) {
@@ -558,7 +578,7 @@ StatusWith<DistLockHandle> ReplSetDistLockManager::lockWithSessionID(OperationCo
 
         const Milliseconds timeRemaining =
             std::max(Milliseconds::zero(), waitFor - Milliseconds(timer.millis()));
-        sleepFor(std::min(kLockRetryInterval, timeRemaining));
+        waitForLockRelease(lockName, releaseCount, std::min(kLockRetryInterval, timeRemaining));
     }
 
     return {ErrorCodes::LockBusy, str::stream() << "timed out waiting for " << name};
@@ -606,6 +626,7 @@ void ReplSetDistLockManager::unlock(OperationContext* opCtx, const DistLockHandl
     } else {
         LOG(0) << "distributed lock with " << LocksType::lockID() << ": " << lockSessionID
                << "' unlocked.";
+        notifyLockReleased(boost::none);
     }
 }
 
@@ -619,6 +640,7 @@ void ReplSetDistLockManager::unlock(OperationContext* opCtx,
     } else {
         LOG(0) << "distributed lock with " << LocksType::lockID() << ": '" << lockSessionID
                << "' and " << LocksType::name() << ": '" << name.toString() << "' unlocked.";
+        notifyLockReleased(name.toString());
     }
 }
 
@@ -627,6 +649,8 @@ void ReplSetDistLockManager::unlockAll(OperationContext* opCtx, const std::strin
     if (!status.isOK()) {
         warning() << "Error while trying to unlock existing distributed locks"
                   << causedBy(redact(status));
+    } else {
+        notifyLockReleased(boost::none);
     }
 }
 
@@ -637,6 +661,62 @@ Status ReplSetDistLockManager::checkStatus(OperationContext* opCtx,
 
 //ReplSetDistLockManager::lockWithSessionIDã쳣{ts:lockSessionID, _id:name}¼_unlockList
 //ReplSetDistLockManager::doTask()мд
+void ReplSetDistLockManager::addLockWaiter(const std::string& name) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _lockWaiters[name].numWaiters++;
+}
+
+void ReplSetDistLockManager::removeLockWaiter(const std::string& name) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _lockWaiters.find(name);
+    invariant(it != _lockWaiters.end());
+    if (--it->second.numWaiters == 0) {
+        _lockWaiters.erase(it);
+    }
+}
+
+uint64_t ReplSetDistLockManager::getLockReleaseCount(const std::string& name) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _lockWaiters.find(name);
+    return (it == _lockWaiters.end()) ? 0 : it->second.numReleases;
+}
+
+void ReplSetDistLockManager::waitForLockRelease(const std::string& name,
+                                                uint64_t releaseCount,
+                                                Milliseconds timeout) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _lockReleasedCV.wait_for(lk, timeout.toSystemDuration(), [&] {
+        if (_isShutDown) {
+            return true;
+        }
+
+        auto it = _lockWaiters.find(name);
+        return it != _lockWaiters.end() && it->second.numReleases != releaseCount;
+    });
+}
+
+void ReplSetDistLockManager::notifyLockReleased(const boost::optional<std::string>& name) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_lockWaiters.empty()) {
+        return;
+    }
+
+    if (name) {
+        auto it = _lockWaiters.find(*name);
+        if (it == _lockWaiters.end()) {
+            return;
+        }
+
+        it->second.numReleases++;
+    } else {
+        for (auto& waiters : _lockWaiters) {
+            waiters.second.numReleases++;
+        }
+    }
+
+    _lockReleasedCV.notify_all();
+}
+
 void ReplSetDistLockManager::queueUnlock(const DistLockHandle& lockSessionID,
                                          const boost::optional<std::string>& name) {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
@@ -96,6 +96,40 @@ protected:
     Status checkStatus(OperationContext* opCtx, const DistLockHandle& lockSessionID) override;
 
 private:
+    /**
+     * Holds the threads of this process which are waiting to acquire a lock of a given name.
+     */
+    struct LockWaiters {
+        int numWaiters{0};
+
+        // Incremented each time this process releases the lock
+        uint64_t numReleases{0};
+    };
+
+    /**
+     * Registers and unregisters the calling thread as waiting to acquire the lock 'name'.
+     */
+    void addLockWaiter(const std::string& name);
+    void removeLockWaiter(const std::string& name);
+
+    /**
+     * Returns how many times this process has released the lock 'name' while some thread was
+     * waiting for it.
+     */
+    uint64_t getLockReleaseCount(const std::string& name);
+
+    /**
+     * Blocks until this process releases the lock 'name' after 'releaseCount' was obtained from
+     * getLockReleaseCount, shutDown is called, or 'timeout' elapses. Locks held by other processes
+     * still have to be polled for.
+     */
+    void waitForLockRelease(const std::string& name, uint64_t releaseCount, Milliseconds timeout);
+
+    /**
+     * Wakes up the threads waiting for the lock 'name', or for any lock if 'name' is not known.
+     */
+    void notifyLockReleased(const boost::optional<std::string>& name);
+
     /**
      * Queue a lock to be unlocked asynchronously with retry until it doesn't error.
      */
@@ -158,6 +192,10 @@ private:
     bool _isShutDown = false;              // (M)
     stdx::condition_variable _shutDownCV;  // (M)
 
+    // Threads waiting to acquire a lock, by lock name. Entries only exist while there are waiters.
+    stdx::unordered_map<std::string, LockWaiters> _lockWaiters;  // (M)
+    stdx::condition_variable _lockReleasedCV;                    // (M)
+
     // Map of lockName to last ping information.    ReplSetDistLockManager._pingHistory
     //locknamepingοReplSetDistLockManager::isLockExpired
     stdx::unordered_map<std::string, DistLockPingInfo> _pingHistory;  // (M)
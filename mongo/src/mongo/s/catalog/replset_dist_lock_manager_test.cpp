@@ -570,6 +570,64 @@ TEST_F(RSDistLockMgrWithMockTickSource, LockRetryTimeout) {
     ASSERT_GREATER_THAN(retryAttempt, 1);
 }
 
+/**
+ * Test scenario:
+ * 1. Grab lock fails because the lock is busy.
+ * 2. Another thread of the same process releases the lock before the retry.
+ * 3. Check that the retry happens right away rather than after the retry interval, which is
+ *    longer than the time allowed to acquire the lock.
+ */
+TEST_F(ReplSetDistLockManagerFixture, LockRetriedWhenReleasedByThisProcess) {
+    string lockName("test");
+    string whyMsg("because");
+
+    LocksType goodLockDoc;
+    goodLockDoc.setName(lockName);
+    goodLockDoc.setState(LocksType::LOCKED);
+    goodLockDoc.setProcess(getProcessID());
+    goodLockDoc.setWho("me");
+    goodLockDoc.setWhy(whyMsg);
+    goodLockDoc.setLockID(OID::gen());
+
+    int grabLockCallCount = 0;
+    getMockCatalog()->expectGrabLock(
+        [&grabLockCallCount](StringData, const OID&, StringData, StringData, Date_t, StringData) {
+            grabLockCallCount++;
+        },
+        {ErrorCodes::LockStateChangeFailed, "nMod 0"});
+
+    // Release the lock from "another thread" of this process while the first attempt is being
+    // made, then let the next attempt succeed.
+    getMockCatalog()->expectGetLockByName(
+        [this, &goodLockDoc, &grabLockCallCount](StringData name) {
+            getMockCatalog()->expectUnLock([](const OID&) {}, Status::OK());
+            distLock()->unlock(operationContext(), OID::gen(), name);
+
+            getMockCatalog()->expectGrabLock(
+                [this, &grabLockCallCount](
+                    StringData, const OID&, StringData, StringData, Date_t, StringData) {
+                    grabLockCallCount++;
+                    getMockCatalog()->expectNoGrabLock();
+                },
+                goodLockDoc);
+            getMockCatalog()->expectGetLockByName(
+                [](StringData name) {
+                    FAIL("should not attempt to overtake lock after successful lock");
+                },
+                LocksType());
+        },
+        {ErrorCodes::LockNotFound, "not found!"});
+
+    {
+        auto lockStatus =
+            distLock()->lock(operationContext(), lockName, whyMsg, Milliseconds(400));
+        ASSERT_OK(lockStatus.getStatus());
+        ASSERT_EQUALS(2, grabLockCallCount);
+
+        getMockCatalog()->expectUnLock([](const OID&) {}, Status::OK());
+    }
+}
+
 /**
  * Test scenario:
  * 1. Set mock to error on grab lock.
@@ -235,8 +235,13 @@ public:
      *     even if the collection default collation is non-simple.
      * @param unique: if true, ensure underlying index enforces a unique constraint.
      * @param initPoints: create chunks based on a set of specified split points.
-     * @param initShardIds: If non-empty, specifies the set of shards to assign chunks between.
-     *     Otherwise all chunks will be assigned to the primary shard for the database.
+     * @param distributeInitialChunks: if true and the collection is empty, assign the chunks
+     *     round-robin between all shards. Otherwise all chunks will be assigned to the primary
+     *     shard for the database.
+     * @param initChunkShardIds: if non-empty, holds the owning shard of each of the chunks
+     *     produced by 'initPoints', in order, and takes precedence over
+     *     'distributeInitialChunks'. The caller is responsible for the collection existing on each
+     *     of these shards.
      */
     void shardCollection(OperationContext* opCtx,
                          const std::string& ns,
@@ -246,6 +251,7 @@ public:
                          bool unique,
                          const std::vector<BSONObj>& initPoints,
                          const bool distributeInitialChunks,
+                         const std::vector<ShardId>& initChunkShardIds,
                          const ShardId& dbPrimaryShardId);
 
     /**
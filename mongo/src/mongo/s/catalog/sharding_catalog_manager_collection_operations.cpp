@@ -87,7 +87,8 @@ ChunkVersion createFirstChunks(OperationContext* opCtx,
                                const ShardKeyPattern& shardKeyPattern,
                                const ShardId& primaryShardId,
                                const std::vector<BSONObj>& initPoints,
-                               const bool distributeInitialChunks) {
+                               const bool distributeInitialChunks,
+                               const std::vector<ShardId>& initChunkShardIds) {
 
     const KeyPattern keyPattern = shardKeyPattern.getKeyPattern();
 
@@ -95,6 +96,8 @@ ChunkVersion createFirstChunks(OperationContext* opCtx,
     vector<ShardId> shardIds;
 
     if (initPoints.empty()) {
+        invariant(initChunkShardIds.empty());
+
         // If no split points were specified use the shard's data distribution to determine them
         auto primaryShard =
             uassertStatusOK(Grid::get(opCtx)->shardRegistry()->getShard(opCtx, primaryShardId));
@@ -145,7 +148,10 @@ ChunkVersion createFirstChunks(OperationContext* opCtx,
             splitPoints.push_back(initPoint);
         }
 
-        if (distributeInitialChunks) {
+        if (!initChunkShardIds.empty()) {
+            invariant(initChunkShardIds.size() == splitPoints.size() + 1);
+            shardIds = initChunkShardIds;
+        } else if (distributeInitialChunks) {
             Grid::get(opCtx)->shardRegistry()->getAllShardIds(&shardIds);
         } else {
             shardIds.push_back(primaryShardId);
@@ -231,6 +237,7 @@ void ShardingCatalogManager::shardCollection(OperationContext* opCtx,
                                              bool unique,
                                              const vector<BSONObj>& initPoints,
                                              const bool distributeInitialChunks,
+                                             const vector<ShardId>& initChunkShardIds,
                                              const ShardId& dbPrimaryShardId) {
     const auto catalogClient = Grid::get(opCtx)->catalogClient();
     const auto shardRegistry = Grid::get(opCtx)->shardRegistry();
@@ -268,8 +275,13 @@ void ShardingCatalogManager::shardCollection(OperationContext* opCtx,
                                               ->makeFromBSON(defaultCollation));
     }
 
-    const auto& collVersion = createFirstChunks(
-        opCtx, nss, fieldsAndOrder, dbPrimaryShardId, initPoints, distributeInitialChunks);
+    const auto& collVersion = createFirstChunks(opCtx,
+                                                nss,
+                                                fieldsAndOrder,
+                                                dbPrimaryShardId,
+                                                initPoints,
+                                                distributeInitialChunks,
+                                                initChunkShardIds);
 
     {
         CollectionType coll;
@@ -143,6 +143,7 @@ TEST_F(ShardCollectionTest, anotherMongosSharding) {
                                              false,
                                              vector<BSONObj>{},
                                              false,
+                                             vector<ShardId>{},
                                              testPrimaryShard),
                        AssertionException,
                        ErrorCodes::ManualInterventionRequired);
@@ -184,6 +185,7 @@ TEST_F(ShardCollectionTest, noInitialChunksOrData) {
                               false,
                               vector<BSONObj>{},
                               false,
+                              vector<ShardId>{},
                               testPrimaryShard);
     });
 
@@ -314,6 +316,7 @@ TEST_F(ShardCollectionTest, withInitialChunks) {
                               true,
                               vector<BSONObj>{splitPoint0, splitPoint1, splitPoint2, splitPoint3},
                               true,
+                              vector<ShardId>{},
                               testPrimaryShard);
     });
 
@@ -327,6 +330,77 @@ TEST_F(ShardCollectionTest, withInitialChunks) {
     future.timed_get(kFutureTimeout);
 }
 
+TEST_F(ShardCollectionTest, withInitialChunkShardIds) {
+    // Initial setup
+    const HostAndPort shard0Host{"shardHost0"};
+    const HostAndPort shard1Host{"shardHost1"};
+    const HostAndPort shard2Host{"shardHost2"};
+
+    ShardType shard0;
+    shard0.setName("shard0");
+    shard0.setHost(shard0Host.toString());
+
+    ShardType shard1;
+    shard1.setName("shard1");
+    shard1.setHost(shard1Host.toString());
+
+    ShardType shard2;
+    shard2.setName("shard2");
+    shard2.setHost(shard2Host.toString());
+
+    std::unique_ptr<RemoteCommandTargeterMock> targeter0(
+        stdx::make_unique<RemoteCommandTargeterMock>());
+    targeter0->setConnectionStringReturnValue(ConnectionString(shard0Host));
+    targeter0->setFindHostReturnValue(shard0Host);
+    targeterFactory()->addTargeterToReturn(ConnectionString(shard0Host), std::move(targeter0));
+
+    ASSERT_OK(setupShards(vector<ShardType>{shard0, shard1, shard2}));
+
+    const auto nss = NamespaceString("db1.foo");
+    setupDatabase(nss.db().toString(), shard0.getName(), true);
+
+    ShardKeyPattern keyPattern(BSON("_id" << 1));
+
+    const BSONObj splitPoint0 = BSON("_id" << 1);
+    const BSONObj splitPoint1 = BSON("_id" << 100);
+    const BSONObj splitPoint2 = BSON("_id" << 200);
+
+    // Deliberately not round-robin, as zones would assign them
+    const vector<ShardId> chunkShardIds{
+        shard2.getName(), shard2.getName(), shard0.getName(), shard1.getName()};
+
+    BSONObj defaultCollation;
+
+    // Now start actually sharding the collection.
+    auto future = launchAsync([&] {
+        ON_BLOCK_EXIT([&] { Client::destroy(); });
+        Client::initThreadIfNotAlready("Test");
+        auto opCtx = cc().makeOperationContext();
+        ShardingCatalogManager::get(operationContext())
+            ->shardCollection(opCtx.get(),
+                              nss.ns(),
+                              boost::none,  // UUID
+                              keyPattern,
+                              defaultCollation,
+                              false,
+                              vector<BSONObj>{splitPoint0, splitPoint1, splitPoint2},
+                              false,
+                              chunkShardIds,
+                              testPrimaryShard);
+    });
+
+    expectSetShardVersion(shard0Host, shard0, nss, boost::none /* expected ChunkVersion */);
+
+    future.timed_get(kFutureTimeout);
+
+    const vector<BSONObj> chunkMins{
+        keyPattern.getKeyPattern().globalMin(), splitPoint0, splitPoint1, splitPoint2};
+    for (size_t i = 0; i < chunkMins.size(); i++) {
+        auto chunk = assertGet(getChunkDoc(operationContext(), chunkMins[i]));
+        ASSERT_EQUALS(chunkShardIds[i], chunk.getShard());
+    }
+}
+
 TEST_F(ShardCollectionTest, withInitialData) {
     // Initial setup
     const HostAndPort shardHost{"shardHost"};
@@ -414,6 +488,7 @@ TEST_F(ShardCollectionTest, withInitialData) {
                               false,
                               vector<BSONObj>{},
                               false,
+                              vector<ShardId>{},
                               testPrimaryShard);
     });
 
@@ -32,6 +32,8 @@
 
 #include "mongo/s/chunk_manager.h"
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
 #include "mongo/base/owned_pointer_vector.h"
@@ -41,6 +43,7 @@
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -49,6 +52,23 @@ namespace {
 // Used to generate sequence numbers to assign to each newly created ChunkManager
 AtomicUInt32 nextCMSequenceNumber(0);
 
+// Shard keys are always ascending, so their KeyString encodings order the same way as the
+// simple BSONObj comparison of the keys.
+const Ordering kShardKeyOrdering = Ordering::make(BSONObj());
+
+bool isHashValue(const BSONObj& key) {
+    return key.nFields() == 1 && key.firstElement().type() == NumberLong;
+}
+
+bool isMaxKey(const BSONObj& key) {
+    return key.nFields() == 1 && key.firstElement().type() == MaxKey;
+}
+
+// Bounds on the number of chunks in a block of a ChunkMap. The larger the blocks, the more an
+// update of the routing table copies; the smaller, the more blocks it copies pointers to.
+const size_t kMaxChunksPerBlock = 512;
+const size_t kMinChunksPerBlock = kMaxChunksPerBlock / 4;
+
 //objǷtype
 void checkAllElementsAreOfType(BSONType type, const BSONObj& o) {
     for (const auto&& element : o) {
@@ -60,6 +80,367 @@ void checkAllElementsAreOfType(BSONType type, const BSONObj& o) {
 
 }  // namespace
 
+/**
+ * An immutable run of consecutive chunks of a ChunkMap, along with their encoded max keys.
+ */
+struct ChunkMap::Block {
+    explicit Block(bool hashedShardKey) : hashed(hashedShardKey) {}
+
+    void append(std::shared_ptr<Chunk> chunk);
+
+    /**
+     * Appends the chunks [begin, end) of 'other', reusing their encoded max keys.
+     */
+    void append(const Block& other, size_t begin, size_t end);
+
+    // Switches the block from the integer representation of the max keys to the KeyString one,
+    // after a max key which is not a NumberLong hash value is appended.
+    void convertToKeyStrings();
+
+    /**
+     * Returns whether 'key' is less than the max key of the chunk at index 'i'.
+     */
+    bool lessThanMax(const SearchKey& key, size_t i) const;
+
+    /**
+     * Returns the index of the first chunk whose max key is greater than 'key', or the number of
+     * chunks if there is no such chunk.
+     */
+    size_t upperBound(const SearchKey& key) const;
+
+    // Whether the max keys are kept in 'hashedMaxKeys' rather than in 'keyStrings'.
+    bool hashed;
+
+    std::vector<std::shared_ptr<Chunk>> chunks;
+
+    // The KeyString encodings of the chunks' max keys, back to back. The encoding of the max key
+    // of chunk 'i' ends at offset 'keyStringEnds[i]' and starts where the one of chunk 'i - 1'
+    // ends.
+    std::string keyStrings;
+    std::vector<uint32_t> keyStringEnds;
+
+    // The max keys of all chunks but a last one whose max key is MaxKey. Only used when 'hashed'
+    // is true.
+    std::vector<long long> hashedMaxKeys;
+
+    // Maximum version of the block's chunks on each shard, filled in when the block is sealed.
+    ShardVersionMap shardVersions;
+};
+
+/**
+ * A key looked up in a ChunkMap, encoded as a KeyString only once a block needs it.
+ */
+class ChunkMap::SearchKey {
+public:
+    explicit SearchKey(const BSONObj& key)
+        : obj(key),
+          isHash(isHashValue(key)),
+          hash(isHash ? key.firstElement()._numberLong() : 0) {}
+
+    const KeyString& keyString() const {
+        if (!_keyString) {
+            _keyString.emplace(KeyString::Version::V1, obj, kShardKeyOrdering);
+        }
+        return *_keyString;
+    }
+
+    const BSONObj& obj;
+    const bool isHash;
+    const long long hash;
+
+private:
+    mutable boost::optional<KeyString> _keyString;
+};
+
+void ChunkMap::Block::append(std::shared_ptr<Chunk> chunk) {
+    const BSONObj& max = chunk->getMax();
+
+    if (hashed) {
+        // Only a last chunk, ending at MaxKey, may be left out of the hashed max keys
+        const bool followsLastChunk = hashedMaxKeys.size() < chunks.size();
+        if (!followsLastChunk && isHashValue(max)) {
+            hashedMaxKeys.push_back(max.firstElement()._numberLong());
+        } else if (followsLastChunk || !isMaxKey(max)) {
+            convertToKeyStrings();
+        }
+    }
+
+    if (!hashed) {
+        const KeyString keyString(KeyString::Version::V1, max, kShardKeyOrdering);
+        keyStrings.append(keyString.getBuffer(), keyString.getSize());
+        keyStringEnds.push_back(keyStrings.size());
+    }
+
+    chunks.push_back(std::move(chunk));
+}
+
+void ChunkMap::Block::append(const Block& other, size_t begin, size_t end) {
+    if (begin == end) {
+        return;
+    }
+
+    if (hashed || other.hashed) {
+        // Hashed max keys are cheap to extract again, so there is nothing to reuse
+        for (size_t i = begin; i < end; ++i) {
+            append(other.chunks[i]);
+        }
+        return;
+    }
+
+    const uint32_t otherStart = begin == 0 ? 0 : other.keyStringEnds[begin - 1];
+    const uint32_t start = keyStrings.size();
+    keyStrings.append(other.keyStrings, otherStart, other.keyStringEnds[end - 1] - otherStart);
+    for (size_t i = begin; i < end; ++i) {
+        keyStringEnds.push_back(other.keyStringEnds[i] - otherStart + start);
+    }
+
+    chunks.insert(chunks.end(), other.chunks.begin() + begin, other.chunks.begin() + end);
+}
+
+void ChunkMap::Block::convertToKeyStrings() {
+    hashed = false;
+    std::vector<long long>().swap(hashedMaxKeys);
+
+    for (const auto& chunk : chunks) {
+        const KeyString keyString(KeyString::Version::V1, chunk->getMax(), kShardKeyOrdering);
+        keyStrings.append(keyString.getBuffer(), keyString.getSize());
+        keyStringEnds.push_back(keyStrings.size());
+    }
+}
+
+bool ChunkMap::Block::lessThanMax(const SearchKey& key, size_t i) const {
+    if (hashed) {
+        if (!key.isHash) {
+            return SimpleBSONObjComparator::kInstance.evaluate(key.obj < chunks[i]->getMax());
+        }
+
+        return i >= hashedMaxKeys.size() || key.hash < hashedMaxKeys[i];
+    }
+
+    const KeyString& keyString = key.keyString();
+    const size_t keySize = keyString.getSize();
+    const uint32_t start = i == 0 ? 0 : keyStringEnds[i - 1];
+    const size_t size = keyStringEnds[i] - start;
+
+    const int cmp =
+        std::memcmp(keyString.getBuffer(), keyStrings.data() + start, std::min(keySize, size));
+    return cmp < 0 || (cmp == 0 && keySize < size);
+}
+
+size_t ChunkMap::Block::upperBound(const SearchKey& key) const {
+    if (hashed && key.isHash) {
+        return std::upper_bound(hashedMaxKeys.begin(), hashedMaxKeys.end(), key.hash) -
+            hashedMaxKeys.begin();
+    }
+
+    size_t low = 0;
+    size_t high = chunks.size();
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (lessThanMax(key, mid)) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+
+    return low;
+}
+
+ChunkMap::const_iterator& ChunkMap::const_iterator::operator++() {
+    if (++_offset == (*_blockIt)->chunks.size()) {
+        ++_blockIt;
+        _offset = 0;
+    }
+    return *this;
+}
+
+const std::shared_ptr<Chunk>& ChunkMap::const_iterator::operator*() const {
+    return (*_blockIt)->chunks[_offset];
+}
+
+const std::shared_ptr<Chunk>& ChunkMap::operator[](size_t i) const {
+    const size_t blockIndex = _findBlock(i);
+    return _blocks[blockIndex]->chunks[i - _blockBegin(blockIndex)];
+}
+
+size_t ChunkMap::upperBound(const BSONObj& key) const {
+    const SearchKey searchKey(key);
+
+    // Find the first block whose last chunk's max key is greater than the key
+    size_t low = 0;
+    size_t high = _blocks.size();
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        const Block& block = *_blocks[mid];
+        if (block.lessThanMax(searchKey, block.chunks.size() - 1)) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+
+    if (low == _blocks.size()) {
+        return size();
+    }
+
+    return _blockBegin(low) + _blocks[low]->upperBound(searchKey);
+}
+
+void ChunkMap::getShardIds(size_t begin,
+                           size_t end,
+                           size_t maxShards,
+                           std::set<ShardId>* shardIds) const {
+    while (begin < end && shardIds->size() < maxShards) {
+        const size_t blockIndex = _findBlock(begin);
+        const size_t blockBegin = _blockBegin(blockIndex);
+        const size_t blockEnd = _blockEnds[blockIndex];
+        const Block& block = *_blocks[blockIndex];
+
+        if (begin == blockBegin && blockEnd <= end) {
+            for (const auto& entry : block.shardVersions) {
+                shardIds->insert(entry.first);
+            }
+        } else {
+            for (size_t i = begin; i < std::min(end, blockEnd); ++i) {
+                shardIds->insert(block.chunks[i - blockBegin]->getShardId());
+            }
+        }
+
+        begin = std::min(end, blockEnd);
+    }
+}
+
+ShardVersionMap ChunkMap::getShardVersions() const {
+    ShardVersionMap shardVersions;
+
+    for (const auto& block : _blocks) {
+        for (const auto& entry : block->shardVersions) {
+            auto it = shardVersions.emplace(entry).first;
+            if (entry.second > it->second) {
+                it->second = entry.second;
+            }
+        }
+    }
+
+    return shardVersions;
+}
+
+size_t ChunkMap::_findBlock(size_t i) const {
+    return std::upper_bound(_blockEnds.begin(), _blockEnds.end(), i) - _blockEnds.begin();
+}
+
+ChunkMap::Builder::Builder(bool hashedShardKey) : _hashed(hashedShardKey) {}
+
+ChunkMap::Builder::~Builder() = default;
+
+void ChunkMap::Builder::append(std::shared_ptr<Chunk> chunk) {
+    _checkContiguous(*chunk);
+    _lastChunk = chunk.get();
+
+    if (!_openBlock) {
+        _openBlock = stdx::make_unique<Block>(_hashed);
+    }
+
+    _openBlock->append(std::move(chunk));
+
+    if (_openBlock->chunks.size() >= kMaxChunksPerBlock) {
+        _sealOpenBlock();
+    }
+}
+
+void ChunkMap::Builder::append(const ChunkMap& other, size_t begin, size_t end) {
+    while (begin < end) {
+        const size_t blockIndex = other._findBlock(begin);
+        const size_t blockBegin = other._blockBegin(blockIndex);
+        const size_t blockEnd = other._blockEnds[blockIndex];
+        const auto& block = other._blocks[blockIndex];
+
+        _checkContiguous(*block->chunks[begin - blockBegin]);
+
+        // Share the whole block, unless the block under construction is too small to be left as
+        // it is, in which case the block is copied into it instead
+        if (begin == blockBegin && blockEnd <= end &&
+            (!_openBlock || _openBlock->chunks.size() >= kMinChunksPerBlock)) {
+            _sealOpenBlock();
+            _pushBlock(block);
+            _lastChunk = block->chunks.back().get();
+            begin = blockEnd;
+            continue;
+        }
+
+        if (!_openBlock) {
+            _openBlock = stdx::make_unique<Block>(_hashed);
+        }
+
+        const size_t copyEnd = std::min(end, blockEnd);
+        _openBlock->append(*block, begin - blockBegin, copyEnd - blockBegin);
+        _lastChunk = _openBlock->chunks.back().get();
+
+        if (_openBlock->chunks.size() >= kMaxChunksPerBlock) {
+            _sealOpenBlock();
+        }
+
+        begin = copyEnd;
+    }
+}
+
+ChunkMap ChunkMap::Builder::done() {
+    _sealOpenBlock();
+    return std::move(_map);
+}
+
+void ChunkMap::Builder::_checkContiguous(const Chunk& chunk) const {
+    if (!_lastChunk) {
+        return;
+    }
+
+    uassert(ErrorCodes::ConflictingOperationInProgress,
+            str::stream() << "Gap or an overlap between chunks "
+                          << ChunkRange(chunk.getMin(), chunk.getMax()).toString()
+                          << " and "
+                          << ChunkRange(_lastChunk->getMin(), _lastChunk->getMax()).toString(),
+            SimpleBSONObjComparator::kInstance.evaluate(_lastChunk->getMax() == chunk.getMin()));
+}
+
+void ChunkMap::Builder::_sealOpenBlock() {
+    if (!_openBlock) {
+        return;
+    }
+
+    std::vector<std::unique_ptr<Block>> blocks;
+    if (_openBlock->chunks.size() <= kMaxChunksPerBlock) {
+        blocks.push_back(std::move(_openBlock));
+    } else {
+        // Copying a shared block into a small one leaves it with up to twice the maximum number
+        // of chunks, so split it in halves
+        const size_t half = _openBlock->chunks.size() / 2;
+        for (const auto& range : {std::make_pair(size_t(0), half),
+                                  std::make_pair(half, _openBlock->chunks.size())}) {
+            auto block = stdx::make_unique<Block>(_hashed);
+            block->append(*_openBlock, range.first, range.second);
+            blocks.push_back(std::move(block));
+        }
+        _openBlock.reset();
+    }
+
+    for (auto& block : blocks) {
+        for (const auto& chunk : block->chunks) {
+            auto it = block->shardVersions.emplace(chunk->getShardId(), chunk->getLastmod()).first;
+            if (chunk->getLastmod() > it->second) {
+                it->second = chunk->getLastmod();
+            }
+        }
+
+        _pushBlock(std::move(block));
+    }
+}
+
+void ChunkMap::Builder::_pushBlock(std::shared_ptr<const Block> block) {
+    _map._blockEnds.push_back(_map.size() + block->chunks.size());
+    _map._blocks.push_back(std::move(block));
+}
+
 ChunkManager::ChunkManager(NamespaceString nss,
                            boost::optional<UUID> uuid,
                            KeyPattern shardKeyPattern,
@@ -91,12 +472,12 @@ std::shared_ptr<Chunk> ChunkManager::findIntersectingChunk(const BSONObj& shardK
         }
     }
 
-    const auto it = _chunkMap.upper_bound(shardKey);
+    const size_t index = _chunkMap.upperBound(shardKey);
     uassert(ErrorCodes::ShardKeyNotFound,
             str::stream() << "Cannot target single shard using key " << shardKey,
-            it != _chunkMap.end() && it->second->containsKey(shardKey));
+            index < _chunkMap.size() && _chunkMap[index]->containsKey(shardKey));
 
-    return it->second;
+    return _chunkMap[index];
 }
 
 std::shared_ptr<Chunk> ChunkManager::findIntersectingChunkWithSimpleCollation(
@@ -171,33 +552,23 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
     // For now, we satisfy that assumption by adding a shard with no matches rather than returning
     // an empty set of shards.
     if (shardIds->empty()) {
-        shardIds->insert(_chunkMapViews.chunkRangeMap.begin()->second.shardId);
+        shardIds->insert((*_chunkMap.begin())->getShardId());
     }
 }
 
 void ChunkManager::getShardIdsForRange(const BSONObj& min,
                                        const BSONObj& max,
                                        std::set<ShardId>* shardIds) const {
-    auto it = _chunkMapViews.chunkRangeMap.upper_bound(min);
-    auto end = _chunkMapViews.chunkRangeMap.upper_bound(max);
+    const size_t begin = _chunkMap.upperBound(min);
 
-    // The chunk range map must always cover the entire key space
-    invariant(it != _chunkMapViews.chunkRangeMap.end());
+    // The chunk map must always cover the entire key space
+    invariant(begin < _chunkMap.size());
 
     // We need to include the last chunk
-    if (end != _chunkMapViews.chunkRangeMap.cend()) {
-        ++end;
-    }
+    const size_t end = std::min(_chunkMap.upperBound(max) + 1, _chunkMap.size());
 
-    for (; it != end; ++it) {
-        shardIds->insert(it->second.shardId);
-
-        // No need to iterate through the rest of the ranges, because we already know we need to use
-        // all shards.
-        if (shardIds->size() == _chunkMapViews.shardVersions.size()) {
-            break;
-        }
-    }
+    // No need to look through the rest of the chunks once we know we need to use all shards
+    _chunkMap.getShardIds(begin, end, _chunkMapViews.shardVersions.size(), shardIds);
 }
 
 //Returns the ids of all shards on which the collection has any chunks.
@@ -335,6 +706,33 @@ bool ChunkManager::compatibleWith(const ChunkManager& other, const ShardId& shar
     return other.getVersion(shardName).equals(getVersion(shardName));
 }
 
+bool ChunkManager::isColocatedWith(const ChunkManager& other) const {
+    const BSONObj keyPattern = _shardKeyPattern.toBSON();
+    const BSONObj otherKeyPattern = other._shardKeyPattern.toBSON();
+    if (keyPattern.nFields() != 1 || otherKeyPattern.nFields() != 1 ||
+        keyPattern.firstElement().woCompare(otherKeyPattern.firstElement(), false) != 0) {
+        return false;
+    }
+
+    if (_chunkMap.size() != other._chunkMap.size()) {
+        return false;
+    }
+
+    // Both maps are ordered by the chunks' upper bounds, so corresponding chunks line up.
+    for (auto it = _chunkMap.begin(), otherIt = other._chunkMap.begin(); it != _chunkMap.end();
+         ++it, ++otherIt) {
+        const Chunk& chunk = **it;
+        const Chunk& otherChunk = **otherIt;
+        if (chunk.getShardId() != otherChunk.getShardId() ||
+            chunk.getMin().woCompare(otherChunk.getMin(), BSONObj(), false) != 0 ||
+            chunk.getMax().woCompare(otherChunk.getMax(), BSONObj(), false) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 ChunkVersion ChunkManager::getVersion(const ShardId& shardName) const {
     auto it = _chunkMapViews.shardVersions.find(shardName);
     if (it == _chunkMapViews.shardVersions.end()) {
@@ -350,8 +748,8 @@ std::string ChunkManager::toString() const {
     StringBuilder sb;
     sb << "ChunkManager: " << _nss.ns() << " key:" << _shardKeyPattern.toString() << '\n';
 
-    for (const auto& entry : _chunkMap) {
-        sb << "\t" << entry.second->toString() << '\n';
+    for (const auto& chunk : _chunkMap) {
+        sb << "\t" << chunk->toString() << '\n';
     }
 
     return sb.str();
@@ -359,84 +757,23 @@ std::string ChunkManager::toString() const {
 
 ChunkManager::ChunkMapViews ChunkManager::_constructChunkMapViews(const OID& epoch,
                                                                   const ChunkMap& chunkMap) {
+    // The chunk map builder already made sure that the chunks are contiguous, so only the ends of
+    // the key space remain to be checked
+    if (!chunkMap.empty()) {
+        checkAllElementsAreOfType(MinKey, (*chunkMap.begin())->getMin());
+        checkAllElementsAreOfType(MaxKey, chunkMap[chunkMap.size() - 1]->getMax());
+    }
 
-    ChunkRangeMap chunkRangeMap =
-        SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ShardAndChunkRange>();
-
-    ShardVersionMap shardVersions;
-
-    ChunkMap::const_iterator current = chunkMap.cbegin();
-
-    while (current != chunkMap.cend()) {
-        const auto& firstChunkInRange = current->second;
-
-        // Tracks the max shard version for the shard on which the current range will reside
-        auto shardVersionIt = shardVersions.find(firstChunkInRange->getShardId());
-        if (shardVersionIt == shardVersions.end()) {
-            shardVersionIt =
-                shardVersions.emplace(firstChunkInRange->getShardId(), ChunkVersion(0, 0, epoch))
-                    .first;
-        }
-
-        auto& maxShardVersion = shardVersionIt->second;
-
-        current = std::find_if(
-            current,
-            chunkMap.cend(),
-            [&firstChunkInRange, &maxShardVersion](const ChunkMap::value_type& chunkMapEntry) {
-                const auto& currentChunk = chunkMapEntry.second;
-
-                if (currentChunk->getShardId() != firstChunkInRange->getShardId())
-                    return true;
-
-                if (currentChunk->getLastmod() > maxShardVersion)
-                    maxShardVersion = currentChunk->getLastmod();
-
-                return false;
-            });
-
-        const auto rangeLast = std::prev(current);
-
-        const BSONObj rangeMin = firstChunkInRange->getMin();
-        const BSONObj rangeMax = rangeLast->second->getMax();
-
-        const auto oldSize = chunkRangeMap.size();
-        const auto insertIterator = chunkRangeMap.insert(
-            chunkRangeMap.end(),
-            std::make_pair(
-                rangeMax,
-                ShardAndChunkRange{{rangeMin, rangeMax}, firstChunkInRange->getShardId()}));
-        uassert(ErrorCodes::ConflictingOperationInProgress,
-                str::stream() << "Metadata contains two chunks with the same max value "
-                              << rangeMax,
-                oldSize + 1 == chunkRangeMap.size());
-
-
-        if (insertIterator != chunkRangeMap.begin()) {
-            // Make sure there are no gaps in the ranges
-            uassert(ErrorCodes::ConflictingOperationInProgress,
-                    str::stream() << "Gap or an overlap between ranges "
-                                  << insertIterator->second.range.toString()
-                                  << " and "
-                                  << std::prev(insertIterator)->second.range.toString(),
-                    SimpleBSONObjComparator::kInstance.evaluate(std::prev(insertIterator)->first ==
-                                                                rangeMin));
-        }
+    ShardVersionMap shardVersions = chunkMap.getShardVersions();
 
+    for (const auto& entry : shardVersions) {
         // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
         // somewhere, which should have been caught at chunk load time
-        invariant(maxShardVersion.isSet());
-    }
-
-    if (!chunkMap.empty()) {
-        invariant(!chunkRangeMap.empty());
-        invariant(!shardVersions.empty());
-
-        checkAllElementsAreOfType(MinKey, chunkRangeMap.begin()->second.min());
-        checkAllElementsAreOfType(MaxKey, chunkRangeMap.rbegin()->first);
+        invariant(entry.second.isSet());
+        invariant(entry.second.epoch() == epoch);
     }
 
-    return {std::move(chunkRangeMap), std::move(shardVersions)};
+    return {std::move(shardVersions)};
 }
 
 //ȡһChunkManager
@@ -449,15 +786,13 @@ std::shared_ptr<ChunkManager> ChunkManager::makeNew(
     bool unique,
     OID epoch,
     const std::vector<ChunkType>& chunks) {
-
-    return ChunkManager(
-               std::move(nss),
-               uuid,
-               std::move(shardKeyPattern),
-               std::move(defaultCollator),
-               std::move(unique),
-               SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<std::shared_ptr<Chunk>>(),
-               {0, 0, epoch})
+    return ChunkManager(std::move(nss),
+                        uuid,
+                        std::move(shardKeyPattern),
+                        std::move(defaultCollator),
+                        std::move(unique),
+                        ChunkMap(),
+                        {0, 0, epoch})
         .makeUpdated(chunks);
 }
 
@@ -465,7 +800,14 @@ std::shared_ptr<ChunkManager> ChunkManager::makeNew(
 std::shared_ptr<ChunkManager> ChunkManager::makeUpdated(
     const std::vector<ChunkType>& changedChunks) {
     const auto startingCollectionVersion = getVersion();
-    auto chunkMap = _chunkMap;
+
+    // The changed chunks, less the ones overlapped by a later change
+    auto updatedChunks =
+        SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<std::shared_ptr<Chunk>>();
+
+    // Ranges [first, second) of positions in the current chunk map of the chunks, which overlap a
+    // changed chunk and are therefore replaced
+    std::vector<std::pair<size_t, size_t>> replacedRanges;
 
     ChunkVersion collectionVersion = startingCollectionVersion;
     for (const auto& chunk : changedChunks) {
@@ -483,17 +825,24 @@ std::shared_ptr<ChunkManager> ChunkManager::makeUpdated(
 
         // Returns the first chunk with a max key that is > min - implies that the chunk overlaps
         // min
-        const auto low = chunkMap.upper_bound(chunk.getMin());
+        const auto low = updatedChunks.upper_bound(chunk.getMin());
 
         // Returns the first chunk with a max key that is > max - implies that the next chunk cannot
         // not overlap max
-        const auto high = chunkMap.upper_bound(chunk.getMax());
+        const auto high = updatedChunks.upper_bound(chunk.getMax());
 
         // Erase all chunks from the map, which overlap the chunk we got from the persistent store
-        chunkMap.erase(low, high);
+        updatedChunks.erase(low, high);
 
         // Insert only the chunk itself
-        chunkMap.insert(std::make_pair(chunk.getMax(), std::make_shared<Chunk>(chunk)));
+        updatedChunks.insert(std::make_pair(chunk.getMax(), std::make_shared<Chunk>(chunk)));
+
+        // The chunks of the current map, which overlap the chunk, by the same criteria
+        const size_t replacedBegin = _chunkMap.upperBound(chunk.getMin());
+        const size_t replacedEnd = _chunkMap.upperBound(chunk.getMax());
+        if (replacedBegin < replacedEnd) {
+            replacedRanges.emplace_back(replacedBegin, replacedEnd);
+        }
     }
 
     // If at least one diff was applied, the metadata is correct, but it might not have changed so
@@ -507,13 +856,47 @@ std::shared_ptr<ChunkManager> ChunkManager::makeUpdated(
         return shared_from_this();
     }
 
+    std::sort(replacedRanges.begin(), replacedRanges.end());
+
+    // Both the current chunk map and the updated chunks are ordered by max key, so the new chunk
+    // map is a merge of the two. The blocks of the current map which no changed chunk touches are
+    // shared with the new one, so the cost of the update is proportional to the number of changed
+    // chunks rather than to the size of the routing table.
+    ChunkMap::Builder chunkMapBuilder(_shardKeyPattern.isHashedPattern());
+
+    size_t next = 0;
+    auto replacedIt = replacedRanges.begin();
+    const auto appendCurrentChunksBefore = [&](size_t end) {
+        while (next < end) {
+            while (replacedIt != replacedRanges.end() && replacedIt->second <= next) {
+                ++replacedIt;
+            }
+
+            if (replacedIt != replacedRanges.end() && replacedIt->first <= next) {
+                next = replacedIt->second;
+                continue;
+            }
+
+            const size_t runEnd =
+                replacedIt == replacedRanges.end() ? end : std::min(end, replacedIt->first);
+            chunkMapBuilder.append(_chunkMap, next, runEnd);
+            next = runEnd;
+        }
+    };
+
+    for (const auto& entry : updatedChunks) {
+        appendCurrentChunksBefore(_chunkMap.upperBound(entry.first));
+        chunkMapBuilder.append(entry.second);
+    }
+    appendCurrentChunksBefore(_chunkMap.size());
+
     return std::shared_ptr<ChunkManager>(
         new ChunkManager(_nss,
                          _uuid,
                          KeyPattern(getShardKeyPattern().getKeyPattern()),
                          CollatorInterface::cloneCollator(getDefaultCollator()),
                          isUnique(),
-                         std::move(chunkMap),
+                         chunkMapBuilder.done(),
                          collectionVersion));
 }
 }  // namespace mongo
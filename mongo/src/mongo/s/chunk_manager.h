@@ -31,6 +31,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/namespace_string.h"
@@ -47,12 +48,147 @@ class CanonicalQuery;
 struct QuerySolutionNode;
 class OperationContext;
 
-// Ordered map from the max for each chunk to an entry describing the chunk
-using ChunkMap = BSONObjIndexedMap<std::shared_ptr<Chunk>>;
-
 // Map from a shard is to the max chunk version on that shard
 using ShardVersionMap = std::map<ShardId, ChunkVersion>;
 
+/**
+ * Flat routing table of a sharded collection: its chunks in ascending order of their max key.
+ *
+ * Rather than a tree keyed on BSONObj, the max keys are kept in contiguous buffers encoded as
+ * KeyString, so that locating the chunk for a shard key is a binary search of memcmp comparisons
+ * over a cache-friendly array. For hashed shard keys, whose chunk bounds are NumberLong hash
+ * values, the max keys are kept as plain arrays of integers instead, which are both smaller and
+ * cheaper to search.
+ *
+ * The chunks are stored in immutable blocks of a bounded size, which copies of a ChunkMap share.
+ * Applying a few changed chunks to a routing table therefore only rebuilds the blocks covering
+ * them and reuses all the others.
+ */
+class ChunkMap {
+    struct Block;
+    class SearchKey;
+
+public:
+    class Builder;
+
+    class const_iterator {
+    public:
+        const_iterator() = default;
+
+        const_iterator& operator++();
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const const_iterator& other) const {
+            return _blockIt == other._blockIt && _offset == other._offset;
+        }
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+        const std::shared_ptr<Chunk>& operator*() const;
+
+    private:
+        friend class ChunkMap;
+
+        using BlockIterator = std::vector<std::shared_ptr<const Block>>::const_iterator;
+
+        const_iterator(BlockIterator blockIt, size_t offset) : _blockIt(blockIt), _offset(offset) {}
+
+        BlockIterator _blockIt;
+        size_t _offset{0};
+    };
+
+    const_iterator begin() const {
+        return {_blocks.begin(), 0};
+    }
+
+    const_iterator end() const {
+        return {_blocks.end(), 0};
+    }
+
+    size_t size() const {
+        return _blockEnds.empty() ? 0 : _blockEnds.back();
+    }
+
+    bool empty() const {
+        return _blocks.empty();
+    }
+
+    const std::shared_ptr<Chunk>& operator[](size_t i) const;
+
+    /**
+     * Returns the index of the first chunk whose max key is greater than 'key', or size() if
+     * there is no such chunk.
+     */
+    size_t upperBound(const BSONObj& key) const;
+
+    /**
+     * Adds to 'shardIds' the shards owning the chunks [begin, end). Stops early once 'shardIds'
+     * holds 'maxShards' entries.
+     */
+    void getShardIds(size_t begin,
+                     size_t end,
+                     size_t maxShards,
+                     std::set<ShardId>* shardIds) const;
+
+    /**
+     * Returns the maximum version of the chunks on each shard, which owns any.
+     */
+    ShardVersionMap getShardVersions() const;
+
+private:
+    // Returns the index of the block containing the chunk at index 'i'
+    size_t _findBlock(size_t i) const;
+
+    size_t _blockBegin(size_t blockIndex) const {
+        return blockIndex == 0 ? 0 : _blockEnds[blockIndex - 1];
+    }
+
+    std::vector<std::shared_ptr<const Block>> _blocks;
+
+    // The index of the chunk following the last chunk of each block
+    std::vector<size_t> _blockEnds;
+};
+
+/**
+ * Accumulates chunks, which must be appended in ascending order of their max key and must cover
+ * contiguous ranges of keys, into a new ChunkMap.
+ */
+class ChunkMap::Builder {
+public:
+    explicit Builder(bool hashedShardKey);
+    ~Builder();
+
+    void append(std::shared_ptr<Chunk> chunk);
+
+    /**
+     * Appends the chunks [begin, end) of 'other', sharing its blocks that fall entirely within
+     * that range and reusing the encoded max keys of the others.
+     */
+    void append(const ChunkMap& other, size_t begin, size_t end);
+
+    ChunkMap done();
+
+private:
+    // Throws if 'chunk' does not start where the last appended chunk ends
+    void _checkContiguous(const Chunk& chunk) const;
+
+    // Moves the block under construction, if any, to the map
+    void _sealOpenBlock();
+
+    void _pushBlock(std::shared_ptr<const Block> block);
+
+    const bool _hashed;
+
+    ChunkMap _map;
+
+    std::unique_ptr<Block> _openBlock;
+
+    const Chunk* _lastChunk{nullptr};
+};
+
 /**
  * In-memory representation of the routing table for a single sharded collection.
  */ 
@@ -83,8 +219,8 @@ public:
         bool operator!=(const ConstChunkIterator& other) const {
             return !(*this == other);
         }
-        const ChunkMap::mapped_type& operator*() const {
-            return _iter->second;
+        const std::shared_ptr<Chunk>& operator*() const {
+            return *_iter;
         }
 
     private:
@@ -166,7 +302,7 @@ public:
     ChunkVersion getVersion(const ShardId& shardId) const;
 
     ConstRangeOfChunks chunks() const {
-        return {ConstChunkIterator{_chunkMap.cbegin()}, ConstChunkIterator{_chunkMap.cend()}};
+        return {ConstChunkIterator{_chunkMap.begin()}, ConstChunkIterator{_chunkMap.end()}};
     }
 
     int numChunks() const {
@@ -239,6 +375,14 @@ public:
      */
     bool compatibleWith(const ChunkManager& other, const ShardId& shard) const;
 
+    /**
+     * Returns true if both collections are sharded on a single field of the same kind (ranged or
+     * hashed), and every chunk of this collection has the same bounds, ignoring field names, and
+     * the same owning shard as the corresponding chunk of 'other'. A document of this collection
+     * and a document of 'other' with equal shard key values then always live on the same shard.
+     */
+    bool isColocatedWith(const ChunkManager& other) const;
+
     std::string toString() const;
 
     bool uuidMatches(UUID uuid) const {
@@ -246,41 +390,18 @@ public:
     }
 
 private:
-    /**
-     * Represents a range of chunk keys [getMin(), getMax()) and the id of the shard on which they
-     * reside according to the metadata.
-     */
-    struct ShardAndChunkRange {
-        const BSONObj& min() const {
-            return range.getMin();
-        }
-
-        const BSONObj& max() const {
-            return range.getMax();
-        }
-
-        ChunkRange range;
-        ShardId shardId;
-    };
-
-    using ChunkRangeMap = BSONObjIndexedMap<ShardAndChunkRange>;
-
     /**
      * Contains different transformations of the chunk map for efficient querying
      */
     struct ChunkMapViews {
-        // Transformation of the chunk map containing what range of keys reside on which shard. The
-        // index is the max key of the respective range and the union of all ranges in a such
-        // constructed map must cover the complete space from [MinKey, MaxKey).
-        const ChunkRangeMap chunkRangeMap;
-
         // Map from shard id to the maximum chunk version for that shard. If a shard contains no
         // chunks, it won't be present in this map.
         const ShardVersionMap shardVersions;
     };
 
     /**
-     * Does a single pass over the chunkMap and constructs the ChunkMapViews object.
+     * Constructs the ChunkMapViews object from the per-block summaries of the chunkMap, without
+     * visiting every chunk.
      */
     static ChunkMapViews _constructChunkMapViews(const OID& epoch, const ChunkMap& chunkMap);
 
@@ -311,8 +432,8 @@ private:
     // Whether the sharding key is unique
     const bool _unique;
 
-    // Map from the max for each chunk to an entry describing the chunk. The union of all chunks'
-    // ranges must cover the complete space from [MinKey, MaxKey).
+    // The chunks ordered by their max key. The union of all chunks' ranges must cover the
+    // complete space from [MinKey, MaxKey).
     //·ɱ  ChunkManager::toStringԴӡmongos·ɱ
     const ChunkMap _chunkMap;
 
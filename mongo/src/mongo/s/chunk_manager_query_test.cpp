@@ -30,6 +30,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <limits>
 #include <set>
 
 #include "mongo/db/query/collation/collator_interface_mock.h"
@@ -438,5 +439,207 @@ TEST_F(ChunkManagerQueryTest, SimpleCollationNumbersMultiShard) {
         {ShardId("0")});
 }
 
+TEST_F(ChunkManagerQueryTest, ColocatedWithCollectionOfSameChunkBoundsAndShards) {
+    auto chunkManager = makeChunkManager(
+        kNss, ShardKeyPattern(BSON("a" << 1)), nullptr, false, {BSON("a" << 0), BSON("a" << 10)});
+    auto otherChunkManager = makeChunkManager(NamespaceString("OtherDB", "OtherColl"),
+                                              ShardKeyPattern(BSON("b" << 1)),
+                                              nullptr,
+                                              false,
+                                              {BSON("b" << 0), BSON("b" << 10)});
+
+    ASSERT_TRUE(chunkManager->isColocatedWith(*otherChunkManager));
+    ASSERT_TRUE(otherChunkManager->isColocatedWith(*chunkManager));
+}
+
+TEST_F(ChunkManagerQueryTest, NotColocatedWithCollectionOfDifferentChunkBounds) {
+    auto chunkManager = makeChunkManager(
+        kNss, ShardKeyPattern(BSON("a" << 1)), nullptr, false, {BSON("a" << 0), BSON("a" << 10)});
+    auto otherChunkManager = makeChunkManager(NamespaceString("OtherDB", "OtherColl"),
+                                              ShardKeyPattern(BSON("b" << 1)),
+                                              nullptr,
+                                              false,
+                                              {BSON("b" << 0), BSON("b" << 20)});
+
+    ASSERT_FALSE(chunkManager->isColocatedWith(*otherChunkManager));
+}
+
+TEST_F(ChunkManagerQueryTest, NotColocatedWithCollectionOfDifferentShardKeyKind) {
+    auto chunkManager =
+        makeChunkManager(kNss, ShardKeyPattern(BSON("a" << 1)), nullptr, false, {BSON("a" << 0)});
+    auto otherChunkManager = makeChunkManager(NamespaceString("OtherDB", "OtherColl"),
+                                              ShardKeyPattern(BSON("b"
+                                                                   << "hashed")),
+                                              nullptr,
+                                              false,
+                                              {BSON("b" << 0)});
+
+    ASSERT_FALSE(chunkManager->isColocatedWith(*otherChunkManager));
+}
+
+TEST_F(ChunkManagerQueryTest, FindIntersectingChunkHashedShardKey) {
+    auto chunkManager =
+        makeChunkManager(kNss,
+                         ShardKeyPattern(BSON("a"
+                                              << "hashed")),
+                         nullptr,
+                         false,
+                         {BSON("a" << -100LL), BSON("a" << 0LL), BSON("a" << 100LL)});
+
+    const auto shardFor = [&](const BSONObj& shardKey) {
+        return chunkManager->findIntersectingChunkWithSimpleCollation(shardKey)->getShardId();
+    };
+
+    ASSERT_EQ(ShardId("0"), shardFor(BSON("a" << MINKEY)));
+    ASSERT_EQ(ShardId("0"), shardFor(BSON("a" << -101LL)));
+    ASSERT_EQ(ShardId("1"), shardFor(BSON("a" << -100LL)));
+    ASSERT_EQ(ShardId("2"), shardFor(BSON("a" << 0LL)));
+    ASSERT_EQ(ShardId("2"), shardFor(BSON("a" << 50)));
+    ASSERT_EQ(ShardId("3"), shardFor(BSON("a" << 100LL)));
+    ASSERT_EQ(ShardId("3"), shardFor(BSON("a" << std::numeric_limits<long long>::max())));
+    ASSERT_THROWS_CODE(
+        shardFor(BSON("a" << MAXKEY)), AssertionException, ErrorCodes::ShardKeyNotFound);
+}
+
+TEST_F(ChunkManagerQueryTest, FindIntersectingChunkCompoundShardKey) {
+    auto chunkManager = makeChunkManager(kNss,
+                                         ShardKeyPattern(BSON("a" << 1 << "b" << 1)),
+                                         nullptr,
+                                         false,
+                                         {BSON("a"
+                                               << "x"
+                                               << "b"
+                                               << 5),
+                                          BSON("a"
+                                               << "y"
+                                               << "b"
+                                               << 5.5)});
+
+    const auto shardFor = [&](const BSONObj& shardKey) {
+        return chunkManager->findIntersectingChunkWithSimpleCollation(shardKey)->getShardId();
+    };
+
+    ASSERT_EQ(ShardId("0"), shardFor(BSON("a" << 10 << "b" << 10)));
+    ASSERT_EQ(ShardId("0"),
+              shardFor(BSON("a"
+                            << "x"
+                            << "b"
+                            << 4.5)));
+    ASSERT_EQ(ShardId("1"),
+              shardFor(BSON("a"
+                            << "x"
+                            << "b"
+                            << 5LL)));
+    ASSERT_EQ(ShardId("1"),
+              shardFor(BSON("a"
+                            << "y"
+                            << "b"
+                            << 5)));
+    ASSERT_EQ(ShardId("2"),
+              shardFor(BSON("a"
+                            << "y"
+                            << "b"
+                            << 5.5)));
+    ASSERT_EQ(ShardId("2"), shardFor(BSON("a" << BSONObj() << "b" << 0)));
+}
+
+TEST_F(ChunkManagerQueryTest, MakeUpdatedReplacesOnlyOverlappedChunks) {
+    auto chunkManager = makeChunkManager(
+        kNss, ShardKeyPattern(BSON("a" << 1)), nullptr, false, {BSON("a" << 0), BSON("a" << 10)});
+
+    // Split the middle chunk [0, 10) and move its upper half to the last shard
+    ChunkVersion version = chunkManager->getVersion();
+    version.incMajor();
+    ChunkType lowerHalf(kNss, {BSON("a" << 0), BSON("a" << 5)}, version, ShardId("1"));
+    version.incMinor();
+    ChunkType upperHalf(kNss, {BSON("a" << 5), BSON("a" << 10)}, version, ShardId("2"));
+
+    auto updated = chunkManager->makeUpdated({lowerHalf, upperHalf});
+    ASSERT_NE(chunkManager.get(), updated.get());
+    ASSERT_EQ(4, updated->numChunks());
+    ASSERT_EQ(version, updated->getVersion());
+
+    const auto shardFor = [&](const BSONObj& shardKey) {
+        return updated->findIntersectingChunkWithSimpleCollation(shardKey)->getShardId();
+    };
+
+    ASSERT_EQ(ShardId("0"), shardFor(BSON("a" << -1)));
+    ASSERT_EQ(ShardId("1"), shardFor(BSON("a" << 4)));
+    ASSERT_EQ(ShardId("2"), shardFor(BSON("a" << 5)));
+    ASSERT_EQ(ShardId("2"), shardFor(BSON("a" << 10)));
+
+    std::set<ShardId> shardIds;
+    updated->getShardIdsForRange(BSON("a" << 1), BSON("a" << 6), &shardIds);
+    ASSERT_EQ(2U, shardIds.size());
+
+    // The chunks outside of the split range are shared with the previous routing table
+    ASSERT_EQ(chunkManager->findIntersectingChunkWithSimpleCollation(BSON("a" << -1)).get(),
+              updated->findIntersectingChunkWithSimpleCollation(BSON("a" << -1)).get());
+}
+
+TEST_F(ChunkManagerQueryTest, MakeUpdatedOnManyChunksKeepsRoutingTableContiguous) {
+    const ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+    const int kNumChunks = 5000;
+
+    ChunkVersion version(1, 0, OID::gen());
+    std::vector<ChunkType> chunks;
+    for (int i = 0; i < kNumChunks; ++i) {
+        const BSONObj min = i == 0 ? shardKeyPattern.getKeyPattern().globalMin() : BSON("a" << i);
+        const BSONObj max = i == kNumChunks - 1 ? shardKeyPattern.getKeyPattern().globalMax()
+                                                : BSON("a" << i + 1);
+        chunks.emplace_back(kNss, ChunkRange(min, max), version, ShardId(i < 2500 ? "0" : "1"));
+        version.incMinor();
+    }
+
+    auto chunkManager = ChunkManager::makeNew(kNss,
+                                              boost::none,
+                                              shardKeyPattern.getKeyPattern(),
+                                              nullptr,
+                                              false,
+                                              version.epoch(),
+                                              chunks);
+    ASSERT_EQ(kNumChunks, chunkManager->numChunks());
+
+    // Split chunk [1000, 1001) and merge chunks [3000, 3003)
+    version.incMajor();
+    ChunkType lowerHalf(kNss, {BSON("a" << 1000), BSON("a" << 1000.5)}, version, ShardId("0"));
+    version.incMinor();
+    ChunkType upperHalf(kNss, {BSON("a" << 1000.5), BSON("a" << 1001)}, version, ShardId("0"));
+    version.incMinor();
+    ChunkType merged(kNss, {BSON("a" << 3000), BSON("a" << 3003)}, version, ShardId("1"));
+
+    auto updated = chunkManager->makeUpdated({lowerHalf, upperHalf, merged});
+    ASSERT_EQ(kNumChunks - 1, updated->numChunks());
+    ASSERT_EQ(version, updated->getVersion());
+    ASSERT_EQ(version, updated->getVersion(ShardId("1")));
+
+    BSONObj lastMax;
+    for (const auto& chunk : updated->chunks()) {
+        if (!lastMax.isEmpty()) {
+            ASSERT_BSONOBJ_EQ(lastMax, chunk->getMin());
+        }
+        lastMax = chunk->getMax();
+    }
+
+    const auto chunkFor = [&](const ChunkManager& cm, const BSONObj& shardKey) {
+        return cm.findIntersectingChunkWithSimpleCollation(shardKey);
+    };
+
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1000.5), chunkFor(*updated, BSON("a" << 1000.7))->getMin());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1000.5), chunkFor(*updated, BSON("a" << 1000.2))->getMax());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 3003), chunkFor(*updated, BSON("a" << 3001))->getMax());
+    ASSERT_EQ(chunkFor(*chunkManager, BSON("a" << 4500)).get(),
+              chunkFor(*updated, BSON("a" << 4500)).get());
+
+    std::set<ShardId> shardIds;
+    updated->getShardIdsForRange(BSON("a" << 10), BSON("a" << 2000), &shardIds);
+    ASSERT_EQ(1U, shardIds.size());
+    ASSERT_EQ(1U, shardIds.count(ShardId("0")));
+
+    shardIds.clear();
+    updated->getShardIdsForRange(BSON("a" << 2499), BSON("a" << 2500), &shardIds);
+    ASSERT_EQ(2U, shardIds.size());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -40,6 +40,9 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
+#include "mongo/db/pipeline/document_source_facet.h"
+#include "mongo/db/pipeline/document_source_lookup.h"
+#include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_out.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
@@ -47,6 +50,7 @@
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/find_common.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/views/resolved_view.h"
 #include "mongo/db/views/view.h"
 #include "mongo/executor/task_executor_pool.h"
@@ -649,6 +653,64 @@ BSONObj getDefaultCollationForUnshardedCollection(const Shard* primaryShard,
     return defaultCollation;
 }
 
+/**
+ * Returns true if 'path' is 'field', a prefix of it, or a path within it.
+ */
+bool pathsOverlap(const std::string& path, const std::string& field) {
+    return path == field || str::startsWith(field, path + ".") ||
+        str::startsWith(path, field + ".");
+}
+
+/**
+ * A co-located $lookup joins each shard's documents against that shard's own chunks of the foreign
+ * collection, which is only correct while the input documents are still on the shard which owns
+ * their 'shardKeyField' value. Asserts that every such $lookup is preceded only by stages which run
+ * on the shards without changing that field, and that none is nested within a $facet.
+ */
+void assertColocatedLookupsSeeOwnedDocuments(const Pipeline::SourceContainer& sources,
+                                             const std::string& shardKeyField,
+                                             bool nested) {
+    bool keyPreserved = true;
+
+    for (auto&& source : sources) {
+        if (auto facet = dynamic_cast<DocumentSourceFacet*>(source.get())) {
+            for (auto&& facetPipeline : facet->getFacetPipelines()) {
+                assertColocatedLookupsSeeOwnedDocuments(
+                    facetPipeline.pipeline->getSources(), shardKeyField, true);
+            }
+        }
+
+        auto lookup = dynamic_cast<DocumentSourceLookUp*>(source.get());
+        if (lookup && lookup->isColocated()) {
+            uassert(28769,
+                    "$lookup from a sharded collection must directly follow stages which run on "
+                    "the shards and preserve the shard key",
+                    !nested && keyPreserved);
+            continue;
+        }
+
+        if (dynamic_cast<DocumentSourceMatch*>(source.get())) {
+            continue;
+        }
+        if (dynamic_cast<SplittableDocumentSource*>(source.get())) {
+            keyPreserved = false;
+            continue;
+        }
+
+        const auto modifiedPaths = source->getModifiedPaths();
+        if (modifiedPaths.type != DocumentSource::GetModPathsReturn::Type::kFiniteSet ||
+            !modifiedPaths.renames.empty()) {
+            keyPreserved = false;
+            continue;
+        }
+        for (auto&& path : modifiedPaths.paths) {
+            if (pathsOverlap(path, shardKeyField)) {
+                keyPreserved = false;
+            }
+        }
+    }
+}
+
 }  // namespace
 
 Status ClusterAggregate::runAggregate(OperationContext* opCtx,
@@ -691,9 +753,21 @@ Status ClusterAggregate::runAggregate(OperationContext* opCtx,
     for (auto&& nss : liteParsedPipeline.getInvolvedNamespaces()) {
         const auto resolvedNsRoutingInfo =
             uassertStatusOK(catalogCache->getCollectionRoutingInfo(opCtx, nss));
-        uassert(
-            28769, str::stream() << nss.ns() << " cannot be sharded", !resolvedNsRoutingInfo.cm());
-        resolvedNamespaces.try_emplace(nss.coll(), nss, std::vector<BSONObj>{});
+        ExpressionContext::ResolvedNamespace resolvedNs(nss, std::vector<BSONObj>{});
+
+        // A sharded collection may be joined only where its chunks line up with those of the
+        // sharded collection being aggregated. The stage checks that it joins the two shard keys.
+        if (const auto foreignCm = resolvedNsRoutingInfo.cm()) {
+            const auto executionCm = executionNsRoutingInfo.cm();
+            uassert(28769,
+                    str::stream() << nss.ns() << " cannot be sharded",
+                    internalQueryAllowColocatedShardedLookup.load() && executionCm &&
+                        executionCm->isColocatedWith(*foreignCm));
+            resolvedNs.colocatedShardKeyFields.emplace(
+                executionCm->getShardKeyPattern().toBSON().firstElementFieldName(),
+                foreignCm->getShardKeyPattern().toBSON().firstElementFieldName());
+        }
+        resolvedNamespaces.try_emplace(nss.coll(), std::move(resolvedNs));
     }
 
     // If this pipeline is on an unsharded collection, is allowed to be forwarded to shards, does
@@ -738,6 +812,12 @@ Status ClusterAggregate::runAggregate(OperationContext* opCtx,
 
     auto pipeline = uassertStatusOK(Pipeline::parse(request.getPipeline(), mergeCtx));
     pipeline->optimizePipeline();
+    if (const auto executionCm = executionNsRoutingInfo.cm()) {
+        assertColocatedLookupsSeeOwnedDocuments(
+            pipeline->getSources(),
+            executionCm->getShardKeyPattern().toBSON().firstElementFieldName(),
+            false);
+    }
 
     // Check whether the entire pipeline must be run on mongoS.
     if (pipeline->requiredToRunOnMongos()) {
@@ -110,7 +110,7 @@ public:
         MONGO_UNREACHABLE;
     }
 
-    BSONObj insert(const NamespaceString& ns, const std::vector<BSONObj>& objs) final {
+    Status insert(const NamespaceString& ns, const std::vector<BSONObj>& objs) final {
         MONGO_UNREACHABLE;
     }
 
@@ -119,6 +119,17 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    BSONObj getColocatedCollectionVersion(const NamespaceString& localNs,
+                                          StringData localField,
+                                          const NamespaceString& foreignNs,
+                                          StringData foreignField) final {
+        MONGO_UNREACHABLE;
+    }
+
+    BSONObj getShardedCollectionVersion(const NamespaceString& ns) final {
+        MONGO_UNREACHABLE;
+    }
+
     void appendLatencyStats(const NamespaceString& nss,
                             bool includeHistograms,
                             BSONObjBuilder* builder) const final {
@@ -161,7 +172,9 @@ public:
 
     std::vector<BSONObj> getCurrentOps(CurrentOpConnectionsMode connMode,
                                        CurrentOpUserMode userMode,
-                                       CurrentOpTruncateMode truncateMode) const final {
+                                       CurrentOpTruncateMode truncateMode,
+                                       CurrentOpReportMode reportMode,
+                                       const MatchExpression* summaryFilter) const final {
         MONGO_UNREACHABLE;
     }
 
@@ -69,6 +69,7 @@
 #include "mongo/s/query/cluster_cursor_manager.h"
 #include "mongo/s/query/cluster_find.h"
 #include "mongo/s/stale_exception.h"
+#include "mongo/transport/reply_buffer_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/op_msg.h"
@@ -429,7 +430,8 @@ DbResponse Strategy::queryOp(OperationContext* opCtx, const NamespaceString& nss
 
 //ServiceEntryPointMongos::handleRequest->Strategy::clientCommandеִ
 DbResponse Strategy::clientCommand(OperationContext* opCtx, const Message& m) {
-    auto reply = rpc::makeReplyBuilder(rpc::protocolForMessage(m));
+    auto reply = rpc::makeReplyBuilder(rpc::protocolForMessage(m),
+                                       ReplyBufferPool::get(opCtx->getClient()).take());
 
     [&] {
         OpMsgRequest request;
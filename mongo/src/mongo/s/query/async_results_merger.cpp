@@ -42,6 +42,7 @@
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/query/cluster_query_knobs.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 
@@ -268,7 +269,7 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return hasSort ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_params->tailableMode != TailableMode::kTailable);
 
@@ -282,8 +283,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     invariant(!_remotes[smallestRemote].docBuffer.empty());
     invariant(_remotes[smallestRemote].status.isOK());
 
-    ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
-    _remotes[smallestRemote].docBuffer.pop();
+    ClusterQueryResult front = _popFront(lk, smallestRemote);
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
@@ -294,15 +294,14 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     return front;
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock lk) {
     size_t remotesAttempted = 0;
     while (remotesAttempted < _remotes.size()) {
         // It is illegal to call this method if there is an error received from any shard.
         invariant(_remotes[_gettingFromRemote].status.isOK());
 
         if (_remotes[_gettingFromRemote].hasNext()) {
-            ClusterQueryResult front = _remotes[_gettingFromRemote].docBuffer.front();
-            _remotes[_gettingFromRemote].docBuffer.pop();
+            ClusterQueryResult front = _popFront(lk, _gettingFromRemote);
 
             if (_params->tailableMode == TailableMode::kTailable &&
                 !_remotes[_gettingFromRemote].hasNext()) {
@@ -325,6 +324,26 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
     return {};
 }
 
+ClusterQueryResult AsyncResultsMerger::_popFront(WithLock lk, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    ClusterQueryResult front = remote.docBuffer.front();
+    remote.docBuffer.pop();
+    remote.bufferedBytes -= front.getResult()->objsize();
+
+    // Batches from tailable cursors are passed through to the client as they are, so only regular
+    // cursors prefetch.
+    const auto watermark = internalQueryAsyncResultsMergerPrefetchWatermark.load();
+    if (watermark > 0 && _params->tailableMode == TailableMode::kNormal &&
+        remote.docBuffer.size() < static_cast<size_t>(watermark) &&
+        remote.bufferedBytes < internalQueryAsyncResultsMergerMaxPrefetchBytesPerRemote.load() &&
+        !remote.exhausted() && !remote.cbHandle.isValid() && remote.status.isOK()) {
+        remote.status = _askForNextBatch(lk, remoteIndex);
+    }
+
+    return front;
+}
+
 Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
     auto& remote = _remotes[remoteIndex];
 
@@ -533,6 +552,7 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
         // Clear the results buffer and cursor id.
         std::queue<ClusterQueryResult> emptyBuffer;
         std::swap(remote.docBuffer, emptyBuffer);
+        remote.bufferedBytes = 0;
         remote.cursorId = 0;
     }
 }
@@ -582,6 +602,11 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                            const CursorResponse& response) {
     auto& remote = _remotes[remoteIndex];
     updateRemoteMetadata(&remote, response);
+
+    // A prefetched batch may arrive while results of the previous one are still buffered, in
+    // which case the remote is already on the merge queue.
+    const bool wasBuffering = remote.hasNext();
+
     for (const auto& obj : response.getBatch()) {
         // If there's a sort, we're expecting the remote node to have given us back a sort key.
         if (!_params->sort.isEmpty() &&
@@ -596,12 +621,13 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
 
         ClusterQueryResult result(obj);
         remote.docBuffer.push(result);
+        remote.bufferedBytes += obj.objsize();
         ++remote.fetchedCount;
     }
 
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the
     // merge queue.
-    if (!_params->sort.isEmpty() && !response.getBatch().empty()) {
+    if (!_params->sort.isEmpty() && !response.getBatch().empty() && !wasBuffering) {
         _mergeQueue.push(remoteIndex);
     }
     return true;
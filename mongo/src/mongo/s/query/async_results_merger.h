@@ -265,6 +265,9 @@ private:
         // Count of fetched docs during ARM processing of the current batch. Used to reduce the
         // batchSize in getMore when mongod returned less docs than the requested batchSize.
         long long fetchedCount = 0;
+
+        // Total size of the results in 'docBuffer'.
+        long long bufferedBytes = 0;
     };
 
     class MergingComparator {
@@ -321,6 +324,13 @@ private:
     ClusterQueryResult _nextReadySorted(WithLock);
     ClusterQueryResult _nextReadyUnsorted(WithLock);
 
+    /**
+     * Removes and returns the first buffered result of the remote at 'remoteIndex'. If prefetching
+     * is enabled and this leaves the remote's buffer below the prefetch watermark, schedules the
+     * request for its next batch right away.
+     */
+    ClusterQueryResult _popFront(WithLock, size_t remoteIndex);
+
     using CbData = executor::TaskExecutor::RemoteCommandCallbackArgs;
     using CbResponse = executor::TaskExecutor::ResponseStatus;
 
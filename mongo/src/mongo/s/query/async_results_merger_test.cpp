@@ -41,9 +41,11 @@
 #include "mongo/executor/thread_pool_task_executor_test_fixture.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/client/shard_registry.h"
+#include "mongo/s/query/cluster_query_knobs.h"
 #include "mongo/s/sharding_test_fixture.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -209,6 +211,14 @@ protected:
         net->exitNetwork();
     }
 
+    bool networkHasReadyRequests() {
+        executor::NetworkInterfaceMock* net = network();
+        net->enterNetwork();
+        const bool hasReadyRequests = net->hasReadyRequests();
+        net->exitNetwork();
+        return hasReadyRequests;
+    }
+
     void blackHoleNextRequest() {
         executor::NetworkInterfaceMock* net = network();
         net->enterNetwork();
@@ -682,6 +692,99 @@ TEST_F(AsyncResultsMergerTest, HasFirstBatch) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, SortedMergePrefetchesNextBatchBelowWatermark) {
+    internalQueryAsyncResultsMergerPrefetchWatermark.store(2);
+    ON_BLOCK_EXIT([] { internalQueryAsyncResultsMergerPrefetchWatermark.store(0); });
+
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
+    std::vector<BSONObj> firstBatch1 = {fromjson("{$sortKey: {'': 1}}"),
+                                        fromjson("{$sortKey: {'': 2}}"),
+                                        fromjson("{$sortKey: {'': 3}}")};
+    std::vector<BSONObj> firstBatch2 = {fromjson("{$sortKey: {'': 4}}")};
+    std::vector<ClusterClientCursorParams::RemoteCursor> cursors;
+    cursors.emplace_back(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(_nss, 5, std::move(firstBatch1)));
+    cursors.emplace_back(
+        kTestShardIds[1], kTestShardHosts[1], CursorResponse(_nss, 6, std::move(firstBatch2)));
+    makeCursorFromExistingCursors(std::move(cursors), findCmd);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 1}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    // Only one result of the first shard remains buffered, which is below the watermark, so the
+    // ARM asks that shard for its next batch without waiting for the buffer to run dry.
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 2}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_EQ(kTestShardHosts[0], getFirstPendingRequest().target);
+
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch1 = {fromjson("{$sortKey: {'': 5}}")};
+    responses.emplace_back(_nss, CursorId(0), batch1);
+    scheduleNetworkResponses(std::move(responses),
+                             CursorResponse::ResponseType::SubsequentResponse);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 3}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 4}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+
+    // The second shard's buffer is now empty and its prefetch is outstanding.
+    ASSERT_FALSE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    ASSERT_EQ(kTestShardHosts[1], getFirstPendingRequest().target);
+
+    responses.clear();
+    responses.emplace_back(_nss, CursorId(0), std::vector<BSONObj>{});
+    scheduleNetworkResponses(std::move(responses),
+                             CursorResponse::ResponseType::SubsequentResponse);
+
+    executor()->waitForEvent(readyEvent);
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 5}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
+TEST_F(AsyncResultsMergerTest, NoPrefetchBeyondMaxBufferedBytesPerRemote) {
+    internalQueryAsyncResultsMergerPrefetchWatermark.store(10);
+    internalQueryAsyncResultsMergerMaxPrefetchBytesPerRemote.store(1);
+    ON_BLOCK_EXIT([] {
+        internalQueryAsyncResultsMergerPrefetchWatermark.store(0);
+        internalQueryAsyncResultsMergerMaxPrefetchBytesPerRemote.store(16 * 1024 * 1024);
+    });
+
+    std::vector<BSONObj> firstBatch = {fromjson("{_id: 1}"), fromjson("{_id: 2}")};
+    std::vector<ClusterClientCursorParams::RemoteCursor> cursors;
+    cursors.emplace_back(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(_nss, 5, std::move(firstBatch)));
+    makeCursorFromExistingCursors(std::move(cursors));
+
+    // One result remains buffered, which exceeds the memory cap, so there is no prefetch.
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    // Once the buffer is empty, the next batch is prefetched.
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(networkHasReadyRequests());
+
+    ASSERT_FALSE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+
+    std::vector<CursorResponse> responses;
+    responses.emplace_back(_nss, CursorId(0), std::vector<BSONObj>{});
+    scheduleNetworkResponses(std::move(responses),
+                             CursorResponse::ResponseType::SubsequentResponse);
+
+    executor()->waitForEvent(readyEvent);
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
 TEST_F(AsyncResultsMergerTest, OneShardHasInitialBatchOtherShardExhausted) {
     std::vector<BSONObj> firstBatch = {
         fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}")};
@@ -37,6 +37,7 @@
 
 #include "mongo/db/kill_sessions_common.h"
 #include "mongo/db/logical_session_cache.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/clock_source.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -196,22 +197,25 @@ void ClusterCursorManager::PinnedCursor::returnAndKillCursor() {
     returnCursor(CursorState::NotExhausted);
 }
 
-ClusterCursorManager::ClusterCursorManager(ClockSource* clockSource)
-    : _clockSource(clockSource),
-      _pseudoRandom(std::unique_ptr<SecureRandom>(SecureRandom::create())->nextInt64()) {
+ClusterCursorManager::ClusterCursorManager(ClockSource* clockSource) : _clockSource(clockSource) {
     invariant(_clockSource);
+    std::unique_ptr<SecureRandom> secureRandom(SecureRandom::create());
+    for (size_t i = 0; i < kNumShards; ++i) {
+        _shards.push_back(stdx::make_unique<CursorShard>(secureRandom->nextInt64()));
+    }
 }
 
 ClusterCursorManager::~ClusterCursorManager() {
-    invariant(_cursorIdPrefixToNamespaceMap.empty());
-    invariant(_namespaceToContainerMap.empty());
+    for (auto&& shard : _shards) {
+        invariant(shard->cursorIdPrefixToNamespaceMap.empty());
+        invariant(shard->namespaceToContainerMap.empty());
+    }
 }
 
 void ClusterCursorManager::shutdown(OperationContext* opCtx) {
-    {
-        stdx::lock_guard<stdx::mutex> lk(_mutex);
-        _inShutdown = true;
-    }
+    // Every shard is locked and visited by killAllCursors() after the flag is set, so a cursor
+    // registered concurrently with shutdown is either refused or marked as kill pending.
+    _inShutdown.store(true);
     killAllCursors();
     reapZombieCursors(opCtx);
 }
@@ -225,9 +229,11 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
     // Read the clock out of the lock.
     const auto now = _clockSource->now();
 
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    const size_t shardIndex = _getShardIndex(nss);
+    CursorShard& shard = *_shards[shardIndex];
+    stdx::unique_lock<stdx::mutex> lk(shard.mutex);
 
-    if (_inShutdown) {
+    if (_inShutdown.load()) {
         lk.unlock();
         cursor->kill(opCtx);
         return Status(ErrorCodes::ShutdownInProgress,
@@ -237,21 +243,24 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
     invariant(cursor);
 
     // Find the CursorEntryContainer for this namespace.  If none exists, create one.
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    if (nsToContainerIt == _namespaceToContainerMap.end()) {
+    auto nsToContainerIt = shard.namespaceToContainerMap.find(nss);
+    if (nsToContainerIt == shard.namespaceToContainerMap.end()) {
         uint32_t containerPrefix = 0;
         do {
             // The server has always generated positive values for CursorId (which is a signed
             // type), so we use std::abs() here on the prefix for consistency with this historical
-            // behavior.
-            containerPrefix = static_cast<uint32_t>(std::abs(_pseudoRandom.nextInt32()));
-        } while (_cursorIdPrefixToNamespaceMap.count(containerPrefix) > 0);
-        _cursorIdPrefixToNamespaceMap[containerPrefix] = nss;
+            // behavior. The prefix is then rounded to the shard's residue class, which keeps it
+            // unique across shards and non-negative as 2^31 is a multiple of kNumShards.
+            containerPrefix = static_cast<uint32_t>(std::abs(shard.pseudoRandom.nextInt32()));
+            containerPrefix = containerPrefix - (containerPrefix % kNumShards) + shardIndex;
+        } while (shard.cursorIdPrefixToNamespaceMap.count(containerPrefix) > 0);
+        shard.cursorIdPrefixToNamespaceMap[containerPrefix] = nss;
 
         auto emplaceResult =
-            _namespaceToContainerMap.emplace(nss, CursorEntryContainer(containerPrefix));
+            shard.namespaceToContainerMap.emplace(nss, CursorEntryContainer(containerPrefix));
         invariant(emplaceResult.second);
-        invariant(_namespaceToContainerMap.size() == _cursorIdPrefixToNamespaceMap.size());
+        invariant(shard.namespaceToContainerMap.size() ==
+                  shard.cursorIdPrefixToNamespaceMap.size());
 
         nsToContainerIt = emplaceResult.first;
     } else {
@@ -263,7 +272,7 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
     CursorEntryMap& entryMap = container.entryMap;
     CursorId cursorId = 0;
     do {
-        const uint32_t cursorSuffix = static_cast<uint32_t>(_pseudoRandom.nextInt32());
+        const uint32_t cursorSuffix = static_cast<uint32_t>(shard.pseudoRandom.nextInt32());
         cursorId = createCursorId(container.containerPrefix, cursorSuffix);
     } while (cursorId == 0 || entryMap.count(cursorId) > 0);
 
@@ -277,14 +286,15 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
 
 StatusWith<ClusterCursorManager::PinnedCursor> ClusterCursorManager::checkOutCursor(
     const NamespaceString& nss, CursorId cursorId, OperationContext* opCtx) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    CursorShard& shard = _getShard(nss);
+    stdx::lock_guard<stdx::mutex> lk(shard.mutex);
 
-    if (_inShutdown) {
+    if (_inShutdown.load()) {
         return Status(ErrorCodes::ShutdownInProgress,
                       "Cannot check out cursor as we are in the process of shutting down");
     }
 
-    CursorEntry* entry = _getEntry(lk, nss, cursorId);
+    CursorEntry* entry = _getEntry(lk, shard, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
@@ -323,13 +333,14 @@ void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cu
     // Read the clock out of the lock.
     const auto now = _clockSource->now();
 
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    CursorShard& shard = _getShard(nss);
+    stdx::unique_lock<stdx::mutex> lk(shard.mutex);
 
     invariant(cursor);
 
     const bool remotesExhausted = cursor->remotesExhausted();
 
-    CursorEntry* entry = _getEntry(lk, nss, cursorId);
+    CursorEntry* entry = _getEntry(lk, shard, nss, cursorId);
     invariant(entry);
 
     entry->setLastActive(now);
@@ -348,7 +359,7 @@ void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cu
 
     // The cursor is exhausted, is not already scheduled for deletion, and does not have any
     // remote cursor state left to clean up. We can delete the cursor right away.
-    auto detachedCursor = _detachCursor(lk, nss, cursorId);
+    auto detachedCursor = _detachCursor(lk, shard, nss, cursorId);
     invariantOK(detachedCursor.getStatus());
 
     // Deletion of the cursor can happen out of the lock.
@@ -357,9 +368,10 @@ void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cu
 }
 
 Status ClusterCursorManager::killCursor(const NamespaceString& nss, CursorId cursorId) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    CursorShard& shard = _getShard(nss);
+    stdx::lock_guard<stdx::mutex> lk(shard.mutex);
 
-    CursorEntry* entry = _getEntry(lk, nss, cursorId);
+    CursorEntry* entry = _getEntry(lk, shard, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
@@ -370,28 +382,32 @@ Status ClusterCursorManager::killCursor(const NamespaceString& nss, CursorId cur
 }
 
 void ClusterCursorManager::killMortalCursorsInactiveSince(Date_t cutoff) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            CursorEntry& entry = cursorIdEntryPair.second;
-            if (entry.getLifetimeType() == CursorLifetime::Mortal && entry.isCursorOwned() &&
-                entry.getLastActive() <= cutoff) {
-                entry.setInactive();
-                log() << "Marking cursor id " << cursorIdEntryPair.first
-                      << " for deletion, idle since " << entry.getLastActive().toString();
-                entry.setKillPending();
+
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lk(shard->mutex);
+        for (auto& nsContainerPair : shard->namespaceToContainerMap) {
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                CursorEntry& entry = cursorIdEntryPair.second;
+                if (entry.getLifetimeType() == CursorLifetime::Mortal && entry.isCursorOwned() &&
+                    entry.getLastActive() <= cutoff) {
+                    entry.setInactive();
+                    log() << "Marking cursor id " << cursorIdEntryPair.first
+                          << " for deletion, idle since " << entry.getLastActive().toString();
+                    entry.setKillPending();
+                }
             }
         }
     }
 }
 
 void ClusterCursorManager::killAllCursors() {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
 
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            cursorIdEntryPair.second.setKillPending();
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lk(shard->mutex);
+        for (auto& nsContainerPair : shard->namespaceToContainerMap) {
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                cursorIdEntryPair.second.setKillPending();
+            }
         }
     }
 }
@@ -406,74 +422,79 @@ std::size_t ClusterCursorManager::reapZombieCursors(OperationContext* opCtx) {
         bool isInactive;
     };
 
-    // List all zombie cursors under the manager lock, and kill them one-by-one while not holding
-    // the lock (ClusterClientCursor::kill() is blocking, so we don't want to hold a lock while
-    // issuing the kill).
-
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-    std::vector<CursorDescriptor> zombieCursorDescriptors;
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        const NamespaceString& nss = nsContainerPair.first;
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            CursorId cursorId = cursorIdEntryPair.first;
-            const CursorEntry& entry = cursorIdEntryPair.second;
-            if (!entry.getKillPending()) {
-                continue;
-            }
-            zombieCursorDescriptors.emplace_back(nss, cursorId, entry.isInactive());
-        }
-    }
+    // List all zombie cursors in each shard under the shard's lock, and kill them one-by-one while
+    // not holding the lock (ClusterClientCursor::kill() is blocking, so we don't want to hold a
+    // lock while issuing the kill).
 
     std::size_t cursorsTimedOut = 0;
 
-    for (auto& cursorDescriptor : zombieCursorDescriptors) {
-        StatusWith<std::unique_ptr<ClusterClientCursor>> zombieCursor =
-            _detachCursor(lk, cursorDescriptor.ns, cursorDescriptor.cursorId);
-        if (!zombieCursor.isOK()) {
-            // Cursor in use, or has already been deleted.
-            continue;
+    for (auto&& shard : _shards) {
+        stdx::unique_lock<stdx::mutex> lk(shard->mutex);
+        std::vector<CursorDescriptor> zombieCursorDescriptors;
+        for (auto& nsContainerPair : shard->namespaceToContainerMap) {
+            const NamespaceString& nss = nsContainerPair.first;
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                CursorId cursorId = cursorIdEntryPair.first;
+                const CursorEntry& entry = cursorIdEntryPair.second;
+                if (!entry.getKillPending()) {
+                    continue;
+                }
+                zombieCursorDescriptors.emplace_back(nss, cursorId, entry.isInactive());
+            }
         }
 
-        lk.unlock();
-        // Pass opCtx to kill(), since a cursor which wraps an underlying aggregation pipeline is
-        // obliged to call Pipeline::dispose with a valid OperationContext prior to deletion.
-        zombieCursor.getValue()->kill(opCtx);
-        zombieCursor.getValue().reset();
-        lk.lock();
-
-        if (cursorDescriptor.isInactive) {
-            ++cursorsTimedOut;
+        for (auto& cursorDescriptor : zombieCursorDescriptors) {
+            StatusWith<std::unique_ptr<ClusterClientCursor>> zombieCursor =
+                _detachCursor(lk, *shard, cursorDescriptor.ns, cursorDescriptor.cursorId);
+            if (!zombieCursor.isOK()) {
+                // Cursor in use, or has already been deleted.
+                continue;
+            }
+
+            lk.unlock();
+            // Pass opCtx to kill(), since a cursor which wraps an underlying aggregation pipeline
+            // is obliged to call Pipeline::dispose with a valid OperationContext prior to
+            // deletion.
+            zombieCursor.getValue()->kill(opCtx);
+            zombieCursor.getValue().reset();
+            lk.lock();
+
+            if (cursorDescriptor.isInactive) {
+                ++cursorsTimedOut;
+            }
         }
     }
     return cursorsTimedOut;
 }
 
 ClusterCursorManager::Stats ClusterCursorManager::stats() const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
 
     Stats stats;
 
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            const CursorEntry& entry = cursorIdEntryPair.second;
-
-            if (entry.getKillPending()) {
-                // Killed cursors do not count towards the number of pinned cursors or the number of
-                // open cursors.
-                continue;
-            }
-
-            if (!entry.isCursorOwned()) {
-                ++stats.cursorsPinned;
-            }
-
-            switch (entry.getCursorType()) {
-                case CursorType::SingleTarget:
-                    ++stats.cursorsSingleTarget;
-                    break;
-                case CursorType::MultiTarget:
-                    ++stats.cursorsMultiTarget;
-                    break;
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lk(shard->mutex);
+        for (auto& nsContainerPair : shard->namespaceToContainerMap) {
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                const CursorEntry& entry = cursorIdEntryPair.second;
+
+                if (entry.getKillPending()) {
+                    // Killed cursors do not count towards the number of pinned cursors or the
+                    // number of open cursors.
+                    continue;
+                }
+
+                if (!entry.isCursorOwned()) {
+                    ++stats.cursorsPinned;
+                }
+
+                switch (entry.getCursorType()) {
+                    case CursorType::SingleTarget:
+                        ++stats.cursorsSingleTarget;
+                        break;
+                    case CursorType::MultiTarget:
+                        ++stats.cursorsMultiTarget;
+                        break;
+                }
             }
         }
     }
@@ -482,20 +503,22 @@ ClusterCursorManager::Stats ClusterCursorManager::stats() const {
 }
 
 void ClusterCursorManager::appendActiveSessions(LogicalSessionIdSet* lsids) const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
-    for (const auto& nsContainerPair : _namespaceToContainerMap) {
-        for (const auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            const CursorEntry& entry = cursorIdEntryPair.second;
-
-            if (entry.getKillPending()) {
-                // Don't include sessions for killed cursors.
-                continue;
-            }
 
-            auto lsid = entry.getLsid();
-            if (lsid) {
-                lsids->insert(*lsid);
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lk(shard->mutex);
+        for (const auto& nsContainerPair : shard->namespaceToContainerMap) {
+            for (const auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                const CursorEntry& entry = cursorIdEntryPair.second;
+
+                if (entry.getKillPending()) {
+                    // Don't include sessions for killed cursors.
+                    continue;
+                }
+
+                auto lsid = entry.getLsid();
+                if (lsid) {
+                    lsids->insert(*lsid);
+                }
             }
         }
     }
@@ -504,22 +527,24 @@ void ClusterCursorManager::appendActiveSessions(LogicalSessionIdSet* lsids) cons
 std::vector<GenericCursor> ClusterCursorManager::getAllCursors() const {
     std::vector<GenericCursor> cursors;
 
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
 
-    for (const auto& nsContainerPair : _namespaceToContainerMap) {
-        for (const auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            const CursorEntry& entry = cursorIdEntryPair.second;
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lk(shard->mutex);
+        for (const auto& nsContainerPair : shard->namespaceToContainerMap) {
+            for (const auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                const CursorEntry& entry = cursorIdEntryPair.second;
 
-            if (entry.getKillPending()) {
-                // Don't include sessions for killed cursors.
-                continue;
-            }
+                if (entry.getKillPending()) {
+                    // Don't include sessions for killed cursors.
+                    continue;
+                }
 
-            cursors.emplace_back();
-            auto& gc = cursors.back();
-            gc.setId(cursorIdEntryPair.first);
-            gc.setNs(nsContainerPair.first);
-            gc.setLsid(entry.getLsid());
+                cursors.emplace_back();
+                auto& gc = cursors.back();
+                gc.setId(cursorIdEntryPair.first);
+                gc.setNs(nsContainerPair.first);
+                gc.setLsid(entry.getLsid());
+            }
         }
     }
 
@@ -539,22 +564,24 @@ std::pair<Status, int> ClusterCursorManager::killCursorsWithMatchingSessions(
 
 stdx::unordered_set<CursorId> ClusterCursorManager::getCursorsForSession(
     LogicalSessionId lsid) const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
 
     stdx::unordered_set<CursorId> cursorIds;
 
-    for (auto&& nsContainerPair : _namespaceToContainerMap) {
-        for (auto&& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            const CursorEntry& entry = cursorIdEntryPair.second;
-
-            if (entry.getKillPending()) {
-                // Don't include sessions for killed cursors.
-                continue;
-            }
-
-            auto cursorLsid = entry.getLsid();
-            if (lsid == cursorLsid) {
-                cursorIds.insert(cursorIdEntryPair.first);
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lk(shard->mutex);
+        for (auto&& nsContainerPair : shard->namespaceToContainerMap) {
+            for (auto&& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                const CursorEntry& entry = cursorIdEntryPair.second;
+
+                if (entry.getKillPending()) {
+                    // Don't include sessions for killed cursors.
+                    continue;
+                }
+
+                auto cursorLsid = entry.getLsid();
+                if (lsid == cursorLsid) {
+                    cursorIds.insert(cursorIdEntryPair.first);
+                }
             }
         }
     }
@@ -564,20 +591,23 @@ stdx::unordered_set<CursorId> ClusterCursorManager::getCursorsForSession(
 
 boost::optional<NamespaceString> ClusterCursorManager::getNamespaceForCursorId(
     CursorId cursorId) const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    CursorShard& shard = _getShardForCursorId(cursorId);
+    stdx::lock_guard<stdx::mutex> lk(shard.mutex);
 
-    const auto it = _cursorIdPrefixToNamespaceMap.find(extractPrefixFromCursorId(cursorId));
-    if (it == _cursorIdPrefixToNamespaceMap.end()) {
+    const auto it = shard.cursorIdPrefixToNamespaceMap.find(extractPrefixFromCursorId(cursorId));
+    if (it == shard.cursorIdPrefixToNamespaceMap.end()) {
         return boost::none;
     }
     return it->second;
 }
 
-auto ClusterCursorManager::_getEntry(WithLock, NamespaceString const& nss, CursorId cursorId)
-    -> CursorEntry* {
+auto ClusterCursorManager::_getEntry(WithLock,
+                                     CursorShard& shard,
+                                     NamespaceString const& nss,
+                                     CursorId cursorId) -> CursorEntry* {
 
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    if (nsToContainerIt == _namespaceToContainerMap.end()) {
+    auto nsToContainerIt = shard.namespaceToContainerMap.find(nss);
+    if (nsToContainerIt == shard.namespaceToContainerMap.end()) {
         return nullptr;
     }
     CursorEntryMap& entryMap = nsToContainerIt->second.entryMap;
@@ -590,9 +620,9 @@ auto ClusterCursorManager::_getEntry(WithLock, NamespaceString const& nss, Curso
 }
 
 StatusWith<std::unique_ptr<ClusterClientCursor>> ClusterCursorManager::_detachCursor(
-    WithLock lk, NamespaceString const& nss, CursorId cursorId) {
+    WithLock lk, CursorShard& shard, NamespaceString const& nss, CursorId cursorId) {
 
-    CursorEntry* entry = _getEntry(lk, nss, cursorId);
+    CursorEntry* entry = _getEntry(lk, shard, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
@@ -602,8 +632,8 @@ StatusWith<std::unique_ptr<ClusterClientCursor>> ClusterCursorManager::_detachCu
         return cursorInUseStatus(nss, cursorId);
     }
 
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    invariant(nsToContainerIt != _namespaceToContainerMap.end());
+    auto nsToContainerIt = shard.namespaceToContainerMap.find(nss);
+    invariant(nsToContainerIt != shard.namespaceToContainerMap.end());
     CursorEntryMap& entryMap = nsToContainerIt->second.entryMap;
     size_t eraseResult = entryMap.erase(cursorId);
     invariant(1 == eraseResult);
@@ -611,13 +641,26 @@ StatusWith<std::unique_ptr<ClusterClientCursor>> ClusterCursorManager::_detachCu
         // This was the last cursor remaining in the given namespace.  Erase all state associated
         // with this namespace.
         size_t numDeleted =
-            _cursorIdPrefixToNamespaceMap.erase(nsToContainerIt->second.containerPrefix);
+            shard.cursorIdPrefixToNamespaceMap.erase(nsToContainerIt->second.containerPrefix);
         invariant(numDeleted == 1);
-        _namespaceToContainerMap.erase(nsToContainerIt);
-        invariant(_namespaceToContainerMap.size() == _cursorIdPrefixToNamespaceMap.size());
+        shard.namespaceToContainerMap.erase(nsToContainerIt);
+        invariant(shard.namespaceToContainerMap.size() ==
+                  shard.cursorIdPrefixToNamespaceMap.size());
     }
 
     return std::move(cursor);
 }
 
+size_t ClusterCursorManager::_getShardIndex(const NamespaceString& nss) const {
+    return NamespaceString::Hasher()(nss) % kNumShards;
+}
+
+auto ClusterCursorManager::_getShard(const NamespaceString& nss) const -> CursorShard& {
+    return *_shards[_getShardIndex(nss)];
+}
+
+auto ClusterCursorManager::_getShardForCursorId(CursorId cursorId) const -> CursorShard& {
+    return *_shards[extractPrefixFromCursorId(cursorId) % kNumShards];
+}
+
 }  // namespace mongo
@@ -37,6 +37,7 @@
 #include "mongo/db/kill_sessions.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/session_killer.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/random.h"
 #include "mongo/s/query/cluster_client_cursor.h"
 #include "mongo/stdx/mutex.h"
@@ -427,13 +428,19 @@ private:
                        CursorId cursorId,
                        CursorState cursorState);
 
+    struct CursorShard;
+
     /**
      * Returns a pointer to the CursorEntry for the given cursor.  If the given cursor is not
      * registered, returns null.
      *
-     * Not thread-safe.
+     * Not thread-safe.  The caller must hold the mutex of 'shard', which must be the shard that
+     * owns 'nss'.
      */
-    CursorEntry* _getEntry(WithLock, NamespaceString const& nss, CursorId cursorId);
+    CursorEntry* _getEntry(WithLock,
+                           CursorShard& shard,
+                           NamespaceString const& nss,
+                           CursorId cursorId);
 
     /**
      * De-registers the given cursor, and returns an owned pointer to the underlying
@@ -445,6 +452,7 @@ private:
      * Not thread-safe.
      */
     StatusWith<std::unique_ptr<ClusterClientCursor>> _detachCursor(WithLock,
+                                                                   CursorShard& shard,
                                                                    NamespaceString const& nss,
                                                                    CursorId cursorId);
 
@@ -562,32 +570,55 @@ private:
     // concurrently accessed by multiple threads.
     ClockSource* _clockSource;
 
-    // Synchronizes access to all private state variables below.
-    mutable stdx::mutex _mutex;
+    /**
+     * The cursors are split into independently locked shards, selected by a hash of the cursor's
+     * namespace, so that getMores against different namespaces do not serialize on a single
+     * mutex. Operations which visit every cursor lock one shard at a time.
+     *
+     * The cursor id prefix assigned to a namespace is always congruent to the index of the
+     * namespace's shard modulo kNumShards, which lets getNamespaceForCursorId() find the owning
+     * shard from the cursor id alone.
+     */
+    struct CursorShard {
+        explicit CursorShard(int64_t seed) : pseudoRandom(seed) {}
+
+        // Synchronizes access to all state below.
+        stdx::mutex mutex;
+
+        // Randomness source.  Used for cursor id generation.
+        PseudoRandom pseudoRandom;
+
+        // Map from cursor id prefix to associated namespace.  Exists only to provide namespace
+        // lookup for (deprecated) getNamespaceForCursorId() method.
+        //
+        // A CursorId is a 64-bit type, made up of a 32-bit prefix and a 32-bit suffix.  When the
+        // first cursor on a given namespace is registered, it is given a CursorId with a prefix
+        // that is unique to that namespace, and an arbitrary suffix.  Cursors subsequently
+        // registered on that namespace will all share the same prefix.
+        //
+        // Entries are added when the first cursor on the given namespace is registered, and
+        // removed when the last cursor on the given namespace is destroyed.
+        stdx::unordered_map<uint32_t, NamespaceString> cursorIdPrefixToNamespaceMap;
+
+        // Map from namespace to the CursorEntryContainer for that namespace.
+        //
+        // Entries are added when the first cursor on the given namespace is registered, and
+        // removed when the last cursor on the given namespace is destroyed.
+        stdx::unordered_map<NamespaceString, CursorEntryContainer, NamespaceString::Hasher>
+            namespaceToContainerMap;
+    };
 
-    bool _inShutdown{false};
+    static const size_t kNumShards = 8;
 
-    // Randomness source.  Used for cursor id generation.
-    PseudoRandom _pseudoRandom;
+    size_t _getShardIndex(const NamespaceString& nss) const;
 
-    // Map from cursor id prefix to associated namespace.  Exists only to provide namespace lookup
-    // for (deprecated) getNamespaceForCursorId() method.
-    //
-    // A CursorId is a 64-bit type, made up of a 32-bit prefix and a 32-bit suffix.  When the first
-    // cursor on a given namespace is registered, it is given a CursorId with a prefix that is
-    // unique to that namespace, and an arbitrary suffix.  Cursors subsequently registered on that
-    // namespace will all share the same prefix.
-    //
-    // Entries are added when the first cursor on the given namespace is registered, and removed
-    // when the last cursor on the given namespace is destroyed.
-    stdx::unordered_map<uint32_t, NamespaceString> _cursorIdPrefixToNamespaceMap;
+    CursorShard& _getShard(const NamespaceString& nss) const;
 
-    // Map from namespace to the CursorEntryContainer for that namespace.
-    //
-    // Entries are added when the first cursor on the given namespace is registered, and removed
-    // when the last cursor on the given namespace is destroyed.
-    stdx::unordered_map<NamespaceString, CursorEntryContainer, NamespaceString::Hasher>
-        _namespaceToContainerMap;
+    CursorShard& _getShardForCursorId(CursorId cursorId) const;
+
+    AtomicBool _inShutdown{false};
+
+    std::vector<std::unique_ptr<CursorShard>> _shards;
 
     size_t _cursorsTimedOut = 0;
 };
@@ -30,6 +30,7 @@
 
 #include "mongo/s/query/cluster_cursor_manager.h"
 
+#include <set>
 #include <vector>
 
 #include "mongo/db/logical_session_cache.h"
@@ -770,6 +771,34 @@ TEST_F(ClusterCursorManagerTest, GetNamespaceForCursorIdMultipleCursorsDifferent
     }
 }
 
+// Test that cursors registered on many namespaces, which are spread across the manager's
+// independently locked shards, get positive ids with a distinct prefix per namespace, and are all
+// visited by operations which scan every cursor.
+TEST_F(ClusterCursorManagerTest, CursorsOnManyNamespacesHaveDistinctPrefixes) {
+    const size_t numNamespaces = 100;
+    std::set<uint64_t> prefixes;
+    for (size_t i = 0; i < numNamespaces; ++i) {
+        NamespaceString cursorNamespace(std::string(str::stream() << "test.collection" << i));
+        auto cursorId =
+            assertGet(getManager()->registerCursor(nullptr,
+                                                   allocateMockCursor(),
+                                                   cursorNamespace,
+                                                   ClusterCursorManager::CursorType::SingleTarget,
+                                                   ClusterCursorManager::CursorLifetime::Mortal));
+        ASSERT_GT(cursorId, 0);
+        prefixes.insert(static_cast<uint64_t>(cursorId) >> 32);
+    }
+    ASSERT_EQ(numNamespaces, prefixes.size());
+    ASSERT_EQ(numNamespaces, getManager()->stats().cursorsSingleTarget);
+
+    getManager()->killAllCursors();
+    ASSERT_EQ(0U, getManager()->stats().cursorsSingleTarget);
+    getManager()->reapZombieCursors(nullptr);
+    for (size_t i = 0; i < numNamespaces; ++i) {
+        ASSERT_TRUE(isMockCursorKilled(i));
+    }
+}
+
 // Test that getting the namespace for an unknown cursor returns boost::none.
 TEST_F(ClusterCursorManagerTest, GetNamespaceForCursorIdUnknown) {
     boost::optional<NamespaceString> cursorNamespace = getManager()->getNamespaceForCursorId(5);
@@ -37,4 +37,10 @@ namespace mongo {
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryAlwaysMergeOnPrimaryShard, bool, false);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryProhibitMergingOnMongoS, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryAsyncResultsMergerPrefetchWatermark, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryAsyncResultsMergerMaxPrefetchBytesPerRemote,
+                              int,
+                              16 * 1024 * 1024);
+
 }  // namespace mongo
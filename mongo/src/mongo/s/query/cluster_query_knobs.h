@@ -45,4 +45,14 @@ extern AtomicBool internalQueryAlwaysMergeOnPrimaryShard;
 // of merging on mongoS will always do so.
 extern AtomicBool internalQueryProhibitMergingOnMongoS;
 
+// If positive, the AsyncResultsMerger on mongos asks a remote for its next batch as soon as fewer
+// than this many of the remote's results remain buffered, rather than only once the buffer is
+// empty, so that the round trip to the shard overlaps with merging the buffered results. Zero, the
+// default, disables prefetching.
+extern AtomicInt32 internalQueryAsyncResultsMergerPrefetchWatermark;
+
+// The AsyncResultsMerger does not prefetch from a remote which already has at least this many
+// bytes of results buffered, which caps the memory a mongos cursor holds for each remote.
+extern AtomicInt32 internalQueryAsyncResultsMergerMaxPrefetchBytesPerRemote;
+
 }  // namespace mongo
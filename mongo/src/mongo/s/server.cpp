@@ -443,6 +443,11 @@ static ExitCode runMongosServer() {
     runner->startup().transitional_ignore();
     getGlobalServiceContext()->setPeriodicRunner(std::move(runner));
 
+    // Enforce operation deadlines from the periodic runner, at the fast clock's granularity, so
+    // that interrupt checks do not have to read the clock.
+    getGlobalServiceContext()->startOperationDeadlineMonitor(
+        getGlobalServiceContext()->getFastClockSource()->getPrecision());
+
     SessionKiller::set(
         getGlobalServiceContext(),
         std::make_shared<SessionKiller>(getGlobalServiceContext(), killSessionsRemote));
@@ -33,7 +33,6 @@
 #include "mongo/s/write_ops/batch_write_exec.h"
 
 #include "mongo/base/error_codes.h"
-#include "mongo/base/owned_pointer_map.h"
 #include "mongo/base/status.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/connection_string.h"
@@ -45,20 +44,13 @@
 #include "mongo/s/write_ops/batch_write_op.h"
 #include "mongo/s/write_ops/write_error_detail.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
 
 const ReadPreferenceSetting kPrimaryOnlyReadPreference(ReadPreference::PrimaryOnly);
 
-//
-// Map which allows associating ConnectionString hosts with TargetedWriteBatches
-// This is needed since the dispatcher only returns hosts with responses.
-//
-
-// TODO: Unordered map?
-typedef OwnedPointerMap<ShardId, TargetedWriteBatch> OwnedShardBatchMap;
-
 WriteErrorDetail errorFromStatus(const Status& status) {
     WriteErrorDetail error;
     error.setErrCode(status.code());
@@ -127,15 +119,24 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
         //    exactly when the metadata changed.
         //
 
-        OwnedPointerMap<ShardId, TargetedWriteBatch> childBatchesOwned;
-        std::map<ShardId, TargetedWriteBatch*>& childBatches = childBatchesOwned.mutableMap();
+        // The batches targeted for each shard, in the order they are to be sent. Any left unsent
+        // when the round ends are deleted here.
+        std::map<ShardId, std::deque<TargetedWriteBatch*>> childBatches;
+        ON_BLOCK_EXIT([&] {
+            for (auto& shardBatches : childBatches) {
+                for (TargetedWriteBatch* batch : shardBatches.second) {
+                    delete batch;
+                }
+            }
+        });
 
         // If we've already had a targeting error, we've refreshed the metadata once and can
         // record target errors definitively.
         bool recordTargetErrors = refreshedTargeter;
-		//BatchWriteOp::targetBatch ȡBatchWriteOpӦchildBatches
+		//BatchWriteOp::targetBatchPerShard ȡBatchWriteOpӦchildBatches
 		//ҲȷBatchWriteOpӦĵӦ÷͵ЩmongodƬ(·ɼ¼childBatches)
-        Status targetStatus = batchOp.targetBatch(targeter, recordTargetErrors, &childBatches);
+        Status targetStatus =
+            batchOp.targetBatchPerShard(targeter, recordTargetErrors, &childBatches);
         if (!targetStatus.isOK()) {
             // Don't do anything until a targeter refresh
             targeter.noteCouldNotTarget();
@@ -147,71 +148,63 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
         //
         // Send all child batches
         //
+        // Each shard has at most one batch out on the network at a time. As soon as a shard
+        // responds it is sent its next batch, so that a slow shard does not hold back the others
+        // until the end of the round.
+        //
 
-        size_t numSent = 0;
-        size_t numToSend = childBatches.size();
-        while (numSent != numToSend) {
-            // Collect batches out on the network, mapped by endpoint
-            OwnedShardBatchMap ownedPendingBatches;
-            OwnedShardBatchMap::MapType& pendingBatches = ownedPendingBatches.mutableMap();
-
-            //
-            // Construct the requests.
-            //
-
-            std::vector<AsyncRequestsSender::Request> requests;
-
-            // Get as many batches as we can at once
-            for (auto& childBatch : childBatches) {
-                TargetedWriteBatch* const nextBatch = childBatch.second;
+        // Collect batches out on the network, mapped by endpoint
+        std::map<ShardId, std::unique_ptr<TargetedWriteBatch>> pendingBatches;
 
-                // If the batch is nullptr, we sent it previously, so skip
-                if (!nextBatch)
-                    continue;
+        // Takes the next batch for 'targetShardId' off its queue, records it as pending and
+        // returns the request to send for it.
+        auto prepareNextRequest = [&](const ShardId& targetShardId) {
+            auto& shardBatches = childBatches[targetShardId];
+            invariant(!shardBatches.empty());
+            TargetedWriteBatch* const nextBatch = shardBatches.front();
+            shardBatches.pop_front();
 
-                // If we already have a batch for this shard, wait until the next time
-                ShardId targetShardId = nextBatch->getEndpoint().shardName;  //ӦƬ
+            // Recv-side is responsible for cleaning up the nextBatch when used
+            pendingBatches[targetShardId].reset(nextBatch);
 
-                OwnedShardBatchMap::MapType::iterator pendingIt =
-                    pendingBatches.find(targetShardId);
-                if (pendingIt != pendingBatches.end()) //ظ
-                    continue;
-
-				
-                const auto request = [&] {
+            const auto request = [&] {
 					//BatchedCommandRequest
-                    const auto shardBatchRequest(batchOp.buildBatchRequest(*nextBatch));
+                const auto shardBatchRequest(batchOp.buildBatchRequest(*nextBatch));
 
-                    BSONObjBuilder requestBuilder;
-                    shardBatchRequest.serialize(&requestBuilder);
+                BSONObjBuilder requestBuilder;
+                shardBatchRequest.serialize(&requestBuilder);
 
-                    {
-                        OperationSessionInfo sessionInfo;
+                {
+                    OperationSessionInfo sessionInfo;
 
-                        if (opCtx->getLogicalSessionId()) {
-                            sessionInfo.setSessionId(*opCtx->getLogicalSessionId());
-                        }
-
-                        sessionInfo.setTxnNumber(opCtx->getTxnNumber());
-                        sessionInfo.serialize(&requestBuilder);
+                    if (opCtx->getLogicalSessionId()) {
+                        sessionInfo.setSessionId(*opCtx->getLogicalSessionId());
                     }
 
-                    return requestBuilder.obj(); 
-                }();
+                    sessionInfo.setTxnNumber(opCtx->getTxnNumber());
+                    sessionInfo.serialize(&requestBuilder);
+                }
+
+                return requestBuilder.obj(); 
+            }();
 
-                LOG(4) << "Sending write batch to " << targetShardId << ": " << redact(request);
+            LOG(4) << "Sending write batch to " << targetShardId << ": " << redact(request);
 
-                requests.emplace_back(targetShardId, request); //requestӦtargetShardIdshard
+            return AsyncRequestsSender::Request(targetShardId, request);
+        };
 
-                // Indicate we're done by setting the batch to nullptr. We'll only get duplicate
-                // hostEndpoints if we have broadcast and non-broadcast endpoints for the same host,
-                // so this should be pretty efficient without moving stuff around.
-                childBatch.second = nullptr;
+        //
+        // Construct the requests.
+        //
 
-                // Recv-side is responsible for cleaning up the nextBatch when used
-                pendingBatches.insert(std::make_pair(targetShardId, nextBatch));
+        std::vector<AsyncRequestsSender::Request> requests;
+        for (auto& shardBatches : childBatches) {
+            if (!shardBatches.second.empty()) {
+                requests.push_back(prepareNextRequest(shardBatches.first));
             }
+        }
 
+        if (!requests.empty()) {
 			//AsyncRequestsSender::AsyncRequestsSender
             AsyncRequestsSender ars(opCtx,
                                     Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(), //ѯGrid::_executorPool
@@ -220,7 +213,6 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                                     kPrimaryOnlyReadPreference, //дֻ
                                     opCtx->getTxnNumber() ? Shard::RetryPolicy::kIdempotent
                                                           : Shard::RetryPolicy::kNoRetry);
-            numSent += pendingBatches.size();
 
             //
             // Receive the responses.
@@ -231,8 +223,15 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                 auto response = ars.next();//AsyncRequestsSender::next
 
                 // Get the TargetedWriteBatch to find where to put the response
-                dassert(pendingBatches.find(response.shardId) != pendingBatches.end());
-                TargetedWriteBatch* batch = pendingBatches.find(response.shardId)->second;
+                auto pendingIt = pendingBatches.find(response.shardId);
+                invariant(pendingIt != pendingBatches.end());
+                const std::unique_ptr<TargetedWriteBatch> batch(std::move(pendingIt->second));
+                pendingBatches.erase(pendingIt);
+
+                // The shard is idle now, so send it its next batch before noting this response
+                if (!childBatches[response.shardId].empty()) {
+                    ars.addRequest(prepareNextRequest(response.shardId));
+                }
 
                 // First check if we were able to target a shard host.
                 if (!response.shardHostAndPort) {
@@ -247,11 +246,7 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                     LOG(4) << "Unable to send write batch to " << batch->getEndpoint().shardName
                            << causedBy(response.swResponse.getStatus());
 
-                    // We're done with this batch. Clean up when we can't resolve a host.
-                    auto it = childBatches.find(batch->getEndpoint().shardName);
-                    invariant(it != childBatches.end());
-                    delete it->second;
-                    it->second = nullptr;
+                    // We're done with this batch, which is deleted when we can't resolve a host.
                     continue;
                 }
 
@@ -116,6 +116,23 @@ bool isNewBatchRequired(const std::vector<TargetedWrite*>& writes,
     return false;
 }
 
+/**
+ * Helper to determine whether adding a write of 'writeSizeBytes' would make a batch too big.
+ */
+bool wouldMakeBatchTooBig(const BatchSize& batchSize, int writeSizeBytes) {
+    if (batchSize.numOps >= static_cast<int>(write_ops::kMaxWriteBatchSize)) {
+        // Too many items in batch
+        return true;
+    }
+
+    if (batchSize.sizeBytes + writeSizeBytes > BSONObjMaxUserSize) {
+        // Batch would be too big
+        return true;
+    }
+
+    return false;
+}
+
 /**
  * Helper to determine whether a number of targeted writes require a new targeted batch.
  */ //ĵȼwouldMakeBatchesTooBig
@@ -131,15 +148,7 @@ bool wouldMakeBatchesTooBig(const std::vector<TargetedWrite*>& writes,
             continue;
         }
 
-        const BatchSize& batchSize = seenIt->second;
-
-        if (batchSize.numOps >= static_cast<int>(write_ops::kMaxWriteBatchSize)) {
-            // Too many items in batch
-            return true;
-        }
-
-        if (batchSize.sizeBytes + writeSizeBytes > BSONObjMaxUserSize) {
-            // Batch would be too big
+        if (wouldMakeBatchTooBig(seenIt->second, writeSizeBytes)) {
             return true;
         }
     }
@@ -238,6 +247,36 @@ BatchWriteOp::~BatchWriteOp() {
 Status BatchWriteOp::targetBatch(const NSTargeter& targeter, //ChunkManagerTargeter
                                  bool recordTargetErrors,
                                  std::map<ShardId, TargetedWriteBatch*>* targetedBatches) {
+    std::vector<TargetedWriteBatch*> batches;
+    Status status = _targetBatch(targeter, recordTargetErrors, false, &batches);
+
+    for (TargetedWriteBatch* batch : batches) {
+        // Send the handle back to caller
+        invariant(targetedBatches->find(batch->getEndpoint().shardName) == targetedBatches->end());
+        targetedBatches->insert(std::make_pair(batch->getEndpoint().shardName, batch));
+    }
+
+    return status;
+}
+
+Status BatchWriteOp::targetBatchPerShard(
+    const NSTargeter& targeter,
+    bool recordTargetErrors,
+    std::map<ShardId, std::deque<TargetedWriteBatch*>>* targetedBatches) {
+    std::vector<TargetedWriteBatch*> batches;
+    Status status = _targetBatch(targeter, recordTargetErrors, true, &batches);
+
+    for (TargetedWriteBatch* batch : batches) {
+        (*targetedBatches)[batch->getEndpoint().shardName].push_back(batch);
+    }
+
+    return status;
+}
+
+Status BatchWriteOp::_targetBatch(const NSTargeter& targeter,
+                                  bool recordTargetErrors,
+                                  bool splitFullBatches,
+                                  std::vector<TargetedWriteBatch*>* targetedBatches) {
     //
     // Targeting of unordered batches is fairly simple - each remaining write op is targeted,
     // and each of those targeted writes are grouped into a batch for a particular shard
@@ -272,10 +311,15 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter, //ChunkManagerTarge
     //
 
     const bool ordered = _clientRequest.getWriteCommandBase().getOrdered();
+    splitFullBatches = splitFullBatches && !ordered;
 
     TargetedBatchMap batchMap;
     TargetedBatchSizeMap batchSizes;
 
+    // Batches which were full when a later write was targeted to their endpoint, in the order they
+    // were started. Only used if 'splitFullBatches' is true.
+    std::vector<TargetedWriteBatch*> fullBatches;
+
     int numTargetErrors = 0;
 
     const size_t numWriteOps = _clientRequest.sizeWriteOps(); //ĵ
@@ -306,7 +350,10 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter, //ChunkManagerTarge
 
             if (!recordTargetErrors) {
                 // Cancel current batch state with an error
-                _cancelBatches(targetError, std::move(batchMap));
+                for (auto&& batch : batchMap) {
+                    fullBatches.push_back(batch.second);
+                }
+                _cancelBatches(targetError, std::move(fullBatches));
                 return targetStatus;
             } else if (!ordered || batchMap.empty()) {
                 // Record an error for this batch
@@ -346,8 +393,24 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter, //ChunkManagerTarge
         const int writeSizeBytes = getWriteSizeBytes(writeOp) + kBSONArrayPerElementOverheadBytes +
             (_batchTxnNum ? kBSONArrayPerElementOverheadBytes + 4 : 0);
 
-        // If this write will push us over some sort of size limit, stop targeting
-        if (wouldMakeBatchesTooBig(writes, writeSizeBytes, batchSizes)) {//ĵȼwouldMakeBatchesTooBig
+        // If this write will push us over some sort of size limit, stop targeting, or, if we may,
+        // set the full batches aside so that the write starts new ones for those endpoints
+        if (splitFullBatches) {
+            for (TargetedWrite* write : writes) {
+                auto batchSizeIt = batchSizes.find(&write->endpoint);
+                if (batchSizeIt == batchSizes.end() ||
+                    !wouldMakeBatchTooBig(batchSizeIt->second, writeSizeBytes)) {
+                    continue;
+                }
+
+                // The maps are keyed by the batch's own endpoint, so erase before the batch can be
+                // replaced
+                auto batchIt = batchMap.find(&write->endpoint);
+                fullBatches.push_back(batchIt->second);
+                batchSizes.erase(batchSizeIt);
+                batchMap.erase(batchIt);
+            }
+        } else if (wouldMakeBatchesTooBig(writes, writeSizeBytes, batchSizes)) {//ĵȼwouldMakeBatchesTooBig
             invariant(!batchMap.empty());
             writeOp.cancelWrites(NULL);
             break;
@@ -401,19 +464,19 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter, //ChunkManagerTarge
     // Send back our targeted batches
     //
 
+    // Full batches for an endpoint were started before the one still open for it
     for (TargetedBatchMap::iterator it = batchMap.begin(); it != batchMap.end(); ++it) {
-        TargetedWriteBatch* batch = it->second;
+        fullBatches.push_back(it->second);
+    }
 
+    for (TargetedWriteBatch* batch : fullBatches) {
         if (batch->getWrites().empty())
             continue;
 
         // Remember targeted batch for reporting
         _targeted.insert(batch);
 
-        // Send the handle back to caller
-        invariant(targetedBatches->find(batch->getEndpoint().shardName) == targetedBatches->end());
-		//batchӦĵϢӦתshardNameڵ
-        targetedBatches->insert(std::make_pair(batch->getEndpoint().shardName, batch)); //targetedBatchesmapԱ
+        targetedBatches->push_back(batch);
     }
 
     return Status::OK();
@@ -808,12 +871,11 @@ void BatchWriteOp::_incBatchStats(const BatchedCommandResponse& response) {
 }
 
 void BatchWriteOp::_cancelBatches(const WriteErrorDetail& why,
-                                  TargetedBatchMap&& batchMapToCancel) {
-    TargetedBatchMap batchMap(batchMapToCancel);
+                                  std::vector<TargetedWriteBatch*>&& batchesToCancel) {
+    std::vector<TargetedWriteBatch*> batches(std::move(batchesToCancel));
 
     // Collect all the writeOps that are currently targeted
-    for (TargetedBatchMap::iterator it = batchMap.begin(); it != batchMap.end();) {
-        TargetedWriteBatch* batch = it->second;
+    for (TargetedWriteBatch* batch : batches) {
         const vector<TargetedWrite*>& writes = batch->getWrites();
 
         for (vector<TargetedWrite*>::const_iterator writeIt = writes.begin();
@@ -827,9 +889,6 @@ void BatchWriteOp::_cancelBatches(const WriteErrorDetail& why,
             _writeOps[write->writeOpRef.first].cancelWrites(&why);
         }
 
-        // Note that we need to *erase* first, *then* delete, since the map keys are ptrs from
-        // the values
-        batchMap.erase(it++);
         delete batch;
     }
 }
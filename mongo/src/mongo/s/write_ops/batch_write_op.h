@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <deque>
 #include <set>
 #include <vector>
 
@@ -140,6 +141,19 @@ public:
                        bool recordTargetErrors,
                        std::map<ShardId, TargetedWriteBatch*>* targetedBatches);
 
+    /**
+     * Like targetBatch(), but an unordered batch op targets all of its ready write ops at once:
+     * whenever the batch for an endpoint is full, another one is started for it rather than
+     * stopping. The batches for each shard are returned in the order they should be sent, so that
+     * a shard can be sent its next batch as soon as it has responded to the previous one. Ordered
+     * batch ops are targeted exactly as by targetBatch().
+     *
+     * Returned TargetedWriteBatches are owned by the caller.
+     */
+    Status targetBatchPerShard(const NSTargeter& targeter,
+                               bool recordTargetErrors,
+                               std::map<ShardId, std::deque<TargetedWriteBatch*>>* targetedBatches);
+
     /**
      * Fills a BatchCommandRequest from a TargetedWriteBatch for this BatchWriteOp.
      */
@@ -188,15 +202,26 @@ public:
     int numWriteOpsIn(WriteOpState state) const;
 
 private:
+    /**
+     * Implements targetBatch() and targetBatchPerShard(). If 'splitFullBatches' is true and the
+     * batch op is unordered, full batches are set aside rather than ending the targeting. Returns
+     * the targeted batches in the order they were started.
+     */
+    Status _targetBatch(const NSTargeter& targeter,
+                        bool recordTargetErrors,
+                        bool splitFullBatches,
+                        std::vector<TargetedWriteBatch*>* targetedBatches);
+
     /**
      * Maintains the batch execution statistics when a response is received.
      */
     void _incBatchStats(const BatchedCommandResponse& response);
 
     /**
-     * Helper function to cancel all the write ops of targeted batches in a map.
+     * Helper function to cancel all the write ops of the given targeted batches and delete them.
      */
-    void _cancelBatches(const WriteErrorDetail& why, TargetedBatchMap&& batchMapToCancel);
+    void _cancelBatches(const WriteErrorDetail& why,
+                        std::vector<TargetedWriteBatch*>&& batchesToCancel);
 
     OperationContext* const _opCtx;
 
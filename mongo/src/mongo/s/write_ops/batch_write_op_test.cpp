@@ -1553,5 +1553,50 @@ TEST_F(BatchWriteOpLimitTests, OneBigOneSmall) {
     ASSERT(batchOp.isFinished());
 }
 
+// Unordered big doc with smaller additional doc - targeted at once as two batches for the shard
+TEST_F(BatchWriteOpLimitTests, OneBigOneSmallUnorderedPerShard) {
+    NamespaceString nss("foo.bar");
+    ShardEndpoint endpoint(ShardId("shard"), ChunkVersion::IGNORED());
+    MockNSTargeter targeter;
+    initTargeterFullRange(nss, endpoint, &targeter);
+
+    // Create a BSONObj (slightly) bigger than the maximum size by including a max-size string
+    const std::string bigString(BSONObjMaxUserSize, 'x');
+
+    BatchedCommandRequest request([&] {
+        write_ops::Update updateOp(nss);
+        updateOp.setWriteCommandBase([] {
+            write_ops::WriteCommandBase wcb;
+            wcb.setOrdered(false);
+            return wcb;
+        }());
+        updateOp.setUpdates({buildUpdate(BSON("x" << 1), BSON("data" << bigString), false),
+                             buildUpdate(BSON("x" << 2), BSONObj(), false)});
+        return updateOp;
+    }());
+
+    BatchWriteOp batchOp(operationContext(), request);
+
+    std::map<ShardId, std::deque<TargetedWriteBatch*>> targeted;
+    ASSERT_OK(batchOp.targetBatchPerShard(targeter, false, &targeted));
+    ASSERT_EQUALS(targeted.size(), 1u);
+
+    std::deque<TargetedWriteBatch*>& shardBatches = targeted.begin()->second;
+    ASSERT_EQUALS(shardBatches.size(), 2u);
+    ASSERT_EQUALS(shardBatches[0]->getWrites().size(), 1u);
+    ASSERT_EQUALS(shardBatches[0]->getWrites()[0]->writeOpRef.first, 0u);
+    ASSERT_EQUALS(shardBatches[1]->getWrites().size(), 1u);
+    ASSERT_EQUALS(shardBatches[1]->getWrites()[0]->writeOpRef.first, 1u);
+
+    BatchedCommandResponse response;
+    buildResponse(1, &response);
+
+    for (TargetedWriteBatch* batch : shardBatches) {
+        batchOp.noteBatchResponse(*batch, response, NULL);
+        delete batch;
+    }
+    ASSERT(batchOp.isFinished());
+}
+
 }  // namespace
 }  // namespace mongo
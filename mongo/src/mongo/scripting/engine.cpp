@@ -33,12 +33,14 @@
 
 #include "mongo/scripting/engine.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
 #include <cctype>
 
 #include "mongo/client/dbclientcursor.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/unordered_set.h"
 #include "mongo/scripting/dbdirectclient_factory.h"
@@ -60,6 +62,14 @@ AtomicInt64 Scope::_lastVersion(1);
 namespace {
 
 MONGO_FP_DECLARE(mr_killop_test_fp);
+
+// The maximum number of idle scopes kept for reuse, across all pools.
+MONGO_EXPORT_SERVER_PARAMETER(scriptingEngineScopeCacheSize, int, 32);
+
+// The number of times a scope may be reused before it is discarded, bounding the garbage and
+// global state an individual scope can accumulate.
+MONGO_EXPORT_SERVER_PARAMETER(scriptingEngineScopeMaxReuse, int, 100);
+
 // 2 GB is the largest support Javascript file size.
 const fileofs kMaxJsFileLength = fileofs(2) * 1024 * 1024 * 1024;
 
@@ -339,13 +349,17 @@ public:
             return;
         }
 
-        if (scope->getTimesUsed() > kMaxScopeReuse)
+        if (scope->getTimesUsed() > scriptingEngineScopeMaxReuse.load())
             return;  // used too many times to save
 
         if (!scope->getError().empty())
             return;  // not saving errored scopes
 
-        if (_pools.size() >= kMaxPoolSize) {
+        const size_t maxPoolSize = std::max(scriptingEngineScopeCacheSize.load(), 0);
+        if (maxPoolSize == 0)
+            return;  // not caching scopes at all
+
+        while (_pools.size() >= maxPoolSize) {
             // prefer to keep recently-used scopes
             _pools.pop_back();
         }
@@ -384,10 +398,8 @@ private:
         string poolName;
     };
 
-    // Note: if these numbers change, reconsider choice of datastructure for _pools
-    static const unsigned kMaxPoolSize = 10;
-    static const int kMaxScopeReuse = 10;
-
+    // Note: tryAcquire() scans _pools linearly, so reconsider the choice of datastructure if the
+    // cache is expected to hold many more than a few dozen scopes.
     typedef std::deque<ScopeAndPool> Pools;  // More-recently used Scopes are kept at the front.
     Pools _pools;                            // protected by _mutex
     stdx::mutex _mutex;
@@ -32,6 +32,7 @@
 
 #include "mongo/shell/bench.h"
 
+#include <cmath>
 #include <pcrecpp.h>
 
 #include "mongo/client/dbclientcursor.h"
@@ -39,11 +40,15 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/query_request.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/scripting/bson_template_evaluator.h"
 #include "mongo/scripting/engine.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/platform/bits.h"
+#include "mongo/platform/random.h"
 #include "mongo/util/log.h"
 #include "mongo/util/md5.h"
+#include "mongo/util/net/op_msg.h"
 #include "mongo/util/time_support.h"
 #include "mongo/util/timer.h"
 #include "mongo/util/version.h"
@@ -62,7 +67,9 @@ const std::map<OpType, std::string> kOpTypeNames{{OpType::NONE, "none"},
                                                  {OpType::CREATEINDEX, "createIndex"},
                                                  {OpType::DROPINDEX, "dropIndex"},
                                                  {OpType::LET, "let"},
-                                                 {OpType::CPULOAD, "cpuload"}};
+                                                 {OpType::CPULOAD, "cpuload"},
+                                                 {OpType::AGGREGATE, "aggregate"},
+                                                 {OpType::CHANGESTREAM, "changeStream"}};
 
 // When specified to the connection's 'runCommand' call indicates that the command should be
 // executed with no query options. This is only meaningful if a command is run via OP_QUERY against
@@ -125,18 +132,9 @@ BSONObj fixQuery(const BSONObj& obj, BsonTemplateEvaluator& btl) {
     return b.obj();
 }
 
-bool runCommandWithSession(DBClientBase* conn,
-                           const std::string& dbname,
-                           const BSONObj& cmdObj,
-                           int options,
-                           const boost::optional<LogicalSessionIdToClient>& lsid,
-                           boost::optional<TxnNumber> txnNumber,
-                           BSONObj* result) {
-    if (!lsid) {
-        invariant(!txnNumber);
-        return conn->runCommand(dbname, cmdObj, *result);
-    }
-
+BSONObj appendSessionInfo(const BSONObj& cmdObj,
+                          const LogicalSessionIdToClient& lsid,
+                          boost::optional<TxnNumber> txnNumber) {
     BSONObjBuilder cmdObjWithLsidBuilder;
 
     for (const auto& cmdArg : cmdObj) {
@@ -153,7 +151,7 @@ bool runCommandWithSession(DBClientBase* conn,
     {
         BSONObjBuilder lsidBuilder(
             cmdObjWithLsidBuilder.subobjStart(OperationSessionInfo::kSessionIdFieldName));
-        lsid->serialize(&lsidBuilder);
+        lsid.serialize(&lsidBuilder);
         lsidBuilder.doneFast();
     }
 
@@ -161,7 +159,22 @@ bool runCommandWithSession(DBClientBase* conn,
         cmdObjWithLsidBuilder.append(OperationSessionInfo::kTxnNumberFieldName, *txnNumber);
     }
 
-    return conn->runCommand(dbname, cmdObjWithLsidBuilder.done(), *result);
+    return cmdObjWithLsidBuilder.obj();
+}
+
+bool runCommandWithSession(DBClientBase* conn,
+                           const std::string& dbname,
+                           const BSONObj& cmdObj,
+                           int options,
+                           const boost::optional<LogicalSessionIdToClient>& lsid,
+                           boost::optional<TxnNumber> txnNumber,
+                           BSONObj* result) {
+    if (!lsid) {
+        invariant(!txnNumber);
+        return conn->runCommand(dbname, cmdObj, *result);
+    }
+
+    return conn->runCommand(dbname, appendSessionInfo(cmdObj, *lsid, txnNumber), *result);
 }
 
 bool runCommandWithSession(DBClientBase* conn,
@@ -173,6 +186,95 @@ bool runCommandWithSession(DBClientBase* conn,
     return runCommandWithSession(conn, dbname, cmdObj, options, lsid, boost::none, result);
 }
 
+/**
+ * Runs the write command 'cmdObj' with 'docs' carried in an OP_MSG document sequence named
+ * 'sequenceName', rather than in an array nested in the command body. The sequence is folded back
+ * into the body if the server does not support OP_MSG.
+ */
+bool runWriteCommandWithDocSequence(DBClientBase* conn,
+                                    const std::string& dbname,
+                                    const BSONObj& cmdObj,
+                                    StringData sequenceName,
+                                    std::vector<BSONObj> docs,
+                                    const boost::optional<LogicalSessionIdToClient>& lsid,
+                                    boost::optional<TxnNumber> txnNumber,
+                                    BSONObj* result) {
+    invariant(lsid || !txnNumber);
+    auto request = OpMsgRequest::fromDBAndBody(
+        dbname, lsid ? appendSessionInfo(cmdObj, *lsid, txnNumber) : cmdObj);
+    request.sequences.push_back({sequenceName.toString(), std::move(docs)});
+
+    *result = conn->runCommand(std::move(request))->getCommandReply().getOwned();
+    return getStatusFromCommandResult(*result).isOK();
+}
+
+/**
+ * Completes the write command in 'builder' with the statements in 'statements' and the write
+ * concern of 'op', and runs it. The statements are sent in an OP_MSG document sequence if the op
+ * asks for one, and as an array field of the command otherwise.
+ */
+bool runWriteCommand(DBClientBase* conn,
+                     const BenchRunOp& op,
+                     BSONObjBuilder* builder,
+                     StringData statementsField,
+                     std::vector<BSONObj> statements,
+                     const boost::optional<LogicalSessionIdToClient>& lsid,
+                     boost::optional<TxnNumber> txnNumber,
+                     BSONObj* result) {
+    const auto dbName = nsToDatabaseSubstring(op.ns).toString();
+    if (op.docSequence) {
+        builder->append("writeConcern", op.writeConcern);
+        return runWriteCommandWithDocSequence(
+            conn, dbName, builder->done(), statementsField, std::move(statements), lsid, txnNumber,
+            result);
+    }
+
+    builder->append(statementsField, statements);
+    builder->append("writeConcern", op.writeConcern);
+    return runCommandWithSession(
+        conn, dbName, builder->done(), kNoOptions, lsid, txnNumber, result);
+}
+
+/**
+ * Runs 'cmdObj', which must return a cursor, and exhausts the returned cursor. Returns the total
+ * number of documents returned.
+ *
+ * On error, throws a AssertionException.
+ */
+int runCursorCommandToCompletion(DBClientBase* conn,
+                                 const std::string& dbName,
+                                 const BSONObj& cmdObj,
+                                 boost::optional<long long> batchSize,
+                                 const boost::optional<LogicalSessionIdToClient>& lsid) {
+    BSONObj commandResult;
+    uassert(ErrorCodes::CommandFailed,
+            str::stream() << cmdObj.firstElementFieldName() << " command failed; reply was: "
+                          << commandResult,
+            runCommandWithSession(conn, dbName, cmdObj, kNoOptions, lsid, &commandResult));
+
+    auto cursorResponse = uassertStatusOK(CursorResponse::parseFromBSON(commandResult));
+    int count = cursorResponse.getBatch().size();
+    while (cursorResponse.getCursorId() != 0) {
+        GetMoreRequest getMoreRequest(cursorResponse.getNSS(),
+                                      cursorResponse.getCursorId(),
+                                      batchSize,
+                                      boost::none,   // maxTimeMS
+                                      boost::none,   // term
+                                      boost::none);  // lastKnownCommittedOpTime
+        BSONObj getMoreCommandResult;
+        uassert(
+            ErrorCodes::CommandFailed,
+            str::stream() << "getMore command failed; reply was: " << getMoreCommandResult,
+            runCommandWithSession(
+                conn, dbName, getMoreRequest.toBSON(), kNoOptions, lsid, &getMoreCommandResult));
+
+        cursorResponse = uassertStatusOK(CursorResponse::parseFromBSON(getMoreCommandResult));
+        count += cursorResponse.getBatch().size();
+    }
+
+    return count;
+}
+
 /**
  * Issues the query 'qr' against 'conn' using read commands. Returns the size of the result set
  * returned by the query.
@@ -233,11 +335,111 @@ void doNothing(const BSONObj&) {}
 
 }  // namespace
 
+namespace {
+
+// Each power of two at or above kSubBucketCount is split into this many linear sub-buckets.
+const long long kHalfSubBucketCount = BenchRunLatencyHistogram::kSubBucketCount / 2;
+
+const size_t kNumLatencyBuckets = BenchRunLatencyHistogram::kSubBucketCount +
+    (BenchRunLatencyHistogram::kMaxValueBits - BenchRunLatencyHistogram::kSubBucketBits) *
+        kHalfSubBucketCount;
+
+const long long kMaxTrackableMicros = (1LL << BenchRunLatencyHistogram::kMaxValueBits) - 1;
+
+}  // namespace
+
+size_t BenchRunLatencyHistogram::bucketIndexFor(long long micros) {
+    if (micros < kSubBucketCount) {
+        return micros < 0 ? 0 : micros;
+    }
+
+    if (micros > kMaxTrackableMicros) {
+        micros = kMaxTrackableMicros;
+    }
+
+    int highestBit = 63 - countLeadingZeros64(micros);
+    int shift = highestBit - (kSubBucketBits - 1);
+    long long subBucket = (micros >> shift) - kHalfSubBucketCount;
+    return kSubBucketCount + (shift - 1) * kHalfSubBucketCount + subBucket;
+}
+
+long long BenchRunLatencyHistogram::highestValueInBucket(size_t index) {
+    if (index < static_cast<size_t>(kSubBucketCount)) {
+        return index;
+    }
+
+    int shift = (index - kSubBucketCount) / kHalfSubBucketCount + 1;
+    long long subBucket = (index - kSubBucketCount) % kHalfSubBucketCount;
+    return ((kHalfSubBucketCount + subBucket + 1) << shift) - 1;
+}
+
+void BenchRunLatencyHistogram::record(long long micros) {
+    if (_buckets.empty()) {
+        _buckets.resize(kNumLatencyBuckets);
+    }
+
+    ++_buckets[bucketIndexFor(micros)];
+    ++_count;
+    if (micros > _maxMicros) {
+        _maxMicros = micros;
+    }
+}
+
+void BenchRunLatencyHistogram::updateFrom(const BenchRunLatencyHistogram& other) {
+    if (other._buckets.empty()) {
+        return;
+    }
+
+    if (_buckets.empty()) {
+        _buckets.resize(kNumLatencyBuckets);
+    }
+
+    for (size_t i = 0; i < kNumLatencyBuckets; ++i) {
+        _buckets[i] += other._buckets[i];
+    }
+    _count += other._count;
+    if (other._maxMicros > _maxMicros) {
+        _maxMicros = other._maxMicros;
+    }
+}
+
+long long BenchRunLatencyHistogram::valueAtPercentile(double percentile) const {
+    if (_count == 0) {
+        return 0;
+    }
+
+    // The rank of the value we are looking for, counting from 1.
+    auto rank = static_cast<unsigned long long>(std::ceil(percentile / 100.0 * _count));
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    unsigned long long seen = 0;
+    for (size_t i = 0; i < kNumLatencyBuckets; ++i) {
+        seen += _buckets[i];
+        if (seen >= rank) {
+            // Never report more than was actually observed.
+            return std::min(highestValueInBucket(i), _maxMicros);
+        }
+    }
+
+    return _maxMicros;
+}
+
+void BenchRunLatencyHistogram::appendPercentiles(BSONObjBuilder* builder) const {
+    builder->append("p50", valueAtPercentile(50));
+    builder->append("p90", valueAtPercentile(90));
+    builder->append("p99", valueAtPercentile(99));
+    builder->append("p999", valueAtPercentile(99.9));
+    builder->append("max", _maxMicros);
+}
+
 BenchRunEventCounter::BenchRunEventCounter() = default;
 
 void BenchRunEventCounter::updateFrom(const BenchRunEventCounter& other) {
     _numEvents += other._numEvents;
     _totalTimeMicros += other._totalTimeMicros;
+    _latencies.updateFrom(other._latencies);
 }
 
 void BenchRunStats::updateFrom(const BenchRunStats& other) {
@@ -252,6 +454,11 @@ void BenchRunStats::updateFrom(const BenchRunStats& other) {
     deleteCounter.updateFrom(other.deleteCounter);
     queryCounter.updateFrom(other.queryCounter);
     commandCounter.updateFrom(other.commandCounter);
+    aggregateCounter.updateFrom(other.aggregateCounter);
+    changeStreamCounter.updateFrom(other.changeStreamCounter);
+
+    changeStreamEventCount += other.changeStreamEventCount;
+    maxScheduleLagMicros = std::max(maxScheduleLagMicros, other.maxScheduleLagMicros);
 
     for (const auto& trappedError : other.trappedErrors) {
         trappedErrors.push_back(trappedError);
@@ -302,9 +509,11 @@ BenchRunOp opFromBson(const BSONObj& op) {
                                   << typeName(arg.type()),
                     arg.isNumber());
             uassert(34378,
-                    str::stream() << "Field 'batchSize' only valid for find op types. Type is "
+                    str::stream() << "Field 'batchSize' only valid for find, aggregate, "
+                                     "changeStream and insert op types. Type is "
                                   << opType,
-                    (opType == "find") || (opType == "query"));
+                    (opType == "find") || (opType == "query") || (opType == "aggregate") ||
+                        (opType == "changeStream") || (opType == "insert"));
             myOp.batchSize = arg.numberInt();
         } else if (name == "check") {
             // check function gets thrown into a scoped function. Leaving that parsing in main loop.
@@ -346,15 +555,24 @@ BenchRunOp opFromBson(const BSONObj& op) {
                     (opType == "insert"));
             myOp.isDocAnArray = arg.type() == Array;
             myOp.doc = arg.Obj();
+        } else if (name == "docSequence") {
+            uassert(50797,
+                    str::stream() << "Field 'docSequence' only valid for insert, update and "
+                                     "remove op types. Type is "
+                                  << opType,
+                    (opType == "insert") || (opType == "update") || (opType == "remove") ||
+                        (opType == "delete"));
+            myOp.docSequence = arg.trueValue();
         } else if (name == "expected") {
             uassert(34380,
                     str::stream() << "Field 'Expected' should be a number, instead it's type: "
                                   << typeName(arg.type()),
                     arg.isNumber());
             uassert(34400,
-                    str::stream() << "Field 'Expected' only valid for find op type. Type is "
-                                  << opType,
-                    (opType == "find") || (opType == "query"));
+                    str::stream()
+                        << "Field 'Expected' only valid for find and aggregate op types. Type is "
+                        << opType,
+                    (opType == "find") || (opType == "query") || (opType == "aggregate"));
             myOp.expected = arg.numberInt();
         } else if (name == "filter") {
             uassert(
@@ -384,6 +602,18 @@ BenchRunOp opFromBson(const BSONObj& op) {
                                   << typeName(arg.type()),
                     arg.isNumber());
             myOp.limit = arg.numberInt();
+        } else if (name == "maxAwaitTimeMS") {
+            uassert(50798,
+                    str::stream()
+                        << "Field 'maxAwaitTimeMS' is only valid for changeStream op type. Type is "
+                        << opType,
+                    opType == "changeStream");
+            uassert(ErrorCodes::BadValue,
+                    str::stream()
+                        << "Field 'maxAwaitTimeMS' should be a number, instead it's type: "
+                        << typeName(arg.type()),
+                    arg.isNumber());
+            myOp.maxAwaitTimeMS = arg.numberInt();
         } else if (name == "multi") {
             uassert(34383,
                     str::stream()
@@ -425,6 +655,10 @@ BenchRunOp opFromBson(const BSONObj& op) {
                 myOp.op = OpType::LET;
             } else if (type == "cpuload") {
                 myOp.op = OpType::CPULOAD;
+            } else if (type == "aggregate") {
+                myOp.op = OpType::AGGREGATE;
+            } else if (type == "changeStream") {
+                myOp.op = OpType::CHANGESTREAM;
             } else {
                 uassert(34387,
                         str::stream() << "benchRun passed an unsupported op type: " << type,
@@ -440,6 +674,17 @@ BenchRunOp opFromBson(const BSONObj& op) {
                                   << opType,
                     (opType == "command") || (opType == "query") || (opType == "find"));
             myOp.options = arg.numberInt();
+        } else if (name == "pipeline") {
+            uassert(50799,
+                    str::stream() << "Field 'pipeline' is only valid for aggregate and "
+                                     "changeStream op types. Type is "
+                                  << opType,
+                    (opType == "aggregate") || (opType == "changeStream"));
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Field 'pipeline' should be an array, instead it's type: "
+                                  << typeName(arg.type()),
+                    arg.type() == Array);
+            myOp.pipeline = arg.Obj();
         } else if (name == "query") {
             uassert(34389,
                     str::stream() << "Field 'query' is only valid for findOne, find, update, and "
@@ -508,6 +753,12 @@ BenchRunOp opFromBson(const BSONObj& op) {
 
     uassert(34395, "Benchrun op has an zero length ns", !myOp.ns.empty());
     uassert(34396, "Benchrun op doesn't have an optype set", myOp.op != OpType::NONE);
+    uassert(50800,
+            "Benchrun op field 'docSequence' requires 'writeCmd'",
+            !myOp.docSequence || myOp.useWriteCmd);
+    uassert(50801,
+            "Benchrun op field 'batchSize' cannot be combined with an array 'doc'",
+            !(myOp.op == OpType::INSERT && myOp.batchSize && myOp.isDocAnArray));
     return myOp;
 }
 
@@ -570,6 +821,21 @@ void BenchRunConfig::initializeFromBson(const BSONObj& args) {
                                   << typeName(arg.type()),
                     arg.isBoolean());
             useIdempotentWrites = arg.boolean();
+        } else if (name == "rate") {
+            uassert(50802,
+                    str::stream() << "Field '" << name << "' should be a number. . Type is "
+                                  << typeName(arg.type()),
+                    arg.isNumber());
+            rate = arg.number();
+            uassert(50803,
+                    str::stream() << "Field '" << name << "' must not be negative",
+                    rate >= 0);
+        } else if (name == "poissonArrivals") {
+            uassert(50804,
+                    str::stream() << "Field '" << name << "' should be a boolean. . Type is "
+                                  << typeName(arg.type()),
+                    arg.isBoolean());
+            poissonArrivals = arg.boolean();
         } else if (name == "hideResults") {
             hideResults = arg.trueValue();
         } else if (name == "handleErrors") {
@@ -751,11 +1017,46 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
     std::unique_ptr<Scope> scope{getGlobalScriptEngine()->newScopeForCurrentThread()};
     verify(scope.get());
 
+    // Open change stream cursors, by op. A change stream is opened the first time its op runs and
+    // each later run of the op issues one getMore against it.
+    std::map<const BenchRunOp*, CursorId> changeStreamCursors;
+
+    // In open loop mode each worker issues its share of the target rate on a schedule measured
+    // from 'scheduleTimer', independently of how long each operation takes.
+    const bool openLoop = _config->rate > 0;
+    const double meanArrivalIntervalMicros =
+        openLoop ? 1000 * 1000 * _config->parallel / _config->rate : 0;
+    PseudoRandom arrivalRandom(_randomSeed);
+    Timer scheduleTimer;
+    double nextArrivalMicros = 0;
+
     while (!shouldStop()) {
         for (const auto& op : _config->ops) {
             if (shouldStop())
                 break;
+
+            // How far behind its schedule the op is starting. Added to each recorded latency, so
+            // that time the op would have spent queued behind the previous one is not omitted.
+            long long lagMicros = 0;
+            if (openLoop) {
+                // Sleep in slices so that a low rate does not delay the end of the run.
+                long long untilArrival;
+                while ((untilArrival = nextArrivalMicros - scheduleTimer.micros()) > 0 &&
+                       !shouldStop()) {
+                    sleepmicros(std::min(untilArrival, 100 * 1000LL));
+                }
+                if (shouldStop())
+                    break;
+
+                lagMicros = std::max(
+                    0LL, scheduleTimer.micros() - static_cast<long long>(nextArrivalMicros));
+                nextArrivalMicros += _config->poissonArrivals
+                    ? -std::log(1 - arrivalRandom.nextCanonicalDouble()) * meanArrivalIntervalMicros
+                    : meanArrivalIntervalMicros;
+            }
+
             auto& stats = shouldCollectStats() ? _stats : _statsBlackHole;
+            stats.maxScheduleLagMicros = std::max(stats.maxScheduleLagMicros, lagMicros);
 
             ScriptingFunction scopeFunc = 0;
             BSONObj scopeObj;
@@ -802,10 +1103,10 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                             qr->setWantMore(false);
                             invariantOK(qr->validate());
 
-                            BenchRunEventTrace _bret(&stats.findOneCounter);
+                            BenchRunEventTrace _bret(&stats.findOneCounter, lagMicros);
                             runQueryWithReadCommands(conn, lsid, std::move(qr), &result);
                         } else {
-                            BenchRunEventTrace _bret(&stats.findOneCounter);
+                            BenchRunEventTrace _bret(&stats.findOneCounter, lagMicros);
                             result = conn->findOne(op.ns,
                                                    fixedQuery,
                                                    nullptr,
@@ -831,7 +1132,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                         bool ok;
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.commandCounter);
+                            BenchRunEventTrace _bret(&stats.commandCounter, lagMicros);
                             ok = runCommandWithSession(conn,
                                                        op.ns,
                                                        fixQuery(op.command, bsonTemplateEvaluator),
@@ -918,12 +1219,12 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                             }
                             invariantOK(qr->validate());
 
-                            BenchRunEventTrace _bret(&stats.queryCounter);
+                            BenchRunEventTrace _bret(&stats.queryCounter, lagMicros);
                             count = runQueryWithReadCommands(conn, lsid, std::move(qr), nullptr);
                         } else {
                             // Use special query function for exhaust query option.
                             if (op.options & QueryOption_Exhaust) {
-                                BenchRunEventTrace _bret(&stats.queryCounter);
+                                BenchRunEventTrace _bret(&stats.queryCounter, lagMicros);
                                 stdx::function<void(const BSONObj&)> castedDoNothing(doNothing);
                                 count = conn->query(
                                     castedDoNothing,
@@ -932,7 +1233,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                                     &op.projection,
                                     op.options | DBClientCursor::QueryOptionLocal_forceOpQuery);
                             } else {
-                                BenchRunEventTrace _bret(&stats.queryCounter);
+                                BenchRunEventTrace _bret(&stats.queryCounter, lagMicros);
                                 std::unique_ptr<DBClientCursor> cursor(conn->query(
                                     op.ns,
                                     fixedQuery,
@@ -970,29 +1271,27 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                     case OpType::UPDATE: {
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.updateCounter);
+                            BenchRunEventTrace _bret(&stats.updateCounter, lagMicros);
                             BSONObj query = fixQuery(op.query, bsonTemplateEvaluator);
                             BSONObj update = fixQuery(op.update, bsonTemplateEvaluator);
 
                             if (op.useWriteCmd) {
                                 BSONObjBuilder builder;
                                 builder.append("update", nsToCollectionSubstring(op.ns));
-                                BSONArrayBuilder docBuilder(builder.subarrayStart("updates"));
-                                docBuilder.append(BSON(
-                                    "q" << query << "u" << update << "multi" << op.multi << "upsert"
-                                        << op.upsert));
-                                docBuilder.done();
-                                builder.append("writeConcern", op.writeConcern);
 
                                 if (txnNumberForWriteCommands)
                                     ++(*txnNumberForWriteCommands);
-                                runCommandWithSession(conn,
-                                                      nsToDatabaseSubstring(op.ns).toString(),
-                                                      builder.done(),
-                                                      kNoOptions,
-                                                      lsid,
-                                                      txnNumberForWriteCommands,
-                                                      &result);
+                                runWriteCommand(conn,
+                                                op,
+                                                &builder,
+                                                "updates",
+                                                {BSON("q" << query << "u" << update << "multi"
+                                                          << op.multi
+                                                          << "upsert"
+                                                          << op.upsert)},
+                                                lsid,
+                                                txnNumberForWriteCommands,
+                                                &result);
                             } else {
                                 auto toSend =
                                     makeUpdateMessage(op.ns,
@@ -1032,47 +1331,38 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                     case OpType::INSERT: {
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.insertCounter);
+                            BenchRunEventTrace _bret(&stats.insertCounter, lagMicros);
+
+                            std::vector<BSONObj> insertDocs;
+                            if (op.isDocAnArray) {
+                                for (const auto& element : op.doc) {
+                                    insertDocs.push_back(
+                                        fixQuery(element.Obj(), bsonTemplateEvaluator));
+                                }
+                            } else {
+                                // A batchSize asks for that many instances of the templated doc.
+                                for (int i = 0; i < std::max(op.batchSize, 1); ++i) {
+                                    insertDocs.push_back(fixQuery(op.doc, bsonTemplateEvaluator));
+                                }
+                            }
 
-                            BSONObj insertDoc;
                             if (op.useWriteCmd) {
                                 BSONObjBuilder builder;
                                 builder.append("insert", nsToCollectionSubstring(op.ns));
-                                BSONArrayBuilder docBuilder(builder.subarrayStart("documents"));
-                                if (op.isDocAnArray) {
-                                    for (const auto& element : op.doc) {
-                                        insertDoc = fixQuery(element.Obj(), bsonTemplateEvaluator);
-                                        docBuilder.append(insertDoc);
-                                    }
-                                } else {
-                                    insertDoc = fixQuery(op.doc, bsonTemplateEvaluator);
-                                    docBuilder.append(insertDoc);
-                                }
-                                docBuilder.done();
-                                builder.append("writeConcern", op.writeConcern);
 
                                 if (txnNumberForWriteCommands)
                                     ++(*txnNumberForWriteCommands);
-                                runCommandWithSession(conn,
-                                                      nsToDatabaseSubstring(op.ns).toString(),
-                                                      builder.done(),
-                                                      kNoOptions,
-                                                      lsid,
-                                                      txnNumberForWriteCommands,
-                                                      &result);
+                                runWriteCommand(conn,
+                                                op,
+                                                &builder,
+                                                "documents",
+                                                std::move(insertDocs),
+                                                lsid,
+                                                txnNumberForWriteCommands,
+                                                &result);
                             } else {
-                                std::vector<BSONObj> insertArray;
-                                if (op.isDocAnArray) {
-                                    for (const auto& element : op.doc) {
-                                        BSONObj e = fixQuery(element.Obj(), bsonTemplateEvaluator);
-                                        insertArray.push_back(e);
-                                    }
-                                } else {
-                                    insertArray.push_back(fixQuery(op.doc, bsonTemplateEvaluator));
-                                }
-
                                 auto toSend = makeInsertMessage(
-                                    op.ns, insertArray.data(), insertArray.size());
+                                    op.ns, insertDocs.data(), insertDocs.size());
                                 conn->say(toSend);
 
                                 if (op.safe)
@@ -1106,26 +1396,23 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                     case OpType::REMOVE: {
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.deleteCounter);
+                            BenchRunEventTrace _bret(&stats.deleteCounter, lagMicros);
                             BSONObj predicate = fixQuery(op.query, bsonTemplateEvaluator);
                             if (op.useWriteCmd) {
                                 BSONObjBuilder builder;
                                 builder.append("delete", nsToCollectionSubstring(op.ns));
-                                BSONArrayBuilder docBuilder(builder.subarrayStart("deletes"));
                                 int limit = (op.multi == true) ? 0 : 1;
-                                docBuilder.append(BSON("q" << predicate << "limit" << limit));
-                                docBuilder.done();
-                                builder.append("writeConcern", op.writeConcern);
 
                                 if (txnNumberForWriteCommands)
                                     ++(*txnNumberForWriteCommands);
-                                runCommandWithSession(conn,
-                                                      nsToDatabaseSubstring(op.ns).toString(),
-                                                      builder.done(),
-                                                      kNoOptions,
-                                                      lsid,
-                                                      txnNumberForWriteCommands,
-                                                      &result);
+                                runWriteCommand(conn,
+                                                op,
+                                                &builder,
+                                                "deletes",
+                                                {BSON("q" << predicate << "limit" << limit)},
+                                                lsid,
+                                                txnNumberForWriteCommands,
+                                                &result);
                             } else {
                                 auto toSend = makeRemoveMessage(
                                     op.ns, predicate, op.multi ? 0 : RemoveOption_JustOne);
@@ -1158,6 +1445,138 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                                               causedBy(result["err"].String()));
                         }
                     } break;
+                    case OpType::AGGREGATE: {
+                        BSONObjBuilder builder;
+                        builder.append("aggregate", nsToCollectionSubstring(op.ns));
+                        builder.appendArray("pipeline",
+                                            fixQuery(op.pipeline, bsonTemplateEvaluator));
+                        {
+                            BSONObjBuilder cursorBuilder(builder.subobjStart("cursor"));
+                            if (op.batchSize) {
+                                cursorBuilder.append("batchSize", op.batchSize);
+                            }
+                        }
+
+                        int count;
+                        {
+                            BenchRunEventTrace _bret(&stats.aggregateCounter, lagMicros);
+                            count = runCursorCommandToCompletion(
+                                conn,
+                                nsToDatabaseSubstring(op.ns).toString(),
+                                builder.done(),
+                                op.batchSize ? boost::make_optional<long long>(op.batchSize)
+                                             : boost::none,
+                                lsid);
+                        }
+
+                        if (op.expected >= 0 && count != op.expected) {
+                            log() << "bench aggregate on: " << op.ns
+                                  << " expected: " << op.expected << " got: " << count;
+                            verify(false);
+                        }
+
+                        if (op.useCheck) {
+                            BSONObj thisValue = BSON("count" << count << "context" << op.context);
+                            int err = scope->invoke(scopeFunc, 0, &thisValue, 1000 * 60, false);
+                            if (err) {
+                                log() << "Error checking in benchRun thread [aggregate]"
+                                      << causedBy(scope->getError());
+
+                                stats.errCount++;
+
+                                return;
+                            }
+                        }
+
+                        if (!_config->hideResults || op.showResult)
+                            log() << "Result from benchRun thread [aggregate] : " << count;
+                    } break;
+                    case OpType::CHANGESTREAM: {
+                        const auto dbName = nsToDatabaseSubstring(op.ns).toString();
+                        const auto batchSize = op.batchSize
+                            ? boost::make_optional<long long>(op.batchSize)
+                            : boost::none;
+
+                        // Forget the cursor until the server has answered, so that a failed
+                        // getMore makes the next run of this op open a new change stream.
+                        auto& cursorId = changeStreamCursors[&op];
+                        const CursorId previousCursorId = cursorId;
+                        cursorId = 0;
+
+                        BSONObj result;
+                        {
+                            BenchRunEventTrace _bret(&stats.changeStreamCounter, lagMicros);
+                            if (!previousCursorId) {
+                                BSONObjBuilder builder;
+                                builder.append("aggregate", nsToCollectionSubstring(op.ns));
+                                {
+                                    BSONArrayBuilder pipelineBuilder(
+                                        builder.subarrayStart("pipeline"));
+                                    pipelineBuilder.append(BSON("$changeStream" << BSONObj()));
+                                    for (const auto& stage : op.pipeline) {
+                                        pipelineBuilder.append(stage);
+                                    }
+                                }
+                                {
+                                    BSONObjBuilder cursorBuilder(builder.subobjStart("cursor"));
+                                    if (batchSize) {
+                                        cursorBuilder.append("batchSize", *batchSize);
+                                    }
+                                }
+                                uassert(ErrorCodes::CommandFailed,
+                                        str::stream() << "$changeStream aggregate failed; reply "
+                                                         "was: "
+                                                      << result,
+                                        runCommandWithSession(conn,
+                                                              dbName,
+                                                              builder.done(),
+                                                              kNoOptions,
+                                                              lsid,
+                                                              &result));
+                            } else {
+                                GetMoreRequest getMoreRequest(
+                                    NamespaceString(op.ns),
+                                    previousCursorId,
+                                    batchSize,
+                                    op.maxAwaitTimeMS
+                                        ? boost::make_optional(Milliseconds(op.maxAwaitTimeMS))
+                                        : boost::none,
+                                    boost::none,   // term
+                                    boost::none);  // lastKnownCommittedOpTime
+                                uassert(ErrorCodes::CommandFailed,
+                                        str::stream() << "getMore command failed; reply was: "
+                                                      << result,
+                                        runCommandWithSession(conn,
+                                                              dbName,
+                                                              getMoreRequest.toBSON(),
+                                                              kNoOptions,
+                                                              lsid,
+                                                              &result));
+                            }
+                        }
+
+                        auto cursorResponse =
+                            uassertStatusOK(CursorResponse::parseFromBSON(result));
+                        cursorId = cursorResponse.getCursorId();
+                        const int count = cursorResponse.getBatch().size();
+                        stats.changeStreamEventCount += count;
+
+                        if (op.useCheck) {
+                            BSONObj thisValue = BSON("count" << count << "context" << op.context);
+                            int err = scope->invoke(scopeFunc, 0, &thisValue, 1000 * 60, false);
+                            if (err) {
+                                log() << "Error checking in benchRun thread [changeStream]"
+                                      << causedBy(scope->getError());
+
+                                stats.errCount++;
+
+                                return;
+                            }
+                        }
+
+                        if (!_config->hideResults || op.showResult)
+                            log() << "Result from benchRun thread [changeStream] : " << count;
+                    } break;
                     case OpType::CREATEINDEX:
                         conn->createIndex(op.ns, op.key);
                         break;
@@ -1231,6 +1650,22 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
         }
     }
 
+    for (const auto& changeStreamCursor : changeStreamCursors) {
+        if (!changeStreamCursor.second)
+            continue;
+
+        // Best effort; the server will time the cursor out if this fails.
+        const auto& ns = changeStreamCursor.first->ns;
+        BSONObj result;
+        runCommandWithSession(conn,
+                              nsToDatabaseSubstring(ns).toString(),
+                              BSON("killCursors" << nsToCollectionSubstring(ns) << "cursors"
+                                                 << BSON_ARRAY(changeStreamCursor.second)),
+                              kNoOptions,
+                              lsid,
+                              &result);
+    }
+
     conn->getLastError();
 }
 
@@ -1377,6 +1812,33 @@ BSONObj BenchRunner::finish(BenchRunner* runner) {
     appendAverageMicrosIfAvailable("updateLatencyAverageMicros", stats.updateCounter);
     appendAverageMicrosIfAvailable("queryLatencyAverageMicros", stats.queryCounter);
     appendAverageMicrosIfAvailable("commandsLatencyAverageMicros", stats.commandCounter);
+    appendAverageMicrosIfAvailable("aggregateLatencyAverageMicros", stats.aggregateCounter);
+    appendAverageMicrosIfAvailable("changeStreamLatencyAverageMicros", stats.changeStreamCounter);
+
+    {
+        BSONObjBuilder percentilesBuilder(buf.subobjStart("latencyPercentilesMicros"));
+        const auto appendPercentilesIfAvailable = [&percentilesBuilder](
+            StringData name, const BenchRunEventCounter& counter) {
+            if (counter.getNumEvents() > 0) {
+                BSONObjBuilder counterBuilder(percentilesBuilder.subobjStart(name));
+                counter.getLatencies().appendPercentiles(&counterBuilder);
+            }
+        };
+
+        appendPercentilesIfAvailable("findOne", stats.findOneCounter);
+        appendPercentilesIfAvailable("insert", stats.insertCounter);
+        appendPercentilesIfAvailable("delete", stats.deleteCounter);
+        appendPercentilesIfAvailable("update", stats.updateCounter);
+        appendPercentilesIfAvailable("query", stats.queryCounter);
+        appendPercentilesIfAvailable("command", stats.commandCounter);
+        appendPercentilesIfAvailable("aggregate", stats.aggregateCounter);
+        appendPercentilesIfAvailable("changeStream", stats.changeStreamCounter);
+    }
+
+    if (runner->config().rate > 0) {
+        buf.append("targetOps/s", runner->config().rate);
+        buf.append("maxScheduleLagMicros", stats.maxScheduleLagMicros);
+    }
 
     buf.append("totalOps", static_cast<long long>(stats.opCount));
 
@@ -1391,6 +1853,9 @@ BSONObj BenchRunner::finish(BenchRunner* runner) {
     appendPerSec("update", stats.updateCounter.getNumEvents());
     appendPerSec("query", stats.queryCounter.getNumEvents());
     appendPerSec("command", stats.commandCounter.getNumEvents());
+    appendPerSec("aggregate", stats.aggregateCounter.getNumEvents());
+    appendPerSec("changeStream", stats.changeStreamCounter.getNumEvents());
+    appendPerSec("changeStreamEvents", stats.changeStreamEventCount);
 
     BSONObj zoo = buf.obj();
 
@@ -30,6 +30,7 @@
 
 #include <boost/optional.hpp>
 #include <string>
+#include <vector>
 
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/jsobj.h"
@@ -56,7 +57,9 @@ enum class OpType {
     CREATEINDEX,
     DROPINDEX,
     LET,
-    CPULOAD
+    CPULOAD,
+    AGGREGATE,
+    CHANGESTREAM
 };
 
 /**
@@ -71,15 +74,18 @@ public:
     double cpuFactor = 1;
     int delay = 0;
     BSONObj doc;
+    bool docSequence = false;
     bool isDocAnArray = false;
     int expected = -1;
     bool handleError = false;
     BSONObj key;
     int limit = 0;
+    int maxAwaitTimeMS = 0;
     bool multi = false;
     std::string ns;
     OpType op = OpType::NONE;
     int options = 0;
+    BSONObj pipeline;
     BSONObj projection;
     BSONObj query;
     bool safe = false;
@@ -167,6 +173,22 @@ public:
      */
     bool useIdempotentWrites{false};
 
+    /**
+     * Target arrival rate, in operations per second summed over all threads. When zero (the
+     * default) every thread issues its next operation as soon as the previous one returns
+     * ("closed loop"). When positive, each thread is given an equal share of the rate and issues
+     * operations on a fixed schedule ("open loop"), and latencies are measured from the time an
+     * operation was scheduled to start rather than the time it was actually sent, so that time
+     * spent queued behind a slow operation is not omitted from the reported percentiles.
+     */
+    double rate{0};
+
+    /**
+     * Whether open loop arrivals are spaced exponentially (a Poisson process) rather than at
+     * constant intervals. Only meaningful when "rate" is positive.
+     */
+    bool poissonArrivals{false};
+
     /// Base random seed for threads
     int64_t randomSeed;
 
@@ -198,6 +220,63 @@ private:
     void initializeToDefaults();
 };
 
+/**
+ * A histogram of latencies with bounded relative error, in the style of HdrHistogram.
+ *
+ * Values below kSubBucketCount microseconds are recorded exactly. Larger values are recorded in
+ * buckets whose width doubles with every power of two, each power of two being split into
+ * kSubBucketCount / 2 linear sub-buckets, so any reported value is within 1/64 (about 1.6%) of
+ * the recorded one. Values above the largest trackable value are clamped to it.
+ *
+ * Not thread safe. Expected use is one instance per thread during parallel execution.
+ */
+class BenchRunLatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 7;
+    static constexpr long long kSubBucketCount = 1LL << kSubBucketBits;
+    static constexpr int kMaxValueBits = 40;
+
+    /**
+     * Record one value, in microseconds. Negative values are recorded as zero.
+     */
+    void record(long long micros);
+
+    /**
+     * Conceptually the equivalent of "+=". Adds "other" into this.
+     */
+    void updateFrom(const BenchRunLatencyHistogram& other);
+
+    /**
+     * Returns the smallest recorded value, rounded up to the top of its bucket, such that at
+     * least "percentile" percent of all recorded values are less than or equal to it. Returns 0
+     * if nothing has been recorded.
+     */
+    long long valueAtPercentile(double percentile) const;
+
+    long long getMaxMicros() const {
+        return _maxMicros;
+    }
+
+    unsigned long long getCount() const {
+        return _count;
+    }
+
+    /**
+     * Appends p50, p90, p99, p99.9 and the maximum recorded value to "builder", in
+     * microseconds. The field names avoid '.' so the result can be stored as-is.
+     */
+    void appendPercentiles(BSONObjBuilder* builder) const;
+
+private:
+    static size_t bucketIndexFor(long long micros);
+    static long long highestValueInBucket(size_t index);
+
+    // Allocated on first use, since most counters in a run never see an event.
+    std::vector<unsigned long long> _buckets;
+    unsigned long long _count{0};
+    long long _maxMicros{0};
+};
+
 /**
  * An event counter for events that have an associated duration.
  *
@@ -218,6 +297,11 @@ public:
     void countOne(long long timeMicros) {
         ++_numEvents;
         _totalTimeMicros += timeMicros;
+        _latencies.record(timeMicros);
+    }
+
+    const BenchRunLatencyHistogram& getLatencies() const {
+        return _latencies;
     }
 
     /**
@@ -237,6 +321,7 @@ public:
 private:
     long long _totalTimeMicros{0};
     unsigned long long _numEvents{0};
+    BenchRunLatencyHistogram _latencies;
 };
 
 /**
@@ -251,12 +336,17 @@ private:
  * event, and otherwise, the succes counter will.
  *
  * In all cases, the counter objects must outlive the trace object.
+ *
+ * "lagMicros" is added to the measured duration. Open loop workers pass the amount of time by
+ * which the event started later than it was scheduled to, so that the recorded latency is the one
+ * a client arriving on schedule would have observed.
  */
 class BenchRunEventTrace {
     MONGO_DISALLOW_COPYING(BenchRunEventTrace);
 
 public:
-    explicit BenchRunEventTrace(BenchRunEventCounter* eventCounter) {
+    explicit BenchRunEventTrace(BenchRunEventCounter* eventCounter, long long lagMicros = 0)
+        : _lagMicros(lagMicros) {
         initialize(eventCounter, eventCounter, false);
     }
 
@@ -267,7 +357,7 @@ public:
     }
 
     ~BenchRunEventTrace() {
-        (_succeeded ? _successCounter : _failCounter)->countOne(_timer.micros());
+        (_succeeded ? _successCounter : _failCounter)->countOne(_timer.micros() + _lagMicros);
     }
 
     void succeed() {
@@ -287,6 +377,7 @@ private:
     }
 
     Timer _timer;
+    long long _lagMicros{0};
     BenchRunEventCounter* _successCounter;
     BenchRunEventCounter* _failCounter;
     bool _succeeded;
@@ -309,6 +400,14 @@ struct BenchRunStats {
     BenchRunEventCounter deleteCounter;
     BenchRunEventCounter queryCounter;
     BenchRunEventCounter commandCounter;
+    BenchRunEventCounter aggregateCounter;
+    BenchRunEventCounter changeStreamCounter;
+
+    // Number of change events returned by all "changeStream" ops.
+    unsigned long long changeStreamEventCount{0};
+
+    // Largest amount of time by which an open loop operation started behind its schedule.
+    long long maxScheduleLagMicros{0};
 
     std::map<std::string, long long> opcounters;
     std::vector<BSONObj> trappedErrors;
@@ -40,6 +40,7 @@ enum class MessageCompressor : uint8_t {
     kNoop = 0,
     kSnappy = 1,
     kZlib = 2,
+    kZstd = 3,
     kExtended = 255,
 };
 
@@ -86,6 +87,25 @@ public:
      */
     virtual StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) = 0;
 
+    /*
+     * Returns the identifier of the trained dictionary this compressor can compress against, or
+     * 0 if it has none. Peers advertise these during isMaster compression negotiation, and a
+     * dictionary is only used on a connection once both sides have reported the same identifier.
+     */
+    virtual std::uint32_t getDictionaryId() const {
+        return 0;
+    }
+
+    /*
+     * Like compressData, but compresses against the trained dictionary identified by
+     * getDictionaryId. The output must still be readable by decompressData on a peer that has
+     * loaded the same dictionary. Compressors without a dictionary compress normally.
+     */
+    virtual StatusWith<std::size_t> compressDataWithDictionary(ConstDataRange input,
+                                                               DataRange output) {
+        return compressData(input, output);
+    }
+
     /*
      * This returns the number of bytes passed in the input for compressData
      */
@@ -41,9 +41,16 @@
 #include "mongo/util/log.h"
 #include "mongo/util/net/message.h"
 
+#include <algorithm>
+#include <boost/optional.hpp>
+
 namespace mongo {
 namespace {
 
+// Sub-document of the isMaster request and response mapping compressor names to the identifier of
+// the trained dictionary each side has loaded for it.
+const auto kCompressionDictionariesField = "compressionDictionaries"_sd;
+
 // TODO(JBR): This should be changed so it 's closer to the MSGHEADER View/ConstView classes
 // than this little struct.
 struct CompressionHeader {
@@ -132,7 +139,8 @@ StatusWith<Message> MessageCompressorManager::compressMessage(
     compressionHeader.serialize(&output);
     ConstDataRange input(inputHeader.data(), inputHeader.data() + inputHeader.dataLen());
 
-    auto sws = compressor->compressData(input, output);
+    auto sws = _usesDictionary(compressor) ? compressor->compressDataWithDictionary(input, output)
+                                           : compressor->compressData(input, output);
 
     if (!sws.isOK())
         return sws.getStatus();
@@ -199,6 +207,7 @@ void MessageCompressorManager::clientBegin(BSONObjBuilder* output) {
 
     // We're about to update the compressor list with the negotiation result from the server.
     _negotiated.clear();
+    _withDictionary.clear();
 
     auto& compressorList = _registry->getCompressorNames();
     if (compressorList.size() == 0)
@@ -210,6 +219,22 @@ void MessageCompressorManager::clientBegin(BSONObjBuilder* output) {
         sub.append(e);
     }
     sub.doneFast();
+
+    // Offer every trained dictionary we have loaded. The server only echoes back the ones it has
+    // loaded as well, so older servers and servers with other dictionaries are unaffected.
+    boost::optional<BSONObjBuilder> dictionaries;
+    for (const auto& name : compressorList) {
+        auto compressor = _registry->getCompressor(name);
+        if (!compressor || compressor->getDictionaryId() == 0)
+            continue;
+        if (!dictionaries)
+            dictionaries.emplace(output->subobjStart(kCompressionDictionariesField));
+        LOG(3) << "Offering dictionary " << compressor->getDictionaryId() << " for "
+               << compressor->getName();
+        dictionaries->append(name, static_cast<long long>(compressor->getDictionaryId()));
+    }
+    if (dictionaries)
+        dictionaries->doneFast();
 }
 
 void MessageCompressorManager::clientFinish(const BSONObj& input) {
@@ -235,6 +260,8 @@ void MessageCompressorManager::clientFinish(const BSONObj& input) {
         LOG(3) << "Adding compressor " << ret->getName();
         _negotiated.push_back(ret);
     }
+
+    _negotiateDictionaries(input);
 }
 
 void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuilder* output) {
@@ -253,6 +280,7 @@ void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuil
                 sub.append(algo->getName());
             }
             sub.doneFast();
+            _appendDictionaries(output);
         } else {
             LOG(3) << "Compression negotiation not requested by client";
         }
@@ -262,6 +290,7 @@ void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuil
     // If compression has already been negotiated, then this is a renegotiation, so we should
     // reset the state of the manager.
     _negotiated.clear();
+    _withDictionary.clear();
 
     // First we go through all the compressor names that the client has requested support for
     BSONObj theirObj = elem.Obj();
@@ -292,11 +321,54 @@ void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuil
             sub.append(algo->getName());
         }
         sub.doneFast();
+
+        _negotiateDictionaries(input);
+        _appendDictionaries(output);
     } else {
         LOG(3) << "Could not agree on compressor to use";
     }
 }
 
+void MessageCompressorManager::_negotiateDictionaries(const BSONObj& input) {
+    auto elem = input.getField(kCompressionDictionariesField);
+    if (elem.type() != Object)
+        return;
+
+    for (const auto& e : elem.Obj()) {
+        if (!e.isNumber())
+            continue;
+        auto compressor = _registry->getCompressor(e.fieldNameStringData());
+        if (!compressor || std::find(_negotiated.begin(), _negotiated.end(), compressor) ==
+                _negotiated.end())
+            continue;
+
+        const auto ourId = compressor->getDictionaryId();
+        if (ourId != 0 && static_cast<long long>(ourId) == e.numberLong()) {
+            LOG(3) << "Using dictionary " << ourId << " for " << compressor->getName();
+            _withDictionary.push_back(compressor);
+        } else {
+            LOG(3) << "Peer dictionary " << e.numberLong() << " for " << compressor->getName()
+                   << " does not match ours (" << ourId << ")";
+        }
+    }
+}
+
+void MessageCompressorManager::_appendDictionaries(BSONObjBuilder* output) const {
+    if (_withDictionary.empty())
+        return;
+
+    BSONObjBuilder sub(output->subobjStart(kCompressionDictionariesField));
+    for (auto algo : _withDictionary) {
+        sub.append(algo->getName(), static_cast<long long>(algo->getDictionaryId()));
+    }
+    sub.doneFast();
+}
+
+bool MessageCompressorManager::_usesDictionary(MessageCompressorBase* compressor) const {
+    return std::find(_withDictionary.begin(), _withDictionary.end(), compressor) !=
+        _withDictionary.end();
+}
+
 //ServiceStateMachine::_processMessageеִ
 MessageCompressorManager& MessageCompressorManager::forSession(
     const transport::SessionHandle& session) {
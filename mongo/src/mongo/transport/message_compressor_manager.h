@@ -74,6 +74,9 @@ public:
      * This looks for a BSON array called "compression" with the server's list of
      * requested algorithms. The first algorithm in that array will be used in subsequent calls
      * to compressMessage.
+     *
+     * If the response also carries a "compressionDictionaries" sub-document, compressors whose
+     * dictionary identifier matches ours will compress against their trained dictionary.
      */
     void clientFinish(const BSONObj& input);
 
@@ -86,6 +89,10 @@ public:
      *
      * If no compressors are configured that match those requested by the client, then it will
      * not append anything to the BSONObjBuilder output.
+     *
+     * The client may also send a "compressionDictionaries" sub-document naming the trained
+     * dictionary it has loaded for each compressor. Those matching ours are echoed back and used
+     * for subsequent calls to compressMessage.
      */
     void serverNegotiate(const BSONObj& input, BSONObjBuilder* output);
 
@@ -126,7 +133,18 @@ public:
     static MessageCompressorManager& forSession(const transport::SessionHandle& session);
 
 private:
+    /*
+     * Records which negotiated compressors both sides hold the same trained dictionary for, based
+     * on the "compressionDictionaries" sub-document of the peer's isMaster request or response.
+     */
+    void _negotiateDictionaries(const BSONObj& input);
+
+    void _appendDictionaries(BSONObjBuilder* output) const;
+
+    bool _usesDictionary(MessageCompressorBase* compressor) const;
+
     std::vector<MessageCompressorBase*> _negotiated;
+    std::vector<MessageCompressorBase*> _withDictionary;
     MessageCompressorRegistry* _registry;
 };
 
@@ -31,12 +31,16 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/config.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/message_compressor_noop.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/message_compressor_snappy.h"
 #include "mongo/transport/message_compressor_zlib.h"
+#ifdef MONGO_CONFIG_HAVE_ZSTD
+#include "mongo/transport/message_compressor_zstd.h"
+#endif
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/message.h"
@@ -64,6 +68,56 @@ MessageCompressorRegistry buildRegistry() {
     return ret;
 }
 
+// A noop compressor which reports a trained dictionary and counts how often it was asked to use it.
+class DictionaryNoopCompressor final : public MessageCompressorBase {
+public:
+    explicit DictionaryNoopCompressor(std::uint32_t dictionaryId)
+        : MessageCompressorBase(MessageCompressor::kNoop), _dictionaryId(dictionaryId) {}
+
+    std::size_t getMaxCompressedSize(size_t inputSize) override {
+        return inputSize;
+    }
+
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override {
+        output.write(input).transitional_ignore();
+        return {input.length()};
+    }
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override {
+        output.write(input).transitional_ignore();
+        return {input.length()};
+    }
+
+    std::uint32_t getDictionaryId() const override {
+        return _dictionaryId;
+    }
+
+    StatusWith<std::size_t> compressDataWithDictionary(ConstDataRange input,
+                                                       DataRange output) override {
+        ++dictionaryCompressions;
+        return compressData(input, output);
+    }
+
+    int dictionaryCompressions = 0;
+
+private:
+    const std::uint32_t _dictionaryId;
+};
+
+MessageCompressorRegistry buildDictionaryRegistry(std::uint32_t dictionaryId,
+                                                  DictionaryNoopCompressor** compressorOut) {
+    MessageCompressorRegistry ret;
+    auto compressor = stdx::make_unique<DictionaryNoopCompressor>(dictionaryId);
+    *compressorOut = compressor.get();
+
+    std::vector<std::string> compressorList = {compressor->getName()};
+    ret.setSupportedCompressors(std::move(compressorList));
+    ret.registerImplementation(std::move(compressor));
+    ret.finalizeSupportedCompressors().transitional_ignore();
+
+    return ret;
+}
+
 void checkNegotiationResult(const BSONObj& result, const std::vector<std::string>& algos) {
     auto compressorsList = result.getField("compression");
     if (algos.empty()) {
@@ -218,6 +272,63 @@ TEST(MessageCompressorManager, FullNormalCompression) {
     clientManager.clientFinish(serverObj);
 }
 
+TEST(MessageCompressorManager, MatchingDictionariesAreUsed) {
+    DictionaryNoopCompressor* clientCompressor;
+    DictionaryNoopCompressor* serverCompressor;
+    auto clientRegistry = buildDictionaryRegistry(42, &clientCompressor);
+    auto serverRegistry = buildDictionaryRegistry(42, &serverCompressor);
+    MessageCompressorManager clientManager(&clientRegistry);
+    MessageCompressorManager serverManager(&serverRegistry);
+
+    BSONObjBuilder clientOutput;
+    clientManager.clientBegin(&clientOutput);
+    auto clientObj = clientOutput.done();
+    ASSERT_BSONOBJ_EQ(clientObj["compressionDictionaries"].Obj(), BSON("noop" << 42LL));
+
+    BSONObjBuilder serverOutput;
+    serverManager.serverNegotiate(clientObj, &serverOutput);
+    auto serverObj = serverOutput.done();
+    checkNegotiationResult(serverObj, {"noop"});
+    ASSERT_BSONOBJ_EQ(serverObj["compressionDictionaries"].Obj(), BSON("noop" << 42LL));
+
+    clientManager.clientFinish(serverObj);
+
+    auto testMessage = buildMessage();
+    ASSERT_OK(clientManager.compressMessage(testMessage).getStatus());
+    ASSERT_EQ(clientCompressor->dictionaryCompressions, 1);
+
+    MessageCompressorId compressorId = clientCompressor->getId();
+    ASSERT_OK(serverManager.compressMessage(testMessage, &compressorId).getStatus());
+    ASSERT_EQ(serverCompressor->dictionaryCompressions, 1);
+}
+
+TEST(MessageCompressorManager, MismatchedDictionariesAreNotUsed) {
+    DictionaryNoopCompressor* clientCompressor;
+    DictionaryNoopCompressor* serverCompressor;
+    auto clientRegistry = buildDictionaryRegistry(42, &clientCompressor);
+    auto serverRegistry = buildDictionaryRegistry(43, &serverCompressor);
+    MessageCompressorManager clientManager(&clientRegistry);
+    MessageCompressorManager serverManager(&serverRegistry);
+
+    BSONObjBuilder clientOutput;
+    clientManager.clientBegin(&clientOutput);
+    auto clientObj = clientOutput.done();
+
+    BSONObjBuilder serverOutput;
+    serverManager.serverNegotiate(clientObj, &serverOutput);
+    auto serverObj = serverOutput.done();
+    checkNegotiationResult(serverObj, {"noop"});
+    ASSERT_TRUE(serverObj["compressionDictionaries"].eoo());
+
+    clientManager.clientFinish(serverObj);
+
+    auto testMessage = buildMessage();
+    ASSERT_OK(clientManager.compressMessage(testMessage).getStatus());
+    ASSERT_OK(serverManager.compressMessage(testMessage).getStatus());
+    ASSERT_EQ(clientCompressor->dictionaryCompressions, 0);
+    ASSERT_EQ(serverCompressor->dictionaryCompressions, 0);
+}
+
 TEST(NoopMessageCompressor, Fidelity) {
     auto testMessage = buildMessage();
     checkFidelity(testMessage, stdx::make_unique<NoopMessageCompressor>());
@@ -241,6 +352,22 @@ TEST(ZlibMessageCompressor, Overflow) {
     checkOverflow(stdx::make_unique<ZlibMessageCompressor>());
 }
 
+#ifdef MONGO_CONFIG_HAVE_ZSTD
+TEST(ZstdMessageCompressor, Fidelity) {
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, stdx::make_unique<ZstdMessageCompressor>());
+}
+
+TEST(ZstdMessageCompressor, Overflow) {
+    checkOverflow(stdx::make_unique<ZstdMessageCompressor>());
+}
+
+TEST(ZstdMessageCompressor, RejectsUntrainedDictionary) {
+    auto swCompressor = ZstdMessageCompressor::makeWithDictionary("not a trained dictionary", 3);
+    ASSERT_EQ(swCompressor.getStatus(), ErrorCodes::BadValue);
+}
+#endif
+
 TEST(MessageCompressorManager, SERVER_28008) {
 
     // Create a client and server that will negotiate the same compressors,
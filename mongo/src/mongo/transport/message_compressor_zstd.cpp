@@ -0,0 +1,243 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/message_compressor_zstd.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <zstd.h>
+
+#include "mongo/base/init.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_registry.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+// Level used for messages compressed without a dictionary; 3 is zstd's own default. Dictionaries
+// are digested at the level in effect at startup, so changing this at runtime only affects
+// dictionary-less compression.
+MONGO_EXPORT_SERVER_PARAMETER(zstdCompressionLevel, int, 3);
+
+// Path to a dictionary produced by "zstd --train" on representative wire traffic. The dictionary
+// is only used on connections whose peer reports the same dictionary ID during negotiation.
+std::string zstdCompressionDictionaryPath;
+ExportedServerParameter<std::string, ServerParameterType::kStartupOnly>
+    zstdCompressionDictionaryPathSetting(ServerParameterSet::getGlobal(),
+                                         "zstdCompressionDictionaryPath",
+                                         &zstdCompressionDictionaryPath);
+
+int clampLevel(int level) {
+    return std::max(1, std::min(level, ZSTD_maxCLevel()));
+}
+
+// Compression contexts are expensive to set up, so each thread keeps one of each around rather
+// than allocating them per message.
+struct CCtxDeleter {
+    void operator()(ZSTD_CCtx* ctx) const {
+        ZSTD_freeCCtx(ctx);
+    }
+};
+
+struct DCtxDeleter {
+    void operator()(ZSTD_DCtx* ctx) const {
+        ZSTD_freeDCtx(ctx);
+    }
+};
+
+ZSTD_CCtx* threadCCtx() {
+    thread_local std::unique_ptr<ZSTD_CCtx, CCtxDeleter> ctx(ZSTD_createCCtx());
+    invariant(ctx);
+    return ctx.get();
+}
+
+ZSTD_DCtx* threadDCtx() {
+    thread_local std::unique_ptr<ZSTD_DCtx, DCtxDeleter> ctx(ZSTD_createDCtx());
+    invariant(ctx);
+    return ctx.get();
+}
+
+}  // namespace
+
+struct ZstdMessageCompressor::Dictionary {
+    ~Dictionary() {
+        ZSTD_freeCDict(cdict);
+        ZSTD_freeDDict(ddict);
+    }
+
+    ZSTD_CDict* cdict = nullptr;
+    ZSTD_DDict* ddict = nullptr;
+    unsigned id = 0;
+};
+
+ZstdMessageCompressor::ZstdMessageCompressor() : MessageCompressorBase(MessageCompressor::kZstd) {}
+
+ZstdMessageCompressor::~ZstdMessageCompressor() = default;
+
+StatusWith<std::unique_ptr<ZstdMessageCompressor>> ZstdMessageCompressor::makeWithDictionary(
+    const std::string& dictionary, int level) {
+    const unsigned id = ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+    if (id == 0) {
+        // A raw-content dictionary leaves no ID in the frame header, which would make frames
+        // compressed with and without it indistinguishable on the receiving side.
+        return {ErrorCodes::BadValue,
+                "zstd compression dictionary must be a dictionary produced by 'zstd --train'"};
+    }
+
+    auto dict = stdx::make_unique<Dictionary>();
+    dict->id = id;
+    dict->cdict = ZSTD_createCDict(dictionary.data(), dictionary.size(), clampLevel(level));
+    dict->ddict = ZSTD_createDDict(dictionary.data(), dictionary.size());
+    if (!dict->cdict || !dict->ddict) {
+        return {ErrorCodes::BadValue, "Could not load zstd compression dictionary"};
+    }
+
+    std::unique_ptr<ZstdMessageCompressor> compressor(new ZstdMessageCompressor());
+    compressor->_dictionary = std::move(dict);
+    return {std::move(compressor)};
+}
+
+std::size_t ZstdMessageCompressor::getMaxCompressedSize(size_t inputSize) {
+    return ZSTD_compressBound(inputSize);
+}
+
+std::uint32_t ZstdMessageCompressor::getDictionaryId() const {
+    return _dictionary ? _dictionary->id : 0;
+}
+
+StatusWith<std::size_t> ZstdMessageCompressor::compressData(ConstDataRange input,
+                                                            DataRange output) {
+    size_t ret = ZSTD_compressCCtx(threadCCtx(),
+                                   const_cast<char*>(output.data()),
+                                   output.length(),
+                                   input.data(),
+                                   input.length(),
+                                   clampLevel(zstdCompressionLevel.load()));
+
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not compress input: " << ZSTD_getErrorName(ret)};
+    }
+    counterHitCompress(input.length(), ret);
+    return {ret};
+}
+
+StatusWith<std::size_t> ZstdMessageCompressor::compressDataWithDictionary(ConstDataRange input,
+                                                                          DataRange output) {
+    if (!_dictionary) {
+        return compressData(input, output);
+    }
+
+    size_t ret = ZSTD_compress_usingCDict(threadCCtx(),
+                                          const_cast<char*>(output.data()),
+                                          output.length(),
+                                          input.data(),
+                                          input.length(),
+                                          _dictionary->cdict);
+
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not compress input: " << ZSTD_getErrorName(ret)};
+    }
+    counterHitCompress(input.length(), ret);
+    return {ret};
+}
+
+StatusWith<std::size_t> ZstdMessageCompressor::decompressData(ConstDataRange input,
+                                                              DataRange output) {
+    auto dctx = threadDCtx();
+    const unsigned frameDictId = ZSTD_getDictID_fromFrame(input.data(), input.length());
+    size_t ret;
+    if (frameDictId != 0) {
+        if (!_dictionary || _dictionary->id != frameDictId) {
+            return Status{ErrorCodes::BadValue,
+                          str::stream() << "Compressed message requires zstd dictionary "
+                                        << frameDictId
+                                        << ", which is not loaded"};
+        }
+        ret = ZSTD_decompress_usingDDict(dctx,
+                                         const_cast<char*>(output.data()),
+                                         output.length(),
+                                         input.data(),
+                                         input.length(),
+                                         _dictionary->ddict);
+    } else {
+        ret = ZSTD_decompressDCtx(dctx,
+                                  const_cast<char*>(output.data()),
+                                  output.length(),
+                                  input.data(),
+                                  input.length());
+    }
+
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue, "Compressed message was invalid or corrupted"};
+    }
+
+    counterHitDecompress(input.length(), ret);
+    return {ret};
+}
+
+
+MONGO_INITIALIZER_GENERAL(ZstdMessageCompressorInit,
+                          ("EndStartupOptionHandling"),
+                          ("AllCompressorsRegistered"))
+(InitializerContext* context) {
+    auto& compressorRegistry = MessageCompressorRegistry::get();
+    if (zstdCompressionDictionaryPath.empty()) {
+        compressorRegistry.registerImplementation(stdx::make_unique<ZstdMessageCompressor>());
+        return Status::OK();
+    }
+
+    std::ifstream in(zstdCompressionDictionaryPath, std::ios::binary);
+    if (!in) {
+        return {ErrorCodes::FileNotOpen,
+                str::stream() << "Could not open zstd compression dictionary "
+                              << zstdCompressionDictionaryPath};
+    }
+    const std::string dictionary{std::istreambuf_iterator<char>(in),
+                                 std::istreambuf_iterator<char>()};
+
+    auto swCompressor =
+        ZstdMessageCompressor::makeWithDictionary(dictionary, zstdCompressionLevel.load());
+    if (!swCompressor.isOK()) {
+        return swCompressor.getStatus();
+    }
+
+    log() << "Loaded zstd compression dictionary from " << zstdCompressionDictionaryPath;
+    compressorRegistry.registerImplementation(std::move(swCompressor.getValue()));
+    return Status::OK();
+}
+}  // namespace mongo
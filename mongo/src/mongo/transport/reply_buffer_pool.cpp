@@ -0,0 +1,78 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/reply_buffer_pool.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+namespace {
+// The total capacity of the reply buffers retained by all connections.
+MONGO_EXPORT_SERVER_PARAMETER(maxPooledReplyBufferBytes, long long, 256 * 1024 * 1024);
+
+AtomicInt64 pooledReplyBufferBytes;
+
+const auto getReplyBufferPool = Client::declareDecoration<ReplyBufferPool>();
+}  // namespace
+
+ReplyBufferPool& ReplyBufferPool::get(Client* client) {
+    return getReplyBufferPool(client);
+}
+
+ReplyBufferPool::~ReplyBufferPool() {
+    take();
+}
+
+SharedBuffer ReplyBufferPool::take() {
+    if (_buffer) {
+        pooledReplyBufferBytes.subtractAndFetch(_buffer.capacity());
+    }
+    return std::move(_buffer);
+}
+
+void ReplyBufferPool::recycle(Message sentMessage) {
+    auto buffer = sentMessage.sharedBuffer();
+    sentMessage.reset();
+    if (_buffer || !buffer || buffer.isShared()) {
+        return;
+    }
+
+    const long long capacity = buffer.capacity();
+    if (pooledReplyBufferBytes.addAndFetch(capacity) > maxPooledReplyBufferBytes.load()) {
+        pooledReplyBufferBytes.subtractAndFetch(capacity);
+        return;
+    }
+    _buffer = std::move(buffer);
+}
+
+}  // namespace mongo
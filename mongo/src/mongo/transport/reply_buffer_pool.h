@@ -0,0 +1,74 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/shared_buffer.h"
+
+namespace mongo {
+
+class Client;
+
+/**
+ * Keeps the buffer of the last reply written on a connection so that the next reply can be built
+ * in it, rather than allocating (and repeatedly growing) a new buffer for every command. This
+ * matters most for cursors, whose batches are large and similar in size from one getMore to the
+ * next.
+ *
+ * Each connection retains at most one buffer, and the buffers retained by all connections are
+ * bounded by the maxPooledReplyBufferBytes server parameter. A ReplyBufferPool is only used by the
+ * thread currently running its Client, so it is not synchronized.
+ */
+class ReplyBufferPool {
+    MONGO_DISALLOW_COPYING(ReplyBufferPool);
+
+public:
+    static ReplyBufferPool& get(Client* client);
+
+    ReplyBufferPool() = default;
+    ~ReplyBufferPool();
+
+    /**
+     * Returns the retained buffer, which the caller has sole ownership of, or a null SharedBuffer
+     * if there is none.
+     */
+    SharedBuffer take();
+
+    /**
+     * Retains the buffer of 'sentMessage', which must have been written to the network, if nothing
+     * else references it and it fits within the process-wide limit.
+     */
+    void recycle(Message sentMessage);
+
+private:
+    SharedBuffer _buffer;
+};
+
+}  // namespace mongo
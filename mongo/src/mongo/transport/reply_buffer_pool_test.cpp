@@ -0,0 +1,89 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/reply_buffer_pool.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class ReplyBufferPoolTest : public unittest::Test {
+protected:
+    ReplyBufferPoolTest() : _client(_serviceContext.makeClient("replyBufferPoolTest")) {}
+
+    ReplyBufferPool& pool() {
+        return ReplyBufferPool::get(_client.get());
+    }
+
+private:
+    ServiceContextNoop _serviceContext;
+    ServiceContext::UniqueClient _client;
+};
+
+TEST_F(ReplyBufferPoolTest, IsEmptyInitially) {
+    ASSERT_FALSE(pool().take());
+}
+
+TEST_F(ReplyBufferPoolTest, ReusesBufferOfSentMessage) {
+    auto buffer = SharedBuffer::allocate(1024);
+    const void* const data = buffer.get();
+    pool().recycle(Message(std::move(buffer)));
+
+    auto reused = pool().take();
+    ASSERT_TRUE(reused);
+    ASSERT_FALSE(reused.isShared());
+    ASSERT_EQ(static_cast<const void*>(reused.get()), data);
+    ASSERT_EQ(reused.capacity(), 1024U);
+
+    ASSERT_FALSE(pool().take());
+}
+
+TEST_F(ReplyBufferPoolTest, DoesNotRetainBufferStillReferencedElsewhere) {
+    auto buffer = SharedBuffer::allocate(1024);
+    pool().recycle(Message(buffer));
+    ASSERT_FALSE(pool().take());
+}
+
+TEST_F(ReplyBufferPoolTest, RetainsOnlyOneBuffer) {
+    auto first = SharedBuffer::allocate(1024);
+    const void* const firstData = first.get();
+    pool().recycle(Message(std::move(first)));
+    pool().recycle(Message(SharedBuffer::allocate(2048)));
+
+    auto reused = pool().take();
+    ASSERT_EQ(static_cast<const void*>(reused.get()), firstData);
+    ASSERT_FALSE(pool().take());
+}
+
+}  // namespace
+}  // namespace mongo
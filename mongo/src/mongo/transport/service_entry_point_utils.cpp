@@ -56,10 +56,42 @@ void* runFunc(void* ctx) {
 
     return nullptr;
 }
+
+#if !defined(_WIN32)
+/**
+ * Returns the stack size to request from pthreads for a thread which wants 'stackSize' bytes, or
+ * zero if the stack rlimit is not above it and the thread should get the default stack.
+ */
+size_t stackSizeToSet(size_t stackSize, const struct rlimit& limits) {
+    if (limits.rlim_cur <= stackSize) {
+        return 0;
+    }
+
+#if !__has_feature(address_sanitizer)
+    if (kDebugBuild)
+        stackSize /= 2;
+#endif
+    return stackSize;
+}
+#endif
 }  // namespace
 
+size_t getServiceWorkerThreadStackSize(size_t stackSize) {
+#if defined(_WIN32)
+    // Threads get the default stack reservation of the executable
+    return kDefaultServiceWorkerThreadStackSize;
+#else
+    struct rlimit limits;
+    invariant(getrlimit(RLIMIT_STACK, &limits) == 0);
+    if (auto toSet = stackSizeToSet(stackSize, limits)) {
+        return toSet;
+    }
+    return limits.rlim_cur;
+#endif
+}
+
 //߳
-Status launchServiceWorkerThread(stdx::function<void()> task) {
+Status launchServiceWorkerThread(stdx::function<void()> task, size_t stackSize) {
 
     try {
 #if defined(_WIN32)
@@ -69,18 +101,10 @@ Status launchServiceWorkerThread(stdx::function<void()> task) {
         pthread_attr_init(&attrs);
         pthread_attr_setdetachstate(&attrs, PTHREAD_CREATE_DETACHED);
 
-        static const size_t kStackSize =
-            1024 * 1024;  // if we change this we need to update the warning
-
         struct rlimit limits;
         invariant(getrlimit(RLIMIT_STACK, &limits) == 0);
-        if (limits.rlim_cur > kStackSize) {
-            size_t stackSizeToSet = kStackSize;
-#if !__has_feature(address_sanitizer)
-            if (kDebugBuild)
-                stackSizeToSet /= 2;
-#endif
-            int failed = pthread_attr_setstacksize(&attrs, stackSizeToSet);
+        if (auto toSet = stackSizeToSet(stackSize, limits)) {
+            int failed = pthread_attr_setstacksize(&attrs, toSet);
             if (failed) {
                 const auto ewd = errnoWithDescription(failed);
                 warning() << "pthread_attr_setstacksize failed: " << ewd;
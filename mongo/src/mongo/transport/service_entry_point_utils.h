@@ -33,6 +33,22 @@
 
 namespace mongo {
 
-Status launchServiceWorkerThread(stdx::function<void()> task);
+/**
+ * The stack size given to service worker threads unless their executor asks for another one.
+ */
+constexpr size_t kDefaultServiceWorkerThreadStackSize = 1024 * 1024;
+
+/**
+ * Launches a detached thread running 'task' with a stack of 'stackSize' bytes. The stack size is
+ * only honoured if it is below the stack rlimit, and is ignored on Windows.
+ */
+Status launchServiceWorkerThread(stdx::function<void()> task,
+                                 size_t stackSize = kDefaultServiceWorkerThreadStackSize);
+
+/**
+ * Returns the stack size that launchServiceWorkerThread actually gives a thread when asked for
+ * 'stackSize' bytes, for memory accounting.
+ */
+size_t getServiceWorkerThreadStackSize(size_t stackSize = kDefaultServiceWorkerThreadStackSize);
 
 }  // namespace mongo
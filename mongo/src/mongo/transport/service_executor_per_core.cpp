@@ -0,0 +1,337 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor;
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/service_executor_per_core.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/service_entry_point_utils.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/scopeguard.h"
+
+#include <asio.hpp>
+
+namespace mongo {
+namespace transport {
+namespace {
+
+// The number of worker threads. -1 means one per available core.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(perCoreServiceExecutorThreads, int, -1);
+
+// Whether each worker thread is bound to its own core.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(perCoreServiceExecutorPinThreads, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(perCoreServiceExecutorRecursionLimit, int, 8);
+MONGO_EXPORT_SERVER_PARAMETER(perCoreServiceExecutorIdlePollMillis, int, 10);
+
+constexpr auto kTotalQueued = "totalQueued"_sd;
+constexpr auto kTotalExecuted = "totalExecuted"_sd;
+constexpr auto kLocalTasksQueued = "localTasksQueued"_sd;
+constexpr auto kTasksStolen = "tasksStolen"_sd;
+constexpr auto kThreadsRunning = "threadsRunning"_sd;
+constexpr auto kExecutorLabel = "executor"_sd;
+constexpr auto kExecutorName = "perCore"_sd;
+
+struct ServerParameterOptions : public ServiceExecutorPerCore::Options {
+    int workerThreads() const final {
+        int value = perCoreServiceExecutorThreads;
+        if (value <= 0) {
+            ProcessInfo pi;
+            value = pi.getNumAvailableCores().value_or(pi.getNumCores());
+            value = std::max(value, 1);
+        }
+        return value;
+    }
+
+    bool pinThreads() const final {
+        return perCoreServiceExecutorPinThreads;
+    }
+
+    int recursionLimit() const final {
+        return perCoreServiceExecutorRecursionLimit.load();
+    }
+
+    Milliseconds idlePollInterval() const final {
+        return Milliseconds{std::max(perCoreServiceExecutorIdlePollMillis.load(), 1)};
+    }
+};
+
+/**
+ * Returns the CPUs this process may run on, in the order the kernel numbers them. Consecutive
+ * CPUs usually share a socket, so handing them out in order keeps neighbouring workers on the
+ * same NUMA node. Returns an empty vector where affinity is not supported.
+ */
+std::vector<int> getAllowedCpus() {
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &cpuSet)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+void pinCurrentThreadToCpu(int cpu) {
+#if defined(__linux__)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    if (ret != 0) {
+        warning() << "Failed to pin worker thread to cpu " << cpu << ": "
+                  << errnoWithDescription(ret);
+    }
+#endif
+}
+
+}  // namespace
+
+thread_local ServiceExecutorPerCore::Worker* ServiceExecutorPerCore::_localWorker = nullptr;
+thread_local ServiceExecutorPerCore* ServiceExecutorPerCore::_localExecutor = nullptr;
+
+ServiceExecutorPerCore::ServiceExecutorPerCore(ServiceContext* ctx,
+                                               std::shared_ptr<asio::io_context> ioCtx)
+    : ServiceExecutorPerCore(ctx, std::move(ioCtx), stdx::make_unique<ServerParameterOptions>()) {}
+
+ServiceExecutorPerCore::ServiceExecutorPerCore(ServiceContext* ctx,
+                                               std::shared_ptr<asio::io_context> ioCtx,
+                                               std::unique_ptr<Options> config)
+    : _ioContext(std::move(ioCtx)), _config(std::move(config)) {}
+
+ServiceExecutorPerCore::~ServiceExecutorPerCore() {
+    invariant(!_isRunning.load());
+}
+
+Status ServiceExecutorPerCore::start() {
+    invariant(!_isRunning.load());
+    invariant(_workers.empty());
+    _isRunning.store(true);
+
+    const auto numWorkers = _config->workerThreads();
+    const auto cpus = _config->pinThreads() ? getAllowedCpus() : std::vector<int>();
+
+    for (int i = 0; i < numWorkers; i++) {
+        _workers.emplace_back(stdx::make_unique<Worker>(i));
+    }
+
+    for (int i = 0; i < numWorkers; i++) {
+        Worker* worker = _workers[i].get();
+        const int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+        {
+            stdx::lock_guard<stdx::mutex> lk(_deathMutex);
+            _numRunningWorkers++;
+        }
+
+        const auto launchResult =
+            launchServiceWorkerThread([this, worker, cpu] { _workerThreadRoutine(worker, cpu); });
+        if (!launchResult.isOK()) {
+            // The workers already running can still steal this worker's queue, which stays empty
+            // since only its own thread pushes to it.
+            warning() << "Failed to launch new worker thread: " << launchResult;
+            stdx::lock_guard<stdx::mutex> lk(_deathMutex);
+            _numRunningWorkers--;
+        }
+    }
+
+    return Status::OK();
+}
+
+Status ServiceExecutorPerCore::shutdown(Milliseconds timeout) {
+    if (!_isRunning.load())
+        return Status::OK();
+
+    _isRunning.store(false);
+    _ioContext->stop();
+
+    stdx::unique_lock<stdx::mutex> lk(_deathMutex);
+    bool result = _deathCondition.wait_for(
+        lk, timeout.toSystemDuration(), [&] { return _numRunningWorkers == 0; });
+
+    return result
+        ? Status::OK()
+        : Status(ErrorCodes::Error::ExceededTimeLimit,
+                 "per-core executor couldn't shutdown all worker threads within time limit.");
+}
+
+Status ServiceExecutorPerCore::schedule(Task task, ScheduleFlags flags) {
+    if (!_isRunning.load()) {
+        return {ErrorCodes::ShutdownInProgress, "Executor is not running"};
+    }
+
+    _totalQueued.addAndFetch(1);
+
+    // Tasks scheduled from outside the workers, such as by the listener for a new session, have
+    // no core to stay on and are picked up by whichever worker gets to them first.
+    Worker* worker = (_localExecutor == this) ? _localWorker : nullptr;
+    if (!worker) {
+        _ioContext->post([ this, task = std::move(task) ] { _runTask(_localWorker, task); });
+        return Status::OK();
+    }
+
+    if ((flags & kMayRecurse) && (worker->recursionDepth + 1 < _config->recursionLimit())) {
+        _runTask(worker, std::move(task));
+        return Status::OK();
+    }
+
+    size_t queueDepth;
+    {
+        stdx::lock_guard<stdx::mutex> lk(worker->mutex);
+        worker->runQueue.push_front(std::move(task));
+        queueDepth = worker->runQueue.size();
+    }
+    _localTasksQueued.addAndFetch(1);
+
+    // This worker will get to the task as soon as its current one returns. If others are already
+    // waiting in its queue, wake an idle worker, which will steal them.
+    if (queueDepth > 1) {
+        _ioContext->post([] {});
+    }
+
+    return Status::OK();
+}
+
+void ServiceExecutorPerCore::_runTask(Worker* worker, Task task) {
+    if (worker) {
+        worker->recursionDepth++;
+    }
+    const auto guard = MakeGuard([this, worker] {
+        if (worker) {
+            worker->recursionDepth--;
+        }
+        _totalExecuted.addAndFetch(1);
+    });
+
+    task();
+}
+
+bool ServiceExecutorPerCore::_runLocalOrStolenTask(Worker* worker) {
+    Task task;
+    {
+        stdx::lock_guard<stdx::mutex> lk(worker->mutex);
+        if (!worker->runQueue.empty()) {
+            task = std::move(worker->runQueue.front());
+            worker->runQueue.pop_front();
+        }
+    }
+
+    // Visit the other workers starting from our neighbour, so that thieves spread out rather
+    // than all contending on the first worker's queue.
+    for (size_t i = 1; !task && i < _workers.size(); i++) {
+        Worker* victim = _workers[(worker->index + i) % _workers.size()].get();
+        stdx::lock_guard<stdx::mutex> lk(victim->mutex);
+        if (!victim->runQueue.empty()) {
+            task = std::move(victim->runQueue.back());
+            victim->runQueue.pop_back();
+            _tasksStolen.addAndFetch(1);
+        }
+    }
+
+    if (!task) {
+        return false;
+    }
+
+    _runTask(worker, std::move(task));
+    return true;
+}
+
+void ServiceExecutorPerCore::_workerThreadRoutine(Worker* worker, int cpu) {
+    _localWorker = worker;
+    _localExecutor = this;
+    {
+        std::string threadName = str::stream() << "worker-" << worker->index;
+        setThreadName(threadName);
+    }
+
+    if (cpu >= 0) {
+        pinCurrentThreadToCpu(cpu);
+        log() << "Started new database worker thread " << worker->index << " on cpu " << cpu;
+    } else {
+        log() << "Started new database worker thread " << worker->index;
+    }
+
+    const auto guard = MakeGuard([this] {
+        stdx::lock_guard<stdx::mutex> lk(_deathMutex);
+        _numRunningWorkers--;
+        _deathCondition.notify_one();
+    });
+
+    while (_isRunning.load()) {
+        if (_runLocalOrStolenTask(worker)) {
+            continue;
+        }
+
+        try {
+            asio::io_context::work work(*_ioContext);
+            _ioContext->run_one_for(_config->idlePollInterval().toSystemDuration());
+            if (_ioContext->stopped())
+                _ioContext->restart();
+        } catch (std::exception& e) {
+            log() << "Exception escaped worker thread: " << e.what();
+        } catch (...) {
+            log() << "Unknown exception escaped worker thread.";
+        }
+    }
+}
+
+void ServiceExecutorPerCore::appendStats(BSONObjBuilder* bob) const {
+    size_t threadsRunning;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_deathMutex);
+        threadsRunning = _numRunningWorkers;
+    }
+
+    BSONObjBuilder section(bob->subobjStart("serviceExecutorTaskStats"));
+    section << kExecutorLabel << kExecutorName                //
+            << kTotalQueued << _totalQueued.load()            //
+            << kTotalExecuted << _totalExecuted.load()        //
+            << kLocalTasksQueued << _localTasksQueued.load()  //
+            << kTasksStolen << _tasksStolen.load()            //
+            << kThreadsRunning << static_cast<long long>(threadsRunning);
+    section.doneFast();
+}
+
+}  // namespace transport
+}  // namespace mongo
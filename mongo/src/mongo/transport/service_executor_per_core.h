@@ -0,0 +1,132 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/transport/service_executor.h"
+
+#include <asio.hpp>
+
+namespace mongo {
+namespace transport {
+
+/**
+ * This is an ASIO-based ServiceExecutor with a fixed pool of worker threads, one per available
+ * core, each pinned to its core where the platform supports it.
+ *
+ * Every worker owns a run queue. A task scheduled from a worker thread, which is how a
+ * ServiceStateMachine schedules its next step after running the previous one, goes onto that
+ * worker's queue, so that consecutive steps of a session run on the same core while its working
+ * set is still in cache. Tasks scheduled from other threads are posted to the shared io_context,
+ * which is also where network completions are dispatched. Workers drain their own queue first,
+ * then steal from the back of other workers' queues, and only then wait on the io_context.
+ */
+class ServiceExecutorPerCore final : public ServiceExecutor {
+public:
+    struct Options {
+        virtual ~Options() = default;
+
+        // The number of worker threads to start.
+        virtual int workerThreads() const = 0;
+
+        // Whether worker threads are bound to a single core each.
+        virtual bool pinThreads() const = 0;
+
+        // The maximum depth of tasks run inline by a worker that schedules with kMayRecurse.
+        virtual int recursionLimit() const = 0;
+
+        // How long an idle worker waits on the io_context before checking the run queues again.
+        virtual Milliseconds idlePollInterval() const = 0;
+    };
+
+    explicit ServiceExecutorPerCore(ServiceContext* ctx, std::shared_ptr<asio::io_context> ioCtx);
+    explicit ServiceExecutorPerCore(ServiceContext* ctx,
+                                    std::shared_ptr<asio::io_context> ioCtx,
+                                    std::unique_ptr<Options> config);
+
+    ~ServiceExecutorPerCore();
+
+    Status start() final;
+    Status shutdown(Milliseconds timeout) final;
+    Status schedule(Task task, ScheduleFlags flags) final;
+
+    Mode transportMode() const final {
+        return Mode::kAsynchronous;
+    }
+
+    void appendStats(BSONObjBuilder* bob) const final;
+
+private:
+    struct Worker {
+        explicit Worker(size_t index) : index(index) {}
+
+        const size_t index;
+
+        // Guards 'runQueue'. The owning worker pushes and pops at the front, so the most recently
+        // scheduled and most cache-warm task runs next, while other workers steal from the back.
+        stdx::mutex mutex;
+        std::deque<Task> runQueue;
+
+        // Only touched by the worker's own thread.
+        int recursionDepth = 0;
+    };
+
+    void _workerThreadRoutine(Worker* worker, int cpu);
+    bool _runLocalOrStolenTask(Worker* worker);
+    void _runTask(Worker* worker, Task task);
+
+    static thread_local Worker* _localWorker;
+    static thread_local ServiceExecutorPerCore* _localExecutor;
+
+    std::shared_ptr<asio::io_context> _ioContext;
+    std::unique_ptr<Options> _config;
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    AtomicBool _isRunning{false};
+
+    mutable stdx::mutex _deathMutex;
+    stdx::condition_variable _deathCondition;
+    size_t _numRunningWorkers = 0;
+
+    AtomicWord<int64_t> _totalQueued{0};
+    AtomicWord<int64_t> _totalExecuted{0};
+    AtomicWord<int64_t> _localTasksQueued{0};
+    AtomicWord<int64_t> _tasksStolen{0};
+};
+
+}  // namespace transport
+}  // namespace mongo
@@ -47,10 +47,20 @@ namespace {
 // value.
 MONGO_EXPORT_SERVER_PARAMETER(synchronousServiceExecutorRecursionLimit, int, 8);
 
+// Stack size of the thread serving each connection. With tens of thousands of connections, the
+// stacks make up much of a mongod's memory, so lowering this trades headroom for deep recursion
+// (e.g. in nested query or document parsing) for a smaller footprint per connection.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(synchronousServiceExecutorThreadStackSizeKB,
+                                      int,
+                                      kDefaultServiceWorkerThreadStackSize / 1024);
+constexpr int kMinThreadStackSizeKB = 256;
+
 //ǰ߳Ҳǵǰconn߳
 constexpr auto kThreadsRunning = "threadsRunning"_sd;
 constexpr auto kExecutorLabel = "executor"_sd;
 constexpr auto kExecutorName = "passthrough"_sd;
+constexpr auto kThreadStackSize = "threadStackSizeBytes"_sd;
+constexpr auto kThreadStacksTotal = "threadStacksTotalBytes"_sd;
 }  // namespace
 
 //̼߳ıֻԱsessionӦ߳
@@ -70,6 +80,15 @@ Status ServiceExecutorSynchronous::start() {
         return static_cast<size_t>(p.getNumCores());
     }();
 
+    auto stackSizeKB = synchronousServiceExecutorThreadStackSizeKB;
+    if (stackSizeKB < kMinThreadStackSizeKB) {
+        warning() << "synchronousServiceExecutorThreadStackSizeKB of " << stackSizeKB
+                  << " is too small, using " << kMinThreadStackSizeKB;
+        stackSizeKB = kMinThreadStackSizeKB;
+    }
+    _threadStackSize = static_cast<size_t>(stackSizeKB) * 1024;
+    _effectiveThreadStackSize = getServiceWorkerThreadStackSize(_threadStackSize);
+
     _stillRunning.store(true);
 
     return Status::OK();
@@ -156,7 +175,7 @@ Status ServiceExecutorSynchronous::schedule(Task task, ScheduleFlags flags) {
     log() << "Starting new executor thread in passthrough mode";
 
 	//conṇ߳߳conn-xxִжӦtask
-    Status status = launchServiceWorkerThread([ this, task = std::move(task) ] {
+    auto workerRoutine = [ this, task = std::move(task) ] {
 		//func̻߳ص
 	
         int ret = _numRunningWorkerThreads.addAndFetch(1);
@@ -189,9 +208,9 @@ Status ServiceExecutorSynchronous::schedule(Task task, ScheduleFlags flags) {
 		//ͻ˶ӦӶϿʱߵ
 		LOG(3) << "Starting new executor thread in passthrough mode yang tesst end ";
 		//log() << "Starting new executor thread in passthrough mode yang tesst end ";
-    });
+    };
 
-    return status;
+    return launchServiceWorkerThread(std::move(workerRoutine), _threadStackSize);
 }
 
 /*
@@ -222,8 +241,11 @@ mongos> db.serverStatus().network
 */ 
 void ServiceExecutorSynchronous::appendStats(BSONObjBuilder* bob) const {
     BSONObjBuilder section(bob->subobjStart("serviceExecutorTaskStats"));
+    const auto threadsRunning = _numRunningWorkerThreads.loadRelaxed();
     section << kExecutorLabel << kExecutorName << kThreadsRunning
-            << static_cast<int>(_numRunningWorkerThreads.loadRelaxed());
+            << static_cast<int>(threadsRunning) << kThreadStackSize
+            << static_cast<long long>(_effectiveThreadStackSize) << kThreadStacksTotal
+            << static_cast<long long>(threadsRunning * _effectiveThreadStackSize);
 }
 
 }  // namespace transport
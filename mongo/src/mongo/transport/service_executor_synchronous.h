@@ -87,7 +87,11 @@ thread_local int64_t ServiceExecutorSynchronous::_localThreadIdleCounter = 0;
     //ǰconn߳οServiceExecutorSynchronous::schedul 
     //ע⣬Ǹȫֵģʾжٸ̣߳ǰ_localWorkQueue̼߳
     AtomicWord<size_t> _numRunningWorkerThreads{0};
-    size_t _numHardwareCores{0}; //cpu
+    size_t _numHardwareCores{0};
+
+    // The stack size requested for worker threads, and the one they actually get
+    size_t _threadStackSize{0};
+    size_t _effectiveThreadStackSize{0}; //cpu
 };
 
 }  // namespace transport
@@ -34,6 +34,7 @@
 
 #include "mongo/db/service_context_noop.h"
 #include "mongo/transport/service_executor_adaptive.h"
+#include "mongo/transport/service_executor_per_core.h"
 #include "mongo/transport/service_executor_synchronous.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
@@ -93,6 +94,39 @@ protected:
     std::shared_ptr<asio::io_context> asioIOCtx;
 };
 
+struct PerCoreTestOptions : public ServiceExecutorPerCore::Options {
+    int workerThreads() const final {
+        return 2;
+    }
+
+    bool pinThreads() const final {
+        return false;
+    }
+
+    int recursionLimit() const final {
+        return 0;
+    }
+
+    Milliseconds idlePollInterval() const final {
+        return Milliseconds{5};
+    }
+};
+
+class ServiceExecutorPerCoreFixture : public unittest::Test {
+protected:
+    void setUp() override {
+        auto scOwned = stdx::make_unique<ServiceContextNoop>();
+        setGlobalServiceContext(std::move(scOwned));
+        asioIOCtx = std::make_shared<asio::io_context>();
+
+        executor = stdx::make_unique<ServiceExecutorPerCore>(
+            getGlobalServiceContext(), asioIOCtx, stdx::make_unique<PerCoreTestOptions>());
+    }
+
+    std::unique_ptr<ServiceExecutorPerCore> executor;
+    std::shared_ptr<asio::io_context> asioIOCtx;
+};
+
 class ServiceExecutorSynchronousFixture : public unittest::Test {
 protected:
     void setUp() override {
@@ -134,6 +168,40 @@ TEST_F(ServiceExecutorAdaptiveFixture, ScheduleFailsBeforeStartup) {
     scheduleBasicTask(executor.get(), false);
 }
 
+TEST_F(ServiceExecutorPerCoreFixture, BasicTaskRuns) {
+    ASSERT_OK(executor->start());
+    auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(Milliseconds{500})); });
+
+    scheduleBasicTask(executor.get(), true);
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, ScheduleFailsBeforeStartup) {
+    scheduleBasicTask(executor.get(), false);
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, TaskScheduledFromWorkerRuns) {
+    ASSERT_OK(executor->start());
+    auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(Milliseconds{500})); });
+
+    // A task scheduled from a worker thread goes onto that worker's own run queue, and must
+    // still run, either on the same worker or on one that steals it.
+    stdx::condition_variable cond;
+    stdx::mutex mutex;
+    bool ran = false;
+    auto innerTask = [&] {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        ran = true;
+        cond.notify_all();
+    };
+    auto outerTask = [&] {
+        ASSERT_OK(executor->schedule(innerTask, ServiceExecutor::kEmptyFlags));
+    };
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    ASSERT_OK(executor->schedule(outerTask, ServiceExecutor::kEmptyFlags));
+    ASSERT_TRUE(cond.wait_for(lk, stdx::chrono::seconds(10), [&] { return ran; }));
+}
+
 TEST_F(ServiceExecutorSynchronousFixture, BasicTaskRuns) {
     ASSERT_OK(executor->start());
     auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(Milliseconds{500})); });
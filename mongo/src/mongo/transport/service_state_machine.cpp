@@ -35,9 +35,12 @@
 #include "mongo/config.h"
 #include "mongo/db/client.h"
 #include "mongo/db/dbmessage.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/traffic_recorder.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/message_compressor_manager.h"
+#include "mongo/transport/reply_buffer_pool.h"
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/ticket.h"
@@ -55,6 +58,11 @@
 
 namespace mongo {
 namespace {
+
+// Whether to let the transport hold back partially filled packets between the replies of an
+// exhaust cursor, which are sent back to back without waiting on the client.
+MONGO_EXPORT_SERVER_PARAMETER(coalesceExhaustReplies, bool, false);
+
 //ʹExhaust͵cursormongoһһķزѯclient֮ǰstream
 // Set up proper headers for formatting an exhaust request, if we need to
 bool setExhaustMessage(Message* m, const DbResponse& dbresponse) {
@@ -89,6 +97,31 @@ bool setExhaustMessage(Message* m, const DbResponse& dbresponse) {
     return true;
 }
 
+// Set up the next request of an OP_MSG exhaust stream, if the command asked for one. The reply
+// that triggered it is flagged kMoreToCome so the client keeps reading without sending anything.
+// Each batch is only produced once the previous reply has been written out, so a slow reader
+// throttles the stream through TCP backpressure rather than having batches pile up in memory.
+bool setOpMsgExhaustMessage(Message* m, DbResponse* dbresponse) {
+    if (!dbresponse->shouldRunAgainForExhaust) {
+        return false;
+    }
+
+    // The next request is always built afresh: rewriting the header of the client's message in
+    // place would invalidate its checksum, if it had one.
+    invariant(dbresponse->nextInvocation);
+    OpMsg next;
+    next.body = *dbresponse->nextInvocation;
+    *m = next.serialize();
+
+    // The next reply answers this one, which is how the client ties the stream together.
+    m->header().setId(dbresponse->response.header().getId());
+    m->header().setResponseToMsgId(dbresponse->response.header().getResponseToMsgId());
+    OpMsg::setFlag(m, OpMsg::kExhaustSupported);
+
+    OpMsg::setFlag(&dbresponse->response, OpMsg::kMoreToCome);
+    return true;
+}
+
 }  // namespace
 
 using transport::ServiceExecutor;
@@ -390,7 +423,14 @@ void ServiceStateMachine::_sinkMessage(ThreadGuard guard, Message toSink) {
 	//boost-asioݷͼص
     if (_transportMode == transport::Mode::kSynchronous) {
 		//ASIOSinkTicketݳɹִ_sinkCallback
-        _sinkCallback(_session()->getTransportLayer()->wait(std::move(ticket)));
+        auto status = _session()->getTransportLayer()->wait(std::move(ticket));
+
+        // The reply has been written, so the next reply on this connection can be built in its
+        // buffer. This thread still holds the Client unless the guard gave it back to the SSM.
+        if (haveClient()) {
+            ReplyBufferPool::get(Client::getCurrent()).recycle(std::move(toSink));
+        }
+        _sinkCallback(status);
     } else if (_transportMode == transport::Mode::kAsynchronous) {
 		//ASIOSinkTicketݳɹִ_sinkCallback
 		_session()->getTransportLayer()->asyncWait(
@@ -528,6 +568,7 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
 
 	//
     networkCounter.hitLogicalIn(_inMessage.size());
+    TrafficRecorder::get(_serviceContext).observe(_session(), _inMessage, false);
 
     // Pass sourced Message to handler to generate response.
     //ȡһΨһUniqueOperationContextһͻ˶ӦһUniqueOperationContext
@@ -549,16 +590,23 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
         invariant(!OpMsg::isFlagSet(_inMessage, OpMsg::kMoreToCome));
         toSink.header().setId(nextMessageId());
         toSink.header().setResponseToMsgId(_inMessage.header().getId());
+        TrafficRecorder::get(_serviceContext).observe(_session(), toSink, true);
 
         // If this is an exhaust cursor, don't source more Messages
         //3.6.1汾ExhaustûԲ_inExhaust = true;
         if (dbresponse.exhaustNS.size() > 0 && setExhaustMessage(&_inMessage, dbresponse)) {
-            _inExhaust = true;  
+            _inExhaust = true;
+        } else if (_inMessage.operation() == dbMsg &&
+                   setOpMsgExhaustMessage(&_inMessage, &dbresponse)) {
+            _inExhaust = true;
         } else {
             _inExhaust = false;
             _inMessage.reset();
         }
 
+        // The last reply of an exhaust stream clears the hint, which flushes it immediately.
+        _session()->setCoalesceWrites(_inExhaust && coalesceExhaustReplies.load());
+
         networkCounter.hitLogicalOut(toSink.size());
 
         if (_compressorId) {
@@ -749,6 +797,7 @@ void ServiceStateMachine::_cleanupSession(ThreadGuard guard) {
     _state.store(State::Ended);
 
     _inMessage.reset();
+    TrafficRecorder::get(_serviceContext).observeEnd(_session());
 
     // By ignoring the return value of Client::releaseCurrent() we destroy the session.
     // _dbClient is now nullptr and _dbClientPtr is invalid and should never be accessed.
@@ -67,6 +67,9 @@ public:
         _ranHandler = true;
         ASSERT_TRUE(haveClient());
 
+        if (_handler)
+            return _handler(request);
+
         auto req = OpMsgRequest::parse(request);
         ASSERT_BSONOBJ_EQ(BSON("ping" << 1), req.body);
 
@@ -98,6 +101,10 @@ public:
         _uassertInHandler = true;
     }
 
+    void setHandler(stdx::function<DbResponse(const Message&)> handler) {
+        _handler = std::move(handler);
+    }
+
     bool ranHandler() {
         bool ret = _ranHandler;
         _ranHandler = false;
@@ -107,6 +114,7 @@ public:
 private:
     bool _uassertInHandler = false;
     bool _ranHandler = false;
+    stdx::function<DbResponse(const Message&)> _handler;
 };
 
 using namespace transport;
@@ -127,9 +135,13 @@ public:
             return TransportLayer::TicketSessionClosedStatus;
         }
 
-        OpMsgBuilder builder;
-        builder.setBody(BSON("ping" << 1));
-        *message = builder.finish();
+        if (!_toSource.empty()) {
+            *message = _toSource;
+        } else {
+            OpMsgBuilder builder;
+            builder.setBody(BSON("ping" << 1));
+            *message = builder.finish();
+        }
 
         return TransportLayerMock::sourceMessage(session, message, expiration);
     }
@@ -196,12 +208,18 @@ public:
         _waitHook = std::move(hook);
     }
 
+    // Sourced instead of a ping request
+    void setMessageToSource(Message message) {
+        _toSource = std::move(message);
+    }
+
 private:
     bool _lastTicketSource = true;
     bool _ranSink = false;
     bool _ranSource = false;
     FailureMode _nextShouldFail = Nothing;
     Message _lastSunk;
+    Message _toSource;
     ServiceStateMachine* _ssm;
     stdx::function<void()> _waitHook;
 };
@@ -573,5 +591,100 @@ TEST_F(ServiceStateMachineFixture, SSMRunsRecursively) {
     ASSERT_EQ(_ssm->state(), State::Ended);
 }
 
+// Answers a cursor command the way runCommands does for an OP_MSG exhaust request, asking for
+// 'nBatches' replies in all, and records the commands it ran.
+stdx::function<DbResponse(const Message&)> makeExhaustHandler(std::vector<BSONObj>* handled,
+                                                              size_t nBatches) {
+    return [handled, nBatches](const Message& request) {
+        ASSERT(OpMsg::isFlagSet(request, OpMsg::kExhaustSupported));
+        handled->push_back(OpMsgRequest::parse(request).body.getOwned());
+
+        DbResponse response{
+            buildRequest(BSON("ok" << 1 << "batch" << static_cast<int>(handled->size())))};
+        if (handled->size() < nBatches) {
+            response.shouldRunAgainForExhaust = true;
+            response.nextInvocation =
+                BSON("getMore" << 1LL << "collection"
+                               << "coll"
+                               << "$db"
+                               << "test");
+        }
+        return response;
+    };
+}
+
+TEST_F(ServiceStateMachineFixture, ExhaustRequestStreamsRepliesUntilTheCursorIsDone) {
+    auto request = buildRequest(BSON("find"
+                                     << "coll"
+                                     << "$db"
+                                     << "test"));
+    OpMsg::setFlag(&request, OpMsg::kExhaustSupported);
+    _tl->setMessageToSource(request);
+
+    std::vector<BSONObj> handled;
+    _sep->setHandler(makeExhaustHandler(&handled, 3));
+
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Process);
+
+    // Every reply but the last is streamed without sourcing another request.
+    std::vector<Message> replies;
+    for (auto expectedState : {State::Process, State::Process, State::Source}) {
+        _ssm->runNext();
+        ASSERT_EQ(_ssm->state(), expectedState);
+        replies.push_back(_tl->getLastSunk());
+    }
+
+    ASSERT_EQ(handled.size(), 3UL);
+    ASSERT_EQ(handled[0].firstElement().fieldNameStringData(), "find"_sd);
+    ASSERT_EQ(handled[1].firstElement().fieldNameStringData(), "getMore"_sd);
+    ASSERT_EQ(handled[2].firstElement().fieldNameStringData(), "getMore"_sd);
+
+    // The first reply answers the client's request, and each later one answers the previous one.
+    ASSERT_EQ(replies[0].header().getResponseToMsgId(), request.header().getId());
+    for (size_t i = 0; i < replies.size(); ++i) {
+        ASSERT_EQ(OpMsg::parse(replies[i]).body["batch"].numberInt(), static_cast<int>(i + 1));
+        ASSERT_EQ(OpMsg::isFlagSet(replies[i], OpMsg::kMoreToCome), i + 1 < replies.size());
+        if (i > 0) {
+            ASSERT_EQ(replies[i].header().getResponseToMsgId(), replies[i - 1].header().getId());
+        }
+    }
+}
+
+TEST_F(ServiceStateMachineFixture, ChecksummedExhaustGetMoreStreamsReplies) {
+    auto request = buildRequest(BSON("getMore" << 1LL << "collection"
+                                               << "coll"
+                                               << "$db"
+                                               << "test"));
+    OpMsg::setFlag(&request, OpMsg::kExhaustSupported);
+    OpMsg::appendChecksum(&request);
+    _tl->setMessageToSource(request);
+
+    // The handler parses every request it is given, which verifies any checksum.
+    std::vector<BSONObj> handled;
+    _sep->setHandler(makeExhaustHandler(&handled, 3));
+
+    _ssm->runNext();
+    for (auto expectedState : {State::Process, State::Process, State::Source}) {
+        _ssm->runNext();
+        ASSERT_EQ(_ssm->state(), expectedState);
+    }
+    ASSERT_EQ(handled.size(), 3UL);
+}
+
+TEST_F(ServiceStateMachineFixture, RequestWithoutExhaustIsAnsweredOnce) {
+    _tl->setMessageToSource(buildRequest(BSON("find"
+                                              << "coll"
+                                              << "$db"
+                                              << "test")));
+    _sep->setHandler([](const Message& request) {
+        ASSERT_FALSE(OpMsg::isFlagSet(request, OpMsg::kExhaustSupported));
+        return DbResponse{buildRequest(BSON("ok" << 1))};
+    });
+
+    runPingTest(State::Process, State::Source);
+    ASSERT_FALSE(OpMsg::isFlagSet(_tl->getLastSunk(), OpMsg::kMoreToCome));
+}
+
 }  // namespace
 }  // namespace mongo
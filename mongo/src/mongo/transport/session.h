@@ -123,6 +123,13 @@ public:
      */
     virtual const HostAndPort& local() const = 0;
 
+    /**
+     * Hints that further replies will be sunk right after the next one, so that the transport
+     * may hold back partially filled packets and send consecutive replies together. Clearing the
+     * hint flushes anything held back. The default implementation ignores the hint.
+     */
+    virtual void setCoalesceWrites(bool coalesce) {}
+
     /**
      * Atomically set all of the session tags specified in the 'tagsToSet' bit field. If the
      * 'kPending' tag is set, indicating that no tags have yet been specified for the session, this
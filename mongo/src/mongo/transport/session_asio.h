@@ -30,6 +30,11 @@
 
 #include <utility>
 
+#ifdef __linux__
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#endif
+
 #include "mongo/base/system_error.h"
 #include "mongo/config.h"
 #include "mongo/transport/asio_utils.h"
@@ -73,6 +78,7 @@ public:
         auto family = endpointToSockAddr(_socket.local_endpoint()).getType();
         //
         if (family == AF_INET || family == AF_INET6) {
+            _isTcp = true;
             //no_delay keep_alive׽ϵͳ
             _socket.set_option(asio::ip::tcp::no_delay(true));
             _socket.set_option(asio::socket_base::keep_alive(true));
@@ -103,6 +109,25 @@ public:
         return _local;
     }
 
+    void setCoalesceWrites(bool coalesce) override {
+#ifdef TCP_CORK
+        if (!_isTcp || coalesce == _coalesceWrites) {
+            return;
+        }
+
+        // While corked, the kernel only sends full segments, so consecutive replies share
+        // packets. Uncorking flushes whatever is left immediately.
+        int optval = coalesce ? 1 : 0;
+        if (::setsockopt(
+                getSocket().native_handle(), IPPROTO_TCP, TCP_CORK, &optval, sizeof(optval)) != 0) {
+            LOG(3) << "Unable to set TCP_CORK on connection " << id() << ": "
+                   << errnoWithDescription();
+            return;
+        }
+        _coalesceWrites = coalesce;
+#endif
+    }
+
     //ȡӶӦϢ
     GenericSocket& getSocket() {
 #ifdef MONGO_CONFIG_SSL
@@ -347,6 +372,11 @@ private:
     //ֵTransportLayerASIO::_acceptConnection
     //Ҳfd
     GenericSocket _socket;
+
+    // Whether '_socket' is a TCP socket, and whether it is currently corked by
+    // setCoalesceWrites().
+    bool _isTcp = false;
+    bool _coalesceWrites = false;
 #ifdef MONGO_CONFIG_SSL
     boost::optional<asio::ssl::stream<decltype(_socket)>> _sslSocket;
     bool _ranHandshake = false;
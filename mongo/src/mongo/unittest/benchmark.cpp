@@ -0,0 +1,399 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/unittest/benchmark.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+
+#if !defined(_WIN32)
+#include <time.h>
+#endif
+
+#include "mongo/stdx/chrono.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/barrier.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/debug_util.h"
+#include "mongo/util/stringutils.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace benchmark {
+
+namespace {
+
+const std::int64_t kMaxIterations = 1000 * 1000 * 1000;
+
+std::int64_t nowRealNanos() {
+    return stdx::chrono::duration_cast<stdx::chrono::nanoseconds>(
+               stdx::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+std::int64_t nowThreadCpuNanos() {
+#if defined(_WIN32)
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return 0;
+    }
+    auto toHundredsOfNanos = [](const FILETIME& time) {
+        return (static_cast<std::int64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    };
+    return (toHundredsOfNanos(kernelTime) + toHundredsOfNanos(userTime)) * 100;
+#else
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return static_cast<std::int64_t>(ts.tv_sec) * 1000 * 1000 * 1000 + ts.tv_nsec;
+#endif
+}
+
+std::vector<std::unique_ptr<Benchmark>>& registeredBenchmarks() {
+    static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+    return benchmarks;
+}
+
+struct Result {
+    std::string name;
+    std::int64_t iterations = 0;
+    int threads = 1;
+    double realNanosPerIteration = 0;
+    double cpuNanosPerIteration = 0;
+    double itemsPerSecond = 0;
+    double bytesPerSecond = 0;
+    std::string label;
+};
+
+void printConsoleHeader(std::ostream& out) {
+    out << std::left << std::setw(50) << "Benchmark" << std::right << std::setw(15) << "Time (ns)"
+        << std::setw(15) << "CPU (ns)" << std::setw(15) << "Iterations" << std::endl;
+    out << std::string(95, '-') << std::endl;
+}
+
+void printConsoleResult(std::ostream& out, const Result& result) {
+    out << std::left << std::setw(50) << result.name << std::right << std::fixed
+        << std::setprecision(1) << std::setw(15) << result.realNanosPerIteration << std::setw(15)
+        << result.cpuNanosPerIteration << std::setw(15) << result.iterations;
+    if (result.itemsPerSecond > 0) {
+        out << "  " << std::setprecision(0) << result.itemsPerSecond << " items/s";
+    }
+    if (result.bytesPerSecond > 0) {
+        out << "  " << std::setprecision(0) << result.bytesPerSecond << " bytes/s";
+    }
+    if (!result.label.empty()) {
+        out << "  " << result.label;
+    }
+    out << std::endl;
+}
+
+// The layout follows Google Benchmark's JSON reporter so existing tooling can compare results.
+void printJSON(std::ostream& out, const std::vector<Result>& results) {
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << dateToISOStringUTC(Date_t::now()) << "\",\n";
+    out << "    \"num_cpus\": " << stdx::thread::hardware_concurrency() << ",\n";
+    out << "    \"library_build_type\": \"" << (kDebugBuild ? "debug" : "release") << "\"\n";
+    out << "  },\n";
+    out << "  \"benchmarks\": [";
+
+    bool first = true;
+    for (const auto& result : results) {
+        out << (first ? "\n" : ",\n");
+        first = false;
+
+        out << "    {\n";
+        out << "      \"name\": \"" << escape(result.name) << "\",\n";
+        out << "      \"iterations\": " << result.iterations << ",\n";
+        out << "      \"threads\": " << result.threads << ",\n";
+        out << std::fixed << std::setprecision(3);
+        out << "      \"real_time\": " << result.realNanosPerIteration << ",\n";
+        out << "      \"cpu_time\": " << result.cpuNanosPerIteration << ",\n";
+        if (result.itemsPerSecond > 0) {
+            out << "      \"items_per_second\": " << result.itemsPerSecond << ",\n";
+        }
+        if (result.bytesPerSecond > 0) {
+            out << "      \"bytes_per_second\": " << result.bytesPerSecond << ",\n";
+        }
+        if (!result.label.empty()) {
+            out << "      \"label\": \"" << escape(result.label) << "\",\n";
+        }
+        out << "      \"time_unit\": \"ns\"\n";
+        out << "    }";
+    }
+
+    out << "\n  ]\n";
+    out << "}\n";
+}
+
+}  // namespace
+
+/**
+ * Expands the registered benchmarks into their argument and thread combinations, and runs them.
+ */
+class Runner {
+public:
+    struct Instance {
+        const Benchmark* benchmark;
+        std::vector<std::int64_t> args;
+        int threads;
+        std::string name;
+    };
+
+    static std::vector<Instance> getInstances(const std::string& filter) {
+        std::vector<Instance> instances;
+
+        for (const auto& benchmark : registeredBenchmarks()) {
+            auto argSets = benchmark->_args;
+            if (argSets.empty()) {
+                argSets.emplace_back();
+            }
+
+            auto threadCounts = benchmark->_threads;
+            if (threadCounts.empty()) {
+                threadCounts.push_back(1);
+            }
+
+            for (const auto& args : argSets) {
+                for (int threads : threadCounts) {
+                    std::string name = benchmark->_name;
+                    for (auto arg : args) {
+                        name += "/" + std::to_string(arg);
+                    }
+                    if (!benchmark->_threads.empty()) {
+                        name += "/threads:" + std::to_string(threads);
+                    }
+
+                    if (name.find(filter) != std::string::npos) {
+                        instances.push_back({benchmark.get(), args, threads, std::move(name)});
+                    }
+                }
+            }
+        }
+
+        return instances;
+    }
+
+    /**
+     * Runs the instance with increasing iteration counts until it takes at least 'minTime'.
+     */
+    static Result run(const Instance& instance, double minTime) {
+        std::int64_t iterations = 1;
+
+        while (true) {
+            std::vector<std::unique_ptr<State>> states;
+            for (int i = 0; i < instance.threads; ++i) {
+                states.push_back(
+                    stdx::make_unique<State>(iterations, instance.args, i, instance.threads));
+            }
+
+            if (instance.threads == 1) {
+                instance.benchmark->_function(*states[0]);
+            } else {
+                unittest::Barrier barrier(instance.threads);
+                std::vector<stdx::thread> threads;
+                for (auto& state : states) {
+                    threads.emplace_back([&barrier, &instance, &state] {
+                        barrier.countDownAndWait();
+                        instance.benchmark->_function(*state);
+                    });
+                }
+                for (auto& thread : threads) {
+                    thread.join();
+                }
+            }
+
+            double realNanos = 0;
+            double cpuNanos = 0;
+            double items = 0;
+            double bytes = 0;
+            for (const auto& state : states) {
+                // A benchmark which returns early would silently report a meaningless time.
+                invariant(state->_finished);
+                realNanos += state->_realNanos;
+                cpuNanos += state->_cpuNanos;
+                items += state->_itemsProcessed;
+                bytes += state->_bytesProcessed;
+            }
+            realNanos /= instance.threads;
+            cpuNanos /= instance.threads;
+
+            const double seconds = realNanos / 1e9;
+            if (seconds >= minTime || iterations >= kMaxIterations) {
+                Result result;
+                result.name = instance.name;
+                result.iterations = iterations;
+                result.threads = instance.threads;
+                result.realNanosPerIteration = realNanos / iterations;
+                result.cpuNanosPerIteration = cpuNanos / iterations;
+                if (seconds > 0) {
+                    result.itemsPerSecond = items / seconds;
+                    result.bytesPerSecond = bytes / seconds;
+                }
+                result.label = states[0]->_label;
+                return result;
+            }
+
+            // Aim past the minimum time so the next run is likely the last, but grow slowly
+            // while the current estimate is based on a very short run.
+            double multiplier = minTime * 1.4 / std::max(seconds, 1e-9);
+            if (seconds / minTime <= 0.1) {
+                multiplier = std::min(10.0, multiplier);
+            }
+            if (multiplier <= 1.0) {
+                multiplier = 2.0;
+            }
+            iterations = std::min(
+                kMaxIterations,
+                std::max(static_cast<std::int64_t>(iterations * multiplier), iterations + 1));
+        }
+    }
+};
+
+State::State(std::int64_t maxIterations,
+             const std::vector<std::int64_t>& args,
+             int threadIndex,
+             int threads)
+    : _maxIterations(maxIterations),
+      _remaining(maxIterations),
+      _args(args),
+      _threadIndex(threadIndex),
+      _threads(threads) {}
+
+void State::_start() {
+    _started = true;
+    _realStart = nowRealNanos();
+    _cpuStart = nowThreadCpuNanos();
+}
+
+void State::_finish() {
+    _remaining = 0;
+    if (_finished) {
+        return;
+    }
+    _finished = true;
+    if (_started && !_paused) {
+        _realNanos += nowRealNanos() - _realStart;
+        _cpuNanos += nowThreadCpuNanos() - _cpuStart;
+    }
+}
+
+void State::pauseTiming() {
+    invariant(_started && !_paused);
+    _realNanos += nowRealNanos() - _realStart;
+    _cpuNanos += nowThreadCpuNanos() - _cpuStart;
+    _paused = true;
+}
+
+void State::resumeTiming() {
+    invariant(_paused);
+    _paused = false;
+    _realStart = nowRealNanos();
+    _cpuStart = nowThreadCpuNanos();
+}
+
+std::int64_t State::range(std::size_t index) const {
+    invariant(index < _args.size());
+    return _args[index];
+}
+
+Benchmark::Benchmark(std::string name, Function function)
+    : _name(std::move(name)), _function(std::move(function)) {}
+
+Benchmark* Benchmark::arg(std::int64_t value) {
+    _args.push_back({value});
+    return this;
+}
+
+Benchmark* Benchmark::args(std::vector<std::int64_t> values) {
+    _args.push_back(std::move(values));
+    return this;
+}
+
+Benchmark* Benchmark::range(std::int64_t low, std::int64_t high, std::int64_t multiplier) {
+    invariant(low > 0 && low <= high && multiplier > 1);
+    for (std::int64_t value = low; value <= high; value *= multiplier) {
+        arg(value);
+    }
+    return this;
+}
+
+Benchmark* Benchmark::threads(int count) {
+    invariant(count > 0);
+    _threads.push_back(count);
+    return this;
+}
+
+Benchmark* registerBenchmark(std::string name, Benchmark::Function function) {
+    registeredBenchmarks().push_back(
+        stdx::make_unique<Benchmark>(std::move(name), std::move(function)));
+    return registeredBenchmarks().back().get();
+}
+
+std::vector<std::string> listBenchmarks(const std::string& filter) {
+    std::vector<std::string> names;
+    for (const auto& instance : Runner::getInstances(filter)) {
+        names.push_back(instance.name);
+    }
+    return names;
+}
+
+int runBenchmarks(const RunOptions& options) {
+    auto instances = Runner::getInstances(options.filter);
+
+    if (options.console) {
+        printConsoleHeader(*options.console);
+    }
+
+    std::vector<Result> results;
+    for (const auto& instance : instances) {
+        for (int i = 0; i < options.repetitions; ++i) {
+            results.push_back(Runner::run(instance, options.minTime));
+            if (options.console) {
+                printConsoleResult(*options.console, results.back());
+            }
+        }
+    }
+
+    if (options.json) {
+        printJSON(*options.json, results);
+    }
+
+    return instances.size();
+}
+
+void _doNotOptimizeAway(const void* ptr) {}
+
+}  // namespace benchmark
+}  // namespace mongo
@@ -0,0 +1,268 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/stdx/functional.h"
+
+/**
+ * A minimal microbenchmark harness modelled on Google Benchmark.
+ *
+ * A benchmark is a function taking a State which runs the code under test once per iteration of
+ * its keepRunning() loop. The harness picks the number of iterations so that each benchmark runs
+ * for at least --minTime seconds, and reports the real and CPU time per iteration.
+ *
+ *     void BM_appendInt(benchmark::State& state) {
+ *         while (state.keepRunning()) {
+ *             BSONObjBuilder bob;
+ *             for (int64_t i = 0; i < state.range(0); ++i)
+ *                 bob.append("a", 1);
+ *             benchmark::doNotOptimize(bob.done());
+ *         }
+ *         state.setItemsProcessed(state.iterations() * state.range(0));
+ *     }
+ *     BENCHMARK(BM_appendInt)->arg(1)->arg(100);
+ *
+ * Benchmarks are built with env.CppBenchmark(), installed to build/benchmarks/ and linked with
+ * benchmark_main, which supports --filter, --minTime, --list and --format=json for regression
+ * tracking.
+ */
+
+namespace mongo {
+namespace benchmark {
+
+/**
+ * The per-thread state of a running benchmark.
+ */
+class State {
+    MONGO_DISALLOW_COPYING(State);
+
+public:
+    State(std::int64_t maxIterations,
+          const std::vector<std::int64_t>& args,
+          int threadIndex,
+          int threads);
+
+    /**
+     * Returns true while more iterations should be run. The timer starts on the first call and
+     * stops on the call which returns false.
+     */
+    bool keepRunning() {
+        if (_remaining-- > 0) {
+            if (!_started) {
+                _start();
+            }
+            return true;
+        }
+        _finish();
+        return false;
+    }
+
+    /**
+     * Stop and restart the timer around per-iteration setup which should not be measured.
+     */
+    void pauseTiming();
+    void resumeTiming();
+
+    /**
+     * Returns the index'th argument given with Benchmark::arg() or Benchmark::args().
+     */
+    std::int64_t range(std::size_t index = 0) const;
+
+    std::int64_t iterations() const {
+        return _maxIterations;
+    }
+
+    int threadIndex() const {
+        return _threadIndex;
+    }
+
+    int threads() const {
+        return _threads;
+    }
+
+    /**
+     * Report throughput in addition to the time per iteration, as totals over all iterations.
+     */
+    void setItemsProcessed(std::int64_t items) {
+        _itemsProcessed = items;
+    }
+    void setBytesProcessed(std::int64_t bytes) {
+        _bytesProcessed = bytes;
+    }
+
+    /**
+     * Attach a free form note to the result, such as a parameter which is not an argument.
+     */
+    void setLabel(std::string label) {
+        _label = std::move(label);
+    }
+
+private:
+    friend class Runner;
+
+    void _start();
+    void _finish();
+
+    const std::int64_t _maxIterations;
+    std::int64_t _remaining;
+    const std::vector<std::int64_t>& _args;
+    const int _threadIndex;
+    const int _threads;
+
+    bool _started = false;
+    bool _finished = false;
+    bool _paused = false;
+
+    // Accumulated measurements, in nanoseconds
+    std::int64_t _realNanos = 0;
+    std::int64_t _cpuNanos = 0;
+
+    // Clock readings when the timer was last started
+    std::int64_t _realStart = 0;
+    std::int64_t _cpuStart = 0;
+
+    std::int64_t _itemsProcessed = 0;
+    std::int64_t _bytesProcessed = 0;
+    std::string _label;
+};
+
+/**
+ * A registered benchmark function and the argument sets and thread counts to run it with. Each
+ * combination is run and reported separately, named like "BM_name/arg1/arg2/threads:4".
+ */
+class Benchmark {
+    MONGO_DISALLOW_COPYING(Benchmark);
+
+public:
+    using Function = stdx::function<void(State&)>;
+
+    Benchmark(std::string name, Function function);
+
+    /**
+     * Add an argument set with a single argument, available as state.range(0).
+     */
+    Benchmark* arg(std::int64_t value);
+
+    /**
+     * Add an argument set with several arguments, available as state.range(0), state.range(1)...
+     */
+    Benchmark* args(std::vector<std::int64_t> values);
+
+    /**
+     * For every power of 'multiplier' between 'low' and 'high' inclusive, add a single argument.
+     */
+    Benchmark* range(std::int64_t low, std::int64_t high, std::int64_t multiplier = 8);
+
+    /**
+     * Run the benchmark concurrently in 'count' threads, each with its own State. May be given
+     * more than once to compare different thread counts.
+     */
+    Benchmark* threads(int count);
+
+private:
+    friend class Runner;
+
+    std::string _name;
+    Function _function;
+    std::vector<std::vector<std::int64_t>> _args;
+    std::vector<int> _threads;
+};
+
+/**
+ * Registers a benchmark. Use the BENCHMARK macro instead.
+ */
+Benchmark* registerBenchmark(std::string name, Benchmark::Function function);
+
+struct RunOptions {
+    // Only run benchmarks whose full name contains this substring
+    std::string filter;
+
+    // Minimum time, in seconds, each benchmark must run for its result to be accepted
+    double minTime = 0.5;
+
+    // Number of times each benchmark is run and reported
+    int repetitions = 1;
+
+    // Prints one line per result to 'console', and if non-null, a JSON document to 'json'
+    std::ostream* console = nullptr;
+    std::ostream* json = nullptr;
+};
+
+/**
+ * Returns the names of all registered benchmarks, including their argument and thread suffixes.
+ */
+std::vector<std::string> listBenchmarks(const std::string& filter);
+
+/**
+ * Runs every registered benchmark matching the filter. Returns the number of benchmarks run.
+ */
+int runBenchmarks(const RunOptions& options);
+
+void _doNotOptimizeAway(const void* ptr);
+
+/**
+ * Prevents the compiler from optimizing away the computation of 'value'.
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    _doNotOptimizeAway(&value);
+#endif
+}
+
+/**
+ * Prevents the compiler from assuming memory is unchanged across this point.
+ */
+inline void clobberMemory() {
+#if defined(__GNUC__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+}  // namespace benchmark
+}  // namespace mongo
+
+#define MONGO_BENCHMARK_CONCAT_INNER_(a, b) a##b
+#define MONGO_BENCHMARK_CONCAT_(a, b) MONGO_BENCHMARK_CONCAT_INNER_(a, b)
+
+/**
+ * Registers FUNCTION as a benchmark. The result may be configured with ->arg() and ->threads().
+ */
+#define BENCHMARK(FUNCTION)                                                            \
+    static ::mongo::benchmark::Benchmark* const MONGO_BENCHMARK_CONCAT_(_mongoBenchmark, \
+                                                                       __LINE__) =     \
+        ::mongo::benchmark::registerBenchmark(#FUNCTION, FUNCTION)
@@ -0,0 +1,132 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "mongo/base/initializer.h"
+#include "mongo/base/status.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/util/options_parser/environment.h"
+#include "mongo/util/options_parser/option_section.h"
+#include "mongo/util/options_parser/options_parser.h"
+#include "mongo/util/signal_handlers_synchronous.h"
+
+using mongo::Status;
+
+int main(int argc, char** argv, char** envp) {
+    ::mongo::clearSignalMask();
+    ::mongo::setupSynchronousSignalHandlers();
+    ::mongo::runGlobalInitializersOrDie(argc, argv, envp);
+
+    namespace moe = ::mongo::optionenvironment;
+    moe::OptionsParser parser;
+    moe::Environment environment;
+    moe::OptionSection options;
+    std::map<std::string, std::string> env;
+
+    // Register our allowed options with our OptionSection
+    auto listDesc = "List all benchmarks in this binary.";
+    options.addOptionChaining("list", "list", moe::Switch, listDesc).setDefault(moe::Value(false));
+
+    auto filterDesc = "Benchmark name filter. Specify a substring of the benchmark names.";
+    options.addOptionChaining("filter", "filter", moe::String, filterDesc);
+
+    auto minTimeDesc = "Minimum number of seconds each benchmark runs for.";
+    options.addOptionChaining("minTime", "minTime", moe::Double, minTimeDesc)
+        .setDefault(moe::Value(0.5));
+
+    auto repetitionsDesc = "Number of times each benchmark is run and reported.";
+    options.addOptionChaining("repetitions", "repetitions", moe::Int, repetitionsDesc)
+        .setDefault(moe::Value(1));
+
+    auto formatDesc = "Output format on stdout, either 'console' or 'json'.";
+    options.addOptionChaining("format", "format", moe::String, formatDesc)
+        .setDefault(moe::Value(std::string("console")));
+
+    auto outDesc = "Also write the results as JSON to this file, for regression tracking.";
+    options.addOptionChaining("out", "out", moe::String, outDesc);
+
+    std::vector<std::string> argVector(argv, argv + argc);
+    Status ret = parser.run(options, argVector, env, &environment);
+    if (!ret.isOK()) {
+        std::cerr << ret.reason() << std::endl;
+        std::cerr << options.helpString();
+        return EXIT_FAILURE;
+    }
+
+    bool list = false;
+    std::string format;
+    std::string out;
+    ::mongo::benchmark::RunOptions runOptions;
+    // "list", "minTime", "repetitions" and "format" will be assigned with default values.
+    invariantOK(environment.get("list", &list));
+    invariantOK(environment.get("minTime", &runOptions.minTime));
+    invariantOK(environment.get("repetitions", &runOptions.repetitions));
+    invariantOK(environment.get("format", &format));
+    // The default values of "filter" and "out" are empty.
+    environment.get("filter", &runOptions.filter).ignore();
+    environment.get("out", &out).ignore();
+
+    if (list) {
+        for (const auto& name : ::mongo::benchmark::listBenchmarks(runOptions.filter)) {
+            std::cout << name << std::endl;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (format == "json") {
+        runOptions.json = &std::cout;
+    } else if (format == "console") {
+        runOptions.console = &std::cout;
+    } else {
+        std::cerr << "--format must be 'console' or 'json'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream outFile;
+    if (!out.empty()) {
+        outFile.open(out, std::ios_base::out | std::ios_base::trunc);
+        if (!outFile.is_open()) {
+            std::cerr << "Failed to open '" << out << "' for writing" << std::endl;
+            return EXIT_FAILURE;
+        }
+        runOptions.json = &outFile;
+    }
+
+    if (::mongo::benchmark::runBenchmarks(runOptions) == 0) {
+        std::cerr << "No benchmarks matched the filter '" << runOptions.filter << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
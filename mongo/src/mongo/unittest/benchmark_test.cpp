@@ -0,0 +1,90 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/unittest/benchmark.h"
+
+#include <sstream>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+int numThreadsSeen = 0;
+
+void BM_benchmarkTestArgs(benchmark::State& state) {
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(state.range(0) + state.range(1));
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_benchmarkTestArgs)->args({1, 2})->args({3, 4});
+
+void BM_benchmarkTestThreads(benchmark::State& state) {
+    if (state.threadIndex() == 0) {
+        numThreadsSeen = state.threads();
+    }
+    while (state.keepRunning()) {
+        benchmark::clobberMemory();
+    }
+}
+BENCHMARK(BM_benchmarkTestThreads)->range(8, 64)->threads(3);
+
+TEST(BenchmarkTest, ListsEveryArgumentAndThreadCombination) {
+    auto names = benchmark::listBenchmarks("BM_benchmarkTest");
+    std::vector<std::string> expected{"BM_benchmarkTestArgs/1/2",
+                                      "BM_benchmarkTestArgs/3/4",
+                                      "BM_benchmarkTestThreads/8/threads:3",
+                                      "BM_benchmarkTestThreads/64/threads:3"};
+    ASSERT(names == expected);
+
+    ASSERT_EQ(1U, benchmark::listBenchmarks("Args/3").size());
+}
+
+TEST(BenchmarkTest, RunsMatchingBenchmarksAndReportsJSON) {
+    std::ostringstream console;
+    std::ostringstream json;
+    benchmark::RunOptions options;
+    options.filter = "BM_benchmarkTest";
+    options.minTime = 0.01;
+    options.console = &console;
+    options.json = &json;
+
+    ASSERT_EQ(4, benchmark::runBenchmarks(options));
+    ASSERT_EQ(3, numThreadsSeen);
+
+    ASSERT_NE(std::string::npos, console.str().find("BM_benchmarkTestArgs/1/2"));
+    ASSERT_NE(std::string::npos,
+              json.str().find("\"name\": \"BM_benchmarkTestThreads/64/threads:3\""));
+    ASSERT_NE(std::string::npos, json.str().find("\"items_per_second\""));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -31,6 +31,7 @@
 
 #include "mongo/util/concurrency/ticketholder.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "mongo/util/log.h"
@@ -112,6 +113,10 @@ bool TicketHolder::waitForTicketUntil(Date_t until) {
 
 void TicketHolder::release() {
     _check(sem_post(&_sem));
+    _numReleased.fetchAndAdd(1);
+    if (_numQueued.load() > 0) {
+        _handOffToQueuedWaiter();
+    }
 }
 
 //checkTicketNumbersеãСTicketHolder::_outof = newSize
@@ -130,8 +135,11 @@ Status TicketHolder::resize(int newSize) {
                                     << newSize);
 
     while (_outof.load() < newSize) {
-        release();
+        _check(sem_post(&_sem));
         _outof.fetchAndAdd(1);
+        if (_numQueued.load() > 0) {
+            _handOffToQueuedWaiter();
+        }
     }
 
     while (_outof.load() > newSize) {
@@ -188,28 +196,43 @@ void TicketHolder::release() {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
         _num++;
     }
+    _numReleased.fetchAndAdd(1);
+    if (_numQueued.load() > 0) {
+        _handOffToQueuedWaiter();
+    }
     _newTicket.notify_one();
 }
 
 Status TicketHolder::resize(int newSize) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    int added = 0;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
 
-    int used = _outof.load() - _num;
-    if (used > newSize) {
-        std::stringstream ss;
-        ss << "can't resize since we're using (" << used << ") "
-           << "more than newSize(" << newSize << ")";
+        int used = _outof.load() - _num;
+        if (used > newSize) {
+            std::stringstream ss;
+            ss << "can't resize since we're using (" << used << ") "
+               << "more than newSize(" << newSize << ")";
 
-        std::string errmsg = ss.str();
-        log() << errmsg;
-        return Status(ErrorCodes::BadValue, errmsg);
-    }
+            std::string errmsg = ss.str();
+            log() << errmsg;
+            return Status(ErrorCodes::BadValue, errmsg);
+        }
+
+        added = newSize - _outof.load();
 
-    _outof.store(newSize);
-    _num = _outof.load() - used;
+        _outof.store(newSize);
+        _num = _outof.load() - used;
+
+        // Potentially wasteful, but easier to see is correct
+        _newTicket.notify_all();
+    }
 
-    // Potentially wasteful, but easier to see is correct
-    _newTicket.notify_all();
+    // Hand tickets over outside of _mutex, which _handOffToQueuedWaiter() takes while holding
+    // _queueMutex.
+    for (int i = 0; i < added && _numQueued.load() > 0; ++i) {
+        _handOffToQueuedWaiter();
+    }
     return Status::OK();
 }
 
@@ -236,4 +259,97 @@ bool TicketHolder::_tryAcquire() {
     return true;
 }
 #endif
+
+namespace {
+// Pass increment for each priority when one of its waiters is woken, i.e. 64 / weight.
+const unsigned long long kStride[] = {64, 16, 4};
+}  // namespace
+
+struct TicketHolder::Waiter {
+    stdx::condition_variable cv;
+
+    // Set by the thread that removed this waiter from its queue and acquired a ticket for it.
+    bool granted = false;
+};
+
+void TicketHolder::waitForTicket(Priority priority) {
+    invariant(waitForTicketUntil(priority, Date_t::max()));
+}
+
+bool TicketHolder::waitForTicketUntil(Priority priority, Date_t until) {
+    if (_numQueued.load() == 0 && tryAcquire()) {
+        return true;
+    }
+
+    const auto idx = static_cast<size_t>(priority);
+    invariant(idx < kNumPriorities);
+
+    Waiter waiter;
+    stdx::unique_lock<stdx::mutex> lk(_queueMutex);
+    _numQueued.fetchAndAdd(1);
+
+    auto& queue = _queues[idx];
+    if (queue.empty()) {
+        // Don't let a class that was idle catch up on the turns it did not need.
+        _pass[idx] = std::max(_pass[idx], _globalPass);
+    }
+    queue.push_back(&waiter);
+
+    // Releasers return the ticket before checking _numQueued, so a release that does not see
+    // this waiter is visible to the tryAcquire() below. Any later release hands its ticket over
+    // under _queueMutex, so no ticket is left unused while this waiter sleeps.
+    bool acquired = tryAcquire();
+    while (!acquired && !waiter.granted) {
+        if (until == Date_t::max()) {
+            waiter.cv.wait(lk);
+        } else if (Date_t::now() >= until) {
+            break;
+        } else {
+            waiter.cv.wait_until(lk, until.toSystemTimePoint());
+        }
+    }
+
+    if (waiter.granted) {
+        acquired = true;
+    } else {
+        queue.erase(std::find(queue.begin(), queue.end(), &waiter));
+    }
+    _numQueued.subtractAndFetch(1);
+    return acquired;
+}
+
+void TicketHolder::_handOffToQueuedWaiter() {
+    stdx::lock_guard<stdx::mutex> lk(_queueMutex);
+    bool queued = false;
+    for (auto&& queue : _queues) {
+        queued = queued || !queue.empty();
+    }
+    if (!queued || !tryAcquire()) {
+        return;
+    }
+
+    auto waiter = _popNextWaiter_inlock();
+    waiter->granted = true;
+    waiter->cv.notify_one();
+}
+
+TicketHolder::Waiter* TicketHolder::_popNextWaiter_inlock() {
+    // Iterate from the highest priority down so that it wins ties.
+    size_t next = kNumPriorities;
+    for (size_t i = kNumPriorities; i-- > 0;) {
+        if (!_queues[i].empty() && (next == kNumPriorities || _pass[i] < _pass[next])) {
+            next = i;
+        }
+    }
+    if (next == kNumPriorities) {
+        return nullptr;
+    }
+
+    _globalPass = _pass[next];
+    _pass[next] += kStride[next];
+
+    auto waiter = _queues[next].front();
+    _queues[next].pop_front();
+    return waiter;
+}
 }
@@ -30,6 +30,9 @@
 #include <semaphore.h>
 #endif
 
+#include <array>
+#include <deque>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -43,6 +46,13 @@ class TicketHolder {
     MONGO_DISALLOW_COPYING(TicketHolder);
 
 public:
+    /**
+     * Admission priority of a waiter. When tickets are scarce, queued waiters are woken by
+     * weighted fair queueing, so each class gets a share of the released tickets proportional to
+     * its weight (1, 4 and 16 respectively) and no class is starved.
+     */
+    enum class Priority { kLow, kNormal, kHigh, kNumPriorities };
+
     explicit TicketHolder(int num);
     ~TicketHolder();
 
@@ -52,6 +62,14 @@ public:
 
     bool waitForTicketUntil(Date_t until);
 
+    /**
+     * Like waitForTicket() and waitForTicketUntil(), but when no ticket is available the caller
+     * is queued by 'priority' instead of racing every other waiter for the next release.
+     */
+    void waitForTicket(Priority priority);
+
+    bool waitForTicketUntil(Priority priority, Date_t until);
+
     void release();
 
     Status resize(int newSize);
@@ -62,6 +80,22 @@ public:
 
     int outof() const;
 
+    /**
+     * Returns the number of tickets returned through release() since construction. Sampling this
+     * periodically gives the rate at which ticket holders complete their work.
+     */
+    long long numReleased() const {
+        return _numReleased.load();
+    }
+
+    /**
+     * Returns the number of threads queued in waitForTicket(Priority) or
+     * waitForTicketUntil(Priority, Date_t).
+     */
+    int numQueued() const {
+        return _numQueued.load();
+    }
+
 private:
 #if defined(__linux__)
     mutable sem_t _sem;
@@ -78,6 +112,30 @@ private:
     stdx::mutex _mutex;
     stdx::condition_variable _newTicket;
 #endif
+
+    AtomicInt64 _numReleased{0};
+
+    struct Waiter;
+
+    static constexpr size_t kNumPriorities = static_cast<size_t>(Priority::kNumPriorities);
+
+    // Called after a ticket has been returned while threads are queued. Moves an available
+    // ticket, if any, to the next queued waiter and wakes it.
+    void _handOffToQueuedWaiter();
+
+    Waiter* _popNextWaiter_inlock();
+
+    // Number of threads inside waitForTicketUntil(Priority, Date_t) that did not get a ticket on
+    // their first attempt. Releasers only take _queueMutex when this is non-zero.
+    AtomicInt32 _numQueued{0};
+
+    stdx::mutex _queueMutex;
+    std::array<std::deque<Waiter*>, kNumPriorities> _queues;
+
+    // Stride scheduling state: the queue with the lowest pass is served next, and serving it
+    // advances its pass by the inverse of its weight.
+    std::array<unsigned long long, kNumPriorities> _pass{};
+    unsigned long long _globalPass = 0;
 };
 
 class ScopedTicket {
@@ -31,8 +31,13 @@
 
 #include "mongo/platform/basic.h"
 
+#include <vector>
+
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/time_support.h"
 
 namespace {
 using namespace mongo;
@@ -71,4 +76,70 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+TEST(TicketholderTest, CountsReleasedTicketsButNotResizes) {
+    TicketHolder holder(5);
+    ASSERT_EQ(holder.numReleased(), 0);
+
+    {
+        ScopedTicket first(&holder);
+        ScopedTicket second(&holder);
+    }
+    ASSERT_EQ(holder.numReleased(), 2);
+
+    ASSERT_OK(holder.resize(10));
+    ASSERT_OK(holder.resize(6));
+    ASSERT_EQ(holder.outof(), 6);
+    ASSERT_EQ(holder.numReleased(), 2);
+}
+
+TEST(TicketholderTest, QueuedWaitersAreWokenByPriority) {
+    TicketHolder holder(1);
+    ASSERT(holder.tryAcquire());
+
+    stdx::mutex mutex;
+    std::vector<TicketHolder::Priority> order;
+    auto waitFor = [&](TicketHolder::Priority priority) {
+        return stdx::thread([&holder, &mutex, &order, priority] {
+            holder.waitForTicket(priority);
+            {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                order.push_back(priority);
+            }
+            holder.release();
+        });
+    };
+    auto waitUntilQueued = [&](int numQueued) {
+        while (holder.numQueued() < numQueued) {
+            sleepmillis(1);
+        }
+    };
+
+    auto low = waitFor(TicketHolder::Priority::kLow);
+    waitUntilQueued(1);
+    auto high = waitFor(TicketHolder::Priority::kHigh);
+    waitUntilQueued(2);
+
+    holder.release();
+    low.join();
+    high.join();
+
+    ASSERT_EQ(order.size(), 2U);
+    ASSERT(order[0] == TicketHolder::Priority::kHigh);
+    ASSERT(order[1] == TicketHolder::Priority::kLow);
+    ASSERT_EQ(holder.numQueued(), 0);
+    ASSERT_EQ(holder.available(), 1);
+}
+
+TEST(TicketholderTest, QueuedWaiterTimesOut) {
+    TicketHolder holder(1);
+    ASSERT(holder.tryAcquire());
+    ASSERT_FALSE(
+        holder.waitForTicketUntil(TicketHolder::Priority::kHigh, Date_t::now() + Milliseconds(5)));
+    ASSERT_EQ(holder.numQueued(), 0);
+
+    holder.release();
+    ASSERT(holder.waitForTicketUntil(TicketHolder::Priority::kLow, Date_t::now()));
+    holder.release();
+}
 }  // namespace
@@ -0,0 +1,130 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/crc32c.h"
+
+#include <cstring>
+
+#include "mongo/platform/endian.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MONGO_CRC32C_HAVE_SSE42
+#include <nmmintrin.h>
+#endif
+
+namespace mongo {
+namespace {
+
+// The reflected form of the Castagnoli polynomial 0x1EDC6F41.
+const uint32_t kPolynomial = 0x82F63B78;
+
+/**
+ * Lookup tables for processing eight bytes at a time ("slicing-by-8"). 'table[0]' is the classic
+ * byte-at-a-time table, and 'table[k][b]' is the CRC of byte 'b' followed by 'k' zero bytes.
+ */
+struct SlicingTables {
+    SlicingTables() {
+        for (uint32_t b = 0; b < 256; ++b) {
+            uint32_t crc = b;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (kPolynomial & (0 - (crc & 1)));
+            }
+            table[0][b] = crc;
+        }
+        for (uint32_t b = 0; b < 256; ++b) {
+            for (int k = 1; k < 8; ++k) {
+                table[k][b] = (table[k - 1][b] >> 8) ^ table[0][table[k - 1][b] & 0xFF];
+            }
+        }
+    }
+
+    uint32_t table[8][256];
+};
+
+uint32_t crc32cSoftware(const uint8_t* p, size_t len, uint32_t crc) {
+    static const SlicingTables tables;
+    const auto& t = tables.table;
+
+    while (len >= 8) {
+        uint32_t low;
+        uint32_t high;
+        std::memcpy(&low, p, sizeof(low));
+        std::memcpy(&high, p + 4, sizeof(high));
+        low = endian::littleToNative(low) ^ crc;
+        high = endian::littleToNative(high);
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^
+            t[4][low >> 24] ^ t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^
+            t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+        p += 8;
+        len -= 8;
+    }
+    while (len--) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+#ifdef MONGO_CRC32C_HAVE_SSE42
+__attribute__((target("sse4.2"))) uint32_t crc32cSse42(const uint8_t* p, size_t len, uint32_t crc) {
+    uint64_t crc64 = crc;
+    while (len >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        p += 8;
+        len -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+    while (len--) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return crc;
+}
+#endif
+
+using Crc32cFunction = uint32_t (*)(const uint8_t*, size_t, uint32_t);
+
+Crc32cFunction chooseImplementation() {
+#ifdef MONGO_CRC32C_HAVE_SSE42
+    if (__builtin_cpu_supports("sse4.2")) {
+        return crc32cSse42;
+    }
+#endif
+    return crc32cSoftware;
+}
+
+}  // namespace
+
+uint32_t crc32c(const void* data, size_t len, uint32_t crc) {
+    static const Crc32cFunction implementation = chooseImplementation();
+    return ~implementation(static_cast<const uint8_t*>(data), len, ~crc);
+}
+
+}  // namespace mongo
@@ -0,0 +1,46 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mongo {
+
+/**
+ * Returns the CRC-32C (Castagnoli) checksum of the 'len' bytes at 'data'. To checksum data in
+ * pieces, pass the checksum of the preceding bytes as 'crc' and the result is the same as for the
+ * concatenation.
+ *
+ * Uses the SSE 4.2 crc32 instruction when built for x86-64 and the processor supports it, and a
+ * table driven implementation otherwise.
+ */
+uint32_t crc32c(const void* data, size_t len, uint32_t crc = 0);
+
+}  // namespace mongo
@@ -0,0 +1,78 @@
+/**
+*    Copyright (C) 2018 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include <cstring>
+#include <vector>
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/crc32c.h"
+
+namespace mongo {
+namespace {
+
+TEST(Crc32cTest, MatchesKnownValues) {
+    // Check values from RFC 3720, appendix B.4, and the common "123456789" test vector.
+    std::vector<uint8_t> bytes(32, 0);
+    ASSERT_EQ(crc32c(bytes.data(), bytes.size()), 0x8A9136AAU);
+
+    std::memset(bytes.data(), 0xFF, bytes.size());
+    ASSERT_EQ(crc32c(bytes.data(), bytes.size()), 0x62A8AB43U);
+
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = i;
+    }
+    ASSERT_EQ(crc32c(bytes.data(), bytes.size()), 0x46DD794EU);
+
+    ASSERT_EQ(crc32c("123456789", 9), 0xE3069283U);
+}
+
+TEST(Crc32cTest, EmptyInputLeavesChecksumUnchanged) {
+    ASSERT_EQ(crc32c(nullptr, 0), 0U);
+    ASSERT_EQ(crc32c(nullptr, 0, 0x12345678), 0x12345678U);
+}
+
+TEST(Crc32cTest, ChecksumInPiecesMatchesWholeAtEveryAlignment) {
+    std::vector<uint8_t> bytes(300);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<uint8_t>(i * 131 + 7);
+    }
+
+    for (size_t start = 0; start < 16; ++start) {
+        const size_t len = bytes.size() - start;
+        const uint32_t whole = crc32c(bytes.data() + start, len);
+        for (size_t split = 0; split <= len; split += 7) {
+            const uint32_t head = crc32c(bytes.data() + start, split);
+            ASSERT_EQ(crc32c(bytes.data() + start + split, len - split, head), whole);
+        }
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -33,19 +33,22 @@
 #include "mongo/util/net/op_msg.h"
 
 #include <bitset>
+#include <cstring>
 #include <set>
 
 #include "mongo/base/data_type_endian.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/rpc/object_check.h"
 #include "mongo/util/bufreader.h"
+#include "mongo/util/crc32c.h"
 #include "mongo/util/hex.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
 namespace {
 
-auto kAllSupportedFlags = OpMsg::kChecksumPresent | OpMsg::kMoreToCome;
+auto kAllSupportedFlags =
+    OpMsg::kChecksumPresent | OpMsg::kMoreToCome | OpMsg::kExhaustSupported;
 
 //OP_MSG flagЧԼ  OpMsg::parse  flagֻܶkAllSupportedFlagsλвλ˲ֱӱ
 //οhttps://docs.mongodb.com/manual/reference/mongodb-wire-protocol/#wire-msg-sections
@@ -54,6 +57,13 @@ bool containsUnknownRequiredFlags(uint32_t flags) {
     return (flags & ~kAllSupportedFlags & kRequiredFlagMask) != 0;
 }
 
+constexpr int kCrc32Size = 4;
+
+// The checksum covers the whole message, header included, up to the checksum itself.
+uint32_t calculateChecksum(const Message& message) {
+    return crc32c(message.buf(), message.size() - kCrc32Size);
+}
+
 enum class Section : uint8_t {
     kBody = 0,
     kDocSequence = 1,
@@ -79,6 +89,28 @@ void OpMsg::replaceFlags(Message* message, uint32_t flags) {
     DataView(message->singleData().data()).write<LittleEndian<uint32_t>>(flags);
 }
 
+void OpMsg::appendChecksum(Message* message) {
+    invariant(message->operation() == dbMsg);
+    invariant(!isFlagSet(*message, kChecksumPresent));
+
+    const int size = message->size();
+    auto buffer = SharedBuffer::allocate(size + kCrc32Size);
+    std::memcpy(buffer.get(), message->buf(), size);
+    *message = Message(std::move(buffer));
+    message->header().setLen(size + kCrc32Size);
+    setFlag(message, kChecksumPresent);
+    DataView(message->buf()).write<LittleEndian<uint32_t>>(calculateChecksum(*message), size);
+}
+
+void OpMsg::removeChecksum(Message* message) {
+    if (!isFlagSet(*message, kChecksumPresent)) {
+        return;
+    }
+    invariant(message->dataSize() >= static_cast<int>(sizeof(uint32_t)) + kCrc32Size);
+    message->header().setLen(message->size() - kCrc32Size);
+    replaceFlags(message, flags(*message) & ~kChecksumPresent);
+}
+
 /*
 OP_MSG {
     MsgHeader header;          // standard message header   Ҳstruct Layout {}
@@ -103,12 +135,13 @@ OpMsg OpMsg::parse(const Message& message) try {
                           << std::bitset<32>(flags).to_string(),
             !containsUnknownRequiredFlags(flags));
 
-	//УĬ4ֽ
-    constexpr int kCrc32Size = 4;
 	//жϸmongobodyǷУ鹦
     const bool haveChecksum = flags & kChecksumPresent;
 	//У鹦ܣĩβ4ֽΪУ
     const int checksumSize = haveChecksum ? kCrc32Size : 0;
+    uassert(50824,
+            "OP_MSG message is too short to hold its checksum",
+            message.dataSize() >= static_cast<int>(sizeof(flags)) + checksumSize);
 
     // The sections begin after the flags and before the checksum (if present).
     //sectionsֶ
@@ -167,6 +200,16 @@ OpMsg OpMsg::parse(const Message& message) try {
 
     uassert(40587, "OP_MSG messages must have a body", haveBody);
 
+    // Checked once the sections have been parsed so that malformed messages report what is wrong
+    // with their structure rather than a checksum mismatch.
+    if (haveChecksum) {
+        const auto checksum = ConstDataView(message.buf())
+                                  .read<LittleEndian<uint32_t>>(message.size() - kCrc32Size);
+        uassert(50823,
+                "OP_MSG checksum does not match contents",
+                checksum == calculateChecksum(message));
+    }
+
     // Detect duplicates between doc sequences and body. TODO IDL
     // Technically this is O(N*M) but N is at most 2.
     //bodysequenceȥж
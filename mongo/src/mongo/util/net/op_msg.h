@@ -50,6 +50,9 @@ struct OpMsg { //
     static constexpr uint32_t kChecksumPresent = 1 << 0;
     //ӦͻˣrunCommands  Strategy::clientCommand
     static constexpr uint32_t kMoreToCome = 1 << 1;
+    // Set by a client issuing getMore (or find/aggregate) to allow the server to stream further
+    // batches with kMoreToCome replies instead of waiting for the next request.
+    static constexpr uint32_t kExhaustSupported = 1 << 16;
 
     /**
      * Returns the unvalidated flags for the given message if it is an OP_MSG message.
@@ -75,6 +78,21 @@ struct OpMsg { //
         replaceFlags(message, flags(*message) | flag);
     }
 
+    /**
+     * Sets kChecksumPresent on an OP_MSG message without a checksum and appends the CRC-32C of
+     * its contents, which parse() verifies.
+     *
+     * The checksum covers the header, so it must be appended after the message's id and
+     * responseTo are final. A message whose header is rewritten afterwards must have its checksum
+     * removed and appended again.
+     */
+    static void appendChecksum(Message* message);
+
+    /**
+     * Clears kChecksumPresent on an OP_MSG message and drops its checksum, if it has one.
+     */
+    static void removeChecksum(Message* message);
+
     /**
      * Parses and returns an OpMsg containing unowned BSON.
      */
@@ -179,6 +197,16 @@ public:
         skipHeaderAndFlags();
     }
 
+    /**
+     * Builds the message in 'buffer', which must not be shared, instead of allocating a new one.
+     * The buffer still grows as needed.
+     */
+    explicit OpMsgBuilder(SharedBuffer buffer) : _buf(0) {
+        invariant(buffer);
+        _buf.useSharedBuffer(std::move(buffer));
+        skipHeaderAndFlags();
+    }
+
     /**
      * See the documentation for DocSequenceBuilder below.
      */
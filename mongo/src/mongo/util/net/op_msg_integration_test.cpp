@@ -166,4 +166,141 @@ TEST(OpMsg, CloseConnectionOnFireAndForgetNotMasterError) {
     ASSERT(foundSecondary);
 }
 
+// Sends 'request' with OpMsg::kExhaustSupported and reads replies for as long as the server flags
+// them with kMoreToCome. recv() checks that each reply answers the previous one.
+std::vector<BSONObj> runExhaustCommand(DBClientBase* conn,
+                                       const OpMsgRequest& request,
+                                       bool withChecksum = false) {
+    auto toSend = request.serialize();
+    OpMsg::setFlag(&toSend, OpMsg::kExhaustSupported);
+    if (withChecksum) {
+        OpMsg::appendChecksum(&toSend);
+    }
+
+    std::vector<BSONObj> replies;
+    Message reply;
+    ASSERT(conn->call(toSend, reply));
+    while (true) {
+        replies.push_back(OpMsg::parse(reply).body.getOwned());
+        if (!OpMsg::isFlagSet(reply, OpMsg::kMoreToCome)) {
+            return replies;
+        }
+        const auto lastId = reply.header().getId();
+        ASSERT(conn->recv(reply, lastId));
+    }
+}
+
+std::unique_ptr<DBClientBase> connectForExhaust() {
+    std::string errMsg;
+    auto conn = std::unique_ptr<DBClientBase>(
+        unittest::getFixtureConnectionString().connect("integration_test", errMsg));
+    uassert(ErrorCodes::SocketException, errMsg, conn);
+    return conn;
+}
+
+TEST(OpMsg, ExhaustFindStreamsGetMoreReplies) {
+    auto conn = connectForExhaust();
+    conn->dropCollection("test.exhaust");
+    for (int i = 0; i < 5; ++i) {
+        conn->insert("test.exhaust", BSON("_id" << i));
+    }
+
+    auto replies = runExhaustCommand(
+        conn.get(),
+        OpMsgRequest::fromDBAndBody("test", fromjson("{find: 'exhaust', batchSize: 2}")));
+
+    // The find and the two getMores the server ran for it on its own.
+    ASSERT_EQ(replies.size(), 3u);
+    ASSERT_EQ(replies[0]["cursor"]["firstBatch"].Obj().nFields(), 2);
+    ASSERT_EQ(replies[1]["cursor"]["nextBatch"].Obj().nFields(), 2);
+    ASSERT_EQ(replies[2]["cursor"]["nextBatch"].Obj().nFields(), 1);
+    ASSERT_EQ(replies[2]["cursor"]["id"].numberLong(), 0);
+}
+
+TEST(OpMsg, ExhaustGetMoreStreamsUntilTheCursorIsExhausted) {
+    auto conn = connectForExhaust();
+    conn->dropCollection("test.exhaust");
+    for (int i = 0; i < 4; ++i) {
+        conn->insert("test.exhaust", BSON("_id" << i));
+    }
+
+    BSONObj reply;
+    ASSERT(conn->runCommand("test", fromjson("{find: 'exhaust', batchSize: 0}"), reply)) << reply;
+    const auto cursorId = reply["cursor"]["id"].numberLong();
+    ASSERT_NE(cursorId, 0);
+
+    auto replies =
+        runExhaustCommand(conn.get(),
+                          OpMsgRequest::fromDBAndBody("test",
+                                                      BSON("getMore" << cursorId << "collection"
+                                                                     << "exhaust"
+                                                                     << "batchSize"
+                                                                     << 2)));
+
+    // The getMore that finds the cursor exhausted returns an empty batch and ends the stream.
+    ASSERT_EQ(replies.size(), 3u);
+    ASSERT_EQ(replies[0]["cursor"]["nextBatch"].Obj().nFields(), 2);
+    ASSERT_EQ(replies[1]["cursor"]["nextBatch"].Obj().nFields(), 2);
+    ASSERT_EQ(replies[2]["cursor"]["nextBatch"].Obj().nFields(), 0);
+    ASSERT_EQ(replies[2]["cursor"]["id"].numberLong(), 0);
+}
+
+TEST(OpMsg, ChecksummedExhaustGetMoreStreamsReplies) {
+    auto conn = connectForExhaust();
+    conn->dropCollection("test.exhaust");
+    for (int i = 0; i < 5; ++i) {
+        conn->insert("test.exhaust", BSON("_id" << i));
+    }
+
+    BSONObj reply;
+    ASSERT(conn->runCommand("test", fromjson("{find: 'exhaust', batchSize: 0}"), reply)) << reply;
+    const auto cursorId = reply["cursor"]["id"].numberLong();
+
+    auto replies =
+        runExhaustCommand(conn.get(),
+                          OpMsgRequest::fromDBAndBody("test",
+                                                      BSON("getMore" << cursorId << "collection"
+                                                                     << "exhaust"
+                                                                     << "batchSize"
+                                                                     << 2)),
+                          true);
+
+    // Every getMore the server ran for itself succeeded.
+    ASSERT_EQ(replies.size(), 3u);
+    for (auto&& getMoreReply : replies) {
+        ASSERT_OK(getStatusFromCommandResult(getMoreReply));
+    }
+    ASSERT_EQ(replies[2]["cursor"]["nextBatch"].Obj().nFields(), 1);
+    ASSERT_EQ(replies[2]["cursor"]["id"].numberLong(), 0);
+}
+
+TEST(OpMsg, ExhaustTailableCursorFallsBackToClientGetMores) {
+    auto conn = connectForExhaust();
+    conn->dropCollection("test.exhaust_capped");
+    ASSERT(conn->createCollection("test.exhaust_capped", 4096, true));
+    for (int i = 0; i < 3; ++i) {
+        conn->insert("test.exhaust_capped", BSON("_id" << i));
+    }
+
+    auto replies = runExhaustCommand(
+        conn.get(),
+        OpMsgRequest::fromDBAndBody(
+            "test", fromjson("{find: 'exhaust_capped', tailable: true, batchSize: 2}")));
+
+    // Once the cursor has caught up, its empty batch hands it back to the client.
+    ASSERT_EQ(replies.size(), 3u);
+    ASSERT_EQ(replies[2]["cursor"]["nextBatch"].Obj().nFields(), 0);
+    const auto cursorId = replies[2]["cursor"]["id"].numberLong();
+    ASSERT_NE(cursorId, 0);
+
+    conn->insert("test.exhaust_capped", BSON("_id" << 3));
+    BSONObj reply;
+    ASSERT(conn->runCommand("test",
+                            BSON("getMore" << cursorId << "collection"
+                                           << "exhaust_capped"),
+                            reply))
+        << reply;
+    ASSERT_BSONOBJ_EQ(reply["cursor"]["nextBatch"].Obj(), BSON_ARRAY(BSON("_id" << 3)));
+}
+
 }  // namespace mongo
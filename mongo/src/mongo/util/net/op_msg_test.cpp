@@ -157,8 +157,8 @@ const char kDocSequenceSection = 1;
 const uint32_t kNoFlags = 0;
 const uint32_t kHaveChecksum = 1;
 
-// CRC filler value
-const uint32_t kFakeCRC = 0;  // TODO will need to compute real crc when SERVER-28679 is done.
+// CRC filler value, for messages which are rejected before their checksum is checked.
+const uint32_t kFakeCRC = 0;
 
 TEST_F(OpMsgParser, SucceedsWithJustBody) {
     auto msg = OpMsgBytes{
@@ -171,16 +171,79 @@ TEST_F(OpMsgParser, SucceedsWithJustBody) {
     ASSERT_EQ(msg.sequences.size(), 0u);
 }
 
-TEST_F(OpMsgParser, IgnoresCrcIfPresent) {  // Until SERVER-28679 is done.
+TEST_F(OpMsgParser, SucceedsWithValidChecksum) {
+    auto message = OpMsgBytes{
+        kNoFlags,  //
+        kBodySection,
+        fromjson("{ping: 1}"),
+
+        kDocSequenceSection,
+        Sized{
+            "docs",  //
+            fromjson("{a: 1}"),
+        },
+    }.done();
+    OpMsg::appendChecksum(&message);
+    ASSERT_TRUE(OpMsg::isFlagSet(message, OpMsg::kChecksumPresent));
+
+    auto msg = OpMsg::parseOwned(message);
+    ASSERT_BSONOBJ_EQ(msg.body, fromjson("{ping: 1}"));
+    ASSERT_EQ(msg.sequences.size(), 1u);
+    ASSERT_EQ(msg.sequences[0].objs.size(), 1u);
+}
+
+TEST_F(OpMsgParser, FailsIfChecksumDoesNotMatch) {
     auto msg = OpMsgBytes{
         kHaveChecksum,  //
         kBodySection,
         fromjson("{ping: 1}"),
-        kFakeCRC,  // If not ignored, this would be read as a second body.
-    }.parse();
+        kFakeCRC,
+    };
+    ASSERT_THROWS_CODE(msg.parse(), AssertionException, 50823);
 
-    ASSERT_BSONOBJ_EQ(msg.body, fromjson("{ping: 1}"));
-    ASSERT_EQ(msg.sequences.size(), 0u);
+    // Corrupting a byte covered by a valid checksum is also detected.
+    auto message = OpMsgBytes{
+        kNoFlags,  //
+        kBodySection,
+        fromjson("{ping: 1}"),
+    }.done();
+    OpMsg::appendChecksum(&message);
+    message.buf()[message.size() - 6] ^= 1;  // Inside the value of "ping".
+    ASSERT_THROWS_CODE(OpMsg::parse(message), AssertionException, 50823);
+}
+
+TEST_F(OpMsgParser, ChecksumCanBeRecomputedAfterTheHeaderChanges) {
+    auto message = OpMsgBytes{
+        kNoFlags,  //
+        kBodySection,
+        fromjson("{ping: 1}"),
+    }.done();
+    const int sizeWithoutChecksum = message.size();
+    OpMsg::appendChecksum(&message);
+
+    // The checksum covers the header, so rewriting the id invalidates it.
+    message.header().setId(message.header().getId() + 1);
+    ASSERT_THROWS_CODE(OpMsg::parse(message), AssertionException, 50823);
+
+    OpMsg::removeChecksum(&message);
+    ASSERT_FALSE(OpMsg::isFlagSet(message, OpMsg::kChecksumPresent));
+    ASSERT_EQ(message.size(), sizeWithoutChecksum);
+    ASSERT_BSONOBJ_EQ(OpMsg::parse(message).body, fromjson("{ping: 1}"));
+
+    OpMsg::appendChecksum(&message);
+    ASSERT_BSONOBJ_EQ(OpMsg::parse(message).body, fromjson("{ping: 1}"));
+
+    // Removing a checksum from a message without one does nothing.
+    OpMsg::removeChecksum(&message);
+    OpMsg::removeChecksum(&message);
+    ASSERT_EQ(message.size(), sizeWithoutChecksum);
+}
+
+TEST_F(OpMsgParser, FailsIfTooShortForChecksum) {
+    auto msg = OpMsgBytes{
+        kHaveChecksum,
+    };
+    ASSERT_THROWS_CODE(msg.parse(), AssertionException, 50824);
 }
 
 TEST_F(OpMsgParser, SucceedsWithBodyThenSequence) {
@@ -729,6 +792,26 @@ TEST(OpMsgSerializer, BodyAndSequenceInPlace) {
                    });
 }
 
+TEST(OpMsgSerializer, BuildsInGivenBuffer) {
+    // Reuse the buffer of a previously built message, as is done for replies on a connection.
+    OpMsgBuilder previous;
+    previous.setBody(fromjson("{previous: 'a reply which is longer than the next one'}"));
+    auto buffer = previous.finish().sharedBuffer();
+    const void* const bufferData = buffer.get();
+
+    OpMsgBuilder builder(std::move(buffer));
+    builder.setBody(fromjson("{ping: 1}"));
+    auto msg = builder.finish();
+    ASSERT_EQ(static_cast<const void*>(msg.buf()), bufferData);
+
+    testSerializer(msg,
+                   OpMsgBytes{
+                       kNoFlags,  //
+                       kBodySection,
+                       fromjson("{ping: 1}"),
+                   });
+}
+
 TEST(OpMsgSerializer, BodyAndInPlaceSequenceInPlaceWithReset) {
     OpMsgBuilder builder;
 
@@ -392,6 +392,8 @@ bool Socket::secure(SSLManagerInterface* mgr, const std::string& remoteHost) {
     _sslManager = mgr;
     _sslConnection.reset(_sslManager->connect(this));
     mgr->parseAndValidatePeerCertificateDeprecated(_sslConnection.get(), remoteHost);
+    // Only a session whose peer passed validation may be resumed by the next connection.
+    mgr->saveResumableSession(_sslConnection->ssl, remoteAddr().toString());
     return true;
 }
 
@@ -106,6 +106,24 @@ ExportedServerParameter<std::string, ServerParameterType::kStartupOnly>
     setDiffieHellmanParameterPEMFile(ServerParameterSet::getGlobal(),
                                      "opensslDiffieHellmanParameters",
                                      &sslGlobalParams.sslPEMTempDHParam);
+
+/**
+ * Configurable via --setParameter opensslClientSessionResumption=false. If true (default),
+ * outgoing connections offer the session negotiated on the previous connection to the same host,
+ * so reconnects can skip the full handshake.
+ */
+ExportedServerParameter<bool, ServerParameterType::kStartupOnly>
+    clientSessionResumptionParameter(ServerParameterSet::getGlobal(),
+                                     "opensslClientSessionResumption",
+                                     &sslGlobalParams.sslClientSessionResumption);
+
+/**
+ * Configurable via --setParameter opensslKernelTLS=true. Asks OpenSSL to hand record encryption
+ * to the kernel for connections driven directly over a socket. Requires an OpenSSL built with
+ * kTLS support.
+ */
+ExportedServerParameter<bool, ServerParameterType::kStartupOnly> kernelTLSParameter(
+    ServerParameterSet::getGlobal(), "opensslKernelTLS", &sslGlobalParams.sslKernelTLS);
 }  // namespace
 
 SSLPeerInfo& SSLPeerInfo::forSession(const transport::SessionHandle& session) {
@@ -176,6 +194,9 @@ struct BIOFree {
 };
 using UniqueBIO = std::unique_ptr<BIO, BIOFree>;
 
+// Upper bound on the number of remote hosts whose sessions are remembered for resumption.
+const size_t kMaxResumableSessions = 1024;
+
 UniqueBIO makeUniqueMemBio(std::vector<std::uint8_t>& v) {
     UniqueBIO rv(::BIO_new_mem_buf(v.data(), v.size()));
     if (!rv) {
@@ -393,6 +414,10 @@ public:
 
     virtual void SSL_free(SSLConnection* conn);
 
+    void offerResumableSession(SSL* ssl, const std::string& remoteHost) final;
+
+    void saveResumableSession(SSL* ssl, const std::string& remoteHost) final;
+
 private:
     const int _rolesNid = OBJ_create(mongodbRolesOID.identifier.c_str(),
                                      mongodbRolesOID.shortDescription.c_str(),
@@ -403,6 +428,10 @@ private:
     bool _allowInvalidCertificates;
     bool _allowInvalidHostnames;
     SSLConfiguration _sslConfiguration;
+    bool _clientSessionResumption;
+
+    // Most recent resumable session for each (client context, remote host) pair.
+    SSLSessionCache _sessionCache;
 
     /**
      * creates an SSL object to be used for this file descriptor.
@@ -593,6 +622,24 @@ SSLConnection::~SSLConnection() {
     }
 }
 
+SSLSessionCache::SSLSessionCache(size_t maxSessions) : _sessions(maxSessions) {}
+
+bool SSLSessionCache::offer(SSL* ssl, const std::string& remoteHost) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _sessions.find({::SSL_get_SSL_CTX(ssl), remoteHost});
+    if (it == _sessions.end()) {
+        return false;
+    }
+    // SSL_set_session takes its own reference, so the cache keeps ownership of the session.
+    ::SSL_set_session(ssl, it->second.get());
+    return true;
+}
+
+void SSLSessionCache::save(SSL* ssl, const std::string& remoteHost, UniqueSession session) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _sessions.add({::SSL_get_SSL_CTX(ssl), remoteHost}, std::move(session));
+}
+
 namespace {
 void canonicalizeClusterDN(std::vector<std::string>* dn) {
     // remove all RDNs we don't care about
@@ -644,7 +691,9 @@ SSLManager::SSLManager(const SSLParams& params, bool isServer)
       _clientContext(nullptr, free_ssl_context),
       _weakValidation(params.sslWeakCertificateValidation),
       _allowInvalidCertificates(params.sslAllowInvalidCertificates),
-      _allowInvalidHostnames(params.sslAllowInvalidHostnames) {
+      _allowInvalidHostnames(params.sslAllowInvalidHostnames),
+      _clientSessionResumption(params.sslClientSessionResumption),
+      _sessionCache(kMaxResumableSessions) {
     if (!_initSynchronousSSLContext(&_clientContext, params, ConnectionDirection::kOutgoing)) {
         uasserted(16768, "ssl initialization problem");
     }
@@ -866,6 +915,17 @@ bool SSLManager::_initSynchronousSSLContext(UniqueSSLContext* contextPtr,
     // Note: this is for blocking sockets only.
     SSL_CTX_set_mode(contextPtr->get(), SSL_MODE_AUTO_RETRY);
 
+    // Kernel TLS only applies to connections whose SSL object owns the socket, which is the case
+    // for these contexts. The ASIO streams feed OpenSSL through memory BIOs and cannot use it.
+    if (params.sslKernelTLS) {
+#ifdef SSL_OP_ENABLE_KTLS
+        ::SSL_CTX_set_options(contextPtr->get(), SSL_OP_ENABLE_KTLS);
+#else
+        uasserted(ErrorCodes::InvalidSSLConfiguration,
+                  "opensslKernelTLS requires an OpenSSL library built with kernel TLS support");
+#endif
+    }
+
     return true;
 }
 
@@ -1286,6 +1346,9 @@ SSLConnection* SSLManager::connect(Socket* socket) {
     if (ret != 1)
         _handleSSLError(SSL_get_error(sslConn.get(), ret), ret);
 
+    const std::string remoteHost = socket->remoteAddr().toString();
+    offerResumableSession(sslConn->ssl, remoteHost);
+
     do {
         ret = ::SSL_connect(sslConn->ssl);
     } while (!_doneWithSSLOp(sslConn.get(), ret));
@@ -1296,6 +1359,29 @@ SSLConnection* SSLManager::connect(Socket* socket) {
     return sslConn.release();
 }
 
+void SSLManager::offerResumableSession(SSL* ssl, const std::string& remoteHost) {
+    if (!_clientSessionResumption)
+        return;
+
+    _sessionCache.offer(ssl, remoteHost);
+}
+
+void SSLManager::saveResumableSession(SSL* ssl, const std::string& remoteHost) {
+    if (!_clientSessionResumption)
+        return;
+
+    SSLSessionCache::UniqueSession session(::SSL_get1_session(ssl));
+    if (!session)
+        return;
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    // TLS 1.3 delivers tickets after the handshake; a session without one cannot be resumed.
+    if (!::SSL_SESSION_is_resumable(session.get()))
+        return;
+#endif
+
+    _sessionCache.save(ssl, remoteHost, std::move(session));
+}
+
 SSLConnection* SSLManager::accept(Socket* socket, const char* initialBytes, int len) {
     std::unique_ptr<SSLConnection> sslConn =
         stdx::make_unique<SSLConnection>(_serverContext.get(), socket, initialBytes, len);
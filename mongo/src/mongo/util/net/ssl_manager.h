@@ -38,7 +38,9 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/decorable.h"
+#include "mongo/util/lru_cache.h"
 #include "mongo/util/net/sock.h"
 #include "mongo/util/net/ssl_types.h"
 #include "mongo/util/time_support.h"
@@ -106,6 +108,50 @@ const ASN1OID mongodbRolesOID("1.3.6.1.4.1.34601.2.1.1",
                               "MongoRoles",
                               "Sequence of MongoDB Database Roles");
 
+/**
+ * The resumable sessions of client handshakes, keyed by the SSL_CTX they were negotiated on and
+ * the remote host. Once the cache is full, saving a session evicts the least recently offered or
+ * saved one. This class is thread safe.
+ */
+class SSLSessionCache {
+    MONGO_DISALLOW_COPYING(SSLSessionCache);
+
+public:
+    struct SessionFree {
+        void operator()(SSL_SESSION* const p) noexcept {
+            if (p) {
+                ::SSL_SESSION_free(p);
+            }
+        }
+    };
+    using UniqueSession = std::unique_ptr<SSL_SESSION, SessionFree>;
+
+    explicit SSLSessionCache(size_t maxSessions);
+
+    /**
+     * Sets the session cached for "remoteHost" on the SSL_CTX of "ssl" as the one "ssl" offers in
+     * its handshake. Returns false if no session is cached.
+     */
+    bool offer(SSL* ssl, const std::string& remoteHost);
+
+    /**
+     * Caches "session" for "remoteHost" on the SSL_CTX of "ssl", replacing any previous one.
+     */
+    void save(SSL* ssl, const std::string& remoteHost, UniqueSession session);
+
+private:
+    using Key = std::pair<const SSL_CTX*, std::string>;
+
+    struct KeyHasher {
+        size_t operator()(const Key& key) const {
+            return std::hash<const SSL_CTX*>()(key.first) ^ std::hash<std::string>()(key.second);
+        }
+    };
+
+    stdx::mutex _mutex;
+    LRUCache<Key, UniqueSession, KeyHasher> _sessions;
+};
+
 class SSLManagerInterface : public Decorable<SSLManagerInterface> {
 public:
     static std::unique_ptr<SSLManagerInterface> create(const SSLParams& params, bool isServer);
@@ -186,6 +232,19 @@ public:
      */
     virtual StatusWith<boost::optional<SSLPeerInfo>> parseAndValidatePeerCertificate(
         SSL* ssl, const std::string& remoteHost) = 0;
+
+    /**
+     * Before a client handshake, offers the session saved by the last successful handshake with
+     * "remoteHost" on the same SSL_CTX, allowing the server to resume it instead of running a full
+     * handshake. Does nothing if no session is cached or resumption is disabled.
+     */
+    virtual void offerResumableSession(SSL* ssl, const std::string& remoteHost) = 0;
+
+    /**
+     * After a successful client handshake and validation of the peer certificate, remembers the
+     * negotiated session for "remoteHost" so that the next connection to it can be resumed.
+     */
+    virtual void saveResumableSession(SSL* ssl, const std::string& remoteHost) = 0;
 };
 
 // Access SSL functions through this instance.
@@ -83,5 +83,88 @@ TEST(SSLManager, matchHostname) {
     ASSERT_FALSE(failure);
 #endif
 }
+
+#ifdef MONGO_CONFIG_SSL
+struct SSLContextFree {
+    void operator()(SSL_CTX* const p) noexcept {
+        ::SSL_CTX_free(p);
+    }
+};
+struct SSLFree {
+    void operator()(SSL* const p) noexcept {
+        ::SSL_free(p);
+    }
+};
+using UniqueSSLContext = std::unique_ptr<SSL_CTX, SSLContextFree>;
+using UniqueSSL = std::unique_ptr<SSL, SSLFree>;
+
+UniqueSSLContext makeContext() {
+    UniqueSSLContext ctx(::SSL_CTX_new(SSLv23_method()));
+    ASSERT(ctx);
+    return ctx;
+}
+
+UniqueSSL makeSSL(SSL_CTX* ctx) {
+    UniqueSSL ssl(::SSL_new(ctx));
+    ASSERT(ssl);
+    return ssl;
+}
+
+// Caches a new session for "remoteHost" on "ctx" and returns it; the cache owns the session.
+SSL_SESSION* saveNewSession(SSLSessionCache* cache, SSL_CTX* ctx, const std::string& remoteHost) {
+    SSLSessionCache::UniqueSession session(::SSL_SESSION_new());
+    ASSERT(session);
+    SSL_SESSION* const raw = session.get();
+    cache->save(makeSSL(ctx).get(), remoteHost, std::move(session));
+    return raw;
+}
+
+// Returns the session offered by a new SSL on "ctx" to "remoteHost", or nullptr.
+SSL_SESSION* offeredSession(SSLSessionCache* cache, SSL_CTX* ctx, const std::string& remoteHost) {
+    auto ssl = makeSSL(ctx);
+    if (!cache->offer(ssl.get(), remoteHost)) {
+        ASSERT(!::SSL_get_session(ssl.get()));
+        return nullptr;
+    }
+    return ::SSL_get_session(ssl.get());
+}
+
+TEST(SSLSessionCache, OffersTheLastSessionSavedForTheSameContextAndHost) {
+    SSLSessionCache cache(4);
+    auto ctx = makeContext();
+    auto otherCtx = makeContext();
+
+    ASSERT(!offeredSession(&cache, ctx.get(), "a:27017"));
+    saveNewSession(&cache, ctx.get(), "a:27017");
+    auto session = saveNewSession(&cache, ctx.get(), "a:27017");
+
+    ASSERT_EQ(session, offeredSession(&cache, ctx.get(), "a:27017"));
+    ASSERT_EQ(session, offeredSession(&cache, ctx.get(), "a:27017"));
+    ASSERT(!offeredSession(&cache, ctx.get(), "b:27017"));
+    ASSERT(!offeredSession(&cache, otherCtx.get(), "a:27017"));
+}
+
+TEST(SSLSessionCache, EvictsTheLeastRecentlyUsedSession) {
+    SSLSessionCache cache(2);
+    auto ctx = makeContext();
+
+    auto a = saveNewSession(&cache, ctx.get(), "a:27017");
+    auto b = saveNewSession(&cache, ctx.get(), "b:27017");
+
+    // Offering "a" makes "b" the least recently used, so it is the one a third host evicts, even
+    // though it sorts after "a".
+    ASSERT_EQ(a, offeredSession(&cache, ctx.get(), "a:27017"));
+    auto c = saveNewSession(&cache, ctx.get(), "c:27017");
+    ASSERT(!offeredSession(&cache, ctx.get(), "b:27017"));
+    ASSERT_EQ(a, offeredSession(&cache, ctx.get(), "a:27017"));
+    ASSERT_EQ(c, offeredSession(&cache, ctx.get(), "c:27017"));
+
+    // Saving a session again for a cached host also makes it the most recently used.
+    auto newC = saveNewSession(&cache, ctx.get(), "c:27017");
+    saveNewSession(&cache, ctx.get(), "d:27017");
+    ASSERT(!offeredSession(&cache, ctx.get(), "a:27017"));
+    ASSERT_EQ(newC, offeredSession(&cache, ctx.get(), "c:27017"));
+}
+#endif
 }  // namespace
 }  // namespace mongo
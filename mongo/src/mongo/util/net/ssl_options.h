@@ -59,6 +59,9 @@ struct SSLParams {
     bool sslAllowInvalidHostnames = false;        // --sslAllowInvalidHostnames
     bool disableNonSSLConnectionLogging =
         false;  // --setParameter disableNonSSLConnectionLogging=true
+    bool sslClientSessionResumption =
+        true;                   // --setParameter opensslClientSessionResumption=false
+    bool sslKernelTLS = false;  // --setParameter opensslKernelTLS=true
 
     SSLParams() {
         sslMode.store(SSLMode_disabled);
@@ -0,0 +1,3 @@
+// This file intentionally blank.  shim_zstd.cpp is part of the
+// third_party/zstd library, which is just a placeholder for forwarding
+// library dependencies.